@@ -2,7 +2,7 @@ load("@rules_cc//cc:defs.bzl", "cc_library")
 
 CPU_CAPABILITY_NAMES = ["DEFAULT", "AVX", "AVX2"]
 CAPABILITY_COMPILER_FLAGS = {
-    "AVX2": ["-mavx2", "-mfma"],
+    "AVX2": ["-mavx2", "-mfma", "-mf16c"],
     "AVX": ["-mavx"],
     "DEFAULT": [],
 }
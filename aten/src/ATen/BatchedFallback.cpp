@@ -5,6 +5,8 @@
 #include <ATen/core/dispatch/Dispatcher.h>
 #include <c10/util/llvmMathExtras.h>
 
+#include <mutex>
+
 namespace at {
 
 // Given a linear index, return the actual index.
@@ -64,7 +66,35 @@ static bool isInplaceOp(const c10::FunctionSchema& schema) {
   return return_alias_info && return_alias_info.value().isWrite();
 }
 
+static std::mutex& fallbackCountsMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+static std::unordered_map<std::string, int64_t>& fallbackCounts() {
+  static std::unordered_map<std::string, int64_t> counts;
+  return counts;
+}
+
+std::unordered_map<std::string, int64_t> getVmapFallbackCounts() {
+  std::lock_guard<std::mutex> guard(fallbackCountsMutex());
+  return fallbackCounts();
+}
+
+void resetVmapFallbackCounts() {
+  std::lock_guard<std::mutex> guard(fallbackCountsMutex());
+  fallbackCounts().clear();
+}
+
+static void countFallback(const c10::FunctionSchema& schema) {
+  const auto& name = schema.operator_name();
+  auto key = name.overload_name.empty() ? name.name : name.name + "." + name.overload_name;
+  std::lock_guard<std::mutex> guard(fallbackCountsMutex());
+  fallbackCounts()[key]++;
+}
+
 static void warnFallback(const c10::FunctionSchema& schema, bool is_inplace) {
+  countFallback(schema);
   if (!globalContext().areVmapFallbackWarningsEnabled()) {
     return;
   }
@@ -3,6 +3,9 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <torch/library.h>
 
+#include <string>
+#include <unordered_map>
+
 namespace at {
 
 // If an operator doesn't have a batching rule implemented then we fallback
@@ -20,4 +23,10 @@ namespace at {
 // write batching rules for operators whenever possible.
 void batchedTensorForLoopFallback(const c10::OperatorHandle& op, torch::jit::Stack* stack);
 
+// The number of calls of each operator that went through the fallback, keyed
+// by the operator name (e.g. "aten::atan2"). This tells which operators of a
+// workload still miss a batching rule.
+TORCH_API std::unordered_map<std::string, int64_t> getVmapFallbackCounts();
+TORCH_API void resetVmapFallbackCounts();
+
 } // namespace at
@@ -77,7 +77,7 @@ bool BatchedTensorImpl::is_contiguous(at::MemoryFormat memory_format) const {
   TORCH_CHECK(memory_format == MemoryFormat::Contiguous,
       "NYI: querying is_contiguous inside of vmap for memory_format ",
       "other than torch.contiguous_format");
-  return is_contiguous_;
+  return memory_format_flags() & kContiguous;
 }
 
 const Storage& BatchedTensorImpl::storage() const {
@@ -54,6 +54,55 @@ static bool is_allowed_dim_on_scalar_tensor(int64_t dim) {
   return dim == 0 || dim == -1;
 }
 
+// The arguments of a reduction over the logical `dims` of `self`, in terms of
+// the physical tensor of `self`. As for the at:: reductions, no dims means all
+// of the (logical) dims.
+struct PhysicalReduction {
+  Tensor tensor;
+  VmapDimVector dims;
+  bool keepdim;
+  VmapPhysicalToLogicalMap map;
+};
+
+static PhysicalReduction getPhysicalReduction(const Tensor& self, IntArrayRef dims, bool keepdim) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  auto map = self_physical.getPhysicalToLogicalMap();
+  const auto num_batch_dims = self_physical.numBatchDims();
+  // The reductions accept dim 0 and dim -1 on a scalar tensor (see
+  // sum_batching_rule), which we replicate by giving the physical tensor a
+  // size-one dim to reduce. The result of a scalar tensor is a scalar tensor,
+  // even with keepdim=True.
+  if (/*logical*/self.dim() == 0 &&
+      std::all_of(dims.begin(), dims.end(), is_allowed_dim_on_scalar_tensor)) {
+    return {self_physical.tensor().unsqueeze(-1), {num_batch_dims}, false, map};
+  }
+  if (dims.empty()) {
+    VmapDimVector all_dims;
+    for (int64_t dim = num_batch_dims; dim < self_physical.tensor().dim(); ++dim) {
+      all_dims.push_back(dim);
+    }
+    return {self_physical.tensor(), std::move(all_dims), keepdim, map};
+  }
+  return {self_physical.tensor(), self_physical.getPhysicalDims(dims), keepdim, map};
+}
+
+// For the full reductions: the physical tensor of `self` with its logical dims
+// flattened into one, which the at:: reductions over a dim can then reduce.
+static PhysicalReduction getFlattenedPhysicalReduction(const Tensor& self) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  const auto num_batch_dims = self_physical.numBatchDims();
+  const auto physical_sizes = self_physical.tensor().sizes();
+  VmapDimVector flattened_sizes(physical_sizes.begin(), physical_sizes.begin() + num_batch_dims);
+  flattened_sizes.push_back(prod_intlist(physical_sizes.begin() + num_batch_dims, physical_sizes.end()));
+  return {
+    self_physical.tensor().reshape(flattened_sizes),
+    {num_batch_dims},
+    false,
+    self_physical.getPhysicalToLogicalMap()
+  };
+}
+
+
 Tensor sum_batching_rule(const Tensor& self, IntArrayRef dims, bool keepdim, optional<ScalarType> dtype) {
   // PyTorch has a special case where sum(scalar_tensor, dim=0) does not fail
   // and instead returns a new scalar tensor (this also happens for dim=-1)
@@ -64,10 +113,130 @@ Tensor sum_batching_rule(const Tensor& self, IntArrayRef dims, bool keepdim, opt
   if (/*logical*/self.dim() == 0 && dims.size() == 1 && is_allowed_dim_on_scalar_tensor(dims[0])) {
     return self.clone();
   }
-  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
-  auto dims_physical = self_physical.getPhysicalDims(dims);
-  auto result = at::sum(self_physical.tensor(), dims_physical, keepdim, dtype);
-  return self_physical.getPhysicalToLogicalMap().apply(result);
+  auto reduction = getPhysicalReduction(self, dims, keepdim);
+  auto result = at::sum(reduction.tensor, reduction.dims, reduction.keepdim, dtype);
+  return reduction.map.apply(result);
+}
+
+Tensor mean_dim_batching_rule(const Tensor& self, IntArrayRef dims, bool keepdim, optional<ScalarType> dtype) {
+  auto reduction = getPhysicalReduction(self, dims, keepdim);
+  auto result = at::mean(reduction.tensor, reduction.dims, reduction.keepdim, dtype);
+  return reduction.map.apply(result);
+}
+
+Tensor prod_dim_batching_rule(const Tensor& self, int64_t dim, bool keepdim, optional<ScalarType> dtype) {
+  auto reduction = getPhysicalReduction(self, dim, keepdim);
+  auto result = at::prod(reduction.tensor, reduction.dims[0], reduction.keepdim, dtype);
+  return reduction.map.apply(result);
+}
+
+Tensor std_dim_batching_rule(const Tensor& self, IntArrayRef dims, bool unbiased, bool keepdim) {
+  auto reduction = getPhysicalReduction(self, dims, keepdim);
+  auto result = at::std(reduction.tensor, reduction.dims, unbiased, reduction.keepdim);
+  return reduction.map.apply(result);
+}
+
+Tensor var_dim_batching_rule(const Tensor& self, IntArrayRef dims, bool unbiased, bool keepdim) {
+  auto reduction = getPhysicalReduction(self, dims, keepdim);
+  auto result = at::var(reduction.tensor, reduction.dims, unbiased, reduction.keepdim);
+  return reduction.map.apply(result);
+}
+
+Tensor norm_dim_batching_rule(const Tensor& self, optional<Scalar> p, IntArrayRef dims, bool keepdim) {
+  auto reduction = getPhysicalReduction(self, dims, keepdim);
+  auto result = at::norm(reduction.tensor, p, reduction.dims, reduction.keepdim);
+  return reduction.map.apply(result);
+}
+
+Tensor frobenius_norm_dim_batching_rule(const Tensor& self, IntArrayRef dims, bool keepdim) {
+  TORCH_CHECK(dims.size() <= 2,
+      "frobenius_norm(self, dim): Expected at most 2 dimensions, but got ", dims.size(),
+      " dimensions instead.");
+  auto reduction = getPhysicalReduction(self, dims, keepdim);
+  // No dims are all of the logical dims, which may be more than 2
+  auto result = reduction.dims.size() <= 2
+      ? at::frobenius_norm(reduction.tensor, reduction.dims, reduction.keepdim)
+      : at::norm(reduction.tensor, 2, reduction.dims, reduction.keepdim);
+  return reduction.map.apply(result);
+}
+
+// Reductions over a list of dims, e.g. amax(self, dim, keepdim)
+template <typename F, F Func>
+Tensor reduce_dims_batching_rule(const Tensor& self, IntArrayRef dims, bool keepdim) {
+  auto reduction = getPhysicalReduction(self, dims, keepdim);
+  auto result = Func(reduction.tensor, reduction.dims, reduction.keepdim);
+  return reduction.map.apply(result);
+}
+
+// Reductions over a single dim, e.g. all(self, dim, keepdim)
+template <typename F, F Func>
+Tensor reduce_dim_batching_rule(const Tensor& self, int64_t dim, bool keepdim) {
+  auto reduction = getPhysicalReduction(self, dim, keepdim);
+  auto result = Func(reduction.tensor, reduction.dims[0], reduction.keepdim);
+  return reduction.map.apply(result);
+}
+
+// Reductions over a single dim that also return the indices, e.g. max(self, dim, keepdim)
+template <typename F, F Func>
+std::tuple<Tensor,Tensor> reduce_dim_with_indices_batching_rule(const Tensor& self, int64_t dim, bool keepdim) {
+  auto reduction = getPhysicalReduction(self, dim, keepdim);
+  Tensor values, indices;
+  std::tie(values, indices) = Func(reduction.tensor, reduction.dims[0], reduction.keepdim);
+  return std::make_tuple(reduction.map.apply(values), reduction.map.apply(indices));
+}
+
+// argmax and argmin, where no dim means the index in the flattened tensor
+template <typename F, F Func>
+Tensor arg_reduce_batching_rule(const Tensor& self, optional<int64_t> dim, bool keepdim) {
+  auto reduction = dim.has_value()
+      ? getPhysicalReduction(self, *dim, keepdim)
+      : getFlattenedPhysicalReduction(self);
+  auto result = Func(reduction.tensor, reduction.dims[0], reduction.keepdim);
+  return reduction.map.apply(result);
+}
+
+Tensor sum_full_batching_rule(const Tensor& self, optional<ScalarType> dtype) {
+  auto reduction = getFlattenedPhysicalReduction(self);
+  auto result = at::sum(reduction.tensor, reduction.dims, /*keepdim=*/false, dtype);
+  return reduction.map.apply(result);
+}
+
+Tensor mean_full_batching_rule(const Tensor& self, optional<ScalarType> dtype) {
+  auto reduction = getFlattenedPhysicalReduction(self);
+  auto result = at::mean(reduction.tensor, reduction.dims, /*keepdim=*/false, dtype);
+  return reduction.map.apply(result);
+}
+
+Tensor prod_full_batching_rule(const Tensor& self, optional<ScalarType> dtype) {
+  auto reduction = getFlattenedPhysicalReduction(self);
+  auto result = at::prod(reduction.tensor, reduction.dims[0], /*keepdim=*/false, dtype);
+  return reduction.map.apply(result);
+}
+
+Tensor std_full_batching_rule(const Tensor& self, bool unbiased) {
+  auto reduction = getFlattenedPhysicalReduction(self);
+  auto result = at::std(reduction.tensor, reduction.dims, unbiased, /*keepdim=*/false);
+  return reduction.map.apply(result);
+}
+
+Tensor var_full_batching_rule(const Tensor& self, bool unbiased) {
+  auto reduction = getFlattenedPhysicalReduction(self);
+  auto result = at::var(reduction.tensor, reduction.dims, unbiased, /*keepdim=*/false);
+  return reduction.map.apply(result);
+}
+
+Tensor norm_full_batching_rule(const Tensor& self, Scalar p) {
+  auto reduction = getFlattenedPhysicalReduction(self);
+  auto result = at::norm(reduction.tensor, p, reduction.dims, /*keepdim=*/false);
+  return reduction.map.apply(result);
+}
+
+// Full reductions that have a variant over a single dim, e.g. all(self)
+template <typename F, F Func>
+Tensor reduce_full_batching_rule(const Tensor& self) {
+  auto reduction = getFlattenedPhysicalReduction(self);
+  auto result = Func(reduction.tensor, reduction.dims[0], /*keepdim=*/false);
+  return reduction.map.apply(result);
 }
 
 bool isPhysicalScalarTensor(const Tensor& logical_tensor) {
@@ -1006,6 +1175,301 @@ Tensor new_empty_strided_batching_rule(
   return physical_view.getPhysicalToLogicalMap().apply(result);
 }
 
+// The size of the batch dims at the front of a physical tensor
+static IntArrayRef getBatchSizes(const VmapPhysicalView& physical_view) {
+  return physical_view.tensor().sizes().slice(0, physical_view.numBatchDims());
+}
+
+Tensor index_select_batching_rule(const Tensor& self, int64_t dim, const Tensor& index) {
+  if (!isBatchedTensor(index)) {
+    auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+    auto dim_physical = self_physical.getPhysicalDim(dim);
+    auto result = at::index_select(self_physical.tensor(), dim_physical, index);
+    return self_physical.getPhysicalToLogicalMap().apply(result);
+  }
+  // A batched index selects different slices for each example, which is a
+  // gather of the index, of size [B..., N], broadcast to the other dims.
+  TORCH_CHECK(/*logical*/index.dim() <= 1,
+      "index_select(self, dim, index): index should be a vector (got `index` of size ",
+      index.sizes(), ")");
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical({self, index});
+  const auto& self_physical = physical_args[0].tensor();
+  const auto dim_physical = physical_args[0].getPhysicalDim(dim);
+  const auto batch_sizes = getBatchSizes(physical_args[0]);
+  const auto num_indices = index.numel();
+
+  VmapDimVector index_view_sizes(batch_sizes.begin(), batch_sizes.end());
+  index_view_sizes.resize(self_physical.dim(), 1);
+  index_view_sizes[dim_physical] = num_indices;
+  VmapDimVector index_expanded_sizes(self_physical.sizes().begin(), self_physical.sizes().end());
+  index_expanded_sizes[dim_physical] = num_indices;
+  auto index_physical = physical_args[1].tensor()
+      .reshape(index_view_sizes)
+      .expand(index_expanded_sizes);
+  auto result = at::gather(self_physical, dim_physical, index_physical);
+  return physical_args[0].getPhysicalToLogicalMap().apply(result);
+}
+
+Tensor gather_batching_rule(const Tensor& self, int64_t dim, const Tensor& index, bool sparse_grad) {
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical({self, index});
+  auto dim_physical = physical_args[0].getPhysicalDim(dim);
+  auto result = at::gather(
+      physical_args[0].tensor(), dim_physical, physical_args[1].tensor(), sparse_grad);
+  return physical_args[0].getPhysicalToLogicalMap().apply(result);
+}
+
+Tensor scatter_src_batching_rule(const Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical({self, index, src});
+  auto dim_physical = physical_args[0].getPhysicalDim(dim);
+  auto result = at::scatter(
+      physical_args[0].tensor(), dim_physical, physical_args[1].tensor(), physical_args[2].tensor());
+  return physical_args[0].getPhysicalToLogicalMap().apply(result);
+}
+
+Tensor scatter_value_batching_rule(const Tensor& self, int64_t dim, const Tensor& index, Scalar value) {
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical({self, index});
+  auto dim_physical = physical_args[0].getPhysicalDim(dim);
+  auto result = at::scatter(
+      physical_args[0].tensor(), dim_physical, physical_args[1].tensor(), value);
+  return physical_args[0].getPhysicalToLogicalMap().apply(result);
+}
+
+Tensor scatter_add_batching_rule(const Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical({self, index, src});
+  auto dim_physical = physical_args[0].getPhysicalDim(dim);
+  auto result = at::scatter_add(
+      physical_args[0].tensor(), dim_physical, physical_args[1].tensor(), physical_args[2].tensor());
+  return physical_args[0].getPhysicalToLogicalMap().apply(result);
+}
+
+Tensor embedding_batching_rule(
+    const Tensor& weight, const Tensor& indices, int64_t padding_idx,
+    bool scale_grad_by_freq, bool sparse) {
+  if (!isBatchedTensor(weight)) {
+    auto indices_physical = MultiBatchVmapTransform::logicalToPhysical(indices);
+    auto result = at::embedding(
+        weight, indices_physical.tensor(), padding_idx, scale_grad_by_freq, sparse);
+    return indices_physical.getPhysicalToLogicalMap().apply(result);
+  }
+  TORCH_CHECK(/*logical*/weight.dim() == 2,
+      "embedding(weight, indices): expected a 2D `weight` (got `weight` of size ",
+      weight.sizes(), ")");
+  // The [B..., N, D] weights are looked up as one [B * N, D] weight, with the
+  // indices of the example b offset by b * N.
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical({weight, indices});
+  const auto& weight_physical = physical_args[0].tensor();
+  const auto& indices_physical = physical_args[1].tensor();
+  const auto batch_sizes = getBatchSizes(physical_args[0]);
+  const auto num_embeddings = weight_physical.size(-2);
+  const auto embedding_dim = weight_physical.size(-1);
+
+  VmapDimVector offsets_sizes(batch_sizes.begin(), batch_sizes.end());
+  offsets_sizes.resize(indices_physical.dim(), 1);
+  auto offsets = at::arange(
+      0, prod_intlist(batch_sizes) * num_embeddings, num_embeddings,
+      indices_physical.options()).view(offsets_sizes);
+  auto result = at::embedding(
+      weight_physical.reshape({-1, embedding_dim}), indices_physical + offsets,
+      /*padding_idx=*/-1, scale_grad_by_freq, sparse);
+  if (padding_idx >= 0) {
+    // The offset indices don't have a single padding index: the rows of
+    // padding_idx are simply not differentiated through
+    auto is_padding = (indices_physical == padding_idx).unsqueeze(-1);
+    result = at::where(is_padding, result.detach(), result);
+  }
+  return physical_args[0].getPhysicalToLogicalMap().apply(result);
+}
+
+static bool isBatchedOptionalTensor(const optional<Tensor>& tensor) {
+  return tensor.has_value() && tensor->defined() && isBatchedTensor(*tensor);
+}
+
+// Note [Batching rules for convolutions]
+// A convolution with batched inputs only is a convolution over the
+// [B * N, C, ...] inputs. With batched weights (or biases), the examples are
+// folded into the groups instead: the [N, B * C, ...] inputs are convolved with
+// the [B * K, C / groups, ...] weights in B * groups groups, so that every
+// example only meets its own weights, with a single convolution call.
+using ConvolutionFn = Tensor (*)(
+    const Tensor&, const Tensor&, const optional<Tensor>&,
+    IntArrayRef, IntArrayRef, IntArrayRef, int64_t);
+
+template <typename F, F Func>
+Tensor convolution_batching_rule(
+    const Tensor& input, const Tensor& weight, const optional<Tensor>& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  if (!isBatchedTensor(weight) && !isBatchedOptionalTensor(bias)) {
+    auto input_physical = MultiBatchVmapTransform::logicalToPhysical(input);
+    const auto num_batch_dims = input_physical.numBatchDims();
+    auto input_sizes = input_physical.tensor().sizes();
+    VmapDimVector folded_sizes = {-1};
+    folded_sizes.insert(folded_sizes.end(), input_sizes.begin() + num_batch_dims + 1, input_sizes.end());
+    auto result = Func(
+        input_physical.tensor().reshape(folded_sizes), weight, bias, stride, padding, dilation, groups);
+    VmapDimVector result_sizes(input_sizes.begin(), input_sizes.begin() + num_batch_dims + 1);
+    result_sizes.insert(result_sizes.end(), result.sizes().begin() + 1, result.sizes().end());
+    return input_physical.getPhysicalToLogicalMap().apply(result.reshape(result_sizes));
+  }
+
+  // See Note [Batching rules for convolutions]
+  std::vector<Tensor> logical_args = {input, weight};
+  if (bias.has_value() && bias->defined()) {
+    logical_args.push_back(*bias);
+  }
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical(logical_args);
+  const auto num_batch_dims = physical_args[0].numBatchDims();
+  const auto batch_sizes = getBatchSizes(physical_args[0]);
+  const auto num_batches = prod_intlist(batch_sizes);
+  // [B..., N, C, ...] -> [N, B * C, ...]
+  auto input_physical = physical_args[0].tensor().flatten(0, num_batch_dims - 1).transpose(0, 1);
+  VmapDimVector input_sizes(input_physical.sizes().begin(), input_physical.sizes().end());
+  input_sizes.erase(input_sizes.begin() + 1);
+  input_sizes[1] *= num_batches;
+  // [B..., K, C / groups, ...] -> [B * K, C / groups, ...]
+  auto weight_physical = physical_args[1].tensor().flatten(0, num_batch_dims);
+  optional<Tensor> bias_physical;
+  if (physical_args.size() > 2) {
+    bias_physical = physical_args[2].tensor().flatten();
+  }
+  auto result = Func(
+      input_physical.reshape(input_sizes), weight_physical, bias_physical,
+      stride, padding, dilation, groups * num_batches);
+  // [N, B * K, ...] -> [B..., N, K, ...]
+  VmapDimVector result_sizes = {result.size(0)};
+  result_sizes.insert(result_sizes.end(), batch_sizes.begin(), batch_sizes.end());
+  result_sizes.push_back(result.size(1) / num_batches);
+  result_sizes.insert(result_sizes.end(), result.sizes().begin() + 2, result.sizes().end());
+  auto result_physical = result.reshape(result_sizes).movedim(0, num_batch_dims);
+  return physical_args[0].getPhysicalToLogicalMap().apply(result_physical);
+}
+
+Tensor layer_norm_batching_rule(
+    const Tensor& input, IntArrayRef normalized_shape,
+    const optional<Tensor>& weight, const optional<Tensor>& bias,
+    double eps, bool cudnn_enable) {
+  if (isBatchedOptionalTensor(weight) || isBatchedOptionalTensor(bias)) {
+    // The normalization doesn't depend on the affine parameters, which are
+    // then applied by the batching rules of mul and add.
+    auto result = at::layer_norm(input, normalized_shape, nullopt, nullopt, eps, cudnn_enable);
+    if (weight.has_value() && weight->defined()) {
+      result = result * *weight;
+    }
+    if (bias.has_value() && bias->defined()) {
+      result = result + *bias;
+    }
+    return result;
+  }
+  TORCH_CHECK(/*logical*/input.dim() >= static_cast<int64_t>(normalized_shape.size()),
+      "layer_norm(input, normalized_shape): expected `input` with at least ",
+      normalized_shape.size(), " dims (got `input` of size ", input.sizes(), ")");
+  // The normalized dims are the last ones, after the batch dims
+  auto input_physical = MultiBatchVmapTransform::logicalToPhysical(input);
+  auto result = at::layer_norm(
+      input_physical.tensor(), normalized_shape, weight, bias, eps, cudnn_enable);
+  return input_physical.getPhysicalToLogicalMap().apply(result);
+}
+
+// The [C] parameters of a norm layer over [N, C, ...] inputs, viewed as
+// [C, 1, ...] to broadcast to the inputs
+static Tensor viewAsChannelParameter(const Tensor& parameter, int64_t input_dim) {
+  VmapDimVector sizes(input_dim - 1, 1);
+  sizes[0] = -1;
+  return parameter.view(sizes);
+}
+
+Tensor group_norm_batching_rule(
+    const Tensor& input, int64_t num_groups,
+    const optional<Tensor>& weight, const optional<Tensor>& bias,
+    double eps, bool cudnn_enabled) {
+  if (isBatchedOptionalTensor(weight) || isBatchedOptionalTensor(bias)) {
+    // See layer_norm_batching_rule
+    auto result = at::group_norm(input, num_groups, nullopt, nullopt, eps, cudnn_enabled);
+    if (weight.has_value() && weight->defined()) {
+      result = result * viewAsChannelParameter(*weight, input.dim());
+    }
+    if (bias.has_value() && bias->defined()) {
+      result = result + viewAsChannelParameter(*bias, input.dim());
+    }
+    return result;
+  }
+  TORCH_CHECK(/*logical*/input.dim() >= 2,
+      "group_norm(input, num_groups): expected `input` with at least 2 dims ",
+      "(got `input` of size ", input.sizes(), ")");
+  // The examples normalize their samples independently: [B * N, C, ...]
+  auto input_physical = MultiBatchVmapTransform::logicalToPhysical(input);
+  const auto num_batch_dims = input_physical.numBatchDims();
+  auto input_sizes = input_physical.tensor().sizes();
+  auto result = at::group_norm(
+      input_physical.tensor().flatten(0, num_batch_dims), num_groups, weight, bias, eps, cudnn_enabled);
+  return input_physical.getPhysicalToLogicalMap().apply(result.reshape(input_sizes));
+}
+
+Tensor batch_norm_batching_rule(
+    const Tensor& input, const optional<Tensor>& weight, const optional<Tensor>& bias,
+    const optional<Tensor>& running_mean, const optional<Tensor>& running_var,
+    bool training, double momentum, double eps, bool cudnn_enabled) {
+  const bool has_running_stats =
+      (running_mean.has_value() && running_mean->defined()) ||
+      (running_var.has_value() && running_var->defined());
+  TORCH_CHECK(!training || !has_running_stats,
+      "vmap: batch_norm(input, ..., training=True) with running_mean or running_var ",
+      "is not supported, since every example would update the same running statistics. ",
+      "Please use running_mean=None and running_var=None (e.g. track_running_stats=False) instead.");
+  TORCH_CHECK(/*logical*/input.dim() >= 2,
+      "batch_norm(input, ...): expected `input` with at least 2 dims ",
+      "(got `input` of size ", input.sizes(), ")");
+  const bool parameters_batched =
+      isBatchedOptionalTensor(weight) || isBatchedOptionalTensor(bias) ||
+      isBatchedOptionalTensor(running_mean) || isBatchedOptionalTensor(running_var);
+  if (!training && !parameters_batched) {
+    // Normalizing with the running statistics treats the samples
+    // independently: [B * N, C, ...]
+    auto input_physical = MultiBatchVmapTransform::logicalToPhysical(input);
+    const auto num_batch_dims = input_physical.numBatchDims();
+    auto result = at::batch_norm(
+        input_physical.tensor().flatten(0, num_batch_dims), weight, bias,
+        running_mean, running_var, training, momentum, eps, cudnn_enabled);
+    return input_physical.getPhysicalToLogicalMap().apply(
+        result.reshape(input_physical.tensor().sizes()));
+  }
+
+  // Every example has its own statistics (and parameters) over its samples,
+  // which are those of the channels of the [N, B * C, ...] input.
+  std::vector<Tensor> logical_args = {input};
+  for (const auto& argument : {weight, bias, running_mean, running_var}) {
+    if (argument.has_value() && argument->defined()) {
+      logical_args.push_back(*argument);
+    }
+  }
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical(logical_args);
+  const auto num_batch_dims = physical_args[0].numBatchDims();
+  const auto physical_sizes = physical_args[0].tensor().sizes();
+  // [B..., N, C, ...] -> [N, B * C, ...]
+  auto input_physical = physical_args[0].tensor().movedim(num_batch_dims, 0);
+  VmapDimVector input_sizes = {physical_sizes[num_batch_dims], -1};
+  input_sizes.insert(input_sizes.end(), physical_sizes.begin() + num_batch_dims + 2, physical_sizes.end());
+  auto next_arg = physical_args.begin() + 1;
+  auto flattenArg = [&](const optional<Tensor>& argument) -> optional<Tensor> {
+    if (!argument.has_value() || !argument->defined()) {
+      return nullopt;
+    }
+    return (next_arg++)->tensor().flatten();
+  };
+  auto weight_physical = flattenArg(weight);
+  auto bias_physical = flattenArg(bias);
+  auto running_mean_physical = flattenArg(running_mean);
+  auto running_var_physical = flattenArg(running_var);
+  auto result = at::batch_norm(
+      input_physical.reshape(input_sizes), weight_physical, bias_physical,
+      running_mean_physical, running_var_physical, training, momentum, eps, cudnn_enabled);
+  // [N, B * C, ...] -> [B..., N, C, ...]
+  VmapDimVector result_sizes = {physical_sizes[num_batch_dims]};
+  result_sizes.insert(result_sizes.end(), physical_sizes.begin(), physical_sizes.begin() + num_batch_dims);
+  result_sizes.insert(result_sizes.end(), physical_sizes.begin() + num_batch_dims + 1, physical_sizes.end());
+  auto result_physical = result.reshape(result_sizes).movedim(0, num_batch_dims);
+  return physical_args[0].getPhysicalToLogicalMap().apply(result_physical);
+}
+
 template <typename F, F Func>
 Tensor comparison_pointwise_batching_rule(const Tensor& self, const Tensor& other) {
   auto physical_args = BroadcastingVmapTransform::logicalToPhysical({self, other});
@@ -1204,6 +1668,56 @@ TORCH_LIBRARY_IMPL(aten, Batched, m) {
 
   m.impl("contiguous", contiguous_batching_rule);
 
+  // reductions
+  using ReduceDimsType = Tensor (*)(const Tensor&, IntArrayRef, bool);
+  using ReduceDimType = Tensor (*)(const Tensor&, int64_t, bool);
+  using ReduceDimWithIndicesType = std::tuple<Tensor,Tensor> (*)(const Tensor&, int64_t, bool);
+  using ArgReduceType = Tensor (*)(const Tensor&, optional<int64_t>, bool);
+  m.impl("sum", sum_full_batching_rule);
+  m.impl("mean", mean_full_batching_rule);
+  m.impl("mean.dim", mean_dim_batching_rule);
+  m.impl("prod", prod_full_batching_rule);
+  m.impl("prod.dim_int", prod_dim_batching_rule);
+  m.impl("std", std_full_batching_rule);
+  m.impl("std.dim", std_dim_batching_rule);
+  m.impl("var", var_full_batching_rule);
+  m.impl("var.dim", var_dim_batching_rule);
+  m.impl("norm.Scalar", norm_full_batching_rule);
+  m.impl("norm.ScalarOpt_dim", norm_dim_batching_rule);
+  m.impl("frobenius_norm", reduce_full_batching_rule<ReduceDimsType, at::frobenius_norm>);
+  m.impl("frobenius_norm.dim", frobenius_norm_dim_batching_rule);
+  m.impl("amax", reduce_dims_batching_rule<ReduceDimsType, at::amax>);
+  m.impl("amin", reduce_dims_batching_rule<ReduceDimsType, at::amin>);
+  m.impl("logsumexp", reduce_dims_batching_rule<ReduceDimsType, at::logsumexp>);
+  m.impl("max", reduce_full_batching_rule<ReduceDimsType, at::amax>);
+  m.impl("min", reduce_full_batching_rule<ReduceDimsType, at::amin>);
+  m.impl("max.dim", reduce_dim_with_indices_batching_rule<ReduceDimWithIndicesType, at::max>);
+  m.impl("min.dim", reduce_dim_with_indices_batching_rule<ReduceDimWithIndicesType, at::min>);
+  m.impl("argmax", arg_reduce_batching_rule<ArgReduceType, at::argmax>);
+  m.impl("argmin", arg_reduce_batching_rule<ArgReduceType, at::argmin>);
+  m.impl("all", reduce_full_batching_rule<ReduceDimType, at::all>);
+  m.impl("all.dim", reduce_dim_batching_rule<ReduceDimType, at::all>);
+  m.impl("any", reduce_full_batching_rule<ReduceDimType, at::any>);
+  m.impl("any.dim", reduce_dim_batching_rule<ReduceDimType, at::any>);
+
+  // indexing
+  m.impl("index_select", index_select_batching_rule);
+  m.impl("gather", gather_batching_rule);
+  m.impl("scatter.src", scatter_src_batching_rule);
+  m.impl("scatter.value", scatter_value_batching_rule);
+  m.impl("scatter_add", scatter_add_batching_rule);
+  m.impl("embedding", embedding_batching_rule);
+
+  // convolutions
+  m.impl("conv1d", convolution_batching_rule<ConvolutionFn, at::conv1d>);
+  m.impl("conv2d", convolution_batching_rule<ConvolutionFn, at::conv2d>);
+  m.impl("conv3d", convolution_batching_rule<ConvolutionFn, at::conv3d>);
+
+  // normalizations
+  m.impl("layer_norm", layer_norm_batching_rule);
+  m.impl("group_norm", group_norm_batching_rule);
+  m.impl("batch_norm", batch_norm_batching_rule);
+
   // Comparison ops
 #define COMPARISON_POINTWISE(op) \
   m.impl(#op".Tensor", comparison_pointwise_batching_rule<TensorTensorType, at::op>); \
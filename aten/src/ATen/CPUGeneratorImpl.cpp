@@ -45,6 +45,17 @@ struct CPUGeneratorImplState {
   bool is_next_float_normal_sample_valid;
 };
 
+/**
+ * CPUGeneratorImplStateCounterBased extends CPUGeneratorImplState with the
+ * offset of the Philox engine. It is the state of the generators in
+ * counter-based mode, those in the default mode keep using
+ * CPUGeneratorImplState.
+ */
+struct CPUGeneratorImplStateCounterBased {
+  CPUGeneratorImplState state;
+  uint64_t philox_offset;
+};
+
 /**
  * PyTorch maintains a collection of default generators that get
  * initialized once. The purpose of these default generators is to
@@ -92,6 +103,7 @@ void CPUGeneratorImpl::set_current_seed(uint64_t seed) {
   next_float_normal_sample_.reset();
   next_double_normal_sample_.reset();
   engine_ = mt19937(seed);
+  philox_offset_ = 0;
 }
 
 /**
@@ -129,9 +141,15 @@ void CPUGeneratorImpl::set_state(const c10::TensorImpl& new_state) {
   static_assert(std::is_pod<CPUGeneratorImplStateLegacy>::value, "CPUGeneratorImplStateLegacy is not a PODType");
   static_assert(std::is_pod<CPUGeneratorImplState>::value, "CPUGeneratorImplState is not a PODType");
 
+  using detail::CPUGeneratorImplStateCounterBased;
+  static_assert(std::is_pod<CPUGeneratorImplStateCounterBased>::value, "CPUGeneratorImplStateCounterBased is not a PODType");
+
   static const size_t size_legacy = sizeof(CPUGeneratorImplStateLegacy);
   static const size_t size_current = sizeof(CPUGeneratorImplState);
+  static const size_t size_counter_based = sizeof(CPUGeneratorImplStateCounterBased);
   static_assert(size_legacy != size_current, "CPUGeneratorImplStateLegacy and CPUGeneratorImplState can't be of the same size");
+  static_assert(size_counter_based != size_current && size_counter_based != size_legacy,
+                "CPUGeneratorImplStateCounterBased can't be of the same size as the other states");
 
   detail::check_rng_state(new_state);
 
@@ -141,7 +159,18 @@ void CPUGeneratorImpl::set_state(const c10::TensorImpl& new_state) {
 
   // Construct the state of at::CPUGeneratorImpl based on input byte tensor size.
   CPUGeneratorImplStateLegacy* legacy_pod;
+  CPUGeneratorImplState* rng_state = nullptr;
+  bool counter_based = false;
+  uint64_t philox_offset = 0;
   auto new_state_size = new_state.numel();
+  if (new_state_size == size_counter_based) {
+    auto counter_based_state = (CPUGeneratorImplStateCounterBased*)new_state.data();
+    rng_state = &counter_based_state->state;
+    counter_based = true;
+    philox_offset = counter_based_state->philox_offset;
+  } else if (new_state_size == size_current) {
+    rng_state = (CPUGeneratorImplState*)new_state.data();
+  }
   if (new_state_size == size_legacy) {
     legacy_pod = (CPUGeneratorImplStateLegacy*)new_state.data();
     // Note that in CPUGeneratorImplStateLegacy, we didn't have float version
@@ -158,8 +187,7 @@ void CPUGeneratorImpl::set_state(const c10::TensorImpl& new_state) {
       // we return the sin version of the normal sample when in caching mode
       double_normal_sample = c10::optional<double>(r * ::sin(theta));
     }
-  } else if (new_state_size == size_current) {
-    auto rng_state = (CPUGeneratorImplState*)new_state.data();
+  } else if (rng_state) {
     legacy_pod = &rng_state->legacy_pod;
     // update next_float_normal_sample
     if (rng_state->is_next_float_normal_sample_valid) {
@@ -175,7 +203,8 @@ void CPUGeneratorImpl::set_state(const c10::TensorImpl& new_state) {
     }
   } else {
     AT_ERROR("Expected either a CPUGeneratorImplStateLegacy of size ", size_legacy,
-             " or a CPUGeneratorImplState of size ", size_current,
+             ", a CPUGeneratorImplState of size ", size_current,
+             " or a CPUGeneratorImplStateCounterBased of size ", size_counter_based,
              " but found the input RNG state size to be ", new_state_size);
   }
 
@@ -194,6 +223,8 @@ void CPUGeneratorImpl::set_state(const c10::TensorImpl& new_state) {
   this->engine_ = engine;
   this->next_float_normal_sample_ = float_normal_sample;
   this->next_double_normal_sample_ = double_normal_sample;
+  this->counter_based_ = counter_based;
+  this->philox_offset_ = philox_offset;
 }
 
 /**
@@ -202,15 +233,19 @@ void CPUGeneratorImpl::set_state(const c10::TensorImpl& new_state) {
  */
 c10::intrusive_ptr<c10::TensorImpl> CPUGeneratorImpl::get_state() const {
   using detail::CPUGeneratorImplState;
+  using detail::CPUGeneratorImplStateCounterBased;
 
-  static const size_t size = sizeof(CPUGeneratorImplState);
+  // The generators in the default mode keep the state they always had
+  const size_t size = counter_based_ ? sizeof(CPUGeneratorImplStateCounterBased) : sizeof(CPUGeneratorImplState);
   static_assert(std::is_pod<CPUGeneratorImplState>::value, "CPUGeneratorImplState is not a PODType");
 
   auto state_tensor = at::detail::empty_cpu({(int64_t)size}, ScalarType::Byte, c10::nullopt, c10::nullopt, c10::nullopt, c10::nullopt);
   auto rng_state = state_tensor.data_ptr();
 
   // accumulate generator data to be copied into byte tensor
-  auto accum_state = std::make_unique<CPUGeneratorImplState>();
+  auto accum_counter_based_state = std::make_unique<CPUGeneratorImplStateCounterBased>();
+  accum_counter_based_state->philox_offset = this->philox_offset_;
+  auto accum_state = &accum_counter_based_state->state;
   auto rng_data = this->engine_.data();
   accum_state->legacy_pod.the_initial_seed = rng_data.seed_;
   accum_state->legacy_pod.left = rng_data.left_;
@@ -232,7 +267,7 @@ c10::intrusive_ptr<c10::TensorImpl> CPUGeneratorImpl::get_state() const {
     accum_state->next_float_normal_sample = *(this->next_float_normal_sample_);
   }
 
-  memcpy(rng_state, accum_state.get(), size);
+  memcpy(rng_state, accum_counter_based_state.get(), size);
   return state_tensor.getIntrusivePtr();
 }
 
@@ -296,6 +331,41 @@ void CPUGeneratorImpl::set_next_double_normal_sample(c10::optional<double> randn
   next_double_normal_sample_ = randn;
 }
 
+/**
+ * Note [Counter-based CPU generation]
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * The mt19937 engine produces one sequence, which uniform_, normal_ and
+ * bernoulli_ consume in order on a single thread while holding the lock of
+ * the generator. In counter-based mode these sample from the Philox engine
+ * instead, like the CUDA generators do: a call takes as many counters as it
+ * needs from the offset of the generator, and the i-th group of 4 random
+ * 32-bit numbers it uses is the block of counter offset + i for the current
+ * seed. Each chunk of a parallel_for can thus compute its numbers on its own,
+ * and the results don't depend on the number of threads.
+ *
+ * The other distributions keep drawing from the mt19937 engine, which is
+ * seeded along with the Philox engine by set_current_seed.
+ */
+void CPUGeneratorImpl::set_counter_based(bool counter_based) {
+  counter_based_ = counter_based;
+}
+
+bool CPUGeneratorImpl::is_counter_based() const {
+  return counter_based_;
+}
+
+/**
+ * Gets the seed and the first counter of the Philox engine for a call using
+ * `increment` counters, and moves the offset past them.
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+std::pair<uint64_t, uint64_t> CPUGeneratorImpl::philox_engine_inputs(uint64_t increment) {
+  uint64_t offset = philox_offset_;
+  philox_offset_ += increment;
+  return std::make_pair(current_seed(), offset);
+}
+
 /**
  * Get the engine of the CPUGeneratorImpl
  */
@@ -331,6 +401,8 @@ CPUGeneratorImpl* CPUGeneratorImpl::clone_impl() const {
   gen->set_engine(engine_);
   gen->set_next_float_normal_sample(next_float_normal_sample_);
   gen->set_next_double_normal_sample(next_double_normal_sample_);
+  gen->counter_based_ = counter_based_;
+  gen->philox_offset_ = philox_offset_;
   return gen;
 }
 
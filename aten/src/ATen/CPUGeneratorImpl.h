@@ -5,6 +5,8 @@
 #include <c10/util/Optional.h>
 #include <c10/core/GeneratorImpl.h>
 
+#include <utility>
+
 namespace at {
 
 struct TORCH_API CPUGeneratorImpl : public c10::GeneratorImpl {
@@ -29,11 +31,20 @@ struct TORCH_API CPUGeneratorImpl : public c10::GeneratorImpl {
   at::mt19937 engine();
   void set_engine(at::mt19937 engine);
 
+  // Counter-based mode, in which uniform_, normal_ and bernoulli_ draw from
+  // the Philox engine in parallel instead of from the mt19937 engine.
+  // See Note [Counter-based CPU generation]
+  void set_counter_based(bool counter_based);
+  bool is_counter_based() const;
+  std::pair<uint64_t, uint64_t> philox_engine_inputs(uint64_t increment);
+
 private:
   CPUGeneratorImpl* clone_impl() const override;
   at::mt19937 engine_;
   c10::optional<float> next_float_normal_sample_;
   c10::optional<double> next_double_normal_sample_;
+  bool counter_based_ = false;
+  uint64_t philox_offset_ = 0;
 };
 
 namespace detail {
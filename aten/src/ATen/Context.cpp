@@ -267,4 +267,20 @@ void Context::setDisplayVmapFallbackWarnings(bool enabled) {
   display_vmap_fallback_warnings_ = enabled;
 }
 
+bool Context::tensorIteratorCache() const {
+  return tensor_iterator_cache_;
+}
+
+void Context::setTensorIteratorCache(bool enabled) {
+  tensor_iterator_cache_ = enabled;
+}
+
+bool Context::trustedIndices() const {
+  return trusted_indices_;
+}
+
+void Context::setTrustedIndices(bool trusted) {
+  trusted_indices_ = trusted;
+}
+
 } // namespace at
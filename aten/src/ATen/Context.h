@@ -199,6 +199,17 @@ class TORCH_API Context {
   void setDisplayVmapFallbackWarnings(bool enabled);
   bool areVmapFallbackWarningsEnabled() const;
 
+  // Reuse the layouts computed by TensorIterator for operands of the same
+  // geometry, see Note [TensorIterator cache]. Off by default.
+  bool tensorIteratorCache() const;
+  void setTensorIteratorCache(bool);
+
+  // Skip the bounds checks of the indices of CUDA indexing ops which would
+  // otherwise run before the ops, see Note [Lazy index bounds checks]. Off by
+  // default.
+  bool trustedIndices() const;
+  void setTrustedIndices(bool);
+
  private:
   void initCUDAIfNeeded(DeviceType p) {
     if (p == DeviceType::CUDA) {
@@ -226,6 +237,8 @@ class TORCH_API Context {
   bool release_original_weights = false;
   #endif
   bool display_vmap_fallback_warnings_ = false;
+  bool tensor_iterator_cache_ = false;
+  bool trusted_indices_ = false;
   c10::optional<at::QEngine> quantized_engine = c10::nullopt;
   std::unique_ptr<THCState, void(*)(THCState*)> thc_state;
   std::unique_ptr<THHState, void(*)(THHState*)> thh_state;
@@ -0,0 +1,162 @@
+#include <ATen/NestedTensorImpl.h>
+
+#include <ATen/WrapDimUtils.h>
+#include <c10/util/Exception.h>
+
+namespace at {
+
+NestedTensorImpl::NestedTensorImpl(Tensor buffer, Tensor nested_size)
+  : TensorImpl(
+      c10::DispatchKeySet(DispatchKey::NestedTensor),
+      buffer.dtype(),
+      buffer.device()
+    )
+  , buffer_(std::move(buffer))
+  , nested_size_(std::move(nested_size))
+{
+  TORCH_INTERNAL_ASSERT(buffer_.defined() && buffer_.dim() == 1 && buffer_.is_contiguous());
+  TORCH_INTERNAL_ASSERT(
+      nested_size_.dim() == 2 && nested_size_.scalar_type() == kLong &&
+      nested_size_.device().is_cpu() && nested_size_.is_contiguous());
+
+  const auto ntensors = nested_size_.size(0);
+  const auto component_dim = nested_size_.size(1);
+  const auto* sizes = nested_size_.data_ptr<int64_t>();
+  offsets_.resize(ntensors + 1);
+  offsets_[0] = 0;
+  for (int64_t i = 0; i < ntensors; i++) {
+    int64_t numel = 1;
+    for (int64_t d = 0; d < component_dim; d++) {
+      TORCH_CHECK(sizes[i * component_dim + d] >= 0,
+          "nested tensor: expected components of non-negative sizes, got ",
+          component_size(i));
+      numel *= sizes[i * component_dim + d];
+    }
+    offsets_[i + 1] = offsets_[i] + numel;
+  }
+  TORCH_CHECK(offsets_[ntensors] == buffer_.numel(),
+      "nested tensor: the components of the nested size have ", offsets_[ntensors],
+      " elements, but the buffer has ", buffer_.numel());
+
+  opt_sizes_.resize(component_dim + 1);
+  opt_sizes_[0] = ntensors;
+  for (int64_t d = 0; d < component_dim; d++) {
+    if (ntensors == 0) {
+      continue;
+    }
+    int64_t size = sizes[d];
+    bool regular = true;
+    for (int64_t i = 1; i < ntensors && regular; i++) {
+      regular = sizes[i * component_dim + d] == size;
+    }
+    if (regular) {
+      opt_sizes_[d + 1] = size;
+    }
+  }
+
+  // Only the dim is held by sizes_and_strides_, see sizes()
+  sizes_and_strides_.resize(component_dim + 1);
+  numel_ = buffer_.numel();
+}
+
+IntArrayRef NestedTensorImpl::component_size(int64_t i) const {
+  const auto component_dim = nested_size_.size(1);
+  return IntArrayRef(nested_size_.data_ptr<int64_t>() + i * component_dim, component_dim);
+}
+
+Tensor NestedTensorImpl::component(int64_t i) const {
+  TORCH_CHECK_INDEX(i >= 0 && i < ntensors(),
+      "index ", i, " is out of bounds for a nested tensor of ", ntensors(), " components");
+  return buffer_.narrow(0, offsets_[i], offsets_[i + 1] - offsets_[i]).view(component_size(i));
+}
+
+c10::optional<int64_t> NestedTensorImpl::opt_size(int64_t dim) const {
+  dim = maybe_wrap_dim(dim, this->dim());
+  return opt_sizes_[dim];
+}
+
+// The following are publically exposed as methods of Tensor
+int64_t NestedTensorImpl::numel() const {
+  return buffer_.numel();
+}
+
+IntArrayRef NestedTensorImpl::sizes() const {
+  TORCH_CHECK(false, "nested tensors do not have sizes, as their components may have different sizes");
+}
+
+IntArrayRef NestedTensorImpl::strides() const {
+  TORCH_CHECK(false, "nested tensors do not have strides");
+}
+
+int64_t NestedTensorImpl::size(int64_t d) const {
+  auto size = opt_size(d);
+  TORCH_CHECK(size.has_value(),
+      "the dim ", d, " of the nested tensor is ragged, its components have different sizes along it");
+  return *size;
+}
+
+int64_t NestedTensorImpl::stride(int64_t d) const {
+  TORCH_CHECK(false, "nested tensors do not have strides");
+}
+
+bool NestedTensorImpl::is_contiguous(at::MemoryFormat memory_format) const {
+  return memory_format == MemoryFormat::Contiguous;
+}
+
+const Storage& NestedTensorImpl::storage() const {
+  TORCH_CHECK(false, "nested tensors do not have storage, the components are in their buffer");
+}
+
+// The following are some internal inherited methods that we do not support.
+// They should never get called.
+void NestedTensorImpl::set_size(int64_t dim, int64_t new_size) {
+  TORCH_INTERNAL_ASSERT(false, "Can't set_size for NestedTensorImpl");
+}
+void NestedTensorImpl::set_stride(int64_t dim, int64_t new_stride) {
+  TORCH_INTERNAL_ASSERT(false, "Can't set_stride for NestedTensorImpl");
+}
+void NestedTensorImpl::set_storage_offset(int64_t storage_offset) {
+  TORCH_INTERNAL_ASSERT(false, "Can't set_storage_offset for NestedTensorImpl");
+}
+#ifdef DEBUG
+bool NestedTensorImpl::has_storage() const {
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(!storage_, "NestedTensorImpl assumes that storage_ is never set");
+  return false;
+}
+#endif
+
+c10::intrusive_ptr<TensorImpl> NestedTensorImpl::shallow_copy_and_detach(
+    const c10::VariableVersion& version_counter,
+    bool allow_tensor_metadata_change) const {
+  auto impl = c10::make_intrusive<NestedTensorImpl>(buffer_, nested_size_);
+  copy_tensor_metadata(
+      /*src_impl=*/this,
+      /*dest_impl=*/impl.get(),
+      /*version_counter=*/version_counter,
+      /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
+  return impl;
+}
+
+c10::intrusive_ptr<TensorImpl> NestedTensorImpl::shallow_copy_and_detach(
+    c10::VariableVersion&& version_counter,
+    bool allow_tensor_metadata_change) const {
+  auto impl = c10::make_intrusive<NestedTensorImpl>(buffer_, nested_size_);
+  copy_tensor_metadata(
+      /*src_impl=*/this,
+      /*dest_impl=*/impl.get(),
+      /*version_counter=*/std::move(version_counter),
+      /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
+  return impl;
+}
+
+Tensor wrapNestedBuffer(Tensor buffer, Tensor nested_size) {
+  TORCH_CHECK(buffer.dim() == 1 && buffer.is_contiguous(),
+      "nested tensor: expected a 1-d contiguous buffer");
+  TORCH_CHECK(!buffer.requires_grad(), "nested tensors do not support autograd");
+  TORCH_CHECK(
+      nested_size.dim() == 2 && nested_size.scalar_type() == kLong && nested_size.device().is_cpu(),
+      "nested tensor: expected a 2-d int64 CPU nested size");
+  return at::detail::make_tensor<NestedTensorImpl>(std::move(buffer), nested_size.contiguous());
+}
+
+} // namespace at
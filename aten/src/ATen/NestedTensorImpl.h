@@ -0,0 +1,97 @@
+#pragma once
+
+#include <ATen/ArrayRef.h>
+#include <ATen/Tensor.h>
+#include <c10/core/TensorImpl.h>
+#include <c10/util/Optional.h>
+
+#include <vector>
+
+namespace at {
+
+// Note [Nested tensors]
+// A nested tensor holds a list of tensors of the same dtype, device and
+// dimension, its components, whose sizes may differ. For example, a batch of
+// sequences of lengths L_i of D features is the nested tensor of the [L_i, D]
+// components, which are stacked along its dim 0. A dim of a nested tensor is
+// regular when all of its components have the same size along it, and ragged
+// otherwise. Dim 0 is regular, of size ntensors; in the example, dim 1 is
+// ragged and dim 2 regular, of size D.
+//
+// The components are stored one after the other, contiguous, in a 1-d buffer,
+// without padding them to the same sizes. Their sizes are the rows of the
+// [ntensors, dim - 1] int64 CPU nested_size tensor. The ops of a nested tensor
+// are registered to DispatchKey::NestedTensor, and run on the whole buffer at
+// once when they don't mix up the components (the pointwise ops, and the ops
+// along regular trailing dims, like linear and layer_norm), or on each of the
+// components otherwise.
+//
+// Since some of its dims may be ragged, a nested tensor has no sizes, strides
+// or storage. It doesn't support autograd.
+struct TORCH_API NestedTensorImpl : public c10::TensorImpl {
+  explicit NestedTensorImpl(Tensor buffer, Tensor nested_size);
+
+  int64_t ntensors() const {
+    return nested_size_.size(0);
+  }
+  // The 1-d contiguous buffer of the components
+  const Tensor& buffer() const {
+    return buffer_;
+  }
+  // The sizes of the components, as the rows of an int64 CPU tensor
+  const Tensor& nested_size() const {
+    return nested_size_;
+  }
+  // The ntensors + 1 offsets of the components in the buffer
+  IntArrayRef offsets() const {
+    return offsets_;
+  }
+  IntArrayRef component_size(int64_t i) const;
+  // The i-th component, a view of the buffer
+  Tensor component(int64_t i) const;
+  // The size of dim, if it is regular
+  c10::optional<int64_t> opt_size(int64_t dim) const;
+
+  // Override a bunch of methods inherited from TensorImpl to return error messages.
+  int64_t numel() const override;
+  IntArrayRef sizes() const override;
+  IntArrayRef strides() const override;
+  int64_t size(int64_t d) const override;
+  int64_t stride(int64_t d) const override;
+  bool is_contiguous(at::MemoryFormat memory_format=at::MemoryFormat::Contiguous) const override;
+  void set_size(int64_t dim, int64_t new_size) override;
+  void set_stride(int64_t dim, int64_t new_stride) override;
+  void set_storage_offset(int64_t storage_offset) override;
+#ifdef DEBUG
+  bool has_storage() const override;
+#endif
+  const Storage& storage() const override;
+
+  c10::intrusive_ptr<TensorImpl> shallow_copy_and_detach(
+      const c10::VariableVersion& version_counter,
+      bool allow_tensor_metadata_change) const override;
+  c10::intrusive_ptr<TensorImpl> shallow_copy_and_detach(
+      c10::VariableVersion&& version_counter,
+      bool allow_tensor_metadata_change) const override;
+
+ private:
+  Tensor buffer_;
+  Tensor nested_size_;
+  std::vector<int64_t> offsets_;
+  std::vector<c10::optional<int64_t>> opt_sizes_;
+};
+
+inline bool isNestedTensor(const Tensor& tensor) {
+  return tensor.unsafeGetTensorImpl()->key_set().has(DispatchKey::NestedTensor);
+}
+
+inline NestedTensorImpl* getNestedTensorImpl(const Tensor& tensor) {
+  TORCH_CHECK(isNestedTensor(tensor), "expected a nested tensor");
+  return static_cast<NestedTensorImpl*>(tensor.unsafeGetTensorImpl());
+}
+
+// Creates the nested tensor of the components of the given sizes stored in
+// the buffer
+TORCH_API Tensor wrapNestedBuffer(Tensor buffer, Tensor nested_size);
+
+} // namespace at
@@ -30,7 +30,7 @@ struct TORCH_API OpaqueTensorImpl : public TensorImpl {
         opaque_handle_(std::move(opaque_handle)) {
     sizes_and_strides_.set_sizes(sizes);
     refresh_numel();
-    is_non_overlapping_and_dense_ = is_non_overlapping_and_dense;
+    set_non_overlapping_and_dense_flag(is_non_overlapping_and_dense);
   }
 
   void release_resources() override {
@@ -3,17 +3,32 @@
 #include <ATen/Parallel.h>
 #include <c10/core/thread_pool.h>
 
+#include <atomic>
+#include <memory>
+
 namespace at {
 
+// When NUMA is enabled, the threads run on the CPUs of numa_node_id, or are
+// spread evenly over the NUMA nodes if it's -1.
 class TORCH_API PTThreadPool : public c10::ThreadPool {
 public:
   explicit PTThreadPool(
       int pool_size,
       int numa_node_id = -1)
-    : c10::ThreadPool(pool_size, numa_node_id, [](){
-        c10::setThreadName("PTThreadPool");
-        at::init_num_threads();
-      }) {}
+    : c10::ThreadPool(
+          pool_size,
+          numa_node_id,
+          [numa_node_id,
+           num_threads = pool_size < 0 ? defaultNumThreads()
+                                       : static_cast<size_t>(pool_size),
+           next_index = std::make_shared<std::atomic<size_t>>(0)]() {
+            c10::setThreadName("PTThreadPool");
+            at::init_num_threads();
+            c10::NUMAPinCurrentThread(
+                numa_node_id >= 0
+                    ? numa_node_id
+                    : c10::GetNUMANodeForThread((*next_index)++, num_threads));
+          }) {}
 };
 
 } // namespace at
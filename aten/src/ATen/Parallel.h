@@ -1,8 +1,11 @@
 #pragma once
 #include <ATen/Config.h>
 #include <ATen/core/ivalue.h>
+#include <c10/core/thread_pool.h>
 #include <c10/macros/Macros.h>
 
+#include <atomic>
+
 namespace at {
 
 inline int64_t divup(int64_t x, int64_t y) {
@@ -122,6 +125,12 @@ TORCH_API int get_num_interop_threads();
 TORCH_API void launch(std::function<void()> func);
 namespace internal {
 void launch_no_thread_state(std::function<void()> fn);
+
+// The number of threads an intra-op parallel region may use: the intra-op
+// threads are shared evenly by the inter-op tasks running at the moment, so
+// that parallel regions run from concurrent inter-op tasks don't oversubscribe
+// the machine
+TORCH_API int intraop_thread_budget();
 } // namespace internal
 
 // Launches intra-op parallel task
@@ -134,6 +143,119 @@ TORCH_API std::shared_ptr<c10::ivalue::Future> intraop_launch_future(
 // Returns number of intra-op threads used by default
 TORCH_API int intraop_default_num_threads();
 
+/*
+Parallel stats
+
+Optional utilization counters of the parallel primitives and of the thread
+pools backing them, to tell whether a workload is bound by intra-op
+parallelism, inter-op queueing or oversubscription.
+
+While enabled, every parallel_for and parallel_reduce split into chunks times
+its chunks, and records the spread between its slowest and fastest chunk ("the
+imbalance"), and the calls falling back to running serially because they were
+made inside a parallel region and the backend can't nest parallel regions are
+counted. Each parallel region is also reported to the profiler as an
+"at::parallel_for" user scope. The thread pools created by the backend for
+intra-op and inter-op tasks count their queued and executed tasks, the time
+the tasks waited in the queue and the time each worker was busy or idle (see
+c10::ThreadPoolStats).
+*/
+struct TORCH_API ParallelStats {
+  uint64_t parallel_regions = 0;
+  uint64_t chunks = 0;
+  // Time spent running the chunks, summed over the chunks
+  uint64_t chunk_total_ns = 0;
+  // Sum and histogram, over the regions, of the imbalance
+  uint64_t imbalance_total_ns = 0;
+  c10::ThreadPoolStatsHistogram imbalance_histogram{};
+  uint64_t nested_fallbacks = 0;
+  // Stats of the thread pools created so far, e.g. "intra-op" and "inter-op"
+  std::vector<std::pair<std::string, c10::ThreadPoolStats>> pools;
+};
+
+// Starts or stops gathering the parallel stats. Enabling the stats resets
+// them.
+TORCH_API void set_parallel_stats_enabled(bool enabled);
+
+TORCH_API bool parallel_stats_enabled();
+
+TORCH_API ParallelStats get_parallel_stats();
+
+TORCH_API void reset_parallel_stats();
+
+struct RecordFunction;
+
+namespace internal {
+
+// Whether the parallel stats are enabled, as a global to keep the check
+// inline in the parallel primitives
+TORCH_API extern std::atomic<bool> parallel_stats_enabled_;
+
+// Makes the stats of a thread pool of the parallel backend part of the
+// parallel stats; the pool must live until the end of the process
+TORCH_API void _register_parallel_stats_pool(
+    std::string name,
+    c10::ThreadPool* pool);
+
+TORCH_API void _record_nested_parallel_fallback();
+
+inline void record_nested_parallel_fallback() {
+  if (C10_UNLIKELY(parallel_stats_enabled_.load(std::memory_order_relaxed))) {
+    _record_nested_parallel_fallback();
+  }
+}
+
+// Times the chunks of a parallel region while the parallel stats are
+// enabled, and records the region when destroyed. The chunks may run on any
+// thread.
+class TORCH_API ParallelRegionRecorder {
+ public:
+  // parallel is false for regions that end up running serially
+  explicit ParallelRegionRecorder(bool parallel = true)
+      : enabled_(
+            parallel && parallel_stats_enabled_.load(std::memory_order_relaxed)) {
+    if (C10_UNLIKELY(enabled_)) {
+      start();
+    }
+  }
+
+  ~ParallelRegionRecorder() {
+    if (C10_UNLIKELY(enabled_)) {
+      finish();
+    }
+  }
+
+  ParallelRegionRecorder(const ParallelRegionRecorder&) = delete;
+  ParallelRegionRecorder& operator=(const ParallelRegionRecorder&) = delete;
+
+  // Returns the start time of a chunk, to be passed to chunk_end
+  int64_t chunk_start() const {
+    return C10_UNLIKELY(enabled_) ? now_ns() : 0;
+  }
+
+  void chunk_end(int64_t start_ns) {
+    if (C10_UNLIKELY(enabled_)) {
+      add_chunk(now_ns() - start_ns);
+    }
+  }
+
+ private:
+  static int64_t now_ns();
+  void start();
+  void finish();
+  void add_chunk(int64_t ns);
+
+  const bool enabled_;
+  std::atomic<uint64_t> chunks_{0};
+  std::atomic<uint64_t> total_ns_{0};
+  std::atomic<int64_t> min_ns_{0};
+  std::atomic<int64_t> max_ns_{0};
+  // The profiler scope of the region, owned by the recorder
+  RecordFunction* record_function_ = nullptr;
+};
+
+} // namespace internal
+
 } // namespace at
 
 #if AT_PARALLEL_OPENMP
@@ -3,7 +3,11 @@
 #include <ATen/Config.h>
 #include <ATen/PTThreadPool.h>
 #include <ATen/Version.h>
+#include <ATen/record_function.h>
 
+#include <chrono>
+#include <limits>
+#include <mutex>
 #include <sstream>
 #include <thread>
 
@@ -40,8 +44,162 @@ size_t get_env_num_threads(const char* var_name, size_t def_value = 0) {
   return def_value;
 }
 
+struct ParallelStatsCounters {
+  std::atomic<uint64_t> parallel_regions{0};
+  std::atomic<uint64_t> chunks{0};
+  std::atomic<uint64_t> chunk_total_ns{0};
+  std::atomic<uint64_t> imbalance_total_ns{0};
+  std::array<std::atomic<uint64_t>, c10::kThreadPoolStatsNumBuckets>
+      imbalance_histogram;
+  std::atomic<uint64_t> nested_fallbacks{0};
+
+  ParallelStatsCounters() {
+    reset();
+  }
+
+  void reset() {
+    parallel_regions = 0;
+    chunks = 0;
+    chunk_total_ns = 0;
+    imbalance_total_ns = 0;
+    for (auto& bucket : imbalance_histogram) {
+      bucket = 0;
+    }
+    nested_fallbacks = 0;
+  }
+};
+
+ParallelStatsCounters& parallel_stats_counters() {
+  static ParallelStatsCounters counters;
+  return counters;
+}
+
+struct ParallelStatsPools {
+  std::mutex mutex;
+  std::vector<std::pair<std::string, c10::ThreadPool*>> pools;
+};
+
+// Leaked, like the pools registered in it
+ParallelStatsPools& parallel_stats_pools() {
+  static auto* pools = new ParallelStatsPools();
+  return *pools;
+}
+
 } // namespace
 
+namespace internal {
+
+std::atomic<bool> parallel_stats_enabled_{false};
+
+void _register_parallel_stats_pool(std::string name, c10::ThreadPool* pool) {
+  auto& pools = parallel_stats_pools();
+  std::lock_guard<std::mutex> guard(pools.mutex);
+  pool->enableStats(parallel_stats_enabled_.load());
+  pools.pools.emplace_back(std::move(name), pool);
+}
+
+void _record_nested_parallel_fallback() {
+  parallel_stats_counters().nested_fallbacks.fetch_add(
+      1, std::memory_order_relaxed);
+}
+
+int64_t ParallelRegionRecorder::now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void ParallelRegionRecorder::start() {
+  min_ns_ = std::numeric_limits<int64_t>::max();
+  auto record_function =
+      std::make_unique<RecordFunction>(RecordScope::USER_SCOPE);
+  if (record_function->isActive()) {
+    record_function->before("at::parallel_for");
+    record_function_ = record_function.release();
+  }
+}
+
+void ParallelRegionRecorder::add_chunk(int64_t ns) {
+  ns = std::max<int64_t>(ns, 0);
+  chunks_.fetch_add(1, std::memory_order_relaxed);
+  total_ns_.fetch_add(ns, std::memory_order_relaxed);
+  int64_t min_ns = min_ns_.load(std::memory_order_relaxed);
+  while (ns < min_ns &&
+         !min_ns_.compare_exchange_weak(min_ns, ns, std::memory_order_relaxed)) {
+  }
+  int64_t max_ns = max_ns_.load(std::memory_order_relaxed);
+  while (ns > max_ns &&
+         !max_ns_.compare_exchange_weak(max_ns, ns, std::memory_order_relaxed)) {
+  }
+}
+
+void ParallelRegionRecorder::finish() {
+  // Destroying the RecordFunction runs the end callbacks of the profiler
+  delete record_function_;
+  record_function_ = nullptr;
+
+  const uint64_t chunks = chunks_.load();
+  if (chunks == 0) {
+    return;
+  }
+  const auto imbalance_ns =
+      static_cast<uint64_t>(max_ns_.load() - min_ns_.load());
+  auto& counters = parallel_stats_counters();
+  counters.parallel_regions.fetch_add(1, std::memory_order_relaxed);
+  counters.chunks.fetch_add(chunks, std::memory_order_relaxed);
+  counters.chunk_total_ns.fetch_add(total_ns_.load(), std::memory_order_relaxed);
+  counters.imbalance_total_ns.fetch_add(imbalance_ns, std::memory_order_relaxed);
+  counters.imbalance_histogram[c10::threadPoolStatsBucket(imbalance_ns)]
+      .fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace internal
+
+void set_parallel_stats_enabled(bool enabled) {
+  auto& pools = parallel_stats_pools();
+  std::lock_guard<std::mutex> guard(pools.mutex);
+  if (enabled && !internal::parallel_stats_enabled_.load()) {
+    parallel_stats_counters().reset();
+  }
+  for (auto& pool : pools.pools) {
+    pool.second->enableStats(enabled);
+  }
+  internal::parallel_stats_enabled_ = enabled;
+}
+
+bool parallel_stats_enabled() {
+  return internal::parallel_stats_enabled_.load();
+}
+
+ParallelStats get_parallel_stats() {
+  ParallelStats stats;
+  const auto& counters = parallel_stats_counters();
+  stats.parallel_regions = counters.parallel_regions.load();
+  stats.chunks = counters.chunks.load();
+  stats.chunk_total_ns = counters.chunk_total_ns.load();
+  stats.imbalance_total_ns = counters.imbalance_total_ns.load();
+  for (size_t i = 0; i < c10::kThreadPoolStatsNumBuckets; ++i) {
+    stats.imbalance_histogram[i] = counters.imbalance_histogram[i].load();
+  }
+  stats.nested_fallbacks = counters.nested_fallbacks.load();
+
+  auto& pools = parallel_stats_pools();
+  std::lock_guard<std::mutex> guard(pools.mutex);
+  for (const auto& pool : pools.pools) {
+    stats.pools.emplace_back(pool.first, pool.second->getStats());
+  }
+  return stats;
+}
+
+void reset_parallel_stats() {
+  parallel_stats_counters().reset();
+  auto& pools = parallel_stats_pools();
+  std::lock_guard<std::mutex> guard(pools.mutex);
+  for (auto& pool : pools.pools) {
+    pool.second->resetStats();
+  }
+}
+
 std::string get_parallel_info() {
   std::ostringstream ss;
 
@@ -74,6 +232,8 @@ std::string get_parallel_info() {
   ss << "ATen parallel backend: ";
   #if AT_PARALLEL_OPENMP
   ss << "OpenMP";
+  #elif AT_PARALLEL_NATIVE_WORK_STEALING
+  ss << "native work-stealing thread pool";
   #elif AT_PARALLEL_NATIVE
   ss << "native thread pool";
   #elif AT_PARALLEL_NATIVE_TBB
@@ -11,6 +11,17 @@
 
 #include <atomic>
 
+#if AT_PARALLEL_NATIVE_WORK_STEALING
+#ifdef C10_MOBILE
+#error "The work-stealing parallel backend is not supported on mobile"
+#endif
+#include <algorithm>
+#include <condition_variable>
+#include <limits>
+#include <thread>
+#include <vector>
+#endif
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -65,16 +76,310 @@ int _num_pool_threads(int nthreads) {
   return nthreads - 1;
 }
 
+#if AT_PARALLEL_NATIVE_WORK_STEALING
+
+// Work-stealing scheduler used by _parallel_run in place of the intra-op
+// thread pool.
+//
+// The tasks of a parallel region are split into one contiguous range per
+// possible participant: the calling thread and every pool thread. A
+// participant runs tasks from the front of its own range and, once it is
+// empty, steals the back half of another participant's range, so threads
+// that finish early pick up the work of slow ones. Parallel regions started
+// from a task are scheduled the same way, which lets nested parallel_for
+// calls use idle threads instead of running serially.
+
+// Range of task ids [begin, end), packed into one word so that the owner
+// (which advances begin) and thieves (which lower end) can update it with a
+// single compare-and-swap.
+class TaskRange {
+ public:
+  void reset(uint32_t begin, uint32_t end) {
+    range_.store(pack(begin, end), std::memory_order_release);
+  }
+
+  bool empty() const {
+    const uint64_t range = range_.load(std::memory_order_acquire);
+    return begin_of(range) >= end_of(range);
+  }
+
+  bool pop_front(size_t& task) {
+    uint64_t range = range_.load(std::memory_order_acquire);
+    while (begin_of(range) < end_of(range)) {
+      if (range_.compare_exchange_weak(
+              range, pack(begin_of(range) + 1, end_of(range)),
+              std::memory_order_acq_rel)) {
+        task = begin_of(range);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool steal_back(uint32_t& begin, uint32_t& end) {
+    uint64_t range = range_.load(std::memory_order_acquire);
+    while (begin_of(range) < end_of(range)) {
+      const uint32_t mid = begin_of(range) + (end_of(range) - begin_of(range)) / 2;
+      if (range_.compare_exchange_weak(
+              range, pack(begin_of(range), mid), std::memory_order_acq_rel)) {
+        begin = mid;
+        end = end_of(range);
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  static uint64_t pack(uint32_t begin, uint32_t end) {
+    return (static_cast<uint64_t>(begin) << 32) | end;
+  }
+  static uint32_t begin_of(uint64_t range) {
+    return static_cast<uint32_t>(range >> 32);
+  }
+  static uint32_t end_of(uint64_t range) {
+    return static_cast<uint32_t>(range);
+  }
+
+  std::atomic<uint64_t> range_{0};
+  // Keep ranges of different participants on different cache lines.
+  char padding_[64 - sizeof(std::atomic<uint64_t>)];
+};
+
+// A single parallel region, owned by the thread that started it.
+struct ParallelJob {
+  ParallelJob(
+      size_t num_tasks,
+      size_t num_slots,
+      int max_workers,
+      const std::function<void(size_t)>& fn)
+      : fn(fn),
+        slots(num_slots),
+        remaining(num_tasks),
+        max_workers(max_workers) {
+    for (size_t i = 0; i < num_slots; ++i) {
+      slots[i].reset(num_tasks * i / num_slots, num_tasks * (i + 1) / num_slots);
+    }
+  }
+
+  bool has_work() const {
+    for (const auto& slot : slots) {
+      if (!slot.empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Runs tasks until there are none left to take.
+  void participate(size_t slot) {
+    size_t task;
+    while (slots[slot].pop_front(task) || steal(slot, task)) {
+      fn(task);
+      if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lk(mutex);
+        done = true;
+        cv.notify_all();
+      }
+    }
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> lk(mutex);
+    cv.wait(lk, [this] { return done; });
+  }
+
+  const std::function<void(size_t)>& fn;
+  std::vector<TaskRange> slots;
+  std::atomic<size_t> remaining;
+  // Pool threads joining the job at most, the tasks in the slots of the others
+  // are stolen
+  const int max_workers;
+  int active_workers = 0; // guarded by the pool's mutex
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done = false;
+
+ private:
+  // Steals the back half of another participant's range into our own slot
+  // and takes its first task.
+  bool steal(size_t slot, size_t& task) {
+    const size_t num_slots = slots.size();
+    for (size_t i = 1; i < num_slots; ++i) {
+      uint32_t begin, end;
+      if (slots[(slot + i) % num_slots].steal_back(begin, end)) {
+        slots[slot].reset(begin + 1, end);
+        task = begin;
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+// Participant slot of the current thread: 0 for threads outside the pool,
+// 1 + the thread's index for pool threads.
+thread_local size_t work_stealing_slot_ = 0;
+
+// When NUMA is enabled, the participants are spread over the NUMA nodes in
+// order of their slots (the calling thread is left where it is). The first
+// tasks, i.e. the first chunks of the range of a parallel_for, then run on
+// the first node and so on, so that the large buffers, whose pages are placed
+// by the threads first touching them (see alloc_cpu), are mostly accessed
+// from their own node by the later parallel_for over them. Thieves look at
+// the neighbouring slots first, which are mostly on the same node.
+class WorkStealingPool {
+ public:
+  explicit WorkStealingPool(size_t pool_size) {
+    threads_.reserve(pool_size);
+    for (size_t i = 0; i < pool_size; ++i) {
+      threads_.emplace_back([this, i, pool_size]() {
+        c10::setThreadName("PTWorkStealing");
+        init_num_threads();
+        c10::NUMAPinCurrentThread(
+            c10::GetNUMANodeForThread(i + 1, pool_size + 1));
+        main_loop(i);
+      });
+    }
+  }
+
+  ~WorkStealingPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_ = false;
+    }
+    job_added_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  size_t size() const {
+    return threads_.size();
+  }
+
+  // Runs fn(task_id) for task_id in [0, num_tasks) on the calling thread and
+  // at most max_workers pool threads, and waits for all of them.
+  void run(
+      size_t num_tasks,
+      int max_workers,
+      const std::function<void(size_t)>& fn) {
+    TORCH_INTERNAL_ASSERT(num_tasks <= std::numeric_limits<uint32_t>::max());
+    ParallelJob job(num_tasks, size() + 1, max_workers, fn);
+    if (size() > 0) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(&job);
+      }
+      job_added_.notify_all();
+    }
+
+    job.participate(work_stealing_slot_);
+    job.wait();
+
+    if (size() > 0) {
+      // Pool threads may still be looking at the job's ranges.
+      std::unique_lock<std::mutex> lock(mutex_);
+      jobs_.erase(std::find(jobs_.begin(), jobs_.end(), &job));
+      job_released_.wait(lock, [&job] { return job.active_workers == 0; });
+    }
+  }
+
+ private:
+  void main_loop(size_t index) {
+    work_stealing_slot_ = index + 1;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      ParallelJob* job = nullptr;
+      job_added_.wait(lock, [this, &job] {
+        return !running_ || (job = find_job()) != nullptr;
+      });
+      if (!running_) {
+        break;
+      }
+      ++job->active_workers;
+      lock.unlock();
+      job->participate(work_stealing_slot_);
+      lock.lock();
+      if (--job->active_workers == 0) {
+        job_released_.notify_all();
+      }
+    }
+  }
+
+  // Prefers the most recently started, i.e. the innermost, region.
+  ParallelJob* find_job() const {
+    for (auto it = jobs_.rbegin(); it != jobs_.rend(); ++it) {
+      if ((*it)->active_workers < (*it)->max_workers && (*it)->has_work()) {
+        return *it;
+      }
+    }
+    return nullptr;
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable job_added_;
+  std::condition_variable job_released_;
+  std::vector<ParallelJob*> jobs_;
+  bool running_ = true;
+};
+
+WorkStealingPool& _get_work_stealing_pool() {
+  static WorkStealingPool pool(
+      _num_pool_threads(num_intraop_threads.exchange(CONSUMED)));
+  return pool;
+}
+
+// Whether the thread pool used by intraop_launch has been created.
+std::atomic<bool> intraop_pool_created{false};
+
+// Thread pool for intraop_launch tasks, sized like the work-stealing pool.
+TaskThreadPoolBase& _get_intraop_pool() {
+  static std::shared_ptr<TaskThreadPoolBase> pool = []() {
+    auto pool = ThreadPoolRegistry()->Create(
+        "C10",
+        /* device_id */ 0,
+        /* pool_size */ _get_work_stealing_pool().size(),
+        /* create_new */ true);
+    if (auto* thread_pool = dynamic_cast<c10::ThreadPool*>(pool.get())) {
+      internal::_register_parallel_stats_pool("intra-op", thread_pool);
+    }
+    intraop_pool_created = true;
+    return pool;
+  }();
+  return *pool;
+}
+
+// Number of pool threads once the pool exists.
+size_t _get_pool_size() {
+  return _get_work_stealing_pool().size();
+}
+
+#else
+
 TaskThreadPoolBase& _get_intraop_pool() {
-  static std::shared_ptr<TaskThreadPoolBase> pool =
-      ThreadPoolRegistry()->Create(
-          "C10",
-          /* device_id */ 0,
-          /* pool_size */ _num_pool_threads(num_intraop_threads.exchange(CONSUMED)),
-          /* create_new */ true); // create a separate thread pool for intra-op
+  static std::shared_ptr<TaskThreadPoolBase> pool = []() {
+    auto pool = ThreadPoolRegistry()->Create(
+        "C10",
+        /* device_id */ 0,
+        /* pool_size */ _num_pool_threads(num_intraop_threads.exchange(CONSUMED)),
+        /* create_new */ true); // create a separate thread pool for intra-op
+    if (auto* thread_pool = dynamic_cast<c10::ThreadPool*>(pool.get())) {
+      internal::_register_parallel_stats_pool("intra-op", thread_pool);
+    }
+    return pool;
+  }();
   return *pool;
 }
 
+// Number of pool threads once the pool exists.
+size_t _get_pool_size() {
+  return _get_intraop_pool().size();
+}
+
+#endif // AT_PARALLEL_NATIVE_WORK_STEALING
+
 #endif // C10_MOBILE
 
 // Run lambda function `fn` over `task_id` in [0, `range`) with threadpool.
@@ -112,6 +417,27 @@ struct ParallelRegionGuard {
   }
 };
 
+#if AT_PARALLEL_NATIVE_WORK_STEALING
+// Like ParallelRegionGuard, but restores the enclosing region's state, since
+// tasks of nested regions run on threads that are already inside a region.
+struct NestedParallelRegionGuard {
+  NestedParallelRegionGuard(size_t thread_num)
+      : prev_thread_num_(thread_num_), prev_in_region_(in_parallel_region_) {
+    _set_thread_num(thread_num);
+    _set_in_parallel_region(true);
+  }
+
+  ~NestedParallelRegionGuard() {
+    _set_in_parallel_region(prev_in_region_);
+    _set_thread_num(prev_thread_num_);
+  }
+
+ private:
+  size_t prev_thread_num_;
+  bool prev_in_region_;
+};
+#endif // AT_PARALLEL_NATIVE_WORK_STEALING
+
 } // namespace
 
 namespace internal {
@@ -126,7 +452,36 @@ void _parallel_run(
   size_t num_tasks, chunk_size;
   std::tie(num_tasks, chunk_size) =
       internal::calc_num_tasks_and_chunk_size(begin, end, grain_size);
-
+  ParallelRegionRecorder recorder;
+
+#if AT_PARALLEL_NATIVE_WORK_STEALING
+  std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
+  std::exception_ptr eptr;
+  // There are more tasks than threads, so get_thread_num() reports the
+  // participant slot rather than the task id; it stays below
+  // get_num_threads() and is unique among concurrently running tasks.
+  _get_work_stealing_pool().run(
+      num_tasks,
+      /* max_workers */ internal::intraop_thread_budget() - 1,
+      [&f, &err_flag, &eptr, &recorder, begin, end, chunk_size](
+          size_t task_id) {
+        int64_t local_start = begin + task_id * chunk_size;
+        int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
+        try {
+          NestedParallelRegionGuard guard(work_stealing_slot_);
+          const int64_t start_ns = recorder.chunk_start();
+          f(local_start, local_end, task_id);
+          recorder.chunk_end(start_ns);
+        } catch (...) {
+          if (!err_flag.test_and_set()) {
+            eptr = std::current_exception();
+          }
+        }
+      });
+  if (eptr) {
+    std::rethrow_exception(eptr);
+  }
+#else
   struct {
     std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
     std::exception_ptr eptr;
@@ -135,14 +490,16 @@ void _parallel_run(
     std::condition_variable cv;
   } state;
 
-  auto task = [f, &state, begin, end, chunk_size]
+  auto task = [f, &state, &recorder, begin, end, chunk_size]
       (int /* unused */, size_t task_id) {
     int64_t local_start = begin + task_id * chunk_size;
     if (local_start < end) {
       int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
       try {
         ParallelRegionGuard guard(task_id);
+        const int64_t start_ns = recorder.chunk_start();
         f(local_start, local_end, task_id);
+        recorder.chunk_end(start_ns);
       } catch (...) {
         if (!state.err_flag.test_and_set()) {
           state.eptr = std::current_exception();
@@ -169,6 +526,7 @@ void _parallel_run(
   if (state.eptr) {
     std::rethrow_exception(state.eptr);
   }
+#endif // AT_PARALLEL_NATIVE_WORK_STEALING
 }
 
 } // namespace internal
@@ -197,7 +555,7 @@ void set_num_threads(int nthreads) {
     int stored_nthreads = num_intraop_threads.load();
     if (stored_nthreads <= 0) {
       // plus one because of master thread
-      stored_nthreads = _get_intraop_pool().size() + 1;
+      stored_nthreads = _get_pool_size() + 1;
     }
     if (stored_nthreads != nthreads) {
       TORCH_WARN(
@@ -224,7 +582,7 @@ int get_num_threads() {
     return intraop_default_num_threads();
   } else {
     TORCH_INTERNAL_ASSERT(nthreads == CONSUMED);
-    return _get_intraop_pool().size() + 1;
+    return _get_pool_size() + 1;
   }
 #else
   caffe2::PThreadPool* const pool = caffe2::pthreadpool();
@@ -238,7 +596,13 @@ int get_thread_num() {
 }
 
 bool in_parallel_region() {
-#ifndef C10_MOBILE
+#if AT_PARALLEL_NATIVE_WORK_STEALING
+  return in_parallel_region_ || (
+    intraop_pool_created.load() &&
+    // Needed as intraop_launch() doesn't set in_parallel_region().
+    _get_intraop_pool().inThreadPool()
+  );
+#elif !defined(C10_MOBILE)
   return in_parallel_region_ || (
     num_intraop_threads.load() == CONSUMED &&
     // Needed as intraop_launch() doesn't set in_parallel_region().
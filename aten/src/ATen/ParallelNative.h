@@ -9,13 +9,27 @@
 namespace at {
 namespace internal {
 
+#if AT_PARALLEL_NATIVE_WORK_STEALING
+// Tasks per thread created by parallel_for, so that threads which finish
+// early have work to steal from the others. Tasks are never smaller than
+// grain_size.
+constexpr int64_t TASKS_PER_THREAD = 4;
+#else
+constexpr int64_t TASKS_PER_THREAD = 1;
+#endif
+
+// The work-stealing scheduler also parallelizes parallel_for calls made from
+// inside a parallel region; the plain native pool runs them serially.
+constexpr bool NESTED_PARALLELISM = AT_PARALLEL_NATIVE_WORK_STEALING;
+
 inline std::tuple<size_t, size_t> calc_num_tasks_and_chunk_size(
     int64_t begin, int64_t end, int64_t grain_size) {
   if ((end - begin) < grain_size) {
     return std::make_tuple(1, std::max((int64_t)0, end - begin));
   }
   // Choose number of tasks based on grain size and number of threads.
-  size_t chunk_size = divup((end - begin), get_num_threads());
+  size_t chunk_size =
+      divup((end - begin), intraop_thread_budget() * TASKS_PER_THREAD);
   // Make sure each task is at least grain_size size.
   chunk_size = std::max((size_t)grain_size, chunk_size);
   size_t num_tasks = divup((end - begin), chunk_size);
@@ -40,7 +54,12 @@ inline void parallel_for(
   if (begin >= end) {
     return;
   }
-  if ((end - begin) < grain_size || in_parallel_region()) {
+  if ((end - begin) < grain_size) {
+    f(begin, end);
+    return;
+  }
+  if (!internal::NESTED_PARALLELISM && in_parallel_region()) {
+    internal::record_nested_parallel_fallback();
     f(begin, end);
     return;
   }
@@ -66,7 +85,11 @@ inline scalar_t parallel_reduce(
   if (begin >= end) {
     return ident;
   }
-  if ((end - begin) < grain_size || in_parallel_region()) {
+  if ((end - begin) < grain_size) {
+    return f(begin, end, ident);
+  }
+  if (!internal::NESTED_PARALLELISM && in_parallel_region()) {
+    internal::record_nested_parallel_fallback();
     return f(begin, end, ident);
   }
   size_t num_tasks, chunk_size;
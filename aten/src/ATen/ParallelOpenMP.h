@@ -30,7 +30,14 @@ inline void parallel_for(
   // returns false when omp_get_max_threads() == 1 inside nested "omp parallel"
   // See issue gh-32284
 
-#pragma omp parallel if (omp_get_max_threads() > 1 && !omp_in_parallel() && ((end - begin) > grain_size))
+  const bool use_parallel =
+      omp_get_max_threads() > 1 && !omp_in_parallel() && ((end - begin) > grain_size);
+  if (!use_parallel && in_parallel_region() && ((end - begin) > grain_size)) {
+    internal::record_nested_parallel_fallback();
+  }
+  internal::ParallelRegionRecorder recorder(use_parallel);
+
+#pragma omp parallel if (use_parallel)
   {
     // choose number of tasks based on grain size and number of threads
     // can't use num_threads clause due to bugs in GOMP's thread pool (See #32008)
@@ -44,7 +51,9 @@ inline void parallel_for(
     int64_t begin_tid = begin + tid * chunk_size;
     if (begin_tid < end) {
       try {
+        const int64_t start_ns = recorder.chunk_start();
         f(begin_tid, std::min(end, chunk_size + begin_tid));
+        recorder.chunk_end(start_ns);
       } catch (...) {
         if (!err_flag.test_and_set()) {
           eptr = std::current_exception();
@@ -73,6 +82,9 @@ inline scalar_t parallel_reduce(
   if (begin >= end) {
     return ident;
   } else if (in_parallel_region() || get_num_threads() == 1) {
+    if (in_parallel_region() && (end - begin) >= grain_size) {
+      internal::record_nested_parallel_fallback();
+    }
     return f(begin, end, ident);
   } else {
     const int64_t num_results = divup((end - begin), grain_size);
@@ -80,11 +92,14 @@ inline scalar_t parallel_reduce(
     scalar_t* results_data = results.data();
     std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
     std::exception_ptr eptr;
+    internal::ParallelRegionRecorder recorder((end - begin) >= grain_size);
 #pragma omp parallel for if ((end - begin) >= grain_size)
     for (int64_t id = 0; id < num_results; id++) {
       int64_t i = begin + id * grain_size;
       try {
+        const int64_t start_ns = recorder.chunk_start();
         results_data[id] = f(i, i + std::min(end - i, grain_size), ident);
+        recorder.chunk_end(start_ns);
       } catch (...) {
         if (!err_flag.test_and_set()) {
           eptr = std::current_exception();
@@ -4,6 +4,7 @@
 #include <ATen/PTThreadPool.h>
 #include <ATen/ThreadLocalState.h>
 
+#include <algorithm>
 #include <atomic>
 
 namespace at {
@@ -19,15 +20,25 @@ const int CONSUMED = -2;
 // NOT_SET -> CONSUMED
 std::atomic<int> num_interop_threads{NOT_SET};
 
+// Number of inter-op tasks running, see intraop_thread_budget()
+std::atomic<int> num_running_interop_tasks{0};
+
 // thread pool global instance is hidden,
 // users should use at::launch and get/set_num_interop_threads interface
 TaskThreadPoolBase& get_pool() {
-  static std::shared_ptr<TaskThreadPoolBase> pool =
-      ThreadPoolRegistry()->Create(
-          "C10",
-          /* device_id */ 0,
-          /* pool_size */ num_interop_threads.exchange(CONSUMED),
-          /* create_new */ true);
+  static std::shared_ptr<TaskThreadPoolBase> pool = []() {
+    auto pool = ThreadPoolRegistry()->Create(
+        "C10",
+        /* device_id */ 0,
+        /* pool_size */ num_interop_threads.exchange(CONSUMED),
+        /* create_new */ true);
+    if (auto* thread_pool = dynamic_cast<c10::ThreadPool*>(pool.get())) {
+      // See Note [Helping while waiting on futures]
+      thread_pool->setHelpWhileWaiting(true);
+      internal::_register_parallel_stats_pool("inter-op", thread_pool);
+    }
+    return pool;
+  }();
   return *pool;
 }
 
@@ -70,12 +81,29 @@ int get_num_interop_threads() {
 
 namespace internal {
 void launch_no_thread_state(std::function<void()> fn) {
+  auto counted_fn = [fn = std::move(fn)]() {
+    struct RunningTaskGuard {
+      RunningTaskGuard() {
+        num_running_interop_tasks++;
+      }
+      ~RunningTaskGuard() {
+        num_running_interop_tasks--;
+      }
+    } guard;
+    fn();
+  };
 #if AT_EXPERIMENTAL_SINGLE_THREAD_POOL
-  intraop_launch(std::move(fn));
+  intraop_launch(std::move(counted_fn));
 #else
-  get_pool().run(std::move(fn));
+  get_pool().run(std::move(counted_fn));
 #endif
 }
+
+int intraop_thread_budget() {
+  const int running = num_running_interop_tasks.load(std::memory_order_relaxed);
+  const int num_threads = get_num_threads();
+  return running > 1 ? std::max(num_threads / running, 1) : num_threads;
+}
 } // namespace internal
 
 void launch(std::function<void()> func) {
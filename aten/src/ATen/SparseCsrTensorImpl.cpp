@@ -0,0 +1,114 @@
+#include <ATen/ATen.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/InitialTensorOptions.h>
+
+namespace at {
+
+namespace {
+  DeviceType sparseCsrTensorSetToDeviceType(DispatchKeySet key_set) {
+    if (key_set.has(DispatchKey::SparseCsrCPU)) {
+      return kCPU;
+    } else if (key_set.has(DispatchKey::SparseCsrCUDA)) {
+      return kCUDA;
+    } else {
+      AT_ERROR("Cannot construct SparseCsrTensor with non-sparse CSR tensor type ID ", key_set);
+    }
+  }
+}
+
+// An empty sparse CSR tensor is a 0 x 0 matrix, which has a crow_indices of
+// a single zero and no col_indices or values.
+SparseCsrTensorImpl::SparseCsrTensorImpl(at::DispatchKeySet key_set, const caffe2::TypeMeta data_type)
+  :   SparseCsrTensorImpl(key_set, data_type
+      , at::zeros({1}, at::initialTensorOptions().device(sparseCsrTensorSetToDeviceType(key_set)).dtype(ScalarType::Long))
+      , at::empty({0}, at::initialTensorOptions().device(sparseCsrTensorSetToDeviceType(key_set)).dtype(ScalarType::Long))
+      , at::empty({0}, at::initialTensorOptions().device(sparseCsrTensorSetToDeviceType(key_set)).dtype(data_type))) {}
+
+SparseCsrTensorImpl::SparseCsrTensorImpl(
+    at::DispatchKeySet key_set,
+    const caffe2::TypeMeta data_type,
+    at::Tensor crow_indices,
+    at::Tensor col_indices,
+    at::Tensor values)
+    : TensorImpl(key_set, data_type, values.device())
+    , crow_indices_(std::move(crow_indices))
+    , col_indices_(std::move(col_indices))
+    , values_(std::move(values)) {
+  sizes_and_strides_.set_sizes({0, 0});
+  refresh_numel();
+  set_non_overlapping_and_dense_flag(false);
+}
+
+void SparseCsrTensorImpl::resize_and_clear_(int64_t nnz_size, IntArrayRef size) {
+  TORCH_CHECK(allow_tensor_metadata_change(), "resize_and_clear_ ", err_msg_tensor_metadata_change_not_allowed);
+  TORCH_CHECK(size.size() == 2, "sparse CSR tensors must be 2-D, but got size ", size);
+  TORCH_CHECK(nnz_size <= size[0] * size[1], "nnz (", nnz_size, ") must not exceed the number of elements of a ", size, " matrix");
+
+  crow_indices_ = at::zeros({size[0] + 1}, crow_indices_.options());
+  col_indices_ = at::empty({nnz_size}, col_indices_.options());
+  values_ = at::empty({nnz_size}, values_.options());
+  sizes_and_strides_.set_sizes(size);
+  refresh_numel();
+}
+
+void SparseCsrTensorImpl::set_member_tensors_unsafe(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values) {
+  TORCH_CHECK(allow_tensor_metadata_change(), "set_member_tensors_unsafe ", err_msg_tensor_metadata_change_not_allowed);
+
+  TORCH_CHECK(crow_indices.layout() == kStrided && col_indices.layout() == kStrided && values.layout() == kStrided,
+      "expected crow_indices, col_indices and values to be strided tensors, but got layouts ",
+      crow_indices.layout(), ", ", col_indices.layout(), " and ", values.layout());
+  TORCH_CHECK(values.device().type() == device().type(), "device type of values (", values.device().type(), ") must match device type of device().type()", device().type(), ")");
+  TORCH_CHECK(values.scalar_type() == typeMetaToScalarType(dtype()), "dtype of values (", values.scalar_type(), ") must match dtype of sparse tensor (", typeMetaToScalarType(dtype()), ")");
+  TORCH_CHECK(crow_indices.scalar_type() == kInt || crow_indices.scalar_type() == kLong,
+      "crow_indices must be an int32 or int64 tensor, but got ", crow_indices.scalar_type());
+  TORCH_CHECK(col_indices.scalar_type() == crow_indices.scalar_type(),
+      "col_indices and crow_indices must have the same dtype, but got ", col_indices.scalar_type(), " and ", crow_indices.scalar_type());
+  TORCH_CHECK(crow_indices.device() == values.device() && col_indices.device() == values.device(),
+      "crow_indices (", crow_indices.device(), "), col_indices (", col_indices.device(), ") and values (", values.device(),
+      ") must be on the same device");
+
+  TORCH_CHECK(crow_indices.dim() == 1 && col_indices.dim() == 1 && values.dim() == 1,
+      "crow_indices, col_indices and values must be 1-D, but got ", crow_indices.dim(), "-D, ",
+      col_indices.dim(), "-D and ", values.dim(), "-D tensors");
+  TORCH_CHECK(crow_indices.size(0) == size(0) + 1, "crow_indices must have rows + 1 (", size(0) + 1, ") elements, but got ", crow_indices.size(0));
+  TORCH_CHECK(col_indices.size(0) == values.size(0), "col_indices and values must have the same nnz, but got nnz from col_indices: ",
+      col_indices.size(0), ", nnz from values: ", values.size(0));
+
+  crow_indices_ = crow_indices;
+  col_indices_ = col_indices;
+  values_ = values;
+  AT_ASSERT(device() == values_.device());
+}
+
+IntArrayRef SparseCsrTensorImpl::strides() const {
+  AT_ERROR("sparse CSR tensors do not have strides");
+}
+bool SparseCsrTensorImpl::is_contiguous(at::MemoryFormat memory_format) const {
+  AT_ERROR("sparse CSR tensors do not have is_contiguous");
+}
+int64_t SparseCsrTensorImpl::stride(int64_t d) const {
+  AT_ERROR("sparse CSR tensors do not have strides");
+}
+void SparseCsrTensorImpl::set_size(int64_t dim, int64_t new_size) {
+  AT_ERROR("sparse CSR tensors do not have set_size");
+}
+void SparseCsrTensorImpl::set_stride(int64_t dim, int64_t new_stride) {
+  AT_ERROR("sparse CSR tensors do not have set_stride");
+}
+void SparseCsrTensorImpl::set_storage_offset(int64_t storage_offset) {
+  AT_ERROR("sparse CSR tensors do not have set_storage_offset");
+}
+#ifdef DEBUG
+bool SparseCsrTensorImpl::has_storage() const {
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(!storage_, "SparseCsrTensorImpl assumes that storage_ is never set");
+  return false;
+}
+#endif
+const Storage& SparseCsrTensorImpl::storage() const {
+  AT_ERROR("sparse CSR tensors do not have storage");
+}
+
+} // namespace at
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <c10/core/TensorImpl.h>
+#include <c10/util/Exception.h>
+
+namespace at {
+
+struct TORCH_API SparseCsrTensorImpl : public TensorImpl {
+  // A 2-D sparse matrix stored in the compressed sparse row (CSR) format.
+
+  // INVARIANTS:
+  // sizes: (rows, cols)
+  // crow_indices_.shape: (rows + 1), crow_indices_[0] == 0 and
+  //   crow_indices_[rows] == nnz; row i holds the elements
+  //   [crow_indices_[i], crow_indices_[i + 1]) of col_indices_ and values_
+  // col_indices_.shape: (nnz), sorted within each row, of the dtype of
+  //   crow_indices_ (int32 or int64)
+  // values_.shape: (nnz)
+  //
+  // Unlike the COO layout, this is the format that MKL sparse BLAS and
+  // cuSPARSE multiply with, so a matrix multiplied many times is
+  // compressed once rather than on every call.
+
+  Tensor crow_indices_;
+  Tensor col_indices_;
+  Tensor values_;
+
+ public:
+  explicit SparseCsrTensorImpl(at::DispatchKeySet, const caffe2::TypeMeta);
+
+  int64_t nnz() const { return values_.size(0); }
+  Tensor crow_indices() const { return crow_indices_; }
+  Tensor col_indices() const { return col_indices_; }
+  Tensor values() const { return values_; }
+
+  IntArrayRef strides() const override;
+  bool is_contiguous(at::MemoryFormat memory_format=at::MemoryFormat::Contiguous) const override;
+  int64_t stride(int64_t d) const override;
+  void set_size(int64_t dim, int64_t new_size) override;
+  void set_stride(int64_t dim, int64_t new_stride) override;
+  void set_storage_offset(int64_t storage_offset) override;
+
+#ifdef DEBUG
+  bool has_storage() const override;
+#endif
+  const Storage& storage() const override;
+
+  // WARNING: This function does NOT preserve the invariants of the indices
+  // and values with respect to the size
+  void raw_resize_(IntArrayRef size) {
+    TORCH_CHECK(allow_tensor_metadata_change(), "raw_resize_ ", err_msg_tensor_metadata_change_not_allowed);
+    TORCH_CHECK(size.size() == 2, "sparse CSR tensors must be 2-D, but got size ", size);
+    sizes_and_strides_.set_sizes(size);
+    refresh_numel();
+  }
+
+  // NOTE: this function will resize the sparse tensor and also set its
+  // indices and values to those of an empty matrix.
+  void resize_and_clear_(int64_t nnz_size, IntArrayRef size);
+
+  // Takes the indices and values and directly puts them into the sparse
+  // tensor, no copy.
+  // NOTE: this function is unsafe because it doesn't check whether the
+  // indices are within bounds or sorted, so it should ONLY be used where
+  // they are known to form a valid CSR matrix of sizes().
+  void set_member_tensors_unsafe(
+      const Tensor& crow_indices,
+      const Tensor& col_indices,
+      const Tensor& values);
+
+  /**
+   * Return a TensorImpl that is a shallow-copy of this TensorImpl.
+   *
+   * For usage of `version_counter` and `allow_tensor_metadata_change`,
+   * see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  c10::intrusive_ptr<TensorImpl> shallow_copy_and_detach(
+      const c10::VariableVersion& version_counter,
+      bool allow_tensor_metadata_change) const override {
+    auto impl = c10::make_intrusive<SparseCsrTensorImpl>(key_set(), dtype());
+    copy_tensor_metadata(
+      /*src_impl=*/this,
+      /*dest_impl=*/impl.get(),
+      /*version_counter=*/version_counter,
+      /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
+    impl->refresh_numel();
+    return impl;
+  }
+
+  /**
+   * Return a TensorImpl that is a shallow-copy of this TensorImpl.
+   *
+   * For usage of `version_counter` and `allow_tensor_metadata_change`,
+   * see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  c10::intrusive_ptr<TensorImpl> shallow_copy_and_detach(
+      c10::VariableVersion&& version_counter,
+      bool allow_tensor_metadata_change) const override {
+    auto impl = c10::make_intrusive<SparseCsrTensorImpl>(key_set(), dtype());
+    copy_tensor_metadata(
+      /*src_impl=*/this,
+      /*dest_impl=*/impl.get(),
+      /*version_counter=*/std::move(version_counter),
+      /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
+    impl->refresh_numel();
+    return impl;
+  }
+
+  /**
+   * Shallow-copies data from another TensorImpl into this TensorImpl.
+   *
+   * For why this function doesn't check this TensorImpl's `allow_tensor_metadata_change_`,
+   * see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  void shallow_copy_from(const c10::intrusive_ptr<TensorImpl>& impl) override {
+    AT_ASSERT(has_compatible_shallow_copy_type(impl->key_set()));
+    auto sparse_impl = static_cast<const SparseCsrTensorImpl*>(impl.get());
+    copy_tensor_metadata(
+      /*src_impl=*/sparse_impl,
+      /*dest_impl=*/this,
+      /*version_counter=*/version_counter(),
+      /*allow_tensor_metadata_change=*/allow_tensor_metadata_change());
+    refresh_numel();
+  }
+
+ private:
+  explicit SparseCsrTensorImpl(
+      at::DispatchKeySet,
+      const caffe2::TypeMeta,
+      at::Tensor crow_indices,
+      at::Tensor col_indices,
+      at::Tensor values);
+
+  /**
+   * Copy the tensor metadata fields (e.g. sizes / strides / storage pointer / storage_offset)
+   * from one TensorImpl to another TensorImpl.
+   *
+   * For usage of `version_counter` and `allow_tensor_metadata_change`, see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  static void copy_tensor_metadata(
+      const SparseCsrTensorImpl* src_sparse_impl,
+      SparseCsrTensorImpl* dest_sparse_impl,
+      const c10::VariableVersion& version_counter,
+      bool allow_tensor_metadata_change) {
+    TensorImpl::copy_tensor_metadata(src_sparse_impl, dest_sparse_impl, version_counter, allow_tensor_metadata_change);
+
+    // Sparse CSR specific fields
+    dest_sparse_impl->crow_indices_ = src_sparse_impl->crow_indices();
+    dest_sparse_impl->col_indices_ = src_sparse_impl->col_indices();
+    dest_sparse_impl->values_ = src_sparse_impl->values();
+  }
+};
+
+} // namespace at
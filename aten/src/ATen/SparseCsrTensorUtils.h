@@ -0,0 +1,32 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/SparseCsrTensorImpl.h>
+
+namespace at { namespace sparse_csr {
+
+// Just for documentary purposes
+using SparseCsrTensor = Tensor;
+
+// This is an internal utility function for getting at the
+// SparseCsrTensorImpl, so that we can write sparse CSR tensor specific
+// accessors for special fields in SparseCsrTensor.  You should only use this
+// for writing low level setters/getters for SparseCsrTensorImpl fields;
+// otherwise, you should use the low level setters/getters that were
+// implemented using this.
+//
+// This may be called repeatedly, so make sure it's pretty cheap.
+inline SparseCsrTensorImpl* get_sparse_csr_impl(const SparseCsrTensor& self) {
+  TORCH_INTERNAL_ASSERT(self.is_sparse_csr(), "_internal_get_SparseCsrTensorImpl: not a sparse CSR tensor");
+  return static_cast<SparseCsrTensorImpl*>(self.unsafeGetTensorImpl());
+}
+
+// The row index of each element of a CSR matrix, i.e. the indices[0] of
+// the equivalent COO matrix, as an int64 tensor
+inline Tensor crow_to_row_indices(const Tensor& crow_indices) {
+  const int64_t rows = crow_indices.numel() - 1;
+  const auto row_counts = (crow_indices.narrow(0, 1, rows) - crow_indices.narrow(0, 0, rows)).to(kLong);
+  return at::repeat_interleave(row_counts);
+}
+
+}} // namespace at::sparse_csr
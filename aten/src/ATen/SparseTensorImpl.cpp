@@ -49,7 +49,7 @@ SparseTensorImpl::SparseTensorImpl(at::DispatchKeySet key_set, const caffe2::Typ
   AT_ASSERT(values_.device() == indices_.device());
   AT_ASSERT(values_.device() == device());
 
-  is_non_overlapping_and_dense_ = false;
+  set_non_overlapping_and_dense_flag(false);
 }
 
 IntArrayRef SparseTensorImpl::strides() const {
@@ -7,6 +7,12 @@
 #include <ATen/MemoryOverlap.h>
 #include <ATen/native/Resize.h>
 #include <ATen/TensorOperators.h>
+#include <ATen/core/Vitals.h>
+#include <c10/util/OverheadProbe.h>
+#include <c10/util/hash.h>
+
+#include <atomic>
+#include <unordered_map>
 
 namespace at {
 
@@ -426,6 +432,10 @@ void TensorIteratorBase::compute_types(const TensorIteratorConfig& config) {
 
     // Promotes inputs by creating temporaries of the correct dtype
       if (config.promote_inputs_to_common_dtype_ && !op.is_output && op.current_dtype != common_dtype_) {
+        // promoting a scalar is cheap
+        if (op.tensor.dim() > 0) {
+          TORCH_SLOW_PATH(TYPE_PROMOTION_COPY);
+        }
         op.original_tensor = op.tensor;
         op.tensor = op.tensor.to(common_dtype_);
         op.current_dtype = common_dtype_;
@@ -920,21 +930,30 @@ TensorIterator TensorIterator::reduce_op(Tensor& out, const Tensor& a) {
 }
 
 TensorIterator TensorIterator::reduce_op(Tensor& out1, Tensor& out2, const Tensor& a) {
+  return reduce_op(TensorList{out1, out2}, a);
+}
+
+TensorIterator TensorIterator::reduce_op(TensorList outs, const Tensor& a) {
+  TORCH_INTERNAL_ASSERT(!outs.empty());
+  const Tensor& out1 = outs[0];
   TORCH_INTERNAL_ASSERT(out1.defined());
-  TORCH_INTERNAL_ASSERT(out2.defined());
-  TORCH_CHECK((!a.is_cuda() && !out1.is_cuda() && !out2.is_cuda()) || (a.device() == out1.device() && out1.device() == out2.device()),
-      "reduce_op(): expected input and both outputs to be on same device, but input is on ", a.device(),
-      ", output1 is on ", out1.device(), " and output2 is on", out2.device());
-  TORCH_CHECK(out1.dim() == out2.dim(), "reduce_op(): expected both outputs to have same number of dims, but output1 has ", out1.dim(),
-      " and output2 has ", out2.dim());
-  TORCH_CHECK(out1.sizes() == out2.sizes(), "reduce_op(): expected both outputs to have same sizes, but output1 has ", out1.sizes(),
-      " and output2 has ", out2.sizes());
-  TORCH_CHECK(out1.strides() == out2.strides(), "reduce_op(): expected both outputs to have same strides, but output1 has ", out1.strides(),
-      " and output2 has ", out2.strides());
-  return TensorIteratorConfig()
-    .set_check_mem_overlap(false)
-    .add_output(out1)
-    .add_output(out2)
+  TensorIteratorConfig config;
+  config.set_check_mem_overlap(false);
+  for (size_t i = 0; i < outs.size(); i++) {
+    const Tensor& out = outs[i];
+    TORCH_INTERNAL_ASSERT(out.defined());
+    TORCH_CHECK((!a.is_cuda() && !out1.is_cuda() && !out.is_cuda()) || (a.device() == out1.device() && out1.device() == out.device()),
+        "reduce_op(): expected input and all outputs to be on same device, but input is on ", a.device(),
+        ", output1 is on ", out1.device(), " and output", i + 1, " is on", out.device());
+    TORCH_CHECK(out1.dim() == out.dim(), "reduce_op(): expected all outputs to have same number of dims, but output1 has ", out1.dim(),
+        " and output", i + 1, " has ", out.dim());
+    TORCH_CHECK(out1.sizes() == out.sizes(), "reduce_op(): expected all outputs to have same sizes, but output1 has ", out1.sizes(),
+        " and output", i + 1, " has ", out.sizes());
+    TORCH_CHECK(out1.strides() == out.strides(), "reduce_op(): expected all outputs to have same strides, but output1 has ", out1.strides(),
+        " and output", i + 1, " has ", out.strides());
+    config.add_output(out);
+  }
+  return config
     .add_input(a)
     .resize_outputs(false)
     .is_reduction(true)
@@ -1250,9 +1269,214 @@ FastSetupType TensorIteratorBase::compute_fast_setup_type(const TensorIteratorCo
   return FastSetupType::NONE;
 }
 
+// Note [TensorIterator cache]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Besides the data pointers, what build() computes only depends on the
+// configuration and on the geometry of the operands: their sizes, strides,
+// dtypes and devices, and which inputs are also outputs. When the cache is
+// enabled (at::globalContext().setTensorIteratorCache, or
+// torch._C._set_tensor_iterator_cache from Python) the shape, permutation,
+// strides and dtypes computed for a key made of these are kept, and the
+// following iterators of the same key only allocate their outputs and bind
+// their data pointers, which on small tensors is most of the cost of an op.
+//
+// The memory overlap checks are still run for each iterator. The iterators
+// with named operands, meta tensors, outputs to resize or temporaries of the
+// common dtype are neither cached nor looked up. The cache is per thread, so
+// it needs no lock, and is emptied when it reaches kMaxCacheEntries.
+namespace {
+
+constexpr size_t kMaxCacheEntries = 1024;
+
+// the same type as TensorIteratorBase::CacheKey
+using CacheKey = SmallVector<int64_t, 32>;
+
+struct CachedOperand {
+  StrideVector stride_bytes;
+  ScalarType target_dtype;
+  Device device = kCPU;
+  // the geometry of an output allocated by the iterator
+  bool allocated = false;
+  DimVector sizes;
+  DimVector strides;
+};
+
+struct CacheEntry {
+  DimVector shape;
+  DimVector perm;
+  bool has_coalesced_dimensions;
+  bool all_ops_same_shape;
+  ScalarType common_dtype;
+  SmallVector<CachedOperand, 4> operands;
+};
+
+struct CacheKeyHash {
+  size_t operator()(const CacheKey& key) const {
+    size_t hash = key.size();
+    for (const auto value : key) {
+      hash = c10::hash_combine(hash, std::hash<int64_t>()(value));
+    }
+    return hash;
+  }
+};
+
+using Cache = std::unordered_map<CacheKey, CacheEntry, CacheKeyHash>;
+
+Cache& thread_cache() {
+  static thread_local Cache cache;
+  return cache;
+}
+
+std::atomic<uint64_t> cache_hits{0};
+std::atomic<uint64_t> cache_misses{0};
+
+// Prints the lookups as the TensorIteratorCache vital at exit
+struct CacheVitalReporter {
+  ~CacheVitalReporter() {
+    const auto stats = get_tensor_iterator_cache_stats();
+    if (!vitals::torchVitalEnabled() || stats.hits + stats.misses == 0) {
+      return;
+    }
+    vitals::TorchVital vital("TensorIteratorCache");
+    vital.create("hits") << stats.hits;
+    vital.create("misses") << stats.misses;
+  }
+};
+
+CacheVitalReporter cache_vital_reporter;
+
+} // namespace
+
+TensorIteratorCacheStats get_tensor_iterator_cache_stats() {
+  TensorIteratorCacheStats stats;
+  stats.hits = cache_hits.load(std::memory_order_relaxed);
+  stats.misses = cache_misses.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void reset_tensor_iterator_cache() {
+  thread_cache().clear();
+  cache_hits.store(0, std::memory_order_relaxed);
+  cache_misses.store(0, std::memory_order_relaxed);
+}
+
+// Called after mark_outputs, returns false if the iterator can't be cached
+bool TensorIteratorBase::compute_cache_key(const TensorIteratorConfig& config, CacheKey& key) const {
+  if (is_meta_) {
+    return false;
+  }
+  key.push_back(
+      config.check_mem_overlap_ | config.allow_cpu_scalars_ << 1 |
+      config.is_reduction_ << 2 | config.resize_outputs_ << 3 |
+      config.check_all_same_dtype_ << 4 | config.check_all_same_device_ << 5 |
+      config.enforce_safe_casting_to_output_ << 6 |
+      config.promote_inputs_to_common_dtype_ << 7 |
+      config.promote_integer_inputs_to_float_ << 8 |
+      config.cast_common_dtype_to_outputs_ << 9);
+  key.push_back(num_outputs_);
+  key.push_back(static_cast<int64_t>(c10::typeMetaToScalarType(c10::get_default_dtype())));
+  if (config.static_shape_.has_value()) {
+    key.push_back(config.static_shape_->size());
+    key.append(config.static_shape_->begin(), config.static_shape_->end());
+  } else {
+    key.push_back(-1);
+  }
+  if (config.static_dtype_and_device_.has_value()) {
+    key.push_back(static_cast<int64_t>(config.static_dtype_and_device_->first));
+    key.push_back(static_cast<int64_t>(config.static_dtype_and_device_->second.type()));
+    key.push_back(config.static_dtype_and_device_->second.index());
+  } else {
+    key.push_back(-1);
+  }
+  for (const auto& op : operands_) {
+    const auto& t = op.tensor;
+    if (!t.defined()) {
+      key.push_back(-1);
+      continue;
+    }
+    if (t.has_names()) {
+      return false;
+    }
+    key.push_back(static_cast<int64_t>(op.current_dtype));
+    key.push_back(static_cast<int64_t>(op.device.type()));
+    key.push_back(op.device.index());
+    key.push_back(op.is_read_write | t.unsafeGetTensorImpl()->is_wrapped_number() << 1);
+    key.push_back(t.dim());
+    key.append(t.sizes().begin(), t.sizes().end());
+    key.append(t.strides().begin(), t.strides().end());
+  }
+  return true;
+}
+
+bool TensorIteratorBase::build_from_cache(const CacheKey& key) {
+  auto& cache = thread_cache();
+  const auto it = cache.find(key);
+  if (it == cache.end()) {
+    cache_misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  cache_hits.fetch_add(1, std::memory_order_relaxed);
+  const auto& entry = it->second;
+  shape_ = entry.shape;
+  perm_ = entry.perm;
+  has_coalesced_dimensions_ = entry.has_coalesced_dimensions;
+  all_ops_same_shape_ = entry.all_ops_same_shape;
+  common_dtype_ = entry.common_dtype;
+  for (int i = 0; i < ntensors(); i++) {
+    auto& op = operands_[i];
+    const auto& cached = entry.operands[i];
+    op.stride_bytes = cached.stride_bytes;
+    op.target_dtype = cached.target_dtype;
+    op.device = cached.device;
+    if (i < num_outputs_) {
+      if (cached.allocated) {
+        set_output(i, cached.sizes, cached.strides, op.options(), {});
+      } else {
+        set_output(i, op.tensor.sizes(), {}, op.tensor.options(), {});
+      }
+      op.current_dtype = op.target_dtype;
+    }
+  }
+  return true;
+}
+
+void TensorIteratorBase::store_in_cache(CacheKey key, const DimMask& allocated_outputs) const {
+  CacheEntry entry;
+  for (const auto& op : operands_) {
+    // the outputs to resize and the temporaries depend on more than the key
+    if (op.will_resize || op.original_tensor.defined()) {
+      return;
+    }
+  }
+  entry.shape = shape_;
+  entry.perm = perm_;
+  entry.has_coalesced_dimensions = has_coalesced_dimensions_;
+  entry.all_ops_same_shape = all_ops_same_shape_;
+  entry.common_dtype = common_dtype_;
+  for (int i = 0; i < ntensors(); i++) {
+    const auto& op = operands_[i];
+    CachedOperand cached;
+    cached.stride_bytes = op.stride_bytes;
+    cached.target_dtype = op.target_dtype;
+    cached.device = op.device;
+    cached.allocated = i < num_outputs_ && allocated_outputs[i];
+    if (cached.allocated) {
+      cached.sizes = DimVector(op.tensor.sizes());
+      cached.strides = DimVector(op.tensor.strides());
+    }
+    entry.operands.push_back(std::move(cached));
+  }
+  auto& cache = thread_cache();
+  if (cache.size() >= kMaxCacheEntries) {
+    cache.clear();
+  }
+  cache.emplace(std::move(key), std::move(entry));
+}
+
 TensorIteratorBase::TensorIteratorBase() {}
 
 void TensorIteratorBase::build(TensorIteratorConfig& config) {
+  C10_OVERHEAD_PROBE(TENSOR_ITERATOR_BUILD);
   // populate some persistent configuration fields
   is_reduction_ = config.is_reduction_;
 
@@ -1263,27 +1487,42 @@ void TensorIteratorBase::build(TensorIteratorConfig& config) {
   // Check that the outputs have no internal overlap
   // and do not share memory with inputs.
   compute_mem_overlaps(config);
-  // Check that input dimensions are aligned correctly & compute outnames.
-  compute_names(config);
-  // compute the broadcasted shape
-  compute_shape(config);
-  // mark outputs for resizing if necessary
-  mark_resize_outputs(config);
-  // compute the result dtype and device
-  compute_types(config);
-  // try fast setup output tensor, if failed, fallback to normal setup
-  if (!fast_set_up(config)) {
-    // compute each tensor's stride after broadcasting
-    compute_strides(config);
-    // re-order dimensions to improve coalescing
-    reorder_dimensions();
-    // allocate the output tensor if it's not provided
-    allocate_or_resize_outputs();
-    // coalesce adjacent dimensions when possible
-    if (!is_meta_) coalesce_dimensions();
-  }
-
-  if (is_meta_) return;
+
+  // See Note [TensorIterator cache]
+  CacheKey cache_key;
+  const bool use_cache = at::globalContext().tensorIteratorCache() &&
+      compute_cache_key(config, cache_key);
+  if (!use_cache || !build_from_cache(cache_key)) {
+    DimMask allocated_outputs;
+    for (int i = 0; i < num_outputs_; i++) {
+      allocated_outputs[i] = !operands_[i].tensor.defined();
+    }
+    // Check that input dimensions are aligned correctly & compute outnames.
+    compute_names(config);
+    // compute the broadcasted shape
+    compute_shape(config);
+    // mark outputs for resizing if necessary
+    mark_resize_outputs(config);
+    // compute the result dtype and device
+    compute_types(config);
+    // try fast setup output tensor, if failed, fallback to normal setup
+    if (!fast_set_up(config)) {
+      // compute each tensor's stride after broadcasting
+      compute_strides(config);
+      // re-order dimensions to improve coalescing
+      reorder_dimensions();
+      // allocate the output tensor if it's not provided
+      allocate_or_resize_outputs();
+      // coalesce adjacent dimensions when possible
+      if (!is_meta_) coalesce_dimensions();
+    }
+
+    if (is_meta_) return;
+
+    if (use_cache) {
+      store_in_cache(std::move(cache_key), allocated_outputs);
+    }
+  }
 
   for (auto& op : operands_) {
     TORCH_INTERNAL_ASSERT(op.tensor.defined());
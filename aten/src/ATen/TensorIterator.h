@@ -320,6 +320,12 @@ protected:
   void propagate_names_to_outputs();
   void coalesce_dimensions();
 
+  // See Note [TensorIterator cache]
+  using CacheKey = SmallVector<int64_t, 32>;
+  bool compute_cache_key(const TensorIteratorConfig&, CacheKey& key) const;
+  bool build_from_cache(const CacheKey& key);
+  void store_in_cache(CacheKey key, const DimMask& allocated_outputs) const;
+
 protected:
 
   /// Records the "computation" shape of the output tensor.  The computation
@@ -421,6 +427,9 @@ struct TORCH_API TensorIterator final : public TensorIteratorBase {
   static TensorIterator nullary_op(Tensor& out);
   static TensorIterator reduce_op(Tensor& out, const Tensor& a);
   static TensorIterator reduce_op(Tensor& out1, Tensor& out2, const Tensor& a);
+  // A reduction of a into all of outs in a single pass; the outputs must have
+  // the same sizes and strides.
+  static TensorIterator reduce_op(TensorList outs, const Tensor& a);
 
   const Tensor& maybe_get_output(int64_t output_idx) override;
   void set_output(int64_t output_idx, IntArrayRef sizes, IntArrayRef strides, TensorOptions options, DimnameList names) override;
@@ -529,6 +538,17 @@ private:
 
 
 
+/// The lookups of the TensorIterator cache (see Note [TensorIterator cache])
+/// since the start of the process or the last reset, in all the threads.
+struct TensorIteratorCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+};
+
+TORCH_API TensorIteratorCacheStats get_tensor_iterator_cache_stats();
+/// Resets the counts and empties the cache of the calling thread.
+TORCH_API void reset_tensor_iterator_cache();
+
 /// A container-like struct that acts as if it contains splits of a
 /// TensorIterator that can use 32-bit indexing. Taken together the splits cover
 /// the original TensorIterator.
@@ -1,5 +1,7 @@
 #include <ATen/ThreadLocalState.h>
 
+#include <c10/core/InferenceMode.h>
+
 #if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
 #include <ATen/core/grad_mode.h>
 #endif
@@ -10,6 +12,7 @@ namespace at {
 
 ThreadLocalState::ThreadLocalState(bool keep_grad_mode)
     : dispatch_key_(c10::impl::tls_local_dispatch_key_set()),
+      inference_mode_enabled_(c10::InferenceMode::is_enabled()),
       debug_info_(c10::ThreadLocalDebugInfo::current()) {
   rf_tls_ = at::get_record_function_tls_();
 
@@ -25,6 +28,9 @@ ThreadLocalState::ThreadLocalState(bool keep_grad_mode)
 /* static */
 void ThreadLocalState::setThreadLocalState(
     const ThreadLocalState& state) {
+  // before grad mode, which can't be set in inference mode
+  c10::InferenceMode::_set_enabled(state.inference_mode_enabled_);
+
 #if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
   if (state.keep_grad_mode_) {
     GradMode::set_enabled(state.grad_mode_enabled_);
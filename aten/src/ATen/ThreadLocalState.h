@@ -26,6 +26,8 @@ class TORCH_API ThreadLocalState {
  private:
   c10::impl::LocalDispatchKeySet dispatch_key_;
 
+  bool inference_mode_enabled_;
+
   // ThreadLocalDebugInfo does not change after being created
   // with DebugInfoGuard
   std::shared_ptr<c10::ThreadLocalDebugInfo> debug_info_;
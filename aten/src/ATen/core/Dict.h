@@ -1,5 +1,6 @@
 #pragma once
 
+#include <c10/core/impl/SmallObjectPool.h>
 #include <c10/macros/Macros.h>
 #include <c10/util/TypeTraits.h>
 #include <c10/util/TypeList.h>
@@ -31,6 +32,10 @@ namespace detail {
 
 struct DictKeyHash {
   size_t operator()(const IValue& ivalue) const;
+
+ private:
+  // The hash cached by the string, see ConstantString::hash()
+  static size_t stringHash(const IValue& ivalue);
 };
 
 struct DictKeyEqualTo {
@@ -38,12 +43,26 @@ struct DictKeyEqualTo {
 };
 
 struct DictImpl final : public c10::intrusive_ptr_target {
-  using dict_map_type = ska_ordered::order_preserving_flat_hash_map<IValue, IValue, DictKeyHash, DictKeyEqualTo>;
+  // The table of even an empty map is allocated, so it comes from the small
+  // object pool as well, see Note [Small object pool]
+  using dict_map_type = ska_ordered::order_preserving_flat_hash_map<
+      IValue,
+      IValue,
+      DictKeyHash,
+      DictKeyEqualTo,
+      c10::impl::SmallObjectAllocator<std::pair<IValue, IValue>>>;
   struct DictElementTypes final {
     TypePtr keyType;
     TypePtr valueType;
   };
 
+  // Dicts with string keys of up to this size are searched linearly, which
+  // compares the keys by identity first and doesn't hash the key.
+  static constexpr size_t kMaxLinearSearchSize = 8;
+
+  // See Note [Small object pool]
+  C10_SMALL_OBJECT_POOL_ALLOCATION_FUNCTIONS
+
   explicit DictImpl(dict_map_type dict_, DictElementTypes elementTypes_)
   : dict(std::move(dict_))
   , elementTypes(std::move(elementTypes_)) {}
@@ -51,6 +70,7 @@ struct DictImpl final : public c10::intrusive_ptr_target {
 
   DictElementTypes elementTypes;
 
+  dict_map_type::iterator find(const IValue& key);
   intrusive_ptr<DictImpl> copy() const;
   friend TORCH_API bool operator==(const DictImpl& lhs, const DictImpl& rhs);
 };
@@ -41,7 +41,7 @@ inline size_t DictKeyHash::operator()(const IValue& ivalue) const {
   if (ivalue.isInt()) {
     return std::hash<int64_t>()(ivalue.toInt());
   } else if (ivalue.isString()) {
-    return std::hash<std::string>()(ivalue.toStringRef());
+    return stringHash(ivalue);
   } else if (ivalue.isDouble()) {
     return std::hash<double>()(ivalue.toDouble());
   } else if (ivalue.isComplexDouble()) {
@@ -56,6 +56,18 @@ inline size_t DictKeyHash::operator()(const IValue& ivalue) const {
   }
 }
 
+inline DictImpl::dict_map_type::iterator DictImpl::find(const IValue& key) {
+  if (key.isString() && dict.size() <= kMaxLinearSearchSize) {
+    for (auto iter = dict.begin(); iter != dict.end(); ++iter) {
+      if (iter->first.isString() && DictKeyEqualTo()(iter->first, key)) {
+        return iter;
+      }
+    }
+    return dict.end();
+  }
+  return dict.find(key);
+}
+
 inline intrusive_ptr<DictImpl> DictImpl::copy() const {
   return make_intrusive<DictImpl>(dict, elementTypes);
 }
@@ -159,12 +171,16 @@ C10_NODISCARD size_t Dict<Key, Value>::erase(const Key& key) const {
 
 template<class Key, class Value>
 Value Dict<Key, Value>::at(const Key& key) const {
-  return impl_->dict.at(key).template to<Value>();
+  auto found = impl_->find(key);
+  if (found == impl_->dict.end()) {
+    throw std::out_of_range("Argument passed to at() was not in the map.");
+  }
+  return found->second.template to<Value>();
 }
 
 template<class Key, class Value>
 typename Dict<Key, Value>::iterator Dict<Key, Value>::find(const Key& key) const {
-  return iterator{impl_->dict.find(key)};
+  return iterator{impl_->find(key)};
 }
 
 template<class Key, class Value>
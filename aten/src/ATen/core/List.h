@@ -1,5 +1,6 @@
 #pragma once
 
+#include <c10/core/impl/SmallObjectPool.h>
 #include <c10/macros/Macros.h>
 #include <c10/util/TypeTraits.h>
 #include <c10/util/TypeList.h>
@@ -21,7 +22,12 @@ using TypePtr = std::shared_ptr<Type>;
 namespace detail {
 
 struct ListImpl final : public c10::intrusive_ptr_target {
-  using list_type = std::vector<IValue>;
+  // The elements come from the small object pool as well, see Note [Small
+  // object pool]
+  using list_type = std::vector<IValue, c10::impl::SmallObjectAllocator<IValue>>;
+
+  // See Note [Small object pool]
+  C10_SMALL_OBJECT_POOL_ALLOCATION_FUNCTIONS
 
   explicit ListImpl(list_type list_, TypePtr elementType_)
   : list(std::move(list_))
@@ -72,13 +72,13 @@ impl::GenericList toList(List<T> list) {
 
 template<class T>
 List<T>::List(List&& rhs) noexcept: impl_(std::move(rhs.impl_)) {
-  rhs.impl_ = make_intrusive<c10::detail::ListImpl>(std::vector<IValue>{}, impl_->elementType);
+  rhs.impl_ = make_intrusive<c10::detail::ListImpl>(typename c10::detail::ListImpl::list_type(), impl_->elementType);
 }
 
 template<class T>
 List<T>& List<T>::operator=(List&& rhs) noexcept {
   impl_ = std::move(rhs.impl_);
-  rhs.impl_ = make_intrusive<c10::detail::ListImpl>(std::vector<IValue>{}, impl_->elementType);
+  rhs.impl_ = make_intrusive<c10::detail::ListImpl>(typename c10::detail::ListImpl::list_type(), impl_->elementType);
   return *this;
 }
 
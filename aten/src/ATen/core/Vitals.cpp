@@ -30,5 +30,67 @@ bool torchVitalEnabled() {
   return enabled;
 }
 
+namespace detail {
+std::atomic<uint64_t> slow_path_counts[kNumSlowPaths] = {};
+} // namespace detail
+
+const char* slowPathName(SlowPath path) {
+  switch (path) {
+    case SlowPath::NON_CONTIGUOUS_COPY:
+      return "non_contiguous_copy";
+    case SlowPath::DYNAMIC_CASTING:
+      return "dynamic_casting";
+    case SlowPath::TYPE_PROMOTION_COPY:
+      return "type_promotion_copy";
+    case SlowPath::AUTOCAST_CACHE_MISS:
+      return "autocast_cache_miss";
+    case SlowPath::CUDNN_CONV_FALLBACK:
+      return "cudnn_conv_fallback";
+    case SlowPath::MKLDNN_REORDER:
+      return "mkldnn_reorder";
+    default:
+      return "unknown";
+  }
+}
+
+uint64_t slowPathCount(SlowPath path) {
+  return detail::slow_path_counts[static_cast<size_t>(path)].load(
+      std::memory_order_relaxed);
+}
+
+std::unordered_map<std::string, uint64_t> getSlowPathCounts() {
+  std::unordered_map<std::string, uint64_t> counts;
+  for (size_t i = 0; i < kNumSlowPaths; ++i) {
+    const auto path = static_cast<SlowPath>(i);
+    counts.emplace(slowPathName(path), slowPathCount(path));
+  }
+  return counts;
+}
+
+void resetSlowPathCounts() {
+  for (auto& count : detail::slow_path_counts) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+namespace {
+// Prints the slow paths taken as the SlowPath vital at exit
+struct SlowPathVitalReporter {
+  ~SlowPathVitalReporter() {
+    if (!torchVitalEnabled()) {
+      return;
+    }
+    TorchVital vital("SlowPath");
+    for (const auto& kv : getSlowPathCounts()) {
+      if (kv.second > 0) {
+        vital.create(kv.first) << kv.second;
+      }
+    }
+  }
+};
+
+SlowPathVitalReporter slow_path_vital_reporter;
+} // namespace
+
 } // namespace at
 } // namespace vitals
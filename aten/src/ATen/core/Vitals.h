@@ -1,7 +1,11 @@
 #pragma once
+#include <c10/macros/Export.h>
+#include <atomic>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <sstream>
+#include <string>
 #include <unordered_map>
 
 namespace at {
@@ -40,6 +44,50 @@ struct TorchVital {
   }
 };
 
+// Note [Slow path counters]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+// Always-on counters of the times the slow paths below are taken, e.g. to
+// find out that production traffic copies non-contiguous inputs without a
+// profiler run. Counting is a relaxed atomic increment, on paths that are
+// at least an allocation or a copy anyway. The counts can be read at any
+// time, from Python with torch._C._get_slow_path_counts, and are printed as
+// the SlowPath vital at exit when TORCH_VITAL is set.
+enum class SlowPath : uint8_t {
+  // contiguous() copying its input
+  NON_CONTIGUOUS_COPY = 0,
+  // CUDA TensorIterator kernels casting their operands on the fly
+  DYNAMIC_CASTING,
+  // TensorIterator copying an input to the common dtype
+  TYPE_PROMOTION_COPY,
+  // autocast casting a weight that wasn't in its cache
+  AUTOCAST_CACHE_MISS,
+  // CUDA convolution run by the native kernels rather than cuDNN
+  CUDNN_CONV_FALLBACK,
+  // conversion between a dense and an MKL-DNN tensor or weight layout
+  MKLDNN_REORDER,
+  NUM_SLOW_PATHS // must be the last in the list
+};
+
+constexpr size_t kNumSlowPaths = static_cast<size_t>(SlowPath::NUM_SLOW_PATHS);
+
+TORCH_API const char* slowPathName(SlowPath path);
+
+namespace detail {
+TORCH_API extern std::atomic<uint64_t> slow_path_counts[kNumSlowPaths];
+} // namespace detail
+
+inline void recordSlowPath(SlowPath path) {
+  detail::slow_path_counts[static_cast<size_t>(path)].fetch_add(
+      1, std::memory_order_relaxed);
+}
+
+TORCH_API uint64_t slowPathCount(SlowPath path);
+
+// The counts by slowPathName
+TORCH_API std::unordered_map<std::string, uint64_t> getSlowPathCounts();
+
+TORCH_API void resetSlowPathCounts();
+
 } // namespace at
 } // namespace vitals
 
@@ -48,3 +96,6 @@ struct TorchVital {
 #define TORCH_VITAL_DEFINE(name) TorchVital TorchVital_##name(#name);
 
 #define TORCH_VITAL(name, attr) TorchVital_##name.create(#attr)
+
+#define TORCH_SLOW_PATH(path) \
+  ::at::vitals::recordSlowPath(::at::vitals::SlowPath::path)
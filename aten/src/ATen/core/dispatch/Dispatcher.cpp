@@ -62,6 +62,8 @@ c10::optional<OperatorHandle> Dispatcher::findSchema(const OperatorName& overloa
   auto it = findOp(overload_name);
   if (it.has_value()) {
     if (it->hasSchema()) {
+      // See Note [Lazy schema registration]
+      it->operatorIterator_->op.parseSchemaIfPending();
       return it;
     } else {
       return c10::nullopt;
@@ -149,11 +151,33 @@ RegistrationHandleRAII Dispatcher::registerDef(FunctionSchema schema, std::strin
   });
 }
 
+RegistrationHandleRAII Dispatcher::registerUnparsedDef(OperatorName op_name, std::string schema_string, std::string debug) {
+  // we need a lock to avoid concurrent writes
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto op = findOrRegisterName_(op_name);
+
+  TORCH_CHECK(op.operatorIterator_->def_count == 0, "Tried to register an operator (", schema_string, ") with the same name and overload name multiple times.",
+                                                    " Each overload's schema should only be registered with a single call to def().",
+                                                    " Duplicate registration: ", debug, ". Original registration: ", op.operatorIterator_->op.debug());
+  op.operatorIterator_->op.registerUnparsedSchema(std::move(schema_string), std::move(debug));
+  listeners_->callOnOperatorRegistered(op);
+
+  // NB: do not increment the counts until AFTER error checking
+  ++op.operatorIterator_->def_count;
+  ++op.operatorIterator_->def_and_impl_count;
+
+  return RegistrationHandleRAII([this, op, op_name] {
+    deregisterDef_(op, op_name);
+  });
+}
+
 void Dispatcher::deregisterDef_(const OperatorHandle& op, const OperatorName& op_name) {
   // we need a lock to avoid concurrent writes
   std::lock_guard<std::mutex> lock(mutex_);
 
-  TORCH_INTERNAL_ASSERT(op.schema().operator_name() == op_name);
+  // Not op.schema(), which would parse a schema that was never looked up
+  TORCH_INTERNAL_ASSERT(op.operator_name() == op_name);
 
   // reduce def_count and actually deregister if no references left
   TORCH_INTERNAL_ASSERT(op.operatorIterator_->def_count > 0);
@@ -307,6 +331,17 @@ std::vector<OperatorHandle> Dispatcher::findDanglingImpls() const {
   });
 }
 
+std::vector<OperatorName> Dispatcher::getAllOpNames() const {
+  return operatorLookupTable_.read([&] (const ska::flat_hash_map<OperatorName, OperatorHandle>& operatorLookupTable) -> std::vector<OperatorName> {
+    std::vector<OperatorName> allOpNames;
+    allOpNames.reserve(operatorLookupTable.size());
+    for (const auto& op : operatorLookupTable) {
+      allOpNames.push_back(op.first);
+    }
+    return allOpNames;
+  });
+}
+
 int64_t Dispatcher::sequenceNumberForRunningRecordFunction(DispatchKey dispatchKey) {
   int64_t seq_num = -1;
   // Setting sequence number in the Autograd case to associate
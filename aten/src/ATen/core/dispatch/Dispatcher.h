@@ -9,6 +9,7 @@
 #include <ATen/record_function.h>
 #include <c10/util/Exception.h>
 #include <c10/util/LeftRight.h>
+#include <c10/util/OverheadProbe.h>
 #include <mutex>
 #include <list>
 
@@ -164,6 +165,14 @@ public:
    */
   RegistrationHandleRAII registerDef(FunctionSchema schema, std::string debug);
 
+  /**
+   * Like registerDef, but only records the schema string; it is parsed when
+   * the operator is first looked up.  op_name must be the name the schema
+   * string defines, with its namespace applied.
+   * See Note [Lazy schema registration]
+   */
+  RegistrationHandleRAII registerUnparsedDef(OperatorName op_name, std::string schema_string, std::string debug);
+
   /**
    * Register a kernel to the dispatch table for an operator.
    * If dispatch_key is nullopt, then this registers a fallback kernel.
@@ -240,6 +249,13 @@ public:
    */
   std::vector<OperatorHandle> findDanglingImpls() const;
 
+  /**
+   * Returns the names of all of the registered operators, with or without a
+   * schema. This doesn't parse the schemas of the operators that were defined
+   * lazily, see Note [Lazy schema registration].
+   */
+  std::vector<OperatorName> getAllOpNames() const;
+
 private:
   Dispatcher();
 
@@ -314,6 +330,10 @@ public:
     return operatorIterator_->op.checkInvariants();
   }
 
+  bool hasKernelForDispatchKey(DispatchKey k) const {
+    return operatorIterator_->op.hasKernelForDispatchKey(k);
+  }
+
   template<class FuncType>
   TypedOperatorHandle<FuncType> typed() const {
     // NB: This assert is not 100% sound: you can retrieve a typed() operator
@@ -396,6 +416,7 @@ inline Return Dispatcher::callWithDispatchKey(const TypedOperatorHandle<Return(A
     return callWithDispatchKeySlowPath<Return, Args...>(op, pre_sampled, dispatchKey, kernel, std::forward<Args>(args)...);
   }
 #endif  // PYTORCH_DISABLE_PER_OP_PROFILING
+  C10_OVERHEAD_PROBE(KERNEL);
   return kernel.template call<Return, Args...>(op, std::forward<Args>(args)...);
 }
 
@@ -418,12 +439,14 @@ inline Return Dispatcher::callWithDispatchKeySlowPath(const TypedOperatorHandle<
     }
   }
   // keeping the guard alive while executing the kernel
+  C10_OVERHEAD_PROBE(KERNEL);
   return kernel.template call<Return, Args...>(op, std::forward<Args>(args)...);
 }
 
 template<class Return, class... Args>
 inline Return Dispatcher::call(const TypedOperatorHandle<Return(Args...)>& op, Args... args) const {
   detail::unused_arg_(args...);  // workaround for a false-positive warning about unused parameters in gcc 5
+  C10_OVERHEAD_PROBE(DISPATCH);
   auto dispatchKey = op.operatorIterator_->op.dispatchKeyExtractor()
     .template getDispatchKeyUnboxed<Args...>(
       DispatchKeySet::FULL,
@@ -435,6 +458,7 @@ inline Return Dispatcher::call(const TypedOperatorHandle<Return(Args...)>& op, A
 template<class Return, class... Args>
 inline Return Dispatcher::redispatch(const TypedOperatorHandle<Return (Args...)>& op, DispatchKey currentDispatchKey, Args... args) const {
   detail::unused_arg_(args...);  // workaround for a false-positive warning about unused parameters in gcc 5
+  C10_OVERHEAD_PROBE(DISPATCH);
   auto dispatchKey = op.operatorIterator_->op.dispatchKeyExtractor()
     .template getDispatchKeyUnboxed<Args...>(
       DispatchKeySet(DispatchKeySet::FULL_AFTER, currentDispatchKey),
@@ -442,12 +466,16 @@ inline Return Dispatcher::redispatch(const TypedOperatorHandle<Return (Args...)>
     );
   // do not use RecordFunction on redispatch
   const KernelFunction& kernel = op.operatorIterator_->op.lookup(dispatchKey);
+  C10_OVERHEAD_PROBE(KERNEL);
   return kernel.template call<Return, Args...>(op, std::forward<Args>(args)...);
 }
 
 inline void Dispatcher::callBoxed(const OperatorHandle& op, Stack* stack) const {
   // note: this doesn't need the mutex because write operations on the list keep iterators intact.
+  C10_OVERHEAD_PROBE(DISPATCH);
   const auto& entry = op.operatorIterator_->op;
+  // The boxed key extraction needs the schema, see Note [Lazy schema registration]
+  entry.parseSchemaIfPending();
   auto dispatchKey = entry.dispatchKeyExtractor().getDispatchKeyBoxed(stack);
   const auto& kernel = entry.lookup(dispatchKey);
 
@@ -466,10 +494,12 @@ inline void Dispatcher::callBoxed(const OperatorHandle& op, Stack* stack) const
       }
     }
     // keeping the guard alive while executing the kernel
+    C10_OVERHEAD_PROBE(KERNEL);
     kernel.callBoxed(op, stack);
     return;
   }
 #endif  // PYTORCH_DISABLE_PER_OP_PROFILING
+  C10_OVERHEAD_PROBE(KERNEL);
   kernel.callBoxed(op, stack);
 }
 
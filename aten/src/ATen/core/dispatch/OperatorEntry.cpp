@@ -2,6 +2,7 @@
 #include <ATen/core/op_registration/infer_schema.h>
 #include <ATen/core/dispatch/Dispatcher.h>
 #include <ATen/core/dispatch/ObservedOperators.h>
+#include <torch/csrc/jit/frontend/function_schema_parser.h>
 
 namespace c10 {
 namespace impl {
@@ -50,7 +51,12 @@ const AnnotatedKernel OperatorEntry::ambiguousAutogradOtherKernel_ = AnnotatedKe
     c10::KernelFunction::makeAmbiguousAutogradOther(), nullptr, "ambiguous_autogradother");
 
 void OperatorEntry::registerSchema(FunctionSchema&& schema, std::string&& debug) {
-  TORCH_INTERNAL_ASSERT(!schema_.has_value());
+  std::lock_guard<std::mutex> lock(schema_mutex_);
+  TORCH_INTERNAL_ASSERT(!schema_.has_value() && !schema_pending_.load(std::memory_order_relaxed));
+  registerSchema_(std::move(schema), std::move(debug));
+}
+
+void OperatorEntry::registerSchema_(FunctionSchema&& schema, std::string&& debug) const {
   for (auto i = kernels_.begin(); i != kernels_.end(); ++i) {
     for (auto j = i->second.begin(); j != i->second.end(); ++j) {
       if (j->inferred_function_schema != nullptr) {
@@ -63,7 +69,45 @@ void OperatorEntry::registerSchema(FunctionSchema&& schema, std::string&& debug)
   schema_ = AnnotatedSchema(std::move(schema), std::move(debug));
 }
 
+void OperatorEntry::registerUnparsedSchema(std::string&& schema_string, std::string&& debug) {
+  std::lock_guard<std::mutex> lock(schema_mutex_);
+  TORCH_INTERNAL_ASSERT(!schema_.has_value() && !schema_pending_.load(std::memory_order_relaxed));
+  unparsed_schema_ = std::move(schema_string);
+  unparsed_schema_debug_ = std::move(debug);
+  schema_pending_.store(true, std::memory_order_release);
+}
+
+void OperatorEntry::parseSchema_() const {
+  std::lock_guard<std::mutex> lock(schema_mutex_);
+  if (!schema_pending_.load(std::memory_order_relaxed)) {
+    // Another thread parsed it while we were waiting for the lock
+    return;
+  }
+  // A parse error leaves the schema pending, so every lookup reports it
+  FunctionSchema schema = torch::jit::parseSchema(unparsed_schema_);
+  schema.setAliasAnalysis(AliasAnalysisKind::FROM_SCHEMA);
+  if (!schema.getNamespace().has_value()) {
+    const auto ns_end = name_.name.find("::");
+    TORCH_INTERNAL_ASSERT(ns_end != std::string::npos, "Operator ", name_, " has no namespace");
+    schema.setNamespaceIfNotSet(name_.name.substr(0, ns_end).c_str());
+  }
+  TORCH_CHECK(schema.operator_name() == name_,
+    "The schema \"", unparsed_schema_, "\" was registered for operator ", name_,
+    " but defines a different one.  ", unparsed_schema_debug_);
+  registerSchema_(std::move(schema), std::move(unparsed_schema_debug_));
+  std::string().swap(unparsed_schema_);
+  schema_pending_.store(false, std::memory_order_release);
+}
+
 void OperatorEntry::deregisterSchema() {
+  std::lock_guard<std::mutex> lock(schema_mutex_);
+  if (schema_pending_.load(std::memory_order_relaxed)) {
+    // Never looked up, so there is nothing to undo
+    std::string().swap(unparsed_schema_);
+    std::string().swap(unparsed_schema_debug_);
+    schema_pending_.store(false, std::memory_order_release);
+    return;
+  }
   TORCH_INTERNAL_ASSERT(schema_.has_value());
   schema_ = c10::nullopt;
   dispatchKeyExtractor_.deregisterSchema();
@@ -77,6 +121,7 @@ std::list<AnnotatedKernel>::iterator OperatorEntry::registerKernel(
   std::unique_ptr<FunctionSchema> inferred_function_schema,
   std::string debug
 ) {
+  std::lock_guard<std::mutex> lock(schema_mutex_);
   // NB: cpp_signature doesn't get cleared even after the kernel that populated
   // it is deleted.  This means you could poison the value of cpp_signature_
   // with a bad signature value, and then it would permanently stay there until
@@ -102,6 +147,7 @@ std::list<AnnotatedKernel>::iterator OperatorEntry::registerKernel(
     }
   }
 
+  // If the schema is still pending, this check happens when it is parsed.
   if (schema_ && inferred_function_schema) {
     checkSchema(name_, schema_->schema, schema_->debug, *inferred_function_schema, debug);
   }
@@ -138,6 +184,7 @@ void OperatorEntry::deregisterKernel_(
   c10::optional<DispatchKey> dispatch_key,
   std::list<AnnotatedKernel>::iterator kernel
 ) {
+  std::lock_guard<std::mutex> lock(schema_mutex_);
   // Redirect catchAll deregistrations to Math.
   DispatchKey dk = dispatch_key.has_value() ? *dispatch_key : DispatchKey::Math;
   auto found = kernels_.find(dk);
@@ -167,6 +214,10 @@ bool OperatorEntry::hasKernelForAnyDispatchKey(DispatchKeySet ks) const {
   return false;
 }
 
+bool OperatorEntry::hasKernelForDispatchKey(DispatchKey dispatch_key) const {
+  return kernels_.find(dispatch_key) != kernels_.end();
+}
+
 c10::optional<const AnnotatedKernel*> OperatorEntry::getKernelForDispatchKey(DispatchKey dispatch_key) const{
   auto kern_it = kernels_.find(dispatch_key);
   if (kern_it != kernels_.end()) {
@@ -424,6 +475,7 @@ std::string OperatorEntry::dumpComputedTable() const {
 // is appropriate for expect tests.
 // This WON'T report backend fallbacks.
 std::string OperatorEntry::dumpState() const {
+  parseSchemaIfPending();
   std::ostringstream oss;
   oss << "name: " << name_ << "\n";
   if (schema_) {
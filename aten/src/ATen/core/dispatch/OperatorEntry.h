@@ -16,6 +16,8 @@
 
 #include <list>
 #include <array>
+#include <atomic>
+#include <mutex>
 
 namespace c10 {
 
@@ -54,6 +56,27 @@ struct AnnotatedSchema final {
   std::string debug;
 };
 
+// Note [Lazy schema registration]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Most operators are def()'ed from a schema string literal in a static
+// initializer (e.g. the ~2000 of RegisterSchema.cpp), and parsing all of
+// those strings is a large part of the time it takes to load libtorch.
+// Library::def(const char*) therefore only splits off the operator name and
+// hands the string to registerUnparsedSchema(); the schema is parsed the
+// first time somebody needs it, i.e. on Dispatcher::findSchema(), on the
+// first schema() or debug() access, or on the first boxed call.  Until then
+// hasSchema() is already true, the dispatch table is maintained as usual
+// and unboxed calls work, since they do not need the schema.
+//
+// The checks of the inferred schemas of the kernels against the schema are
+// deferred to the parse as well, so a mismatch is reported when the
+// operator is first looked up rather than when the library is loaded.
+//
+// Parsing can happen concurrently from several threads and concurrently
+// with kernel (de)registration, which is why it is guarded by schema_mutex_
+// rather than the Dispatcher lock.  schema_pending_ makes the common,
+// already parsed case a single load.
+
 // Internal data structure that records information about a specific operator.
 // It's not part of the public API; typically, users will interact with
 // OperatorHandle instead.
@@ -71,15 +94,25 @@ public:
   OperatorEntry& operator=(OperatorEntry&&) noexcept = delete;
 
   const FunctionSchema& schema() const {
+    parseSchemaIfPending();
     TORCH_INTERNAL_ASSERT(schema_.has_value(), "Tried to access the schema for ", name_, " which doesn't have a schema registered yet");
     return schema_->schema;
   }
   const std::string& debug() const {
+    parseSchemaIfPending();
     TORCH_INTERNAL_ASSERT(schema_.has_value());
     return schema_->debug;
   }
   bool hasSchema() const {
-    return schema_.has_value();
+    return schema_pending_.load(std::memory_order_acquire) || schema_.has_value();
+  }
+
+  // Parses the schema string given to registerUnparsedSchema(), if that
+  // hasn't happened yet.  See Note [Lazy schema registration]
+  void parseSchemaIfPending() const {
+    if (C10_UNLIKELY(schema_pending_.load(std::memory_order_acquire))) {
+      parseSchema_();
+    }
   }
 
   bool isObserved() const {
@@ -95,6 +128,10 @@ public:
   // versa that is an error.  (Refcounting for the registrations is
   // handled in the OperatorHandle in Dispatcher)
   void registerSchema(FunctionSchema&&, std::string&& debug);
+  // Like registerSchema, but keeps the schema string to be parsed on first
+  // use.  The string must spell out operator_name() once the namespace of
+  // the name is applied to it.  See Note [Lazy schema registration]
+  void registerUnparsedSchema(std::string&& schema_string, std::string&& debug);
   void deregisterSchema();
 
   const OperatorName& operator_name() const {
@@ -138,6 +175,7 @@ public:
 
   // Precondition: Dispatcher::mutex_ is held
   void updateSchemaAliasAnalysis(AliasAnalysisKind a) {
+    parseSchemaIfPending();
     TORCH_INTERNAL_ASSERT(schema_.has_value());
     schema_->schema.setAliasAnalysis(a);
   }
@@ -176,13 +214,26 @@ public:
 
   std::string listAllDispatchKeys() const;
 
+  // Returns true if a kernel is registered to dispatch_key itself, the
+  // kernels of alias keys and fallbacks aside.
+  bool hasKernelForDispatchKey(DispatchKey dispatch_key) const;
+
 private:
 
   OperatorName name_;
-  c10::optional<AnnotatedSchema> schema_;
+  // schema_ and dispatchKeyExtractor_ are only filled in when a schema
+  // registered with registerUnparsedSchema() is parsed, which can happen
+  // from a const accessor; see Note [Lazy schema registration]
+  mutable c10::optional<AnnotatedSchema> schema_;
+  // The arguments of registerUnparsedSchema() while schema_pending_ is set
+  mutable std::string unparsed_schema_;
+  mutable std::string unparsed_schema_debug_;
+  mutable std::atomic<bool> schema_pending_{false};
+  // Guards the schema members and kernels_ against a concurrent parse
+  mutable std::mutex schema_mutex_;
 
   std::array<KernelFunction, static_cast<uint8_t>(DispatchKey::NumDispatchKeys)> dispatchTable_;
-  DispatchKeyExtractor dispatchKeyExtractor_;
+  mutable DispatchKeyExtractor dispatchKeyExtractor_;
 
   // kernels_ stores all registered kernels for the corresponding dispatch key
   // and catchAllKernels_ stores the catch-all kernels.
@@ -237,6 +288,9 @@ private:
   const bool is_observed_;
 
   [[noreturn]] void reportSignatureError(std::string name) const;
+  void parseSchema_() const;
+  // Precondition: schema_mutex_ is held
+  void registerSchema_(FunctionSchema&& schema, std::string&& debug) const;
   const KernelFunction& computeDispatchTableEntry(const c10::Dispatcher& dispatcher, DispatchKey dispatch_key) const;
   std::pair<const AnnotatedKernel&, const char*> computeDispatchTableEntryWithDebug(
     const c10::Dispatcher& dispatcher, DispatchKey dispatch_key
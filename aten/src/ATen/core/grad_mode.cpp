@@ -1,5 +1,7 @@
 #include <ATen/core/grad_mode.h>
 
+#include <c10/core/InferenceMode.h>
+
 #include <stdexcept>
 
 namespace at {
@@ -12,12 +14,17 @@ namespace at {
 
 thread_local bool GradMode_enabled = true;
 
+// Grad mode is disabled in inference mode and can't be enabled there, so
+// restoring a value read in inference mode leaves the value outside of it
+// untouched. See Note [Inference mode]
 bool GradMode::is_enabled() {
-  return GradMode_enabled;
+  return GradMode_enabled && !c10::InferenceMode::is_enabled();
 }
 
 void GradMode::set_enabled(bool enabled) {
-  GradMode_enabled = enabled;
+  if (!c10::InferenceMode::is_enabled()) {
+    GradMode_enabled = enabled;
+  }
 }
 
 #else
@@ -288,6 +288,11 @@ namespace c10 {
   _(cuda, _set_device)               \
   _(cuda, set_stream)                \
   _(cuda, _current_device)           \
+  _(cuda, _streams_begin)            \
+  _(cuda, _stream_use)               \
+  _(cuda, _stream_wait)              \
+  _(cuda, _stream_record)            \
+  _(cuda, _streams_end)              \
   _(aten, swapaxes)                  \
   _(aten, swapaxes_)                 \
   _(aten, swapdims)                  \
@@ -4,6 +4,7 @@
 #include <ATen/core/function.h>
 #include <ATen/core/jit_type.h>
 #include <ATen/core/stack.h>
+#include <c10/core/thread_pool.h>
 #include <c10/util/StringUtil.h>
 #include <c10/util/hash.h>
 #include <cmath>
@@ -920,6 +921,20 @@ getClassConverter() {
   return classConverter;
 }
 
+void ivalue::Future::waitUntilCompleted(std::unique_lock<std::mutex>& lock) {
+  if (!completed_ && c10::ThreadPool::canHelpWhileWaiting()) {
+    // Run with the other callbacks once completed_ is set
+    auto waiter = std::make_shared<c10::ThreadPool::HelpingWaiter>();
+    callbacks_.emplace_back([waiter]() { waiter->complete(); });
+    lock.unlock();
+    c10::ThreadPool::helpUntilComplete(waiter);
+    lock.lock();
+  }
+  while (!completed_) {
+    finished_cv_.wait(lock);
+  }
+}
+
 TORCH_API intrusive_ptr<ivalue::Future> collectAll(
     List<intrusive_ptr<ivalue::Future>> srcs) {
   struct Ctx {
@@ -25,6 +25,9 @@ struct IValue;
 struct ClassType;
 struct Type;
 class RRefInterface;
+namespace detail {
+struct DictKeyHash;
+} // namespace detail
 using TypePtr = std::shared_ptr<Type>;
 
 struct ClassType;
@@ -977,6 +980,7 @@ struct TORCH_API IValue final {
   Tag tag;
   bool is_intrusive_ptr;
   friend struct WeakIValue;
+  friend struct detail::DictKeyHash;
 };
 
 struct TORCH_API WeakIValue final {
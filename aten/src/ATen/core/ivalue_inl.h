@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <type_traits>
 
@@ -12,6 +13,7 @@
 #include <c10/core/Scalar.h>
 #include <c10/core/Stream.h>
 #include <c10/core/TensorImpl.h>
+#include <c10/core/impl/SmallObjectPool.h>
 #include <c10/core/UndefinedTensorImpl.h>
 #include <c10/util/intrusive_ptr.h>
 #include <c10/util/hash.h>
@@ -214,13 +216,29 @@ using Shared = c10::intrusive_ptr<T>;
 struct TORCH_API ConstantString final : c10::intrusive_ptr_target {
  private:
   const std::string str_;
+  // 0 until the string is hashed
+  mutable std::atomic<size_t> hash_{0};
 
  public:
+  // See Note [Small object pool]
+  C10_SMALL_OBJECT_POOL_ALLOCATION_FUNCTIONS
+
   ConstantString(std::string str) : str_(std::move(str)) {}
   static c10::intrusive_ptr<ConstantString> create(std::string str_);
   const std::string& string() const {
     return str_;
   }
+  // std::hash of the string, computed once. The strings are shared by the
+  // IValues that are copies of each other, e.g. the Dict keys that come from
+  // the constants of a graph, so these are hashed only once.
+  size_t hash() const {
+    size_t h = hash_.load(std::memory_order_relaxed);
+    if (h == 0) {
+      h = std::hash<std::string>()(str_);
+      hash_.store(h, std::memory_order_relaxed);
+    }
+    return h;
+  }
   operator const std::string&() const {
     return string();
   }
@@ -238,6 +256,9 @@ struct TORCH_API Tuple : c10::intrusive_ptr_target {
       type_; // lazily computed for unnamed tuples
 
  public:
+  // See Note [Small object pool]
+  C10_SMALL_OBJECT_POOL_ALLOCATION_FUNCTIONS
+
   // named tuples have additional type information, so we
   // directly create them tagged
   static c10::intrusive_ptr<Tuple> createNamed(
@@ -325,9 +346,7 @@ struct C10_EXPORT ivalue::Future : c10::intrusive_ptr_target {
    */
   void wait() {
     std::unique_lock<std::mutex> lock(mutex_);
-    while (!completed_) {
-      finished_cv_.wait(lock);
-    }
+    waitUntilCompleted(lock);
 
     if (!eptr_) {
       postWaitHook(value_);
@@ -340,9 +359,7 @@ struct C10_EXPORT ivalue::Future : c10::intrusive_ptr_target {
    */
   void waitAndThrow() {
     std::unique_lock<std::mutex> lock(mutex_);
-    while (!completed_) {
-      finished_cv_.wait(lock);
-    }
+    waitUntilCompleted(lock);
 
     if (eptr_) {
       std::rethrow_exception(eptr_);
@@ -547,6 +564,11 @@ struct C10_EXPORT ivalue::Future : c10::intrusive_ptr_target {
     }
   }
 
+  // Blocks until the future completes. A worker of a c10::ThreadPool which
+  // helps while waiting, like the at::launch one, runs the tasks queued in its
+  // pool meanwhile, see Note [Helping while waiting on futures].
+  void waitUntilCompleted(std::unique_lock<std::mutex>& lock);
+
   // Tries to retrieve the error message from std::exception_ptr.
   std::string tryRetrieveErrorMessageInternal(std::exception_ptr eptr) const {
     try {
@@ -1261,6 +1283,11 @@ inline const std::string& IValue::toStringRef() const {
              payload.u.as_intrusive_ptr)
       ->string();
 }
+inline size_t detail::DictKeyHash::stringHash(const IValue& ivalue) {
+  return static_cast<const c10::ivalue::ConstantString*>(
+             ivalue.payload.u.as_intrusive_ptr)
+      ->hash();
+}
 inline c10::optional<std::reference_wrapper<const std::string>> IValue::
     toOptionalStringRef() const {
   if (isNone()) {
@@ -2,6 +2,8 @@
 
 #include <ATen/core/dispatch/Dispatcher.h>
 
+#include <cctype>
+
 namespace torch {
 
 namespace {
@@ -30,6 +32,37 @@ namespace {
     }
     return "(unknown)";
   }
+
+  // Splits the operator name, e.g. "aten::add.Tensor", off the front of a
+  // schema string without parsing the rest of it.  Returns nullopt for
+  // anything but a plain name followed by the argument list, in which case
+  // the caller should parse the whole schema to get a proper error.
+  c10::optional<c10::OperatorName> parseOperatorNameOfSchema(const char* schema) {
+    const char* end = schema;
+    while (std::isalnum(static_cast<unsigned char>(*end)) || *end == '_' || *end == ':' || *end == '.') {
+      ++end;
+    }
+    if (end == schema || *end != '(') {
+      return c10::nullopt;
+    }
+    std::string name(schema, end);
+    std::string overload_name;
+    const auto dot = name.find('.');
+    if (dot != std::string::npos) {
+      overload_name = name.substr(dot + 1);
+      name.resize(dot);
+    }
+    // At most one "::", separating a non-empty namespace from the name
+    const auto ns_end = name.find("::");
+    const auto name_begin = ns_end == std::string::npos ? 0 : ns_end + 2;
+    if (ns_end == 0 || name_begin == name.size() ||
+        name.find(':') < ns_end ||
+        name.find(':', name_begin) != std::string::npos ||
+        overload_name.find_first_of(".:") != std::string::npos) {
+      return c10::nullopt;
+    }
+    return c10::OperatorName(std::move(name), std::move(overload_name));
+  }
 }
 
 CppFunction::CppFunction(c10::KernelFunction func, c10::optional<c10::impl::CppSignature> cpp_signature, std::unique_ptr<c10::FunctionSchema> schema)
@@ -124,6 +157,44 @@ Library& Library::_def(c10::FunctionSchema&& schema, c10::OperatorName* out_name
 }
 #undef DEF_PRELUDE
 
+#define DEF_PRELUDE "def(\"", raw_schema, "\"): "
+Library& Library::_defUnparsed(const char* raw_schema) & {
+  auto name = parseOperatorNameOfSchema(raw_schema);
+  if (!name.has_value()) {
+    return _def(torch::schema(raw_schema));
+  }
+  TORCH_CHECK(kind_ == DEF || kind_ == FRAGMENT,
+    DEF_PRELUDE,
+    "Cannot define an operator inside of a ", toString(kind_), " block.  "
+    "All def()s should be placed in the (unique) TORCH_LIBRARY block for their namespace.  ",
+    ERROR_CONTEXT
+  );
+  TORCH_INTERNAL_ASSERT(ns_.has_value(), ERROR_CONTEXT);
+  TORCH_INTERNAL_ASSERT(!dispatch_key_.has_value(), ERROR_CONTEXT);
+  const auto ns_end = name->name.find("::");
+  if (ns_end != std::string::npos) {
+    // See Note [Redundancy in registration code is OK]
+    TORCH_CHECK(name->name.compare(0, ns_end, *ns_) == 0 && ns_end == ns_->size(),
+      "Explicitly provided namespace (", name->name.substr(0, ns_end), ") in schema string "
+      "does not match namespace of enclosing ", toString(kind_), " block (", *ns_, ").  "
+      "Move this definition to the (unique) TORCH_LIBRARY block corresponding to this namespace "
+      "(and consider deleting the namespace from your schema string.)  ",
+      ERROR_CONTEXT
+    );
+  } else {
+    name->name = *ns_ + "::" + name->name;
+  }
+  registrars_.emplace_back(
+    c10::Dispatcher::singleton().registerUnparsedDef(
+      std::move(*name),
+      raw_schema,
+      debugString("", file_, line_)
+    )
+  );
+  return *this;
+}
+#undef DEF_PRELUDE
+
 Library& Library::_def(c10::either<c10::OperatorName, c10::FunctionSchema>&& name_or_schema, CppFunction&& f) & {
   c10::FunctionSchema schema = [&] {
     if (name_or_schema.is_right()) {
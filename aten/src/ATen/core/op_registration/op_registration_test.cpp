@@ -1945,6 +1945,53 @@ TEST(NewOperatorRegistrationTest, testDelayedListener) {
   EXPECT_EQ(initial_num_deregisters + 1, listener_ptr->num_deregisters_);
 }
 
+TEST(NewOperatorRegistrationTest, givenLazyDef_whenLookingUpSchema_thenIsParsed) {
+  auto m = MAKE_TORCH_LIBRARY(_test);
+  m.def("lazy.overload(Tensor(a!) self, int dim=1) -> Tensor(a!)");
+  auto op = Dispatcher::singleton().findOp({"_test::lazy", "overload"});
+  ASSERT_TRUE(op.has_value());
+  EXPECT_TRUE(op->hasSchema());
+
+  auto schema_op = Dispatcher::singleton().findSchema({"_test::lazy", "overload"});
+  ASSERT_TRUE(schema_op.has_value());
+  const auto& schema = schema_op->schema();
+  EXPECT_EQ("_test::lazy", schema.name());
+  EXPECT_EQ("overload", schema.overload_name());
+  EXPECT_EQ(2u, schema.arguments().size());
+  EXPECT_EQ(c10::AliasAnalysisKind::FROM_SCHEMA, schema.aliasAnalysis());
+  EXPECT_TRUE(schema.is_mutable());
+}
+
+TEST(NewOperatorRegistrationTest, givenLazyDefWithInvalidSchema_whenLookingUpSchema_thenFails) {
+  auto m = MAKE_TORCH_LIBRARY(_test);
+  // Only the operator name is checked when registering
+  m.def("lazy(Tensor self, NotAType x) -> Tensor");
+  expectThrows<c10::Error>([] {
+    Dispatcher::singleton().findSchema({"_test::lazy", ""});
+  }, "");
+  // and the error is reported again on the next lookup
+  expectThrows<c10::Error>([] {
+    Dispatcher::singleton().findSchema({"_test::lazy", ""});
+  }, "");
+}
+
+TEST(NewOperatorRegistrationTest, givenLazyDefWithMismatchingKernel_whenLookingUpSchema_thenFails) {
+  auto m = MAKE_TORCH_LIBRARY(_test);
+  m.def("lazy(Tensor self) -> Tensor");
+  m.impl("lazy", torch::dispatch(c10::DispatchKey::CPU, [](const Tensor& x, int64_t) { return x; }));
+  expectThrows<c10::Error>([] {
+    Dispatcher::singleton().findSchema({"_test::lazy", ""});
+  }, "Inferred operator schema for a C++ kernel function doesn't match the expected function schema");
+}
+
+TEST(NewOperatorRegistrationTest, givenLazyDefWithOtherNamespace_whenRegistering_thenFails) {
+  auto m = MAKE_TORCH_LIBRARY(_test);
+  expectThrows<c10::Error>([&] {
+    m.def("_other::lazy(Tensor self) -> Tensor");
+  }, "does not match namespace of enclosing");
+  EXPECT_FALSE(Dispatcher::singleton().findOp({"_other::lazy", ""}).has_value());
+}
+
 TEST(NewOperatorRegistrationTest, testImplNoDefGetsCaught) {
   auto danglingImpls = Dispatcher::singleton().findDanglingImpls();
   std::string error_str = "Discovered operators that have been registered through the dispatcher"
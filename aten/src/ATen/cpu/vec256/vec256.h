@@ -10,6 +10,7 @@
 #include <ATen/cpu/vec256/vec256_float.h>
 #include <ATen/cpu/vec256/vec256_float_neon.h>
 #include <ATen/cpu/vec256/vec256_bfloat16.h>
+#include <ATen/cpu/vec256/vec256_half.h>
 #include <ATen/cpu/vec256/vec256_double.h>
 #include <ATen/cpu/vec256/vec256_int.h>
 #include <ATen/cpu/vec256/vec256_qint.h>
@@ -894,4 +894,9 @@ inline void convert(const src_T *src, dst_T *dst, int64_t n) {
   }
 }
 
+// Kernels that are written against at::vec (see vec512/functional.h) name the
+// vector type of their CPU capability Vectorized<T>.
+template <typename T>
+using Vectorized = Vec256<T>;
+
 }}}
@@ -0,0 +1,49 @@
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256_base.h>
+#include <c10/util/Half.h>
+
+namespace at {
+namespace vec256 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+#if defined(CPU_CAPABILITY_AVX2)
+
+// The AVX2 kernels are compiled with F16C, which converts 8 values between
+// Half and float at a time with the rounding of c10::Half.
+template <>
+inline void convert(const Half* src, float* dst, int64_t n) {
+  int64_t i;
+#pragma unroll
+  for (i = 0; i <= (n - Vec256<float>::size()); i += Vec256<float>::size()) {
+    auto vsrc = _mm_loadu_si128(reinterpret_cast<const __m128i*>((const void*)(src + i)));
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(vsrc));
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = src[i];
+  }
+}
+
+template <>
+inline void convert(const float* src, Half* dst, int64_t n) {
+  int64_t i;
+#pragma unroll
+  for (i = 0; i <= (n - Vec256<float>::size()); i += Vec256<float>::size()) {
+    auto vdst = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>((void*)(dst + i)), vdst);
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = src[i];
+  }
+}
+
+#endif
+
+}}}
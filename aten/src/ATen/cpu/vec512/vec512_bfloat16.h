@@ -0,0 +1,416 @@
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec512/vec512_base.h>
+#include <ATen/cpu/vec512/vec512_float.h>
+
+namespace at {
+namespace vec512 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+static inline void cvtbf16_fp32(const __m512i& a, __m512& o1, __m512& o2) {
+  __m256i lo = _mm512_extracti64x4_epi64(a, 0);
+  __m256i hi = _mm512_extracti64x4_epi64(a, 1);
+  o1 = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(lo), 16));
+  o2 = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(hi), 16));
+}
+static inline __m512i cvtfp32_bf16(const __m512& a, const __m512& b) {
+  // Not _mm512_cvtne2ps_pbh: AVX512_BF16 flushes denormals to zero, which
+  // would not match the rounding of c10::BFloat16 and of the other kernels.
+  __m512i lo = _mm512_castps_si512(a);
+  __m512i hi = _mm512_castps_si512(b);
+  __m512i nan = _mm512_set1_epi32(0xffff);
+  __mmask16 mask_lo = _mm512_cmp_ps_mask(a, a, _CMP_ORD_Q);
+  __mmask16 mask_hi = _mm512_cmp_ps_mask(b, b, _CMP_ORD_Q);
+  __m512i ones = _mm512_set1_epi32(0x1);
+  __m512i vec_bias = _mm512_set1_epi32(0x7fff);
+  // uint32_t lsb = (input >> 16) & 1;
+  auto t_lo = _mm512_and_si512(_mm512_srli_epi32(lo, 16), ones);
+  auto t_hi = _mm512_and_si512(_mm512_srli_epi32(hi, 16), ones);
+  // uint32_t rounding_bias = 0x7fff + lsb;
+  t_lo = _mm512_add_epi32(t_lo, vec_bias);
+  t_hi = _mm512_add_epi32(t_hi, vec_bias);
+  // input += rounding_bias;
+  t_lo = _mm512_add_epi32(t_lo, lo);
+  t_hi = _mm512_add_epi32(t_hi, hi);
+  // input = input >> 16;
+  t_lo = _mm512_srli_epi32(t_lo, 16);
+  t_hi = _mm512_srli_epi32(t_hi, 16);
+  // Check NaN before converting back to bf16
+  t_lo = _mm512_mask_blend_epi32(mask_lo, nan, t_lo);
+  t_hi = _mm512_mask_blend_epi32(mask_hi, nan, t_hi);
+  // Unlike _mm256_packus_epi32, the narrowing keeps the order of the lanes.
+  return _mm512_inserti64x4(
+      _mm512_castsi256_si512(_mm512_cvtepi32_epi16(t_lo)), _mm512_cvtepi32_epi16(t_hi), 1);
+}
+
+template <> class Vec512<BFloat16> {
+private:
+  __m512i values;
+  static inline __mmask32 tail_mask(int64_t count) {
+    return static_cast<__mmask32>((uint64_t(1) << count) - 1);
+  }
+  // Computes op on the two halves of the vector, converted to float
+  template <typename Op>
+  Vec512<BFloat16> map_as_fp32(const Op& op) const {
+    __m512 lo, hi;
+    cvtbf16_fp32(values, lo, hi);
+    return cvtfp32_bf16(op(Vec512<float>(lo)), op(Vec512<float>(hi)));
+  }
+  template <typename Op>
+  Vec512<BFloat16> map2_as_fp32(const Vec512<BFloat16>& b, const Op& op) const {
+    __m512 lo, hi;
+    __m512 b_lo, b_hi;
+    cvtbf16_fp32(values, lo, hi);
+    cvtbf16_fp32(b.values, b_lo, b_hi);
+    return cvtfp32_bf16(op(Vec512<float>(lo), Vec512<float>(b_lo)),
+                        op(Vec512<float>(hi), Vec512<float>(b_hi)));
+  }
+public:
+  using value_type = uint16_t;
+  static constexpr int size() {
+    return 32;
+  }
+  Vec512() {}
+  Vec512(__m512i v) : values(v) {}
+  Vec512(BFloat16 val) {
+    value_type uw = val.x;
+    values = _mm512_set1_epi16(uw);
+  }
+  template<typename... Args,
+           typename = std::enable_if_t<(sizeof...(Args) == size())>>
+  Vec512(Args... vals) {
+    __at_align64__ BFloat16 buffer[size()] = {vals...};
+    values = _mm512_load_si512(reinterpret_cast<const __m512i*>(buffer));
+  }
+  operator __m512i() const {
+    return values;
+  }
+  BFloat16& operator[](int idx) = delete;
+  const BFloat16& operator[](int idx) const  = delete;
+  int64_t zero_mask() const {
+    // returns an integer mask where all zero elements are translated to 1-bit and others are translated to 0-bit
+    return _mm512_cmpeq_epi16_mask(values, _mm512_set1_epi16(0));
+  }
+  // The tails are loaded and stored with masks: the lanes past count are
+  // neither read nor written, and loaded as zeros.
+  static Vec512<BFloat16> loadu(const void* ptr) {
+    return _mm512_loadu_si512(reinterpret_cast<const __m512i*>(ptr));
+  }
+  static Vec512<BFloat16> loadu(const void* ptr, int64_t count) {
+    return _mm512_maskz_loadu_epi16(tail_mask(count), ptr);
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm512_storeu_si512(reinterpret_cast<__m512i*>(ptr), values);
+    } else if (count > 0) {
+      _mm512_mask_storeu_epi16(ptr, tail_mask(count), values);
+    }
+  }
+  template <int64_t mask>
+  static Vec512<BFloat16> blend(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+    return _mm512_mask_blend_epi16(static_cast<__mmask32>(mask), a.values, b.values);
+  }
+  static Vec512<BFloat16> blendv(const Vec512<BFloat16>& a,
+      const Vec512<BFloat16>& b, const Vec512<BFloat16>& mask) {
+    // like _mm256_blendv_epi8, select the bytes of b where the sign bit of mask is set
+    return _mm512_mask_blend_epi8(_mm512_movepi8_mask(mask.values), a.values, b.values);
+  }
+  template<typename step_t>
+  static Vec512<BFloat16> arange(BFloat16 base = 0.f, step_t step = static_cast<step_t>(1)) {
+    __at_align64__ BFloat16 buffer[size()];
+    for (int64_t i = 0; i < size(); i++) {
+      buffer[i] = base + i * step;
+    }
+    return _mm512_load_si512(reinterpret_cast<const __m512i*>(buffer));
+  }
+  static Vec512<BFloat16> set(const Vec512<BFloat16>& a,
+      const Vec512<BFloat16>& b, int64_t count = size()) {
+    if (count >= size()) {
+      return b;
+    }
+    return _mm512_mask_blend_epi16(tail_mask(count), a.values, b.values);
+  }
+  Vec512<BFloat16> map(const __m512 (*vop)(__m512)) const {
+    __m512 lo, hi;
+    cvtbf16_fp32(values, lo, hi);
+    auto o1 = vop(lo);
+    auto o2 = vop(hi);
+    return cvtfp32_bf16(o1, o2);
+  }
+  Vec512<BFloat16> abs() const {
+    return map_as_fp32([](Vec512<float> x) { return x.abs(); });
+  }
+  Vec512<BFloat16> angle() const {
+    return map_as_fp32([](Vec512<float> x) { return x.angle(); });
+  }
+  Vec512<BFloat16> real() const {
+    return *this;
+  }
+  Vec512<BFloat16> imag() const {
+    return _mm512_set1_epi16(0);
+  }
+  Vec512<BFloat16> conj() const {
+    return *this;
+  }
+  Vec512<BFloat16> acos() const {
+    return map_as_fp32([](Vec512<float> x) { return x.acos(); });
+  }
+  Vec512<BFloat16> asin() const {
+    return map_as_fp32([](Vec512<float> x) { return x.asin(); });
+  }
+  Vec512<BFloat16> atan() const {
+    return map_as_fp32([](Vec512<float> x) { return x.atan(); });
+  }
+  Vec512<BFloat16> atan2(const Vec512<BFloat16> &b) const {
+    return map2_as_fp32(b, [](Vec512<float> x, Vec512<float> y) { return x.atan2(y); });
+  }
+  Vec512<BFloat16> erf() const {
+    return map_as_fp32([](Vec512<float> x) { return x.erf(); });
+  }
+  Vec512<BFloat16> erfc() const {
+    return map_as_fp32([](Vec512<float> x) { return x.erfc(); });
+  }
+  Vec512<BFloat16> erfinv() const {
+    return map_as_fp32([](Vec512<float> x) { return x.erfinv(); });
+  }
+  Vec512<BFloat16> exp() const {
+    return map_as_fp32([](Vec512<float> x) { return x.exp(); });
+  }
+  Vec512<BFloat16> expm1() const {
+    return map_as_fp32([](Vec512<float> x) { return x.expm1(); });
+  }
+  Vec512<BFloat16> fmod(const Vec512<BFloat16> & q) const {
+    return map2_as_fp32(q, [](Vec512<float> x, Vec512<float> y) { return x.fmod(y); });
+  }
+  Vec512<BFloat16> hypot(const Vec512<BFloat16> &b) const {
+    return map2_as_fp32(b, [](Vec512<float> x, Vec512<float> y) { return x.hypot(y); });
+  }
+  Vec512<BFloat16> i0() const {
+    return map_as_fp32([](Vec512<float> x) { return x.i0(); });
+  }
+  Vec512<BFloat16> igamma(const Vec512<BFloat16> &x) const {
+    return map2_as_fp32(x, [](Vec512<float> a, Vec512<float> b) { return a.igamma(b); });
+  }
+  Vec512<BFloat16> igammac(const Vec512<BFloat16> &x) const {
+    return map2_as_fp32(x, [](Vec512<float> a, Vec512<float> b) { return a.igammac(b); });
+  }
+  Vec512<BFloat16> log() const {
+    return map_as_fp32([](Vec512<float> x) { return x.log(); });
+  }
+  Vec512<BFloat16> log2() const {
+    return map_as_fp32([](Vec512<float> x) { return x.log2(); });
+  }
+  Vec512<BFloat16> log10() const {
+    return map_as_fp32([](Vec512<float> x) { return x.log10(); });
+  }
+  Vec512<BFloat16> log1p() const {
+    return map_as_fp32([](Vec512<float> x) { return x.log1p(); });
+  }
+  Vec512<BFloat16> frac() const;
+  Vec512<BFloat16> sin() const {
+    return map_as_fp32([](Vec512<float> x) { return x.sin(); });
+  }
+  Vec512<BFloat16> sinh() const {
+    return map_as_fp32([](Vec512<float> x) { return x.sinh(); });
+  }
+  Vec512<BFloat16> cos() const {
+    return map_as_fp32([](Vec512<float> x) { return x.cos(); });
+  }
+  Vec512<BFloat16> cosh() const {
+    return map_as_fp32([](Vec512<float> x) { return x.cosh(); });
+  }
+  Vec512<BFloat16> ceil() const {
+    return map_as_fp32([](Vec512<float> x) { return x.ceil(); });
+  }
+  Vec512<BFloat16> floor() const {
+    return map_as_fp32([](Vec512<float> x) { return x.floor(); });
+  }
+  Vec512<BFloat16> neg() const {
+    return map_as_fp32([](Vec512<float> x) { return x.neg(); });
+  }
+  Vec512<BFloat16> nextafter(const Vec512<BFloat16> &b) const {
+    return map2_as_fp32(b, [](Vec512<float> x, Vec512<float> y) { return x.nextafter(y); });
+  }
+  Vec512<BFloat16> round() const {
+    return map_as_fp32([](Vec512<float> x) { return x.round(); });
+  }
+  Vec512<BFloat16> tan() const {
+    return map_as_fp32([](Vec512<float> x) { return x.tan(); });
+  }
+  Vec512<BFloat16> tanh() const {
+    return map_as_fp32([](Vec512<float> x) { return x.tanh(); });
+  }
+  Vec512<BFloat16> trunc() const {
+    return map_as_fp32([](Vec512<float> x) { return x.trunc(); });
+  }
+  Vec512<BFloat16> lgamma() const {
+    return map_as_fp32([](Vec512<float> x) { return x.lgamma(); });
+  }
+  Vec512<BFloat16> sqrt() const {
+    return map_as_fp32([](Vec512<float> x) { return x.sqrt(); });
+  }
+  Vec512<BFloat16> reciprocal() const {
+    return map_as_fp32([](Vec512<float> x) { return x.reciprocal(); });
+  }
+  Vec512<BFloat16> rsqrt() const {
+    return map_as_fp32([](Vec512<float> x) { return x.rsqrt(); });
+  }
+  Vec512<BFloat16> pow(const Vec512<BFloat16> &b) const {
+    return map2_as_fp32(b, [](Vec512<float> x, Vec512<float> y) { return x.pow(y); });
+  }
+
+  // The comparisons of the float halves are all ones (a NaN) where true,
+  // which converts to 0xffff.
+  Vec512<BFloat16> operator>(const Vec512<BFloat16>& other) const {
+    return map2_as_fp32(other, [](Vec512<float> x, Vec512<float> y) { return x > y; });
+  }
+  Vec512<BFloat16> operator<(const Vec512<BFloat16>& other) const {
+    return map2_as_fp32(other, [](Vec512<float> x, Vec512<float> y) { return x < y; });
+  }
+  Vec512<BFloat16> operator>=(const Vec512<BFloat16>& other) const {
+    return map2_as_fp32(other, [](Vec512<float> x, Vec512<float> y) { return x >= y; });
+  }
+  Vec512<BFloat16> operator<=(const Vec512<BFloat16>& other) const {
+    return map2_as_fp32(other, [](Vec512<float> x, Vec512<float> y) { return x <= y; });
+  }
+  Vec512<BFloat16> operator==(const Vec512<BFloat16>& other) const {
+    return map2_as_fp32(other, [](Vec512<float> x, Vec512<float> y) { return x == y; });
+  }
+  Vec512<BFloat16> operator!=(const Vec512<BFloat16>& other) const {
+    return map2_as_fp32(other, [](Vec512<float> x, Vec512<float> y) { return x != y; });
+  }
+
+  Vec512<BFloat16> eq(const Vec512<BFloat16>& other) const;
+  Vec512<BFloat16> ne(const Vec512<BFloat16>& other) const;
+  Vec512<BFloat16> gt(const Vec512<BFloat16>& other) const;
+  Vec512<BFloat16> ge(const Vec512<BFloat16>& other) const;
+  Vec512<BFloat16> lt(const Vec512<BFloat16>& other) const;
+  Vec512<BFloat16> le(const Vec512<BFloat16>& other) const;
+
+  template <typename Op>
+  friend Vec512<BFloat16> bfloat16_binary_op_as_fp32(
+      const Vec512<BFloat16>& a, const Vec512<BFloat16>& b, Op op) {
+    return a.map2_as_fp32(b, op);
+  }
+};
+
+Vec512<BFloat16> inline operator+(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return bfloat16_binary_op_as_fp32(a, b, [](Vec512<float> x, Vec512<float> y) { return x + y; });
+}
+Vec512<BFloat16> inline operator-(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return bfloat16_binary_op_as_fp32(a, b, [](Vec512<float> x, Vec512<float> y) { return x - y; });
+}
+Vec512<BFloat16> inline operator*(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return bfloat16_binary_op_as_fp32(a, b, [](Vec512<float> x, Vec512<float> y) { return x * y; });
+}
+Vec512<BFloat16> inline operator/(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return bfloat16_binary_op_as_fp32(a, b, [](Vec512<float> x, Vec512<float> y) { return x / y; });
+}
+
+Vec512<BFloat16> inline operator&(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return _mm512_and_si512(a, b);
+}
+Vec512<BFloat16> inline operator|(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return _mm512_or_si512(a, b);
+}
+Vec512<BFloat16> inline operator^(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return _mm512_xor_si512(a, b);
+}
+
+Vec512<BFloat16> Vec512<BFloat16>::eq(const Vec512<BFloat16>& other) const {
+  return (*this == other) & Vec512<BFloat16>(1.0f);
+}
+
+Vec512<BFloat16> Vec512<BFloat16>::ne(const Vec512<BFloat16>& other) const {
+  return (*this != other) & Vec512<BFloat16>(1.0f);
+}
+
+Vec512<BFloat16> Vec512<BFloat16>::gt(const Vec512<BFloat16>& other) const {
+  return (*this > other) & Vec512<BFloat16>(1.0f);
+}
+
+Vec512<BFloat16> Vec512<BFloat16>::ge(const Vec512<BFloat16>& other) const {
+  return (*this >= other) & Vec512<BFloat16>(1.0f);
+}
+
+Vec512<BFloat16> Vec512<BFloat16>::lt(const Vec512<BFloat16>& other) const {
+  return (*this < other) & Vec512<BFloat16>(1.0f);
+}
+
+Vec512<BFloat16> Vec512<BFloat16>::le(const Vec512<BFloat16>& other) const {
+  return (*this <= other) & Vec512<BFloat16>(1.0f);
+}
+
+// frac. Implement this here so we can use subtraction
+Vec512<BFloat16> Vec512<BFloat16>::frac() const {
+  return *this - this->trunc();
+}
+
+// Implements the IEEE 754 201X `maximum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vec512<BFloat16> inline maximum(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return bfloat16_binary_op_as_fp32(a, b, [](Vec512<float> x, Vec512<float> y) { return maximum(x, y); });
+}
+
+// Implements the IEEE 754 201X `minimum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vec512<BFloat16> inline minimum(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return bfloat16_binary_op_as_fp32(a, b, [](Vec512<float> x, Vec512<float> y) { return minimum(x, y); });
+}
+
+template <>
+Vec512<BFloat16> inline clamp_max(const Vec512<BFloat16>& a, const Vec512<BFloat16>& max) {
+  return bfloat16_binary_op_as_fp32(a, max, [](Vec512<float> x, Vec512<float> y) { return clamp_max(x, y); });
+}
+
+template <>
+Vec512<BFloat16> inline clamp_min(const Vec512<BFloat16>& a, const Vec512<BFloat16>& min) {
+  return bfloat16_binary_op_as_fp32(a, min, [](Vec512<float> x, Vec512<float> y) { return clamp_min(x, y); });
+}
+
+template <>
+Vec512<BFloat16> inline clamp(const Vec512<BFloat16>& a,
+    const Vec512<BFloat16>& min, const Vec512<BFloat16>& max) {
+  return clamp_max(clamp_min(a, min), max);
+}
+
+template <>
+inline void convert(const BFloat16* src, BFloat16* dst, int64_t n) {
+  int64_t i;
+#pragma unroll
+  for (i = 0; i <= (n - Vec512<BFloat16>::size()); i += Vec512<BFloat16>::size()) {
+    auto vsrc = _mm512_loadu_si512(reinterpret_cast<const __m512i*>((const void*)(src + i)));
+    _mm512_storeu_si512(reinterpret_cast<__m512i*>((void*)(dst + i)), vsrc);
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = src[i];
+  }
+}
+
+template <>
+Vec512<BFloat16> inline fmadd(const Vec512<BFloat16>& a,
+    const Vec512<BFloat16>& b, const Vec512<BFloat16>& c) {
+  __m512 a_lo, a_hi;
+  __m512 b_lo, b_hi;
+  __m512 c_lo, c_hi;
+  cvtbf16_fp32(__m512i(a), a_lo, a_hi);
+  cvtbf16_fp32(__m512i(b), b_lo, b_hi);
+  cvtbf16_fp32(__m512i(c), c_lo, c_hi);
+  auto o1 = _mm512_fmadd_ps(a_lo, b_lo, c_lo);
+  auto o2 = _mm512_fmadd_ps(a_hi, b_hi, c_hi);
+  return cvtfp32_bf16(o1, o2);
+}
+
+#endif
+
+}}}
@@ -760,7 +760,7 @@ void vdot<c10::complex<double>>(CUDABLAS_DOT_ARGTYPES(c10::complex<double>)) {
                                    reinterpret_cast<cuDoubleComplex*>(result)));
 }
 
-// This guards blocks use of getrfBatched and getriBatched on platforms other than cuda
+// This guards blocks use of getrfBatched, getriBatched and getrsBatched on platforms other than cuda
 #ifdef CUDART_VERSION
 
 template <>
@@ -879,6 +879,74 @@ void getriBatched<c10::complex<float>>(
       batchsize));
 }
 
+template <>
+void getrsBatched<double>(
+    int n, int nrhs, double** dA_array, int ldda, int* ipiv_array, double** dB_array, int lddb, int* info, int batchsize) {
+  auto handle = at::cuda::getCurrentCUDABlasHandle();
+  TORCH_CUDABLAS_CHECK(cublasDgetrsBatched(
+      handle, CUBLAS_OP_N, n, nrhs, dA_array, ldda, ipiv_array, dB_array, lddb, info, batchsize));
+}
+
+template <>
+void getrsBatched<float>(
+    int n, int nrhs, float** dA_array, int ldda, int* ipiv_array, float** dB_array, int lddb, int* info, int batchsize) {
+  auto handle = at::cuda::getCurrentCUDABlasHandle();
+  TORCH_CUDABLAS_CHECK(cublasSgetrsBatched(
+      handle, CUBLAS_OP_N, n, nrhs, dA_array, ldda, ipiv_array, dB_array, lddb, info, batchsize));
+}
+
+template <>
+void getrsBatched<c10::complex<double>>(
+    int n,
+    int nrhs,
+    c10::complex<double>** dA_array,
+    int ldda,
+    int* ipiv_array,
+    c10::complex<double>** dB_array,
+    int lddb,
+    int* info,
+    int batchsize) {
+  auto handle = at::cuda::getCurrentCUDABlasHandle();
+  TORCH_CUDABLAS_CHECK(cublasZgetrsBatched(
+      handle,
+      CUBLAS_OP_N,
+      n,
+      nrhs,
+      reinterpret_cast<cuDoubleComplex**>(dA_array),
+      ldda,
+      ipiv_array,
+      reinterpret_cast<cuDoubleComplex**>(dB_array),
+      lddb,
+      info,
+      batchsize));
+}
+
+template <>
+void getrsBatched<c10::complex<float>>(
+    int n,
+    int nrhs,
+    c10::complex<float>** dA_array,
+    int ldda,
+    int* ipiv_array,
+    c10::complex<float>** dB_array,
+    int lddb,
+    int* info,
+    int batchsize) {
+  auto handle = at::cuda::getCurrentCUDABlasHandle();
+  TORCH_CUDABLAS_CHECK(cublasCgetrsBatched(
+      handle,
+      CUBLAS_OP_N,
+      n,
+      nrhs,
+      reinterpret_cast<cuComplex**>(dA_array),
+      ldda,
+      ipiv_array,
+      reinterpret_cast<cuComplex**>(dB_array),
+      lddb,
+      info,
+      batchsize));
+}
+
 #endif // CUDART_VERSION
 
 } // namespace blas
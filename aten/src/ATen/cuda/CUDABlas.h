@@ -154,7 +154,7 @@ void vdot<c10::complex<float>>(CUDABLAS_DOT_ARGTYPES(c10::complex<float>));
 template <>
 void vdot<c10::complex<double>>(CUDABLAS_DOT_ARGTYPES(c10::complex<double>));
 
-// This guards blocks use of getrfBatched and getriBatched on platforms other than cuda
+// This guards blocks use of getrfBatched, getriBatched and getrsBatched on platforms other than cuda
 #ifdef CUDART_VERSION
 
 #define CUDABLAS_GETRF_ARGTYPES(Dtype)  \
@@ -190,6 +190,25 @@ void getriBatched<c10::complex<double>>(CUDABLAS_GETRI_ARGTYPES(c10::complex<dou
 template<>
 void getriBatched<c10::complex<float>>(CUDABLAS_GETRI_ARGTYPES(c10::complex<float>));
 
+// getrsBatched solves op(A) X = B with the LU factorization of getrfBatched.
+// Unlike getrfBatched, 'info' is a host pointer: it only reports invalid
+// arguments, so calling it doesn't synchronize with the device.
+#define CUDABLAS_GETRS_ARGTYPES(Dtype)  \
+  int n, int nrhs, Dtype** dA_array, int ldda, int* ipiv_array, Dtype** dB_array, int lddb, int* info, int batchsize
+
+template<class Dtype>
+void getrsBatched(CUDABLAS_GETRS_ARGTYPES(Dtype)) {
+  TORCH_CHECK(false, "at::cuda::blas::getrsBatched: not implemented for ", typeid(Dtype).name());
+}
+template<>
+void getrsBatched<float>(CUDABLAS_GETRS_ARGTYPES(float));
+template<>
+void getrsBatched<double>(CUDABLAS_GETRS_ARGTYPES(double));
+template<>
+void getrsBatched<c10::complex<double>>(CUDABLAS_GETRS_ARGTYPES(c10::complex<double>));
+template<>
+void getrsBatched<c10::complex<float>>(CUDABLAS_GETRS_ARGTYPES(c10::complex<float>));
+
 #endif // CUDART_VERSION
 
 } // namespace blas
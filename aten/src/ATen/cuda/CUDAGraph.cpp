@@ -22,6 +22,21 @@ namespace cuda {
  *     ops properly.  Their graphs would yield invalid numerics on replay.
  */
 
+/**
+ * Note [CUDA Graph Memory Pools]
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * A replay writes to the same addresses the captured kernels wrote to, including
+ * the memory of intermediates whose tensors were freed during capture. Had that
+ * memory gone back to the regular pools of the caching allocator, it could be
+ * handed out to tensors outside the graph, which every replay would then corrupt.
+ *
+ * So capture_begin tells the allocator to serve the allocations of the capturing
+ * stream from a private pool, whose blocks only captures of that pool reuse. The
+ * static outputs of a capture live in the pool; they stay valid until the next
+ * replay overwrites them. reset() gives up the graph's use of the pool, and
+ * emptyCache returns its memory once no graph uses it and all its blocks are free.
+ */
+
 CUDAGraph::CUDAGraph()
   // CUDAStreams may not be default-constructed.
   : capture_stream_(at::cuda::getCurrentCUDAStream()) {
@@ -30,7 +45,7 @@ CUDAGraph::CUDAGraph()
 #endif
 }
 
-void CUDAGraph::capture_begin() {
+void CUDAGraph::capture_begin(c10::cuda::CUDACachingAllocator::MempoolId_t pool) {
 #if CUDA_VERSION >= 11000
   TORCH_CHECK(!has_graph_exec_,
               "This CUDAGraph instance already owns a captured graph. "
@@ -68,6 +83,14 @@ void CUDAGraph::capture_begin() {
   cudaStreamCaptureStatus status;
   AT_CUDA_CHECK(cudaStreamGetCaptureInfo(stream, &status, &id_));
   TORCH_INTERNAL_ASSERT(status == cudaStreamCaptureStatus::cudaStreamCaptureStatusActive);
+
+  // The allocations of the capture come from a private pool, see
+  // Note [CUDA Graph Memory Pools]. Capture ids are unique over the process,
+  // so {id_, 0} never collides with the pool of another graph.
+  capture_dev_ = c10::cuda::current_device();
+  mempool_id_ = (pool.first != 0 || pool.second != 0) ? pool : std::make_pair(id_, 0ULL);
+  c10::cuda::CUDACachingAllocator::notifyCaptureBegin(capture_dev_, id_, mempool_id_);
+  has_mempool_ = true;
 #else
   TORCH_CHECK(false, "CUDA graphs may only be used in Pytorch built with CUDA >= 11.0");
 #endif
@@ -80,8 +103,18 @@ void CUDAGraph::capture_end() {
   TORCH_CHECK(stream == capture_stream_,
               "Capture must end on the same stream it began on.");
 
-  AT_CUDA_CHECK(cudaStreamEndCapture(capture_stream_, &graph_));
-  TORCH_CHECK(graph_ != NULL, "Invalid capture.");
+  // Ends the routing of allocations to the private pool and the graph state
+  // of the generator even if the capture was invalidated, e.g. by an op that
+  // synchronizes, so that the caller can fall back to running eagerly.
+  cudaError_t capture_err = cudaStreamEndCapture(capture_stream_, &graph_);
+  c10::cuda::CUDACachingAllocator::notifyCaptureEnd(capture_dev_, id_);
+  wholegraph_increment_ = capture_gen_->capture_epilogue();
+  if (capture_err != cudaSuccess) {
+    // clears the error state of the failed capture
+    cudaGetLastError();
+  }
+  TORCH_CHECK(capture_err == cudaSuccess && graph_ != NULL,
+              "Invalid capture: ", cudaGetErrorString(capture_err));
   has_graph_ = true;
 
   // Trailing NULL, NULL, 0 arguments were recommended by Cuda driver people,
@@ -96,7 +129,6 @@ void CUDAGraph::capture_end() {
               "Default CUDA RNG generator on current device at capture end "
               "is different from default generator on current device "
               "when capture began");
-  wholegraph_increment_ = gen->capture_epilogue();
 
   // Now that we've instantiated graph_ into graph_exec_,
   // we don't need graph_ anymore.
@@ -151,15 +183,33 @@ void CUDAGraph::reset() {
   // if calls fail, is the compromise we chose.
   if (has_graph_) {
     C10_CUDA_CHECK_WARN(cudaGraphDestroy(graph_));
+    has_graph_ = false;
   }
   if (has_graph_exec_) {
     C10_CUDA_CHECK_WARN(cudaGraphExecDestroy(graph_exec_));
+    has_graph_exec_ = false;
+  }
+  // The memory of the pool is released once all graphs sharing it are reset
+  // and all its blocks are freed, see Note [CUDA Graph Memory Pools].
+  if (has_mempool_) {
+    c10::cuda::CUDACachingAllocator::notifyCaptureDestroy(capture_dev_, mempool_id_);
+    has_mempool_ = false;
   }
 #else
   TORCH_CHECK(false, "CUDA graphs may only be used in Pytorch built with CUDA >= 11.0");
 #endif
 }
 
+c10::cuda::CUDACachingAllocator::MempoolId_t CUDAGraph::pool() const {
+#if CUDA_VERSION >= 11000
+  TORCH_CHECK(has_mempool_,
+              "Called CUDAGraph::pool without a preceding capture_begin.");
+  return mempool_id_;
+#else
+  TORCH_CHECK(false, "CUDA graphs may only be used in Pytorch built with CUDA >= 11.0");
+#endif
+}
+
 CUDAGraph::~CUDAGraph() {
   reset();
 }
@@ -1,5 +1,6 @@
 #include <ATen/Tensor.h>
 #include <c10/core/Device.h>
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/cuda/CUDAStream.h>
 #include <ATen/CUDAGeneratorImpl.h>
 
@@ -10,10 +11,13 @@ struct TORCH_CUDA_CPP_API CUDAGraph {
   CUDAGraph();
   ~CUDAGraph();
 
-  void capture_begin();
+  // Allocations during capture come from a private memory pool of the
+  // graph, or from the pool of another graph given by its pool().
+  void capture_begin(c10::cuda::CUDACachingAllocator::MempoolId_t pool = {0, 0});
   void capture_end();
   void replay();
   void reset();
+  c10::cuda::CUDACachingAllocator::MempoolId_t pool() const;
 
   protected:
 #if CUDA_VERSION >= 11000
@@ -25,9 +29,18 @@ struct TORCH_CUDA_CPP_API CUDAGraph {
   bool has_graph_ = false;
   bool has_graph_exec_ = false;
 
+  // whether the graph holds a use of the private pool mempool_id_
+  bool has_mempool_ = false;
+
   // uuid, retrieved from Cuda
   unsigned long long id_;
 
+  // private memory pool of the allocations made during capture
+  c10::cuda::CUDACachingAllocator::MempoolId_t mempool_id_;
+
+  // Device on which capture began
+  int capture_dev_;
+
   // Stream on which capture began
   at::cuda::CUDAStream capture_stream_;
 
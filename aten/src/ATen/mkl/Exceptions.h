@@ -4,6 +4,7 @@
 #include <stdexcept>
 #include <sstream>
 #include <mkl_dfti.h>
+#include <mkl_spblas.h>
 
 namespace at { namespace native {
 
@@ -16,4 +17,13 @@ static inline void MKL_DFTI_CHECK(MKL_INT status)
   }
 }
 
+static inline void MKL_SPARSE_CHECK(sparse_status_t status)
+{
+  if (status != SPARSE_STATUS_SUCCESS) {
+    std::ostringstream ss;
+    ss << "MKL sparse BLAS error: status " << status;
+    throw std::runtime_error(ss.str());
+  }
+}
+
 }}  // namespace at::native
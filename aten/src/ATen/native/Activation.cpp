@@ -7,6 +7,9 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/Parallel.h>
 #include <ATen/core/DistributionsHelper.h>
+#if defined(C10_MOBILE) && defined(USE_XNNPACK)
+#include <ATen/native/xnnpack/Engine.h>
+#endif
 
 namespace at { namespace native {
 
@@ -136,6 +139,11 @@ Tensor elu_backward(
 }
 
 Tensor hardswish(const Tensor& self) {
+#if defined(C10_MOBILE) && defined(USE_XNNPACK)
+  if (xnnpack::use_hardswish(self)) {
+    return xnnpack::hardswish(self);
+  }
+#endif
   Tensor result;
   auto iter = TensorIterator::unary_op(result, self);
   hardswish_stub(iter.device_type(), iter);
@@ -149,6 +157,11 @@ Tensor& hardswish_out(Tensor& result, const Tensor& self) {
 }
 
 Tensor& hardswish_(Tensor& self) {
+#if defined(C10_MOBILE) && defined(USE_XNNPACK)
+  if (xnnpack::use_hardswish_(self)) {
+    return xnnpack::hardswish_(self);
+  }
+#endif
   auto iter = TensorIterator::unary_op(self, self);
   hardswish_stub(iter.device_type(), iter);
   return self;
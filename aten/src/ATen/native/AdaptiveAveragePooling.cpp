@@ -1,6 +1,9 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/AdaptivePooling.h>
+#if defined(C10_MOBILE) && defined(USE_XNNPACK)
+#include <ATen/native/xnnpack/Engine.h>
+#endif
 
 
 namespace at {
@@ -100,6 +103,11 @@ namespace {
     }
 
     if (!input.is_quantized() && output_size[0] == 1 && output_size[1] == 1) {
+#if defined(C10_MOBILE) && defined(USE_XNNPACK)
+      if (xnnpack::use_global_average_pool(input)) {
+        return xnnpack::global_average_pool(input);
+      }
+#endif
       // in this case, adaptive pooling is just computing mean over hw
       // dimensions, which can be done more efficiently
       Tensor out = input.mean({-1, -2}, /* keepdim = */ true);
@@ -0,0 +1,428 @@
+#include <ATen/native/Attention.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace at { namespace native {
+
+AttentionInputs prepare_attention_inputs(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const c10::optional<Tensor>& attn_mask,
+    c10::optional<double> scale) {
+  TORCH_CHECK(
+      (query.dim() == 3 || query.dim() == 4) && key.dim() == query.dim() &&
+          value.dim() == query.dim(),
+      "_scaled_dot_product_attention: expected query, key and value to be all 3-d or all 4-d, got ",
+      query.dim(), "-d, ", key.dim(), "-d and ", value.dim(), "-d");
+  TORCH_CHECK(
+      at::isFloatingType(query.scalar_type()) &&
+          key.scalar_type() == query.scalar_type() &&
+          value.scalar_type() == query.scalar_type(),
+      "_scaled_dot_product_attention: expected query, key and value of the same floating point dtype, got ",
+      query.scalar_type(), ", ", key.scalar_type(), " and ", value.scalar_type());
+  TORCH_CHECK(
+      key.device() == query.device() && value.device() == query.device(),
+      "_scaled_dot_product_attention: expected query, key and value on the same device");
+
+  auto as_4d = [](const Tensor& t) {
+    return (t.dim() == 3 ? t.unsqueeze(0) : t).contiguous();
+  };
+  AttentionInputs inputs;
+  inputs.query = as_4d(query);
+  inputs.key = as_4d(key);
+  inputs.value = as_4d(value);
+  inputs.batch = inputs.query.size(0);
+  inputs.heads = inputs.query.size(1);
+  inputs.query_len = inputs.query.size(2);
+  inputs.head_dim = inputs.query.size(3);
+  inputs.key_len = inputs.key.size(2);
+  inputs.value_dim = inputs.value.size(3);
+  TORCH_CHECK(
+      inputs.key.size(0) == inputs.batch && inputs.key.size(1) == inputs.heads &&
+          inputs.key.size(3) == inputs.head_dim &&
+          inputs.value.sizes().slice(0, 3) == inputs.key.sizes().slice(0, 3),
+      "_scaled_dot_product_attention: incompatible sizes of query ", query.sizes(),
+      ", key ", key.sizes(), " and value ", value.sizes());
+  inputs.scale = scale.has_value()
+      ? *scale
+      : 1.0 / std::sqrt(static_cast<double>(inputs.head_dim));
+
+  if (attn_mask.has_value() && attn_mask->defined()) {
+    Tensor mask = *attn_mask;
+    TORCH_CHECK(
+        mask.dim() <= 4,
+        "_scaled_dot_product_attention: expected a mask of at most 4 dimensions, got ",
+        mask.dim());
+    TORCH_CHECK(
+        mask.device() == query.device(),
+        "_scaled_dot_product_attention: expected the mask on the device of query");
+    if (mask.scalar_type() == kBool) {
+      // masked out where true
+      mask = at::zeros(mask.sizes(), query.options())
+                 .masked_fill_(mask, -std::numeric_limits<double>::infinity());
+    } else {
+      TORCH_CHECK(
+          mask.scalar_type() == query.scalar_type(),
+          "_scaled_dot_product_attention: expected a bool mask or a mask of the dtype of query, got ",
+          mask.scalar_type());
+    }
+    inputs.mask = mask.expand(
+        {inputs.batch, inputs.heads, inputs.query_len, inputs.key_len});
+  }
+  return inputs;
+}
+
+namespace {
+
+// The 4-d [batch, heads, query_len, key_len] scores, in the accumulation
+// dtype
+Tensor attention_scores(const AttentionInputs& inputs, bool is_causal) {
+  const auto acc_type = attention_acc_type(inputs.query.scalar_type());
+  Tensor scores = at::matmul(inputs.query, inputs.key.transpose(-2, -1))
+                      .to(acc_type)
+                      .mul_(inputs.scale);
+  if (inputs.mask.defined()) {
+    scores.add_(inputs.mask);
+  }
+  if (is_causal) {
+    scores.masked_fill_(
+        at::ones(
+            {inputs.query_len, inputs.key_len},
+            scores.options().dtype(kBool))
+            .triu_(1),
+        -std::numeric_limits<double>::infinity());
+  }
+  return scores;
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor> attention_math(
+    const AttentionInputs& inputs,
+    bool is_causal) {
+  Tensor scores = attention_scores(inputs, is_causal);
+  Tensor logsumexp = at::logsumexp(scores, -1);
+  Tensor probs = scores.sub_(logsumexp.unsqueeze(-1)).exp_();
+  Tensor out = at::matmul(probs.to(inputs.query.scalar_type()), inputs.value);
+  return std::make_tuple(out, logsumexp);
+}
+
+std::tuple<Tensor, Tensor, Tensor> attention_math_backward(
+    const Tensor& grad_out,
+    const AttentionInputs& inputs,
+    const Tensor& out,
+    const Tensor& logsumexp,
+    bool is_causal) {
+  const auto dtype = inputs.query.scalar_type();
+  const auto acc_type = attention_acc_type(dtype);
+  Tensor probs =
+      attention_scores(inputs, is_causal).sub_(logsumexp.unsqueeze(-1)).exp_();
+  Tensor grad = grad_out.to(acc_type);
+  Tensor grad_value = at::matmul(probs.transpose(-2, -1), grad);
+  Tensor grad_probs =
+      at::matmul(grad, inputs.value.to(acc_type).transpose(-2, -1));
+  Tensor delta = (grad * out.to(acc_type)).sum(-1, /*keepdim=*/true);
+  Tensor grad_scores = grad_probs.sub_(delta).mul_(probs).mul_(inputs.scale);
+  Tensor grad_query = at::matmul(grad_scores, inputs.key.to(acc_type));
+  Tensor grad_key =
+      at::matmul(grad_scores.transpose(-2, -1), inputs.query.to(acc_type));
+  return std::make_tuple(
+      grad_query.to(dtype), grad_key.to(dtype), grad_value.to(dtype));
+}
+
+namespace {
+
+// The CPU kernels compute blocks of query rows against blocks of keys, with
+// an online softmax: the running max and sum of the exponentials of each row
+// rescale its output accumulator whenever the max grows, so that only a
+// block of scores is ever materialized.
+constexpr int64_t kAttentionQueryBlock = 32;
+constexpr int64_t kAttentionKeyBlock = 128;
+
+template <typename scalar_t>
+using attention_acc_t = typename std::
+    conditional<std::is_same<scalar_t, double>::value, double, float>::type;
+
+template <typename scalar_t>
+void attention_forward_cpu_kernel(
+    const Tensor& out,
+    const Tensor& logsumexp,
+    const AttentionInputs& inputs,
+    bool is_causal) {
+  using acc_t = attention_acc_t<scalar_t>;
+  constexpr acc_t neg_inf = -std::numeric_limits<acc_t>::infinity();
+  const int64_t heads = inputs.heads;
+  const int64_t L = inputs.query_len;
+  const int64_t S = inputs.key_len;
+  const int64_t E = inputs.head_dim;
+  const int64_t Ev = inputs.value_dim;
+  const acc_t scale = inputs.scale;
+  const scalar_t* query = inputs.query.data_ptr<scalar_t>();
+  const scalar_t* key = inputs.key.data_ptr<scalar_t>();
+  const scalar_t* value = inputs.value.data_ptr<scalar_t>();
+  const scalar_t* mask =
+      inputs.mask.defined() ? inputs.mask.data_ptr<scalar_t>() : nullptr;
+  const IntArrayRef mask_strides =
+      inputs.mask.defined() ? inputs.mask.strides() : IntArrayRef();
+  scalar_t* out_data = out.data_ptr<scalar_t>();
+  acc_t* logsumexp_data = logsumexp.data_ptr<acc_t>();
+
+  const int64_t num_query_blocks =
+      (L + kAttentionQueryBlock - 1) / kAttentionQueryBlock;
+  at::parallel_for(
+      0, inputs.batch * heads * num_query_blocks, 1, [&](int64_t begin, int64_t end) {
+    std::vector<acc_t> query_block(kAttentionQueryBlock * E);
+    std::vector<acc_t> scores(kAttentionKeyBlock);
+    std::vector<acc_t> row_max(kAttentionQueryBlock);
+    std::vector<acc_t> row_sum(kAttentionQueryBlock);
+    std::vector<acc_t> acc(kAttentionQueryBlock * Ev);
+    for (int64_t task = begin; task < end; task++) {
+      const int64_t bh = task / num_query_blocks;
+      const int64_t b = bh / heads;
+      const int64_t h = bh % heads;
+      const int64_t q_begin = (task % num_query_blocks) * kAttentionQueryBlock;
+      const int64_t q_end = std::min(q_begin + kAttentionQueryBlock, L);
+      const scalar_t* k_ptr = key + bh * S * E;
+      const scalar_t* v_ptr = value + bh * S * Ev;
+      for (int64_t i = q_begin; i < q_end; i++) {
+        const scalar_t* q_ptr = query + (bh * L + i) * E;
+        for (int64_t e = 0; e < E; e++) {
+          query_block[(i - q_begin) * E + e] = static_cast<acc_t>(q_ptr[e]) * scale;
+        }
+      }
+      std::fill(row_max.begin(), row_max.end(), neg_inf);
+      std::fill(row_sum.begin(), row_sum.end(), acc_t(0));
+      std::fill(acc.begin(), acc.end(), acc_t(0));
+
+      const int64_t key_end = is_causal ? std::min(S, q_end) : S;
+      for (int64_t k_begin = 0; k_begin < key_end; k_begin += kAttentionKeyBlock) {
+        const int64_t k_end = std::min(k_begin + kAttentionKeyBlock, key_end);
+        for (int64_t i = q_begin; i < q_end; i++) {
+          const int64_t r = i - q_begin;
+          const acc_t* q_row = query_block.data() + r * E;
+          acc_t block_max = neg_inf;
+          for (int64_t j = k_begin; j < k_end; j++) {
+            acc_t s = neg_inf;
+            if (!is_causal || j <= i) {
+              const scalar_t* k_row = k_ptr + j * E;
+              s = 0;
+              for (int64_t e = 0; e < E; e++) {
+                s += q_row[e] * static_cast<acc_t>(k_row[e]);
+              }
+              if (mask != nullptr) {
+                s += static_cast<acc_t>(mask[b * mask_strides[0] + h * mask_strides[1] +
+                                             i * mask_strides[2] + j * mask_strides[3]]);
+              }
+            }
+            scores[j - k_begin] = s;
+            block_max = std::max(block_max, s);
+          }
+          const acc_t new_max = std::max(row_max[r], block_max);
+          if (new_max == neg_inf) {
+            continue;
+          }
+          const acc_t correction = std::exp(row_max[r] - new_max);
+          acc_t* acc_row = acc.data() + r * Ev;
+          row_sum[r] *= correction;
+          for (int64_t e = 0; e < Ev; e++) {
+            acc_row[e] *= correction;
+          }
+          for (int64_t j = k_begin; j < k_end; j++) {
+            const acc_t p = std::exp(scores[j - k_begin] - new_max);
+            if (p == 0) {
+              continue;
+            }
+            row_sum[r] += p;
+            const scalar_t* v_row = v_ptr + j * Ev;
+            for (int64_t e = 0; e < Ev; e++) {
+              acc_row[e] += p * static_cast<acc_t>(v_row[e]);
+            }
+          }
+          row_max[r] = new_max;
+        }
+      }
+
+      for (int64_t i = q_begin; i < q_end; i++) {
+        const int64_t r = i - q_begin;
+        scalar_t* out_row = out_data + (bh * L + i) * Ev;
+        for (int64_t e = 0; e < Ev; e++) {
+          out_row[e] = static_cast<scalar_t>(acc[r * Ev + e] / row_sum[r]);
+        }
+        logsumexp_data[bh * L + i] = row_max[r] + std::log(row_sum[r]);
+      }
+    }
+  });
+}
+
+// Recomputes the probabilities of each row from its logsumexp, and
+// accumulates the gradients of the keys and values of a (batch, head) over
+// its query rows.
+template <typename scalar_t>
+void attention_backward_cpu_kernel(
+    const Tensor& grad_query,
+    const Tensor& grad_key,
+    const Tensor& grad_value,
+    const Tensor& grad_out,
+    const AttentionInputs& inputs,
+    const Tensor& out,
+    const Tensor& logsumexp,
+    bool is_causal) {
+  using acc_t = attention_acc_t<scalar_t>;
+  constexpr acc_t neg_inf = -std::numeric_limits<acc_t>::infinity();
+  const int64_t heads = inputs.heads;
+  const int64_t L = inputs.query_len;
+  const int64_t S = inputs.key_len;
+  const int64_t E = inputs.head_dim;
+  const int64_t Ev = inputs.value_dim;
+  const acc_t scale = inputs.scale;
+  const scalar_t* query = inputs.query.data_ptr<scalar_t>();
+  const scalar_t* key = inputs.key.data_ptr<scalar_t>();
+  const scalar_t* value = inputs.value.data_ptr<scalar_t>();
+  const scalar_t* mask =
+      inputs.mask.defined() ? inputs.mask.data_ptr<scalar_t>() : nullptr;
+  const IntArrayRef mask_strides =
+      inputs.mask.defined() ? inputs.mask.strides() : IntArrayRef();
+  const scalar_t* grad_out_data = grad_out.data_ptr<scalar_t>();
+  const scalar_t* out_data = out.data_ptr<scalar_t>();
+  const acc_t* logsumexp_data = logsumexp.data_ptr<acc_t>();
+  scalar_t* grad_query_data = grad_query.data_ptr<scalar_t>();
+  scalar_t* grad_key_data = grad_key.data_ptr<scalar_t>();
+  scalar_t* grad_value_data = grad_value.data_ptr<scalar_t>();
+
+  at::parallel_for(0, inputs.batch * heads, 1, [&](int64_t begin, int64_t end) {
+    std::vector<acc_t> grad_key_acc(S * E);
+    std::vector<acc_t> grad_value_acc(S * Ev);
+    std::vector<acc_t> grad_query_row(E);
+    std::vector<acc_t> grad_out_row(Ev);
+    for (int64_t bh = begin; bh < end; bh++) {
+      const int64_t b = bh / heads;
+      const int64_t h = bh % heads;
+      const scalar_t* k_ptr = key + bh * S * E;
+      const scalar_t* v_ptr = value + bh * S * Ev;
+      std::fill(grad_key_acc.begin(), grad_key_acc.end(), acc_t(0));
+      std::fill(grad_value_acc.begin(), grad_value_acc.end(), acc_t(0));
+      for (int64_t i = 0; i < L; i++) {
+        const scalar_t* q_row = query + (bh * L + i) * E;
+        const scalar_t* out_row = out_data + (bh * L + i) * Ev;
+        acc_t delta = 0;
+        for (int64_t e = 0; e < Ev; e++) {
+          grad_out_row[e] = grad_out_data[(bh * L + i) * Ev + e];
+          delta += grad_out_row[e] * static_cast<acc_t>(out_row[e]);
+        }
+        std::fill(grad_query_row.begin(), grad_query_row.end(), acc_t(0));
+        const acc_t lse = logsumexp_data[bh * L + i];
+        const int64_t key_end = is_causal ? std::min(S, i + 1) : S;
+        for (int64_t j = 0; lse != neg_inf && j < key_end; j++) {
+          const scalar_t* k_row = k_ptr + j * E;
+          const scalar_t* v_row = v_ptr + j * Ev;
+          acc_t s = 0;
+          for (int64_t e = 0; e < E; e++) {
+            s += static_cast<acc_t>(q_row[e]) * static_cast<acc_t>(k_row[e]);
+          }
+          s *= scale;
+          if (mask != nullptr) {
+            s += static_cast<acc_t>(mask[b * mask_strides[0] + h * mask_strides[1] +
+                                         i * mask_strides[2] + j * mask_strides[3]]);
+          }
+          const acc_t p = std::exp(s - lse);
+          if (p == 0) {
+            continue;
+          }
+          acc_t grad_p = 0;
+          for (int64_t e = 0; e < Ev; e++) {
+            grad_p += grad_out_row[e] * static_cast<acc_t>(v_row[e]);
+            grad_value_acc[j * Ev + e] += p * grad_out_row[e];
+          }
+          const acc_t grad_s = p * (grad_p - delta) * scale;
+          for (int64_t e = 0; e < E; e++) {
+            grad_query_row[e] += grad_s * static_cast<acc_t>(k_row[e]);
+            grad_key_acc[j * E + e] += grad_s * static_cast<acc_t>(q_row[e]);
+          }
+        }
+        for (int64_t e = 0; e < E; e++) {
+          grad_query_data[(bh * L + i) * E + e] = static_cast<scalar_t>(grad_query_row[e]);
+        }
+      }
+      for (int64_t idx = 0; idx < S * E; idx++) {
+        grad_key_data[bh * S * E + idx] = static_cast<scalar_t>(grad_key_acc[idx]);
+      }
+      for (int64_t idx = 0; idx < S * Ev; idx++) {
+        grad_value_data[bh * S * Ev + idx] = static_cast<scalar_t>(grad_value_acc[idx]);
+      }
+    }
+  });
+}
+
+// The contiguous 4-d version of a 3-d or 4-d tensor of the outputs
+Tensor attention_as_4d(const Tensor& t, int64_t dim) {
+  return (t.dim() == dim - 1 ? t.unsqueeze(0) : t).contiguous();
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor> _scaled_dot_product_attention_cpu(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const c10::optional<Tensor>& attn_mask,
+    bool is_causal,
+    c10::optional<double> scale) {
+  AttentionInputs inputs =
+      prepare_attention_inputs(query, key, value, attn_mask, scale);
+  Tensor out = at::empty(
+      {inputs.batch, inputs.heads, inputs.query_len, inputs.value_dim},
+      inputs.query.options());
+  Tensor logsumexp = at::empty(
+      {inputs.batch, inputs.heads, inputs.query_len},
+      inputs.query.options().dtype(attention_acc_type(query.scalar_type())));
+  if (out.numel() > 0) {
+    AT_DISPATCH_FLOATING_TYPES_AND(kBFloat16, query.scalar_type(), "_scaled_dot_product_attention_cpu", [&] {
+      attention_forward_cpu_kernel<scalar_t>(out, logsumexp, inputs, is_causal);
+    });
+  }
+  return std::make_tuple(
+      attention_output_as(out, query.sizes(), inputs.value_dim),
+      attention_output_as(logsumexp, query.sizes(), -1));
+}
+
+std::tuple<Tensor, Tensor, Tensor> _scaled_dot_product_attention_backward_cpu(
+    const Tensor& grad_out,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& out,
+    const Tensor& logsumexp,
+    const c10::optional<Tensor>& attn_mask,
+    bool is_causal,
+    c10::optional<double> scale) {
+  AttentionInputs inputs =
+      prepare_attention_inputs(query, key, value, attn_mask, scale);
+  Tensor grad_query = at::empty_like(inputs.query);
+  Tensor grad_key = at::empty_like(inputs.key);
+  Tensor grad_value = at::empty_like(inputs.value);
+  if (grad_key.numel() > 0 || grad_value.numel() > 0) {
+    AT_DISPATCH_FLOATING_TYPES_AND(kBFloat16, query.scalar_type(), "_scaled_dot_product_attention_backward_cpu", [&] {
+      attention_backward_cpu_kernel<scalar_t>(
+          grad_query, grad_key, grad_value,
+          attention_as_4d(grad_out, 4), inputs, attention_as_4d(out, 4),
+          attention_as_4d(logsumexp, 3), is_causal);
+    });
+  } else {
+    grad_query.zero_();
+  }
+  return std::make_tuple(
+      grad_query.view(query.sizes()),
+      grad_key.view(key.sizes()),
+      grad_value.view(value.sizes()));
+}
+
+}} // namespace at::native
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <c10/util/Optional.h>
+
+#include <tuple>
+
+namespace at { namespace native {
+
+// The inputs of _scaled_dot_product_attention and its backward as contiguous
+// 4-d [batch, heads, length, features] tensors (3-d inputs get a batch of 1),
+// with the mask, if any, made additive and expanded to
+// [batch, heads, query_len, key_len] with zero strides for the broadcast
+// dimensions.
+struct AttentionInputs {
+  Tensor query;
+  Tensor key;
+  Tensor value;
+  Tensor mask;
+  int64_t batch;
+  int64_t heads;
+  int64_t query_len;
+  int64_t key_len;
+  int64_t head_dim;
+  int64_t value_dim;
+  double scale;
+};
+
+// The dtype of the logsumexp of the attention of inputs of the given dtype
+inline ScalarType attention_acc_type(ScalarType dtype) {
+  return dtype == kDouble ? kDouble : kFloat;
+}
+
+TORCH_API AttentionInputs prepare_attention_inputs(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const c10::optional<Tensor>& attn_mask,
+    c10::optional<double> scale);
+
+// The attention computed with matmuls and a materialized score matrix, for
+// the inputs the fused kernels don't support. Returns 4-d outputs.
+TORCH_API std::tuple<Tensor, Tensor> attention_math(
+    const AttentionInputs& inputs,
+    bool is_causal);
+
+TORCH_API std::tuple<Tensor, Tensor, Tensor> attention_math_backward(
+    const Tensor& grad_out,
+    const AttentionInputs& inputs,
+    const Tensor& out,
+    const Tensor& logsumexp,
+    bool is_causal);
+
+// Views the 4-d output as the output for a query of the given sizes
+inline Tensor attention_output_as(
+    const Tensor& output,
+    IntArrayRef query_sizes,
+    int64_t last_dim) {
+  std::vector<int64_t> sizes = query_sizes.vec();
+  if (last_dim < 0) {
+    sizes.pop_back();
+  } else {
+    sizes.back() = last_dim;
+  }
+  return output.view(sizes);
+}
+
+}} // namespace at::native
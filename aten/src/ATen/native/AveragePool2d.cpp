@@ -138,6 +138,14 @@ void avg_pool2d_out_cpu_template(
     inputHeight, inputWidth,
     outputHeight, outputWidth, input_.suggest_memory_format());
 
+  if (input_.ndimension() == 4 && input_.scalar_type() != at::ScalarType::Long &&
+      input_.suggest_memory_format() == at::MemoryFormat::ChannelsLast) {
+    output.resize_({nbatch, nInputPlane, outputHeight, outputWidth}, at::MemoryFormat::ChannelsLast);
+    avg_pool2d_channels_last_kernel(kCPU, output, input_,
+        kW, kH, dW, dH, padW, padH, count_include_pad, divisor_override);
+    return;
+  }
+
   if (input_.ndimension() == 3) {
     output.resize_({nInputPlane, outputHeight, outputWidth});
   }
@@ -295,6 +303,15 @@ Tensor& avg_pool2d_backward_out_cpu_template(
     outputHeight, outputWidth,
     input.suggest_memory_format());
 
+  if (ndim == 4 && input.scalar_type() != at::ScalarType::Long &&
+      input.suggest_memory_format() == at::MemoryFormat::ChannelsLast) {
+    gradInput.resize_(input.sizes(), at::MemoryFormat::ChannelsLast);
+    gradInput.zero_();
+    avg_pool2d_backward_channels_last_kernel(kCPU, gradInput, gradOutput_,
+        kW, kH, dW, dH, padW, padH, count_include_pad, divisor_override);
+    return gradInput;
+  }
+
   /* get contiguous gradOutput */
   const Tensor gradOutput = gradOutput_.contiguous();
 
@@ -329,6 +346,9 @@ Tensor& avg_pool2d_backward_out_cpu_template(
 
 } // namespace
 
+DEFINE_DISPATCH(avg_pool2d_channels_last_kernel);
+DEFINE_DISPATCH(avg_pool2d_backward_channels_last_kernel);
+
 Tensor& avg_pool2d_out_cpu(
   Tensor& output,
   const Tensor& input,
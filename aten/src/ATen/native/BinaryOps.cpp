@@ -7,6 +7,9 @@
 #include <ATen/MemoryOverlap.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/TensorIterator.h>
+#if defined(C10_MOBILE) && defined(USE_XNNPACK)
+#include <ATen/native/xnnpack/Engine.h>
+#endif
 
 #include <torch/library.h>
 
@@ -77,12 +80,26 @@ static Tensor wrapped_scalar_tensor(Scalar scalar) {
 TORCH_IMPL_FUNC(add_out) (
   const Tensor& self, const Tensor& other, Scalar alpha, const Tensor& result
 ) {
+#if defined(C10_MOBILE) && defined(USE_XNNPACK)
+  if (!alpha.isComplex() && alpha.toDouble() == 1.0 &&
+      xnnpack::use_add(self, other, result)) {
+    xnnpack::add(self, other, result);
+    return;
+  }
+#endif
   add_stub(device_type(), *this, alpha);
   TORCH_INTERNAL_ASSERT(result.scalar_type() == output().dtype());
 }
 
 Tensor& add_relu_impl(
     Tensor& result, const Tensor& self, const Tensor& other, Scalar alpha) {
+#if defined(C10_MOBILE) && defined(USE_XNNPACK)
+  if (!alpha.isComplex() && alpha.toDouble() == 1.0 &&
+      xnnpack::use_add(self, other, result)) {
+    result = xnnpack::add(self, other, result, 0.0f);
+    return result;
+  }
+#endif
   auto iter = TensorIterator::binary_op(result, self, other);
   Scalar min_val;
   Scalar max_val;
@@ -336,12 +353,23 @@ Tensor& floor_divide_(Tensor& self, const Tensor& other) {
 }
 
 Tensor& mul_out(Tensor& result, const Tensor& self, const Tensor& other) {
+#if defined(C10_MOBILE) && defined(USE_XNNPACK)
+  if (xnnpack::use_multiply(self, other, result)) {
+    xnnpack::multiply(self, other, result);
+    return result;
+  }
+#endif
   auto iter = TensorIterator::binary_op(result, self, other);
   mul_stub(iter.device_type(), iter);
   return result;
 }
 
 Tensor mul(const Tensor& self, const Tensor& other) {
+#if defined(C10_MOBILE) && defined(USE_XNNPACK)
+  if (xnnpack::use_multiply(self, other, Tensor())) {
+    return xnnpack::multiply(self, other, Tensor());
+  }
+#endif
   Tensor result;
   auto iter = TensorIterator::binary_op(result, self, other);
   mul_stub(iter.device_type(), iter);
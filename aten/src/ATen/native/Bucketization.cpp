@@ -1,6 +1,10 @@
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
 #include <ATen/native/BucketizationUtils.h>
+#include <c10/util/llvmMathExtras.h>
+
+#include <limits>
+#include <vector>
 
 /* Implement a TF like searchsorted and a bucketize function running on cpu
  *
@@ -43,6 +47,94 @@ const input_t* cus_lower_bound(const input_t* start, const input_t* end, input_t
   return start;
 }
 
+// Note [Eytzinger searchsorted]
+// A binary search over a sorted sequence much larger than the cache misses on
+// most of its steps, and each step waits for the previous one. When many
+// values are searched in the same 1-D boundaries, the boundaries are first
+// laid out in Eytzinger (BFS) order: the children of node k are 2k and 2k+1,
+// so that the nodes of the first levels, which every search reads, share a few
+// cache lines. The tree is padded to a full one with the largest value, so that
+// every search takes the same number of branchless steps, and a batch of
+// values is searched in lockstep, so that the loads of the searches overlap.
+// The search ends at the node after the last one it went right at, found from
+// the trailing ones of its final position, whose rank in the boundaries is the
+// result. The padding nodes, and the root of no node, have the rank idim_bd.
+//
+// The layout takes O(idim_bd) to build, so it's used when there are at least
+// as many values as boundaries.
+constexpr int64_t EYTZINGER_MIN_BOUNDARIES = 64;
+constexpr int64_t EYTZINGER_BATCH_SIZE = 16;
+
+template<typename input_t>
+struct EytzingerBoundaries {
+  EytzingerBoundaries(const input_t* data_bd, int64_t idim_bd) {
+    levels = llvm::Log2_64_Ceil(idim_bd + 1);
+    const int64_t size = int64_t(1) << levels;
+    const input_t padding = std::numeric_limits<input_t>::has_infinity ?
+      std::numeric_limits<input_t>::infinity() : std::numeric_limits<input_t>::max();
+    keys.assign(size, padding);
+    ranks.assign(size, idim_bd);
+    // in-order traversal, the tree being full
+    int64_t rank = 0;
+    int64_t k = 1;
+    while (k < size) {
+      k <<= 1;
+    }
+    k >>= 1;
+    for (int64_t i = 0; i < size - 1; ++i) {
+      if (rank < idim_bd) {
+        keys[k] = data_bd[rank];
+        ranks[k] = rank;
+      }
+      ++rank;
+      // next node in order: the leftmost of the right subtree, or the first
+      // ancestor reached from its left child
+      if (2 * k + 1 < size) {
+        k = 2 * k + 1;
+        while (2 * k < size) {
+          k = 2 * k;
+        }
+      } else {
+        k >>= llvm::countTrailingOnes(static_cast<uint64_t>(k)) + 1;
+      }
+    }
+  }
+
+  template<typename output_t>
+  void search(const input_t* data_in, output_t* data_out, int64_t n, bool right) const {
+    int64_t k[EYTZINGER_BATCH_SIZE];
+    for (int64_t begin = 0; begin < n; begin += EYTZINGER_BATCH_SIZE) {
+      const int64_t batch = std::min(EYTZINGER_BATCH_SIZE, n - begin);
+      const input_t* values = data_in + begin;
+      for (int64_t j = 0; j < batch; ++j) {
+        k[j] = 1;
+      }
+      for (int level = 0; level < levels; ++level) {
+        if (!right) {
+          for (int64_t j = 0; j < batch; ++j) {
+            k[j] = 2 * k[j] + !(keys[k[j]] >= values[j]);
+          }
+        } else {
+          for (int64_t j = 0; j < batch; ++j) {
+            k[j] = 2 * k[j] + !(values[j] < keys[k[j]]);
+          }
+        }
+      }
+      for (int64_t j = 0; j < batch; ++j) {
+        const uint64_t node = static_cast<uint64_t>(k[j]) >>
+          (llvm::countTrailingOnes(static_cast<uint64_t>(k[j])) + 1);
+        // type conversion might happen here
+        data_out[begin + j] = ranks[node];
+      }
+    }
+  }
+
+  int levels;
+  // keys[0] is unused, ranks[0] is idim_bd
+  std::vector<input_t> keys;
+  std::vector<int64_t> ranks;
+};
+
 template<typename input_t, typename output_t>
 void searchsorted_cpu_contiguous(Tensor& result, const Tensor& input, const Tensor& boundaries, const bool& right) {
   int64_t numel_in = input.numel();
@@ -56,6 +148,15 @@ void searchsorted_cpu_contiguous(Tensor& result, const Tensor& input, const Tens
   output_t *data_out = result.data_ptr<output_t>();
 
   bool is_1d_boundaries = boundaries.dim() == 1;
+  // See Note [Eytzinger searchsorted]
+  if (is_1d_boundaries && idim_bd >= EYTZINGER_MIN_BOUNDARIES && numel_in >= idim_bd) {
+    const EytzingerBoundaries<input_t> tree(data_bd, idim_bd);
+    at::parallel_for(0, numel_in, SEARCHSORTED_GRAIN_SIZE, [&](int64_t start, int64_t end) {
+      tree.search(data_in + start, data_out + start, end - start, right);
+    });
+    return;
+  }
+
   at::parallel_for(0, numel_in, SEARCHSORTED_GRAIN_SIZE, [&](int64_t start, int64_t end) {
     for (int64_t i = start; i < end; ++i) {
       // If boundaries tensor is 1d, we always search the entire boundary tensor
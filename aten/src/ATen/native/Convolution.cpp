@@ -1,6 +1,8 @@
 #include <limits>
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/core/Vitals.h>
+#include <ATen/native/cpu/Conv2dKernel.h>
 #include <ATen/native/cpu/DepthwiseConvKernel.h>
 #include <ATen/native/utils/ParamUtils.h>
 #include <ATen/native/ConvUtils.h>
@@ -19,6 +21,8 @@ constexpr int MIOPEN_DIM_MAX = 5;
 namespace at { namespace native {
 
 DEFINE_DISPATCH(convolution_depthwise3x3_winograd_stub);
+DEFINE_DISPATCH(convolution_winograd3x3_stub);
+DEFINE_DISPATCH(convolution_direct_nhwc_stub);
 
 struct ConvParams {
   std::vector<int64_t> stride;
@@ -41,6 +45,11 @@ struct ConvParams {
   bool is_stride_nonpos() const;
   void view1d_as_2d();
   bool use_cpu_depthwise3x3_winograd(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool use_cpu_depthwise(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool use_cpu_native_conv(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool use_cpu_winograd3x3(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  int64_t cpu_winograd3x3_tile_size(const at::Tensor& input) const;
+  bool use_cpu_direct_nhwc(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
   bool needs_64bit_indexing_no_split(const at::Tensor& input, const at::Tensor& weight) const;
   bool use_cudnn(const at::Tensor& input, const at::Tensor& weight) const;
   bool use_cudnn_depthwise(const at::Tensor& input, const at::Tensor& weight) const;
@@ -161,6 +170,96 @@ auto ConvParams::use_cpu_depthwise3x3_winograd(
 #endif
 }
 
+// The direct depthwise kernels of cpu/DepthwiseConvKernel.h, differentiable
+// through thnn_conv_depthwise2d, for any stride, padding and dilation
+auto ConvParams::use_cpu_depthwise(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias) const -> bool {
+  return (input.ndimension() == 4) &&
+         (weight.ndimension() == 4) &&
+         (input.device().type() == c10::DeviceType::CPU) &&
+         (input.layout() == at::kStrided) &&
+         (input.scalar_type() == at::kFloat || input.scalar_type() == at::kDouble) &&
+         (weight.device().type() == c10::DeviceType::CPU) &&
+         (weight.layout() == at::kStrided) &&
+         (weight.scalar_type() == input.scalar_type()) &&
+         (!bias.defined() ||
+            ((bias.device().type() == c10::DeviceType::CPU) &&
+             (bias.scalar_type() == input.scalar_type()))) &&
+         (input.size(1) == groups) &&
+         groups > 1 &&
+         (weight.size(0) % input.size(1) == 0) &&
+         !transposed;
+}
+
+// The float convolution kernels of cpu/Conv2dKernel.h, for inference when
+// MKL-DNN doesn't take the convolution (or isn't built, e.g. on ARM)
+auto ConvParams::use_cpu_native_conv(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias) const -> bool {
+  return (input.ndimension() == 4) &&
+         (weight.ndimension() == 4) &&
+         (input.device().type() == c10::DeviceType::CPU) &&
+         (input.layout() == at::kStrided) &&
+         (input.scalar_type() == at::kFloat) &&
+         (weight.device().type() == c10::DeviceType::CPU) &&
+         (weight.layout() == at::kStrided) &&
+         (weight.scalar_type() == at::kFloat) &&
+         (!bias.defined() ||
+            ((bias.device().type() == c10::DeviceType::CPU) &&
+             (bias.scalar_type() == at::kFloat))) &&
+         // the kernels are not differentiable
+         !input.requires_grad() &&
+         !weight.requires_grad() &&
+         !(bias.defined() && bias.requires_grad()) &&
+         (input.numel() > 0) &&
+         (groups == 1) &&
+         !transposed;
+}
+
+auto ConvParams::use_cpu_winograd3x3(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias) const -> bool {
+  return use_cpu_native_conv(input, weight, bias) &&
+         (weight.size(2) == 3) &&
+         (weight.size(3) == 3) &&
+         !is_strided() &&
+         !is_dilated() &&
+         // enough channels to amortize the transforms of the tiles
+         (input.size(1) >= 16) &&
+         (weight.size(0) >= 16) &&
+         // and at least 4x4 outputs
+         (input.size(2) + 2 * padding[0] >= 6) &&
+         (input.size(3) + 2 * padding[1] >= 6);
+}
+
+// F(4x4, 3x3) does 4 times fewer multiplications than the direct convolution
+// and F(2x2, 3x3) 2.25 times, but the larger tiles waste more at the borders
+auto ConvParams::cpu_winograd3x3_tile_size(const at::Tensor& input) const -> int64_t {
+  const int64_t out_rows = input.size(2) + 2 * padding[0] - 2;
+  const int64_t out_cols = input.size(3) + 2 * padding[1] - 2;
+  return (out_rows >= 16 && out_cols >= 16) ? 4 : 2;
+}
+
+auto ConvParams::use_cpu_direct_nhwc(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias) const -> bool {
+  if (!use_cpu_native_conv(input, weight, bias)) {
+    return false;
+  }
+  // channels last inputs would be converted for im2col
+  if (input.suggest_memory_format() == at::MemoryFormat::ChannelsLast) {
+    return true;
+  }
+  // as well as few input channels, which make poorly shaped GEMMs
+  const bool is_pointwise = (weight.size(2) == 1) && (weight.size(3) == 1);
+  return !is_pointwise && (input.size(1) * weight.size(2) * weight.size(3) <= 256);
+}
+
 auto ConvParams::needs_64bit_indexing_no_split(const at::Tensor& input, const at::Tensor& weight) const -> bool {
   constexpr int64_t int_max = std::numeric_limits<int>::max();
   int64_t numel_input = input.numel();
@@ -768,6 +867,28 @@ at::Tensor _convolution(
         params.stride,
         params.padding,
         params.groups);
+  } else if (params.use_cpu_depthwise(input, weight, bias)) {
+    output = at::thnn_conv_depthwise2d(
+        input, weight, weight.sizes().slice(2), bias, params.stride, params.padding, params.dilation);
+  } else if (params.use_cpu_winograd3x3(input, weight, bias)) {
+    output = convolution_winograd3x3_stub(
+        input.device().type(),
+        input,
+        weight,
+        bias,
+        params.padding,
+        params.cpu_winograd3x3_tile_size(input));
+    output = output.contiguous(input.suggest_memory_format());
+  } else if (params.use_cpu_direct_nhwc(input, weight, bias)) {
+    output = convolution_direct_nhwc_stub(
+        input.device().type(),
+        input,
+        weight,
+        bias,
+        params.stride,
+        params.padding,
+        params.dilation);
+    output = output.contiguous(input.suggest_memory_format());
   } else if (
         !params.transposed && (input.ndimension() == 5) &&
         (input.device().type() == c10::DeviceType::CPU) &&
@@ -781,6 +902,9 @@ at::Tensor _convolution(
           params.stride,
           params.padding);
   } else if (input.device().type() == c10::DeviceType::CPU || input.device().type() == c10::DeviceType::CUDA) {
+    if (input.is_cuda()) {
+      TORCH_SLOW_PATH(CUDNN_CONV_FALLBACK);
+    }
     if (params.groups == 1) {
       output = at::_convolution_nogroup(
           input.contiguous(), weight, bias, params.stride, params.padding, params.dilation, params.transposed, params.output_padding);
@@ -197,6 +197,89 @@ static void slow_conv2d_update_output_frame(
   }
 }
 
+// Without autograd, the output is computed by tiles of output rows whose
+// im2col fits in L2, instead of keeping the finput of the whole batch, so that
+// the memory doesn't grow with the batch size
+constexpr int64_t kSlowConv2dTileBytes = 256 * 1024;
+
+static inline bool slow_conv2d_needs_finput(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias) {
+  return GradMode::is_enabled() &&
+      (input.requires_grad() || weight.requires_grad() ||
+       (bias.defined() && bias.requires_grad()));
+}
+
+static void slow_conv2d_update_output_blocked(
+    const Tensor& input,
+    Tensor& output,
+    const Tensor& weight,
+    const Tensor& bias,
+    int64_t kernel_height,
+    int64_t kernel_width,
+    int64_t stride_height,
+    int64_t stride_width,
+    int64_t pad_height,
+    int64_t pad_width,
+    int64_t n_input_plane,
+    int64_t input_height,
+    int64_t input_width,
+    int64_t n_output_plane,
+    int64_t output_height,
+    int64_t output_width) {
+  const int64_t batch_size = input.size(0);
+  const int64_t unfolded_rows = n_input_plane * kernel_height * kernel_width;
+  const int64_t rows_per_tile = std::min(
+      output_height,
+      std::max<int64_t>(
+          1, kSlowConv2dTileBytes / (unfolded_rows * output_width * input.element_size())));
+  const int64_t tiles = (output_height + rows_per_tile - 1) / rows_per_tile;
+
+  at::parallel_for(0, batch_size * tiles, 0, [&](int64_t start, int64_t end) {
+    NoGradGuard no_grad;
+    AutoNonVariableTypeMode non_variable_type_mode;
+    // reused by all the tiles of this thread
+    Tensor buffer = at::empty({unfolded_rows * rows_per_tile * output_width}, input.options());
+    for (int64_t task = start; task < end; task++) {
+      const int64_t t = task / tiles;
+      const int64_t row_begin = (task % tiles) * rows_per_tile;
+      const int64_t rows = std::min(rows_per_tile, output_height - row_begin);
+      Tensor input_t = input[t];
+      Tensor finput_tile =
+          buffer.narrow(0, 0, unfolded_rows * rows * output_width)
+              .view({unfolded_rows, rows * output_width});
+      unfolded2d_copy_rows_stub(
+          kCPU,
+          finput_tile,
+          input_t,
+          kernel_height,
+          kernel_width,
+          stride_height,
+          stride_width,
+          pad_height,
+          pad_width,
+          n_input_plane,
+          input_height,
+          input_width,
+          row_begin,
+          rows,
+          output_width);
+
+      auto output_tile =
+          output[t]
+              .view({n_output_plane, output_height * output_width})
+              .narrow(1, row_begin * output_width, rows * output_width);
+      if (bias.defined()) {
+        output_tile.copy_(bias.unsqueeze(-1));
+        output_tile.addmm_(weight, finput_tile, 1, 1);
+      } else {
+        output_tile.addmm_(weight, finput_tile, 0, 1);
+      }
+    }
+  });
+}
+
 void slow_conv2d_backward_update_grad_input_frame(
     Tensor& grad_input,
     const Tensor& grad_output,
@@ -433,8 +516,33 @@ std::tuple<Tensor&, Tensor&, Tensor&> slow_conv2d_forward_out_cpu(
 
   const int64_t batch_size = input.size(0);
 
-  if ((input.ndimension() == 4) && (kernel_height == 1) && (stride_height == 1) && (pad_height == 0) &&
-      (kernel_width == 1) && (stride_width == 1) && (pad_width == 0)) {
+  const bool is_pointwise = (input.ndimension() == 4) && (kernel_height == 1) && (stride_height == 1) &&
+      (pad_height == 0) && (kernel_width == 1) && (stride_width == 1) && (pad_width == 0);
+  if (!is_pointwise && !slow_conv2d_needs_finput(self, weight_, bias)) {
+    // finput is only needed by the backward
+    finput.resize_({0});
+    output.resize_({batch_size, n_output_plane, output_height, output_width});
+    slow_conv2d_update_output_blocked(
+        input,
+        output,
+        weight_2d,
+        bias,
+        kernel_height,
+        kernel_width,
+        stride_height,
+        stride_width,
+        pad_height,
+        pad_width,
+        n_input_plane,
+        input_height,
+        input_width,
+        n_output_plane,
+        output_height,
+        output_width);
+    return std::tuple<Tensor&, Tensor&, Tensor&>(output, finput, fgrad_input);
+  }
+
+  if (is_pointwise) {
     finput =
         input.view({batch_size, n_input_plane, output_height * output_width})
             .detach();
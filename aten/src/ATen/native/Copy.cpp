@@ -25,62 +25,11 @@ using namespace at;
 
 bool copy_transpose_valid(const Tensor& self, const Tensor& src) {
   const int MIN_SZ = 60 * 60;
-  return self.is_contiguous() && src.numel() != 0 && src.dim() == 2 &&
-      src.stride(0) == 1 && src.stride(1) == src.size(0) &&
+  return self.dim() >= 2 && self.sizes() == src.sizes() &&
       self.scalar_type() == src.scalar_type() &&
-      self.numel() >= MIN_SZ;
-}
-
-// special case copy where tensor is contiguous and src is a transposed matrix
-// This can be generalized to most copies, but it's trickier
-void copy_same_type_transpose_(Tensor& self, const Tensor& src) {
-  int64_t BLOCK_SZ;
-  if (self.scalar_type() == kByte) {
-    BLOCK_SZ = 120;
-  } else {
-    BLOCK_SZ = 60;
-  }
-  Tensor buf = empty({BLOCK_SZ, BLOCK_SZ}, self.options());
-
-  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kHalf, kBool, kBFloat16, self.scalar_type(), "copy_", [&] {
-    scalar_t* sp = src.data_ptr<scalar_t>();
-    scalar_t* rp = self.data_ptr<scalar_t>();
-    scalar_t* bp = buf.data_ptr<scalar_t>();
-
-    int64_t NR = src.size(0);
-    int64_t NC = src.size(1);
-    for (int64_t R = 0; R < NR; R += BLOCK_SZ) {
-      for (int64_t C = 0; C < NC; C += BLOCK_SZ) {
-        scalar_t* spo = sp + R + C * NR;
-        scalar_t* rpo = rp + C + R * NC;
-
-        int nr = std::min(NR - R, BLOCK_SZ);
-        int nc = std::min(NC - C, BLOCK_SZ);
-
-        // 1. copy columns from src to buf
-        for (int c = 0; c < nc; c++) {
-          memcpy(bp + c * BLOCK_SZ, spo + c * NR, nr * sizeof(scalar_t));
-        }
-
-        // 2. transpose buf in place
-        int rc_max = std::max(nr, nc);
-        int rc_min = std::min(nr, nc);
-        for (int r = 0; r < rc_max; r++) {
-          int end = std::min(r, rc_min);
-          for (int c = 0; c < end; c++) {
-            scalar_t tmp = bp[r + BLOCK_SZ * c];
-            bp[r + BLOCK_SZ * c] = bp[r * BLOCK_SZ + c];
-            bp[r * BLOCK_SZ + c] = tmp;
-          }
-        }
-
-        // 3. copy rows from buf to dst
-        for (int r = 0; r < nr; r++) {
-          memcpy(rpo + r * NC, bp + r * BLOCK_SZ, nc * sizeof(scalar_t));
-        }
-      }
-    }
-  });
+      self.numel() >= MIN_SZ && src.device().is_cpu() &&
+      self.is_non_overlapping_and_dense() &&
+      get_overlap_status(self, src) == MemOverlapStatus::NO;
 }
 
 // Devices directly supported by this copy implementation. Other device types
@@ -210,8 +159,8 @@ static Tensor & copy_impl(Tensor & self, const Tensor & src, bool non_blocking)
   }
 
   // TODO: if we need to, we can also enable this path for quantized tensor
-  if (device_type == kCPU && copy_transpose_valid(self, src) && !self.is_quantized()) {
-    copy_same_type_transpose_(self, src);
+  if (device_type == kCPU && copy_transpose_valid(self, src) && !self.is_quantized() &&
+      transpose_copy_stub(device_type, self, src)) {
     return self;
   }
 
@@ -234,6 +183,7 @@ Tensor& copy_(Tensor& self, const Tensor& src, bool non_blocking) {
 }
 
 DEFINE_DISPATCH(copy_stub);
+DEFINE_DISPATCH(transpose_copy_stub);
 
 } // namespace native
 } // namespace at
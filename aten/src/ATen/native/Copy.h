@@ -13,5 +13,14 @@ using copy_fn = void (*)(TensorIterator&, bool non_blocking);
 
 DECLARE_DISPATCH(copy_fn, copy_stub);
 
+// Copies src to self, of the same sizes and dtype, when the dimension along
+// which the elements of src are contiguous isn't the one of self, as in
+// permute().contiguous() or the conversions between NCHW and NHWC. Returns
+// false without copying anything when the layouts aren't such a
+// transposition.
+using transpose_copy_fn = bool (*)(Tensor& self, const Tensor& src);
+
+DECLARE_DISPATCH(transpose_copy_fn, transpose_copy_stub);
+
 } // namespace native
 } // namespace at
@@ -0,0 +1,216 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/cpu/DepthwiseConvKernel.h>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(conv_depthwise2d_stub);
+DEFINE_DISPATCH(conv_depthwise2d_backward_input_stub);
+DEFINE_DISPATCH(conv_depthwise2d_backward_weight_stub);
+
+namespace {
+
+void check_conv_depthwise2d_arguments(
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  TORCH_CHECK(self.dim() == 4, "thnn_conv_depthwise2d: expected a 4D input, but got ", self.dim(), "D");
+  TORCH_CHECK(
+      weight.dim() == 4 && weight.size(1) == 1,
+      "thnn_conv_depthwise2d: expected a weight of size (out_channels, 1, kH, kW), but got ", weight.sizes());
+  TORCH_CHECK(
+      self.size(1) > 0 && weight.size(0) % self.size(1) == 0,
+      "thnn_conv_depthwise2d: the number of output channels (", weight.size(0),
+      ") must be a multiple of the number of input channels (", self.size(1), ")");
+  TORCH_CHECK(
+      kernel_size.size() == 2 && kernel_size[0] == weight.size(2) && kernel_size[1] == weight.size(3),
+      "thnn_conv_depthwise2d: kernel_size ", kernel_size, " doesn't match the weight of size ", weight.sizes());
+  TORCH_CHECK(
+      stride.size() == 2 && stride[0] > 0 && stride[1] > 0,
+      "thnn_conv_depthwise2d: expected a positive stride, but got ", stride);
+  TORCH_CHECK(
+      padding.size() == 2 && padding[0] >= 0 && padding[1] >= 0,
+      "thnn_conv_depthwise2d: expected a non-negative padding, but got ", padding);
+  TORCH_CHECK(
+      dilation.size() == 2 && dilation[0] > 0 && dilation[1] > 0,
+      "thnn_conv_depthwise2d: expected a positive dilation, but got ", dilation);
+  TORCH_CHECK(
+      self.scalar_type() == weight.scalar_type(),
+      "thnn_conv_depthwise2d: expected the input and the weight to have the same dtype, but got ",
+      self.scalar_type(), " and ", weight.scalar_type());
+}
+
+std::vector<int64_t> conv_depthwise2d_output_size(
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  std::vector<int64_t> output_size{self.size(0), weight.size(0)};
+  for (int64_t d = 0; d < 2; ++d) {
+    const int64_t extent = dilation[d] * (weight.size(d + 2) - 1) + 1;
+    output_size.push_back((self.size(d + 2) + 2 * padding[d] - extent) / stride[d] + 1);
+  }
+  TORCH_CHECK(
+      output_size[2] > 0 && output_size[3] > 0,
+      "thnn_conv_depthwise2d: the input of size ", self.sizes(),
+      " is too small for the kernel, the computed output size is ", output_size);
+  return output_size;
+}
+
+// The input repeated 'multiplier' times along the channels, so that the
+// channel k of the result feeds the output channel k, in channels last
+Tensor expand_depthwise_input(const Tensor& self, int64_t multiplier) {
+  const auto input = self.contiguous(MemoryFormat::ChannelsLast);
+  if (multiplier == 1) {
+    return input;
+  }
+  const int64_t batch = input.size(0);
+  const int64_t channels = input.size(1);
+  const int64_t rows = input.size(2);
+  const int64_t cols = input.size(3);
+  return input.permute({0, 2, 3, 1})
+      .unsqueeze(4)
+      .expand({batch, rows, cols, channels, multiplier})
+      .reshape({batch, rows, cols, channels * multiplier})
+      .permute({0, 3, 1, 2});
+}
+
+// The (out_channels, 1, kH, kW) weight as a (kH * kW, out_channels) matrix
+Tensor pack_depthwise_weight(const Tensor& weight) {
+  return weight.reshape({weight.size(0), -1}).t().contiguous();
+}
+
+} // namespace
+
+Tensor& thnn_conv_depthwise2d_forward_out_cpu(
+    Tensor& output,
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  check_conv_depthwise2d_arguments(self, weight, kernel_size, stride, padding, dilation);
+  TORCH_CHECK(
+      !bias.defined() || (bias.dim() == 1 && bias.size(0) == weight.size(0)),
+      "thnn_conv_depthwise2d: expected a bias of size ", weight.size(0), ", but got ", bias.sizes());
+  const auto output_size = conv_depthwise2d_output_size(self, weight, stride, padding, dilation);
+
+  const auto input = expand_depthwise_input(self, weight.size(0) / self.size(1));
+  const auto packed_weight = pack_depthwise_weight(weight);
+  const auto bias_contig = bias.defined() ? bias.contiguous() : bias;
+
+  output.resize_(output_size, self.suggest_memory_format());
+  if (output.is_contiguous(MemoryFormat::ChannelsLast)) {
+    conv_depthwise2d_stub(
+        kCPU, output, input, packed_weight, bias_contig, kernel_size, stride, padding, dilation);
+  } else {
+    const auto result = at::empty(output_size, output.options().memory_format(MemoryFormat::ChannelsLast));
+    conv_depthwise2d_stub(
+        kCPU, result, input, packed_weight, bias_contig, kernel_size, stride, padding, dilation);
+    output.copy_(result);
+  }
+  return output;
+}
+
+Tensor thnn_conv_depthwise2d_forward_cpu(
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  auto output = at::empty({0}, self.options());
+  return native::thnn_conv_depthwise2d_forward_out_cpu(
+      output, self, weight, kernel_size, bias, stride, padding, dilation);
+}
+
+std::tuple<Tensor&, Tensor&> thnn_conv_depthwise2d_backward_out_cpu(
+    Tensor& grad_input,
+    Tensor& grad_weight,
+    const Tensor& grad_output,
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  check_conv_depthwise2d_arguments(self, weight, kernel_size, stride, padding, dilation);
+  const auto output_size = conv_depthwise2d_output_size(self, weight, stride, padding, dilation);
+  TORCH_CHECK(
+      grad_output.sizes() == IntArrayRef(output_size),
+      "thnn_conv_depthwise2d_backward: expected a grad_output of size ", IntArrayRef(output_size),
+      ", but got ", grad_output.sizes());
+
+  const int64_t batch = self.size(0);
+  const int64_t channels = self.size(1);
+  const int64_t out_channels = weight.size(0);
+  const int64_t multiplier = out_channels / channels;
+  const auto grad_output_nhwc = grad_output.contiguous(MemoryFormat::ChannelsLast);
+
+  if (grad_input.defined()) {
+    const auto packed_weight = pack_depthwise_weight(weight);
+    auto grad_expanded = at::empty(
+        {batch, out_channels, self.size(2), self.size(3)},
+        grad_output.options().memory_format(MemoryFormat::ChannelsLast));
+    conv_depthwise2d_backward_input_stub(
+        kCPU, grad_expanded, grad_output_nhwc, packed_weight, kernel_size, stride, padding, dilation);
+    if (multiplier > 1) {
+      // the input channel c fed the output channels c * multiplier + m
+      grad_expanded = grad_expanded.permute({0, 2, 3, 1})
+          .reshape({batch, self.size(2), self.size(3), channels, multiplier})
+          .sum(4)
+          .permute({0, 3, 1, 2});
+    }
+    grad_input.resize_(self.sizes(), self.suggest_memory_format());
+    grad_input.copy_(grad_expanded);
+  }
+
+  if (grad_weight.defined()) {
+    const auto input = expand_depthwise_input(self, multiplier);
+    // the contributions of each sample, reduced afterwards
+    const auto grad_weight_partial = at::zeros(
+        {batch, kernel_size[0] * kernel_size[1], out_channels}, grad_output.options());
+    conv_depthwise2d_backward_weight_stub(
+        kCPU, grad_weight_partial, grad_output_nhwc, input, kernel_size, stride, padding, dilation);
+    grad_weight.resize_(weight.sizes());
+    grad_weight.copy_(grad_weight_partial.sum(0).t().reshape(weight.sizes()));
+  }
+
+  return std::tuple<Tensor&, Tensor&>(grad_input, grad_weight);
+}
+
+std::tuple<Tensor, Tensor> thnn_conv_depthwise2d_backward_cpu(
+    const Tensor& grad_output,
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    std::array<bool, 2> output_mask) {
+  Tensor grad_input;
+  Tensor grad_weight;
+
+  if (output_mask[0]) {
+    grad_input = at::empty({0}, grad_output.options());
+  }
+
+  if (output_mask[1]) {
+    grad_weight = at::empty({0}, grad_output.options());
+  }
+
+  native::thnn_conv_depthwise2d_backward_out_cpu(
+      grad_input, grad_weight, grad_output, self, weight, kernel_size, stride, padding, dilation);
+  return std::make_tuple(grad_input, grad_weight);
+}
+
+} // namespace native
+} // namespace at
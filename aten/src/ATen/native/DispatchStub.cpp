@@ -16,6 +16,9 @@ static CPUCapability compute_cpu_capability() {
       return CPUCapability::VSX;
     }
 #else
+    if (strcmp(envar, "avx512") == 0) {
+      return CPUCapability::AVX512;
+    }
     if (strcmp(envar, "avx2") == 0) {
       return CPUCapability::AVX2;
     }
@@ -31,7 +34,13 @@ static CPUCapability compute_cpu_capability() {
 
 #if !defined(__powerpc__) && !defined(__s390x__)
   if (cpuinfo_initialize()) {
-    if (cpuinfo_has_x86_avx2() && cpuinfo_has_x86_fma3()) {
+    // The AVX2 and AVX512 kernels are also compiled with F16C
+    if (cpuinfo_has_x86_avx512f() && cpuinfo_has_x86_avx512dq() &&
+        cpuinfo_has_x86_avx512bw() && cpuinfo_has_x86_avx512vl() &&
+        cpuinfo_has_x86_fma3() && cpuinfo_has_x86_f16c()) {
+      return CPUCapability::AVX512;
+    }
+    if (cpuinfo_has_x86_avx2() && cpuinfo_has_x86_fma3() && cpuinfo_has_x86_f16c()) {
       return CPUCapability::AVX2;
     }
     if (cpuinfo_has_x86_avx()) {
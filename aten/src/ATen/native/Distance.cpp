@@ -11,6 +11,7 @@ DEFINE_DISPATCH(pdist_forward_stub);
 DEFINE_DISPATCH(pdist_backward_stub);
 DEFINE_DISPATCH(cdist_stub);
 DEFINE_DISPATCH(cdist_backward_stub);
+DEFINE_DISPATCH(cdist_topk_update_stub);
 
 Tensor pairwise_distance(const Tensor& x1, const Tensor& x2, double p, double eps, bool keepdim) {
   return at::norm(x1 - x2 + eps, p, 1, keepdim);
@@ -30,12 +31,17 @@ Tensor _euclidean_dist(const Tensor& x1, const Tensor& x2) {
    * We divide it in two steps to simplify dealing with subgradients in the
    * backward step */
   Tensor x1_norm = x1.pow(2).sum(-1, true);
-  Tensor x1_pad = at::ones_like(x1_norm, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   Tensor x2_norm = x2.pow(2).sum(-1, true);
-  Tensor x2_pad = at::ones_like(x2_norm, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  Tensor x1_ = at::cat({x1.mul(-2), x1_norm, x1_pad}, -1);
-  Tensor x2_ = at::cat({x2, x2_pad, x2_norm}, -1);
-  Tensor result = x1_.matmul(x2_.transpose(-2, -1));
+  // The sums of the squared norms are the accumulator of the gemm of -2 * x1 * x2^T,
+  // so that the distances are computed without padded copies of x1 and x2
+  Tensor result = x1_norm + x2_norm.transpose(-2, -1);
+  if (x1.dim() == 2 && x2.dim() == 2) {
+    result.addmm_(x1, x2.t(), /*beta=*/1, /*alpha=*/-2);
+  } else if (x1.dim() == 3 && x2.dim() == 3 && x1.size(0) == x2.size(0)) {
+    result.baddbmm_(x1, x2.transpose(1, 2), /*beta=*/1, /*alpha=*/-2);
+  } else {
+    result.sub_(x1.matmul(x2.transpose(-2, -1)), 2);
+  }
   result.clamp_min_(0).sqrt_();
   return result;
 }
@@ -135,6 +141,62 @@ Tensor _cdist_forward(const Tensor& x1, const Tensor& x2, const double p, c10::o
   return result;
 }
 
+// The rows of x1 are processed in blocks of this many rows, and each block is
+// matched against the rows of x2 in tiles of this many columns
+static constexpr int64_t kCdistTopkRowBlock = 1024;
+static constexpr int64_t kCdistTopkColBlock = 4096;
+
+// Returns the Euclidean distances and the indices of the k nearest rows of x2 of
+// each row of x1, sorted by distance. On CPU, the distances are streamed in
+// tiles of the products x1 * x2^T of a blocked gemm, which
+// cdist_topk_update_stub merges with the squared norms of the rows into the
+// heaps of the k nearest rows, so that the x1.size(0) x x2.size(0) distance
+// matrix is never materialized.
+std::tuple<Tensor, Tensor> _cdist_topk(const Tensor& x1, const Tensor& x2, int64_t k) {
+  TORCH_CHECK(x1.dim() == 2 && x2.dim() == 2,
+      "_cdist_topk only supports 2D tensors, X1 got: ", x1.dim(), "D, X2 got: ", x2.dim(), "D");
+  TORCH_CHECK(x1.size(1) == x2.size(1), "X1 and X2 must have the same number of columns. X1: ", x1.size(1), " X2: ", x2.size(1));
+  TORCH_CHECK(at::isFloatingType(x1.scalar_type()), "_cdist_topk only supports floating-point dtypes, X1 got: ", x1.scalar_type());
+  TORCH_CHECK(x1.scalar_type() == x2.scalar_type(), "X1 and X2 must have the same dtype. X1: ", x1.scalar_type(), " X2: ", x2.scalar_type());
+  TORCH_CHECK(x1.device() == x2.device(), "X1 and X2 must be on the same device. X1: ", x1.device(), " X2: ", x2.device());
+  TORCH_CHECK(k >= 0 && k <= x2.size(0), "k (", k, ") must be between 0 and the number of rows of X2 (", x2.size(0), ")");
+
+  const auto dtype = x1.scalar_type();
+  if (!x1.device().is_cpu() || (dtype != kFloat && dtype != kDouble) || x1.size(0) == 0 || k == 0) {
+    return at::cdist(x1, x2).topk(k, -1, /*largest=*/false);
+  }
+
+  const int64_t r1 = x1.size(0);
+  const int64_t r2 = x2.size(0);
+  const Tensor x1_ = x1.contiguous();
+  const Tensor x2_ = x2.contiguous();
+  const Tensor x1_norm = x1_.pow(2).sum(-1);
+  const Tensor x2_norm = x2_.pow(2).sum(-1);
+  Tensor values = at::empty({r1, k}, x1.options());
+  Tensor indices = at::empty({r1, k}, x1.options().dtype(kLong));
+  Tensor buffer = at::empty({std::min(r1, kCdistTopkRowBlock) * std::min(r2, kCdistTopkColBlock)}, x1.options());
+
+  for (int64_t row = 0; row < r1; row += kCdistTopkRowBlock) {
+    const int64_t rows = std::min(kCdistTopkRowBlock, r1 - row);
+    Tensor values_block = values.narrow(0, row, rows);
+    Tensor indices_block = indices.narrow(0, row, rows);
+    const Tensor x1_block = x1_.narrow(0, row, rows);
+    const Tensor x1_norm_block = x1_norm.narrow(0, row, rows);
+    for (int64_t col = 0; col < r2; col += kCdistTopkColBlock) {
+      const int64_t cols = std::min(kCdistTopkColBlock, r2 - col);
+      Tensor products = buffer.narrow(0, 0, rows * cols).view({rows, cols});
+      at::mm_out(products, x1_block, x2_.narrow(0, col, cols).t());
+      cdist_topk_update_stub(
+          kCPU, values_block, indices_block, products, x1_norm_block, x2_norm.narrow(0, col, cols), col);
+    }
+  }
+
+  // The heaps hold the squared distances
+  Tensor order;
+  std::tie(values, order) = values.sort(-1);
+  return std::make_tuple(values.sqrt_(), indices.gather(-1, order));
+}
+
 Tensor _cdist_backward(const Tensor& grad, const Tensor& x1, const Tensor& x2, const double p, const Tensor& cdist) {
   TORCH_CHECK(x1.is_contiguous(), "_cdist_backward requires X1 to be contiguous");
   TORCH_CHECK(x2.is_contiguous(), "_cdist_backward requires X2 to be contiguous");
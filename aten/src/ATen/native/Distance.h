@@ -9,10 +9,15 @@ using pdist_forward_fn = void(*)(Tensor&, const Tensor&, const double p);
 using pdist_backward_fn = void(*)(Tensor&, const Tensor&, const Tensor&, const double p, const Tensor&);
 using cdist_fn = void(*)(Tensor&, const Tensor&, const Tensor&, const double p);
 using cdist_backward_fn = void(*)(Tensor&, const Tensor&, const Tensor&, const Tensor&, const double p, const Tensor&);
+// Merges a tile of the products x1 * x2^T, of the columns starting at
+// col_offset, into the heaps of the k nearest columns of its rows, see _cdist_topk
+using cdist_topk_update_fn = void(*)(Tensor& values, Tensor& indices, const Tensor& products,
+                                     const Tensor& x1_norm, const Tensor& x2_norm, int64_t col_offset);
 
 DECLARE_DISPATCH(pdist_forward_fn, pdist_forward_stub);
 DECLARE_DISPATCH(pdist_backward_fn, pdist_backward_stub);
 DECLARE_DISPATCH(cdist_fn, cdist_stub);
 DECLARE_DISPATCH(cdist_backward_fn, cdist_backward_stub);
+DECLARE_DISPATCH(cdist_topk_update_fn, cdist_topk_update_stub);
 
 }} // namespace at::native
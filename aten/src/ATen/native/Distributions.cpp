@@ -119,6 +119,7 @@ DEFINE_DISPATCH(bernoulli_scalar_stub);
 DEFINE_DISPATCH(cauchy_stub);
 DEFINE_DISPATCH(exponential_stub);
 DEFINE_DISPATCH(multinomial_with_replacement_stub);
+DEFINE_DISPATCH(sample_top_k_top_p_stub);
 DEFINE_DISPATCH(geometric_stub);
 DEFINE_DISPATCH(log_normal_stub);
 DEFINE_DISPATCH(uniform_stub);
@@ -554,4 +555,42 @@ Tensor multinomial(
   return result;
 }
 
+// Samples an index of each row of logits from the softmax of the top_k
+// largest logits (all of them if top_k is 0), further restricted to the
+// smallest set of largest logits whose probability mass is at least top_p of
+// the mass of the top_k ones, in a single pass instead of the softmax, sort,
+// cumsum, masking and multinomial of the usual top-k/top-p sampling. Logits
+// equal to the smallest logit kept are all kept. Like multinomial(probs, 1),
+// returns a Long tensor of size [1] or [n_dist, 1].
+Tensor _sample_top_k_top_p(
+    const Tensor& self,
+    int64_t top_k,
+    double top_p,
+    c10::optional<Generator> gen) {
+  TORCH_CHECK(
+      self.dim() > 0 && self.dim() <= 2, "logits must be 1 or 2 dim");
+  TORCH_CHECK(
+      at::isFloatingType(self.scalar_type()),
+      "_sample_top_k_top_p only supports floating-point dtypes for logits, got: ",
+      self.scalar_type());
+  const int64_t n_categories = self.size(-1);
+  TORCH_CHECK(n_categories > 0, "cannot sample from 0 categories");
+  TORCH_CHECK(
+      n_categories <= std::numeric_limits<int>::max(),
+      "number of categories cannot exceed 2^31 - 1");
+  TORCH_CHECK(top_k >= 0, "top_k must be non-negative, got ", top_k);
+  TORCH_CHECK(
+      top_p > 0 && top_p <= 1, "top_p must be in (0, 1], got ", top_p);
+
+  Tensor result = self.dim() == 1
+      ? at::empty({1}, self.options().dtype(kLong))
+      : at::empty({self.size(0), 1}, self.options().dtype(kLong));
+  if (result.numel() == 0) {
+    return result;
+  }
+  sample_top_k_top_p_stub(
+      self.device().type(), result, self, top_k, top_p, gen);
+  return result;
+}
+
 }} // namespace at::native
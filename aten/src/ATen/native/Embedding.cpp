@@ -55,6 +55,12 @@ Tensor embedding_sparse_backward(
         "embedding_backward: scale_grad_by_freq not supported with sparse gradients");
   }
 
+  // On CUDA the gradient is accumulated into its unique rows, unless it is
+  // itself differentiated, which the composite ops below support
+  if (grad_.is_cuda() && !grad_.requires_grad()) {
+    return at::_embedding_sparse_backward_coalesced(grad_, indices_, num_weights, padding_idx);
+  }
+
   Tensor indices = indices_;
   Tensor grad = grad_;
   if (padding_idx != -1) {
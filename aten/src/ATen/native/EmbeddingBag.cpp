@@ -2,6 +2,7 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/native/EmbeddingBag.h>
 
 #include <TH/THBlasUtils.h>
 
@@ -303,6 +304,195 @@ index_select_scale_add(const Tensor &select_indices,
   }
 }
 
+// The sum/mean kernel below gathers rows of weight whose elements are
+// contiguous. It covers the weight dtypes and modes that the FBGEMM/perfkernels
+// path above doesn't (double, half, bfloat16 and mode='mean').
+bool isFastPathSumMean(const Tensor& src, int64_t mode) {
+  return (mode == MODE_SUM || mode == MODE_MEAN) && src.stride(1) == 1;
+}
+
+// Rows whose gather is prefetched ahead of the row being accumulated, the same
+// distance the FBGEMM kernels use.
+constexpr int64_t kEmbeddingBagPrefetchDistance = 16;
+constexpr int64_t kCacheLineSize = 64;
+
+inline void prefetch_row(const void* row, int64_t nbytes) {
+#if defined(__GNUC__) || defined(__clang__)
+  const char* ptr = static_cast<const char*>(row);
+  for (int64_t i = 0; i < nbytes; i += kCacheLineSize) {
+    __builtin_prefetch(ptr + i, /*rw=*/0, /*locality=*/1);
+  }
+#endif
+}
+
+template <typename data_t, typename index_t>
+struct EmbeddingBagSumMeanArgs {
+  const data_t* src;
+  int64_t src_stride0;
+  int64_t num_rows; // src.size(0)
+  int64_t ddim; // src.size(1)
+  const index_t* indices;
+  const index_t* offsets; // num_bags + 1 entries
+  const data_t* scale; // per_sample_weights, or nullptr
+  int64_t scale_stride;
+  int64_t num_bags;
+  bool normalize_by_lengths; // mode='mean'
+  data_t* output; // contiguous, num_bags x ddim
+};
+
+// Accumulates the bags [begin, end) into rows of output.
+// Rows are accumulated in float (double for double weights), so that fp16 and
+// bf16 tables lose no precision to the reduction. kBlockSize is ddim when it
+// is known at compile time, or 0, so that the inner loops over common
+// embedding dims get fully unrolled and vectorized.
+template <typename data_t, typename index_t, int64_t kBlockSize>
+void embedding_bag_sum_mean_block(
+    const EmbeddingBagSumMeanArgs<data_t, index_t>& args,
+    int64_t begin,
+    int64_t end) {
+  using acc_t = typename std::
+      conditional<std::is_same<data_t, double>::value, double, float>::type;
+  const int64_t ddim = kBlockSize > 0 ? kBlockSize : args.ddim;
+  const int64_t row_bytes = ddim * sizeof(data_t);
+  std::vector<acc_t> acc_buffer(ddim);
+  acc_t* acc = acc_buffer.data();
+  const int64_t last = args.offsets[end];
+  for (int64_t bag = begin; bag < end; ++bag) {
+    std::fill(acc, acc + ddim, acc_t(0));
+    const int64_t bag_begin = args.offsets[bag];
+    const int64_t bag_end = args.offsets[bag + 1];
+    for (int64_t i = bag_begin; i < bag_end; ++i) {
+      const int64_t prefetch_i = i + kEmbeddingBagPrefetchDistance;
+      if (prefetch_i < last) {
+        const int64_t prefetch_idx = args.indices[prefetch_i];
+        if (prefetch_idx >= 0 && prefetch_idx < args.num_rows) {
+          prefetch_row(args.src + prefetch_idx * args.src_stride0, row_bytes);
+        }
+      }
+      const int64_t idx = args.indices[i];
+      TORCH_CHECK(
+          idx >= 0 && idx < args.num_rows,
+          "embedding_bag: index ", idx, " is out of bounds for a weight with ",
+          args.num_rows, " rows");
+      const data_t* row = args.src + idx * args.src_stride0;
+      if (args.scale != nullptr) {
+        const acc_t scale = args.scale[i * args.scale_stride];
+        for (int64_t j = 0; j < ddim; ++j) {
+          acc[j] += scale * static_cast<acc_t>(row[j]);
+        }
+      } else {
+        for (int64_t j = 0; j < ddim; ++j) {
+          acc[j] += static_cast<acc_t>(row[j]);
+        }
+      }
+    }
+    // Empty bags are all 0s.
+    const acc_t norm = args.normalize_by_lengths && bag_end > bag_begin
+        ? acc_t(1) / (bag_end - bag_begin)
+        : acc_t(1);
+    data_t* out = args.output + bag * ddim;
+    for (int64_t j = 0; j < ddim; ++j) {
+      out[j] = static_cast<data_t>(acc[j] * norm);
+    }
+  }
+}
+
+template <typename data_t, typename index_t>
+void embedding_bag_sum_mean_bags(
+    const EmbeddingBagSumMeanArgs<data_t, index_t>& args,
+    int64_t begin,
+    int64_t end) {
+  switch (args.ddim) {
+    case 16:
+      return embedding_bag_sum_mean_block<data_t, index_t, 16>(args, begin, end);
+    case 32:
+      return embedding_bag_sum_mean_block<data_t, index_t, 32>(args, begin, end);
+    case 64:
+      return embedding_bag_sum_mean_block<data_t, index_t, 64>(args, begin, end);
+    case 128:
+      return embedding_bag_sum_mean_block<data_t, index_t, 128>(args, begin, end);
+    case 256:
+      return embedding_bag_sum_mean_block<data_t, index_t, 256>(args, begin, end);
+    default:
+      return embedding_bag_sum_mean_block<data_t, index_t, 0>(args, begin, end);
+  }
+}
+
+// Bags per task so that each task accumulates roughly GRAIN_SIZE elements.
+int64_t embedding_bag_grain_size(
+    int64_t num_indices,
+    int64_t num_bags,
+    int64_t ddim) {
+  const int64_t work_per_bag =
+      std::max<int64_t>(1, num_indices / std::max<int64_t>(1, num_bags)) *
+      std::max<int64_t>(1, ddim);
+  return std::max<int64_t>(1, at::internal::GRAIN_SIZE / work_per_bag);
+}
+
+// offsets_include_last holds the offsets when they have to be extended by the
+// end of the last bag, and must outlive the returned args.
+template <typename data_t, typename index_t>
+EmbeddingBagSumMeanArgs<data_t, index_t> make_embedding_bag_sum_mean_args(
+    const Tensor& indices,
+    const Tensor& per_sample_weights,
+    const Tensor& src,
+    Tensor& output,
+    const Tensor& offsets,
+    bool include_last_offset,
+    int64_t mode,
+    std::vector<index_t>& offsets_include_last) {
+  const index_t* offsets_data = offsets.data_ptr<index_t>();
+  int64_t num_bags = offsets.numel() - 1;
+  if (!include_last_offset) {
+    num_bags = offsets.numel();
+    offsets_include_last.resize(offsets.numel() + 1);
+    std::memcpy(
+        offsets_include_last.data(),
+        offsets_data,
+        sizeof(index_t) * offsets.numel());
+    offsets_include_last[offsets.numel()] = indices.numel();
+    offsets_data = offsets_include_last.data();
+  }
+
+  EmbeddingBagSumMeanArgs<data_t, index_t> args;
+  args.src = src.data_ptr<data_t>();
+  args.src_stride0 = src.stride(0);
+  args.num_rows = src.size(0);
+  args.ddim = src.size(1);
+  args.indices = indices.data_ptr<index_t>();
+  args.offsets = offsets_data;
+  args.scale = per_sample_weights.defined()
+      ? per_sample_weights.data_ptr<data_t>()
+      : nullptr;
+  args.scale_stride =
+      per_sample_weights.defined() ? per_sample_weights.stride(0) : 0;
+  args.num_bags = num_bags;
+  args.normalize_by_lengths = mode == MODE_MEAN;
+  args.output = output.data_ptr<data_t>();
+  return args;
+}
+
+// Accumulates each bag into a row of output, parallelized across bags.
+template <typename data_t, typename index_t>
+void embedding_bag_sum_mean(
+    const Tensor& indices,
+    const Tensor& per_sample_weights,
+    const Tensor& src,
+    Tensor& output,
+    const Tensor& offsets,
+    bool include_last_offset,
+    int64_t mode) {
+  std::vector<index_t> offsets_include_last;
+  const auto args = make_embedding_bag_sum_mean_args<data_t, index_t>(
+      indices, per_sample_weights, src, output, offsets, include_last_offset,
+      mode, offsets_include_last);
+  const int64_t grain_size = embedding_bag_grain_size(
+      args.offsets[args.num_bags], args.num_bags, args.ddim);
+  at::parallel_for(0, args.num_bags, grain_size, [&](int64_t begin, int64_t end) {
+    embedding_bag_sum_mean_bags(args, begin, end);
+  });
+}
+
 }  // namespace
 
 static at::Tensor make_bag_size(
@@ -426,7 +616,7 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> embedding_bag_cpu_max(
 // Assumes all input tensors except for `weight` are contiguous.
 // See NOTE [ embedding_bag Native Functions ] in native_functions.yaml for details
 std::tuple<Tensor, Tensor, Tensor, Tensor> _embedding_bag_cpu_impl(
-    const Tensor& weight,
+    const Tensor& weight_,
     const Tensor& indices,
     const Tensor& offsets,
     const int64_t mode,
@@ -438,8 +628,15 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> _embedding_bag_cpu_impl(
   auto offsets_arg = TensorArg(offsets, "offsets", 1);
   checkScalarTypes("embedding_bag", offsets_arg, {kLong, kInt});
   checkSameType("embedding_bag", indices_arg, offsets_arg);
-  auto weight_arg = TensorArg(weight, "weight", 1);
-  checkScalarTypes("embedding_bag", weight_arg, {kFloat, kDouble});
+  auto weight_arg = TensorArg(weight_, "weight", 1);
+  checkScalarTypes("embedding_bag", weight_arg, {kFloat, kDouble, kHalf, kBFloat16});
+  // half and bfloat16 weights are only supported by the sum/mean kernel for
+  // rows with contiguous elements, and by max.
+  const bool reduced_precision =
+      weight_.scalar_type() == kHalf || weight_.scalar_type() == kBFloat16;
+  const Tensor weight = reduced_precision && mode != MODE_MAX && weight_.stride(1) != 1
+      ? weight_.contiguous()
+      : weight_;
 
   AT_DISPATCH_INDEX_TYPES(offsets.scalar_type(), "_embedding_bag_cpu_impl", [&]() {
     index_t offset_0 = offsets.data_ptr<index_t>()[0];
@@ -483,21 +680,26 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> _embedding_bag_cpu_impl(
        weight.size(1)},
       weight.options());
 
-  // To save compute, if we are going to go down the fast path case for the 'sum'
-  // mode, we skip calculating offset2bag, since it is not going to be used.
-  auto fast_path_sum = [&weight, &per_sample_weights, &output]() {
-    if (per_sample_weights.defined()) {
+  // To save compute, if we are going to go down a fast path for the 'sum' or
+  // 'mean' modes, we skip calculating offset2bag, since it is not going to be
+  // used. Float 'sum' goes to FBGEMM/perfkernels, the other dtypes and float
+  // 'mean' go to embedding_bag_sum_mean.
+  auto fast_path_sum = [&weight, &per_sample_weights, &output, mode]() {
+    if (mode != MODE_SUM) {
+      return false;
+    } else if (per_sample_weights.defined()) {
       return isFastPathIndexSelectScale(weight, per_sample_weights, output);
     } else {
       return isFastPathIndexSelect(weight, output);
     }
   };
+  const bool fast_path_sum_mean = !fast_path_sum() && isFastPathSumMean(weight, mode);
 
   // Use an empty 0-element tensor as a sentinel that we have skipped the
   // creation of offset2bag because autograd chokes when trying to use an
   // undefined tensor as an input to a backward op.
   Tensor offset2bag = at::empty({0}, offsets.options());
-  if (mode == MODE_MEAN || mode == MODE_MAX || !fast_path_sum()) {
+  if (mode == MODE_MAX || !(fast_path_sum() || fast_path_sum_mean)) {
     // If the last entries are empty, that the last offsets are irrelevant as they
     // won't change anything in the assignment of ID -> bag, but index_add would
     // throw out of bounds error. So to keep it simple we just add one more
@@ -513,7 +715,18 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> _embedding_bag_cpu_impl(
     output.zero_();
   }
 
-  if (mode == MODE_MEAN || mode == MODE_SUM) {
+  if (fast_path_sum_mean) {
+    AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
+      weight.scalar_type(), "embedding_bag_cpu",
+      [&indices, &per_sample_weights, &weight, &output, &offsets, &include_last_offset, &mode]() {
+      AT_DISPATCH_INDEX_TYPES(indices.scalar_type(), "embedding_bag_cpu",
+        [&indices, &per_sample_weights, &weight, &output, &offsets, &include_last_offset, &mode]() {
+        embedding_bag_sum_mean<scalar_t, index_t>(
+            indices, per_sample_weights, weight, output, offsets, include_last_offset, mode);
+      });
+    });
+    return std::tuple<Tensor, Tensor, Tensor, Tensor>(output, offset2bag, bag_size, bag_size);
+  } else if (mode == MODE_MEAN || mode == MODE_SUM) {
     // explicitly capture all required variables to work around windows build
     // TODO: fix this when windows can correctly capture variables in nested lambda
     AT_DISPATCH_FLOATING_TYPES(weight.scalar_type(), "embedding_bag_cpu",
@@ -536,7 +749,7 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> _embedding_bag_cpu_impl(
     if (per_sample_weights.defined()) {
       maybe_per_sample_weights = per_sample_weights;
     }
-    return AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+    return AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
       weight.scalar_type(), "embedding_bag_cpu_max", [&]() {
         return embedding_bag_cpu_max<scalar_t>(
             weight, indices, offset2bag, output, bag_size, offsets, include_last_offset);
@@ -940,5 +1153,259 @@ Tensor _embedding_bag_sparse_backward(
   return native::embedding_backward(index_grad, indices, num_weights, -1,
                                     scale_grad_by_freq, true);
 }
+
+void check_embedding_bag_multi_args(
+    TensorList weights_or_grads,
+    TensorList indices,
+    TensorList offsets,
+    int64_t mode,
+    const char* name) {
+  TORCH_CHECK(
+      weights_or_grads.size() == indices.size() &&
+          weights_or_grads.size() == offsets.size(),
+      name, ": expected one indices and offsets tensor per table, got ",
+      weights_or_grads.size(), " tables, ", indices.size(), " indices and ",
+      offsets.size(), " offsets");
+  TORCH_CHECK(
+      mode == MODE_SUM || mode == MODE_MEAN,
+      name, ": only mode='sum' and mode='mean' are supported");
+  for (size_t t = 0; t < weights_or_grads.size(); ++t) {
+    auto indices_arg = TensorArg(indices[t], "indices", 2);
+    auto offsets_arg = TensorArg(offsets[t], "offsets", 3);
+    checkScalarTypes(name, indices_arg, {kLong, kInt});
+    checkSameType(name, indices_arg, offsets_arg);
+    checkContiguous(name, indices_arg);
+    checkContiguous(name, offsets_arg);
+    checkDim(name, indices_arg, 1);
+    checkDim(name, offsets_arg, 1);
+    TORCH_CHECK(
+        weights_or_grads[t].dim() == 2,
+        name, ": expected 2-D tables, got a ", weights_or_grads[t].dim(),
+        "-D table at position ", t);
+    TORCH_CHECK(
+        weights_or_grads[t].scalar_type() == weights_or_grads[0].scalar_type() &&
+            indices[t].scalar_type() == indices[0].scalar_type(),
+        name, ": expected all tables and all indices to have the same dtype");
+    TORCH_CHECK(offsets[t].numel() >= 1, name, ": offsets can not be empty");
+  }
+}
+
+namespace {
+
+// Prefix sums of the number of bags of the tables, so that the bags of all
+// tables can be split into tasks as one range.
+template <typename Args>
+std::vector<int64_t> embedding_bag_multi_bag_begins(const std::vector<Args>& args) {
+  std::vector<int64_t> bag_begins(args.size() + 1, 0);
+  for (size_t t = 0; t < args.size(); ++t) {
+    bag_begins[t + 1] = bag_begins[t] + args[t].num_bags;
+  }
+  return bag_begins;
+}
+
+// Calls fn(table, begin, end) for the bags of every table that fall into the
+// global range of bags [begin, end).
+template <typename Fn>
+void for_each_table_in_range(
+    const std::vector<int64_t>& bag_begins,
+    int64_t begin,
+    int64_t end,
+    const Fn& fn) {
+  const int64_t num_tables = bag_begins.size() - 1;
+  int64_t t =
+      std::upper_bound(bag_begins.begin(), bag_begins.end(), begin) -
+      bag_begins.begin() - 1;
+  for (; t < num_tables && bag_begins[t] < end; ++t) {
+    const int64_t table_begin = std::max(begin, bag_begins[t]) - bag_begins[t];
+    const int64_t table_end = std::min(end, bag_begins[t + 1]) - bag_begins[t];
+    if (table_begin < table_end) {
+      fn(t, table_begin, table_end);
+    }
+  }
+}
+
+} // namespace
+
+// Runs embedding_bag over many tables at once, so that models with hundreds of
+// sparse features pay for one op and one parallel region instead of one per
+// table. Bags of all tables are split into tasks together.
+std::vector<Tensor> _embedding_bag_multi_cpu(
+    TensorList weights,
+    TensorList indices,
+    TensorList offsets,
+    int64_t mode,
+    bool sparse,
+    bool include_last_offset) {
+  std::ignore = sparse;
+  check_embedding_bag_multi_args(
+      weights, indices, offsets, mode, "_embedding_bag_multi");
+  const int64_t num_tables = weights.size();
+  if (num_tables == 0) {
+    return {};
+  }
+  auto weight_arg = TensorArg(weights[0], "weights", 1);
+  checkScalarTypes(
+      "_embedding_bag_multi", weight_arg, {kFloat, kDouble, kHalf, kBFloat16});
+
+  std::vector<Tensor> weights_(num_tables);
+  std::vector<Tensor> outputs(num_tables);
+  int64_t num_indices = 0;
+  int64_t ddim = 0;
+  for (int64_t t = 0; t < num_tables; ++t) {
+    weights_[t] = weights[t].stride(1) == 1 ? weights[t] : weights[t].contiguous();
+    const int64_t num_offsets = offsets[t].size(0);
+    outputs[t] = at::empty(
+        {include_last_offset ? num_offsets - 1 : num_offsets, weights[t].size(1)},
+        weights[t].options());
+    num_indices += indices[t].numel();
+    ddim = std::max(ddim, weights[t].size(1));
+  }
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
+    weights[0].scalar_type(), "_embedding_bag_multi_cpu", [&]() {
+    AT_DISPATCH_INDEX_TYPES(indices[0].scalar_type(), "_embedding_bag_multi_cpu", [&]() {
+      std::vector<std::vector<index_t>> offsets_include_last(num_tables);
+      std::vector<EmbeddingBagSumMeanArgs<scalar_t, index_t>> args;
+      args.reserve(num_tables);
+      for (int64_t t = 0; t < num_tables; ++t) {
+        const index_t* offsets_data = offsets[t].data_ptr<index_t>();
+        const int64_t offset_n = offsets_data[offsets[t].size(0) - 1];
+        TORCH_CHECK(offsets_data[0] == 0, "_embedding_bag_multi: offsets[0] of "
+                    "table ", t, " has to be 0, but got ", offsets_data[0]);
+        TORCH_CHECK(offset_n <= indices[t].size(0), "_embedding_bag_multi: "
+                    "offsets[-1] of table ", t, " can not be greater than the "
+                    "length of its indices ", indices[t].size(0), " but got ", offset_n);
+        args.push_back(make_embedding_bag_sum_mean_args<scalar_t, index_t>(
+            indices[t], Tensor(), weights_[t], outputs[t], offsets[t],
+            include_last_offset, mode, offsets_include_last[t]));
+      }
+      const auto bag_begins = embedding_bag_multi_bag_begins(args);
+      const int64_t num_bags = bag_begins.back();
+      at::parallel_for(
+          0, num_bags, embedding_bag_grain_size(num_indices, num_bags, ddim),
+          [&](int64_t begin, int64_t end) {
+            for_each_table_in_range(
+                bag_begins, begin, end, [&](int64_t t, int64_t lo, int64_t hi) {
+                  embedding_bag_sum_mean_bags(args[t], lo, hi);
+                });
+          });
+    });
+  });
+  return outputs;
+}
+
+// Gradients of _embedding_bag_multi for all tables. Sparse gradients are
+// gathered in one parallel region across the bags of all tables; dense
+// gradients are accumulated in one parallel region across tables.
+std::vector<Tensor> _embedding_bag_multi_backward_cpu(
+    TensorList grads,
+    TensorList indices,
+    TensorList offsets,
+    IntArrayRef num_weights,
+    int64_t mode,
+    bool sparse,
+    bool include_last_offset) {
+  check_embedding_bag_multi_args(
+      grads, indices, offsets, mode, "_embedding_bag_multi_backward");
+  const int64_t num_tables = grads.size();
+  TORCH_CHECK(
+      static_cast<int64_t>(num_weights.size()) == num_tables,
+      "_embedding_bag_multi_backward: expected one num_weights per table");
+  if (num_tables == 0) {
+    return {};
+  }
+
+  std::vector<Tensor> grads_(num_tables);
+  std::vector<Tensor> grad_weights(num_tables);
+  int64_t num_indices = 0;
+  int64_t ddim = 0;
+  for (int64_t t = 0; t < num_tables; ++t) {
+    grads_[t] = grads[t].contiguous();
+    const int64_t num_features = grads[t].size(1);
+    grad_weights[t] = sparse
+        ? at::empty({indices[t].numel(), num_features}, grads[t].options())
+        : at::zeros({num_weights[t], num_features}, grads[t].options());
+    num_indices += indices[t].numel();
+    ddim = std::max(ddim, num_features);
+  }
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
+    grads[0].scalar_type(), "_embedding_bag_multi_backward_cpu", [&]() {
+    AT_DISPATCH_INDEX_TYPES(indices[0].scalar_type(), "_embedding_bag_multi_backward_cpu", [&]() {
+      std::vector<std::vector<index_t>> offsets_include_last(num_tables);
+      // The args of the forward, with the grads as src and the gradients of
+      // the weights as output.
+      std::vector<EmbeddingBagSumMeanArgs<scalar_t, index_t>> args;
+      args.reserve(num_tables);
+      for (int64_t t = 0; t < num_tables; ++t) {
+        args.push_back(make_embedding_bag_sum_mean_args<scalar_t, index_t>(
+            indices[t], Tensor(), grads_[t], grad_weights[t], offsets[t],
+            include_last_offset, mode, offsets_include_last[t]));
+      }
+
+      // Writes or adds grad[bag] / bag_size (for mean) to row(i, idx) for
+      // the indices i of the bags [begin, end) of a table.
+      auto scatter_bags = [&](int64_t t, int64_t begin, int64_t end, bool accumulate) {
+        const auto& a = args[t];
+        for (int64_t bag = begin; bag < end; ++bag) {
+          const int64_t bag_begin = a.offsets[bag];
+          const int64_t bag_end = a.offsets[bag + 1];
+          const float norm = a.normalize_by_lengths && bag_end > bag_begin
+              ? 1.0f / (bag_end - bag_begin)
+              : 1.0f;
+          const scalar_t* grad_row = a.src + bag * a.src_stride0;
+          for (int64_t i = bag_begin; i < bag_end; ++i) {
+            if (accumulate) {
+              const int64_t idx = a.indices[i];
+              TORCH_CHECK(
+                  idx >= 0 && idx < num_weights[t],
+                  "_embedding_bag_multi_backward: index ", idx, " is out of bounds");
+              scalar_t* out = a.output + idx * a.ddim;
+              for (int64_t j = 0; j < a.ddim; ++j) {
+                out[j] += grad_row[j] * norm;
+              }
+            } else {
+              scalar_t* out = a.output + i * a.ddim;
+              for (int64_t j = 0; j < a.ddim; ++j) {
+                out[j] = grad_row[j] * norm;
+              }
+            }
+          }
+        }
+      };
+
+      if (sparse) {
+        const auto bag_begins = embedding_bag_multi_bag_begins(args);
+        const int64_t num_bags = bag_begins.back();
+        at::parallel_for(
+            0, num_bags, embedding_bag_grain_size(num_indices, num_bags, ddim),
+            [&](int64_t begin, int64_t end) {
+              for_each_table_in_range(
+                  bag_begins, begin, end, [&](int64_t t, int64_t lo, int64_t hi) {
+                    scatter_bags(t, lo, hi, /*accumulate=*/false);
+                  });
+            });
+      } else {
+        // Bags of a table add into the same rows, so tables are the unit of
+        // parallelism.
+        at::parallel_for(0, num_tables, 1, [&](int64_t begin, int64_t end) {
+          for (int64_t t = begin; t < end; ++t) {
+            scatter_bags(t, 0, args[t].num_bags, /*accumulate=*/true);
+          }
+        });
+      }
+    });
+  });
+
+  if (sparse) {
+    for (int64_t t = 0; t < num_tables; ++t) {
+      grad_weights[t] = at::_sparse_coo_tensor_unsafe(
+          indices[t].reshape({1, -1}).to(kLong), grad_weights[t],
+          {num_weights[t], grads[t].size(1)});
+    }
+  }
+  return grad_weights;
+}
+
 }
 } // namespace at::native
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at {
+namespace native {
+
+// Checks the arguments of _embedding_bag_multi and its backward, which
+// takes the gradients of the outputs in place of the weights.
+void check_embedding_bag_multi_args(
+    TensorList weights_or_grads,
+    TensorList indices,
+    TensorList offsets,
+    int64_t mode,
+    const char* name);
+
+} // namespace native
+} // namespace at
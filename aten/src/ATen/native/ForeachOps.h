@@ -0,0 +1,70 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// The ops of the CPU multi-tensor kernels, see Note [CPU foreach kernels]
+enum class ForeachBinaryOp: uint8_t {ADD, SUB, MUL, DIV, MAXIMUM, MINIMUM};
+enum class ForeachUnaryOp: uint8_t {
+  SQRT, EXP, LOG, LOG10, LOG2, LOG1P, EXPM1, ABS, NEG, RECIPROCAL, SIGMOID,
+  SIN, COS, TAN, TANH, ERF, ERFC, FLOOR, CEIL, TRUNC};
+enum class ForeachPointwiseOp: uint8_t {ADDCMUL, ADDCDIV};
+
+// out[i] = op(self[i], scalars[i]), with a single scalar for all of the
+// tensors or one for each of them
+using foreach_binary_scalar_fn = void (*)(
+    TensorList out,
+    TensorList self,
+    ArrayRef<Scalar> scalars,
+    ForeachBinaryOp op);
+
+// out[i] = op(self[i], other[i]); add and sub multiply other[i] by alpha
+using foreach_binary_list_fn = void (*)(
+    TensorList out,
+    TensorList self,
+    TensorList other,
+    Scalar alpha,
+    ForeachBinaryOp op);
+
+using foreach_unary_fn = void (*)(
+    TensorList out,
+    TensorList self,
+    ForeachUnaryOp op);
+
+// out[i] = self[i] + scalars[i] * op(tensor1[i], tensor2[i])
+using foreach_pointwise_fn = void (*)(
+    TensorList out,
+    TensorList self,
+    TensorList tensor1,
+    TensorList tensor2,
+    ArrayRef<Scalar> scalars,
+    ForeachPointwiseOp op);
+
+// The Adam or AdamW step of _fused_adam_, with step_size the lr divided by
+// the bias correction of the first moment
+using fused_adam_fn = void (*)(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    double lr,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps,
+    double step_size,
+    double sqrt_bias_correction2,
+    bool amsgrad,
+    bool decoupled_weight_decay,
+    double grad_scale);
+
+DECLARE_DISPATCH(foreach_binary_scalar_fn, foreach_binary_scalar_stub);
+DECLARE_DISPATCH(foreach_binary_list_fn, foreach_binary_list_stub);
+DECLARE_DISPATCH(foreach_unary_fn, foreach_unary_stub);
+DECLARE_DISPATCH(foreach_pointwise_fn, foreach_pointwise_stub);
+DECLARE_DISPATCH(fused_adam_fn, fused_adam_stub);
+
+}} // namespace at::native
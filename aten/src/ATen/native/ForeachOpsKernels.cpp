@@ -1,12 +1,51 @@
 #include <ATen/ATen.h>
+#include <ATen/native/ForeachOps.h>
 #include <ATen/native/ForeachUtils.h>
 #include <c10/util/irange.h>
 
+#include <cmath>
+
 namespace at { namespace native {
 
-#define FOREACH_BINARY_OP_SCALAR(OP)                                                                      \
+DEFINE_DISPATCH(foreach_binary_scalar_stub);
+DEFINE_DISPATCH(foreach_binary_list_stub);
+DEFINE_DISPATCH(foreach_unary_stub);
+DEFINE_DISPATCH(foreach_pointwise_stub);
+DEFINE_DISPATCH(fused_adam_stub);
+
+// The kernels below loop over the tensors of the lists, and the CUDA kernels
+// fall back to them when they can't take their fast route. On CPU, the lists
+// of float and double tensors which can take the fast route go through the
+// multi-tensor kernels instead, see Note [CPU foreach kernels].
+namespace {
+
+bool can_use_cpu_kernels(TensorList tensors) {
+  const auto dtype = tensors[0].scalar_type();
+  return tensors[0].device().is_cpu() && (dtype == kFloat || dtype == kDouble);
+}
+
+std::vector<Tensor> empty_like_list(TensorList tensors) {
+  std::vector<Tensor> result;
+  result.reserve(tensors.size());
+  for (const auto& t : tensors) {
+    result.emplace_back(at::empty_like(t));
+  }
+  return result;
+}
+
+std::vector<Scalar> to_scalar_list(ArrayRef<double> scalars) {
+  return std::vector<Scalar>(scalars.begin(), scalars.end());
+}
+
+} // anonymous namespace
+
+#define FOREACH_BINARY_OP_SCALAR(OP, NAME)                                                                \
 void foreach_tensor_##OP##_scalar_kernel_slow_(TensorList tensors, Scalar scalar) {                       \
   check_foreach_api_restrictions(tensors);                                                                \
+  if (can_use_fast_route(tensors, scalar) && can_use_cpu_kernels(tensors)) {                              \
+    foreach_binary_scalar_stub(kCPU, tensors, tensors, scalar, ForeachBinaryOp::NAME);                    \
+    return;                                                                                               \
+  }                                                                                                       \
                                                                                                           \
   for (auto& t: tensors) {                                                                                \
     t.OP##_(scalar);                                                                                      \
@@ -15,6 +54,11 @@ void foreach_tensor_##OP##_scalar_kernel_slow_(TensorList tensors, Scalar scalar
                                                                                                           \
 std::vector<Tensor> foreach_tensor_##OP##_scalar_kernel_slow(TensorList tensors, Scalar scalar) {         \
   check_foreach_api_restrictions(tensors);                                                                \
+  if (can_use_fast_route(tensors, scalar) && can_use_cpu_kernels(tensors)) {                              \
+    auto result = empty_like_list(tensors);                                                               \
+    foreach_binary_scalar_stub(kCPU, result, tensors, scalar, ForeachBinaryOp::NAME);                     \
+    return result;                                                                                        \
+  }                                                                                                       \
                                                                                                           \
   std::vector<Tensor> result;                                                                             \
   result.reserve(tensors.size());                                                                         \
@@ -25,9 +69,13 @@ std::vector<Tensor> foreach_tensor_##OP##_scalar_kernel_slow(TensorList tensors,
   return result;                                                                                          \
 }
 
-#define FOREACH_BINARY_OP_SCALARLIST(OP)                                                                                \
+#define FOREACH_BINARY_OP_SCALARLIST(OP, NAME)                                                                          \
 void foreach_tensor_##OP##_scalarlist_kernel_slow_(TensorList tensors, at::ArrayRef<double> scalars) {                  \
   check_foreach_api_restrictions(tensors, scalars);                                                                     \
+  if (can_use_fast_route(tensors, scalars) && can_use_cpu_kernels(tensors)) {                                           \
+    foreach_binary_scalar_stub(kCPU, tensors, tensors, to_scalar_list(scalars), ForeachBinaryOp::NAME);                 \
+    return;                                                                                                             \
+  }                                                                                                                     \
                                                                                                                         \
   for (const auto i : c10::irange(tensors.size())) {                                                                    \
       tensors[i].OP##_(scalars[i]);                                                                                     \
@@ -36,6 +84,12 @@ void foreach_tensor_##OP##_scalarlist_kernel_slow_(TensorList tensors, at::Array
                                                                                                                         \
 std::vector<Tensor> foreach_tensor_##OP##_scalarlist_kernel_slow(TensorList tensors, at::ArrayRef<double> scalars) {    \
   check_foreach_api_restrictions(tensors, scalars);                                                                     \
+  if (can_use_fast_route(tensors, scalars) && can_use_cpu_kernels(tensors)) {                                           \
+    auto result = empty_like_list(tensors);                                                                             \
+    foreach_binary_scalar_stub(kCPU, result, tensors, to_scalar_list(scalars), ForeachBinaryOp::NAME);                  \
+    return result;                                                                                                      \
+  }                                                                                                                     \
+                                                                                                                        \
   std::vector<Tensor> result;                                                                                           \
   result.reserve(tensors.size());                                                                                       \
   for (const auto i : c10::irange(tensors.size())) {                                                                    \
@@ -45,9 +99,14 @@ std::vector<Tensor> foreach_tensor_##OP##_scalarlist_kernel_slow(TensorList tens
   return result;                                                                                                        \
 }
 
-#define FOREACH_BINARY_OP_LIST(OP)                                                                        \
+#define FOREACH_BINARY_OP_LIST(OP, NAME)                                                                  \
 std::vector<Tensor> foreach_tensor_##OP##_list_kernel_slow(TensorList tensors1, TensorList tensors2) {    \
   check_foreach_api_restrictions(tensors1, tensors2);                                                     \
+  if (can_use_fast_route(tensors1, tensors2) && can_use_cpu_kernels(tensors1)) {                          \
+    auto result = empty_like_list(tensors1);                                                              \
+    foreach_binary_list_stub(kCPU, result, tensors1, tensors2, 1, ForeachBinaryOp::NAME);                 \
+    return result;                                                                                        \
+  }                                                                                                       \
                                                                                                           \
   std::vector<Tensor> result;                                                                             \
   result.reserve(tensors1.size());                                                                        \
@@ -60,15 +119,24 @@ std::vector<Tensor> foreach_tensor_##OP##_list_kernel_slow(TensorList tensors1,
                                                                                                           \
 void foreach_tensor_##OP##_list_kernel_slow_(TensorList tensors1, TensorList tensors2) {                  \
   check_foreach_api_restrictions(tensors1, tensors2);                                                     \
+  if (can_use_fast_route(tensors1, tensors2) && can_use_cpu_kernels(tensors1)) {                          \
+    foreach_binary_list_stub(kCPU, tensors1, tensors1, tensors2, 1, ForeachBinaryOp::NAME);               \
+    return;                                                                                               \
+  }                                                                                                       \
                                                                                                           \
   for (const auto i : c10::irange(tensors1.size())) {                                                     \
     tensors1[i].OP##_(tensors2[i]);                                                                       \
   }                                                                                                       \
 }
 
-#define FOREACH_BINARY_OP_LIST_ALPHA(OP)                                                                                \
+#define FOREACH_BINARY_OP_LIST_ALPHA(OP, NAME)                                                                          \
 std::vector<Tensor> foreach_tensor_##OP##_list_kernel_slow(TensorList tensors1, TensorList tensors2, Scalar alpha) {    \
   check_foreach_api_restrictions(tensors1, tensors2);                                                                   \
+  if (can_use_fast_route(tensors1, tensors2, alpha) && can_use_cpu_kernels(tensors1)) {                                 \
+    auto result = empty_like_list(tensors1);                                                                            \
+    foreach_binary_list_stub(kCPU, result, tensors1, tensors2, alpha, ForeachBinaryOp::NAME);                           \
+    return result;                                                                                                      \
+  }                                                                                                                     \
                                                                                                                         \
   std::vector<Tensor> result;                                                                                           \
   result.reserve(tensors1.size());                                                                                      \
@@ -81,6 +149,10 @@ std::vector<Tensor> foreach_tensor_##OP##_list_kernel_slow(TensorList tensors1,
                                                                                                                         \
 void foreach_tensor_##OP##_list_kernel_slow_(TensorList tensors1, TensorList tensors2, Scalar alpha) {                  \
   check_foreach_api_restrictions(tensors1, tensors2);                                                                   \
+  if (can_use_fast_route(tensors1, tensors2, alpha) && can_use_cpu_kernels(tensors1)) {                                 \
+    foreach_binary_list_stub(kCPU, tensors1, tensors1, tensors2, alpha, ForeachBinaryOp::NAME);                         \
+    return;                                                                                                             \
+  }                                                                                                                     \
                                                                                                                         \
   for (const auto i : c10::irange(tensors1.size())) {                                                                   \
     tensors1[i].OP##_(tensors2[i], alpha);                                                                              \
@@ -108,9 +180,45 @@ void foreach_tensor_##OP##_slow_(TensorList tensors) {                     \
   }                                                                        \
 }
 
-#define FOREACH_POINTWISE_OP_SCALAR(OP)                                                                                              \
+// The unary ops which have a multi-tensor kernel on CPU
+#define FOREACH_UNARY_OP_VECTORIZED(OP, NAME) \
+std::vector<Tensor> foreach_tensor_##OP##_slow(TensorList tensors) {                                   \
+  check_foreach_api_restrictions(tensors);                                                             \
+  if (can_use_fast_route(tensors) && can_use_cpu_kernels(tensors)) {                                   \
+    auto result = empty_like_list(tensors);                                                            \
+    foreach_unary_stub(kCPU, result, tensors, ForeachUnaryOp::NAME);                                   \
+    return result;                                                                                     \
+  }                                                                                                    \
+                                                                                                       \
+  std::vector<Tensor> result;                                                                          \
+  result.reserve(tensors.size());                                                                      \
+  for (const auto& t : tensors) {                                                                      \
+    result.emplace_back(t.OP());                                                                       \
+  }                                                                                                    \
+                                                                                                       \
+  return result;                                                                                       \
+}                                                                                                      \
+                                                                                                       \
+void foreach_tensor_##OP##_slow_(TensorList tensors) {                                                 \
+  check_foreach_api_restrictions(tensors);                                                             \
+  if (can_use_fast_route(tensors) && can_use_cpu_kernels(tensors)) {                                   \
+    foreach_unary_stub(kCPU, tensors, tensors, ForeachUnaryOp::NAME);                                  \
+    return;                                                                                            \
+  }                                                                                                    \
+                                                                                                       \
+  for (auto& t : tensors) {                                                                            \
+    t.OP##_();                                                                                         \
+  }                                                                                                    \
+}
+
+#define FOREACH_POINTWISE_OP_SCALAR(OP, NAME)                                                                                        \
 std::vector<Tensor> foreach_tensor_##OP##_scalar_slow(TensorList input, TensorList tensors1, TensorList tensors2, Scalar scalar) {   \
   check_foreach_api_restrictions(input, tensors1, tensors2);                                                                         \
+  if (can_use_fast_route(input, tensors1, tensors2, scalar) && can_use_cpu_kernels(input)) {                                         \
+    auto result = empty_like_list(input);                                                                                            \
+    foreach_pointwise_stub(kCPU, result, input, tensors1, tensors2, scalar, ForeachPointwiseOp::NAME);                               \
+    return result;                                                                                                                   \
+  }                                                                                                                                  \
                                                                                                                                      \
   std::vector<Tensor> result;                                                                                                        \
   for(const auto i : c10::irange(input.size())) {                                                                                    \
@@ -122,15 +230,24 @@ std::vector<Tensor> foreach_tensor_##OP##_scalar_slow(TensorList input, TensorLi
                                                                                                                                      \
 void foreach_tensor_##OP##_scalar_slow_(TensorList input, TensorList tensors1, TensorList tensors2, Scalar scalar) {                 \
   check_foreach_api_restrictions(input, tensors1, tensors2);                                                                         \
+  if (can_use_fast_route(input, tensors1, tensors2, scalar) && can_use_cpu_kernels(input)) {                                         \
+    foreach_pointwise_stub(kCPU, input, input, tensors1, tensors2, scalar, ForeachPointwiseOp::NAME);                                \
+    return;                                                                                                                          \
+  }                                                                                                                                  \
                                                                                                                                      \
   for(const auto i : c10::irange(input.size())) {                                                                                    \
     input[i].OP##_(tensors1[i], tensors2[i], scalar);                                                                                \
   }                                                                                                                                  \
-}                                                                                                                                    \
+}
 
-#define FOREACH_POINTWISE_OP_SCALARLIST(OP)                                                                                                             \
+#define FOREACH_POINTWISE_OP_SCALARLIST(OP, NAME)                                                                                                       \
 std::vector<Tensor> foreach_tensor_##OP##_scalarlist_slow(TensorList input, TensorList tensors1, TensorList tensors2, at::ArrayRef<double> scalars) {   \
   check_foreach_api_restrictions(input, tensors1, tensors2, scalars);                                                                                   \
+  if (can_use_fast_route(input, tensors1, tensors2, scalars) && can_use_cpu_kernels(input)) {                                                           \
+    auto result = empty_like_list(input);                                                                                                               \
+    foreach_pointwise_stub(kCPU, result, input, tensors1, tensors2, to_scalar_list(scalars), ForeachPointwiseOp::NAME);                                 \
+    return result;                                                                                                                                      \
+  }                                                                                                                                                     \
                                                                                                                                                         \
   std::vector<Tensor> result;                                                                                                                           \
   for(const auto i : c10::irange(input.size())) {                                                                                                       \
@@ -142,78 +259,88 @@ std::vector<Tensor> foreach_tensor_##OP##_scalarlist_slow(TensorList input, Tens
                                                                                                                                                         \
 void foreach_tensor_##OP##_scalarlist_slow_(TensorList input, TensorList tensors1, TensorList tensors2, at::ArrayRef<double> scalars) {                 \
   check_foreach_api_restrictions(input, tensors1, tensors2, scalars);                                                                                   \
+  if (can_use_fast_route(input, tensors1, tensors2, scalars) && can_use_cpu_kernels(input)) {                                                           \
+    foreach_pointwise_stub(kCPU, input, input, tensors1, tensors2, to_scalar_list(scalars), ForeachPointwiseOp::NAME);                                  \
+    return;                                                                                                                                             \
+  }                                                                                                                                                     \
                                                                                                                                                         \
   for(const auto i : c10::irange(input.size())) {                                                                                                       \
     input[i].OP##_(tensors1[i], tensors2[i], scalars[i]);                                                                                               \
   }                                                                                                                                                     \
-}                                                                                                                                                       \
+}
 
-FOREACH_BINARY_OP_LIST_ALPHA(add);
-FOREACH_BINARY_OP_LIST_ALPHA(sub);
+FOREACH_BINARY_OP_LIST_ALPHA(add, ADD);
+FOREACH_BINARY_OP_LIST_ALPHA(sub, SUB);
 
-FOREACH_BINARY_OP_SCALAR(add);
-FOREACH_BINARY_OP_SCALAR(sub);
-FOREACH_BINARY_OP_SCALAR(mul);
-FOREACH_BINARY_OP_SCALAR(div);
+FOREACH_BINARY_OP_SCALAR(add, ADD);
+FOREACH_BINARY_OP_SCALAR(sub, SUB);
+FOREACH_BINARY_OP_SCALAR(mul, MUL);
+FOREACH_BINARY_OP_SCALAR(div, DIV);
 
-FOREACH_BINARY_OP_SCALARLIST(add);
-FOREACH_BINARY_OP_SCALARLIST(sub);
-FOREACH_BINARY_OP_SCALARLIST(mul);
-FOREACH_BINARY_OP_SCALARLIST(div);
+FOREACH_BINARY_OP_SCALARLIST(add, ADD);
+FOREACH_BINARY_OP_SCALARLIST(sub, SUB);
+FOREACH_BINARY_OP_SCALARLIST(mul, MUL);
+FOREACH_BINARY_OP_SCALARLIST(div, DIV);
 
-FOREACH_BINARY_OP_LIST(mul);
-FOREACH_BINARY_OP_LIST(div);
+FOREACH_BINARY_OP_LIST(mul, MUL);
+FOREACH_BINARY_OP_LIST(div, DIV);
 
-FOREACH_UNARY_OP(sqrt);
-FOREACH_UNARY_OP(exp);
-FOREACH_UNARY_OP(abs);
+FOREACH_UNARY_OP_VECTORIZED(sqrt, SQRT);
+FOREACH_UNARY_OP_VECTORIZED(exp, EXP);
+FOREACH_UNARY_OP_VECTORIZED(abs, ABS);
 FOREACH_UNARY_OP(acos);
 FOREACH_UNARY_OP(asin);
 FOREACH_UNARY_OP(atan);
-FOREACH_UNARY_OP(ceil);
-FOREACH_UNARY_OP(cos);
+FOREACH_UNARY_OP_VECTORIZED(ceil, CEIL);
+FOREACH_UNARY_OP_VECTORIZED(cos, COS);
 FOREACH_UNARY_OP(cosh);
-FOREACH_UNARY_OP(erf);
-FOREACH_UNARY_OP(erfc);
-FOREACH_UNARY_OP(expm1);
-FOREACH_UNARY_OP(floor);
-FOREACH_UNARY_OP(log);
-FOREACH_UNARY_OP(log10);
-FOREACH_UNARY_OP(log1p);
-FOREACH_UNARY_OP(log2);
-FOREACH_UNARY_OP(neg);
-FOREACH_UNARY_OP(tan);
-FOREACH_UNARY_OP(tanh);
-FOREACH_UNARY_OP(sin);
+FOREACH_UNARY_OP_VECTORIZED(erf, ERF);
+FOREACH_UNARY_OP_VECTORIZED(erfc, ERFC);
+FOREACH_UNARY_OP_VECTORIZED(expm1, EXPM1);
+FOREACH_UNARY_OP_VECTORIZED(floor, FLOOR);
+FOREACH_UNARY_OP_VECTORIZED(log, LOG);
+FOREACH_UNARY_OP_VECTORIZED(log10, LOG10);
+FOREACH_UNARY_OP_VECTORIZED(log1p, LOG1P);
+FOREACH_UNARY_OP_VECTORIZED(log2, LOG2);
+FOREACH_UNARY_OP_VECTORIZED(neg, NEG);
+FOREACH_UNARY_OP_VECTORIZED(tan, TAN);
+FOREACH_UNARY_OP_VECTORIZED(tanh, TANH);
+FOREACH_UNARY_OP_VECTORIZED(sin, SIN);
 FOREACH_UNARY_OP(sinh);
 FOREACH_UNARY_OP(round);
 FOREACH_UNARY_OP(lgamma);
 FOREACH_UNARY_OP(frac);
-FOREACH_UNARY_OP(trunc);
-FOREACH_UNARY_OP(reciprocal);
-FOREACH_UNARY_OP(sigmoid);
-
-FOREACH_POINTWISE_OP_SCALAR(addcdiv);
-FOREACH_POINTWISE_OP_SCALAR(addcmul);
-
-FOREACH_POINTWISE_OP_SCALARLIST(addcdiv);
-FOREACH_POINTWISE_OP_SCALARLIST(addcmul);
-
-#define FOREACH_MAXIMUM_MINIMUM_OP(NAME)                                                     \
-std::vector<Tensor> foreach_tensor_##NAME##_slow(TensorList tensors1, TensorList tensors2) { \
-  check_foreach_api_restrictions(tensors1, tensors2);                                        \
-                                                                                             \
-  std::vector<Tensor> result;                                                                \
-  result.reserve(tensors1.size());                                                           \
-  for (const auto i : c10::irange(tensors1.size())) {                                        \
-    result.emplace_back(at::NAME(tensors1[i], tensors2[i]));                                 \
-  }                                                                                          \
-                                                                                             \
-  return result;                                                                             \
-}                                                                                            \
-
-FOREACH_MAXIMUM_MINIMUM_OP(maximum)
-FOREACH_MAXIMUM_MINIMUM_OP(minimum)
+FOREACH_UNARY_OP_VECTORIZED(trunc, TRUNC);
+FOREACH_UNARY_OP_VECTORIZED(reciprocal, RECIPROCAL);
+FOREACH_UNARY_OP_VECTORIZED(sigmoid, SIGMOID);
+
+FOREACH_POINTWISE_OP_SCALAR(addcdiv, ADDCDIV);
+FOREACH_POINTWISE_OP_SCALAR(addcmul, ADDCMUL);
+
+FOREACH_POINTWISE_OP_SCALARLIST(addcdiv, ADDCDIV);
+FOREACH_POINTWISE_OP_SCALARLIST(addcmul, ADDCMUL);
+
+
+#define FOREACH_MAXIMUM_MINIMUM_OP(NAME, BINARY_OP)                                            \
+std::vector<Tensor> foreach_tensor_##NAME##_slow(TensorList tensors1, TensorList tensors2) {   \
+  check_foreach_api_restrictions(tensors1, tensors2);                                          \
+  if (can_use_fast_route(tensors1, tensors2) && can_use_cpu_kernels(tensors1)) {               \
+    auto result = empty_like_list(tensors1);                                                   \
+    foreach_binary_list_stub(kCPU, result, tensors1, tensors2, 1, ForeachBinaryOp::BINARY_OP); \
+    return result;                                                                             \
+  }                                                                                            \
+                                                                                               \
+  std::vector<Tensor> result;                                                                  \
+  result.reserve(tensors1.size());                                                             \
+  for (const auto i : c10::irange(tensors1.size())) {                                          \
+    result.emplace_back(at::NAME(tensors1[i], tensors2[i]));                                   \
+  }                                                                                            \
+                                                                                               \
+  return result;                                                                               \
+}
+
+FOREACH_MAXIMUM_MINIMUM_OP(maximum, MAXIMUM)
+FOREACH_MAXIMUM_MINIMUM_OP(minimum, MINIMUM)
 
 void foreach_tensor_zero_slow_(TensorList tensors) {
   check_foreach_api_restrictions(tensors);
@@ -223,4 +350,89 @@ void foreach_tensor_zero_slow_(TensorList tensors) {
   }
 }
 
+// The Adam step of _fused_adam_ on CPU, which runs the multi-tensor kernel on
+// float and double params, see Note [CPU foreach kernels]
+void _fused_adam_cpu_(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    TensorList model_params,
+    double lr,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps,
+    int64_t step,
+    bool amsgrad,
+    bool decoupled_weight_decay,
+    const c10::optional<Tensor>& inv_grad_scale,
+    const c10::optional<Tensor>& found_inf) {
+  TORCH_CHECK(step > 0, "Expected a positive step, got ", step);
+  TORCH_CHECK(params.size() > 0, "Tensor list must have at least one tensor.");
+  TORCH_CHECK(model_params.empty(), "Master params are only supported by the CUDA fused optimizers.");
+  const auto dtype = params[0].scalar_type();
+  TORCH_CHECK(dtype == kFloat || dtype == kDouble, "params must be float or double tensors, got ", dtype);
+  TORCH_CHECK(grads.size() == params.size(), "Expected as many grads as params, got ", grads.size(), " and ", params.size());
+  std::vector<TensorList> states{exp_avgs, exp_avg_sqs};
+  if (amsgrad) {
+    states.push_back(max_exp_avg_sqs);
+  }
+  for (const TensorList& state : states) {
+    TORCH_CHECK(state.size() == params.size(), "Expected as many states as params, got ", state.size(), " and ", params.size());
+  }
+
+  // The tensors of a parameter are swept linearly, so they must all have its layout
+  auto check_same_layout = [&](const Tensor& t, const Tensor& param, const char* name) {
+    TORCH_CHECK(t.scalar_type() == dtype, "Expected ", name, " of dtype ", dtype, ", got ", t.scalar_type());
+    TORCH_CHECK(t.device().is_cpu(), "Expected ", name, " on CPU, got ", t.device());
+    TORCH_CHECK(t.sizes() == param.sizes(), "Expected ", name, " of size ", param.sizes(), ", got ", t.sizes());
+    TORCH_CHECK(t.strides() == param.strides(), "Expected ", name, " of strides ", param.strides(), ", got ", t.strides());
+  };
+  std::vector<Tensor> contiguous_grads;
+  contiguous_grads.reserve(params.size());
+  for (const auto i : c10::irange(params.size())) {
+    const Tensor& param = params[i];
+    TORCH_CHECK(param.layout() == at::kStrided && param.is_non_overlapping_and_dense(),
+                "params must be non overlapping and dense strided tensors.");
+    check_same_layout(param, param, "param");
+
+    Tensor grad = grads[i];
+    TORCH_CHECK(!grad.is_sparse(), "Fused optimizers don't support sparse gradients.");
+    if (grad.sizes() == param.sizes() && grad.strides() != param.strides()) {
+      grad = at::empty_strided(param.sizes(), param.strides(), grad.options()).copy_(grad);
+    }
+    check_same_layout(grad, param, "grad");
+    contiguous_grads.push_back(grad);
+
+    for (const TensorList& state : states) {
+      check_same_layout(state[i], param, "state");
+    }
+  }
+
+  double grad_scale = 1;
+  if (inv_grad_scale.has_value() && inv_grad_scale->defined()) {
+    TORCH_CHECK(inv_grad_scale->device().is_cpu(), "inv_grad_scale must be a CPU tensor.");
+    TORCH_CHECK(inv_grad_scale->numel() == 1, "inv_grad_scale must be a 1-element tensor.");
+    TORCH_CHECK(inv_grad_scale->scalar_type() == at::ScalarType::Float, "inv_grad_scale must be a float tensor.");
+    grad_scale = *inv_grad_scale->data_ptr<float>();
+  }
+  if (found_inf.has_value() && found_inf->defined()) {
+    TORCH_CHECK(found_inf->device().is_cpu(), "found_inf must be a CPU tensor.");
+    TORCH_CHECK(found_inf->numel() == 1, "found_inf must be a 1-element tensor.");
+    TORCH_CHECK(found_inf->scalar_type() == at::ScalarType::Float, "found_inf must be a float tensor.");
+    if (*found_inf->data_ptr<float>() != 0.f) {
+      return;
+    }
+  }
+
+  const double step_size = lr / (1 - std::pow(beta1, step));
+  const double sqrt_bias_correction2 = std::sqrt(1 - std::pow(beta2, step));
+  fused_adam_stub(
+      kCPU, params, contiguous_grads, exp_avgs, exp_avg_sqs, amsgrad ? max_exp_avg_sqs : TensorList(),
+      lr, beta1, beta2, weight_decay, eps, step_size, sqrt_bias_correction2, amsgrad,
+      decoupled_weight_decay, grad_scale);
+}
+
 }} // namespace at::native
@@ -3,6 +3,7 @@
 #include <ATen/Device.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
+#include <ATen/core/grad_mode.h>
 #include <c10/core/Layout.h>
 #include <ATen/cpu/vml.h>
 #include <ATen/native/IndexingUtils.h>
@@ -10,6 +11,8 @@
 #include <ATen/native/cpu/GridSamplerKernel.h>
 #include <c10/util/Exception.h>
 
+#include <algorithm>
+
 namespace at { namespace native {
 
 using at::native::detail::GridSamplerInterpolation;
@@ -728,6 +731,11 @@ Tensor grid_sampler_2d_cpu(const Tensor& input, const Tensor& grid,
                            int64_t interpolation_mode, int64_t padding_mode,
                            bool align_corners) {
 
+  if (input.suggest_memory_format() == at::MemoryFormat::ChannelsLast) {
+    return grid_sampler_channels_last_cpu_kernel(
+      kCPU, input, grid, interpolation_mode, padding_mode, align_corners);
+  }
+
   // AVX gather instructions use signed 32-bit offsets to gather float values.
   // Check for possible overflow and fallback to scalar implementation
   if (input.scalar_type() != kDouble) {
@@ -753,12 +761,17 @@ Tensor grid_sampler_2d_cpu(const Tensor& input, const Tensor& grid,
 }
 
 DEFINE_DISPATCH(grid_sampler_2d_cpu_kernel);
+DEFINE_DISPATCH(grid_sampler_channels_last_cpu_kernel);
 
 
 // No shape checking needed here. See # NOTE [ grid_sampler Native Functions ].
 Tensor grid_sampler_3d_cpu(const Tensor& input, const Tensor& grid,
                            int64_t interpolation_mode, int64_t padding_mode,
                            bool align_corners) {
+  if (input.suggest_memory_format() == at::MemoryFormat::ChannelsLast3d) {
+    return grid_sampler_channels_last_cpu_kernel(
+      kCPU, input, grid, interpolation_mode, padding_mode, align_corners);
+  }
   return AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "grid_sampler3d_cpu", [&] {
     return grid_sampler_3d_cpu_impl<scalar_t>(
       input, grid, static_cast<GridSamplerInterpolation>(interpolation_mode),
@@ -771,6 +784,11 @@ std::tuple<Tensor, Tensor>
 grid_sampler_2d_backward_cpu(const Tensor& grad_output, const Tensor& input, const Tensor& grid,
                              int64_t interpolation_mode, int64_t padding_mode, bool align_corners) {
 
+  if (input.suggest_memory_format() == at::MemoryFormat::ChannelsLast) {
+    return grid_sampler_backward_channels_last_cpu_kernel(
+      kCPU, grad_output, input, grid, interpolation_mode, padding_mode, align_corners);
+  }
+
   // AVX gather instructions use signed 32-bit offsets to gather float values.
   // Check for possible overflow and fallback to scalar implementation
   if (input.scalar_type() != kDouble) {
@@ -799,11 +817,16 @@ grid_sampler_2d_backward_cpu(const Tensor& grad_output, const Tensor& input, con
 }
 
 DEFINE_DISPATCH(grid_sampler_2d_backward_cpu_kernel);
+DEFINE_DISPATCH(grid_sampler_backward_channels_last_cpu_kernel);
 
 // No shape checking needed here. See # NOTE [ grid_sampler Native Functions ].
 std::tuple<Tensor, Tensor>
 grid_sampler_3d_backward_cpu(const Tensor& grad_output, const Tensor& input, const Tensor& grid,
                              int64_t interpolation_mode, int64_t padding_mode, bool align_corners) {
+  if (input.suggest_memory_format() == at::MemoryFormat::ChannelsLast3d) {
+    return grid_sampler_backward_channels_last_cpu_kernel(
+      kCPU, grad_output, input, grid, interpolation_mode, padding_mode, align_corners);
+  }
   return AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "grid_sampler_3d_backward_cpu", [&] {
     return grid_sampler_3d_backward_cpu_impl<scalar_t>(
       grad_output, input, grid,
@@ -875,4 +898,40 @@ Tensor grid_sampler(const Tensor& input, const Tensor& grid,
   }
 }
 
+// grid_sampler(input, affine_grid_generator(theta, size, align_corners), ...).
+// The grid isn't materialized for channels last CPU inputs which don't require
+// grad, see Note [Channels last grid sampler].
+Tensor affine_grid_sampler(const Tensor& input, const Tensor& theta, IntArrayRef size,
+                           int64_t interpolation_mode, int64_t padding_mode,
+                           bool align_corners) {
+  const int64_t dim = input.dim() - 2;
+  const bool requires_grad = GradMode::is_enabled() &&
+      (input.requires_grad() || theta.requires_grad());
+  const auto memory_format = input.suggest_memory_format();
+  const bool fused = !requires_grad &&
+      input.device().is_cpu() && theta.device().is_cpu() &&
+      input.layout() == kStrided && theta.layout() == kStrided &&
+      !input.is_quantized() &&
+      (input.scalar_type() == kFloat || input.scalar_type() == kDouble) &&
+      theta.scalar_type() == input.scalar_type() &&
+      ((dim == 2 && memory_format == at::MemoryFormat::ChannelsLast) ||
+       (dim == 3 && memory_format == at::MemoryFormat::ChannelsLast3d &&
+        static_cast<GridSamplerInterpolation>(interpolation_mode) != GridSamplerInterpolation::Bicubic)) &&
+      static_cast<int64_t>(size.size()) == input.dim() &&
+      size[0] == input.size(0) && size[1] == input.size(1) &&
+      theta.dim() == 3 && theta.size(0) == input.size(0) &&
+      theta.size(1) == dim && theta.size(2) == dim + 1 &&
+      std::all_of(size.begin() + 2, size.end(), [](int64_t s) { return s > 0; }) &&
+      std::all_of(input.sizes().begin() + 2, input.sizes().end(), [](int64_t s) { return s > 0; });
+  if (fused) {
+    return affine_grid_sampler_channels_last_cpu_kernel(
+      kCPU, input, theta, size.slice(2), interpolation_mode, padding_mode, align_corners);
+  }
+  return at::grid_sampler(
+    input, at::affine_grid_generator(theta, size, align_corners),
+    interpolation_mode, padding_mode, align_corners);
+}
+
+DEFINE_DISPATCH(affine_grid_sampler_channels_last_cpu_kernel);
+
 }}  // namespace at::native
@@ -25,6 +25,7 @@ namespace at {
 namespace native {
 
 DEFINE_DISPATCH(addr_stub);
+DEFINE_DISPATCH(baddbmm_small_stub);
 
 // Helper function for det methods.
 // For pivoted LU factorization A = P * L * U. Since we always have det(L) = 1,
@@ -708,10 +709,16 @@ inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const T
 // - When the operand size is small, computation are parallelized over the batch
 //   dimension using OMP and naive matrix multiplication is applied.
 // - When the operand size is larger than the threshold, if compiled with MKL, MKL's batch gemm is used.
+// - Otherwise, float and double matrices with all of their sizes at most
+//   kSmallBmmMaxSize are multiplied by a register-blocked kernel, also
+//   parallelized over the batch (baddbmm_small_stub), which avoids a BLAS call
+//   per matrix.
 // - Otherwise, we use a series of matrix multiplications.
 // The threshold of 400 for the first has not been thoroughly benchmarked yet and may have room for further
 // optimization, it likely depends on the characteristics of the CPU, MKL will be different from non-MKL etc.,
 // but this seems to be a first starting point.
+// kSmallBmmMaxSize keeps a packed mat2 of the kernel within the L2 cache.
+constexpr int64_t kSmallBmmMaxSize = 128;
 
 static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor& batch1, const Tensor& batch2, Scalar beta, Scalar alpha, bool is_bmm_out) {
   // is_bmm_out: true for bmm_out, false for baddbmm_
@@ -788,6 +795,12 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
             && batch_items_contiguous_or_transposed(batch2)
             && self_or_result.is_contiguous()) {
     at::native::_baddbmm_mkl_(self_or_result, batch1, batch2, beta, alpha);
+  } else if ((self_or_result.scalar_type() == kFloat || self_or_result.scalar_type() == kDouble)
+            && self_or_result.stride(2) == 1
+            && res_rows <= kSmallBmmMaxSize
+            && res_cols <= kSmallBmmMaxSize
+            && contraction_size <= kSmallBmmMaxSize) {
+    baddbmm_small_stub(kCPU, self_or_result, batch1, batch2, beta, alpha, is_bmm_out);
   } else { // split along batch dimension
     if (is_bmm_out) {
       for (int64_t b = 0; b < bs; b++) {
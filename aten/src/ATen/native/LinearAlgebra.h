@@ -10,4 +10,10 @@ namespace at { namespace native {
 using addr_fn = void (*)(TensorIterator &, Scalar beta, Scalar alpha);
 DECLARE_DISPATCH(addr_fn, addr_stub);
 
+// bmm/baddbmm of small float or double matrices, result must have a unit
+// stride in its last dimension. See bmm_out_or_baddbmm_ for when it is used.
+using baddbmm_small_fn = void (*)(const Tensor& result, const Tensor& batch1, const Tensor& batch2,
+                                  Scalar beta, Scalar alpha, bool is_bmm);
+DECLARE_DISPATCH(baddbmm_small_fn, baddbmm_small_stub);
+
 }} // namespace at::native
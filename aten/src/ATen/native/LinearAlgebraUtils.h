@@ -112,6 +112,11 @@ static inline void batchCheckErrors(std::vector<int64_t>& infos, const char* nam
  * This is an overloaded case of the previous function for a tensor of infos.
  */
 static inline void batchCheckErrors(const Tensor& infos, const char* name, bool allow_singular=false, int info_per_batch=1) {
+  // For large batches on the GPU, copying whether there is any error is much
+  // cheaper than copying all the error codes, and there is usually none
+  if (infos.is_cuda() && !infos.ne(0).any().item<bool>()) {
+    return;
+  }
   auto batch_size = infos.numel();
   auto infos_cpu = infos.to(at::kCPU);
   auto infos_data = infos_cpu.data_ptr<int>();
@@ -3,10 +3,16 @@
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/native/cpu/SoftmaxKernel.h>
+
+#include <limits>
 
 namespace at {
 namespace native {
 
+DEFINE_DISPATCH(log_softmax_nll_loss_kernel);
+DEFINE_DISPATCH(log_softmax_nll_loss_backward_kernel);
+
 namespace {
 
 // Returns a contiguous tensor if the source tensor
@@ -323,6 +329,62 @@ void nll_loss_backward_out_cpu_template(
       });
 }
 
+void check_log_softmax_nll_loss_inputs(
+    const Tensor& input,
+    const Tensor& target,
+    const Tensor& weight) {
+  TORCH_CHECK(input.dim() == 2, "input tensor should be 2D");
+  TORCH_CHECK(
+      target.dim() == 1,
+      "1D target tensor expected, multi-target not supported");
+  TORCH_CHECK(
+      input.size(0) == target.size(0),
+      "size mismatch (got input: ",
+      input.sizes(),
+      ", target: ",
+      target.sizes(),
+      ")")
+  TORCH_CHECK(
+      target.scalar_type() == kLong,
+      "expected target of scalar type Long but got ",
+      target.scalar_type());
+  TORCH_CHECK(
+      !weight.defined() || weight.numel() == input.size(1),
+      "weight tensor should be defined either for all ",
+      input.size(1),
+      " classes or no classes"
+      " but got weight tensor of shape: ",
+      weight.sizes());
+}
+
+// Weight of every row, 0 for the rows whose target is ignore_index, and the
+// target with ignore_index replaced by a valid class.
+std::tuple<Tensor, Tensor> log_softmax_nll_loss_row_weights(
+    const Tensor& input,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index) {
+  auto keep = target != ignore_index;
+  auto safe_target = target.masked_fill(keep.logical_not(), 0);
+  auto row_weights = weight.defined() ? weight.index_select(0, safe_target)
+                                      : at::ones_like(target, input.options());
+  return std::make_tuple(row_weights * keep, safe_target);
+}
+
+// The gradient of the losses of every row, before weighting.
+Tensor log_softmax_nll_loss_grad_rows(
+    const Tensor& grad_output,
+    const Tensor& total_weight,
+    int64_t batch_size,
+    int64_t reduction) {
+  if (reduction == Reduction::None) {
+    return grad_output;
+  }
+  auto grad = reduction == Reduction::Mean ? grad_output / total_weight
+                                           : grad_output;
+  return grad.expand({batch_size});
+}
+
 } // namespace
 
 std::tuple<Tensor&, Tensor&> nll_loss_forward_out_cpu(
@@ -402,6 +464,158 @@ Tensor nll_loss(const Tensor & self, const Tensor & target, const Tensor & weigh
   return std::get<0>(at::nll_loss_forward(self, target, weight, reduction, ignore_index));
 }
 
+// log_softmax(self, 1) followed by nll_loss, without the log-probabilities.
+// The logsumexp of every row is returned for the backward.
+std::tuple<Tensor, Tensor, Tensor> math_log_softmax_nll_loss_forward(
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t reduction,
+    int64_t ignore_index) {
+  check_log_softmax_nll_loss_inputs(self, target, weight);
+  Tensor row_weights, safe_target;
+  std::tie(row_weights, safe_target) =
+      log_softmax_nll_loss_row_weights(self, target, weight, ignore_index);
+  auto lse = at::logsumexp(self, {1});
+  auto losses = (lse - self.gather(1, safe_target.unsqueeze(1)).squeeze(1)) *
+      row_weights;
+  auto total_weight = row_weights.sum();
+  if (reduction == Reduction::None) {
+    return std::make_tuple(losses, lse, total_weight);
+  }
+  auto output = losses.sum();
+  if (reduction == Reduction::Mean) {
+    // same as nll_loss: the loss stays 0 if all the targets are ignored,
+    // except for an empty input
+    output = self.numel() == 0
+        ? output / total_weight
+        : at::where(total_weight == 0, output, output / total_weight);
+  }
+  return std::make_tuple(output, lse, total_weight);
+}
+
+std::tuple<Tensor, Tensor, Tensor> log_softmax_nll_loss_forward_cpu(
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t reduction,
+    int64_t ignore_index) {
+  if (self.scalar_type() == kBFloat16) {
+    // computed in float and rounded once
+    Tensor output, lse, total_weight;
+    std::tie(output, lse, total_weight) = log_softmax_nll_loss_forward_cpu(
+        self.to(kFloat),
+        target,
+        weight.defined() ? weight.to(kFloat) : weight,
+        reduction,
+        ignore_index);
+    return std::make_tuple(
+        output.to(kBFloat16), lse.to(kBFloat16), total_weight.to(kBFloat16));
+  }
+  check_log_softmax_nll_loss_inputs(self, target, weight);
+  auto input = self.contiguous();
+  auto target_contiguous = target.contiguous();
+  auto weight_contiguous = optional_contiguous(weight);
+  const auto batch_size = input.size(0);
+  auto losses = at::empty({batch_size}, input.options());
+  auto row_weights = at::empty({batch_size}, input.options());
+  auto lse = at::empty({batch_size}, input.options());
+  if (input.numel() > 0) {
+    log_softmax_nll_loss_kernel(
+        kCPU,
+        losses,
+        row_weights,
+        lse,
+        input,
+        target_contiguous,
+        weight_contiguous,
+        ignore_index);
+  } else {
+    losses.zero_();
+    row_weights.zero_();
+    lse.fill_(-std::numeric_limits<double>::infinity());
+  }
+  auto total_weight = row_weights.sum();
+  if (reduction == Reduction::None) {
+    return std::make_tuple(losses, lse, total_weight);
+  }
+  auto output = losses.sum();
+  if (reduction == Reduction::Mean &&
+      (total_weight.item<double>() != 0 || input.numel() == 0)) {
+    // allow NaN result for total_weight == 0 case, see #15870
+    output.div_(total_weight);
+  }
+  return std::make_tuple(output, lse, total_weight);
+}
+
+Tensor math_log_softmax_nll_loss_backward(
+    const Tensor& grad_output,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t reduction,
+    int64_t ignore_index,
+    const Tensor& lse,
+    const Tensor& total_weight) {
+  check_log_softmax_nll_loss_inputs(self, target, weight);
+  Tensor row_weights, safe_target;
+  std::tie(row_weights, safe_target) =
+      log_softmax_nll_loss_row_weights(self, target, weight, ignore_index);
+  auto grad = (log_softmax_nll_loss_grad_rows(
+                   grad_output, total_weight, self.size(0), reduction) *
+               row_weights)
+                  .unsqueeze(1);
+  return ((self - lse.unsqueeze(1)).exp() * grad)
+      .scatter_add(1, safe_target.unsqueeze(1), -grad);
+}
+
+Tensor log_softmax_nll_loss_backward_cpu(
+    const Tensor& grad_output,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t reduction,
+    int64_t ignore_index,
+    const Tensor& lse,
+    const Tensor& total_weight) {
+  if (self.scalar_type() == kBFloat16) {
+    // the logsumexp is recomputed, the saved one was rounded to BFloat16
+    auto self_float = self.to(kFloat);
+    return log_softmax_nll_loss_backward_cpu(
+               grad_output.to(kFloat),
+               self_float,
+               target,
+               weight.defined() ? weight.to(kFloat) : weight,
+               reduction,
+               ignore_index,
+               at::logsumexp(self_float, {1}),
+               total_weight.to(kFloat))
+        .to(kBFloat16);
+  }
+  check_log_softmax_nll_loss_inputs(self, target, weight);
+  auto input = self.contiguous();
+  auto grad_input = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  if (input.numel() == 0) {
+    return grad_input;
+  }
+  auto grad_rows = log_softmax_nll_loss_grad_rows(
+                       grad_output, total_weight, input.size(0), reduction)
+                       .contiguous();
+  log_softmax_nll_loss_backward_kernel(
+      kCPU,
+      grad_input,
+      grad_rows,
+      input,
+      target.contiguous(),
+      optional_contiguous(weight),
+      lse.contiguous(),
+      ignore_index);
+  return grad_input;
+}
+
+Tensor log_softmax_nll_loss(const Tensor & self, const Tensor & target, const Tensor & weight, int64_t reduction, int64_t ignore_index) {
+  return std::get<0>(at::_log_softmax_nll_loss_forward(self, target, weight, reduction, ignore_index));
+}
 
 } // namespace native
 } // namespace at
@@ -0,0 +1,357 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/NestedTensorImpl.h>
+#include <ATen/WrapDimUtils.h>
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+// See Note [Nested tensors]
+
+namespace at { namespace native {
+
+namespace {
+
+// The nested tensor of the components, copied one after the other to a new
+// buffer
+Tensor pack_components(TensorList components) {
+  TORCH_INTERNAL_ASSERT(!components.empty());
+  const int64_t ntensors = components.size();
+  const int64_t component_dim = components[0].dim();
+  Tensor nested_size = at::empty({ntensors, component_dim}, kLong);
+  auto* sizes = nested_size.data_ptr<int64_t>();
+  std::vector<Tensor> flat;
+  flat.reserve(ntensors);
+  for (int64_t i = 0; i < ntensors; i++) {
+    const auto component_size = components[i].sizes();
+    std::copy(component_size.begin(), component_size.end(), sizes + i * component_dim);
+    flat.push_back(components[i].reshape({-1}));
+  }
+  return wrapNestedBuffer(at::cat(flat), nested_size);
+}
+
+// Views the buffer as the rows of its last row_dims dims, which are regular
+Tensor buffer_rows(const NestedTensorImpl* nt, int64_t row_dims) {
+  const int64_t component_dim = nt->dim() - 1;
+  TORCH_INTERNAL_ASSERT(row_dims <= component_dim);
+  int64_t rows = 0;
+  for (int64_t i = 0; i < nt->ntensors(); i++) {
+    const auto component_size = nt->component_size(i);
+    int64_t component_rows = 1;
+    for (int64_t d = 0; d < component_dim - row_dims; d++) {
+      component_rows *= component_size[d];
+    }
+    rows += component_rows;
+  }
+  std::vector<int64_t> size{rows};
+  for (int64_t d = component_dim + 1 - row_dims; d <= component_dim; d++) {
+    size.push_back(*nt->opt_size(d));
+  }
+  return nt->buffer().view(size);
+}
+
+// The operands of a binary op of a nested tensor, which are its buffer and
+// either the buffer of the other operand, a nested tensor of the same nested
+// size, a 0-d tensor, or a 1-d tensor broadcast along the regular last dim of
+// the nested tensor, next to the rows of the buffer
+struct NestedOperands {
+  Tensor self;
+  Tensor other;
+  Tensor nested_size;
+};
+
+NestedOperands nested_operands(const Tensor& self, const Tensor& other, const char* op_name) {
+  if (isNestedTensor(self) && isNestedTensor(other)) {
+    const auto* self_nt = getNestedTensorImpl(self);
+    const auto* other_nt = getNestedTensorImpl(other);
+    TORCH_CHECK(
+        self_nt->nested_size().sizes() == other_nt->nested_size().sizes() &&
+            at::equal(self_nt->nested_size(), other_nt->nested_size()),
+        op_name, ": expected nested tensors with components of the same sizes");
+    return {self_nt->buffer(), other_nt->buffer(), self_nt->nested_size()};
+  }
+  const bool self_nested = isNestedTensor(self);
+  const auto* nt = getNestedTensorImpl(self_nested ? self : other);
+  Tensor dense = self_nested ? other : self;
+  Tensor buffer = nt->buffer();
+  if (dense.dim() == 1) {
+    const auto last_size = nt->opt_size(-1);
+    TORCH_CHECK(
+        nt->dim() >= 2 && last_size.has_value() && dense.size(0) == *last_size,
+        op_name, ": a 1-d tensor of size ", dense.size(0),
+        " can only be broadcast along a regular last dim of the same size of a nested tensor");
+    buffer = buffer_rows(nt, 1);
+  } else {
+    TORCH_CHECK(
+        dense.dim() == 0, op_name,
+        ": expected a nested tensor, a 0-d tensor or a 1-d tensor as the operand of a nested tensor, got a ",
+        dense.dim(), "-d tensor");
+  }
+  if (self_nested) {
+    return {buffer, dense, nt->nested_size()};
+  }
+  return {dense, buffer, nt->nested_size()};
+}
+
+Tensor wrap_rows(const Tensor& rows, const Tensor& nested_size) {
+  return wrapNestedBuffer(rows.view({-1}), nested_size);
+}
+
+} // anonymous namespace
+
+Tensor nested_tensor(TensorList tensors) {
+  TORCH_CHECK(!tensors.empty(), "nested_tensor: expected a non-empty list of tensors");
+  const auto& first = tensors[0];
+  for (const auto& tensor : tensors) {
+    TORCH_CHECK(!isNestedTensor(tensor), "nested_tensor: expected tensors which aren't nested");
+    TORCH_CHECK(
+        tensor.dim() == first.dim() && tensor.scalar_type() == first.scalar_type() &&
+            tensor.device() == first.device(),
+        "nested_tensor: expected tensors of the same dim, dtype and device, got a ",
+        first.dim(), "-d ", first.scalar_type(), " tensor on ", first.device(), " and a ",
+        tensor.dim(), "-d ", tensor.scalar_type(), " tensor on ", tensor.device());
+  }
+  return pack_components(tensors);
+}
+
+Tensor nested_tensor_from_padded(const Tensor& padded, const Tensor& lengths) {
+  TORCH_CHECK(!isNestedTensor(padded), "nested_tensor_from_padded: expected a padded tensor which isn't nested");
+  TORCH_CHECK(padded.dim() >= 2,
+      "nested_tensor_from_padded: expected a padded tensor of at least 2 dims, got ", padded.dim());
+  const int64_t batch = padded.size(0);
+  const int64_t max_length = padded.size(1);
+  TORCH_CHECK(
+      lengths.dim() == 1 && lengths.size(0) == batch && lengths.scalar_type() == kLong,
+      "nested_tensor_from_padded: expected 1-d int64 lengths of size ", batch,
+      ", got ", lengths.dim(), "-d ", lengths.scalar_type(), " lengths");
+  const Tensor lengths_cpu = lengths.cpu().contiguous();
+  const auto* lengths_data = lengths_cpu.data_ptr<int64_t>();
+
+  const int64_t component_dim = padded.dim() - 1;
+  Tensor nested_size = at::empty({batch, component_dim}, kLong);
+  auto* sizes = nested_size.data_ptr<int64_t>();
+  std::vector<Tensor> flat;
+  flat.reserve(batch);
+  for (int64_t i = 0; i < batch; i++) {
+    const int64_t length = lengths_data[i];
+    TORCH_CHECK(length >= 0 && length <= max_length,
+        "nested_tensor_from_padded: expected lengths between 0 and ", max_length, ", got ", length);
+    sizes[i * component_dim] = length;
+    for (int64_t d = 1; d < component_dim; d++) {
+      sizes[i * component_dim + d] = padded.size(d + 1);
+    }
+    flat.push_back(padded.select(0, i).narrow(0, 0, length).reshape({-1}));
+  }
+  Tensor buffer = batch > 0 ? at::cat(flat) : at::empty({0}, padded.options());
+  return wrapNestedBuffer(buffer, nested_size);
+}
+
+Tensor nested_to_padded_tensor(const Tensor& self, double padding, c10::optional<IntArrayRef> output_size) {
+  const auto* nt = getNestedTensorImpl(self);
+  const int64_t dim = self.dim();
+  std::vector<int64_t> padded_size(dim, 0);
+  padded_size[0] = nt->ntensors();
+  for (int64_t i = 0; i < nt->ntensors(); i++) {
+    const auto component_size = nt->component_size(i);
+    for (int64_t d = 1; d < dim; d++) {
+      padded_size[d] = std::max(padded_size[d], component_size[d - 1]);
+    }
+  }
+  if (output_size.has_value()) {
+    TORCH_CHECK(static_cast<int64_t>(output_size->size()) == dim,
+        "to_padded_tensor: expected an output size of ", dim, " dims, got ", *output_size);
+    for (int64_t d = 0; d < dim; d++) {
+      TORCH_CHECK((*output_size)[d] >= padded_size[d],
+          "to_padded_tensor: the output size ", *output_size,
+          " is smaller than the size ", padded_size, " the components are padded to");
+    }
+    padded_size = output_size->vec();
+  }
+
+  Tensor padded = at::full(padded_size, padding, nt->buffer().options());
+  for (int64_t i = 0; i < nt->ntensors(); i++) {
+    const auto component_size = nt->component_size(i);
+    Tensor slot = padded.select(0, i);
+    for (int64_t d = 0; d < dim - 1; d++) {
+      slot = slot.narrow(d, 0, component_size[d]);
+    }
+    slot.copy_(nt->component(i));
+  }
+  return padded;
+}
+
+std::vector<Tensor> nested_unbind(const Tensor& self, int64_t dim) {
+  const auto* nt = getNestedTensorImpl(self);
+  dim = maybe_wrap_dim(dim, self.dim());
+  TORCH_CHECK(dim == 0, "unbind: nested tensors can only be unbound along dim 0, into their components");
+  std::vector<Tensor> components;
+  components.reserve(nt->ntensors());
+  for (int64_t i = 0; i < nt->ntensors(); i++) {
+    components.push_back(nt->component(i));
+  }
+  return components;
+}
+
+Tensor nested_clone(const Tensor& self, c10::optional<MemoryFormat> optional_memory_format) {
+  const auto memory_format = optional_memory_format.value_or(MemoryFormat::Preserve);
+  TORCH_CHECK(
+      memory_format == MemoryFormat::Preserve || memory_format == MemoryFormat::Contiguous,
+      "clone: nested tensors only support the preserve and contiguous memory formats, got ",
+      memory_format);
+  const auto* nt = getNestedTensorImpl(self);
+  return wrapNestedBuffer(nt->buffer().clone(), nt->nested_size());
+}
+
+// The pointwise ops run on the buffer
+
+Tensor nested_relu(const Tensor& self) {
+  const auto* nt = getNestedTensorImpl(self);
+  return wrapNestedBuffer(at::relu(nt->buffer()), nt->nested_size());
+}
+
+Tensor& nested_relu_(Tensor& self) {
+  getNestedTensorImpl(self)->buffer().relu_();
+  return self;
+}
+
+Tensor nested_gelu(const Tensor& self) {
+  const auto* nt = getNestedTensorImpl(self);
+  return wrapNestedBuffer(at::gelu(nt->buffer()), nt->nested_size());
+}
+
+Tensor nested_sigmoid(const Tensor& self) {
+  const auto* nt = getNestedTensorImpl(self);
+  return wrapNestedBuffer(at::sigmoid(nt->buffer()), nt->nested_size());
+}
+
+Tensor nested_tanh(const Tensor& self) {
+  const auto* nt = getNestedTensorImpl(self);
+  return wrapNestedBuffer(at::tanh(nt->buffer()), nt->nested_size());
+}
+
+Tensor nested_add(const Tensor& self, const Tensor& other, Scalar alpha) {
+  auto operands = nested_operands(self, other, "add");
+  return wrap_rows(at::add(operands.self, operands.other, alpha), operands.nested_size);
+}
+
+Tensor& nested_add_(Tensor& self, const Tensor& other, Scalar alpha) {
+  TORCH_CHECK(isNestedTensor(self), "add_: can't add a nested tensor in place to a tensor which isn't nested");
+  auto operands = nested_operands(self, other, "add_");
+  operands.self.add_(operands.other, alpha);
+  return self;
+}
+
+Tensor nested_mul(const Tensor& self, const Tensor& other) {
+  auto operands = nested_operands(self, other, "mul");
+  return wrap_rows(at::mul(operands.self, operands.other), operands.nested_size);
+}
+
+Tensor& nested_mul_(Tensor& self, const Tensor& other) {
+  TORCH_CHECK(isNestedTensor(self), "mul_: can't multiply a tensor which isn't nested in place by a nested tensor");
+  auto operands = nested_operands(self, other, "mul_");
+  operands.self.mul_(operands.other);
+  return self;
+}
+
+// linear and layer_norm run on the rows of the regular trailing dims of the
+// buffer
+
+Tensor nested_linear(const Tensor& input, const Tensor& weight, const Tensor& bias) {
+  const auto* nt = getNestedTensorImpl(input);
+  TORCH_CHECK(!isNestedTensor(weight) && weight.dim() == 2,
+      "linear: expected a 2-d weight for a nested input, got a ", weight.dim(), "-d weight");
+  const auto in_features = nt->opt_size(-1);
+  TORCH_CHECK(
+      input.dim() >= 2 && in_features.has_value() && *in_features == weight.size(1),
+      "linear: expected a nested input with a regular last dim of the ", weight.size(1),
+      " in features of the weight");
+  Tensor output = at::linear(buffer_rows(nt, 1), weight, bias);
+  Tensor nested_size = nt->nested_size().clone();
+  nested_size.select(1, -1).fill_(weight.size(0));
+  return wrap_rows(output, nested_size);
+}
+
+Tensor nested_layer_norm(
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */,
+    double eps,
+    bool cudnn_enable) {
+  const auto* nt = getNestedTensorImpl(input);
+  const int64_t normalized_ndim = normalized_shape.size();
+  TORCH_CHECK(normalized_ndim >= 1 && normalized_ndim < input.dim(),
+      "layer_norm: expected a normalized shape of 1 to ", input.dim() - 1,
+      " dims for a nested input, got ", normalized_shape);
+  for (int64_t d = 0; d < normalized_ndim; d++) {
+    const auto size = nt->opt_size(input.dim() - normalized_ndim + d);
+    TORCH_CHECK(size.has_value() && *size == normalized_shape[d],
+        "layer_norm: expected a nested input with regular last dims of the normalized shape ",
+        normalized_shape);
+  }
+  Tensor output = at::layer_norm(
+      buffer_rows(nt, normalized_ndim), normalized_shape, weight, bias, eps, cudnn_enable);
+  return wrap_rows(output, nt->nested_size());
+}
+
+Tensor nested_softmax(const Tensor& self, int64_t dim, bool half_to_float) {
+  const auto* nt = getNestedTensorImpl(self);
+  dim = maybe_wrap_dim(dim, self.dim());
+  TORCH_CHECK(dim > 0, "softmax: can't compute the softmax of a nested tensor along dim 0, across its components");
+  if (dim == self.dim() - 1 && nt->opt_size(dim).has_value()) {
+    return wrap_rows(at::_softmax(buffer_rows(nt, 1), 1, half_to_float), nt->nested_size());
+  }
+  // The rows along dim have different sizes in different components
+  std::vector<Tensor> outputs;
+  outputs.reserve(nt->ntensors());
+  for (int64_t i = 0; i < nt->ntensors(); i++) {
+    outputs.push_back(at::_softmax(nt->component(i), dim - 1, half_to_float));
+  }
+  if (outputs.empty()) {
+    return nested_clone(self, c10::nullopt);
+  }
+  return pack_components(outputs);
+}
+
+// The attention of nested query, key and value of [heads, length, features]
+// components, of the query i to the key and value i. The components are
+// computed by the fused kernels one after the other, each over its own
+// lengths: the lengths replace the masks of padded inputs.
+std::tuple<Tensor, Tensor> nested_scaled_dot_product_attention(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const c10::optional<Tensor>& attn_mask,
+    bool is_causal,
+    c10::optional<double> scale) {
+  TORCH_CHECK(isNestedTensor(query) && isNestedTensor(key) && isNestedTensor(value),
+      "_scaled_dot_product_attention: expected query, key and value to be all nested or all not nested");
+  TORCH_CHECK(!(attn_mask.has_value() && attn_mask->defined()),
+      "_scaled_dot_product_attention: nested inputs don't take a mask, their components have their own lengths");
+  TORCH_CHECK(query.dim() == 4 && key.dim() == 4 && value.dim() == 4,
+      "_scaled_dot_product_attention: expected nested query, key and value of 3-d [heads, length, features] components");
+  const auto* query_nt = getNestedTensorImpl(query);
+  const auto* key_nt = getNestedTensorImpl(key);
+  const auto* value_nt = getNestedTensorImpl(value);
+  const int64_t ntensors = query_nt->ntensors();
+  TORCH_CHECK(ntensors > 0 && key_nt->ntensors() == ntensors && value_nt->ntensors() == ntensors,
+      "_scaled_dot_product_attention: expected nested query, key and value of the same number of components, got ",
+      ntensors, ", ", key_nt->ntensors(), " and ", value_nt->ntensors());
+
+  std::vector<Tensor> outputs;
+  std::vector<Tensor> logsumexps;
+  outputs.reserve(ntensors);
+  logsumexps.reserve(ntensors);
+  for (int64_t i = 0; i < ntensors; i++) {
+    Tensor output, logsumexp;
+    std::tie(output, logsumexp) = at::_scaled_dot_product_attention(
+        query_nt->component(i), key_nt->component(i), value_nt->component(i),
+        c10::nullopt, is_causal, scale);
+    outputs.push_back(std::move(output));
+    logsumexps.push_back(std::move(logsumexp));
+  }
+  return std::make_tuple(pack_components(outputs), pack_components(logsumexps));
+}
+
+}} // namespace at::native
@@ -17,6 +17,9 @@ static const int MIOPEN_DIM_MAX = 5;
 namespace at { namespace native {
 
 DEFINE_DISPATCH(batch_norm_cpu_inference_contiguous_stub);
+DEFINE_DISPATCH(batch_norm_cpu_collect_stats_stub);
+DEFINE_DISPATCH(batch_norm_cpu_transform_stub);
+DEFINE_DISPATCH(batch_norm_cpu_backward_stub);
 
 namespace {
   void check_dims_match_num_input_features(const char* arg_name, int64_t expected, int64_t actual){
@@ -387,6 +390,102 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_template(const Tensor
   return std::make_tuple(grad_input, grad_weight, grad_bias);
 }
 
+// The blocked training kernels of cpu/batch_norm_kernel.cpp reduce the
+// statistics in one pass over the input with Welford's algorithm, and
+// parallelize over the rows of channels last inputs as well.
+static bool batch_norm_use_blocked_kernels(const Tensor& input) {
+  return input.dim() >= 2 && input.numel() > 0 &&
+      (input.is_contiguous() || input.is_contiguous(at::MemoryFormat::ChannelsLast));
+}
+
+static MemoryFormat batch_norm_blocked_memory_format(const Tensor& input) {
+  return input.is_contiguous() ? at::MemoryFormat::Contiguous : at::MemoryFormat::ChannelsLast;
+}
+
+template<typename scalar_t>
+std::tuple<Tensor, Tensor, Tensor> batch_norm_cpu_train_blocked_template(
+    const Tensor& input, const Tensor& weight, const Tensor& bias,
+    const Tensor& running_mean, const Tensor& running_var, double momentum, double eps) {
+
+  using accscalar_t = at::acc_type<scalar_t, false>;
+
+  int64_t n_input = input.size(1);
+  int64_t n = input.numel() / n_input;
+
+  Tensor save_mean = at::empty({n_input}, input.options());
+  Tensor save_var = at::empty({n_input}, input.options());
+  batch_norm_cpu_collect_stats_stub(kCPU, save_mean, save_var, input);
+
+  Tensor save_invstd = at::empty({n_input}, input.options());
+  Tensor alpha = at::empty({n_input}, input.options());
+  Tensor beta = at::empty({n_input}, input.options());
+  auto save_mean_a = save_mean.accessor<scalar_t, 1>();
+  auto save_var_a = save_var.accessor<scalar_t, 1>();
+  auto save_invstd_a = save_invstd.accessor<scalar_t, 1>();
+  auto alpha_a = alpha.accessor<scalar_t, 1>();
+  auto beta_a = beta.accessor<scalar_t, 1>();
+  auto weight_a = conditional_accessor_1d<scalar_t>(weight);
+  auto bias_a = conditional_accessor_1d<scalar_t>(bias);
+  auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
+  auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
+
+  for (int64_t f = 0; f < n_input; ++f) {
+    accscalar_t mean = save_mean_a[f];
+    accscalar_t var = save_var_a[f];
+    accscalar_t invstd = InvStd<accscalar_t>{}(var, eps);
+    save_invstd_a[f] = invstd;
+
+    // output = (input - mean) * invstd * w + b = input * alpha + beta
+    accscalar_t w = weight.defined() ? weight_a[f] : 1;
+    accscalar_t b = bias.defined() ? bias_a[f] : 0;
+    alpha_a[f] = invstd * w;
+    beta_a[f] = b - mean * invstd * w;
+
+    // update running averages
+    if (running_mean.defined()) {
+      running_mean_a[f] = momentum * mean + (1 - momentum) * running_mean_a[f];
+    }
+    if (running_var.defined()) {
+      accscalar_t unbiased_var = var * n / (n - 1);
+      running_var_a[f] = momentum * unbiased_var + (1 - momentum) * running_var_a[f];
+    }
+  }
+
+  Tensor output = at::empty_like(input, batch_norm_blocked_memory_format(input));
+  batch_norm_cpu_transform_stub(kCPU, output, input, alpha, beta);
+  return std::make_tuple(output, save_mean, save_invstd);
+}
+
+template<typename scalar_t>
+std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_train_blocked_template(
+    const Tensor& grad_out_, const Tensor& input, const Tensor& weight,
+    const Tensor& save_mean, const Tensor& save_invstd, std::array<bool,3> grad_input_mask) {
+
+  const auto memory_format = batch_norm_blocked_memory_format(input);
+  Tensor grad_out = grad_out_.contiguous(memory_format);
+  int64_t n_input = input.size(1);
+
+  Tensor grad_input;
+  if (grad_input_mask[0]) {
+    grad_input = at::empty_like(input, memory_format);
+  }
+  Tensor sum_dy = at::empty({n_input}, input.options());
+  Tensor sum_dy_xmu = at::empty({n_input}, input.options());
+  Tensor invstd = save_invstd.contiguous();
+  batch_norm_cpu_backward_stub(kCPU, grad_input, sum_dy, sum_dy_xmu, grad_out, input,
+      weight.defined() ? weight.contiguous() : weight, save_mean.contiguous(), invstd);
+
+  Tensor grad_weight;
+  Tensor grad_bias;
+  if (grad_input_mask[1]) {
+    grad_weight = sum_dy_xmu.mul_(invstd);
+  }
+  if (grad_input_mask[2]) {
+    grad_bias = sum_dy;
+  }
+  return std::make_tuple(grad_input, grad_weight, grad_bias);
+}
+
 // _batch_norm_impl_index(_backward) are used in the JIT be able to keep the run-time selection
 // of backends, while enabling it to keep the information about the used backend, so that it can
 // use its corresponding backward implementation.
@@ -555,6 +654,8 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_cpu(const Tensor& self, const Tens
   return AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "batch_norm", [&] {
       if (!train) {
         return batch_norm_cpu_transform_input_template<scalar_t>(self, weight, bias, {}, {}, running_mean, running_var, train, eps);
+      } else if (batch_norm_use_blocked_kernels(self)) {
+        return batch_norm_cpu_train_blocked_template<scalar_t>(self, weight, bias, running_mean, running_var, momentum, eps);
       } else {
         auto save_stats = batch_norm_cpu_update_stats_template<scalar_t, InvStd>(self, running_mean, running_var, momentum, eps);
         return batch_norm_cpu_transform_input_template<scalar_t>(self, weight, bias, std::get<0>(save_stats), std::get<1>(save_stats), running_mean, running_var, train, eps);
@@ -566,8 +667,179 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu(const Tensor& grad_ou
                                                            const Tensor& running_mean, const Tensor& running_var, const Tensor& save_mean, const Tensor& save_invstd,
                                                            bool train, double eps, std::array<bool,3> grad_input_mask) {
   return AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "batch_norm_backward_cpu", [&] {
+      if (train && batch_norm_use_blocked_kernels(self)) {
+        return batch_norm_backward_cpu_train_blocked_template<scalar_t>(grad_out, self, weight, save_mean, save_invstd, grad_input_mask);
+      }
       return batch_norm_backward_cpu_template<scalar_t>(grad_out, self, weight, running_mean, running_var, save_mean, save_invstd, train, eps, grad_input_mask);
     });
 }
 
+namespace {
+
+void check_batch_norm_add_relu_inputs(const Tensor& input, const Tensor& other) {
+  TORCH_CHECK(input.dim() >= 2,
+              "batch_norm_add_relu: expected an input of at least 2 dimensions, got ", input.dim());
+  TORCH_CHECK(!other.defined() || other.sizes() == input.sizes(),
+              "batch_norm_add_relu: expected other of the size of input ", input.sizes(),
+              ", got ", other.sizes());
+}
+
+// The dimensions batch norm reduces over, and the shape of the statistics
+// broadcast to the input
+std::pair<std::vector<int64_t>, std::vector<int64_t>> batch_norm_add_relu_dims(const Tensor& input) {
+  std::vector<int64_t> reduce_dims{0};
+  std::vector<int64_t> channel_shape(input.dim(), 1);
+  for (int64_t dim = 2; dim < input.dim(); dim++) {
+    reduce_dims.push_back(dim);
+  }
+  channel_shape[1] = input.size(1);
+  return std::make_pair(reduce_dims, channel_shape);
+}
+
+// Packs a bit per element of the boolean tensor, in channels last order
+// (i.e. the order of the elements of positive.movedim(1, -1)), into int32
+// words, as the CUDA kernels store the ReLU mask.
+Tensor pack_relu_mask(const Tensor& positive) {
+  const int64_t numel = positive.numel();
+  const int64_t words = (numel + 31) / 32;
+  Tensor bits = at::constant_pad_nd(
+      positive.movedim(1, -1).reshape({-1}).to(kLong), {0, words * 32 - numel});
+  Tensor shifts = at::arange(32, bits.options());
+  Tensor weights = at::ones({32}, bits.options()).__lshift__(shifts);
+  return bits.view({words, 32}).mul_(weights).sum(1).to(kInt);
+}
+
+Tensor unpack_relu_mask(const Tensor& relu_mask, const Tensor& like) {
+  Tensor words = relu_mask.to(kLong).unsqueeze(1);
+  Tensor bits = words.__rshift__(at::arange(32, words.options())).bitwise_and_(1);
+  return bits.view({-1}).narrow(0, 0, like.numel()).to(kBool)
+      .view(like.movedim(1, -1).sizes()).movedim(-1, 1);
+}
+
+ScalarType batch_norm_add_relu_acc_type(const Tensor& input) {
+  const auto dtype = input.scalar_type();
+  return dtype == kHalf || dtype == kBFloat16 ? kFloat : dtype;
+}
+
+} // namespace
+
+// Computes relu(batch_norm(input) + other) with the ops of the composite
+// batch norm. Returns (output, save_mean, save_invstd, relu_mask), the
+// statistics being those of the running stats when not training.
+std::tuple<Tensor, Tensor, Tensor, Tensor> math_batch_norm_add_relu(
+    const Tensor& input, const Tensor& other /* optional */,
+    const Tensor& weight /* optional */, const Tensor& bias /* optional */,
+    const Tensor& running_mean /* optional */, const Tensor& running_var /* optional */,
+    bool training, double momentum, double eps) {
+  check_batch_norm_add_relu_inputs(input, other);
+  std::vector<int64_t> reduce_dims, channel_shape;
+  std::tie(reduce_dims, channel_shape) = batch_norm_add_relu_dims(input);
+  Tensor input_acc = input.to(batch_norm_add_relu_acc_type(input));
+
+  Tensor save_mean, save_invstd;
+  if (training) {
+    const int64_t n = input.numel() / input.size(1);
+    TORCH_CHECK(n > 1, "Expected more than 1 value per channel when training, got input size ", input.sizes());
+    Tensor var;
+    std::tie(var, save_mean) = at::var_mean(input_acc, reduce_dims, /*unbiased=*/false);
+    save_invstd = (var + eps).rsqrt_();
+    if (running_mean.defined()) {
+      running_mean.mul_(1 - momentum).add_(save_mean.to(running_mean.scalar_type()), momentum);
+    }
+    if (running_var.defined()) {
+      Tensor unbiased_var = var * (static_cast<double>(n) / (n - 1));
+      running_var.mul_(1 - momentum).add_(unbiased_var.to(running_var.scalar_type()), momentum);
+    }
+  } else {
+    TORCH_CHECK(running_mean.defined() && running_var.defined(),
+                "batch_norm_add_relu: expected running_mean and running_var to be defined when not training");
+    save_mean = running_mean.to(input_acc.scalar_type(), /*non_blocking=*/false, /*copy=*/true);
+    save_invstd = (running_var.to(input_acc.scalar_type()) + eps).rsqrt_();
+  }
+
+  Tensor output = (input_acc - save_mean.view(channel_shape)) * save_invstd.view(channel_shape);
+  if (weight.defined()) {
+    output = output * weight.view(channel_shape);
+  }
+  if (bias.defined()) {
+    output = output + bias.view(channel_shape);
+  }
+  if (other.defined()) {
+    output = output + other;
+  }
+  output = output.relu_().to(input.scalar_type());
+  Tensor relu_mask = pack_relu_mask(output > 0);
+  return std::make_tuple(output, save_mean, save_invstd, relu_mask);
+}
+
+// Gradients of _batch_norm_add_relu for input, other, weight and bias
+std::tuple<Tensor, Tensor, Tensor, Tensor> math_batch_norm_add_relu_backward(
+    const Tensor& grad_out, const Tensor& input, const Tensor& weight /* optional */,
+    const Tensor& save_mean, const Tensor& save_invstd, const Tensor& relu_mask,
+    bool training, std::array<bool, 4> output_mask) {
+  std::vector<int64_t> reduce_dims, channel_shape;
+  std::tie(reduce_dims, channel_shape) = batch_norm_add_relu_dims(input);
+  const auto acc_type = save_mean.scalar_type();
+  Tensor grad = grad_out.to(acc_type).masked_fill_(unpack_relu_mask(relu_mask, input).logical_not(), 0);
+  Tensor mean = save_mean.view(channel_shape);
+  Tensor invstd = save_invstd.view(channel_shape);
+  Tensor scale = weight.defined() ? invstd * weight.to(acc_type).view(channel_shape) : invstd;
+
+  Tensor grad_input, grad_other, grad_weight, grad_bias;
+  if (output_mask[0]) {
+    if (training) {
+      const double n = input.numel() / input.size(1);
+      Tensor xhat = (input.to(acc_type) - mean) * invstd;
+      Tensor mean_grad = grad.mean(reduce_dims, /*keepdim=*/true);
+      Tensor mean_grad_xhat = (grad * xhat).sum(reduce_dims, /*keepdim=*/true).div_(n);
+      grad_input = ((grad - mean_grad) - xhat * mean_grad_xhat) * scale;
+    } else {
+      grad_input = grad * scale;
+    }
+    grad_input = grad_input.to(input.scalar_type());
+  }
+  if (output_mask[1]) {
+    grad_other = grad.to(input.scalar_type());
+  }
+  if (output_mask[2] && weight.defined()) {
+    grad_weight = (grad * (input.to(acc_type) - mean) * invstd).sum(reduce_dims).to(weight.scalar_type());
+  }
+  if (output_mask[3]) {
+    grad_bias = grad.sum(reduce_dims).to(weight.defined() ? weight.scalar_type() : acc_type);
+  }
+  return std::make_tuple(grad_input, grad_other, grad_weight, grad_bias);
+}
+
+Tensor batch_norm_add_relu(
+    const Tensor& input, const Tensor& other /* optional */,
+    const Tensor& weight /* optional */, const Tensor& bias /* optional */,
+    const Tensor& running_mean /* optional */, const Tensor& running_var /* optional */,
+    bool training, double momentum, double eps) {
+  return std::get<0>(at::_batch_norm_add_relu(
+      input, other, weight, bias, running_mean, running_var, training, momentum, eps));
+}
+
+// batch_norm(convolution(input, conv_weight, conv_bias)). When training, the
+// batch norm subtracts the bias of the convolution again with the mean, so
+// the convolution is computed without it and the bias is only added to the
+// running mean, saving a pass over the output of the convolution.
+Tensor conv_batch_norm(
+    const Tensor& input, const Tensor& conv_weight, const Tensor& conv_bias /* optional */,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups,
+    const Tensor& weight /* optional */, const Tensor& bias /* optional */,
+    const Tensor& running_mean /* optional */, const Tensor& running_var /* optional */,
+    bool training, double momentum, double eps) {
+  const bool skip_conv_bias = training && conv_bias.defined();
+  Tensor conv_out = at::convolution(
+      input, conv_weight, skip_conv_bias ? Tensor() : conv_bias,
+      stride, padding, dilation, /*transposed=*/false, /*output_padding=*/{0}, groups);
+  Tensor output = at::batch_norm(
+      conv_out, weight, bias, running_mean, running_var, training, momentum, eps,
+      at::globalContext().userEnabledCuDNN());
+  if (skip_conv_bias && running_mean.defined()) {
+    running_mean.add_(conv_bias.detach().to(running_mean.scalar_type()), momentum);
+  }
+  return output;
+}
+
 }} // at::native
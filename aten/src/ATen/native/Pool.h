@@ -2,6 +2,7 @@
 #include <ATen/Parallel.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/div_rtn.h>
+#include <ATen/native/DispatchStub.h>
 #include <tuple>
 
 #pragma once
@@ -9,6 +10,23 @@
 namespace at {
 namespace native {
 
+// The CPU kernels of max_pool2d and avg_pool2d for 4-d channels last inputs,
+// which compute channels last outputs (see Note [Channels last pooling])
+using max_pool2d_fn = void(*)(Tensor& output, Tensor& indices, const Tensor& input,
+    int kW, int kH, int dW, int dH, int padW, int padH, int dilationW, int dilationH);
+using max_pool2d_backward_fn = void(*)(Tensor& grad_input, const Tensor& grad_output, const Tensor& indices);
+DECLARE_DISPATCH(max_pool2d_fn, max_pool2d_channels_last_kernel);
+DECLARE_DISPATCH(max_pool2d_backward_fn, max_pool2d_backward_channels_last_kernel);
+
+using avg_pool2d_fn = void(*)(Tensor& output, const Tensor& input,
+    int kW, int kH, int dW, int dH, int padW, int padH,
+    bool count_include_pad, c10::optional<int64_t> divisor_override);
+using avg_pool2d_backward_fn = void(*)(Tensor& grad_input, const Tensor& grad_output,
+    int kW, int kH, int dW, int dH, int padW, int padH,
+    bool count_include_pad, c10::optional<int64_t> divisor_override);
+DECLARE_DISPATCH(avg_pool2d_fn, avg_pool2d_channels_last_kernel);
+DECLARE_DISPATCH(avg_pool2d_backward_fn, avg_pool2d_backward_channels_last_kernel);
+
 namespace {
 
 template <typename dest_t, typename src_t>
@@ -2,6 +2,7 @@
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/core/grad_mode.h>
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/packed_params.h>
@@ -717,6 +718,27 @@ struct SimpleCell : Cell<Tensor, cell_params> {
   }
 };
 
+// Whether the CPU time step of a cell can run lstm_cell_pointwise_stub or
+// gru_cell_pointwise_stub, which autograd doesn't see. The gates of every
+// cell params are float, the quantized ones included.
+bool use_fused_cell_pointwise(
+    const Tensor& igates,
+    const Tensor& hgates,
+    const Tensor& hx,
+    int64_t num_gates) {
+  if (at::GradMode::is_enabled() &&
+      (igates.requires_grad() || hgates.requires_grad() || hx.requires_grad())) {
+    return false;
+  }
+  const auto dtype = hx.scalar_type();
+  return hx.device().is_cpu() && hx.dim() == 2 && igates.dim() == 2 &&
+      hgates.dim() == 2 && (dtype == kFloat || dtype == kDouble) &&
+      igates.scalar_type() == dtype && hgates.scalar_type() == dtype &&
+      igates.device().is_cpu() && hgates.device().is_cpu() &&
+      igates.sizes() == hgates.sizes() && igates.size(0) == hx.size(0) &&
+      igates.size(1) == num_gates * hx.size(1);
+}
+
 // TODO: can use inplace ops?
 template <typename cell_params>
 struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
@@ -742,8 +764,17 @@ struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
       return std::make_tuple(std::move(hy), std::move(std::get<1>(result)));
     }
 
-    const auto gates = params.linear_hh(hx).add_(
-        pre_compute_input ? input : params.linear_ih(input));
+    auto hgates = params.linear_hh(hx);
+    const auto igates = pre_compute_input ? input : params.linear_ih(input);
+    if (use_fused_cell_pointwise(igates, hgates, cx, 4)) {
+      auto hy = at::empty_like(cx, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+      auto cy = at::empty_like(cx, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+      lstm_cell_pointwise_stub(kCPU, hy, cy, igates, hgates, cx);
+      hy = params.matmul_hr(hy);
+      return std::make_tuple(std::move(hy), std::move(cy));
+    }
+
+    const auto gates = hgates.add_(igates);
     auto chunked_gates = gates.unsafe_chunk(4, 1);
     auto ingate = chunked_gates[0].sigmoid_();
     auto forgetgate = chunked_gates[1].sigmoid_();
@@ -775,10 +806,15 @@ struct GRUCell : Cell<Tensor, cell_params> {
       // Slice off the workspace argument (it's needed only for AD).
       return std::move(std::get<0>(result));
     }
-    const auto chunked_igates = pre_compute_input
-        ? input.unsafe_chunk(3, 1)
-        : params.linear_ih(input).unsafe_chunk(3, 1);
-    auto chunked_hgates = params.linear_hh(hidden).unsafe_chunk(3, 1);
+    const auto igates = pre_compute_input ? input : params.linear_ih(input);
+    const auto hgates = params.linear_hh(hidden);
+    if (use_fused_cell_pointwise(igates, hgates, hidden, 3)) {
+      auto hy = at::empty_like(hidden, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+      gru_cell_pointwise_stub(kCPU, hy, igates, hgates, hidden);
+      return hy;
+    }
+    const auto chunked_igates = igates.unsafe_chunk(3, 1);
+    auto chunked_hgates = hgates.unsafe_chunk(3, 1);
     const auto reset_gate =
         chunked_hgates[0].add_(chunked_igates[0]).sigmoid_();
     const auto input_gate =
@@ -1156,6 +1192,154 @@ std::tuple<io_type, Tensor, Tensor> _lstm_impl(
   return std::make_tuple(std::move(result.outputs), at::stack(hy, 0), at::stack(cy, 0));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// FUSED CPU INFERENCE
+//
+// The LSTMs and GRUs which don't need autograd run their layers over the whole
+// sequence in one go instead of going through the cells: the input projection
+// of a layer is one GEMM, the states stay in preallocated [batch, hidden]
+// buffers updated in place by the pointwise kernels, and the outputs are
+// written to a preallocated packed output. The sequences of a packed input are
+// sorted by decreasing length, so each step only updates the first
+// batch_sizes[t] rows of the states: the finished sequences keep their final
+// states in the other rows, without slicing or concatenating them.
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename CellType>
+constexpr bool has_fused_rnn = false;
+template <>
+constexpr bool has_fused_rnn<GRUCell<CellParams>> = true;
+
+bool use_fused_rnn(
+    const Tensor& input,
+    TensorList hx,
+    TensorList params,
+    bool has_projections,
+    double dropout_p,
+    bool train) {
+  const auto dtype = input.scalar_type();
+  if (!input.device().is_cpu() || (dtype != kFloat && dtype != kDouble) ||
+      input.numel() == 0 || has_projections || (train && dropout_p != 0)) {
+    return false;
+  }
+  const bool grad_mode = at::GradMode::is_enabled();
+  if (grad_mode && input.requires_grad()) {
+    return false;
+  }
+  for (const auto& tensors : {hx, params}) {
+    for (const auto& t : tensors) {
+      if (!t.defined()) {
+        continue;
+      }
+      if (!t.device().is_cpu() || t.scalar_type() != dtype || (grad_mode && t.requires_grad())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Runs one direction of an LSTM layer (c defined) or a GRU layer (c
+// undefined) over the [num_rows, input_size] packed input. h and c hold the
+// initial states and are updated to the final ones, the outputs are written to
+// the [num_rows, hidden_size] output.
+void fused_rnn_layer(
+    const Tensor& input,
+    IntArrayRef batch_sizes,
+    const CellParams& params,
+    Tensor& h,
+    Tensor& c,
+    Tensor output,
+    bool reverse) {
+  const auto igates_all = params.linear_ih(input);
+  auto hgates_buffer = at::empty({h.size(0), igates_all.size(1)}, h.options());
+  const auto w_hh_t = params.w_hh.t();
+  const int64_t num_steps = batch_sizes.size();
+  std::vector<int64_t> offsets(num_steps);
+  int64_t offset = 0;
+  for (int64_t t = 0; t < num_steps; ++t) {
+    offsets[t] = offset;
+    offset += batch_sizes[t];
+  }
+
+  for (int64_t step = 0; step < num_steps; ++step) {
+    const int64_t t = reverse ? num_steps - 1 - step : step;
+    const int64_t batch_size = batch_sizes[t];
+    auto hx = h.narrow(0, 0, batch_size);
+    auto hgates = hgates_buffer.narrow(0, 0, batch_size);
+    if (params.b_hh().defined()) {
+      at::addmm_out(hgates, params.b_hh(), hx, w_hh_t);
+    } else {
+      at::mm_out(hgates, hx, w_hh_t);
+    }
+    const auto igates = igates_all.narrow(0, offsets[t], batch_size);
+    // the kernels read each state before writing it, hence in place
+    if (c.defined()) {
+      auto cx = c.narrow(0, 0, batch_size);
+      lstm_cell_pointwise_stub(kCPU, hx, cx, igates, hgates, cx);
+    } else {
+      gru_cell_pointwise_stub(kCPU, hx, igates, hgates, hx);
+    }
+    output.narrow(0, offsets[t], batch_size).copy_(hx);
+  }
+}
+
+// The stacked layers of fused_rnn_layer, returning the packed output and the
+// final h and c (undefined for a GRU)
+std::tuple<Tensor, Tensor, Tensor> fused_rnn(
+    const Tensor& input,
+    IntArrayRef batch_sizes,
+    const std::vector<CellParams>& params,
+    const Tensor& hx,
+    const Tensor& cx,
+    int64_t num_layers,
+    bool bidirectional) {
+  const int64_t num_directions = bidirectional ? 2 : 1;
+  TORCH_CHECK(
+      (int64_t)params.size() == num_layers * num_directions,
+      "Expected ", num_layers * num_directions, " sets of RNN weights, but got ", params.size());
+  const int64_t hidden_size = hx.size(2);
+  auto hy = hx.clone(at::MemoryFormat::Contiguous);
+  auto cy = cx.defined() ? cx.clone(at::MemoryFormat::Contiguous) : Tensor();
+  auto layer_input = input;
+  for (int64_t l = 0; l < num_layers; ++l) {
+    auto layer_output = at::empty({input.size(0), num_directions * hidden_size}, input.options());
+    for (int64_t d = 0; d < num_directions; ++d) {
+      const int64_t index = l * num_directions + d;
+      auto h = hy.select(0, index);
+      auto c = cy.defined() ? cy.select(0, index) : Tensor();
+      fused_rnn_layer(
+          layer_input, batch_sizes, params[index], h, c,
+          layer_output.narrow(1, d * hidden_size, hidden_size), /*reverse=*/d == 1);
+    }
+    layer_input = std::move(layer_output);
+  }
+  return std::make_tuple(std::move(layer_input), std::move(hy), std::move(cy));
+}
+
+// fused_rnn over a [seq_len, batch, input_size] input, as a packed input with
+// all the sequences of the same length
+std::tuple<Tensor, Tensor, Tensor> fused_rnn_full(
+    const Tensor& input,
+    const std::vector<CellParams>& params,
+    const Tensor& hx,
+    const Tensor& cx,
+    int64_t num_layers,
+    bool bidirectional) {
+  const int64_t seq_len = input.size(0);
+  const int64_t batch_size = input.size(1);
+  const std::vector<int64_t> batch_sizes(seq_len, batch_size);
+  auto result = fused_rnn(
+      input.reshape({seq_len * batch_size, input.size(2)}), batch_sizes, params, hx, cx,
+      num_layers, bidirectional);
+  std::get<0>(result) = std::get<0>(result).view({seq_len, batch_size, -1});
+  return result;
+}
+
+IntArrayRef batch_sizes_ref(const Tensor& batch_sizes) {
+  return IntArrayRef(batch_sizes.data_ptr<int64_t>(), batch_sizes.size(0));
+}
+
 } // anonymous namespace
 
 bool _use_cudnn_rnn_flatten_weight() {
@@ -1223,6 +1407,16 @@ bool _use_cudnn_rnn_flatten_weight() {
     check_attributes(_input, _params, hx);                                  \
     auto input = batch_first ? _input.transpose(0, 1) : _input;             \
     auto params = gather_params(_params, has_biases);                       \
+    if (has_fused_rnn<CELL> &&                                              \
+        use_fused_rnn(_input, hx, _params, false, dropout_p, train)) {      \
+      auto fused = fused_rnn_full(                                          \
+          input, params, hx, Tensor(), num_layers, bidirectional);          \
+      auto& output = std::get<0>(fused);                                    \
+      if (batch_first) {                                                    \
+        output.transpose_(0, 1);                                            \
+      }                                                                     \
+      return std::make_tuple(std::move(output), std::move(std::get<1>(fused))); \
+    }                                                                       \
     auto results =                                                          \
         _rnn_impl_with_concat<CELL, FullLayer, FullBidirectionalLayer>(     \
             input,                                                          \
@@ -1284,6 +1478,14 @@ bool _use_cudnn_rnn_flatten_weight() {
     }                                                                       \
     PackedSequence input{data, batch_sizes};                                \
     auto params = gather_params(_params, has_biases);                       \
+    if (has_fused_rnn<CELL> &&                                              \
+        use_fused_rnn(data, hx, _params, false, dropout_p, train)) {        \
+      auto fused = fused_rnn(                                               \
+          data, batch_sizes_ref(batch_sizes), params, hx, Tensor(),         \
+          num_layers, bidirectional);                                       \
+      return std::make_tuple(                                               \
+          std::move(std::get<0>(fused)), std::move(std::get<1>(fused)));    \
+    }                                                                       \
     auto result =                                                           \
         _rnn_impl_with_concat<CELL, PackedLayer, PackedBidirectionalLayer>( \
             input,                                                          \
@@ -1421,6 +1623,8 @@ ONE_HIDDEN_RNN(rnn_tanh, tanf_cell_type)
 using relu_cell_type = SimpleCell<relu_f, CellParams>;
 ONE_HIDDEN_RNN(rnn_relu, relu_cell_type);
 
+DEFINE_DISPATCH(lstm_cell_pointwise_stub);
+DEFINE_DISPATCH(gru_cell_pointwise_stub);
 DEFINE_DISPATCH(lstm_cudnn_stub);
 DEFINE_DISPATCH(lstm_packed_cudnn_stub);
 DEFINE_DISPATCH(lstm_miopen_stub);
@@ -1453,6 +1657,13 @@ std::tuple<Tensor, Tensor, Tensor> lstm(
   check_attributes(_input, _params, hx);
   auto input = batch_first ? _input.transpose(0, 1) : _input;
   auto params = gather_params(_params, has_biases, has_projections);
+  if (use_fused_rnn(_input, hx, _params, has_projections, dropout_p, train)) {
+    auto results = fused_rnn_full(input, params, hx[0], hx[1], num_layers, bidirectional);
+    if (batch_first) {
+      std::get<0>(results) = std::get<0>(results).transpose(0, 1);
+    }
+    return results;
+  }
   auto results = _lstm_impl<FullLayer, FullBidirectionalLayer>(
       input, params, hx[0], hx[1], num_layers, dropout_p, train, bidirectional);
   if (batch_first) {
@@ -1482,8 +1693,12 @@ std::tuple<Tensor, Tensor, Tensor> lstm(
     return std::make_tuple(std::move(output), std::move(hy), std::move(cy));
   }
 
-  PackedSequence input { data, batch_sizes };
   auto params = gather_params(_params, has_biases, has_projections);
+  if (use_fused_rnn(data, hx, _params, has_projections, dropout_p, train)) {
+    return fused_rnn(
+        data, batch_sizes_ref(batch_sizes), params, hx[0], hx[1], num_layers, bidirectional);
+  }
+  PackedSequence input { data, batch_sizes };
   auto result = _lstm_impl<PackedLayer, PackedBidirectionalLayer>(
       input, params, hx[0], hx[1], num_layers, dropout_p, train, bidirectional);
   auto & packed_output = std::get<0>(result);
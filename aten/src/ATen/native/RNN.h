@@ -27,6 +27,14 @@ DECLARE_DISPATCH(rnn_packed_fn, rnn_tanh_packed_miopen_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_cudnn_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_miopen_stub);
 
+// The gate nonlinearities and state updates of an LSTM or GRU time step in one
+// pass over the gates, for the CPU cells that don't need autograd. The gates
+// include the biases.
+using lstm_cell_pointwise_fn = void(*)(Tensor& hy, Tensor& cy, const Tensor& igates, const Tensor& hgates, const Tensor& cx);
+using gru_cell_pointwise_fn = void(*)(Tensor& hy, const Tensor& igates, const Tensor& hgates, const Tensor& hx);
+DECLARE_DISPATCH(lstm_cell_pointwise_fn, lstm_cell_pointwise_stub);
+DECLARE_DISPATCH(gru_cell_pointwise_fn, gru_cell_pointwise_stub);
+
 inline void check_attributes(const Tensor& input, const TensorList& params, const TensorList& hiddens, bool check_dtype=false) {
   auto input_device = input.device();
   auto input_dtype = input.scalar_type();
@@ -28,6 +28,7 @@ namespace native {
 DEFINE_DISPATCH(sum_stub);
 DEFINE_DISPATCH(nansum_stub);
 DEFINE_DISPATCH(std_var_stub);
+DEFINE_DISPATCH(aminmax_var_mean_stub);
 DEFINE_DISPATCH(prod_stub);
 DEFINE_DISPATCH(norm_stub);
 DEFINE_DISPATCH(mean_stub);
@@ -1022,6 +1023,32 @@ Tensor amax(const Tensor& self, IntArrayRef dim, bool keepdim) {
   return at::amax_out(result, self, dim, keepdim);
 }
 
+std::tuple<Tensor&, Tensor&, Tensor&, Tensor&> aminmax_var_mean_out(
+    Tensor& min, Tensor& max, Tensor& var, Tensor& mean,
+    const Tensor& self, IntArrayRef dim, bool unbiased, bool keepdim) {
+  TORCH_CHECK(self.device().type() == DeviceType::CPU || self.device().type() == DeviceType::CUDA,
+              "aminmax_var_mean only supports CPU AND CUDA device type, got: ", self.device().type());
+  TORCH_CHECK(self.layout() == Layout::Strided,
+              "aminmax_var_mean only supports strided layout, got: ", self.layout());
+  TORCH_CHECK(at::isFloatingType(self.scalar_type()),
+              "aminmax_var_mean only support floating-point dtypes");
+  std::vector<Tensor> results = {min, max, var, mean};
+  auto iter = make_reduction("aminmax_var_mean", results, self, dim, keepdim, self.scalar_type());
+  TORCH_CHECK(iter.numel() > 0, "operation does not have an identity");
+  aminmax_var_mean_stub(iter.device_type(), iter, unbiased);
+  return std::tuple<Tensor&, Tensor&, Tensor&, Tensor&>(min, max, var, mean);
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor> aminmax_var_mean(
+    const Tensor& self, IntArrayRef dim, bool unbiased, bool keepdim) {
+  Tensor min = at::empty({0}, self.options());
+  Tensor max = at::empty({0}, self.options());
+  Tensor var = at::empty({0}, self.options());
+  Tensor mean = at::empty({0}, self.options());
+  at::native::aminmax_var_mean_out(min, max, var, mean, self, dim, unbiased, keepdim);
+  return std::make_tuple(min, max, var, mean);
+}
+
 Tensor& argmax_out(Tensor& result, const Tensor& self, c10::optional<int64_t> dim, bool keepdim) {
   TORCH_CHECK(self.numel() > 0, "cannot perform reduction function argmax on a "
       "tensor with no elements because the operation does not have an identity");
@@ -27,6 +27,11 @@ using reduce_std_var_function =
   void (*)(TensorIterator&, bool unbiased, bool take_sqrt);
 DECLARE_DISPATCH(reduce_std_var_function, std_var_stub);
 
+// min, max, var and mean of the reduced elements into the four outputs of the
+// iterator, in a single pass over the input
+using reduce_aminmax_var_mean_fn = void (*)(TensorIterator&, bool unbiased);
+DECLARE_DISPATCH(reduce_aminmax_var_mean_fn, aminmax_var_mean_stub);
+
 using reduce_norm_fn =
     void (*)(Tensor&, const Tensor&, Scalar, c10::optional<int64_t>);
 DECLARE_DISPATCH(reduce_norm_fn, norm_kernel);
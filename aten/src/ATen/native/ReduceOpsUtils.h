@@ -249,4 +249,36 @@ static TensorIterator make_reduction(
   return make_reduction(name, result1, result2, self, dim, keepdim, dtype, dtype);
 }
 
+// Reduction of self into every tensor of results in a single pass. Undefined
+// results are allocated with dtype, defined ones are resized.
+static TensorIterator make_reduction(
+    const char* name, std::vector<Tensor>& results, const Tensor& self, IntArrayRef dim,
+    bool keepdim, ScalarType dtype)
+{
+  for (const auto& result : results) {
+    TORCH_CHECK(
+      !result.defined() || result.scalar_type() == dtype,
+      name, ": provided dtype must match dtype of result. Got ",
+      toString(result.scalar_type()),
+      " and ",
+      toString(dtype),
+      ".");
+  }
+
+  int64_t ndim = self.dim();
+  DimMask mask = make_dim_mask(dim, ndim);
+  std::vector<Tensor> viewed_results;
+  viewed_results.reserve(results.size());
+  for (auto& result : results) {
+    allocate_reduction_result(result, self, mask, keepdim, dtype);
+    viewed_results.push_back(review_reduce_result(result, ndim, mask, keepdim));
+    namedinference::propagate_names_for_reduction(result, self, dim, keepdim);
+  }
+
+  if (self.scalar_type() == dtype) {
+    return TensorIterator::reduce_op(viewed_results, self);
+  }
+  return TensorIterator::reduce_op(viewed_results, self.to(dtype));
+}
+
 }}  // at::native
@@ -5,6 +5,7 @@
 #include <type_traits>
 #include <complex>
 #include <c10/macros/Macros.h>
+#include <ATen/core/Array.h>
 #include <ATen/detail/FunctionTraits.h>
 #include <ATen/NumericUtils.h>
 #if defined(__CUDACC__)
@@ -510,6 +511,80 @@ struct MinMaxOps {
 #endif
 };
 
+template <typename scalar_t, typename acc_scalar_t, typename index_t, typename combine_t>
+struct MinMaxWelfordData {
+  WelfordData<acc_scalar_t, index_t, combine_t> welford;
+  scalar_t min;
+  scalar_t max;
+  C10_HOST_DEVICE MinMaxWelfordData() : welford(), min(0), max(0) {}
+  C10_DEVICE MinMaxWelfordData(WelfordData<acc_scalar_t, index_t, combine_t> welford, scalar_t min, scalar_t max)
+    : welford(welford), min(min), max(max) {}
+};
+
+// Computes min, max, var and mean in a single pass over the input, the var
+// and the mean as in WelfordOps. The min and the max propagate NaN. An
+// accumulator without elements is the identity of combine.
+template <typename scalar_t, typename acc_scalar_t, typename index_t, typename combine_t>
+struct MinMaxWelfordOps {
+  bool unbiased;
+ public:
+  using acc_t = MinMaxWelfordData<scalar_t, acc_scalar_t, index_t, combine_t>;
+  using res_t = at::detail::Array<scalar_t, 4>;
+  using welford_ops_t = WelfordOps<scalar_t, acc_scalar_t, index_t, combine_t, detail::pair<scalar_t, scalar_t>>;
+
+  static inline C10_DEVICE scalar_t min_or_nan(scalar_t a, scalar_t b) {
+    return (at::_isnan(a) || a < b) ? a : b;
+  }
+  static inline C10_DEVICE scalar_t max_or_nan(scalar_t a, scalar_t b) {
+    return (at::_isnan(a) || a > b) ? a : b;
+  }
+
+  inline C10_DEVICE acc_t reduce(acc_t acc, scalar_t data, index_t idx) const {
+    auto welford = welford_ops_t{unbiased, false}.reduce(acc.welford, data, idx);
+    if (acc.welford.nf == 0) {
+      return {welford, data, data};
+    }
+    return {welford, min_or_nan(acc.min, data), max_or_nan(acc.max, data)};
+  }
+  inline C10_DEVICE acc_t combine(acc_t a, acc_t b) const {
+    if (a.welford.nf == 0) {
+      return b;
+    }
+    if (b.welford.nf == 0) {
+      return a;
+    }
+    return {
+      welford_ops_t{unbiased, false}.combine(a.welford, b.welford),
+      min_or_nan(a.min, b.min),
+      max_or_nan(a.max, b.max)
+    };
+  }
+  // (min, max, var, mean)
+  inline C10_DEVICE res_t project(acc_t acc) const {
+    auto var_mean = welford_ops_t{unbiased, false}.project(acc.welford);
+    res_t results;
+    results[0] = acc.min;
+    results[1] = acc.max;
+    results[2] = var_mean.first;
+    results[3] = var_mean.second;
+    return results;
+  }
+
+  static C10_DEVICE acc_t translate_idx(acc_t acc, int64_t /*base_idx*/) {
+    return acc;
+  }
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  inline __device__ acc_t warp_shfl_down(acc_t acc, int offset) const {
+    return {
+      welford_ops_t{unbiased, false}.warp_shfl_down(acc.welford, offset)
+      , WARP_SHFL_DOWN(acc.min, offset)
+      , WARP_SHFL_DOWN(acc.max, offset)
+    };
+  }
+#endif
+};
+
 }} // namespace at::native
 
 #undef MAX
@@ -1,6 +1,7 @@
 #include <ATen/ATen.h>
 #include <ATen/Config.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/detail/CUDAHooksInterface.h>
 #include <ATen/native/SpectralOpsUtils.h>
 #include <ATen/native/TensorIterator.h>
@@ -933,6 +934,137 @@ Tensor istft(const Tensor& self, const int64_t n_fft, const optional<int64_t> ho
       onesidedOpt, lengthOpt, /*return_complex=*/false);
 }
 
+namespace {
+
+// Frames per block of the CPU mel spectrogram, such that the windowed frames,
+// their spectrum and their power of a block stay in cache.
+constexpr int64_t kMelSpectrogramCpuBlockBytes = 256 * 1024;
+// Complex values of the spectrum of a block of the CUDA mel spectrogram,
+// large enough for the FFT and the projection to keep the device busy.
+constexpr int64_t kMelSpectrogramCudaBlockNumel = 1 << 24;
+
+// Projects the power spectrogram of frames, (..., n_frames, n_fft) windowed
+// by window_, on mel_basis_t, (n_freqs, n_mels), into out, (..., n_frames, n_mels).
+void mel_spectrogram_block(Tensor out, const Tensor& frames, const Tensor& window_,
+                           const Tensor& mel_basis_t, double power, fft_norm_mode norm) {
+  const auto windowed = window_.defined() ? frames.mul(window_) : frames;
+  const auto spectrum = at::_fft_r2c(windowed, windowed.dim() - 1, static_cast<int64_t>(norm), /*onesided=*/true);
+  auto power_spectrum = at::empty(spectrum.sizes(), windowed.options());
+  auto iter = TensorIteratorConfig()
+      .add_output(power_spectrum)
+      .add_input(spectrum)
+      .check_all_same_dtype(false)
+      .build();
+  spectrogram_power_stub(iter.device_type(), iter, power);
+  if (out.dim() == 2) {
+    at::mm_out(out, power_spectrum, mel_basis_t);
+  } else {
+    out.copy_(at::matmul(power_spectrum, mel_basis_t));
+  }
+}
+
+} // anonymous namespace
+
+/* Mel spectrogram, for audio front ends.
+ *
+ * Computes mel_basis @ |stft(self)|^power, with the framing, window and
+ * normalization of a onesided stft. Rather than materializing the complex
+ * spectrogram of the whole signal, blocks of frames are windowed, transformed,
+ * turned into power and projected on the mel basis while they are in cache
+ * (in parallel on the CPU).
+ *
+ * NOTE: as for stft, centering and padding the signal is left to the caller.
+ */
+Tensor _mel_spectrogram(const Tensor& self, const int64_t n_fft, const Tensor& mel_basis,
+                        const optional<int64_t> hop_lengthOpt, const optional<int64_t> win_lengthOpt,
+                        const Tensor& window, const double power, const bool normalized) {
+  TORCH_CHECK(at::isFloatingType(self.scalar_type()),
+              "_mel_spectrogram: expected a tensor of floating point values, but got ", self.scalar_type());
+  TORCH_CHECK(self.dim() == 1 || self.dim() == 2,
+              "_mel_spectrogram: expected a 1D or 2D tensor, but got a ", self.dim(), "D tensor");
+  TORCH_CHECK(!window.defined() || (window.device() == self.device() && window.scalar_type() == self.scalar_type()),
+              "_mel_spectrogram: expected window on the same device and with the same dtype as the input, but got ",
+              window.toString(), " on ", window.device(), " and ", self.toString(), " on ", self.device());
+  TORCH_CHECK(mel_basis.device() == self.device() && mel_basis.scalar_type() == self.scalar_type(),
+              "_mel_spectrogram: expected mel_basis on the same device and with the same dtype as the input, but got ",
+              mel_basis.toString(), " on ", mel_basis.device(), " and ", self.toString(), " on ", self.device());
+  TORCH_CHECK(power > 0, "_mel_spectrogram: expected power > 0, but got power=", power);
+
+  const auto hop_length = hop_lengthOpt.value_or(n_fft >> 2);
+  const auto win_length = win_lengthOpt.value_or(n_fft);
+  Tensor input = self.dim() == 1 ? self.unsqueeze(0) : self;
+  const int64_t batch = input.size(0);
+  const int64_t len = input.size(1);
+  TORCH_CHECK(n_fft > 0 && n_fft <= len,
+              "_mel_spectrogram: expected 0 < n_fft <= ", len, ", but got n_fft=", n_fft);
+  TORCH_CHECK(hop_length > 0, "_mel_spectrogram: expected hop_length > 0, but got hop_length=", hop_length);
+  TORCH_CHECK(win_length > 0 && win_length <= n_fft,
+              "_mel_spectrogram: expected 0 < win_length <= n_fft, but got win_length=", win_length);
+  TORCH_CHECK(!window.defined() || (window.dim() == 1 && window.size(0) == win_length),
+              "_mel_spectrogram: expected a 1D window tensor of size equal to win_length=",
+              win_length, ", but got window with size ", window.sizes());
+  const int64_t n_freqs = n_fft / 2 + 1;
+  TORCH_CHECK(mel_basis.dim() == 2 && mel_basis.size(1) == n_freqs,
+              "_mel_spectrogram: expected mel_basis of size (n_mels, n_fft / 2 + 1 = ", n_freqs,
+              "), but got mel_basis with size ", mel_basis.sizes());
+
+  auto window_ = window;
+  if (win_length < n_fft) {
+    // pad center
+    auto left = (n_fft - win_length) / 2;
+    window_ = at::zeros({n_fft}, self.options());
+    if (window.defined()) {
+      window_.narrow(0, left, win_length).copy_(window);
+    } else {
+      window_.narrow(0, left, win_length).fill_(1);
+    }
+  }
+
+  const int64_t n_mels = mel_basis.size(0);
+  const int64_t n_frames = 1 + (len - n_fft) / hop_length;
+  // time2col
+  const auto frames = input.as_strided(
+    {batch, n_frames, n_fft},
+    {input.stride(0), hop_length * input.stride(1), input.stride(1)}
+  );
+  const auto mel_basis_t = mel_basis.t();
+  const fft_norm_mode norm = normalized ? fft_norm_mode::by_root_n : fft_norm_mode::none;
+  // (batch x num_frames x n_mels), transposed as for stft before returning
+  auto out = at::empty({batch, n_frames, n_mels}, self.options());
+
+  if (self.device().is_cpu()) {
+    // Blocks of frames of each signal are independent tasks
+    const int64_t frame_bytes = n_fft * self.element_size() * 3;
+    const int64_t block = std::max<int64_t>(1, kMelSpectrogramCpuBlockBytes / frame_bytes);
+    const int64_t n_blocks = (n_frames + block - 1) / block;
+    at::parallel_for(0, batch * n_blocks, 1, [&](int64_t begin, int64_t end) {
+      // The worker threads don't inherit the dispatch state of the caller
+      at::AutoNonVariableTypeMode non_var_type_mode(true);
+      for (int64_t i = begin; i < end; ++i) {
+        const int64_t b = i / n_blocks;
+        const int64_t f0 = (i % n_blocks) * block;
+        const int64_t f = std::min(block, n_frames - f0);
+        mel_spectrogram_block(
+            out.select(0, b).narrow(0, f0, f), frames.select(0, b).narrow(0, f0, f),
+            window_, mel_basis_t, power, norm);
+      }
+    });
+  } else {
+    const int64_t block = std::max<int64_t>(1, kMelSpectrogramCudaBlockNumel / (batch * n_freqs));
+    for (int64_t f0 = 0; f0 < n_frames; f0 += block) {
+      const int64_t f = std::min(block, n_frames - f0);
+      mel_spectrogram_block(
+          out.narrow(1, f0, f), frames.narrow(1, f0, f), window_, mel_basis_t, power, norm);
+    }
+  }
+
+  out.transpose_(1, 2);
+  if (self.dim() == 1) {
+    out.squeeze_(0);
+  }
+  return out;
+}
+
 void _fft_fill_with_conjugate_symmetry_(const Tensor& input, IntArrayRef dim_) {
   const auto input_sizes = input.sizes();
   const auto input_strides = input.strides();
@@ -1025,5 +1157,6 @@ void _fft_fill_with_conjugate_symmetry_(const Tensor& input, IntArrayRef dim_) {
 }
 
 DEFINE_DISPATCH(fft_fill_with_conjugate_symmetry_stub);
+DEFINE_DISPATCH(spectrogram_power_stub);
 
 }} // at::native
@@ -5,7 +5,10 @@
 #include <sstream>
 #include <ATen/native/DispatchStub.h>
 
-namespace at { namespace native {
+namespace at {
+struct TensorIterator;
+
+namespace native {
 
 // Normalization types used in _fft_with_size
 enum class fft_norm_mode {
@@ -77,4 +80,9 @@ DECLARE_DISPATCH(fft_fill_with_conjugate_symmetry_fn, fft_fill_with_conjugate_sy
 // See NOTE [ Fourier Transform Conjugate Symmetry ]
 TORCH_API void _fft_fill_with_conjugate_symmetry_(const Tensor& self, IntArrayRef dims);
 
+// Computes |z|^power of the complex spectrogram input of iter into its real
+// output (the power spectrogram for power=2), see _mel_spectrogram.
+using spectrogram_power_fn = void (*)(TensorIterator& iter, double power);
+DECLARE_DISPATCH(spectrogram_power_fn, spectrogram_power_stub);
+
 }} // at::native
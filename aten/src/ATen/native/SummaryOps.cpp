@@ -2,8 +2,12 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 
+#include <cmath>
+#include <limits>
 #include <tuple>
+#include <vector>
 
 namespace at { namespace native {
 
@@ -65,4 +69,172 @@ _bincount_cpu(const Tensor& self, const Tensor& weights, int64_t minlength) {
   });
 }
 
+///////////////// histogram observer /////////////////
+namespace {
+
+// Adds the counts of the values of self in the nbins bins of [min, max] to
+// hist, the way torch.histc bins them. Every task counts a chunk of self into a
+// histogram of its own, which are added up at the end.
+template <typename scalar_t>
+void histc_accumulate_cpu(
+    const Tensor& self,
+    int64_t nbins,
+    scalar_t min,
+    scalar_t max,
+    float* hist) {
+  if (min == max) {
+    min = min - 1;
+    max = max + 1;
+  }
+  const scalar_t* self_p = self.data_ptr<scalar_t>();
+  const int64_t numel = self.numel();
+  const int64_t num_chunks = std::max<int64_t>(
+      1,
+      std::min<int64_t>(
+          at::get_num_threads(),
+          (numel + internal::GRAIN_SIZE - 1) / internal::GRAIN_SIZE));
+  const int64_t chunk_size = (numel + num_chunks - 1) / num_chunks;
+  std::vector<int64_t> counts(num_chunks * nbins, 0);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      int64_t* counts_p = counts.data() + c * nbins;
+      const int64_t i_end = std::min(numel, (c + 1) * chunk_size);
+      for (int64_t i = c * chunk_size; i < i_end; ++i) {
+        const scalar_t value = self_p[i];
+        if (value >= min && value <= max) {
+          const int64_t bin =
+              static_cast<int64_t>((value - min) / (max - min) * nbins);
+          counts_p[std::min(bin, nbins - 1)] += 1;
+        }
+      }
+    }
+  });
+  for (int64_t c = 0; c < num_chunks; ++c) {
+    for (int64_t b = 0; b < nbins; ++b) {
+      hist[b] += counts[c * nbins + b];
+    }
+  }
+}
+
+// Adds the histogram old_hist to hist, whose range is downsample_rate /
+// upsample_rate times as large. Every bin of old_hist is spread uniformly over
+// its upsample_rate cells of a grid of nbins * downsample_rate cells, starting
+// at the cell start_idx. A bin of hist sums downsample_rate cells.
+void add_rebinned_histogram_cpu(
+    const float* old_hist,
+    int64_t nbins,
+    int64_t upsample_rate,
+    int64_t downsample_rate,
+    int64_t start_idx,
+    float* hist) {
+  const int64_t old_begin = start_idx;
+  const int64_t old_end = start_idx + nbins * upsample_rate;
+  at::parallel_for(0, nbins, 256, [&](int64_t begin, int64_t end) {
+    for (int64_t k = begin; k < end; ++k) {
+      const int64_t cell_end = std::min((k + 1) * downsample_rate, old_end);
+      double acc = 0;
+      for (int64_t cell = std::max(k * downsample_rate, old_begin); cell < cell_end;) {
+        const int64_t b = (cell - old_begin) / upsample_rate;
+        const int64_t next_cell =
+            std::min(cell_end, old_begin + (b + 1) * upsample_rate);
+        acc += static_cast<double>(old_hist[b]) * (next_cell - cell);
+        cell = next_cell;
+      }
+      hist[k] += static_cast<float>(acc / upsample_rate);
+    }
+  });
+}
+
+} // namespace
+
+// See HistogramObserver.forward in torch/quantization/observer.py. The
+// histogram of self is made over the combined range of the old and new values,
+// which is widened so that the old histogram bins are a whole fraction
+// 1 / upsample_rate of the new ones then, and the old histogram is rebinned
+// into it.
+std::tuple<Tensor, Tensor, Tensor> _histogram_observer_update_cpu(
+    const Tensor& self,
+    const Tensor& histogram,
+    const Tensor& min_val,
+    const Tensor& max_val,
+    int64_t upsample_rate) {
+  TORCH_CHECK(
+      histogram.dim() == 1 && histogram.scalar_type() == kFloat,
+      "_histogram_observer_update: Expected a 1-D float histogram");
+  TORCH_CHECK(
+      min_val.numel() == 1 && max_val.numel() == 1,
+      "histogram min/max values must be scalar.");
+  TORCH_CHECK(
+      upsample_rate > 0,
+      "_histogram_observer_update: upsample_rate must be positive");
+  const int64_t nbins = histogram.size(0);
+  TORCH_CHECK(nbins > 0, "bins must be > 0");
+  const float old_min = min_val.item<float>();
+  const float old_max = max_val.item<float>();
+  if (self.numel() == 0) {
+    return std::make_tuple(histogram.clone(), min_val.clone(), max_val.clone());
+  }
+
+  const Tensor input = self.contiguous();
+  Tensor new_min_t, new_max_t;
+  std::tie(new_min_t, new_max_t) = at::_aminmax(input);
+  const float new_min = new_min_t.item<float>();
+  const float new_max = new_max_t.item<float>();
+  TORCH_CHECK(
+      !(std::isinf(new_min) || std::isinf(new_max) || std::isnan(new_min) ||
+        std::isnan(new_max)),
+      "range of [", new_min, ", ", new_max, "] is not finite");
+
+  Tensor new_histogram = at::zeros({nbins}, histogram.options());
+  float* hist_p = new_histogram.data_ptr<float>();
+  const bool is_uninitialized =
+      old_min == std::numeric_limits<float>::infinity() &&
+      old_max == -std::numeric_limits<float>::infinity();
+  if (is_uninitialized || old_min == old_max) {
+    AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "histogram_observer_cpu", [&] {
+      histc_accumulate_cpu<scalar_t>(input, nbins, new_min, new_max, hist_p);
+    });
+    return std::make_tuple(
+        new_histogram,
+        at::full_like(min_val, new_min),
+        at::full_like(max_val, new_max));
+  }
+
+  // The arithmetic is in float, as the min_val and max_val buffers are.
+  float combined_min = std::min(new_min, old_min);
+  float combined_max = std::max(new_max, old_max);
+  const float hist_bin_width =
+      (old_max - old_min) / static_cast<float>(nbins * upsample_rate);
+  const float bins_width = static_cast<float>(nbins) * hist_bin_width;
+  const int64_t downsample_rate = static_cast<int64_t>(
+      std::ceil((combined_max - combined_min) / bins_width));
+  // Relax only the max, not the min, so that for one sided distributions, min
+  // stays at zero.
+  combined_max += static_cast<float>(downsample_rate) * bins_width -
+      (combined_max - combined_min);
+  const int64_t start_idx = static_cast<int64_t>(
+      std::nearbyint((old_min - combined_min) / hist_bin_width));
+
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "histogram_observer_cpu", [&] {
+    histc_accumulate_cpu<scalar_t>(
+        input, nbins, combined_min, combined_max, hist_p);
+  });
+  const Tensor old_histogram = histogram.contiguous();
+  if (combined_min == old_min && combined_max == old_max) {
+    new_histogram.add_(old_histogram);
+  } else {
+    add_rebinned_histogram_cpu(
+        old_histogram.data_ptr<float>(),
+        nbins,
+        upsample_rate,
+        downsample_rate,
+        start_idx,
+        hist_p);
+  }
+  return std::make_tuple(
+      new_histogram,
+      at::full_like(min_val, combined_min),
+      at::full_like(max_val, combined_max));
+}
+
 }} // namespace at::native
@@ -50,6 +50,7 @@
 
 #include <ATen/native/TensorAdvancedIndexing.h>
 #include <ATen/native/IndexingUtils.h>
+#include <ATen/native/ScatterGatherChecks.h>
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
@@ -329,6 +330,238 @@ Tensor& index_out(Tensor& result, const Tensor & self, const torch::List<c10::op
   return result;
 }
 
+// Index segments
+//
+// Accumulating index_add_, scatter_add_ and index_put_(accumulate=True) in
+// parallel over the indices races on duplicate destinations, so the CPU
+// kernels used to run these serially. Instead, the positions of a 1-D index
+// can be grouped by destination, like the rows of a CSR matrix:
+//
+//   perm[offsets[s]], ..., perm[offsets[s + 1] - 1]
+//
+// are the positions i with index[i] == s, in increasing order. Every
+// destination is then reduced by a single thread, so there are no write
+// conflicts, and in the order of the serial loop, so the results are the same.
+// _index_segments exposes the grouping so that it can be reused by
+// _index_add_segments_ when the index does not change, e.g. for the edges of a
+// static graph.
+
+// Destinations are first distributed among at most this many buckets of
+// consecutive destinations, so that the histograms of all threads stay small
+// whatever the number of destinations.
+static constexpr int64_t kMaxIndexSegmentBuckets = 4096;
+
+// Stable counting sort of the index by destination. Negative indices count from
+// the end of the dimension if wrap_negative is true.
+static std::tuple<Tensor, Tensor> index_segments_cpu(
+    const Tensor& index, int64_t num_segments, int64_t dim, bool wrap_negative) {
+  TORCH_CHECK_INDEX(index.dim() <= 1, "index_segments(): Index is supposed to be a vector");
+  TORCH_CHECK(index.scalar_type() == ScalarType::Long || index.scalar_type() == ScalarType::Int,
+              "index_segments(): Expected dtype int32/int64 for index");
+  TORCH_CHECK(num_segments >= 0, "index_segments(): num_segments must be non-negative, got ", num_segments);
+  auto index_contig = index.contiguous();
+  const int64_t n = index.numel();
+  auto perm = at::empty({n}, index.options().dtype(kLong));
+  auto offsets = at::empty({num_segments + 1}, index.options().dtype(kLong));
+
+  AT_DISPATCH_INDEX_TYPES(index.scalar_type(), "index_segments_cpu", [&] {
+    const index_t* index_data = index_contig.data_ptr<index_t>();
+    int64_t* perm_data = perm.data_ptr<int64_t>();
+    int64_t* offsets_data = offsets.data_ptr<int64_t>();
+
+    // bucket b holds the destinations [b * bucket_width, (b + 1) * bucket_width)
+    const int64_t bucket_width = std::max<int64_t>(divup(num_segments, kMaxIndexSegmentBuckets), 1);
+    const int64_t num_buckets = divup(num_segments, bucket_width);
+    const int64_t num_chunks = std::max<int64_t>(
+        std::min<int64_t>(at::get_num_threads(), divup(n, internal::GRAIN_SIZE)), 1);
+    const int64_t chunk_size = divup(n, num_chunks);
+
+    std::vector<int64_t> dest(n);
+    std::vector<int64_t> bucket_pos(num_chunks * num_buckets, 0);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t chunk_begin, int64_t chunk_end) {
+      for (int64_t c = chunk_begin; c < chunk_end; ++c) {
+        int64_t* counts = bucket_pos.data() + c * num_buckets;
+        for (int64_t i = c * chunk_size; i < std::min(n, (c + 1) * chunk_size); ++i) {
+          int64_t d = index_data[i];
+          if (wrap_negative && d < 0) {
+            d += num_segments;
+          }
+          TORCH_CHECK_INDEX(d >= 0 && d < num_segments,
+              "index ", index_data[i], " is out of bounds for dimension ", dim,
+              " with size ", num_segments);
+          dest[i] = d;
+          counts[d / bucket_width]++;
+        }
+      }
+    });
+
+    // Bucket-major, chunk-minor exclusive scan: positions of a bucket keep
+    // their order across chunks.
+    std::vector<int64_t> bucket_begin(num_buckets + 1);
+    int64_t pos = 0;
+    for (int64_t b = 0; b < num_buckets; ++b) {
+      bucket_begin[b] = pos;
+      for (int64_t c = 0; c < num_chunks; ++c) {
+        const int64_t count = bucket_pos[c * num_buckets + b];
+        bucket_pos[c * num_buckets + b] = pos;
+        pos += count;
+      }
+    }
+    bucket_begin[num_buckets] = pos;
+
+    std::vector<int64_t> by_bucket(n);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t chunk_begin, int64_t chunk_end) {
+      for (int64_t c = chunk_begin; c < chunk_end; ++c) {
+        int64_t* cursors = bucket_pos.data() + c * num_buckets;
+        for (int64_t i = c * chunk_size; i < std::min(n, (c + 1) * chunk_size); ++i) {
+          by_bucket[cursors[dest[i] / bucket_width]++] = i;
+        }
+      }
+    });
+
+    // Every bucket is sorted by destination on its own.
+    at::parallel_for(0, num_buckets, 1, [&](int64_t b_begin, int64_t b_end) {
+      std::vector<int64_t> cursors(bucket_width + 1);
+      for (int64_t b = b_begin; b < b_end; ++b) {
+        const int64_t first = b * bucket_width;
+        const int64_t width = std::min(num_segments - first, bucket_width);
+        std::fill(cursors.begin(), cursors.end(), 0);
+        for (int64_t k = bucket_begin[b]; k < bucket_begin[b + 1]; ++k) {
+          cursors[dest[by_bucket[k]] - first + 1]++;
+        }
+        cursors[0] = bucket_begin[b];
+        for (int64_t j = 0; j < width; ++j) {
+          cursors[j + 1] += cursors[j];
+          offsets_data[first + j] = cursors[j];
+        }
+        for (int64_t k = bucket_begin[b]; k < bucket_begin[b + 1]; ++k) {
+          const int64_t i = by_bucket[k];
+          perm_data[cursors[dest[i] - first]++] = i;
+        }
+      }
+    });
+    offsets_data[num_segments] = n;
+  });
+  return std::make_tuple(perm, offsets);
+}
+
+// Adds source.select(dim, perm[k]) to self.select(dim, s) for every k in
+// [offsets[s], offsets[s + 1]).
+static void index_add_segments_cpu_impl(
+    Tensor& self, int64_t dim, const Tensor& perm, const Tensor& offsets, const Tensor& source) {
+  const int64_t num_segments = offsets.numel() - 1;
+  const int64_t n = perm.numel();
+  if (n == 0) {
+    return;
+  }
+  const int64_t* perm_data = perm.data_ptr<int64_t>();
+  const int64_t* offsets_data = offsets.data_ptr<int64_t>();
+  const int64_t source_dim_size = source.size(dim);
+  const int64_t slice_size = self.numel() / num_segments;
+  const int64_t grain_size = std::max<int64_t>(internal::GRAIN_SIZE / std::max<int64_t>(slice_size, 1), 1);
+
+  // Tasks split the sorted positions evenly. A task reduces the destinations
+  // whose segment starts in its range, whatever their length.
+  auto for_each_segment = [&](int64_t begin, int64_t end, const auto& f) {
+    const int64_t first = std::lower_bound(offsets_data, offsets_data + num_segments, begin) - offsets_data;
+    const int64_t last = std::lower_bound(offsets_data, offsets_data + num_segments, end) - offsets_data;
+    for (int64_t s = first; s < last; ++s) {
+      f(s);
+    }
+  };
+
+  if (self.dim() > 1) {
+    auto selfSlice = self.select(dim, 0);
+    auto sourceSlice = source.select(dim, 0);
+    auto self_stride_bytes = self.stride(dim) * elementSize(self.scalar_type());
+    auto source_stride_bytes = source.stride(dim) * elementSize(source.scalar_type());
+    auto iter = TensorIterator::binary_op(selfSlice, selfSlice, sourceSlice);
+    at::parallel_for(0, n, grain_size, [&](int64_t begin, int64_t end) {
+      TensorIterator it(iter);
+      for_each_segment(begin, end, [&](int64_t s) {
+        auto self_data = static_cast<char*>(selfSlice.data_ptr()) + s * self_stride_bytes;
+        for (int64_t k = offsets_data[s]; k < offsets_data[s + 1]; ++k) {
+          TORCH_CHECK_INDEX(perm_data[k] >= 0 && perm_data[k] < source_dim_size, "index out of range in source");
+          auto source_data = static_cast<char*>(sourceSlice.data_ptr()) + perm_data[k] * source_stride_bytes;
+          it.unsafe_replace_operand(0, self_data);
+          it.unsafe_replace_operand(1, self_data);
+          it.unsafe_replace_operand(2, source_data);
+          add_stub(it.device_type(), it, 1);
+        }
+      });
+    });
+  } else {
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(ScalarType::Half, ScalarType::BFloat16,
+        self.scalar_type(), "index_add_segments_cpu", [&] {
+      auto self_stride = self.stride(0);
+      auto source_stride = source.stride(0);
+      auto* self_ptr = self.data_ptr<scalar_t>();
+      auto* source_ptr = source.data_ptr<scalar_t>();
+      at::parallel_for(0, n, grain_size, [&](int64_t begin, int64_t end) {
+        for_each_segment(begin, end, [&](int64_t s) {
+          scalar_t sum = self_ptr[s * self_stride];
+          for (int64_t k = offsets_data[s]; k < offsets_data[s + 1]; ++k) {
+            TORCH_CHECK_INDEX(perm_data[k] >= 0 && perm_data[k] < source_dim_size, "index out of range in source");
+            sum += source_ptr[perm_data[k] * source_stride];
+          }
+          self_ptr[s * self_stride] = sum;
+        });
+      });
+    });
+  }
+}
+
+// Grouping the indices costs a pass over the index and over the destinations,
+// so it only pays off for many indices and when the destinations are not much
+// more than the accumulated elements.
+static bool use_index_segments(const Tensor& self, int64_t dim, int64_t num_indices) {
+  if (at::get_num_threads() <= 1 || self.dim() == 0 || self.scalar_type() == ScalarType::Bool ||
+      num_indices < internal::GRAIN_SIZE) {
+    return false;
+  }
+  const int64_t dim_size = self.size(dim);
+  return dim_size > 0 && dim_size <= num_indices * (self.numel() / dim_size);
+}
+
+std::tuple<Tensor, Tensor> _index_segments_cpu(const Tensor& index, int64_t num_segments) {
+  return index_segments_cpu(index, num_segments, /*dim=*/0, /*wrap_negative=*/false);
+}
+
+Tensor& _index_add_segments_cpu_(Tensor& self, int64_t dim, const Tensor& perm, const Tensor& offsets, const Tensor& source) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  TORCH_CHECK(self.dim() > 0 && self.dim() == source.dim(),
+              "_index_add_segments_(): self and source must have the same number of dimensions, got ",
+              self.dim(), " and ", source.dim());
+  TORCH_CHECK(self.scalar_type() == source.scalar_type(),
+              "_index_add_segments_(): self and source must have the same scalar type");
+  TORCH_CHECK(perm.scalar_type() == ScalarType::Long && offsets.scalar_type() == ScalarType::Long &&
+              perm.dim() == 1 && offsets.dim() == 1,
+              "_index_add_segments_(): Expected perm and offsets of dtype int64 and dimension 1, as returned by _index_segments");
+  TORCH_CHECK(offsets.numel() == self.size(dim) + 1,
+              "_index_add_segments_(): Expected offsets of size self.size(dim) + 1 = ", self.size(dim) + 1,
+              ", got ", offsets.numel());
+  TORCH_CHECK(perm.numel() == source.size(dim),
+              "_index_add_segments_(): Number of indices should be equal to source.size(dim)");
+  for (int64_t d = 0; d < self.dim(); ++d) {
+    TORCH_CHECK(d == dim || self.size(d) == source.size(d),
+                "_index_add_segments_(): Expected source of size ", self.sizes(),
+                " apart from dimension ", dim, ", got ", source.sizes());
+  }
+  at::assert_no_internal_overlap(self);
+  at::assert_no_overlap(self, perm);
+  at::assert_no_overlap(self, offsets);
+  at::assert_no_overlap(self, source);
+
+  auto perm_contig = perm.contiguous();
+  auto offsets_contig = offsets.contiguous();
+  const int64_t* offsets_data = offsets_contig.data_ptr<int64_t>();
+  TORCH_CHECK(offsets_data[0] == 0 && offsets_data[offsets.numel() - 1] == perm.numel() &&
+              std::is_sorted(offsets_data, offsets_data + offsets.numel()),
+              "_index_add_segments_(): offsets must be non-decreasing from 0 to perm.numel()");
+  index_add_segments_cpu_impl(self, dim, perm_contig, offsets_contig, source);
+  return self;
+}
+
 Tensor index_put(const Tensor & self, const torch::List<c10::optional<Tensor>>& indices, const Tensor & value, bool accumulate) {
   return self.clone(at::MemoryFormat::Preserve).index_put_(indices, value, accumulate);
 }
@@ -355,6 +588,21 @@ Tensor & _index_put_impl_(Tensor & self, const torch::List<c10::optional<Tensor>
       return self;
   }
 
+  if (accumulate && self.device().type() == kCPU && self.dim() > 0 && indices.size() == 1) {
+    const c10::optional<Tensor> index = indices.get(0);
+    if (index.has_value() && index->scalar_type() == ScalarType::Long && index->dim() == 1 &&
+        value.scalar_type() == self.scalar_type() && use_index_segments(self, 0, index->numel())) {
+      auto source_sizes = self.sizes().vec();
+      source_sizes[0] = index->numel();
+      if (is_expandable_to(value.sizes(), source_sizes)) {
+        Tensor perm, offsets;
+        std::tie(perm, offsets) = index_segments_cpu(*index, self.size(0), /*dim=*/0, /*wrap_negative=*/true);
+        index_add_segments_cpu_impl(self, 0, perm, offsets, value.expand(source_sizes));
+        return self;
+      }
+    }
+  }
+
   auto info = make_info(self, indices);
   auto iter = make_index_put_iterator(info, value);
   index_put_stub(iter.device_type(), iter, info.indexed_sizes, info.indexed_strides, accumulate);
@@ -434,6 +682,13 @@ Tensor& index_add_cpu_(Tensor & self, int64_t dim, const Tensor & index, const T
   at::assert_no_overlap(self, index);
   at::assert_no_overlap(self, source);
 
+  if (self.dim() > 0 && source.dim() == self.dim() && use_index_segments(self, dim, numel)) {
+    Tensor perm, offsets;
+    std::tie(perm, offsets) = index_segments_cpu(index, self.size(dim), dim, /*wrap_negative=*/false);
+    index_add_segments_cpu_impl(self, dim, perm, offsets, source);
+    return self;
+  }
+
   auto index_contig = index.contiguous();
 
   if (self.dim() > 1) {
@@ -900,6 +1155,33 @@ Tensor & scatter_add_(Tensor & self, int64_t dim, const Tensor & index, const Te
   at::assert_no_internal_overlap(self);
   at::assert_no_overlap(self, index);
   at::assert_no_overlap(self, src);
+  if (self.device().type() == kCPU && index.numel() > 0 && self.dim() > 0 && index.dim() == self.dim()) {
+    dim = maybe_wrap_dim(dim, self.dim());
+    scatter_gather_dtype_check("scatter_add_", self, index, src);
+    scatter_shape_check(self, dim, index, src);
+    // An index that is the same for all the positions outside of dim, e.g.
+    // index.unsqueeze(-1).expand_as(src) in message passing, is an index_add_
+    // of src into self.
+    bool index_is_1d = true;
+    for (int64_t d = 0; d < index.dim(); ++d) {
+      index_is_1d &= d == dim || index.size(d) == 1 || index.stride(d) == 0;
+    }
+    if (index_is_1d && use_index_segments(self, dim, index.size(dim))) {
+      auto self_part = self;
+      auto src_part = src.narrow(dim, 0, index.size(dim));
+      for (int64_t d = 0; d < index.dim(); ++d) {
+        if (d != dim) {
+          self_part = self_part.narrow(d, 0, index.size(d));
+          src_part = src_part.narrow(d, 0, index.size(d));
+        }
+      }
+      Tensor perm, offsets;
+      std::tie(perm, offsets) = index_segments_cpu(
+          index.as_strided({index.size(dim)}, {index.stride(dim)}), self.size(dim), dim, /*wrap_negative=*/false);
+      index_add_segments_cpu_impl(self_part, dim, perm, offsets, src_part);
+      return self;
+    }
+  }
   scatter_add_stub(self.device().type(), self, dim, index, src);
   return self;
 }
@@ -1199,6 +1481,67 @@ std::vector<Tensor> nonzero_numpy(const Tensor& self) {
   return self.nonzero().unbind(1);
 }
 
+// Note [Static size indexing]
+// nonzero, masked_select and indexing with a boolean mask return as many
+// elements as the mask selects, so on CUDA they wait for the count to be copied
+// to the host to allocate their output. nonzero_static and masked_select_static
+// instead return max_size rows, the ones after the count being zeros, and the
+// count as a 0-dim tensor on the device of the input. The count is the number
+// of elements selected, which is more than max_size when some are dropped.
+// index_static takes the indices and count returned by nonzero_static, and
+// returns the rows of self[mask] zero-padded to max_size, so that a chain of
+// these ops never synchronizes and can be captured in a CUDA graph.
+std::tuple<Tensor, Tensor> nonzero_static_cpu(const Tensor& self, int64_t max_size) {
+  TORCH_CHECK(max_size >= 0, "nonzero_static: max_size must be non-negative, but got ", max_size);
+  Tensor nonzeros = at::nonzero(self);
+  const int64_t count = nonzeros.size(0);
+  Tensor indices = at::zeros({max_size, nonzeros.size(1)}, nonzeros.options());
+  const int64_t kept = std::min(count, max_size);
+  indices.narrow(0, 0, kept).copy_(nonzeros.narrow(0, 0, kept));
+  return std::make_tuple(indices, at::scalar_tensor(count, nonzeros.options()));
+}
+
+Tensor index_static(const Tensor& self, const Tensor& indices, const Tensor& count) {
+  TORCH_CHECK(indices.dim() == 2 && indices.scalar_type() == kLong,
+      "index_static: expected indices to be a 2-D Long tensor, but got a ", indices.dim(),
+      "-D ", indices.scalar_type(), " tensor");
+  TORCH_CHECK(indices.size(1) <= self.dim(),
+      "index_static: indices index ", indices.size(1), " dims of a ", self.dim(), "-D tensor");
+  TORCH_CHECK(count.numel() == 1, "index_static: expected count to have one element, but it has ", count.numel());
+  const int64_t max_size = indices.size(0);
+  const int64_t indexed_dims = indices.size(1);
+  std::vector<int64_t> result_sizes{max_size};
+  result_sizes.insert(result_sizes.end(), self.sizes().begin() + indexed_dims, self.sizes().end());
+  if (self.numel() == 0) {
+    // The indices are all padding
+    return at::zeros(result_sizes, self.options());
+  }
+  Tensor values;
+  if (indexed_dims == 0) {
+    values = self.unsqueeze(0).expand(result_sizes);
+  } else {
+    c10::List<c10::optional<Tensor>> index_list;
+    for (const auto& index : indices.unbind(1)) {
+      index_list.push_back(index);
+    }
+    values = at::index(self, index_list);
+  }
+  std::vector<int64_t> padding_sizes(result_sizes.size(), 1);
+  padding_sizes[0] = max_size;
+  Tensor padding = at::arange(max_size, indices.options()).ge(count.reshape({})).view(padding_sizes);
+  return values.masked_fill(padding, 0);
+}
+
+std::tuple<Tensor, Tensor> masked_select_static(const Tensor& self, const Tensor& mask, int64_t max_size) {
+  TORCH_CHECK(mask.scalar_type() == ScalarType::Bool,
+      "masked_select_static: expected mask to be a Bool tensor, but got ", mask.scalar_type());
+  Tensor b_self, b_mask;
+  std::tie(b_self, b_mask) = expand_outplace(self, mask, "masked_select_static");
+  Tensor indices, count;
+  std::tie(indices, count) = at::nonzero_static(b_mask.reshape(-1), max_size);
+  return std::make_tuple(at::index_static(b_self.reshape(-1), indices, count), count);
+}
+
 Tensor & masked_scatter__cpu(Tensor& self, const Tensor & mask, const Tensor & source) {
   at::assert_no_internal_overlap(self);
   TORCH_CHECK(
@@ -105,6 +105,8 @@ Tensor to_dense_backward(const Tensor& grad, const Tensor& input_) {
   if (input_.layout() == c10::kSparse) {
     auto input = input_.coalesce();
     return grad.sparse_mask(input);
+  } else if (input_.layout() == c10::kSparseCsr) {
+    return grad.sparse_mask(input_.to_sparse()).to_sparse_csr();
   } else if (input_.layout() == c10::kMkldnn) {
     return grad.to_mkldnn(input_.scalar_type());
   } else {
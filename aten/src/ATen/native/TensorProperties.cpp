@@ -2,6 +2,7 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/detail/CUDAHooksInterface.h>
 #include <ATen/NamedTensorUtils.h>
+#include <ATen/core/Vitals.h>
 #include <torch/library.h>
 
 #include <ATen/Config.h>
@@ -71,6 +72,7 @@ Tensor contiguous(const Tensor& self, MemoryFormat memory_format) {
       memory_format != MemoryFormat::Preserve,
       "preserve memory format is unsupported by the contiguous operator");
 
+  TORCH_SLOW_PATH(NON_CONTIGUOUS_COPY);
   auto result = at::empty_like(self, self.options(), memory_format);
   return result.copy_(self);
 }
@@ -24,7 +24,7 @@
 namespace at {
 namespace native {
 
-DEFINE_DISPATCH(cat_serial_stub);
+DEFINE_DISPATCH(cat_contig_stub);
 DEFINE_DISPATCH(stack_serial_stub);
 
 Tensor _reshape_from_tensor(const Tensor& self, const Tensor& shape_tensor) {
@@ -164,8 +164,6 @@ Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
   for (size_t i = 0; i < tensors.size(); i++) {
     auto const &tensor = tensors[i];
     if (should_skip(tensor)) {
-      // don't use fast path for empty tensor
-      allContiguous = false;
       continue;
     }
     check_cat_shape_except_dim(notSkippedTensor, tensor, dim, i);
@@ -196,12 +194,18 @@ Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
     return result;
   }
 
-  // fast path for single thread when both inputs and result are contiguous and not empty
+  // fast path when both inputs and result are contiguous in the same memory
+  // format: all inputs are copied by one parallel loop over the result
   allContiguous = allContiguous && result.is_contiguous(first_tensor_mem_format);
-  bool use_serial_kernel = result.numel() < at::internal::GRAIN_SIZE || at::get_num_threads() == 1;
-  ScalarType dtype = notSkippedTensor.scalar_type();
-  if (use_serial_kernel && allContiguous && no_type_promotion && (dtype == ScalarType::Double || dtype == ScalarType::Float)) {
-    cat_serial_stub(kCPU, result, tensors, dim);
+  if (allContiguous) {
+    for (auto const &tensor : tensors) {
+      if (!should_skip(tensor) && tensor.dtype() != result.dtype()) {
+        TORCH_CHECK(canCast(tensor.scalar_type(), result.scalar_type()),
+                    "result type ", tensor.scalar_type(), " can't be cast to the "
+                    "desired output type ", result.scalar_type());
+      }
+    }
+    cat_contig_stub(kCPU, result, tensors, dim, first_tensor_mem_format);
     return result;
   }
 
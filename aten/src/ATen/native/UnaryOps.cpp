@@ -13,6 +13,9 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/native/ComplexHelper.h>
+#if defined(C10_MOBILE) && defined(USE_XNNPACK)
+#include <ATen/native/xnnpack/Engine.h>
+#endif
 
 #include <algorithm>
 #include <cmath>
@@ -401,7 +404,14 @@ Tensor square(const Tensor& self) { return at::pow(self, 2); }
 Tensor& square_(Tensor& self) { return at::pow_out(self, self, 2); }
 
 Tensor& sigmoid_out(Tensor& result, const Tensor& self) { return unary_op_impl_float_out(result, self, sigmoid_stub);  }
-Tensor sigmoid(const Tensor& self) { return unary_op_impl_float(self, sigmoid_stub);  }
+Tensor sigmoid(const Tensor& self) {
+#if defined(C10_MOBILE) && defined(USE_XNNPACK)
+  if (xnnpack::use_sigmoid(self)) {
+    return xnnpack::sigmoid(self);
+  }
+#endif
+  return unary_op_impl_float(self, sigmoid_stub);
+}
 Tensor& sigmoid_(Tensor& self) { return unary_op_impl_(self, at::sigmoid_out);  }
 
 Tensor& logit_out(
@@ -80,6 +80,9 @@ DECLARE_DISPATCH(void(*)(TensorIterator&, Scalar a, Scalar b), clamp_stub);
 DECLARE_DISPATCH(
     void (*)(Tensor&, const Tensor&, int64_t, c10::optional<Generator>),
     multinomial_with_replacement_stub);
+DECLARE_DISPATCH(
+    void (*)(Tensor&, const Tensor&, int64_t, double, c10::optional<Generator>),
+    sample_top_k_top_p_stub);
 DECLARE_DISPATCH(
     void (*)(
         TensorIterator&,
@@ -25,4 +25,27 @@ using unfold2d_fn =
 DECLARE_DISPATCH(unfold2d_fn, unfolded2d_copy_stub);
 DECLARE_DISPATCH(unfold2d_fn, unfolded2d_acc_stub);
 
+// unfolded2d_copy of the output rows [output_row_begin, output_row_begin +
+// output_rows) only, into a (n_input_plane * kH * kW, output_rows * output_width)
+// finput
+using unfold2d_rows_fn =
+    void (*)(
+    Tensor& finput,
+    Tensor& input,
+    int64_t kH,
+    int64_t kW,
+    int64_t dH,
+    int64_t dW,
+    int64_t padH,
+    int64_t padW,
+    int64_t n_input_plane,
+    int64_t input_height,
+    int64_t input_width,
+    int64_t output_row_begin,
+    int64_t output_rows,
+    int64_t output_width
+);
+
+DECLARE_DISPATCH(unfold2d_rows_fn, unfolded2d_copy_rows_stub);
+
 }} // namespace at::native
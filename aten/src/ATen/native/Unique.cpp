@@ -2,125 +2,388 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/NumericUtils.h>
+#include <ATen/Parallel.h>
 
-#include <set>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <numeric>
 #include <tuple>
-#include <unordered_map>
-#include <unordered_set>
+#include <type_traits>
+#include <vector>
 
 namespace at {
 namespace native{
 
 namespace {
 
+// Note [CPU unique]
+// unique splits its input into chunks, one per thread, each deduplicated with
+// an open addressing hash table of its own, which keeps the unique elements of
+// the chunk in the order they first appear. The unique elements of the chunks
+// are then inserted in order into one table, so that the output also keeps the
+// order of the first appearances, and the ids of the chunks are mapped to the
+// ids of the output in parallel. The hashes of blocks of elements are
+// computed before probing the table with them, in a loop which vectorizes.
+//
+// When the output is sorted and most of the elements are unique, as estimated
+// from a sample of the input, the hash tables barely reduce the number of
+// elements sorted afterwards, and the input is sorted directly (with the
+// parallel radix sort of the sort kernel) and split into runs of equal
+// elements in parallel, like unique_consecutive.
+//
+// NaNs are all different, and -0.0 is the same as 0.0.
+constexpr int64_t kUniqueGrainSize = 1 << 15;
+constexpr int64_t kUniqueHashBlockSize = 256;
+constexpr int64_t kUniqueSampleSize = 4096;
+constexpr int64_t kUniqueSortMinSize = 1 << 16;
+constexpr double kUniqueSortMinDistinctFraction = 0.5;
+constexpr uint64_t kUniqueHashMultiplier = 0x9e3779b97f4a7c15ULL;
+
+// The hash of a value, the same for values which compare equal
 template <typename scalar_t>
-std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
-    const Tensor& self,
-    const bool sorted,
-    const bool return_inverse,
-    const bool return_counts) {
-  const Tensor& input = self.contiguous();
-  const scalar_t* input_data = input.data_ptr<scalar_t>();
-  int64_t numel = input.numel();
-  Tensor output;
-  Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
-  Tensor counts = at::empty({0}, self.options().dtype(kLong));
+inline uint64_t unique_hash(scalar_t value) {
+  uint64_t bits = 0;
+  if (!(std::is_floating_point<scalar_t>::value && value == 0)) {
+    std::memcpy(&bits, &value, sizeof(scalar_t));
+  }
+  return bits * kUniqueHashMultiplier;
+}
 
-  std::unordered_set<scalar_t> set(input_data, input_data + numel);
-  output = at::empty({static_cast<int64_t>(set.size())}, input.options());
-  scalar_t *output_data = output.data_ptr<scalar_t>();
+template <typename scalar_t>
+class UniqueHashTable {
+ public:
+  explicit UniqueHashTable(int64_t expected_size) {
+    resize(expected_size);
+  }
 
-  if (sorted) {
-    std::vector<scalar_t> vec(set.begin(), set.end());
-    std::sort(vec.begin(), vec.end());
-    std::copy(vec.begin(), vec.end(), output_data);
-  } else {
-    std::copy(set.begin(), set.end(), output_data);
+  // Returns the id of value, the number of values inserted before it if it's
+  // new
+  int64_t insert(scalar_t value, uint64_t hash) {
+    if (_isnan(value)) {
+      values_.push_back(value);
+      return values_.size() - 1;
+    }
+    for (uint64_t slot = hash >> shift_;; slot = (slot + 1) & mask_) {
+      const int64_t id = ids_[slot];
+      if (id < 0) {
+        const int64_t new_id = values_.size();
+        ids_[slot] = new_id;
+        keys_[slot] = value;
+        values_.push_back(value);
+        if (2 * values_.size() > ids_.size()) {
+          resize(values_.size());
+        }
+        return new_id;
+      }
+      if (keys_[slot] == value) {
+        return id;
+      }
+    }
   }
 
-  if (return_inverse || return_counts) {
-    inverse_indices.resize_(input.sizes());
-    int64_t* inverse_indices_data = inverse_indices.data_ptr<int64_t>();
-    std::unordered_map<scalar_t, int64_t> inverse_map;
-    inverse_map.reserve(output.numel());
-    for (int64_t i = 0; i < output.numel(); ++i) {
-      inverse_map[output_data[i]] = i;
+  // The values inserted, in the order of their ids
+  const std::vector<scalar_t>& values() const {
+    return values_;
+  }
+
+ private:
+  // Makes room for twice size values
+  void resize(int64_t size) {
+    int log_capacity = 4;
+    while ((int64_t(1) << log_capacity) < 4 * size) {
+      ++log_capacity;
     }
-    for(int64_t i = 0; i < numel; ++i) {
-      inverse_indices_data[i] = inverse_map[input_data[i]];
+    shift_ = 64 - log_capacity;
+    mask_ = (uint64_t(1) << log_capacity) - 1;
+    ids_.assign(mask_ + 1, -1);
+    keys_.resize(mask_ + 1);
+    for (size_t id = 0; id < values_.size(); ++id) {
+      const scalar_t value = values_[id];
+      if (_isnan(value)) {
+        continue;
+      }
+      uint64_t slot = unique_hash(value) >> shift_;
+      while (ids_[slot] >= 0) {
+        slot = (slot + 1) & mask_;
+      }
+      ids_[slot] = id;
+      keys_[slot] = value;
     }
-    if (return_counts) {
-      std::unordered_map<scalar_t, int64_t> counts_map;
-      counts_map.reserve(output.numel());
-      for (int64_t i = 0; i < output.numel(); ++i) {
-        counts_map[output_data[i]] = 0;
+  }
+
+  int shift_;
+  uint64_t mask_;
+  std::vector<int64_t> ids_;
+  std::vector<scalar_t> keys_;
+  std::vector<scalar_t> values_;
+};
+
+// Inserts data[0, n) into table, writing the id of every element to ids and
+// counting the elements of every id in counts, if they aren't null
+template <typename scalar_t, typename data_t>
+void unique_hash_insert(
+    UniqueHashTable<scalar_t>& table,
+    const data_t& data,
+    int64_t n,
+    int64_t* ids,
+    std::vector<int64_t>* counts) {
+  uint64_t hashes[kUniqueHashBlockSize];
+  for (int64_t begin = 0; begin < n; begin += kUniqueHashBlockSize) {
+    const int64_t size = std::min(kUniqueHashBlockSize, n - begin);
+    for (int64_t i = 0; i < size; ++i) {
+      hashes[i] = unique_hash(data[begin + i]);
+    }
+    for (int64_t i = 0; i < size; ++i) {
+      const int64_t id = table.insert(data[begin + i], hashes[i]);
+      if (ids) {
+        ids[begin + i] = id;
       }
-      for(int64_t i = 0; i < numel; i++) {
-        counts_map[input_data[i]] += 1;
+      if (counts) {
+        if (id == static_cast<int64_t>(counts->size())) {
+          counts->push_back(1);
+        } else {
+          (*counts)[id]++;
+        }
       }
-      counts.resize_(output.sizes());
-      counts.fill_(0);
-      int64_t *counts_data = counts.data_ptr<int64_t>();
-      for(int64_t i = 0; i < output.numel(); i++) {
-        counts_data[i] = counts_map[output_data[i]];
+    }
+  }
+}
+
+// The fraction of the elements of a strided sample of data[0, n) which are
+// unique
+template <typename scalar_t>
+double estimate_distinct_fraction(const scalar_t* data, int64_t n) {
+  const int64_t sample_size = std::min(n, kUniqueSampleSize);
+  if (sample_size == 0) {
+    return 0;
+  }
+  const int64_t stride = n / sample_size;
+  UniqueHashTable<scalar_t> table(sample_size);
+  for (int64_t i = 0; i < sample_size; ++i) {
+    const scalar_t value = data[i * stride];
+    table.insert(value, unique_hash(value));
+  }
+  return static_cast<double>(table.values().size()) / sample_size;
+}
+
+// Splits data[0, n) into runs of equal elements, returning the first element
+// of every run, the run of every element (of element perm[i] for data[i] if
+// perm isn't null), reshaped to inverse_sizes, and the length of every run.
+template <typename scalar_t>
+std::tuple<Tensor, Tensor, Tensor> unique_consecutive_runs(
+    const Tensor& input,
+    const scalar_t* data,
+    int64_t n,
+    const int64_t* perm,
+    const bool return_inverse,
+    const bool return_counts) {
+  Tensor inverse_indices = at::empty({0}, input.options().dtype(kLong));
+  Tensor counts = at::empty({0}, input.options().dtype(kLong));
+  if (return_inverse) {
+    inverse_indices.resize_(input.sizes());
+  }
+  if (n == 0) {
+    return std::make_tuple(at::empty({0}, input.options()), inverse_indices, counts);
+  }
+
+  const int64_t num_chunks = std::max<int64_t>(1,
+      std::min<int64_t>(at::get_num_threads(), n / kUniqueGrainSize));
+  const int64_t chunk_size = divup(n, num_chunks);
+  // The number of runs starting in every chunk, then the first run of every
+  // chunk
+  std::vector<int64_t> chunk_runs(num_chunks + 1, 0);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      const int64_t chunk_end = std::min(n, (c + 1) * chunk_size);
+      int64_t runs = 0;
+      for (int64_t i = c * chunk_size; i < chunk_end; ++i) {
+        runs += i == 0 || data[i] != data[i - 1];
+      }
+      chunk_runs[c + 1] = runs;
+    }
+  });
+  std::partial_sum(chunk_runs.begin(), chunk_runs.end(), chunk_runs.begin());
+  const int64_t num_runs = chunk_runs[num_chunks];
+
+  Tensor output = at::empty({num_runs}, input.options());
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  int64_t* inverse_data = return_inverse ? inverse_indices.data_ptr<int64_t>() : nullptr;
+  std::vector<int64_t> run_starts(return_counts ? num_runs + 1 : 0);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      const int64_t chunk_end = std::min(n, (c + 1) * chunk_size);
+      int64_t run = chunk_runs[c] - 1;
+      for (int64_t i = c * chunk_size; i < chunk_end; ++i) {
+        if (i == 0 || data[i] != data[i - 1]) {
+          output_data[++run] = data[i];
+          if (return_counts) {
+            run_starts[run] = i;
+          }
+        }
+        if (return_inverse) {
+          inverse_data[perm ? perm[i] : i] = run;
+        }
       }
     }
+  });
+
+  if (return_counts) {
+    run_starts[num_runs] = n;
+    counts.resize_({num_runs});
+    int64_t* counts_data = counts.data_ptr<int64_t>();
+    at::parallel_for(0, num_runs, kUniqueGrainSize, [&](int64_t begin, int64_t end) {
+      for (int64_t r = begin; r < end; ++r) {
+        counts_data[r] = run_starts[r + 1] - run_starts[r];
+      }
+    });
   }
   return std::make_tuple(output, inverse_indices, counts);
 }
 
 template <typename scalar_t>
-std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
+std::tuple<Tensor, Tensor, Tensor> unique_cpu_sort_template(
+    const Tensor& input,
+    const bool return_inverse,
+    const bool return_counts) {
+  Tensor sorted, perm;
+  std::tie(sorted, perm) = input.reshape(-1).sort();
+  return unique_consecutive_runs(
+      input, sorted.data_ptr<scalar_t>(), sorted.numel(),
+      perm.data_ptr<int64_t>(), return_inverse, return_counts);
+}
+
+template <typename scalar_t>
+std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
     const Tensor& self,
+    const bool sorted,
     const bool return_inverse,
     const bool return_counts) {
   const Tensor& input = self.contiguous();
   const scalar_t* input_data = input.data_ptr<scalar_t>();
   int64_t numel = input.numel();
-  Tensor output = at::empty({numel}, input.options());
   Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
   Tensor counts = at::empty({0}, self.options().dtype(kLong));
 
+  const double distinct_fraction = estimate_distinct_fraction(input_data, numel);
+  if (sorted && numel >= kUniqueSortMinSize &&
+      distinct_fraction > kUniqueSortMinDistinctFraction &&
+      !std::is_same<scalar_t, bool>::value) {
+    return unique_cpu_sort_template<scalar_t>(input, return_inverse, return_counts);
+  }
+
   if (return_inverse) {
     inverse_indices.resize_(input.sizes());
   }
+  int64_t* inverse_data = return_inverse ? inverse_indices.data_ptr<int64_t>() : nullptr;
+
+  // Deduplicate every chunk, see Note [CPU unique]
+  const int64_t num_chunks = std::max<int64_t>(1,
+      std::min<int64_t>(at::get_num_threads(), numel / kUniqueGrainSize));
+  const int64_t chunk_size = numel == 0 ? 0 : divup(numel, num_chunks);
+  const int64_t expected_chunk_unique = std::min(chunk_size,
+      static_cast<int64_t>(distinct_fraction * chunk_size) + 16);
+  std::vector<std::unique_ptr<UniqueHashTable<scalar_t>>> chunk_tables(num_chunks);
+  std::vector<std::vector<int64_t>> chunk_counts(num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      const int64_t chunk_begin = std::min(numel, c * chunk_size);
+      const int64_t chunk_end = std::min(numel, chunk_begin + chunk_size);
+      chunk_tables[c] = std::make_unique<UniqueHashTable<scalar_t>>(expected_chunk_unique);
+      unique_hash_insert(
+          *chunk_tables[c], input_data + chunk_begin, chunk_end - chunk_begin,
+          inverse_data ? inverse_data + chunk_begin : nullptr,
+          return_counts ? &chunk_counts[c] : nullptr);
+    }
+  });
 
-  if (numel > 0) {
-    scalar_t *output_data = output.data_ptr<scalar_t>();
-    int64_t *inverse_data = inverse_indices.data_ptr<int64_t>();;
-    int64_t *counts_data = nullptr;
-    *output_data = *input_data;
-
-    if (return_counts) {
-      counts.resize_({numel});
-      counts_data = counts.data_ptr<int64_t>();
+  // Merge the chunks in order, mapping the ids of every chunk to the ids of
+  // the output
+  std::unique_ptr<UniqueHashTable<scalar_t>> merged;
+  std::vector<int64_t> merged_counts;
+  std::vector<std::vector<int64_t>> chunk_ids(num_chunks);
+  if (num_chunks == 1) {
+    merged = std::move(chunk_tables[0]);
+    merged_counts = std::move(chunk_counts[0]);
+  } else {
+    int64_t total_chunk_unique = 0;
+    for (const auto& table : chunk_tables) {
+      total_chunk_unique += table->values().size();
     }
-    scalar_t *p = output_data;
-    int64_t *q = counts_data;
-    int64_t last = 0;
-    for (int64_t i = 0; i < numel; i++) {
-      if (input_data[i] != *p) {
-        *(++p) = input_data[i];
-        if (return_counts) {
-          *(q++) = i - last;
-          last = i;
+    merged = std::make_unique<UniqueHashTable<scalar_t>>(
+        std::min(total_chunk_unique, 2 * expected_chunk_unique));
+    for (int64_t c = 0; c < num_chunks; ++c) {
+      const auto& values = chunk_tables[c]->values();
+      chunk_ids[c].resize(values.size());
+      unique_hash_insert(
+          *merged, values, values.size(), chunk_ids[c].data(), nullptr);
+      if (return_counts) {
+        merged_counts.resize(merged->values().size(), 0);
+        for (size_t i = 0; i < values.size(); ++i) {
+          merged_counts[chunk_ids[c][i]] += chunk_counts[c][i];
         }
       }
-      if (return_inverse) {
-        inverse_data[i] = p - output_data;
-      }
+      chunk_tables[c].reset();
     }
-    int64_t output_size = p - output_data + 1;
+  }
+  const auto& values = merged->values();
+  const int64_t num_unique = values.size();
+
+  // The position of every id in the output
+  std::vector<int64_t> order;
+  if (sorted) {
+    order.resize(num_unique);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+      // NaNs last, like sort
+      return (!_isnan(values[a]) && _isnan(values[b])) || values[a] < values[b];
+    });
+  }
+  Tensor output = at::empty({num_unique}, input.options());
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  if (return_counts) {
+    counts.resize_({num_unique});
+  }
+  int64_t* counts_data = return_counts ? counts.data_ptr<int64_t>() : nullptr;
+  std::vector<int64_t> rank(sorted ? num_unique : 0);
+  for (int64_t i = 0; i < num_unique; ++i) {
+    const int64_t id = sorted ? order[i] : i;
+    output_data[i] = values[id];
     if (return_counts) {
-      *q = numel - last;
-      counts.resize_({output_size});
+      counts_data[i] = merged_counts[id];
+    }
+    if (sorted) {
+      rank[id] = i;
     }
-    output.resize_({output_size});
   }
 
+  if (return_inverse && (num_chunks > 1 || sorted)) {
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; ++c) {
+        const int64_t chunk_begin = std::min(numel, c * chunk_size);
+        const int64_t chunk_end = std::min(numel, chunk_begin + chunk_size);
+        for (int64_t i = chunk_begin; i < chunk_end; ++i) {
+          int64_t id = num_chunks > 1 ? chunk_ids[c][inverse_data[i]] : inverse_data[i];
+          inverse_data[i] = sorted ? rank[id] : id;
+        }
+      }
+    });
+  }
   return std::make_tuple(output, inverse_indices, counts);
 }
 
+template <typename scalar_t>
+std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
+    const Tensor& self,
+    const bool return_inverse,
+    const bool return_counts) {
+  const Tensor& input = self.contiguous();
+  return unique_consecutive_runs(
+      input, input.data_ptr<scalar_t>(), input.numel(), nullptr,
+      return_inverse, return_counts);
+}
+
 template<class ForwardIt>
 ForwardIt _unique_dim_cpu_impl(ForwardIt first, ForwardIt last,
   std::vector<int64_t>& indices, Tensor inverse_indices_vec, Tensor counts) {
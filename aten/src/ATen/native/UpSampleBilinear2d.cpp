@@ -4,6 +4,9 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/UpSample.h>
+#if defined(C10_MOBILE) && defined(USE_XNNPACK)
+#include <ATen/native/xnnpack/Engine.h>
+#endif
 
 namespace at {
 namespace native {
@@ -109,6 +112,11 @@ Tensor upsample_bilinear2d_cpu(
     bool align_corners,
     c10::optional<double> scales_h,
     c10::optional<double> scales_w) {
+#if defined(C10_MOBILE) && defined(USE_XNNPACK)
+  if (xnnpack::use_upsample_bilinear2d(input, output_size, align_corners, scales_h, scales_w)) {
+    return xnnpack::upsample_bilinear2d(input, output_size, align_corners);
+  }
+#endif
   auto output = at::empty({0}, input.options());
   upsample_bilinear2d_out_cpu_template(
       output, input, output_size, align_corners, scales_h, scales_w);
@@ -153,6 +161,11 @@ Tensor upsample_bilinear2d_cpu(
   auto osize = compute_output_size(input.sizes(), output_size, scale_factors);
   auto scale_h = get_scale_value(scale_factors, 0);
   auto scale_w = get_scale_value(scale_factors, 1);
+#if defined(C10_MOBILE) && defined(USE_XNNPACK)
+  if (xnnpack::use_upsample_bilinear2d(input, osize, align_corners, scale_h, scale_w)) {
+    return xnnpack::upsample_bilinear2d(input, osize, align_corners);
+  }
+#endif
   upsample_bilinear2d_out_cpu_template(output, input, osize, align_corners, scale_h, scale_w);
   return output;
 }
@@ -12,6 +12,24 @@ using batch_norm_fn = void (*)(Tensor&, const Tensor&, const Tensor&,
 
 DECLARE_DISPATCH(batch_norm_fn, batch_norm_cpu_inference_contiguous_stub);
 
+// The blocked training kernels take inputs that are either contiguous or
+// channels last contiguous, and outputs of the same memory format.
+
+// Stores the mean and the biased variance of every channel of input
+using batch_norm_collect_stats_fn = void (*)(Tensor& mean, Tensor& var, const Tensor& input);
+// output = input * alpha + beta, alpha and beta having an element per channel
+using batch_norm_transform_fn = void (*)(Tensor& output, const Tensor& input,
+    const Tensor& alpha, const Tensor& beta);
+// Stores the sums over every channel of grad_output and of
+// grad_output * (input - mean), and grad_input if it is defined
+using batch_norm_backward_fn = void (*)(Tensor& grad_input, Tensor& sum_dy, Tensor& sum_dy_xmu,
+    const Tensor& grad_output, const Tensor& input, const Tensor& weight /* optional */,
+    const Tensor& mean, const Tensor& invstd);
+
+DECLARE_DISPATCH(batch_norm_collect_stats_fn, batch_norm_cpu_collect_stats_stub);
+DECLARE_DISPATCH(batch_norm_transform_fn, batch_norm_cpu_transform_stub);
+DECLARE_DISPATCH(batch_norm_backward_fn, batch_norm_cpu_backward_stub);
+
 } // namespace native
 
 } // namespace at
@@ -6,6 +6,8 @@
 #include <ATen/cpu/vec256/vec256.h>
 #include <ATen/native/cpu/utils.h>
 
+#include <memory>
+
 namespace at { namespace native {
 
 namespace {
@@ -29,6 +31,7 @@ void cpu_adaptive_avg_pool(
   int64_t output_height = output_size[0];
   int64_t output_width = output_size[1];
 
+  using acc_t = typename vec_acc_type<scalar_t>::type;
   // parallel on dim of N, C
   at::parallel_for(0, channels, 0, [&](int64_t begin, int64_t end) {
     for (int64_t c = begin; c < end; c++) {
@@ -46,7 +49,7 @@ void cpu_adaptive_avg_pool(
           int64_t kw = iw1 - iw0;
 
           // compute local average
-          scalar_t sum = 0;
+          acc_t sum = 0;
           for (int64_t ih = ih0; ih < ih1; ih++) {
             for (int64_t iw = iw0; iw < iw1; iw++) {
               sum += input_ptr[ih * input_width + iw];
@@ -82,7 +85,8 @@ void cpu_adaptive_avg_pool_channels_last(
   int64_t output_height = output_size[0];
   int64_t output_width = output_size[1];
 
-  using Vec = vec256::Vec256<scalar_t>;
+  using acc_t = typename vec_acc_type<scalar_t>::type;
+  using Vec = vec256::Vec256<acc_t>;
   // parallel on dim N, H, W
   at::parallel_for(0, nbatch * output_height * output_width, 0, [&](int64_t begin, int64_t end) {
     int64_t n = 0;
@@ -90,6 +94,10 @@ void cpu_adaptive_avg_pool_channels_last(
     int64_t ow = 0;
     data_index_init(begin, n, nbatch, oh, output_height, ow, output_width);
 
+    // rows of BFloat16 are summed in float, see Note [Channels last pooling]
+    std::unique_ptr<acc_t[]> in_buffer(new acc_t[channels]);
+    std::unique_ptr<acc_t[]> out_buffer(new acc_t[channels]);
+
     for (int64_t i = begin; i < end; i++) {
       int64_t ih0 = start_index(oh, output_height, input_height);
       int64_t ih1 = end_index(oh, output_height, input_height);
@@ -99,7 +107,7 @@ void cpu_adaptive_avg_pool_channels_last(
       int64_t iw1 = end_index(ow, output_width, input_width);
       int64_t kw = iw1 - iw0;
 
-      scalar_t* out = output_data + i * channels;
+      acc_t* out = acc_row(output_data + i * channels, out_buffer.get());
       int64_t size = channels;
 
       // Note: For oridinary usage scenario, each out lane should
@@ -107,17 +115,18 @@ void cpu_adaptive_avg_pool_channels_last(
       // Pass I: zero the out lane
       int64_t d1 = 0;
       for (; d1 < size - (size % Vec::size()); d1 += Vec::size()) {
-        Vec out_vec = Vec(scalar_t(0));
+        Vec out_vec = Vec(acc_t(0));
         out_vec.store(out + d1);
       }
       for (; d1 < size; d1++) {
-        out[d1] = scalar_t(0);
+        out[d1] = acc_t(0);
       }
       // Pass II: compute local sum
       for (int64_t ih = ih0; ih < ih1; ih++) {
         for (int64_t iw = iw0; iw < iw1; iw++) {
-          scalar_t* in = input_data + n * input_height * input_width * channels +
+          scalar_t* in_row = input_data + n * input_height * input_width * channels +
               ih * input_width * channels + iw * channels;
+          const acc_t* in = load_acc_row(in_row, in_buffer.get(), size);
 
           int64_t d2 = 0;
           for (; d2 < size - (size % Vec::size()); d2 += Vec::size()) {
@@ -132,12 +141,13 @@ void cpu_adaptive_avg_pool_channels_last(
       // Pass III: compute local average
       int64_t d3 = 0;
       for (; d3 < size - (size % Vec::size()); d3 += Vec::size()) {
-        Vec out_vec = Vec::loadu(out + d3) / Vec(scalar_t(kh * kw));
+        Vec out_vec = Vec::loadu(out + d3) / Vec(acc_t(kh * kw));
         out_vec.store(out + d3);
       }
       for (; d3 < size; d3++) {
         out[d3] = out[d3] / kh / kw;
       }
+      store_acc_row(out, output_data + i * channels, size);
 
       // move on to next output index
       data_index_step(n, nbatch, oh, output_height, ow, output_width);
@@ -216,13 +226,17 @@ void cpu_adaptive_avg_pool_backward_channels_last(
   int64_t input_width = grad_input.size(3);
   int64_t output_height = grad_output.size(2);
   int64_t output_width = grad_output.size(3);
+  int64_t channel_blocks = (channels + kChannelsLastBlock - 1) / kChannelsLastBlock;
 
   using Vec = vec256::Vec256<scalar_t>;
-  // parallel on dim N
-  at::parallel_for(0, nbatch, 0, [&](int64_t begin, int64_t end) {
-    for (int64_t n = begin; n < end; n++) {
-      scalar_t* grad_input_ptr = grad_input_data + n * input_height * input_width * channels;
-      scalar_t* grad_output_ptr = grad_output_data + n * output_height * output_width * channels;
+  // parallel on dim N and blocks of C
+  at::parallel_for(0, nbatch * channel_blocks, 0, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      int64_t n = i / channel_blocks;
+      int64_t c0 = (i % channel_blocks) * kChannelsLastBlock;
+      int64_t size = std::min(kChannelsLastBlock, channels - c0);
+      scalar_t* grad_input_ptr = grad_input_data + n * input_height * input_width * channels + c0;
+      scalar_t* grad_output_ptr = grad_output_data + n * output_height * output_width * channels + c0;
 
       for (int64_t oh = 0; oh < output_height; oh++) {
         int64_t ih0 = start_index(oh, output_height, input_height);
@@ -235,7 +249,6 @@ void cpu_adaptive_avg_pool_backward_channels_last(
           int64_t kw = iw1 - iw0;
 
           scalar_t* gout = grad_output_ptr + oh * output_width * channels + ow * channels;
-          int64_t size = channels;
           for (int64_t ih = ih0; ih < ih1; ih++) {
             for (int64_t iw = iw0; iw < iw1; iw++) {
               scalar_t* gin = grad_input_ptr + ih * input_width * channels + iw * channels;
@@ -246,7 +259,7 @@ void cpu_adaptive_avg_pool_backward_channels_last(
                 gin_vec.store(gin + d);
               }
               for (; d < size; d++) {
-                gin[d] += gout[d] / kw / kw;
+                gin[d] += gout[d] / kh / kw;
               }
             }
           }
@@ -266,13 +279,13 @@ void adaptive_avg_pool2d_kernel_impl(
     IntArrayRef output_size) {
   switch (input.suggest_memory_format()) {
     case at::MemoryFormat::Contiguous: {
-      AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "adaptive_avg_pool2d", [&] {
+      AT_DISPATCH_FLOATING_TYPES_AND(ScalarType::BFloat16, input.scalar_type(), "adaptive_avg_pool2d", [&] {
         cpu_adaptive_avg_pool<scalar_t>(output, input, output_size);
       });
       break;
     }
     case at::MemoryFormat::ChannelsLast: {
-      AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "adaptive_avg_pool2d_channels_last", [&]{
+      AT_DISPATCH_FLOATING_TYPES_AND(ScalarType::BFloat16, input.scalar_type(), "adaptive_avg_pool2d_channels_last", [&]{
         cpu_adaptive_avg_pool_channels_last<scalar_t>(output, input, output_size);
       });
       break;
@@ -287,13 +300,13 @@ void adapative_avg_pool2d_backward_kernel_impl(
     const Tensor& grad_output) {
   switch (grad_output.suggest_memory_format()) {
     case at::MemoryFormat::Contiguous: {
-      AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "adaptive_avg_pool2d_backward", [&] {
+      AT_DISPATCH_FLOATING_TYPES_AND(ScalarType::BFloat16, grad_output.scalar_type(), "adaptive_avg_pool2d_backward", [&] {
         cpu_adaptive_avg_pool_backward<scalar_t>(grad_input, grad_output);
       });
       break;
     }
     case at::MemoryFormat::ChannelsLast: {
-      AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "adaptive_avg_pool2d_backward_channels_last", [&]{
+      AT_DISPATCH_FLOATING_TYPES_AND(ScalarType::BFloat16, grad_output.scalar_type(), "adaptive_avg_pool2d_backward_channels_last", [&]{
         cpu_adaptive_avg_pool_backward_channels_last<scalar_t>(grad_input, grad_output);
       });
       break;
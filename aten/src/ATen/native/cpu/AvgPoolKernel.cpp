@@ -0,0 +1,236 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/Pool.h>
+#include <ATen/native/cpu/utils.h>
+
+#include <memory>
+
+namespace at { namespace native {
+
+namespace {
+
+// See Note [Channels last pooling]
+template <typename scalar_t>
+void cpu_avg_pool_channels_last(
+    Tensor& output_,
+    const Tensor& input_,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    bool count_include_pad,
+    c10::optional<int64_t> divisor_override) {
+  auto memory_format = at::MemoryFormat::ChannelsLast;
+  auto input = input_.contiguous(memory_format);
+  auto output = output_.contiguous(memory_format);
+
+  auto input_data = input.data_ptr<scalar_t>();
+  auto output_data = output.data_ptr<scalar_t>();
+
+  int64_t nbatch = input.size(0);
+  int64_t channels = input.size(1);
+  int64_t input_height = input.size(2);
+  int64_t input_width = input.size(3);
+  int64_t output_height = output.size(2);
+  int64_t output_width = output.size(3);
+
+  using acc_t = typename vec_acc_type<scalar_t>::type;
+  using Vec = vec256::Vec256<acc_t>;
+  // parallel on dim N, H, W
+  at::parallel_for(0, nbatch * output_height * output_width, 0, [&](int64_t begin, int64_t end) {
+    int64_t n = 0;
+    int64_t oh = 0;
+    int64_t ow = 0;
+    data_index_init(begin, n, nbatch, oh, output_height, ow, output_width);
+
+    std::unique_ptr<acc_t[]> in_buffer(new acc_t[channels]);
+    std::unique_ptr<acc_t[]> sum_buffer(new acc_t[channels]);
+
+    for (int64_t i = begin; i < end; i++) {
+      int64_t ih0 = oh * dH - padH;
+      int64_t iw0 = ow * dW - padW;
+      int64_t ih1 = std::min(ih0 + kH, input_height + padH);
+      int64_t iw1 = std::min(iw0 + kW, input_width + padW);
+      int64_t pool_size = (ih1 - ih0) * (iw1 - iw0);
+      ih0 = std::max(ih0, (int64_t) 0);
+      iw0 = std::max(iw0, (int64_t) 0);
+      ih1 = std::min(ih1, input_height);
+      iw1 = std::min(iw1, input_width);
+
+      acc_t* sum = acc_row(output_data + i * channels, sum_buffer.get());
+      int64_t size = channels;
+
+      // Pass I: zero the out lane
+      int64_t d1 = 0;
+      for (; d1 < size - (size % Vec::size()); d1 += Vec::size()) {
+        Vec(acc_t(0)).store(sum + d1);
+      }
+      for (; d1 < size; d1++) {
+        sum[d1] = acc_t(0);
+      }
+
+      if (ih0 < ih1 && iw0 < iw1) {
+        int64_t divide_factor;
+        if (divisor_override.has_value()) {
+          divide_factor = divisor_override.value();
+        } else if (count_include_pad) {
+          divide_factor = pool_size;
+        } else {
+          divide_factor = (ih1 - ih0) * (iw1 - iw0);
+        }
+
+        // Pass II: compute local sum
+        for (int64_t ih = ih0; ih < ih1; ih++) {
+          for (int64_t iw = iw0; iw < iw1; iw++) {
+            const scalar_t* in_row = input_data +
+                ((n * input_height + ih) * input_width + iw) * channels;
+            const acc_t* in = load_acc_row(in_row, in_buffer.get(), size);
+
+            int64_t d2 = 0;
+            for (; d2 < size - (size % Vec::size()); d2 += Vec::size()) {
+              Vec sum_vec = Vec::loadu(sum + d2) + Vec::loadu(in + d2);
+              sum_vec.store(sum + d2);
+            }
+            for (; d2 < size; d2++) {
+              sum[d2] += in[d2];
+            }
+          }
+        }
+        // Pass III: compute local average
+        int64_t d3 = 0;
+        for (; d3 < size - (size % Vec::size()); d3 += Vec::size()) {
+          Vec out_vec = Vec::loadu(sum + d3) / Vec(acc_t(divide_factor));
+          out_vec.store(sum + d3);
+        }
+        for (; d3 < size; d3++) {
+          sum[d3] = sum[d3] / divide_factor;
+        }
+      }
+      store_acc_row(sum, output_data + i * channels, size);
+
+      // move on to next output index
+      data_index_step(n, nbatch, oh, output_height, ow, output_width);
+    }
+  });
+
+  if (!output_.is_contiguous(memory_format)) {
+    output_.copy_(output);
+  }
+}
+
+template <typename scalar_t>
+void cpu_avg_pool_backward_channels_last(
+    Tensor& grad_input_,
+    const Tensor& grad_output_,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    bool count_include_pad,
+    c10::optional<int64_t> divisor_override) {
+  auto memory_format = at::MemoryFormat::ChannelsLast;
+  auto grad_input = grad_input_.contiguous(memory_format);
+  auto grad_output = grad_output_.contiguous(memory_format);
+
+  auto grad_input_data = grad_input.data_ptr<scalar_t>();
+  auto grad_output_data = grad_output.data_ptr<scalar_t>();
+
+  int64_t nbatch = grad_input.size(0);
+  int64_t channels = grad_input.size(1);
+  int64_t input_height = grad_input.size(2);
+  int64_t input_width = grad_input.size(3);
+  int64_t output_height = grad_output.size(2);
+  int64_t output_width = grad_output.size(3);
+  int64_t channel_blocks = (channels + kChannelsLastBlock - 1) / kChannelsLastBlock;
+
+  using Vec = vec256::Vec256<scalar_t>;
+  // parallel on dim N and blocks of C
+  at::parallel_for(0, nbatch * channel_blocks, 0, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      int64_t n = i / channel_blocks;
+      int64_t c0 = (i % channel_blocks) * kChannelsLastBlock;
+      int64_t size = std::min(kChannelsLastBlock, channels - c0);
+      scalar_t* grad_input_ptr = grad_input_data + n * input_height * input_width * channels + c0;
+      const scalar_t* grad_output_ptr = grad_output_data + n * output_height * output_width * channels + c0;
+
+      for (int64_t oh = 0; oh < output_height; oh++) {
+        for (int64_t ow = 0; ow < output_width; ow++) {
+          int64_t ih0 = oh * dH - padH;
+          int64_t iw0 = ow * dW - padW;
+          int64_t ih1 = std::min(ih0 + kH, input_height + padH);
+          int64_t iw1 = std::min(iw0 + kW, input_width + padW);
+          int64_t pool_size = (ih1 - ih0) * (iw1 - iw0);
+          ih0 = std::max(ih0, (int64_t) 0);
+          iw0 = std::max(iw0, (int64_t) 0);
+          ih1 = std::min(ih1, input_height);
+          iw1 = std::min(iw1, input_width);
+
+          int64_t divide_factor;
+          if (divisor_override.has_value()) {
+            divide_factor = divisor_override.value();
+          } else if (count_include_pad) {
+            divide_factor = pool_size;
+          } else {
+            divide_factor = (ih1 - ih0) * (iw1 - iw0);
+          }
+
+          const scalar_t* gout = grad_output_ptr + (oh * output_width + ow) * channels;
+          for (int64_t ih = ih0; ih < ih1; ih++) {
+            for (int64_t iw = iw0; iw < iw1; iw++) {
+              scalar_t* gin = grad_input_ptr + (ih * input_width + iw) * channels;
+
+              int64_t d = 0;
+              for (; d < size - (size % Vec::size()); d += Vec::size()) {
+                Vec gin_vec = Vec::loadu(gin + d) + Vec::loadu(gout + d) / Vec(scalar_t(divide_factor));
+                gin_vec.store(gin + d);
+              }
+              for (; d < size; d++) {
+                gin[d] += gout[d] / divide_factor;
+              }
+            }
+          }
+        }
+      }
+    }
+  });
+
+  if (!grad_input_.is_contiguous(memory_format)) {
+    grad_input_.copy_(grad_input);
+  }
+}
+
+void avg_pool2d_channels_last_kernel_impl(
+    Tensor& output,
+    const Tensor& input,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    bool count_include_pad,
+    c10::optional<int64_t> divisor_override) {
+  AT_DISPATCH_FLOATING_TYPES_AND(ScalarType::BFloat16, input.scalar_type(), "avg_pool2d_channels_last", [&] {
+    cpu_avg_pool_channels_last<scalar_t>(
+        output, input, kW, kH, dW, dH, padW, padH, count_include_pad, divisor_override);
+  });
+}
+
+void avg_pool2d_backward_channels_last_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad_output,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    bool count_include_pad,
+    c10::optional<int64_t> divisor_override) {
+  AT_DISPATCH_FLOATING_TYPES_AND(ScalarType::BFloat16, grad_output.scalar_type(), "avg_pool2d_backward_channels_last", [&] {
+    cpu_avg_pool_backward_channels_last<scalar_t>(
+        grad_input, grad_output, kW, kH, dW, dH, padW, padH, count_include_pad, divisor_override);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(avg_pool2d_channels_last_kernel, &avg_pool2d_channels_last_kernel_impl);
+REGISTER_DISPATCH(avg_pool2d_backward_channels_last_kernel, &avg_pool2d_backward_channels_last_kernel_impl);
+
+}} // at::native
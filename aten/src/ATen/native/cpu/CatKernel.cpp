@@ -1,69 +1,135 @@
 #include <ATen/ATen.h>
 
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/cpu/CatKernel.h>
-#include <ATen/cpu/vec256/functional.h>
-#include <ATen/cpu/vec256/vec256.h>
+#include <c10/util/TypeCast.h>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
 
 namespace at { namespace native {
 
 namespace {
 
+// The result and the inputs are contiguous in the same memory format, so the
+// result is `outer` rows, and every row is the concatenation of one block of
+// each input. Blocks of an input follow each other in its memory.
 struct InputMeta {
-  void* data_ptr;
-  int64_t inner_size;
-
-  InputMeta(const Tensor& t, int64_t dim, int64_t inner)
-    : data_ptr(t.data_ptr())
-    , inner_size(t.sizes()[dim] * inner) {}
+  const char* data_ptr;
+  ScalarType dtype;
+  int64_t element_size;
+  int64_t inner_size; // elements of a block
 };
 
+// Position of the dims in memory, outermost first.
+std::vector<int64_t> physical_dim_order(int64_t ndim, MemoryFormat memory_format) {
+  if (memory_format == MemoryFormat::ChannelsLast && ndim == 4) {
+    return {0, 2, 3, 1};
+  }
+  if (memory_format == MemoryFormat::ChannelsLast3d && ndim == 5) {
+    return {0, 2, 3, 4, 1};
+  }
+  std::vector<int64_t> order(ndim);
+  std::iota(order.begin(), order.end(), 0);
+  return order;
+}
+
+// Copies n elements from the input, casting them to the dtype of the result
+// if needed.
 template <typename scalar_t>
-void cat_serial_kernel_impl(Tensor& result, TensorList tensors, int64_t dim) {
-  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
-      dim >= 0 && dim < result.dim(), "dim out of range in cat_serial_kernel_impl");
-  int64_t outer = result.numel() / (result.sizes()[dim] * result.strides()[dim]);
-  scalar_t* result_data = result.data_ptr<scalar_t>();
-  int64_t ninputs = tensors.size();
-  std::vector<InputMeta> inputs;
-  inputs.reserve(ninputs);
-  for (auto const &tensor : tensors) {
-    inputs.emplace_back(tensor, dim, result.strides()[dim]);
+void copy_block(char* out, const InputMeta& input, const char* in, int64_t n) {
+  if (input.dtype == CppTypeToScalarType<scalar_t>::value) {
+    std::memcpy(out, in, n * sizeof(scalar_t));
+    return;
   }
+  scalar_t* out_ptr = reinterpret_cast<scalar_t*>(out);
+  for (int64_t k = 0; k < n; ++k) {
+    out_ptr[k] = c10::fetch_and_cast<scalar_t>(
+        input.dtype, in + k * input.element_size);
+  }
+}
 
-  using Vec = vec256::Vec256<scalar_t>;
-  scalar_t* result_ptr = result_data;
-  for (int64_t i = 0; i < outer; ++i) {
-    for (int64_t j = 0; j < ninputs; j++) {
-      int64_t local_inner = inputs[j].inner_size;
-      scalar_t* input_ptr = (scalar_t*)(inputs[j].data_ptr) + i * local_inner;
-      if (local_inner < Vec::size()) {
-        #if !defined(_MSC_VER) && !defined(COMPILING_FOR_MIN_SIZE)
-        # pragma unroll
-        #endif
-        for (int64_t k = 0; k < local_inner; k++) {
-          result_ptr[k] = input_ptr[k];
-        }
-      } else {
-        vec256::map(
-            [](Vec x) { return x; },
-            result_ptr,
-            input_ptr,
-            local_inner);
+template <typename scalar_t>
+void cat_contig_kernel_impl(
+    Tensor& result,
+    const std::vector<InputMeta>& inputs,
+    const std::vector<int64_t>& block_offsets,
+    int64_t row_size) {
+  char* result_data = static_cast<char*>(result.data_ptr());
+  const int64_t ninputs = inputs.size();
+  const int64_t result_element_size = sizeof(scalar_t);
+
+  // The output is split evenly into tasks, whatever the sizes of the blocks.
+  at::parallel_for(0, result.numel(), at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    int64_t i = begin / row_size;
+    const int64_t pos = begin % row_size;
+    int64_t j = std::upper_bound(block_offsets.begin(), block_offsets.end(), pos) -
+        block_offsets.begin() - 1;
+    int64_t k = pos - block_offsets[j];
+    for (int64_t cur = begin; cur < end;) {
+      const InputMeta& input = inputs[j];
+      const int64_t n = std::min(input.inner_size - k, end - cur);
+      copy_block<scalar_t>(
+          result_data + cur * result_element_size,
+          input,
+          input.data_ptr + (i * input.inner_size + k) * input.element_size,
+          n);
+      cur += n;
+      k = 0;
+      // inputs with empty blocks are not in `inputs`
+      if (++j == ninputs) {
+        j = 0;
+        ++i;
       }
-      result_ptr += local_inner;
     }
-  }
+  });
 }
 
-void cat_serial_kernel(Tensor& result, TensorList tensors, int64_t dim) {
-  AT_DISPATCH_FLOATING_TYPES(result.scalar_type(), "cat_serial_kernel", [&]() {
-    cat_serial_kernel_impl<scalar_t>(result, tensors, dim);
+// Concatenates inputs that are contiguous in memory_format into a result that
+// is contiguous in memory_format. Pointers and block sizes of all inputs are
+// computed once, then the result is filled by memcpy of whole blocks in one
+// parallel loop, casting the inputs whose dtype differs from the result.
+void cat_contig_kernel(Tensor& result, TensorList tensors, int64_t dim, MemoryFormat memory_format) {
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+      dim >= 0 && dim < result.dim(), "dim out of range in cat_contig_kernel");
+  const auto order = physical_dim_order(result.dim(), memory_format);
+  const int64_t dim_pos = std::find(order.begin(), order.end(), dim) - order.begin();
+  int64_t inner = 1;
+  for (size_t p = dim_pos + 1; p < order.size(); ++p) {
+    inner *= result.sizes()[order[p]];
+  }
+  const int64_t row_size = result.sizes()[dim] * inner;
+
+  std::vector<InputMeta> inputs;
+  std::vector<int64_t> block_offsets;
+  inputs.reserve(tensors.size());
+  block_offsets.reserve(tensors.size() + 1);
+  int64_t offset = 0;
+  for (auto const &tensor : tensors) {
+    // empty inputs, including the legacy 1-D ones, have nothing to copy
+    if (tensor.numel() == 0) {
+      continue;
+    }
+    inputs.push_back({static_cast<const char*>(tensor.data_ptr()),
+                      tensor.scalar_type(),
+                      static_cast<int64_t>(tensor.element_size()),
+                      tensor.sizes()[dim] * inner});
+    block_offsets.push_back(offset);
+    offset += inputs.back().inner_size;
+  }
+  TORCH_INTERNAL_ASSERT(offset == row_size);
+  block_offsets.push_back(offset);
+
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kBool, kHalf, kBFloat16,
+      result.scalar_type(), "cat_contig_kernel", [&]() {
+    cat_contig_kernel_impl<scalar_t>(result, inputs, block_offsets, row_size);
   });
 }
 
 } // anonymous namespace
 
-REGISTER_DISPATCH(cat_serial_stub, &cat_serial_kernel);
+REGISTER_DISPATCH(cat_contig_stub, &cat_contig_kernel);
 
 }} // at::native
@@ -0,0 +1,417 @@
+#include <ATen/native/cpu/Conv2dKernel.h>
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+
+namespace at {
+namespace native {
+namespace {
+
+using Vec = vec256::Vec256<float>;
+
+// The first n floats of ptr, for the remainder of the channels
+inline Vec load_n(const float* ptr, int64_t n) {
+  return n >= Vec::size() ? Vec::loadu(ptr) : Vec::loadu(ptr, n);
+}
+
+inline void store_n(const Vec& v, float* ptr, int64_t n) {
+  if (n >= Vec::size()) {
+    v.store(ptr);
+  } else {
+    v.store(ptr, n);
+  }
+}
+
+// Zero-padded channels last copy of the NCHW input, of size
+// (batch, padded_rows, padded_cols, channels), with the input at (pad_rows, pad_cols)
+Tensor pad_nhwc(const Tensor& input, int64_t pad_rows, int64_t pad_cols,
+                int64_t padded_rows, int64_t padded_cols) {
+  auto padded = at::zeros({input.size(0), padded_rows, padded_cols, input.size(1)}, input.options());
+  padded.narrow(1, pad_rows, input.size(2))
+      .narrow(2, pad_cols, input.size(3))
+      .copy_(input.permute({0, 2, 3, 1}));
+  return padded;
+}
+
+// Winograd F(m x m, 3 x 3) with alpha = m + 2 points, from Lavin and Gray,
+// "Fast Algorithms for Convolutional Neural Networks":
+//   Y = A^T [(G g G^T) . (B^T d B)] A
+// for each m x m output tile Y of the alpha x alpha input tile d.
+struct WinogradF2x3 final {
+  static constexpr int m = 2;
+  static constexpr int alpha = 4;
+  static constexpr float BT[alpha][alpha] = {
+    {1,  0, -1,  0},
+    {0,  1,  1,  0},
+    {0, -1,  1,  0},
+    {0,  1,  0, -1},
+  };
+  static constexpr float G[alpha][3] = {
+    {1,     0,    0},
+    {0.5,  0.5, 0.5},
+    {0.5, -0.5, 0.5},
+    {0,     0,    1},
+  };
+  static constexpr float AT[m][alpha] = {
+    {1, 1,  1,  0},
+    {0, 1, -1, -1},
+  };
+};
+
+struct WinogradF4x3 final {
+  static constexpr int m = 4;
+  static constexpr int alpha = 6;
+  static constexpr float BT[alpha][alpha] = {
+    {4,  0, -5,  0, 1, 0},
+    {0, -4, -4,  1, 1, 0},
+    {0,  4, -4, -1, 1, 0},
+    {0, -2, -1,  2, 1, 0},
+    {0,  2, -1, -2, 1, 0},
+    {0,  4,  0, -5, 0, 1},
+  };
+  static constexpr float G[alpha][3] = {
+    { 1.f / 4,         0,        0},
+    {-1.f / 6,  -1.f / 6, -1.f / 6},
+    {-1.f / 6,   1.f / 6, -1.f / 6},
+    { 1.f / 24,  1.f / 12, 1.f / 6},
+    { 1.f / 24, -1.f / 12, 1.f / 6},
+    {        0,         0,       1},
+  };
+  static constexpr float AT[m][alpha] = {
+    {1, 1,  1, 1,  1, 0},
+    {0, 1, -1, 2, -2, 0},
+    {0, 1,  1, 4,  4, 0},
+    {0, 1, -1, 8, -8, 1},
+  };
+};
+
+constexpr float WinogradF2x3::BT[WinogradF2x3::alpha][WinogradF2x3::alpha];
+constexpr float WinogradF2x3::G[WinogradF2x3::alpha][3];
+constexpr float WinogradF2x3::AT[WinogradF2x3::m][WinogradF2x3::alpha];
+constexpr float WinogradF4x3::BT[WinogradF4x3::alpha][WinogradF4x3::alpha];
+constexpr float WinogradF4x3::G[WinogradF4x3::alpha][3];
+constexpr float WinogradF4x3::AT[WinogradF4x3::m][WinogradF4x3::alpha];
+
+// Bytes of transformed input and output tiles processed at once
+constexpr int64_t kWinogradBlockBytes = 4 << 20;
+
+// Packs the (K, C, 3, 3) weight into the (alpha * alpha, K, C) matrices G g G^T
+template <typename F>
+Tensor pack_winograd_weight(const Tensor& weight) {
+  constexpr int alpha = F::alpha;
+  const int64_t K = weight.size(0);
+  const int64_t C = weight.size(1);
+  const auto weight_ = weight.contiguous();
+  auto packed = at::empty({alpha * alpha, K, C}, weight.options());
+  const float* w_data = weight_.data_ptr<float>();
+  float* p_data = packed.data_ptr<float>();
+  at::parallel_for(0, K * C, 64, [&](int64_t begin, int64_t end) {
+    for (int64_t kc = begin; kc < end; ++kc) {
+      const float* g = w_data + kc * 9;
+      float tmp[alpha][3];
+      for (int xi = 0; xi < alpha; ++xi) {
+        for (int b = 0; b < 3; ++b) {
+          tmp[xi][b] = F::G[xi][0] * g[b] + F::G[xi][1] * g[3 + b] + F::G[xi][2] * g[6 + b];
+        }
+      }
+      for (int xi = 0; xi < alpha; ++xi) {
+        for (int nu = 0; nu < alpha; ++nu) {
+          p_data[(xi * alpha + nu) * K * C + kc] =
+              tmp[xi][0] * F::G[nu][0] + tmp[xi][1] * F::G[nu][1] + tmp[xi][2] * F::G[nu][2];
+        }
+      }
+    }
+  });
+  return packed;
+}
+
+// B^T d B of the input tile whose top left pixel is in, into the rows v of
+// the (alpha * alpha, tiles, C) transformed input, vectorized over channels.
+template <typename F>
+void winograd_input_transform(const float* in, int64_t row_stride, int64_t C,
+                              float* v, int64_t point_stride) {
+  constexpr int alpha = F::alpha;
+  for (int64_t c = 0; c < C; c += Vec::size()) {
+    const int64_t n = std::min<int64_t>(Vec::size(), C - c);
+    Vec d[alpha][alpha];
+    for (int i = 0; i < alpha; ++i) {
+      for (int j = 0; j < alpha; ++j) {
+        d[i][j] = load_n(in + i * row_stride + j * C + c, n);
+      }
+    }
+    Vec tmp[alpha][alpha];
+    for (int xi = 0; xi < alpha; ++xi) {
+      for (int j = 0; j < alpha; ++j) {
+        Vec acc(0.f);
+        for (int i = 0; i < alpha; ++i) {
+          if (F::BT[xi][i] != 0) {
+            acc = vec256::fmadd(Vec(F::BT[xi][i]), d[i][j], acc);
+          }
+        }
+        tmp[xi][j] = acc;
+      }
+    }
+    for (int xi = 0; xi < alpha; ++xi) {
+      for (int nu = 0; nu < alpha; ++nu) {
+        Vec acc(0.f);
+        for (int j = 0; j < alpha; ++j) {
+          if (F::BT[nu][j] != 0) {
+            acc = vec256::fmadd(Vec(F::BT[nu][j]), tmp[xi][j], acc);
+          }
+        }
+        store_n(acc, v + (xi * alpha + nu) * point_stride + c, n);
+      }
+    }
+  }
+}
+
+// A^T M A (+ bias) of the rows m of the (alpha * alpha, tiles, K) products,
+// into the first rows x cols pixels of the output tile whose top left pixel
+// is out, vectorized over channels.
+template <typename F>
+void winograd_output_transform(const float* m, int64_t point_stride, int64_t K,
+                               const float* bias, float* out, int64_t row_stride,
+                               int64_t rows, int64_t cols) {
+  constexpr int alpha = F::alpha;
+  for (int64_t k = 0; k < K; k += Vec::size()) {
+    const int64_t n = std::min<int64_t>(Vec::size(), K - k);
+    Vec tmp[F::m][alpha];
+    for (int i = 0; i < F::m; ++i) {
+      for (int nu = 0; nu < alpha; ++nu) {
+        tmp[i][nu] = Vec(0.f);
+      }
+    }
+    for (int xi = 0; xi < alpha; ++xi) {
+      for (int nu = 0; nu < alpha; ++nu) {
+        const Vec mv = load_n(m + (xi * alpha + nu) * point_stride + k, n);
+        for (int i = 0; i < F::m; ++i) {
+          if (F::AT[i][xi] != 0) {
+            tmp[i][nu] = vec256::fmadd(Vec(F::AT[i][xi]), mv, tmp[i][nu]);
+          }
+        }
+      }
+    }
+    const Vec b = bias ? load_n(bias + k, n) : Vec(0.f);
+    for (int64_t i = 0; i < rows; ++i) {
+      for (int64_t j = 0; j < cols; ++j) {
+        Vec acc = b;
+        for (int nu = 0; nu < alpha; ++nu) {
+          if (F::AT[j][nu] != 0) {
+            acc = vec256::fmadd(Vec(F::AT[j][nu]), tmp[i][nu], acc);
+          }
+        }
+        store_n(acc, out + i * row_stride + j * K + k, n);
+      }
+    }
+  }
+}
+
+template <typename F>
+Tensor convolution_winograd3x3_impl(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef padding) {
+  constexpr int alpha = F::alpha;
+  constexpr int m = F::m;
+  const int64_t batch = input.size(0);
+  const int64_t C = input.size(1);
+  const int64_t K = weight.size(0);
+  const int64_t out_rows = input.size(2) + 2 * padding[0] - 2;
+  const int64_t out_cols = input.size(3) + 2 * padding[1] - 2;
+  const int64_t tile_rows = (out_rows + m - 1) / m;
+  const int64_t tile_cols = (out_cols + m - 1) / m;
+  const int64_t padded_rows = tile_rows * m + 2;
+  const int64_t padded_cols = tile_cols * m + 2;
+
+  const auto padded = pad_nhwc(input, padding[0], padding[1], padded_rows, padded_cols);
+  // (alpha * alpha, C, K) operands of the products with the transformed input
+  const auto packed_weight = pack_winograd_weight<F>(weight).transpose(1, 2);
+  const auto bias_ = bias.defined() ? bias.contiguous() : bias;
+  auto output = at::empty(
+      {batch, K, out_rows, out_cols},
+      input.options().memory_format(at::MemoryFormat::ChannelsLast));
+
+  const float* in_data = padded.data_ptr<float>();
+  const float* bias_data = bias_.defined() ? bias_.data_ptr<float>() : nullptr;
+  float* out_data = output.data_ptr<float>();
+
+  const int64_t tiles = batch * tile_rows * tile_cols;
+  const int64_t block = std::min(
+      tiles,
+      std::max<int64_t>(64, kWinogradBlockBytes / (alpha * alpha * std::max(C, K) * sizeof(float))));
+  Tensor transformed_input;
+  Tensor products;
+  for (int64_t t0 = 0; t0 < tiles; t0 += block) {
+    const int64_t n_tiles = std::min(block, tiles - t0);
+    if (!transformed_input.defined() || transformed_input.size(1) != n_tiles) {
+      transformed_input = at::empty({alpha * alpha, n_tiles, C}, input.options());
+      products = at::empty({alpha * alpha, n_tiles, K}, input.options());
+    }
+    float* v_data = transformed_input.data_ptr<float>();
+    float* m_data = products.data_ptr<float>();
+
+    at::parallel_for(0, n_tiles, 16, [&](int64_t begin, int64_t end) {
+      for (int64_t t = begin; t < end; ++t) {
+        const int64_t tile = t0 + t;
+        const int64_t n = tile / (tile_rows * tile_cols);
+        const int64_t ty = (tile / tile_cols) % tile_rows;
+        const int64_t tx = tile % tile_cols;
+        winograd_input_transform<F>(
+            in_data + ((n * padded_rows + ty * m) * padded_cols + tx * m) * C,
+            padded_cols * C, C, v_data + t * C, n_tiles * C);
+      }
+    });
+
+    at::bmm_out(products, transformed_input, packed_weight);
+
+    at::parallel_for(0, n_tiles, 16, [&](int64_t begin, int64_t end) {
+      for (int64_t t = begin; t < end; ++t) {
+        const int64_t tile = t0 + t;
+        const int64_t n = tile / (tile_rows * tile_cols);
+        const int64_t ty = (tile / tile_cols) % tile_rows;
+        const int64_t tx = tile % tile_cols;
+        winograd_output_transform<F>(
+            m_data + t * K, n_tiles * K, K, bias_data,
+            out_data + ((n * out_rows + ty * m) * out_cols + tx * m) * K,
+            out_cols * K,
+            std::min<int64_t>(m, out_rows - ty * m),
+            std::min<int64_t>(m, out_cols - tx * m));
+      }
+    });
+  }
+  return output;
+}
+
+Tensor _convolution_winograd3x3(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef padding,
+    int64_t tile_size) {
+  TORCH_INTERNAL_ASSERT(tile_size == 2 || tile_size == 4);
+  if (tile_size == 4) {
+    return convolution_winograd3x3_impl<WinogradF4x3>(input, weight, bias, padding);
+  }
+  return convolution_winograd3x3_impl<WinogradF2x3>(input, weight, bias, padding);
+}
+
+// Output pixels of a row computed at once by the direct convolution
+constexpr int64_t kDirectBlockCols = 4;
+
+// Computes block_cols consecutive output pixels of a row into out, for all
+// the K output channels in blocks of 2 vectors. in is the first input pixel
+// of the first output pixel and w the (KH, KW, C, K) packed weight.
+template <int64_t block_cols>
+void convolution_direct_nhwc_block(
+    const float* in, const float* w, const float* bias, float* out,
+    int64_t C, int64_t K, int64_t KH, int64_t KW,
+    int64_t col_step, int64_t dilation_row_step, int64_t dilation_col_step) {
+  constexpr int64_t kVecSize = Vec::size();
+  for (int64_t k0 = 0; k0 < K; k0 += 2 * kVecSize) {
+    const int64_t n0 = std::min(kVecSize, K - k0);
+    const int64_t n1 = std::min(kVecSize, K - k0 - n0);
+    Vec acc0[block_cols];
+    Vec acc1[block_cols];
+    const Vec b0 = bias ? load_n(bias + k0, n0) : Vec(0.f);
+    const Vec b1 = bias && n1 > 0 ? load_n(bias + k0 + kVecSize, n1) : Vec(0.f);
+    for (int64_t b = 0; b < block_cols; ++b) {
+      acc0[b] = b0;
+      acc1[b] = b1;
+    }
+    for (int64_t ky = 0; ky < KH; ++ky) {
+      for (int64_t kx = 0; kx < KW; ++kx) {
+        const float* x = in + ky * dilation_row_step + kx * dilation_col_step;
+        const float* wk = w + (ky * KW + kx) * C * K + k0;
+        if (n1 > 0) {
+          for (int64_t c = 0; c < C; ++c) {
+            const Vec w0 = load_n(wk + c * K, n0);
+            const Vec w1 = load_n(wk + c * K + kVecSize, n1);
+            for (int64_t b = 0; b < block_cols; ++b) {
+              const Vec xv(x[b * col_step + c]);
+              acc0[b] = vec256::fmadd(xv, w0, acc0[b]);
+              acc1[b] = vec256::fmadd(xv, w1, acc1[b]);
+            }
+          }
+        } else {
+          for (int64_t c = 0; c < C; ++c) {
+            const Vec w0 = load_n(wk + c * K, n0);
+            for (int64_t b = 0; b < block_cols; ++b) {
+              acc0[b] = vec256::fmadd(Vec(x[b * col_step + c]), w0, acc0[b]);
+            }
+          }
+        }
+      }
+    }
+    for (int64_t b = 0; b < block_cols; ++b) {
+      store_n(acc0[b], out + b * K + k0, n0);
+      if (n1 > 0) {
+        store_n(acc1[b], out + b * K + k0 + kVecSize, n1);
+      }
+    }
+  }
+}
+
+Tensor _convolution_direct_nhwc(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  const int64_t batch = input.size(0);
+  const int64_t C = input.size(1);
+  const int64_t K = weight.size(0);
+  const int64_t KH = weight.size(2);
+  const int64_t KW = weight.size(3);
+  const int64_t padded_rows = input.size(2) + 2 * padding[0];
+  const int64_t padded_cols = input.size(3) + 2 * padding[1];
+  const int64_t out_rows = (padded_rows - dilation[0] * (KH - 1) - 1) / stride[0] + 1;
+  const int64_t out_cols = (padded_cols - dilation[1] * (KW - 1) - 1) / stride[1] + 1;
+
+  const auto padded = pad_nhwc(input, padding[0], padding[1], padded_rows, padded_cols);
+  const auto packed_weight = weight.permute({2, 3, 1, 0}).contiguous();
+  const auto bias_ = bias.defined() ? bias.contiguous() : bias;
+  auto output = at::empty(
+      {batch, K, out_rows, out_cols},
+      input.options().memory_format(at::MemoryFormat::ChannelsLast));
+
+  const float* in_data = padded.data_ptr<float>();
+  const float* w_data = packed_weight.data_ptr<float>();
+  const float* bias_data = bias_.defined() ? bias_.data_ptr<float>() : nullptr;
+  float* out_data = output.data_ptr<float>();
+
+  const int64_t col_step = stride[1] * C;
+  const int64_t dilation_row_step = dilation[0] * padded_cols * C;
+  const int64_t dilation_col_step = dilation[1] * C;
+  at::parallel_for(0, batch * out_rows, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; ++row) {
+      const int64_t n = row / out_rows;
+      const int64_t oy = row % out_rows;
+      const float* in_row = in_data + (n * padded_rows + oy * stride[0]) * padded_cols * C;
+      float* out_row = out_data + row * out_cols * K;
+      int64_t ox = 0;
+      for (; ox + kDirectBlockCols <= out_cols; ox += kDirectBlockCols) {
+        convolution_direct_nhwc_block<kDirectBlockCols>(
+            in_row + ox * col_step, w_data, bias_data, out_row + ox * K,
+            C, K, KH, KW, col_step, dilation_row_step, dilation_col_step);
+      }
+      for (; ox < out_cols; ++ox) {
+        convolution_direct_nhwc_block<1>(
+            in_row + ox * col_step, w_data, bias_data, out_row + ox * K,
+            C, K, KH, KW, col_step, dilation_row_step, dilation_col_step);
+      }
+    }
+  });
+  return output;
+}
+
+}  // namespace
+
+REGISTER_DISPATCH(convolution_winograd3x3_stub, &_convolution_winograd3x3);
+REGISTER_DISPATCH(convolution_direct_nhwc_stub, &_convolution_direct_nhwc);
+
+}  // namespace native
+}  // namespace at
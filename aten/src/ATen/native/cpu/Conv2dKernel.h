@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+/*
+  Dense 2D convolution operators on float NHWC data, for inference when
+  MKL-DNN is not available:
+
+  - Winograd F(2x2, 3x3) and F(4x4, 3x3) convolution (tile_size 2 or 4) for
+    3x3 kernels with unit stride and dilation,
+  - direct convolution, blocked over output pixels and output channels.
+
+  Both pack the weights once per call and return a channels last output.
+*/
+
+namespace at {
+namespace native {
+
+using convolution_winograd3x3_fn =
+    Tensor (*)(const Tensor&, const Tensor&, const Tensor&, IntArrayRef, int64_t);
+using convolution_direct_nhwc_fn =
+    Tensor (*)(const Tensor&, const Tensor&, const Tensor&, IntArrayRef, IntArrayRef, IntArrayRef);
+
+DECLARE_DISPATCH(convolution_winograd3x3_fn, convolution_winograd3x3_stub);
+DECLARE_DISPATCH(convolution_direct_nhwc_fn, convolution_direct_nhwc_stub);
+
+}  // namespace native
+}  // namespace at
@@ -1,15 +1,58 @@
 #include <ATen/ATen.h>
 
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 #include <c10/util/TypeCast.h>
 
+#ifdef CPU_CAPABILITY_AVX2
+#include <ATen/native/cpu/Intrinsics.h>
+#endif
+
+#include <algorithm>
+#include <numeric>
+
 namespace at {
 namespace native {
 namespace {
 
+// Copies between float and BFloat16 or Half convert the contiguous runs with
+// vec256::convert, which is vectorized for them
+template <typename dest_t, typename src_t>
+void reduced_float_copy_kernel(TensorIterator& iter) {
+  iter.for_each([](char** data, const int64_t* strides, int64_t n) {
+    char* dst = data[0];
+    const char* src = data[1];
+    if (strides[0] == sizeof(dest_t) && strides[1] == sizeof(src_t)) {
+      vec256::convert(reinterpret_cast<const src_t*>(src), reinterpret_cast<dest_t*>(dst), n);
+      return;
+    }
+    for (int64_t i = 0; i < n; i++) {
+      *reinterpret_cast<dest_t*>(dst + i * strides[0]) =
+          static_cast<dest_t>(*reinterpret_cast<const src_t*>(src + i * strides[1]));
+    }
+  });
+}
+
+static bool reduced_float_copy(TensorIterator& iter) {
+  const ScalarType dtype = iter.dtype(0);
+  const ScalarType src_dtype = iter.dtype(1);
+  if (dtype == ScalarType::Float && src_dtype == ScalarType::BFloat16) {
+    reduced_float_copy_kernel<float, at::BFloat16>(iter);
+  } else if (dtype == ScalarType::BFloat16 && src_dtype == ScalarType::Float) {
+    reduced_float_copy_kernel<at::BFloat16, float>(iter);
+  } else if (dtype == ScalarType::Float && src_dtype == ScalarType::Half) {
+    reduced_float_copy_kernel<float, at::Half>(iter);
+  } else if (dtype == ScalarType::Half && src_dtype == ScalarType::Float) {
+    reduced_float_copy_kernel<at::Half, float>(iter);
+  } else {
+    return false;
+  }
+  return true;
+}
+
 static void copy_kernel(TensorIterator& iter, bool non_blocking) {
   ScalarType dtype = iter.dtype(0);
   if (dtype == iter.dtype(1)) {
@@ -42,7 +85,7 @@ static void copy_kernel(TensorIterator& iter, bool non_blocking) {
                 [=](Vec256<scalar_t> a) { return a; });
           });
     }
-  } else {
+  } else if (!reduced_float_copy(iter)) {
     AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(ScalarType::Half, ScalarType::Bool, ScalarType::BFloat16, dtype, "copy_", [&] {
       using dest_t = scalar_t;
       AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(ScalarType::Half, ScalarType::Bool, ScalarType::BFloat16, iter.dtype(1), "copy_", [&] {
@@ -67,9 +110,265 @@ static void copy_kernel(TensorIterator& iter, bool non_blocking) {
   }
 }
 
+// Note [Transposed copies]
+// A copy whose source and destination are contiguous along different
+// dimensions, like permute().contiguous(), reads or writes one of them with a
+// large stride in the TensorIterator loops. Here the dimensions of size 1 are
+// dropped and those which are contiguous in both tensors are merged, and the
+// copy is split in the 2D transpositions, one per index of the other
+// dimensions, of the dimension along which src is contiguous with the one
+// along which self is. These are cut in tiles copied in parallel, which are
+// recursively halved until they fit in the L1 cache, and the elements are
+// moved by 8x8 (4 bytes) or 4x4 (8 bytes) blocks transposed in registers.
+
+// The side of the tiles copied in parallel
+constexpr int64_t kTransposeTile = 128;
+// The size under which the tiles are no further halved
+constexpr int64_t kTransposeBlockBytes = 4096;
+
+// Sets dst[c * ld_dst + r] to src[r * ld_src + c] for the 8x8 block
+template <typename T>
+inline void transpose_8x8(const T* src, int64_t ld_src, T* dst, int64_t ld_dst) {
+  for (int64_t c = 0; c < 8; ++c) {
+    for (int64_t r = 0; r < 8; ++r) {
+      dst[c * ld_dst + r] = src[r * ld_src + c];
+    }
+  }
+}
+
+#ifdef CPU_CAPABILITY_AVX2
+
+// The lanes are only moved, the 32-bit types are transposed as floats and
+// the 64-bit ones as doubles
+template <>
+inline void transpose_8x8<uint32_t>(const uint32_t* src_, int64_t ld_src, uint32_t* dst_, int64_t ld_dst) {
+  const float* src = reinterpret_cast<const float*>(src_);
+  float* dst = reinterpret_cast<float*>(dst_);
+  const __m256 r0 = _mm256_loadu_ps(src);
+  const __m256 r1 = _mm256_loadu_ps(src + ld_src);
+  const __m256 r2 = _mm256_loadu_ps(src + 2 * ld_src);
+  const __m256 r3 = _mm256_loadu_ps(src + 3 * ld_src);
+  const __m256 r4 = _mm256_loadu_ps(src + 4 * ld_src);
+  const __m256 r5 = _mm256_loadu_ps(src + 5 * ld_src);
+  const __m256 r6 = _mm256_loadu_ps(src + 6 * ld_src);
+  const __m256 r7 = _mm256_loadu_ps(src + 7 * ld_src);
+  // interleave the pairs of rows
+  const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+  const __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+  const __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+  const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+  const __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+  const __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+  const __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+  const __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+  // gather the 4x4 blocks of each half
+  const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+  // and swap the halves
+  _mm256_storeu_ps(dst, _mm256_permute2f128_ps(s0, s4, 0x20));
+  _mm256_storeu_ps(dst + ld_dst, _mm256_permute2f128_ps(s1, s5, 0x20));
+  _mm256_storeu_ps(dst + 2 * ld_dst, _mm256_permute2f128_ps(s2, s6, 0x20));
+  _mm256_storeu_ps(dst + 3 * ld_dst, _mm256_permute2f128_ps(s3, s7, 0x20));
+  _mm256_storeu_ps(dst + 4 * ld_dst, _mm256_permute2f128_ps(s0, s4, 0x31));
+  _mm256_storeu_ps(dst + 5 * ld_dst, _mm256_permute2f128_ps(s1, s5, 0x31));
+  _mm256_storeu_ps(dst + 6 * ld_dst, _mm256_permute2f128_ps(s2, s6, 0x31));
+  _mm256_storeu_ps(dst + 7 * ld_dst, _mm256_permute2f128_ps(s3, s7, 0x31));
+}
+
+inline void transpose_4x4(const double* src, int64_t ld_src, double* dst, int64_t ld_dst) {
+  const __m256d r0 = _mm256_loadu_pd(src);
+  const __m256d r1 = _mm256_loadu_pd(src + ld_src);
+  const __m256d r2 = _mm256_loadu_pd(src + 2 * ld_src);
+  const __m256d r3 = _mm256_loadu_pd(src + 3 * ld_src);
+  const __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+  const __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+  const __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+  const __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+  _mm256_storeu_pd(dst, _mm256_permute2f128_pd(t0, t2, 0x20));
+  _mm256_storeu_pd(dst + ld_dst, _mm256_permute2f128_pd(t1, t3, 0x20));
+  _mm256_storeu_pd(dst + 2 * ld_dst, _mm256_permute2f128_pd(t0, t2, 0x31));
+  _mm256_storeu_pd(dst + 3 * ld_dst, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+template <>
+inline void transpose_8x8<uint64_t>(const uint64_t* src_, int64_t ld_src, uint64_t* dst_, int64_t ld_dst) {
+  const double* src = reinterpret_cast<const double*>(src_);
+  double* dst = reinterpret_cast<double*>(dst_);
+  transpose_4x4(src, ld_src, dst, ld_dst);
+  transpose_4x4(src + 4, ld_src, dst + 4 * ld_dst, ld_dst);
+  transpose_4x4(src + 4 * ld_src, ld_src, dst + 4, ld_dst);
+  transpose_4x4(src + 4 * ld_src + 4, ld_src, dst + 4 * ld_dst + 4, ld_dst);
+}
+
+#endif
+
+// Sets dst[c * ld_dst + r] to src[r * ld_src + c] for r < rows and c < cols
+template <typename T>
+void transpose_block(const T* src, int64_t ld_src, T* dst, int64_t ld_dst, int64_t rows, int64_t cols) {
+  if (rows * cols * static_cast<int64_t>(sizeof(T)) > kTransposeBlockBytes && std::max(rows, cols) > 8) {
+    // halves the longest side on a multiple of 8
+    if (rows >= cols) {
+      const int64_t half = (rows / 2 + 7) / 8 * 8;
+      transpose_block(src, ld_src, dst, ld_dst, half, cols);
+      transpose_block(src + half * ld_src, ld_src, dst + half, ld_dst, rows - half, cols);
+    } else {
+      const int64_t half = (cols / 2 + 7) / 8 * 8;
+      transpose_block(src, ld_src, dst, ld_dst, rows, half);
+      transpose_block(src + half, ld_src, dst + half * ld_dst, ld_dst, rows, cols - half);
+    }
+    return;
+  }
+  const int64_t rows8 = rows / 8 * 8;
+  const int64_t cols8 = cols / 8 * 8;
+  for (int64_t r = 0; r < rows8; r += 8) {
+    for (int64_t c = 0; c < cols8; c += 8) {
+      transpose_8x8(src + r * ld_src + c, ld_src, dst + c * ld_dst + r, ld_dst);
+    }
+  }
+  for (int64_t c = cols8; c < cols; ++c) {
+    for (int64_t r = 0; r < rows; ++r) {
+      dst[c * ld_dst + r] = src[r * ld_src + c];
+    }
+  }
+  for (int64_t c = 0; c < cols8; ++c) {
+    for (int64_t r = rows8; r < rows; ++r) {
+      dst[c * ld_dst + r] = src[r * ld_src + c];
+    }
+  }
+}
+
+// The elements are only moved, and are copied as integers of their size
+struct Bytes16 {
+  uint64_t lo;
+  uint64_t hi;
+};
+
+template <typename T>
+void transpose_copy(
+    char* dst_data,
+    const char* src_data,
+    const DimVector& sizes,
+    const DimVector& dst_strides,
+    const DimVector& src_strides,
+    int64_t src_dim) {
+  // the rows of src, along dimension 0 which is contiguous in dst, and its
+  // columns along src_dim
+  const int64_t rows = sizes[0];
+  const int64_t cols = sizes[src_dim];
+  const int64_t ld_src = src_strides[0];
+  const int64_t ld_dst = dst_strides[src_dim];
+  const int64_t row_tiles = (rows + kTransposeTile - 1) / kTransposeTile;
+  const int64_t col_tiles = (cols + kTransposeTile - 1) / kTransposeTile;
+  const int64_t num_tiles = row_tiles * col_tiles;
+  int64_t outer = 1;
+  for (size_t d = 1; d < sizes.size(); ++d) {
+    if (static_cast<int64_t>(d) != src_dim) {
+      outer *= sizes[d];
+    }
+  }
+  const T* src = reinterpret_cast<const T*>(src_data);
+  T* dst = reinterpret_cast<T*>(dst_data);
+  const int64_t grain_size =
+      std::max<int64_t>(1, internal::GRAIN_SIZE / (kTransposeTile * kTransposeTile));
+  at::parallel_for(0, outer * num_tiles, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      // the offsets of the transposition, from its index in the other
+      // dimensions
+      int64_t index = i / num_tiles;
+      int64_t src_offset = 0;
+      int64_t dst_offset = 0;
+      for (size_t d = 1; d < sizes.size(); ++d) {
+        if (static_cast<int64_t>(d) != src_dim) {
+          src_offset += (index % sizes[d]) * src_strides[d];
+          dst_offset += (index % sizes[d]) * dst_strides[d];
+          index /= sizes[d];
+        }
+      }
+      const int64_t r = (i % num_tiles) / col_tiles * kTransposeTile;
+      const int64_t c = (i % num_tiles) % col_tiles * kTransposeTile;
+      transpose_block(
+          src + src_offset + r * ld_src + c, ld_src,
+          dst + dst_offset + c * ld_dst + r, ld_dst,
+          std::min(kTransposeTile, rows - r), std::min(kTransposeTile, cols - c));
+    }
+  });
+}
+
+// See Note [Transposed copies]
+static bool transpose_copy_kernel(Tensor& self, const Tensor& src) {
+  const int64_t element_size = self.element_size();
+  if (element_size != 1 && element_size != 2 && element_size != 4 &&
+      element_size != 8 && element_size != 16) {
+    return false;
+  }
+
+  // the dimensions of size larger than 1, from the innermost of self
+  DimVector perm;
+  for (int64_t d = 0; d < self.dim(); ++d) {
+    if (self.size(d) != 1) {
+      perm.push_back(d);
+    }
+  }
+  std::stable_sort(perm.begin(), perm.end(), [&](int64_t a, int64_t b) {
+    return self.stride(a) < self.stride(b);
+  });
+  DimVector sizes;
+  DimVector dst_strides;
+  DimVector src_strides;
+  for (const auto d : perm) {
+    const auto n = sizes.size();
+    if (n > 0 && dst_strides[n - 1] * sizes[n - 1] == self.stride(d) &&
+        src_strides[n - 1] * sizes[n - 1] == src.stride(d)) {
+      // contiguous with the previous dimension in both tensors
+      sizes[n - 1] *= self.size(d);
+    } else {
+      sizes.push_back(self.size(d));
+      dst_strides.push_back(self.stride(d));
+      src_strides.push_back(src.stride(d));
+    }
+  }
+  if (sizes.size() < 2 || dst_strides[0] != 1) {
+    return false;
+  }
+  const auto src_dim = std::find(src_strides.begin(), src_strides.end(), 1) - src_strides.begin();
+  // the narrow transpositions are left to the TensorIterator loops
+  if (src_dim == 0 || src_dim == static_cast<int64_t>(src_strides.size()) ||
+      sizes[0] < 8 || sizes[src_dim] < 8) {
+    return false;
+  }
+
+  char* dst_data = static_cast<char*>(self.data_ptr());
+  const char* src_data = static_cast<const char*>(src.data_ptr());
+  switch (element_size) {
+    case 1:
+      transpose_copy<uint8_t>(dst_data, src_data, sizes, dst_strides, src_strides, src_dim);
+      break;
+    case 2:
+      transpose_copy<uint16_t>(dst_data, src_data, sizes, dst_strides, src_strides, src_dim);
+      break;
+    case 4:
+      transpose_copy<uint32_t>(dst_data, src_data, sizes, dst_strides, src_strides, src_dim);
+      break;
+    case 8:
+      transpose_copy<uint64_t>(dst_data, src_data, sizes, dst_strides, src_strides, src_dim);
+      break;
+    default:
+      transpose_copy<Bytes16>(dst_data, src_data, sizes, dst_strides, src_strides, src_dim);
+      break;
+  }
+  return true;
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(copy_stub, &copy_kernel);
+REGISTER_DISPATCH(transpose_copy_stub, &transpose_copy_kernel);
 
 } // namespace native
 } // namespace at
@@ -1,6 +1,10 @@
 #include <ATen/native/cpu/DepthwiseConvKernel.h>
 #include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <type_traits>
 
 #ifdef __ARM_NEON__
 #include <arm_neon.h>
@@ -297,9 +301,304 @@ Tensor _convolution_depthwise3x3_winograd(
   return output;
 }
 
+// Geometry of the direct depthwise convolution
+struct DepthwiseArguments final {
+  int64_t batch;
+  int64_t channels;
+  int64_t in_rows;
+  int64_t in_cols;
+  int64_t out_rows;
+  int64_t out_cols;
+  int64_t kernel_rows;
+  int64_t kernel_cols;
+  int64_t stride_rows;
+  int64_t stride_cols;
+  int64_t pad_rows;
+  int64_t pad_cols;
+  int64_t dilation_rows;
+  int64_t dilation_cols;
+};
+
+DepthwiseArguments depthwise_arguments(
+    const Tensor& input,
+    const Tensor& output,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  return {
+      input.size(0),
+      input.size(1),
+      input.size(2),
+      input.size(3),
+      output.size(2),
+      output.size(3),
+      kernel_size[0],
+      kernel_size[1],
+      stride[0],
+      stride[1],
+      padding[0],
+      padding[1],
+      dilation[0],
+      dilation[1],
+  };
+}
+
+// The first n values of ptr, for the remainder of the channels
+template <typename Vec, typename scalar_t>
+inline Vec load_n(const scalar_t* ptr, int64_t n) {
+  return n >= Vec::size() ? Vec::loadu(ptr) : Vec::loadu(ptr, n);
+}
+
+template <typename Vec, typename scalar_t>
+inline void store_n(const Vec& v, scalar_t* ptr, int64_t n) {
+  if (n >= Vec::size()) {
+    v.store(ptr);
+  } else {
+    v.store(ptr, n);
+  }
+}
+
+// Calls f with the kernel size as compile time constants for the common
+// sizes, so that the loops over the kernel are unrolled, and as 0 otherwise
+template <typename func_t>
+void dispatch_kernel_size(int64_t kernel_rows, int64_t kernel_cols, const func_t& f) {
+  using size_1 = std::integral_constant<int64_t, 1>;
+  using size_3 = std::integral_constant<int64_t, 3>;
+  using size_5 = std::integral_constant<int64_t, 5>;
+  using size_7 = std::integral_constant<int64_t, 7>;
+  using size_runtime = std::integral_constant<int64_t, 0>;
+  if (kernel_rows == 3 && kernel_cols == 3) {
+    f(size_3(), size_3());
+  } else if (kernel_rows == 5 && kernel_cols == 5) {
+    f(size_5(), size_5());
+  } else if (kernel_rows == 7 && kernel_cols == 7) {
+    f(size_7(), size_7());
+  } else if (kernel_rows == 1 && kernel_cols == 3) {
+    f(size_1(), size_3());
+  } else if (kernel_rows == 3 && kernel_cols == 1) {
+    f(size_3(), size_1());
+  } else {
+    f(size_runtime(), size_runtime());
+  }
+}
+
+template <typename scalar_t, int64_t kKernelRows, int64_t kKernelCols>
+void conv_depthwise2d_impl(
+    const DepthwiseArguments& args,
+    const scalar_t* const input,
+    const scalar_t* const weight,
+    const scalar_t* const bias,
+    scalar_t* const output) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t kernel_rows = kKernelRows > 0 ? kKernelRows : args.kernel_rows;
+  const int64_t kernel_cols = kKernelCols > 0 ? kKernelCols : args.kernel_cols;
+  const int64_t channels = args.channels;
+
+  at::parallel_for(0, args.batch * args.out_rows, 1, [&](int64_t start, int64_t end) {
+    for (int64_t row = start; row < end; ++row) {
+      const int64_t n = row / args.out_rows;
+      const int64_t oy = row % args.out_rows;
+      const scalar_t* const input_n = input + n * args.in_rows * args.in_cols * channels;
+      for (int64_t ox = 0; ox < args.out_cols; ++ox) {
+        const int64_t iy0 = oy * args.stride_rows - args.pad_rows;
+        const int64_t ix0 = ox * args.stride_cols - args.pad_cols;
+        scalar_t* const output_pixel = output + (row * args.out_cols + ox) * channels;
+        for (int64_t c = 0; c < channels; c += Vec::size()) {
+          const int64_t count = std::min<int64_t>(Vec::size(), channels - c);
+          Vec acc = bias ? load_n<Vec>(bias + c, count) : Vec(0);
+          for (int64_t ky = 0; ky < kernel_rows; ++ky) {
+            const int64_t iy = iy0 + ky * args.dilation_rows;
+            if (iy < 0 || iy >= args.in_rows) {
+              continue;
+            }
+            for (int64_t kx = 0; kx < kernel_cols; ++kx) {
+              const int64_t ix = ix0 + kx * args.dilation_cols;
+              if (ix < 0 || ix >= args.in_cols) {
+                continue;
+              }
+              acc = vec256::fmadd(
+                  load_n<Vec>(input_n + (iy * args.in_cols + ix) * channels + c, count),
+                  load_n<Vec>(weight + (ky * kernel_cols + kx) * channels + c, count),
+                  acc);
+            }
+          }
+          store_n(acc, output_pixel + c, count);
+        }
+      }
+    }
+  });
+}
+
+// Each input pixel gathers the gradients of the output pixels it contributed
+// to, so that the rows of the input gradient are independent
+template <typename scalar_t, int64_t kKernelRows, int64_t kKernelCols>
+void conv_depthwise2d_backward_input_impl(
+    const DepthwiseArguments& args,
+    const scalar_t* const grad_output,
+    const scalar_t* const weight,
+    scalar_t* const grad_input) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t kernel_rows = kKernelRows > 0 ? kKernelRows : args.kernel_rows;
+  const int64_t kernel_cols = kKernelCols > 0 ? kKernelCols : args.kernel_cols;
+  const int64_t channels = args.channels;
+
+  at::parallel_for(0, args.batch * args.in_rows, 1, [&](int64_t start, int64_t end) {
+    for (int64_t row = start; row < end; ++row) {
+      const int64_t n = row / args.in_rows;
+      const int64_t iy = row % args.in_rows;
+      const scalar_t* const grad_output_n = grad_output + n * args.out_rows * args.out_cols * channels;
+      for (int64_t ix = 0; ix < args.in_cols; ++ix) {
+        scalar_t* const grad_input_pixel = grad_input + (row * args.in_cols + ix) * channels;
+        for (int64_t c = 0; c < channels; c += Vec::size()) {
+          const int64_t count = std::min<int64_t>(Vec::size(), channels - c);
+          Vec acc(0);
+          for (int64_t ky = 0; ky < kernel_rows; ++ky) {
+            const int64_t ty = iy + args.pad_rows - ky * args.dilation_rows;
+            if (ty < 0 || ty % args.stride_rows != 0 || ty / args.stride_rows >= args.out_rows) {
+              continue;
+            }
+            const int64_t oy = ty / args.stride_rows;
+            for (int64_t kx = 0; kx < kernel_cols; ++kx) {
+              const int64_t tx = ix + args.pad_cols - kx * args.dilation_cols;
+              if (tx < 0 || tx % args.stride_cols != 0 || tx / args.stride_cols >= args.out_cols) {
+                continue;
+              }
+              const int64_t ox = tx / args.stride_cols;
+              acc = vec256::fmadd(
+                  load_n<Vec>(grad_output_n + (oy * args.out_cols + ox) * channels + c, count),
+                  load_n<Vec>(weight + (ky * kernel_cols + kx) * channels + c, count),
+                  acc);
+            }
+          }
+          store_n(acc, grad_input_pixel + c, count);
+        }
+      }
+    }
+  });
+}
+
+// Each sample and block of channels accumulates into its own row of
+// grad_weight, which stays in cache while the output pixels are traversed
+template <typename scalar_t, int64_t kKernelRows, int64_t kKernelCols>
+void conv_depthwise2d_backward_weight_impl(
+    const DepthwiseArguments& args,
+    const scalar_t* const grad_output,
+    const scalar_t* const input,
+    scalar_t* const grad_weight) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t kernel_rows = kKernelRows > 0 ? kKernelRows : args.kernel_rows;
+  const int64_t kernel_cols = kKernelCols > 0 ? kKernelCols : args.kernel_cols;
+  const int64_t channels = args.channels;
+  const int64_t channel_blocks = (channels + Vec::size() - 1) / Vec::size();
+
+  at::parallel_for(0, args.batch * channel_blocks, 1, [&](int64_t start, int64_t end) {
+    for (int64_t task = start; task < end; ++task) {
+      const int64_t n = task / channel_blocks;
+      const int64_t c = (task % channel_blocks) * Vec::size();
+      const int64_t count = std::min<int64_t>(Vec::size(), channels - c);
+      const scalar_t* const input_n = input + n * args.in_rows * args.in_cols * channels;
+      const scalar_t* const grad_output_n = grad_output + n * args.out_rows * args.out_cols * channels;
+      scalar_t* const grad_weight_n = grad_weight + n * kernel_rows * kernel_cols * channels;
+      for (int64_t oy = 0; oy < args.out_rows; ++oy) {
+        for (int64_t ox = 0; ox < args.out_cols; ++ox) {
+          const Vec grad = load_n<Vec>(grad_output_n + (oy * args.out_cols + ox) * channels + c, count);
+          const int64_t iy0 = oy * args.stride_rows - args.pad_rows;
+          const int64_t ix0 = ox * args.stride_cols - args.pad_cols;
+          for (int64_t ky = 0; ky < kernel_rows; ++ky) {
+            const int64_t iy = iy0 + ky * args.dilation_rows;
+            if (iy < 0 || iy >= args.in_rows) {
+              continue;
+            }
+            for (int64_t kx = 0; kx < kernel_cols; ++kx) {
+              const int64_t ix = ix0 + kx * args.dilation_cols;
+              if (ix < 0 || ix >= args.in_cols) {
+                continue;
+              }
+              scalar_t* const grad_weight_k = grad_weight_n + (ky * kernel_cols + kx) * channels + c;
+              store_n(
+                  vec256::fmadd(
+                      grad,
+                      load_n<Vec>(input_n + (iy * args.in_cols + ix) * channels + c, count),
+                      load_n<Vec>(grad_weight_k, count)),
+                  grad_weight_k,
+                  count);
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+void conv_depthwise2d_kernel(
+    const Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  const auto args = depthwise_arguments(input, output, kernel_size, stride, padding, dilation);
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "conv_depthwise2d_cpu", [&] {
+    dispatch_kernel_size(args.kernel_rows, args.kernel_cols, [&](auto rows, auto cols) {
+      conv_depthwise2d_impl<scalar_t, decltype(rows)::value, decltype(cols)::value>(
+          args,
+          input.data_ptr<scalar_t>(),
+          weight.data_ptr<scalar_t>(),
+          bias.defined() ? bias.data_ptr<scalar_t>() : nullptr,
+          output.data_ptr<scalar_t>());
+    });
+  });
+}
+
+void conv_depthwise2d_backward_input_kernel(
+    const Tensor& grad_input,
+    const Tensor& grad_output,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  const auto args = depthwise_arguments(grad_input, grad_output, kernel_size, stride, padding, dilation);
+  AT_DISPATCH_FLOATING_TYPES(grad_input.scalar_type(), "conv_depthwise2d_backward_input_cpu", [&] {
+    dispatch_kernel_size(args.kernel_rows, args.kernel_cols, [&](auto rows, auto cols) {
+      conv_depthwise2d_backward_input_impl<scalar_t, decltype(rows)::value, decltype(cols)::value>(
+          args,
+          grad_output.data_ptr<scalar_t>(),
+          weight.data_ptr<scalar_t>(),
+          grad_input.data_ptr<scalar_t>());
+    });
+  });
+}
+
+void conv_depthwise2d_backward_weight_kernel(
+    const Tensor& grad_weight,
+    const Tensor& grad_output,
+    const Tensor& input,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  const auto args = depthwise_arguments(input, grad_output, kernel_size, stride, padding, dilation);
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "conv_depthwise2d_backward_weight_cpu", [&] {
+    dispatch_kernel_size(args.kernel_rows, args.kernel_cols, [&](auto rows, auto cols) {
+      conv_depthwise2d_backward_weight_impl<scalar_t, decltype(rows)::value, decltype(cols)::value>(
+          args,
+          grad_output.data_ptr<scalar_t>(),
+          input.data_ptr<scalar_t>(),
+          grad_weight.data_ptr<scalar_t>());
+    });
+  });
+}
+
 }  // namespace
 
 REGISTER_DISPATCH(convolution_depthwise3x3_winograd_stub, &_convolution_depthwise3x3_winograd);
+REGISTER_DISPATCH(conv_depthwise2d_stub, &conv_depthwise2d_kernel);
+REGISTER_DISPATCH(conv_depthwise2d_backward_input_stub, &conv_depthwise2d_backward_input_kernel);
+REGISTER_DISPATCH(conv_depthwise2d_backward_weight_stub, &conv_depthwise2d_backward_weight_kernel);
 
 }  // namespace native
 }  // namespace at
@@ -15,5 +15,28 @@ using convolution_depthwise3x3_winograd_fn =
 
 DECLARE_DISPATCH(convolution_depthwise3x3_winograd_fn, convolution_depthwise3x3_winograd_stub);
 
+/*
+  Direct depthwise convolution operators, vectorized over the channels and
+  specialized on the common kernel sizes. The input, output and their
+  gradients are channels last (N, C, H, W) tensors with as many input as
+  output channels, and the weight is a contiguous (KH * KW, C) tensor.
+  The weight gradient is computed into a zero-initialized (N, KH * KW, C)
+  tensor of the contributions of each sample.
+*/
+
+using conv_depthwise2d_fn = void (*)(
+    const Tensor& output, const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef kernel_size, IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation);
+using conv_depthwise2d_backward_input_fn = void (*)(
+    const Tensor& grad_input, const Tensor& grad_output, const Tensor& weight,
+    IntArrayRef kernel_size, IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation);
+using conv_depthwise2d_backward_weight_fn = void (*)(
+    const Tensor& grad_weight, const Tensor& grad_output, const Tensor& input,
+    IntArrayRef kernel_size, IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation);
+
+DECLARE_DISPATCH(conv_depthwise2d_fn, conv_depthwise2d_stub);
+DECLARE_DISPATCH(conv_depthwise2d_backward_input_fn, conv_depthwise2d_backward_input_stub);
+DECLARE_DISPATCH(conv_depthwise2d_backward_weight_fn, conv_depthwise2d_backward_weight_stub);
+
 }  // namespace native
 }  // namespace at
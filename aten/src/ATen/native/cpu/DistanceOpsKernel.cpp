@@ -3,9 +3,13 @@
 #include <numeric>
 #include <iterator>
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 #include <ATen/Dispatch.h>
+#include <ATen/NumericUtils.h>
 #include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
 #include <ATen/cpu/vml.h>
 
 namespace at { namespace native { namespace {
@@ -436,6 +440,76 @@ static void cdist_backward_kernel_impl(Tensor& result, const Tensor& grad, const
   });
 }
 
+// NaN is the largest distance, as in topk
+template <typename scalar_t>
+inline bool distance_less(scalar_t a, scalar_t b) {
+  return a < b || (at::_isnan(b) && !at::_isnan(a));
+}
+
+// The heap of the row i of values and indices holds the k smallest squared
+// distances of the col_offset columns before the tile, or all of them while
+// there are fewer than k
+template <typename scalar_t>
+void cdist_topk_update(Tensor& values, Tensor& indices, const Tensor& products,
+                       const Tensor& x1_norm, const Tensor& x2_norm, int64_t col_offset) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t rows = products.size(0);
+  const int64_t cols = products.size(1);
+  const int64_t k = values.size(1);
+  scalar_t* products_data = products.data_ptr<scalar_t>();
+  scalar_t* values_data = values.data_ptr<scalar_t>();
+  int64_t* indices_data = indices.data_ptr<int64_t>();
+  const scalar_t* x1_norm_data = x1_norm.data_ptr<scalar_t>();
+  const scalar_t* x2_norm_data = x2_norm.data_ptr<scalar_t>();
+
+  using heap_entry = std::pair<scalar_t, int64_t>;
+  auto heap_less = [](const heap_entry& a, const heap_entry& b) {
+    return distance_less(a.first, b.first);
+  };
+  const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(cols, 1));
+  at::parallel_for(0, rows, grain_size, [&](int64_t start, int64_t end) {
+    std::vector<heap_entry> heap;
+    heap.reserve(k);
+    for (int64_t i = start; i < end; i++) {
+      // ||x1||^2 + ||x2||^2 - 2 * x1 * x2^T, clamped to 0 against cancellation
+      scalar_t* dist = products_data + i * cols;
+      const Vec x1_norm_vec(x1_norm_data[i]);
+      vec256::map2(
+          [&](Vec product, Vec x2_norm_vec) {
+            return vec256::maximum(x1_norm_vec + x2_norm_vec - Vec(2) * product, Vec(0));
+          },
+          dist, dist, x2_norm_data, cols);
+
+      scalar_t* row_values = values_data + i * k;
+      int64_t* row_indices = indices_data + i * k;
+      heap.clear();
+      for (int64_t j = 0; j < std::min(k, col_offset); j++) {
+        heap.emplace_back(row_values[j], row_indices[j]);
+      }
+      for (int64_t j = 0; j < cols; j++) {
+        if (static_cast<int64_t>(heap.size()) < k) {
+          heap.emplace_back(dist[j], col_offset + j);
+          std::push_heap(heap.begin(), heap.end(), heap_less);
+        } else if (distance_less(dist[j], heap.front().first)) {
+          std::pop_heap(heap.begin(), heap.end(), heap_less);
+          heap.back() = heap_entry(dist[j], col_offset + j);
+          std::push_heap(heap.begin(), heap.end(), heap_less);
+        }
+      }
+      for (int64_t j = 0; j < static_cast<int64_t>(heap.size()); j++) {
+        row_values[j] = heap[j].first;
+        row_indices[j] = heap[j].second;
+      }
+    }
+  });
+}
+
+static void cdist_topk_update_kernel_impl(Tensor& values, Tensor& indices, const Tensor& products,
+                                          const Tensor& x1_norm, const Tensor& x2_norm, int64_t col_offset) {
+  AT_DISPATCH_FLOATING_TYPES(products.scalar_type(), "cdist_topk", [&] {
+    cdist_topk_update<scalar_t>(values, indices, products, x1_norm, x2_norm, col_offset);
+  });
+}
 
 }  // anonymous namespace
 
@@ -443,5 +517,6 @@ REGISTER_DISPATCH(pdist_forward_stub, &pdist_forward_kernel_impl);
 REGISTER_DISPATCH(pdist_backward_stub, &pdist_backward_kernel_impl);
 REGISTER_DISPATCH(cdist_stub, &cdist_kernel_impl);
 REGISTER_DISPATCH(cdist_backward_stub, &cdist_backward_kernel_impl);
+REGISTER_DISPATCH(cdist_topk_update_stub, &cdist_topk_update_kernel_impl);
 
 }}  // namespace at::native
@@ -2,11 +2,15 @@
 
 #include <ATen/Dispatch.h>
 #include <ATen/CPUApplyUtils.h>
+#include <ATen/Parallel.h>
 #include <ATen/core/DistributionsHelper.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
+#include <algorithm>
 #include <limits>
 #include <mutex>
+#include <type_traits>
+#include <utility>
 
 #ifdef CPU_CAPABILITY_AVX2
 #include <ATen/native/cpu/avx_mathfun.h>
@@ -348,6 +352,190 @@ void bernoulli_kernel(Tensor& self, double p, RNG generator) {
   });
 }
 
+// ==================================================== Philox ========================================================
+
+// The kernels of the generators in counter-based mode, see
+// Note [Counter-based CPU generation]
+
+// The number of counters whose blocks are computed together, in structure of
+// arrays form so that the rounds are vectorized
+constexpr int64_t kPhiloxCounters = 16;
+
+// Computes the Philox4x32-10 blocks of the kPhiloxCounters counters starting
+// at `counter`, the 4 numbers of each in a row, as
+// at::philox_engine(seed, /*subsequence=*/0, counter) produces them.
+inline void philox_blocks(uint64_t seed, uint64_t counter, uint32_t* out) {
+  constexpr uint32_t kPhilox10A = 0x9E3779B9;
+  constexpr uint32_t kPhilox10B = 0xBB67AE85;
+  constexpr uint32_t kPhiloxSA = 0xD2511F53;
+  constexpr uint32_t kPhiloxSB = 0xCD9E8D57;
+  uint32_t c0[kPhiloxCounters], c1[kPhiloxCounters], c2[kPhiloxCounters], c3[kPhiloxCounters];
+  for (int64_t l = 0; l < kPhiloxCounters; ++l) {
+    const uint64_t c = counter + l;
+    c0[l] = static_cast<uint32_t>(c);
+    c1[l] = static_cast<uint32_t>(c >> 32);
+    c2[l] = 0;
+    c3[l] = 0;
+  }
+  uint32_t k0 = static_cast<uint32_t>(seed);
+  uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+  for (int round = 0; round < 10; ++round) {
+    for (int64_t l = 0; l < kPhiloxCounters; ++l) {
+      const uint64_t p0 = static_cast<uint64_t>(kPhiloxSA) * c0[l];
+      const uint64_t p1 = static_cast<uint64_t>(kPhiloxSB) * c2[l];
+      const uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[l] ^ k0;
+      const uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[l] ^ k1;
+      c0[l] = n0;
+      c1[l] = static_cast<uint32_t>(p1);
+      c2[l] = n2;
+      c3[l] = static_cast<uint32_t>(p0);
+    }
+    k0 += kPhilox10A;
+    k1 += kPhilox10B;
+  }
+  for (int64_t l = 0; l < kPhiloxCounters; ++l) {
+    out[4 * l] = c0[l];
+    out[4 * l + 1] = c1[l];
+    out[4 * l + 2] = c2[l];
+    out[4 * l + 3] = c3[l];
+  }
+}
+
+// A float in [0, 1) made of the 24 high bits of x
+inline float philox_uniform_float(uint32_t x) {
+  return static_cast<float>(x >> 8) * (1.0f / (1 << 24));
+}
+
+// A double in [0, 1) made of the 53 high bits of hi and lo
+inline double philox_uniform_double(uint32_t hi, uint32_t lo) {
+  const uint64_t x = (static_cast<uint64_t>(hi) << 32) | lo;
+  return static_cast<double>(x >> 11) * (1.0 / (static_cast<uint64_t>(1) << 53));
+}
+
+// Fills self with kPerCounter values per counter, which
+// transform(randoms, values) computes from the blocks of kPhiloxCounters
+// counters. The i-th element of self only depends on the block of the
+// counter offset + i / kPerCounter.
+template <typename scalar_t, int64_t kPerCounter, typename RNG, typename Transform>
+void philox_fill(Tensor& self, RNG generator, const Transform& transform) {
+  const int64_t numel = self.numel();
+  if (numel == 0) {
+    return;
+  }
+  Tensor out = self.is_contiguous() ? self : at::empty(self.sizes(), self.options());
+  const int64_t num_counters = (numel + kPerCounter - 1) / kPerCounter;
+  std::pair<uint64_t, uint64_t> inputs;
+  {
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(generator->mutex_);
+    inputs = generator->philox_engine_inputs(num_counters);
+  }
+  const uint64_t seed = inputs.first;
+  const uint64_t offset = inputs.second;
+  scalar_t* data = out.data_ptr<scalar_t>();
+  at::parallel_for(0, num_counters, internal::GRAIN_SIZE / kPerCounter, [&](int64_t begin, int64_t end) {
+    uint32_t randoms[4 * kPhiloxCounters];
+    scalar_t values[kPerCounter * kPhiloxCounters];
+    for (int64_t counter = begin; counter < end; counter += kPhiloxCounters) {
+      philox_blocks(seed, offset + counter, randoms);
+      transform(randoms, values);
+      const int64_t first = counter * kPerCounter;
+      const int64_t last = std::min(end * kPerCounter, numel);
+      std::copy(values, values + std::min(kPerCounter * kPhiloxCounters, last - first), data + first);
+    }
+  });
+  if (!out.is_same(self)) {
+    self.copy_(out);
+  }
+}
+
+template<typename RNG>
+void philox_uniform_kernel(Tensor& self, double from, double to, RNG generator) {
+  AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, self.scalar_type(), "uniform_kernel_cpu", [&]() {
+    if (std::is_same<scalar_t, double>::value) {
+      // a double of 2 numbers
+      philox_fill<scalar_t, 2>(self, generator, [from, to](const uint32_t* randoms, scalar_t* values) {
+        for (int64_t i = 0; i < 2 * kPhiloxCounters; ++i) {
+          const double u = philox_uniform_double(randoms[2 * i], randoms[2 * i + 1]);
+          values[i] = static_cast<scalar_t>(u * (to - from) + from);
+        }
+      });
+    } else {
+      const auto from_ = static_cast<float>(from);
+      const auto range = static_cast<float>(to - from);
+      philox_fill<scalar_t, 4>(self, generator, [from_, range](const uint32_t* randoms, scalar_t* values) {
+        for (int64_t i = 0; i < 4 * kPhiloxCounters; ++i) {
+          values[i] = static_cast<scalar_t>(philox_uniform_float(randoms[i]) * range + from_);
+        }
+      });
+    }
+  });
+}
+
+// Box-Muller transform of the pairs of uniforms (u1[i], u2[i]), with u1[i] in
+// (0, 1], into the pairs of normal values (z0[i], z1[i])
+template <typename T, int64_t kPairs>
+void philox_box_muller(const T* u1, const T* u2, T mean, T std, T* z0, T* z1) {
+  using Vec = vec256::Vec256<T>;
+  static_assert(kPairs % Vec::size() == 0, "the pairs must fill whole vectors");
+  const Vec minus_two(-2), two_pi(2.0 * c10::pi<double>), mean_v(mean), std_v(std);
+  for (int64_t i = 0; i < kPairs; i += Vec::size()) {
+    const Vec radius = (Vec::loadu(u1 + i).log() * minus_two).sqrt() * std_v;
+    const Vec theta = Vec::loadu(u2 + i) * two_pi;
+    (radius * theta.cos() + mean_v).store(z0 + i);
+    (radius * theta.sin() + mean_v).store(z1 + i);
+  }
+}
+
+template<typename RNG>
+void philox_normal_kernel(Tensor& self, double mean, double std, RNG generator) {
+  AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, self.scalar_type(), "normal_kernel_cpu", [&]() {
+    if (std::is_same<scalar_t, double>::value) {
+      // a pair of doubles of 4 numbers
+      philox_fill<scalar_t, 2>(self, generator, [mean, std](const uint32_t* randoms, scalar_t* values) {
+        double u1[kPhiloxCounters], u2[kPhiloxCounters], z0[kPhiloxCounters], z1[kPhiloxCounters];
+        for (int64_t i = 0; i < kPhiloxCounters; ++i) {
+          u1[i] = 1.0 - philox_uniform_double(randoms[4 * i], randoms[4 * i + 1]);
+          u2[i] = philox_uniform_double(randoms[4 * i + 2], randoms[4 * i + 3]);
+        }
+        philox_box_muller<double, kPhiloxCounters>(u1, u2, mean, std, z0, z1);
+        for (int64_t i = 0; i < kPhiloxCounters; ++i) {
+          values[2 * i] = static_cast<scalar_t>(z0[i]);
+          values[2 * i + 1] = static_cast<scalar_t>(z1[i]);
+        }
+      });
+    } else {
+      // a pair of floats of 2 numbers
+      const auto mean_ = static_cast<float>(mean);
+      const auto std_ = static_cast<float>(std);
+      philox_fill<scalar_t, 4>(self, generator, [mean_, std_](const uint32_t* randoms, scalar_t* values) {
+        constexpr int64_t kPairs = 2 * kPhiloxCounters;
+        float u1[kPairs], u2[kPairs], z0[kPairs], z1[kPairs];
+        for (int64_t i = 0; i < kPairs; ++i) {
+          u1[i] = 1.0f - philox_uniform_float(randoms[2 * i]);
+          u2[i] = philox_uniform_float(randoms[2 * i + 1]);
+        }
+        philox_box_muller<float, kPairs>(u1, u2, mean_, std_, z0, z1);
+        for (int64_t i = 0; i < kPairs; ++i) {
+          values[2 * i] = static_cast<scalar_t>(z0[i]);
+          values[2 * i + 1] = static_cast<scalar_t>(z1[i]);
+        }
+      });
+    }
+  });
+}
+
+template<typename RNG>
+void philox_bernoulli_kernel(Tensor& self, double p, RNG generator) {
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "bernoulli_scalar_cpu_", [&] {
+    philox_fill<scalar_t, 4>(self, generator, [p](const uint32_t* randoms, scalar_t* values) {
+      for (int64_t i = 0; i < 4 * kPhiloxCounters; ++i) {
+        values[i] = static_cast<scalar_t>(randoms[i] * (1.0 / 4294967296.0) < p);
+      }
+    });
+  });
+}
+
 template<typename RNG>
 struct BernoulliKernel {
   void operator()(Tensor& self, double p, c10::optional<Generator> gen) {
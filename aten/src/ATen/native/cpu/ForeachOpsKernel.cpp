@@ -0,0 +1,487 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/ForeachOps.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+
+using namespace vec256;
+
+// Note [CPU foreach kernels]
+// The CPU _foreach_* ops used to loop over the tensors of their lists, calling
+// the op of a single tensor on each of them, with its own dispatch,
+// TensorIterator and parallel region. With many small tensors, like the
+// parameters of an optimizer, that overhead costs more than the math. The
+// multi-tensor kernels instead run the op on all of the tensors in a single
+// parallel region over the elements of the list: the ranges of elements of
+// the threads are balanced by element count, so that the small tensors are
+// grouped together and the large ones split, and each range is swept with
+// Vec256 over the slices of the tensors it spans.
+//
+// The tensors of the lists must be CPU float or double tensors, and the
+// corresponding tensors of the lists must be non-overlapping and dense, of
+// the same strides, so that their elements are swept linearly, in the same
+// order (see can_use_fast_route in ForeachUtils.h); the other lists go
+// through the per-tensor loops of ForeachOpsKernels.cpp.
+
+// Calls fn(t, begin, end) on the ranges [begin, end) of the elements of each
+// tensor t of the list which the threads get
+template <typename func_t>
+void foreach_parallel_for(TensorList tensors, const func_t& fn) {
+  const int64_t ntensors = tensors.size();
+  std::vector<int64_t> offsets(ntensors + 1, 0);
+  for (int64_t t = 0; t < ntensors; t++) {
+    offsets[t + 1] = offsets[t] + tensors[t].numel();
+  }
+  at::parallel_for(0, offsets[ntensors], internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    int64_t t = std::upper_bound(offsets.begin(), offsets.end(), begin) - offsets.begin() - 1;
+    for (; begin < end; t++) {
+      const int64_t tensor_end = std::min(end, offsets[t + 1]);
+      if (tensor_end > begin) {
+        fn(t, begin - offsets[t], tensor_end - offsets[t]);
+      }
+      begin = tensor_end;
+    }
+  });
+}
+
+template <typename scalar_t>
+std::vector<scalar_t*> data_ptrs(TensorList tensors) {
+  std::vector<scalar_t*> ptrs;
+  ptrs.reserve(tensors.size());
+  for (const auto& t : tensors) {
+    ptrs.push_back(t.data_ptr<scalar_t>());
+  }
+  return ptrs;
+}
+
+// The scalar of each tensor, from a single scalar or a list of them
+template <typename scalar_t>
+std::vector<scalar_t> scalar_values(ArrayRef<Scalar> scalars, int64_t ntensors) {
+  std::vector<scalar_t> values(ntensors);
+  for (int64_t t = 0; t < ntensors; t++) {
+    values[t] = scalars[scalars.size() == 1 ? 0 : t].to<scalar_t>();
+  }
+  return values;
+}
+
+// out[d] = op(inputs[d]...) for d in [0, size)
+template <typename scalar_t, typename op_t, typename vec_op_t, typename... inputs_t>
+inline void foreach_map(
+    const op_t& op,
+    const vec_op_t& vec_op,
+    scalar_t* out,
+    int64_t size,
+    const inputs_t*... inputs) {
+  using Vec = Vec256<scalar_t>;
+  int64_t d = 0;
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    vec_op(Vec::loadu(inputs + d)...).store(out + d);
+  }
+  for (; d < size; d++) {
+    out[d] = op(inputs[d]...);
+  }
+}
+
+template <typename scalar_t>
+inline scalar_t maximum_propagate_nan(scalar_t a, scalar_t b) {
+  if (a != a || b != b) {
+    return std::numeric_limits<scalar_t>::quiet_NaN();
+  }
+  return std::max(a, b);
+}
+
+template <typename scalar_t>
+inline scalar_t minimum_propagate_nan(scalar_t a, scalar_t b) {
+  if (a != a || b != b) {
+    return std::numeric_limits<scalar_t>::quiet_NaN();
+  }
+  return std::min(a, b);
+}
+
+// out = op(a, b), with b multiplied by alpha for add and sub
+template <typename scalar_t>
+void binary_op(
+    ForeachBinaryOp op,
+    scalar_t* out,
+    int64_t size,
+    const scalar_t* a,
+    const scalar_t* b,
+    scalar_t alpha) {
+  using Vec = Vec256<scalar_t>;
+  switch (op) {
+    case ForeachBinaryOp::SUB:
+      alpha = -alpha;
+      // fallthrough
+    case ForeachBinaryOp::ADD: {
+      const Vec alpha_vec(alpha);
+      foreach_map(
+          [=](scalar_t x, scalar_t y) { return x + alpha * y; },
+          [=](Vec x, Vec y) { return vec256::fmadd(y, alpha_vec, x); },
+          out, size, a, b);
+      break;
+    }
+    case ForeachBinaryOp::MUL:
+      foreach_map(
+          [](scalar_t x, scalar_t y) { return x * y; },
+          [](Vec x, Vec y) { return x * y; },
+          out, size, a, b);
+      break;
+    case ForeachBinaryOp::DIV:
+      foreach_map(
+          [](scalar_t x, scalar_t y) { return x / y; },
+          [](Vec x, Vec y) { return x / y; },
+          out, size, a, b);
+      break;
+    case ForeachBinaryOp::MAXIMUM:
+      foreach_map(
+          [](scalar_t x, scalar_t y) { return maximum_propagate_nan(x, y); },
+          [](Vec x, Vec y) { return vec256::maximum(x, y); },
+          out, size, a, b);
+      break;
+    case ForeachBinaryOp::MINIMUM:
+      foreach_map(
+          [](scalar_t x, scalar_t y) { return minimum_propagate_nan(x, y); },
+          [](Vec x, Vec y) { return vec256::minimum(x, y); },
+          out, size, a, b);
+      break;
+  }
+}
+
+// out = op(a, b) with a scalar b
+template <typename scalar_t>
+void binary_scalar_op(
+    ForeachBinaryOp op,
+    scalar_t* out,
+    int64_t size,
+    const scalar_t* a,
+    scalar_t b) {
+  using Vec = Vec256<scalar_t>;
+  const Vec b_vec(b);
+  switch (op) {
+    case ForeachBinaryOp::ADD:
+      foreach_map(
+          [=](scalar_t x) { return x + b; },
+          [=](Vec x) { return x + b_vec; },
+          out, size, a);
+      break;
+    case ForeachBinaryOp::SUB:
+      foreach_map(
+          [=](scalar_t x) { return x - b; },
+          [=](Vec x) { return x - b_vec; },
+          out, size, a);
+      break;
+    case ForeachBinaryOp::MUL:
+      foreach_map(
+          [=](scalar_t x) { return x * b; },
+          [=](Vec x) { return x * b_vec; },
+          out, size, a);
+      break;
+    case ForeachBinaryOp::DIV:
+      foreach_map(
+          [=](scalar_t x) { return x / b; },
+          [=](Vec x) { return x / b_vec; },
+          out, size, a);
+      break;
+    case ForeachBinaryOp::MAXIMUM:
+      foreach_map(
+          [=](scalar_t x) { return maximum_propagate_nan(x, b); },
+          [=](Vec x) { return vec256::maximum(x, b_vec); },
+          out, size, a);
+      break;
+    case ForeachBinaryOp::MINIMUM:
+      foreach_map(
+          [=](scalar_t x) { return minimum_propagate_nan(x, b); },
+          [=](Vec x) { return vec256::minimum(x, b_vec); },
+          out, size, a);
+      break;
+  }
+}
+
+template <typename scalar_t>
+void unary_op(ForeachUnaryOp op, scalar_t* out, int64_t size, const scalar_t* a) {
+  using Vec = Vec256<scalar_t>;
+#define FOREACH_UNARY_CASE(NAME, EXPR, VEC_EXPR)                    \
+    case ForeachUnaryOp::NAME:                                    \
+      foreach_map(                                                  \
+          [](scalar_t x) -> scalar_t { return EXPR; },              \
+          [](Vec x) { return VEC_EXPR; },                           \
+          out, size, a);                                            \
+      break;
+  switch (op) {
+    FOREACH_UNARY_CASE(SQRT, std::sqrt(x), x.sqrt())
+    FOREACH_UNARY_CASE(EXP, std::exp(x), x.exp())
+    FOREACH_UNARY_CASE(LOG, std::log(x), x.log())
+    FOREACH_UNARY_CASE(LOG10, std::log10(x), x.log10())
+    FOREACH_UNARY_CASE(LOG2, std::log2(x), x.log2())
+    FOREACH_UNARY_CASE(LOG1P, std::log1p(x), x.log1p())
+    FOREACH_UNARY_CASE(EXPM1, std::expm1(x), x.expm1())
+    FOREACH_UNARY_CASE(ABS, std::abs(x), x.abs())
+    FOREACH_UNARY_CASE(NEG, -x, x.neg())
+    FOREACH_UNARY_CASE(RECIPROCAL, static_cast<scalar_t>(1) / x, x.reciprocal())
+    FOREACH_UNARY_CASE(SIGMOID,
+                       static_cast<scalar_t>(1) / (static_cast<scalar_t>(1) + std::exp(-x)),
+                       (Vec(static_cast<scalar_t>(1)) + x.neg().exp()).reciprocal())
+    FOREACH_UNARY_CASE(SIN, std::sin(x), x.sin())
+    FOREACH_UNARY_CASE(COS, std::cos(x), x.cos())
+    FOREACH_UNARY_CASE(TAN, std::tan(x), x.tan())
+    FOREACH_UNARY_CASE(TANH, std::tanh(x), x.tanh())
+    FOREACH_UNARY_CASE(ERF, std::erf(x), x.erf())
+    FOREACH_UNARY_CASE(ERFC, std::erfc(x), x.erfc())
+    FOREACH_UNARY_CASE(FLOOR, std::floor(x), x.floor())
+    FOREACH_UNARY_CASE(CEIL, std::ceil(x), x.ceil())
+    FOREACH_UNARY_CASE(TRUNC, std::trunc(x), x.trunc())
+  }
+#undef FOREACH_UNARY_CASE
+}
+
+void foreach_binary_scalar_kernel(
+    TensorList out,
+    TensorList self,
+    ArrayRef<Scalar> scalars,
+    ForeachBinaryOp op) {
+  AT_DISPATCH_FLOATING_TYPES(self[0].scalar_type(), "foreach_binary_scalar_cpu", [&] {
+    const auto out_data = data_ptrs<scalar_t>(out);
+    const auto self_data = data_ptrs<scalar_t>(self);
+    const auto values = scalar_values<scalar_t>(scalars, self.size());
+    foreach_parallel_for(self, [&](int64_t t, int64_t begin, int64_t end) {
+      binary_scalar_op<scalar_t>(
+          op, out_data[t] + begin, end - begin, self_data[t] + begin, values[t]);
+    });
+  });
+}
+
+void foreach_binary_list_kernel(
+    TensorList out,
+    TensorList self,
+    TensorList other,
+    Scalar alpha,
+    ForeachBinaryOp op) {
+  AT_DISPATCH_FLOATING_TYPES(self[0].scalar_type(), "foreach_binary_list_cpu", [&] {
+    const auto out_data = data_ptrs<scalar_t>(out);
+    const auto self_data = data_ptrs<scalar_t>(self);
+    const auto other_data = data_ptrs<scalar_t>(other);
+    const scalar_t alpha_value = alpha.to<scalar_t>();
+    foreach_parallel_for(self, [&](int64_t t, int64_t begin, int64_t end) {
+      binary_op<scalar_t>(
+          op, out_data[t] + begin, end - begin, self_data[t] + begin,
+          other_data[t] + begin, alpha_value);
+    });
+  });
+}
+
+void foreach_unary_kernel(TensorList out, TensorList self, ForeachUnaryOp op) {
+  AT_DISPATCH_FLOATING_TYPES(self[0].scalar_type(), "foreach_unary_cpu", [&] {
+    const auto out_data = data_ptrs<scalar_t>(out);
+    const auto self_data = data_ptrs<scalar_t>(self);
+    foreach_parallel_for(self, [&](int64_t t, int64_t begin, int64_t end) {
+      unary_op<scalar_t>(op, out_data[t] + begin, end - begin, self_data[t] + begin);
+    });
+  });
+}
+
+void foreach_pointwise_kernel(
+    TensorList out,
+    TensorList self,
+    TensorList tensor1,
+    TensorList tensor2,
+    ArrayRef<Scalar> scalars,
+    ForeachPointwiseOp op) {
+  AT_DISPATCH_FLOATING_TYPES(self[0].scalar_type(), "foreach_pointwise_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const auto out_data = data_ptrs<scalar_t>(out);
+    const auto self_data = data_ptrs<scalar_t>(self);
+    const auto tensor1_data = data_ptrs<scalar_t>(tensor1);
+    const auto tensor2_data = data_ptrs<scalar_t>(tensor2);
+    const auto values = scalar_values<scalar_t>(scalars, self.size());
+    foreach_parallel_for(self, [&](int64_t t, int64_t begin, int64_t end) {
+      const scalar_t value = values[t];
+      const Vec value_vec(value);
+      scalar_t* o = out_data[t] + begin;
+      const scalar_t* a = self_data[t] + begin;
+      const scalar_t* b = tensor1_data[t] + begin;
+      const scalar_t* c = tensor2_data[t] + begin;
+      if (op == ForeachPointwiseOp::ADDCMUL) {
+        foreach_map(
+            [=](scalar_t x, scalar_t y, scalar_t z) { return x + value * y * z; },
+            [=](Vec x, Vec y, Vec z) { return x + value_vec * y * z; },
+            o, end - begin, a, b, c);
+      } else {
+        foreach_map(
+            [=](scalar_t x, scalar_t y, scalar_t z) { return x + value * y / z; },
+            [=](Vec x, Vec y, Vec z) { return x + value_vec * y / z; },
+            o, end - begin, a, b, c);
+      }
+    });
+  });
+}
+
+// The hyper parameters of an Adam step, see _fused_adam_
+template <typename scalar_t>
+struct AdamHyperParams {
+  scalar_t lr;
+  scalar_t beta1;
+  scalar_t beta2;
+  scalar_t weight_decay;
+  scalar_t eps;
+  scalar_t step_size;
+  scalar_t sqrt_bias_correction2;
+  scalar_t grad_scale;
+  bool decoupled_weight_decay;
+};
+
+template <typename scalar_t>
+inline Vec256<scalar_t> adam_sqrt(const Vec256<scalar_t>& x) {
+  return x.sqrt();
+}
+
+inline float adam_sqrt(float x) {
+  return std::sqrt(x);
+}
+
+inline double adam_sqrt(double x) {
+  return std::sqrt(x);
+}
+
+template <typename scalar_t>
+inline Vec256<scalar_t> adam_max(const Vec256<scalar_t>& a, const Vec256<scalar_t>& b) {
+  return vec256::maximum(a, b);
+}
+
+template <typename scalar_t>
+inline scalar_t adam_max(scalar_t a, scalar_t b) {
+  return maximum_propagate_nan(a, b);
+}
+
+// The Adam step of a single element or a Vec256 of them, with T either
+// scalar_t or Vec256<scalar_t>; fuses the mul, add and addcmul of the
+// moments with the addcdiv of the parameter
+template <bool amsgrad, typename T, typename scalar_t>
+inline void adam_update(
+    const AdamHyperParams<scalar_t>& hp,
+    T& p,
+    T g,
+    T& m,
+    T& v,
+    T& max_v) {
+  const scalar_t one(1);
+  g = g * T(hp.grad_scale);
+  if (hp.weight_decay != 0) {
+    if (hp.decoupled_weight_decay) {
+      p = p * T(one - hp.lr * hp.weight_decay);
+    } else {
+      g = g + T(hp.weight_decay) * p;
+    }
+  }
+  m = T(hp.beta1) * m + T(one - hp.beta1) * g;
+  v = T(hp.beta2) * v + T(one - hp.beta2) * g * g;
+  T denom;
+  if (amsgrad) {
+    max_v = adam_max(max_v, v);
+    denom = adam_sqrt(max_v) / T(hp.sqrt_bias_correction2) + T(hp.eps);
+  } else {
+    denom = adam_sqrt(v) / T(hp.sqrt_bias_correction2) + T(hp.eps);
+  }
+  p = p - T(hp.step_size) * m / denom;
+}
+
+// The Adam step of the elements [0, size) of a parameter
+template <typename scalar_t, bool amsgrad>
+void adam_step(
+    const AdamHyperParams<scalar_t>& hp,
+    int64_t size,
+    scalar_t* param,
+    const scalar_t* grad,
+    scalar_t* exp_avg,
+    scalar_t* exp_avg_sq,
+    scalar_t* max_exp_avg_sq) {
+  using Vec = Vec256<scalar_t>;
+  int64_t d = 0;
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    Vec p = Vec::loadu(param + d);
+    Vec m = Vec::loadu(exp_avg + d);
+    Vec v = Vec::loadu(exp_avg_sq + d);
+    Vec max_v = amsgrad ? Vec::loadu(max_exp_avg_sq + d) : Vec(0);
+    adam_update<amsgrad>(hp, p, Vec::loadu(grad + d), m, v, max_v);
+    p.store(param + d);
+    m.store(exp_avg + d);
+    v.store(exp_avg_sq + d);
+    if (amsgrad) {
+      max_v.store(max_exp_avg_sq + d);
+    }
+  }
+  for (; d < size; d++) {
+    scalar_t max_v = amsgrad ? max_exp_avg_sq[d] : scalar_t(0);
+    adam_update<amsgrad>(hp, param[d], grad[d], exp_avg[d], exp_avg_sq[d], max_v);
+    if (amsgrad) {
+      max_exp_avg_sq[d] = max_v;
+    }
+  }
+}
+
+void fused_adam_kernel(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    double lr,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps,
+    double step_size,
+    double sqrt_bias_correction2,
+    bool amsgrad,
+    bool decoupled_weight_decay,
+    double grad_scale) {
+  AT_DISPATCH_FLOATING_TYPES(params[0].scalar_type(), "fused_adam_cpu", [&] {
+    AdamHyperParams<scalar_t> hp{
+        static_cast<scalar_t>(lr),
+        static_cast<scalar_t>(beta1),
+        static_cast<scalar_t>(beta2),
+        static_cast<scalar_t>(weight_decay),
+        static_cast<scalar_t>(eps),
+        static_cast<scalar_t>(step_size),
+        static_cast<scalar_t>(sqrt_bias_correction2),
+        static_cast<scalar_t>(grad_scale),
+        decoupled_weight_decay};
+    const auto param_data = data_ptrs<scalar_t>(params);
+    const auto grad_data = data_ptrs<scalar_t>(grads);
+    const auto exp_avg_data = data_ptrs<scalar_t>(exp_avgs);
+    const auto exp_avg_sq_data = data_ptrs<scalar_t>(exp_avg_sqs);
+    const auto max_exp_avg_sq_data = data_ptrs<scalar_t>(max_exp_avg_sqs);
+    foreach_parallel_for(params, [&](int64_t t, int64_t begin, int64_t end) {
+      if (amsgrad) {
+        adam_step<scalar_t, true>(
+            hp, end - begin, param_data[t] + begin, grad_data[t] + begin,
+            exp_avg_data[t] + begin, exp_avg_sq_data[t] + begin,
+            max_exp_avg_sq_data[t] + begin);
+      } else {
+        adam_step<scalar_t, false>(
+            hp, end - begin, param_data[t] + begin, grad_data[t] + begin,
+            exp_avg_data[t] + begin, exp_avg_sq_data[t] + begin, nullptr);
+      }
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(foreach_binary_scalar_stub, &foreach_binary_scalar_kernel);
+REGISTER_DISPATCH(foreach_binary_list_stub, &foreach_binary_list_kernel);
+REGISTER_DISPATCH(foreach_unary_stub, &foreach_unary_kernel);
+REGISTER_DISPATCH(foreach_pointwise_stub, &foreach_pointwise_kernel);
+REGISTER_DISPATCH(fused_adam_stub, &fused_adam_kernel);
+
+}} // namespace at::native
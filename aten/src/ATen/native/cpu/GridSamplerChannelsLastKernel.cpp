@@ -0,0 +1,453 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/GridSampler.h>
+#include <ATen/native/UpSample.h>
+#include <ATen/native/cpu/GridSamplerKernel.h>
+#include <ATen/native/cpu/utils.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace at { namespace native {
+
+namespace {
+
+using at::native::detail::GridSamplerInterpolation;
+using at::native::detail::GridSamplerPadding;
+
+// Note [Channels last grid sampler]
+// The kernels of GridSamplerKernel.cpp vectorize over the output pixels of a
+// channel, gathering the input pixels each of them reads, and the 3-d grid
+// sampler isn't vectorized at all. For channels last inputs, the kernels here
+// compute the row of channels of an output pixel at once, as the weighted sum
+// of the rows of the input pixels around its source location, which are
+// contiguous and vectorized over. A 4-d (2-d spatial) input is treated as a
+// 5-d input of depth 1.
+//
+// The interpolation is separable, so the input pixels read and their weights
+// are computed along each spatial dim (Taps), and combined.
+//
+// The backward kernels add the weighted row of grad_output to the rows of
+// grad_input of the same input pixels, which different output pixels read.
+// When there are at least as many images as threads, the images are split
+// among the threads. Otherwise the threads split the output pixels, and add to
+// grad_input buffers of their own, which are summed at the end.
+//
+// affine_grid_sampler (see GridSampler.cpp) computes the source location of
+// an output pixel from theta as affine_grid_generator does, without
+// materializing the grid.
+
+// The input pixels an interpolation reads along one spatial dim, with their
+// weights and the derivatives of the weights by the source coordinate. Pixels
+// out of bounds, which are zeros, are left out.
+template <typename scalar_t>
+struct Taps {
+  int64_t size = 0;
+  int64_t index[4];
+  scalar_t weight[4];
+  scalar_t dweight[4];
+  // d source coordinate / d grid coordinate
+  scalar_t mult = 1;
+
+  void add(int64_t i, scalar_t w, scalar_t dw, int64_t bound) {
+    if (i >= 0 && i < bound) {
+      index[size] = i;
+      weight[size] = w;
+      dweight[size] = dw;
+      size++;
+    }
+  }
+};
+
+template <typename scalar_t>
+static inline Taps<scalar_t> compute_taps(
+    scalar_t coord,
+    int64_t size,
+    GridSamplerInterpolation interpolation_mode,
+    GridSamplerPadding padding_mode,
+    bool align_corners) {
+  Taps<scalar_t> taps;
+  if (interpolation_mode == GridSamplerInterpolation::Bilinear) {
+    scalar_t x = grid_sampler_compute_source_index_set_grad(
+        coord, size, padding_mode, align_corners, &taps.mult);
+    int64_t x0 = static_cast<int64_t>(std::floor(x));
+    scalar_t t = x - x0;
+    taps.add(x0, 1 - t, -1, size);
+    taps.add(x0 + 1, t, 1, size);
+  } else if (interpolation_mode == GridSamplerInterpolation::Nearest) {
+    scalar_t x = grid_sampler_compute_source_index(
+        coord, size, padding_mode, align_corners);
+    taps.add(static_cast<int64_t>(std::nearbyint(x)), 1, 0, size);
+  } else {
+    // As in _grid_sampler_2d_cpu_fallback, each of the 4 pixels is padded
+    // rather than the source coordinate
+    scalar_t x = grid_sampler_unnormalize_set_grad(
+        coord, size, align_corners, &taps.mult);
+    scalar_t x0 = std::floor(x);
+    scalar_t t = x - x0;
+    scalar_t coeffs[4];
+    scalar_t coeffs_grad[4];
+    get_cubic_upsample_coefficients<scalar_t>(coeffs, t);
+    get_cubic_coefficients_grad<scalar_t>(coeffs_grad, t);
+    for (int64_t i = 0; i < 4; i++) {
+      scalar_t xi = compute_coordinates<scalar_t>(
+          x0 - 1 + i, size, padding_mode, align_corners);
+      // coeffs_grad are the derivatives by the distance to the pixel, -t
+      taps.add(static_cast<int64_t>(xi), coeffs[i], -coeffs_grad[i], size);
+    }
+  }
+  return taps;
+}
+
+// The taps of the depth of a 2-d input
+template <typename scalar_t>
+static inline Taps<scalar_t> unit_taps() {
+  Taps<scalar_t> taps;
+  taps.add(0, 1, 0, 1);
+  return taps;
+}
+
+// out[c] = sum of the weighted rows of the input pixels read
+template <typename scalar_t>
+static inline void interpolate_row(
+    scalar_t* out,
+    const scalar_t* inp,
+    const Taps<scalar_t> (&taps)[3],
+    int64_t inp_H,
+    int64_t inp_W,
+    int64_t C) {
+  using Vec = vec256::Vec256<scalar_t>;
+  std::fill(out, out + C, scalar_t(0));
+  for (int64_t kd = 0; kd < taps[0].size; kd++) {
+    for (int64_t kh = 0; kh < taps[1].size; kh++) {
+      for (int64_t kw = 0; kw < taps[2].size; kw++) {
+        const Vec w_vec(taps[0].weight[kd] * taps[1].weight[kh] * taps[2].weight[kw]);
+        const scalar_t* in = inp +
+            ((taps[0].index[kd] * inp_H + taps[1].index[kh]) * inp_W + taps[2].index[kw]) * C;
+        vec256::map2(
+            [w_vec](Vec out_vec, Vec in_vec) { return out_vec + w_vec * in_vec; },
+            out, out, in, C);
+      }
+    }
+  }
+}
+
+// Adds the weighted row gout to the rows of gin of the input pixels read, and
+// computes the gradient of the grid coordinates (x, y[, z]) of the pixel
+template <typename scalar_t, int dim>
+static inline void backward_row(
+    scalar_t* gin,
+    scalar_t* ggrid,
+    const scalar_t* gout,
+    const scalar_t* inp,
+    const Taps<scalar_t> (&taps)[3],
+    bool compute_grid_grad,
+    int64_t inp_H,
+    int64_t inp_W,
+    int64_t C) {
+  using Vec = vec256::Vec256<scalar_t>;
+  scalar_t gx = 0;
+  scalar_t gy = 0;
+  scalar_t gz = 0;
+  for (int64_t kd = 0; kd < taps[0].size; kd++) {
+    for (int64_t kh = 0; kh < taps[1].size; kh++) {
+      for (int64_t kw = 0; kw < taps[2].size; kw++) {
+        const scalar_t wd = taps[0].weight[kd];
+        const scalar_t wh = taps[1].weight[kh];
+        const scalar_t ww = taps[2].weight[kw];
+        const int64_t offset =
+            ((taps[0].index[kd] * inp_H + taps[1].index[kh]) * inp_W + taps[2].index[kw]) * C;
+        const Vec w_vec(wd * wh * ww);
+        vec256::map2(
+            [w_vec](Vec gin_vec, Vec gout_vec) { return gin_vec + w_vec * gout_vec; },
+            gin + offset, gin + offset, gout, C);
+        if (compute_grid_grad) {
+          const scalar_t dot = vec256::map2_reduce_all<scalar_t>(
+              [](Vec x, Vec y) { return x * y; },
+              [](Vec x, Vec y) { return x + y; },
+              inp + offset, gout, C);
+          gx += wd * wh * taps[2].dweight[kw] * dot;
+          gy += wd * taps[1].dweight[kh] * ww * dot;
+          gz += taps[0].dweight[kd] * wh * ww * dot;
+        }
+      }
+    }
+  }
+  ggrid[0] = taps[2].mult * gx;
+  ggrid[1] = taps[1].mult * gy;
+  if (dim == 3) {
+    ggrid[2] = taps[0].mult * gz;
+  }
+}
+
+template <int dim>
+static inline at::MemoryFormat channels_last_format() {
+  return dim == 2 ? at::MemoryFormat::ChannelsLast : at::MemoryFormat::ChannelsLast3d;
+}
+
+// coords(coord, i, n, od, oh, ow) sets the grid coordinates (x, y[, z]) of
+// the output pixel i, at (od, oh, ow) of image n
+template <typename scalar_t, int dim, typename coords_t>
+Tensor cpu_grid_sampler_channels_last(
+    const Tensor& input_,
+    IntArrayRef output_size,
+    const coords_t& coords,
+    GridSamplerInterpolation interpolation_mode,
+    GridSamplerPadding padding_mode,
+    bool align_corners) {
+  const at::MemoryFormat memory_format = channels_last_format<dim>();
+  auto input = input_.contiguous(memory_format);
+
+  int64_t N = input.size(0);
+  int64_t C = input.size(1);
+  int64_t inp_D = dim == 3 ? input.size(2) : 1;
+  int64_t inp_H = input.size(-2);
+  int64_t inp_W = input.size(-1);
+  int64_t out_D = dim == 3 ? output_size[0] : 1;
+  int64_t out_H = output_size[dim - 2];
+  int64_t out_W = output_size[dim - 1];
+
+  std::vector<int64_t> sizes = {N, C};
+  sizes.insert(sizes.end(), output_size.begin(), output_size.end());
+  auto output = at::empty(sizes, input.options().memory_format(memory_format));
+
+  auto input_data = input.data_ptr<scalar_t>();
+  auto output_data = output.data_ptr<scalar_t>();
+  const int64_t grain_size = at::divup(at::internal::GRAIN_SIZE, std::max<int64_t>(C, 1) * 4);
+
+  // parallel on dim N, D, H, W
+  at::parallel_for(0, N * out_D * out_H * out_W, grain_size, [&](int64_t begin, int64_t end) {
+    int64_t n = 0;
+    int64_t od = 0;
+    int64_t oh = 0;
+    int64_t ow = 0;
+    data_index_init(begin, n, N, od, out_D, oh, out_H, ow, out_W);
+
+    scalar_t coord[3];
+    for (int64_t i = begin; i < end; i++) {
+      coords(coord, i, n, od, oh, ow);
+      const Taps<scalar_t> taps[3] = {
+          dim == 3 ? compute_taps(coord[2], inp_D, interpolation_mode, padding_mode, align_corners)
+                   : unit_taps<scalar_t>(),
+          compute_taps(coord[1], inp_H, interpolation_mode, padding_mode, align_corners),
+          compute_taps(coord[0], inp_W, interpolation_mode, padding_mode, align_corners)};
+      interpolate_row(
+          output_data + i * C,
+          input_data + n * inp_D * inp_H * inp_W * C,
+          taps, inp_H, inp_W, C);
+
+      // move on to next output index
+      data_index_step(n, N, od, out_D, oh, out_H, ow, out_W);
+    }
+  });
+
+  return output;
+}
+
+template <typename scalar_t, int dim>
+std::tuple<Tensor, Tensor> cpu_grid_sampler_backward_channels_last(
+    const Tensor& grad_output_,
+    const Tensor& input_,
+    const Tensor& grid_,
+    GridSamplerInterpolation interpolation_mode,
+    GridSamplerPadding padding_mode,
+    bool align_corners) {
+  const at::MemoryFormat memory_format = channels_last_format<dim>();
+  auto input = input_.contiguous(memory_format);
+  auto grad_output = grad_output_.contiguous(memory_format);
+  auto grid = grid_.contiguous();
+  auto grad_grid = at::empty_like(grid, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+
+  int64_t N = input.size(0);
+  int64_t C = input.size(1);
+  int64_t inp_D = dim == 3 ? input.size(2) : 1;
+  int64_t inp_H = input.size(-2);
+  int64_t inp_W = input.size(-1);
+  int64_t inp_spatial = inp_D * inp_H * inp_W;
+  int64_t out_spatial = 1;
+  for (int64_t d = 1; d <= dim; d++) {
+    out_spatial *= grid.size(d);
+  }
+
+  auto input_data = input.data_ptr<scalar_t>();
+  auto grad_output_data = grad_output.data_ptr<scalar_t>();
+  auto grid_data = grid.data_ptr<scalar_t>();
+  auto grad_grid_data = grad_grid.data_ptr<scalar_t>();
+  const bool compute_grid_grad = interpolation_mode != GridSamplerInterpolation::Nearest;
+
+  // accumulates the output pixel i of image n into gin, the grad_input of the
+  // image
+  auto backward_pixel = [&](scalar_t* gin, int64_t i, int64_t n) {
+    const scalar_t* coord = grid_data + i * dim;
+    const Taps<scalar_t> taps[3] = {
+        dim == 3 ? compute_taps(coord[2], inp_D, interpolation_mode, padding_mode, align_corners)
+                 : unit_taps<scalar_t>(),
+        compute_taps(coord[1], inp_H, interpolation_mode, padding_mode, align_corners),
+        compute_taps(coord[0], inp_W, interpolation_mode, padding_mode, align_corners)};
+    backward_row<scalar_t, dim>(
+        gin,
+        grad_grid_data + i * dim,
+        grad_output_data + i * C,
+        input_data + n * inp_spatial * C,
+        taps, compute_grid_grad, inp_H, inp_W, C);
+  };
+
+  Tensor grad_input;
+  int num_threads = at::get_num_threads();
+  if (N >= num_threads) {
+    grad_input = at::zeros_like(input, memory_format);
+    auto grad_input_data = grad_input.data_ptr<scalar_t>();
+    // parallel on dim N
+    at::parallel_for(0, N, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t n = begin; n < end; n++) {
+        scalar_t* gin = grad_input_data + n * inp_spatial * C;
+        for (int64_t o = 0; o < out_spatial; o++) {
+          backward_pixel(gin, n * out_spatial + o, n);
+        }
+      }
+    });
+  } else {
+    const int64_t numel = input.numel();
+    Tensor buffer = at::zeros({num_threads, numel}, input.options());
+    auto buffer_data = buffer.data_ptr<scalar_t>();
+    const int64_t grain_size = at::divup(at::internal::GRAIN_SIZE, std::max<int64_t>(C, 1) * 4);
+    // parallel on dim N, D, H, W
+    at::parallel_for(0, N * out_spatial, grain_size, [&](int64_t begin, int64_t end) {
+      int tid = at::get_thread_num();
+      TORCH_CHECK(tid < num_threads,
+                  "expect thread id smaller than ", num_threads, ", got thread id ", tid);
+      scalar_t* gin_buffer = buffer_data + tid * numel;
+      for (int64_t i = begin; i < end; i++) {
+        int64_t n = i / out_spatial;
+        backward_pixel(gin_buffer + n * inp_spatial * C, i, n);
+      }
+    });
+    // the rows of the buffer are channels last, as grad_input
+    auto sizes = input.sizes();
+    if (dim == 2) {
+      grad_input = buffer.sum(0).view({N, inp_H, inp_W, C}).permute({0, 3, 1, 2});
+    } else {
+      grad_input = buffer.sum(0).view({N, inp_D, inp_H, inp_W, C}).permute({0, 4, 1, 2, 3});
+    }
+    TORCH_INTERNAL_ASSERT(grad_input.sizes() == sizes);
+  }
+
+  return std::make_tuple(grad_input, grad_grid);
+}
+
+Tensor grid_sampler_channels_last_cpu_kernel_impl(
+    const Tensor& input,
+    const Tensor& grid_,
+    int64_t interpolation_mode,
+    int64_t padding_mode,
+    bool align_corners) {
+  auto grid = grid_.contiguous();
+  const auto interp = static_cast<GridSamplerInterpolation>(interpolation_mode);
+  const auto padding = static_cast<GridSamplerPadding>(padding_mode);
+  return AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "grid_sampler_channels_last_cpu", [&] {
+    auto grid_data = grid.data_ptr<scalar_t>();
+    if (input.dim() == 4) {
+      auto coords = [grid_data](scalar_t* coord, int64_t i, int64_t, int64_t, int64_t, int64_t) {
+        coord[0] = grid_data[i * 2];
+        coord[1] = grid_data[i * 2 + 1];
+      };
+      return cpu_grid_sampler_channels_last<scalar_t, 2>(
+          input, grid.sizes().slice(1, 2), coords, interp, padding, align_corners);
+    }
+    auto coords = [grid_data](scalar_t* coord, int64_t i, int64_t, int64_t, int64_t, int64_t) {
+      coord[0] = grid_data[i * 3];
+      coord[1] = grid_data[i * 3 + 1];
+      coord[2] = grid_data[i * 3 + 2];
+    };
+    return cpu_grid_sampler_channels_last<scalar_t, 3>(
+        input, grid.sizes().slice(1, 3), coords, interp, padding, align_corners);
+  });
+}
+
+std::tuple<Tensor, Tensor> grid_sampler_backward_channels_last_cpu_kernel_impl(
+    const Tensor& grad_output,
+    const Tensor& input,
+    const Tensor& grid,
+    int64_t interpolation_mode,
+    int64_t padding_mode,
+    bool align_corners) {
+  const auto interp = static_cast<GridSamplerInterpolation>(interpolation_mode);
+  const auto padding = static_cast<GridSamplerPadding>(padding_mode);
+  return AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "grid_sampler_backward_channels_last_cpu", [&] {
+    if (input.dim() == 4) {
+      return cpu_grid_sampler_backward_channels_last<scalar_t, 2>(
+          grad_output, input, grid, interp, padding, align_corners);
+    }
+    return cpu_grid_sampler_backward_channels_last<scalar_t, 3>(
+        grad_output, input, grid, interp, padding, align_corners);
+  });
+}
+
+// The coordinate of the step i of num_steps of the base grid, see
+// linspace_from_neg_one in AffineGridGenerator.cpp
+template <typename scalar_t>
+static inline scalar_t base_grid_coordinate(int64_t i, int64_t num_steps, bool align_corners) {
+  if (num_steps <= 1) {
+    return scalar_t(0);
+  }
+  scalar_t coord = scalar_t(-1) + scalar_t(2) * i / (num_steps - 1);
+  if (!align_corners) {
+    coord = coord * (num_steps - 1) / num_steps;
+  }
+  return coord;
+}
+
+Tensor affine_grid_sampler_channels_last_cpu_kernel_impl(
+    const Tensor& input,
+    const Tensor& theta_,
+    IntArrayRef output_size,
+    int64_t interpolation_mode,
+    int64_t padding_mode,
+    bool align_corners) {
+  auto theta = theta_.contiguous();
+  const auto interp = static_cast<GridSamplerInterpolation>(interpolation_mode);
+  const auto padding = static_cast<GridSamplerPadding>(padding_mode);
+  return AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "affine_grid_sampler_channels_last_cpu", [&] {
+    auto theta_data = theta.data_ptr<scalar_t>();
+    if (input.dim() == 4) {
+      const int64_t out_H = output_size[0];
+      const int64_t out_W = output_size[1];
+      // grid = theta[n] @ (x, y, 1)
+      auto coords = [&](scalar_t* coord, int64_t, int64_t n, int64_t, int64_t oh, int64_t ow) {
+        const scalar_t* t = theta_data + n * 6;
+        const scalar_t x = base_grid_coordinate<scalar_t>(ow, out_W, align_corners);
+        const scalar_t y = base_grid_coordinate<scalar_t>(oh, out_H, align_corners);
+        coord[0] = t[0] * x + t[1] * y + t[2];
+        coord[1] = t[3] * x + t[4] * y + t[5];
+      };
+      return cpu_grid_sampler_channels_last<scalar_t, 2>(
+          input, output_size, coords, interp, padding, align_corners);
+    }
+    const int64_t out_D = output_size[0];
+    const int64_t out_H = output_size[1];
+    const int64_t out_W = output_size[2];
+    // grid = theta[n] @ (x, y, z, 1)
+    auto coords = [&](scalar_t* coord, int64_t, int64_t n, int64_t od, int64_t oh, int64_t ow) {
+      const scalar_t* t = theta_data + n * 12;
+      const scalar_t x = base_grid_coordinate<scalar_t>(ow, out_W, align_corners);
+      const scalar_t y = base_grid_coordinate<scalar_t>(oh, out_H, align_corners);
+      const scalar_t z = base_grid_coordinate<scalar_t>(od, out_D, align_corners);
+      coord[0] = t[0] * x + t[1] * y + t[2] * z + t[3];
+      coord[1] = t[4] * x + t[5] * y + t[6] * z + t[7];
+      coord[2] = t[8] * x + t[9] * y + t[10] * z + t[11];
+    };
+    return cpu_grid_sampler_channels_last<scalar_t, 3>(
+        input, output_size, coords, interp, padding, align_corners);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(grid_sampler_channels_last_cpu_kernel, &grid_sampler_channels_last_cpu_kernel_impl);
+REGISTER_DISPATCH(grid_sampler_backward_channels_last_cpu_kernel, &grid_sampler_backward_channels_last_cpu_kernel_impl);
+REGISTER_DISPATCH(affine_grid_sampler_channels_last_cpu_kernel, &affine_grid_sampler_channels_last_cpu_kernel_impl);
+
+}} // at::native
@@ -15,4 +15,13 @@ using backward_2d_fn = std::tuple<Tensor, Tensor>(*)(const Tensor &, const Tenso
 DECLARE_DISPATCH(forward_2d_fn, grid_sampler_2d_cpu_kernel);
 DECLARE_DISPATCH(backward_2d_fn, grid_sampler_2d_backward_cpu_kernel);
 
+// The kernels of 4-d and 5-d channels last inputs, which compute channels last
+// outputs and gradients of the input (see Note [Channels last grid sampler])
+using forward_channels_last_fn = Tensor(*)(const Tensor &, const Tensor &, int64_t, int64_t, bool);
+using backward_channels_last_fn = std::tuple<Tensor, Tensor>(*)(const Tensor &, const Tensor &, const Tensor &, int64_t, int64_t, bool);
+using affine_forward_channels_last_fn = Tensor(*)(const Tensor &, const Tensor &, IntArrayRef, int64_t, int64_t, bool);
+DECLARE_DISPATCH(forward_channels_last_fn, grid_sampler_channels_last_cpu_kernel);
+DECLARE_DISPATCH(backward_channels_last_fn, grid_sampler_backward_channels_last_cpu_kernel);
+DECLARE_DISPATCH(affine_forward_channels_last_fn, affine_grid_sampler_channels_last_cpu_kernel);
+
 }}  // namespace at::native
@@ -1,9 +1,12 @@
 #include <ATen/ATen.h>
 #include <ATen/native/LinearAlgebra.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 
+#include <vector>
+
 namespace at { namespace native { namespace {
 
 void addr_kernel(TensorIterator &iter,
@@ -79,8 +82,135 @@ void addr_kernel(TensorIterator &iter,
   );
 }
 
+// A tile of `rows` x (2 vectors) of the result of one small gemm:
+//   c[0:rows, 0:cols] = alpha * a[0:rows, :] @ b[:, 0:cols] (+ beta * c)
+// The products are accumulated in registers over the whole contraction.
+// b is the packed, zero padded rows of mat2, so that the loads of b never
+// need a mask; only the stores to c are limited to the `cols` columns.
+template <typename scalar_t, int64_t rows>
+inline void small_gemm_tile(
+    int64_t ks,
+    const scalar_t* a, int64_t a_row_stride, int64_t a_col_stride,
+    const scalar_t* b, int64_t ldb,
+    scalar_t* c, int64_t ldc, int64_t cols,
+    scalar_t alpha, scalar_t beta, bool use_beta) {
+  using Vec = Vec256<scalar_t>;
+  Vec acc[rows][2];
+  for (int64_t r = 0; r < rows; r++) {
+    acc[r][0] = Vec(scalar_t(0));
+    acc[r][1] = Vec(scalar_t(0));
+  }
+  for (int64_t k = 0; k < ks; k++) {
+    const Vec b0 = Vec::loadu(b + k * ldb);
+    const Vec b1 = Vec::loadu(b + k * ldb + Vec::size());
+    for (int64_t r = 0; r < rows; r++) {
+      const Vec a_val(a[r * a_row_stride + k * a_col_stride]);
+      acc[r][0] = vec256::fmadd(a_val, b0, acc[r][0]);
+      acc[r][1] = vec256::fmadd(a_val, b1, acc[r][1]);
+    }
+  }
+  const Vec alpha_vec(alpha);
+  const Vec beta_vec(beta);
+  for (int64_t r = 0; r < rows; r++) {
+    scalar_t* c_row = c + r * ldc;
+    for (int64_t v = 0; v < 2; v++) {
+      const int64_t count = std::min<int64_t>(Vec::size(), cols - v * Vec::size());
+      if (count <= 0) {
+        break;
+      }
+      Vec out = acc[r][v] * alpha_vec;
+      // when beta == 0, values in self should be ignored,
+      // nans and infs in self should not propagate.
+      if (use_beta) {
+        out = vec256::fmadd(beta_vec, Vec::loadu(c_row + v * Vec::size(), count), out);
+      }
+      out.store(c_row + v * Vec::size(), count);
+    }
+  }
+}
+
+// bmm/baddbmm of matrices small enough that a BLAS call per matrix costs
+// more than the multiplication: the batch is split between the threads and
+// each matrix is multiplied with register-blocked tiles, with mat2 packed
+// once per matrix into a buffer of the thread.
+template <typename scalar_t>
+void baddbmm_small_kernel_impl(
+    const Tensor& result, const Tensor& batch1, const Tensor& batch2,
+    Scalar beta_, Scalar alpha_, bool is_bmm) {
+  using Vec = Vec256<scalar_t>;
+  constexpr int64_t kRowBlock = 4;
+  const int64_t kColBlock = 2 * Vec::size();
+
+  const int64_t bs = result.size(0);
+  const int64_t is = result.size(1);
+  const int64_t js = result.size(2);
+  const int64_t ks = batch1.size(2);
+  // the columns of the packed mat2, padded to a multiple of the tile width
+  const int64_t ldb = (js + kColBlock - 1) / kColBlock * kColBlock;
+
+  const scalar_t alpha = alpha_.to<scalar_t>();
+  const scalar_t beta = beta_.to<scalar_t>();
+  const bool use_beta = !is_bmm && beta != scalar_t(0);
+
+  scalar_t* const r_data = result.data_ptr<scalar_t>();
+  const scalar_t* const s_data = batch1.data_ptr<scalar_t>();
+  const scalar_t* const m_data = batch2.data_ptr<scalar_t>();
+  const auto r_strides = result.strides();
+  const auto s_strides = batch1.strides();
+  const auto m_strides = batch2.strides();
+
+  const int64_t grain_size = std::max(internal::GRAIN_SIZE / (is * js * ks), (int64_t)1);
+  parallel_for(0, bs, grain_size, [&](int64_t b_begin, int64_t b_end) {
+    std::vector<scalar_t> packed(ks * ldb, scalar_t(0));
+    for (int64_t b = b_begin; b < b_end; b++) {
+      const scalar_t* m = m_data + b * m_strides[0];
+      for (int64_t k = 0; k < ks; k++) {
+        for (int64_t j = 0; j < js; j++) {
+          packed[k * ldb + j] = m[k * m_strides[1] + j * m_strides[2]];
+        }
+      }
+      const scalar_t* s = s_data + b * s_strides[0];
+      scalar_t* r = r_data + b * r_strides[0];
+      for (int64_t i = 0; i < is; i += kRowBlock) {
+        const scalar_t* a = s + i * s_strides[1];
+        scalar_t* c_rows = r + i * r_strides[1];
+        for (int64_t j = 0; j < js; j += kColBlock) {
+          const int64_t cols = std::min(kColBlock, js - j);
+          scalar_t* c = c_rows + j;
+          switch (std::min(kRowBlock, is - i)) {
+            case 4:
+              small_gemm_tile<scalar_t, 4>(ks, a, s_strides[1], s_strides[2], packed.data() + j, ldb,
+                                           c, r_strides[1], cols, alpha, beta, use_beta);
+              break;
+            case 3:
+              small_gemm_tile<scalar_t, 3>(ks, a, s_strides[1], s_strides[2], packed.data() + j, ldb,
+                                           c, r_strides[1], cols, alpha, beta, use_beta);
+              break;
+            case 2:
+              small_gemm_tile<scalar_t, 2>(ks, a, s_strides[1], s_strides[2], packed.data() + j, ldb,
+                                           c, r_strides[1], cols, alpha, beta, use_beta);
+              break;
+            default:
+              small_gemm_tile<scalar_t, 1>(ks, a, s_strides[1], s_strides[2], packed.data() + j, ldb,
+                                           c, r_strides[1], cols, alpha, beta, use_beta);
+          }
+        }
+      }
+    }
+  });
+}
+
+void baddbmm_small_kernel(
+    const Tensor& result, const Tensor& batch1, const Tensor& batch2,
+    Scalar beta, Scalar alpha, bool is_bmm) {
+  AT_DISPATCH_FLOATING_TYPES(result.scalar_type(), "baddbmm_small", [&] {
+    baddbmm_small_kernel_impl<scalar_t>(result, batch1, batch2, beta, alpha, is_bmm);
+  });
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(addr_stub, &addr_kernel);
+REGISTER_DISPATCH(baddbmm_small_stub, &baddbmm_small_kernel);
 
 }} // namespace at::native
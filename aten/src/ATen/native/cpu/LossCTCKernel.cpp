@@ -0,0 +1,336 @@
+// The alpha / beta recursions of the CPU CTC loss, see LossCTC.cpp for the
+// references and the equation numbers (Graves et al., 2006).
+#include <ATen/native/cpu/LossCTCKernel.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+
+namespace at {
+namespace native {
+namespace {
+
+using namespace vec256;
+
+// log(exp(a) + exp(b) + exp(c))
+template <typename scalar_t>
+inline scalar_t log_add_exp3(scalar_t a, scalar_t b, scalar_t c) {
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  scalar_t m = std::max(std::max(a, b), c);
+  if (m == neginf) { // cannot do neginf-neginf
+    m = 0;
+  }
+  return std::log(std::exp(a - m) + std::exp(b - m) + std::exp(c - m)) + m;
+}
+
+template <typename scalar_t>
+inline Vec256<scalar_t> log_add_exp3(
+    const Vec256<scalar_t>& a, const Vec256<scalar_t>& b, const Vec256<scalar_t>& c) {
+  using Vec = Vec256<scalar_t>;
+  const Vec neginf(-std::numeric_limits<scalar_t>::infinity());
+  Vec m = maximum(maximum(a, b), c);
+  m = Vec::blendv(m, Vec(0), m == neginf);
+  return ((a - m).exp() + (b - m).exp() + (c - m).exp()).log() + m;
+}
+
+// The augmented target l' of a sample, with blanks around and between the
+// labels, and for every state s, 0 if the recursion can go from s - 2 to s
+// (i.e. l'[s] is a label that differs from l'[s - 2]) and -inf otherwise, so
+// that the third summand of eq (6) / (10) is added without a branch.
+template <typename scalar_t>
+struct CTCStates {
+  std::vector<int64_t> target_prime;
+  std::vector<scalar_t> skip;
+
+  template <typename target_t>
+  CTCStates(const target_t* targets, int64_t offset, int64_t stride, int64_t target_length, int64_t BLANK)
+      : target_prime(2 * target_length + 1, BLANK),
+        skip(2 * target_length + 1, -std::numeric_limits<scalar_t>::infinity()) {
+    for (int64_t s = 1; s < 2 * target_length + 1; s += 2) {
+      target_prime[s] = targets[offset + stride * (s / 2)];
+      if (s > 1 && target_prime[s] != target_prime[s - 2]) {
+        skip[s] = 0;
+      }
+    }
+  }
+
+  int64_t size() const {
+    return target_prime.size();
+  }
+};
+
+// Splits the batch into at most one bin per thread. at::parallel_for would
+// give every thread the same number of samples, but the cost of a sample is
+// input_length x (2 * target_length + 1), which varies by orders of magnitude
+// between the samples of a batch with long targets. The bins are filled
+// longest sample first, every one going to the least loaded bin.
+std::vector<std::vector<int64_t>> balance_ctc_samples(IntArrayRef input_lengths, IntArrayRef target_lengths) {
+  const int64_t batch_size = input_lengths.size();
+  const int64_t n_bins = std::min<int64_t>(batch_size, at::get_num_threads());
+  auto cost = [&](int64_t b) {
+    return input_lengths[b] * (2 * target_lengths[b] + 1);
+  };
+  std::vector<int64_t> order(batch_size);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+    return cost(a) > cost(b);
+  });
+  std::vector<std::vector<int64_t>> bins(n_bins);
+  std::vector<int64_t> load(n_bins, 0);
+  for (int64_t b : order) {
+    const int64_t bin = std::min_element(load.begin(), load.end()) - load.begin();
+    bins[bin].push_back(b);
+    // every sample costs something, even with an empty input
+    load[bin] += cost(b) + 1;
+  }
+  return bins;
+}
+
+template <typename scalar_t, typename target_t>
+void ctc_loss_kernel_impl(Tensor& neg_log_likelihood, Tensor& log_alpha, const Tensor& log_probs, const Tensor& targets,
+                          IntArrayRef input_lengths, IntArrayRef target_lengths,
+                          IntArrayRef tg_batch_offsets, int64_t tg_target_stride, int64_t BLANK) {
+  using Vec = Vec256<scalar_t>;
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  const int64_t max_input_length = log_probs.size(0);
+  const int64_t batch_size = log_probs.size(1);
+  const int64_t num_labels = log_probs.size(2);
+  const int64_t alpha_width = log_alpha.size(2);
+  const scalar_t* log_probs_data = log_probs.data_ptr<scalar_t>();
+  scalar_t* log_alpha_data = log_alpha.data_ptr<scalar_t>();
+  const target_t* targets_data = targets.data_ptr<target_t>();
+  auto neg_log_likelihood_a = neg_log_likelihood.accessor<scalar_t, 1>();
+
+  const auto bins = balance_ctc_samples(input_lengths, target_lengths);
+  at::parallel_for(0, bins.size(), 1, [&](int64_t start, int64_t end) {
+    std::vector<scalar_t> lp;
+    for (int64_t bin = start; bin < end; bin++) {
+      for (int64_t b : bins[bin]) {
+        const int64_t input_length = input_lengths[b];
+        const int64_t target_length = target_lengths[b];
+        const CTCStates<scalar_t> states(targets_data, tg_batch_offsets[b], tg_target_stride, target_length, BLANK);
+        const int64_t num_states = states.size();
+        if (input_length == 0) {
+          // only the empty target can be emitted by an empty input
+          neg_log_likelihood_a[b] = target_length == 0 ? 0 : std::numeric_limits<scalar_t>::infinity();
+          continue;
+        }
+        auto log_probs_row = [&](int64_t t) {
+          return log_probs_data + (t * batch_size + b) * num_labels;
+        };
+        scalar_t* alpha = log_alpha_data + b * max_input_length * alpha_width;
+
+        // the first row, the three equations for alpha_1 above eq (6)
+        std::fill(alpha, alpha + alpha_width, neginf);
+        alpha[0] = log_probs_row(0)[BLANK];
+        if (target_length > 0) {
+          alpha[1] = log_probs_row(0)[states.target_prime[1]];
+        }
+
+        // now the loop over the inputs, eq (6) and (7), vectorized over the
+        // states: alpha_t(s) only depends on the previous row
+        lp.resize(num_states);
+        for (int64_t t = 1; t < input_length; t++) {
+          const scalar_t* prev = alpha + (t - 1) * alpha_width;
+          scalar_t* cur = alpha + t * alpha_width;
+          const scalar_t* log_probs_t = log_probs_row(t);
+          for (int64_t s = 0; s < num_states; s++) {
+            lp[s] = log_probs_t[states.target_prime[s]];
+          }
+          cur[0] = prev[0] + lp[0];
+          if (num_states > 1) {
+            cur[1] = log_add_exp3(prev[1], prev[0], neginf) + lp[1];
+          }
+          int64_t s = 2;
+          for (; s + Vec::size() <= num_states; s += Vec::size()) {
+            const Vec la = log_add_exp3(
+                Vec::loadu(prev + s), Vec::loadu(prev + s - 1),
+                Vec::loadu(prev + s - 2) + Vec::loadu(states.skip.data() + s));
+            (la + Vec::loadu(lp.data() + s)).store(cur + s);
+          }
+          for (; s < num_states; s++) {
+            cur[s] = log_add_exp3(prev[s], prev[s - 1], prev[s - 2] + states.skip[s]) + lp[s];
+          }
+        }
+
+        // the likelihood is the the sum of the last two alphas, eq (8), the loss is the negative log likelihood
+        const scalar_t* last = alpha + (input_length - 1) * alpha_width;
+        if (target_length == 0) {
+          // if the target is empty then there is no preceding BLANK state and hence there is no path to merge
+          neg_log_likelihood_a[b] = -last[0];
+        } else {
+          neg_log_likelihood_a[b] = -log_add_exp3(last[2 * target_length], last[2 * target_length - 1], neginf);
+        }
+      }
+    }
+  });
+}
+
+// The betas of eq (10) and (11) only need the next row, so only two rows are
+// kept, and the sum of eq (16) is collected for every t as soon as its row of
+// betas is known. The terms alpha_t(s) beta_t(s) / (y_t(l'_s) Z) of that sum
+// are occupation probabilities, at most 1, so they are summed in linear
+// space, which vectorizes unlike the log-space sum of several states into the
+// same label.
+template <typename scalar_t, typename target_t>
+void ctc_loss_backward_kernel_impl(Tensor& grad, const Tensor& grad_out, const Tensor& log_probs, const Tensor& targets,
+                                   IntArrayRef input_lengths, IntArrayRef target_lengths,
+                                   IntArrayRef tg_batch_offsets, int64_t tg_target_stride,
+                                   const Tensor& neg_log_likelihood, const Tensor& log_alpha,
+                                   int64_t BLANK, bool zero_infinity) {
+  using Vec = Vec256<scalar_t>;
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  const int64_t max_input_length = log_probs.size(0);
+  const int64_t batch_size = log_probs.size(1);
+  const int64_t num_labels = log_probs.size(2);
+  const int64_t alpha_width = log_alpha.size(2);
+  const scalar_t* log_probs_data = log_probs.data_ptr<scalar_t>();
+  const scalar_t* log_alpha_data = log_alpha.data_ptr<scalar_t>();
+  scalar_t* grad_data = grad.data_ptr<scalar_t>();
+  const target_t* targets_data = targets.data_ptr<target_t>();
+  auto neg_log_likelihood_a = neg_log_likelihood.accessor<scalar_t, 1>();
+  auto grad_out_a = grad_out.accessor<scalar_t, 1>();
+
+  const auto bins = balance_ctc_samples(input_lengths, target_lengths);
+  at::parallel_for(0, bins.size(), 1, [&](int64_t start, int64_t end) {
+    std::vector<scalar_t> lp, beta_cur, beta_next, occupation;
+    for (int64_t bin = start; bin < end; bin++) {
+      for (int64_t b : bins[bin]) {
+        auto grad_row = [&](int64_t t) {
+          return grad_data + (t * batch_size + b) * num_labels;
+        };
+        auto log_probs_row = [&](int64_t t) {
+          return log_probs_data + (t * batch_size + b) * num_labels;
+        };
+        const scalar_t nll = neg_log_likelihood_a[b];
+        const int64_t input_length =
+            zero_infinity && nll == std::numeric_limits<scalar_t>::infinity() ? 0 : input_lengths[b];
+        const int64_t target_length = target_lengths[b];
+        const CTCStates<scalar_t> states(targets_data, tg_batch_offsets[b], tg_target_stride, target_length, BLANK);
+        const int64_t num_states = states.size();
+        const scalar_t* alpha = log_alpha_data + b * max_input_length * alpha_width;
+        const scalar_t gr = grad_out_a[b];
+
+        lp.resize(num_states);
+        beta_cur.resize(num_states);
+        beta_next.resize(num_states);
+        occupation.resize(num_states);
+        for (int64_t t = input_length - 1; t >= 0; t--) {
+          const scalar_t* log_probs_t = log_probs_row(t);
+          for (int64_t s = 0; s < num_states; s++) {
+            lp[s] = log_probs_t[states.target_prime[s]];
+          }
+          scalar_t* cur = beta_cur.data();
+          const scalar_t* next = beta_next.data();
+          if (t == input_length - 1) {
+            // the initialization of beta before eq (10)
+            std::fill(cur, cur + num_states, neginf);
+            cur[num_states - 1] = lp[num_states - 1];
+            if (target_length > 0) {
+              cur[num_states - 2] = lp[num_states - 2];
+            }
+          } else {
+            // eq (10) / (11)
+            cur[num_states - 1] = next[num_states - 1] + lp[num_states - 1];
+            if (num_states > 1) {
+              cur[num_states - 2] = log_add_exp3(next[num_states - 2], next[num_states - 1], neginf) + lp[num_states - 2];
+            }
+            int64_t s = 0;
+            for (; s + Vec::size() <= num_states - 2; s += Vec::size()) {
+              const Vec lb = log_add_exp3(
+                  Vec::loadu(next + s), Vec::loadu(next + s + 1),
+                  Vec::loadu(next + s + 2) + Vec::loadu(states.skip.data() + s + 2));
+              (lb + Vec::loadu(lp.data() + s)).store(cur + s);
+            }
+            for (; s < num_states - 2; s++) {
+              cur[s] = log_add_exp3(next[s], next[s + 1], next[s + 2] + states.skip[s + 2]) + lp[s];
+            }
+          }
+
+          // the occupation probabilities exp(alpha + beta + nll - lp) of
+          // eq (16); states that no path goes through contribute 0, not the
+          // NaN of -inf - (-inf) when their label has probability 0
+          const scalar_t* alpha_t = alpha + t * alpha_width;
+          const Vec nll_vec(nll);
+          const Vec neginf_vec(neginf);
+          int64_t s = 0;
+          for (; s + Vec::size() <= num_states; s += Vec::size()) {
+            const Vec log_alpha_beta = Vec::loadu(alpha_t + s) + Vec::loadu(cur + s);
+            const Vec occ = (log_alpha_beta + nll_vec - Vec::loadu(lp.data() + s)).exp();
+            Vec::blendv(occ, Vec(0), log_alpha_beta == neginf_vec).store(occupation.data() + s);
+          }
+          for (; s < num_states; s++) {
+            const scalar_t log_alpha_beta = alpha_t[s] + cur[s];
+            occupation[s] = log_alpha_beta == neginf ? 0 : std::exp(log_alpha_beta + nll - lp[s]);
+          }
+
+          // several states can have the same label, so the sum isn't vectorized
+          scalar_t* grad_t = grad_row(t);
+          std::fill(grad_t, grad_t + num_labels, scalar_t(0));
+          for (s = 0; s < num_states; s++) {
+            grad_t[states.target_prime[s]] += occupation[s];
+          }
+          // grad is the output gradient, nll is the loss. Note that the likelihood -nll is the Z of eq (16)
+          const Vec gr_vec(gr);
+          int64_t c = 0;
+          for (; c + Vec::size() <= num_labels; c += Vec::size()) {
+            ((Vec::loadu(log_probs_t + c).exp() - Vec::loadu(grad_t + c)) * gr_vec).store(grad_t + c);
+          }
+          for (; c < num_labels; c++) {
+            grad_t[c] = (std::exp(log_probs_t[c]) - grad_t[c]) * gr;
+          }
+          std::swap(beta_cur, beta_next);
+        }
+
+        // zero the remainder, and all of the gradient of infinite losses with zero_infinity
+        for (int64_t t = input_length; t < max_input_length; t++) {
+          std::fill(grad_row(t), grad_row(t) + num_labels, scalar_t(0));
+        }
+      }
+    }
+  });
+}
+
+void ctc_loss_cpu_kernel(Tensor& neg_log_likelihood, Tensor& log_alpha, const Tensor& log_probs, const Tensor& targets,
+                     IntArrayRef input_lengths, IntArrayRef target_lengths,
+                     IntArrayRef tg_batch_offsets, int64_t tg_target_stride, int64_t BLANK) {
+  AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_cpu", [&] {
+    if (targets.scalar_type() == kLong) {
+      ctc_loss_kernel_impl<scalar_t, int64_t>(neg_log_likelihood, log_alpha, log_probs, targets,
+          input_lengths, target_lengths, tg_batch_offsets, tg_target_stride, BLANK);
+    } else {
+      ctc_loss_kernel_impl<scalar_t, int>(neg_log_likelihood, log_alpha, log_probs, targets,
+          input_lengths, target_lengths, tg_batch_offsets, tg_target_stride, BLANK);
+    }
+  });
+}
+
+void ctc_loss_backward_cpu_kernel(Tensor& grad, const Tensor& grad_out, const Tensor& log_probs, const Tensor& targets,
+                              IntArrayRef input_lengths, IntArrayRef target_lengths,
+                              IntArrayRef tg_batch_offsets, int64_t tg_target_stride,
+                              const Tensor& neg_log_likelihood, const Tensor& log_alpha,
+                              int64_t BLANK, bool zero_infinity) {
+  AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_backward_cpu", [&] {
+    if (targets.scalar_type() == kLong) {
+      ctc_loss_backward_kernel_impl<scalar_t, int64_t>(grad, grad_out, log_probs, targets,
+          input_lengths, target_lengths, tg_batch_offsets, tg_target_stride,
+          neg_log_likelihood, log_alpha, BLANK, zero_infinity);
+    } else {
+      ctc_loss_backward_kernel_impl<scalar_t, int>(grad, grad_out, log_probs, targets,
+          input_lengths, target_lengths, tg_batch_offsets, tg_target_stride,
+          neg_log_likelihood, log_alpha, BLANK, zero_infinity);
+    }
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(ctc_loss_kernel, &ctc_loss_cpu_kernel);
+REGISTER_DISPATCH(ctc_loss_backward_kernel, &ctc_loss_backward_cpu_kernel);
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,229 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/Pool.h>
+#include <ATen/native/cpu/utils.h>
+
+#include <limits>
+#include <memory>
+
+namespace at { namespace native {
+
+namespace {
+
+// Note [Channels last pooling]
+// The CPU poolings of channels last inputs used to convert them to contiguous,
+// and their outputs back. The channels last kernels instead compute the row of
+// channels of an output pixel at once, from the rows of the input pixels of its
+// window, which are contiguous and vectorized over, and keep the outputs
+// channels last. The forward kernels are parallel over the output pixels of
+// the batch, N * H_out * W_out. The windows of grad_input written by the
+// backward kernels overlap, so these are parallel over the images and blocks
+// of kChannelsLastBlock channels instead. BFloat16 rows are converted to float
+// to be computed.
+//
+// max_pool2d first records the position of the max of each channel in the
+// window, which fits in an integer of the size of the values and is blended
+// with them, and converts it to the index of the input pixel once the window
+// is done.
+
+template <typename scalar_t>
+void cpu_max_pool_channels_last(
+    Tensor& output_,
+    Tensor& indices_,
+    const Tensor& input_,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    int dilationW, int dilationH) {
+  auto memory_format = at::MemoryFormat::ChannelsLast;
+  auto input = input_.contiguous(memory_format);
+  auto output = output_.contiguous(memory_format);
+  auto indices = indices_.contiguous(memory_format);
+
+  auto input_data = input.data_ptr<scalar_t>();
+  auto output_data = output.data_ptr<scalar_t>();
+  auto indices_data = indices.data_ptr<int64_t>();
+
+  int64_t nbatch = input.size(0);
+  int64_t channels = input.size(1);
+  int64_t input_height = input.size(2);
+  int64_t input_width = input.size(3);
+  int64_t output_height = output.size(2);
+  int64_t output_width = output.size(3);
+
+  using acc_t = typename vec_acc_type<scalar_t>::type;
+  using integer_t = vec256::int_same_size_t<acc_t>;
+  using Vec = vec256::Vec256<acc_t>;
+  using iVec = vec256::Vec256<integer_t>;
+  static_assert(Vec::size() == iVec::size(), "the positions are blended with the values");
+  const int64_t window_size = int64_t(kH) * kW;
+
+  // parallel on dim N, H, W
+  at::parallel_for(0, nbatch * output_height * output_width, 0, [&](int64_t begin, int64_t end) {
+    int64_t n = 0;
+    int64_t oh = 0;
+    int64_t ow = 0;
+    data_index_init(begin, n, nbatch, oh, output_height, ow, output_width);
+
+    std::unique_ptr<acc_t[]> in_buffer(new acc_t[channels]);
+    std::unique_ptr<acc_t[]> max_buffer(new acc_t[channels]);
+    std::unique_ptr<integer_t[]> pos(new integer_t[channels]);
+    // the index of the input pixel at each position of the window
+    std::unique_ptr<int64_t[]> window_index(new int64_t[window_size]);
+
+    for (int64_t i = begin; i < end; i++) {
+      int64_t ih0 = oh * dH - padH;
+      int64_t iw0 = ow * dW - padW;
+      int64_t ih1 = std::min(ih0 + (kH - 1) * dilationH + 1, input_height);
+      int64_t iw1 = std::min(iw0 + (kW - 1) * dilationW + 1, input_width);
+      while (ih0 < 0) {
+        ih0 += dilationH;
+      }
+      while (iw0 < 0) {
+        iw0 += dilationW;
+      }
+
+      acc_t* max = acc_row(output_data + i * channels, max_buffer.get());
+      int64_t* ind = indices_data + i * channels;
+      int64_t size = channels;
+
+      // Pass I: init the out lane
+      window_index[0] = ih0 * input_width + iw0;
+      int64_t d1 = 0;
+      for (; d1 < size - (size % Vec::size()); d1 += Vec::size()) {
+        Vec(-std::numeric_limits<acc_t>::infinity()).store(max + d1);
+        iVec(0).store(pos.get() + d1);
+      }
+      for (; d1 < size; d1++) {
+        max[d1] = -std::numeric_limits<acc_t>::infinity();
+        pos[d1] = 0;
+      }
+      // Pass II: compute local max and its position
+      integer_t p = 0;
+      for (int64_t ih = ih0; ih < ih1; ih += dilationH) {
+        for (int64_t iw = iw0; iw < iw1; iw += dilationW) {
+          const scalar_t* in_row = input_data +
+              ((n * input_height + ih) * input_width + iw) * channels;
+          const acc_t* in = load_acc_row(in_row, in_buffer.get(), size);
+          window_index[p] = ih * input_width + iw;
+
+          const iVec p_vec(p);
+          int64_t d2 = 0;
+          for (; d2 < size - (size % Vec::size()); d2 += Vec::size()) {
+            Vec val_vec = Vec::loadu(in + d2);
+            Vec max_vec = Vec::loadu(max + d2);
+            // a NaN is the max
+            Vec mask = (val_vec > max_vec) | (val_vec != val_vec);
+            Vec::blendv(max_vec, val_vec, mask).store(max + d2);
+            iVec pos_vec = iVec::loadu(pos.get() + d2);
+            iVec::blendv(pos_vec, p_vec, vec256::cast<integer_t, acc_t>(mask)).store(pos.get() + d2);
+          }
+          for (; d2 < size; d2++) {
+            acc_t val = in[d2];
+            if ((val > max[d2]) || std::isnan(val)) {
+              max[d2] = val;
+              pos[d2] = p;
+            }
+          }
+          p++;
+        }
+      }
+      // Pass III: store the max and the index of its input pixel
+      store_acc_row(max, output_data + i * channels, size);
+      for (int64_t d3 = 0; d3 < size; d3++) {
+        ind[d3] = window_index[pos[d3]];
+      }
+
+      // move on to next output index
+      data_index_step(n, nbatch, oh, output_height, ow, output_width);
+    }
+  });
+
+  if (!output_.is_contiguous(memory_format)) {
+    output_.copy_(output);
+  }
+  if (!indices_.is_contiguous(memory_format)) {
+    indices_.copy_(indices);
+  }
+}
+
+template <typename scalar_t>
+void cpu_max_pool_backward_channels_last(
+    Tensor& grad_input_,
+    const Tensor& grad_output_,
+    const Tensor& indices_) {
+  auto memory_format = at::MemoryFormat::ChannelsLast;
+  auto grad_input = grad_input_.contiguous(memory_format);
+  auto grad_output = grad_output_.contiguous(memory_format);
+  auto indices = indices_.contiguous(memory_format);
+
+  auto grad_input_data = grad_input.data_ptr<scalar_t>();
+  auto grad_output_data = grad_output.data_ptr<scalar_t>();
+  auto indices_data = indices.data_ptr<int64_t>();
+
+  int64_t nbatch = grad_input.size(0);
+  int64_t channels = grad_input.size(1);
+  int64_t input_height = grad_input.size(2);
+  int64_t input_width = grad_input.size(3);
+  int64_t output_height = grad_output.size(2);
+  int64_t output_width = grad_output.size(3);
+  int64_t channel_blocks = (channels + kChannelsLastBlock - 1) / kChannelsLastBlock;
+
+  // parallel on dim N and blocks of C
+  at::parallel_for(0, nbatch * channel_blocks, 0, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      int64_t n = i / channel_blocks;
+      int64_t c0 = (i % channel_blocks) * kChannelsLastBlock;
+      int64_t c1 = std::min(c0 + kChannelsLastBlock, channels);
+      scalar_t* gin = grad_input_data + n * input_height * input_width * channels;
+      const scalar_t* gout = grad_output_data + n * output_height * output_width * channels;
+      const int64_t* ind = indices_data + n * output_height * output_width * channels;
+
+      for (int64_t o = 0; o < output_height * output_width; o++) {
+        for (int64_t c = c0; c < c1; c++) {
+          int64_t maxindex = ind[o * channels + c];
+          if (maxindex != -1) {
+            gin[maxindex * channels + c] += gout[o * channels + c];
+          }
+        }
+      }
+    }
+  });
+
+  if (!grad_input_.is_contiguous(memory_format)) {
+    grad_input_.copy_(grad_input);
+  }
+}
+
+void max_pool2d_channels_last_kernel_impl(
+    Tensor& output,
+    Tensor& indices,
+    const Tensor& input,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    int dilationW, int dilationH) {
+  AT_DISPATCH_FLOATING_TYPES_AND(ScalarType::BFloat16, input.scalar_type(), "max_pool2d_channels_last", [&] {
+    cpu_max_pool_channels_last<scalar_t>(
+        output, indices, input, kW, kH, dW, dH, padW, padH, dilationW, dilationH);
+  });
+}
+
+void max_pool2d_backward_channels_last_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad_output,
+    const Tensor& indices) {
+  AT_DISPATCH_FLOATING_TYPES_AND(ScalarType::BFloat16, grad_output.scalar_type(), "max_pool2d_backward_channels_last", [&] {
+    cpu_max_pool_backward_channels_last<scalar_t>(grad_input, grad_output, indices);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(max_pool2d_channels_last_kernel, &max_pool2d_channels_last_kernel_impl);
+REGISTER_DISPATCH(max_pool2d_backward_channels_last_kernel, &max_pool2d_backward_channels_last_kernel_impl);
+
+}} // at::native
@@ -1,12 +1,18 @@
 #include <ATen/ATen.h>
 
+#include <ATen/AccumulateType.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 #include <ATen/core/DistributionsHelper.h>
 #include <ATen/native/UnaryOps.h>
 
+#include <algorithm>
+#include <functional>
+#include <vector>
+
 namespace at {
 namespace native {
 namespace {
@@ -115,10 +121,117 @@ static void multinomial_with_replacement_kernel_impl(
     multinomial_with_replacement_apply<scalar_t>(result, self, n_sample, gen);
   });
 }
+
+template <typename scalar_t>
+void sample_top_k_top_p_apply(
+    Tensor& result,
+    const Tensor& self,
+    const int64_t top_k,
+    const double top_p,
+    c10::optional<Generator> generator) {
+  using acc_t = at::acc_type<scalar_t, false>;
+  const int64_t n_categories = self.size(-1);
+  const int64_t n_dist = self.dim() > 1 ? self.size(-2) : 1;
+  const auto self_stride_0 = self.dim() > 1 ? self.stride(-2) : 0;
+  const auto self_stride_1 = self.stride(-1);
+  const scalar_t* const self_ptr = self.data_ptr<scalar_t>();
+  int64_t* const result_ptr = result.data_ptr<int64_t>();
+
+  // draw the uniform samples upfront, so that the rows can be sampled in
+  // parallel
+  std::vector<double> uniform_samples(n_dist);
+  {
+    auto gen = get_generator_or_default<CPUGeneratorImpl>(generator, detail::getDefaultCPUGenerator());
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    at::uniform_real_distribution<double> uniform(0, 1);
+    for (int64_t i = 0; i < n_dist; i++) {
+      uniform_samples[i] = uniform(gen);
+    }
+  }
+
+  at::parallel_for(0, n_dist, 1, [&](int64_t begin, int64_t end) {
+    std::vector<acc_t> logits(n_categories);
+    std::vector<acc_t> kept;
+    for (int64_t i = begin; i < end; i++) {
+      acc_t max_logit = -std::numeric_limits<acc_t>::infinity();
+      for (int64_t j = 0; j < n_categories; j++) {
+        logits[j] = self_ptr[i * self_stride_0 + j * self_stride_1];
+        TORCH_CHECK(!_isnan(logits[j]), "_sample_top_k_top_p: logits contain NaN");
+        max_logit = std::max(max_logit, logits[j]);
+      }
+
+      // the logits are kept if they are at least threshold
+      kept = logits;
+      acc_t threshold = -std::numeric_limits<acc_t>::infinity();
+      if (top_k > 0 && top_k < n_categories) {
+        std::nth_element(
+            kept.begin(), kept.begin() + top_k - 1, kept.end(), std::greater<acc_t>());
+        threshold = kept[top_k - 1];
+        kept.resize(top_k);
+      }
+      if (top_p < 1) {
+        std::sort(kept.begin(), kept.end(), std::greater<acc_t>());
+        acc_t kept_mass = 0;
+        for (const acc_t logit : kept) {
+          kept_mass += std::exp(logit - max_logit);
+        }
+        const acc_t target = top_p * kept_mass;
+        acc_t mass = 0;
+        for (const acc_t logit : kept) {
+          mass += std::exp(logit - max_logit);
+          if (mass >= target) {
+            threshold = std::max(threshold, logit);
+            break;
+          }
+        }
+      }
+
+      acc_t total = 0;
+      for (int64_t j = 0; j < n_categories; j++) {
+        if (logits[j] >= threshold) {
+          total += std::exp(logits[j] - max_logit);
+        }
+      }
+      const acc_t sample = uniform_samples[i] * total;
+      acc_t mass = 0;
+      int64_t sample_idx = -1;
+      for (int64_t j = 0; j < n_categories; j++) {
+        if (logits[j] >= threshold) {
+          const acc_t weight = std::exp(logits[j] - max_logit);
+          if (weight > 0) {
+            mass += weight;
+            // the last kept logit if the rounding of the sum leaves the
+            // sample above mass
+            sample_idx = j;
+            if (mass > sample) {
+              break;
+            }
+          }
+        }
+      }
+      result_ptr[i] = sample_idx;
+    }
+  });
+}
+
+static void sample_top_k_top_p_kernel_impl(
+    Tensor& result,
+    const Tensor& self,
+    const int64_t top_k,
+    const double top_p,
+    c10::optional<Generator> gen) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "sample_top_k_top_p", [&] {
+    sample_top_k_top_p_apply<scalar_t>(result, self, top_k, top_p, gen);
+  });
+}
 }
 
 REGISTER_DISPATCH(
     multinomial_with_replacement_stub,
     &multinomial_with_replacement_kernel_impl);
+REGISTER_DISPATCH(
+    sample_top_k_top_p_stub,
+    &sample_top_k_top_p_kernel_impl);
 }
 }
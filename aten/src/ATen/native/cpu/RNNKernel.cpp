@@ -0,0 +1,170 @@
+#include <ATen/native/RNN.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <cmath>
+
+namespace at {
+namespace native {
+
+namespace {
+
+using namespace vec256;
+
+template <typename scalar_t>
+inline scalar_t sigmoid(scalar_t a) {
+  return static_cast<scalar_t>(1) / (static_cast<scalar_t>(1) + std::exp(-a));
+}
+
+template <typename scalar_t>
+inline Vec256<scalar_t> sigmoid(Vec256<scalar_t> a) {
+  a = Vec256<scalar_t>(static_cast<scalar_t>(0)) - a;
+  a = a.exp();
+  a = Vec256<scalar_t>(static_cast<scalar_t>(1)) + a;
+  return a.reciprocal();
+}
+
+// Batch rows in a task of parallel_for, so that the small cells of a time
+// step stay on one thread.
+int64_t cell_grain_size(int64_t row_size) {
+  return std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, row_size));
+}
+
+// igates and hgates are [batch, 4 * hidden] with the input, forget, cell and
+// output gates, cx is [batch, hidden].
+template <typename scalar_t>
+void lstm_cell_pointwise_kernel_impl(
+    Tensor& hy,
+    Tensor& cy,
+    const Tensor& igates,
+    const Tensor& hgates,
+    const Tensor& cx) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t batch_size = cx.size(0);
+  const int64_t hidden_size = cx.size(1);
+  const Tensor igates_contig = igates.contiguous();
+  const Tensor hgates_contig = hgates.contiguous();
+  const Tensor cx_contig = cx.contiguous();
+  const scalar_t* igates_data = igates_contig.data_ptr<scalar_t>();
+  const scalar_t* hgates_data = hgates_contig.data_ptr<scalar_t>();
+  const scalar_t* cx_data = cx_contig.data_ptr<scalar_t>();
+  scalar_t* hy_data = hy.data_ptr<scalar_t>();
+  scalar_t* cy_data = cy.data_ptr<scalar_t>();
+
+  at::parallel_for(
+      0, batch_size, cell_grain_size(4 * hidden_size), [&](int64_t begin, int64_t end) {
+        for (int64_t b = begin; b < end; ++b) {
+          const scalar_t* ig = igates_data + b * 4 * hidden_size;
+          const scalar_t* hg = hgates_data + b * 4 * hidden_size;
+          const scalar_t* c_prev = cx_data + b * hidden_size;
+          scalar_t* h = hy_data + b * hidden_size;
+          scalar_t* c = cy_data + b * hidden_size;
+          const int64_t H = hidden_size;
+          int64_t j = 0;
+          for (; j + Vec::size() <= H; j += Vec::size()) {
+            const Vec ingate =
+                sigmoid(Vec::loadu(ig + j) + Vec::loadu(hg + j));
+            const Vec forgetgate =
+                sigmoid(Vec::loadu(ig + H + j) + Vec::loadu(hg + H + j));
+            const Vec cellgate =
+                (Vec::loadu(ig + 2 * H + j) + Vec::loadu(hg + 2 * H + j)).tanh();
+            const Vec outgate =
+                sigmoid(Vec::loadu(ig + 3 * H + j) + Vec::loadu(hg + 3 * H + j));
+            const Vec cell = forgetgate * Vec::loadu(c_prev + j) + ingate * cellgate;
+            cell.store(c + j);
+            (outgate * cell.tanh()).store(h + j);
+          }
+          for (; j < H; ++j) {
+            const scalar_t ingate = sigmoid(ig[j] + hg[j]);
+            const scalar_t forgetgate = sigmoid(ig[H + j] + hg[H + j]);
+            const scalar_t cellgate = std::tanh(ig[2 * H + j] + hg[2 * H + j]);
+            const scalar_t outgate = sigmoid(ig[3 * H + j] + hg[3 * H + j]);
+            const scalar_t cell = forgetgate * c_prev[j] + ingate * cellgate;
+            c[j] = cell;
+            h[j] = outgate * std::tanh(cell);
+          }
+        }
+      });
+}
+
+// igates and hgates are [batch, 3 * hidden] with the reset, input and new
+// gates, hx is [batch, hidden].
+template <typename scalar_t>
+void gru_cell_pointwise_kernel_impl(
+    Tensor& hy,
+    const Tensor& igates,
+    const Tensor& hgates,
+    const Tensor& hx) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t batch_size = hx.size(0);
+  const int64_t hidden_size = hx.size(1);
+  const Tensor igates_contig = igates.contiguous();
+  const Tensor hgates_contig = hgates.contiguous();
+  const Tensor hx_contig = hx.contiguous();
+  const scalar_t* igates_data = igates_contig.data_ptr<scalar_t>();
+  const scalar_t* hgates_data = hgates_contig.data_ptr<scalar_t>();
+  const scalar_t* hx_data = hx_contig.data_ptr<scalar_t>();
+  scalar_t* hy_data = hy.data_ptr<scalar_t>();
+
+  at::parallel_for(
+      0, batch_size, cell_grain_size(3 * hidden_size), [&](int64_t begin, int64_t end) {
+        for (int64_t b = begin; b < end; ++b) {
+          const scalar_t* ig = igates_data + b * 3 * hidden_size;
+          const scalar_t* hg = hgates_data + b * 3 * hidden_size;
+          const scalar_t* h_prev = hx_data + b * hidden_size;
+          scalar_t* h = hy_data + b * hidden_size;
+          const int64_t H = hidden_size;
+          int64_t j = 0;
+          for (; j + Vec::size() <= H; j += Vec::size()) {
+            const Vec reset_gate =
+                sigmoid(Vec::loadu(hg + j) + Vec::loadu(ig + j));
+            const Vec input_gate =
+                sigmoid(Vec::loadu(hg + H + j) + Vec::loadu(ig + H + j));
+            const Vec new_gate =
+                (Vec::loadu(ig + 2 * H + j) + Vec::loadu(hg + 2 * H + j) * reset_gate)
+                    .tanh();
+            ((Vec::loadu(h_prev + j) - new_gate) * input_gate + new_gate)
+                .store(h + j);
+          }
+          for (; j < H; ++j) {
+            const scalar_t reset_gate = sigmoid(hg[j] + ig[j]);
+            const scalar_t input_gate = sigmoid(hg[H + j] + ig[H + j]);
+            const scalar_t new_gate =
+                std::tanh(ig[2 * H + j] + hg[2 * H + j] * reset_gate);
+            h[j] = (h_prev[j] - new_gate) * input_gate + new_gate;
+          }
+        }
+      });
+}
+
+void lstm_cell_pointwise_kernel(
+    Tensor& hy,
+    Tensor& cy,
+    const Tensor& igates,
+    const Tensor& hgates,
+    const Tensor& cx) {
+  AT_DISPATCH_FLOATING_TYPES(cx.scalar_type(), "lstm_cell_pointwise_cpu", [&] {
+    lstm_cell_pointwise_kernel_impl<scalar_t>(hy, cy, igates, hgates, cx);
+  });
+}
+
+void gru_cell_pointwise_kernel(
+    Tensor& hy,
+    const Tensor& igates,
+    const Tensor& hgates,
+    const Tensor& hx) {
+  AT_DISPATCH_FLOATING_TYPES(hx.scalar_type(), "gru_cell_pointwise_cpu", [&] {
+    gru_cell_pointwise_kernel_impl<scalar_t>(hy, igates, hgates, hx);
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(lstm_cell_pointwise_stub, &lstm_cell_pointwise_kernel);
+REGISTER_DISPATCH(gru_cell_pointwise_stub, &gru_cell_pointwise_kernel);
+
+} // namespace native
+} // namespace at
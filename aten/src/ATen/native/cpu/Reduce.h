@@ -2,6 +2,7 @@
 
 #include <ATen/native/cpu/Loops.h>
 #include <ATen/Parallel.h>
+#include <ATen/core/Array.h>
 #include <c10/util/TypeList.h>
 
 #include <sstream>
@@ -146,6 +147,15 @@ static void set_results(const std::tuple<res_t...>& result, const TensorIterator
   AT_ASSERT((size_t)num_outputs == result_size);
 }
 
+// Outputs of the same type, one per element of the array
+template<typename traits, typename res_t, int size>
+static void set_results(const at::detail::Array<res_t, size>& result, const TensorIteratorBase &iter, const int num_outputs) {
+  AT_ASSERT(num_outputs == size);
+  for (int i = 0; i < size; i++) {
+    set_result<traits>(i, result[i], iter, num_outputs);
+  }
+}
+
 template <typename T, typename... Args>
 struct all_same : guts::conjunction<
   std::is_same<T, Args>...
@@ -13,17 +13,102 @@
 
 #include <c10/util/Optional.h>
 #include <ATen/AccumulateType.h>
+#include <ATen/Parallel.h>
 
 namespace at { namespace native { namespace {
 
 using namespace vec256;
 
-template <typename scalar_t, typename func_t>
+// Note [Parallel cumulative ops]
+// A scan along a long dim, e.g. the cumsum of a 1-D tensor, is split into
+// blocks of kScanBlockSize elements and done in three passes: the totals of
+// the blocks are reduced in parallel, the totals are scanned serially into the
+// starting value of every block, and the blocks are scanned in parallel from
+// their starting values. The blocks don't depend on the number of threads, so
+// that neither do the results.
+//
+// The scans along a dim whose rows are contiguous, e.g. cumsum(dim=0) of a
+// matrix, go over kScanRowBlockSize rows at a time, the elements of the rows
+// at the same index being side by side, so that the loop over the rows is
+// vectorized.
+constexpr int64_t kScanBlockSize = 16384;
+constexpr int64_t kBlockedScanMinSize = 4 * kScanBlockSize;
+constexpr int64_t kScanRowBlockSize = 64;
+
+template <typename scalar_t, typename acc_t, typename func_t>
+static inline void cum_scan_row(
+    scalar_t* result_data, int64_t result_dim_stride,
+    const scalar_t* self_data, int64_t self_dim_stride,
+    int64_t size, acc_t init_val, const func_t& op) {
+  acc_t cum_number = init_val;
+  for (int64_t i = 0; i < size; ++i) {
+    cum_number = op(cum_number, static_cast<acc_t>(self_data[i * self_dim_stride]));
+    result_data[i * result_dim_stride] = static_cast<scalar_t>(cum_number);
+  }
+}
+
+template <typename scalar_t, typename acc_t, typename func_t>
+static inline void cum_scan_row_blocked(
+    scalar_t* result_data, int64_t result_dim_stride,
+    const scalar_t* self_data, int64_t self_dim_stride,
+    int64_t size, acc_t init_val, const func_t& op) {
+  const int64_t num_blocks = divup(size, kScanBlockSize);
+  // The totals of the blocks, then the starting value of every block
+  std::vector<acc_t> block_init(num_blocks, init_val);
+  at::parallel_for(1, num_blocks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      const scalar_t* block_data = self_data + (b - 1) * kScanBlockSize * self_dim_stride;
+      acc_t total = init_val;
+      for (int64_t i = 0; i < kScanBlockSize; ++i) {
+        total = op(total, static_cast<acc_t>(block_data[i * self_dim_stride]));
+      }
+      block_init[b] = total;
+    }
+  });
+  for (int64_t b = 2; b < num_blocks; ++b) {
+    block_init[b] = op(block_init[b - 1], block_init[b]);
+  }
+  at::parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      const int64_t offset = b * kScanBlockSize;
+      cum_scan_row(
+        result_data + offset * result_dim_stride, result_dim_stride,
+        self_data + offset * self_dim_stride, self_dim_stride,
+        std::min(kScanBlockSize, size - offset), block_init[b], op);
+    }
+  });
+}
+
+// Scans n rows, the i-th element of the j-th row being at
+// data[i * dim_stride + j]
+template <typename scalar_t, typename acc_t, typename func_t>
+static inline void cum_scan_contiguous_rows(
+    scalar_t* result_data, int64_t result_dim_stride,
+    const scalar_t* self_data, int64_t self_dim_stride,
+    int64_t size, int64_t n, acc_t init_val, const func_t& op) {
+  acc_t cum_numbers[kScanRowBlockSize];
+  for (int64_t j0 = 0; j0 < n; j0 += kScanRowBlockSize) {
+    const int64_t rows = std::min(kScanRowBlockSize, n - j0);
+    std::fill(cum_numbers, cum_numbers + rows, init_val);
+    for (int64_t i = 0; i < size; ++i) {
+      const scalar_t* self_row = self_data + i * self_dim_stride + j0;
+      scalar_t* result_row = result_data + i * result_dim_stride + j0;
+      for (int64_t j = 0; j < rows; ++j) {
+        cum_numbers[j] = op(cum_numbers[j], static_cast<acc_t>(self_row[j]));
+        result_row[j] = static_cast<scalar_t>(cum_numbers[j]);
+      }
+    }
+  }
+}
+
+// Scans self along dim with the associative op, whose identity is init_val,
+// accumulating in acc_t (see Note [Parallel cumulative ops])
+template <typename scalar_t, typename acc_t, typename func_t>
 static inline void cpu_cum_base_kernel(Tensor& result,
     const Tensor& self,
     int64_t dim,
-    const func_t& f,
-    scalar_t init_val) {
+    const func_t& op,
+    acc_t init_val) {
   if (result.sizes() != self.sizes()) {
     result.resize_as_(self);
   }
@@ -46,16 +131,35 @@ static inline void cpu_cum_base_kernel(Tensor& result,
 
   auto result_dim_stride = ensure_nonempty_stride(result, dim);
   auto self_dim_stride = ensure_nonempty_stride(self, dim);
+  int64_t self_dim_size = ensure_nonempty_size(self, dim);
 
   auto loop = [&](char** data, const int64_t* strides, int64_t n) {
     auto* result_data_bytes = data[0];
     const auto* self_data_bytes = data[1];
 
+    if (self_dim_size >= kBlockedScanMinSize) {
+      for (int64_t i = 0; i < n; ++i) {
+        cum_scan_row_blocked(
+          (scalar_t*)result_data_bytes, result_dim_stride,
+          (scalar_t*)self_data_bytes, self_dim_stride,
+          self_dim_size, init_val, op);
+        result_data_bytes += strides[0];
+        self_data_bytes += strides[1];
+      }
+      return;
+    }
+    if (n > 1 && strides[0] == sizeof(scalar_t) && strides[1] == sizeof(scalar_t)) {
+      cum_scan_contiguous_rows(
+        (scalar_t*)result_data_bytes, result_dim_stride,
+        (scalar_t*)self_data_bytes, self_dim_stride,
+        self_dim_size, n, init_val, op);
+      return;
+    }
     for (int64_t i = 0; i < n; ++i) {
-      f(
+      cum_scan_row(
         (scalar_t*)result_data_bytes, result_dim_stride,
-        (scalar_t*)self_data_bytes, self_dim_stride, init_val
-      );
+        (scalar_t*)self_data_bytes, self_dim_stride,
+        self_dim_size, init_val, op);
       result_data_bytes += strides[0];
       self_data_bytes += strides[1];
     }
@@ -66,59 +170,35 @@ static inline void cpu_cum_base_kernel(Tensor& result,
 
 static void cumsum_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
   auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
 
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX(self.scalar_type(), "cumsum_out_cpu", [&] {
-    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
-      scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        auto cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
-          cum_number += self_data[i * self_dim_stride];
-          result_data[i * result_dim_stride] = (scalar_t)cum_number;
-        }
-      }, /*init_val=*/ 0
+    using acc_t = at::acc_type<scalar_t, false>;
+    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [] (acc_t x, acc_t y) {
+        return x + y;
+      }, /*init_val=*/ acc_t(0)
     );
   });
 }
 
 static void cumprod_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
   auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
 
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX(self.scalar_type(), "cumprod_out_cpu", [&] {
-    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
-      scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        auto cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
-          cum_number *= self_data[i * self_dim_stride];
-          result_data[i * result_dim_stride] = (scalar_t)cum_number;
-        }
-      }, /*init_val=*/ 1
+    using acc_t = at::acc_type<scalar_t, false>;
+    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [] (acc_t x, acc_t y) {
+        return x * y;
+      }, /*init_val=*/ acc_t(1)
     );
   });
 }
 
 static void logcumsumexp_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
   auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
 
   AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "logcumsumexp_out_cpu", [&] {
-    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
-      scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        scalar_t cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
-          scalar_t x = self_data[i * self_dim_stride];
-
-          // Reference : https://www.tensorflow.org/api_docs/python/tf/math/cumulative_logsumexp
-          auto log_add_exp = [](scalar_t x, scalar_t y) -> scalar_t {
-            return std::log1p(std::exp(std::min(x, y) - std::max(x, y))) + std::max(x, y);
-          };
-          cum_number = log_add_exp(x, cum_number);
-          result_data[i * result_dim_stride] = static_cast<scalar_t>(cum_number);
-        }
+    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [] (scalar_t x, scalar_t y) {
+        // Reference : https://www.tensorflow.org/api_docs/python/tf/math/cumulative_logsumexp
+        return std::log1p(std::exp(std::min(x, y) - std::max(x, y))) + std::max(x, y);
       }, /*init_val=*/ -std::numeric_limits<scalar_t>::infinity()
     );
   });
@@ -157,6 +237,16 @@ static void std_var_kernel_impl(TensorIterator &iter, bool unbiased, bool take_s
   });
 }
 
+static void aminmax_var_mean_kernel_impl(TensorIterator &iter, bool unbiased) {
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(iter.dtype(), "aminmax_var_mean_cpu", [&] {
+    binary_kernel_reduce(
+      iter,
+      MinMaxWelfordOps<scalar_t, double, int64_t, double> { unbiased },
+      MinMaxWelfordData<scalar_t, double, int64_t, double>()
+    );
+  });
+}
+
 static void prod_kernel_impl(TensorIterator& iter) {
   // Workaround for the error: '*' in boolean context, suggest '&&' instead [-Werror=int-in-bool-context]
   if (iter.dtype() == ScalarType::Bool) {
@@ -388,6 +478,7 @@ static void argmin_kernel_impl(TensorIterator &iter) {
 
 REGISTER_DISPATCH(nansum_stub, &nansum_kernel_impl);
 REGISTER_DISPATCH(std_var_stub, &std_var_kernel_impl);
+REGISTER_DISPATCH(aminmax_var_mean_stub, &aminmax_var_mean_kernel_impl);
 REGISTER_DISPATCH(prod_stub, &prod_kernel_impl);
 REGISTER_DISPATCH(mean_stub, &mean_kernel_impl);
 REGISTER_DISPATCH(norm_stub, &norm_kernel_tensor_iterator_impl);
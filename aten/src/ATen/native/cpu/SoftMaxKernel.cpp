@@ -2,12 +2,13 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <numeric>
+#include <type_traits>
 
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
-#include <ATen/cpu/vec256/functional.h>
-#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec512/functional.h>
 #include <c10/util/Optional.h>
 
 // [Note AVX-SSE transitions] In general we avoid calls into cmath for code
@@ -22,13 +23,145 @@
 namespace at { namespace native {
 namespace {
 
+// Rows at least this long are normalized with the online softmax below. They
+// don't fit in L1, so the separate passes for max, sum and normalize each
+// read them from L2 or memory.
+static constexpr int64_t ONLINE_SOFTMAX_MIN_DIM_SIZE = 4096;
+
+// Online softmax: computes the max of a row and the sum of exp(x - max) in a
+// single read of the row. The row is split into blocks that fit in L1; the
+// max of a block is taken first, then the running sum is rescaled to the new
+// max once per block and the exps of the block are added to it.
+template <typename scalar_t>
+inline void _vec_online_max_sum(
+    const scalar_t* input_data,
+    int64_t dim_size,
+    scalar_t& max_input,
+    scalar_t& tmp_sum) {
+  using Vec = vec::Vectorized<scalar_t>;
+  static constexpr int64_t BLOCK_SIZE = 32 * Vec::size();
+  const Vec neg_inf(-std::numeric_limits<scalar_t>::infinity());
+  // the lanes past the end of the row are -inf, which don't change the max
+  // and add nothing to the sum
+  auto load = [&](int64_t d) {
+    if (d + Vec::size() <= dim_size) {
+      return Vec::loadu(input_data + d);
+    }
+    return Vec::set(
+        neg_inf, Vec::loadu(input_data + d, dim_size - d), dim_size - d);
+  };
+
+  max_input = -std::numeric_limits<scalar_t>::infinity();
+  Vec sum_vec(0);
+  for (int64_t begin = 0; begin < dim_size; begin += BLOCK_SIZE) {
+    const int64_t end = std::min(begin + BLOCK_SIZE, dim_size);
+    Vec max_vec = vec::maximum(Vec(max_input), load(begin));
+    for (int64_t d = begin + Vec::size(); d < end; d += Vec::size()) {
+      max_vec = vec::maximum(max_vec, load(d));
+    }
+    const scalar_t new_max = vec::vec_reduce_all<scalar_t>(
+        [](Vec& x, Vec& y) { return vec::maximum(x, y); },
+        max_vec,
+        Vec::size());
+    // Everything so far is -inf and contributes nothing. Skipping it avoids
+    // the NaN of -inf - -inf for rows that start with masked out values.
+    if (new_max == -std::numeric_limits<scalar_t>::infinity()) {
+      continue;
+    }
+    const Vec new_max_vec(new_max);
+    sum_vec = sum_vec * (Vec(max_input) - new_max_vec).exp();
+    for (int64_t d = begin; d < end; d += Vec::size()) {
+      sum_vec = sum_vec + (load(d) - new_max_vec).exp();
+    }
+    max_input = new_max;
+  }
+  tmp_sum = vec::vec_reduce_all<scalar_t>(
+      [](Vec& x, Vec& y) { return x + y; }, sum_vec, Vec::size());
+}
+
+// See [Note AVX-SSE transitions] for why this doesn't call std::log.
+template <typename scalar_t>
+inline scalar_t _vec_log(scalar_t x) {
+  using Vec = vec::Vectorized<scalar_t>;
+  scalar_t log_arr[Vec::size()];
+  Vec(x).log().store(log_arr);
+  return log_arr[0];
+}
+
+template <typename scalar_t>
+inline void _vec_online_log_softmax_lastdim(
+    scalar_t* input_data_base,
+    scalar_t* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  using Vec = vec::Vectorized<scalar_t>;
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          scalar_t* input_data = input_data_base + i * dim_size;
+          scalar_t* output_data = output_data_base + i * dim_size;
+          scalar_t max_input;
+          scalar_t tmp_sum;
+          _vec_online_max_sum(input_data, dim_size, max_input, tmp_sum);
+          tmp_sum = _vec_log(tmp_sum);
+          // Keeps the order of the operations of _vec_log_softmax_lastdim.
+          vec::map(
+              [tmp_sum, max_input](Vec x) { return x - Vec(max_input) - Vec(tmp_sum); },
+              output_data,
+              input_data,
+              dim_size);
+        }
+      });
+}
+
+template <typename scalar_t>
+inline void _vec_online_softmax_lastdim(
+    scalar_t* input_data_base,
+    scalar_t* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  using Vec = vec::Vectorized<scalar_t>;
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          scalar_t* input_data = input_data_base + i * dim_size;
+          scalar_t* output_data = output_data_base + i * dim_size;
+          scalar_t max_input;
+          scalar_t tmp_sum;
+          _vec_online_max_sum(input_data, dim_size, max_input, tmp_sum);
+          tmp_sum = 1 / tmp_sum;
+          vec::map(
+              [tmp_sum, max_input](Vec x) {
+                return (x - Vec(max_input)).exp() * Vec(tmp_sum);
+              },
+              output_data,
+              input_data,
+              dim_size);
+        }
+      });
+}
+
 template <typename scalar_t>
 inline void _vec_log_softmax_lastdim(
     scalar_t* input_data_base,
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec::Vectorized<scalar_t>;
   static constexpr int64_t CHUNK_SIZE = (128 / sizeof(scalar_t)) * Vec::size();
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size * CHUNK_SIZE);
   if (grain_size < CHUNK_SIZE)
@@ -48,8 +181,8 @@ inline void _vec_log_softmax_lastdim(
           for (int64_t j = 0; j < loop_end; j++) {
             int64_t i = ii + j;
             scalar_t* input_data = input_data_base + i * dim_size;
-            max_input_arr[j] = vec256::reduce_all<scalar_t>(
-                [](Vec& x, Vec& y) { return vec256::maximum(x, y); },
+            max_input_arr[j] = vec::reduce_all<scalar_t>(
+                [](Vec& x, Vec& y) { return vec::maximum(x, y); },
                 input_data,
                 dim_size);
           }
@@ -57,7 +190,7 @@ inline void _vec_log_softmax_lastdim(
             int64_t i = ii + j;
             scalar_t* input_data = input_data_base + i * dim_size;
             scalar_t max_input = max_input_arr[j];
-            tmp_sum_scalar[j] = vec256::map_reduce_all<scalar_t>(
+            tmp_sum_scalar[j] = vec::map_reduce_all<scalar_t>(
                 [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
                 [](Vec x, Vec y) { return x + y; },
                 input_data,
@@ -65,7 +198,7 @@ inline void _vec_log_softmax_lastdim(
           }
           // See [Note AVX-SSE transitions] for why this should call the
           // vectorized version (aside from perf improvements).
-          vec256::map(
+          vec::map(
               [](Vec x) { return x.log(); },
               tmp_sum_scalar,
               tmp_sum_scalar,
@@ -82,7 +215,7 @@ inline void _vec_log_softmax_lastdim(
             // is small, if we compute `max_input` plus `tmp_sum` before,
             // there would be a numerical problem. See an example in
             // https://github.com/pytorch/pytorch/issues/11752#issuecomment-422883379
-            vec256::map(
+            vec::map(
                 [tmp_sum, max_input](Vec x) { return x - Vec(max_input) - Vec(tmp_sum); },
                 output_data,
                 input_data,
@@ -98,7 +231,7 @@ inline void _vec_softmax_lastdim(
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec::Vectorized<scalar_t>;
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
   if (grain_size < 1)
     grain_size = 1;
@@ -111,19 +244,19 @@ inline void _vec_softmax_lastdim(
         for (int64_t i = begin; i < end; i++) {
           scalar_t* input_data = input_data_base + i * dim_size;
           scalar_t* output_data = output_data_base + i * dim_size;
-          scalar_t max_input = vec256::reduce_all<scalar_t>(
-              [](Vec& x, Vec& y) { return vec256::maximum(x, y); },
+          scalar_t max_input = vec::reduce_all<scalar_t>(
+              [](Vec& x, Vec& y) { return vec::maximum(x, y); },
               input_data,
               dim_size);
-          vec256::map(
+          vec::map(
               [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
               output_data,
               input_data,
               dim_size);
-          scalar_t tmp_sum = vec256::reduce_all<scalar_t>(
+          scalar_t tmp_sum = vec::reduce_all<scalar_t>(
               [](Vec x, Vec y) { return x + y; }, output_data, dim_size);
           tmp_sum = 1 / tmp_sum;
-          vec256::map(
+          vec::map(
               [tmp_sum](Vec x) { return x * Vec(tmp_sum); },
               output_data,
               output_data,
@@ -139,7 +272,7 @@ inline void _vec_host_softmax_backward_lastdim(
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec::Vectorized<scalar_t>;
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
   if (grain_size < 1)
     grain_size = 1;
@@ -155,10 +288,10 @@ inline void _vec_host_softmax_backward_lastdim(
           scalar_t* output_data = output_data_base + i * dim_size;
           scalar_t sum;
           if (log_softmax) {
-            sum = vec256::reduce_all<scalar_t>(
+            sum = vec::reduce_all<scalar_t>(
                 [](Vec& x, Vec& y) { return x + y; }, grad_data, dim_size);
           } else {
-            sum = vec256::map2_reduce_all<scalar_t>(
+            sum = vec::map2_reduce_all<scalar_t>(
                 [](Vec x, Vec y) { return x * y; },
                 [](Vec x, Vec y) { return x + y; },
                 grad_data,
@@ -166,14 +299,14 @@ inline void _vec_host_softmax_backward_lastdim(
                 dim_size);
           }
           if (log_softmax) {
-            vec256::map2(
+            vec::map2(
                 [sum](Vec x, Vec y) { return x - ((y.exp()) * Vec(sum)); },
                 grad_input_data,
                 grad_data,
                 output_data,
                 dim_size);
           } else {
-            vec256::map2(
+            vec::map2(
                 [sum](Vec x, Vec y) { return (x - Vec(sum)) * y; },
                 grad_input_data,
                 grad_data,
@@ -193,9 +326,19 @@ struct vec_host_softmax_lastdim {
       outer_size *= input.size(i);
     scalar_t* input_data_base = input.data_ptr<scalar_t>();
     scalar_t* output_data_base = output.data_ptr<scalar_t>();
-    if (LogSoftMax) {
+    // The online kernels accumulate in scalar_t, which is not precise
+    // enough for BFloat16.
+    const bool online = dim_size >= ONLINE_SOFTMAX_MIN_DIM_SIZE &&
+        !std::is_same<scalar_t, BFloat16>::value;
+    if (LogSoftMax && online) {
+      _vec_online_log_softmax_lastdim(
+          input_data_base, output_data_base, outer_size, dim_size);
+    } else if (LogSoftMax) {
       _vec_log_softmax_lastdim(
           input_data_base, output_data_base, outer_size, dim_size);
+    } else if (online) {
+      _vec_online_softmax_lastdim(
+          input_data_base, output_data_base, outer_size, dim_size);
     } else {
       _vec_softmax_lastdim(
           input_data_base, output_data_base, outer_size, dim_size);
@@ -223,6 +366,122 @@ struct vec_host_softmax_backward_lastdim {
   }
 };
 
+// log_softmax followed by nll_loss over the rows of input, without writing
+// the log-probabilities: each row is read once to compute its logsumexp, and
+// only the target element is read again.
+template <typename scalar_t>
+void _vec_log_softmax_nll_loss(
+    Tensor& losses,
+    Tensor& weights,
+    Tensor& lse,
+    const Tensor& input,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index) {
+  const int64_t outer_size = input.size(0);
+  const int64_t dim_size = input.size(1);
+  const scalar_t* input_data_base = input.data_ptr<scalar_t>();
+  const int64_t* target_data = target.data_ptr<int64_t>();
+  const scalar_t* weight_data =
+      weight.defined() ? weight.data_ptr<scalar_t>() : nullptr;
+  scalar_t* losses_data = losses.data_ptr<scalar_t>();
+  scalar_t* weights_data = weights.data_ptr<scalar_t>();
+  scalar_t* lse_data = lse.data_ptr<scalar_t>();
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          const scalar_t* input_data = input_data_base + i * dim_size;
+          scalar_t max_input;
+          scalar_t tmp_sum;
+          _vec_online_max_sum(input_data, dim_size, max_input, tmp_sum);
+          tmp_sum = _vec_log(tmp_sum);
+          lse_data[i] = max_input + tmp_sum;
+
+          const int64_t cur_target = target_data[i];
+          if (cur_target == ignore_index) {
+            losses_data[i] = 0;
+            weights_data[i] = 0;
+            continue;
+          }
+          TORCH_CHECK_INDEX(
+              cur_target >= 0 && cur_target < dim_size,
+              "Target ",
+              cur_target,
+              " is out of bounds.");
+          const scalar_t cur_weight = weight_data != nullptr
+              ? weight_data[cur_target]
+              : static_cast<scalar_t>(1);
+          losses_data[i] =
+              -(input_data[cur_target] - max_input - tmp_sum) * cur_weight;
+          weights_data[i] = cur_weight;
+        }
+      });
+}
+
+// grad_input = grad_losses * weight[target] * (softmax(input) - one_hot(target))
+// over the rows of input, with the softmax computed from the saved logsumexp.
+template <typename scalar_t>
+void _vec_log_softmax_nll_loss_backward(
+    Tensor& grad_input,
+    const Tensor& grad_losses,
+    const Tensor& input,
+    const Tensor& target,
+    const Tensor& weight,
+    const Tensor& lse,
+    int64_t ignore_index) {
+  using Vec = vec::Vectorized<scalar_t>;
+  const int64_t outer_size = input.size(0);
+  const int64_t dim_size = input.size(1);
+  scalar_t* grad_input_data_base = grad_input.data_ptr<scalar_t>();
+  const scalar_t* grad_losses_data = grad_losses.data_ptr<scalar_t>();
+  const scalar_t* input_data_base = input.data_ptr<scalar_t>();
+  const int64_t* target_data = target.data_ptr<int64_t>();
+  const scalar_t* weight_data =
+      weight.defined() ? weight.data_ptr<scalar_t>() : nullptr;
+  const scalar_t* lse_data = lse.data_ptr<scalar_t>();
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          const scalar_t* input_data = input_data_base + i * dim_size;
+          scalar_t* grad_input_data = grad_input_data_base + i * dim_size;
+          const int64_t cur_target = target_data[i];
+          if (cur_target == ignore_index) {
+            std::fill(grad_input_data, grad_input_data + dim_size, scalar_t(0));
+            continue;
+          }
+          TORCH_CHECK_INDEX(
+              cur_target >= 0 && cur_target < dim_size,
+              "Target ",
+              cur_target,
+              " is out of bounds.");
+          const scalar_t grad = grad_losses_data[i] *
+              (weight_data != nullptr ? weight_data[cur_target]
+                                      : static_cast<scalar_t>(1));
+          const scalar_t cur_lse = lse_data[i];
+          vec::map(
+              [grad, cur_lse](Vec x) { return (x - Vec(cur_lse)).exp() * Vec(grad); },
+              grad_input_data,
+              input_data,
+              dim_size);
+          grad_input_data[cur_target] -= grad;
+        }
+      });
+}
+
 static void softmax_lastdim_kernel_impl(Tensor& result, const Tensor& self) {
   AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "softmax_lastdim_kernel_impl", [&] {
     vec_host_softmax_lastdim<scalar_t, false>::apply(result, self);
@@ -261,6 +520,36 @@ static void log_softmax_backward_lastdim_kernel_impl(
       });
 }
 
+static void log_softmax_nll_loss_kernel_impl(
+    Tensor& losses,
+    Tensor& weights,
+    Tensor& lse,
+    const Tensor& input,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index) {
+  AT_DISPATCH_FLOATING_TYPES(
+      input.scalar_type(), "log_softmax_nll_loss_kernel_impl", [&] {
+        _vec_log_softmax_nll_loss<scalar_t>(
+            losses, weights, lse, input, target, weight, ignore_index);
+      });
+}
+
+static void log_softmax_nll_loss_backward_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad_losses,
+    const Tensor& input,
+    const Tensor& target,
+    const Tensor& weight,
+    const Tensor& lse,
+    int64_t ignore_index) {
+  AT_DISPATCH_FLOATING_TYPES(
+      input.scalar_type(), "log_softmax_nll_loss_backward_kernel_impl", [&] {
+        _vec_log_softmax_nll_loss_backward<scalar_t>(
+            grad_input, grad_losses, input, target, weight, lse, ignore_index);
+      });
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(softmax_lastdim_kernel, &softmax_lastdim_kernel_impl);
@@ -271,5 +560,11 @@ REGISTER_DISPATCH(
 REGISTER_DISPATCH(
     log_softmax_backward_lastdim_kernel,
     &log_softmax_backward_lastdim_kernel_impl);
+REGISTER_DISPATCH(
+    log_softmax_nll_loss_kernel,
+    &log_softmax_nll_loss_kernel_impl);
+REGISTER_DISPATCH(
+    log_softmax_nll_loss_backward_kernel,
+    &log_softmax_nll_loss_backward_kernel_impl);
 
 }} // namespace at::native
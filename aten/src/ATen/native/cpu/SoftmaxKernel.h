@@ -8,11 +8,17 @@ namespace native {
 
 using forward_fn = void(*)(Tensor &, const Tensor &);
 using backward_fn = void(*)(Tensor &, const Tensor &, const Tensor&);
+// (losses, weights, lse, input, target, weight, ignore_index)
+using log_softmax_nll_loss_fn = void(*)(Tensor&, Tensor&, Tensor&, const Tensor&, const Tensor&, const Tensor&, int64_t);
+// (grad_input, grad_losses, input, target, weight, lse, ignore_index)
+using log_softmax_nll_loss_backward_fn = void(*)(Tensor&, const Tensor&, const Tensor&, const Tensor&, const Tensor&, const Tensor&, int64_t);
 
 DECLARE_DISPATCH(forward_fn, softmax_lastdim_kernel);
 DECLARE_DISPATCH(forward_fn, log_softmax_lastdim_kernel);
 DECLARE_DISPATCH(backward_fn, softmax_backward_lastdim_kernel);
 DECLARE_DISPATCH(backward_fn, log_softmax_backward_lastdim_kernel);
+DECLARE_DISPATCH(log_softmax_nll_loss_fn, log_softmax_nll_loss_kernel);
+DECLARE_DISPATCH(log_softmax_nll_loss_backward_fn, log_softmax_nll_loss_backward_kernel);
 
 }
 }
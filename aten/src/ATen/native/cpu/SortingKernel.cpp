@@ -8,6 +8,10 @@
 #include <ATen/native/Sorting.h>
 #include <ATen/native/SortingUtils.h>
 
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
 namespace at { namespace native {
 
 namespace {
@@ -92,6 +96,173 @@ struct KeyValueCompDesc {
   }
 };
 
+// Slices with at least this many elements are sorted with a parallel radix
+// sort, if there are few of them.
+constexpr int64_t kRadixSortMinSize = 1 << 16;
+constexpr int kRadixBits = 8;
+constexpr int64_t kRadixBuckets = 1 << kRadixBits;
+
+// Maps keys to unsigned integers with the same order, so that they can be
+// sorted digit by digit.
+template <typename scalar_t, typename Enable = void>
+struct RadixTraits {
+  static constexpr bool supported = false;
+};
+
+template <typename scalar_t>
+struct RadixTraits<scalar_t, typename std::enable_if<
+    std::is_integral<scalar_t>::value &&
+    !std::is_same<scalar_t, bool>::value>::type> {
+  static constexpr bool supported = true;
+  using key_t = typename std::make_unsigned<scalar_t>::type;
+
+  static bool is_nan(scalar_t) {
+    return false;
+  }
+
+  static key_t to_key(scalar_t value) {
+    auto key = static_cast<key_t>(value);
+    if (std::is_signed<scalar_t>::value) {
+      // negative values come first
+      key ^= key_t(1) << (sizeof(key_t) * 8 - 1);
+    }
+    return key;
+  }
+};
+
+template <typename scalar_t>
+struct RadixTraits<scalar_t, typename std::enable_if<
+    std::is_floating_point<scalar_t>::value>::type> {
+  static constexpr bool supported = true;
+  using key_t = typename std::conditional<
+    sizeof(scalar_t) == 4, uint32_t, uint64_t>::type;
+
+  static bool is_nan(scalar_t value) {
+    return _isnan(value);
+  }
+
+  static key_t to_key(scalar_t value) {
+    constexpr key_t sign = key_t(1) << (sizeof(key_t) * 8 - 1);
+    // -0.0 and 0.0 compare equal, so they keep their order
+    if (value == 0) {
+      return sign;
+    }
+    key_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // negative values come first, in reverse order of their magnitude
+    return (bits & sign) ? ~bits : (bits | sign);
+  }
+};
+
+// Stable LSD radix sort of one slice, in passes of kRadixBits bits. Each pass
+// splits the slice into chunks that are histogrammed in parallel, and then
+// scattered in parallel to the offsets given by the prefix sum of the
+// histograms in (digit, chunk) order. NaNs are sorted like the comparator
+// path does: last if ascending, first if descending.
+template <typename scalar_t>
+typename std::enable_if<RadixTraits<scalar_t>::supported, bool>::type
+radix_sort_slice(
+    scalar_t* values, int64_t values_dim_stride,
+    int64_t* indices, int64_t indices_dim_stride,
+    int64_t dim_size, bool descending) {
+  using traits = RadixTraits<scalar_t>;
+  using key_t = typename traits::key_t;
+  constexpr int64_t grain_size = kRadixSortMinSize / 4;
+  const int64_t n = dim_size;
+
+  std::vector<key_t> keys(n);
+  std::vector<key_t> keys_tmp(n);
+  std::vector<int64_t> idx(n);
+  std::vector<int64_t> idx_tmp(n);
+  const key_t nan_key = descending ? 0 : std::numeric_limits<key_t>::max();
+  at::parallel_for(0, n, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const scalar_t value = values[i * values_dim_stride];
+      const key_t key = traits::to_key(value);
+      keys[i] = traits::is_nan(value) ? nan_key : (descending ? ~key : key);
+      idx[i] = i;
+    }
+  });
+
+  const int64_t num_chunks = std::max<int64_t>(1,
+    std::min<int64_t>(at::get_num_threads(), n / grain_size));
+  const int64_t chunk_size = (n + num_chunks - 1) / num_chunks;
+  std::vector<int64_t> offsets(num_chunks * kRadixBuckets);
+  for (size_t shift = 0; shift < sizeof(key_t) * 8; shift += kRadixBits) {
+    auto digit = [shift](key_t key) {
+      return static_cast<int64_t>((key >> shift) & (kRadixBuckets - 1));
+    };
+
+    std::fill(offsets.begin(), offsets.end(), 0);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; ++c) {
+        int64_t* counts = offsets.data() + c * kRadixBuckets;
+        const int64_t chunk_end = std::min(n, (c + 1) * chunk_size);
+        for (int64_t i = c * chunk_size; i < chunk_end; ++i) {
+          counts[digit(keys[i])]++;
+        }
+      }
+    });
+
+    // exclusive prefix sum in (digit, chunk) order, so that the scatter is
+    // stable. A pass where all keys have the same digit is skipped.
+    bool trivial = false;
+    int64_t offset = 0;
+    for (int64_t d = 0; d < kRadixBuckets; ++d) {
+      const int64_t start = offset;
+      for (int64_t c = 0; c < num_chunks; ++c) {
+        const int64_t count = offsets[c * kRadixBuckets + d];
+        offsets[c * kRadixBuckets + d] = offset;
+        offset += count;
+      }
+      trivial = trivial || offset - start == n;
+    }
+    if (trivial) {
+      continue;
+    }
+
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; ++c) {
+        int64_t* positions = offsets.data() + c * kRadixBuckets;
+        const int64_t chunk_end = std::min(n, (c + 1) * chunk_size);
+        for (int64_t i = c * chunk_size; i < chunk_end; ++i) {
+          const int64_t pos = positions[digit(keys[i])]++;
+          keys_tmp[pos] = keys[i];
+          idx_tmp[pos] = idx[i];
+        }
+      }
+    });
+    std::swap(keys, keys_tmp);
+    std::swap(idx, idx_tmp);
+  }
+
+  // gather the values before overwriting them
+  std::vector<key_t>().swap(keys);
+  std::vector<key_t>().swap(keys_tmp);
+  std::vector<scalar_t> sorted(n);
+  at::parallel_for(0, n, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      sorted[i] = values[idx[i] * values_dim_stride];
+    }
+  });
+  at::parallel_for(0, n, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      values[i * values_dim_stride] = sorted[i];
+      indices[i * indices_dim_stride] = idx[i];
+    }
+  });
+  return true;
+}
+
+template <typename scalar_t>
+typename std::enable_if<!RadixTraits<scalar_t>::supported, bool>::type
+radix_sort_slice(
+    scalar_t* values, int64_t values_dim_stride,
+    int64_t* indices, int64_t indices_dim_stride,
+    int64_t dim_size, bool descending) {
+  return false;
+}
+
 static void sort_kernel(
     Tensor& values,
     Tensor& indices,
@@ -99,6 +270,11 @@ static void sort_kernel(
     bool descending) {
   dim = maybe_wrap_dim(dim, values.dim());
   _fill_indices(indices, dim);
+  const int64_t sort_size = values.dim() == 0 ? 1 : values.size(dim);
+  const int64_t num_slices = sort_size == 0 ? 0 : values.numel() / sort_size;
+  // With many slices, parallelizing over the slices is better.
+  const bool use_radix_sort = sort_size >= kRadixSortMinSize &&
+    (num_slices == 1 || num_slices < at::get_num_threads());
   _dim_apply(
     values, indices, dim,
     "sort_cpu", [&](
@@ -107,6 +283,11 @@ static void sort_kernel(
       int64_t dim_size
     ) {
       using scalar_t = typename std::remove_pointer<decltype(values)>::type;
+      if (use_radix_sort && radix_sort_slice(
+            values, values_dim_stride, indices, indices_dim_stride,
+            dim_size, descending)) {
+        return;
+      }
       auto values_accessor = StridedRandomAccessor<scalar_t>(
         values, values_dim_stride);
       auto indices_accessor = StridedRandomAccessor<int64_t>(
@@ -127,6 +308,126 @@ static void sort_kernel(
   );
 }
 
+// Slices with at least this many elements are split into chunks selected in
+// parallel, if there are few slices.
+constexpr int64_t kParallelTopkMinSize = 1 << 16;
+
+// Orders (value, index) pairs from best to worst for topk. NaNs are the
+// largest values, and ties go to the smaller index, so that the result
+// doesn't depend on how a slice is split into chunks.
+template <typename scalar_t>
+struct TopkBetter {
+  bool largest;
+
+  bool operator()(
+      const std::pair<scalar_t, int64_t>& x,
+      const std::pair<scalar_t, int64_t>& y) const {
+    const bool x_nan = _isnan<scalar_t>(x.first);
+    const bool y_nan = _isnan<scalar_t>(y.first);
+    if (x_nan || y_nan) {
+      if (x_nan && y_nan) {
+        return x.second < y.second;
+      }
+      return largest ? x_nan : y_nan;
+    }
+    if (x.first != y.first) {
+      return largest ? x.first > y.first : x.first < y.first;
+    }
+    return x.second < y.second;
+  }
+};
+
+// Selects the k best of `n` strided values into `queue`, which is reused
+// across calls. If k is small compared to n, this keeps a heap of the k best
+// elements seen so far, whose worst element is the threshold new elements
+// have to beat; most elements are rejected by that single comparison.
+// Otherwise it selects with nth_element. The k best come first, sorted if
+// `sorted` is set.
+template <typename scalar_t>
+void topk_select(
+    std::vector<std::pair<scalar_t, int64_t>>& queue,
+    const scalar_t* data,
+    int64_t stride,
+    int64_t n,
+    int64_t index_offset,
+    int64_t k,
+    const TopkBetter<scalar_t>& better,
+    bool sorted) {
+  queue.clear();
+  if (k * 64 <= n) {
+    queue.reserve(k);
+    for (int64_t j = 0; j < k; ++j) {
+      queue.emplace_back(data[j * stride], j + index_offset);
+    }
+    // the worst of the k best is at the front
+    std::make_heap(queue.begin(), queue.end(), better);
+    for (int64_t j = k; j < n; ++j) {
+      const std::pair<scalar_t, int64_t> elem(
+        data[j * stride], j + index_offset);
+      if (better(elem, queue.front())) {
+        std::pop_heap(queue.begin(), queue.end(), better);
+        queue.back() = elem;
+        std::push_heap(queue.begin(), queue.end(), better);
+      }
+    }
+    if (sorted) {
+      std::sort_heap(queue.begin(), queue.end(), better);
+    }
+  } else {
+    queue.reserve(n);
+    for (int64_t j = 0; j < n; ++j) {
+      queue.emplace_back(data[j * stride], j + index_offset);
+    }
+    std::nth_element(
+      queue.begin(), queue.begin() + k - 1, queue.end(), better);
+    if (sorted) {
+      std::sort(queue.begin(), queue.begin() + k - 1, better);
+    }
+  }
+}
+
+// Selects the k best of a huge slice by selecting the k best of each chunk in
+// parallel, and then the k best of the candidates.
+template <typename scalar_t>
+void topk_select_parallel(
+    std::vector<std::pair<scalar_t, int64_t>>& queue,
+    const scalar_t* data,
+    int64_t stride,
+    int64_t n,
+    int64_t k,
+    const TopkBetter<scalar_t>& better,
+    bool sorted) {
+  const int64_t num_chunks = std::max<int64_t>(1,
+    std::min<int64_t>(at::get_num_threads(), n / (kParallelTopkMinSize / 4)));
+  const int64_t chunk_size = (n + num_chunks - 1) / num_chunks;
+  std::vector<std::vector<std::pair<scalar_t, int64_t>>> candidates(num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      const int64_t offset = c * chunk_size;
+      const int64_t len = std::min(n, offset + chunk_size) - offset;
+      const int64_t chunk_k = std::min(k, len);
+      auto& chunk = candidates[c];
+      topk_select(chunk, data + offset * stride, stride, len, offset,
+        chunk_k, better, /*sorted=*/false);
+      chunk.resize(chunk_k);
+    }
+  });
+
+  std::vector<std::pair<scalar_t, int64_t>> merged;
+  for (const auto& chunk : candidates) {
+    merged.insert(merged.end(), chunk.begin(), chunk.end());
+  }
+  queue.clear();
+  if (sorted) {
+    std::partial_sort(
+      merged.begin(), merged.begin() + k, merged.end(), better);
+  } else {
+    std::nth_element(
+      merged.begin(), merged.begin() + k - 1, merged.end(), better);
+  }
+  queue.assign(merged.begin(), merged.begin() + k);
+}
+
 static void topk_kernel(
     Tensor& values,
     Tensor& indices,
@@ -135,69 +436,58 @@ static void topk_kernel(
     int64_t dim,
     bool largest,
     bool sorted) {
+  if (k == 0 || self.numel() == 0) {
+    return;
+  }
+  dim = maybe_wrap_dim(dim, self.dim());
+  auto iter = TensorIteratorConfig()
+    .check_all_same_dtype(false)
+    .resize_outputs(false)
+    .declare_static_shape(self.sizes(), /*squash_dim=*/dim)
+    .add_output(values)
+    .add_output(indices)
+    .add_input(self)
+    .build();
+
+  const int64_t n = self.size(dim);
+  const int64_t self_dim_stride = self.stride(dim);
+  const int64_t values_dim_stride = values.stride(dim);
+  const int64_t indices_dim_stride = indices.stride(dim);
+  const int64_t num_slices = self.numel() / n;
+  // Parallelize within the slices if there are too few of them to give every
+  // thread work, and across slices otherwise.
+  const bool parallel_slices = n >= kParallelTopkMinSize &&
+    num_slices < at::get_num_threads();
+  const int64_t grain_size = parallel_slices
+    ? num_slices
+    : std::max<int64_t>(1, at::internal::GRAIN_SIZE / n);
+
   AT_DISPATCH_ALL_TYPES(self.scalar_type(), "topk_cpu", [&] {
-    dim_apply(
-        {self, values, indices},
-        dim,
-        [&](int64_t i, TensorList tl) {
-          auto tmp_values = tl[0].accessor<scalar_t, 1>();
-          auto mode_values = tl[1].accessor<scalar_t, 1>();
-          auto mode_indices = tl[2].accessor<int64_t, 1>();
-
-          auto n = tmp_values.size(0);
-          auto use_partial_sort = k * 64 <= n;
-
-          using elem_t = std::pair<scalar_t, int64_t>;
-          std::vector<elem_t> queue(n);
-          for (int64_t j = 0; j < n; j++) {
-            queue[j].first = tmp_values[j];
-            queue[j].second = j;
-          }
-
-          // we want NaN to be sorted as top for numpy compatibility
-          if (use_partial_sort) {
-            if (largest) {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-            } else {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-            }
-          } else {
-            if (largest) {
-              std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k - 1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                  });
-              }
-            } else {
-              std::nth_element(queue.begin(), queue.begin() + k -1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k -1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                  });
-              }
-            }
-          }
-
-          for (int64_t j = 0; j < k; j++) {
-            mode_values[j] = queue[j].first;
-            mode_indices[j] = queue[j].second;
-          }
-        });
+    const TopkBetter<scalar_t> better{largest};
+    auto loop = [&](char** data, const int64_t* strides, int64_t num) {
+      // reused by all the slices of this thread
+      std::vector<std::pair<scalar_t, int64_t>> queue;
+      for (int64_t i = 0; i < num; ++i) {
+        auto* values_data =
+          reinterpret_cast<scalar_t*>(data[0] + i * strides[0]);
+        auto* indices_data =
+          reinterpret_cast<int64_t*>(data[1] + i * strides[1]);
+        const auto* self_data =
+          reinterpret_cast<const scalar_t*>(data[2] + i * strides[2]);
+        if (parallel_slices) {
+          topk_select_parallel(queue, self_data, self_dim_stride, n, k,
+            better, sorted);
+        } else {
+          topk_select(queue, self_data, self_dim_stride, n, 0, k,
+            better, sorted);
+        }
+        for (int64_t j = 0; j < k; ++j) {
+          values_data[j * values_dim_stride] = queue[j].first;
+          indices_data[j * indices_dim_stride] = queue[j].second;
+        }
+      }
+    };
+    iter.for_each(loop, grain_size);
   });
 }
 
@@ -0,0 +1,36 @@
+#include <ATen/Dispatch.h>
+#include <ATen/native/SpectralOpsUtils.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cpu/Loops.h>
+
+#include <cmath>
+
+namespace at {
+namespace native {
+namespace {
+
+void spectrogram_power_kernel(TensorIterator& iter, double power) {
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "spectrogram_power_cpu", [&]() {
+    if (power == 2) {
+      cpu_kernel(iter, [=](c10::complex<scalar_t> z) -> scalar_t {
+        return z.real() * z.real() + z.imag() * z.imag();
+      });
+    } else if (power == 1) {
+      cpu_kernel(iter, [=](c10::complex<scalar_t> z) -> scalar_t {
+        return std::abs(z);
+      });
+    } else {
+      const auto p = static_cast<scalar_t>(power);
+      cpu_kernel(iter, [=](c10::complex<scalar_t> z) -> scalar_t {
+        return std::pow(std::abs(z), p);
+      });
+    }
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(spectrogram_power_stub, &spectrogram_power_kernel);
+
+} // namespace native
+} // namespace at
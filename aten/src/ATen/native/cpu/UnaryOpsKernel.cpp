@@ -478,6 +478,10 @@ void bernoulli_tensor_kernel(Tensor& self, const Tensor& p_, c10::optional<Gener
 
 void bernoulli_scalar_kernel_default(Tensor& self, double p, c10::optional<Generator> gen) {
   CPUGeneratorImpl* generator = get_generator_or_default<CPUGeneratorImpl>(gen, detail::getDefaultCPUGenerator());
+  if (generator->is_counter_based()) {
+    templates::cpu::philox_bernoulli_kernel(self, p, generator);
+    return;
+  }
   templates::cpu::bernoulli_kernel(self, p, generator);
 }
 
@@ -487,8 +491,9 @@ void bernoulli_scalar_kernel(Tensor& self, double p, c10::optional<Generator> ge
 }
 #else
 void bernoulli_scalar_kernel(Tensor &self, double p, c10::optional<Generator> gen) {
-  if (cpuinfo_initialize() && cpuinfo_vendor_intel == cpuinfo_get_processor(0)->core->vendor) {
-    CPUGeneratorImpl* generator = get_generator_or_default<CPUGeneratorImpl>(gen, detail::getDefaultCPUGenerator());
+  CPUGeneratorImpl* generator = get_generator_or_default<CPUGeneratorImpl>(gen, detail::getDefaultCPUGenerator());
+  if (!generator->is_counter_based() &&
+      cpuinfo_initialize() && cpuinfo_vendor_intel == cpuinfo_get_processor(0)->core->vendor) {
     int64_t seed;
     {
       // See Note [Acquire lock when using random generators]
@@ -537,7 +542,8 @@ void bernoulli_scalar_kernel(Tensor &self, double p, c10::optional<Generator> ge
       }
     });
   } else {
-    // The situation of AMD, move to using the default version
+    // The situation of AMD and of the counter-based generators, move to using
+    // the default version
     bernoulli_scalar_kernel_default(self, p, gen);
   }
 }
@@ -560,11 +566,20 @@ static void log_normal_kernel(TensorIterator& iter, double mean, double std, c10
 
 void uniform_kernel(TensorIterator& iter, double from, double to, c10::optional<Generator> gen) {
   CPUGeneratorImpl* generator = get_generator_or_default<CPUGeneratorImpl>(gen, detail::getDefaultCPUGenerator());
+  if (generator->is_counter_based()) {
+    auto self = iter.tensor(0);
+    templates::cpu::philox_uniform_kernel(self, from, to, generator);
+    return;
+  }
   templates::cpu::uniform_kernel(iter, from, to, generator);
 }
 
 void normal_kernel(Tensor& self, double mean, double std, c10::optional<Generator> gen) {
   CPUGeneratorImpl* generator = get_generator_or_default<CPUGeneratorImpl>(gen, detail::getDefaultCPUGenerator());
+  if (generator->is_counter_based()) {
+    templates::cpu::philox_normal_kernel(self, mean, std, generator);
+    return;
+  }
   templates::cpu::normal_kernel(self, mean, std, generator);
 }
 
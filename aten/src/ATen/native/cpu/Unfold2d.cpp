@@ -151,6 +151,7 @@ void unfolded2d_acc_kernel(
       });
 }
 
+// Unfolds the output rows [output_row_begin, output_row_begin + output_height)
 template <typename scalar_t>
 static void unfolded2d_copy(
     scalar_t* input_data,
@@ -164,6 +165,7 @@ static void unfolded2d_copy(
     int64_t n_input_plane,
     int64_t input_height,
     int64_t input_width,
+    int64_t output_row_begin,
     int64_t output_height,
     int64_t output_width) {
   at::parallel_for(
@@ -184,7 +186,7 @@ static void unfolded2d_copy(
           if (padW > 0 || padH > 0) {
             int64_t lpad, rpad;
             for (y = 0; y < output_height; y++) {
-              iy = (int64_t)y * dH - padH + kh;
+              iy = (int64_t)(output_row_begin + y) * dH - padH + kh;
               if (iy < 0 || iy >= input_height) {
                 memset(
                     dst + (size_t)y * output_width,
@@ -235,7 +237,7 @@ static void unfolded2d_copy(
             }
           } else {
             for (y = 0; y < output_height; y++) {
-              iy = (int64_t)y * dH + kh;
+              iy = (int64_t)(output_row_begin + y) * dH + kh;
               ix = 0 + kw;
               if (dW == 1)
                 memcpy(
@@ -292,15 +294,55 @@ void unfolded2d_copy_kernel(
             n_input_plane,
             input_height,
             input_width,
+            0,
             output_height,
             output_width);
       });
 }
 
+void unfolded2d_copy_rows_kernel(
+    Tensor& finput,
+    Tensor& input,
+    int64_t kH,
+    int64_t kW,
+    int64_t dH,
+    int64_t dW,
+    int64_t padH,
+    int64_t padW,
+    int64_t n_input_plane,
+    int64_t input_height,
+    int64_t input_width,
+    int64_t output_row_begin,
+    int64_t output_rows,
+    int64_t output_width) {
+  AT_DISPATCH_ALL_TYPES_AND(
+      at::ScalarType::BFloat16, input.scalar_type(), "unfolded2d_copy_rows", [&] {
+        scalar_t* input_data = input.data_ptr<scalar_t>();
+        scalar_t* finput_data = finput.data_ptr<scalar_t>();
+
+        unfolded2d_copy(
+            input_data,
+            finput_data,
+            kH,
+            kW,
+            dH,
+            dW,
+            padH,
+            padW,
+            n_input_plane,
+            input_height,
+            input_width,
+            output_row_begin,
+            output_rows,
+            output_width);
+      });
+}
+
 } // namespace
 
 REGISTER_DISPATCH(unfolded2d_copy_stub, &unfolded2d_copy_kernel);
 REGISTER_DISPATCH(unfolded2d_acc_stub, &unfolded2d_acc_kernel);
+REGISTER_DISPATCH(unfolded2d_copy_rows_stub, &unfolded2d_copy_rows_kernel);
 
 } // namespace native
 } // namespace at
@@ -3,6 +3,9 @@
 #include <ATen/ATen.h>
 #include <ATen/CPUApplyUtils.h>
 #include <ATen/Dispatch.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/SharedReduceOps.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 
@@ -107,8 +110,304 @@ void batch_norm_cpu_inference_contiguous_kernel(Tensor& output, const Tensor& in
   });
 }
 
+// The training kernels visit the input by blocks of about this many
+// elements, small enough for the second pass over a block to hit the cache
+constexpr int64_t kBatchNormBlockSize = 4096;
+
+template <typename accscalar_t>
+using BatchNormWelford =
+    WelfordOps<accscalar_t, accscalar_t, int64_t, accscalar_t, std::pair<accscalar_t, accscalar_t>>;
+
+template <typename accscalar_t>
+using BatchNormWelfordData = WelfordData<accscalar_t, int64_t, accscalar_t>;
+
+// Contiguous inputs are n_batch * n_channel rows of image_size elements,
+// channels last inputs (and contiguous ones with an image_size of 1) are
+// n_batch * image_size rows of n_channel elements
+struct BatchNormShape {
+  int64_t n_channel;
+  int64_t n_rows;
+  int64_t row_size;
+  bool channels_last;
+};
+
+BatchNormShape batch_norm_shape(const Tensor& input) {
+  const int64_t n_channel = input.size(1);
+  const int64_t per_channel = input.numel() / n_channel;
+  const int64_t image_size = per_channel / input.size(0);
+  if (!input.is_contiguous() || image_size == 1) {
+    return {n_channel, per_channel, n_channel, true};
+  }
+  return {n_channel, input.size(0) * n_channel, image_size, false};
+}
+
+// Welford statistics of the count contiguous elements of data, with a pass
+// for the mean and one for the squared deviations
+template <typename scalar_t, typename accscalar_t>
+BatchNormWelfordData<accscalar_t> contiguous_block_stats(const scalar_t* data, int64_t count) {
+  accscalar_t sum = 0;
+  for (int64_t i = 0; i < count; i++) {
+    sum += data[i];
+  }
+  const accscalar_t mean = sum / count;
+  accscalar_t m2 = 0;
+  for (int64_t i = 0; i < count; i++) {
+    const accscalar_t delta = data[i] - mean;
+    m2 += delta * delta;
+  }
+  return {mean, m2, count, static_cast<accscalar_t>(count)};
+}
+
+template <typename scalar_t>
+void batch_norm_cpu_collect_stats_impl(Tensor& mean, Tensor& var, const Tensor& input) {
+  using accscalar_t = at::acc_type<scalar_t, false>;
+  const BatchNormWelford<accscalar_t> welford{/*unbiased=*/false, /*take_sqrt=*/false};
+  const auto shape = batch_norm_shape(input);
+  const int64_t n_channel = shape.n_channel;
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  scalar_t* mean_data = mean.data_ptr<scalar_t>();
+  scalar_t* var_data = var.data_ptr<scalar_t>();
+
+  if (!shape.channels_last) {
+    const int64_t n_batch = shape.n_rows / n_channel;
+    const int64_t image_size = shape.row_size;
+    parallel_for(0, n_channel, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        BatchNormWelfordData<accscalar_t> stats;
+        for (int64_t n = 0; n < n_batch; n++) {
+          const scalar_t* row = input_data + (n * n_channel + c) * image_size;
+          for (int64_t i = 0; i < image_size; i += kBatchNormBlockSize) {
+            stats = welford.combine(stats, contiguous_block_stats<scalar_t, accscalar_t>(
+                row + i, std::min(kBatchNormBlockSize, image_size - i)));
+          }
+        }
+        mean_data[c] = stats.mean;
+        var_data[c] = stats.m2 / stats.nf;
+      }
+    });
+    return;
+  }
+
+  // Every block of rows gets the statistics of its channels, which are
+  // then combined in order so that the result doesn't depend on the number
+  // of threads
+  const int64_t n_rows = shape.n_rows;
+  const int64_t rows_per_block = std::max<int64_t>(1, kBatchNormBlockSize / n_channel);
+  const int64_t n_blocks = (n_rows + rows_per_block - 1) / rows_per_block;
+  std::vector<accscalar_t> block_mean(n_blocks * n_channel, 0);
+  std::vector<accscalar_t> block_m2(n_blocks * n_channel, 0);
+  parallel_for(0, n_blocks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      const int64_t row_begin = b * rows_per_block;
+      const int64_t row_end = std::min(n_rows, row_begin + rows_per_block);
+      accscalar_t* b_mean = block_mean.data() + b * n_channel;
+      accscalar_t* b_m2 = block_m2.data() + b * n_channel;
+      for (int64_t r = row_begin; r < row_end; r++) {
+        const scalar_t* row = input_data + r * n_channel;
+        for (int64_t c = 0; c < n_channel; c++) {
+          b_mean[c] += row[c];
+        }
+      }
+      const accscalar_t count = row_end - row_begin;
+      for (int64_t c = 0; c < n_channel; c++) {
+        b_mean[c] /= count;
+      }
+      for (int64_t r = row_begin; r < row_end; r++) {
+        const scalar_t* row = input_data + r * n_channel;
+        for (int64_t c = 0; c < n_channel; c++) {
+          const accscalar_t delta = row[c] - b_mean[c];
+          b_m2[c] += delta * delta;
+        }
+      }
+    }
+  });
+  parallel_for(0, n_channel, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      BatchNormWelfordData<accscalar_t> stats;
+      for (int64_t b = 0; b < n_blocks; b++) {
+        const int64_t count = std::min(rows_per_block, n_rows - b * rows_per_block);
+        stats = welford.combine(stats, BatchNormWelfordData<accscalar_t>(
+            block_mean[b * n_channel + c], block_m2[b * n_channel + c],
+            count, static_cast<accscalar_t>(count)));
+      }
+      mean_data[c] = stats.mean;
+      var_data[c] = stats.m2 / stats.nf;
+    }
+  });
+}
+
+template <typename scalar_t>
+void batch_norm_cpu_transform_impl(Tensor& output, const Tensor& input,
+    const Tensor& alpha, const Tensor& beta) {
+  using Vec = Vec256<scalar_t>;
+  const auto shape = batch_norm_shape(input);
+  const int64_t n_channel = shape.n_channel;
+  const int64_t row_size = shape.row_size;
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  const scalar_t* alpha_data = alpha.data_ptr<scalar_t>();
+  const scalar_t* beta_data = beta.data_ptr<scalar_t>();
+
+  const int64_t grain_size = std::max<int64_t>(1, kBatchNormBlockSize / row_size);
+  parallel_for(0, shape.n_rows, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t r = begin; r < end; r++) {
+      const scalar_t* in = input_data + r * row_size;
+      scalar_t* out = output_data + r * row_size;
+      if (shape.channels_last) {
+        for (int64_t c = 0; c < n_channel; c++) {
+          out[c] = in[c] * alpha_data[c] + beta_data[c];
+        }
+      } else {
+        const int64_t c = r % n_channel;
+        const Vec alpha_vec(alpha_data[c]);
+        const Vec beta_vec(beta_data[c]);
+        int64_t d = 0;
+        for (; d < row_size - (row_size % Vec::size()); d += Vec::size()) {
+          (Vec::loadu(in + d) * alpha_vec + beta_vec).store(out + d);
+        }
+        if (row_size - d > 0) {
+          (Vec::loadu(in + d, row_size - d) * alpha_vec + beta_vec).store(out + d, row_size - d);
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void batch_norm_cpu_backward_impl(Tensor& grad_input, Tensor& sum_dy, Tensor& sum_dy_xmu,
+    const Tensor& grad_output, const Tensor& input, const Tensor& weight,
+    const Tensor& mean, const Tensor& invstd) {
+  using accscalar_t = at::acc_type<scalar_t, false>;
+  const auto shape = batch_norm_shape(input);
+  const int64_t n_channel = shape.n_channel;
+  const int64_t n_rows = shape.n_rows;
+  const int64_t row_size = shape.row_size;
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const scalar_t* grad_output_data = grad_output.data_ptr<scalar_t>();
+  const scalar_t* mean_data = mean.data_ptr<scalar_t>();
+  const scalar_t* invstd_data = invstd.data_ptr<scalar_t>();
+  const scalar_t* weight_data = weight.defined() ? weight.data_ptr<scalar_t>() : nullptr;
+
+  // Sums of dy and dy * (x - mean) over every channel, in one pass
+  std::vector<accscalar_t> sums(n_channel, 0);
+  std::vector<accscalar_t> dots(n_channel, 0);
+  if (!shape.channels_last) {
+    parallel_for(0, n_channel, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        const accscalar_t m = mean_data[c];
+        accscalar_t sum = 0;
+        accscalar_t dot = 0;
+        for (int64_t r = c; r < n_rows; r += n_channel) {
+          const scalar_t* x = input_data + r * row_size;
+          const scalar_t* dy = grad_output_data + r * row_size;
+          for (int64_t i = 0; i < row_size; i++) {
+            sum += dy[i];
+            dot += (x[i] - m) * dy[i];
+          }
+        }
+        sums[c] = sum;
+        dots[c] = dot;
+      }
+    });
+  } else {
+    const int64_t rows_per_block = std::max<int64_t>(1, kBatchNormBlockSize / n_channel);
+    const int64_t n_blocks = (n_rows + rows_per_block - 1) / rows_per_block;
+    std::vector<accscalar_t> block_sums(n_blocks * n_channel, 0);
+    std::vector<accscalar_t> block_dots(n_blocks * n_channel, 0);
+    parallel_for(0, n_blocks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; b++) {
+        accscalar_t* b_sum = block_sums.data() + b * n_channel;
+        accscalar_t* b_dot = block_dots.data() + b * n_channel;
+        const int64_t row_end = std::min(n_rows, (b + 1) * rows_per_block);
+        for (int64_t r = b * rows_per_block; r < row_end; r++) {
+          const scalar_t* x = input_data + r * n_channel;
+          const scalar_t* dy = grad_output_data + r * n_channel;
+          for (int64_t c = 0; c < n_channel; c++) {
+            b_sum[c] += dy[c];
+            b_dot[c] += (x[c] - mean_data[c]) * dy[c];
+          }
+        }
+      }
+    });
+    for (int64_t b = 0; b < n_blocks; b++) {
+      for (int64_t c = 0; c < n_channel; c++) {
+        sums[c] += block_sums[b * n_channel + c];
+        dots[c] += block_dots[b * n_channel + c];
+      }
+    }
+  }
+
+  scalar_t* sum_dy_data = sum_dy.data_ptr<scalar_t>();
+  scalar_t* sum_dy_xmu_data = sum_dy_xmu.data_ptr<scalar_t>();
+  for (int64_t c = 0; c < n_channel; c++) {
+    sum_dy_data[c] = sums[c];
+    sum_dy_xmu_data[c] = dots[c];
+  }
+  if (!grad_input.defined()) {
+    return;
+  }
+
+  // dL/dX = (dy - mean(dy) - (x - mean) * mean(dy * (x - mean)) * invstd^2) * invstd * w
+  //       = dy * alpha + x * beta + gamma
+  const accscalar_t n = input.numel() / n_channel;
+  std::vector<accscalar_t> alpha(n_channel), beta(n_channel), gamma(n_channel);
+  for (int64_t c = 0; c < n_channel; c++) {
+    const accscalar_t s = invstd_data[c];
+    const accscalar_t w = weight_data ? weight_data[c] : 1;
+    const accscalar_t k = dots[c] * s * s / n;
+    alpha[c] = s * w;
+    beta[c] = -k * s * w;
+    gamma[c] = (mean_data[c] * k - sums[c] / n) * s * w;
+  }
+  scalar_t* grad_input_data = grad_input.data_ptr<scalar_t>();
+  const int64_t grain_size = std::max<int64_t>(1, kBatchNormBlockSize / row_size);
+  parallel_for(0, n_rows, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t r = begin; r < end; r++) {
+      const scalar_t* x = input_data + r * row_size;
+      const scalar_t* dy = grad_output_data + r * row_size;
+      scalar_t* dx = grad_input_data + r * row_size;
+      if (shape.channels_last) {
+        for (int64_t c = 0; c < n_channel; c++) {
+          dx[c] = dy[c] * alpha[c] + x[c] * beta[c] + gamma[c];
+        }
+      } else {
+        const int64_t c = r % n_channel;
+        const accscalar_t a = alpha[c], b = beta[c], g = gamma[c];
+        for (int64_t i = 0; i < row_size; i++) {
+          dx[i] = dy[i] * a + x[i] * b + g;
+        }
+      }
+    }
+  });
+}
+
+void batch_norm_cpu_collect_stats_kernel(Tensor& mean, Tensor& var, const Tensor& input) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "batch_norm_cpu_collect_stats", [&] {
+    batch_norm_cpu_collect_stats_impl<scalar_t>(mean, var, input);
+  });
+}
+
+void batch_norm_cpu_transform_kernel(Tensor& output, const Tensor& input,
+    const Tensor& alpha, const Tensor& beta) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "batch_norm_cpu_transform", [&] {
+    batch_norm_cpu_transform_impl<scalar_t>(output, input, alpha, beta);
+  });
+}
+
+void batch_norm_cpu_backward_kernel(Tensor& grad_input, Tensor& sum_dy, Tensor& sum_dy_xmu,
+    const Tensor& grad_output, const Tensor& input, const Tensor& weight,
+    const Tensor& mean, const Tensor& invstd) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "batch_norm_cpu_backward", [&] {
+    batch_norm_cpu_backward_impl<scalar_t>(grad_input, sum_dy, sum_dy_xmu,
+        grad_output, input, weight, mean, invstd);
+  });
+}
+
 }// anonymous namespace
 
 REGISTER_DISPATCH(batch_norm_cpu_inference_contiguous_stub, &batch_norm_cpu_inference_contiguous_kernel);
+REGISTER_DISPATCH(batch_norm_cpu_collect_stats_stub, &batch_norm_cpu_collect_stats_kernel);
+REGISTER_DISPATCH(batch_norm_cpu_transform_stub, &batch_norm_cpu_transform_kernel);
+REGISTER_DISPATCH(batch_norm_cpu_backward_stub, &batch_norm_cpu_backward_kernel);
 
 }} // namespace at::native
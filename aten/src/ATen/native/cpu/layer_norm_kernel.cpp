@@ -5,8 +5,7 @@
 #include <ATen/ATen.h>
 #include <ATen/CPUApplyUtils.h>
 #include <ATen/Dispatch.h>
-#include <ATen/cpu/vec256/functional.h>
-#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec512/functional.h>
 #include <ATen/Parallel.h>
 
 namespace at {
@@ -14,6 +13,56 @@ namespace native {
 
 namespace {
 
+// Normalizes one row of N elements and returns its mean and rstd.
+template <typename T>
+void LayerNormRow(
+    const T* X_ptr,
+    const T* gamma_data,
+    const T* beta_data,
+    int64_t N,
+    T eps,
+    T* Y_ptr,
+    T* mean_ptr,
+    T* rstd_ptr) {
+  using Vec = vec::Vectorized<T>;
+  const T c = T(1) / static_cast<T>(N);
+  const bool gamma_null = gamma_data == nullptr;
+  const bool beta_null = beta_data == nullptr;
+  T mean_val = vec::reduce_all<T>(
+      [](Vec& x, Vec& y) { return x + y; },
+      X_ptr,
+      N);
+  T rstd_val = vec::map_reduce_all<T>(
+      [](Vec x) { return x * x; },
+      [](Vec x, Vec y) { return x + y; },
+      X_ptr,
+      N);
+  mean_val *= c;
+  rstd_val = std::max(rstd_val * c - mean_val * mean_val, T(0));
+  rstd_val = T(1) / std::sqrt(rstd_val + eps);
+  const T scale = rstd_val;
+  const T bias = -rstd_val * mean_val;
+  if (gamma_null || beta_null) {
+    for (int64_t j = 0; j < N; ++j) {
+      const T gamma_v = gamma_null ? T(1) : gamma_data[j];
+      const T beta_v = beta_null ? T(0) : beta_data[j];
+      Y_ptr[j] = (X_ptr[j] * scale + bias) * gamma_v + beta_v;
+    }
+  } else {
+    vec::map3<T>(
+        [scale, bias](Vec x, Vec gamma, Vec beta) {
+          return (x * Vec(scale) + Vec(bias)) * gamma + beta;
+        },
+        Y_ptr,
+        X_ptr,
+        gamma_data,
+        beta_data,
+        N);
+  }
+  *mean_ptr = mean_val;
+  *rstd_ptr = rstd_val;
+}
+
 template <typename T>
 void LayerNormKernelImplInternal(
     const Tensor& X,
@@ -25,7 +74,6 @@ void LayerNormKernelImplInternal(
     Tensor* Y,
     Tensor* mean,
     Tensor* rstd) {
-  using Vec = vec256::Vec256<T>;
   DCHECK_EQ(X.numel(), M * N);
   DCHECK(!gamma.defined() || gamma.numel() == N);
   DCHECK(!beta.defined() || beta.numel() == N);
@@ -35,46 +83,17 @@ void LayerNormKernelImplInternal(
   T* Y_data = Y->data_ptr<T>();
   T* mean_data = mean->data_ptr<T>();
   T* rstd_data = rstd->data_ptr<T>();
-  const T c = T(1) / static_cast<T>(N);
-  const bool gamma_null = gamma_data == nullptr;
-  const bool beta_null = beta_data == nullptr;
   at::parallel_for(0, M, 1, [&](int64_t start, int64_t end) {
     for (int64_t i = start; i < end; ++i) {
-      T* X_ptr = X_data + i * N;
-      T* Y_ptr = Y_data + i * N;
-      T mean_val = vec256::reduce_all<T>(
-          [](Vec& x, Vec& y) { return x + y; },
-          X_ptr,
-          N);
-      T rstd_val = vec256::map_reduce_all<T>(
-          [](Vec x) { return x * x; },
-          [](Vec x, Vec y) { return x + y; },
-          X_ptr,
-          N);
-      mean_val *= c;
-      rstd_val = std::max(rstd_val * c - mean_val * mean_val, T(0));
-      rstd_val = T(1) / std::sqrt(rstd_val + eps);
-      const T scale = rstd_val;
-      const T bias = -rstd_val * mean_val;
-      if (gamma_null || beta_null) {
-        for (int64_t j = 0; j < N; ++j) {
-          const T gamma_v = gamma_null ? T(1) : gamma_data[j];
-          const T beta_v = beta_null ? T(0) : beta_data[j];
-          Y_ptr[j] = (X_ptr[j] * scale + bias) * gamma_v + beta_v;
-        }
-      } else {
-        vec256::map3<T>(
-            [scale, bias](Vec x, Vec gamma, Vec beta) {
-              return (x * Vec(scale) + Vec(bias)) * gamma + beta;
-            },
-            Y_ptr,
-            X_ptr,
-            gamma_data,
-            beta_data,
-            N);
-      }
-      mean_data[i] = mean_val;
-      rstd_data[i] = rstd_val;
+      LayerNormRow<T>(
+          X_data + i * N,
+          gamma_data,
+          beta_data,
+          N,
+          eps,
+          Y_data + i * N,
+          mean_data + i,
+          rstd_data + i);
     }
   });
 }
@@ -95,6 +114,86 @@ void LayerNormKernelImpl(
   });
 }
 
+// S = X * noise + R (or X + R without dropout) is written row by row and
+// normalized while the row is still in cache, so X, R and noise are read once.
+template <typename T>
+void AddLayerNormKernelImplInternal(
+    const Tensor& X,
+    const Tensor& R,
+    const Tensor& noise,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t M,
+    int64_t N,
+    T eps,
+    Tensor* S,
+    Tensor* Y,
+    Tensor* mean,
+    Tensor* rstd) {
+  using Vec = vec::Vectorized<T>;
+  DCHECK_EQ(X.numel(), M * N);
+  DCHECK_EQ(R.numel(), M * N);
+  DCHECK(!noise.defined() || noise.numel() == M * N);
+  const T* X_data = X.data_ptr<T>();
+  const T* R_data = R.data_ptr<T>();
+  const T* noise_data = noise.defined() ? noise.data_ptr<T>() : nullptr;
+  const T* gamma_data = gamma.defined() ? gamma.data_ptr<T>() : nullptr;
+  const T* beta_data = beta.defined() ? beta.data_ptr<T>() : nullptr;
+  T* S_data = S->data_ptr<T>();
+  T* Y_data = Y->data_ptr<T>();
+  T* mean_data = mean->data_ptr<T>();
+  T* rstd_data = rstd->data_ptr<T>();
+  at::parallel_for(0, M, 1, [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; ++i) {
+      T* S_ptr = S_data + i * N;
+      if (noise_data == nullptr) {
+        vec::map2<T>(
+            [](Vec x, Vec r) { return r + x; },
+            S_ptr,
+            X_data + i * N,
+            R_data + i * N,
+            N);
+      } else {
+        vec::map3<T>(
+            [](Vec x, Vec m, Vec r) { return r + x * m; },
+            S_ptr,
+            X_data + i * N,
+            noise_data + i * N,
+            R_data + i * N,
+            N);
+      }
+      LayerNormRow<T>(
+          S_ptr,
+          gamma_data,
+          beta_data,
+          N,
+          eps,
+          Y_data + i * N,
+          mean_data + i,
+          rstd_data + i);
+    }
+  });
+}
+
+void AddLayerNormKernelImpl(
+    const Tensor& X,
+    const Tensor& R,
+    const Tensor& noise,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t M,
+    int64_t N,
+    double eps,
+    Tensor* S,
+    Tensor* Y,
+    Tensor* mean,
+    Tensor* rstd) {
+  AT_DISPATCH_FLOATING_TYPES(X.scalar_type(), "AddLayerNormKernelImpl", [&]() {
+    AddLayerNormKernelImplInternal<scalar_t>(
+        X, R, noise, gamma, beta, M, N, static_cast<scalar_t>(eps), S, Y, mean, rstd);
+  });
+}
+
 template <typename T>
 void LayerNormBackwardKernelImplInternal(
     const Tensor& dY,
@@ -107,7 +206,7 @@ void LayerNormBackwardKernelImplInternal(
     Tensor* dX,
     Tensor* dgamma,
     Tensor* dbeta) {
-  using Vec = vec256::Vec256<T>;
+  using Vec = vec::Vectorized<T>;
   DCHECK_EQ(dY.numel(), M * N);
   DCHECK_EQ(X.numel(), M * N);
   DCHECK_EQ(mean.numel(), M);
@@ -161,7 +260,7 @@ void LayerNormBackwardKernelImplInternal(
         // for (int64_t j = 0; j < N; ++j) {
         //   dgamma_data[j] += dY_ptr[j] * (a * X_ptr[j] + b);
         // }
-        vec256::map3<T>(
+        vec::map3<T>(
             [a, b](Vec dgamma, Vec dy, Vec x) { return dgamma + dy * (Vec(a) * x + Vec(b)); },
             dgamma_buffer_ptr,
             dgamma_buffer_ptr,
@@ -174,7 +273,7 @@ void LayerNormBackwardKernelImplInternal(
         // for (int64_t j = 0; j < N; ++j) {
         //   dbeta_data[j] += dY_ptr[j];
         // }
-        vec256::map2<T>(
+        vec::map2<T>(
             [](Vec dbeta, Vec dy) { return dbeta + dy; },
             dbeta_buffer_ptr,
             dbeta_buffer_ptr,
@@ -192,25 +291,25 @@ void LayerNormBackwardKernelImplInternal(
         //   db += dY_ptr[j] * gamma_v;
         // }
         if (gamma_null) {
-          ds = vec256::map2_reduce_all<T>(
+          ds = vec::map2_reduce_all<T>(
               [](Vec x, Vec y) { return x * y; },
               [](Vec x, Vec y) { return x + y; },
               dY_ptr,
               X_ptr,
               N);
-          db = vec256::reduce_all<T>(
+          db = vec::reduce_all<T>(
               [](Vec& x, Vec& y) { return x + y; },
               dY_ptr,
               N);
         } else {
-          ds = vec256::map3_reduce_all<T>(
+          ds = vec::map3_reduce_all<T>(
               [](Vec x, Vec y, Vec z) { return x * y * z; },
               [](Vec x, Vec y) { return x + y; },
               dY_ptr,
               X_ptr,
               gamma_data,
               N);
-          db = vec256::map2_reduce_all<T>(
+          db = vec::map2_reduce_all<T>(
               [](Vec x, Vec y) { return x * y; },
               [](Vec x, Vec y) { return x + y; },
               dY_ptr,
@@ -226,14 +325,14 @@ void LayerNormBackwardKernelImplInternal(
         //   dX_ptr[j] = a * dY_ptr[j] * gamma_v + b * X_ptr[j] + c;
         // }
         if (gamma_null) {
-          vec256::map2<T>(
+          vec::map2<T>(
               [a, b, c](Vec dy, Vec x) { return Vec(a) * dy + Vec(b) * x + Vec(c); },
               dX_ptr,
               dY_ptr,
               X_ptr,
               N);
         } else {
-          vec256::map3<T>(
+          vec::map3<T>(
               [a, b, c](Vec dy, Vec gamma, Vec x) { return Vec(a) * dy * gamma + Vec(b) * x + Vec(c); },
               dX_ptr,
               dY_ptr,
@@ -288,6 +387,7 @@ void LayerNormBackwardKernelImpl(
 
 REGISTER_DISPATCH(LayerNormKernel, &LayerNormKernelImpl);
 REGISTER_DISPATCH(LayerNormBackwardKernel, &LayerNormBackwardKernelImpl);
+REGISTER_DISPATCH(AddLayerNormKernel, &AddLayerNormKernelImpl);
 
 } // namespace native
 } // namespace at
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <ATen/cpu/vec256/vec256.h>
+
 namespace at { namespace native { namespace {
 
 template <typename T>
@@ -27,4 +29,53 @@ inline bool data_index_step(T &x, const T &X, Args &&... args) {
   return false;
 }
 
+// The type the vectorized kernels compute BFloat16 in, converting it a row at
+// a time
+template <typename scalar_t>
+struct vec_acc_type {
+  using type = scalar_t;
+};
+
+template <>
+struct vec_acc_type<BFloat16> {
+  using type = float;
+};
+
+// The channels of a task of the channels last kernels which are parallel over
+// the channels
+constexpr int64_t kChannelsLastBlock = 64;
+
+// Returns the n values of src as acc_t: src itself when it has that type, or
+// their conversion in buffer
+template <typename T>
+inline const T* load_acc_row(const T* src, T* buffer, int64_t n) {
+  return src;
+}
+
+template <typename acc_t, typename scalar_t>
+inline const acc_t* load_acc_row(const scalar_t* src, acc_t* buffer, int64_t n) {
+  vec256::convert(src, buffer, n);
+  return buffer;
+}
+
+// Returns where to compute the n values of dst as acc_t, dst itself when it
+// has that type, or buffer, which store_acc_row converts into dst
+template <typename T>
+inline T* acc_row(T* dst, T* buffer) {
+  return dst;
+}
+
+template <typename acc_t, typename scalar_t>
+inline acc_t* acc_row(scalar_t* dst, acc_t* buffer) {
+  return buffer;
+}
+
+template <typename T>
+inline void store_acc_row(const T* acc, T* dst, int64_t n) {}
+
+template <typename acc_t, typename scalar_t>
+inline void store_acc_row(const acc_t* acc, scalar_t* dst, int64_t n) {
+  vec256::convert(acc, dst, n);
+}
+
 }}}  // namespace at::native::<anonymous>
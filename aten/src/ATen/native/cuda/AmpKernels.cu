@@ -32,6 +32,10 @@ namespace {
 static __host__ __device__ __forceinline__ int isfinite_ensure_cuda_math(float val) {
   return isfinite(val);
 }
+
+static __host__ __device__ __forceinline__ int isfinite_ensure_cuda_math(double val) {
+  return isfinite(val);
+}
 }
 
 namespace at {
@@ -174,6 +178,84 @@ void _amp_foreach_non_finite_check_and_unscale_cuda_(TensorList scaled_grads,
 }
 
 
+namespace {
+// Sets *found_inf to 1.0 if the chunk of a block contains an inf or NaN, without writing the chunk.
+template<typename scalar_t>
+struct NonFiniteCheckFunctor {
+  using opmath_t = typename get_opmath_t<scalar_t>::opmath_t;
+  __device__ __forceinline__ void operator() (
+      int chunk_size,
+      TensorListMetadata<1>& tl,
+      float* found_inf_ptr) {
+    int tensor_loc = tl.block_to_tensor[blockIdx.x];
+    int chunk_idx = tl.block_to_chunk[blockIdx.x];
+    int n = tl.numel_for_tensor[tensor_loc] - chunk_idx * chunk_size;
+    const scalar_t* x = (const scalar_t*)tl.addresses[0][tensor_loc] + chunk_idx * chunk_size;
+
+    bool found = false;
+    for (int i = threadIdx.x; i < n && i < chunk_size; i += blockDim.x) {
+      found |= !isfinite_ensure_cuda_math(static_cast<opmath_t>(x[i]));
+    }
+    if (found) {
+      *found_inf_ptr = 1.f;
+    }
+  }
+};
+} // anonymous namespace
+
+
+// Sets found_inf to 1.0 if any element of any tensor in grads is inf or NaN, without unscaling grads.
+// Used with the fused optimizers (see FusedOptimizerKernels.cu), which unscale the grads as they read them
+// and skip the step if found_inf is set, which saves writing the unscaled grads back.
+//
+// Args:
+// grads:  A TensorList of gradient tensors.  May contain infs or NaNs.
+// found_inf:  A single-element float tensor to which 1.0 will be written if any gradient contain infs/nans.
+//             Pre-zeroing found_inf, if appropriate, is the responsibility of the caller.
+void _amp_foreach_non_finite_check_cuda(TensorList grads, Tensor& found_inf)
+{
+  if (grads.size() == 0) {
+    return;
+  }
+
+  TORCH_CHECK(found_inf.is_cuda(), "found_inf must be a CUDA tensor.");
+  TORCH_CHECK(found_inf.numel() == 1, "found_inf must be a 1-element tensor.");
+  TORCH_CHECK(found_inf.scalar_type() == at::ScalarType::Float, "found_inf must be a float tensor.");
+
+  check_foreach_api_restrictions(grads);
+
+  std::vector<std::vector<at::Tensor>> tensor_lists(1);
+  tensor_lists[0].reserve(grads.size());
+  auto expected_device = grads[0].device();
+  for (const Tensor& t : grads) {
+    TORCH_CHECK(t.is_cuda(), "one of grads was not a CUDA tensor.");
+    TORCH_CHECK(t.device() == expected_device, "grads must be on the same device.");
+    TORCH_CHECK(t.layout() == at::kStrided, "one of grads was not a strided tensor.");
+    if (!t.is_non_overlapping_and_dense()) {
+      // Not MTA-safe, checked without synchronizing.
+      found_inf.copy_(at::maximum(found_inf, t.isfinite().logical_not().any().to(found_inf.dtype())));
+    } else {
+      tensor_lists[0].push_back(t);
+    }
+  }
+  if (tensor_lists[0].size() == 0) {
+    return;
+  }
+
+  const OptionalDeviceGuard device_guard(device_of(tensor_lists[0][0]));
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+    at::ScalarType::Half,
+    at::ScalarType::BFloat16,
+    tensor_lists[0][0].scalar_type(),
+    "_amp_foreach_non_finite_check_cuda",
+    [&tensor_lists, &found_inf] {
+      multi_tensor_apply<1>(tensor_lists,
+                            NonFiniteCheckFunctor<scalar_t>(),
+                            found_inf.data_ptr<float>());
+    });
+}
+
+
 // amp_update_scale_cuda_kernel is launched with a single thread to compute the new scale.
 // The scale factor is maintained and updated on the GPU to avoid synchronization.
 __global__ void amp_update_scale_cuda_kernel(int* growth_tracker,
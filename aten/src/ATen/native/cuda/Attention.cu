@@ -0,0 +1,553 @@
+#include <ATen/native/Attention.h>
+
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/DeviceUtils.cuh>
+#include <c10/macros/Macros.h>
+
+#include <limits>
+
+namespace at { namespace native {
+
+namespace {
+
+// The kernels give a warp to each row of a block of query (or, for the
+// gradients of the keys and values, key) rows, and stream tiles of the other
+// side through shared memory. Each lane holds kValuesPerLane features of its
+// row in registers, which bounds the head dimensions the kernels support;
+// larger heads use the math implementation.
+constexpr int kAttentionWarpsPerBlock = 8;
+constexpr int kAttentionThreads = kAttentionWarpsPerBlock * C10_WARP_SIZE;
+constexpr int kAttentionMaxHeadDim = 128;
+constexpr int kValuesPerLane = kAttentionMaxHeadDim / C10_WARP_SIZE;
+
+// The rows of a tile, sized to keep the shared memory of a block around 32KB
+template <typename accscalar_t>
+constexpr int attention_tile_rows() {
+  return sizeof(accscalar_t) > 4 ? 16 : 32;
+}
+
+template <typename T>
+__device__ __forceinline__ T warp_allreduce_sum(T value) {
+#pragma unroll
+  for (int offset = C10_WARP_SIZE / 2; offset > 0; offset /= 2) {
+    value += WARP_SHFL_XOR(value, offset);
+  }
+  return value;
+}
+
+struct MaskInfo {
+  int64_t strides[4];
+};
+
+template <typename scalar_t, typename accscalar_t>
+__device__ __forceinline__ accscalar_t mask_value(
+    const scalar_t* mask, const MaskInfo& info, int64_t b, int64_t h, int64_t i, int64_t j) {
+  return static_cast<accscalar_t>(
+      mask[b * info.strides[0] + h * info.strides[1] + i * info.strides[2] + j * info.strides[3]]);
+}
+
+// Online softmax: every key rescales the output accumulator of the row by
+// exp(old max - new max), so the scores are never materialized.
+template <typename scalar_t, typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(kAttentionThreads)
+__global__ void attention_forward_kernel(
+    const scalar_t* __restrict__ query,
+    const scalar_t* __restrict__ key,
+    const scalar_t* __restrict__ value,
+    const scalar_t* __restrict__ mask,
+    MaskInfo mask_info,
+    scalar_t* __restrict__ out,
+    accscalar_t* __restrict__ logsumexp,
+    int64_t heads, int64_t L, int64_t S, int E, int Ev,
+    int64_t num_row_blocks, accscalar_t scale, bool is_causal) {
+  constexpr int BLOCK_N = attention_tile_rows<accscalar_t>();
+  extern __shared__ unsigned char smem[];
+  accscalar_t* key_tile = reinterpret_cast<accscalar_t*>(smem);
+  accscalar_t* value_tile = key_tile + BLOCK_N * E;
+
+  const int warp = threadIdx.x / C10_WARP_SIZE;
+  const int lane = threadIdx.x % C10_WARP_SIZE;
+  const int64_t bh = blockIdx.x / num_row_blocks;
+  const int64_t b = bh / heads;
+  const int64_t h = bh % heads;
+  const int64_t row_begin = (blockIdx.x % num_row_blocks) * kAttentionWarpsPerBlock;
+  const int64_t i = row_begin + warp;
+  const bool active = i < L;
+  const scalar_t* k_ptr = key + bh * S * E;
+  const scalar_t* v_ptr = value + bh * S * Ev;
+
+  accscalar_t q[kValuesPerLane];
+  accscalar_t acc[kValuesPerLane];
+#pragma unroll
+  for (int t = 0; t < kValuesPerLane; t++) {
+    const int e = lane + t * C10_WARP_SIZE;
+    q[t] = (active && e < E)
+        ? scale * static_cast<accscalar_t>(query[(bh * L + i) * E + e])
+        : accscalar_t(0);
+    acc[t] = 0;
+  }
+  accscalar_t row_max = -std::numeric_limits<accscalar_t>::infinity();
+  accscalar_t row_sum = 0;
+
+  const int64_t key_end = is_causal
+      ? ::min(S, row_begin + kAttentionWarpsPerBlock) : S;
+  for (int64_t k_begin = 0; k_begin < key_end; k_begin += BLOCK_N) {
+    const int cols = static_cast<int>(::min(static_cast<int64_t>(BLOCK_N), key_end - k_begin));
+    __syncthreads();
+    for (int idx = threadIdx.x; idx < cols * E; idx += blockDim.x) {
+      key_tile[idx] = static_cast<accscalar_t>(k_ptr[k_begin * E + idx]);
+    }
+    for (int idx = threadIdx.x; idx < cols * Ev; idx += blockDim.x) {
+      value_tile[idx] = static_cast<accscalar_t>(v_ptr[k_begin * Ev + idx]);
+    }
+    __syncthreads();
+    if (!active) {
+      continue;
+    }
+    for (int c = 0; c < cols; c++) {
+      const int64_t j = k_begin + c;
+      if (is_causal && j > i) {
+        break;
+      }
+      accscalar_t s = 0;
+#pragma unroll
+      for (int t = 0; t < kValuesPerLane; t++) {
+        const int e = lane + t * C10_WARP_SIZE;
+        if (e < E) {
+          s += q[t] * key_tile[c * E + e];
+        }
+      }
+      s = warp_allreduce_sum(s);
+      if (mask != nullptr) {
+        s += mask_value<scalar_t, accscalar_t>(mask, mask_info, b, h, i, j);
+      }
+      if (s == -std::numeric_limits<accscalar_t>::infinity()) {
+        continue;
+      }
+      const accscalar_t new_max = ::max(row_max, s);
+      const accscalar_t correction = ::exp(row_max - new_max);
+      const accscalar_t p = ::exp(s - new_max);
+      row_sum = row_sum * correction + p;
+#pragma unroll
+      for (int t = 0; t < kValuesPerLane; t++) {
+        const int e = lane + t * C10_WARP_SIZE;
+        if (e < Ev) {
+          acc[t] = acc[t] * correction + p * value_tile[c * Ev + e];
+        }
+      }
+      row_max = new_max;
+    }
+  }
+
+  if (active) {
+#pragma unroll
+    for (int t = 0; t < kValuesPerLane; t++) {
+      const int e = lane + t * C10_WARP_SIZE;
+      if (e < Ev) {
+        out[(bh * L + i) * Ev + e] = static_cast<scalar_t>(acc[t] / row_sum);
+      }
+    }
+    if (lane == 0) {
+      logsumexp[bh * L + i] = row_max + ::log(row_sum);
+    }
+  }
+}
+
+// The gradient of a query row: recomputes the probabilities of the row from
+// its logsumexp against tiles of the keys and values.
+template <typename scalar_t, typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(kAttentionThreads)
+__global__ void attention_backward_query_kernel(
+    const scalar_t* __restrict__ grad_out,
+    const scalar_t* __restrict__ query,
+    const scalar_t* __restrict__ key,
+    const scalar_t* __restrict__ value,
+    const scalar_t* __restrict__ mask,
+    MaskInfo mask_info,
+    const accscalar_t* __restrict__ logsumexp,
+    const accscalar_t* __restrict__ delta,
+    scalar_t* __restrict__ grad_query,
+    int64_t heads, int64_t L, int64_t S, int E, int Ev,
+    int64_t num_row_blocks, accscalar_t scale, bool is_causal) {
+  constexpr int BLOCK_N = attention_tile_rows<accscalar_t>();
+  extern __shared__ unsigned char smem[];
+  accscalar_t* key_tile = reinterpret_cast<accscalar_t*>(smem);
+  accscalar_t* value_tile = key_tile + BLOCK_N * E;
+
+  const int warp = threadIdx.x / C10_WARP_SIZE;
+  const int lane = threadIdx.x % C10_WARP_SIZE;
+  const int64_t bh = blockIdx.x / num_row_blocks;
+  const int64_t b = bh / heads;
+  const int64_t h = bh % heads;
+  const int64_t row_begin = (blockIdx.x % num_row_blocks) * kAttentionWarpsPerBlock;
+  const int64_t i = row_begin + warp;
+  const accscalar_t neg_inf = -std::numeric_limits<accscalar_t>::infinity();
+  const accscalar_t lse = i < L ? logsumexp[bh * L + i] : neg_inf;
+  // rows with all their keys masked out don't contribute
+  const bool active = i < L && lse != neg_inf;
+  const accscalar_t row_delta = active ? delta[bh * L + i] : accscalar_t(0);
+  const scalar_t* k_ptr = key + bh * S * E;
+  const scalar_t* v_ptr = value + bh * S * Ev;
+
+  accscalar_t q[kValuesPerLane];
+  accscalar_t grad_o[kValuesPerLane];
+  accscalar_t grad_q[kValuesPerLane];
+#pragma unroll
+  for (int t = 0; t < kValuesPerLane; t++) {
+    const int e = lane + t * C10_WARP_SIZE;
+    q[t] = (active && e < E)
+        ? static_cast<accscalar_t>(query[(bh * L + i) * E + e]) : accscalar_t(0);
+    grad_o[t] = (active && e < Ev)
+        ? static_cast<accscalar_t>(grad_out[(bh * L + i) * Ev + e]) : accscalar_t(0);
+    grad_q[t] = 0;
+  }
+
+  const int64_t key_end = is_causal
+      ? ::min(S, row_begin + kAttentionWarpsPerBlock) : S;
+  for (int64_t k_begin = 0; k_begin < key_end; k_begin += BLOCK_N) {
+    const int cols = static_cast<int>(::min(static_cast<int64_t>(BLOCK_N), key_end - k_begin));
+    __syncthreads();
+    for (int idx = threadIdx.x; idx < cols * E; idx += blockDim.x) {
+      key_tile[idx] = static_cast<accscalar_t>(k_ptr[k_begin * E + idx]);
+    }
+    for (int idx = threadIdx.x; idx < cols * Ev; idx += blockDim.x) {
+      value_tile[idx] = static_cast<accscalar_t>(v_ptr[k_begin * Ev + idx]);
+    }
+    __syncthreads();
+    if (!active) {
+      continue;
+    }
+    for (int c = 0; c < cols; c++) {
+      const int64_t j = k_begin + c;
+      if (is_causal && j > i) {
+        break;
+      }
+      accscalar_t s = 0;
+      accscalar_t grad_p = 0;
+#pragma unroll
+      for (int t = 0; t < kValuesPerLane; t++) {
+        const int e = lane + t * C10_WARP_SIZE;
+        if (e < E) {
+          s += q[t] * key_tile[c * E + e];
+        }
+        if (e < Ev) {
+          grad_p += grad_o[t] * value_tile[c * Ev + e];
+        }
+      }
+      s = warp_allreduce_sum(s) * scale;
+      grad_p = warp_allreduce_sum(grad_p);
+      if (mask != nullptr) {
+        s += mask_value<scalar_t, accscalar_t>(mask, mask_info, b, h, i, j);
+      }
+      const accscalar_t grad_s = ::exp(s - lse) * (grad_p - row_delta) * scale;
+#pragma unroll
+      for (int t = 0; t < kValuesPerLane; t++) {
+        const int e = lane + t * C10_WARP_SIZE;
+        if (e < E) {
+          grad_q[t] += grad_s * key_tile[c * E + e];
+        }
+      }
+    }
+  }
+
+  if (i < L) {
+#pragma unroll
+    for (int t = 0; t < kValuesPerLane; t++) {
+      const int e = lane + t * C10_WARP_SIZE;
+      if (e < E) {
+        grad_query[(bh * L + i) * E + e] = static_cast<scalar_t>(grad_q[t]);
+      }
+    }
+  }
+}
+
+// The gradients of a key and a value row: recomputes the probabilities of
+// the key against tiles of the queries, the gradients of the output and the
+// logsumexps and deltas of their rows. Giving each key to a warp avoids
+// atomics on the accumulators.
+template <typename scalar_t, typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(kAttentionThreads)
+__global__ void attention_backward_key_value_kernel(
+    const scalar_t* __restrict__ grad_out,
+    const scalar_t* __restrict__ query,
+    const scalar_t* __restrict__ key,
+    const scalar_t* __restrict__ value,
+    const scalar_t* __restrict__ mask,
+    MaskInfo mask_info,
+    const accscalar_t* __restrict__ logsumexp,
+    const accscalar_t* __restrict__ delta,
+    scalar_t* __restrict__ grad_key,
+    scalar_t* __restrict__ grad_value,
+    int64_t heads, int64_t L, int64_t S, int E, int Ev,
+    int64_t num_row_blocks, accscalar_t scale, bool is_causal) {
+  constexpr int BLOCK_N = attention_tile_rows<accscalar_t>();
+  extern __shared__ unsigned char smem[];
+  accscalar_t* query_tile = reinterpret_cast<accscalar_t*>(smem);
+  accscalar_t* grad_out_tile = query_tile + BLOCK_N * E;
+  accscalar_t* lse_tile = grad_out_tile + BLOCK_N * Ev;
+  accscalar_t* delta_tile = lse_tile + BLOCK_N;
+
+  const int warp = threadIdx.x / C10_WARP_SIZE;
+  const int lane = threadIdx.x % C10_WARP_SIZE;
+  const int64_t bh = blockIdx.x / num_row_blocks;
+  const int64_t b = bh / heads;
+  const int64_t h = bh % heads;
+  const int64_t row_begin = (blockIdx.x % num_row_blocks) * kAttentionWarpsPerBlock;
+  const int64_t j = row_begin + warp;
+  const bool active = j < S;
+  const accscalar_t neg_inf = -std::numeric_limits<accscalar_t>::infinity();
+  const scalar_t* q_ptr = query + bh * L * E;
+  const scalar_t* grad_o_ptr = grad_out + bh * L * Ev;
+
+  accscalar_t k[kValuesPerLane];
+  accscalar_t v[kValuesPerLane];
+  accscalar_t grad_k[kValuesPerLane];
+  accscalar_t grad_v[kValuesPerLane];
+#pragma unroll
+  for (int t = 0; t < kValuesPerLane; t++) {
+    const int e = lane + t * C10_WARP_SIZE;
+    k[t] = (active && e < E)
+        ? static_cast<accscalar_t>(key[(bh * S + j) * E + e]) : accscalar_t(0);
+    v[t] = (active && e < Ev)
+        ? static_cast<accscalar_t>(value[(bh * S + j) * Ev + e]) : accscalar_t(0);
+    grad_k[t] = 0;
+    grad_v[t] = 0;
+  }
+
+  // with a causal mask, the keys of the block are only attended to by the
+  // queries from their first row on
+  const int64_t query_begin = is_causal ? ::min(L, row_begin) : 0;
+  for (int64_t q_begin = query_begin; q_begin < L; q_begin += BLOCK_N) {
+    const int rows = static_cast<int>(::min(static_cast<int64_t>(BLOCK_N), L - q_begin));
+    __syncthreads();
+    for (int idx = threadIdx.x; idx < rows * E; idx += blockDim.x) {
+      query_tile[idx] = static_cast<accscalar_t>(q_ptr[q_begin * E + idx]);
+    }
+    for (int idx = threadIdx.x; idx < rows * Ev; idx += blockDim.x) {
+      grad_out_tile[idx] = static_cast<accscalar_t>(grad_o_ptr[q_begin * Ev + idx]);
+    }
+    for (int idx = threadIdx.x; idx < rows; idx += blockDim.x) {
+      lse_tile[idx] = logsumexp[bh * L + q_begin + idx];
+      delta_tile[idx] = delta[bh * L + q_begin + idx];
+    }
+    __syncthreads();
+    if (!active) {
+      continue;
+    }
+    for (int r = 0; r < rows; r++) {
+      const int64_t i = q_begin + r;
+      const accscalar_t lse = lse_tile[r];
+      if ((is_causal && j > i) || lse == neg_inf) {
+        continue;
+      }
+      accscalar_t s = 0;
+      accscalar_t grad_p = 0;
+#pragma unroll
+      for (int t = 0; t < kValuesPerLane; t++) {
+        const int e = lane + t * C10_WARP_SIZE;
+        if (e < E) {
+          s += k[t] * query_tile[r * E + e];
+        }
+        if (e < Ev) {
+          grad_p += v[t] * grad_out_tile[r * Ev + e];
+        }
+      }
+      s = warp_allreduce_sum(s) * scale;
+      grad_p = warp_allreduce_sum(grad_p);
+      if (mask != nullptr) {
+        s += mask_value<scalar_t, accscalar_t>(mask, mask_info, b, h, i, j);
+      }
+      const accscalar_t p = ::exp(s - lse);
+      const accscalar_t grad_s = p * (grad_p - delta_tile[r]) * scale;
+#pragma unroll
+      for (int t = 0; t < kValuesPerLane; t++) {
+        const int e = lane + t * C10_WARP_SIZE;
+        if (e < E) {
+          grad_k[t] += grad_s * query_tile[r * E + e];
+        }
+        if (e < Ev) {
+          grad_v[t] += p * grad_out_tile[r * Ev + e];
+        }
+      }
+    }
+  }
+
+  if (active) {
+#pragma unroll
+    for (int t = 0; t < kValuesPerLane; t++) {
+      const int e = lane + t * C10_WARP_SIZE;
+      if (e < E) {
+        grad_key[(bh * S + j) * E + e] = static_cast<scalar_t>(grad_k[t]);
+      }
+      if (e < Ev) {
+        grad_value[(bh * S + j) * Ev + e] = static_cast<scalar_t>(grad_v[t]);
+      }
+    }
+  }
+}
+
+bool can_use_fused_attention(const AttentionInputs& inputs) {
+  const int64_t bh = inputs.batch * inputs.heads;
+  const int64_t blocks = bh *
+      ((std::max(inputs.query_len, inputs.key_len) + kAttentionWarpsPerBlock - 1) /
+       kAttentionWarpsPerBlock);
+  return inputs.head_dim <= kAttentionMaxHeadDim &&
+      inputs.value_dim <= kAttentionMaxHeadDim &&
+      blocks <= std::numeric_limits<int32_t>::max();
+}
+
+MaskInfo make_mask_info(const AttentionInputs& inputs) {
+  MaskInfo info{};
+  if (inputs.mask.defined()) {
+    for (int d = 0; d < 4; d++) {
+      info.strides[d] = inputs.mask.stride(d);
+    }
+  }
+  return info;
+}
+
+int64_t attention_row_blocks(int64_t rows) {
+  return (rows + kAttentionWarpsPerBlock - 1) / kAttentionWarpsPerBlock;
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor> _scaled_dot_product_attention_cuda(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const c10::optional<Tensor>& attn_mask,
+    bool is_causal,
+    c10::optional<double> scale) {
+  AttentionInputs inputs =
+      prepare_attention_inputs(query, key, value, attn_mask, scale);
+  Tensor out, logsumexp;
+  if (!can_use_fused_attention(inputs)) {
+    std::tie(out, logsumexp) = attention_math(inputs, is_causal);
+    return std::make_tuple(
+        attention_output_as(out, query.sizes(), inputs.value_dim),
+        attention_output_as(logsumexp, query.sizes(), -1));
+  }
+  out = at::empty(
+      {inputs.batch, inputs.heads, inputs.query_len, inputs.value_dim},
+      inputs.query.options());
+  logsumexp = at::empty(
+      {inputs.batch, inputs.heads, inputs.query_len},
+      inputs.query.options().dtype(attention_acc_type(query.scalar_type())));
+  if (out.numel() > 0) {
+    const MaskInfo mask_info = make_mask_info(inputs);
+    const int64_t num_row_blocks = attention_row_blocks(inputs.query_len);
+    const dim3 grid(inputs.batch * inputs.heads * num_row_blocks);
+    auto stream = at::cuda::getCurrentCUDAStream();
+    AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, query.scalar_type(), "_scaled_dot_product_attention_cuda", [&] {
+      using accscalar_t = at::acc_type<scalar_t, true>;
+      const size_t smem = attention_tile_rows<accscalar_t>() *
+          (inputs.head_dim + inputs.value_dim) * sizeof(accscalar_t);
+      attention_forward_kernel<scalar_t, accscalar_t>
+          <<<grid, kAttentionThreads, smem, stream>>>(
+              inputs.query.data_ptr<scalar_t>(),
+              inputs.key.data_ptr<scalar_t>(),
+              inputs.value.data_ptr<scalar_t>(),
+              inputs.mask.defined() ? inputs.mask.data_ptr<scalar_t>() : nullptr,
+              mask_info,
+              out.data_ptr<scalar_t>(),
+              logsumexp.data_ptr<accscalar_t>(),
+              inputs.heads, inputs.query_len, inputs.key_len,
+              inputs.head_dim, inputs.value_dim, num_row_blocks,
+              static_cast<accscalar_t>(inputs.scale), is_causal);
+      C10_CUDA_KERNEL_LAUNCH_CHECK();
+    });
+  }
+  return std::make_tuple(
+      attention_output_as(out, query.sizes(), inputs.value_dim),
+      attention_output_as(logsumexp, query.sizes(), -1));
+}
+
+std::tuple<Tensor, Tensor, Tensor> _scaled_dot_product_attention_backward_cuda(
+    const Tensor& grad_out,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& out,
+    const Tensor& logsumexp,
+    const c10::optional<Tensor>& attn_mask,
+    bool is_causal,
+    c10::optional<double> scale) {
+  AttentionInputs inputs =
+      prepare_attention_inputs(query, key, value, attn_mask, scale);
+  auto as_4d = [](const Tensor& t, int64_t dim) {
+    return (t.dim() == dim - 1 ? t.unsqueeze(0) : t).contiguous();
+  };
+  Tensor grad_out_4d = as_4d(grad_out, 4);
+  Tensor out_4d = as_4d(out, 4);
+  Tensor logsumexp_3d = as_4d(logsumexp, 3);
+  Tensor grad_query, grad_key, grad_value;
+  if (!can_use_fused_attention(inputs)) {
+    std::tie(grad_query, grad_key, grad_value) = attention_math_backward(
+        grad_out_4d, inputs, out_4d, logsumexp_3d, is_causal);
+  } else {
+    grad_query = at::zeros_like(inputs.query);
+    grad_key = at::zeros_like(inputs.key);
+    grad_value = at::zeros_like(inputs.value);
+    const auto acc_type = attention_acc_type(query.scalar_type());
+    Tensor delta = (grad_out_4d.to(acc_type) * out_4d.to(acc_type)).sum(-1);
+    const MaskInfo mask_info = make_mask_info(inputs);
+    auto stream = at::cuda::getCurrentCUDAStream();
+    AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, query.scalar_type(), "_scaled_dot_product_attention_backward_cuda", [&] {
+      using accscalar_t = at::acc_type<scalar_t, true>;
+      constexpr int BLOCK_N = attention_tile_rows<accscalar_t>();
+      const scalar_t* mask =
+          inputs.mask.defined() ? inputs.mask.data_ptr<scalar_t>() : nullptr;
+      const int64_t query_blocks = attention_row_blocks(inputs.query_len);
+      const int64_t key_blocks = attention_row_blocks(inputs.key_len);
+      const int64_t bh = inputs.batch * inputs.heads;
+      if (bh * query_blocks > 0 && inputs.key_len > 0) {
+        const size_t smem =
+            BLOCK_N * (inputs.head_dim + inputs.value_dim) * sizeof(accscalar_t);
+        attention_backward_query_kernel<scalar_t, accscalar_t>
+            <<<bh * query_blocks, kAttentionThreads, smem, stream>>>(
+                grad_out_4d.data_ptr<scalar_t>(),
+                inputs.query.data_ptr<scalar_t>(),
+                inputs.key.data_ptr<scalar_t>(),
+                inputs.value.data_ptr<scalar_t>(),
+                mask, mask_info,
+                logsumexp_3d.data_ptr<accscalar_t>(),
+                delta.data_ptr<accscalar_t>(),
+                grad_query.data_ptr<scalar_t>(),
+                inputs.heads, inputs.query_len, inputs.key_len,
+                inputs.head_dim, inputs.value_dim, query_blocks,
+                static_cast<accscalar_t>(inputs.scale), is_causal);
+        C10_CUDA_KERNEL_LAUNCH_CHECK();
+      }
+      if (bh * key_blocks > 0 && inputs.query_len > 0) {
+        const size_t smem = BLOCK_N * (inputs.head_dim + inputs.value_dim + 2) *
+            sizeof(accscalar_t);
+        attention_backward_key_value_kernel<scalar_t, accscalar_t>
+            <<<bh * key_blocks, kAttentionThreads, smem, stream>>>(
+                grad_out_4d.data_ptr<scalar_t>(),
+                inputs.query.data_ptr<scalar_t>(),
+                inputs.key.data_ptr<scalar_t>(),
+                inputs.value.data_ptr<scalar_t>(),
+                mask, mask_info,
+                logsumexp_3d.data_ptr<accscalar_t>(),
+                delta.data_ptr<accscalar_t>(),
+                grad_key.data_ptr<scalar_t>(),
+                grad_value.data_ptr<scalar_t>(),
+                inputs.heads, inputs.query_len, inputs.key_len,
+                inputs.head_dim, inputs.value_dim, key_blocks,
+                static_cast<accscalar_t>(inputs.scale), is_causal);
+        C10_CUDA_KERNEL_LAUNCH_CHECK();
+      }
+    });
+  }
+  return std::make_tuple(
+      grad_query.view(query.sizes()),
+      grad_key.view(key.sizes()),
+      grad_value.view(value.sizes()));
+}
+
+}} // namespace at::native
@@ -11,6 +11,7 @@
 #include <ATen/native/Resize.h>
 #include <ATen/native/BatchLinearAlgebra.h>
 #include <ATen/native/cuda/BatchLinearAlgebraLib.h>
+#include <ATen/native/cuda/BatchLinearAlgebraSmall.h>
 #include <ATen/native/cpu/zmath.h>
 
 #include <THC/THC.h> // for USE_MAGMA
@@ -1271,6 +1272,18 @@ void magmaLuSolveBatched<c10::complex<float>>(
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ solve ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+// Heuristic for the solvers: tiny matrices are handled by the register-resident
+// kernels of BatchLinearAlgebraSmall.cu, batches of mid-sized matrices by cublas
+// getrfBatched + getrsBatched and the rest by MAGMA. Unlike MAGMA, the first two
+// don't synchronize with the host (see use_small_linalg_kernels for the former).
+#ifdef USE_CUSOLVER
+constexpr int64_t kCublasBatchedSolveMaxSize = 128;
+
+static bool use_cublas_batched_solve(const Tensor& A) {
+  return A.dim() > 2 && batchCount(A) > 2 && A.size(-1) <= kCublasBatchedSolveMaxSize;
+}
+#endif
+
 template <typename scalar_t>
 static void apply_solve(Tensor& b, Tensor& A, Tensor& infos) {
 #ifndef USE_MAGMA
@@ -1340,13 +1353,26 @@ AT_ERROR("solve: MAGMA library not found in "
 #endif
 }
 
+// This is a dispatching helper function for the solvers of 'solve' and 'linalg_solve'
+static void solve_dispatch(Tensor& b, Tensor& A, Tensor& infos) {
+  if (use_small_linalg_kernels(A)) {
+    small_solve_batched(b, A, infos);
+#ifdef USE_CUSOLVER
+  } else if (use_cublas_batched_solve(A)) {
+    _solve_batched_cublas(b, A, infos);
+#endif
+  } else {
+    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(b.scalar_type(), "solve_cuda", [&]{
+      apply_solve<scalar_t>(b, A, infos);
+    });
+  }
+}
+
 std::tuple<Tensor, Tensor> _solve_helper_cuda(const Tensor& self, const Tensor& A) {
   auto self_working_copy = cloneBatchedColumnMajor(self);
   auto A_working_copy = cloneBatchedColumnMajor(A);
-  auto infos = at::empty({std::max<int64_t>(1, batchCount(self))}, self.options().dtype(kInt));
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "solve_cuda", [&]{
-    apply_solve<scalar_t>(self_working_copy, A_working_copy, infos);
-  });
+  auto infos = at::zeros({std::max<int64_t>(1, batchCount(self))}, self.options().dtype(kInt));
+  solve_dispatch(self_working_copy, A_working_copy, infos);
   if (self.dim() > 2) {
     batchCheckErrors(infos, "solve_cuda");
   } else {
@@ -1355,15 +1381,13 @@ std::tuple<Tensor, Tensor> _solve_helper_cuda(const Tensor& self, const Tensor&
   return std::tuple<Tensor, Tensor>(self_working_copy, A_working_copy);
 }
 
-// This is a type dispatching helper function for 'apply_solve'
+// This is a dispatching helper function for 'apply_solve' and the batched solvers
 Tensor& _linalg_solve_out_helper_cuda(Tensor& result, Tensor& input, Tensor& infos) {
   // 'result' and 'input' should be in column major order (it should be checked before calling this function)
-  // the content of 'result', 'input' and 'infos' is overwritten by 'apply_solve'
+  // the content of 'result', 'input' and 'infos' is overwritten by the solver
   // 'result' should contain data of 'other' tensor (right-hand-side of the linear system of equations)
   // 'input' should contain data of origianl 'input' tensor (left-hand-side of the linear system)
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(result.scalar_type(), "linalg_solve_out_cpu", [&]{
-    apply_solve<scalar_t>(result, input, infos);
-  });
+  solve_dispatch(result, input, infos);
   return result;
 }
 
@@ -1495,6 +1519,17 @@ Tensor _inverse_helper_cuda_legacy(const Tensor& self) {
 }
 
 Tensor _inverse_helper_cuda(const Tensor& self) {
+  if (use_small_linalg_kernels(self)) {
+    auto self_inv_working_copy = cloneBatchedColumnMajor(self);
+    auto infos = at::zeros({std::max<int64_t>(1, batchCount(self))}, self.options().dtype(kInt));
+    small_inverse_batched(self_inv_working_copy, self_inv_working_copy, infos);
+    if (self.dim() > 2) {
+      batchCheckErrors(infos, "inverse_cuda");
+    } else {
+      singleCheckErrors(infos.item().toInt(), "inverse_cuda");
+    }
+    return self_inv_working_copy;
+  }
 #ifdef USE_CUSOLVER
   if ((self.dim() == 2) || (/* self.dim() > 2 && */ batchCount(self) <= 2) || !use_magma_) {
     return _inverse_helper_cuda_lib(self);    // cusolver or cublas
@@ -1527,6 +1562,11 @@ Tensor& _linalg_inv_out_helper_cuda_legacy(Tensor& result, Tensor& infos_lu, Ten
 Tensor& _linalg_inv_out_helper_cuda(Tensor &result, Tensor& infos_lu, Tensor& infos_getri) {
   // This function calculates the inverse matrix in-place
   // result should be in column major order and contain matrices to invert
+  if (use_small_linalg_kernels(result)) {
+    // there is no getri step, 'infos_getri' stays zero
+    small_inverse_batched(result, result, infos_lu);
+    return result;
+  }
 #ifdef USE_CUSOLVER
   if ((result.dim() == 2) || (/* result.dim() > 2 && */ batchCount(result) <= 2) || !use_magma_) {
     return _linalg_inv_out_helper_cuda_lib(result, infos_lu, infos_getri);  // cusolver or cublas
@@ -1614,6 +1654,10 @@ Tensor _cholesky_solve_helper_cuda(const Tensor& self, const Tensor& A, bool upp
   int64_t info = 0;
   auto self_working_copy = cloneBatchedColumnMajor(self);
   auto A_working_copy = cloneBatchedColumnMajor(A);
+  if (use_small_linalg_kernels(A)) {
+    small_cholesky_solve_batched(self_working_copy, A_working_copy, upper);
+    return self_working_copy;
+  }
   AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "cholesky_solve_cuda", [&]{
     apply_cholesky_solve<scalar_t>(self_working_copy, A_working_copy, upper, info);
   });
@@ -2493,6 +2537,16 @@ Tensor _lu_solve_helper_cuda(const Tensor& self, const Tensor& LU_data, const Te
   if (self.numel() == 0 || LU_data.numel() == 0) {
     return at::zeros_like(self, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   }
+  if (use_small_linalg_kernels(LU_data)) {
+    small_lu_solve_batched(self_working_copy, LU_data_working_copy, LU_pivots_working_copy);
+    return self_working_copy;
+  }
+#ifdef USE_CUSOLVER
+  if (use_cublas_batched_solve(LU_data)) {
+    _lu_solve_batched_cublas(self_working_copy, LU_data_working_copy, LU_pivots_working_copy);
+    return self_working_copy;
+  }
+#endif
   AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "lu_solve_cuda", [&]{
     apply_lu_solve<scalar_t>(self_working_copy, LU_data_working_copy, LU_pivots_working_copy, info);
   });
@@ -150,6 +150,67 @@ Tensor _inverse_helper_cuda_lib(const Tensor& self) {
   return self_inv_working_copy;
 }
 
+// cublas batched kernels require input be "device array of device pointers"
+template <typename scalar_t>
+static Tensor get_device_pointers(const Tensor& self) {
+  auto self_data = self.data_ptr<scalar_t>();
+  auto self_mat_stride = matrixStride(self);
+  const int64_t batch_size = batchCount(self);
+  return at::arange(
+    reinterpret_cast<int64_t>(self_data),
+    reinterpret_cast<int64_t>(&self_data[(batch_size-1) * self_mat_stride]) + 1,
+    static_cast<int64_t>(self_mat_stride * sizeof(scalar_t)), self.options().dtype(at::kLong));
+}
+
+template <typename scalar_t>
+static void apply_lu_solve_batched_cublas(Tensor& b, const Tensor& lu, int* ipiv_data) {
+  const int batch_size = cuda_int_cast(batchCount(b), "batchCount");
+  const int n = cuda_int_cast(lu.size(-2), "lu.size(-2)");
+  const int nrhs = cuda_int_cast(b.size(-1), "b.size(-1)");
+  const int lda = std::max<int>(1, n);
+
+  Tensor lu_array = get_device_pointers<scalar_t>(lu);
+  Tensor b_array = get_device_pointers<scalar_t>(b);
+
+  // getrsBatched checks its arguments on the host, it doesn't look at the factorization
+  int info = 0;
+  at::cuda::blas::getrsBatched<scalar_t>(n, nrhs, reinterpret_cast<scalar_t**>(lu_array.data_ptr()), lda,
+    ipiv_data, reinterpret_cast<scalar_t**>(b_array.data_ptr()), lda, &info, batch_size);
+  TORCH_INTERNAL_ASSERT(info == 0, "cublas getrsBatched : invalid argument: ", -info);
+}
+
+// entrance of calculations of `solve` using cublas getrfBatched + getrsBatched
+void _solve_batched_cublas(Tensor& b, Tensor& A, Tensor& infos) {
+  const int batch_size = cuda_int_cast(batchCount(A), "batchCount");
+  const int n = cuda_int_cast(A.size(-2), "A.size(-2)");
+  const int lda = std::max<int>(1, n);
+  if (batch_size == 0 || n == 0) {
+    return;
+  }
+
+  auto& allocator = *::c10::cuda::CUDACachingAllocator::get();
+  auto dataPtr = allocator.allocate(sizeof(int)*batch_size*lda);
+  int* ipiv_array = reinterpret_cast<int*>(dataPtr.get());
+
+  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(A.scalar_type(), "solve_cuda", [&]{
+    Tensor A_array = get_device_pointers<scalar_t>(A);
+    at::cuda::blas::getrfBatched<scalar_t>(n, reinterpret_cast<scalar_t**>(A_array.data_ptr()), lda,
+      ipiv_array, infos.data_ptr<int>(), batch_size);
+    apply_lu_solve_batched_cublas<scalar_t>(b, A, ipiv_array);
+  });
+}
+
+// entrance of calculations of `lu_solve` using cublas getrsBatched
+void _lu_solve_batched_cublas(Tensor& b, const Tensor& lu, const Tensor& pivots) {
+  if (batchCount(b) == 0 || lu.size(-2) == 0) {
+    return;
+  }
+  TORCH_INTERNAL_ASSERT(pivots.scalar_type() == kInt && pivots.is_contiguous());
+  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(b.scalar_type(), "lu_solve_cuda", [&]{
+    apply_lu_solve_batched_cublas<scalar_t>(b, lu, pivots.data_ptr<int>());
+  });
+}
+
 // call cusolver gesvdj function to calculate svd
 template<typename scalar_t>
 inline static void _apply_svd_lib_gesvdj(const Tensor& self, Tensor& U, Tensor& S, Tensor& VT, Tensor& infos, bool compute_uv, bool some) {
@@ -21,6 +21,11 @@ namespace native {
 Tensor _inverse_helper_cuda_lib(const Tensor& self);
 Tensor& _linalg_inv_out_helper_cuda_lib(Tensor& result, Tensor& infos_getrf, Tensor& infos_getrs);
 
+// entrance of calculations of `solve` and `lu_solve` for batches of matrices using cublas getrfBatched + getrsBatched
+// 'A' is overwritten with its LU factorization and 'b' with the solution, the getrf error codes are saved in 'infos'
+void _solve_batched_cublas(Tensor& b, Tensor& A, Tensor& infos);
+void _lu_solve_batched_cublas(Tensor& b, const Tensor& lu, const Tensor& pivots);
+
 // entrance of calculations of `svd` using cusolver gesvdj and gesvdjBatched
 std::tuple<Tensor, Tensor, Tensor> _svd_helper_cuda_lib(const Tensor& self, bool some, bool compute_uv);
 
@@ -0,0 +1,377 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cuda/CUDAApplyUtils.cuh>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/DeviceUtils.cuh>
+
+#include <ATen/native/LinearAlgebraUtils.h>
+#include <ATen/native/cuda/MiscUtils.h>
+#include <ATen/native/cuda/BatchLinearAlgebraSmall.h>
+
+#include <type_traits>
+
+namespace at {
+namespace native {
+
+namespace {
+
+constexpr int kSmallLinalgBlockSize = 128;
+
+// Calls 'launch' with the width W of the segments of threads handling the
+// matrices of size n: the smallest power of 2 >= n, from 4 to 32. The kernels
+// keep W values per thread in registers, with the loops over them unrolled.
+template <typename F>
+void dispatch_segment_width(int n, const F& launch) {
+  if (n <= 4) {
+    launch(std::integral_constant<int, 4>());
+  } else if (n <= 8) {
+    launch(std::integral_constant<int, 8>());
+  } else if (n <= 16) {
+    launch(std::integral_constant<int, 16>());
+  } else {
+    TORCH_INTERNAL_ASSERT(n <= kSmallLinalgMaxSize);
+    launch(std::integral_constant<int, 32>());
+  }
+}
+
+inline dim3 small_linalg_grid(int64_t batch_size, int width) {
+  return dim3(cuda::ATenCeilDiv(batch_size * width, static_cast<int64_t>(kSmallLinalgBlockSize)));
+}
+
+// In all the kernels, thread r of a segment handles the row r of a matrix.
+// The threads past the end of the matrix or of the batch still take part in
+// the shuffles, which need all the threads of the warp, but they don't access
+// memory. The loops over the rows are guarded with the size n, which is the
+// same for the whole warp.
+
+// Solves L U x = y, with the packed LU factorization held in registers: 'a'
+// is the row r of L (below the diagonal, unit diagonal) and of U, and 'x' is
+// y[r] on entry.
+template <typename scalar_t, int W>
+__device__ __forceinline__ scalar_t lu_substitute(const scalar_t (&a)[W], scalar_t x, int r, int n) {
+  #pragma unroll
+  for (int k = 0; k < W; k++) {
+    if (k < n) {
+      const scalar_t xk = WARP_SHFL(x, k, W);
+      if (r > k) {
+        x -= a[k] * xk;
+      }
+    }
+  }
+  #pragma unroll
+  for (int k = W - 1; k >= 0; k--) {
+    if (k < n) {
+      if (r == k) {
+        x /= a[k];
+      }
+      const scalar_t xk = WARP_SHFL(x, k, W);
+      if (r < k) {
+        x -= a[k] * xk;
+      }
+    }
+  }
+  return x;
+}
+
+// getrf + getrs for each matrix of the batch. 'perm' tracks the row of A held
+// by each thread, so the right hand side is read in the pivoted order directly
+// instead of swapping it. With 'identity_rhs' the right hand side is the
+// identity matrix and 'b' isn't read, which computes the inverse.
+template <typename scalar_t, int W>
+C10_LAUNCH_BOUNDS_1(kSmallLinalgBlockSize)
+__global__ void small_lu_solve_kernel(
+    scalar_t* A, int64_t A_stride, bool store_lu,
+    const scalar_t* b, int64_t b_stride, bool identity_rhs,
+    scalar_t* x, int64_t x_stride,
+    int* infos, int n, int nrhs, int64_t batch_size) {
+  const int64_t matrix = (static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x) / W;
+  const int r = threadIdx.x % W;
+  const bool in_batch = matrix < batch_size;
+  const bool valid = in_batch && r < n;
+  const int64_t m = in_batch ? matrix : 0;
+  scalar_t* A_mat = A + m * A_stride;
+
+  scalar_t a[W];
+  #pragma unroll
+  for (int j = 0; j < W; j++) {
+    a[j] = (valid && j < n) ? A_mat[r + j * n] : scalar_t(0);
+  }
+
+  int perm = r;
+  int info = 0;
+  #pragma unroll
+  for (int k = 0; k < W; k++) {
+    if (k < n) {
+      // Partial pivoting: the first row >= k with the largest magnitude in column k
+      scalar_t best = (r >= k && r < n) ? ::abs(a[k]) : scalar_t(-1);
+      int p = r;
+      #pragma unroll
+      for (int offset = W / 2; offset > 0; offset /= 2) {
+        const scalar_t other_best = WARP_SHFL_XOR(best, offset, W);
+        const int other_p = WARP_SHFL_XOR(p, offset, W);
+        if (other_best > best || (other_best == best && other_p < p)) {
+          best = other_best;
+          p = other_p;
+        }
+      }
+
+      // Swap the rows k and p, including their part of L
+      const int src = r == k ? p : (r == p ? k : r);
+      #pragma unroll
+      for (int j = 0; j < W; j++) {
+        if (j < n) {
+          a[j] = WARP_SHFL(a[j], src, W);
+        }
+      }
+      perm = WARP_SHFL(perm, src, W);
+
+      // A zero pivot means that the column below the diagonal is zero too,
+      // so there is nothing to eliminate
+      const scalar_t pivot = WARP_SHFL(a[k], k, W);
+      if (pivot == scalar_t(0) && info == 0) {
+        info = k + 1;
+      }
+      scalar_t l = scalar_t(0);
+      if (r > k && pivot != scalar_t(0)) {
+        l = a[k] / pivot;
+        a[k] = l;
+      }
+      #pragma unroll
+      for (int j = k + 1; j < W; j++) {
+        if (j < n) {
+          const scalar_t u = WARP_SHFL(a[j], k, W);
+          if (r > k) {
+            a[j] -= l * u;
+          }
+        }
+      }
+    }
+  }
+
+  if (in_batch && r == 0) {
+    infos[matrix] = info;
+  }
+  if (store_lu && valid) {
+    #pragma unroll
+    for (int j = 0; j < W; j++) {
+      if (j < n) {
+        A_mat[r + j * n] = a[j];
+      }
+    }
+  }
+
+  const scalar_t* b_mat = b + (identity_rhs ? 0 : m * b_stride);
+  scalar_t* x_mat = x + m * x_stride;
+  for (int c = 0; c < nrhs; c++) {
+    scalar_t xr;
+    if (identity_rhs) {
+      xr = perm == c ? scalar_t(1) : scalar_t(0);
+    } else {
+      xr = valid ? b_mat[perm + c * n] : scalar_t(0);
+    }
+    xr = lu_substitute<scalar_t, W>(a, xr, r, n);
+    // 'x' may be 'b': all the threads of the matrix must have read the
+    // column before it is written
+#ifndef __HIP_PLATFORM_HCC__
+    __syncwarp();
+#endif
+    if (valid) {
+      x_mat[r + c * n] = xr;
+    }
+  }
+}
+
+// getrs for each matrix of the batch, with the pivots of getrf (1-based). The
+// pivots are out of our control, they are clamped to the matrix so that the
+// reads stay in bounds.
+template <typename scalar_t, int W>
+C10_LAUNCH_BOUNDS_1(kSmallLinalgBlockSize)
+__global__ void small_lu_solve_pivots_kernel(
+    const scalar_t* lu, int64_t lu_stride,
+    const int* pivots, int64_t pivots_stride,
+    scalar_t* b, int64_t b_stride,
+    int n, int nrhs, int64_t batch_size) {
+  const int64_t matrix = (static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x) / W;
+  const int r = threadIdx.x % W;
+  const bool in_batch = matrix < batch_size;
+  const bool valid = in_batch && r < n;
+  const int64_t m = in_batch ? matrix : 0;
+  const scalar_t* lu_mat = lu + m * lu_stride;
+  const int* pivots_mat = pivots + m * pivots_stride;
+  scalar_t* b_mat = b + m * b_stride;
+
+  scalar_t a[W];
+  #pragma unroll
+  for (int j = 0; j < W; j++) {
+    a[j] = (valid && j < n) ? lu_mat[r + j * n] : scalar_t(0);
+  }
+
+  int perm = r;
+  for (int k = 0; k < n; k++) {
+    const int p = in_batch ? ::min(::max(pivots_mat[k] - 1, 0), n - 1) : k;
+    const int src = r == k ? p : (r == p ? k : r);
+    perm = WARP_SHFL(perm, src, W);
+  }
+
+  for (int c = 0; c < nrhs; c++) {
+    scalar_t xr = valid ? b_mat[perm + c * n] : scalar_t(0);
+    xr = lu_substitute<scalar_t, W>(a, xr, r, n);
+#ifndef __HIP_PLATFORM_HCC__
+    __syncwarp();
+#endif
+    if (valid) {
+      b_mat[r + c * n] = xr;
+    }
+  }
+}
+
+// potrs for each matrix of the batch. Each thread holds the row r of the
+// lower triangular factor (L, or U^T) in 'f' for the forward substitution, and
+// the row r of the upper triangular one (L^T, or U) in 'g' for the backward
+// substitution.
+template <typename scalar_t, int W>
+C10_LAUNCH_BOUNDS_1(kSmallLinalgBlockSize)
+__global__ void small_cholesky_solve_kernel(
+    const scalar_t* A, int64_t A_stride, bool upper,
+    scalar_t* b, int64_t b_stride,
+    int n, int nrhs, int64_t batch_size) {
+  const int64_t matrix = (static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x) / W;
+  const int r = threadIdx.x % W;
+  const bool in_batch = matrix < batch_size;
+  const bool valid = in_batch && r < n;
+  const int64_t m = in_batch ? matrix : 0;
+  const scalar_t* A_mat = A + m * A_stride;
+  scalar_t* b_mat = b + m * b_stride;
+
+  scalar_t f[W];
+  scalar_t g[W];
+  #pragma unroll
+  for (int j = 0; j < W; j++) {
+    f[j] = (valid && j <= r) ? (upper ? A_mat[j + r * n] : A_mat[r + j * n]) : scalar_t(0);
+    g[j] = (valid && j >= r && j < n) ? (upper ? A_mat[r + j * n] : A_mat[j + r * n]) : scalar_t(0);
+  }
+
+  for (int c = 0; c < nrhs; c++) {
+    scalar_t xr = valid ? b_mat[r + c * n] : scalar_t(0);
+    #pragma unroll
+    for (int k = 0; k < W; k++) {
+      if (k < n) {
+        if (r == k) {
+          xr /= f[k];
+        }
+        const scalar_t xk = WARP_SHFL(xr, k, W);
+        if (r > k) {
+          xr -= f[k] * xk;
+        }
+      }
+    }
+    #pragma unroll
+    for (int k = W - 1; k >= 0; k--) {
+      if (k < n) {
+        if (r == k) {
+          xr /= g[k];
+        }
+        const scalar_t xk = WARP_SHFL(xr, k, W);
+        if (r < k) {
+          xr -= g[k] * xk;
+        }
+      }
+    }
+    // Every thread reads and writes its own elements of 'b' only
+    if (valid) {
+      b_mat[r + c * n] = xr;
+    }
+  }
+}
+
+} // namespace
+
+bool use_small_linalg_kernels(const Tensor& A) {
+  return A.is_cuda() && (A.scalar_type() == kFloat || A.scalar_type() == kDouble) &&
+      A.size(-1) <= kSmallLinalgMaxSize;
+}
+
+void small_solve_batched(Tensor& b, Tensor& A, Tensor& infos) {
+  const int64_t batch_size = batchCount(A);
+  const int n = cuda_int_cast(A.size(-2), "A.size(-2)");
+  const int nrhs = cuda_int_cast(b.size(-1), "b.size(-1)");
+  if (batch_size == 0 || n == 0) {
+    return;
+  }
+  auto stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES(A.scalar_type(), "small_solve_batched_cuda", [&] {
+    dispatch_segment_width(n, [&](auto width) {
+      constexpr int W = decltype(width)::value;
+      small_lu_solve_kernel<scalar_t, W><<<small_linalg_grid(batch_size, W), kSmallLinalgBlockSize, 0, stream>>>(
+          A.data_ptr<scalar_t>(), matrixStride(A), /*store_lu=*/true,
+          b.data_ptr<scalar_t>(), matrixStride(b), /*identity_rhs=*/false,
+          b.data_ptr<scalar_t>(), matrixStride(b),
+          infos.data_ptr<int>(), n, nrhs, batch_size);
+      C10_CUDA_KERNEL_LAUNCH_CHECK();
+    });
+  });
+}
+
+void small_inverse_batched(const Tensor& A, Tensor& A_inv, Tensor& infos) {
+  const int64_t batch_size = batchCount(A);
+  const int n = cuda_int_cast(A.size(-2), "A.size(-2)");
+  if (batch_size == 0 || n == 0) {
+    return;
+  }
+  auto stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES(A.scalar_type(), "small_inverse_batched_cuda", [&] {
+    dispatch_segment_width(n, [&](auto width) {
+      constexpr int W = decltype(width)::value;
+      small_lu_solve_kernel<scalar_t, W><<<small_linalg_grid(batch_size, W), kSmallLinalgBlockSize, 0, stream>>>(
+          A.data_ptr<scalar_t>(), matrixStride(A), /*store_lu=*/false,
+          nullptr, 0, /*identity_rhs=*/true,
+          A_inv.data_ptr<scalar_t>(), matrixStride(A_inv),
+          infos.data_ptr<int>(), n, n, batch_size);
+      C10_CUDA_KERNEL_LAUNCH_CHECK();
+    });
+  });
+}
+
+void small_lu_solve_batched(Tensor& b, const Tensor& lu, const Tensor& pivots) {
+  const int64_t batch_size = batchCount(b);
+  const int n = cuda_int_cast(lu.size(-2), "lu.size(-2)");
+  const int nrhs = cuda_int_cast(b.size(-1), "b.size(-1)");
+  if (batch_size == 0 || n == 0) {
+    return;
+  }
+  TORCH_INTERNAL_ASSERT(pivots.scalar_type() == kInt && pivots.is_contiguous());
+  auto stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES(b.scalar_type(), "small_lu_solve_batched_cuda", [&] {
+    dispatch_segment_width(n, [&](auto width) {
+      constexpr int W = decltype(width)::value;
+      small_lu_solve_pivots_kernel<scalar_t, W><<<small_linalg_grid(batch_size, W), kSmallLinalgBlockSize, 0, stream>>>(
+          lu.data_ptr<scalar_t>(), matrixStride(lu),
+          pivots.data_ptr<int>(), pivots.size(-1),
+          b.data_ptr<scalar_t>(), matrixStride(b),
+          n, nrhs, batch_size);
+      C10_CUDA_KERNEL_LAUNCH_CHECK();
+    });
+  });
+}
+
+void small_cholesky_solve_batched(Tensor& b, const Tensor& A, bool upper) {
+  const int64_t batch_size = batchCount(b);
+  const int n = cuda_int_cast(A.size(-2), "A.size(-2)");
+  const int nrhs = cuda_int_cast(b.size(-1), "b.size(-1)");
+  if (batch_size == 0 || n == 0) {
+    return;
+  }
+  auto stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES(b.scalar_type(), "small_cholesky_solve_batched_cuda", [&] {
+    dispatch_segment_width(n, [&](auto width) {
+      constexpr int W = decltype(width)::value;
+      small_cholesky_solve_kernel<scalar_t, W><<<small_linalg_grid(batch_size, W), kSmallLinalgBlockSize, 0, stream>>>(
+          A.data_ptr<scalar_t>(), matrixStride(A), upper,
+          b.data_ptr<scalar_t>(), matrixStride(b),
+          n, nrhs, batch_size);
+      C10_CUDA_KERNEL_LAUNCH_CHECK();
+    });
+  });
+}
+
+}}  // namespace at::native
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at {
+namespace native {
+
+// Register-resident kernels for batches of tiny matrices. Each matrix is
+// handled by a segment of a warp with one thread per row (4, 8, 16 or 32
+// threads), the rows are kept in registers and the pivot search, the row
+// swaps and the substitutions are done with warp shuffles. Besides avoiding
+// the MAGMA launches for each 65535 matrices, they don't allocate pointer
+// arrays and don't synchronize with the host: the error codes are written to
+// the device 'infos' tensor as they are.
+//
+// All the tensors are batched column major (see cloneBatchedColumnMajor).
+
+// The largest matrices handled by the register-resident kernels
+constexpr int64_t kSmallLinalgMaxSize = 32;
+
+// Whether the register-resident kernels can handle the (batched) square
+// matrices 'A'. Only float and double are supported.
+bool use_small_linalg_kernels(const Tensor& A);
+
+// Solves A X = b with partial pivoting, in-place: 'A' is overwritten with its
+// LU factorization (as with getrf) and 'b' with the solution. 'infos' gets the
+// getrf error code of each matrix.
+void small_solve_batched(Tensor& b, Tensor& A, Tensor& infos);
+
+// Computes the inverse of 'A' in 'A_inv', which may be 'A' itself. 'infos'
+// gets the getrf error code of each matrix.
+void small_inverse_batched(const Tensor& A, Tensor& A_inv, Tensor& infos);
+
+// Solves A X = b in-place in 'b', given the LU factorization and the (1-based)
+// pivots of A, as returned by torch.lu.
+void small_lu_solve_batched(Tensor& b, const Tensor& lu, const Tensor& pivots);
+
+// Solves A X = b in-place in 'b', given the Cholesky factor of A
+void small_cholesky_solve_batched(Tensor& b, const Tensor& A, bool upper);
+
+}}  // namespace at::native
@@ -66,6 +66,36 @@ __global__ void searchsorted_cuda_kernel(
   }
 }
 
+// 1-d boundaries which fit in shared memory are searched by every block from
+// its own copy, so that the log2(idim_bd) dependent loads of every search hit
+// shared memory instead of global memory. Each block then searches many
+// elements, to amortize the copy.
+template<typename input_t, typename output_t>
+__global__ void searchsorted_shared_cuda_kernel(
+  output_t *data_out,
+  const input_t *data_in,
+  const input_t *data_bd,
+  int64_t idim_bd,
+  int64_t numel_in,
+  bool right) {
+
+  extern __shared__ __align__(sizeof(double)) unsigned char smem[];
+  input_t *shared_bd = reinterpret_cast<input_t*>(smem);
+  for (int64_t i = threadIdx.x; i < idim_bd; i += blockDim.x) {
+    shared_bd[i] = data_bd[i];
+  }
+  __syncthreads();
+
+  for (int64_t tid = blockIdx.x * blockDim.x + threadIdx.x; tid < numel_in; tid += blockDim.x * gridDim.x) {
+    int64_t pos = !right ?
+      lower_bound<input_t>(shared_bd, 0, idim_bd, data_in[tid]) :
+      upper_bound<input_t>(shared_bd, 0, idim_bd, data_in[tid]);
+
+    // type conversion might happen here
+    data_out[tid] = pos;
+  }
+}
+
 template<typename input_t, typename output_t>
 void searchsorted_cuda_contiguous(Tensor& result, const Tensor& input, const Tensor& boundaries, const bool& right) {
   int64_t numel_in = input.numel();
@@ -78,12 +108,27 @@ void searchsorted_cuda_contiguous(Tensor& result, const Tensor& input, const Ten
   const input_t *data_bd = boundaries.data_ptr<input_t>();
   output_t *data_out = result.data_ptr<output_t>();
 
-  int64_t maxThread = at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock;
+  const cudaDeviceProp* prop = at::cuda::getCurrentDeviceProperties();
+  int64_t maxThread = prop->maxThreadsPerBlock;
   int64_t maxGrid = 1024;
   dim3 block = dim3(std::min(maxThread, numel_in));
-  dim3 grid  = dim3(std::min(maxGrid, cuda::ATenCeilDiv<int64_t>(numel_in, block.x)));
   at::cuda::CUDAStream stream = at::cuda::getCurrentCUDAStream();
 
+  // Shared memory above 48KB needs an opt-in per kernel
+  const size_t maxSharedMem = std::min<size_t>(prop->sharedMemPerBlock, 48 * 1024);
+  const size_t sharedMem = idim_bd * sizeof(input_t);
+  if (boundaries.dim() == 1 && sharedMem <= maxSharedMem && numel_in >= 2 * idim_bd) {
+    // Few enough blocks for each of them to search many elements
+    int64_t sharedMaxGrid = prop->multiProcessorCount * 2;
+    dim3 grid = dim3(std::min(sharedMaxGrid, cuda::ATenCeilDiv<int64_t>(numel_in, block.x)));
+    searchsorted_shared_cuda_kernel<<<grid, block, sharedMem, stream>>>(
+      data_out, data_in, data_bd, idim_bd, numel_in, right);
+    C10_CUDA_KERNEL_LAUNCH_CHECK();
+    return;
+  }
+
+  dim3 grid  = dim3(std::min(maxGrid, cuda::ATenCeilDiv<int64_t>(numel_in, block.x)));
+
   searchsorted_cuda_kernel<<<grid, block, 0, stream>>>(
     data_out, data_in, data_bd, idim_in, idim_bd, numel_in, right, boundaries.dim() == 1);
   C10_CUDA_KERNEL_LAUNCH_CHECK();
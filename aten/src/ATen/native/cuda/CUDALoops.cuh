@@ -34,12 +34,14 @@
 #include <ATen/ATen.h>
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/core/Array.h>
+#include <ATen/core/Vitals.h>
 #include <ATen/detail/FunctionTraits.h>
 #include <ATen/native/TensorIterator.h>
 #include <c10/macros/Macros.h>
 #include <c10/core/ScalarType.h>
 #include <c10/util/TypeCast.h>
 #include <c10/util/C++17.h>
+#include <c10/util/OverheadProbe.h>
 
 // Marks a lambda as executable on both the host and device. The __host__
 // attribute is important so that we can access static type information from
@@ -84,6 +86,7 @@ C10_LAUNCH_BOUNDS_1(num_threads)
 __global__ void unrolled_elementwise_kernel(int N, func_t f, array_t data,
                                             inp_calc_t ic, out_calc_t oc, loader_t l, storer_t s)
 {
+  C10_OVERHEAD_PROBE(KERNEL_LAUNCH);
   int remaining = N - block_work_size * blockIdx.x;
   auto policy = memory::policies::unroll<array_t, inp_calc_t, out_calc_t, loader_t, storer_t>(data, remaining, ic, oc, l, s);
   elementwise_kernel_helper(f, policy);
@@ -92,6 +95,7 @@ __global__ void unrolled_elementwise_kernel(int N, func_t f, array_t data,
 // this function assume trivial 1d and no dynamic casting
 template<typename func_t, typename array_t>
 static inline void launch_vectorized_kernel(int64_t N, const func_t& f, array_t data) {
+  C10_OVERHEAD_PROBE(KERNEL_LAUNCH);
   TORCH_INTERNAL_ASSERT(N > 0 && N <= std::numeric_limits<int32_t>::max());
   using traits = function_traits<func_t>;
   int64_t grid = (N + block_work_size - 1) / block_work_size;
@@ -132,6 +136,140 @@ static inline void launch_unrolled_kernel(int64_t N, const func_t& f, array_t da
   C10_CUDA_KERNEL_LAUNCH_CHECK();
 }
 
+template<int vec_size, typename func_t, typename array_t, typename outer_calc_t>
+C10_LAUNCH_BOUNDS_1(num_threads)
+__global__ void inner_vectorized_elementwise_kernel(int num_vecs, func_t f, array_t data,
+                                                    IntDivider<uint32_t> row_divider,
+                                                    outer_calc_t outer_calc, uint32_t broadcast_mask) {
+  auto policy = memory::policies::inner_vectorized<vec_size, array_t, outer_calc_t>(
+    data, num_vecs, row_divider, outer_calc, broadcast_mask);
+  elementwise_kernel_helper(f, policy);
+}
+
+template<typename func_t, typename array_t, typename outer_calc_t, typename stride_t>
+C10_LAUNCH_BOUNDS_1(num_threads)
+__global__ void transposed_tile_elementwise_kernel(int size0, int size1, func_t f, array_t data,
+                                                   stride_t strides0, stride_t strides1,
+                                                   outer_calc_t outer_calc, uint32_t transposed_mask) {
+  constexpr int ntensors = function_traits<func_t>::arity + 1;
+  auto policy = memory::policies::transposed_tile<array_t, outer_calc_t, ntensors>(
+    data, size0, size1, strides0, strides1, outer_calc, transposed_mask);
+  elementwise_kernel_helper(f, policy);
+}
+
+// The offsets of the dimensions from first_dim on, in elements
+template <int ntensors>
+static OffsetCalculator<ntensors> make_outer_offset_calculator(const TensorIteratorBase& iter, int first_dim) {
+  std::array<const int64_t*, ntensors> strides;
+  int64_t element_sizes[ntensors];
+  for (int i = 0; i < ntensors; i++) {
+    strides[i] = iter.strides(i).data() + first_dim;
+    element_sizes[i] = iter.element_size(i);
+  }
+  return OffsetCalculator<ntensors>(iter.ndim() - first_dim, iter.shape().data() + first_dim, strides.data(), element_sizes);
+}
+
+// Non-contiguous iterators whose innermost dimension is contiguous for every
+// tensor, or broadcast for some inputs (e.g. the addition of a bias, also in
+// channels last), still get vectorized loads and stores along it. Returns
+// false if the iterator doesn't qualify.
+template<typename func_t, typename array_t>
+static inline bool launch_inner_vectorized_kernel(const TensorIteratorBase& iter, const func_t& f, array_t data) {
+  using traits = function_traits<func_t>;
+  constexpr int ntensors = traits::arity + 1;
+  if (iter.ndim() < 2) {
+    return false;
+  }
+  int vec_size = 4;
+  uint32_t broadcast_mask = 0;
+  for (int i = 0; i < ntensors; i++) {
+    const auto strides = iter.strides(i);
+    const int64_t element_size = iter.element_size(i);
+    if (i > 0 && strides[0] == 0) {
+      broadcast_mask |= 1u << (i - 1);
+      continue;
+    }
+    if (strides[0] != element_size) {
+      return false;
+    }
+    const uint64_t address = reinterpret_cast<uint64_t>(data[i]);
+    while (vec_size > 1 && address % (element_size * vec_size) != 0) {
+      vec_size /= 2;
+    }
+    for (int dim = 1; dim < iter.ndim(); dim++) {
+      while (vec_size > 1 && (strides[dim] / element_size) % vec_size != 0) {
+        vec_size /= 2;
+      }
+    }
+  }
+  const int64_t size0 = iter.shape()[0];
+  while (vec_size > 1 && size0 % vec_size != 0) {
+    vec_size /= 2;
+  }
+  if (vec_size == 1) {
+    return false;
+  }
+
+  const int64_t num_vecs = iter.numel() / vec_size;
+  const int64_t block_vecs = num_threads * (thread_work_size / vec_size);
+  const int64_t grid = (num_vecs + block_vecs - 1) / block_vecs;
+  const auto outer_calc = make_outer_offset_calculator<ntensors>(iter, 1);
+  const IntDivider<uint32_t> row_divider(size0 / vec_size);
+  C10_OVERHEAD_PROBE(KERNEL_LAUNCH);
+  auto stream = at::cuda::getCurrentCUDAStream();
+  if (vec_size == 4) {
+    inner_vectorized_elementwise_kernel<4><<<grid, num_threads, 0, stream>>>(
+      num_vecs, f, data, row_divider, outer_calc, broadcast_mask);
+  } else {
+    inner_vectorized_elementwise_kernel<2><<<grid, num_threads, 0, stream>>>(
+      num_vecs, f, data, row_divider, outer_calc, broadcast_mask);
+  }
+  C10_CUDA_KERNEL_LAUNCH_CHECK();
+  return true;
+}
+
+// Iterators that read some inputs transposed with respect to the output in
+// the two innermost dimensions (e.g. the conversion between contiguous and
+// channels last) go through shared memory tiles, so that neither their loads
+// nor the stores are strided. Returns false if the iterator doesn't qualify.
+template<typename func_t, typename array_t>
+static inline bool launch_transposed_tile_kernel(const TensorIteratorBase& iter, const func_t& f, array_t data) {
+  using traits = function_traits<func_t>;
+  constexpr int ntensors = traits::arity + 1;
+  using policy_t = memory::policies::transposed_tile<array_t, OffsetCalculator<ntensors>, ntensors>;
+  if (iter.ndim() < 2 || iter.strides(0)[0] != iter.element_size(0) ||
+      iter.shape()[0] < policy_t::tile_dim / 2 || iter.shape()[1] < policy_t::tile_rows / 2) {
+    return false;
+  }
+  uint32_t transposed_mask = 0;
+  typename policy_t::stride_t strides0, strides1;
+  for (int i = 0; i < ntensors; i++) {
+    const auto strides = iter.strides(i);
+    const int64_t element_size = iter.element_size(i);
+    if (i > 0 && strides[1] == element_size && strides[0] != element_size && strides[0] != 0) {
+      transposed_mask |= 1u << (i - 1);
+    }
+    strides0[i] = strides[0] / element_size;
+    strides1[i] = strides[1] / element_size;
+  }
+  if (transposed_mask == 0) {
+    return false;
+  }
+
+  const int64_t size0 = iter.shape()[0];
+  const int64_t size1 = iter.shape()[1];
+  const int64_t tiles = ((size0 + policy_t::tile_dim - 1) / policy_t::tile_dim) *
+      ((size1 + policy_t::tile_rows - 1) / policy_t::tile_rows);
+  const int64_t grid = tiles * (iter.numel() / (size0 * size1));
+  const auto outer_calc = make_outer_offset_calculator<ntensors>(iter, 2);
+  C10_OVERHEAD_PROBE(KERNEL_LAUNCH);
+  auto stream = at::cuda::getCurrentCUDAStream();
+  transposed_tile_elementwise_kernel<<<grid, num_threads, 0, stream>>>(
+    size0, size1, f, data, strides0, strides1, outer_calc, transposed_mask);
+  C10_CUDA_KERNEL_LAUNCH_CHECK();
+  return true;
+}
+
 template <typename func_t>
 void gpu_kernel_impl(TensorIteratorBase& iter, const func_t& f) {
   using traits = function_traits<func_t>;
@@ -151,11 +289,15 @@ void gpu_kernel_impl(TensorIteratorBase& iter, const func_t& f) {
 
   bool contiguous = iter.is_contiguous();
   bool dynamic_casting = needs_dynamic_casting<func_t>::check(iter);
+  if (dynamic_casting) {
+    TORCH_SLOW_PATH(DYNAMIC_CASTING);
+  }
 
   if (!dynamic_casting) {
     if (contiguous) {
       launch_vectorized_kernel(numel, f, data);
-    } else {
+    } else if (!launch_inner_vectorized_kernel(iter, f, data) &&
+               !launch_transposed_tile_kernel(iter, f, data)) {
       auto input_offset_calculator = make_input_offset_calculator<traits::arity>(iter);
       auto output_offset_calculator = make_output_offset_calculator(iter);
       auto loader = memory::LoadWithoutCast();
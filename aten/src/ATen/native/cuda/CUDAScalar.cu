@@ -2,6 +2,7 @@
 #include <ATen/NativeFunctions.h>
 
 #include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/cuda/IndexBoundsCheck.cuh>
 #include <cuda.h>
 
 #ifdef __HIP_PLATFORM_HCC__
@@ -31,6 +32,7 @@ Scalar _local_scalar_dense_cuda(const Tensor& self) {
         r = Scalar(value);
       });
 #endif
+  throwPendingIndexError();
   return r;
 }
 
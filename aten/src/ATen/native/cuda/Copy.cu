@@ -6,6 +6,7 @@
 #include <c10/cuda/CUDAStream.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
+#include <ATen/native/cuda/IndexBoundsCheck.cuh>
 #include <ATen/native/cuda/Loops.cuh>
 #include <THC/THC.h>
 
@@ -200,6 +201,7 @@ static void copy_kernel_cuda(TensorIterator& iter, bool non_blocking) {
     AT_CUDA_CHECK(cudaMemcpyAsync(dst, src, nbytes, kind, stream));
     AT_CUDA_CHECK(cudaStreamSynchronize(stream));
 #endif
+    throwPendingIndexError();
   }
 }
 
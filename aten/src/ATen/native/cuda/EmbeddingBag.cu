@@ -16,6 +16,7 @@
 #include <thrust/iterator/constant_iterator.h>
 #include <thrust/device_vector.h>
 
+#include <ATen/native/EmbeddingBag.h>
 #include <ATen/native/cuda/EmbeddingBackwardKernel.cuh>
 
 #include <c10/macros/Macros.h>
@@ -480,5 +481,240 @@ Tensor _embedding_bag_per_sample_weights_backward_cuda(
   return output;
 }
 
+namespace {
+
+// A table of _embedding_bag_multi. For the forward, src is the weight and dst
+// the output. For the backward, src is the grad and dst the gradient of the
+// weight, or the values of the sparse gradient.
+template <typename scalar_t, typename index_t>
+struct EmbeddingBagMultiTable {
+  const index_t* indices;
+  const index_t* offsets;
+  int64_t num_indices;
+  int64_t num_offsets;
+  int64_t bag_begin; // first bag of the table in the bags of all tables
+  int64_t feature_size;
+  const scalar_t* src;
+  int64_t src_stride0;
+  int64_t src_stride1;
+  scalar_t* dst; // contiguous
+};
+
+// Returns the last table that starts at or before bag, which skips the empty
+// tables in front of it.
+template <typename Table>
+__device__ __forceinline__ const Table& findTable(
+    const Table* tables, int64_t numTables, int64_t bag) {
+  int64_t lo = 0;
+  int64_t hi = numTables - 1;
+  while (lo < hi) {
+    int64_t mid = (lo + hi + 1) / 2;
+    if (tables[mid].bag_begin <= bag) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return tables[lo];
+}
+
+// Each bag of each table is handled by one row of threads of a block, with
+// the threads of the row covering the features.
+template <typename scalar_t, typename index_t>
+__global__ void EmbeddingBagMulti_updateOutputKernel(
+    const EmbeddingBagMultiTable<scalar_t, index_t>* tables, int64_t numTables,
+    int64_t numBags, int mode) {
+  using accscalar_t = acc_type<scalar_t, true>;
+  for (int64_t bag = blockIdx.x * blockDim.y + threadIdx.y; bag < numBags;
+       bag += gridDim.x * blockDim.y) {
+    const auto& table = findTable(tables, numTables, bag);
+    const int64_t tableBag = bag - table.bag_begin;
+    const int64_t begin = table.offsets[tableBag];
+    const int64_t end = tableBag + 1 < table.num_offsets
+        ? table.offsets[tableBag + 1] : table.num_indices;
+    for (int64_t featureDim = threadIdx.x; featureDim < table.feature_size;
+         featureDim += blockDim.x) {
+      const scalar_t* weightFeat = table.src + featureDim * table.src_stride1;
+      accscalar_t weightFeatSum = 0;
+      for (int64_t emb = begin; emb < end; emb++) {
+        weightFeatSum += static_cast<accscalar_t>(
+            weightFeat[table.indices[emb] * table.src_stride0]);
+      }
+      if (mode == MODE_MEAN && end > begin) {
+        weightFeatSum = weightFeatSum / static_cast<accscalar_t>(end - begin);
+      }
+      table.dst[tableBag * table.feature_size + featureDim] =
+          static_cast<scalar_t>(weightFeatSum);
+    }
+  }
+}
+
+// Writes (sparse) or adds (dense) the grad of each bag to the rows of its
+// indices.
+template <typename scalar_t, typename index_t>
+__global__ void EmbeddingBagMulti_accGradParametersKernel(
+    const EmbeddingBagMultiTable<scalar_t, index_t>* tables, int64_t numTables,
+    int64_t numBags, int mode, bool sparse) {
+  using accscalar_t = acc_type<scalar_t, true>;
+  for (int64_t bag = blockIdx.x * blockDim.y + threadIdx.y; bag < numBags;
+       bag += gridDim.x * blockDim.y) {
+    const auto& table = findTable(tables, numTables, bag);
+    const int64_t tableBag = bag - table.bag_begin;
+    const int64_t begin = table.offsets[tableBag];
+    const int64_t end = tableBag + 1 < table.num_offsets
+        ? table.offsets[tableBag + 1] : table.num_indices;
+    for (int64_t featureDim = threadIdx.x; featureDim < table.feature_size;
+         featureDim += blockDim.x) {
+      accscalar_t gradFeat = static_cast<accscalar_t>(
+          table.src[tableBag * table.src_stride0 + featureDim * table.src_stride1]);
+      if (mode == MODE_MEAN && end > begin) {
+        gradFeat = gradFeat / static_cast<accscalar_t>(end - begin);
+      }
+      const scalar_t value = static_cast<scalar_t>(gradFeat);
+      for (int64_t emb = begin; emb < end; emb++) {
+        if (sparse) {
+          table.dst[emb * table.feature_size + featureDim] = value;
+        } else {
+          gpuAtomicAdd(
+              &table.dst[table.indices[emb] * table.feature_size + featureDim],
+              value);
+        }
+      }
+    }
+  }
+}
+
+// Copies the tables to the device and launches kernel over the bags of all
+// tables.
+template <typename scalar_t, typename index_t, typename Launch>
+void launch_embedding_bag_multi(
+    TensorList srcs, TensorList indices, TensorList offsets,
+    const std::vector<Tensor>& dsts, bool include_last_offset,
+    const Launch& launch) {
+  using Table = EmbeddingBagMultiTable<scalar_t, index_t>;
+  const int64_t numTables = srcs.size();
+  const int64_t tablesSize = numTables * sizeof(Table);
+  auto tables_storage = at::empty({tablesSize},
+      srcs[0].options().dtype(at::kByte).device(at::kCPU).pinned_memory(true));
+  auto tables = static_cast<Table*>(tables_storage.data_ptr());
+  int64_t numBags = 0;
+  for (int64_t t = 0; t < numTables; ++t) {
+    tables[t].indices = indices[t].data_ptr<index_t>();
+    tables[t].offsets = offsets[t].data_ptr<index_t>();
+    tables[t].num_indices = indices[t].numel();
+    tables[t].num_offsets = offsets[t].numel();
+    tables[t].bag_begin = numBags;
+    tables[t].feature_size = srcs[t].size(1);
+    tables[t].src = srcs[t].data_ptr<scalar_t>();
+    tables[t].src_stride0 = srcs[t].stride(0);
+    tables[t].src_stride1 = srcs[t].stride(1);
+    tables[t].dst = dsts[t].data_ptr<scalar_t>();
+    numBags += offsets[t].numel() - (include_last_offset ? 1 : 0);
+  }
+  if (numBags == 0) {
+    return;
+  }
+  auto d_tables_storage = at::empty({tablesSize}, srcs[0].options().dtype(at::kByte));
+  at::native::copy_(d_tables_storage, tables_storage, /* non_blocking= */ true);
+
+#ifdef __HIP_PLATFORM_HCC__
+  dim3 block = dim3(64, 4);
+#else
+  dim3 block = dim3(32, 8);
+#endif
+  int grid = std::min<int64_t>(1024, THCCeilDiv(numBags, (int64_t)block.y));
+  launch(static_cast<const Table*>(d_tables_storage.data_ptr()), numTables,
+         numBags, grid, block, at::cuda::getCurrentCUDAStream());
+}
+
+} // namespace
+
+// See _embedding_bag_multi_cpu in EmbeddingBag.cpp. All tables are reduced by
+// a single kernel launch.
+std::vector<Tensor> _embedding_bag_multi_cuda(
+    TensorList weights, TensorList indices, TensorList offsets, int64_t mode,
+    bool sparse, bool include_last_offset) {
+  std::ignore = sparse;
+  check_embedding_bag_multi_args(
+      weights, indices, offsets, mode, "_embedding_bag_multi_cuda");
+  std::vector<Tensor> outputs;
+  outputs.reserve(weights.size());
+  for (size_t t = 0; t < weights.size(); ++t) {
+    auto weight_arg = TensorArg(weights[t], "weights", 1);
+    checkSameGPU("_embedding_bag_multi_cuda", weight_arg, TensorArg(indices[t], "indices", 2));
+    checkSameGPU("_embedding_bag_multi_cuda", weight_arg, TensorArg(offsets[t], "offsets", 3));
+    const int64_t numBags = offsets[t].size(0) - (include_last_offset ? 1 : 0);
+    outputs.push_back(at::empty({numBags, weights[t].size(1)}, weights[t].options()));
+  }
+  if (weights.empty()) {
+    return outputs;
+  }
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, weights[0].scalar_type(), "_embedding_bag_multi_cuda", [&] {
+    AT_DISPATCH_INDEX_TYPES(indices[0].scalar_type(), "_embedding_bag_multi_cuda", [&] () {
+      launch_embedding_bag_multi<scalar_t, index_t>(
+          weights, indices, offsets, outputs, include_last_offset,
+          [&](const EmbeddingBagMultiTable<scalar_t, index_t>* tables,
+              int64_t numTables, int64_t numBags, int grid, dim3 block,
+              cudaStream_t stream) {
+            EmbeddingBagMulti_updateOutputKernel<scalar_t, index_t><<<grid, block, 0, stream>>>(
+                tables, numTables, numBags, mode);
+            C10_CUDA_KERNEL_LAUNCH_CHECK();
+          });
+    });
+  });
+  return outputs;
+}
+
+std::vector<Tensor> _embedding_bag_multi_backward_cuda(
+    TensorList grads, TensorList indices, TensorList offsets,
+    IntArrayRef num_weights, int64_t mode, bool sparse,
+    bool include_last_offset) {
+  check_embedding_bag_multi_args(
+      grads, indices, offsets, mode, "_embedding_bag_multi_backward_cuda");
+  TORCH_CHECK(
+      num_weights.size() == grads.size(),
+      "_embedding_bag_multi_backward_cuda: expected one num_weights per table");
+  if (!sparse) {
+    // See Note [Writing Nondeterministic Operations]
+    // Nondeterministic because of atomicAdd usage
+    globalContext().alertNotDeterministic("_embedding_bag_multi_backward_cuda");
+  }
+
+  std::vector<Tensor> grad_weights;
+  grad_weights.reserve(grads.size());
+  for (size_t t = 0; t < grads.size(); ++t) {
+    grad_weights.push_back(sparse
+        ? at::empty({indices[t].numel(), grads[t].size(1)}, grads[t].options())
+        : at::zeros({num_weights[t], grads[t].size(1)}, grads[t].options()));
+  }
+  if (grads.empty()) {
+    return grad_weights;
+  }
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, grads[0].scalar_type(), "_embedding_bag_multi_backward_cuda", [&] {
+    AT_DISPATCH_INDEX_TYPES(indices[0].scalar_type(), "_embedding_bag_multi_backward_cuda", [&] () {
+      launch_embedding_bag_multi<scalar_t, index_t>(
+          grads, indices, offsets, grad_weights, include_last_offset,
+          [&](const EmbeddingBagMultiTable<scalar_t, index_t>* tables,
+              int64_t numTables, int64_t numBags, int grid, dim3 block,
+              cudaStream_t stream) {
+            EmbeddingBagMulti_accGradParametersKernel<scalar_t, index_t><<<grid, block, 0, stream>>>(
+                tables, numTables, numBags, mode, sparse);
+            C10_CUDA_KERNEL_LAUNCH_CHECK();
+          });
+    });
+  });
+
+  if (sparse) {
+    for (size_t t = 0; t < grads.size(); ++t) {
+      grad_weights[t] = at::_sparse_coo_tensor_unsafe(
+          indices[t].reshape({1, -1}).to(kLong), grad_weights[t],
+          {num_weights[t], grads[t].size(1)});
+    }
+  }
+  return grad_weights;
+}
+
 }
 }
@@ -0,0 +1,275 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Context.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/TensorUtils.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/detail/KernelUtils.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/macros/Macros.h>
+
+#include <THC/THCAtomics.cuh>
+
+#include <cub/cub.cuh>
+
+#include <limits>
+
+// The sparse gradient of an embedding as one row per unique index, computed
+// without sorting the indices: the indices are inserted into an open
+// addressing hash table, whose occupied slots give the unique rows; only
+// those (usually far fewer than the indices) are sorted, to order the rows
+// of the coalesced gradient.
+//
+// The rows of the gradient are then either accumulated with atomics, or, for
+// deterministic results, summed in the order of the indices after a radix
+// sort of the row of each index, which only looks at the bits of the number
+// of unique rows instead of the full width of the indices.
+
+namespace at { namespace native {
+
+namespace {
+
+constexpr int64_t kEmptySlot = -1;
+constexpr int kHashBlockSize = 256;
+
+__device__ __forceinline__ uint64_t embedding_hash(int64_t key) {
+  // The finalizer of MurmurHash3, which spreads consecutive indices over the
+  // table
+  uint64_t h = static_cast<uint64_t>(key);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// Returns the slot of key, inserting it if it isn't in the table yet
+__device__ __forceinline__ int64_t embedding_hash_insert(
+    int64_t* table_keys,
+    int64_t capacity_mask,
+    int64_t key) {
+  int64_t slot = embedding_hash(key) & capacity_mask;
+  while (true) {
+    const auto prev = static_cast<int64_t>(atomicCAS(
+        reinterpret_cast<unsigned long long*>(table_keys + slot),
+        static_cast<unsigned long long>(kEmptySlot),
+        static_cast<unsigned long long>(key)));
+    if (prev == kEmptySlot || prev == key) {
+      return slot;
+    }
+    slot = (slot + 1) & capacity_mask;
+  }
+}
+
+// Writes the slot of each index, -1 for padding_idx. The lanes of a warp
+// that share an index insert it once, which keeps the hot rows of skewed
+// distributions from serializing on the same slot. The loop bound is the
+// same for the whole block so that the warps stay converged.
+template <typename index_t>
+__global__ void embedding_hash_insert_kernel(
+    const index_t* __restrict__ indices,
+    int64_t numel,
+    int64_t padding_idx,
+    int64_t* __restrict__ table_keys,
+    int64_t capacity_mask,
+    int64_t* __restrict__ slots) {
+  const int64_t stride = static_cast<int64_t>(gridDim.x) * blockDim.x;
+  for (int64_t start = static_cast<int64_t>(blockIdx.x) * blockDim.x; start < numel; start += stride) {
+    const int64_t i = start + threadIdx.x;
+    const int64_t key = i < numel ? static_cast<int64_t>(indices[i]) : kEmptySlot;
+    const bool active = i < numel && key != padding_idx;
+    int64_t slot = kEmptySlot;
+#if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 700
+    const unsigned peers = __match_any_sync(0xffffffff, static_cast<unsigned long long>(key));
+    const int leader = __ffs(peers) - 1;
+    if (active && static_cast<int>(threadIdx.x % C10_WARP_SIZE) == leader) {
+      slot = embedding_hash_insert(table_keys, capacity_mask, key);
+    }
+    slot = __shfl_sync(0xffffffff, slot, leader);
+#else
+    if (active) {
+      slot = embedding_hash_insert(table_keys, capacity_mask, key);
+    }
+#endif
+    if (i < numel) {
+      slots[i] = active ? slot : kEmptySlot;
+    }
+  }
+}
+
+// Adds grad (numel x features) into the rows of values, skipping the
+// indices of row -1
+template <typename scalar_t, typename accscalar_t>
+__global__ void embedding_sparse_accumulate_kernel(
+    const scalar_t* __restrict__ grad,
+    const int64_t* __restrict__ rows,
+    int64_t numel,
+    int64_t features,
+    accscalar_t* __restrict__ values) {
+  CUDA_KERNEL_LOOP_TYPE(linear, numel * features, int64_t) {
+    const int64_t i = linear / features;
+    const int64_t row = rows[i];
+    if (row >= 0) {
+      gpuAtomicAdd(values + row * features + linear % features,
+                   static_cast<accscalar_t>(grad[linear]));
+    }
+  }
+}
+
+// Sums, in the order of the indices, the gradients of the positions
+// offsets[row]..offsets[row + 1] of the indices sorted by row
+template <typename scalar_t, typename accscalar_t>
+__global__ void embedding_sparse_segment_sum_kernel(
+    const scalar_t* __restrict__ grad,
+    const int64_t* __restrict__ positions,
+    const int64_t* __restrict__ offsets,
+    int64_t num_rows,
+    int64_t features,
+    scalar_t* __restrict__ values) {
+  const int64_t feature = static_cast<int64_t>(blockIdx.y) * blockDim.x + threadIdx.x;
+  if (feature >= features) {
+    return;
+  }
+  for (int64_t row = blockIdx.x; row < num_rows; row += gridDim.x) {
+    accscalar_t sum = 0;
+    for (int64_t p = offsets[row]; p < offsets[row + 1]; p++) {
+      sum += static_cast<accscalar_t>(grad[positions[p] * features + feature]);
+    }
+    values[row * features + feature] = static_cast<scalar_t>(sum);
+  }
+}
+
+int64_t embedding_hash_blocks(int64_t numel) {
+  const int64_t max_blocks = at::cuda::getCurrentDeviceProperties()->multiProcessorCount *
+      (at::cuda::getCurrentDeviceProperties()->maxThreadsPerMultiProcessor / kHashBlockSize);
+  return std::max<int64_t>(1, std::min<int64_t>(max_blocks, (numel + kHashBlockSize - 1) / kHashBlockSize));
+}
+
+// Stable sort of the keys, in [0, 2^end_bit), with the values
+void radix_sort_pairs(
+    const Tensor& keys_in, Tensor& keys_out,
+    const Tensor& values_in, Tensor& values_out,
+    int end_bit) {
+  auto& allocator = *c10::cuda::CUDACachingAllocator::get();
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  const int num_items = static_cast<int>(keys_in.numel());
+  size_t temp_storage_bytes = 0;
+  AT_CUDA_CHECK(cub::DeviceRadixSort::SortPairs(
+      nullptr, temp_storage_bytes,
+      keys_in.data_ptr<int64_t>(), keys_out.data_ptr<int64_t>(),
+      values_in.data_ptr<int64_t>(), values_out.data_ptr<int64_t>(),
+      num_items, 0, end_bit, stream));
+  auto temp_storage = allocator.allocate(temp_storage_bytes);
+  AT_CUDA_CHECK(cub::DeviceRadixSort::SortPairs(
+      temp_storage.get(), temp_storage_bytes,
+      keys_in.data_ptr<int64_t>(), keys_out.data_ptr<int64_t>(),
+      values_in.data_ptr<int64_t>(), values_out.data_ptr<int64_t>(),
+      num_items, 0, end_bit, stream));
+}
+
+} // namespace
+
+Tensor embedding_sparse_backward_coalesced_cuda(
+    const Tensor& grad_, const Tensor& indices_, int64_t num_weights,
+    int64_t padding_idx) {
+  auto grad_arg = TensorArg(grad_, "grad", 1);
+  auto indices_arg = TensorArg(indices_, "indices", 2);
+  checkScalarTypes("embedding_backward", indices_arg, {kLong, kInt});
+  checkSameGPU("embedding_backward", grad_arg, indices_arg);
+
+  const int64_t num_features = grad_.size(-1);
+  const int64_t numel = indices_.numel();
+  auto weight_size = std::array<int64_t, 2>{{ num_weights, num_features }};
+  auto empty_gradient = [&] {
+    return at::_sparse_coo_tensor_unsafe(at::empty({1, 0}, indices_.options().dtype(kLong)),
+                                         at::empty({0, num_features}, grad_.options()),
+                                         weight_size)._coalesced_(true);
+  };
+  if (numel == 0) {
+    return empty_gradient();
+  }
+  // The cub sort of the deterministic path takes an int number of items
+  TORCH_CHECK(numel <= std::numeric_limits<int>::max(),
+              "embedding_backward: expected at most ", std::numeric_limits<int>::max(),
+              " indices, got ", numel);
+
+  auto indices = indices_.contiguous().view({-1});
+  auto grad = grad_.contiguous().view({numel, num_features});
+  auto long_options = indices.options().dtype(kLong);
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+
+  // A load factor of at most 1/2 keeps the probe sequences short
+  int64_t capacity = 1;
+  while (capacity < 2 * numel) {
+    capacity *= 2;
+  }
+  Tensor table_keys = at::full({capacity}, kEmptySlot, long_options);
+  Tensor slots = at::empty({numel}, long_options);
+  AT_DISPATCH_INDEX_TYPES(indices.scalar_type(), "embedding_sparse_backward_coalesced_cuda", [&] () {
+    embedding_hash_insert_kernel<index_t><<<embedding_hash_blocks(numel), kHashBlockSize, 0, stream>>>(
+        indices.data_ptr<index_t>(), numel, padding_idx,
+        table_keys.data_ptr<int64_t>(), capacity - 1, slots.data_ptr<int64_t>());
+    C10_CUDA_KERNEL_LAUNCH_CHECK();
+  });
+
+  // The unique indices in order, and the row of the gradient of each slot
+  Tensor occupied_slots = (table_keys != kEmptySlot).nonzero().view({-1});
+  const int64_t num_rows = occupied_slots.numel();
+  if (num_rows == 0) {
+    return empty_gradient();
+  }
+  Tensor unique_indices, order;
+  std::tie(unique_indices, order) = table_keys.index_select(0, occupied_slots).sort();
+  Tensor slot_rows = at::empty({capacity}, long_options);
+  slot_rows.index_put_({occupied_slots.index_select(0, order)}, at::arange(num_rows, long_options));
+  // -1 for padding_idx
+  Tensor rows = at::where(slots >= 0, slot_rows.index_select(0, slots.clamp_min(0)), slots);
+
+  Tensor values;
+  // See Note [Enabling Deterministic Operations]
+  if (at::globalContext().deterministicAlgorithms()) {
+    // The keys are the rows + 1, which puts padding_idx in its own segment
+    int end_bit = 1;
+    while ((int64_t(1) << end_bit) <= num_rows) {
+      end_bit++;
+    }
+    Tensor keys = rows + 1;
+    Tensor sorted_keys = at::empty_like(keys);
+    Tensor positions = at::empty_like(keys);
+    radix_sort_pairs(keys, sorted_keys, at::arange(numel, long_options), positions, end_bit);
+    Tensor offsets = at::searchsorted(sorted_keys, at::arange(1, num_rows + 2, long_options));
+
+    values = at::empty({num_rows, num_features}, grad.options());
+    const int threads = std::min<int64_t>(
+        at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock,
+        std::max<int64_t>(C10_WARP_SIZE, (num_features + C10_WARP_SIZE - 1) / C10_WARP_SIZE * C10_WARP_SIZE));
+    const dim3 blocks(std::min<int64_t>(num_rows, 65535), (num_features + threads - 1) / threads);
+    AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
+        grad.scalar_type(), "embedding_sparse_backward_coalesced_cuda", [&] {
+      using accscalar_t = acc_type<scalar_t, true>;
+      embedding_sparse_segment_sum_kernel<scalar_t, accscalar_t><<<blocks, threads, 0, stream>>>(
+          grad.data_ptr<scalar_t>(), positions.data_ptr<int64_t>(), offsets.data_ptr<int64_t>(),
+          num_rows, num_features, values.data_ptr<scalar_t>());
+      C10_CUDA_KERNEL_LAUNCH_CHECK();
+    });
+  } else {
+    const auto acc_dtype = grad.scalar_type() == kDouble ? kDouble : kFloat;
+    Tensor values_acc = at::zeros({num_rows, num_features}, grad.options().dtype(acc_dtype));
+    AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
+        grad.scalar_type(), "embedding_sparse_backward_coalesced_cuda", [&] {
+      using accscalar_t = acc_type<scalar_t, true>;
+      const int64_t total = numel * num_features;
+      embedding_sparse_accumulate_kernel<scalar_t, accscalar_t>
+          <<<cuda::detail::GET_BLOCKS(total), cuda::detail::CUDA_NUM_THREADS, 0, stream>>>(
+          grad.data_ptr<scalar_t>(), rows.data_ptr<int64_t>(), numel, num_features,
+          values_acc.data_ptr<accscalar_t>());
+      C10_CUDA_KERNEL_LAUNCH_CHECK();
+    });
+    values = values_acc.to(grad.scalar_type());
+  }
+
+  return at::_sparse_coo_tensor_unsafe(unique_indices.unsqueeze(0), values, weight_size)._coalesced_(true);
+}
+
+}} // namespace at::native
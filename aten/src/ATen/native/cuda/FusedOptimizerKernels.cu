@@ -0,0 +1,591 @@
+#include <ATen/ATen.h>
+#include <ATen/DeviceGuard.h>
+#include <ATen/cuda/Atomic.cuh>
+#include <ATen/native/ForeachUtils.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+#include <ATen/native/cuda/block_reduce.cuh>
+
+#include <cmath>
+#include <type_traits>
+
+// Fused optimizer steps, which update all the parameters of a step and their
+// states in a single multi_tensor_apply sweep instead of one sweep per
+// _foreach_* op.
+//
+// params are the parameters that are updated, with states of the same dtype.
+// model_params is either empty, or the fp16/bf16 copies of fp32 master
+// params, which are written with the updated params; grads are then of the
+// dtype of model_params.
+//
+// If inv_grad_scale is given, grads are multiplied by it as they are read, so
+// that GradScaler doesn't need to write the unscaled grads, and if found_inf
+// is given and set (see _amp_foreach_non_finite_check_cuda) the step is
+// skipped on the device.
+
+namespace at { namespace native {
+
+namespace {
+
+// The device pointers of the optional GradScaler arguments
+struct GradScalerArgs {
+  const float* inv_grad_scale;
+  const float* found_inf;
+};
+
+GradScalerArgs grad_scaler_args(
+    const c10::optional<Tensor>& inv_grad_scale,
+    const c10::optional<Tensor>& found_inf) {
+  GradScalerArgs args{nullptr, nullptr};
+  if (inv_grad_scale.has_value() && inv_grad_scale->defined()) {
+    TORCH_CHECK(inv_grad_scale->is_cuda(), "inv_grad_scale must be a CUDA tensor.");
+    TORCH_CHECK(inv_grad_scale->numel() == 1, "inv_grad_scale must be a 1-element tensor.");
+    TORCH_CHECK(inv_grad_scale->scalar_type() == at::ScalarType::Float, "inv_grad_scale must be a float tensor.");
+    args.inv_grad_scale = inv_grad_scale->data_ptr<float>();
+  }
+  if (found_inf.has_value() && found_inf->defined()) {
+    TORCH_CHECK(found_inf->is_cuda(), "found_inf must be a CUDA tensor.");
+    TORCH_CHECK(found_inf->numel() == 1, "found_inf must be a 1-element tensor.");
+    TORCH_CHECK(found_inf->scalar_type() == at::ScalarType::Float, "found_inf must be a float tensor.");
+    args.found_inf = found_inf->data_ptr<float>();
+  }
+  return args;
+}
+
+void check_same_layout(const Tensor& t, const Tensor& param, ScalarType dtype, const char* name) {
+  TORCH_CHECK(t.scalar_type() == dtype, "Expected ", name, " of dtype ", dtype, ", got ", t.scalar_type());
+  TORCH_CHECK(t.device() == param.device(), "Expected ", name, " on ", param.device(), ", got ", t.device());
+  TORCH_CHECK(t.sizes() == param.sizes(), "Expected ", name, " of size ", param.sizes(), ", got ", t.sizes());
+  TORCH_CHECK(t.strides() == param.strides(), "Expected ", name, " of strides ", param.strides(), ", got ", t.strides());
+}
+
+// Returns the tensor lists params, grads, states... and model_params of a
+// fused step, in the order of their addresses in TensorListMetadata. The
+// lists are swept linearly, so all the tensors of a parameter must have its
+// strides; grads that don't are copied.
+std::vector<std::vector<Tensor>> fused_optimizer_tensor_lists(
+    TensorList params,
+    TensorList grads,
+    std::vector<TensorList> states,
+    TensorList model_params) {
+  TORCH_CHECK(params.size() > 0, "Tensor list must have at least one tensor.");
+  TORCH_CHECK(grads.size() == params.size(), "Expected as many grads as params, got ", grads.size(), " and ", params.size());
+  for (const TensorList& state : states) {
+    TORCH_CHECK(state.size() == params.size(), "Expected as many states as params, got ", state.size(), " and ", params.size());
+  }
+  const ScalarType param_dtype = params[0].scalar_type();
+  ScalarType grad_dtype = param_dtype;
+  if (!model_params.empty()) {
+    TORCH_CHECK(model_params.size() == params.size(), "Expected as many model_params as params, got ", model_params.size(), " and ", params.size());
+    TORCH_CHECK(param_dtype == at::ScalarType::Float, "Master params must be float tensors.");
+    grad_dtype = model_params[0].scalar_type();
+    TORCH_CHECK(grad_dtype == at::ScalarType::Half || grad_dtype == at::ScalarType::BFloat16,
+                "model_params must be half or bfloat16 tensors.");
+  }
+
+  std::vector<std::vector<Tensor>> tensor_lists(2 + states.size() + (model_params.empty() ? 0 : 1));
+  for (auto& list : tensor_lists) {
+    list.reserve(params.size());
+  }
+  const Device device = params[0].device();
+  TORCH_CHECK(params[0].is_cuda(), "params must be CUDA tensors.");
+  for (size_t i = 0; i < params.size(); i++) {
+    const Tensor& param = params[i];
+    TORCH_CHECK(param.device() == device, "params must be on the same device.");
+    TORCH_CHECK(param.layout() == at::kStrided && param.is_non_overlapping_and_dense(),
+                "params must be non overlapping and dense strided tensors.");
+    check_same_layout(param, param, param_dtype, "param");
+    tensor_lists[0].push_back(param);
+
+    Tensor grad = grads[i];
+    TORCH_CHECK(!grad.is_sparse(), "Fused optimizers don't support sparse gradients.");
+    if (grad.sizes() == param.sizes() && grad.strides() != param.strides()) {
+      grad = at::empty_strided(param.sizes(), param.strides(), grad.options()).copy_(grad);
+    }
+    check_same_layout(grad, param, grad_dtype, "grad");
+    tensor_lists[1].push_back(grad);
+
+    for (size_t s = 0; s < states.size(); s++) {
+      check_same_layout(states[s][i], param, param_dtype, "state");
+      tensor_lists[2 + s].push_back(states[s][i]);
+    }
+    if (!model_params.empty()) {
+      check_same_layout(model_params[i], param, grad_dtype, "model_param");
+      tensor_lists.back().push_back(model_params[i]);
+    }
+  }
+  return tensor_lists;
+}
+
+template<typename T>
+__device__ __forceinline__ T* chunk_address(void* address, int chunk_idx, int chunk_size) {
+  return static_cast<T*>(address) + static_cast<int64_t>(chunk_idx) * chunk_size;
+}
+
+__device__ __forceinline__ bool skip_step(const float* found_inf) {
+  return found_inf != nullptr && *found_inf != 0.f;
+}
+
+template<typename opmath_t>
+__device__ __forceinline__ opmath_t grad_scale_of(const float* inv_grad_scale) {
+  return inv_grad_scale != nullptr ? static_cast<opmath_t>(*inv_grad_scale) : opmath_t(1);
+}
+
+//
+// Adam and AdamW
+//
+
+template<typename opmath_t>
+struct AdamHyperParams {
+  opmath_t lr;
+  opmath_t beta1;
+  opmath_t beta2;
+  opmath_t weight_decay;
+  opmath_t eps;
+  // lr / bias_correction1
+  opmath_t step_size;
+  opmath_t sqrt_bias_correction2;
+  bool decoupled_weight_decay;
+};
+
+// lists: params, grads, exp_avgs, exp_avg_sqs, [max_exp_avg_sqs], [model_params]
+template<typename param_t, typename grad_t, int depth, bool amsgrad, bool master>
+struct FusedAdamFunctor {
+  using opmath_t = typename get_opmath_t<param_t>::opmath_t;
+  __device__ __forceinline__ void operator() (
+      int chunk_size,
+      TensorListMetadata<depth>& tl,
+      AdamHyperParams<opmath_t> hp,
+      const float* inv_grad_scale,
+      const float* found_inf) {
+    if (skip_step(found_inf)) {
+      return;
+    }
+    int tensor_loc = tl.block_to_tensor[blockIdx.x];
+    int chunk_idx = tl.block_to_chunk[blockIdx.x];
+    int n = tl.numel_for_tensor[tensor_loc] - chunk_idx * chunk_size;
+
+    param_t* param = chunk_address<param_t>(tl.addresses[0][tensor_loc], chunk_idx, chunk_size);
+    const grad_t* grad = chunk_address<grad_t>(tl.addresses[1][tensor_loc], chunk_idx, chunk_size);
+    param_t* exp_avg = chunk_address<param_t>(tl.addresses[2][tensor_loc], chunk_idx, chunk_size);
+    param_t* exp_avg_sq = chunk_address<param_t>(tl.addresses[3][tensor_loc], chunk_idx, chunk_size);
+    param_t* max_exp_avg_sq = amsgrad ? chunk_address<param_t>(tl.addresses[4][tensor_loc], chunk_idx, chunk_size) : nullptr;
+    grad_t* model_param = master ? chunk_address<grad_t>(tl.addresses[depth - 1][tensor_loc], chunk_idx, chunk_size) : nullptr;
+    const opmath_t grad_scale = grad_scale_of<opmath_t>(inv_grad_scale);
+
+    for (int i = threadIdx.x; i < n && i < chunk_size; i += blockDim.x) {
+      opmath_t p = static_cast<opmath_t>(param[i]);
+      opmath_t g = static_cast<opmath_t>(grad[i]) * grad_scale;
+      if (hp.weight_decay != 0) {
+        if (hp.decoupled_weight_decay) {
+          p *= 1 - hp.lr * hp.weight_decay;
+        } else {
+          g += hp.weight_decay * p;
+        }
+      }
+      const opmath_t m = hp.beta1 * static_cast<opmath_t>(exp_avg[i]) + (1 - hp.beta1) * g;
+      const opmath_t v = hp.beta2 * static_cast<opmath_t>(exp_avg_sq[i]) + (1 - hp.beta2) * g * g;
+      exp_avg[i] = static_cast<param_t>(m);
+      exp_avg_sq[i] = static_cast<param_t>(v);
+      opmath_t denom_sq = v;
+      if (amsgrad) {
+        const opmath_t max_v = static_cast<opmath_t>(max_exp_avg_sq[i]);
+        denom_sq = max_v > v ? max_v : v;
+        max_exp_avg_sq[i] = static_cast<param_t>(denom_sq);
+      }
+      const opmath_t denom = ::sqrt(denom_sq) / hp.sqrt_bias_correction2 + hp.eps;
+      p -= hp.step_size * m / denom;
+      param[i] = static_cast<param_t>(p);
+      if (master) {
+        model_param[i] = static_cast<grad_t>(p);
+      }
+    }
+  }
+};
+
+template<typename param_t, typename grad_t, bool master>
+void launch_fused_adam(
+    std::vector<std::vector<Tensor>>& tensor_lists,
+    double lr, double beta1, double beta2, double weight_decay, double eps, int64_t step,
+    bool amsgrad, bool decoupled_weight_decay,
+    const GradScalerArgs& scaler) {
+  using opmath_t = typename get_opmath_t<param_t>::opmath_t;
+  AdamHyperParams<opmath_t> hp;
+  hp.lr = lr;
+  hp.beta1 = beta1;
+  hp.beta2 = beta2;
+  hp.weight_decay = weight_decay;
+  hp.eps = eps;
+  hp.step_size = lr / (1 - std::pow(beta1, step));
+  hp.sqrt_bias_correction2 = std::sqrt(1 - std::pow(beta2, step));
+  hp.decoupled_weight_decay = decoupled_weight_decay;
+  if (amsgrad) {
+    multi_tensor_apply<5 + master>(tensor_lists,
+                                   FusedAdamFunctor<param_t, grad_t, 5 + master, true, master>(),
+                                   hp,
+                                   scaler.inv_grad_scale,
+                                   scaler.found_inf);
+  } else {
+    multi_tensor_apply<4 + master>(tensor_lists,
+                                   FusedAdamFunctor<param_t, grad_t, 4 + master, false, master>(),
+                                   hp,
+                                   scaler.inv_grad_scale,
+                                   scaler.found_inf);
+  }
+}
+
+//
+// SGD
+//
+
+template<typename opmath_t>
+struct SGDHyperParams {
+  opmath_t lr;
+  opmath_t momentum;
+  opmath_t dampening;
+  opmath_t weight_decay;
+  bool nesterov;
+  // whether the momentum buffers are initialized to the grads
+  bool first_step;
+};
+
+// lists: params, grads, [momentum_buffers], [model_params]
+template<typename param_t, typename grad_t, int depth, bool has_momentum, bool master>
+struct FusedSGDFunctor {
+  using opmath_t = typename get_opmath_t<param_t>::opmath_t;
+  __device__ __forceinline__ void operator() (
+      int chunk_size,
+      TensorListMetadata<depth>& tl,
+      SGDHyperParams<opmath_t> hp,
+      const float* inv_grad_scale,
+      const float* found_inf) {
+    if (skip_step(found_inf)) {
+      return;
+    }
+    int tensor_loc = tl.block_to_tensor[blockIdx.x];
+    int chunk_idx = tl.block_to_chunk[blockIdx.x];
+    int n = tl.numel_for_tensor[tensor_loc] - chunk_idx * chunk_size;
+
+    param_t* param = chunk_address<param_t>(tl.addresses[0][tensor_loc], chunk_idx, chunk_size);
+    const grad_t* grad = chunk_address<grad_t>(tl.addresses[1][tensor_loc], chunk_idx, chunk_size);
+    param_t* momentum_buffer = has_momentum ? chunk_address<param_t>(tl.addresses[2][tensor_loc], chunk_idx, chunk_size) : nullptr;
+    grad_t* model_param = master ? chunk_address<grad_t>(tl.addresses[depth - 1][tensor_loc], chunk_idx, chunk_size) : nullptr;
+    const opmath_t grad_scale = grad_scale_of<opmath_t>(inv_grad_scale);
+
+    for (int i = threadIdx.x; i < n && i < chunk_size; i += blockDim.x) {
+      opmath_t p = static_cast<opmath_t>(param[i]);
+      opmath_t d_p = static_cast<opmath_t>(grad[i]) * grad_scale;
+      if (hp.weight_decay != 0) {
+        d_p += hp.weight_decay * p;
+      }
+      if (has_momentum) {
+        const opmath_t buf = hp.first_step
+            ? d_p
+            : hp.momentum * static_cast<opmath_t>(momentum_buffer[i]) + (1 - hp.dampening) * d_p;
+        momentum_buffer[i] = static_cast<param_t>(buf);
+        d_p = hp.nesterov ? d_p + hp.momentum * buf : buf;
+      }
+      p -= hp.lr * d_p;
+      param[i] = static_cast<param_t>(p);
+      if (master) {
+        model_param[i] = static_cast<grad_t>(p);
+      }
+    }
+  }
+};
+
+template<typename param_t, typename grad_t, bool master>
+void launch_fused_sgd(
+    std::vector<std::vector<Tensor>>& tensor_lists,
+    double lr, double momentum, double dampening, double weight_decay, bool nesterov, bool first_step,
+    const GradScalerArgs& scaler) {
+  using opmath_t = typename get_opmath_t<param_t>::opmath_t;
+  SGDHyperParams<opmath_t> hp;
+  hp.lr = lr;
+  hp.momentum = momentum;
+  hp.dampening = dampening;
+  hp.weight_decay = weight_decay;
+  hp.nesterov = nesterov;
+  hp.first_step = first_step;
+  if (momentum != 0) {
+    multi_tensor_apply<3 + master>(tensor_lists,
+                                   FusedSGDFunctor<param_t, grad_t, 3 + master, true, master>(),
+                                   hp,
+                                   scaler.inv_grad_scale,
+                                   scaler.found_inf);
+  } else {
+    multi_tensor_apply<2 + master>(tensor_lists,
+                                   FusedSGDFunctor<param_t, grad_t, 2 + master, false, master>(),
+                                   hp,
+                                   scaler.inv_grad_scale,
+                                   scaler.found_inf);
+  }
+}
+
+//
+// LAMB
+//
+// The trust ratio of a parameter depends on the norm of its whole update, so
+// a LAMB step takes two sweeps: the first one updates the moments, writes the
+// Adam updates and accumulates the squared norms of the params and updates of
+// each tensor, and the second one applies the updates scaled by their trust
+// ratios.
+//
+
+// lists: params, grads, exp_avgs, exp_avg_sqs, updates
+template<typename param_t, typename grad_t>
+struct FusedLambUpdateFunctor {
+  using opmath_t = typename get_opmath_t<param_t>::opmath_t;
+  __device__ __forceinline__ void operator() (
+      int chunk_size,
+      TensorListMetadata<5>& tl,
+      AdamHyperParams<opmath_t> hp,
+      float* param_norms,
+      float* update_norms,
+      const float* inv_grad_scale,
+      const float* found_inf) {
+    if (skip_step(found_inf)) {
+      return;
+    }
+    int tensor_loc = tl.block_to_tensor[blockIdx.x];
+    int chunk_idx = tl.block_to_chunk[blockIdx.x];
+    int n = tl.numel_for_tensor[tensor_loc] - chunk_idx * chunk_size;
+
+    const param_t* param = chunk_address<param_t>(tl.addresses[0][tensor_loc], chunk_idx, chunk_size);
+    const grad_t* grad = chunk_address<grad_t>(tl.addresses[1][tensor_loc], chunk_idx, chunk_size);
+    param_t* exp_avg = chunk_address<param_t>(tl.addresses[2][tensor_loc], chunk_idx, chunk_size);
+    param_t* exp_avg_sq = chunk_address<param_t>(tl.addresses[3][tensor_loc], chunk_idx, chunk_size);
+    param_t* update = chunk_address<param_t>(tl.addresses[4][tensor_loc], chunk_idx, chunk_size);
+    const opmath_t grad_scale = grad_scale_of<opmath_t>(inv_grad_scale);
+
+    opmath_t param_norm = 0;
+    opmath_t update_norm = 0;
+    for (int i = threadIdx.x; i < n && i < chunk_size; i += blockDim.x) {
+      const opmath_t p = static_cast<opmath_t>(param[i]);
+      const opmath_t g = static_cast<opmath_t>(grad[i]) * grad_scale;
+      const opmath_t m = hp.beta1 * static_cast<opmath_t>(exp_avg[i]) + (1 - hp.beta1) * g;
+      const opmath_t v = hp.beta2 * static_cast<opmath_t>(exp_avg_sq[i]) + (1 - hp.beta2) * g * g;
+      exp_avg[i] = static_cast<param_t>(m);
+      exp_avg_sq[i] = static_cast<param_t>(v);
+      // step_size is 1 / bias_correction1 here
+      const opmath_t u = hp.step_size * m / (::sqrt(v) / hp.sqrt_bias_correction2 + hp.eps) + hp.weight_decay * p;
+      update[i] = static_cast<param_t>(u);
+      param_norm += p * p;
+      update_norm += u * u;
+    }
+
+    __shared__ opmath_t shared[C10_WARP_SIZE];
+    param_norm = cuda_utils::BlockReduceSum(param_norm, shared);
+    update_norm = cuda_utils::BlockReduceSum(update_norm, shared);
+    if (threadIdx.x == 0) {
+      const int tensor = tl.start_tensor_this_launch + tensor_loc;
+      gpuAtomicAdd(&param_norms[tensor], static_cast<float>(param_norm));
+      gpuAtomicAdd(&update_norms[tensor], static_cast<float>(update_norm));
+    }
+  }
+};
+
+// lists: params, updates, [model_params]
+template<typename param_t, typename grad_t, int depth, bool master>
+struct FusedLambApplyFunctor {
+  using opmath_t = typename get_opmath_t<param_t>::opmath_t;
+  __device__ __forceinline__ void operator() (
+      int chunk_size,
+      TensorListMetadata<depth>& tl,
+      opmath_t lr,
+      const float* param_norms,
+      const float* update_norms,
+      const float* found_inf) {
+    if (skip_step(found_inf)) {
+      return;
+    }
+    int tensor_loc = tl.block_to_tensor[blockIdx.x];
+    int chunk_idx = tl.block_to_chunk[blockIdx.x];
+    int n = tl.numel_for_tensor[tensor_loc] - chunk_idx * chunk_size;
+
+    param_t* param = chunk_address<param_t>(tl.addresses[0][tensor_loc], chunk_idx, chunk_size);
+    const param_t* update = chunk_address<param_t>(tl.addresses[1][tensor_loc], chunk_idx, chunk_size);
+    grad_t* model_param = master ? chunk_address<grad_t>(tl.addresses[depth - 1][tensor_loc], chunk_idx, chunk_size) : nullptr;
+
+    const int tensor = tl.start_tensor_this_launch + tensor_loc;
+    const opmath_t param_norm = ::sqrt(static_cast<opmath_t>(param_norms[tensor]));
+    const opmath_t update_norm = ::sqrt(static_cast<opmath_t>(update_norms[tensor]));
+    const opmath_t trust_ratio = (param_norm > 0 && update_norm > 0) ? param_norm / update_norm : opmath_t(1);
+    const opmath_t step_size = lr * trust_ratio;
+
+    for (int i = threadIdx.x; i < n && i < chunk_size; i += blockDim.x) {
+      const opmath_t p = static_cast<opmath_t>(param[i]) - step_size * static_cast<opmath_t>(update[i]);
+      param[i] = static_cast<param_t>(p);
+      if (master) {
+        model_param[i] = static_cast<grad_t>(p);
+      }
+    }
+  }
+};
+
+template<typename param_t, typename grad_t, bool master>
+void launch_fused_lamb(
+    std::vector<std::vector<Tensor>>& tensor_lists,
+    double lr, double beta1, double beta2, double weight_decay, double eps, int64_t step,
+    const GradScalerArgs& scaler) {
+  using opmath_t = typename get_opmath_t<param_t>::opmath_t;
+  const std::vector<Tensor>& params = tensor_lists[0];
+  const int64_t num_tensors = params.size();
+  std::vector<Tensor> updates;
+  updates.reserve(num_tensors);
+  for (const Tensor& param : params) {
+    updates.push_back(at::empty_like(param));
+  }
+  // the squared norms of the params and updates
+  Tensor norms = at::zeros({2, num_tensors}, params[0].options().dtype(at::kFloat));
+  float* param_norms = norms.data_ptr<float>();
+  float* update_norms = param_norms + num_tensors;
+
+  AdamHyperParams<opmath_t> hp;
+  hp.lr = lr;
+  hp.beta1 = beta1;
+  hp.beta2 = beta2;
+  hp.weight_decay = weight_decay;
+  hp.eps = eps;
+  hp.step_size = 1 / (1 - std::pow(beta1, step));
+  hp.sqrt_bias_correction2 = std::sqrt(1 - std::pow(beta2, step));
+  hp.decoupled_weight_decay = true;
+  std::vector<std::vector<Tensor>> update_lists{
+      tensor_lists[0], tensor_lists[1], tensor_lists[2], tensor_lists[3], updates};
+  multi_tensor_apply<5>(update_lists,
+                        FusedLambUpdateFunctor<param_t, grad_t>(),
+                        hp,
+                        param_norms,
+                        update_norms,
+                        scaler.inv_grad_scale,
+                        scaler.found_inf);
+
+  std::vector<std::vector<Tensor>> apply_lists{tensor_lists[0], std::move(updates)};
+  if (master) {
+    apply_lists.push_back(tensor_lists.back());
+  }
+  multi_tensor_apply<2 + master>(apply_lists,
+                                 FusedLambApplyFunctor<param_t, grad_t, 2 + master, master>(),
+                                 static_cast<opmath_t>(lr),
+                                 static_cast<const float*>(param_norms),
+                                 static_cast<const float*>(update_norms),
+                                 scaler.found_inf);
+}
+
+// Calls launch(param_t(), grad_t(), master) for the dtypes of the lists
+template<typename F>
+void dispatch_fused_optimizer(const char* name, TensorList params, TensorList model_params, F launch) {
+  if (!model_params.empty()) {
+    if (model_params[0].scalar_type() == at::ScalarType::Half) {
+      launch(float(), at::Half(), std::true_type());
+    } else {
+      launch(float(), at::BFloat16(), std::true_type());
+    }
+    return;
+  }
+  switch (params[0].scalar_type()) {
+    case at::ScalarType::Double:
+      launch(double(), double(), std::false_type());
+      break;
+    case at::ScalarType::Float:
+      launch(float(), float(), std::false_type());
+      break;
+    case at::ScalarType::Half:
+      launch(at::Half(), at::Half(), std::false_type());
+      break;
+    case at::ScalarType::BFloat16:
+      launch(at::BFloat16(), at::BFloat16(), std::false_type());
+      break;
+    default:
+      TORCH_CHECK(false, name, " not implemented for '", toString(params[0].scalar_type()), "'");
+  }
+}
+
+} // anonymous namespace
+
+void _fused_adam_cuda_(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    TensorList model_params,
+    double lr,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps,
+    int64_t step,
+    bool amsgrad,
+    bool decoupled_weight_decay,
+    const c10::optional<Tensor>& inv_grad_scale,
+    const c10::optional<Tensor>& found_inf) {
+  TORCH_CHECK(step > 0, "Expected a positive step, got ", step);
+  std::vector<TensorList> states{exp_avgs, exp_avg_sqs};
+  if (amsgrad) {
+    states.push_back(max_exp_avg_sqs);
+  }
+  auto tensor_lists = fused_optimizer_tensor_lists(params, grads, states, model_params);
+  const GradScalerArgs scaler = grad_scaler_args(inv_grad_scale, found_inf);
+
+  const OptionalDeviceGuard device_guard(device_of(params[0]));
+  dispatch_fused_optimizer("_fused_adam_cuda_", params, model_params, [&](auto param, auto grad, auto master) {
+    launch_fused_adam<decltype(param), decltype(grad), decltype(master)::value>(
+        tensor_lists, lr, beta1, beta2, weight_decay, eps, step, amsgrad, decoupled_weight_decay, scaler);
+  });
+}
+
+void _fused_sgd_cuda_(
+    TensorList params,
+    TensorList grads,
+    TensorList momentum_buffers,
+    TensorList model_params,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov,
+    bool first_step,
+    const c10::optional<Tensor>& inv_grad_scale,
+    const c10::optional<Tensor>& found_inf) {
+  TORCH_CHECK(!nesterov || (momentum > 0 && dampening == 0),
+              "Nesterov momentum requires a momentum and zero dampening");
+  std::vector<TensorList> states;
+  if (momentum != 0) {
+    states.push_back(momentum_buffers);
+  }
+  auto tensor_lists = fused_optimizer_tensor_lists(params, grads, states, model_params);
+  const GradScalerArgs scaler = grad_scaler_args(inv_grad_scale, found_inf);
+
+  const OptionalDeviceGuard device_guard(device_of(params[0]));
+  dispatch_fused_optimizer("_fused_sgd_cuda_", params, model_params, [&](auto param, auto grad, auto master) {
+    launch_fused_sgd<decltype(param), decltype(grad), decltype(master)::value>(
+        tensor_lists, lr, momentum, dampening, weight_decay, nesterov, first_step, scaler);
+  });
+}
+
+void _fused_lamb_cuda_(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList model_params,
+    double lr,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps,
+    int64_t step,
+    const c10::optional<Tensor>& inv_grad_scale,
+    const c10::optional<Tensor>& found_inf) {
+  TORCH_CHECK(step > 0, "Expected a positive step, got ", step);
+  auto tensor_lists = fused_optimizer_tensor_lists(params, grads, {exp_avgs, exp_avg_sqs}, model_params);
+  const GradScalerArgs scaler = grad_scaler_args(inv_grad_scale, found_inf);
+
+  const OptionalDeviceGuard device_guard(device_of(params[0]));
+  dispatch_fused_optimizer("_fused_lamb_cuda_", params, model_params, [&](auto param, auto grad, auto master) {
+    launch_fused_lamb<decltype(param), decltype(grad), decltype(master)::value>(
+        tensor_lists, lr, beta1, beta2, weight_decay, eps, step, scaler);
+  });
+}
+
+}} // namespace at::native
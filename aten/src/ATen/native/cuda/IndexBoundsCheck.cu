@@ -0,0 +1,89 @@
+#include <ATen/native/cuda/IndexBoundsCheck.cuh>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cuda/Loops.cuh>
+#include <c10/util/Exception.h>
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+namespace at { namespace native {
+
+// See Note [Lazy index bounds checks]
+namespace {
+
+// The host pointer of the IndexError, null until a kernel may record to it
+std::atomic<IndexError*> index_error_host{nullptr};
+IndexError* index_error_device = nullptr;
+std::once_flag index_error_init;
+
+void initIndexErrorBuffer() {
+  void* host_ptr = nullptr;
+  // Mapped and portable, so that the kernels of every device can write to it
+  AT_CUDA_CHECK(cudaHostAlloc(
+      &host_ptr, sizeof(IndexError), cudaHostAllocMapped | cudaHostAllocPortable));
+  std::memset(host_ptr, 0, sizeof(IndexError));
+  void* device_ptr = nullptr;
+  AT_CUDA_CHECK(cudaHostGetDevicePointer(&device_ptr, host_ptr, 0));
+  index_error_device = static_cast<IndexError*>(device_ptr);
+  index_error_host.store(static_cast<IndexError*>(host_ptr), std::memory_order_release);
+}
+
+} // namespace
+
+IndexError* getIndexErrorBuffer() {
+  std::call_once(index_error_init, initIndexErrorBuffer);
+  return index_error_device;
+}
+
+void throwPendingIndexError() {
+  IndexError* error = index_error_host.load(std::memory_order_acquire);
+  if (error == nullptr ||
+      *static_cast<volatile int*>(&error->reported) == 0) {
+    return;
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const int64_t index = *static_cast<volatile int64_t*>(&error->index);
+  const int64_t dim = *static_cast<volatile int64_t*>(&error->dim);
+  const int64_t dim_size = *static_cast<volatile int64_t*>(&error->dim_size);
+  *static_cast<volatile int*>(&error->reported) = 0;
+  std::atomic_thread_fence(std::memory_order_release);
+  *static_cast<volatile int*>(&error->claimed) = 0;
+  TORCH_CHECK_INDEX(false, "index ", index, " is out of bounds for dimension ", dim,
+      " with size ", dim_size, " (found by an indexing op launched before this call)");
+}
+
+Tensor wrapIndexAsync(
+    const Tensor& index,
+    int64_t dim,
+    int64_t dim_size,
+    bool check_range,
+    int64_t invalid_index) {
+  TORCH_INTERNAL_ASSERT(index.is_cuda() && index.scalar_type() == kLong);
+  // Raise the errors of the previous ops first, as the host checks would have
+  throwPendingIndexError();
+  Tensor wrapped = at::empty_like(index, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  if (index.numel() == 0) {
+    return wrapped;
+  }
+  auto iter = TensorIterator::unary_op(wrapped, index);
+  if (check_range) {
+    IndexError* error = getIndexErrorBuffer();
+    gpu_kernel(iter, [=] GPU_LAMBDA (int64_t i) -> int64_t {
+      if (i < -dim_size || i >= dim_size) {
+        recordIndexError(error, i, dim, dim_size);
+        return invalid_index;
+      }
+      return i < 0 ? i + dim_size : i;
+    });
+  } else {
+    gpu_kernel(iter, [=] GPU_LAMBDA (int64_t i) -> int64_t {
+      return i < 0 ? i + dim_size : i;
+    });
+  }
+  return wrapped;
+}
+
+}} // namespace at::native
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <c10/macros/Export.h>
+
+#include <cstdint>
+
+namespace at { namespace native {
+
+// Note [Lazy index bounds checks]
+// Checking that the indices of an indexing op are in bounds on the host takes
+// a copy of their min and max to the host, which waits for the kernels queued
+// before it to finish. Instead, the kernels check the indices they read, skip
+// the ones out of bounds, and record the first of them in an IndexError in
+// mapped host memory. The host reads it without synchronizing, at the next
+// point where it waits for the device anyway (item(), a copy to the host,
+// torch.cuda.synchronize()) and before the next indexing op, and throws the
+// IndexError the op would have thrown. The error is thus raised by a later
+// call than the op with the bad index. As the elements with a bad index are
+// skipped, the op leaves them unmodified, like when it threw right away.
+//
+// There is a single IndexError for the process, which the kernels of all
+// devices record to. The error is therefore thrown by the next call that
+// checks it, on any thread, and not necessarily by a call on the thread or
+// device of the op with the bad index.
+//
+// When at::globalContext().trustedIndices() is set, the indices of indexing
+// ops are assumed to be in bounds, and aren't checked before being used.
+
+// The first out of bounds index seen by the kernels since the last
+// throwPendingIndexError()
+struct IndexError {
+  int claimed;
+  int reported;
+  int64_t index;
+  int64_t dim;
+  int64_t dim_size;
+};
+
+// The device pointer of the IndexError the kernels record errors to
+TORCH_CUDA_CU_API IndexError* getIndexErrorBuffer();
+
+// Throws the IndexError recorded by the kernels which have finished, if any,
+// and clears it
+TORCH_CUDA_CU_API void throwPendingIndexError();
+
+// Wraps the negative elements of a CUDA index of dim dim_size to positive
+// ones. When check_range is set, the elements out of bounds are recorded and
+// replaced with invalid_index, which the caller must skip, so that an op with
+// a bad index doesn't modify anything.
+TORCH_CUDA_CU_API Tensor wrapIndexAsync(
+    const Tensor& index,
+    int64_t dim,
+    int64_t dim_size,
+    bool check_range,
+    int64_t invalid_index);
+
+#ifdef __CUDACC__
+__device__ __forceinline__ void recordIndexError(
+    IndexError* error,
+    int64_t index,
+    int64_t dim,
+    int64_t dim_size) {
+  if (atomicCAS(&error->claimed, 0, 1) == 0) {
+    error->index = index;
+    error->dim = dim;
+    error->dim_size = dim_size;
+    // The host reads the fields once it sees reported
+    __threadfence_system();
+    *static_cast<volatile int*>(&error->reported) = 1;
+  }
+}
+#endif
+
+}} // namespace at::native
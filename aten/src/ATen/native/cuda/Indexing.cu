@@ -9,6 +9,7 @@
 #include <ATen/AccumulateType.h>
 #include <ATen/cuda/detail/IndexUtils.cuh>
 #include <ATen/cuda/CUDAUtils.h>
+#include <ATen/native/cuda/IndexBoundsCheck.cuh>
 
 #include <THC/THCDeviceUtils.cuh>
 #include <THC/THCGeneral.h>
@@ -51,7 +52,8 @@ __global__ void indexing_backward_kernel(
   // Number of values processed by each thread (grain size)
   for (int64_t z = blockIdx.z; z < outer_dim; z += gridDim.z){
     int64_t idx = blockIdx.x * blockDim.y + threadIdx.y;
-    if (idx < numel
+    // negative indices are the ones out of bounds, see Note [Lazy index bounds checks]
+    if (idx < numel && sorted_indices[idx] >= 0
         && (idx == 0 || sorted_indices[idx] != sorted_indices[idx - 1])){
       do {
         int64_t start_feature = threadIdx.x + blockIdx.y * blockDim.x * SZ;
@@ -99,8 +101,13 @@ __global__ void indexing_backward_kernel(
 
 namespace at { namespace native {
 
-static Tensor wrapIndexOnce(const Tensor & index, int64_t dim, int64_t dim_size, bool check_range=true) {
+// The elements of a CUDA index out of bounds are replaced with invalid_index
+static Tensor wrapIndexOnce(const Tensor & index, int64_t dim, int64_t dim_size, bool check_range, int64_t invalid_index) {
 //we don't need to check range in backward - if there were out of bounds indices forward should already have errored out
+  if (index.is_cuda()) {
+    // Checking on the host would wait for the index, see Note [Lazy index bounds checks]
+    return wrapIndexAsync(index, dim, dim_size, check_range && !globalContext().trustedIndices(), invalid_index);
+  }
   if (index.numel() != 0 && check_range) {
     auto max_idx = index.max().item<int64_t>();
     auto min_idx = index.min().item<int64_t>();
@@ -138,7 +145,10 @@ computeLinearIndex(const Tensor & src, TensorList indices, bool check_range) {
     if (indices[i].defined()) {
       // Cast index to the longType matching src's backend
       // This allows us to support ie indexing a cuda tensor with a cpu tensor
-      Tensor index = (wrapIndexOnce(indices[i], i, src.size(i), check_range) * strides[i]).toBackend(backend);
+      // An invalid index makes the linear index negative whatever the other
+      // ones are, as they add less than src.numel() to it
+      const int64_t invalid_index = strides[i] > 0 ? -(src.numel() / strides[i]) - 1 : -1;
+      Tensor index = (wrapIndexOnce(indices[i], i, src.size(i), check_range, invalid_index) * strides[i]).toBackend(backend);
       if (linearIndex.defined()) {
         linearIndex += index;
       } else {
@@ -314,7 +324,9 @@ __global__ void indexAddSmallIndex(cuda::detail::TensorInfo<T, IndexType> dst,
                                    int dstAddDim,
                                    int srcAddDim,
                                    IndexType innerSize,
-                                   int64_t dstAddDimSize) {
+                                   int64_t dstAddDimSize,
+                                   IndexError* indexError,
+                                   int64_t indexDim) {
   // In order to avoid reloading the index that we are copying, load
   // it once to handle all of the points that are being selected, so
   // it can be reused as much as possible. This kernel is chosen when
@@ -322,9 +334,14 @@ __global__ void indexAddSmallIndex(cuda::detail::TensorInfo<T, IndexType> dst,
   // re-accessing indices in addition to src elements can be slow.
   for (IndexType srcIndex = 0; srcIndex < indices.sizes[0]; ++srcIndex) {
     // Lua indices begin at 1
-    IndexType dstIndex =
+    IndicesType index =
         indices.data[cuda::detail::IndexToOffset<IndicesType, IndexType, IdxDim>::get(srcIndex, indices)];
-    CUDA_KERNEL_ASSERT(dstIndex < dstAddDimSize);
+    IndexType dstIndex = index;
+    if (dstIndex >= dstAddDimSize) {
+      // See Note [Lazy index bounds checks]
+      recordIndexError(indexError, index, indexDim, dstAddDimSize);
+      continue;
+    }
 
     // We stride over the output ignoring the indexed dimension
     // (innerSize), whose offset calculation is handled differently
@@ -359,7 +376,9 @@ __global__ void indexAddLargeIndex(cuda::detail::TensorInfo<T, IndexType> dst,
                                    int srcAddDim,
                                    IndexType totalSize,
                                    IndexType innerSize,
-                                   int64_t dstAddDimSize) {
+                                   int64_t dstAddDimSize,
+                                   IndexError* indexError,
+                                   int64_t indexDim) {
   // We stride over the output including the indexed dimension
   // (totalSize), and calculate the destination index point based on that
   for (IndexType linearIndex = blockIdx.x * blockDim.x + threadIdx.x;
@@ -376,9 +395,14 @@ __global__ void indexAddLargeIndex(cuda::detail::TensorInfo<T, IndexType> dst,
     }
 
     // Lua indices begin at 1
-    IndexType dstIndex =
+    IndicesType index =
         indices.data[cuda::detail::IndexToOffset<IndicesType, IndexType, IdxDim>::get(srcIndex, indices)];
-    CUDA_KERNEL_ASSERT(dstIndex < dstAddDimSize);
+    IndexType dstIndex = index;
+    if (dstIndex >= dstAddDimSize) {
+      // See Note [Lazy index bounds checks]
+      recordIndexError(indexError, index, indexDim, dstAddDimSize);
+      continue;
+    }
 
     IndexType dstOffset =
       cuda::detail::IndexToOffset<T, IndexType, DstDim>::get(elementInSlice, dst);
@@ -474,6 +498,8 @@ Tensor& index_add_cuda_(Tensor & self, int64_t dim, const Tensor & index, const
   if (sliceSize == 0) {
     return self;
   }
+  throwPendingIndexError();
+  IndexError* indexError = getIndexErrorBuffer();
   const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
   bool indContig = index.is_contiguous();
 
@@ -483,7 +509,8 @@ Tensor& index_add_cuda_(Tensor & self, int64_t dim, const Tensor & index, const
   indexAddSmallIndex<TENSOR_TYPE, INDICES_TYPE, TYPE, SELF_DIM, SOURCE_DIM, IDX_DIM> \
     <<<smallIndexGrid, smallIndexBlock, 0, stream>>>(                                \
       selfInfo, sourceInfo, indexInfo,                                               \
-      selfAddDim, sourceAddDim, sliceSize, selfAddDimSize);                          \
+      selfAddDim, sourceAddDim, sliceSize, selfAddDimSize,                           \
+      indexError, dim);                                                              \
   C10_CUDA_KERNEL_LAUNCH_CHECK();
 
 #define LARGE_INDEX(TENSOR_TYPE, INDICES_TYPE, TYPE,                        \
@@ -494,7 +521,7 @@ Tensor& index_add_cuda_(Tensor & self, int64_t dim, const Tensor & index, const
       selfInfo, sourceInfo, indexInfo,                                      \
       selfAddDim, sourceAddDim, sourceTotalSize,                            \
       (IDX_IS_MAJOR) ? sliceSize : numIndex,                                \
-      selfAddDimSize);                                                      \
+      selfAddDimSize, indexError, dim);                                     \
   C10_CUDA_KERNEL_LAUNCH_CHECK();
 
   dim3 smallIndexGrid(std::min(THCCeilDiv(sliceSize, (ptrdiff_t)128), (ptrdiff_t)(mpc * 8)));
@@ -597,16 +624,23 @@ __global__ void indexSelectSmallIndex(cuda::detail::TensorInfo<T, IndexType> dst
                                       int dstSelectDim,
                                       int srcSelectDim,
                                       IndexType innerSize,
-                                      int64_t srcSelectDimSize) {
+                                      int64_t srcSelectDimSize,
+                                      IndexError* indexError,
+                                      int64_t indexDim) {
   // In order to avoid reloading the index that we are copying, load
   // it once to handle all of the points that are being selected, so
   // it can be reused as much as possible. This kernel is chosen when
   // this is a good choice (small number of chosen indices), since
   // re-accessing indices in addition to src elements can be slow.
   for (IndexType dstIndex = 0; dstIndex < indices.sizes[0]; ++dstIndex) {
-    IndexType srcIndex =
+    IndicesType index =
       indices.data[cuda::detail::IndexToOffset<IndicesType, IndexType, IdxDim>::get(dstIndex, indices)];
-    CUDA_KERNEL_ASSERT(srcIndex < srcSelectDimSize);
+    IndexType srcIndex = index;
+    if (srcIndex >= srcSelectDimSize) {
+      // See Note [Lazy index bounds checks]
+      recordIndexError(indexError, index, indexDim, srcSelectDimSize);
+      continue;
+    }
 
     // We stride over the output ignoring the indexed dimension
     // (innerSize), whose offset calculation is handled differently
@@ -641,7 +675,9 @@ __global__ void indexSelectLargeIndex(cuda::detail::TensorInfo<T, IndexType> dst
                                       int srcSelectDim,
                                       IndexType totalSize,
                                       IndexType innerSize,
-                                      int64_t srcSelectDimSize) {
+                                      int64_t srcSelectDimSize,
+                                      IndexError* indexError,
+                                      int64_t indexDim) {
   // We stride over the output including the indexed dimension
   // (totalSize), and calculate the destination index point based on that
   for (IndexType linearIndex = blockIdx.x * blockDim.x + threadIdx.x;
@@ -657,9 +693,14 @@ __global__ void indexSelectLargeIndex(cuda::detail::TensorInfo<T, IndexType> dst
       dstIndex = linearIndex % innerSize;
     }
 
-    IndexType srcIndex =
+    IndicesType index =
       indices.data[cuda::detail::IndexToOffset<IndicesType, IndexType, IdxDim>::get(dstIndex, indices)];
-    CUDA_KERNEL_ASSERT(srcIndex < srcSelectDimSize);
+    IndexType srcIndex = index;
+    if (srcIndex >= srcSelectDimSize) {
+      // See Note [Lazy index bounds checks]
+      recordIndexError(indexError, index, indexDim, srcSelectDimSize);
+      continue;
+    }
 
     IndexType dstOffset =
       cuda::detail::IndexToOffset<T, IndexType, DstDim>::get(elementInSlice, dst);
@@ -713,6 +754,8 @@ void index_select_out_cuda_impl(Tensor& out, const Tensor& self, long dim,
   if (outTotalSize == 0) {
     return;
   }
+  throwPendingIndexError();
+  IndexError* indexError = getIndexErrorBuffer();
 
   bool indContig = index.is_contiguous();
 
@@ -731,7 +774,7 @@ void index_select_out_cuda_impl(Tensor& out, const Tensor& self, long dim,
     <<<smallIndexGrid, smallIndexBlock, 0, stream>>>(                                   \
       outInfo, selfInfo, indicesInfo,                                                   \
       outSelectDim, selfSelectDim, static_cast<TYPE>(sliceSize),                        \
-      selfSelectDimSize);                                                               \
+      selfSelectDimSize, indexError, dim);                                              \
   C10_CUDA_KERNEL_LAUNCH_CHECK();
 
 #define LARGE_INDEX(TENSOR_TYPE, INDICES_TYPE, TYPE,                           \
@@ -742,7 +785,7 @@ void index_select_out_cuda_impl(Tensor& out, const Tensor& self, long dim,
       outInfo, selfInfo, indicesInfo,                                          \
       outSelectDim, selfSelectDim, static_cast<TYPE>(outTotalSize),            \
       static_cast<TYPE>((IDX_IS_MAJOR) ? sliceSize : numIndices),              \
-      selfSelectDimSize);                                                      \
+      selfSelectDimSize, indexError, dim);                                     \
   C10_CUDA_KERNEL_LAUNCH_CHECK();
 
   dim3 smallIndexGrid(std::min(THCCeilDiv(sliceSize, (ptrdiff_t)128), (ptrdiff_t)(mpc * 8)));
@@ -935,5 +978,67 @@ Tensor nonzero_cuda(const Tensor& self){
 }
 
 
+// See Note [Static size indexing]
+template<typename scalar_t>
+void nonzero_static_cuda_impl(const Tensor& self, int64_t max_size, Tensor& indices, Tensor& count){
+  Tensor self_ = self.contiguous();
+  int N = self_.numel();
+  const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  auto& allocator = *c10::cuda::CUDACachingAllocator::get();
+  // The linear indices of all the nonzero elements, of which the first
+  // max_size are kept
+  Tensor flat_indices = at::empty({N}, self.options().dtype(kLong));
+  Tensor num_nonzeros = at::empty({}, self.options().dtype(kInt));
+  cub::TransformInputIterator<bool, NonZeroOp<scalar_t>, scalar_t*> itr(self_.data_ptr<scalar_t>(), NonZeroOp<scalar_t>());
+  cub::CountingInputIterator<int64_t> counting_itr(0);
+  size_t temp_storage_bytes = 0;
+  cub::DeviceSelect::Flagged(nullptr, temp_storage_bytes, counting_itr, itr,
+    flat_indices.data_ptr<int64_t>(), num_nonzeros.data_ptr<int>(), N, stream);
+  auto temp_storage = allocator.allocate(temp_storage_bytes);
+  cub::DeviceSelect::Flagged(temp_storage.get(), temp_storage_bytes, counting_itr, itr,
+    flat_indices.data_ptr<int64_t>(), num_nonzeros.data_ptr<int>(), N, stream);
+  count = num_nonzeros.to(kLong);
+
+  const int64_t kept = std::min<int64_t>(N, max_size);
+  Tensor linear_indices = at::empty({max_size}, flat_indices.options());
+  linear_indices.narrow(0, 0, kept).copy_(flat_indices.narrow(0, 0, kept));
+  linear_indices.masked_fill_(at::arange(max_size, count.options()).ge(count), 0);
+
+  // Same transposed layout as the output of nonzero
+  Tensor out_temp = at::empty({self.dim(), max_size}, flat_indices.options());
+  if (max_size > 0) {
+    int64_t div = 1;
+    auto thrust_allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
+    for (int dim = self.dim()-1; dim >= 0; dim--){
+      int64_t dim_size = self.sizes()[dim];
+      thrust::transform(
+        thrust::cuda::par(thrust_allocator).on(stream),
+        thrust::device_ptr<int64_t>(linear_indices.data_ptr<int64_t>()),
+        thrust::device_ptr<int64_t>(linear_indices.data_ptr<int64_t>()) + max_size,
+        thrust::device_ptr<int64_t>(out_temp.data_ptr<int64_t>()) + max_size * dim,
+        [=] C10_HOST_DEVICE (const int64_t val) {return (val/div) % dim_size;}
+      );
+      div *= dim_size;
+    }
+  }
+  indices = out_temp.t();
+}
+
+std::tuple<Tensor, Tensor> nonzero_static_cuda(const Tensor& self, int64_t max_size){
+  TORCH_CHECK(self.numel() < std::numeric_limits<int>::max(), "nonzero_static is not supported for tensors with more than INT_MAX elements, \
+  file a support request");
+  TORCH_CHECK(max_size >= 0, "nonzero_static: max_size must be non-negative, but got ", max_size);
+  if (self.numel() == 0) {
+    return std::make_tuple(
+      at::zeros({max_size, self.dim()}, self.options().dtype(kLong)),
+      at::zeros({}, self.options().dtype(kLong)));
+  }
+  Tensor indices, count;
+  AT_DISPATCH_ALL_TYPES_AND3(at::ScalarType::Bool, at::ScalarType::BFloat16, at::ScalarType::Half,
+    self.scalar_type(), "nonzero_static_cuda",
+    [&] {nonzero_static_cuda_impl<scalar_t>(self, max_size, indices, count);});
+  return std::make_tuple(indices, count);
+}
+
 } // native
 } // at
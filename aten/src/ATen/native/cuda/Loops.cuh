@@ -14,6 +14,7 @@ constexpr int block_work_size = BLOCK_WORK_SIZE;
 #include <ATen/native/TensorIteratorDynamicCasting.h>
 #include <ATen/cuda/detail/OffsetCalculator.cuh>
 #include <ATen/native/cuda/MemoryAccess.cuh>
+#include <c10/util/OverheadProbe.h>
 
 #include <thrust/tuple.h>
 
@@ -186,6 +187,7 @@ __global__ void unrolled_elementwise_kernel_for_multi_outputs(int N, func_t f, a
 
 template <int num_outputs, typename func_t, typename array_t, typename inp_calc_t, typename out_calc_t>
 static inline void launch_unrolled_kernel_for_multi_outputs(int64_t N, const func_t& f, array_t data, inp_calc_t ic, out_calc_t oc) {
+  C10_OVERHEAD_PROBE(KERNEL_LAUNCH);
   TORCH_INTERNAL_ASSERT(N > 0 && N <= std::numeric_limits<int32_t>::max());
   int64_t grid = (N + block_work_size - 1) / block_work_size;
   auto stream = at::cuda::getCurrentCUDAStream();
@@ -16,6 +16,9 @@
 
 namespace at { namespace native { namespace memory {
 
+template<typename scalar_t, int vec_size>
+struct aligned_vector;
+
 namespace detail {
 
 // What does the `static_unroll` do?
@@ -76,6 +79,77 @@ struct unroll_load_helper {
   }
 };
 
+template<int arg_index>
+struct inner_vectorized_load_helper {
+  template <typename policy_t, typename args_t, typename offset_t>
+  static __device__ void apply(policy_t &self, args_t *args, offset_t offsets, uint32_t inner) {
+    using arg_t = std::tuple_element_t<arg_index, args_t>;
+    using vec_t = aligned_vector<arg_t, policy_t::width>;
+    // `data` hold the data_ptr for tensors [output, input0, input1, ...], so we
+    // need a +1 offset to get the input
+    arg_t *ptr = reinterpret_cast<arg_t *>(self.data[arg_index + 1]) + offsets[arg_index + 1];
+    if (self.broadcast_mask & (1u << arg_index)) {
+      arg_t value = *ptr;
+      #pragma unroll
+      for (int j = 0; j < policy_t::width; j++) {
+        std::get<arg_index>(args[j]) = value;
+      }
+    } else {
+      vec_t v = *reinterpret_cast<vec_t *>(ptr + inner);
+      #pragma unroll
+      for (int j = 0; j < policy_t::width; j++) {
+        std::get<arg_index>(args[j]) = v.val[j];
+      }
+    }
+  }
+};
+
+template<int arg_index>
+struct tile_load_helper {
+  // stages the tile of a transposed input in shared memory, reading along
+  // dim 1, in which it is contiguous
+  template <typename args_t, typename policy_t>
+  static __device__ void stage(policy_t &self) {
+    using arg_t = std::tuple_element_t<arg_index, args_t>;
+    if (!(self.transposed_mask & (1u << arg_index))) {
+      return;
+    }
+    arg_t *tile = self.template shared_tile<arg_t, arg_index>();
+    const arg_t *ptr = reinterpret_cast<arg_t *>(self.data[arg_index + 1]) + self.base[arg_index + 1];
+    for (int k = threadIdx.x; k < policy_t::tile_size; k += num_threads) {
+      const int d0 = k / policy_t::tile_rows;
+      const int d1 = k % policy_t::tile_rows;
+      if (self.d0_begin + d0 < self.size0 && self.d1_begin + d1 < self.size1) {
+        tile[d0 * (policy_t::tile_rows + 1) + d1] =
+            ptr[(self.d0_begin + d0) * self.strides0[arg_index + 1] + (self.d1_begin + d1) * self.strides1[arg_index + 1]];
+      }
+    }
+  }
+
+  template <typename args_t, typename policy_t>
+  static __device__ void apply(policy_t &self, args_t *args, int i) {
+    using arg_t = std::tuple_element_t<arg_index, args_t>;
+    const int d0 = threadIdx.x % policy_t::tile_dim;
+    const int d1 = threadIdx.x / policy_t::tile_dim + i * policy_t::rows_per_pass;
+    if (self.transposed_mask & (1u << arg_index)) {
+      std::get<arg_index>(args[i]) =
+          self.template shared_tile<arg_t, arg_index>()[d0 * (policy_t::tile_rows + 1) + d1];
+    } else {
+      const arg_t *ptr = reinterpret_cast<arg_t *>(self.data[arg_index + 1]) + self.base[arg_index + 1];
+      std::get<arg_index>(args[i]) =
+          ptr[(self.d0_begin + d0) * self.strides0[arg_index + 1] + (self.d1_begin + d1) * self.strides1[arg_index + 1]];
+    }
+  }
+};
+
+template<int arg_index>
+struct tile_stage_helper {
+  template <typename args_t, typename policy_t>
+  static __device__ void apply(policy_t &self, args_t *args) {
+    tile_load_helper<arg_index>::template stage<args_t>(self);
+  }
+};
+
 template <int current>
 struct multi_outputs_store_helper {
   template<int ntensors, int num_outputs, typename ...Args>
@@ -259,6 +333,160 @@ struct vectorized {
   }
 };
 
+// Assumption:
+// the innermost dimension (dim 0) of the output is contiguous, and that of
+// each input is either contiguous or broadcast (stride 0, flagged in
+// broadcast_mask); the size of dim 0 and the strides of the contiguous
+// tensors in the other dimensions are multiples of vec_size, and their data
+// pointers are aligned to it.
+// Note:
+// Each thread handles thread_work_size / vec_size vectors of dim 0, and the
+// offsets of the row of a vector are computed once by outer_calc, instead of
+// for every element as the unroll policy does.
+template <int vec_size, typename data_t, typename outer_calc_t>
+struct inner_vectorized {
+
+  static_assert(thread_work_size % vec_size == 0, "The workload per thread must be a multiple of vec_size");
+  static constexpr int width = vec_size;
+  static constexpr int loop_size = thread_work_size / vec_size;
+  static constexpr int block_vecs = num_threads * loop_size;
+
+  data_t data;
+  int num_vecs;
+  IntDivider<uint32_t> row_divider;
+  outer_calc_t outer_calc;
+  uint32_t broadcast_mask;
+  uint32_t output_offsets[loop_size];
+
+  __device__ inner_vectorized(data_t data, int num_vecs, IntDivider<uint32_t> row_divider,
+                              outer_calc_t outer_calc, uint32_t broadcast_mask):
+    data(data), num_vecs(num_vecs), row_divider(row_divider), outer_calc(outer_calc), broadcast_mask(broadcast_mask) {}
+
+  __device__ inline int vec_index(int idx, int i) {
+    return block_vecs * idx + threadIdx.x + i * num_threads;
+  }
+
+  __device__ inline bool check_inbounds(int thread_work_elem) {
+    return vec_index(blockIdx.x, thread_work_elem / vec_size) < num_vecs;
+  }
+
+  template<typename args_t>
+  __device__ inline void load(args_t *args, int idx) {
+    constexpr int arity = std::tuple_size<args_t>::value;
+    #pragma unroll
+    for (int i = 0; i < loop_size; i++) {
+      const int vec_idx = vec_index(idx, i);
+      if (vec_idx >= num_vecs) {
+        return;
+      }
+      auto divmod = row_divider.divmod(vec_idx);
+      auto offsets = outer_calc.get(divmod.div);
+      const uint32_t inner = divmod.mod * vec_size;
+      output_offsets[i] = offsets[0] + inner;
+      detail::static_unroll<detail::inner_vectorized_load_helper, arity>::with_args(*this, args + vec_size * i, offsets, inner);
+    }
+  }
+
+  template<typename scalar_t>
+  __device__ inline void store(scalar_t *from, int idx) {
+    using vec_t = aligned_vector<scalar_t, vec_size>;
+    #pragma unroll
+    for (int i = 0; i < loop_size; i++) {
+      if (vec_index(idx, i) >= num_vecs) {
+        return;
+      }
+      vec_t v;
+      #pragma unroll
+      for (int j = 0; j < vec_size; j++) {
+        v.val[j] = from[vec_size * i + j];
+      }
+      *reinterpret_cast<vec_t *>(reinterpret_cast<scalar_t *>(data[0]) + output_offsets[i]) = v;
+    }
+  }
+};
+
+// Assumption:
+// the output is contiguous in dim 0, and the inputs flagged in
+// transposed_mask are contiguous in dim 1.
+// Note:
+// A block handles a tile_dim x tile_rows tile of dims 0 and 1 at one index of
+// the outer dimensions, with thread_work_size rows per thread. The transposed
+// inputs are staged in shared memory, so that both their loads and the
+// stores of the output are coalesced.
+template <typename data_t, typename outer_calc_t, int ntensors>
+struct transposed_tile {
+
+  static constexpr int tile_dim = 16;
+  static_assert(num_threads % tile_dim == 0, "The block size must be a multiple of tile_dim");
+  static constexpr int rows_per_pass = num_threads / tile_dim;
+  static constexpr int tile_rows = rows_per_pass * thread_work_size;
+  static constexpr int tile_size = tile_dim * tile_rows;
+
+  using stride_t = at::detail::Array<uint32_t, ntensors>;
+
+  data_t data;
+  int size0;
+  int size1;
+  int tiles0;
+  int tiles1;
+  stride_t strides0;
+  stride_t strides1;
+  outer_calc_t outer_calc;
+  uint32_t transposed_mask;
+  typename outer_calc_t::offset_type base;
+  int d0_begin;
+  int d1_begin;
+
+  __device__ transposed_tile(data_t data, int size0, int size1, stride_t strides0, stride_t strides1,
+                             outer_calc_t outer_calc, uint32_t transposed_mask):
+    data(data), size0(size0), size1(size1),
+    tiles0((size0 + tile_dim - 1) / tile_dim), tiles1((size1 + tile_rows - 1) / tile_rows),
+    strides0(strides0), strides1(strides1), outer_calc(outer_calc), transposed_mask(transposed_mask) {}
+
+  // one tile per input, padded to avoid bank conflicts
+  template <typename arg_t, int arg_index>
+  __device__ inline arg_t *shared_tile() {
+    __shared__ typename std::aligned_storage<sizeof(arg_t), alignof(arg_t)>::type tile[tile_dim * (tile_rows + 1)];
+    return reinterpret_cast<arg_t *>(tile);
+  }
+
+  __device__ inline bool check_inbounds(int thread_work_elem) {
+    const int d0 = threadIdx.x % tile_dim;
+    const int d1 = threadIdx.x / tile_dim + thread_work_elem * rows_per_pass;
+    return d0_begin + d0 < size0 && d1_begin + d1 < size1;
+  }
+
+  template<typename args_t>
+  __device__ inline void load(args_t *args, int idx) {
+    constexpr int arity = std::tuple_size<args_t>::value;
+    const int tile = idx % (tiles0 * tiles1);
+    base = outer_calc.get(idx / (tiles0 * tiles1));
+    d0_begin = (tile % tiles0) * tile_dim;
+    d1_begin = (tile / tiles0) * tile_rows;
+    detail::static_unroll<detail::tile_stage_helper, arity>::with_args(*this, args);
+    __syncthreads();
+    #pragma unroll
+    for (int i = 0; i < thread_work_size; i++) {
+      if (check_inbounds(i)) {
+        detail::static_unroll<detail::tile_load_helper, arity>::with_args(*this, args, i);
+      }
+    }
+  }
+
+  template<typename scalar_t>
+  __device__ inline void store(scalar_t *from, int idx) {
+    scalar_t *to = reinterpret_cast<scalar_t *>(data[0]) + base[0];
+    #pragma unroll
+    for (int i = 0; i < thread_work_size; i++) {
+      if (check_inbounds(i)) {
+        const int d0 = d0_begin + threadIdx.x % tile_dim;
+        const int d1 = d1_begin + threadIdx.x / tile_dim + i * rows_per_pass;
+        to[d0 * strides0[0] + d1 * strides1[0]] = from[i];
+      }
+    }
+  }
+};
+
 template <typename data_t, typename inp_calc_t, typename out_calc_t, int num_outputs>
 struct multi_outputs_unroll : unroll<data_t, inp_calc_t, out_calc_t, LoadWithoutCast, StoreWithoutCast, num_outputs> {
 
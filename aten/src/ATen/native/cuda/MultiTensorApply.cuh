@@ -24,9 +24,9 @@ __device__ __forceinline__ void load_store(T* dst, T* src, int dst_offset, int s
 }
 
 // TensorListMetadata has to be < 4KB - the limit for kernel launch argument
-static constexpr int depth_to_max_tensors[5] = {110, 64, 48, 36, 30};
-static constexpr int depth_to_max_blocks[5] = {320, 320, 320, 320, 320};
-static constexpr int depth_to_max_tensors_scalarlist[5] = {96, 64, 48, 36, 30};
+static constexpr int depth_to_max_tensors[6] = {110, 64, 48, 36, 30, 24};
+static constexpr int depth_to_max_blocks[6] = {320, 320, 320, 320, 320, 320};
+static constexpr int depth_to_max_tensors_scalarlist[6] = {96, 64, 48, 36, 30, 24};
 
 template<int n> struct TensorListMetadata
 {
@@ -34,6 +34,9 @@ template<int n> struct TensorListMetadata
   int numel_for_tensor[depth_to_max_tensors[n-1]];
   unsigned char block_to_tensor[depth_to_max_blocks[n-1]];
   int block_to_chunk[depth_to_max_blocks[n-1]];
+  // The index in tensor_lists of the tensor at addresses[*][0], for the
+  // functors that keep per-tensor results
+  int start_tensor_this_launch;
 };
 
 template<typename scalar_vals_t, int n> struct TensorListScalarListMetadata
@@ -124,6 +127,7 @@ void multi_tensor_apply(
         TORCH_CHECK(tensor_lists.size() == depth, "Number of tensor lists has to match the depth.");
         size_t n_tensors = tensor_lists[0].size();
         TensorListMetadata<depth> tensorListMeta;
+        tensorListMeta.start_tensor_this_launch = 0;
 
         int loc_block_info = 0;
         int loc_tensor_info = 0;
@@ -156,9 +160,11 @@ void multi_tensor_apply(
                     loc_block_info = 0;
                     if(chunk == chunks - 1) {
                         loc_tensor_info = 0;
+                        tensorListMeta.start_tensor_this_launch = t + 1;
                     }
                     else {
                         tensorListMeta.numel_for_tensor[0] = tensorListMeta.numel_for_tensor[loc_tensor_info-1];
+                        tensorListMeta.start_tensor_this_launch = t;
                         for(int d = 0; d < depth; d++) {
                             tensorListMeta.addresses[d][0] = tensorListMeta.addresses[d][loc_tensor_info-1];
                         }
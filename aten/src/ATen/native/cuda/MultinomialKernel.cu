@@ -6,8 +6,12 @@
 #include <ATen/cuda/CUDAApplyUtils.cuh>
 #include <ATen/native/cuda/LaunchUtils.h>
 #include <ATen/AccumulateType.h>
+#include <ATen/NumericUtils.h>
 #include <ATen/cuda/CUDAGraphsUtils.cuh>
+#include <ATen/native/cuda/SortingRadixSelect.cuh>
 
+#include <THC/THCAsmUtils.cuh>
+#include <THC/THCDeviceUtils.cuh>
 #include <THC/THCReduceApplyUtils.cuh>
 #include <THC/THCTensorMathReduce.cuh>
 #include <THC/THCNumerics.cuh>
@@ -16,6 +20,8 @@
 #include <curand_kernel.h>
 #include <curand_philox4x32_x.h>
 
+#include <cub/cub.cuh>
+
 namespace at { namespace native {
 
 namespace {
@@ -300,6 +306,212 @@ sampleMultinomialOnce(int64_t* dest,
   }
 }
 
+#if defined(__HIP_PLATFORM_HCC__)
+constexpr int SAMPLE_BLOCK_SIZE = 256;
+#else
+constexpr int SAMPLE_BLOCK_SIZE = 512;
+#endif
+
+// The top-p threshold is selected by digits of SAMPLE_RADIX_BITS, like
+// radixSelect does, but the digits are chosen by the probability mass of the
+// logits having them instead of by the count of these logits.
+constexpr int SAMPLE_RADIX_BITS = 4;
+constexpr int SAMPLE_RADIX_SIZE = 1 << SAMPLE_RADIX_BITS;
+
+// Samples one index of each distribution (row) of logits from the softmax of
+// the logits that are at least the top_k-th largest and the top-p threshold,
+// the smallest logit such that the logits at least it have top_p of the
+// probability mass of the top_k largest. Each block samples whole rows, with
+// a radix selection of each threshold, and a block scan of the kept
+// probabilities for the sample.
+template <typename scalar_t, typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(SAMPLE_BLOCK_SIZE)
+__global__ void sampleTopKTopP(
+    PhiloxCudaState philox_args,
+    int64_t* dest,
+    int64_t distributions,
+    int categories,
+    scalar_t* dist,
+    int64_t stride_dist,
+    int64_t stride_categories,
+    int top_k,
+    accscalar_t top_p) {
+  using bitwise_t = typename TopKTypeConfig<scalar_t>::RadixType;
+  using BlockReduce = cub::BlockReduce<accscalar_t, SAMPLE_BLOCK_SIZE>;
+  using BlockScan = cub::BlockScan<accscalar_t, SAMPLE_BLOCK_SIZE>;
+  __shared__ union {
+    typename BlockReduce::TempStorage reduce;
+    typename BlockScan::TempStorage scan;
+  } temp_storage;
+  __shared__ int smem[C10_WARP_SIZE]; // for radixSelect
+  __shared__ accscalar_t digit_mass[SAMPLE_RADIX_SIZE];
+  __shared__ accscalar_t broadcast;
+  __shared__ int found;
+  __shared__ int last_kept;
+
+  auto seeds = at::cuda::philox::unpack(philox_args);
+  curandStatePhilox4_32_10_t state;
+  curand_init(std::get<0>(seeds),
+              blockIdx.x,
+              std::get<1>(seeds),
+              &state);
+
+  // Reduces val over the block, and returns the result to all the threads
+  auto block_reduce = [&](accscalar_t val, bool is_max) {
+    val = is_max ? BlockReduce(temp_storage.reduce).Reduce(val, cub::Max())
+                 : BlockReduce(temp_storage.reduce).Sum(val);
+    if (threadIdx.x == 0) {
+      broadcast = val;
+    }
+    __syncthreads();
+    val = broadcast;
+    __syncthreads();
+    return val;
+  };
+
+  for (int64_t curDist = blockIdx.x; curDist < distributions; curDist += gridDim.x) {
+    scalar_t* logits = dist + curDist * stride_dist;
+    auto logit = [&](int64_t cat) {
+      return static_cast<accscalar_t>(logits[cat * stride_categories]);
+    };
+
+    accscalar_t max_logit = -std::numeric_limits<accscalar_t>::infinity();
+    for (int64_t cat = threadIdx.x; cat < categories; cat += blockDim.x) {
+      accscalar_t val = logit(cat);
+      CUDA_KERNEL_ASSERT(!_isnan(val));
+      max_logit = val > max_logit ? val : max_logit;
+    }
+    max_logit = block_reduce(max_logit, /*is_max=*/true);
+    auto probability = [&](accscalar_t val) {
+      return std::exp(val - max_logit);
+    };
+
+    // The logits are kept if they are at least threshold
+    accscalar_t threshold = -std::numeric_limits<accscalar_t>::infinity();
+    if (top_k > 0 && top_k < categories) {
+      scalar_t kth;
+      radixSelect<scalar_t, bitwise_t, int64_t, true>(
+          logits, top_k, categories, stride_categories, smem, &kth);
+      threshold = static_cast<accscalar_t>(kth);
+    }
+
+    if (top_p < 1) {
+      accscalar_t kept_mass = 0;
+      for (int64_t cat = threadIdx.x; cat < categories; cat += blockDim.x) {
+        accscalar_t val = logit(cat);
+        if (val >= threshold) {
+          kept_mass += probability(val);
+        }
+      }
+      kept_mass = block_reduce(kept_mass, /*is_max=*/false);
+
+      // The mass left to find within the logits matching desired
+      accscalar_t target = top_p * kept_mass;
+      bitwise_t desired = 0;
+      bitwise_t desiredMask = 0;
+      for (int digitPos = sizeof(scalar_t) * 8 - SAMPLE_RADIX_BITS; digitPos >= 0;
+           digitPos -= SAMPLE_RADIX_BITS) {
+        if (threadIdx.x < SAMPLE_RADIX_SIZE) {
+          digit_mass[threadIdx.x] = 0;
+        }
+        __syncthreads();
+        for (int64_t cat = threadIdx.x; cat < categories; cat += blockDim.x) {
+          scalar_t v = logits[cat * stride_categories];
+          bitwise_t val = TopKTypeConfig<scalar_t>::convert(v);
+          if ((val & desiredMask) == desired &&
+              static_cast<accscalar_t>(v) >= threshold) {
+            gpuAtomicAdd(
+                &digit_mass[Bitfield<bitwise_t>::getBitfield(
+                    val, digitPos, SAMPLE_RADIX_BITS)],
+                probability(static_cast<accscalar_t>(v)));
+          }
+        }
+        __syncthreads();
+
+        // All threads pick the same digit: the largest one whose logits
+        // reach the mass left, or else the smallest one with mass
+        int digit = 0;
+        accscalar_t above = 0;
+        accscalar_t above_digit = 0;
+        for (int i = SAMPLE_RADIX_SIZE - 1; i >= 0; --i) {
+          accscalar_t mass = digit_mass[i];
+          if (mass > 0) {
+            digit = i;
+            above_digit = above;
+            if (above + mass >= target) {
+              break;
+            }
+            above += mass;
+          }
+        }
+        target -= above_digit;
+        desired = Bitfield<bitwise_t>::setBitfield(
+            desired, digit, digitPos, SAMPLE_RADIX_BITS);
+        desiredMask = Bitfield<bitwise_t>::setBitfield(
+            desiredMask, SAMPLE_RADIX_SIZE - 1, digitPos, SAMPLE_RADIX_BITS);
+        __syncthreads();
+      }
+      accscalar_t top_p_threshold =
+          static_cast<accscalar_t>(TopKTypeConfig<scalar_t>::deconvert(desired));
+      threshold = top_p_threshold > threshold ? top_p_threshold : threshold;
+    }
+
+    accscalar_t total = 0;
+    for (int64_t cat = threadIdx.x; cat < categories; cat += blockDim.x) {
+      accscalar_t val = logit(cat);
+      if (val >= threshold) {
+        total += probability(val);
+      }
+    }
+    total = block_reduce(total, /*is_max=*/false);
+
+    if (threadIdx.x == 0) {
+      // curand_uniform4 is used for the same reason as in
+      // sampleMultinomialWithReplacement
+      broadcast = static_cast<accscalar_t>(curand_uniform4(&state).x) * total;
+      found = -1;
+      last_kept = -1;
+    }
+    __syncthreads();
+    const accscalar_t sample = broadcast;
+
+    // The sample is the kept logit whose bucket of the inclusive scan of the
+    // kept probabilities contains sample
+    accscalar_t prefix = 0;
+    for (int64_t chunk = 0; chunk < categories; chunk += blockDim.x) {
+      int64_t cat = chunk + threadIdx.x;
+      accscalar_t prob = 0;
+      if (cat < categories) {
+        accscalar_t val = logit(cat);
+        if (val >= threshold) {
+          prob = probability(val);
+        }
+      }
+      accscalar_t inclusive;
+      accscalar_t aggregate;
+      BlockScan(temp_storage.scan).InclusiveSum(prob, inclusive, aggregate);
+      if (prob > 0) {
+        if (prefix + inclusive - prob < sample && prefix + inclusive >= sample) {
+          found = cat;
+        }
+        atomicMax(&last_kept, static_cast<int>(cat));
+      }
+      __syncthreads();
+      if (found >= 0) {
+        break;
+      }
+      prefix += aggregate;
+    }
+
+    if (threadIdx.x == 0) {
+      // the last kept logit if the rounding of the sums leaves the sample
+      // above all the buckets
+      dest[curDist] = found >= 0 ? found : last_kept;
+    }
+    __syncthreads();
+  }
+}
+
 void multinomial_with_replacement_kernel_impl(
     Tensor& result,
     const Tensor& self,
@@ -412,9 +624,53 @@ void multinomial_with_replacement_kernel_impl(
     result.resize_({n_sample});
   }
 }
+
+void sample_top_k_top_p_kernel_impl(
+    Tensor& result,
+    const Tensor& self,
+    const int64_t top_k,
+    const double top_p,
+    c10::optional<Generator> generator) {
+  auto gen = get_generator_or_default<CUDAGeneratorImpl>(generator, cuda::detail::getDefaultCUDAGenerator());
+
+  auto self_v = self.dim() == 1 ? self.unsqueeze(0) : self;
+  int64_t numDist = self_v.size(0);
+  int numCategories = self_v.size(1);
+  int numSM = at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+
+  dim3 block(SAMPLE_BLOCK_SIZE);
+  dim3 grid(numDist < numSM * 4 ? numDist : numSM * 4);
+  PhiloxCudaState rng_engine_inputs;
+  {
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    // a curand_uniform4 per distribution of a block
+    rng_engine_inputs = gen->philox_cuda_state(((numDist - 1) / grid.x + 1) * 4);
+  }
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
+      self_v.scalar_type(), "sample_top_k_top_p_cuda", [&] {
+    using accscalar_t = at::acc_type<scalar_t, true>;
+    sampleTopKTopP<scalar_t, accscalar_t>
+        <<<grid, block, 0, at::cuda::getCurrentCUDAStream()>>>(
+            rng_engine_inputs,
+            result.data_ptr<int64_t>(),
+            numDist,
+            numCategories,
+            self_v.data_ptr<scalar_t>(),
+            self_v.stride(0),
+            self_v.stride(1),
+            static_cast<int>(std::min<int64_t>(top_k, numCategories)),
+            static_cast<accscalar_t>(top_p));
+    C10_CUDA_KERNEL_LAUNCH_CHECK();
+  });
+}
 }
 
 REGISTER_DISPATCH(
     multinomial_with_replacement_stub,
     &multinomial_with_replacement_kernel_impl);
+REGISTER_DISPATCH(
+    sample_top_k_top_p_stub,
+    &sample_top_k_top_p_kernel_impl);
 }}
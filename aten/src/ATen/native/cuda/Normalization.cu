@@ -215,4 +215,133 @@ std::tuple<Tensor, Tensor> batch_norm_update_stats_cuda(
   });
 }
 
+namespace {
+
+// The dtype the channels last kernels of batch_norm_add_relu keep the
+// parameters and running stats of the input in (stat_scalar_t), float for
+// half and bfloat16 inputs with float or no parameters
+ScalarType batch_norm_add_relu_stat_type(const Tensor& input, const Tensor& params) {
+  const auto dtype = input.scalar_type();
+  if ((dtype == kHalf || dtype == kBFloat16) && (!params.defined() || params.scalar_type() == kFloat)) {
+    return kFloat;
+  }
+  return dtype;
+}
+
+bool is_channels_last_dense(const Tensor& t) {
+  return t.movedim(1, -1).is_contiguous();
+}
+
+Tensor channels_last_dense(const Tensor& t) {
+  return t.movedim(1, -1).contiguous().movedim(-1, 1);
+}
+
+Tensor empty_channels_last_dense(const Tensor& like) {
+  return at::empty(like.movedim(1, -1).sizes(), like.options()).movedim(-1, 1);
+}
+
+Tensor contiguous_as(const Tensor& t, ScalarType dtype) {
+  return t.defined() ? t.to(dtype).contiguous() : t;
+}
+
+bool is_running_stat_of_type(const Tensor& t, ScalarType dtype) {
+  return !t.defined() || (t.scalar_type() == dtype && t.is_contiguous());
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor, Tensor, Tensor> batch_norm_add_relu_cuda(
+    const Tensor& self, const Tensor& other, const Tensor& weight, const Tensor& bias,
+    const Tensor& running_mean, const Tensor& running_var, bool train, double momentum, double epsilon) {
+  const auto stat_type = batch_norm_add_relu_stat_type(self, weight.defined() ? weight : running_mean);
+  // The kernels handle channels last inputs, which the elementwise kernels of
+  // the composite would otherwise walk with the strides of the channels
+  // first dimensions; the other inputs go through the composite.
+  if (self.dim() < 2 || self.numel() == 0 || !is_channels_last_dense(self) ||
+      (other.defined() && (other.sizes() != self.sizes() || other.scalar_type() != self.scalar_type())) ||
+      !is_running_stat_of_type(running_mean, stat_type) || !is_running_stat_of_type(running_var, stat_type) ||
+      (!train && !(running_mean.defined() && running_var.defined()))) {
+    return math_batch_norm_add_relu(self, other, weight, bias, running_mean, running_var, train, momentum, epsilon);
+  }
+  TORCH_CHECK(!train || self.numel() / self.size(1) > 1,
+              "Expected more than 1 value per channel when training, got input size ", self.sizes());
+
+  const int64_t channels = self.size(1);
+  auto stat_options = self.options().dtype(stat_type == kFloat || stat_type == kDouble ? stat_type : kFloat);
+  Tensor output = empty_channels_last_dense(self);
+  Tensor save_mean = at::empty({channels}, stat_options);
+  Tensor save_invstd = at::empty({channels}, stat_options);
+  Tensor relu_mask = at::empty({(self.numel() + 31) / 32}, self.options().dtype(kInt));
+  Tensor other_ = other.defined() ? channels_last_dense(other) : other;
+  Tensor weight_ = contiguous_as(weight, stat_type);
+  Tensor bias_ = contiguous_as(bias, stat_type);
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, self.scalar_type(), "batch_norm_add_relu_cuda", [&] {
+    const bool is_reduced_float = stat_type == kFloat && !std::is_same<scalar_t, float>::value;
+    if (cuda::detail::canUse32BitIndexMath(self)) {
+      if (is_reduced_float) {
+        batch_norm_add_relu_cuda_template<scalar_t, float, int32_t>(output, save_mean, save_invstd, relu_mask, self, other_, weight_, bias_, running_mean, running_var, train, momentum, epsilon);
+      } else {
+        batch_norm_add_relu_cuda_template<scalar_t, scalar_t, int32_t>(output, save_mean, save_invstd, relu_mask, self, other_, weight_, bias_, running_mean, running_var, train, momentum, epsilon);
+      }
+    } else {
+      if (is_reduced_float) {
+        batch_norm_add_relu_cuda_template<scalar_t, float, int64_t>(output, save_mean, save_invstd, relu_mask, self, other_, weight_, bias_, running_mean, running_var, train, momentum, epsilon);
+      } else {
+        batch_norm_add_relu_cuda_template<scalar_t, scalar_t, int64_t>(output, save_mean, save_invstd, relu_mask, self, other_, weight_, bias_, running_mean, running_var, train, momentum, epsilon);
+      }
+    }
+  });
+  return std::make_tuple(output, save_mean, save_invstd, relu_mask);
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor> batch_norm_add_relu_backward_cuda(
+    const Tensor& grad_out, const Tensor& self, const Tensor& weight, const Tensor& save_mean,
+    const Tensor& save_invstd, const Tensor& relu_mask, bool train, std::array<bool, 4> output_mask) {
+  if (!is_channels_last_dense(self) || self.numel() == 0) {
+    return math_batch_norm_add_relu_backward(grad_out, self, weight, save_mean, save_invstd, relu_mask, train, output_mask);
+  }
+  const int64_t channels = self.size(1);
+  const auto stat_type = batch_norm_add_relu_stat_type(self, weight);
+  Tensor grad_out_ = channels_last_dense(grad_out.to(self.scalar_type()));
+  Tensor weight_ = contiguous_as(weight, stat_type);
+  Tensor grad_input, grad_other, grad_weight, grad_bias;
+  if (output_mask[0]) {
+    grad_input = empty_channels_last_dense(self);
+  }
+  if (output_mask[1]) {
+    grad_other = empty_channels_last_dense(self);
+  }
+  if (output_mask[2] && weight.defined()) {
+    grad_weight = at::empty({channels}, weight_.options());
+  }
+  if (output_mask[3]) {
+    grad_bias = at::empty({channels}, self.options().dtype(stat_type));
+  }
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, self.scalar_type(), "batch_norm_add_relu_backward_cuda", [&] {
+    const bool is_reduced_float = stat_type == kFloat && !std::is_same<scalar_t, float>::value;
+    if (cuda::detail::canUse32BitIndexMath(self)) {
+      if (is_reduced_float) {
+        batch_norm_add_relu_backward_cuda_template<scalar_t, float, int32_t>(grad_input, grad_other, grad_weight, grad_bias, grad_out_, self, weight_, save_mean, save_invstd, relu_mask, train);
+      } else {
+        batch_norm_add_relu_backward_cuda_template<scalar_t, scalar_t, int32_t>(grad_input, grad_other, grad_weight, grad_bias, grad_out_, self, weight_, save_mean, save_invstd, relu_mask, train);
+      }
+    } else {
+      if (is_reduced_float) {
+        batch_norm_add_relu_backward_cuda_template<scalar_t, float, int64_t>(grad_input, grad_other, grad_weight, grad_bias, grad_out_, self, weight_, save_mean, save_invstd, relu_mask, train);
+      } else {
+        batch_norm_add_relu_backward_cuda_template<scalar_t, scalar_t, int64_t>(grad_input, grad_other, grad_weight, grad_bias, grad_out_, self, weight_, save_mean, save_invstd, relu_mask, train);
+      }
+    }
+  });
+  if (grad_weight.defined()) {
+    grad_weight = grad_weight.to(weight.scalar_type());
+  }
+  if (grad_bias.defined() && weight.defined()) {
+    grad_bias = grad_bias.to(weight.scalar_type());
+  }
+  return std::make_tuple(grad_input, grad_other, grad_weight, grad_bias);
+}
+
 } } // namespace at::native
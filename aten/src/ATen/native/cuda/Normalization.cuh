@@ -859,4 +859,400 @@ std::tuple<Tensor, Tensor> batch_norm_update_stats_cuda_template(
   return std::make_tuple(save_mean_, save_var_);
 }
 
+// The kernels of batch_norm_add_relu work on the [rows, channels] view of
+// channels last inputs (input.movedim(1, -1)). The reductions use blocks of
+// BN_ADD_RELU_CHANNELS channels by MAX_BLOCK_SIZE / BN_ADD_RELU_CHANNELS rows,
+// each block reducing a group of the rows to per channel partials that a
+// kernel with a thread per channel then merges. The ReLU mask holds a bit per
+// element, in [rows, channels] order, in int32 words.
+constexpr int BN_ADD_RELU_CHANNELS = 32;
+constexpr int BN_ADD_RELU_MASK_BITS = 32;
+
+template <typename T>
+__device__ __forceinline__ void welford_merge(T& mean, T& m2, T& count, T other_mean, T other_m2, T other_count) {
+  T total = count + other_count;
+  if (total == static_cast<T>(0)) {
+    return;
+  }
+  T delta = other_mean - mean;
+  T factor = other_count / total;
+  mean += delta * factor;
+  m2 += other_m2 + delta * delta * count * factor;
+  count = total;
+}
+
+template <typename index_t>
+__device__ __forceinline__ bool relu_mask_bit(const int32_t* __restrict__ relu_mask, index_t i) {
+  return (static_cast<uint32_t>(relu_mask[i / BN_ADD_RELU_MASK_BITS]) >> (i % BN_ADD_RELU_MASK_BITS)) & 1;
+}
+
+// Writes the count, mean and M2 of the rows of blockIdx.y's group to the
+// [3, groups, channels] partials
+template <typename input_scalar_t, typename stat_accscalar_t, typename index_t>
+__global__ void batch_norm_add_relu_welford_kernel(
+    const input_scalar_t* __restrict__ input,
+    const index_t rows,
+    const index_t channels,
+    const index_t rows_per_group,
+    stat_accscalar_t* __restrict__ partials) {
+  __shared__ stat_accscalar_t shared_mean[MAX_BLOCK_SIZE];
+  __shared__ stat_accscalar_t shared_m2[MAX_BLOCK_SIZE];
+  __shared__ stat_accscalar_t shared_count[MAX_BLOCK_SIZE];
+
+  const index_t c = blockIdx.x * blockDim.x + threadIdx.x;
+  const index_t row_begin = blockIdx.y * rows_per_group;
+  const index_t row_end = ::min(row_begin + rows_per_group, rows);
+  stat_accscalar_t mean = 0, m2 = 0, count = 0;
+  if (c < channels) {
+    for (index_t r = row_begin + threadIdx.y; r < row_end; r += blockDim.y) {
+      stat_accscalar_t v = input[r * channels + c];
+      count += 1;
+      stat_accscalar_t delta = v - mean;
+      mean += delta / count;
+      m2 += delta * (v - mean);
+    }
+  }
+
+  const int tid = threadIdx.y * blockDim.x + threadIdx.x;
+  shared_mean[tid] = mean;
+  shared_m2[tid] = m2;
+  shared_count[tid] = count;
+  __syncthreads();
+  for (int offset = blockDim.y / 2; offset > 0; offset >>= 1) {
+    if (threadIdx.y < offset) {
+      const int other = tid + offset * blockDim.x;
+      welford_merge(mean, m2, count, shared_mean[other], shared_m2[other], shared_count[other]);
+      shared_mean[tid] = mean;
+      shared_m2[tid] = m2;
+      shared_count[tid] = count;
+    }
+    __syncthreads();
+  }
+
+  if (threadIdx.y == 0 && c < channels) {
+    const index_t plane = gridDim.y * channels;
+    const index_t offset = blockIdx.y * channels + c;
+    partials[offset] = count;
+    partials[plane + offset] = mean;
+    partials[2 * plane + offset] = m2;
+  }
+}
+
+// Merges the partials of each channel (or reads the running stats when not
+// training) into the saved statistics and the [2, channels] scale and shift
+// the transform applies
+template <typename stat_scalar_t, typename stat_accscalar_t, typename index_t>
+__global__ void batch_norm_add_relu_finalize_kernel(
+    const stat_accscalar_t* __restrict__ partials,
+    const index_t groups,
+    const index_t channels,
+    const stat_scalar_t* __restrict__ weight,
+    const stat_scalar_t* __restrict__ bias,
+    stat_scalar_t* __restrict__ running_mean,
+    stat_scalar_t* __restrict__ running_var,
+    const bool train,
+    const double momentum,
+    const double epsilon,
+    stat_accscalar_t* __restrict__ save_mean,
+    stat_accscalar_t* __restrict__ save_invstd,
+    stat_accscalar_t* __restrict__ coefficients) {
+  const index_t c = blockIdx.x * blockDim.x + threadIdx.x;
+  if (c >= channels) {
+    return;
+  }
+  stat_accscalar_t mean, invstd;
+  if (train) {
+    const index_t plane = groups * channels;
+    stat_accscalar_t m2 = 0, count = 0;
+    mean = 0;
+    for (index_t g = 0; g < groups; g++) {
+      const index_t offset = g * channels + c;
+      welford_merge(mean, m2, count, partials[plane + offset], partials[2 * plane + offset], partials[offset]);
+    }
+    invstd = InvStd<stat_accscalar_t>{}(m2 / count, epsilon);
+    if (running_mean != nullptr) {
+      running_mean[c] = static_cast<stat_scalar_t>(momentum * mean + (1 - momentum) * running_mean[c]);
+    }
+    if (running_var != nullptr) {
+      stat_accscalar_t unbiased_var = m2 / (count - 1);
+      running_var[c] = static_cast<stat_scalar_t>(momentum * unbiased_var + (1 - momentum) * running_var[c]);
+    }
+  } else {
+    mean = static_cast<stat_accscalar_t>(running_mean[c]);
+    invstd = InvStd<stat_accscalar_t>{}(static_cast<stat_accscalar_t>(running_var[c]), epsilon);
+  }
+  save_mean[c] = mean;
+  save_invstd[c] = invstd;
+  stat_accscalar_t w = weight != nullptr ? static_cast<stat_accscalar_t>(weight[c]) : static_cast<stat_accscalar_t>(1);
+  stat_accscalar_t b = bias != nullptr ? static_cast<stat_accscalar_t>(bias[c]) : static_cast<stat_accscalar_t>(0);
+  coefficients[c] = w * invstd;
+  coefficients[channels + c] = b - mean * w * invstd;
+}
+
+// output = relu(input * scale + shift + other). The block stride is a
+// multiple of BN_ADD_RELU_MASK_BITS, so the first lane of each 32 packs the
+// ballot of its word of the mask.
+template <typename input_scalar_t, typename stat_accscalar_t, typename index_t>
+__global__ void batch_norm_add_relu_transform_kernel(
+    const input_scalar_t* __restrict__ input,
+    const input_scalar_t* __restrict__ other,
+    const stat_accscalar_t* __restrict__ coefficients,
+    const index_t numel,
+    const index_t channels,
+    input_scalar_t* __restrict__ output,
+    int32_t* __restrict__ relu_mask) {
+  const index_t stride = static_cast<index_t>(gridDim.x) * blockDim.x;
+  const int lane = threadIdx.x % C10_WARP_SIZE;
+  for (index_t start = static_cast<index_t>(blockIdx.x) * blockDim.x; start < numel; start += stride) {
+    const index_t i = start + threadIdx.x;
+    bool positive = false;
+    if (i < numel) {
+      const index_t c = i % channels;
+      stat_accscalar_t y = static_cast<stat_accscalar_t>(input[i]) * coefficients[c] + coefficients[channels + c];
+      if (other != nullptr) {
+        y += static_cast<stat_accscalar_t>(other[i]);
+      }
+      input_scalar_t out = y > 0 ? static_cast<input_scalar_t>(y) : static_cast<input_scalar_t>(0);
+      positive = static_cast<stat_accscalar_t>(out) > 0;
+      output[i] = out;
+    }
+    auto ballot = WARP_BALLOT(positive);
+    if (lane % BN_ADD_RELU_MASK_BITS == 0 && i < numel) {
+      relu_mask[i / BN_ADD_RELU_MASK_BITS] = static_cast<int32_t>(static_cast<uint32_t>(ballot >> lane));
+    }
+  }
+}
+
+// Writes the sums of grad and grad * (input - mean) over the rows of
+// blockIdx.y's group, grad being masked by the ReLU mask, to the
+// [2, groups, channels] partials
+template <typename input_scalar_t, typename stat_accscalar_t, typename index_t>
+__global__ void batch_norm_add_relu_backward_reduce_kernel(
+    const input_scalar_t* __restrict__ grad_out,
+    const input_scalar_t* __restrict__ input,
+    const int32_t* __restrict__ relu_mask,
+    const stat_accscalar_t* __restrict__ save_mean,
+    const index_t rows,
+    const index_t channels,
+    const index_t rows_per_group,
+    stat_accscalar_t* __restrict__ partials) {
+  __shared__ stat_accscalar_t shared_sum_dy[MAX_BLOCK_SIZE];
+  __shared__ stat_accscalar_t shared_sum_dy_xmu[MAX_BLOCK_SIZE];
+
+  const index_t c = blockIdx.x * blockDim.x + threadIdx.x;
+  const index_t row_begin = blockIdx.y * rows_per_group;
+  const index_t row_end = ::min(row_begin + rows_per_group, rows);
+  stat_accscalar_t sum_dy = 0, sum_dy_xmu = 0;
+  if (c < channels) {
+    const stat_accscalar_t mean = save_mean[c];
+    for (index_t r = row_begin + threadIdx.y; r < row_end; r += blockDim.y) {
+      const index_t i = r * channels + c;
+      if (relu_mask_bit(relu_mask, i)) {
+        stat_accscalar_t dy = grad_out[i];
+        sum_dy += dy;
+        sum_dy_xmu += dy * (static_cast<stat_accscalar_t>(input[i]) - mean);
+      }
+    }
+  }
+
+  const int tid = threadIdx.y * blockDim.x + threadIdx.x;
+  shared_sum_dy[tid] = sum_dy;
+  shared_sum_dy_xmu[tid] = sum_dy_xmu;
+  __syncthreads();
+  for (int offset = blockDim.y / 2; offset > 0; offset >>= 1) {
+    if (threadIdx.y < offset) {
+      const int other = tid + offset * blockDim.x;
+      shared_sum_dy[tid] = sum_dy = sum_dy + shared_sum_dy[other];
+      shared_sum_dy_xmu[tid] = sum_dy_xmu = sum_dy_xmu + shared_sum_dy_xmu[other];
+    }
+    __syncthreads();
+  }
+
+  if (threadIdx.y == 0 && c < channels) {
+    const index_t offset = blockIdx.y * channels + c;
+    partials[offset] = sum_dy;
+    partials[gridDim.y * channels + offset] = sum_dy_xmu;
+  }
+}
+
+// Merges the partial sums into grad_weight and grad_bias and the [3, channels]
+// coefficients of grad_input = grad * k1 + (input - mean) * k2 + k3
+template <typename stat_scalar_t, typename stat_accscalar_t, typename index_t>
+__global__ void batch_norm_add_relu_backward_finalize_kernel(
+    const stat_accscalar_t* __restrict__ partials,
+    const index_t groups,
+    const index_t channels,
+    const index_t rows,
+    const stat_scalar_t* __restrict__ weight,
+    const stat_accscalar_t* __restrict__ save_invstd,
+    const bool train,
+    stat_scalar_t* __restrict__ grad_weight,
+    stat_scalar_t* __restrict__ grad_bias,
+    stat_accscalar_t* __restrict__ coefficients) {
+  const index_t c = blockIdx.x * blockDim.x + threadIdx.x;
+  if (c >= channels) {
+    return;
+  }
+  stat_accscalar_t sum_dy = 0, sum_dy_xmu = 0;
+  for (index_t g = 0; g < groups; g++) {
+    sum_dy += partials[g * channels + c];
+    sum_dy_xmu += partials[(groups + g) * channels + c];
+  }
+  const stat_accscalar_t invstd = save_invstd[c];
+  if (grad_weight != nullptr) {
+    grad_weight[c] = static_cast<stat_scalar_t>(sum_dy_xmu * invstd);
+  }
+  if (grad_bias != nullptr) {
+    grad_bias[c] = static_cast<stat_scalar_t>(sum_dy);
+  }
+  const stat_accscalar_t w = weight != nullptr ? static_cast<stat_accscalar_t>(weight[c]) : static_cast<stat_accscalar_t>(1);
+  const stat_accscalar_t k1 = invstd * w;
+  const stat_accscalar_t norm = static_cast<stat_accscalar_t>(1) / rows;
+  coefficients[c] = k1;
+  coefficients[channels + c] = train ? -k1 * invstd * invstd * sum_dy_xmu * norm : static_cast<stat_accscalar_t>(0);
+  coefficients[2 * channels + c] = train ? -k1 * sum_dy * norm : static_cast<stat_accscalar_t>(0);
+}
+
+template <typename input_scalar_t, typename stat_accscalar_t, typename index_t>
+__global__ void batch_norm_add_relu_backward_elemt_kernel(
+    const input_scalar_t* __restrict__ grad_out,
+    const input_scalar_t* __restrict__ input,
+    const int32_t* __restrict__ relu_mask,
+    const stat_accscalar_t* __restrict__ save_mean,
+    const stat_accscalar_t* __restrict__ coefficients,
+    const index_t numel,
+    const index_t channels,
+    input_scalar_t* __restrict__ grad_input,
+    input_scalar_t* __restrict__ grad_other) {
+  const index_t stride = static_cast<index_t>(gridDim.x) * blockDim.x;
+  for (index_t i = static_cast<index_t>(blockIdx.x) * blockDim.x + threadIdx.x; i < numel; i += stride) {
+    const stat_accscalar_t dy = relu_mask_bit(relu_mask, i) ?
+        static_cast<stat_accscalar_t>(grad_out[i]) : static_cast<stat_accscalar_t>(0);
+    if (grad_input != nullptr) {
+      const index_t c = i % channels;
+      const stat_accscalar_t xmu = static_cast<stat_accscalar_t>(input[i]) - save_mean[c];
+      grad_input[i] = static_cast<input_scalar_t>(
+          dy * coefficients[c] + xmu * coefficients[channels + c] + coefficients[2 * channels + c]);
+    }
+    if (grad_other != nullptr) {
+      grad_other[i] = static_cast<input_scalar_t>(dy);
+    }
+  }
+}
+
+// The number of row groups the reductions of batch_norm_add_relu split the
+// rows into, and the rows of each group
+static std::pair<int64_t, int64_t> batch_norm_add_relu_groups(int64_t rows, int64_t channels) {
+  const int64_t block_rows = MAX_BLOCK_SIZE / BN_ADD_RELU_CHANNELS;
+  const int64_t channel_blocks = (channels + BN_ADD_RELU_CHANNELS - 1) / BN_ADD_RELU_CHANNELS;
+  // Aim at a few waves of blocks, with each thread reducing at least a few rows
+  const int64_t max_groups = std::max<int64_t>(1, (4 * at::cuda::getCurrentDeviceProperties()->multiProcessorCount *
+      (at::cuda::getCurrentDeviceProperties()->maxThreadsPerMultiProcessor / MAX_BLOCK_SIZE)) / channel_blocks);
+  const int64_t groups = std::max<int64_t>(1, std::min<int64_t>({max_groups, (rows + 4 * block_rows - 1) / (4 * block_rows), 65535}));
+  const int64_t rows_per_group = (rows + groups - 1) / groups;
+  return std::make_pair((rows + rows_per_group - 1) / rows_per_group, rows_per_group);
+}
+
+static int64_t batch_norm_add_relu_elementwise_blocks(int64_t numel, int64_t threads) {
+  const int64_t max_blocks = at::cuda::getCurrentDeviceProperties()->multiProcessorCount *
+      (at::cuda::getCurrentDeviceProperties()->maxThreadsPerMultiProcessor / threads) * 4;
+  return std::max<int64_t>(1, std::min<int64_t>(max_blocks, (numel + threads - 1) / threads));
+}
+
+// input, other and output are channels last dense (movedim(1, -1) makes them
+// contiguous), the parameters and running stats contiguous and of the stat type
+template<typename input_scalar_t, typename stat_scalar_t, typename index_t>
+void batch_norm_add_relu_cuda_template(Tensor& output_, Tensor& save_mean_, Tensor& save_invstd_, Tensor& relu_mask_,
+                                       const Tensor& input_, const Tensor& other_, const Tensor& weight_, const Tensor& bias_,
+                                       const Tensor& running_mean_, const Tensor& running_var_,
+                                       bool train, double momentum, double epsilon) {
+  using stat_accscalar_t = at::acc_type<stat_scalar_t, true>;
+  const int64_t channels = input_.size(1);
+  const int64_t numel = input_.numel();
+  const int64_t rows = numel / channels;
+  auto stream = at::cuda::getCurrentCUDAStream();
+
+  Tensor coefficients_ = at::empty({2, channels}, save_mean_.options());
+  const dim3 reduce_threads(BN_ADD_RELU_CHANNELS, MAX_BLOCK_SIZE / BN_ADD_RELU_CHANNELS);
+  const int64_t channel_blocks = (channels + BN_ADD_RELU_CHANNELS - 1) / BN_ADD_RELU_CHANNELS;
+  int64_t groups = 0, rows_per_group = 0;
+  Tensor partials_;
+  if (train) {
+    std::tie(groups, rows_per_group) = batch_norm_add_relu_groups(rows, channels);
+    partials_ = at::empty({3, groups, channels}, save_mean_.options());
+    const dim3 blocks(channel_blocks, groups);
+    batch_norm_add_relu_welford_kernel<input_scalar_t, stat_accscalar_t, index_t> <<<blocks, reduce_threads, 0, stream>>>
+      (input_.data_ptr<input_scalar_t>(), rows, channels, rows_per_group, partials_.data_ptr<stat_accscalar_t>());
+    C10_CUDA_KERNEL_LAUNCH_CHECK();
+  }
+
+  const int finalize_threads = getNumThreads(channels);
+  batch_norm_add_relu_finalize_kernel<stat_scalar_t, stat_accscalar_t, index_t>
+    <<<(channels + finalize_threads - 1) / finalize_threads, finalize_threads, 0, stream>>>
+    (train ? partials_.data_ptr<stat_accscalar_t>() : nullptr, groups, channels,
+     weight_.defined() ? weight_.data_ptr<stat_scalar_t>() : nullptr,
+     bias_.defined() ? bias_.data_ptr<stat_scalar_t>() : nullptr,
+     running_mean_.defined() ? running_mean_.data_ptr<stat_scalar_t>() : nullptr,
+     running_var_.defined() ? running_var_.data_ptr<stat_scalar_t>() : nullptr,
+     train, momentum, epsilon,
+     save_mean_.data_ptr<stat_accscalar_t>(), save_invstd_.data_ptr<stat_accscalar_t>(),
+     coefficients_.data_ptr<stat_accscalar_t>());
+  C10_CUDA_KERNEL_LAUNCH_CHECK();
+
+  const int64_t threads = MAX_BLOCK_SIZE;
+  batch_norm_add_relu_transform_kernel<input_scalar_t, stat_accscalar_t, index_t>
+    <<<batch_norm_add_relu_elementwise_blocks(numel, threads), threads, 0, stream>>>
+    (input_.data_ptr<input_scalar_t>(), other_.defined() ? other_.data_ptr<input_scalar_t>() : nullptr,
+     coefficients_.data_ptr<stat_accscalar_t>(), numel, channels,
+     output_.data_ptr<input_scalar_t>(), relu_mask_.data_ptr<int32_t>());
+  C10_CUDA_KERNEL_LAUNCH_CHECK();
+}
+
+// grad_out, input, grad_input and grad_other are channels last dense, weight
+// contiguous and of the stat type
+template<typename input_scalar_t, typename stat_scalar_t, typename index_t>
+void batch_norm_add_relu_backward_cuda_template(Tensor& grad_input_, Tensor& grad_other_, Tensor& grad_weight_, Tensor& grad_bias_,
+                                                const Tensor& grad_out_, const Tensor& input_, const Tensor& weight_,
+                                                const Tensor& save_mean_, const Tensor& save_invstd_, const Tensor& relu_mask_,
+                                                bool train) {
+  using stat_accscalar_t = at::acc_type<stat_scalar_t, true>;
+  const int64_t channels = input_.size(1);
+  const int64_t numel = input_.numel();
+  const int64_t rows = numel / channels;
+  auto stream = at::cuda::getCurrentCUDAStream();
+
+  int64_t groups, rows_per_group;
+  std::tie(groups, rows_per_group) = batch_norm_add_relu_groups(rows, channels);
+  Tensor partials_ = at::empty({2, groups, channels}, save_mean_.options());
+  Tensor coefficients_ = at::empty({3, channels}, save_mean_.options());
+  const dim3 reduce_threads(BN_ADD_RELU_CHANNELS, MAX_BLOCK_SIZE / BN_ADD_RELU_CHANNELS);
+  const dim3 blocks((channels + BN_ADD_RELU_CHANNELS - 1) / BN_ADD_RELU_CHANNELS, groups);
+  batch_norm_add_relu_backward_reduce_kernel<input_scalar_t, stat_accscalar_t, index_t> <<<blocks, reduce_threads, 0, stream>>>
+    (grad_out_.data_ptr<input_scalar_t>(), input_.data_ptr<input_scalar_t>(), relu_mask_.data_ptr<int32_t>(),
+     save_mean_.data_ptr<stat_accscalar_t>(), rows, channels, rows_per_group, partials_.data_ptr<stat_accscalar_t>());
+  C10_CUDA_KERNEL_LAUNCH_CHECK();
+
+  const int finalize_threads = getNumThreads(channels);
+  batch_norm_add_relu_backward_finalize_kernel<stat_scalar_t, stat_accscalar_t, index_t>
+    <<<(channels + finalize_threads - 1) / finalize_threads, finalize_threads, 0, stream>>>
+    (partials_.data_ptr<stat_accscalar_t>(), groups, channels, rows,
+     weight_.defined() ? weight_.data_ptr<stat_scalar_t>() : nullptr,
+     save_invstd_.data_ptr<stat_accscalar_t>(), train,
+     grad_weight_.defined() ? grad_weight_.data_ptr<stat_scalar_t>() : nullptr,
+     grad_bias_.defined() ? grad_bias_.data_ptr<stat_scalar_t>() : nullptr,
+     coefficients_.data_ptr<stat_accscalar_t>());
+  C10_CUDA_KERNEL_LAUNCH_CHECK();
+
+  if (grad_input_.defined() || grad_other_.defined()) {
+    const int64_t threads = MAX_BLOCK_SIZE;
+    batch_norm_add_relu_backward_elemt_kernel<input_scalar_t, stat_accscalar_t, index_t>
+      <<<batch_norm_add_relu_elementwise_blocks(numel, threads), threads, 0, stream>>>
+      (grad_out_.data_ptr<input_scalar_t>(), input_.data_ptr<input_scalar_t>(), relu_mask_.data_ptr<int32_t>(),
+       save_mean_.data_ptr<stat_accscalar_t>(), coefficients_.data_ptr<stat_accscalar_t>(), numel, channels,
+       grad_input_.defined() ? grad_input_.data_ptr<input_scalar_t>() : nullptr,
+       grad_other_.defined() ? grad_other_.data_ptr<input_scalar_t>() : nullptr);
+    C10_CUDA_KERNEL_LAUNCH_CHECK();
+  }
+}
+
 } } // namespace at::native
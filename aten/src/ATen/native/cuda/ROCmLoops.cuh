@@ -38,6 +38,7 @@
 #include <ATen/native/TensorIterator.h>
 #include <c10/macros/Macros.h>
 #include <c10/core/ScalarType.h>
+#include <c10/util/OverheadProbe.h>
 #include <c10/util/TypeCast.h>
 
 // Marks a lambda as executable on both the host and device. The __host__
@@ -130,6 +131,7 @@ static void launch_kernel(int64_t N, const func_t& f) {
   if (N == 0) {
     return;
   }
+  C10_OVERHEAD_PROBE(KERNEL_LAUNCH);
   dim3 block(nt);
   dim3 grid((N + block.x * vt - 1) / (block.x * vt));
   auto stream = at::cuda::getCurrentCUDAStream();
@@ -293,6 +295,7 @@ static void launch_kernel(int64_t N, const func_t& f, array_t data) {
   if (N == 0) {
     return;
   }
+  C10_OVERHEAD_PROBE(KERNEL_LAUNCH);
   int64_t grid = (N + block_work_size - 1) / block_work_size;
   auto stream = at::cuda::getCurrentCUDAStream();
   elementwise_kernel<func_t, array_t><<<grid, num_threads, 0, stream>>>(N, f, data);
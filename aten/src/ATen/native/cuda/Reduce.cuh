@@ -13,6 +13,7 @@
 #include <ATen/native/cuda/MemoryAccess.cuh>
 #include <c10/macros/Macros.h>
 #include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/util/OverheadProbe.h>
 #include <functional>
 #include <iosfwd>
 #include <type_traits>
@@ -280,13 +281,16 @@ struct ReduceOp {
 
   static constexpr int input_vec_size = ReduceConfig::input_vec_size;
 
+  static constexpr int max_outputs = 4;
+  using out_ptrs_t = at::detail::Array<char*, max_outputs>;
+
   ops_t ops;
   arg_t ident;
   ReduceConfig config;
   InputCalculator input_calc;
   OutputCalculator output_calc;
   const void* src;
-  const char* dst[2]; //it accepts at most two destinations
+  const char* dst[max_outputs]; //it accepts at most max_outputs destinations
   // acc_buf used for accumulation among sub Tensor Iterator when accumulation on
   // output is not permissible
   void* acc_buf;
@@ -304,8 +308,7 @@ struct ReduceOp {
       InputCalculator input_calc,
       OutputCalculator output_calc,
       const void* src,
-      char* dst0,
-      optional<char*> dst1,
+      out_ptrs_t dsts,
       void* acc_buf,
       void* cta_buf,
       int* semaphores,
@@ -323,9 +326,8 @@ struct ReduceOp {
         semaphores(semaphores),
         base_idx(base_idx),
         noutputs(noutputs) {
-    dst[0] = dst0;
-    if (dst1.has_value()) {
-      dst[1] = dst1.value();
+    for (int i = 0; i < max_outputs; i++) {
+      dst[i] = dsts[i];
     }
   }
 
@@ -701,6 +703,19 @@ struct ReduceOp {
     }
   }
 
+  // Outputs of the same type, one per element of the array
+  template<class T, int size>
+  C10_DEVICE void set_results(const at::detail::Array<T, size> x, const index_t base_offset) const {
+    static_assert(size <= max_outputs, "too many outputs for ReduceOp");
+    #pragma unroll
+    for (int i = 0; i < size; i++) {
+      if (i < noutputs) {
+        auto res = (T*)((char*)dst[i] + base_offset);
+        *res = x[i];
+      }
+    }
+  }
+
   template <int output_vec_size>
   C10_DEVICE void set_results_to_output(at::detail::Array<arg_t, output_vec_size> value, at::detail::Array<index_t, output_vec_size> base_offset) const {
     assert(final_output);
@@ -808,6 +823,7 @@ struct ReduceOp {
 
 template<int max_threads, typename R>
 static void launch_reduce_kernel(const ReduceConfig& config, const R& reduction) {
+  C10_OVERHEAD_PROBE(KERNEL_LAUNCH);
   dim3 block = config.block();
   dim3 grid = config.grid();
 
@@ -935,16 +951,16 @@ inline void gpu_reduce_kernel(TensorIterator& iter, const ops_t& ops, ident_t id
     return;
   }
 
+  using reduce_op_t = ReduceOp<scalar_t, ops_t, uint32_t, out_scalar_t, vt0>;
   const char* in_data = (char*)iter.data_ptr(iter.ntensors() - 1);
-  char* out_data = (char*)iter.data_ptr(0);
   const auto noutputs = iter.noutputs();
-  optional<char*> out_data_extra;
-  if (noutputs > 1) {
-    out_data_extra = (char*)iter.data_ptr(1);
-  } else {
-    out_data_extra = nullopt;
+  TORCH_INTERNAL_ASSERT(noutputs <= reduce_op_t::max_outputs,
+      "gpu_reduce_kernel supports at most ", reduce_op_t::max_outputs, " outputs, got ", noutputs);
+  typename reduce_op_t::out_ptrs_t out_data(nullptr);
+  for (int i = 0; i < noutputs; i++) {
+    out_data[i] = (char*)iter.data_ptr(i);
   }
-  char* acc_data = acc_buf_ptr->get_acc_slice(out_data);
+  char* acc_data = acc_buf_ptr->get_acc_slice(out_data[0]);
 
   // Start by assuming that each thread handles a single output and all
   // the inputs for that output.
@@ -1088,14 +1104,13 @@ inline void gpu_reduce_kernel(TensorIterator& iter, const ops_t& ops, ident_t id
   AT_ASSERT(can_use_32bit_indexing);
   auto output_calc = make_output_calculator<uint32_t>(iter);
   auto input_calc = make_input_calculator<uint32_t>(iter);
-  auto reduce = ReduceOp<scalar_t, ops_t, uint32_t, out_scalar_t, vt0>(
+  auto reduce = reduce_op_t(
       ops,
       config,
       input_calc,
       output_calc,
       in_data,
       out_data,
-      out_data_extra,
       acc_data,
       buffer.get(),
       (int*)semaphores.get(),
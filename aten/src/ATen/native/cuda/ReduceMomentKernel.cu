@@ -34,6 +34,25 @@ static void std_var_kernel_cuda(TensorIterator& iter, bool unbiased, bool take_s
   });
 }
 
+template <typename scalar_t, typename acc_scalar_t=scalar_t>
+void aminmax_var_mean_kernel_impl(TensorIterator& iter, bool unbiased) {
+  // the same unrolling factor as the welford kernel, the min and the max add
+  // to its register usage
+  gpu_reduce_kernel<scalar_t, scalar_t, 2>(iter, MinMaxWelfordOps<scalar_t, acc_scalar_t, int32_t, float> { unbiased }, MinMaxWelfordData<scalar_t, acc_scalar_t, int32_t, float> {});
+}
+
+static void aminmax_var_mean_kernel_cuda(TensorIterator& iter, bool unbiased) {
+  if (iter.dtype() == kHalf) {
+    aminmax_var_mean_kernel_impl<at::Half, float>(iter, unbiased);
+  } else if (iter.dtype() == kBFloat16) {
+    aminmax_var_mean_kernel_impl<at::BFloat16, float>(iter, unbiased);
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "aminmax_var_mean_cuda", [&]() {
+      aminmax_var_mean_kernel_impl<scalar_t>(iter, unbiased);
+    });
+  }
+}
+
 template <typename scalar_t, typename acc_t=scalar_t, typename out_t=scalar_t>
 void mean_kernel_impl(TensorIterator& iter) {
   //  returns acc_t for all non-complex dtypes and returns T for c10::complex<T>
@@ -61,6 +80,7 @@ static void mean_kernel_cuda(TensorIterator& iter) {
 }
 
 REGISTER_DISPATCH(std_var_stub, &std_var_kernel_cuda);
+REGISTER_DISPATCH(aminmax_var_mean_stub, &aminmax_var_mean_kernel_cuda);
 REGISTER_DISPATCH(mean_stub, &mean_kernel_cuda);
 
 }} // namespace at::native
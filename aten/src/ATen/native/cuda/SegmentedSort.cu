@@ -0,0 +1,271 @@
+#include <ATen/native/cuda/SegmentedSort.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/NumericUtils.h>
+#include <ATen/WrapDimUtils.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/detail/KernelUtils.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cuda/Loops.cuh>
+#include <c10/cuda/CUDACachingAllocator.h>
+
+#include <cub/cub.cuh>
+
+#include <limits>
+
+namespace at { namespace native {
+
+namespace {
+
+// cub sorts the total number of items of a launch, not only the segments,
+// with int offsets
+constexpr int64_t max_items_per_launch = std::numeric_limits<int>::max();
+
+template <typename scalar_t>
+struct cub_key_type {
+  using type = scalar_t;
+};
+
+template <>
+struct cub_key_type<c10::Half> {
+  using type = __half;
+};
+
+// The offset of the first item of a segment, for segments of equal size
+struct SegmentOffset {
+  int segment_size;
+
+  __host__ __device__ __forceinline__ int operator()(int segment) const {
+    return segment * segment_size;
+  }
+};
+
+using SegmentOffsetIterator = cub::TransformInputIterator<
+    int,
+    SegmentOffset,
+    cub::CountingInputIterator<int>>;
+
+__global__ void fill_segment_index_kernel(
+    int64_t* index,
+    int64_t segment_size,
+    int64_t n) {
+  CUDA_KERNEL_LOOP_TYPE(i, n, int64_t) {
+    index[i] = i % segment_size;
+  }
+}
+
+// A single segment is sorted with DeviceRadixSort, which spreads it over the
+// whole device instead of over one block.  Values are not sorted if
+// values_out is null.
+template <typename key_t>
+cudaError_t cub_radix_sort(
+    void* temp_storage,
+    size_t& temp_storage_bytes,
+    const key_t* keys_in,
+    key_t* keys_out,
+    const int64_t* values_in,
+    int64_t* values_out,
+    int num_items,
+    int num_segments,
+    SegmentOffsetIterator begin_offsets,
+    bool descending,
+    cudaStream_t stream) {
+  constexpr int begin_bit = 0;
+  constexpr int end_bit = sizeof(key_t) * 8;
+  if (num_segments == 1) {
+    if (values_out == nullptr) {
+      return descending
+          ? cub::DeviceRadixSort::SortKeysDescending(
+                temp_storage, temp_storage_bytes, keys_in, keys_out,
+                num_items, begin_bit, end_bit, stream)
+          : cub::DeviceRadixSort::SortKeys(
+                temp_storage, temp_storage_bytes, keys_in, keys_out,
+                num_items, begin_bit, end_bit, stream);
+    }
+    return descending
+        ? cub::DeviceRadixSort::SortPairsDescending(
+              temp_storage, temp_storage_bytes, keys_in, keys_out, values_in,
+              values_out, num_items, begin_bit, end_bit, stream)
+        : cub::DeviceRadixSort::SortPairs(
+              temp_storage, temp_storage_bytes, keys_in, keys_out, values_in,
+              values_out, num_items, begin_bit, end_bit, stream);
+  }
+  if (values_out == nullptr) {
+    return descending
+        ? cub::DeviceSegmentedRadixSort::SortKeysDescending(
+              temp_storage, temp_storage_bytes, keys_in, keys_out, num_items,
+              num_segments, begin_offsets, begin_offsets + 1, begin_bit,
+              end_bit, stream)
+        : cub::DeviceSegmentedRadixSort::SortKeys(
+              temp_storage, temp_storage_bytes, keys_in, keys_out, num_items,
+              num_segments, begin_offsets, begin_offsets + 1, begin_bit,
+              end_bit, stream);
+  }
+  return descending
+      ? cub::DeviceSegmentedRadixSort::SortPairsDescending(
+            temp_storage, temp_storage_bytes, keys_in, keys_out, values_in,
+            values_out, num_items, num_segments, begin_offsets,
+            begin_offsets + 1, begin_bit, end_bit, stream)
+      : cub::DeviceSegmentedRadixSort::SortPairs(
+            temp_storage, temp_storage_bytes, keys_in, keys_out, values_in,
+            values_out, num_items, num_segments, begin_offsets,
+            begin_offsets + 1, begin_bit, end_bit, stream);
+}
+
+// Sorts the num_segments contiguous segments of segment_size keys (and
+// values, if values_out isn't null)
+template <typename scalar_t>
+void radix_sort_segments(
+    const scalar_t* keys_in,
+    scalar_t* keys_out,
+    const int64_t* values_in,
+    int64_t* values_out,
+    int64_t num_segments,
+    int64_t segment_size,
+    bool descending) {
+  using key_t = typename cub_key_type<scalar_t>::type;
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  auto& allocator = *c10::cuda::CUDACachingAllocator::get();
+  const int64_t segments_per_launch =
+      std::max<int64_t>(max_items_per_launch / segment_size, 1);
+  SegmentOffsetIterator begin_offsets(
+      cub::CountingInputIterator<int>(0),
+      SegmentOffset{static_cast<int>(segment_size)});
+
+  for (int64_t first = 0; first < num_segments; first += segments_per_launch) {
+    const int num = std::min(segments_per_launch, num_segments - first);
+    const int num_items = num * segment_size;
+    const int64_t offset = first * segment_size;
+    const key_t* launch_keys_in =
+        reinterpret_cast<const key_t*>(keys_in + offset);
+    key_t* launch_keys_out = reinterpret_cast<key_t*>(keys_out + offset);
+    const int64_t* launch_values_in =
+        values_out == nullptr ? nullptr : values_in + offset;
+    int64_t* launch_values_out =
+        values_out == nullptr ? nullptr : values_out + offset;
+
+    size_t temp_storage_bytes = 0;
+    AT_CUDA_CHECK(cub_radix_sort(
+        nullptr, temp_storage_bytes, launch_keys_in, launch_keys_out,
+        launch_values_in, launch_values_out, num_items, num, begin_offsets,
+        descending, stream));
+    auto temp_storage = allocator.allocate(temp_storage_bytes);
+    AT_CUDA_CHECK(cub_radix_sort(
+        temp_storage.get(), temp_storage_bytes, launch_keys_in,
+        launch_keys_out, launch_values_in, launch_values_out, num_items, num,
+        begin_offsets, descending, stream));
+  }
+}
+
+// Copies src into the contiguous keys, replacing the NaNs, whose sign bit and
+// payload would otherwise decide their order, by the positive quiet NaN,
+// which the radix sort orders after +inf, and -0.0 by 0.0, so that they keep
+// their order.
+void copy_sort_keys(const Tensor& keys, const Tensor& src) {
+  if (!at::isFloatingType(src.scalar_type())) {
+    keys.copy_(src);
+    return;
+  }
+  auto iter = TensorIteratorConfig()
+      .add_output(keys)
+      .add_input(src)
+      .build();
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(src.scalar_type(), "copy_sort_keys", [&] {
+    gpu_kernel(iter, []GPU_LAMBDA(scalar_t a) -> scalar_t {
+      if (at::_isnan(a)) {
+        return std::numeric_limits<scalar_t>::quiet_NaN();
+      }
+      return a == scalar_t(0) ? scalar_t(0) : a;
+    });
+  });
+}
+
+} // namespace
+
+bool can_use_radix_sort(const Tensor& self, int64_t dim) {
+  switch (self.scalar_type()) {
+    case kByte:
+    case kChar:
+    case kShort:
+    case kInt:
+    case kLong:
+    case kHalf:
+    case kFloat:
+    case kDouble:
+      break;
+    default:
+      return false;
+  }
+  if (self.dim() == 0) {
+    return false;
+  }
+  dim = maybe_wrap_dim(dim, self.dim());
+  return self.size(dim) <= max_items_per_launch;
+}
+
+void radix_sort_out_cuda(
+    const Tensor& self,
+    int64_t dim,
+    bool descending,
+    const Tensor& values,
+    const Tensor& indices) {
+  TORCH_INTERNAL_ASSERT(can_use_radix_sort(self, dim));
+  TORCH_INTERNAL_ASSERT(values.sizes() == self.sizes());
+  TORCH_INTERNAL_ASSERT(!indices.defined() || indices.sizes() == self.sizes());
+  dim = maybe_wrap_dim(dim, self.dim());
+  const int64_t numel = self.numel();
+  if (numel == 0) {
+    return;
+  }
+  const int64_t segment_size = self.size(dim);
+  const int64_t num_segments = numel / segment_size;
+
+  // The segments are the rows of contiguous tensors with dim innermost. The
+  // outputs are written in place if they are laid out like that.
+  Tensor keys = at::empty(self.transpose(dim, -1).sizes(), self.options());
+  copy_sort_keys(keys, self.transpose(dim, -1));
+  // The sorted keys of floating types differ from self in their NaNs and
+  // zeros, so the values are then gathered from self if there are indices.
+  const bool gather_values =
+      indices.defined() && at::isFloatingType(self.scalar_type());
+  Tensor values_t = values.transpose(dim, -1);
+  Tensor keys_out = values_t.is_contiguous() && !gather_values
+      ? values_t
+      : at::empty_like(keys);
+
+  Tensor indices_t, index_in, index_out;
+  if (indices.defined()) {
+    index_in = at::empty(keys.sizes(), indices.options());
+    fill_segment_index_kernel<<<
+        at::cuda::detail::GET_BLOCKS(numel),
+        at::cuda::detail::CUDA_NUM_THREADS,
+        0,
+        at::cuda::getCurrentCUDAStream()>>>(
+        index_in.data_ptr<int64_t>(), segment_size, numel);
+    C10_CUDA_KERNEL_LAUNCH_CHECK();
+    indices_t = indices.transpose(dim, -1);
+    index_out = indices_t.is_contiguous() ? indices_t : at::empty_like(index_in);
+  }
+
+  AT_DISPATCH_ALL_TYPES_AND(kHalf, self.scalar_type(), "radix_sort_out_cuda", [&] {
+    radix_sort_segments<scalar_t>(
+        keys.data_ptr<scalar_t>(),
+        keys_out.data_ptr<scalar_t>(),
+        indices.defined() ? index_in.data_ptr<int64_t>() : nullptr,
+        indices.defined() ? index_out.data_ptr<int64_t>() : nullptr,
+        num_segments,
+        segment_size,
+        descending);
+  });
+
+  if (indices.defined() && !index_out.is_same(indices_t)) {
+    indices_t.copy_(index_out);
+  }
+  if (gather_values) {
+    values.copy_(self.gather(dim, indices));
+  } else if (!keys_out.is_same(values_t)) {
+    values_t.copy_(keys_out);
+  }
+}
+
+}} // namespace at::native
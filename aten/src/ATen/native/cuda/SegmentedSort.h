@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <c10/macros/Export.h>
+
+namespace at { namespace native {
+
+// Whether radix_sort_out_cuda can sort self along dim, i.e. whether cub
+// supports its dtype and the slices fit in an int.
+TORCH_CUDA_CU_API bool can_use_radix_sort(const Tensor& self, int64_t dim);
+
+// Sorts all the slices of self along dim with cub's (segmented) radix sort,
+// sorting as many slices per launch as the 32-bit item count of cub allows.
+// The sort is stable: the indices of equal elements, including -0.0 and 0.0,
+// remain in increasing order.  NaNs are greater than any other value.  values
+// and indices must have the sizes of self; indices may be undefined, in which
+// case only the values are sorted, and their NaNs and zeros may lose their
+// sign.
+TORCH_CUDA_CU_API void radix_sort_out_cuda(
+    const Tensor& self,
+    int64_t dim,
+    bool descending,
+    const Tensor& values,
+    const Tensor& indices);
+
+}} // namespace at::native
@@ -12,6 +12,7 @@
 #include <ATen/native/SpectralOpsUtils.h>
 #include <ATen/native/cuda/CuFFTUtils.h>
 #include <ATen/native/cuda/CuFFTPlanCache.h>
+#include <ATen/native/cuda/Loops.cuh>
 #include <THC/THCTensorSort.cuh>
 #include <THC/THCThrustAllocator.cuh>
 
@@ -132,6 +133,27 @@ void _fft_fill_with_conjugate_symmetry_cuda_(
 
 REGISTER_DISPATCH(fft_fill_with_conjugate_symmetry_stub, &_fft_fill_with_conjugate_symmetry_cuda_);
 
+void spectrogram_power_kernel_cuda(TensorIterator& iter, double power) {
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "spectrogram_power_cuda", [&]() {
+    if (power == 2) {
+      gpu_kernel(iter, [] GPU_LAMBDA (c10::complex<scalar_t> z) -> scalar_t {
+        return z.real() * z.real() + z.imag() * z.imag();
+      });
+    } else if (power == 1) {
+      gpu_kernel(iter, [] GPU_LAMBDA (c10::complex<scalar_t> z) -> scalar_t {
+        return std::abs(z);
+      });
+    } else {
+      const auto p = static_cast<scalar_t>(power);
+      gpu_kernel(iter, [p] GPU_LAMBDA (c10::complex<scalar_t> z) -> scalar_t {
+        return std::pow(std::abs(z), p);
+      });
+    }
+  });
+}
+
+REGISTER_DISPATCH(spectrogram_power_stub, &spectrogram_power_kernel_cuda);
+
 // Execute a pre-planned tranform
 static void exec_cufft_plan(
     const CuFFTConfig &config, void* in_data, void* out_data, bool forward) {
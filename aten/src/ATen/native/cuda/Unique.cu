@@ -1,5 +1,6 @@
 #include <ATen/ATen.h>
 #include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/cuda/SegmentedSort.h>
 #include <THC/THCGeneral.h>
 #include <THC/THCThrustAllocator.cuh>
 #include <thrust/execution_policy.h>
@@ -84,22 +85,32 @@ std::tuple<Tensor, Tensor, Tensor> unique_cuda_template(
   auto policy = thrust::cuda::par(allocator).on(stream);
 
   auto options = self.options().dtype(kLong);
-  Tensor output = self.clone(at::MemoryFormat::Contiguous).reshape(-1);
-  int64_t num_inp = output.numel();
-  scalar_t* output_data = output.data_ptr<scalar_t>();
-
+  int64_t num_inp = self.numel();
+  Tensor output;
   Tensor sorted_indices;
-  if (!return_inverse) {
-    if (!consecutive) {
-      thrust::sort(policy, output_data, output_data + num_inp);
+  Tensor flat = self.reshape(-1);
+  if (!consecutive && can_use_radix_sort(flat, 0)) {
+    output = at::empty_like(flat, at::MemoryFormat::Contiguous);
+    if (return_inverse) {
+      sorted_indices = at::empty(flat.sizes(), options);
     }
+    radix_sort_out_cuda(flat, 0, /*descending=*/false, output, sorted_indices);
   } else {
-    sorted_indices = at::arange(0, num_inp, options);
-    if (!consecutive) {
-      int64_t *sorted_indices_ptr = sorted_indices.data_ptr<int64_t>();
-      thrust::sort_by_key(policy, output_data, output_data + num_inp, sorted_indices_ptr);
+    output = self.clone(at::MemoryFormat::Contiguous).reshape(-1);
+    scalar_t* output_data = output.data_ptr<scalar_t>();
+    if (!return_inverse) {
+      if (!consecutive) {
+        thrust::sort(policy, output_data, output_data + num_inp);
+      }
+    } else {
+      sorted_indices = at::arange(0, num_inp, options);
+      if (!consecutive) {
+        int64_t *sorted_indices_ptr = sorted_indices.data_ptr<int64_t>();
+        thrust::sort_by_key(policy, output_data, output_data + num_inp, sorted_indices_ptr);
+      }
     }
   }
+  scalar_t* output_data = output.data_ptr<scalar_t>();
 
   Tensor inverse_indices, counts;
   int64_t num_out;
@@ -1,6 +1,8 @@
 #include <ATen/ATen.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
+#include <ATen/native/cuda/MemoryAccess.cuh>
 #include <THC/THCAtomics.cuh>
 
 #include <math.h>
@@ -257,6 +259,34 @@ __device__ __forceinline__ static int nearest_neighbor_bw_compute_source_index(
   return src_index;
 }
 
+// The channels last kernels load and store vec_size channels of a pixel at
+// once: the widest vector that divides the channels and that both tensors are
+// aligned to.
+template <typename scalar_t>
+static inline int upsample_channels_last_vec_size(
+    int64_t channels,
+    const Tensor& src,
+    const Tensor& dst) {
+  int vec_size = std::min(
+      memory::can_vectorize_up_to<scalar_t>(static_cast<char*>(src.data_ptr())),
+      memory::can_vectorize_up_to<scalar_t>(static_cast<char*>(dst.data_ptr())));
+  while (channels % vec_size != 0) {
+    vec_size /= 2;
+  }
+  return vec_size;
+}
+
+// The grid of the channels last kernels, which loop over the n vectors they
+// process when there are more than the device holds at once.
+static inline int upsample_channels_last_num_blocks(int64_t n, int num_threads) {
+  const auto* properties = at::cuda::getCurrentDeviceProperties();
+  const int64_t max_blocks = static_cast<int64_t>(properties->multiProcessorCount) *
+      (properties->maxThreadsPerMultiProcessor / num_threads);
+  return std::max<int64_t>(
+      std::min<int64_t>(cuda::ATenCeilDiv(n, int64_t{num_threads}), max_blocks),
+      1);
+}
+
 /* Used by UpSampleBicubic2d.cu */
 template <typename scalar_t>
 __device__ __forceinline__ static scalar_t upsample_get_value_bounded(
@@ -151,6 +151,442 @@ __global__ void upsample_bilinear2d_backward_out_frame(
   }
 }
 
+// Fills the tables of the channels last kernels for the output rows (the
+// first output_height entries) and the output columns (the next output_width
+// entries): the two source indices each output index interpolates between and
+// the weight of the second one.
+template <typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(1024)
+__global__ void upsample_bilinear2d_compute_indices(
+    const int input_height,
+    const int input_width,
+    const int output_height,
+    const int output_width,
+    const accscalar_t rheight,
+    const accscalar_t rwidth,
+    const bool align_corners,
+    int* __restrict__ indices0,
+    int* __restrict__ indices1,
+    accscalar_t* __restrict__ lambdas1) {
+  const int index = threadIdx.x + blockIdx.x * blockDim.x;
+  if (index >= output_height + output_width) {
+    return;
+  }
+  const bool is_row = index < output_height;
+  const int dst_index = is_row ? index : index - output_height;
+  const int input_size = is_row ? input_height : input_width;
+  const accscalar_t src_index = area_pixel_compute_source_index<accscalar_t>(
+      is_row ? rheight : rwidth, dst_index, align_corners, /*cubic=*/false);
+  const int src_index0 = src_index;
+  indices0[index] = src_index0;
+  indices1[index] = src_index0 + ((src_index0 < input_size - 1) ? 1 : 0);
+  lambdas1[index] = src_index - src_index0;
+}
+
+// Fills starts[i], for the input rows i in [0, input_height] (the first
+// input_height + 1 entries) and the input columns i in [0, input_width] (the
+// next input_width + 1 entries), with the first output index whose source
+// index in `indices` is at least i. The source indices grow with the output
+// index, so the outputs interpolating from input i are
+// [starts[i], starts[i + 1]).
+C10_LAUNCH_BOUNDS_1(1024)
+__global__ void upsample_bilinear2d_compute_starts(
+    const int input_height,
+    const int input_width,
+    const int output_height,
+    const int output_width,
+    const int* __restrict__ indices,
+    int* __restrict__ starts) {
+  const int index = threadIdx.x + blockIdx.x * blockDim.x;
+  if (index >= input_height + input_width + 2) {
+    return;
+  }
+  const bool is_row = index <= input_height;
+  const int src_index = is_row ? index : index - input_height - 1;
+  const int* dst_indices = is_row ? indices : indices + output_height;
+  int lo = 0;
+  int hi = is_row ? output_height : output_width;
+  while (lo < hi) {
+    const int mid = lo + (hi - lo) / 2;
+    if (dst_indices[mid] < src_index) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  starts[index] = lo;
+}
+
+// Channels last forward: each thread computes vec_size channels of an output
+// pixel from the four neighbouring input pixels, with the source indices and
+// weights of its row and column read from the tables.
+template <typename scalar_t, typename accscalar_t, int vec_size>
+C10_LAUNCH_BOUNDS_1(1024)
+__global__ void upsample_bilinear2d_nhwc_out_frame(
+    const int64_t n,
+    const int channels,
+    const int input_height,
+    const int input_width,
+    const int output_height,
+    const int output_width,
+    const int* __restrict__ indices0,
+    const int* __restrict__ indices1,
+    const accscalar_t* __restrict__ lambdas1,
+    const scalar_t* __restrict__ idata,
+    scalar_t* __restrict__ odata) {
+  using vec_t = memory::aligned_vector<scalar_t, vec_size>;
+  const int channel_vecs = channels / vec_size;
+  for (int64_t index = threadIdx.x + blockIdx.x * blockDim.x; index < n;
+       index += blockDim.x * gridDim.x) {
+    int64_t index_temp = index;
+    const int c = (index_temp % channel_vecs) * vec_size;
+    index_temp /= channel_vecs;
+    const int w2 = index_temp % output_width;
+    index_temp /= output_width;
+    const int h2 = index_temp % output_height;
+    const int64_t nbatch = index_temp / output_height;
+    //
+    const accscalar_t h1lambda = lambdas1[h2];
+    const accscalar_t h0lambda = static_cast<accscalar_t>(1) - h1lambda;
+    const accscalar_t w1lambda = lambdas1[output_height + w2];
+    const accscalar_t w0lambda = static_cast<accscalar_t>(1) - w1lambda;
+    //
+    const scalar_t* batch_data =
+        idata + nbatch * input_height * input_width * channels + c;
+    const int64_t h0_offset = indices0[h2] * static_cast<int64_t>(input_width);
+    const int64_t h1_offset = indices1[h2] * static_cast<int64_t>(input_width);
+    const int w0 = indices0[output_height + w2];
+    const int w1 = indices1[output_height + w2];
+    const vec_t v00 = *reinterpret_cast<const vec_t*>(
+        batch_data + (h0_offset + w0) * channels);
+    const vec_t v01 = *reinterpret_cast<const vec_t*>(
+        batch_data + (h0_offset + w1) * channels);
+    const vec_t v10 = *reinterpret_cast<const vec_t*>(
+        batch_data + (h1_offset + w0) * channels);
+    const vec_t v11 = *reinterpret_cast<const vec_t*>(
+        batch_data + (h1_offset + w1) * channels);
+    vec_t out;
+#pragma unroll
+    for (int i = 0; i < vec_size; i++) {
+      const accscalar_t val = h0lambda *
+              (w0lambda * static_cast<accscalar_t>(v00.val[i]) +
+               w1lambda * static_cast<accscalar_t>(v01.val[i])) +
+          h1lambda *
+              (w0lambda * static_cast<accscalar_t>(v10.val[i]) +
+               w1lambda * static_cast<accscalar_t>(v11.val[i]));
+      out.val[i] = static_cast<scalar_t>(val);
+    }
+    *reinterpret_cast<vec_t*>(odata + index * vec_size) = out;
+  }
+}
+
+// Channels last backward: rather than scattering every output gradient into
+// the input gradient with atomics, each thread gathers vec_size channels of an
+// input pixel from the output pixels that interpolate from it, which the
+// starts tables give as ranges of rows and columns. The gradient is summed in
+// accscalar_t and the result is deterministic.
+template <typename scalar_t, typename accscalar_t, int vec_size>
+C10_LAUNCH_BOUNDS_1(1024)
+__global__ void upsample_bilinear2d_nhwc_backward_out_frame(
+    const int64_t n,
+    const int channels,
+    const int input_height,
+    const int input_width,
+    const int output_height,
+    const int output_width,
+    const accscalar_t* __restrict__ lambdas1,
+    const int* __restrict__ starts0,
+    const int* __restrict__ starts1,
+    scalar_t* __restrict__ idata,
+    const scalar_t* __restrict__ odata) {
+  using vec_t = memory::aligned_vector<scalar_t, vec_size>;
+  const int channel_vecs = channels / vec_size;
+  for (int64_t index = threadIdx.x + blockIdx.x * blockDim.x; index < n;
+       index += blockDim.x * gridDim.x) {
+    int64_t index_temp = index;
+    const int c = (index_temp % channel_vecs) * vec_size;
+    index_temp /= channel_vecs;
+    const int w1 = index_temp % input_width;
+    index_temp /= input_width;
+    const int h1 = index_temp % input_height;
+    const int64_t nbatch = index_temp / input_height;
+    //
+    const scalar_t* batch_grad =
+        odata + nbatch * output_height * output_width * channels + c;
+    accscalar_t grad[vec_size];
+#pragma unroll
+    for (int i = 0; i < vec_size; i++) {
+      grad[i] = static_cast<accscalar_t>(0);
+    }
+    for (int hside = 0; hside < 2; hside++) {
+      const int* hstarts = hside == 0 ? starts0 : starts1;
+      for (int h2 = hstarts[h1]; h2 < hstarts[h1 + 1]; h2++) {
+        const accscalar_t hlambda = hside == 0
+            ? static_cast<accscalar_t>(1) - lambdas1[h2]
+            : lambdas1[h2];
+        for (int wside = 0; wside < 2; wside++) {
+          const int* wstarts =
+              (wside == 0 ? starts0 : starts1) + input_height + 1;
+          for (int w2 = wstarts[w1]; w2 < wstarts[w1 + 1]; w2++) {
+            const accscalar_t w1lambda = lambdas1[output_height + w2];
+            const accscalar_t weight = hlambda *
+                (wside == 0 ? static_cast<accscalar_t>(1) - w1lambda
+                            : w1lambda);
+            const vec_t d2val = *reinterpret_cast<const vec_t*>(
+                batch_grad +
+                (static_cast<int64_t>(h2) * output_width + w2) * channels);
+#pragma unroll
+            for (int i = 0; i < vec_size; i++) {
+              grad[i] += weight * static_cast<accscalar_t>(d2val.val[i]);
+            }
+          }
+        }
+      }
+    }
+    vec_t out;
+#pragma unroll
+    for (int i = 0; i < vec_size; i++) {
+      out.val[i] = static_cast<scalar_t>(grad[i]);
+    }
+    *reinterpret_cast<vec_t*>(idata + index * vec_size) = out;
+  }
+}
+
+// Computes the tables of the output rows and columns, see
+// upsample_bilinear2d_compute_indices
+template <typename accscalar_t>
+static void upsample_bilinear2d_nhwc_indices(
+    Tensor& indices,
+    Tensor& lambdas,
+    const Tensor& input,
+    int input_height,
+    int input_width,
+    int output_height,
+    int output_width,
+    accscalar_t rheight,
+    accscalar_t rwidth,
+    bool align_corners) {
+  const int size = output_height + output_width;
+  indices = at::empty({2, size}, input.options().dtype(kInt));
+  lambdas = at::empty(
+      {size}, input.options().dtype(c10::CppTypeToScalarType<accscalar_t>::value));
+  const int num_threads = std::min(
+      at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock, 1024);
+  upsample_bilinear2d_compute_indices<accscalar_t>
+      <<<cuda::ATenCeilDiv(size, num_threads),
+         num_threads,
+         0,
+         at::cuda::getCurrentCUDAStream()>>>(
+          input_height,
+          input_width,
+          output_height,
+          output_width,
+          rheight,
+          rwidth,
+          align_corners,
+          indices.data_ptr<int>(),
+          indices.data_ptr<int>() + size,
+          lambdas.data_ptr<accscalar_t>());
+  C10_CUDA_KERNEL_LAUNCH_CHECK();
+}
+
+template <typename scalar_t, typename accscalar_t, int vec_size>
+static void upsample_bilinear2d_nhwc_out_launch(
+    const Tensor& output,
+    const Tensor& input,
+    const Tensor& indices,
+    const Tensor& lambdas,
+    int channels,
+    int input_height,
+    int input_width,
+    int output_height,
+    int output_width) {
+  const int64_t n = output.numel() / vec_size;
+  const int num_threads = std::min(
+      at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock, 512);
+  const int* indices_data = indices.data_ptr<int>();
+  upsample_bilinear2d_nhwc_out_frame<scalar_t, accscalar_t, vec_size>
+      <<<upsample_channels_last_num_blocks(n, num_threads),
+         num_threads,
+         0,
+         at::cuda::getCurrentCUDAStream()>>>(
+          n,
+          channels,
+          input_height,
+          input_width,
+          output_height,
+          output_width,
+          indices_data,
+          indices_data + output_height + output_width,
+          lambdas.data_ptr<accscalar_t>(),
+          input.data_ptr<scalar_t>(),
+          output.data_ptr<scalar_t>());
+  C10_CUDA_KERNEL_LAUNCH_CHECK();
+}
+
+template <typename scalar_t, typename accscalar_t, int vec_size>
+static void upsample_bilinear2d_nhwc_backward_out_launch(
+    const Tensor& grad_input,
+    const Tensor& grad_output,
+    const Tensor& lambdas,
+    const Tensor& starts,
+    int channels,
+    int input_height,
+    int input_width,
+    int output_height,
+    int output_width) {
+  const int64_t n = grad_input.numel() / vec_size;
+  const int num_threads = std::min(
+      at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock, 512);
+  const int* starts_data = starts.data_ptr<int>();
+  upsample_bilinear2d_nhwc_backward_out_frame<scalar_t, accscalar_t, vec_size>
+      <<<upsample_channels_last_num_blocks(n, num_threads),
+         num_threads,
+         0,
+         at::cuda::getCurrentCUDAStream()>>>(
+          n,
+          channels,
+          input_height,
+          input_width,
+          output_height,
+          output_width,
+          lambdas.data_ptr<accscalar_t>(),
+          starts_data,
+          starts_data + input_height + input_width + 2,
+          grad_input.data_ptr<scalar_t>(),
+          grad_output.data_ptr<scalar_t>());
+  C10_CUDA_KERNEL_LAUNCH_CHECK();
+}
+
+static void upsample_bilinear2d_nhwc_out_cuda_template(
+    const Tensor& output,
+    const Tensor& input_,
+    int input_height,
+    int input_width,
+    int output_height,
+    int output_width,
+    bool align_corners,
+    c10::optional<double> scales_h,
+    c10::optional<double> scales_w) {
+  if (output.numel() == 0) {
+    return;
+  }
+  // special case: just copy
+  if (input_height == output_height && input_width == output_width) {
+    output.copy_(input_);
+    return;
+  }
+  Tensor input = input_.contiguous(at::MemoryFormat::ChannelsLast);
+  const int channels = input.size(1);
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      ScalarType::Half, ScalarType::BFloat16,
+      input.scalar_type(), "upsample_bilinear2d_nhwc_out_frame", [&] {
+        using accscalar_t = at::acc_type<scalar_t, true>;
+
+        const accscalar_t rheight = area_pixel_compute_scale<accscalar_t>(
+            input_height, output_height, align_corners, scales_h);
+        const accscalar_t rwidth = area_pixel_compute_scale<accscalar_t>(
+            input_width, output_width, align_corners, scales_w);
+
+        Tensor indices, lambdas;
+        upsample_bilinear2d_nhwc_indices<accscalar_t>(
+            indices, lambdas, input, input_height, input_width,
+            output_height, output_width, rheight, rwidth, align_corners);
+
+        switch (upsample_channels_last_vec_size<scalar_t>(channels, input, output)) {
+          case 4:
+            upsample_bilinear2d_nhwc_out_launch<scalar_t, accscalar_t, 4>(
+                output, input, indices, lambdas, channels,
+                input_height, input_width, output_height, output_width);
+            break;
+          case 2:
+            upsample_bilinear2d_nhwc_out_launch<scalar_t, accscalar_t, 2>(
+                output, input, indices, lambdas, channels,
+                input_height, input_width, output_height, output_width);
+            break;
+          default:
+            upsample_bilinear2d_nhwc_out_launch<scalar_t, accscalar_t, 1>(
+                output, input, indices, lambdas, channels,
+                input_height, input_width, output_height, output_width);
+            break;
+        }
+      });
+}
+
+static void upsample_bilinear2d_nhwc_backward_out_cuda_template(
+    const Tensor& grad_input,
+    const Tensor& grad_output_,
+    int input_height,
+    int input_width,
+    int output_height,
+    int output_width,
+    bool align_corners,
+    c10::optional<double> scales_h,
+    c10::optional<double> scales_w) {
+  if (grad_input.numel() == 0) {
+    return;
+  }
+  Tensor grad_output = grad_output_.contiguous(at::MemoryFormat::ChannelsLast);
+  const int channels = grad_input.size(1);
+  const int num_threads = std::min(
+      at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock, 1024);
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      ScalarType::Half, ScalarType::BFloat16,
+      grad_output.scalar_type(), "upsample_bilinear2d_nhwc_backward_out_frame", [&] {
+        using accscalar_t = at::acc_type<scalar_t, true>;
+
+        const accscalar_t rheight = area_pixel_compute_scale<accscalar_t>(
+            input_height, output_height, align_corners, scales_h);
+        const accscalar_t rwidth = area_pixel_compute_scale<accscalar_t>(
+            input_width, output_width, align_corners, scales_w);
+
+        Tensor indices, lambdas;
+        upsample_bilinear2d_nhwc_indices<accscalar_t>(
+            indices, lambdas, grad_output, input_height, input_width,
+            output_height, output_width, rheight, rwidth, align_corners);
+
+        // The starts of the outputs by their first (starts[0]) and their
+        // second (starts[1]) source index.
+        const int starts_size = input_height + input_width + 2;
+        Tensor starts = at::empty({2, starts_size}, indices.options());
+        for (int side = 0; side < 2; side++) {
+          upsample_bilinear2d_compute_starts
+              <<<cuda::ATenCeilDiv(starts_size, num_threads),
+                 num_threads,
+                 0,
+                 stream>>>(
+                  input_height,
+                  input_width,
+                  output_height,
+                  output_width,
+                  indices[side].data_ptr<int>(),
+                  starts[side].data_ptr<int>());
+          C10_CUDA_KERNEL_LAUNCH_CHECK();
+        }
+
+        switch (upsample_channels_last_vec_size<scalar_t>(channels, grad_output, grad_input)) {
+          case 4:
+            upsample_bilinear2d_nhwc_backward_out_launch<scalar_t, accscalar_t, 4>(
+                grad_input, grad_output, lambdas, starts, channels,
+                input_height, input_width, output_height, output_width);
+            break;
+          case 2:
+            upsample_bilinear2d_nhwc_backward_out_launch<scalar_t, accscalar_t, 2>(
+                grad_input, grad_output, lambdas, starts, channels,
+                input_height, input_width, output_height, output_width);
+            break;
+          default:
+            upsample_bilinear2d_nhwc_backward_out_launch<scalar_t, accscalar_t, 1>(
+                grad_input, grad_output, lambdas, starts, channels,
+                input_height, input_width, output_height, output_width);
+            break;
+        }
+      });
+}
+
 static void upsample_bilinear2d_out_cuda_template(
     Tensor& output,
     const Tensor& input,
@@ -184,18 +620,28 @@ static void upsample_bilinear2d_out_cuda_template(
       output_height,
       output_width);
 
-  output.resize_({input.size(0), input.size(1), output_height, output_width});
+  output.resize_(
+      {input.size(0), input.size(1), output_height, output_width},
+      input.suggest_memory_format());
 
   AT_ASSERT(
       input_height > 0 && input_width > 0 && output_height > 0 &&
       output_width > 0);
 
+  if (input.suggest_memory_format() == at::MemoryFormat::ChannelsLast) {
+    upsample_bilinear2d_nhwc_out_cuda_template(
+        output, input, input_height, input_width, output_height, output_width,
+        align_corners, scales_h, scales_w);
+    return;
+  }
+
   const int num_kernels = output_height * output_width;
   const int num_threads = std::min(
       at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock, 1024);
   cudaStream_t stream = at::cuda::getCurrentCUDAStream();
 
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      ScalarType::Half, ScalarType::BFloat16,
       input.scalar_type(), "upsample_bilinear2d_out_frame", [&] {
         using accscalar_t = at::acc_type<scalar_t, true>;
 
@@ -259,6 +705,16 @@ static void upsample_bilinear2d_backward_out_cuda_template(
       output_height,
       output_width);
 
+  if (grad_output_.suggest_memory_format() == at::MemoryFormat::ChannelsLast) {
+    grad_input.resize_(
+        {nbatch, channels, input_height, input_width},
+        at::MemoryFormat::ChannelsLast);
+    upsample_bilinear2d_nhwc_backward_out_cuda_template(
+        grad_input, grad_output_, input_height, input_width, output_height,
+        output_width, align_corners, scales_h, scales_w);
+    return;
+  }
+
   Tensor grad_output = grad_output_.contiguous();
 
   grad_input.resize_({nbatch, channels, input_height, input_width});
@@ -278,7 +734,8 @@ static void upsample_bilinear2d_backward_out_cuda_template(
       at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock, 1024);
   cudaStream_t stream = at::cuda::getCurrentCUDAStream();
 
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      ScalarType::Half, ScalarType::BFloat16,
       grad_output.scalar_type(), "upsample_bilinear2d_backward_out_frame", [&] {
         using accscalar_t = at::acc_type<scalar_t, true>;
 
@@ -344,8 +801,11 @@ Tensor& upsample_bilinear2d_backward_out_cuda(
     c10::optional<double> scales_h,
     c10::optional<double> scales_w) {
   // See Note [Writing Nondeterministic Operations]
-  // Nondeterministic because of atomicAdd usage
-  globalContext().alertNotDeterministic("upsample_bilinear2d_backward_out_cuda");
+  // Nondeterministic because of atomicAdd usage, the channels last kernel
+  // gathers the gradient instead
+  if (grad_output.suggest_memory_format() != at::MemoryFormat::ChannelsLast) {
+    globalContext().alertNotDeterministic("upsample_bilinear2d_backward_out_cuda");
+  }
   upsample_bilinear2d_backward_out_cuda_template(
       grad_input, grad_output, output_size, input_size, align_corners, scales_h, scales_w);
   return grad_input;
@@ -359,8 +819,11 @@ Tensor upsample_bilinear2d_backward_cuda(
     c10::optional<double> scales_h,
     c10::optional<double> scales_w) {
   // See Note [Writing Nondeterministic Operations]
-  // Nondeterministic because of atomicAdd usage
-  globalContext().alertNotDeterministic("upsample_bilinear2d_backward_cuda");
+  // Nondeterministic because of atomicAdd usage, the channels last kernel
+  // gathers the gradient instead
+  if (grad_output.suggest_memory_format() != at::MemoryFormat::ChannelsLast) {
+    globalContext().alertNotDeterministic("upsample_bilinear2d_backward_cuda");
+  }
   Tensor grad_input = at::empty_like(grad_output, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   upsample_bilinear2d_backward_out_cuda_template(
       grad_input, grad_output, output_size, input_size, align_corners, scales_h, scales_w);
@@ -389,8 +852,11 @@ Tensor upsample_bilinear2d_backward_cuda(
     IntArrayRef input_size,
     bool align_corners,
     c10::optional<ArrayRef<double>> scale_factors) {
-  // Nondeterministic because of atomicAdd usage
-  globalContext().alertNotDeterministic("upsample_bilinear2d_backward_cuda");
+  // Nondeterministic because of atomicAdd usage, the channels last kernel
+  // gathers the gradient instead
+  if (grad_output.suggest_memory_format() != at::MemoryFormat::ChannelsLast) {
+    globalContext().alertNotDeterministic("upsample_bilinear2d_backward_cuda");
+  }
   auto osize = compute_output_size(input_size, output_size, scale_factors);
   auto scale_h = get_scale_value(scale_factors, 0);
   auto scale_w = get_scale_value(scale_factors, 1);
@@ -111,6 +111,305 @@ __global__ void upsample_nearest2d_backward_out_frame(
   }
 }
 
+// Fills the first dst_height entries of `indices` with the source indices of
+// the destination rows and the next dst_width entries with the source indices
+// of the destination columns, for the forward or the backward mapping of
+// NOTE [ Nearest neighbor upsampling kernel implementation ]. The backward
+// tables have an entry past the last row and column, so that the outputs of
+// input row i are [indices[i], indices[i + 1]).
+template <bool backward>
+C10_LAUNCH_BOUNDS_1(1024)
+__global__ void upsample_nearest2d_compute_indices(
+    const int dst_height,
+    const int dst_width,
+    const int src_height,
+    const int src_width,
+    const float height_scale,
+    const float width_scale,
+    int* __restrict__ indices) {
+  const int index = threadIdx.x + blockIdx.x * blockDim.x;
+  if (index >= dst_height + dst_width) {
+    return;
+  }
+  const bool is_row = index < dst_height;
+  const int dst_index = is_row ? index : index - dst_height;
+  const int dst_size = is_row ? dst_height : dst_width;
+  const int src_size = is_row ? src_height : src_width;
+  const float scale = is_row ? height_scale : width_scale;
+  if (backward) {
+    indices[index] =
+        nearest_neighbor_bw_compute_source_index(scale, dst_index, src_size);
+  } else {
+    indices[index] = dst_size == src_size
+        ? dst_index
+        : nearest_neighbor_compute_source_index(scale, dst_index, src_size);
+  }
+}
+
+// Channels last forward: each thread copies vec_size channels of an output
+// pixel from its source pixel.
+template <typename scalar_t, int vec_size>
+C10_LAUNCH_BOUNDS_1(1024)
+__global__ void upsample_nearest2d_nhwc_out_frame(
+    const int64_t n,
+    const int channels,
+    const int input_height,
+    const int input_width,
+    const int output_height,
+    const int output_width,
+    const int* __restrict__ indices,
+    const scalar_t* __restrict__ idata,
+    scalar_t* __restrict__ odata) {
+  using vec_t = memory::aligned_vector<scalar_t, vec_size>;
+  const int channel_vecs = channels / vec_size;
+  for (int64_t index = threadIdx.x + blockIdx.x * blockDim.x; index < n;
+       index += blockDim.x * gridDim.x) {
+    int64_t index_temp = index;
+    const int c = (index_temp % channel_vecs) * vec_size;
+    index_temp /= channel_vecs;
+    const int w2 = index_temp % output_width;
+    index_temp /= output_width;
+    const int h2 = index_temp % output_height;
+    const int64_t nbatch = index_temp / output_height;
+
+    const int h1 = indices[h2];
+    const int w1 = indices[output_height + w2];
+    const int64_t src_index =
+        ((nbatch * input_height + h1) * input_width + w1) * channels + c;
+    *reinterpret_cast<vec_t*>(odata + index * vec_size) =
+        *reinterpret_cast<const vec_t*>(idata + src_index);
+  }
+}
+
+// Channels last backward: each thread sums vec_size channels of the output
+// gradient over the block of output pixels an input pixel was copied to.
+template <typename scalar_t, typename accscalar_t, int vec_size>
+C10_LAUNCH_BOUNDS_1(1024)
+__global__ void upsample_nearest2d_nhwc_backward_out_frame(
+    const int64_t n,
+    const int channels,
+    const int input_height,
+    const int input_width,
+    const int output_height,
+    const int output_width,
+    const int* __restrict__ indices,
+    scalar_t* __restrict__ grad_i,
+    const scalar_t* __restrict__ grad_o) {
+  using vec_t = memory::aligned_vector<scalar_t, vec_size>;
+  const int channel_vecs = channels / vec_size;
+  const int* col_indices = indices + input_height + 1;
+  for (int64_t index = threadIdx.x + blockIdx.x * blockDim.x; index < n;
+       index += blockDim.x * gridDim.x) {
+    int64_t index_temp = index;
+    const int c = (index_temp % channel_vecs) * vec_size;
+    index_temp /= channel_vecs;
+    const int w1 = index_temp % input_width;
+    index_temp /= input_width;
+    const int h1 = index_temp % input_height;
+    const int64_t nbatch = index_temp / input_height;
+
+    const scalar_t* batch_grad =
+        grad_o + nbatch * output_height * output_width * channels + c;
+    accscalar_t grad[vec_size];
+#pragma unroll
+    for (int i = 0; i < vec_size; i++) {
+      grad[i] = static_cast<accscalar_t>(0);
+    }
+    for (int y = indices[h1]; y < indices[h1 + 1]; y++) {
+      for (int x = col_indices[w1]; x < col_indices[w1 + 1]; x++) {
+        const vec_t val = *reinterpret_cast<const vec_t*>(
+            batch_grad + (static_cast<int64_t>(y) * output_width + x) * channels);
+#pragma unroll
+        for (int i = 0; i < vec_size; i++) {
+          grad[i] += static_cast<accscalar_t>(val.val[i]);
+        }
+      }
+    }
+    vec_t out;
+#pragma unroll
+    for (int i = 0; i < vec_size; i++) {
+      out.val[i] = static_cast<scalar_t>(grad[i]);
+    }
+    *reinterpret_cast<vec_t*>(grad_i + index * vec_size) = out;
+  }
+}
+
+// Computes the source index tables, see upsample_nearest2d_compute_indices
+template <bool backward>
+static Tensor upsample_nearest2d_nhwc_indices(
+    const Tensor& input,
+    int dst_height,
+    int dst_width,
+    int src_height,
+    int src_width,
+    float height_scale,
+    float width_scale) {
+  const int size = dst_height + dst_width;
+  Tensor indices = at::empty({size}, input.options().dtype(kInt));
+  const int num_threads = std::min(
+      at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock, 1024);
+  upsample_nearest2d_compute_indices<backward>
+      <<<cuda::ATenCeilDiv(size, num_threads),
+         num_threads,
+         0,
+         at::cuda::getCurrentCUDAStream()>>>(
+          dst_height,
+          dst_width,
+          src_height,
+          src_width,
+          height_scale,
+          width_scale,
+          indices.data_ptr<int>());
+  C10_CUDA_KERNEL_LAUNCH_CHECK();
+  return indices;
+}
+
+template <typename scalar_t, int vec_size>
+static void upsample_nearest2d_nhwc_out_launch(
+    const Tensor& output,
+    const Tensor& input,
+    const Tensor& indices,
+    int channels,
+    int input_height,
+    int input_width,
+    int output_height,
+    int output_width) {
+  const int64_t n = output.numel() / vec_size;
+  const int num_threads = std::min<int>(
+      at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock, MAX_THREADS);
+  upsample_nearest2d_nhwc_out_frame<scalar_t, vec_size>
+      <<<upsample_channels_last_num_blocks(n, num_threads),
+         num_threads,
+         0,
+         at::cuda::getCurrentCUDAStream()>>>(
+          n,
+          channels,
+          input_height,
+          input_width,
+          output_height,
+          output_width,
+          indices.data_ptr<int>(),
+          input.data_ptr<scalar_t>(),
+          output.data_ptr<scalar_t>());
+  C10_CUDA_KERNEL_LAUNCH_CHECK();
+}
+
+template <typename scalar_t, typename accscalar_t, int vec_size>
+static void upsample_nearest2d_nhwc_backward_out_launch(
+    const Tensor& grad_input,
+    const Tensor& grad_output,
+    const Tensor& indices,
+    int channels,
+    int input_height,
+    int input_width,
+    int output_height,
+    int output_width) {
+  const int64_t n = grad_input.numel() / vec_size;
+  const int num_threads = std::min<int>(
+      at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock, MAX_THREADS);
+  upsample_nearest2d_nhwc_backward_out_frame<scalar_t, accscalar_t, vec_size>
+      <<<upsample_channels_last_num_blocks(n, num_threads),
+         num_threads,
+         0,
+         at::cuda::getCurrentCUDAStream()>>>(
+          n,
+          channels,
+          input_height,
+          input_width,
+          output_height,
+          output_width,
+          indices.data_ptr<int>(),
+          grad_input.data_ptr<scalar_t>(),
+          grad_output.data_ptr<scalar_t>());
+  C10_CUDA_KERNEL_LAUNCH_CHECK();
+}
+
+static void upsample_nearest2d_nhwc_out_cuda_template(
+    const Tensor& output,
+    const Tensor& input_,
+    int input_height,
+    int input_width,
+    int output_height,
+    int output_width,
+    c10::optional<double> scales_h,
+    c10::optional<double> scales_w) {
+  if (output.numel() == 0) {
+    return;
+  }
+  Tensor input = input_.contiguous(at::MemoryFormat::ChannelsLast);
+  const int channels = input.size(1);
+
+  const float height_scale = compute_scales_value<float>(scales_h, input_height, output_height);
+  const float width_scale = compute_scales_value<float>(scales_w, input_width, output_width);
+  Tensor indices = upsample_nearest2d_nhwc_indices</*backward=*/false>(
+      input, output_height, output_width, input_height, input_width,
+      height_scale, width_scale);
+
+  AT_DISPATCH_FLOATING_TYPES_AND3(ScalarType::Half, ScalarType::BFloat16, ScalarType::Byte, input.scalar_type(), "upsample_nearest2d_nhwc_out_frame", [&] {
+        switch (upsample_channels_last_vec_size<scalar_t>(channels, input, output)) {
+          case 4:
+            upsample_nearest2d_nhwc_out_launch<scalar_t, 4>(
+                output, input, indices, channels,
+                input_height, input_width, output_height, output_width);
+            break;
+          case 2:
+            upsample_nearest2d_nhwc_out_launch<scalar_t, 2>(
+                output, input, indices, channels,
+                input_height, input_width, output_height, output_width);
+            break;
+          default:
+            upsample_nearest2d_nhwc_out_launch<scalar_t, 1>(
+                output, input, indices, channels,
+                input_height, input_width, output_height, output_width);
+            break;
+        }
+      });
+}
+
+static void upsample_nearest2d_nhwc_backward_out_cuda_template(
+    const Tensor& grad_input,
+    const Tensor& grad_output_,
+    int input_height,
+    int input_width,
+    int output_height,
+    int output_width,
+    c10::optional<double> scales_h,
+    c10::optional<double> scales_w) {
+  if (grad_input.numel() == 0) {
+    return;
+  }
+  Tensor grad_output = grad_output_.contiguous(at::MemoryFormat::ChannelsLast);
+  const int channels = grad_input.size(1);
+
+  const float height_scale = compute_scales_value_backwards<float>(scales_h, output_height, input_height);
+  const float width_scale = compute_scales_value_backwards<float>(scales_w, output_width, input_width);
+  Tensor indices = upsample_nearest2d_nhwc_indices</*backward=*/true>(
+      grad_output, input_height + 1, input_width + 1, output_height,
+      output_width, height_scale, width_scale);
+
+  AT_DISPATCH_FLOATING_TYPES_AND3(ScalarType::Half, ScalarType::BFloat16, ScalarType::Byte, grad_output.scalar_type(), "upsample_nearest2d_nhwc_backward_out_frame", [&] {
+        using accscalar_t = at::acc_type<scalar_t, true>;
+
+        switch (upsample_channels_last_vec_size<scalar_t>(channels, grad_output, grad_input)) {
+          case 4:
+            upsample_nearest2d_nhwc_backward_out_launch<scalar_t, accscalar_t, 4>(
+                grad_input, grad_output, indices, channels,
+                input_height, input_width, output_height, output_width);
+            break;
+          case 2:
+            upsample_nearest2d_nhwc_backward_out_launch<scalar_t, accscalar_t, 2>(
+                grad_input, grad_output, indices, channels,
+                input_height, input_width, output_height, output_width);
+            break;
+          default:
+            upsample_nearest2d_nhwc_backward_out_launch<scalar_t, accscalar_t, 1>(
+                grad_input, grad_output, indices, channels,
+                input_height, input_width, output_height, output_width);
+            break;
+        }
+      });
+}
+
 static void upsample_nearest2d_out_cuda_template(
     const Tensor& output,
     const Tensor& input_,
@@ -148,6 +447,16 @@ static void upsample_nearest2d_out_cuda_template(
       input_height > 0 && input_width > 0 && output_height > 0 &&
       output_width > 0);
 
+  if (input_.suggest_memory_format() == at::MemoryFormat::ChannelsLast) {
+    output.resize_(
+        {nbatch, channels, output_height, output_width},
+        at::MemoryFormat::ChannelsLast);
+    upsample_nearest2d_nhwc_out_cuda_template(
+        output, input_, input_height, input_width, output_height, output_width,
+        scales_h, scales_w);
+    return;
+  }
+
   Tensor input = input_.contiguous();
   output.resize_({nbatch, channels, output_height, output_width});
 
@@ -188,7 +497,7 @@ static void upsample_nearest2d_out_cuda_template(
       "input tensor has spatial dimension larger than the kernel capacity");
 
   cudaStream_t stream = at::cuda::getCurrentCUDAStream();
-  AT_DISPATCH_FLOATING_TYPES_AND2(ScalarType::Half, ScalarType::Byte, input.scalar_type(), "upsample_nearest2d_out_frame", [&] {
+  AT_DISPATCH_FLOATING_TYPES_AND3(ScalarType::Half, ScalarType::BFloat16, ScalarType::Byte, input.scalar_type(), "upsample_nearest2d_out_frame", [&] {
         using accscalar_t = at::acc_type<scalar_t, true>;
 
         auto idata = input.data_ptr<scalar_t>();
@@ -253,6 +562,16 @@ static void upsample_nearest2d_backward_out_cuda_template(
       output_height,
       output_width);
 
+  if (grad_output_.suggest_memory_format() == at::MemoryFormat::ChannelsLast) {
+    grad_input.resize_(
+        {nbatch, channels, input_height, input_width},
+        at::MemoryFormat::ChannelsLast);
+    upsample_nearest2d_nhwc_backward_out_cuda_template(
+        grad_input, grad_output_, input_height, input_width, output_height,
+        output_width, scales_h, scales_w);
+    return;
+  }
+
   Tensor grad_output = grad_output_.contiguous();
   grad_input.resize_({nbatch, channels, input_height, input_width});
 
@@ -269,7 +588,7 @@ static void upsample_nearest2d_backward_out_cuda_template(
   TORCH_CHECK(grad_input.numel() <= std::numeric_limits<int32_t>::max());
 
   cudaStream_t stream = at::cuda::getCurrentCUDAStream();
-  AT_DISPATCH_FLOATING_TYPES_AND2(ScalarType::Half, ScalarType::Byte, grad_output.scalar_type(), "upsample_nearest2d_backward_out_frame", [&] {
+  AT_DISPATCH_FLOATING_TYPES_AND3(ScalarType::Half, ScalarType::BFloat16, ScalarType::Byte, grad_output.scalar_type(), "upsample_nearest2d_backward_out_frame", [&] {
         using accscalar_t = at::acc_type<scalar_t, true>;
 
         auto idata = grad_input.data_ptr<scalar_t>();
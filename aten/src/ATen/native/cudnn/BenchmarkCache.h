@@ -0,0 +1,40 @@
+#pragma once
+
+#include <c10/macros/Export.h>
+
+#include <string>
+
+namespace at { namespace native {
+
+// The algorithms found for cuDNN convolutions (see BenchmarkCache in
+// Conv_v7.cpp) can be persisted so that restarted processes, the other
+// processes of a host or the other ranks of a job don't search for them
+// again.  An entry is keyed by its ConvolutionParams (which include the
+// requested math mode, i.e. allow_tf32), the name of the device it was found
+// on and the cuDNN version, and stores the chosen algorithm, math type and
+// workspace size.  Entries are only imported for the current device and cuDNN
+// version; saving preserves the entries of other devices and versions already
+// in the file.
+//
+// If the environment variable TORCH_CUDNN_BENCHMARK_CACHE_FILE is set, the
+// caches are loaded from that file on first use and saved to it whenever an
+// algorithm is benchmarked.
+
+// Serializes the entries of all the caches of this process.
+TORCH_CUDA_CPP_API std::string exportCudnnBenchmarkCache();
+
+// Adds the entries of a state returned by exportCudnnBenchmarkCache, and
+// returns the number of entries added.
+TORCH_CUDA_CPP_API size_t importCudnnBenchmarkCache(const std::string& state);
+
+// Merges the entries of all the caches of this process into the file at path,
+// which is replaced atomically.
+TORCH_CUDA_CPP_API void saveCudnnBenchmarkCache(const std::string& path);
+
+// Adds the entries of the file at path, and returns the number of entries
+// added.
+TORCH_CUDA_CPP_API size_t loadCudnnBenchmarkCache(const std::string& path);
+
+TORCH_CUDA_CPP_API void clearCudnnBenchmarkCache();
+
+}}  // namespace at::native
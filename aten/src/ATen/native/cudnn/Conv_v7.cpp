@@ -9,7 +9,9 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/Config.h>
+#include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/Exceptions.h>
+#include <ATen/native/cudnn/BenchmarkCache.h>
 #include <ATen/native/cudnn/ConvShared.h>
 
 #include <THC/THC.h>
@@ -23,11 +25,24 @@
 #include <iterator>
 #include <sstream>
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <stdint.h>
+#include <tuple>
 #include <unordered_map>
 
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
 // Note [behavior of cudnnFind and cudnnGet]
 // You'll notice that by default, in the ConvolutionDescriptor, we do the following:
 //
@@ -98,8 +113,15 @@ std::ostream& operator<<(std::ostream & out, const ConvolutionArgs& args) {
 // TODO: Use something less heavy duty than a big honking mutex
 template <typename T>
 struct BenchmarkCache {
+  // The perf result of an entry, and the device it was found on whose name
+  // it is persisted with
+  struct Entry {
+    T perf;
+    int device;
+  };
+
   std::mutex mutex;
-  std::unordered_map<ConvolutionParams, T, ParamsHash<ConvolutionParams>, ParamsEqual<ConvolutionParams>> map;
+  std::unordered_map<ConvolutionParams, Entry, ParamsHash<ConvolutionParams>, ParamsEqual<ConvolutionParams>> map;
 
   bool find(const ConvolutionParams& params, T* results) {
     std::lock_guard<std::mutex> guard(mutex);
@@ -107,13 +129,33 @@ struct BenchmarkCache {
     if (it == map.end()) {
       return false;
     }
-    *results = it->second;
+    *results = it->second.perf;
     return true;
   }
 
-  void insert(const ConvolutionParams& params, const T& results) {
+  // Returns whether there was no entry for params yet
+  bool insert(const ConvolutionParams& params, const T& results, int device) {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = map.find(params);
+    if (it == map.end()) {
+      map.emplace(params, Entry{results, device});
+      return true;
+    }
+    it->second = Entry{results, device};
+    return false;
+  }
+
+  template <typename F>
+  void forEach(F f) {
+    std::lock_guard<std::mutex> guard(mutex);
+    for (const auto& kv : map) {
+      f(kv.first, kv.second);
+    }
+  }
+
+  void clear() {
     std::lock_guard<std::mutex> guard(mutex);
-    map[params] = results;
+    map.clear();
   }
 };
 
@@ -121,6 +163,302 @@ BenchmarkCache<cudnnConvolutionFwdAlgoPerf_t> fwd_algos;
 BenchmarkCache<cudnnConvolutionBwdDataAlgoPerf_t> bwd_data_algos;
 BenchmarkCache<cudnnConvolutionBwdFilterAlgoPerf_t> bwd_filter_algos;
 
+// ---------------------------------------------------------------------
+//
+// Persistence of the benchmark caches (see BenchmarkCache.h)
+//
+// ---------------------------------------------------------------------
+
+namespace {
+
+// The raw bytes of the POD params and perf structs are persisted; they are
+// only read back for the same cuDNN version, and only if their sizes match
+// the ones of this build.
+enum BenchmarkKind : uint8_t {
+  kForward = 0,
+  kBackwardData = 1,
+  kBackwardFilter = 2,
+};
+
+// kind, cuDNN version, device name and params bytes
+using BenchmarkRecordKey = std::tuple<uint8_t, uint64_t, std::string, std::string>;
+// perf bytes by key
+using BenchmarkRecords = std::map<BenchmarkRecordKey, std::string>;
+
+constexpr char kBenchmarkCacheMagic[] = "PTCUDNNB";
+constexpr uint32_t kBenchmarkCacheFormatVersion = 1;
+
+template <typename T>
+std::string bytesOf(const T& value) {
+  return std::string(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool fromBytes(const std::string& bytes, T* value) {
+  if (bytes.size() != sizeof(T)) {
+    return false;
+  }
+  memcpy(value, bytes.data(), sizeof(T));
+  return true;
+}
+
+std::string deviceName(int device) {
+  return at::cuda::getDeviceProperties(device)->name;
+}
+
+template <typename T>
+void appendPod(std::string& out, T value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void appendString(std::string& out, const std::string& value) {
+  appendPod(out, static_cast<uint32_t>(value.size()));
+  out.append(value);
+}
+
+std::string serializeRecords(const BenchmarkRecords& records) {
+  std::string out(kBenchmarkCacheMagic, sizeof(kBenchmarkCacheMagic) - 1);
+  appendPod(out, kBenchmarkCacheFormatVersion);
+  appendPod(out, static_cast<uint64_t>(records.size()));
+  for (const auto& record : records) {
+    appendPod(out, std::get<0>(record.first));
+    appendPod(out, std::get<1>(record.first));
+    appendString(out, std::get<2>(record.first));
+    appendString(out, std::get<3>(record.first));
+    appendString(out, record.second);
+  }
+  return out;
+}
+
+struct RecordReader {
+  const std::string& in;
+  size_t pos = 0;
+
+  explicit RecordReader(const std::string& in) : in(in) {}
+
+  template <typename T>
+  bool readPod(T* value) {
+    if (in.size() - pos < sizeof(T)) {
+      return false;
+    }
+    memcpy(value, in.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+
+  bool readString(std::string* value) {
+    uint32_t size = 0;
+    if (!readPod(&size) || in.size() - pos < size) {
+      return false;
+    }
+    value->assign(in, pos, size);
+    pos += size;
+    return true;
+  }
+};
+
+void deserializeRecords(const std::string& state, BenchmarkRecords& records) {
+  const size_t magic_size = sizeof(kBenchmarkCacheMagic) - 1;
+  TORCH_CHECK(
+      state.compare(0, magic_size, kBenchmarkCacheMagic) == 0,
+      "Not a cuDNN benchmark cache");
+  RecordReader reader(state);
+  reader.pos = magic_size;
+  uint32_t format_version = 0;
+  uint64_t num_records = 0;
+  TORCH_CHECK(
+      reader.readPod(&format_version) &&
+          format_version == kBenchmarkCacheFormatVersion,
+      "Unsupported cuDNN benchmark cache format version ", format_version);
+  TORCH_CHECK(reader.readPod(&num_records), "Truncated cuDNN benchmark cache");
+  for (uint64_t i = 0; i < num_records; i++) {
+    uint8_t kind = 0;
+    uint64_t cudnn_version = 0;
+    std::string device_name, params, perf;
+    TORCH_CHECK(
+        reader.readPod(&kind) && reader.readPod(&cudnn_version) &&
+            reader.readString(&device_name) && reader.readString(&params) &&
+            reader.readString(&perf),
+        "Truncated cuDNN benchmark cache");
+    records[BenchmarkRecordKey(kind, cudnn_version, device_name, params)] =
+        std::move(perf);
+  }
+}
+
+template <typename T>
+void collectRecords(
+    BenchmarkCache<T>& cache,
+    uint8_t kind,
+    BenchmarkRecords& records) {
+  const uint64_t cudnn_version = cudnnGetVersion();
+  std::unordered_map<int, std::string> device_names;
+  cache.forEach([&](const ConvolutionParams& params,
+                    const typename BenchmarkCache<T>::Entry& entry) {
+    auto it = device_names.find(entry.device);
+    if (it == device_names.end()) {
+      it = device_names.emplace(entry.device, deviceName(entry.device)).first;
+    }
+    records[BenchmarkRecordKey(kind, cudnn_version, it->second, bytesOf(params))] =
+        bytesOf(entry.perf);
+  });
+}
+
+BenchmarkRecords collectAllRecords() {
+  BenchmarkRecords records;
+  collectRecords(fwd_algos, kForward, records);
+  collectRecords(bwd_data_algos, kBackwardData, records);
+  collectRecords(bwd_filter_algos, kBackwardFilter, records);
+  return records;
+}
+
+// Imports the records of kind for the current device and cuDNN version
+template <typename T>
+size_t importRecords(
+    const BenchmarkRecords& records,
+    uint8_t kind,
+    BenchmarkCache<T>& cache) {
+  const uint64_t cudnn_version = cudnnGetVersion();
+  const int device = at::cuda::current_device();
+  const std::string device_name = deviceName(device);
+  size_t num_imported = 0;
+  for (const auto& record : records) {
+    if (std::get<0>(record.first) != kind ||
+        std::get<1>(record.first) != cudnn_version ||
+        std::get<2>(record.first) != device_name) {
+      continue;
+    }
+    ConvolutionParams params;
+    T perf;
+    if (fromBytes(std::get<3>(record.first), &params) &&
+        fromBytes(record.second, &perf)) {
+      cache.insert(params, perf, device);
+      num_imported++;
+    }
+  }
+  return num_imported;
+}
+
+size_t importAllRecords(const BenchmarkRecords& records) {
+  return importRecords(records, kForward, fwd_algos) +
+      importRecords(records, kBackwardData, bwd_data_algos) +
+      importRecords(records, kBackwardFilter, bwd_filter_algos);
+}
+
+// Returns false if there is no file at path
+bool readFile(const std::string& path, std::string* contents) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  contents->assign(
+      std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return true;
+}
+
+// The file the caches are persisted to, if any
+const char* benchmarkCacheFile() {
+  static const char* path = std::getenv("TORCH_CUDNN_BENCHMARK_CACHE_FILE");
+  return path;
+}
+
+void loadBenchmarkCacheFileOnce() {
+  static std::once_flag once;
+  std::call_once(once, [] {
+    const char* path = benchmarkCacheFile();
+    std::string contents;
+    if (path == nullptr || !readFile(path, &contents)) {
+      return;
+    }
+    try {
+      BenchmarkRecords records;
+      deserializeRecords(contents, records);
+      importAllRecords(records);
+    } catch (const c10::Error& e) {
+      TORCH_WARN(
+          "Ignoring the cuDNN benchmark cache file ", path, ": ", e.what_without_backtrace());
+    }
+  });
+}
+
+void saveBenchmarkCacheFile() {
+  const char* path = benchmarkCacheFile();
+  if (path == nullptr) {
+    return;
+  }
+  try {
+    saveCudnnBenchmarkCache(path);
+  } catch (const c10::Error& e) {
+    TORCH_WARN(
+        "Failed to save the cuDNN benchmark cache file ", path, ": ", e.what_without_backtrace());
+  }
+}
+
+} // namespace
+
+std::string exportCudnnBenchmarkCache() {
+  return serializeRecords(collectAllRecords());
+}
+
+size_t importCudnnBenchmarkCache(const std::string& state) {
+  BenchmarkRecords records;
+  deserializeRecords(state, records);
+  return importAllRecords(records);
+}
+
+// Concurrent savers of the same file may drop each other's new entries, which
+// are saved again with the next entry they find.
+void saveCudnnBenchmarkCache(const std::string& path) {
+  BenchmarkRecords records;
+  std::string contents;
+  if (readFile(path, &contents)) {
+    try {
+      deserializeRecords(contents, records);
+    } catch (const c10::Error&) {
+      // replaced by the entries of this process
+      records.clear();
+    }
+  }
+  for (auto& record : collectAllRecords()) {
+    records[record.first] = std::move(record.second);
+  }
+
+#ifdef _WIN32
+  const int pid = _getpid();
+#else
+  const int pid = getpid();
+#endif
+  static std::atomic<uint64_t> num_saves{0};
+  std::ostringstream tmp_path;
+  tmp_path << path << ".tmp." << pid << "." << num_saves++;
+  {
+    std::ofstream file(tmp_path.str(), std::ios::binary | std::ios::trunc);
+    TORCH_CHECK(file, "Unable to open ", tmp_path.str(), " for writing");
+    const std::string state = serializeRecords(records);
+    file.write(state.data(), state.size());
+    TORCH_CHECK(file, "Unable to write ", tmp_path.str());
+  }
+#ifdef _WIN32
+  // std::rename doesn't replace existing files on Windows
+  std::remove(path.c_str());
+#endif
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.str().c_str());
+    TORCH_CHECK(false, "Unable to replace ", path);
+  }
+}
+
+size_t loadCudnnBenchmarkCache(const std::string& path) {
+  std::string contents;
+  TORCH_CHECK(readFile(path, &contents), "Unable to open ", path);
+  return importCudnnBenchmarkCache(contents);
+}
+
+void clearCudnnBenchmarkCache() {
+  fwd_algos.clear();
+  bwd_data_algos.clear();
+  bwd_filter_algos.clear();
+}
+
 // TODO: Stop manually allocating CUDA memory; allocate an ATen byte
 // tensor instead.
 struct Workspace {
@@ -495,6 +833,9 @@ public:
     bool only_use_default = args.params.deterministic && !benchmark;
 
     auto& cache = search::cache();
+    if (!only_use_default) {
+      loadBenchmarkCacheFileOnce();
+    }
     perf_t algoPerf;
     if (!only_use_default && cache.find(args.params, &algoPerf)) {
       try {
@@ -509,7 +850,9 @@ public:
     for (auto &algoPerf : perfResults) {
       try {
         f(algoPerf);
-        cache.insert(args.params, algoPerf);
+        if (cache.insert(args.params, algoPerf, at::cuda::current_device()) && benchmark) {
+          saveBenchmarkCacheFile();
+        }
         return;
       } catch (c10::CUDAOutOfMemoryError &e) {
         cudaGetLastError(); // clear CUDA error
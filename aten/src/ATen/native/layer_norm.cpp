@@ -103,6 +103,108 @@ Tensor layer_norm(
 
 DEFINE_DISPATCH(LayerNormKernel);
 DEFINE_DISPATCH(LayerNormBackwardKernel);
+DEFINE_DISPATCH(AddLayerNormKernel);
+
+namespace {
+
+// The scaled dropout noise of _dropout_impl (see Dropout.cpp), or an undefined
+// tensor when dropout is disabled.
+Tensor add_layer_norm_noise(const Tensor& input, double p, bool train) {
+  TORCH_CHECK(p >= 0 && p <= 1, "dropout probability has to be between 0 and 1, but got ", p);
+  if (p == 0 || !train || input.numel() == 0) {
+    return Tensor();
+  }
+  if (p == 1) {
+    return at::zeros_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  }
+  auto noise = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  noise.bernoulli_(1 - p);
+  return noise.div_(1 - p);
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> math_add_layer_norm(
+    const Tensor& input,
+    const Tensor& residual,
+    IntArrayRef normalized_shape,
+    const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */,
+    double eps,
+    double p,
+    bool train) {
+  Tensor noise = add_layer_norm_noise(input, p, train);
+  Tensor sum = noise.defined() ? residual + input * noise : residual + input;
+  auto outputs = at::native_layer_norm(sum, normalized_shape, weight, bias, eps);
+  return std::make_tuple(
+      std::get<0>(outputs), sum, noise, std::get<1>(outputs), std::get<2>(outputs));
+}
+
+// Computes sum = residual + dropout(input, p, train) and
+// output = layer_norm(sum). Returns (output, sum, noise, mean, rstd); noise is
+// undefined when dropout is disabled. Operands that need broadcasting or type
+// promotion take the unfused path.
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> add_layer_norm_cpu(
+    const Tensor& input,
+    const Tensor& residual,
+    IntArrayRef normalized_shape,
+    const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */,
+    double eps,
+    double p,
+    bool train) {
+  if (!input.sizes().equals(residual.sizes()) ||
+      input.scalar_type() != residual.scalar_type()) {
+    return math_add_layer_norm(
+        input, residual, normalized_shape, weight, bias, eps, p, train);
+  }
+  Tensor noise = add_layer_norm_noise(input, p, train);
+
+  auto inputs = _prepare_layer_norm_inputs(input, normalized_shape, weight, bias);
+  auto X = std::get<0>(inputs);
+  auto gamma = std::get<1>(inputs);
+  auto beta = std::get<2>(inputs);
+  auto M = std::get<3>(inputs);
+  auto N = std::get<4>(inputs);
+  const auto& R = residual.is_contiguous() ? residual : residual.contiguous();
+
+  Tensor S = at::native::empty_like(X, at::MemoryFormat::Contiguous);
+  Tensor Y = at::native::empty_like(X, at::MemoryFormat::Contiguous);
+  Tensor mean = at::empty({M}, X.options());
+  Tensor rstd = at::empty({M}, X.options());
+  if (M > 0) {
+    AddLayerNormKernel(kCPU, X, R, noise, gamma, beta, M, N, eps, &S, &Y, &mean, &rstd);
+
+    const auto input_shape = input.sizes();
+    const size_t axis = input.dim() - normalized_shape.size();
+
+    std::vector<int64_t> stat_shape;
+    for (size_t idx = 0; idx < axis; ++idx) {
+      stat_shape.push_back(input_shape[idx]);
+    }
+    for (size_t idx = axis; idx < input.dim(); ++idx) {
+      stat_shape.push_back(1);
+    }
+
+    mean = mean.view(stat_shape);
+    rstd = rstd.view(stat_shape);
+  }
+  return std::make_tuple(
+      std::move(Y), std::move(S), std::move(noise), std::move(mean), std::move(rstd));
+}
+
+Tensor add_layer_norm(
+    const Tensor& input,
+    const Tensor& residual,
+    IntArrayRef normalized_shape,
+    const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */,
+    double eps,
+    double p,
+    bool train) {
+  return std::get<0>(at::_add_layer_norm(
+      input, residual, normalized_shape, weight, bias, eps, p, train));
+}
 
 // Ported from pytorch/xla repo
 std::tuple<Tensor, Tensor, Tensor> math_native_layer_norm(
@@ -34,13 +34,10 @@
   [encoder setComputePipelineState:state];
   [encoder setTexture:[_X texture] atIndex:0];
   [encoder setTexture:[_Y texture] atIndex:1];
-  id<MTLBuffer> clampBuffer = [[MPSCNNContext sharedInstance].device
-      newBufferWithLength:2 * sizeof(fp16)
-                  options:MTLResourceOptionCPUCacheModeWriteCombined];
-  fp16* clampBufferPtr = (fp16*)[clampBuffer contents];
-  clampBufferPtr[0] = _min.floatValue;
-  clampBufferPtr[1] = _max.floatValue;
-  [encoder setBuffer:clampBuffer offset:0 atIndex:0];
+  // small enough to be copied in the command buffer, rather than a buffer
+  // allocated for each clamp
+  const fp16 clampValues[2] = {(fp16)_min.floatValue, (fp16)_max.floatValue};
+  [encoder setBytes:clampValues length:sizeof(clampValues) atIndex:0];
   const auto& launchParams =
       at::native::metal::mpscnn::spatialPointwiseKernelLaunchParams(state, _Y);
   [encoder dispatchThreadgroups:launchParams.threadgroupsPerGrid
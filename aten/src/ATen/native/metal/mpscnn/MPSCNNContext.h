@@ -14,5 +14,12 @@ API_AVAILABLE(ios(10.0), macos(10.13))
 - (id<MTLComputePipelineState>)specializedPipelineState:(NSString*)kernel
                                               Constants:(NSArray<NSNumber*>*)
                                                             constants;
+// The MPS kernel cached under the key on the current thread, or made by the
+// constructor block. The key must hold every parameter the kernel was
+// initialized with. Kernels are not shared across threads, as they can't be
+// encoded from several threads at once.
+- (__kindof MPSKernel*)kernelForKey:(NSString*)key
+                        constructor:(MPSKernel* (^)(id<MTLDevice> device))
+                                        constructor;
 
 @end
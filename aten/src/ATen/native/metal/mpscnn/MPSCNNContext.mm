@@ -10,6 +10,8 @@
 #import <Foundation/NSProcessInfo.h>
 #endif
 
+NSString* kernel_cache_key = @"PTKernelCache";
+
 @implementation MPSCNNContext {
   std::mutex _pipelineCacheMutex;
   NSMutableDictionary<NSString*, id<MTLComputePipelineState>>* _pipelineCache;
@@ -92,8 +94,11 @@
   for (auto i = 0; i < constants.count; ++i) {
     kernelStr += "_" + std::string([constants[i] stringValue].UTF8String);
   }
+  NSString* specializedKernel =
+      [NSString stringWithCString:kernelStr.c_str()
+                         encoding:NSUTF8StringEncoding];
   std::lock_guard<std::mutex> g(_pipelineCacheMutex);
-  id<MTLComputePipelineState> state = _pipelineCache[kernel];
+  id<MTLComputePipelineState> state = _pipelineCache[specializedKernel];
   if (state) {
     return state;
   }
@@ -130,10 +135,26 @@
       func, "Couldn't get function: ", errors.localizedDescription.UTF8String);
   state = [_device newComputePipelineStateWithFunction:func error:&errors];
   TORCH_CHECK(state != nil, errors.localizedDescription.UTF8String);
-  kernel = [NSString stringWithCString:kernelStr.c_str()
-                              encoding:NSUTF8StringEncoding];
-  _pipelineCache[kernel] = state;
+  _pipelineCache[specializedKernel] = state;
   return state;
 }
 
+- (__kindof MPSKernel*)kernelForKey:(NSString*)key
+                        constructor:(MPSKernel* (^)(id<MTLDevice> device))
+                                        constructor {
+  NSMutableDictionary* dict = [[NSThread currentThread] threadDictionary];
+  NSMutableDictionary<NSString*, MPSKernel*>* cache = dict[kernel_cache_key];
+  if (!cache) {
+    cache = [NSMutableDictionary<NSString*, MPSKernel*> new];
+    dict[kernel_cache_key] = cache;
+  }
+  MPSKernel* kernel = cache[key];
+  if (!kernel) {
+    kernel = constructor(_device);
+    TORCH_CHECK(kernel != nil, "Failed to create the kernel ", key.UTF8String);
+    cache[key] = kernel;
+  }
+  return kernel;
+}
+
 @end
@@ -145,16 +145,23 @@ Tensor max_pool2d(
   const int64_t dH = dilation[0];
   const int64_t dW = dilation[1];
   MPSImage* X = imageFromTensor(input);
-  MPSCNNPoolingMax* pool = [[MPSCNNPoolingMax alloc]
-       initWithDevice:[MPSCNNContext sharedInstance].device
-          kernelWidth:kernel_size[0]
-         kernelHeight:kernel_size[1]
-      strideInPixelsX:stride[0]
-      strideInPixelsY:stride[1]];
-  [pool setEdgeMode:MPSImageEdgeModeClamp];
-  [pool setOffset:{.x = static_cast<NSInteger>(kernel_size[0] / 2),
-                   .y = static_cast<NSInteger>(kernel_size[1] / 2),
-                   .z = 0}];
+  NSString* key = [NSString stringWithFormat:@"max_pool2d_%lld_%lld_%lld_%lld",
+                                             kH, kW, sH, sW];
+  MPSCNNPoolingMax* pool = [[MPSCNNContext sharedInstance]
+      kernelForKey:key
+       constructor:^MPSKernel*(id<MTLDevice> device) {
+         MPSCNNPoolingMax* kernel = [[MPSCNNPoolingMax alloc]
+              initWithDevice:device
+                 kernelWidth:kH
+                kernelHeight:kW
+             strideInPixelsX:sH
+             strideInPixelsY:sW];
+         [kernel setEdgeMode:MPSImageEdgeModeClamp];
+         [kernel setOffset:{.x = static_cast<NSInteger>(kH / 2),
+                            .y = static_cast<NSInteger>(kW / 2),
+                            .z = 0}];
+         return kernel;
+       }];
 
   int64_t oN = iN;
   int64_t oC = iC;
@@ -176,16 +183,25 @@ Tensor max_pool2d(
 API_AVAILABLE(ios(10.0), macos(10.13))
 Tensor global_avg_pool2d(const Tensor& input, IntArrayRef output_size) {
   MPSImage* X = imageFromTensor(input);
-  MPSCNNPoolingAverage* pool = [[MPSCNNPoolingAverage alloc]
-       initWithDevice:[MPSCNNContext sharedInstance].device
-          kernelWidth:X.width
-         kernelHeight:X.height
-      strideInPixelsX:X.width
-      strideInPixelsY:X.height];
-  [pool setEdgeMode:MPSImageEdgeModeClamp];
-  [pool setOffset:{.x = static_cast<NSInteger>(X.width / 2),
-                   .y = static_cast<NSInteger>(X.height / 2),
-                   .z = 0}];
+  const NSUInteger width = X.width;
+  const NSUInteger height = X.height;
+  NSString* key = [NSString
+      stringWithFormat:@"global_avg_pool2d_%lu_%lu", width, height];
+  MPSCNNPoolingAverage* pool = [[MPSCNNContext sharedInstance]
+      kernelForKey:key
+       constructor:^MPSKernel*(id<MTLDevice> device) {
+         MPSCNNPoolingAverage* kernel = [[MPSCNNPoolingAverage alloc]
+              initWithDevice:device
+                 kernelWidth:width
+                kernelHeight:height
+             strideInPixelsX:width
+             strideInPixelsY:height];
+         [kernel setEdgeMode:MPSImageEdgeModeClamp];
+         [kernel setOffset:{.x = static_cast<NSInteger>(width / 2),
+                            .y = static_cast<NSInteger>(height / 2),
+                            .z = 0}];
+         return kernel;
+       }];
   std::vector<int64_t> outputSize{
       input.sizes()[0], input.sizes()[1], output_size[0], output_size[1]};
   MetalTensor mt{outputSize};
@@ -513,12 +529,26 @@ Tensor binaryElementwiseMPSCNNKernel(
   TORCH_CHECK([cb1 isEqual:cb2], @"inputs have different command buffer");
   mt.texture()->allocateTemporaryTextureStorage(outputSize, cb1);
   MPSImage* Y = imageFromMetalTensor(mt);
-  T* kernel = [[T alloc]
-      initWithDevice:[MPSCNNContext sharedInstance].device];
-  kernel.primaryStrideInPixelsY = (NSUInteger)(input1.sizes()[2] == 1 ? 0 : 1);
-  kernel.primaryStrideInPixelsX = (NSUInteger)(input1.sizes()[3] == 1 ? 0 : 1);
-  kernel.secondaryStrideInPixelsY = (NSUInteger)(input2.sizes()[2] == 1 ? 0 : 1);
-  kernel.secondaryStrideInPixelsX = (NSUInteger)(input2.sizes()[3] == 1 ? 0 : 1);
+  const NSUInteger primaryStrideY = input1.sizes()[2] == 1 ? 0 : 1;
+  const NSUInteger primaryStrideX = input1.sizes()[3] == 1 ? 0 : 1;
+  const NSUInteger secondaryStrideY = input2.sizes()[2] == 1 ? 0 : 1;
+  const NSUInteger secondaryStrideX = input2.sizes()[3] == 1 ? 0 : 1;
+  NSString* key = [NSString stringWithFormat:@"%@_%lu_%lu_%lu_%lu",
+                                             NSStringFromClass([T class]),
+                                             primaryStrideY,
+                                             primaryStrideX,
+                                             secondaryStrideY,
+                                             secondaryStrideX];
+  T* kernel = [[MPSCNNContext sharedInstance]
+      kernelForKey:key
+       constructor:^MPSKernel*(id<MTLDevice> device) {
+         T* kernel = [[T alloc] initWithDevice:device];
+         kernel.primaryStrideInPixelsY = primaryStrideY;
+         kernel.primaryStrideInPixelsX = primaryStrideX;
+         kernel.secondaryStrideInPixelsY = secondaryStrideY;
+         kernel.secondaryStrideInPixelsX = secondaryStrideX;
+         return kernel;
+       }];
   [kernel encodeToCommandBuffer:cb1.buffer
       primaryImage:X1
       secondaryImage:X2
@@ -544,8 +574,11 @@ Tensor& binaryElementwiseMPSCNNKernel_(
   TORCH_CHECK([cb1 isEqual:cb2], @"inputs have different command buffer");
   mt.texture()->allocateTemporaryTextureStorage(outputSize, cb1);
   MPSImage* Y = imageFromMetalTensor(mt);
-  T* kernel = [[T alloc]
-      initWithDevice:[MPSCNNContext sharedInstance].device];
+  T* kernel = [[MPSCNNContext sharedInstance]
+      kernelForKey:NSStringFromClass([T class])
+       constructor:^MPSKernel*(id<MTLDevice> device) {
+         return [[T alloc] initWithDevice:device];
+       }];
   [kernel encodeToCommandBuffer:cb1.buffer
       primaryImage:X1
       secondaryImage:X2
@@ -604,8 +637,11 @@ Tensor t(const Tensor& input) {
   mt.texture()->allocateTemporaryTextureStorage(
       {1, 1, sizes[1], sizes[0]}, commandBuffer);
   MPSImage* Y = imageFromMetalTensor(mt);
-  MPSImageTranspose* transpose = [[MPSImageTranspose alloc]
-      initWithDevice:[MPSCNNContext sharedInstance].device];
+  MPSImageTranspose* transpose = [[MPSCNNContext sharedInstance]
+      kernelForKey:@"transpose"
+       constructor:^MPSKernel*(id<MTLDevice> device) {
+         return [[MPSImageTranspose alloc] initWithDevice:device];
+       }];
   [transpose encodeToCommandBuffer:commandBuffer.buffer
                        sourceImage:X
                   destinationImage:Y];
@@ -643,8 +679,11 @@ Tensor log_softmax_int(const Tensor& input) {
   MPSImage* X = imageFromTensor(input);
   TORCH_CHECK(X.height == 1 && X.width == 1);
   std::vector<int64_t> outputSize = input.sizes().vec();
-  MPSCNNLogSoftMax* logSoftmax = [[MPSCNNLogSoftMax alloc]
-      initWithDevice:[MPSCNNContext sharedInstance].device];
+  MPSCNNLogSoftMax* logSoftmax = [[MPSCNNContext sharedInstance]
+      kernelForKey:@"log_softmax"
+       constructor:^MPSKernel*(id<MTLDevice> device) {
+         return [[MPSCNNLogSoftMax alloc] initWithDevice:device];
+       }];
 
   MetalTensor mt{outputSize};
   MetalCommandBuffer* commandBuffer = commandBufferFromInputTensor(input);
@@ -690,10 +729,18 @@ Tensor upsample_nearest2d_vec(
   mt.texture()->allocateTemporaryTextureStorage(outputSizes, commandBuffer);
   MPSImage* Y = imageFromMetalTensor(mt);
   if (@available(iOS 11.0, *)) {
-    MPSCNNUpsamplingNearest* kernel = [[MPSCNNUpsamplingNearest alloc]
-        initWithDevice:[MPSCNNContext sharedInstance].device
-        integerScaleFactorX:(NSUInteger)scale_w.value()
-        integerScaleFactorY:(NSUInteger)scale_h.value()];
+    const NSUInteger scaleX = (NSUInteger)scale_w.value();
+    const NSUInteger scaleY = (NSUInteger)scale_h.value();
+    NSString* key = [NSString
+        stringWithFormat:@"upsample_nearest2d_%lu_%lu", scaleX, scaleY];
+    MPSCNNUpsamplingNearest* kernel = [[MPSCNNContext sharedInstance]
+        kernelForKey:key
+         constructor:^MPSKernel*(id<MTLDevice> device) {
+           return [[MPSCNNUpsamplingNearest alloc]
+                    initWithDevice:device
+               integerScaleFactorX:scaleX
+               integerScaleFactorY:scaleY];
+         }];
     [kernel encodeToCommandBuffer:commandBuffer.buffer
                       sourceImage:X
                  destinationImage:Y];
@@ -37,6 +37,22 @@ Tensor& _fft_c2c_mkl_out(Tensor& out, const Tensor& self, IntArrayRef dim, int64
   AT_ERROR("fft: ATen not compiled with MKL support");
 }
 
+int64_t _mkl_fft_get_plan_cache_size() {
+  AT_ERROR("fft: ATen not compiled with MKL support");
+}
+
+int64_t _mkl_fft_get_plan_cache_max_size() {
+  AT_ERROR("fft: ATen not compiled with MKL support");
+}
+
+void _mkl_fft_set_plan_cache_max_size(int64_t max_size) {
+  AT_ERROR("fft: ATen not compiled with MKL support");
+}
+
+void _mkl_fft_clear_plan_cache() {
+  AT_ERROR("fft: ATen not compiled with MKL support");
+}
+
 }}
 
 #else // AT_MKL_ENABLED
@@ -49,11 +65,17 @@ Tensor& _fft_c2c_mkl_out(Tensor& out, const Tensor& self, IntArrayRef dim, int64
 #include <ATen/Utils.h>
 
 #include <ATen/native/TensorIterator.h>
+#include <ATen/native/utils/ParamsHash.h>
 
 #include <algorithm>
 #include <vector>
 #include <numeric>
 #include <cmath>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <mkl_dfti.h>
 #include <ATen/mkl/Exceptions.h>
@@ -288,6 +310,219 @@ static DftiDescriptor _plan_mkl_fft(
   return descriptor;
 }
 
+// NOTE [ MKL FFT Plan Cache ]
+//
+// Creating and committing a DFTI descriptor costs much more than running a
+// small transform, so the committed descriptors are cached, like the cuFFT
+// plans (see native/cuda/CuFFTPlanCache.h). Each thread has its own LRU
+// cache, so a descriptor is only ever used by the thread that committed it.
+// The caches of all the threads are registered so that
+// torch.backends.mkl.fft_plan_cache can resize and clear all of them. The
+// descriptors are held by shared_ptrs, so a cache can be cleared while its
+// thread computes with one of them.
+
+// The transforms of more signal dimensions are planned for every call
+constexpr int64_t mkl_fft_max_cached_rank = 3;
+
+// The default capacity of the cache of each thread. Descriptors hold their
+// twiddle factors, so this is smaller than the default of the cuFFT cache.
+constexpr int64_t mkl_fft_default_cache_size = 256;
+
+// The key to the plan cache: all the arguments of _plan_mkl_fft
+struct MklFFTParams {
+  int64_t signal_ndim_;
+  // These include the batch dimension as well
+  int64_t sizes_[mkl_fft_max_cached_rank + 1];
+  int64_t input_strides_[mkl_fft_max_cached_rank + 1];
+  int64_t output_strides_[mkl_fft_max_cached_rank + 1];
+  int64_t normalization_;
+  bool complex_input_;
+  bool complex_output_;
+  bool forward_;
+  ScalarType value_type_;
+
+  MklFFTParams() = default;
+
+  MklFFTParams(IntArrayRef in_strides, IntArrayRef out_strides, IntArrayRef sizes,
+               bool complex_input, bool complex_output,
+               int64_t normalization, bool forward, ScalarType value_type) {
+    // Padding bits must be zeroed for hashing
+    memset(this, 0, sizeof(*this));
+    signal_ndim_ = sizes.size() - 1;
+    TORCH_INTERNAL_ASSERT(1 <= signal_ndim_ && signal_ndim_ <= mkl_fft_max_cached_rank);
+    std::copy(sizes.cbegin(), sizes.cend(), sizes_);
+    std::copy(in_strides.cbegin(), in_strides.cend(), input_strides_);
+    std::copy(out_strides.cbegin(), out_strides.cend(), output_strides_);
+    normalization_ = normalization;
+    complex_input_ = complex_input;
+    complex_output_ = complex_output;
+    forward_ = forward;
+    value_type_ = value_type;
+  }
+};
+
+static_assert(std::is_trivial<MklFFTParams>::value, "");
+
+class MklFFTPlanCache;
+
+// All the plan caches, and the capacity of each of them
+struct MklFFTPlanCacheRegistry {
+  std::mutex mutex;
+  std::unordered_set<MklFFTPlanCache*> caches;
+  int64_t max_size = mkl_fft_default_cache_size;
+
+  // Leaked, because threads may exit after the static destructors ran
+  static MklFFTPlanCacheRegistry& get() {
+    static auto* registry = new MklFFTPlanCacheRegistry();
+    return *registry;
+  }
+};
+
+// The LRU plan cache of a thread. Its mutex is only contended when the cache
+// is resized, cleared or counted from the registry.
+class MklFFTPlanCache {
+public:
+  using plan_t = std::shared_ptr<DftiDescriptor>;
+  using kv_t = typename std::pair<MklFFTParams, plan_t>;
+  using map_t = typename std::unordered_map<std::reference_wrapper<MklFFTParams>,
+                                            typename std::list<kv_t>::iterator,
+                                            ParamsHash<MklFFTParams>,
+                                            ParamsEqual<MklFFTParams>>;
+
+  MklFFTPlanCache() {
+    auto& registry = MklFFTPlanCacheRegistry::get();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    max_size_ = registry.max_size;
+    registry.caches.insert(this);
+  }
+
+  ~MklFFTPlanCache() {
+    auto& registry = MklFFTPlanCacheRegistry::get();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    registry.caches.erase(this);
+  }
+
+  static MklFFTPlanCache& current() {
+    static thread_local MklFFTPlanCache cache;
+    return cache;
+  }
+
+  // Returns the plan for params, or nullptr if it isn't cached
+  plan_t find(MklFFTParams params) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto map_it = cache_map_.find(params);
+    if (map_it == cache_map_.end()) {
+      return nullptr;
+    }
+    // Hit, put to list front
+    usage_list_.splice(usage_list_.begin(), usage_list_, map_it->second);
+    return map_it->second->second;
+  }
+
+  void insert(MklFFTParams params, plan_t plan) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (max_size_ == 0 || cache_map_.count(params) > 0) {
+      return;
+    }
+    evict(max_size_ - 1);
+    usage_list_.emplace_front(params, std::move(plan));
+    cache_map_.emplace(usage_list_.front().first, usage_list_.begin());
+  }
+
+  void resize(int64_t max_size) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    max_size_ = max_size;
+    evict(max_size_);
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    cache_map_.clear();
+    usage_list_.clear();
+  }
+
+  int64_t size() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return cache_map_.size();
+  }
+
+private:
+  // Removes the least recently used plans until at most max_size are left
+  void evict(int64_t max_size) {
+    while (static_cast<int64_t>(usage_list_.size()) > max_size) {
+      cache_map_.erase(usage_list_.back().first);
+      usage_list_.pop_back();
+    }
+  }
+
+  std::mutex mutex_;
+  std::list<kv_t> usage_list_;
+  map_t cache_map_;
+  int64_t max_size_;
+};
+
+// Returns the committed descriptor of a transform, from the plan cache of the
+// current thread if possible. See _plan_mkl_fft for the arguments.
+static std::shared_ptr<DftiDescriptor> _get_mkl_fft_plan(
+    IntArrayRef in_strides, IntArrayRef out_strides, IntArrayRef sizes,
+    bool complex_input, bool complex_output,
+    int64_t normalization, bool forward, ScalarType dtype) {
+  auto make_plan = [&] {
+    return std::make_shared<DftiDescriptor>(_plan_mkl_fft(
+        in_strides, out_strides, sizes, complex_input, complex_output,
+        normalization, forward, dtype));
+  };
+  if (static_cast<int64_t>(sizes.size()) - 1 > mkl_fft_max_cached_rank) {
+    return make_plan();
+  }
+
+  const MklFFTParams params(in_strides, out_strides, sizes, complex_input,
+                            complex_output, normalization, forward, dtype);
+  auto& cache = MklFFTPlanCache::current();
+  auto plan = cache.find(params);
+  if (!plan) {
+    // Committing can be slow, it is done without holding the cache's lock
+    plan = make_plan();
+    cache.insert(params, plan);
+  }
+  return plan;
+}
+
+int64_t _mkl_fft_get_plan_cache_size() {
+  auto& registry = MklFFTPlanCacheRegistry::get();
+  std::lock_guard<std::mutex> guard(registry.mutex);
+  int64_t size = 0;
+  for (auto* cache : registry.caches) {
+    size += cache->size();
+  }
+  return size;
+}
+
+int64_t _mkl_fft_get_plan_cache_max_size() {
+  auto& registry = MklFFTPlanCacheRegistry::get();
+  std::lock_guard<std::mutex> guard(registry.mutex);
+  return registry.max_size;
+}
+
+void _mkl_fft_set_plan_cache_max_size(int64_t max_size) {
+  TORCH_CHECK(max_size >= 0,
+              "MKL FFT plan cache size must be non-negative, but got ", max_size);
+  auto& registry = MklFFTPlanCacheRegistry::get();
+  std::lock_guard<std::mutex> guard(registry.mutex);
+  registry.max_size = max_size;
+  for (auto* cache : registry.caches) {
+    cache->resize(max_size);
+  }
+}
+
+void _mkl_fft_clear_plan_cache() {
+  auto& registry = MklFFTPlanCacheRegistry::get();
+  std::lock_guard<std::mutex> guard(registry.mutex);
+  for (auto* cache : registry.caches) {
+    cache->clear();
+  }
+}
+
 // Execute a general fft operation (can be c2c, onesided r2c or onesided c2r)
 static Tensor& _exec_fft(Tensor& out, const Tensor& self, IntArrayRef out_sizes,
                          IntArrayRef dim, int64_t normalization, bool forward) {
@@ -340,15 +575,15 @@ static Tensor& _exec_fft(Tensor& out, const Tensor& self, IntArrayRef out_sizes,
   const auto value_type = c10::toValueType(input.scalar_type());
   out.resize_(batched_out_sizes, MemoryFormat::Contiguous);
 
-  auto descriptor = _plan_mkl_fft(
+  auto descriptor = _get_mkl_fft_plan(
       input.strides(), out.strides(), signal_size, input.is_complex(),
       out.is_complex(), normalization, forward, value_type);
 
   // run the FFT
   if (forward) {
-    MKL_DFTI_CHECK(DftiComputeForward(descriptor.get(), input.data_ptr(), out.data_ptr()));
+    MKL_DFTI_CHECK(DftiComputeForward(descriptor->get(), input.data_ptr(), out.data_ptr()));
   } else {
-    MKL_DFTI_CHECK(DftiComputeBackward(descriptor.get(), input.data_ptr(), out.data_ptr()));
+    MKL_DFTI_CHECK(DftiComputeBackward(descriptor->get(), input.data_ptr(), out.data_ptr()));
   }
 
   // Inplace reshaping to original batch shape and inverting the dimension permutation
@@ -34,7 +34,9 @@ std::tuple<Tensor, Tensor, Tensor> mkldnn_convolution_backward(
 
 #else // AT_MKLDNN_EBABLED
 
+#include <ATen/core/Vitals.h>
 #include <ATen/native/mkldnn/MKLDNNCommon.h>
+#include <ATen/native/mkldnn/MKLDNNWeightCache.h>
 #include <ATen/native/mkldnn/Utils.h>
 #include <ATen/native/ConvUtils.h>
 
@@ -92,7 +94,40 @@ Tensor mkldnn_convolution(
     IntArrayRef dilation,
     int64_t groups) {
   const ideep::tensor mkldnn_input = itensor_from_tensor(input);
-  const ideep::tensor mkldnn_weight = itensor_from_tensor(weight);
+  ideep::tensor mkldnn_weight;
+  if (weight.is_mkldnn()) {
+    mkldnn_weight = itensor_from_mkldnn(weight);
+  } else if (use_mkldnn_weight_cache(weight)) {
+    std::vector<int64_t> params;
+    params.insert(params.end(), padding.begin(), padding.end());
+    params.insert(params.end(), stride.begin(), stride.end());
+    params.insert(params.end(), dilation.begin(), dilation.end());
+    params.push_back(groups);
+    mkldnn_weight = get_cached_mkldnn_weight(weight, MkldnnWeightKind::Convolution, params, [&]() {
+      TORCH_SLOW_PATH(MKLDNN_REORDER);
+      const ideep::tensor w = itensor_view_from_dense(weight);
+      auto desc = ideep::convolution_forward::expected_weights_desc(
+          w.get_dims(),
+          w.get_data_type(),
+          {stride.begin(), stride.end()},
+          {padding.begin(), padding.end()},
+          {padding.begin(), padding.end()},
+          {dilation.begin(), dilation.end()},
+          groups,
+          ideep::algorithm::convolution_direct,
+          ideep::prop_kind::forward,
+          mkldnn_input.get_data_type(),
+          mkldnn_input.get_dims());
+      ideep::tensor result;
+      result.init(desc);
+      result.feed_from(w);
+      return result;
+    });
+  } else {
+    // ideep reorders the dense weight to the layout of the kernel
+    TORCH_SLOW_PATH(MKLDNN_REORDER);
+    mkldnn_weight = itensor_view_from_dense(weight);
+  }
   c10::optional<ideep::tensor> mkldnn_bias{c10::nullopt};
   if (bias.defined()) {
     mkldnn_bias = itensor_from_tensor(bias);
@@ -35,6 +35,7 @@ std::tuple<Tensor, Tensor, Tensor> mkldnn_linear_backward(
 #else // AT_MKLDNN_EBABLED
 
 #include <ATen/native/mkldnn/MKLDNNCommon.h>
+#include <ATen/native/mkldnn/MKLDNNWeightCache.h>
 
 namespace at {
 namespace native {
@@ -52,7 +53,23 @@ Tensor mkldnn_linear(
   auto self_reshaped = self.dim() > 2 ? self.reshape({-1, self.size(self.dim() - 1)}) : self;
   const ideep::tensor x = itensor_from_mkldnn(self_reshaped);
   // weight can be a mkldnn tensor or dense tensor.
-  const ideep::tensor w = itensor_from_tensor(weight);
+  ideep::tensor w;
+  if (!weight.is_mkldnn() && use_mkldnn_weight_cache(weight)) {
+    w = get_cached_mkldnn_weight(weight, MkldnnWeightKind::Linear, {}, [&]() {
+      const ideep::tensor dense_w = itensor_view_from_dense(weight);
+      auto desc = ideep::inner_product_forward::expected_weights_desc(
+          dense_w.get_dims(),
+          x.get_dims(),
+          dense_w.get_data_type(),
+          x.get_data_type());
+      ideep::tensor result;
+      result.init(desc);
+      result.feed_from(dense_w);
+      return result;
+    });
+  } else {
+    w = itensor_from_tensor(weight);
+  }
 
   ideep::tensor y;
   if (bias.defined()) {
@@ -0,0 +1,221 @@
+#include <ATen/ATen.h>
+#include <ATen/Config.h>
+#include <ATen/NativeFunctions.h>
+
+#if !AT_MKLDNN_ENABLED()
+
+namespace at { namespace native {
+
+int64_t _mkldnn_weight_cache_get_size() {
+  TORCH_CHECK(false, "_mkldnn_weight_cache_get_size: ATen not compiled with MKLDNN support");
+}
+
+int64_t _mkldnn_weight_cache_get_max_size() {
+  TORCH_CHECK(false, "_mkldnn_weight_cache_get_max_size: ATen not compiled with MKLDNN support");
+}
+
+void _mkldnn_weight_cache_set_max_size(int64_t max_size) {
+  TORCH_CHECK(false, "_mkldnn_weight_cache_set_max_size: ATen not compiled with MKLDNN support");
+}
+
+void _mkldnn_weight_cache_clear() {
+  TORCH_CHECK(false, "_mkldnn_weight_cache_clear: ATen not compiled with MKLDNN support");
+}
+
+}}
+
+#else // AT_MKLDNN_EBABLED
+
+#include <ATen/core/grad_mode.h>
+#include <ATen/native/mkldnn/MKLDNNWeightCache.h>
+#include <c10/util/hash.h>
+#include <c10/util/intrusive_ptr.h>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+
+// Default budget of the cache, in bytes
+constexpr int64_t kDefaultWeightCacheMaxSize = 256 << 20;
+
+struct WeightKey {
+  const c10::StorageImpl* storage;
+  // kind, dtype, storage offset, sizes, strides and kernel parameters
+  std::vector<int64_t> signature;
+
+  bool operator==(const WeightKey& other) const {
+    return storage == other.storage && signature == other.signature;
+  }
+};
+
+struct WeightKeyHash {
+  size_t operator()(const WeightKey& key) const {
+    return c10::get_hash(key.storage, key.signature);
+  }
+};
+
+struct WeightEntry {
+  WeightKey key;
+  // Tells whether the cached storage is still alive: while it is, no other
+  // storage can have the same address
+  c10::weak_intrusive_ptr<c10::StorageImpl> storage;
+  uint32_t version;
+  ideep::tensor weight;
+  int64_t nbytes;
+};
+
+WeightKey make_key(const Tensor& weight, MkldnnWeightKind kind, IntArrayRef params) {
+  std::vector<int64_t> signature;
+  signature.reserve(3 + 2 * weight.dim() + params.size());
+  signature.push_back(static_cast<int64_t>(kind));
+  signature.push_back(static_cast<int64_t>(weight.scalar_type()));
+  signature.push_back(weight.storage_offset());
+  signature.insert(signature.end(), weight.sizes().begin(), weight.sizes().end());
+  signature.insert(signature.end(), weight.strides().begin(), weight.strides().end());
+  signature.insert(signature.end(), params.begin(), params.end());
+  return {weight.storage().unsafeGetStorageImpl(), std::move(signature)};
+}
+
+// LRU cache shared by all the threads, the most recently used entries first
+class MkldnnWeightCache {
+ public:
+  static MkldnnWeightCache& get() {
+    // leaked, for the weights may be released at exit after static destruction
+    static MkldnnWeightCache* cache = new MkldnnWeightCache();
+    return *cache;
+  }
+
+  c10::optional<ideep::tensor> find(const WeightKey& key, uint32_t version) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    const auto it = index_.find(key);
+    if (it == index_.end()) {
+      return c10::nullopt;
+    }
+    if (it->second->storage.expired() || it->second->version != version) {
+      erase(it->second);
+      return c10::nullopt;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->weight;
+  }
+
+  void insert(WeightKey key, const Tensor& weight, uint32_t version, const ideep::tensor& reordered) {
+    const int64_t nbytes = reordered.get_size();
+    std::lock_guard<std::mutex> guard(mutex_);
+    const auto it = index_.find(key);
+    if (it != index_.end()) {
+      erase(it->second);
+    }
+    // the entries of the released weights are only useless memory
+    for (auto entry = entries_.begin(); entry != entries_.end();) {
+      auto next = std::next(entry);
+      if (entry->storage.expired()) {
+        erase(entry);
+      }
+      entry = next;
+    }
+    if (nbytes > max_size_) {
+      return;
+    }
+    const auto storage = c10::intrusive_ptr<c10::StorageImpl>::unsafe_reclaim_from_nonowning(
+        weight.storage().unsafeGetStorageImpl());
+    entries_.push_front({key, c10::weak_intrusive_ptr<c10::StorageImpl>(storage), version, reordered, nbytes});
+    index_.emplace(std::move(key), entries_.begin());
+    size_ += nbytes;
+    evict();
+  }
+
+  int64_t size() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return size_;
+  }
+
+  int64_t max_size() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return max_size_;
+  }
+
+  void set_max_size(int64_t max_size) {
+    TORCH_CHECK(max_size >= 0, "mkldnn weight_cache.max_size must be non-negative, but got ", max_size);
+    std::lock_guard<std::mutex> guard(mutex_);
+    max_size_ = max_size;
+    evict();
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    index_.clear();
+    entries_.clear();
+    size_ = 0;
+  }
+
+ private:
+  void erase(std::list<WeightEntry>::iterator entry) {
+    size_ -= entry->nbytes;
+    index_.erase(entry->key);
+    entries_.erase(entry);
+  }
+
+  void evict() {
+    while (size_ > max_size_) {
+      erase(std::prev(entries_.end()));
+    }
+  }
+
+  std::mutex mutex_;
+  std::list<WeightEntry> entries_;
+  std::unordered_map<WeightKey, std::list<WeightEntry>::iterator, WeightKeyHash> index_;
+  int64_t size_ = 0;
+  int64_t max_size_ = kDefaultWeightCacheMaxSize;
+};
+
+} // namespace
+
+bool use_mkldnn_weight_cache(const Tensor& weight) {
+  return weight.layout() == kStrided &&
+      weight.scalar_type() == kFloat &&
+      weight.is_contiguous() &&
+      !(weight.requires_grad() && GradMode::is_enabled());
+}
+
+ideep::tensor get_cached_mkldnn_weight(
+    const Tensor& weight,
+    MkldnnWeightKind kind,
+    IntArrayRef params,
+    const std::function<ideep::tensor()>& reorder) {
+  auto& cache = MkldnnWeightCache::get();
+  auto key = make_key(weight, kind, params);
+  const uint32_t version = weight.unsafeGetTensorImpl()->version_counter().current_version();
+  if (auto cached = cache.find(key, version)) {
+    return *cached;
+  }
+  // reordered outside of the lock, other threads may reorder the same weight
+  ideep::tensor reordered = reorder();
+  cache.insert(std::move(key), weight, version, reordered);
+  return reordered;
+}
+
+int64_t _mkldnn_weight_cache_get_size() {
+  return MkldnnWeightCache::get().size();
+}
+
+int64_t _mkldnn_weight_cache_get_max_size() {
+  return MkldnnWeightCache::get().max_size();
+}
+
+void _mkldnn_weight_cache_set_max_size(int64_t max_size) {
+  MkldnnWeightCache::get().set_max_size(max_size);
+}
+
+void _mkldnn_weight_cache_clear() {
+  MkldnnWeightCache::get().clear();
+}
+
+}}
+
+#endif // AT_MKLDNN_EBABLED
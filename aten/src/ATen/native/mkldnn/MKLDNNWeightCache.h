@@ -0,0 +1,41 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/Config.h>
+
+#if AT_MKLDNN_ENABLED()
+#include <ideep.hpp>
+
+#include <functional>
+
+namespace at { namespace native {
+
+// Cache of the dense weights reordered to the blocked layouts of the MKL-DNN
+// kernels, so that eager mode inference doesn't reorder every weight on every
+// call. The entries are keyed by the storage, the geometry and the dtype of
+// the weight, and by the parameters of the kernel (e.g. the padding, stride,
+// dilation and groups of a convolution). An entry is only used while the
+// storage is alive and the version counter of the weight is unchanged, i.e.
+// until the parameter is mutated in-place. The least recently used entries are
+// evicted past a budget of bytes, see torch.backends.mkldnn.weight_cache.
+
+enum class MkldnnWeightKind : int64_t {
+  Convolution,
+  Linear,
+};
+
+// Whether the reordered weight can be cached: for dense float weights which
+// are not being trained (these are mutated after each iteration anyway).
+bool use_mkldnn_weight_cache(const Tensor& weight);
+
+// Returns the reordered weight from the cache, or reorders it with reorder
+// and caches it.
+ideep::tensor get_cached_mkldnn_weight(
+    const Tensor& weight,
+    MkldnnWeightKind kind,
+    IntArrayRef params,
+    const std::function<ideep::tensor()>& reorder);
+
+}}
+
+#endif // AT_MKLDNN_ENABLED
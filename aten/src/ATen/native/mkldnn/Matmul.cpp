@@ -0,0 +1,93 @@
+#include <ATen/native/mkldnn/Matmul.h>
+
+#if !AT_MKLDNN_ENABLED()
+
+namespace at { namespace native {
+
+bool mkldnn_bf16_gemm(
+    cpublas::TransposeType transa, cpublas::TransposeType transb,
+    int64_t m, int64_t n, int64_t k,
+    float alpha,
+    const c10::BFloat16 *a, int64_t lda,
+    const c10::BFloat16 *b, int64_t ldb,
+    float beta,
+    c10::BFloat16 *c, int64_t ldc) {
+  return false;
+}
+
+}} // namespace at::native
+
+#else // AT_MKLDNN_ENABLED
+
+#include <ATen/native/mkldnn/MKLDNNCommon.h>
+#include <cpuinfo.h>
+
+namespace at { namespace native {
+
+// Note [BFloat16 gemm with MKL-DNN]
+// The gemm_stub kernel of BFloat16 is a scalar loop, which makes a BFloat16
+// addmm or mm much slower than a float one. MKL-DNN has a BFloat16 matmul
+// accumulating in float, which uses the dot products of AVX512_BF16 on the
+// CPUs which have them (Cooper Lake and later) and converts to float with
+// AVX512 on the others.
+//
+// cpublas::gemm takes column major matrices, while the strides of the memory
+// descriptors of MKL-DNN are those of row major ones, so C = A B is computed
+// as the row major C^T = B^T A^T.
+static bool use_mkldnn_bf16_gemm() {
+  static const bool supported = cpuinfo_initialize() &&
+      cpuinfo_has_x86_avx512f() && cpuinfo_has_x86_avx512bw() &&
+      cpuinfo_has_x86_avx512vl() && cpuinfo_has_x86_avx512dq();
+  return supported && at::globalContext().userEnabledMkldnn();
+}
+
+bool mkldnn_bf16_gemm(
+    cpublas::TransposeType transa, cpublas::TransposeType transb,
+    int64_t m, int64_t n, int64_t k,
+    float alpha,
+    const c10::BFloat16 *a, int64_t lda,
+    const c10::BFloat16 *b, int64_t ldb,
+    float beta,
+    c10::BFloat16 *c, int64_t ldc) {
+  if (!use_mkldnn_bf16_gemm() || m == 0 || n == 0 || k == 0) {
+    return false;
+  }
+  using dims = dnnl::memory::dims;
+  using dt = dnnl::memory::data_type;
+  // The (i, j) element of B^T (n x k) is B(j, i), and that of A^T (k x m) is
+  // A(j, i)
+  const dnnl::memory::desc src_md(
+      {n, k}, dt::bf16,
+      transb == cpublas::NoTranspose ? dims{ldb, 1} : dims{1, ldb});
+  const dnnl::memory::desc weights_md(
+      {k, m}, dt::bf16,
+      transa == cpublas::NoTranspose ? dims{lda, 1} : dims{1, lda});
+  const dnnl::memory::desc dst_md({n, m}, dt::bf16, dims{ldc, 1});
+
+  dnnl::primitive_attr attr;
+  if (alpha != 1.0f) {
+    attr.set_output_scales(0, {alpha});
+  }
+  if (beta != 0.0f) {
+    dnnl::post_ops ops;
+    ops.append_sum(beta);
+    attr.set_post_ops(ops);
+  }
+
+  const auto& engine = ideep::engine::cpu_engine();
+  const dnnl::matmul::primitive_desc pd(
+      dnnl::matmul::desc(src_md, weights_md, dst_md), attr, engine);
+  dnnl::memory src(src_md, engine, const_cast<c10::BFloat16*>(b));
+  dnnl::memory weights(weights_md, engine, const_cast<c10::BFloat16*>(a));
+  dnnl::memory dst(dst_md, engine, c);
+  auto& stream = ideep::stream::default_stream();
+  dnnl::matmul(pd).execute(
+      stream,
+      {{DNNL_ARG_SRC, src}, {DNNL_ARG_WEIGHTS, weights}, {DNNL_ARG_DST, dst}});
+  stream.wait();
+  return true;
+}
+
+}} // namespace at::native
+
+#endif // AT_MKLDNN_ENABLED
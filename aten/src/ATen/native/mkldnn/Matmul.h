@@ -0,0 +1,21 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/Config.h>
+#include <ATen/native/CPUBlas.h>
+
+namespace at { namespace native {
+
+// Computes the BFloat16 gemm of cpublas::gemm with MKL-DNN, and returns
+// whether it could, i.e. whether ATen is built with MKL-DNN and the CPU has
+// the AVX512 instructions its BFloat16 kernels need
+bool mkldnn_bf16_gemm(
+    cpublas::TransposeType transa, cpublas::TransposeType transb,
+    int64_t m, int64_t n, int64_t k,
+    float alpha,
+    const c10::BFloat16 *a, int64_t lda,
+    const c10::BFloat16 *b, int64_t ldb,
+    float beta,
+    c10::BFloat16 *c, int64_t ldc);
+
+}}
@@ -2,6 +2,7 @@
 
 #include <ATen/ATen.h>
 #include <ATen/core/List.h>
+#include <ATen/core/dispatch/Dispatcher.h>
 
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
@@ -219,6 +220,25 @@ c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>> deserialize_conv(
 
   auto& ctx = at::globalContext();
 
+  // The CUDA packed params live in the CUDA library, so they are created
+  // through the QuantizedCUDA kernel of the op.
+  if (weight.is_cuda()) {
+    TORCH_CHECK(
+        kSpatialDim == 2 && !transpose,
+        "prepack/__setstate__: CUDA only supports Conv2d now.");
+    static auto op =
+        c10::Dispatcher::singleton()
+            .findSchemaOrThrow("quantized::conv2d_prepack", "")
+            .typed<c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>>(
+                at::Tensor,
+                c10::optional<at::Tensor>,
+                torch::List<int64_t>,
+                torch::List<int64_t>,
+                torch::List<int64_t>,
+                int64_t)>();
+    return op.call(weight, bias, stride, padding, dilation, groups);
+  }
+
 #ifdef USE_FBGEMM
   if (ctx.qEngine() == at::QEngine::FBGEMM) {
     return PackedConvWeight<kSpatialDim>::prepack(
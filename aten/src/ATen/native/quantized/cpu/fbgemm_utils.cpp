@@ -1,4 +1,5 @@
 #include <ATen/ATen.h>
+#include <ATen/core/dispatch/Dispatcher.h>
 #include <ATen/native/TensorFactories.h>
 
 #include <ATen/native/quantized/cpu/conv_packed_params.h>
@@ -422,6 +423,17 @@ torch::class_<LinearPackedParamsBase> register_linear_params() {
                 weight = std::move(std::get<0>(state));
                 bias = std::move(std::get<1>(state));
 
+                // The CUDA packed params live in the CUDA library, so they
+                // are created through the QuantizedCUDA kernel of the op.
+                if (weight.is_cuda()) {
+                  static auto op =
+                      c10::Dispatcher::singleton()
+                          .findSchemaOrThrow("quantized::linear_prepack", "")
+                          .typed<c10::intrusive_ptr<LinearPackedParamsBase>(
+                              at::Tensor, c10::optional<at::Tensor>)>();
+                  return op.call(std::move(weight), std::move(bias));
+                }
+
 #ifdef USE_FBGEMM
                 if (at::globalContext().qEngine() == at::QEngine::FBGEMM) {
                   if (weight.scalar_type() == at::kQInt8) {
@@ -431,6 +443,11 @@ torch::class_<LinearPackedParamsBase> register_linear_params() {
                     // NB: fp16 weight is serialized as float
                     return PackedLinearWeightFp16::prepack(
                         std::move(weight), std::move(bias));
+                  } else if (weight.scalar_type() == at::kByte) {
+                    // NB: 4-bit weight is serialized in its packed
+                    // representation, see PackedLinearWeightInt4
+                    return PackedLinearWeightInt4::from_packed(
+                        std::move(weight), std::move(bias));
                   } else {
                     TORCH_CHECK(
                         false,
@@ -116,6 +116,75 @@ struct TORCH_API PackedLinearWeightFp16 : public LinearPackedParamsBase {
   at::Tensor apply_dynamic_impl(at::Tensor input);
 };
 
+// The weight of a fully connected layer quantized to 4 bits in groups of
+// group_size consecutive elements of a row, each group having its own scale
+// and offset. Only the weight is quantized, the input and output of
+// apply_dynamic are float. The packed weight uses the "fused" representation
+// of quantized::embedding_bag_4bit_prepack for every group:
+//   w: N x (K / group_size) x (group_size / 2 + 4) bytes,
+//   | ... group_size 4-bit values ... | scale | offset |
+//   |        group_size / 2 B         |  2B   |   2B   |
+// with the fp16 scale and offset, the value of element k being
+// (k-th 4-bit value) * scale + offset. Element 2 * i of a group is in the
+// lower 4 bits of byte i, element 2 * i + 1 in the upper ones. unpack()
+// returns w itself, which is also how the weight is serialized.
+struct TORCH_API PackedLinearWeightInt4 : public LinearPackedParamsBase {
+  PackedLinearWeightInt4(at::Tensor w, c10::optional<at::Tensor> bias)
+      : w(std::move(w)), bias_(std::move(bias)) {}
+
+  at::Tensor w;
+  c10::optional<at::Tensor> bias_;
+
+  at::Tensor apply(
+      at::Tensor input,
+      double output_scale,
+      int64_t output_zero_point) override {
+    TORCH_CHECK(
+        false,
+        "4-bit packed linear weights only support quantized::linear_dynamic");
+  }
+  at::Tensor apply_relu(
+      at::Tensor input,
+      double output_scale,
+      int64_t output_zero_point) override {
+    TORCH_CHECK(
+        false,
+        "4-bit packed linear weights only support "
+        "quantized::linear_relu_dynamic");
+  }
+
+  at::Tensor apply_dynamic(at::Tensor input, bool reduce_range=false) override;
+  at::Tensor apply_dynamic_relu(at::Tensor input, bool reduce_range=false) override;
+
+  std::tuple<at::Tensor, c10::optional<at::Tensor>> unpack() override;
+
+  c10::optional<at::Tensor> bias() override {
+    return bias_;
+  }
+
+  void set_bias(c10::optional<at::Tensor> bias) override;
+
+  // Quantizes the float weight of N x K elements, K being a multiple of
+  // group_size.
+  static c10::intrusive_ptr<LinearPackedParamsBase> prepack(
+      at::Tensor weight,
+      c10::optional<at::Tensor> bias,
+      int64_t group_size);
+
+  // Wraps a weight of the representation above, as returned by unpack().
+  static c10::intrusive_ptr<LinearPackedParamsBase> from_packed(
+      at::Tensor packed_weight,
+      c10::optional<at::Tensor> bias);
+
+  int64_t group_size() const {
+    return (w.size(2) - 2 * static_cast<int64_t>(sizeof(at::Half))) * 2;
+  }
+
+ private:
+  template <bool ReluFused>
+  at::Tensor apply_dynamic_impl(at::Tensor input);
+};
+
 template <int kSpatialDim = 2>
 struct TORCH_API PackedConvWeight : public ConvPackedParamsBase<kSpatialDim> {
   PackedConvWeight(
@@ -1,6 +1,7 @@
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
+#include <ATen/cpu/vec512/functional.h>
 #include <ATen/native/SortingUtils.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/UpSample.h>
@@ -9,6 +10,9 @@
 #include <ATen/native/quantized/cpu/quantized_ops.h>
 
 #include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
 #ifdef USE_FBGEMM
 #include <fbgemm/QuantUtils.h>
 #endif
@@ -2140,27 +2144,57 @@ void fake_quant_per_channel_cachemask_cpu(
     TensorIterator& iter_mask,
     int64_t quant_min,
     int64_t quant_max) {
-  // TODO(future, optional): read once, write twice.  Not done at the moment
-  //   for simplicity, as we do not expect this to be a bottleneck.
-
-  // write mask
-  cpu_kernel(iter_mask, [=](float self, float scale, int64_t zero_point) -> bool {
-    float inv_scale = 1.0f / scale;
-    const auto qval = static_cast<int64_t>(zero_point + std::nearbyint(self * inv_scale));
-    return ((quant_min <= qval) && (qval <= quant_max));
-  });
+  using Vec = vec::Vectorized<float>;
+  // The output and the mask are written in a single pass over the input:
+  // iter and iter_mask have the same inputs.
+  auto iter_combined = TensorIteratorConfig()
+    .check_all_same_dtype(false)
+    .add_output(iter.output())
+    .add_output(iter_mask.output())
+    .add_input(iter.input(0))
+    .add_input(iter.input(1))
+    .add_input(iter.input(2))
+    .build();
+
+  const Vec quant_min_vec(static_cast<float>(quant_min));
+  const Vec quant_max_vec(static_cast<float>(quant_max));
+  iter_combined.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    int64_t i = 0;
+    // An inner loop over the elements of one channel, e.g. of NCHW.
+    if (strides[0] == sizeof(float) && strides[1] == sizeof(bool) &&
+        strides[2] == sizeof(float) && strides[3] == 0 && strides[4] == 0) {
+      float* output_data = reinterpret_cast<float*>(data[0]);
+      bool* mask_data = reinterpret_cast<bool*>(data[1]);
+      const float* input_data = reinterpret_cast<const float*>(data[2]);
+      const float scale = *reinterpret_cast<const float*>(data[3]);
+      const int64_t zero_point = *reinterpret_cast<const int64_t*>(data[4]);
+      const Vec scale_vec(scale);
+      const Vec inv_scale_vec(1.0f / scale);
+      const Vec zero_point_vec(static_cast<float>(zero_point));
+      float qvalues[Vec::size()];
+      for (; i + Vec::size() <= n; i += Vec::size()) {
+        const Vec qvalue =
+            (Vec::loadu(input_data + i) * inv_scale_vec).round() + zero_point_vec;
+        qvalue.store(qvalues);
+        for (int64_t k = 0; k < Vec::size(); ++k) {
+          mask_data[i + k] = quant_min <= qvalues[k] && qvalues[k] <= quant_max;
+        }
+        ((vec::minimum(vec::maximum(qvalue, quant_min_vec), quant_max_vec) -
+          zero_point_vec) * scale_vec).store(output_data + i);
+      }
+    }
+    for (; i < n; ++i) {
+      float* output_val = (float*)(data[0] + i * strides[0]);
+      bool* mask_val = (bool*)(data[1] + i * strides[1]);
+      const float input_val = *(float*)(data[2] + i * strides[2]);
+      const float scale = *(float*)(data[3] + i * strides[3]);
+      const int64_t zero_point = *(int64_t*)(data[4] + i * strides[4]);
 
-  // write fake_quant
-  cpu_kernel(iter, [=](float self, float scale, int64_t zero_point) -> float {
-    float inv_scale = 1.0f / scale;
-    return (std::fmin(
-                std::fmax(
-                    static_cast<int64_t>(
-                        zero_point + std::nearbyint(self * inv_scale)),
-                    quant_min),
-                quant_max) -
-            zero_point) *
-        scale;
+      const float inv_scale = 1.0f / scale;
+      const auto qval = static_cast<int64_t>(zero_point + std::nearbyint(input_val * inv_scale));
+      *output_val = (std::fmin(std::fmax(qval, quant_min), quant_max) - zero_point) * scale;
+      *mask_val = ((quant_min <= qval) && (qval <= quant_max));
+    }
   });
 }
 
@@ -2380,6 +2414,73 @@ void quantized_normalize_kernel(
   });
 }
 
+// output = input x dequantized(weight)^T + bias, see PackedLinearWeightInt4
+// for the representation of the weight. Every group of a row of the weight is
+// dequantized once into a buffer, then multiplied with the corresponding
+// elements of all the rows of the input, so that the weight, whose reads bound
+// the time of the few rows of an inference batch, is only read once. The
+// products are computed with the vectors of the CPU capability, 512-bit ones in
+// the AVX512 build.
+void qlinear_int4_kernel(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    bool relu_fused,
+    Tensor& output) {
+  using Vec = vec::Vectorized<float>;
+  const int64_t M = input.size(0);
+  const int64_t K = input.size(1);
+  const int64_t N = weight.size(0);
+  const int64_t num_groups = weight.size(1);
+  const int64_t group_bytes = weight.size(2);
+  const int64_t group_size = K / num_groups;
+  const float* input_data = input.data_ptr<float>();
+  const uint8_t* weight_data = weight.data_ptr<uint8_t>();
+  const float* bias_data = bias.defined() ? bias.data_ptr<float>() : nullptr;
+  float* output_data = output.data_ptr<float>();
+
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, M * K));
+  at::parallel_for(0, N, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<float> w_group(group_size);
+    std::vector<float> sums(M);
+    float acc_arr[Vec::size()];
+    for (int64_t n = begin; n < end; ++n) {
+      std::fill(sums.begin(), sums.end(), 0.f);
+      for (int64_t g = 0; g < num_groups; ++g) {
+        const uint8_t* group = weight_data + (n * num_groups + g) * group_bytes;
+        const at::Half* qparams =
+            reinterpret_cast<const at::Half*>(group + group_size / 2);
+        const float scale = qparams[0];
+        const float offset = qparams[1];
+        for (int64_t i = 0; i < group_size / 2; ++i) {
+          w_group[2 * i] = (group[i] & 0xF) * scale + offset;
+          w_group[2 * i + 1] = (group[i] >> 4) * scale + offset;
+        }
+        for (int64_t m = 0; m < M; ++m) {
+          const float* x = input_data + m * K + g * group_size;
+          Vec acc_vec(0.f);
+          int64_t k = 0;
+          for (; k + Vec::size() <= group_size; k += Vec::size()) {
+            acc_vec = vec::fmadd(
+                Vec::loadu(x + k), Vec::loadu(w_group.data() + k), acc_vec);
+          }
+          acc_vec.store(acc_arr);
+          float sum = std::accumulate(acc_arr, acc_arr + Vec::size(), 0.f);
+          for (; k < group_size; ++k) {
+            sum += x[k] * w_group[k];
+          }
+          sums[m] += sum;
+        }
+      }
+      for (int64_t m = 0; m < M; ++m) {
+        float value = bias_data ? sums[m] + bias_data[n] : sums[m];
+        output_data[m * N + n] = relu_fused ? std::max(value, 0.f) : value;
+      }
+    }
+  });
+}
+
 #ifdef USE_FBGEMM
 void quantize_tensor_per_tensor_affine_cpu(
     Tensor rtensor,
@@ -2578,8 +2679,57 @@ void dequantize_tensor_per_tensor_affine_cpu(
 }
 #endif // USE_FBGEMM
 
-// TODO: add fbgemm for per channel
-// Generic template defaults to naive quantize implementation
+// Quantizes n values, either all of one channel (per_element_qparams is
+// false, inv_scales and zero_points point to one value), or of consecutive
+// channels (channels last). The values are rounded like quantize_val, in
+// float, so the vectorized and the scalar loops give the same result. The
+// vectors are the ones of the CPU capability, 512-bit ones in the AVX512 build.
+template <typename T, bool per_element_qparams>
+void quantize_values_per_channel(
+    const float* in,
+    T* out,
+    int64_t n,
+    const float* inv_scales,
+    const float* zero_points) {
+  using Vec = vec::Vectorized<float>;
+  using underlying_t = typename T::underlying;
+  constexpr int64_t qmin = std::numeric_limits<underlying_t>::min();
+  constexpr int64_t qmax = std::numeric_limits<underlying_t>::max();
+  int64_t i = 0;
+  // the int32 limits are not exact in float, so qint32 stays scalar
+  if (sizeof(underlying_t) < sizeof(int32_t)) {
+    const Vec qmin_vec(static_cast<float>(qmin));
+    const Vec qmax_vec(static_cast<float>(qmax));
+    Vec inv_scale_vec(inv_scales[0]);
+    Vec zero_point_vec(zero_points[0]);
+    float qvalues[Vec::size()];
+    for (; i + Vec::size() <= n; i += Vec::size()) {
+      if (per_element_qparams) {
+        inv_scale_vec = Vec::loadu(inv_scales + i);
+        zero_point_vec = Vec::loadu(zero_points + i);
+      }
+      const Vec qvalue = vec::minimum(
+          vec::maximum(
+              (Vec::loadu(in + i) * inv_scale_vec).round() + zero_point_vec,
+              qmin_vec),
+          qmax_vec);
+      qvalue.store(qvalues);
+      for (int64_t k = 0; k < Vec::size(); ++k) {
+        out[i + k] = T(static_cast<underlying_t>(qvalues[k]));
+      }
+    }
+  }
+  for (; i < n; ++i) {
+    const int64_t c = per_element_qparams ? i : 0;
+    const int64_t qvalue = static_cast<int64_t>(
+        zero_points[c] + std::nearbyint(in[i] * inv_scales[c]));
+    out[i] = T(static_cast<underlying_t>(std::min<int64_t>(
+        std::max<int64_t>(qvalue, qmin), qmax)));
+  }
+}
+
+// Generic template for the per channel quantization, parallel over the
+// channels (NCHW) or over the elements (channels last).
 template <typename T>
 void quantize_tensor_per_channel_impl(
     Tensor rtensor,
@@ -2587,7 +2737,6 @@ void quantize_tensor_per_channel_impl(
     Tensor scales,
     Tensor zero_points,
     int64_t axis) {
-  // TODO: channels last kernel can be made faster.
   // For contiguous tensors, e.g. NCHW, arbitrary axis can be used.
   // For channels_last/3d however axis == 0 or 1.
   // Since current implemntation on channels_last format does not
@@ -2600,6 +2749,13 @@ void quantize_tensor_per_channel_impl(
   auto zero_points_data = zero_points.data_ptr<int64_t>();
   const float* in = rtensor.data_ptr<float>();
   auto out = qtensor.data_ptr<T>();
+  // quantize_val computes the inverse scale in float
+  std::vector<float> inv_scales(channels);
+  std::vector<float> zero_points_float(channels);
+  for (int64_t c = 0; c < channels; ++c) {
+    inv_scales[c] = 1.0f / static_cast<float>(scales_data[c]);
+    zero_points_float[c] = static_cast<float>(zero_points_data[c]);
+  }
   if (axis == 1 &&
       (rtensor.is_contiguous(MemoryFormat::ChannelsLast) ||
        rtensor.is_contiguous(MemoryFormat::ChannelsLast3d))) {
@@ -2607,26 +2763,33 @@ void quantize_tensor_per_channel_impl(
     // channels_last contig.
     // If axis = 0 and channels_last contig, implementation for channels
     // first (NCHW) works.
-    for (auto b = 0; b < batches; ++b) {
-      for (auto e = 0; e < elements_per_channel; ++e) {
-        for (auto c = 0; c < channels; ++c) {
-          auto i = b * channels * elements_per_channel + e * channels + c;
-          out[i] = at::native::quantize_val<T>(
-              scales_data[c], zero_points_data[c], in[i]);
-        }
-      }
-    }
+    const int64_t grain_size = at::internal::GRAIN_SIZE / channels + 1;
+    at::parallel_for(
+        0, batches * elements_per_channel, grain_size, [&](int64_t begin, int64_t end) {
+          for (int64_t row = begin; row < end; ++row) {
+            quantize_values_per_channel<T, /*per_element_qparams=*/true>(
+                in + row * channels,
+                out + row * channels,
+                channels,
+                inv_scales.data(),
+                zero_points_float.data());
+          }
+        });
   } else {
-    for (auto b = 0; b < batches; ++b) {
-      for (auto c = 0; c < channels; ++c) {
-        for (auto e = 0; e < elements_per_channel; ++e) {
-          auto i = b * channels * elements_per_channel +
-              c * elements_per_channel + e;
-          out[i] = at::native::quantize_val<T>(
-              scales_data[c], zero_points_data[c], in[i]);
-        }
-      }
-    }
+    const int64_t grain_size =
+        at::internal::GRAIN_SIZE / std::max<int64_t>(elements_per_channel, 1) + 1;
+    at::parallel_for(
+        0, batches * channels, grain_size, [&](int64_t begin, int64_t end) {
+          for (int64_t row = begin; row < end; ++row) {
+            const int64_t c = row % channels;
+            quantize_values_per_channel<T, /*per_element_qparams=*/false>(
+                in + row * elements_per_channel,
+                out + row * elements_per_channel,
+                elements_per_channel,
+                &inv_scales[c],
+                &zero_points_float[c]);
+          }
+        });
   }
 }
 
@@ -2843,6 +3006,35 @@ void quantize_tensor_per_channel_affine_cpu(
       });
 }
 
+// Dequantizes n 8-bit values, like quantize_values_per_channel.
+template <typename Q, bool per_element_qparams>
+void dequantize_values_per_channel(
+    const Q* in,
+    float* out,
+    int64_t n,
+    const float* scales,
+    const float* zero_points) {
+  using Vec = vec::Vectorized<float>;
+  int64_t i = 0;
+  Vec scale_vec(scales[0]);
+  Vec zero_point_vec(zero_points[0]);
+  float values[Vec::size()];
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    if (per_element_qparams) {
+      scale_vec = Vec::loadu(scales + i);
+      zero_point_vec = Vec::loadu(zero_points + i);
+    }
+    for (int64_t k = 0; k < Vec::size(); ++k) {
+      values[k] = static_cast<float>(in[i + k].val_);
+    }
+    ((Vec::loadu(values) - zero_point_vec) * scale_vec).store(out + i);
+  }
+  for (; i < n; ++i) {
+    const int64_t c = per_element_qparams ? i : 0;
+    out[i] = (static_cast<float>(in[i].val_) - zero_points[c]) * scales[c];
+  }
+}
+
 template<typename T, typename N, typename Q>
 void dequantize_per_channel_affine_kernel(
       Tensor qtensor,
@@ -2869,9 +3061,51 @@ void dequantize_per_channel_affine_kernel(
   check_tensor_memory_format(qtensor, rtensor);
   const auto* qd = qtensor.data_ptr<Q>();
   float* rd = rtensor.data_ptr<float>();
+  const bool channels_last = axis == 1 &&
+      (rtensor.is_contiguous(MemoryFormat::ChannelsLast) ||
+       rtensor.is_contiguous(MemoryFormat::ChannelsLast3d));
+  if (bit_width == 8) {
+    // Like the quantization, these are float.
+    std::vector<float> scales_float(channel);
+    std::vector<float> zero_points_float(channel);
+    for (int64_t c = 0; c < channel; ++c) {
+      scales_float[c] = static_cast<float>(scales_data[c]);
+      zero_points_float[c] = static_cast<float>(zero_points_data[c]);
+    }
+    if (channels_last) {
+      const int64_t grain_size = at::internal::GRAIN_SIZE / channel + 1;
+      at::parallel_for(
+          0, batches * elements_per_channel, grain_size, [&](int64_t begin, int64_t end) {
+            for (int64_t row = begin; row < end; ++row) {
+              dequantize_values_per_channel<Q, /*per_element_qparams=*/true>(
+                  qd + row * channel,
+                  rd + row * channel,
+                  channel,
+                  scales_float.data(),
+                  zero_points_float.data());
+            }
+          });
+    } else {
+      const int64_t grain_size =
+          at::internal::GRAIN_SIZE / std::max<int64_t>(elements_per_channel, 1) + 1;
+      at::parallel_for(
+          0, batches * channel, grain_size, [&](int64_t begin, int64_t end) {
+            for (int64_t row = begin; row < end; ++row) {
+              const int64_t c = row % channel;
+              dequantize_values_per_channel<Q, /*per_element_qparams=*/false>(
+                  qd + row * elements_per_channel,
+                  rd + row * elements_per_channel,
+                  elements_per_channel,
+                  &scales_float[c],
+                  &zero_points_float[c]);
+            }
+          });
+    }
+    return;
+  }
+  // Sub-byte values, several per byte.
   const auto elem_per_byte = 8 / bit_width;
-  if (axis == 1 && (rtensor.is_contiguous(MemoryFormat::ChannelsLast) ||
-      rtensor.is_contiguous(MemoryFormat::ChannelsLast3d))) {
+  if (channels_last) {
     for (auto b = 0; b < batches; ++b) {
       for (auto e = 0; e < elements_per_channel; ++e) {
         for (auto c = 0; c < channel; ++c) {
@@ -3082,6 +3316,7 @@ REGISTER_DISPATCH(qclamp_max_stub, &qclamp_max_kernel);
 REGISTER_DISPATCH(qelu_stub, &qelu_kernel);
 REGISTER_DISPATCH(qhardsigmoid_stub, &qhardsigmoid_kernel);
 REGISTER_DISPATCH(qhardswish_stub, &qhardswish_kernel);
+REGISTER_DISPATCH(qlinear_int4_stub, &qlinear_int4_kernel);
 REGISTER_DISPATCH(qmaxpool_2d_nhwc_stub, &qmaxpool_2d_nhwc_kernel);
 REGISTER_DISPATCH(qmul_relu_stub, &qmul_kernel<true>);
 REGISTER_DISPATCH(qmul_stub, &qmul_kernel<false>);
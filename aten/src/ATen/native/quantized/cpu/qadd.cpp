@@ -4,6 +4,8 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 #include <ATen/quantized/Quantizer.h>
+#include <ATen/native/quantized/cpu/conv_packed_params.h>
+#include <ATen/native/quantized/cpu/packed_params.h>
 #include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <ATen/native/quantized/cpu/init_qnnpack.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
@@ -226,6 +228,66 @@ Tensor qadd(Tensor qa, Tensor qb, double scale, int64_t zero_point) {
   return _add_out<ReLUFused>(qc, qa, qb);
 }
 
+// Adds qb to the temporary qa, the output of a quantized conv or linear that
+// nothing else refers to. Unless QNNPACK runs the add, the sum is written
+// over qa, which saves allocating and writing a new activation.
+template <bool ReLUFused = false>
+Tensor qadd_into_temporary(Tensor qa, Tensor qb, double scale, int64_t zero_point) {
+  check_inputs(qa, qb);
+#ifdef USE_PYTORCH_QNNPACK
+  if (at::globalContext().qEngine() == at::QEngine::QNNPACK &&
+      qa.scalar_type() == kQUInt8 && qb.scalar_type() == kQUInt8) {
+    return qnnpack_add<ReLUFused>(qa, qb, scale, zero_point);
+  }
+#endif
+  auto qc = at::_empty_affine_quantized(
+      {0},
+      at::device(kCPU).dtype(qa.scalar_type()),
+      scale,
+      zero_point,
+      c10::nullopt);
+  qc.set_(qa.storage(), qa.storage_offset(), qa.sizes(), qa.strides());
+  return _add_out<ReLUFused>(qc, qa, qb);
+}
+
+// quantized::conv2d followed by quantized::add(_relu) of the residual qaccum,
+// see FuseQuantizedResidualAdd.
+template <bool ReLUFused = false>
+class QConvAddInt8 final {
+ public:
+  static Tensor run(
+      Tensor act,
+      const c10::intrusive_ptr<ConvPackedParamsBase<2>>& packed_weight,
+      double conv_scale,
+      int64_t conv_zero_point,
+      Tensor qaccum,
+      double output_scale,
+      int64_t output_zero_point) {
+    Tensor conv_out = packed_weight->apply(act, conv_scale, conv_zero_point);
+    return qadd_into_temporary<ReLUFused>(
+        std::move(conv_out), std::move(qaccum), output_scale, output_zero_point);
+  }
+};
+
+// quantized::linear followed by quantized::add(_relu) of accum.
+template <bool ReLUFused = false>
+class QLinearAddInt8 final {
+ public:
+  static Tensor run(
+      Tensor input,
+      const c10::intrusive_ptr<LinearPackedParamsBase>& packed_weight,
+      double linear_scale,
+      int64_t linear_zero_point,
+      Tensor accum,
+      double output_scale,
+      int64_t output_zero_point) {
+    Tensor linear_out = packed_weight->apply(
+        std::move(input), linear_scale, linear_zero_point);
+    return qadd_into_temporary<ReLUFused>(
+        std::move(linear_out), std::move(accum), output_scale, output_zero_point);
+  }
+};
+
 template <bool ReLUFused = false>
 Tensor qadd_out(Tensor qa, Tensor qb, Tensor out) {
   check_inputs(qa, qb);
@@ -296,6 +358,10 @@ TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
   m.impl(TORCH_SELECTIVE_NAME("quantized::add_scalar_relu.Tensor"), TORCH_FN(qadd_scalar_tensor</*ReLUFused=*/true>));
   m.impl(TORCH_SELECTIVE_NAME("quantized::add_scalar_out.Tensor"), TORCH_FN(qadd_scalar_tensor_out</*ReLUFused=*/false>));
   m.impl(TORCH_SELECTIVE_NAME("quantized::add_scalar_relu_out.Tensor"), TORCH_FN(qadd_scalar_tensor_out</*ReLUFused=*/true>));
+  m.impl(TORCH_SELECTIVE_NAME("quantized::conv2d_add"),         TORCH_FN(QConvAddInt8</*ReLUFused=*/false>::run));
+  m.impl(TORCH_SELECTIVE_NAME("quantized::conv2d_add_relu"),    TORCH_FN(QConvAddInt8</*ReLUFused=*/true>::run));
+  m.impl(TORCH_SELECTIVE_NAME("quantized::linear_add"),         TORCH_FN(QLinearAddInt8</*ReLUFused=*/false>::run));
+  m.impl(TORCH_SELECTIVE_NAME("quantized::linear_add_relu"),    TORCH_FN(QLinearAddInt8</*ReLUFused=*/true>::run));
 }
 
 TORCH_LIBRARY_IMPL(_quantized, QuantizedCPU, m) {
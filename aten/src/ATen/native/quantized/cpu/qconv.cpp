@@ -554,12 +554,27 @@ at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply_relu(
   return apply_impl<true>(input, output_scale, output_zero_point);
 }
 
+template <int kSpatialDim>
+at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply_with_lut(
+    const at::Tensor& input,
+    double output_scale,
+    int64_t output_zero_point,
+    const QnnpackOutputLut& output_lut) {
+  TORCH_CHECK(
+      !transpose(),
+      "quantized::conv_transpose (qnnpack): Activations cannot be fused into "
+      "ConvTranspose.");
+  return apply_impl<false>(
+      input, output_scale, output_zero_point, &output_lut);
+}
+
 template <int kSpatialDim>
 template <bool kReluFused>
 at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply_impl(
     const at::Tensor& act,
     double output_scale,
-    int64_t output_zero_point) {
+    int64_t output_zero_point,
+    const QnnpackOutputLut* output_lut) {
   const std::string func_name = transpose() ? "quantized::conv_transpose"
                                             : "quantized::conv";
   TORCH_CHECK(!(kReluFused && transpose()),
@@ -701,8 +716,8 @@ at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply_impl(
       at::device(c10::kCPU)
           .dtype(c10::kQUInt8)
           .memory_format(c10::MemoryFormat::ChannelsLast),
-      output_scale,
-      output_zero_point,
+      output_lut ? output_lut->output_scale : output_scale,
+      output_lut ? output_lut->output_zero_point : output_zero_point,
       c10::nullopt);
 
   pytorch_qnnp_status run_status;
@@ -718,7 +733,7 @@ at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply_impl(
         reinterpret_cast<uint8_t*>(act_nhwc.template data_ptr<c10::quint8>()),
         w_zero_points.data(),
         requantization_scales.data(),
-        output.q_zero_point(),
+        output_zero_point,
         output_min,
         output_max,
         reinterpret_cast<uint8_t*>(output.template data_ptr<c10::quint8>()),
@@ -735,11 +750,12 @@ at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply_impl(
         reinterpret_cast<uint8_t*>(act_nhwc.template data_ptr<c10::quint8>()),
         w_zero_points.data(),
         requantization_scales.data(),
-        output.q_zero_point(),
+        output_zero_point,
         output_min,
         output_max,
         reinterpret_cast<uint8_t*>(output.template data_ptr<c10::quint8>()),
-        caffe2::pthreadpool_());
+        caffe2::pthreadpool_(),
+        output_lut ? output_lut->table.data() : nullptr);
   }
 
   TORCH_INTERNAL_ASSERT(
@@ -769,6 +785,12 @@ template at::Tensor PackedConvWeightsQnnp<3>::apply_relu(
     double output_scale,
     int64_t output_zero_point);
 
+template at::Tensor PackedConvWeightsQnnp<2>::apply_with_lut(
+    const at::Tensor& act,
+    double output_scale,
+    int64_t output_zero_point,
+    const QnnpackOutputLut& output_lut);
+
 #endif // USE_PYTORCH_QNNPACK
 
 namespace at {
@@ -7,6 +7,9 @@
 #include <fbgemm/Fbgemm.h>
 #include <fbgemm/FbgemmEmbedding.h>
 #endif
+#if defined(__ARM_NEON__) || defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 #include <ATen/Parallel.h>
 
@@ -14,7 +17,84 @@ torch::class_<EmbeddingPackedParamsBase> register_embedding_params();
 
 namespace {
 
-// Fallback implementation when FBGEMM is not available.
+// Rows whose gather is prefetched ahead of the row being accumulated, the same
+// distance the FBGEMM kernels use.
+constexpr int64_t kEmbeddingBagPrefetchDistance = 16;
+constexpr int64_t kCacheLineSize = 64;
+
+inline void prefetch_row(const void* row, int64_t nbytes) {
+#if defined(__GNUC__) || defined(__clang__)
+  const char* ptr = static_cast<const char*>(row);
+  for (int64_t i = 0; i < nbytes; i += kCacheLineSize) {
+    __builtin_prefetch(ptr + i, /*rw=*/0, /*locality=*/1);
+  }
+#endif
+}
+
+#if defined(__ARM_NEON__) || defined(__aarch64__)
+// out[0:16] += scale * q + bias
+inline void accumulate_16(
+    uint8x16_t q,
+    float32x4_t vscale,
+    float32x4_t vbias,
+    float* out) {
+  const uint16x8_t q_lo = vmovl_u8(vget_low_u8(q));
+  const uint16x8_t q_hi = vmovl_u8(vget_high_u8(q));
+  const float32x4_t f[4] = {
+      vcvtq_f32_u32(vmovl_u16(vget_low_u16(q_lo))),
+      vcvtq_f32_u32(vmovl_u16(vget_high_u16(q_lo))),
+      vcvtq_f32_u32(vmovl_u16(vget_low_u16(q_hi))),
+      vcvtq_f32_u32(vmovl_u16(vget_high_u16(q_hi)))};
+  for (int k = 0; k < 4; ++k) {
+    const float32x4_t acc = vaddq_f32(vld1q_f32(out + 4 * k), vbias);
+#if defined(__aarch64__)
+    vst1q_f32(out + 4 * k, vfmaq_f32(acc, f[k], vscale));
+#else
+    vst1q_f32(out + 4 * k, vmlaq_f32(acc, f[k], vscale));
+#endif
+  }
+}
+#endif // defined(__ARM_NEON__) || defined(__aarch64__)
+
+// out[0:block_size] += scale * row + bias for a row of BIT_RATE bit values,
+// NUM_ELEM_PER_BYTE of them in a byte starting from the low bits.
+template <int BIT_RATE, int NUM_ELEM_PER_BYTE>
+inline void accumulate_row(
+    const uint8_t* row,
+    float scale,
+    float bias,
+    int64_t block_size,
+    float* out) {
+  int64_t j = 0;
+#if defined(__ARM_NEON__) || defined(__aarch64__)
+  const float32x4_t vscale = vdupq_n_f32(scale);
+  const float32x4_t vbias = vdupq_n_f32(bias);
+  if (BIT_RATE == 8) {
+    for (; j + 16 <= block_size; j += 16) {
+      accumulate_16(vld1q_u8(row + j), vscale, vbias, out + j);
+    }
+  } else if (BIT_RATE == 4) {
+    const uint8x8_t low_mask = vdup_n_u8(0x0F);
+    for (; j + 16 <= block_size; j += 16) {
+      const uint8x8_t packed = vld1_u8(row + j / 2);
+      // the low nibble of a byte is the even element
+      const uint8x8x2_t q = vzip_u8(vand_u8(packed, low_mask), vshr_n_u8(packed, 4));
+      accumulate_16(vcombine_u8(q.val[0], q.val[1]), vscale, vbias, out + j);
+    }
+  }
+#endif // defined(__ARM_NEON__) || defined(__aarch64__)
+  for (; j < block_size; ++j) {
+    uint8_t quantized = row[j / NUM_ELEM_PER_BYTE];
+    quantized >>= (j % NUM_ELEM_PER_BYTE) * BIT_RATE;
+    quantized &= (1 << BIT_RATE) - 1;
+
+    out[j] = fma(scale, quantized, out[j] + bias);
+  }
+}
+
+// Fallback implementation when FBGEMM is not available. The bags are
+// independent, so that they are split across threads. offsets_data has
+// output_size + 1 entries.
 template <
     typename IndexType,
     typename OffsetType,
@@ -23,93 +103,90 @@ template <
 at::Tensor& embedding_lookup_fallback_impl(
     const at::Tensor& weight,
     const at::Tensor& indices,
-    const at::Tensor& offsets,
+    const OffsetType* offsets_data,
     const c10::optional<at::Tensor>& per_sample_weights_,
     const c10::optional<at::Tensor>& compressed_indices_mapping,
     at::Tensor& output,
     const int64_t block_size,
     const int64_t output_size,
-    bool include_last_offset,
     bool pruned) {
   auto* output_data = output.data_ptr<float>();
   const auto weight_data = weight.data_ptr<uint8_t>();
   const auto indices_data = indices.data_ptr<IndexType>();
-  int32_t* compressed_indices_mapping_data = nullptr;
+  const int32_t* compressed_indices_mapping_data = nullptr;
+  int64_t compressed_index_size = 0;
+  if (pruned) {
+    compressed_indices_mapping_data =
+        compressed_indices_mapping.value().data_ptr<int32_t>();
+    compressed_index_size = compressed_indices_mapping.value().numel();
+  }
   const auto weight_sizes = weight.sizes();
   const int64_t N = weight_sizes[0];
   const int64_t weight_size = weight_sizes[1];
-  const int index_size = indices.numel();
-
-  auto accessor = offsets.accessor<OffsetType, 1>();
-  std::vector<OffsetType> lengths_data;
-
-  int64_t lower = accessor[0];
-  for (int64_t i = 1; i < offsets.numel(); ++i) {
-    lengths_data.push_back(accessor[i] - lower);
-    lower = accessor[i];
-  }
-  if (!include_last_offset) {
-    lengths_data.push_back(indices.numel() - lower);
-  }
-
-  int64_t current = 0;
-  float* per_sample_weights_data;
-  if (per_sample_weights_.has_value()) {
-    per_sample_weights_data = per_sample_weights_.value().data_ptr<float>();
-  }
-  for (int m = 0; m < output_size; ++m) {
-    memset(output_data, 0, block_size * sizeof(float));
+  const int64_t index_size = indices.numel();
+  const float* per_sample_weights_data = per_sample_weights_.has_value()
+      ? per_sample_weights_.value().data_ptr<float>()
+      : nullptr;
+
+  // The row of an index, -1 for the rows pruned away.
+  auto row_of = [&](int64_t current) -> int64_t {
+    if (!pruned) {
+      const int64_t idx = indices_data[current];
+      TORCH_CHECK((idx >= 0 && idx < N), "Invalid indices data");
+      return idx;
+    }
+    const int64_t uncompressed_idx = indices_data[current];
     TORCH_CHECK(
-        current + lengths_data[m] <= index_size,
-        "Expect the lengths data to be less than indices size");
-
-    for (int i = 0; i < lengths_data[m]; ++i, ++current) {
-      int64_t idx;
-      if (!pruned) {
-        idx = indices_data[current];
-        TORCH_CHECK((idx >= 0 && idx < N), "Invalid indices data");
-      } else {
-        int64_t uncompressed_idx = indices_data[current];
-        int compressed_index_size = compressed_indices_mapping.value().numel();
-        compressed_indices_mapping_data =
-            compressed_indices_mapping.value().data_ptr<int32_t>();
-        TORCH_CHECK(
-            uncompressed_idx >= 0 && uncompressed_idx < compressed_index_size,
-            "Invalid indices data for Sparse Op.")
-        idx = compressed_indices_mapping_data[uncompressed_idx];
+        uncompressed_idx >= 0 && uncompressed_idx < compressed_index_size,
+        "Invalid indices data for Sparse Op.")
+    return compressed_indices_mapping_data[uncompressed_idx];
+  };
+
+  at::parallel_for(0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
+    for (int64_t m = start_idx; m < end_idx; ++m) {
+      float* out = output_data + m * block_size;
+      memset(out, 0, block_size * sizeof(float));
+      const int64_t begin = offsets_data[m];
+      const int64_t end = offsets_data[m + 1];
+      TORCH_CHECK(
+          begin <= end && end <= index_size,
+          "Expect the lengths data to be less than indices size");
+
+      for (int64_t current = begin; current < end; ++current) {
+        if (current + kEmbeddingBagPrefetchDistance < end) {
+          const int64_t prefetch_idx =
+              row_of(current + kEmbeddingBagPrefetchDistance);
+          if (prefetch_idx >= 0) {
+            prefetch_row(weight_data + prefetch_idx * weight_size, weight_size);
+          }
+        }
+        const int64_t idx = row_of(current);
         if (idx == -1) {
           continue;
         }
-      }
-
-      float weight_val = 1.0f;
-      if (per_sample_weights_.has_value()) {
-        weight_val = per_sample_weights_data[current];
-      }
-      float scale, bias;
-      if (BIT_RATE == 8) {
-        const uint8_t* scale_bias =
-            weight_data + (idx + 1) * weight_size - 2 * sizeof(float);
-        scale = weight_val * reinterpret_cast<const float*>(scale_bias)[0];
-        bias = weight_val * reinterpret_cast<const float*>(scale_bias)[1];
-      } else {
-        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
-            weight_data + (idx + 1) * weight_size - 2 * sizeof(at::Half));
-        scale = weight_val * (scale_bias)[0];
-        bias = weight_val * (scale_bias)[1];
-      }
-
-      for (int j = 0; j < block_size; ++j) {
-        uint8_t quantized =
-            weight_data[idx * weight_size + j / NUM_ELEM_PER_BYTE];
-        quantized >>= (j % NUM_ELEM_PER_BYTE) * BIT_RATE;
-        quantized &= (1 << BIT_RATE) - 1;
-
-        output_data[j] = fma(scale, quantized, output_data[j] + bias);
-      }
-    } // for each i
-    output_data += block_size;
-  } // for each m
+
+        float weight_val = 1.0f;
+        if (per_sample_weights_data) {
+          weight_val = per_sample_weights_data[current];
+        }
+        float scale, bias;
+        if (BIT_RATE == 8) {
+          const uint8_t* scale_bias =
+              weight_data + (idx + 1) * weight_size - 2 * sizeof(float);
+          scale = weight_val * reinterpret_cast<const float*>(scale_bias)[0];
+          bias = weight_val * reinterpret_cast<const float*>(scale_bias)[1];
+        } else {
+          const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+              weight_data + (idx + 1) * weight_size - 2 * sizeof(at::Half));
+          scale = weight_val * (scale_bias)[0];
+          bias = weight_val * (scale_bias)[1];
+        }
+
+        accumulate_row<BIT_RATE, NUM_ELEM_PER_BYTE>(
+            weight_data + idx * weight_size, scale, bias, block_size, out);
+      } // for each index of the bag
+    } // for each m
+  });
   return output;
 }
 
@@ -239,13 +316,12 @@ at::Tensor& embedding_bag_4bit_impl(
   return embedding_lookup_fallback_impl<IndexType, OffsetType, 4, 2>(
       weight,
       indices,
-      offsets,
+      offsets_data,
       per_sample_weights_,
       compressed_indices_mapping,
       output,
       D,
       output_size,
-      include_last_offset,
       (pruned_weights && !fallback_to_no_sparse));
 #endif
 }
@@ -382,13 +458,12 @@ at::Tensor& embedding_bag_byte_impl(
   return embedding_lookup_fallback_impl<IndexType, OffsetType, 8, 1>(
       weight,
       indices,
-      offsets,
+      offsets_data,
       per_sample_weights_,
       compressed_indices_mapping,
       output,
       D,
       output_size,
-      include_last_offset,
       (pruned_weights && !fallback_to_no_sparse));
 #endif
 }
@@ -2,6 +2,8 @@
 #include <ATen/NativeFunctions.h>
 #include <torch/library.h>
 #include <ATen/quantized/Quantizer.h>
+#include <ATen/native/quantized/cpu/conv_packed_params.h>
+#include <ATen/native/quantized/cpu/packed_params.h>
 #include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <ATen/native/quantized/cpu/init_qnnpack.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
@@ -88,8 +90,99 @@ Tensor quantized_hardswish(const Tensor& qx, double output_scale, int64_t output
   return qy;
 }
 
+namespace {
+
+#ifdef USE_PYTORCH_QNNPACK
+// The table of qnnpack_hardswish, for inputs quantized with input_scale and
+// input_zero_point.
+QnnpackOutputLut qnnpack_hardswish_lut(
+    double input_scale,
+    int64_t input_zero_point,
+    double output_scale,
+    int64_t output_zero_point) {
+  QnnpackOutputLut lut;
+  pytorch_qnnp_compute_hardswish_lut_q8(
+      input_zero_point,
+      input_scale,
+      output_zero_point,
+      output_scale,
+      std::numeric_limits<uint8_t>::min(),
+      std::numeric_limits<uint8_t>::max(),
+      lut.table.data());
+  lut.output_scale = output_scale;
+  lut.output_zero_point = output_zero_point;
+  return lut;
+}
+#endif // USE_PYTORCH_QNNPACK
+
+// quantized::conv2d followed by quantized::hardswish. For weights prepacked
+// by QNNPACK, the hardswish is applied to the output tiles of the convolution
+// as they are written.
+class QConvHardswishInt8 final {
+ public:
+  static Tensor run(
+      Tensor act,
+      const c10::intrusive_ptr<ConvPackedParamsBase<2>>& packed_weight,
+      double conv_scale,
+      int64_t conv_zero_point,
+      double output_scale,
+      int64_t output_zero_point) {
+#ifdef USE_PYTORCH_QNNPACK
+    auto qnnp_weight =
+        c10::dynamic_intrusive_pointer_cast<PackedConvWeightsQnnp<2>>(
+            packed_weight);
+    if (qnnp_weight && act.scalar_type() == kQUInt8) {
+      return qnnp_weight->apply_with_lut(
+          act,
+          conv_scale,
+          conv_zero_point,
+          qnnpack_hardswish_lut(
+              conv_scale, conv_zero_point, output_scale, output_zero_point));
+    }
+#endif // USE_PYTORCH_QNNPACK
+    return quantized_hardswish(
+        packed_weight->apply(act, conv_scale, conv_zero_point),
+        output_scale,
+        output_zero_point);
+  }
+};
+
+// quantized::linear followed by quantized::hardswish, see QConvHardswishInt8.
+class QLinearHardswishInt8 final {
+ public:
+  static Tensor run(
+      Tensor input,
+      const c10::intrusive_ptr<LinearPackedParamsBase>& packed_weight,
+      double linear_scale,
+      int64_t linear_zero_point,
+      double output_scale,
+      int64_t output_zero_point) {
+#ifdef USE_PYTORCH_QNNPACK
+    auto qnnp_weight =
+        c10::dynamic_intrusive_pointer_cast<PackedLinearWeightsQnnp>(
+            packed_weight);
+    if (qnnp_weight && input.scalar_type() == kQUInt8) {
+      return qnnp_weight->apply_with_lut(
+          std::move(input),
+          linear_scale,
+          linear_zero_point,
+          qnnpack_hardswish_lut(
+              linear_scale, linear_zero_point, output_scale, output_zero_point));
+    }
+#endif // USE_PYTORCH_QNNPACK
+    return quantized_hardswish(
+        packed_weight->apply(std::move(input), linear_scale, linear_zero_point),
+        output_scale,
+        output_zero_point);
+  }
+};
+
+} // namespace
+
 TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
   m.impl(TORCH_SELECTIVE_NAME("quantized::hardswish"), TORCH_FN(quantized_hardswish));
+  m.impl(TORCH_SELECTIVE_NAME("quantized::conv2d_hardswish"), TORCH_FN(QConvHardswishInt8::run));
+  m.impl(TORCH_SELECTIVE_NAME("quantized::linear_hardswish"), TORCH_FN(QLinearHardswishInt8::run));
 }
 
 }}  // namespace at::native
@@ -9,6 +9,7 @@
 #include <torch/library.h>
 
 #include <algorithm>
+#include <limits>
 #include <string>
 
 torch::class_<LinearPackedParamsBase> register_linear_params();
@@ -229,7 +230,8 @@ template <bool ReluFused>
 at::Tensor PackedLinearWeightsQnnp::apply_impl(
     at::Tensor input,
     double output_scale,
-    int64_t output_zero_point) {
+    int64_t output_zero_point,
+    const QnnpackOutputLut* output_lut) {
   TORCH_CHECK(
       input.dim() >= 2,
       "quantized::linear(): Input tensor rank should be >= 2");
@@ -320,8 +322,8 @@ at::Tensor PackedLinearWeightsQnnp::apply_impl(
   at::Tensor output = at::_empty_affine_quantized(
       out_sizes,
       input.options(),
-      output_scale,
-      output_zero_point);
+      output_lut ? output_lut->output_scale : output_scale,
+      output_lut ? output_lut->output_zero_point : output_zero_point);
 
   auto output_min = ReluFused
       ? activationLimits(output_scale, output_zero_point, Activation::RELU)
@@ -349,7 +351,8 @@ at::Tensor PackedLinearWeightsQnnp::apply_impl(
       rows_w /* output_stride */,
       // TODO (Ashkan): Disabling temporarily.
       // Throws a floating point exception with OSS pthreadpool.
-      caffe2::pthreadpool_() /* threadpool */);
+      caffe2::pthreadpool_() /* threadpool */,
+      output_lut ? output_lut->table.data() : nullptr);
 
   TORCH_INTERNAL_ASSERT(
       runStatus == pytorch_qnnp_status_success,
@@ -372,6 +375,119 @@ at::Tensor PackedLinearWeightsQnnp::apply_relu(
   return apply_impl<true>(std::move(input), output_scale, output_zero_point);
 }
 
+at::Tensor PackedLinearWeightsQnnp::apply_with_lut(
+    at::Tensor input,
+    double output_scale,
+    int64_t output_zero_point,
+    const QnnpackOutputLut& output_lut) {
+  return apply_impl<false>(
+      std::move(input), output_scale, output_zero_point, &output_lut);
+}
+
+at::Tensor PackedLinearWeightQnnpSparse::apply_sparse_dq(
+    const at::Tensor& q_input) {
+  const size_t rows_w = bias_.size(0);
+  const size_t cols_input = q_input.size(q_input.dim() - 1);
+  size_t rows_input = 1;
+  for (size_t i = 0; i < q_input.dim() - 1; ++i) {
+    rows_input *= q_input.size(i);
+  }
+  TORCH_CHECK(
+      static_cast<int64_t>(cols_input) == in_features_,
+      "quantized::linear(): input size does not match weight dimension 1 size: \
+         got ",
+      cols_input,
+      " but expected ",
+      in_features_);
+
+  // The sparse kernels dequantize the int32 products with these scales.
+  generate_requantization_scales(
+      w_scales, q_input.q_scale(), 1.f, requantization_scales);
+
+  std::vector<int64_t> out_sizes = q_input.sizes().vec();
+  out_sizes.back() = static_cast<int64_t>(rows_w);
+  at::Tensor output =
+      at::empty(out_sizes, q_input.options().dtype(at::kFloat));
+
+  pytorch_qnnp_operator_t sparse_linear = nullptr;
+  pytorch_qnnp_status status =
+      pytorch_qnnp_create_fully_connected_sparse_dq_nc_q8(
+          cols_input /* input_channels */,
+          rows_w /* output_channels */,
+          q_input.q_zero_point(),
+          w_zero_points.data(),
+          bcsr_matrix->col_indices.data(),
+          bcsr_matrix->row_values.data(),
+          bcsr_matrix->values.data(),
+          bcsr_matrix->col_block_size,
+          0 /* output zero point: not used */,
+          std::numeric_limits<uint8_t>::min(),
+          std::numeric_limits<uint8_t>::max(),
+          0 /* flags */,
+          requantization_scales.data(),
+          false /* use_prepack_kernel */,
+          &sparse_linear);
+  TORCH_INTERNAL_ASSERT(
+      status == pytorch_qnnp_status_success,
+      "failed to create QNNPACK sparse Linear operator");
+  std::unique_ptr<pytorch_qnnp_operator, QnnpackOperatorDeleter>
+      sparse_linear_op(sparse_linear);
+
+  status = pytorch_qnnp_setup_fully_connected_sparse_dq_nc_q8(
+      sparse_linear,
+      rows_input /* batch_size */,
+      reinterpret_cast<uint8_t*>(q_input.data_ptr<c10::quint8>()),
+      cols_input /* input_stride */,
+      bias_.data_ptr<float>(),
+      output.data_ptr<float>(),
+      rows_w /* output_stride */);
+  TORCH_INTERNAL_ASSERT(
+      status == pytorch_qnnp_status_success,
+      "failed to setup QNNPACK sparse Linear operator");
+
+  status = pytorch_qnnp_run_operator(sparse_linear, caffe2::pthreadpool_());
+  TORCH_INTERNAL_ASSERT(
+      status == pytorch_qnnp_status_success,
+      "failed to run QNNPACK sparse Linear operator");
+  return output;
+}
+
+template <bool ReluFused>
+at::Tensor PackedLinearWeightQnnpSparse::apply_impl(
+    at::Tensor input,
+    double output_scale,
+    int64_t output_zero_point) {
+  TORCH_CHECK(
+      input.dim() >= 2,
+      "quantized::linear(): Input tensor rank should be >= 2");
+  TORCH_CHECK(
+      input.scalar_type() == c10::kQUInt8 &&
+          input.qscheme() == c10::kPerTensorAffine,
+      "quantized::linear(): Expected a per tensor quint8 input");
+  auto input_contig = input.contiguous();
+
+  at::Tensor output = apply_sparse_dq(input_contig);
+  if (ReluFused) {
+    output.relu_();
+  }
+  return at::quantize_per_tensor(
+      output, output_scale, output_zero_point, c10::kQUInt8);
+}
+
+at::Tensor PackedLinearWeightQnnpSparse::apply(
+    at::Tensor input,
+    double output_scale,
+    int64_t output_zero_point) {
+  return apply_impl<false>(std::move(input), output_scale, output_zero_point);
+}
+
+at::Tensor PackedLinearWeightQnnpSparse::apply_relu(
+    at::Tensor input,
+    double output_scale,
+    int64_t output_zero_point) {
+  return apply_impl<true>(std::move(input), output_scale, output_zero_point);
+}
+
 #endif // USE_PYTORCH_QNNPACK
 
 namespace at {
@@ -5,6 +5,7 @@
 #include <ATen/native/quantized/cpu/packed_params.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
 #include <ATen/native/quantized/cpu/quant_utils.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <caffe2/utils/threadpool/pthreadpool-cpp.h>
 #include <torch/library.h>
 
@@ -12,10 +13,33 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 torch::class_<LinearPackedParamsBase> register_linear_params();
 
 #ifdef USE_FBGEMM
+namespace {
+
+// The buffers fbgemm::PackAWithQuantRowOffset packs the quantized input and
+// its row offsets into. Their sizes only depend on the blocking of the CPU,
+// so every thread keeps one pair across calls instead of every packA
+// allocating and freeing them.
+struct PackAScratch {
+  std::vector<uint8_t> pmat;
+  std::vector<int32_t> row_offsets;
+};
+
+PackAScratch& get_pack_a_scratch() {
+  static thread_local PackAScratch scratch;
+  scratch.pmat.resize(
+      fbgemm::PackAWithQuantRowOffset<uint8_t>::packedBufferSize());
+  scratch.row_offsets.resize(
+      fbgemm::PackAWithQuantRowOffset<uint8_t>::rowOffsetBufferSize());
+  return scratch;
+}
+
+} // namespace
+
 template <bool ReluFused>
 at::Tensor PackedLinearWeight::apply_dynamic_impl(at::Tensor input, bool reduce_range) {
   using at::Tensor;
@@ -81,6 +105,7 @@ at::Tensor PackedLinearWeight::apply_dynamic_impl(at::Tensor input, bool reduce_
 
   const float* bias_ptr = nullptr;
   at::Tensor bias_vec;
+  at::Tensor bias_contig;
   if (bias_.has_value()) {
     bias_vec = bias_.value();
     TORCH_CHECK(bias_vec.dim() == 1, "bias should be a vector (1D Tensor)");
@@ -88,7 +113,8 @@ at::Tensor PackedLinearWeight::apply_dynamic_impl(at::Tensor input, bool reduce_
         bias_vec.size(0) == N,
         "bias should have N elements: " + std::to_string(N));
     // TODO: contiguous is called for further jit optimizations.
-    auto bias_contig = bias_vec.contiguous();
+    // bias_contig outlives the GEMM, which reads bias_ptr.
+    bias_contig = bias_vec.contiguous();
     bias_ptr = bias_contig.data_ptr<float>();
   }
   // The resulting matrix here is 2-D, let's view it with the original
@@ -119,18 +145,22 @@ at::Tensor PackedLinearWeight::apply_dynamic_impl(at::Tensor input, bool reduce_
     //
     //  Note this is not executed eagerly, but rather within the fbgemmPacked
     //  call below.
+    //
+    //  The packed tiles and the row offsets go to buffers of this thread
+    //  that are reused by the next calls, see get_pack_a_scratch().
 
+    auto& scratch = get_pack_a_scratch();
     fbgemm::PackAWithQuantRowOffset<uint8_t> packA(
         /*trans=*/fbgemm::matrix_op_t::NoTranspose,
         /*nRow=*/M,
         /*nCol=*/K,
         /*smat=*/input_ptr,
         /*ld=*/K,
-        /*pmat=*/nullptr, // Currently, packA manages ownership of `pmat`.
+        /*pmat=*/scratch.pmat.data(),
         /*scale=*/q_params.scale,
-        /*zero_pt=*/q_params.zero_point);
-    // TODO: Consider a way to pre-allocate and reuse
-    // pmat buffer.
+        /*zero_pt=*/q_params.zero_point,
+        /*groups=*/1,
+        /*row_offset=*/scratch.row_offsets.data());
 
     // This is the end of the pipeline, pass the resulting matrix through.
     fbgemm::DoNothing<float, float> doNothingObj{};
@@ -352,6 +382,48 @@ at::Tensor PackedLinearWeightsQnnp::apply_dynamic_relu(at::Tensor input, bool re
   return apply_dynamic_impl</*ReluFused=*/true>(std::move(input));
 }
 
+template <bool ReluFused>
+at::Tensor PackedLinearWeightQnnpSparse::apply_dynamic_impl(at::Tensor input) {
+  TORCH_CHECK(
+      input.dim() >= 2,
+      "The dimension of input tensor should be larger than or equal to 2");
+  auto input_contig = input.contiguous();
+
+  float x_min;
+  float x_max;
+  if (input.numel() > 0) {
+    x_min = input_contig.min().item<float>();
+    x_max = input_contig.max().item<float>();
+  } else {
+    // On empty input, no output data will be generated,
+    // so use arbitrary qparams.
+    x_min = 0;
+    x_max = 0;
+  }
+
+  auto q_params = quant_utils::ChooseQuantizationParams(
+      /*min=*/x_min,
+      /*max=*/x_max,
+      /*qmin=*/0,
+      /*qmax=*/255);
+  at::Tensor q_input = at::quantize_per_tensor(
+      input_contig, q_params.scale, q_params.zero_point, c10::kQUInt8);
+
+  at::Tensor output = apply_sparse_dq(q_input);
+  if (ReluFused) {
+    output.relu_();
+  }
+  return output;
+}
+
+at::Tensor PackedLinearWeightQnnpSparse::apply_dynamic(at::Tensor input, bool reduce_range) {
+  return apply_dynamic_impl</*ReluFused=*/false>(std::move(input));
+}
+
+at::Tensor PackedLinearWeightQnnpSparse::apply_dynamic_relu(at::Tensor input, bool reduce_range) {
+  return apply_dynamic_impl</*ReluFused=*/true>(std::move(input));
+}
+
 #endif // USE_PYTORCH_QNNPACK
 
 #ifdef USE_FBGEMM
@@ -402,10 +474,60 @@ void PackedLinearWeightFp16::set_bias(c10::optional<at::Tensor> bias) {
   bias_ = std::move(bias);
 }
 
+template <bool ReluFused>
+at::Tensor PackedLinearWeightInt4::apply_dynamic_impl(at::Tensor input) {
+  TORCH_CHECK(
+      input.dim() >= 2,
+      "The dimension of input tensor should be larger than or equal to 2");
+  TORCH_CHECK(
+      input.scalar_type() == at::kFloat,
+      "quantized::linear_dynamic with 4-bit weights expects a float input, got ",
+      input.scalar_type());
+  const int64_t K = input.size(input.dim() - 1);
+  const int64_t N = w.size(0);
+  TORCH_CHECK(
+      K == w.size(1) * group_size(),
+      "The number of columns of the input should be equal to K: ",
+      w.size(1) * group_size());
+
+  const int64_t M = size_to_dim_(input.dim() - 1, input.sizes());
+  const at::Tensor input_contig = input.contiguous().view({M, K});
+  at::Tensor bias_contig;
+  if (bias_.has_value()) {
+    TORCH_CHECK(
+        bias_->dim() == 1 && bias_->size(0) == N,
+        "bias should have N elements: " + std::to_string(N));
+    bias_contig = bias_->contiguous();
+  }
+  std::vector<int64_t> output_size = input.sizes().vec();
+  output_size.back() = N;
+  at::Tensor output = at::empty(output_size, input.options().dtype(at::kFloat));
+  at::Tensor output_2d = output.view({M, N});
+
+  at::native::qlinear_int4_stub(
+      at::kCPU, input_contig, w, bias_contig, ReluFused, output_2d);
+  return output;
+}
+
+at::Tensor PackedLinearWeightInt4::apply_dynamic(at::Tensor input, bool reduce_range) {
+  return apply_dynamic_impl</*ReluFused=*/false>(std::move(input));
+}
+
+at::Tensor PackedLinearWeightInt4::apply_dynamic_relu(at::Tensor input, bool reduce_range) {
+  return apply_dynamic_impl</*ReluFused=*/true>(std::move(input));
+}
+
+void PackedLinearWeightInt4::set_bias(c10::optional<at::Tensor> bias) {
+  bias_ = std::move(bias);
+}
+
 #endif // USE_FBGEMM
 
 namespace at {
 namespace native {
+
+DEFINE_DISPATCH(qlinear_int4_stub);
+
 namespace {
 
 template <bool ReluFused>
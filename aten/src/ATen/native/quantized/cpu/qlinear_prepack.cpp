@@ -1,4 +1,5 @@
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/init_qnnpack.h>
@@ -9,6 +10,7 @@
 #include <torch/custom_class.h>
 #include <torch/library.h>
 #include <algorithm>
+#include <cmath>
 #include <vector>
 
 torch::class_<LinearPackedParamsBase> register_linear_params();
@@ -114,6 +116,114 @@ c10::intrusive_ptr<LinearPackedParamsBase> PackedLinearWeight::prepack(
 #endif // USE_FBGEMM
 
 #ifdef USE_PYTORCH_QNNPACK
+namespace {
+// The fraction of the 1 x col_block_size blocks of the rows of the int8
+// weight that have an element other than the zero point of their row, which
+// are the blocks kept by qnnpack::generateBlockCSRMatrix.
+double sparse_block_density(
+    const at::Tensor& weight_contig,
+    const std::vector<uint8_t>& w_zero_points,
+    int64_t col_block_size) {
+  const int64_t N = weight_contig.size(0);
+  const int64_t K = weight_contig.size(1);
+  const int64_t blocks_per_row = (K + col_block_size - 1) / col_block_size;
+  if (N * blocks_per_row == 0) {
+    return 1.0;
+  }
+  const int8_t* w_data =
+      reinterpret_cast<const int8_t*>(weight_contig.data_ptr<c10::qint8>());
+  int64_t nnz_blocks = 0;
+  for (int64_t n = 0; n < N; ++n) {
+    const int8_t* row = w_data + n * K;
+    const int8_t zero_point = static_cast<int8_t>(w_zero_points[n] - 128);
+    for (int64_t k = 0; k < K; k += col_block_size) {
+      const int8_t* block_end = row + std::min(k + col_block_size, K);
+      nnz_blocks += std::any_of(row + k, block_end, [&](int8_t w) {
+        return w != zero_point;
+      });
+    }
+  }
+  return static_cast<double>(nnz_blocks) / (N * blocks_per_row);
+}
+} // namespace
+
+c10::intrusive_ptr<LinearPackedParamsBase> PackedLinearWeightQnnpSparse::prepack(
+    at::Tensor weight,
+    c10::optional<at::Tensor> bias_in,
+    int64_t out_features_block_size,
+    int64_t in_features_block_size) {
+  TORCH_CHECK(
+      out_features_block_size == 1 && in_features_block_size == kColBlockSize,
+      "quantized::linear_prepack_sparse (qnnpack): only blocks of 1 x ",
+      kColBlockSize,
+      " are supported, got ",
+      out_features_block_size,
+      " x ",
+      in_features_block_size);
+  TORCH_CHECK(
+      weight.dim() == 2 && weight.scalar_type() == c10::kQInt8,
+      "quantized::linear_prepack_sparse (qnnpack): Expected a 2-D qint8 "
+      "weight");
+
+  const int64_t rows_w = weight.size(0);
+  const int64_t cols_w = weight.size(1);
+  at::Tensor bias_fp32;
+  if (bias_in.has_value()) {
+    bias_fp32 = bias_in.value();
+  } else {
+    bias_fp32 = at::zeros(rows_w, weight.options().dtype(at::kFloat));
+  }
+  TORCH_CHECK(
+      bias_fp32.ndimension() == 1 && bias_fp32.size(0) == rows_w,
+      "quantized::linear_prepack_sparse (qnnpack): Given weight of size ",
+      weight.sizes(),
+      ", expected bias to be 1-dimensional with ",
+      rows_w,
+      " elements",
+      ", but got bias of size ",
+      bias_fp32.sizes(),
+      " instead");
+  TORCH_CHECK(
+      cols_w > 0,
+      "quantized::linear_prepack_sparse (qnnpack): Expected a weight with "
+      "at least one column");
+
+  at::Tensor weight_contig = weight.contiguous();
+  std::vector<uint8_t> w_zero_points;
+  at::Tensor w_scales;
+  std::tie(w_zero_points, w_scales) =
+      make_zero_points_and_scales_tensor(weight_contig);
+
+  // Adjust the weight to uint8 from int8, like its zero points.
+  std::vector<uint8_t> qnnp_w_data(weight_contig.numel());
+  const int8_t* w_data =
+      reinterpret_cast<const int8_t*>(weight_contig.data_ptr<c10::qint8>());
+  for (size_t i = 0; i < qnnp_w_data.size(); ++i) {
+    qnnp_w_data[i] = static_cast<uint8_t>(w_data[i] + 128);
+  }
+
+  at::native::initQNNPACK();
+
+  auto bcsr_matrix = qnnpack::generateBlockCSRMatrix(
+      qnnp_w_data.data(),
+      rows_w,
+      cols_w,
+      kColBlockSize,
+      w_zero_points.data());
+  auto wt_ptr = c10::make_intrusive<PackedLinearWeightQnnpSparse>(
+      std::move(bcsr_matrix),
+      weight_contig, /* int8_t weight */
+      bias_fp32.contiguous(), /* fp32 bias */
+      w_scales,
+      std::move(w_zero_points));
+  if (at::globalContext().releaseWeightsWhenPrepacking()) {
+    // On mobile, we release the original weight by resetting the
+    // intrusive_ptr. Calling unpack after this will throw an assertion.
+    wt_ptr->orig_weight.reset();
+  }
+  return wt_ptr;
+}
+
 c10::intrusive_ptr<LinearPackedParamsBase> PackedLinearWeightsQnnp::prepack(
     at::Tensor weight,
     c10::optional<at::Tensor> bias_in) {
@@ -146,6 +256,17 @@ c10::intrusive_ptr<LinearPackedParamsBase> PackedLinearWeightsQnnp::prepack(
   std::tie(w_zero_points, w_scales) =
       make_zero_points_and_scales_tensor(weight_contig);
 
+  // Pruned weights run faster in the block sparse kernels.
+  if (weight_contig.size(1) > 0 &&
+      sparse_block_density(
+          weight_contig,
+          w_zero_points,
+          PackedLinearWeightQnnpSparse::kColBlockSize) <=
+          PackedLinearWeightQnnpSparse::kSparseBlockDensityThreshold) {
+    return PackedLinearWeightQnnpSparse::prepack(
+        std::move(weight_contig), std::move(bias_fp32));
+  }
+
   at::native::initQNNPACK();
 
   // We set the pre-packed linear weights to nullptr below as we call pre-pack
@@ -189,6 +310,76 @@ c10::intrusive_ptr<LinearPackedParamsBase> PackedLinearWeightFp16::prepack(
       bias);
   return ptr;
 }
+
+c10::intrusive_ptr<LinearPackedParamsBase> PackedLinearWeightInt4::prepack(
+    at::Tensor weight,
+    c10::optional<at::Tensor> bias,
+    int64_t group_size) {
+  TORCH_CHECK(
+      weight.dim() == 2 && weight.scalar_type() == at::kFloat,
+      "quantized::linear_prepack_int4 expects a 2-D float weight");
+  const int64_t N = weight.size(0);
+  const int64_t K = weight.size(1);
+  TORCH_CHECK(
+      group_size > 0 && group_size % 2 == 0 && K % group_size == 0,
+      "quantized::linear_prepack_int4 expects an even group_size that "
+      "divides the number of columns ",
+      K,
+      ", got ",
+      group_size);
+  const int64_t num_groups = K / group_size;
+  const int64_t group_bytes = group_size / 2 + 2 * sizeof(at::Half);
+  at::Tensor weight_contig = weight.contiguous();
+  const float* weight_data = weight_contig.data_ptr<float>();
+  at::Tensor packed = at::empty({N, num_groups, group_bytes}, at::kByte);
+  uint8_t* packed_data = packed.data_ptr<uint8_t>();
+
+  // Like the row-wise quantization of quantized::embedding_bag_4bit_prepack,
+  // one group at a time.
+  at::parallel_for(0, N * num_groups, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const float* input_group = weight_data + i * group_size;
+      uint8_t* output_group = packed_data + i * group_bytes;
+      const float Xmin = static_cast<at::Half>(
+          *std::min_element(input_group, input_group + group_size));
+      const float Xmax =
+          *std::max_element(input_group, input_group + group_size);
+      const float range = Xmax - Xmin;
+      at::Half scale = range == 0 ? 1.0f : range / 15;
+      float inverse_scale = 1.0f / scale;
+      if (scale == 0 || std::isinf(inverse_scale)) {
+        scale = 1.0f;
+        inverse_scale = 1.0f;
+      }
+      at::Half* output_qparams =
+          reinterpret_cast<at::Half*>(output_group + group_size / 2);
+      output_qparams[0] = scale;
+      output_qparams[1] = Xmin;
+      const auto quantize = [&](float x) {
+        return static_cast<uint8_t>(std::max(
+            0, std::min<int>(lrintf((x - Xmin) * inverse_scale), 15)));
+      };
+      for (int64_t k = 0; k < group_size; k += 2) {
+        output_group[k / 2] = quantize(input_group[k]) |
+            (quantize(input_group[k + 1]) << 4);
+      }
+    }
+  });
+  return c10::make_intrusive<PackedLinearWeightInt4>(
+      std::move(packed), std::move(bias));
+}
+
+c10::intrusive_ptr<LinearPackedParamsBase> PackedLinearWeightInt4::from_packed(
+    at::Tensor packed_weight,
+    c10::optional<at::Tensor> bias) {
+  TORCH_CHECK(
+      packed_weight.dim() == 3 && packed_weight.scalar_type() == at::kByte &&
+          packed_weight.size(2) > 2 * static_cast<int64_t>(sizeof(at::Half)),
+      "Expected a 4-bit packed linear weight of N x (K / group_size) x "
+      "(group_size / 2 + 4) bytes");
+  return c10::make_intrusive<PackedLinearWeightInt4>(
+      packed_weight.contiguous(), std::move(bias));
+}
 #endif // USE_FBGEMM
 
 namespace at {
@@ -254,6 +445,58 @@ class QLinearPackWeightFp16 final {
   }
 };
 
+class QLinearPackWeightInt4 final {
+ public:
+  static c10::intrusive_ptr<LinearPackedParamsBase> run(
+      at::Tensor weight,
+      c10::optional<Tensor> bias,
+      int64_t group_size) {
+    auto& ctx = at::globalContext();
+#ifdef USE_FBGEMM
+    if (ctx.qEngine() == at::QEngine::FBGEMM) {
+      return PackedLinearWeightInt4::prepack(
+          std::move(weight), std::move(bias), group_size);
+    }
+#endif // USE_FBGEMM
+#ifdef USE_PYTORCH_QNNPACK
+    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+      TORCH_CHECK(
+          false,
+          "quantized::linear_prepack_int4 is currently "
+          "not supported by QNNPACK");
+    }
+#endif // USE_PYTORCH_QNNPACK
+    TORCH_CHECK(
+        false,
+        "Didn't find engine for operation quantized::linear_prepack_int4 ",
+        toString(ctx.qEngine()));
+  }
+};
+
+class QLinearPackWeightSparse final {
+ public:
+  static c10::intrusive_ptr<LinearPackedParamsBase> run(
+      at::Tensor weight,
+      c10::optional<Tensor> bias,
+      int64_t out_features_block_size,
+      int64_t in_features_block_size) {
+    auto& ctx = at::globalContext();
+#ifdef USE_PYTORCH_QNNPACK
+    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+      return PackedLinearWeightQnnpSparse::prepack(
+          std::move(weight),
+          std::move(bias),
+          out_features_block_size,
+          in_features_block_size);
+    }
+#endif // USE_PYTORCH_QNNPACK
+    TORCH_CHECK(
+        false,
+        "Didn't find engine for operation quantized::linear_prepack_sparse ",
+        toString(ctx.qEngine()));
+  }
+};
+
 class QLinearPackWeightInt8Legacy final {
  public:
   static Tensor run(at::Tensor weight, c10::optional<Tensor> bias) {
@@ -320,11 +563,13 @@ class QLinearPackWeightFp16Legacy final {
 TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
   m.impl(TORCH_SELECTIVE_NAME("quantized::linear_prepack"), TORCH_FN(QLinearPackWeightInt8::run));
   m.impl(TORCH_SELECTIVE_NAME("quantized::linear_prepack_legacy"), TORCH_FN(QLinearPackWeightInt8Legacy::run));
+  m.impl(TORCH_SELECTIVE_NAME("quantized::linear_prepack_sparse"), TORCH_FN(QLinearPackWeightSparse::run));
 }
 
 TORCH_LIBRARY_IMPL(quantized, CPU, m) {
   m.impl(TORCH_SELECTIVE_NAME("quantized::linear_prepack_fp16"), TORCH_FN(QLinearPackWeightFp16::run));
   m.impl(TORCH_SELECTIVE_NAME("quantized::linear_prepack_fp16_legacy"), TORCH_FN(QLinearPackWeightFp16Legacy::run));
+  m.impl(TORCH_SELECTIVE_NAME("quantized::linear_prepack_int4"), TORCH_FN(QLinearPackWeightInt4::run));
 }
 
 TORCH_LIBRARY_IMPL(_quantized, QuantizedCPU, m) {
@@ -54,6 +54,15 @@ std::tuple<at::Tensor, c10::optional<at::Tensor>> PackedLinearWeightsQnnp::
       "Call at::globalContext()::setReleaseOriginalWeights(false) before packing or loading to enable unpacking.");
   return std::tuple<at::Tensor, c10::optional<at::Tensor>>(orig_weight, bias_);
 }
+
+std::tuple<at::Tensor, c10::optional<at::Tensor>> PackedLinearWeightQnnpSparse::
+    unpack() {
+  TORCH_CHECK(
+      orig_weight.defined(),
+      "Cannot unpack weights. "
+      "Call at::globalContext()::setReleaseOriginalWeights(false) before packing or loading to enable unpacking.");
+  return std::tuple<at::Tensor, c10::optional<at::Tensor>>(orig_weight, bias_);
+}
 #endif // USE_PYTORCH_QNNPACK
 
 #ifdef USE_FBGEMM
@@ -72,6 +81,11 @@ std::tuple<at::Tensor, c10::optional<at::Tensor>> PackedLinearWeightFp16::
 
   return std::make_tuple(unpacked_weight.to(at::kFloat), bias_);
 }
+
+std::tuple<at::Tensor, c10::optional<at::Tensor>> PackedLinearWeightInt4::
+    unpack() {
+  return std::make_tuple(w, bias_);
+}
 #endif // USE_FBGEMM
 
 namespace at {
@@ -101,6 +115,21 @@ class QLinearUnpackWeightFp16 final {
   }
 };
 
+class QLinearUnpackWeightInt4 final {
+ public:
+  static std::tuple<at::Tensor, c10::optional<Tensor>> run(
+      const c10::intrusive_ptr<LinearPackedParamsBase>& packed_weight) {
+    auto& ctx = at::globalContext();
+
+    TORCH_CHECK(
+        ctx.qEngine() != at::QEngine::QNNPACK,
+        "quantized::linear_unpack_int4 is currently "
+        "not supported by QNNPACK");
+
+    return packed_weight->unpack();
+  }
+};
+
 class QLinearUnpackWeightInt8Legacy final {
  public:
   static std::tuple<at::Tensor, c10::optional<Tensor>> run(
@@ -144,6 +173,7 @@ TORCH_LIBRARY_IMPL(quantized, CPU, m) {
 TORCH_LIBRARY_IMPL(quantized, CatchAll, m) {
   m.impl(TORCH_SELECTIVE_NAME("quantized::linear_unpack"), TORCH_FN(QLinearUnpackWeightInt8::run));
   m.impl(TORCH_SELECTIVE_NAME("quantized::linear_unpack_fp16"), TORCH_FN(QLinearUnpackWeightFp16::run));
+  m.impl(TORCH_SELECTIVE_NAME("quantized::linear_unpack_int4"), TORCH_FN(QLinearUnpackWeightInt4::run));
 }
 
 } // namespace
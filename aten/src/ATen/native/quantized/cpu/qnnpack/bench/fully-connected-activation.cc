@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <pytorch_qnnpack.h>
+#include <qnnpack_func.h>
+
+#include <benchmark/benchmark.h>
+
+/*
+ * Fully connected layers followed by Hardswish, with the activation run as a
+ * separate operator over the output or fused into the output tiles of the
+ * GEMM through the output_lut of qnnpack::qnnpackLinear.
+ */
+class FullyConnectedHardswish : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State& state) override {
+    batchSize_ = static_cast<size_t>(state.range(0));
+    inputChannels_ = static_cast<size_t>(state.range(1));
+    outputChannels_ = static_cast<size_t>(state.range(2));
+
+    std::random_device randomDevice;
+    auto rng = std::mt19937(randomDevice());
+    auto s32rng =
+        std::bind(std::uniform_int_distribution<int32_t>(-10000, 10000), rng);
+    auto u8rng = std::bind(std::uniform_int_distribution<uint8_t>(), rng);
+
+    input_.resize(batchSize_ * inputChannels_);
+    std::generate(input_.begin(), input_.end(), std::ref(u8rng));
+    std::vector<uint8_t> kernel(outputChannels_ * inputChannels_);
+    std::generate(kernel.begin(), kernel.end(), std::ref(u8rng));
+    std::vector<int32_t> bias(outputChannels_);
+    std::generate(bias.begin(), bias.end(), std::ref(s32rng));
+    output_.resize(batchSize_ * outputChannels_);
+    activation_.resize(batchSize_ * outputChannels_);
+
+    kernelZeroPoints_.assign(outputChannels_ + 8, 127);
+    requantizationScales_.assign(outputChannels_ + 8, 0.5f / inputChannels_);
+
+    if (pytorch_qnnp_initialize() != pytorch_qnnp_status_success) {
+      return;
+    }
+    packedWeights_.reset(new qnnpack::PackBMatrix(
+        inputChannels_,
+        outputChannels_,
+        kernelZeroPoints_.data(),
+        requantizationScales_.data(),
+        kernel.data(),
+        bias.data()));
+    pytorch_qnnp_compute_hardswish_lut_q8(
+        127 /* input zero point */,
+        0.05f /* input scale */,
+        127 /* output zero point */,
+        0.025f /* output scale */,
+        0 /* output min */,
+        255 /* output max */,
+        lut_);
+  }
+
+  void TearDown(benchmark::State& state) override {
+    const size_t itemsPerIteration =
+        batchSize_ * inputChannels_ * outputChannels_;
+    state.SetItemsProcessed(
+        int64_t(state.iterations()) * int64_t(itemsPerIteration));
+    packedWeights_.reset();
+  }
+
+  pytorch_qnnp_status runLinear(uint8_t* output, const uint8_t* outputLut) {
+    return qnnpack::qnnpackLinear(
+        batchSize_,
+        inputChannels_,
+        outputChannels_,
+        127 /* input zero point */,
+        kernelZeroPoints_.data(),
+        requantizationScales_.data(),
+        127 /* output zero point */,
+        0 /* output min */,
+        255 /* output max */,
+        input_.data(),
+        inputChannels_ /* input stride */,
+        packedWeights_->getPackedWeights(),
+        output,
+        outputChannels_ /* output stride */,
+        nullptr /* thread pool */,
+        outputLut);
+  }
+
+ protected:
+  size_t batchSize_;
+  size_t inputChannels_;
+  size_t outputChannels_;
+  std::vector<uint8_t> input_;
+  std::vector<uint8_t> output_;
+  std::vector<uint8_t> activation_;
+  std::vector<uint8_t> kernelZeroPoints_;
+  std::vector<float> requantizationScales_;
+  std::unique_ptr<qnnpack::PackBMatrix> packedWeights_;
+  uint8_t lut_[256];
+};
+
+BENCHMARK_DEFINE_F(FullyConnectedHardswish, unfused)(benchmark::State& state) {
+  if (!packedWeights_) {
+    state.SkipWithError("failed to initialize QNNPACK");
+    return;
+  }
+
+  pytorch_qnnp_operator_t hardswishOperator = nullptr;
+  pytorch_qnnp_status status = pytorch_qnnp_create_hardswish_nc_q8(
+      outputChannels_,
+      127 /* input zero point */,
+      0.05f /* input scale */,
+      127 /* output zero point */,
+      0.025f /* output scale */,
+      0 /* output min */,
+      255 /* output max */,
+      0 /* flags */,
+      &hardswishOperator);
+  if (status != pytorch_qnnp_status_success || hardswishOperator == nullptr) {
+    state.SkipWithError("failed to create Hardswish operator");
+  }
+
+  status = pytorch_qnnp_setup_hardswish_nc_q8(
+      hardswishOperator,
+      batchSize_,
+      output_.data(),
+      outputChannels_ /* input:stride */,
+      activation_.data(),
+      outputChannels_ /* output:stride */);
+  if (status != pytorch_qnnp_status_success) {
+    state.SkipWithError("failed to setup Hardswish operator");
+  }
+
+  for (auto _ : state) {
+    if (runLinear(output_.data(), nullptr) != pytorch_qnnp_status_success) {
+      state.SkipWithError("failed to run Linear operator");
+    }
+    status =
+        pytorch_qnnp_run_operator(hardswishOperator, nullptr /* thread pool */);
+    if (status != pytorch_qnnp_status_success) {
+      state.SkipWithError("failed to run Hardswish operator");
+    }
+  }
+
+  status = pytorch_qnnp_delete_operator(hardswishOperator);
+  if (status != pytorch_qnnp_status_success) {
+    state.SkipWithError("failed to delete Hardswish operator");
+  }
+}
+
+BENCHMARK_DEFINE_F(FullyConnectedHardswish, fused)(benchmark::State& state) {
+  if (!packedWeights_) {
+    state.SkipWithError("failed to initialize QNNPACK");
+    return;
+  }
+
+  for (auto _ : state) {
+    if (runLinear(output_.data(), lut_) != pytorch_qnnp_status_success) {
+      state.SkipWithError("failed to run Linear operator");
+    }
+  }
+}
+
+/* Pointwise convolutions of MobileNetV3, as M x K x N GEMMs */
+static void MobileNetV3Arguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "K", "N"});
+
+  b->Args({112 * 112, 16, 16});
+  b->Args({56 * 56, 16, 64});
+  b->Args({28 * 28, 24, 72});
+  b->Args({14 * 14, 40, 240});
+  b->Args({14 * 14, 80, 200});
+  b->Args({14 * 14, 112, 672});
+  b->Args({7 * 7, 160, 960});
+  b->Args({1, 960, 1280});
+}
+
+BENCHMARK_REGISTER_F(FullyConnectedHardswish, unfused)
+    ->Apply(MobileNetV3Arguments);
+BENCHMARK_REGISTER_F(FullyConnectedHardswish, fused)
+    ->Apply(MobileNetV3Arguments);
+
+#ifndef PYTORCH_QNNPACK_BENCHMARK_NO_MAIN
+BENCHMARK_MAIN();
+#endif
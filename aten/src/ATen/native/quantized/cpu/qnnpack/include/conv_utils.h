@@ -27,6 +27,20 @@ static inline size_t compute_output_dimension(
     return (input_dim + pad_dim - kernel_dim) / stride_dim + 1;
   }
 }
+
+// Maps the rows x columns output tile at c through the 256 entry lookup
+// table of a fused activation, right after the tile has been requantized and
+// while it is still in cache. See output_lut of qnnpackConv.
+static inline void apply_output_lut(
+    const uint8_t* lut,
+    size_t rows,
+    size_t columns,
+    uint8_t* c,
+    size_t c_stride) {
+  for (size_t row = 0; row < rows; row++) {
+    pytorch_qnnp_params.x8lut(columns, c + row * c_stride, lut, c + row * c_stride);
+  }
+}
 }  // namespace
 
 struct conv_param_t {
@@ -309,6 +309,15 @@ enum pytorch_qnnp_status pytorch_qnnp_setup_sigmoid_nc_q8(
     uint8_t* output,
     size_t output_stride);
 
+/* The lookup table of the Sigmoid operator, whose output scale is 1/256 and
+ * output zero point is 0. The arguments are not validated. */
+void pytorch_qnnp_compute_sigmoid_lut_q8(
+    uint8_t input_zero_point,
+    float input_scale,
+    uint8_t output_min,
+    uint8_t output_max,
+    uint8_t lookup_table[256]);
+
 enum pytorch_qnnp_status pytorch_qnnp_create_leaky_relu_nc_q8(
     size_t channels,
     float negative_slope,
@@ -402,6 +411,17 @@ enum pytorch_qnnp_status pytorch_qnnp_setup_hardswish_nc_q8(
     uint8_t* output,
     size_t output_stride);
 
+/* The lookup table of the Hardswish operator. The arguments are not
+ * validated. */
+void pytorch_qnnp_compute_hardswish_lut_q8(
+    uint8_t input_zero_point,
+    float input_scale,
+    uint8_t output_zero_point,
+    float output_scale,
+    uint8_t output_min,
+    uint8_t output_max,
+    uint8_t lookup_table[256]);
+
 enum pytorch_qnnp_status pytorch_qnnp_run_operator(
     pytorch_qnnp_operator_t op,
     pthreadpool_t threadpool);
@@ -91,6 +91,11 @@ class PackBMatrix final {
   size_t output_channels_;
 };
 
+// output_lut, if not null, is a 256 entry lookup table from the requantized
+// outputs to the outputs of an activation (see pytorch_qnnp_compute_*_lut_q8),
+// applied to each output tile right after the microkernel has written it.
+// This fuses the activation into the GEMM instead of running it as a
+// separate pass over the output.
 enum pytorch_qnnp_status qnnpackLinear(
     const size_t batch_size,
     const size_t input_channels,
@@ -106,8 +111,10 @@ enum pytorch_qnnp_status qnnpackLinear(
     void* packed_weights,
     uint8_t* output,
     const size_t output_stride,
-    pthreadpool_t threadpool);
+    pthreadpool_t threadpool,
+    const uint8_t* output_lut = nullptr);
 
+// See qnnpackLinear for output_lut.
 enum pytorch_qnnp_status qnnpackConv(
     const conv_param_t& conv_p,
     const pytorch_qnnp_operator_t convolution,
@@ -123,7 +130,8 @@ enum pytorch_qnnp_status qnnpackConv(
     const uint8_t output_min,
     const uint8_t output_max,
     uint8_t* output,
-    pthreadpool_t threadpool);
+    pthreadpool_t threadpool,
+    const uint8_t* output_lut = nullptr);
 
 enum pytorch_qnnp_status qnnpackDeConv(
     const conv_param_t& deconv_p,
@@ -23,6 +23,7 @@ struct q8gemm_xzp_context {
   size_t a_sum_stride;
   union pytorch_qnnp_q31_requantization_params requantization_params;
   const pytorch_q8gemm_xzp_ukernel_function ukernel;
+  const uint8_t* output_lut;
 };
 static void compute_q8gemm_xzp(
     const struct q8gemm_xzp_context context[1],
@@ -60,6 +61,15 @@ static void compute_q8gemm_xzp(
           group_index * n,
       c_stride,
       &context->requantization_params);
+  if (context->output_lut != nullptr) {
+    apply_output_lut(
+        context->output_lut,
+        mr_block_size,
+        nr_block_size,
+        c + (pixel_index + mr_block_start) * c_stride + nr_block_start +
+            group_index * n,
+        c_stride);
+  }
 }
 
 struct q8gemm_context {
@@ -74,6 +84,7 @@ struct q8gemm_context {
   size_t c_stride;
   union pytorch_qnnp_conv_quantization_params quantization_params;
   const pytorch_q8gemm_ukernel_function ukernel;
+  const uint8_t* output_lut;
 };
 static void compute_q8gemm(
     const struct q8gemm_context context[1],
@@ -108,6 +119,15 @@ static void compute_q8gemm(
       c_stride,
       output_channel_index,
       &context->quantization_params);
+  if (context->output_lut != nullptr) {
+    apply_output_lut(
+        context->output_lut,
+        mr_block_size,
+        nr_block_size,
+        c + (pixel_index + mr_block_start) * c_stride + nr_block_start +
+            group_index * n,
+        c_stride);
+  }
 }
 
 struct q8conv_context {
@@ -125,6 +145,7 @@ struct q8conv_context {
   size_t c_stride;
   union pytorch_qnnp_conv_quantization_params quantization_params;
   const pytorch_q8conv_ukernel_function ukernel;
+  const uint8_t* output_lut;
 };
 static void compute_q8conv(
     const struct q8conv_context context[1],
@@ -163,6 +184,15 @@ static void compute_q8conv(
       c_stride,
       output_channel_index,
       &context->quantization_params);
+  if (context->output_lut != nullptr) {
+    apply_output_lut(
+        context->output_lut,
+        mr_block_size,
+        nr_block_size,
+        c + (mr_block_start + image_index * m) * c_stride + group_index * n +
+            nr_block_start,
+        c_stride);
+  }
 }
 
 struct q8sum_rows_context {
@@ -218,7 +248,24 @@ struct q8dwconv_context {
   union pytorch_qnnp_conv_quantization_params quantization_params;
   const pytorch_q8dwconv_up_ukernel_function unipass_ukernel;
   const pytorch_q8dwconv_mp_ukernel_function multipass_ukernel;
+  const uint8_t* output_lut;
 };
+
+// Depthwise convolutions write a row of output_width pixels of groups
+// channels at a time.
+static void apply_dwconv_output_lut(
+    const struct q8dwconv_context context[1],
+    size_t image,
+    size_t output_y) {
+  apply_output_lut(
+      context->output_lut,
+      context->output_width,
+      context->groups,
+      context->output +
+          (image * context->output_height + output_y) *
+              context->output_row_stride,
+      context->groups + context->output_col_increment);
+}
 static void compute_dwconv_unipass(
     const struct q8dwconv_context context[1],
     size_t image,
@@ -237,6 +284,9 @@ static void compute_dwconv_unipass(
       context->indirection_buffer_col_stride,
       context->output_col_increment,
       &context->quantization_params);
+  if (context->output_lut != nullptr) {
+    apply_dwconv_output_lut(context, image, output_y);
+  }
 }
 static void compute_dwconv_multiipass(
     const struct q8dwconv_context context[1],
@@ -263,6 +313,9 @@ static void compute_dwconv_multiipass(
       context->indirection_buffer_col_stride,
       context->output_col_increment,
       &context->quantization_params);
+  if (context->output_lut != nullptr) {
+    apply_dwconv_output_lut(context, image, output_y);
+  }
 
 #ifdef _MSC_VER
   _freea(multipass_acc);
@@ -290,7 +343,8 @@ enum pytorch_qnnp_status qnnpackConv(
     const uint8_t output_min,
     const uint8_t output_max,
     uint8_t* output,
-    pthreadpool_t threadpool) {
+    pthreadpool_t threadpool,
+    const uint8_t* output_lut) {
   const size_t input_pixel_stride = conv_p.input_channels;
   const size_t output_pixel_stride = conv_p.output_channels;
   const size_t kernel_width = conv_p.kernel_dims[0];
@@ -393,6 +447,7 @@ enum pytorch_qnnp_status qnnpackConv(
                   conv_p.per_channel ?
                       pytorch_qnnp_params.q8dw25.mpdw_per_channel :
                       pytorch_qnnp_params.q8dw25.mpdw,
+              .output_lut = output_lut,
           };
           pthreadpool_compute_2d(
               threadpool,
@@ -429,6 +484,7 @@ enum pytorch_qnnp_status qnnpackConv(
                   conv_p.per_channel ?
                       pytorch_qnnp_params.q8dw25.mpdw_per_channel :
                       pytorch_qnnp_params.q8dw25.mpdw,
+              .output_lut = output_lut,
           };
           pthreadpool_compute_2d(
               threadpool,
@@ -505,6 +561,7 @@ enum pytorch_qnnp_status qnnpackConv(
           .a_sum_stride = input_size,
           .requantization_params = requantization_params,
           .ukernel = pytorch_qnnp_params.q8conv_xzp.gemm,
+          .output_lut = output_lut,
       };
       pthreadpool_compute_4d_tiled(
           threadpool,
@@ -541,6 +598,7 @@ enum pytorch_qnnp_status qnnpackConv(
           .c_stride = output_pixel_stride,
           .quantization_params = conv_quantization_params,
           .ukernel = pytorch_qnnp_params.q8conv.gemm,
+          .output_lut = output_lut,
       };
 
       pthreadpool_compute_4d_tiled(
@@ -582,6 +640,7 @@ enum pytorch_qnnp_status qnnpackConv(
           .c_stride = output_pixel_stride,
           .quantization_params = conv_quantization_params,
           .ukernel = pytorch_qnnp_params.q8conv.conv,
+          .output_lut = output_lut,
       };
 
       pthreadpool_compute_4d_tiled(
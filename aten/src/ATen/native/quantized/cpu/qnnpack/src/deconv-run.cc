@@ -25,6 +25,8 @@ struct q8conv_context {
   size_t c_stride;
   union pytorch_qnnp_conv_quantization_params quantization_params;
   const pytorch_q8conv_ukernel_function ukernel;
+  // Unused, keeps the layout of q8conv_context in conv-run.cc
+  const uint8_t* output_lut;
 };
 
 static void compute_q8conv(
@@ -168,6 +170,7 @@ enum pytorch_qnnp_status qnnpackDeConv(
       .c_stride = deconvolution->output_pixel_stride,
       .quantization_params = deconvolution->conv_quantization_params,
       .ukernel = pytorch_qnnp_params.q8conv.conv,
+      .output_lut = nullptr,
   };
 
   pthreadpool_compute_4d_tiled(
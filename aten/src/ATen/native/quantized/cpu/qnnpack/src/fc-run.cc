@@ -15,6 +15,7 @@ struct q8gemm_context {
   size_t c_stride;
   union pytorch_qnnp_conv_quantization_params quantization_params;
   const pytorch_q8gemm_ukernel_function ukernel;
+  const uint8_t* output_lut;
 };
 
 static void compute_q8gemm(
@@ -50,6 +51,14 @@ static void compute_q8gemm(
       c_stride,
       output_channel_index,
       &context->quantization_params);
+  if (context->output_lut != nullptr) {
+    apply_output_lut(
+        context->output_lut,
+        mr_block_size,
+        nr_block_size,
+        c + (pixel_index + mr_block_start) * c_stride + nr_block_start + group_index * n,
+        c_stride);
+  }
 }
 
 enum pytorch_qnnp_status qnnpackLinear(
@@ -67,7 +76,8 @@ enum pytorch_qnnp_status qnnpackLinear(
     void* packed_weights,
     uint8_t* output,
     const size_t output_stride,
-    pthreadpool_t threadpool)
+    pthreadpool_t threadpool,
+    const uint8_t* output_lut)
 {
   const size_t groups = 1;
   const size_t group_input_channels = input_channels;
@@ -96,6 +106,7 @@ enum pytorch_qnnp_status qnnpackLinear(
       .c_stride = output_stride,
       .quantization_params = conv_quantization_params,
       .ukernel = pytorch_qnnp_params.q8conv.gemm,
+      .output_lut = output_lut,
   };
 
   if (output_size == 0) {
@@ -16,6 +16,36 @@
 #include <qnnpack/log.h>
 #include <qnnpack/operator.h>
 
+void pytorch_qnnp_compute_hardswish_lut_q8(
+    uint8_t input_zero_point,
+    float input_scale,
+    uint8_t output_zero_point,
+    float output_scale,
+    uint8_t output_min,
+    uint8_t output_max,
+    uint8_t lookup_table[256]) {
+  const float scaled_min = (float)(int32_t)output_min;
+  const float scaled_max = (float)(int32_t)output_max;
+  const float inv_output_scale = 1.0f / output_scale;
+  for (int32_t i = 0; i < 256; i++) {
+    float x =
+        input_scale * (float)(i - (int32_t)(uint32_t)input_zero_point);
+    // hardswish, no min/max functions in C
+    float x2 = x + 3.0f;
+    x2 = x2 > 0.0f ? x2 : 0.0f;
+    x2 = x2 < 6.0f ? x2 : 6.0f;
+    x2 = x * x2 / 6.0f;
+    float scaled_hardswish_x = inv_output_scale * x2 + output_zero_point;
+    if (scaled_hardswish_x < scaled_min) {
+      scaled_hardswish_x = scaled_min;
+    }
+    if (scaled_hardswish_x > scaled_max) {
+      scaled_hardswish_x = scaled_max;
+    }
+    lookup_table[(uint32_t)i] = (uint8_t)lrintf(scaled_hardswish_x);
+  }
+}
+
 enum pytorch_qnnp_status pytorch_qnnp_create_hardswish_nc_q8(
     size_t channels,
     uint8_t input_zero_point,
@@ -84,27 +114,14 @@ enum pytorch_qnnp_status pytorch_qnnp_create_hardswish_nc_q8(
     goto error;
   }
 
-  uint8_t* lookup_table = hardswish_op->lookup_table;
-  const float scaled_min = (float)(int32_t)output_min;
-  const float scaled_max = (float)(int32_t)output_max;
-  const float inv_output_scale = 1.0f / output_scale;
-  for (int32_t i = 0; i < 256; i++) {
-    float x =
-        input_scale * (float)(i - (int32_t)(uint32_t)input_zero_point);
-    // hardswish, no min/max functions in C
-    float x2 = x + 3.0f;
-    x2 = x2 > 0.0f ? x2 : 0.0f;
-    x2 = x2 < 6.0f ? x2 : 6.0f;
-    x2 = x * x2 / 6.0f;
-    float scaled_hardswish_x = inv_output_scale * x2 + output_zero_point;
-    if (scaled_hardswish_x < scaled_min) {
-      scaled_hardswish_x = scaled_min;
-    }
-    if (scaled_hardswish_x > scaled_max) {
-      scaled_hardswish_x = scaled_max;
-    }
-    lookup_table[(uint32_t)i] = (uint8_t)lrintf(scaled_hardswish_x);
-  }
+  pytorch_qnnp_compute_hardswish_lut_q8(
+      input_zero_point,
+      input_scale,
+      output_zero_point,
+      output_scale,
+      output_min,
+      output_max,
+      hardswish_op->lookup_table);
 
   hardswish_op->channels = channels;
 
@@ -16,6 +16,29 @@
 #include <qnnpack/log.h>
 #include <qnnpack/operator.h>
 
+void pytorch_qnnp_compute_sigmoid_lut_q8(
+    uint8_t input_zero_point,
+    float input_scale,
+    uint8_t output_min,
+    uint8_t output_max,
+    uint8_t lookup_table[256]) {
+  const float scaled_min = (float)(int32_t)output_min;
+  const float scaled_max = (float)(int32_t)output_max;
+  for (int32_t i = 0; i < 256; i++) {
+    const float x =
+        input_scale * (float)(i - (int32_t)(uint32_t)input_zero_point);
+    /* Scale sigmoid(x) by 1 / output scale = 256.0 */
+    float scaled_sigmoid_x = 256.0f / (1.0f + expf(-x));
+    if (scaled_sigmoid_x < scaled_min) {
+      scaled_sigmoid_x = scaled_min;
+    }
+    if (scaled_sigmoid_x > scaled_max) {
+      scaled_sigmoid_x = scaled_max;
+    }
+    lookup_table[(uint32_t)i] = (uint8_t)lrintf(scaled_sigmoid_x);
+  }
+}
+
 enum pytorch_qnnp_status pytorch_qnnp_create_sigmoid_nc_q8(
     size_t channels,
     uint8_t input_zero_point,
@@ -101,22 +124,12 @@ enum pytorch_qnnp_status pytorch_qnnp_create_sigmoid_nc_q8(
     goto error;
   }
 
-  uint8_t* lookup_table = sigmoid_op->lookup_table;
-  const float scaled_min = (float)(int32_t)output_min;
-  const float scaled_max = (float)(int32_t)output_max;
-  for (int32_t i = 0; i < 256; i++) {
-    const float x =
-        input_scale * (float)(i - (int32_t)(uint32_t)input_zero_point);
-    /* Scale sigmoid(x) by 1 / output scale = 256.0 */
-    float scaled_sigmoid_x = 256.0f / (1.0f + expf(-x));
-    if (scaled_sigmoid_x < scaled_min) {
-      scaled_sigmoid_x = scaled_min;
-    }
-    if (scaled_sigmoid_x > scaled_max) {
-      scaled_sigmoid_x = scaled_max;
-    }
-    lookup_table[(uint32_t)i] = (uint8_t)lrintf(scaled_sigmoid_x);
-  }
+  pytorch_qnnp_compute_sigmoid_lut_q8(
+      input_zero_point,
+      input_scale,
+      output_min,
+      output_max,
+      sigmoid_op->lookup_table);
 
   sigmoid_op->channels = channels;
 
@@ -2,6 +2,7 @@
 
 #ifdef USE_PYTORCH_QNNPACK
 #include <ATen/ATen.h>
+#include <pack_block_sparse.h>
 #include <pytorch_qnnpack.h>
 #include <qnnpack_func.h>
 
@@ -9,6 +10,7 @@
 #include <ATen/native/quantized/cpu/packed_params.h>
 #include <ATen/native/utils/Factory.h>
 
+#include <array>
 #include <utility>
 
 struct QnnpackOperatorDeleter {
@@ -17,6 +19,16 @@ struct QnnpackOperatorDeleter {
   }
 };
 
+// An activation fused into the outputs of a QNNPACK linear or convolution:
+// the lookup table from their requantized outputs to the outputs of the
+// activation (see output_lut of qnnpack::qnnpackConv), whose quantization is
+// output_scale and output_zero_point.
+struct QnnpackOutputLut {
+  std::array<uint8_t, 256> table;
+  double output_scale;
+  int64_t output_zero_point;
+};
+
 // PackedWeight struct for QNNPACK stores the original Weight and Bias as
 // QNNPACK currently does not support an unpack function.
 // For PyTorch Mobile, once the model is scripted and serialized we don't need
@@ -60,6 +72,14 @@ struct PackedLinearWeightsQnnp : public LinearPackedParamsBase {
       double output_scale,
       int64_t output_zero_point) override;
 
+  // The linear requantized to output_scale and output_zero_point, mapped
+  // through output_lut in the same pass.
+  at::Tensor apply_with_lut(
+      at::Tensor input,
+      double output_scale,
+      int64_t output_zero_point,
+      const QnnpackOutputLut& output_lut);
+
   at::Tensor apply_dynamic(at::Tensor input, bool reduce_range=false) override;
   at::Tensor apply_dynamic_relu(at::Tensor input, bool reduce_range=false) override;
 
@@ -74,6 +94,84 @@ struct PackedLinearWeightsQnnp : public LinearPackedParamsBase {
       c10::optional<at::Tensor> bias);
 
  private:
+  template <bool ReluFused>
+  at::Tensor apply_impl(
+      at::Tensor input,
+      double output_scale,
+      int64_t output_zero_point,
+      const QnnpackOutputLut* output_lut = nullptr);
+
+  template <bool ReluFused>
+  at::Tensor apply_dynamic_impl(at::Tensor input);
+};
+
+// PackedWeight struct for the block sparse linear of QNNPACK. The weight is
+// stored in the block CSR format of qnnpack::generateBlockCSRMatrix, in
+// blocks of 1 x 4 elements of a row, the blocks whose elements all are the
+// zero point of their row being dropped. PackedLinearWeightsQnnp::prepack
+// returns one when at most kSparseBlockDensityThreshold of the blocks of the
+// weight are kept, quantized::linear_prepack_sparse always does. The sparse
+// kernels of QNNPACK dequantize their output, so the output of apply() is
+// quantized again to output_scale.
+struct PackedLinearWeightQnnpSparse : public LinearPackedParamsBase {
+  PackedLinearWeightQnnpSparse(
+      std::unique_ptr<qnnpack::BCSRMatrix> bcsr_matrix,
+      at::Tensor orig_weight,
+      at::Tensor bias,
+      at::Tensor w_scales,
+      std::vector<uint8_t>&& w_zps)
+      : bcsr_matrix(std::move(bcsr_matrix)),
+        orig_weight(std::move(orig_weight)),
+        in_features_(this->orig_weight.size(1)),
+        bias_(at::native::mobile::allocate_padded_contiguous_if_needed(
+            bias, bias.suggest_memory_format())),
+        w_scales(std::move(w_scales)),
+        w_zero_points(std::move(w_zps)) {}
+
+  // The 1 x kColBlockSize blocks of the sparse kernels.
+  static constexpr uint32_t kColBlockSize = 4;
+  static constexpr double kSparseBlockDensityThreshold = 0.3;
+
+  std::unique_ptr<qnnpack::BCSRMatrix> bcsr_matrix;
+  at::Tensor orig_weight;
+  // orig_weight may be released, see releaseWeightsWhenPrepacking().
+  int64_t in_features_;
+  at::Tensor bias_;
+  at::Tensor w_scales;
+  std::vector<uint8_t> w_zero_points;
+  std::vector<float> requantization_scales;
+
+  at::Tensor apply(
+      at::Tensor input,
+      double output_scale,
+      int64_t output_zero_point) override;
+  at::Tensor apply_relu(
+      at::Tensor input,
+      double output_scale,
+      int64_t output_zero_point) override;
+
+  at::Tensor apply_dynamic(at::Tensor input, bool reduce_range=false) override;
+  at::Tensor apply_dynamic_relu(at::Tensor input, bool reduce_range=false) override;
+
+  std::tuple<at::Tensor, c10::optional<at::Tensor>> unpack() override;
+
+  c10::optional<at::Tensor> bias() override {
+    return bias_;
+  }
+
+  // `weight' is a qint8 weight of out_features_block_size x
+  // in_features_block_size blocks, only 1 x 4 being supported.
+  static c10::intrusive_ptr<LinearPackedParamsBase> prepack(
+      at::Tensor weight,
+      c10::optional<at::Tensor> bias,
+      int64_t out_features_block_size = 1,
+      int64_t in_features_block_size = kColBlockSize);
+
+ private:
+  // Runs the sparse kernel on the quint8 input, whose dequantized product
+  // with the weight is returned.
+  at::Tensor apply_sparse_dq(const at::Tensor& q_input);
+
   template <bool ReluFused>
   at::Tensor apply_impl(
       at::Tensor input,
@@ -252,6 +350,13 @@ struct PackedConvWeightsQnnp : public ConvPackedParamsBase<kSpatialDim> {
       double output_scale,
       int64_t output_zero_point) override;
 
+  // See PackedLinearWeightsQnnp::apply_with_lut.
+  at::Tensor apply_with_lut(
+      const at::Tensor& input,
+      double output_scale,
+      int64_t output_zero_point,
+      const QnnpackOutputLut& output_lut);
+
   std::tuple<at::Tensor, c10::optional<at::Tensor>> unpack() override;
 
   static c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>> prepack(
@@ -293,7 +398,8 @@ struct PackedConvWeightsQnnp : public ConvPackedParamsBase<kSpatialDim> {
   at::Tensor apply_impl(
       const at::Tensor& input,
       double output_scale,
-      int64_t output_zero_point);
+      int64_t output_zero_point,
+      const QnnpackOutputLut* output_lut = nullptr);
 };
 
 enum class Activation : uint8_t { NONE = 0, RELU = 1 };
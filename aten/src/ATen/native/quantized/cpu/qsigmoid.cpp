@@ -4,6 +4,8 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 #include <ATen/quantized/Quantizer.h>
+#include <ATen/native/quantized/cpu/conv_packed_params.h>
+#include <ATen/native/quantized/cpu/packed_params.h>
 #include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <ATen/native/quantized/cpu/init_qnnpack.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
@@ -128,8 +130,102 @@ class QSigmoid final {
   }
 };
 
+#ifdef USE_PYTORCH_QNNPACK
+// QNNPACK computes sigmoid for the output quantization of
+// sigmoid_quantized_cpu only.
+bool is_qnnpack_sigmoid_output(double output_scale, int64_t output_zero_point) {
+  return static_cast<float>(output_scale) == 1.0f / 256.0f &&
+      output_zero_point == 0;
+}
+
+// The table of qnnpack_sigmoid, for inputs quantized with input_scale and
+// input_zero_point.
+QnnpackOutputLut qnnpack_sigmoid_lut(
+    double input_scale,
+    int64_t input_zero_point,
+    double output_scale,
+    int64_t output_zero_point) {
+  QnnpackOutputLut lut;
+  pytorch_qnnp_compute_sigmoid_lut_q8(
+      input_zero_point,
+      input_scale,
+      std::numeric_limits<uint8_t>::min(),
+      std::numeric_limits<uint8_t>::max(),
+      lut.table.data());
+  lut.output_scale = output_scale;
+  lut.output_zero_point = output_zero_point;
+  return lut;
+}
+#endif // USE_PYTORCH_QNNPACK
+
+// quantized::conv2d followed by quantized::sigmoid. For weights prepacked by
+// QNNPACK, the sigmoid is applied to the output tiles of the convolution as
+// they are written.
+class QConvSigmoidInt8 final {
+ public:
+  static Tensor run(
+      Tensor act,
+      const c10::intrusive_ptr<ConvPackedParamsBase<2>>& packed_weight,
+      double conv_scale,
+      int64_t conv_zero_point,
+      double output_scale,
+      int64_t output_zero_point) {
+#ifdef USE_PYTORCH_QNNPACK
+    auto qnnp_weight =
+        c10::dynamic_intrusive_pointer_cast<PackedConvWeightsQnnp<2>>(
+            packed_weight);
+    if (qnnp_weight && act.scalar_type() == kQUInt8 &&
+        is_qnnpack_sigmoid_output(output_scale, output_zero_point)) {
+      return qnnp_weight->apply_with_lut(
+          act,
+          conv_scale,
+          conv_zero_point,
+          qnnpack_sigmoid_lut(
+              conv_scale, conv_zero_point, output_scale, output_zero_point));
+    }
+#endif // USE_PYTORCH_QNNPACK
+    return QSigmoid::run(
+        packed_weight->apply(act, conv_scale, conv_zero_point),
+        output_scale,
+        output_zero_point);
+  }
+};
+
+// quantized::linear followed by quantized::sigmoid, see QConvSigmoidInt8.
+class QLinearSigmoidInt8 final {
+ public:
+  static Tensor run(
+      Tensor input,
+      const c10::intrusive_ptr<LinearPackedParamsBase>& packed_weight,
+      double linear_scale,
+      int64_t linear_zero_point,
+      double output_scale,
+      int64_t output_zero_point) {
+#ifdef USE_PYTORCH_QNNPACK
+    auto qnnp_weight =
+        c10::dynamic_intrusive_pointer_cast<PackedLinearWeightsQnnp>(
+            packed_weight);
+    if (qnnp_weight && input.scalar_type() == kQUInt8 &&
+        is_qnnpack_sigmoid_output(output_scale, output_zero_point)) {
+      return qnnp_weight->apply_with_lut(
+          std::move(input),
+          linear_scale,
+          linear_zero_point,
+          qnnpack_sigmoid_lut(
+              linear_scale, linear_zero_point, output_scale, output_zero_point));
+    }
+#endif // USE_PYTORCH_QNNPACK
+    return QSigmoid::run(
+        packed_weight->apply(std::move(input), linear_scale, linear_zero_point),
+        output_scale,
+        output_zero_point);
+  }
+};
+
 TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
   m.impl(TORCH_SELECTIVE_NAME("quantized::sigmoid"), TORCH_FN(QSigmoid::run));
+  m.impl(TORCH_SELECTIVE_NAME("quantized::conv2d_sigmoid"), TORCH_FN(QConvSigmoidInt8::run));
+  m.impl(TORCH_SELECTIVE_NAME("quantized::linear_sigmoid"), TORCH_FN(QLinearSigmoidInt8::run));
 }
 } // namespace
 
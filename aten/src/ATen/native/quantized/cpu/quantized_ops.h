@@ -156,6 +156,14 @@ using qnormalize_fn = void (*)(
     double /* eps */,
     Tensor* /* Y */);
 
+// See PackedLinearWeightInt4 for the representation of the weight.
+using qlinear_int4_fn = void (*)(
+    const Tensor& /* input, M x K float */,
+    const Tensor& /* packed weight, N x (K / group_size) x (group_size / 2 + 4) */,
+    const Tensor& /* bias, N float, undefined if there is none */,
+    bool /* relu_fused */,
+    Tensor& /* output, M x N float */);
+
 DECLARE_DISPATCH(qadaptive_avg_pool2d_fn, qadaptive_avg_pool2d_nhwc_stub);
 DECLARE_DISPATCH(qadaptive_avg_pool3d_fn, qadaptive_avg_pool3d_ndhwc_stub);
 DECLARE_DISPATCH(qadd_scalar_fn, qadd_scalar_relu_stub);
@@ -176,6 +184,7 @@ DECLARE_DISPATCH(qclamp_minmax_fn, qclamp_max_stub);
 DECLARE_DISPATCH(qelu_fn, qelu_stub);
 DECLARE_DISPATCH(qhardsigmoid_fn, qhardsigmoid_stub);
 DECLARE_DISPATCH(qhardswish_fn, qhardswish_stub);
+DECLARE_DISPATCH(qlinear_int4_fn, qlinear_int4_stub);
 DECLARE_DISPATCH(qmaxpool_2d_fn, qmaxpool_2d_nhwc_stub);
 DECLARE_DISPATCH(qnormalize_fn, quantized_normalize_stub);
 DECLARE_DISPATCH(qrelu_fn, qrelu6_stub);
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/core/List.h>
+#include <ATen/native/quantized/cpu/conv_packed_params.h>
+#include <ATen/native/quantized/cpu/packed_params.h>
+
+// Packed weights of the int8 quantized::linear and quantized::conv2d of the
+// QuantizedCUDA key.
+//
+// The GEMMs and convolutions of cuBLAS and cuDNN are for int8 operands with
+// no zero point. The weight has to be symmetrically quantized (qint8 with
+// zero points of 0, per tensor or per output channel). The quint8 input x is
+// shifted to int8 as x - 128, so that each output is
+//
+//   y = x_scale * w_scale * (acc + (128 - x_zero_point) * sum(w)) + bias
+//
+// where acc is the int8 product and sum(w) is the sum of the weights of the
+// output channel. Convolution padding is done explicitly with the value
+// x_zero_point - 128, which keeps the formula valid at the borders. The
+// requantization to output_scale and output_zero_point, the bias and a fused
+// ReLU are one kernel over acc, see requantize_cuda.
+//
+// cuBLAS and cuDNN need the reduction and output channels of int8 operands
+// to be multiples of 4, so the packed weight is padded with zeros.
+
+struct PackedLinearWeightCuda : public LinearPackedParamsBase {
+  PackedLinearWeightCuda(
+      at::Tensor orig_weight,
+      c10::optional<at::Tensor> bias,
+      at::Tensor packed_weight,
+      at::Tensor weight_scales,
+      at::Tensor weight_sums)
+      : orig_weight(std::move(orig_weight)),
+        bias_(std::move(bias)),
+        packed_weight(std::move(packed_weight)),
+        weight_scales(std::move(weight_scales)),
+        weight_sums(std::move(weight_sums)) {}
+
+  at::Tensor orig_weight;
+  c10::optional<at::Tensor> bias_;
+  // int8 [N_pad, K_pad]
+  at::Tensor packed_weight;
+  // float [N], on the device of the weight
+  at::Tensor weight_scales;
+  // float [N], on the device of the weight
+  at::Tensor weight_sums;
+
+  at::Tensor apply(
+      at::Tensor input,
+      double output_scale,
+      int64_t output_zero_point) override;
+  at::Tensor apply_relu(
+      at::Tensor input,
+      double output_scale,
+      int64_t output_zero_point) override;
+
+  at::Tensor apply_dynamic(at::Tensor input, bool reduce_range = false) override;
+  at::Tensor apply_dynamic_relu(at::Tensor input, bool reduce_range = false) override;
+
+  std::tuple<at::Tensor, c10::optional<at::Tensor>> unpack() override {
+    return std::make_tuple(orig_weight, bias_);
+  }
+
+  c10::optional<at::Tensor> bias() override {
+    return bias_;
+  }
+
+  static c10::intrusive_ptr<LinearPackedParamsBase> prepack(
+      at::Tensor weight,
+      c10::optional<at::Tensor> bias);
+
+ private:
+  template <bool ReluFused>
+  at::Tensor apply_impl(
+      const at::Tensor& input,
+      double output_scale,
+      int64_t output_zero_point);
+};
+
+template <int kSpatialDim = 2>
+struct PackedConvWeightCudnn : public ConvPackedParamsBase<kSpatialDim> {
+  PackedConvWeightCudnn(
+      at::Tensor orig_weight,
+      c10::optional<at::Tensor> bias,
+      at::Tensor packed_weight,
+      at::Tensor weight_scales,
+      at::Tensor weight_sums,
+      torch::List<int64_t> stride,
+      torch::List<int64_t> padding,
+      torch::List<int64_t> dilation,
+      int64_t groups)
+      : orig_weight(std::move(orig_weight)),
+        bias_(std::move(bias)),
+        packed_weight(std::move(packed_weight)),
+        weight_scales(std::move(weight_scales)),
+        weight_sums(std::move(weight_sums)),
+        stride_(std::move(stride)),
+        padding_(std::move(padding)),
+        dilation_(std::move(dilation)),
+        groups_(groups) {}
+
+  at::Tensor orig_weight;
+  c10::optional<at::Tensor> bias_;
+  // int8 [C_out_pad, C_in_pad / groups, kH, kW], channels last
+  at::Tensor packed_weight;
+  // float [C_out], on the device of the weight
+  at::Tensor weight_scales;
+  // float [C_out], on the device of the weight
+  at::Tensor weight_sums;
+  torch::List<int64_t> stride_;
+  torch::List<int64_t> padding_;
+  torch::List<int64_t> dilation_;
+  int64_t groups_;
+
+  at::Tensor apply(
+      const at::Tensor& input,
+      double output_scale,
+      int64_t output_zero_point) override;
+  at::Tensor apply_relu(
+      const at::Tensor& input,
+      double output_scale,
+      int64_t output_zero_point) override;
+
+  std::tuple<at::Tensor, c10::optional<at::Tensor>> unpack() override {
+    return std::make_tuple(orig_weight, bias_);
+  }
+
+  torch::List<int64_t> stride() const override {
+    return stride_;
+  }
+  torch::List<int64_t> padding() const override {
+    return padding_;
+  }
+  torch::List<int64_t> output_padding() const override {
+    return torch::List<int64_t>(std::vector<int64_t>(kSpatialDim, 0));
+  }
+  torch::List<int64_t> dilation() const override {
+    return dilation_;
+  }
+  int64_t groups() const override {
+    return groups_;
+  }
+  bool transpose() const override {
+    return false;
+  }
+
+  static c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>> prepack(
+      at::Tensor weight,
+      c10::optional<at::Tensor> bias,
+      torch::List<int64_t> stride,
+      torch::List<int64_t> padding,
+      torch::List<int64_t> dilation,
+      int64_t groups);
+
+ private:
+  template <bool ReluFused>
+  at::Tensor apply_impl(
+      const at::Tensor& input,
+      double output_scale,
+      int64_t output_zero_point);
+};
+
+namespace at {
+namespace native {
+
+// The int8 representation x - 128 of the quint8 tensor x, in the memory
+// format of x.
+Tensor quint8_to_int8_cuda(const Tensor& qx);
+
+// Writes quint8 values round(acc * multiplier + offset) + zero_point of the
+// int32 or float accumulators acc to output, clamped to [zero_point, 255] if
+// relu is set. multiplier and offset are float tensors broadcast to acc.
+void requantize_cuda(
+    const Tensor& acc,
+    const Tensor& multiplier,
+    const Tensor& offset,
+    Tensor& output,
+    bool relu);
+
+// The multiplier and offset of requantize_cuda for the weight scales and sums
+// of the output channels, see the formula above.
+std::tuple<Tensor, Tensor> requantize_params_cuda(
+    const Tensor& input,
+    const Tensor& weight_scales,
+    const Tensor& weight_sums,
+    const c10::optional<Tensor>& bias,
+    double output_scale);
+
+// The weight scales and the int8 representation of a symmetrically quantized
+// qint8 weight, whose output channels are along dim 0.
+std::tuple<Tensor, Tensor> int8_weight_and_scales_cuda(const Tensor& weight);
+
+} // namespace native
+} // namespace at
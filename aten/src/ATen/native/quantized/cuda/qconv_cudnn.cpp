@@ -0,0 +1,315 @@
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAConfig.h>
+#include <torch/library.h>
+
+#if AT_CUDNN_ENABLED()
+
+#include <ATen/cudnn/Descriptors.h>
+#include <ATen/cudnn/Handle.h>
+#include <ATen/native/quantized/cuda/cuda_packed_params.h>
+
+namespace {
+
+int64_t round_up_to_multiple_of_4(int64_t n) {
+  return (n + 3) / 4 * 4;
+}
+
+} // namespace
+
+template <int kSpatialDim>
+c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>> PackedConvWeightCudnn<
+    kSpatialDim>::
+    prepack(
+        at::Tensor weight,
+        c10::optional<at::Tensor> bias,
+        torch::List<int64_t> stride,
+        torch::List<int64_t> padding,
+        torch::List<int64_t> dilation,
+        int64_t groups) {
+  static_assert(kSpatialDim == 2, "cuDNN int8 convolution is 2-D only");
+  TORCH_CHECK(
+      weight.dim() == kSpatialDim + 2 && weight.is_cuda(),
+      "quantized::conv2d_prepack (cudnn): Expected a 4-D CUDA weight");
+  TORCH_CHECK(
+      stride.size() == kSpatialDim && padding.size() == kSpatialDim &&
+          dilation.size() == kSpatialDim,
+      "quantized::conv2d_prepack (cudnn): Expected 2 elements of stride, "
+      "padding and dilation");
+  const int64_t out_channels = weight.size(0);
+  const int64_t in_channels_per_group = weight.size(1);
+  TORCH_CHECK(
+      groups > 0 && out_channels % groups == 0,
+      "quantized::conv2d_prepack (cudnn): The number of output channels ",
+      out_channels,
+      " is not divisible by groups ",
+      groups);
+  // The channels of a group cannot be padded, see cuda_packed_params.h.
+  TORCH_CHECK(
+      groups == 1 ||
+          (in_channels_per_group % 4 == 0 && (out_channels / groups) % 4 == 0),
+      "quantized::conv2d_prepack (cudnn): grouped convolutions need "
+      "multiples of 4 channels per group");
+  if (bias.has_value()) {
+    TORCH_CHECK(
+        bias->dim() == 1 && bias->size(0) == out_channels &&
+            bias->scalar_type() == at::kFloat,
+        "quantized::conv2d_prepack (cudnn): Expected a float bias of ",
+        out_channels,
+        " elements");
+    bias = bias->to(weight.device());
+  }
+
+  at::Tensor weight_int8;
+  at::Tensor weight_scales;
+  std::tie(weight_int8, weight_scales) =
+      at::native::int8_weight_and_scales_cuda(weight);
+  at::Tensor weight_sums =
+      weight_int8.to(at::kInt).sum({1, 2, 3}).to(at::kFloat);
+  at::Tensor packed_weight = weight_int8;
+  if (groups == 1) {
+    // pad the channels with zeros, which do not change the products
+    packed_weight = at::constant_pad_nd(
+        weight_int8,
+        {0,
+         0,
+         0,
+         0,
+         0,
+         round_up_to_multiple_of_4(in_channels_per_group) -
+             in_channels_per_group,
+         0,
+         round_up_to_multiple_of_4(out_channels) - out_channels},
+        0);
+  }
+  packed_weight =
+      packed_weight.contiguous(c10::MemoryFormat::ChannelsLast);
+  return c10::make_intrusive<PackedConvWeightCudnn<kSpatialDim>>(
+      std::move(weight),
+      std::move(bias),
+      std::move(packed_weight),
+      std::move(weight_scales),
+      std::move(weight_sums),
+      std::move(stride),
+      std::move(padding),
+      std::move(dilation),
+      groups);
+}
+
+// cuDNN runs int8 convolutions on NHWC tensors with the
+// IMPLICIT_PRECOMP_GEMM algorithm only, here with int32 accumulation and a
+// float output (the INT8_EXT_CONFIG of cudnnConvolutionForward).
+template <int kSpatialDim>
+template <bool ReluFused>
+at::Tensor PackedConvWeightCudnn<kSpatialDim>::apply_impl(
+    const at::Tensor& input,
+    double output_scale,
+    int64_t output_zero_point) {
+  TORCH_CHECK(
+      input.dim() == kSpatialDim + 2,
+      "quantized::conv2d (cudnn): Expected a 4-D input");
+  TORCH_CHECK(
+      input.scalar_type() == c10::kQUInt8 &&
+          input.qscheme() == c10::kPerTensorAffine,
+      "quantized::conv2d (cudnn): Expected a per tensor quint8 input");
+  const int64_t batch_size = input.size(0);
+  const int64_t in_channels = input.size(1);
+  const int64_t out_channels = orig_weight.size(0);
+  const int64_t kernel_h = orig_weight.size(2);
+  const int64_t kernel_w = orig_weight.size(3);
+  TORCH_CHECK(
+      in_channels == orig_weight.size(1) * groups_,
+      "quantized::conv2d (cudnn): Expected ",
+      orig_weight.size(1) * groups_,
+      " input channels, got ",
+      in_channels);
+  const int64_t out_channels_pad = packed_weight.size(0);
+  const int64_t in_channels_pad = packed_weight.size(1) * groups_;
+
+  // Padding with the zero point of the input, see cuda_packed_params.h.
+  at::Tensor x = at::native::quint8_to_int8_cuda(input);
+  x = at::constant_pad_nd(
+          x,
+          {padding_[1],
+           padding_[1],
+           padding_[0],
+           padding_[0],
+           0,
+           in_channels_pad - in_channels},
+          input.q_zero_point() - 128)
+          .contiguous(c10::MemoryFormat::ChannelsLast);
+  const int64_t in_h = x.size(2);
+  const int64_t in_w = x.size(3);
+  const int64_t out_h =
+      (in_h - dilation_[0] * (kernel_h - 1) - 1) / stride_[0] + 1;
+  const int64_t out_w =
+      (in_w - dilation_[1] * (kernel_w - 1) - 1) / stride_[1] + 1;
+  TORCH_CHECK(
+      out_h > 0 && out_w > 0,
+      "quantized::conv2d (cudnn): The output size is too small");
+
+  at::Tensor acc = at::empty(
+      {batch_size, out_channels_pad, out_h, out_w},
+      input.options().dtype(at::kFloat),
+      c10::MemoryFormat::ChannelsLast);
+  if (batch_size > 0) {
+    at::native::TensorDescriptor x_desc;
+    AT_CUDNN_CHECK(cudnnSetTensor4dDescriptor(
+        x_desc.mut_desc(),
+        CUDNN_TENSOR_NHWC,
+        CUDNN_DATA_INT8,
+        batch_size,
+        in_channels_pad,
+        in_h,
+        in_w));
+    at::native::FilterDescriptor w_desc;
+    AT_CUDNN_CHECK(cudnnSetFilter4dDescriptor(
+        w_desc.mut_desc(),
+        CUDNN_DATA_INT8,
+        CUDNN_TENSOR_NHWC,
+        out_channels_pad,
+        packed_weight.size(1),
+        kernel_h,
+        kernel_w));
+    at::native::ConvolutionDescriptor conv_desc;
+    AT_CUDNN_CHECK(cudnnSetConvolution2dDescriptor(
+        conv_desc.mut_desc(),
+        0,
+        0,
+        stride_[0],
+        stride_[1],
+        dilation_[0],
+        dilation_[1],
+        CUDNN_CROSS_CORRELATION,
+        CUDNN_DATA_INT32));
+    AT_CUDNN_CHECK(cudnnSetConvolutionGroupCount(conv_desc.mut_desc(), groups_));
+    at::native::TensorDescriptor y_desc;
+    AT_CUDNN_CHECK(cudnnSetTensor4dDescriptor(
+        y_desc.mut_desc(),
+        CUDNN_TENSOR_NHWC,
+        CUDNN_DATA_FLOAT,
+        batch_size,
+        out_channels_pad,
+        out_h,
+        out_w));
+
+    cudnnHandle_t handle = at::native::getCudnnHandle();
+    const cudnnConvolutionFwdAlgo_t algo =
+        CUDNN_CONVOLUTION_FWD_ALGO_IMPLICIT_PRECOMP_GEMM;
+    size_t workspace_size = 0;
+    AT_CUDNN_CHECK(cudnnGetConvolutionForwardWorkspaceSize(
+        handle,
+        x_desc.desc(),
+        w_desc.desc(),
+        conv_desc.desc(),
+        y_desc.desc(),
+        algo,
+        &workspace_size));
+    at::Tensor workspace = at::empty(
+        {static_cast<int64_t>(workspace_size)},
+        input.options().dtype(at::kByte));
+    const float one = 1.f;
+    const float zero = 0.f;
+    AT_CUDNN_CHECK(cudnnConvolutionForward(
+        handle,
+        &one,
+        x_desc.desc(),
+        x.data_ptr(),
+        w_desc.desc(),
+        packed_weight.data_ptr(),
+        conv_desc.desc(),
+        algo,
+        workspace.data_ptr(),
+        workspace_size,
+        &zero,
+        y_desc.desc(),
+        acc.data_ptr()));
+  }
+
+  at::Tensor multiplier;
+  at::Tensor offset;
+  std::tie(multiplier, offset) = at::native::requantize_params_cuda(
+      input, weight_scales, weight_sums, bias_, output_scale);
+  at::Tensor output = at::_empty_affine_quantized(
+      {batch_size, out_channels, out_h, out_w},
+      input.options().dtype(c10::kQUInt8),
+      output_scale,
+      output_zero_point,
+      c10::MemoryFormat::ChannelsLast);
+  at::native::requantize_cuda(
+      acc.narrow(1, 0, out_channels),
+      multiplier.view({1, out_channels, 1, 1}),
+      offset.view({1, out_channels, 1, 1}),
+      output,
+      ReluFused);
+  return output;
+}
+
+template <int kSpatialDim>
+at::Tensor PackedConvWeightCudnn<kSpatialDim>::apply(
+    const at::Tensor& input,
+    double output_scale,
+    int64_t output_zero_point) {
+  return apply_impl<false>(input, output_scale, output_zero_point);
+}
+
+template <int kSpatialDim>
+at::Tensor PackedConvWeightCudnn<kSpatialDim>::apply_relu(
+    const at::Tensor& input,
+    double output_scale,
+    int64_t output_zero_point) {
+  return apply_impl<true>(input, output_scale, output_zero_point);
+}
+
+template struct PackedConvWeightCudnn<2>;
+
+namespace at {
+namespace native {
+namespace {
+
+class QConvPackWeightInt8Cudnn final {
+ public:
+  static c10::intrusive_ptr<ConvPackedParamsBase<2>> run_conv(
+      Tensor weight,
+      c10::optional<Tensor> bias,
+      torch::List<int64_t> stride,
+      torch::List<int64_t> padding,
+      torch::List<int64_t> dilation,
+      int64_t groups) {
+    return PackedConvWeightCudnn<2>::prepack(
+        std::move(weight),
+        std::move(bias),
+        std::move(stride),
+        std::move(padding),
+        std::move(dilation),
+        groups);
+  }
+};
+
+template <bool kReluFused>
+class QConvInt8Cudnn final {
+ public:
+  static Tensor run(
+      Tensor act,
+      const c10::intrusive_ptr<ConvPackedParamsBase<2>>& packed_weight,
+      double output_scale,
+      int64_t output_zero_point) {
+    if (kReluFused) {
+      return packed_weight->apply_relu(act, output_scale, output_zero_point);
+    } else {
+      return packed_weight->apply(act, output_scale, output_zero_point);
+    }
+  }
+};
+
+TORCH_LIBRARY_IMPL(quantized, QuantizedCUDA, m) {
+  m.impl(TORCH_SELECTIVE_NAME("quantized::conv_prepack"), TORCH_FN(QConvPackWeightInt8Cudnn::run_conv));
+  m.impl(TORCH_SELECTIVE_NAME("quantized::conv2d_prepack"), TORCH_FN(QConvPackWeightInt8Cudnn::run_conv));
+  m.impl(TORCH_SELECTIVE_NAME("quantized::conv2d.new"), QConvInt8Cudnn<false>::run);
+  m.impl(TORCH_SELECTIVE_NAME("quantized::conv2d_relu.new"), QConvInt8Cudnn<true>::run);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
+
+#endif // AT_CUDNN_ENABLED()
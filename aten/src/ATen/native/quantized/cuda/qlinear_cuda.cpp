@@ -0,0 +1,203 @@
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+#include <ATen/native/quantized/cuda/cuda_packed_params.h>
+#include <torch/library.h>
+
+// See Note [the int8 GEMM of cuBLAS] below.
+#ifndef __HIP_PLATFORM_HCC__
+
+namespace {
+
+int64_t round_up_to_multiple_of_4(int64_t n) {
+  return (n + 3) / 4 * 4;
+}
+
+} // namespace
+
+c10::intrusive_ptr<LinearPackedParamsBase> PackedLinearWeightCuda::prepack(
+    at::Tensor weight,
+    c10::optional<at::Tensor> bias) {
+  TORCH_CHECK(
+      weight.dim() == 2 && weight.is_cuda(),
+      "quantized::linear_prepack (cuda): Expected a 2-D CUDA weight");
+  const int64_t N = weight.size(0);
+  const int64_t K = weight.size(1);
+  if (bias.has_value()) {
+    TORCH_CHECK(
+        bias->dim() == 1 && bias->size(0) == N &&
+            bias->scalar_type() == at::kFloat,
+        "quantized::linear_prepack (cuda): Expected a float bias of ",
+        N,
+        " elements");
+    bias = bias->to(weight.device());
+  }
+
+  at::Tensor weight_int8;
+  at::Tensor weight_scales;
+  std::tie(weight_int8, weight_scales) =
+      at::native::int8_weight_and_scales_cuda(weight);
+  at::Tensor weight_sums = weight_int8.to(at::kInt).sum(1).to(at::kFloat);
+  // pad the rows and columns with zeros, which do not change the products
+  at::Tensor packed_weight = at::constant_pad_nd(
+      weight_int8,
+      {0, round_up_to_multiple_of_4(K) - K, 0, round_up_to_multiple_of_4(N) - N},
+      0).contiguous();
+  return c10::make_intrusive<PackedLinearWeightCuda>(
+      std::move(weight),
+      std::move(bias),
+      std::move(packed_weight),
+      std::move(weight_scales),
+      std::move(weight_sums));
+}
+
+// Note [the int8 GEMM of cuBLAS]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// cublasGemmEx multiplies int8 matrices into int32 ones with the TN layout
+// (op(A) = A^T), with leading dimensions that are multiples of 4, and uses
+// the IMMA tensor cores of Turing and later GPUs for it. In column major, the
+// row major output [M, N_pad] is W [K_pad, N_pad]^T x [K_pad, M].
+template <bool ReluFused>
+at::Tensor PackedLinearWeightCuda::apply_impl(
+    const at::Tensor& input,
+    double output_scale,
+    int64_t output_zero_point) {
+  TORCH_CHECK(
+      input.dim() >= 2,
+      "quantized::linear (cuda): Input tensor rank should be >= 2");
+  TORCH_CHECK(
+      input.scalar_type() == c10::kQUInt8 &&
+          input.qscheme() == c10::kPerTensorAffine,
+      "quantized::linear (cuda): Expected a per tensor quint8 input");
+  const int64_t N = orig_weight.size(0);
+  const int64_t K = input.size(input.dim() - 1);
+  TORCH_CHECK(
+      K == orig_weight.size(1),
+      "quantized::linear (cuda): input size does not match weight dimension 1 size: got ",
+      K,
+      " but expected ",
+      orig_weight.size(1));
+  const int64_t N_pad = packed_weight.size(0);
+  const int64_t K_pad = packed_weight.size(1);
+  const int64_t M = input.numel() / K;
+
+  at::Tensor x = at::native::quint8_to_int8_cuda(input.contiguous()).view({M, K});
+  if (K_pad != K) {
+    x = at::constant_pad_nd(x, {0, K_pad - K}, 0);
+  }
+  at::Tensor acc = at::empty({M, N_pad}, input.options().dtype(at::kInt));
+  if (M > 0) {
+    cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+    const int32_t alpha = 1;
+    const int32_t beta = 0;
+    TORCH_CUDABLAS_CHECK(cublasGemmEx(
+        handle,
+        CUBLAS_OP_T,
+        CUBLAS_OP_N,
+        N_pad,
+        M,
+        K_pad,
+        &alpha,
+        packed_weight.data_ptr<int8_t>(),
+        CUDA_R_8I,
+        K_pad,
+        x.data_ptr<int8_t>(),
+        CUDA_R_8I,
+        K_pad,
+        &beta,
+        acc.data_ptr<int32_t>(),
+        CUDA_R_32I,
+        N_pad,
+        CUDA_R_32I,
+        CUBLAS_GEMM_DEFAULT_TENSOR_OP));
+  }
+
+  at::Tensor multiplier;
+  at::Tensor offset;
+  std::tie(multiplier, offset) = at::native::requantize_params_cuda(
+      input, weight_scales, weight_sums, bias_, output_scale);
+  std::vector<int64_t> out_sizes = input.sizes().vec();
+  out_sizes.back() = N;
+  at::Tensor output = at::_empty_affine_quantized(
+      out_sizes,
+      input.options().dtype(c10::kQUInt8),
+      output_scale,
+      output_zero_point);
+  at::Tensor output_2d = output.view({M, N});
+  at::native::requantize_cuda(
+      acc.narrow(1, 0, N), multiplier, offset, output_2d, ReluFused);
+  return output;
+}
+
+at::Tensor PackedLinearWeightCuda::apply(
+    at::Tensor input,
+    double output_scale,
+    int64_t output_zero_point) {
+  return apply_impl<false>(input, output_scale, output_zero_point);
+}
+
+at::Tensor PackedLinearWeightCuda::apply_relu(
+    at::Tensor input,
+    double output_scale,
+    int64_t output_zero_point) {
+  return apply_impl<true>(input, output_scale, output_zero_point);
+}
+
+at::Tensor PackedLinearWeightCuda::apply_dynamic(
+    at::Tensor input,
+    bool reduce_range) {
+  TORCH_CHECK(
+      false,
+      "quantized::linear_dynamic is currently not supported on CUDA");
+}
+
+at::Tensor PackedLinearWeightCuda::apply_dynamic_relu(
+    at::Tensor input,
+    bool reduce_range) {
+  TORCH_CHECK(
+      false,
+      "quantized::linear_relu_dynamic is currently not supported on CUDA");
+}
+
+namespace at {
+namespace native {
+namespace {
+
+class QLinearPackWeightInt8Cuda final {
+ public:
+  static c10::intrusive_ptr<LinearPackedParamsBase> run(
+      at::Tensor weight,
+      c10::optional<Tensor> bias) {
+    return PackedLinearWeightCuda::prepack(std::move(weight), std::move(bias));
+  }
+};
+
+template <bool ReluFused>
+class QLinearInt8Cuda final {
+ public:
+  static at::Tensor run(
+      at::Tensor input,
+      const c10::intrusive_ptr<LinearPackedParamsBase>& packed_weight,
+      double output_scale,
+      int64_t output_zero_point) {
+    if (ReluFused) {
+      return packed_weight->apply_relu(
+          std::move(input), output_scale, output_zero_point);
+    } else {
+      return packed_weight->apply(
+          std::move(input), output_scale, output_zero_point);
+    }
+  }
+};
+
+TORCH_LIBRARY_IMPL(quantized, QuantizedCUDA, m) {
+  m.impl(TORCH_SELECTIVE_NAME("quantized::linear_prepack"), TORCH_FN(QLinearPackWeightInt8Cuda::run));
+  m.impl(TORCH_SELECTIVE_NAME("quantized::linear"), TORCH_FN(QLinearInt8Cuda<false>::run));
+  m.impl(TORCH_SELECTIVE_NAME("quantized::linear_relu"), TORCH_FN(QLinearInt8Cuda<true>::run));
+}
+
+} // namespace
+} // namespace native
+} // namespace at
+
+#endif // __HIP_PLATFORM_HCC__
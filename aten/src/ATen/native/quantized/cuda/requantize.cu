@@ -0,0 +1,121 @@
+#include <ATen/ATen.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cuda/Loops.cuh>
+#include <ATen/native/quantized/cuda/cuda_packed_params.h>
+
+#include <math.h>
+
+namespace at {
+namespace native {
+
+Tensor quint8_to_int8_cuda(const Tensor& qx) {
+  TORCH_CHECK(
+      qx.scalar_type() == kQUInt8,
+      "Expected a quint8 tensor, got ",
+      toString(qx.scalar_type()));
+  Tensor dst = at::empty(
+      qx.sizes(), qx.options().dtype(kChar), qx.suggest_memory_format());
+  auto iter = TensorIteratorConfig()
+    .check_all_same_dtype(false)
+    .add_output(dst)
+    .add_input(qx)
+    .build();
+  gpu_kernel(iter, [] GPU_LAMBDA(c10::quint8 value) -> int8_t {
+    return static_cast<int8_t>(static_cast<int>(value.val_) - 128);
+  });
+  return dst;
+}
+
+void requantize_cuda(
+    const Tensor& acc,
+    const Tensor& multiplier,
+    const Tensor& offset,
+    Tensor& output,
+    bool relu) {
+  TORCH_CHECK(output.scalar_type() == kQUInt8, "Expected a quint8 output");
+  const int64_t zero_point = output.q_zero_point();
+  const int64_t qmin = relu ? zero_point : 0;
+  const int64_t qmax = 255;
+  auto iter = TensorIteratorConfig()
+    .check_all_same_dtype(false)
+    .add_output(output)
+    .add_input(acc)
+    .add_input(multiplier)
+    .add_input(offset)
+    .build();
+  if (acc.scalar_type() == kInt) {
+    gpu_kernel(
+        iter,
+        [=] GPU_LAMBDA(int32_t value, float m, float o) -> c10::quint8 {
+          int64_t qvalue = static_cast<int64_t>(
+              nearbyintf(static_cast<float>(value) * m + o)) + zero_point;
+          qvalue = std::max<int64_t>(qvalue, qmin);
+          qvalue = std::min<int64_t>(qvalue, qmax);
+          return c10::quint8(static_cast<uint8_t>(qvalue));
+        });
+  } else {
+    TORCH_CHECK(
+        acc.scalar_type() == kFloat,
+        "Expected int32 or float accumulators, got ",
+        toString(acc.scalar_type()));
+    gpu_kernel(
+        iter,
+        [=] GPU_LAMBDA(float value, float m, float o) -> c10::quint8 {
+          int64_t qvalue =
+              static_cast<int64_t>(nearbyintf(value * m + o)) + zero_point;
+          qvalue = std::max<int64_t>(qvalue, qmin);
+          qvalue = std::min<int64_t>(qvalue, qmax);
+          return c10::quint8(static_cast<uint8_t>(qvalue));
+        });
+  }
+}
+
+std::tuple<Tensor, Tensor> requantize_params_cuda(
+    const Tensor& input,
+    const Tensor& weight_scales,
+    const Tensor& weight_sums,
+    const c10::optional<Tensor>& bias,
+    double output_scale) {
+  const double input_scale = input.q_scale();
+  const int64_t input_zero_point = input.q_zero_point();
+  Tensor acc_scales = weight_scales * input_scale;
+  Tensor offset =
+      acc_scales * weight_sums * static_cast<double>(128 - input_zero_point);
+  if (bias.has_value() && bias->defined()) {
+    offset.add_(*bias);
+  }
+  return std::make_tuple(
+      acc_scales.div_(output_scale), offset.div_(output_scale));
+}
+
+std::tuple<Tensor, Tensor> int8_weight_and_scales_cuda(const Tensor& weight) {
+  TORCH_CHECK(
+      weight.scalar_type() == kQInt8,
+      "Expected a qint8 weight, got ",
+      toString(weight.scalar_type()));
+  const int64_t out_channels = weight.size(0);
+  Tensor scales;
+  if (weight.qscheme() == kPerTensorAffine) {
+    TORCH_CHECK(
+        weight.q_zero_point() == 0,
+        "Expected a symmetrically quantized weight (zero point 0), got ",
+        weight.q_zero_point());
+    scales = at::full(
+        {out_channels},
+        weight.q_scale(),
+        weight.options().dtype(kFloat));
+  } else {
+    TORCH_CHECK(
+        weight.qscheme() == kPerChannelAffine &&
+            weight.q_per_channel_axis() == 0,
+        "Expected a weight quantized per tensor or per output channel");
+    TORCH_CHECK(
+        weight.q_per_channel_zero_points().eq(0).all().item<bool>(),
+        "Expected a symmetrically quantized weight (zero points 0)");
+    scales = weight.q_per_channel_scales().to(weight.device(), kFloat);
+  }
+  return std::make_tuple(weight.int_repr(), scales);
+}
+
+} // namespace native
+} // namespace at
@@ -88,8 +88,8 @@ std::tuple<Tensor, Tensor> fake_quantize_per_channel_affine_cachemask(
     .add_input(native::_unsafe_view(zero_point, expected_shape))
     .build();
 
-  // TODO(future, optional): read once, write twice.  Not done at the moment
-  //   for simplicity, as we do not expect this to be a bottleneck.
+  // The CPU kernel writes the output and the mask in one pass over self,
+  // the CUDA kernel runs iter and iter_mask one after the other.
   TensorIterator iter_mask = TensorIteratorConfig()
     .check_all_same_dtype(false)
     .add_output(mask)
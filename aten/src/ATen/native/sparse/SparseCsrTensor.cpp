@@ -0,0 +1,194 @@
+// Basic functions on sparse CSR tensors
+
+#include <ATen/ATen.h>
+#include <ATen/DeviceGuard.h>
+#include <ATen/InitialTensorOptions.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseCsrTensorUtils.h>
+#include <ATen/SparseTensorUtils.h>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+
+/******************************************************************************
+ * access methods
+ ******************************************************************************/
+
+Tensor crow_indices_sparse_csr(const Tensor& self) {
+  return get_sparse_csr_impl(self)->crow_indices().alias();
+}
+
+Tensor col_indices_sparse_csr(const Tensor& self) {
+  return get_sparse_csr_impl(self)->col_indices().alias();
+}
+
+Tensor values_sparse_csr(const Tensor& self) {
+  return get_sparse_csr_impl(self)->values().alias();
+}
+
+int64_t _nnz_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->nnz();
+}
+
+/******************************************************************************
+ * creation methods
+ ******************************************************************************/
+
+namespace {
+
+SparseCsrTensor new_csr_tensor(const TensorOptions& options) {
+  TORCH_INTERNAL_ASSERT(options.layout() == kSparseCsr);
+  DispatchKey dispatch_key;
+  if (options.device().is_cuda()) {
+    dispatch_key = DispatchKey::SparseCsrCUDA;
+  } else {
+    TORCH_CHECK(options.device().is_cpu(), "sparse CSR tensors are only supported on CPU and CUDA, but got device ", options.device());
+    dispatch_key = DispatchKey::SparseCsrCPU;
+  }
+  return detail::make_tensor<SparseCsrTensorImpl>(
+      DispatchKeySet(dispatch_key), options.dtype());
+}
+
+// The options of the values of a sparse CSR tensor created with options
+TensorOptions values_options(const Tensor& values, const TensorOptions& options) {
+  TORCH_CHECK(!options.has_layout() || options.layout() == kSparseCsr, "expected sparse CSR layout, but got layout ", options.layout());
+  TORCH_CHECK(!options.pinned_memory(), "Only dense CPU tensors can be pinned");
+  auto result = values.options();
+  if (options.has_dtype()) {
+    result = result.dtype(options.dtype());
+  }
+  if (options.has_device()) {
+    result = result.device(options.device());
+  }
+  return result;
+}
+
+} // namespace
+
+void _validate_sparse_csr_tensor_args(const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, IntArrayRef size) {
+  // the following checks are redundant because they are also checked in
+  // SparseCsrTensorImpl::set_member_tensors_unsafe, but we need to ensure them
+  // before reading the indices.
+  TORCH_CHECK(size.size() == 2, "sparse CSR tensors must be 2-D, but got size ", size);
+  TORCH_CHECK(crow_indices.layout() == kStrided && col_indices.layout() == kStrided && values.layout() == kStrided,
+      "expected crow_indices, col_indices and values to be strided tensors");
+  TORCH_CHECK(crow_indices.dim() == 1 && col_indices.dim() == 1 && values.dim() == 1,
+      "crow_indices, col_indices and values must be 1-D, but got ", crow_indices.dim(), "-D, ",
+      col_indices.dim(), "-D and ", values.dim(), "-D tensors");
+  TORCH_CHECK(crow_indices.scalar_type() == kInt || crow_indices.scalar_type() == kLong,
+      "crow_indices must be an int32 or int64 tensor, but got ", crow_indices.scalar_type());
+  TORCH_CHECK(col_indices.scalar_type() == crow_indices.scalar_type(),
+      "col_indices and crow_indices must have the same dtype, but got ", col_indices.scalar_type(), " and ", crow_indices.scalar_type());
+  TORCH_CHECK(crow_indices.numel() == size[0] + 1,
+      "crow_indices must have rows + 1 (", size[0] + 1, ") elements, but got ", crow_indices.numel());
+  const int64_t nnz = values.numel();
+  TORCH_CHECK(col_indices.numel() == nnz, "col_indices and values must have the same nnz, but got nnz from col_indices: ",
+      col_indices.numel(), ", nnz from values: ", nnz);
+
+  // Check the compression and the bounds of the indices on the CPU, with a
+  // single copy from the device
+  const auto crow_cpu = crow_indices.to(kCPU, kLong);
+  const auto crow_accessor = crow_cpu.accessor<int64_t, 1>();
+  TORCH_CHECK(crow_accessor[0] == 0, "crow_indices[0] must be 0, but got ", crow_accessor[0]);
+  TORCH_CHECK(crow_accessor[size[0]] == nnz,
+      "crow_indices[-1] must be nnz (", nnz, "), but got ", crow_accessor[size[0]]);
+  for (int64_t i = 0; i < size[0]; i++) {
+    TORCH_CHECK(crow_accessor[i] <= crow_accessor[i + 1],
+        "crow_indices must be non-decreasing, but crow_indices[", i, "] = ", crow_accessor[i],
+        " > crow_indices[", i + 1, "] = ", crow_accessor[i + 1]);
+  }
+  if (nnz > 0) {
+    const int64_t min_col = col_indices.min().item<int64_t>();
+    const int64_t max_col = col_indices.max().item<int64_t>();
+    TORCH_CHECK(min_col >= 0, "found negative column index ", min_col);
+    TORCH_CHECK(max_col < size[1],
+        "size is inconsistent with col_indices: size[1] is ", size[1], " but found column index ", max_col);
+  }
+}
+
+// NOTE: _sparse_csr_tensor_unsafe() differs from sparse_csr_tensor() in that
+// we don't check whether the indices form a valid CSR matrix of `size`, thus
+// avoiding a copy from CUDA to CPU.  It should ONLY be used where we know
+// that they do, or if the caller is going to call
+// _validate_sparse_csr_tensor_args before using the tensor.
+Tensor _sparse_csr_tensor_unsafe(const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values_, IntArrayRef size, const TensorOptions& options) {
+  const auto options_ = values_options(values_, options);
+  const auto values = values_.to(options_);
+  // The default member tensors of the impl are allocated on the current device
+  const OptionalDeviceGuard device_guard(device_of(values));
+  SparseCsrTensor self = new_csr_tensor(options_.layout(kSparseCsr));
+  get_sparse_csr_impl(self)->raw_resize_(size);
+  get_sparse_csr_impl(self)->set_member_tensors_unsafe(
+      crow_indices.to(values.device()), col_indices.to(values.device()), values);
+  return self;
+}
+
+Tensor sparse_csr_tensor(const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, IntArrayRef size, const TensorOptions& options) {
+  at::native::_validate_sparse_csr_tensor_args(crow_indices, col_indices, values, size);
+  return at::native::_sparse_csr_tensor_unsafe(crow_indices, col_indices, values, size, options);
+}
+
+// If the size is not given, the number of columns is inferred as the max
+// column index + 1
+Tensor sparse_csr_tensor(const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, const TensorOptions& options) {
+  TORCH_CHECK(crow_indices.dim() == 1 && crow_indices.numel() > 0,
+      "crow_indices must be a non-empty 1-D tensor, but got size ", crow_indices.sizes());
+  const int64_t cols = col_indices.numel() > 0 ? col_indices.max().item<int64_t>() + 1 : 0;
+  return at::native::sparse_csr_tensor(crow_indices, col_indices, values, {crow_indices.numel() - 1, cols}, options);
+}
+
+/******************************************************************************
+ * conversions
+ ******************************************************************************/
+
+SparseCsrTensor coo_to_sparse_csr(const Tensor& self) {
+  TORCH_CHECK(self.sparse_dim() == 2 && self.dense_dim() == 0,
+      "to_sparse_csr: only 2-D sparse COO tensors with scalar values can be converted, but got sparse_dim ",
+      self.sparse_dim(), " and dense_dim ", self.dense_dim());
+  const auto coalesced = self.coalesce();
+  const auto indices = coalesced._indices();
+  const auto row_indices = indices.select(0, 0).contiguous();
+  // crow_indices[i] is the number of elements in the rows before row i
+  const auto crow_indices = at::searchsorted(
+      row_indices, at::arange(self.size(0) + 1, row_indices.options()));
+  return at::native::_sparse_csr_tensor_unsafe(
+      crow_indices,
+      indices.select(0, 1).contiguous(),
+      coalesced._values(),
+      self.sizes(),
+      coalesced._values().options().layout(kSparseCsr));
+}
+
+SparseCsrTensor dense_to_sparse_csr(const Tensor& self) {
+  TORCH_CHECK(self.dim() == 2, "to_sparse_csr: only 2-D tensors can be converted, but got a ", self.dim(), "-D tensor");
+  return coo_to_sparse_csr(self.to_sparse());
+}
+
+Tensor sparse_csr_to_sparse(const SparseCsrTensor& self) {
+  const auto impl = get_sparse_csr_impl(self);
+  const auto indices = at::stack(
+      {crow_to_row_indices(impl->crow_indices()), impl->col_indices().to(kLong)});
+  // The elements are sorted by row and then by column, so they are coalesced
+  return at::_sparse_coo_tensor_unsafe(indices, impl->values(), self.sizes())._coalesced_(true);
+}
+
+Tensor sparse_csr_to_sparse(const SparseCsrTensor& self, int64_t sparse_dim) {
+  TORCH_CHECK(sparse_dim == 2, "to_sparse: a sparse CSR tensor can only be converted with sparse_dim 2, but got ", sparse_dim);
+  return sparse_csr_to_sparse(self);
+}
+
+Tensor sparse_csr_to_dense(const SparseCsrTensor& self, c10::optional<ScalarType> dtype) {
+  TORCH_CHECK(!dtype.has_value(), "dtype argument is not supported by sparse_csr_to_dense");
+  const auto impl = get_sparse_csr_impl(self);
+  Tensor dst = at::zeros(self.sizes(), impl->values().options());
+  if (impl->nnz() > 0) {
+    dst.index_put_(
+        {crow_to_row_indices(impl->crow_indices()), impl->col_indices().to(kLong)},
+        impl->values());
+  }
+  return dst;
+}
+
+}} // namespace at::native
@@ -0,0 +1,269 @@
+#include <ATen/ATen.h>
+#include <ATen/Config.h>
+#include <ATen/Dispatch.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/ScalarOps.h>
+#include <ATen/SparseCsrTensorUtils.h>
+#include <ATen/SparseTensorUtils.h>
+
+#if AT_MKL_ENABLED()
+#include <mkl.h>
+#include <ATen/mkl/Exceptions.h>
+#endif
+
+#include <algorithm>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+using at::sparse::is_same_tensor;
+
+// --------------------------------------------------------------------
+// addmm(D1, S, D2, beta, alpha) -> D  [broadcasts]
+//
+// D = beta * D1 + alpha * mm(S, D2), S in the sparse CSR layout
+// --------------------------------------------------------------------
+
+namespace {
+
+// r += alpha * op(S) * dense, where op(S) is S or its transpose, and r and
+// dense are row-major
+template <typename scalar_t, typename index_t>
+void spmm_csr_dense_worker(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense,
+    scalar_t alpha,
+    Tensor& r,
+    bool transpose) {
+  const index_t* crow_ptr = crow_indices.data_ptr<index_t>();
+  const index_t* col_ptr = col_indices.data_ptr<index_t>();
+  const scalar_t* values_ptr = values.data_ptr<scalar_t>();
+  const scalar_t* dense_ptr = dense.data_ptr<scalar_t>();
+  scalar_t* r_ptr = r.data_ptr<scalar_t>();
+  const int64_t rows = crow_indices.numel() - 1;
+  const int64_t nnz = values.numel();
+  const int64_t dim_k = r.size(1);
+
+  if (!transpose) {
+    // Each row of r only depends on the same row of S
+    const int64_t row_cost = std::max<int64_t>(1, nnz / std::max<int64_t>(rows, 1) * dim_k);
+    at::parallel_for(0, rows, std::max<int64_t>(1, internal::GRAIN_SIZE / row_cost), [&](int64_t start, int64_t end) {
+      for (int64_t i = start; i < end; i++) {
+        scalar_t* r_row = r_ptr + i * dim_k;
+        for (index_t e = crow_ptr[i]; e < crow_ptr[i + 1]; e++) {
+          const scalar_t val = alpha * values_ptr[e];
+          const scalar_t* dense_row = dense_ptr + static_cast<int64_t>(col_ptr[e]) * dim_k;
+          for (int64_t k = 0; k < dim_k; k++) {
+            r_row[k] += val * dense_row[k];
+          }
+        }
+      }
+    });
+  } else {
+    // The elements of a row of S scatter to different rows of r, so the
+    // threads split the columns of r instead
+    at::parallel_for(0, dim_k, std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(nnz, 1)), [&](int64_t start, int64_t end) {
+      for (int64_t i = 0; i < rows; i++) {
+        const scalar_t* dense_row = dense_ptr + i * dim_k;
+        for (index_t e = crow_ptr[i]; e < crow_ptr[i + 1]; e++) {
+          const scalar_t val = alpha * values_ptr[e];
+          scalar_t* r_row = r_ptr + static_cast<int64_t>(col_ptr[e]) * dim_k;
+          for (int64_t k = start; k < end; k++) {
+            r_row[k] += val * dense_row[k];
+          }
+        }
+      }
+    });
+  }
+}
+
+#if AT_MKL_ENABLED()
+
+inline sparse_status_t mkl_sparse_create_csr(
+    sparse_matrix_t* A, MKL_INT rows, MKL_INT cols, MKL_INT* crow, MKL_INT* col, float* values) {
+  return mkl_sparse_s_create_csr(A, SPARSE_INDEX_BASE_ZERO, rows, cols, crow, crow + 1, col, values);
+}
+
+inline sparse_status_t mkl_sparse_create_csr(
+    sparse_matrix_t* A, MKL_INT rows, MKL_INT cols, MKL_INT* crow, MKL_INT* col, double* values) {
+  return mkl_sparse_d_create_csr(A, SPARSE_INDEX_BASE_ZERO, rows, cols, crow, crow + 1, col, values);
+}
+
+inline sparse_status_t mkl_sparse_mm(
+    sparse_operation_t op, float alpha, const sparse_matrix_t A, const float* B,
+    MKL_INT columns, MKL_INT ldb, float beta, float* C, MKL_INT ldc) {
+  matrix_descr descr;
+  descr.type = SPARSE_MATRIX_TYPE_GENERAL;
+  return mkl_sparse_s_mm(op, alpha, A, descr, SPARSE_LAYOUT_ROW_MAJOR, B, columns, ldb, beta, C, ldc);
+}
+
+inline sparse_status_t mkl_sparse_mm(
+    sparse_operation_t op, double alpha, const sparse_matrix_t A, const double* B,
+    MKL_INT columns, MKL_INT ldb, double beta, double* C, MKL_INT ldc) {
+  matrix_descr descr;
+  descr.type = SPARSE_MATRIX_TYPE_GENERAL;
+  return mkl_sparse_d_mm(op, alpha, A, descr, SPARSE_LAYOUT_ROW_MAJOR, B, columns, ldb, beta, C, ldc);
+}
+
+// r += alpha * op(S) * dense with the MKL sparse BLAS. The MKL handle only
+// refers to the indices and values, so there is no copy unless the indices
+// are not of the MKL_INT type.
+template <typename scalar_t>
+void spmm_csr_dense_mkl(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense,
+    scalar_t alpha,
+    Tensor& r,
+    int64_t cols,
+    bool transpose) {
+  const auto mkl_int_type = sizeof(MKL_INT) == sizeof(int64_t) ? kLong : kInt;
+  auto crow = crow_indices.to(mkl_int_type).contiguous();
+  auto col = col_indices.to(mkl_int_type).contiguous();
+  auto vals = values.contiguous();
+
+  sparse_matrix_t A = nullptr;
+  MKL_SPARSE_CHECK(mkl_sparse_create_csr(
+      &A, crow.numel() - 1, cols, crow.data_ptr<MKL_INT>(), col.data_ptr<MKL_INT>(), vals.data_ptr<scalar_t>()));
+  const auto status = mkl_sparse_mm(
+      transpose ? SPARSE_OPERATION_TRANSPOSE : SPARSE_OPERATION_NON_TRANSPOSE,
+      alpha, A, dense.data_ptr<scalar_t>(), r.size(1), dense.size(1),
+      scalar_t(1), r.data_ptr<scalar_t>(), r.size(1));
+  mkl_sparse_destroy(A);
+  MKL_SPARSE_CHECK(status);
+}
+
+#endif
+
+// r = beta * t + alpha * op(S) * dense, the shapes are already checked
+void addmm_out_sparse_csr_dense_worker(
+    Tensor& r,
+    Scalar beta,
+    const Tensor& t,
+    Scalar alpha,
+    const SparseCsrTensor& sparse,
+    const Tensor& dense_,
+    bool transpose) {
+  if (beta.toComplexDouble() == 0.) {
+    r.zero_();
+  } else if (beta.toComplexDouble() == 1.) {
+    if (!is_same_tensor(r, t)) {
+      r.copy_(t);
+    }
+  } else {
+    at::mul_out(r, t, scalar_to_tensor(beta));
+  }
+
+  const auto impl = get_sparse_csr_impl(sparse);
+  if (impl->nnz() == 0 || alpha.toComplexDouble() == 0. || r.numel() == 0) {
+    return;
+  }
+
+  // Both kernels work on row-major matrices
+  const auto dense = dense_.contiguous();
+  Tensor r_ = r.is_contiguous() ? r : r.contiguous();
+
+  AT_DISPATCH_FLOATING_TYPES(impl->values().scalar_type(), "addmm_sparse_csr_dense", [&] {
+#if AT_MKL_ENABLED()
+    spmm_csr_dense_mkl<scalar_t>(
+        impl->crow_indices(), impl->col_indices(), impl->values(), dense,
+        alpha.to<scalar_t>(), r_, sparse.size(1), transpose);
+#else
+    const auto crow_indices = impl->crow_indices().contiguous();
+    const auto col_indices = impl->col_indices().contiguous();
+    const auto values = impl->values().contiguous();
+    AT_DISPATCH_INDEX_TYPES(crow_indices.scalar_type(), "addmm_sparse_csr_dense_indices", [&] {
+      spmm_csr_dense_worker<scalar_t, index_t>(
+          crow_indices, col_indices, values, dense, alpha.to<scalar_t>(), r_, transpose);
+    });
+#endif
+  });
+
+  if (!is_same_tensor(r, r_)) {
+    r.copy_(r_);
+  }
+}
+
+} // namespace
+
+Tensor& addmm_out_sparse_csr_dense_cpu(
+    Tensor& result,
+    const Tensor& self,
+    const SparseCsrTensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha) {
+  TORCH_CHECK(!result.is_cuda(), "addmm: expected 'out' to be CPU tensor, but got CUDA tensor");
+  TORCH_CHECK(!self.is_cuda(), "addmm: expected 'self' to be a CPU tensor, but got a CUDA tensor");
+  TORCH_CHECK(!mat2.is_cuda(), "addmm: expected 'mat2' to be a CPU tensor, but got a CUDA tensor");
+  TORCH_CHECK(mat2.dim() == 2, "addmm: matrices expected, got ", mat2.dim(), "D tensor");
+  TORCH_CHECK(mat2.size(0) == mat1.size(1),
+      "addmm: Argument #3 (dense): Expected dim 0 size ", mat1.size(1), ", got ", mat2.size(0));
+  TORCH_CHECK(mat1.scalar_type() == mat2.scalar_type() && result.scalar_type() == mat2.scalar_type(),
+      "addmm: expected 'mat1', 'mat2' and 'out' to have the same dtype, but got ",
+      mat1.scalar_type(), ", ", mat2.scalar_type(), " and ", result.scalar_type());
+
+  Tensor b_self;
+  std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm_out");
+  result.resize_({mat1.size(0), mat2.size(1)});
+  addmm_out_sparse_csr_dense_worker(result, beta, b_self, alpha, mat1, mat2, /*transpose=*/false);
+  return result;
+}
+
+Tensor _sparse_csr_transposed_mm_cpu(const SparseCsrTensor& sparse, const Tensor& dense) {
+  TORCH_CHECK(dense.dim() == 2, "_sparse_csr_transposed_mm: matrices expected, got ", dense.dim(), "D tensor");
+  TORCH_CHECK(dense.size(0) == sparse.size(0),
+      "_sparse_csr_transposed_mm: Expected dim 0 size ", sparse.size(0), ", got ", dense.size(0));
+  TORCH_CHECK(sparse.scalar_type() == dense.scalar_type(),
+      "_sparse_csr_transposed_mm: expected 'sparse' and 'dense' to have the same dtype, but got ",
+      sparse.scalar_type(), " and ", dense.scalar_type());
+  Tensor result = at::empty({sparse.size(1), dense.size(1)}, dense.options());
+  addmm_out_sparse_csr_dense_worker(result, 0, result, 1, sparse, dense, /*transpose=*/true);
+  return result;
+}
+
+// The backends share the functions that redispatch to addmm
+
+Tensor addmm_sparse_csr_dense(
+    const Tensor& self,
+    const SparseCsrTensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha) {
+  Tensor r = at::empty({0}, mat2.options());
+  at::addmm_out(r, self, mat1, mat2, beta, alpha);
+  return r;
+}
+
+Tensor& mm_out_sparse_csr(Tensor& result, const SparseCsrTensor& self, const Tensor& mat2) {
+  TORCH_CHECK(mat2.dim() == 2, "mm: matrices expected, got ", mat2.dim(), "D tensor");
+  Tensor t = at::zeros({}, mat2.options());
+  return at::addmm_out(result, t, self, mat2, 0, 1);
+}
+
+Tensor mm_sparse_csr(const SparseCsrTensor& self, const Tensor& mat2) {
+  Tensor result = at::empty({0}, mat2.options());
+  return at::native::mm_out_sparse_csr(result, self, mat2);
+}
+
+Tensor& mv_out_sparse_csr(Tensor& result, const SparseCsrTensor& self, const Tensor& vec) {
+  TORCH_CHECK(vec.dim() == 1, "mv: vector expected, got ", vec.dim(), "D tensor");
+  TORCH_CHECK(vec.size(0) == self.size(1), "mv: expected self.size(-1) == vec.size(-1)");
+  result.resize_({self.size(0)});
+  // A view of result as a column, so that addmm writes into it
+  auto result_column = result.unsqueeze(1);
+  at::native::mm_out_sparse_csr(result_column, self, vec.unsqueeze(1));
+  return result;
+}
+
+Tensor mv_sparse_csr(const SparseCsrTensor& self, const Tensor& vec) {
+  Tensor result = at::empty({0}, vec.options());
+  return at::native::mv_out_sparse_csr(result, self, vec);
+}
+
+}} // namespace at::native
@@ -12,6 +12,7 @@
 #include <TH/THBlasUtils.h>
 
 #include <algorithm>
+#include <unordered_map>
 
 namespace at { namespace native {
 
@@ -606,6 +607,116 @@ SparseTensor& add_out_sparse_cpu(const SparseTensor& t, const SparseTensor& src,
   }
 }
 
+// --------------------------------------------------------------------
+// _sparse_accumulate_rows_(SparseTensor, SparseTensor)
+// --------------------------------------------------------------------
+
+// Accumulates 'other' into 'self' keeping 'self' coalesced, so that summing
+// many uncoalesced gradients (e.g. of embedding(sparse=True)) doesn't pile up
+// duplicate indices: the rows of 'other' are deduplicated by hashing, those
+// already in 'self' are added in place and only the new ones are merged in.
+SparseTensor& sparse_accumulate_rows_cpu_(SparseTensor& self, const SparseTensor& other) {
+  TORCH_CHECK(other.is_sparse(), "_sparse_accumulate_rows_: expected 'other' to be a sparse tensor");
+  if (self._nnz() == 0 && self.sizes().equals(other.sizes())) {
+    // e.g. a zeroed gradient, whose dimensions are all sparse
+    self.sparse_resize_and_clear_(other.sizes(), other.sparse_dim(), other.dense_dim());
+  }
+  TORCH_CHECK(
+      self.sparse_dim() == 1 && other.sparse_dim() == 1,
+      "_sparse_accumulate_rows_: expected tensors with a single sparse dimension, but got ",
+      self.sparse_dim(), " and ", other.sparse_dim());
+  TORCH_CHECK(
+      self.sizes().equals(other.sizes()),
+      "_sparse_accumulate_rows_: expected sizes of 'self' and 'other' to match, but ",
+      self.sizes(), " != ", other.sizes());
+  TORCH_CHECK(
+      self.scalar_type() == other.scalar_type(),
+      "_sparse_accumulate_rows_: expected 'self' and 'other' to have the same dtype, but got ",
+      self.scalar_type(), " and ", other.scalar_type());
+  TORCH_CHECK(!other.is_cuda(), "_sparse_accumulate_rows_: expected 'other' to be a CPU tensor");
+
+  if (!self.is_coalesced()) {
+    coalesce_(self);
+  }
+  const int64_t other_nnz = other._nnz();
+  if (other_nnz == 0) {
+    return self;
+  }
+
+  // deduplicate the rows of 'other'
+  const auto other_indices = other._indices().contiguous();
+  const int64_t* other_rows = other_indices.data_ptr<int64_t>();
+  std::unordered_map<int64_t, int64_t> slot_of_row;
+  slot_of_row.reserve(other_nnz);
+  std::vector<int64_t> rows;
+  std::vector<int64_t> slots(other_nnz);
+  for (int64_t i = 0; i < other_nnz; i++) {
+    const auto it = slot_of_row.emplace(other_rows[i], static_cast<int64_t>(rows.size()));
+    if (it.second) {
+      rows.push_back(other_rows[i]);
+    }
+    slots[i] = it.first->second;
+  }
+  const auto other_values = other._values();
+  auto unique_sizes = other_values.sizes().vec();
+  unique_sizes[0] = rows.size();
+  auto unique_values = at::zeros(unique_sizes, other_values.options());
+  unique_values.index_add_(0, at::tensor(slots, other_indices.options()), other_values);
+
+  // the rows already in 'self' are accumulated in place
+  const auto self_indices = self._indices().contiguous();
+  const int64_t self_nnz = self._nnz();
+  const int64_t* self_rows = self_indices.data_ptr<int64_t>();
+  std::vector<int64_t> found_positions;
+  std::vector<int64_t> found_slots;
+  std::vector<int64_t> missing_slots;
+  for (int64_t j = 0; j < static_cast<int64_t>(rows.size()); j++) {
+    const int64_t* position = std::lower_bound(self_rows, self_rows + self_nnz, rows[j]);
+    if (position != self_rows + self_nnz && *position == rows[j]) {
+      found_positions.push_back(position - self_rows);
+      found_slots.push_back(j);
+    } else {
+      missing_slots.push_back(j);
+    }
+  }
+  auto self_values = self._values();
+  if (!found_slots.empty()) {
+    self_values.index_add_(
+        0,
+        at::tensor(found_positions, self_indices.options()),
+        unique_values.index_select(0, at::tensor(found_slots, self_indices.options())));
+  }
+
+  // and the new ones are merged in order
+  if (!missing_slots.empty()) {
+    std::sort(missing_slots.begin(), missing_slots.end(), [&](int64_t a, int64_t b) {
+      return rows[a] < rows[b];
+    });
+    const int64_t missing = missing_slots.size();
+    std::vector<int64_t> merged_rows;
+    std::vector<int64_t> order;
+    merged_rows.reserve(self_nnz + missing);
+    order.reserve(self_nnz + missing);
+    int64_t i = 0, j = 0;
+    while (i < self_nnz || j < missing) {
+      if (j >= missing || (i < self_nnz && self_rows[i] < rows[missing_slots[j]])) {
+        merged_rows.push_back(self_rows[i]);
+        order.push_back(i++);
+      } else {
+        merged_rows.push_back(rows[missing_slots[j]]);
+        order.push_back(self_nnz + j++);
+      }
+    }
+    const auto all_values = at::cat(
+        {self_values, unique_values.index_select(0, at::tensor(missing_slots, self_indices.options()))}, 0);
+    alias_into_sparse(
+        self,
+        at::tensor(merged_rows, self_indices.options()).view({1, -1}),
+        all_values.index_select(0, at::tensor(order, self_indices.options())));
+  }
+  return self._coalesced_(true);
+}
+
 // --------------------------------------------------------------------
 // add(Tensor, SparseTensor, Scalar)
 //    formerly known as spcadd
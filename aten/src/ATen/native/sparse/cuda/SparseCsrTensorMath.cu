@@ -0,0 +1,156 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/ScalarOps.h>
+#include <ATen/SparseCsrTensorUtils.h>
+#include <ATen/SparseTensorUtils.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAUtils.h>
+#include <ATen/native/sparse/cuda/SparseCUDABlas.cuh>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+using at::sparse::is_same_tensor;
+
+// --------------------------------------------------------------------
+// addmm(D1, S, D2, beta, alpha) -> D  [broadcasts]
+//
+// D = beta * D1 + alpha * mm(S, D2), S in the sparse CSR layout
+// --------------------------------------------------------------------
+
+namespace {
+
+// r_ = beta * t + alpha * op(S) * dense, where op(S) is S or its transpose.
+// Unlike the COO kernel, the row compression is already done: cuSPARSE
+// multiplies with the crow_indices of S as they are, after a conversion to
+// int32 if S has int64 indices.
+template <typename scalar_t>
+void addmm_out_sparse_csr_dense_cuda_worker(
+    Tensor& r_,
+    Scalar beta,
+    const Tensor& t,
+    Scalar alpha,
+    const SparseCsrTensor& sparse,
+    const Tensor& dense,
+    bool transpose) {
+  scalar_t cast_beta = beta.to<scalar_t>();
+  scalar_t cast_alpha = alpha.to<scalar_t>();
+
+  if (cast_beta == 0) {
+    r_.zero_();
+  } else if (cast_beta == 1) {
+    if (!is_same_tensor(t, r_)) {
+      r_.copy_(t);
+    }
+  } else {
+    at::mul_out(r_, t, scalar_to_tensor(beta));
+  }
+
+  const auto impl = get_sparse_csr_impl(sparse);
+  const int64_t nnz = impl->nnz();
+  if (nnz == 0) {
+    return;
+  }
+
+  // cuSPARSE works on column-major dense matrices
+  Tensor r__;
+  if (r_.stride(0) == 1 && r_.stride(1) == r_.size(0)) {
+    r__ = r_;
+  } else {
+    r__ = r_.transpose(0, 1).clone(at::MemoryFormat::Contiguous);
+    r__.transpose_(0, 1);
+  }
+
+  Tensor dense_;
+  char transpose_dense;
+  if (dense.stride(0) == 1 && dense.stride(1) == dense.size(0)) {
+    transpose_dense = 'n';
+    dense_ = dense;
+  } else if (dense.stride(1) == 1 && dense.stride(0) != dense.size(1)) {
+    transpose_dense = 't';
+    dense_ = dense;
+  } else {
+    transpose_dense = 't';
+    dense_ = dense.contiguous();
+  }
+
+  const auto crow_indices = impl->crow_indices().to(kInt).contiguous();
+  const auto col_indices = impl->col_indices().to(kInt).contiguous();
+  const auto values = impl->values().contiguous();
+
+  // op(S) is m x k
+  const int64_t m = transpose ? sparse.size(1) : sparse.size(0);
+  const int64_t k = transpose ? sparse.size(0) : sparse.size(1);
+  sparse::cuda::csrmm2(
+    transpose ? 't' : 'n',
+    transpose_dense,
+    m,
+    r__.size(1),
+    k,
+    nnz,
+    cast_alpha,
+    values.data_ptr<scalar_t>(),
+    crow_indices.data_ptr<int32_t>(),
+    col_indices.data_ptr<int32_t>(),
+    dense_.data_ptr<scalar_t>(),
+    (transpose_dense == 'n' ? dense_.stride(1) : dense_.stride(0)),
+    cast_beta == 0 ? scalar_t(0) : scalar_t(1),
+    r__.data_ptr<scalar_t>(),
+    r__.stride(1));
+
+  if (!is_same_tensor(r_, r__)) {
+    r_.copy_(r__);
+  }
+}
+
+} // namespace
+
+Tensor& addmm_out_sparse_csr_dense_cuda(
+    Tensor& result,
+    const Tensor& self,
+    const SparseCsrTensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha) {
+  TORCH_CHECK(self.is_cuda(), "addmm: expected 'self' to be CUDA, but got CPU");
+  TORCH_CHECK(result.is_cuda(), "addmm: expected 'out' to be CUDA, but got CPU");
+  TORCH_CHECK(mat2.is_cuda(), "addmm: expected 'mat2' to be CUDA, but got CPU");
+  TORCH_CHECK(cuda::check_device({mat1, result, self, mat2}));
+  TORCH_CHECK(mat2.dim() == 2, "addmm: 2D tensor expected, got ", mat2.dim(), "D tensor");
+  TORCH_CHECK(mat2.size(0) == mat1.size(1),
+      "addmm: Argument #3 (dense): Expected dim 0 size ", mat1.size(1), ", got ", mat2.size(0));
+  TORCH_CHECK(mat1.scalar_type() == mat2.scalar_type() && result.scalar_type() == mat2.scalar_type(),
+      "addmm: expected 'mat1', 'mat2' and 'out' to have the same dtype, but got ",
+      mat1.scalar_type(), ", ", mat2.scalar_type(), " and ", result.scalar_type());
+
+  Tensor b_self;
+  std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm_out");
+  result.resize_({mat1.size(0), mat2.size(1)});
+
+  // No half support, so we don't have to use CUDATypeConversion
+  AT_DISPATCH_FLOATING_TYPES(mat1.scalar_type(), "addmm_sparse_csr_cuda", [&] {
+    addmm_out_sparse_csr_dense_cuda_worker<scalar_t>(result, beta, b_self, alpha, mat1, mat2, /*transpose=*/false);
+  });
+  return result;
+}
+
+Tensor _sparse_csr_transposed_mm_cuda(const SparseCsrTensor& sparse, const Tensor& dense) {
+  TORCH_CHECK(dense.is_cuda(), "_sparse_csr_transposed_mm: expected 'dense' to be CUDA, but got CPU");
+  TORCH_CHECK(cuda::check_device({sparse, dense}));
+  TORCH_CHECK(dense.dim() == 2, "_sparse_csr_transposed_mm: matrices expected, got ", dense.dim(), "D tensor");
+  TORCH_CHECK(dense.size(0) == sparse.size(0),
+      "_sparse_csr_transposed_mm: Expected dim 0 size ", sparse.size(0), ", got ", dense.size(0));
+  TORCH_CHECK(sparse.scalar_type() == dense.scalar_type(),
+      "_sparse_csr_transposed_mm: expected 'sparse' and 'dense' to have the same dtype, but got ",
+      sparse.scalar_type(), " and ", dense.scalar_type());
+
+  Tensor result = at::empty({sparse.size(1), dense.size(1)}, dense.options());
+  AT_DISPATCH_FLOATING_TYPES(sparse.scalar_type(), "_sparse_csr_transposed_mm_cuda", [&] {
+    addmm_out_sparse_csr_dense_cuda_worker<scalar_t>(result, 0, result, 1, sparse, dense, /*transpose=*/true);
+  });
+  return result;
+}
+
+}} // namespace at::native
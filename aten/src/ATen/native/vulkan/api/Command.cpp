@@ -67,6 +67,26 @@ void allocate_command_buffers(
       command_buffers));
 }
 
+void submit_command_buffers(
+    const VkQueue queue,
+    const VkCommandBuffer* const command_buffers,
+    const uint32_t count,
+    const VkFence fence) {
+  const VkSubmitInfo submit_info{
+    VK_STRUCTURE_TYPE_SUBMIT_INFO,
+    nullptr,
+    0u,
+    nullptr,
+    nullptr,
+    count,
+    command_buffers,
+    0u,
+    nullptr,
+  };
+
+  VK_CHECK(vkQueueSubmit(queue, 1u, &submit_info, fence));
+}
+
 } // namespace
 
 Command::Buffer::Buffer(const VkCommandBuffer command_buffer)
@@ -341,6 +361,7 @@ Command::Pool::Pool(const GPU& gpu)
       "Invalid Vulkan command pool!");
 
   buffer_.pool.reserve(Configuration::kReserve);
+  stream_.batch_depth = 0u;
 }
 
 Command::Pool::Pool(Pool&& pool)
@@ -413,6 +434,32 @@ Command::Buffer& Command::Pool::stream() {
   return stream_.buffer;
 }
 
+void Command::Pool::begin_batch() {
+  ++stream_.batch_depth;
+}
+
+void Command::Pool::end_batch(const VkQueue queue) {
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+      stream_.batch_depth > 0u,
+      "Unbalanced command batch!");
+
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+      queue,
+      "Invalid Vulkan queue!");
+
+  if ((0u == --stream_.batch_depth) && stream_.buffer) {
+    stream_.buffer.end();
+    const VkCommandBuffer command_buffer = stream_.buffer.handle();
+    stream_.buffer.invalidate();
+
+    submit_command_buffers(queue, &command_buffer, 1u, VK_NULL_HANDLE);
+  }
+}
+
+bool Command::Pool::batching() const {
+  return stream_.batch_depth > 0u;
+}
+
 void Command::Pool::purge() {
   TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
       device_ && command_pool_,
@@ -458,9 +505,12 @@ void Command::Pool::submit(
     if (stream_.buffer.handle() == command_buffer) {
       // Hand the stream off to the driver if:
       // - The user has implictly signaled interest in the results via a fence.
-      // - We are over the submission cutoff.  We don't want to starve the GPU.
+      // - We are over the submission cutoff, outside of a batch.  We don't
+      //   want to starve the GPU.
 
-      if (fence || (stream_.counter++ > Configuration::kSubmit)) {
+      if (fence ||
+          ((0u == stream_.batch_depth) &&
+           (stream_.counter++ > Configuration::kSubmit))) {
         stream_.buffer.end();
         stream_.buffer.invalidate();
       }
@@ -476,19 +526,11 @@ void Command::Pool::submit(
   }
 
   if (!command_buffers.empty()) {
-    const VkSubmitInfo submit_info{
-      VK_STRUCTURE_TYPE_SUBMIT_INFO,
-      nullptr,
-      0u,
-      nullptr,
-      nullptr,
-      command_buffers.size(),
-      command_buffers.data(),
-      0u,
-      nullptr,
-    };
-
-    VK_CHECK(vkQueueSubmit(queue, 1u, &submit_info, fence.handle()));
+    submit_command_buffers(
+        queue,
+        command_buffers.data(),
+        command_buffers.size(),
+        fence.handle());
   }
 }
 
@@ -90,6 +90,13 @@ struct Command final {
     Buffer& stream();
     void purge();
 
+    // While a batch is open the command stream is only handed to the driver
+    // to signal a fence, as readbacks do, instead of every kSubmit
+    // submissions.  The end of the outermost batch submits the stream.
+    void begin_batch();
+    void end_batch(VkQueue queue);
+    bool batching() const;
+
     void submit(
         VkQueue queue,
         c10::ArrayRef<const Buffer> buffers,
@@ -116,6 +123,7 @@ struct Command final {
     struct {
       Buffer buffer;
       uint32_t counter;
+      uint32_t batch_depth;
     } stream_;
   } pool /* [thread_count] */;
 
@@ -168,6 +168,27 @@ Context* context() {
   return context.get();
 }
 
+Batch::Batch() {
+  context()->command().pool.begin_batch();
+}
+
+Batch::~Batch() {
+  try {
+    Context* const context = api::context();
+    context->command().pool.end_batch(context->gpu().queue);
+  }
+  catch (const std::exception& e) {
+    TORCH_WARN(
+        "Vulkan: Batch destructor raised an exception! Error: ",
+        e.what());
+  }
+  catch (...) {
+    TORCH_WARN(
+        "Vulkan: Batch destructor raised an exception! "
+        "Error: Unknown");
+  }
+}
+
 Descriptor::Set dispatch_prologue(
     Command::Buffer& command_buffer,
     const Shader::Layout::Signature& shader_layout_signature,
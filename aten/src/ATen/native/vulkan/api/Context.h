@@ -75,6 +75,24 @@ class Context final {
 bool available();
 Context* context();
 
+//
+// Batches the commands issued within its scope, typically one inference, into
+// a single command buffer submitted to the queue once at the end of the scope.
+// Reading results back to the CPU in the meantime still submits the commands
+// recorded so far, as the readback needs them complete.  Batches nest, and
+// only the outermost one submits.
+//
+
+class Batch final {
+ public:
+  Batch();
+  Batch(const Batch&) = delete;
+  Batch& operator=(const Batch&) = delete;
+  Batch(Batch&&) = delete;
+  Batch& operator=(Batch&&) = delete;
+  ~Batch();
+};
+
 //
 // Impl
 //
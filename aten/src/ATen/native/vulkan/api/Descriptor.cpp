@@ -397,8 +397,12 @@ void Descriptor::Pool::purge() {
       "This descriptor pool is in an invalid state! "
       "Potential reason: This descriptor pool is moved from.");
 
-  VK_CHECK(vkResetDescriptorPool(device_, descriptor_pool_.get(), 0u));
-  set_.layouts.clear();
+  // Keep the descriptor sets allocated, and hand them out again for the same
+  // layouts, rather than resetting the pool.  Once the first inference has
+  // been through, the following ones do not allocate any descriptor set.
+  for (auto& layout : set_.layouts) {
+    layout.second.in_use = 0u;
+  }
 }
 
 void Descriptor::Pool::invalidate() {
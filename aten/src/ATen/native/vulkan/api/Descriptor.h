@@ -48,7 +48,9 @@ namespace api {
 // It is important to point out that for performance reasons, we intentionally
 // do not free the descriptor sets individually, and instead opt to purge the
 // pool in its totality, even though Vulkan supports the former usage pattern
-// as well.  This behavior is by design.
+// as well.  This behavior is by design.  A purge keeps the descriptor sets
+// allocated though, and recycles them for their layout, since the GPU is done
+// with all of them by then.
 //
 
 struct Descriptor final {
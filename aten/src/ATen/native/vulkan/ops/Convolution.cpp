@@ -450,6 +450,102 @@ bool usable(const Tensor& input) {
          true;
 }
 
+// Binds the (output, input, weight, bias) quartet common to all convolution
+// shaders, along with the residual added to the result by the fused variants.
+template<typename Block>
+void dispatch(
+    api::Context* const context,
+    api::Command::Buffer& command_buffer,
+    const api::Shader::Descriptor& shader_descriptor,
+    const api::Shader::Descriptor& shader_add_descriptor,
+    vTensor& v_output,
+    const vTensor& v_input,
+    const vTensor& v_weight,
+    const vTensor& v_bias,
+    const vTensor* const v_other,
+    const Block& block) {
+  if (v_other) {
+    context->dispatch(
+        command_buffer,
+        {
+          VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+        },
+        shader_add_descriptor,
+        v_output.extents(),
+        // Write-only access bypasses synchronization but inserts appropriate
+        // barriers if necessary.
+        v_output.image(
+            command_buffer,
+            vTensor::Stage::Compute,
+            vTensor::Access::Write),
+        // Read-only access is implied on const tensors and triggers an async
+        // synchronization if necessary.
+        v_input.image(
+            command_buffer,
+            vTensor::Stage::Compute),
+        // Read-only access is implied on const tensors and triggers an async
+        // synchronization if necessary.
+        v_weight.image(
+            command_buffer,
+            vTensor::Stage::Compute),
+        // Read-only access is implied on const tensors and triggers an async
+        // synchronization if necessary.
+        v_bias.buffer(
+            command_buffer,
+            vTensor::Stage::Compute),
+        // Read-only access is implied on const tensors and triggers an async
+        // synchronization if necessary.
+        v_other->image(
+            command_buffer,
+            vTensor::Stage::Compute),
+        // Object lifetime is managed by the resource pool.
+        // It is OK not to keep track of the handle.
+        context->resource().pool.uniform(block).object);
+  }
+  else {
+    context->dispatch(
+        command_buffer,
+        {
+          VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+          VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+        },
+        shader_descriptor,
+        v_output.extents(),
+        // Write-only access bypasses synchronization but inserts appropriate
+        // barriers if necessary.
+        v_output.image(
+            command_buffer,
+            vTensor::Stage::Compute,
+            vTensor::Access::Write),
+        // Read-only access is implied on const tensors and triggers an async
+        // synchronization if necessary.
+        v_input.image(
+            command_buffer,
+            vTensor::Stage::Compute),
+        // Read-only access is implied on const tensors and triggers an async
+        // synchronization if necessary.
+        v_weight.image(
+            command_buffer,
+            vTensor::Stage::Compute),
+        // Read-only access is implied on const tensors and triggers an async
+        // synchronization if necessary.
+        v_bias.buffer(
+            command_buffer,
+            vTensor::Stage::Compute),
+        // Object lifetime is managed by the resource pool.
+        // It is OK not to keep track of the handle.
+        context->resource().pool.uniform(block).object);
+  }
+}
+
 void conv2d_dw(
     api::Context* const context,
     api::Command::Buffer& command_buffer,
@@ -457,6 +553,7 @@ void conv2d_dw(
     const vTensor& v_input,
     const vTensor& v_weight,
     const vTensor& v_bias,
+    const vTensor* const v_other,
     const IntArrayRef filter,
     const IntArrayRef src_filter,
     const IntArrayRef stride,
@@ -500,41 +597,17 @@ void conv2d_dw(
       },
     };
 
-    context->dispatch(
+    dispatch(
+        context,
         command_buffer,
-        {
-          VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-          VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-          VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-        },
         VK_KERNEL(conv2d_dw),
-        v_output.extents(),
-        // Write-only access bypasses synchronization but inserts appropriate
-        // barriers if necessary.
-        v_output.image(
-            command_buffer,
-            vTensor::Stage::Compute,
-            vTensor::Access::Write),
-        // Read-only access is implied on const tensors and triggers an async
-        // synchronization if necessary.
-        v_input.image(
-            command_buffer,
-            vTensor::Stage::Compute),
-        // Read-only access is implied on const tensors and triggers an async
-        // synchronization if necessary.
-        v_weight.image(
-            command_buffer,
-            vTensor::Stage::Compute),
-        // Read-only access is implied on const tensors and triggers an async
-        // synchronization if necessary.
-        v_bias.buffer(
-            command_buffer,
-            vTensor::Stage::Compute),
-        // Object lifetime is managed by the resource pool.
-        // It is OK not to keep track of the handle.
-        context->resource().pool.uniform(block).object);
+        VK_KERNEL(conv2d_dw_add),
+        v_output,
+        v_input,
+        v_weight,
+        v_bias,
+        v_other,
+        block);
   }
   else {
     TORCH_CHECK(false, "Not implemented!");
@@ -548,6 +621,7 @@ void conv2d_pw(
     const vTensor& v_input,
     const vTensor& v_weight,
     const vTensor& v_bias,
+    const vTensor* const v_other,
     const IntArrayRef filter,
     const IntArrayRef stride,
     const IntArrayRef padding,
@@ -577,41 +651,17 @@ void conv2d_pw(
       },
     };
 
-    context->dispatch(
+    dispatch(
+        context,
         command_buffer,
-        {
-          VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-          VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-          VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-        },
         VK_KERNEL(conv2d_pw),
-        v_output.extents(),
-        // Write-only access bypasses synchronization but inserts appropriate
-        // barriers if necessary.
-        v_output.image(
-            command_buffer,
-            vTensor::Stage::Compute,
-            vTensor::Access::Write),
-        // Read-only access is implied on const tensors and triggers an async
-        // synchronization if necessary.
-        v_input.image(
-            command_buffer,
-            vTensor::Stage::Compute),
-        // Read-only access is implied on const tensors and triggers an async
-        // synchronization if necessary.
-        v_weight.image(
-            command_buffer,
-            vTensor::Stage::Compute),
-        // Read-only access is implied on const tensors and triggers an async
-        // synchronization if necessary.
-        v_bias.buffer(
-            command_buffer,
-            vTensor::Stage::Compute),
-        // Object lifetime is managed by the resource pool.
-        // It is OK not to keep track of the handle.
-        context->resource().pool.uniform(block).object);
+        VK_KERNEL(conv2d_pw_add),
+        v_output,
+        v_input,
+        v_weight,
+        v_bias,
+        v_other,
+        block);
   }
   else {
     TORCH_CHECK(false, "Not implemented!");
@@ -625,6 +675,7 @@ void conv2d(
     const vTensor& v_input,
     const vTensor& v_weight,
     const vTensor& v_bias,
+    const vTensor* const v_other,
     const IntArrayRef filter,
     const IntArrayRef src_filter,
     const IntArrayRef stride,
@@ -674,41 +725,17 @@ void conv2d(
       },
     };
 
-    context->dispatch(
+    dispatch(
+        context,
         command_buffer,
-        {
-          VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-          VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-          VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-        },
         VK_KERNEL(conv2d),
-        v_output.extents(),
-        // Write-only access bypasses synchronization but inserts appropriate
-        // barriers if necessary.
-        v_output.image(
-            command_buffer,
-            vTensor::Stage::Compute,
-            vTensor::Access::Write),
-        // Read-only access is implied on const tensors and triggers an async
-        // synchronization if necessary.
-        v_input.image(
-            command_buffer,
-            vTensor::Stage::Compute),
-        // Read-only access is implied on const tensors and triggers an async
-        // synchronization if necessary.
-        v_weight.image(
-            command_buffer,
-            vTensor::Stage::Compute),
-        // Read-only access is implied on const tensors and triggers an async
-        // synchronization if necessary.
-        v_bias.buffer(
-            command_buffer,
-            vTensor::Stage::Compute),
-        // Object lifetime is managed by the resource pool.
-        // It is OK not to keep track of the handle.
-        context->resource().pool.uniform(block).object);
+        VK_KERNEL(conv2d_add),
+        v_output,
+        v_input,
+        v_weight,
+        v_bias,
+        v_other,
+        block);
   }
   else {
     TORCH_CHECK(false, "Not implemented!");
@@ -926,7 +953,9 @@ Conv2dOpContext Conv2dOpContext::create(
   };
 }
 
-Tensor Conv2dOpContext::run(const Tensor& input_arg) const {
+Tensor Conv2dOpContext::run(
+    const Tensor& input_arg,
+    const c10::optional<Tensor>& other_arg) const {
   api::Context* const context = api::context();
 
   const Tensor input = input_arg.is_vulkan() ? input_arg : input_arg.vulkan();
@@ -948,6 +977,26 @@ Tensor Conv2dOpContext::run(const Tensor& input_arg) const {
     input.options(),
   };
 
+  Tensor other;
+  const vTensor* v_other = nullptr;
+  float output_min = packed_.output_min;
+  float output_max = packed_.output_max;
+
+  if (other_arg) {
+    other = other_arg->is_vulkan() ? *other_arg : other_arg->vulkan();
+
+    // The shaders add the residual as is.  Those which broadcast are added
+    // afterwards, along with the clamp which must follow.
+    if (!Experimentation::kUseConv2dOldApi &&
+        (other.sizes() == v_output.sizes())) {
+      v_other = &convert(other);
+    }
+    else {
+      output_min = -std::numeric_limits<float>::infinity();
+      output_max = +std::numeric_limits<float>::infinity();
+    }
+  }
+
   api::Command::Pool& command_pool = context->command().pool;
   api::Command::Buffer& command_buffer = command_pool.stream();
   {
@@ -959,13 +1008,14 @@ Tensor Conv2dOpContext::run(const Tensor& input_arg) const {
           v_input,
           packed_.v_weight,
           packed_.v_bias,
+          v_other,
           packed_.filter,
           unpacked_.filter,
           packed_.stride,
           packed_.padding,
           packed_.dilation,
-          packed_.output_min,
-          packed_.output_max);
+          output_min,
+          output_max);
     }
     else {
       if (Experimentation::kUseConv2dOldApi) {
@@ -980,8 +1030,8 @@ Tensor Conv2dOpContext::run(const Tensor& input_arg) const {
             packed_.stride,
             packed_.padding,
             packed_.dilation,
-            packed_.output_min,
-            packed_.output_max);
+            output_min,
+            output_max);
       } else {
         if (is_pointwise(unpacked_.filter)) {
           conv2d_pw(
@@ -991,11 +1041,12 @@ Tensor Conv2dOpContext::run(const Tensor& input_arg) const {
               v_input,
               packed_.v_weight,
               packed_.v_bias,
+              v_other,
               packed_.filter,
               packed_.stride,
               packed_.padding,
-              packed_.output_min,
-              packed_.output_max);
+              output_min,
+              output_max);
         }
         else {
           conv2d(
@@ -1005,19 +1056,30 @@ Tensor Conv2dOpContext::run(const Tensor& input_arg) const {
               v_input,
               packed_.v_weight,
               packed_.v_bias,
+              v_other,
               packed_.filter,
               unpacked_.filter,
               packed_.stride,
               packed_.padding,
               packed_.dilation,
-              packed_.output_min,
-              packed_.output_max);
+              output_min,
+              output_max);
         }
       }
     }
   }
   command_pool.submit(context->gpu().queue, command_buffer);
 
+  if (other.defined() && !v_other) {
+    const Tensor output = at::add(convert(v_output), other);
+
+    if (unpacked_.output_min || unpacked_.output_max) {
+      return at::clamp(output, unpacked_.output_min, unpacked_.output_max);
+    }
+
+    return output;
+  }
+
   return convert(v_output);
 }
 
@@ -1064,6 +1126,13 @@ Tensor conv2d_clamp_run(
   return context->run(input);
 }
 
+Tensor conv2d_clamp_add_run(
+    const Tensor& input,
+    const Tensor& other,
+    const c10::intrusive_ptr<Conv2dOpContext>& context) {
+  return context->run(input, other);
+}
+
 } // namespace ops
 } // namespace vulkan
 } // namespace native
@@ -35,7 +35,11 @@ class Conv2dOpContext final : public torch::jit::CustomClassHolder {
       c10::optional<Scalar>,
       c10::optional<Scalar>>;
 
-  Tensor run(const Tensor& input) const;
+  // Adds other, if any, to the convolution before clamping it, as in the
+  // residual blocks of ResNets.
+  Tensor run(
+      const Tensor& input,
+      const c10::optional<Tensor>& other = c10::nullopt) const;
   State unpack() const;
 
  private:
@@ -82,6 +86,11 @@ Tensor conv2d_clamp_run(
     const Tensor& input,
     const c10::intrusive_ptr<Conv2dOpContext>& context);
 
+Tensor conv2d_clamp_add_run(
+    const Tensor& input,
+    const Tensor& other,
+    const c10::intrusive_ptr<Conv2dOpContext>& context);
+
 c10::intrusive_ptr<Conv2dOpContext> conv2d_clamp_prepack(
     Tensor&& weight,
     c10::optional<Tensor>&& bias,
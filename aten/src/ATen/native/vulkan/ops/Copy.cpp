@@ -75,79 +75,13 @@ Tensor& copy_(Tensor& self, const Tensor& src) {
     }
     // Vulkan -> X
     else if (at::kVulkan == src.device().type()) {
-      const vTensor& v_src = convert(src);
-
       // Vulkan -> CPU
       if (self.device().is_cpu()) {
-        // Similar notes as above applies, with the additional consideration of
-        // potential syncs on read accesses.  Namely,
-        // - on discrete systems, if the (staging, buffer, image) trio, or
-        // - on UMA, if the (buffer, image) duo
-        // have gone out of sync as a result of one processor writing to one
-        // resource which is then either accessed as an another resource type on
-        // the same or another processor.  Same considerations regarding hazard
-        // avoidance as above applies.
-
-        using Future = vTensor::Future<const void, vTensor::Access::Read>;
-        const Future v_src_future = v_src.host<const void>(command_buffer);
-
-        // Ideally we would have been able to put as much distance between
-        // requesting the data - a call to host() - and accessing the data
-        // - a call to wait() - but a local view of the computation graph
-        // in eager mode makes that optimization non-trivial.
-
-        // This wait() is a no-op if data is not out of sync.  More often than
-        // not though, waits here are expected as the GPU catches up with
-        // compute submitted from CPU.
-
-        const Future::Payload v_src_payload = v_src_future.wait();
-
-        memcpy(
-            self.data_ptr<float>(),
-            v_src_payload.get(),
-            std::min(src.nbytes(), self.nbytes()));
+        Readback(src, self).wait();
       }
       else {
         TORCH_CHECK(false, "Unsupported!");
       }
-
-      //
-      // WARNING
-      //
-
-      // This is not great.  We almost never want to flush the GPU pipeline as
-      // that has far reaching consequences, especially if PyTorch is not the only
-      // process accessing the GPU.  If we have done our job properly, above
-      // synchronization mechanisms should be enough to ensure correctness at a more
-      // modest cost, as there is no need to flush the entirety of jobs in flight
-      // if one is only interested on waiting on computation affecting one single
-      // tensor to finish.
-      //
-      // Having said that, we still do need to release all pool resources at one
-      // point per inference run or we will run out of memory otherwise. There is
-      // no perfect answer to this problem that checks all boxes, which leaves us
-      // with one of several design decisions:
-      //
-      // 1) Use graph mode to gain an understanding of the computation graph,
-      //    itself allowing us to place pool purges intelligently.  Best option
-      //    for performance and memory consumption.  Not without its downsides if
-      //    flexibility is a top priority.
-      // 2) If on eager mode, and hence are seeing operations one at a time, expose
-      //    this release of resources to the user as a Python / C++ function.  This
-      //    makes for suboptimal user experience but is efficient in terms of
-      //    performance.
-      // 3) If on eager mode, and interested in keeping this bookkeeping transparent
-      //    to the user, release all resources somewhere ... like here.  This is
-      //    not ideal since it requires a pipeline flush to make sure these objects
-      //    are not already in use by a workload in flight.  Cannot do much better
-      //    within the constraints of this approach.  Good for user experience,
-      //    suboptimal for performance.
-      // 4) If on eager mode, and interested in keeping this bookkeeping transparent
-      //    to the user, and performance does not matter, make CPU and GPU run in
-      //    lockstep.  Obviously this is just bad.  Mentioned for the sake of
-      //    completeness.
-
-      context->flush();
     }
     else {
       TORCH_INTERNAL_ASSERT(
@@ -162,6 +96,91 @@ Tensor& copy_(Tensor& self, const Tensor& src) {
   return self;
 }
 
+Readback::Readback(const Tensor& src)
+  : Readback(src, at::empty(src.sizes(), src.options().device(at::kCPU))) {
+}
+
+Readback::Readback(const Tensor& src, const Tensor& dst)
+  : src_(src),
+    dst_(dst),
+    // Similar notes as in copy_() applies, with the additional consideration
+    // of potential syncs on read accesses.  Namely,
+    // - on discrete systems, if the (staging, buffer, image) trio, or
+    // - on UMA, if the (buffer, image) duo
+    // have gone out of sync as a result of one processor writing to one
+    // resource which is then either accessed as an another resource type on
+    // the same or another processor.  In which case host() records the
+    // transfer, and submits the command stream along with a fence.
+    future_(convert(src_).host<const void>(
+        api::context()->command().pool.stream())) {
+  TORCH_CHECK(
+      at::kVulkan == src_.device().type() && dst_.device().is_cpu(),
+      "Vulkan: Readback expects a Vulkan source and a CPU destination!");
+}
+
+Tensor Readback::wait() {
+  // This wait() is a no-op if data is not out of sync.  More often than not
+  // though, waits here are expected as the GPU catches up with compute
+  // submitted from CPU.  The later the wait, the less of it remains.
+  {
+    const Future::Payload payload = future_.wait();
+
+    memcpy(
+        dst_.data_ptr<float>(),
+        payload.get(),
+        std::min(src_.nbytes(), dst_.nbytes()));
+  }
+
+  //
+  // WARNING
+  //
+
+  // This is not great.  We almost never want to flush the GPU pipeline as
+  // that has far reaching consequences, especially if PyTorch is not the only
+  // process accessing the GPU.  If we have done our job properly, above
+  // synchronization mechanisms should be enough to ensure correctness at a more
+  // modest cost, as there is no need to flush the entirety of jobs in flight
+  // if one is only interested on waiting on computation affecting one single
+  // tensor to finish.
+  //
+  // Having said that, we still do need to release all pool resources at one
+  // point per inference run or we will run out of memory otherwise. There is
+  // no perfect answer to this problem that checks all boxes, which leaves us
+  // with one of several design decisions:
+  //
+  // 1) Use graph mode to gain an understanding of the computation graph,
+  //    itself allowing us to place pool purges intelligently.  Best option
+  //    for performance and memory consumption.  Not without its downsides if
+  //    flexibility is a top priority.
+  // 2) If on eager mode, and hence are seeing operations one at a time, expose
+  //    this release of resources to the user as a Python / C++ function.  This
+  //    makes for suboptimal user experience but is efficient in terms of
+  //    performance.
+  // 3) If on eager mode, and interested in keeping this bookkeeping transparent
+  //    to the user, release all resources somewhere ... like here.  This is
+  //    not ideal since it requires a pipeline flush to make sure these objects
+  //    are not already in use by a workload in flight.  Cannot do much better
+  //    within the constraints of this approach.  Good for user experience,
+  //    suboptimal for performance.
+  // 4) If on eager mode, and interested in keeping this bookkeeping transparent
+  //    to the user, and performance does not matter, make CPU and GPU run in
+  //    lockstep.  Obviously this is just bad.  Mentioned for the sake of
+  //    completeness.
+  //
+  // The fence waited on above also covers the work submitted before it, so
+  // that the GPU is idle by now, barring commands recorded since, and the
+  // flush itself does not wait.  The same does not hold within a batch, whose
+  // stream keeps recording, in which case the pools are purged at the next
+  // readback outside of any batch.
+
+  api::Context* const context = api::context();
+  if (!context->command().pool.batching()) {
+    context->flush();
+  }
+
+  return dst_;
+}
+
 } // namespace ops
 } // namespace vulkan
 } // namespace native
@@ -11,6 +11,35 @@ namespace ops {
 
 Tensor& copy_(Tensor& self, const Tensor& src);
 
+//
+// A copy of a Vulkan tensor to the CPU, requested from the GPU on construction
+// and completed by wait().  The CPU is free to prepare the next inputs, or to
+// record more work, while the GPU catches up and transfers the results.
+//
+
+class Readback final {
+ public:
+  // Reads back into a new contiguous CPU tensor
+  explicit Readback(const Tensor& src);
+  Readback(const Tensor& src, const Tensor& dst);
+  Readback(const Readback&) = delete;
+  Readback& operator=(const Readback&) = delete;
+  Readback(Readback&&) = default;
+  Readback& operator=(Readback&&) = default;
+  ~Readback() = default;
+
+  // Blocks until the copy is complete, and returns the CPU tensor
+  Tensor wait();
+
+ private:
+  using Future = vTensor::Future<const void, vTensor::Access::Read>;
+
+  // Keeps the Vulkan tensor alive until the copy is complete
+  Tensor src_;
+  Tensor dst_;
+  Future future_;
+};
+
 } // namespace ops
 } // namespace vulkan
 } // namespace native
@@ -53,6 +53,9 @@ TORCH_LIBRARY(vulkan_prepack, m) {
   m.def(
       "conv2d_clamp_run(Tensor X, "
       "__torch__.torch.classes.vulkan.Conv2dOpContext W_prepack) -> Tensor Y");
+  m.def(
+      "conv2d_clamp_add_run(Tensor X, Tensor other, "
+      "__torch__.torch.classes.vulkan.Conv2dOpContext W_prepack) -> Tensor Y");
   m.def(
       "linear_prepack(Tensor W, Tensor? B) "
       "-> __torch__.torch.classes.vulkan.LinearOpContext");
@@ -68,6 +71,7 @@ TORCH_LIBRARY_IMPL(vulkan_prepack, CPU, m) {
 
 TORCH_LIBRARY_IMPL(vulkan_prepack, Vulkan, m) {
   m.impl("conv2d_clamp_run", TORCH_FN(conv2d_clamp_run));
+  m.impl("conv2d_clamp_add_run", TORCH_FN(conv2d_clamp_add_run));
   m.impl("linear_run", TORCH_FN(linear_run));
 }
 
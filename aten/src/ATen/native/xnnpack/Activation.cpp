@@ -0,0 +1,146 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/xnnpack/Engine.h>
+#include <ATen/native/utils/Factory.h>
+#include <c10/core/CPUAllocator.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+namespace {
+
+// Here are the list of conditions required for the elementwise activations to
+// take this code path:
+// * Input must be a CPU float tensor with no gradients.
+// * Input must be contiguous in its suggested memory format, which covers both
+//   NCHW and NHWC activation maps, so that it is processed as a flat array
+//   without any copy in or out.
+bool use_activation(const Tensor& input) {
+  return xnnpack::internal::available() &&
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      (input.numel() > 0) &&
+      input.is_contiguous(input.suggest_memory_format()) &&
+      !input.requires_grad() &&
+      true;
+}
+
+template <typename Create, typename Setup>
+Tensor& activation_out(
+    Tensor& output,
+    const Tensor& input,
+    const Create create,
+    const Setup setup,
+    const char* const name) {
+  using namespace internal;
+
+  // The input and the output are processed as arrays of numel() pixels of one
+  // channel, which XNNPACK splits across the threadpool as a single contiguous
+  // block.
+  xnn_operator_t activation_op{};
+
+  const xnn_status create_status = create(
+      1u,                                             // channels
+      1u,                                             // input_pixel_stride
+      1u,                                             // output_pixel_stride
+      0u,                                             // flags
+      &activation_op);                                // operator
+
+  Operator activation_scoped_op(activation_op);
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_", name, "_nc_f32 failed!");
+
+  const xnn_status setup_status = setup(
+      activation_op,                                  // operator
+      input.numel(),                                  // batch_size
+      input.data_ptr<float>(),                        // input
+      output.data_ptr<float>(),                       // output
+      caffe2::pthreadpool_());                        // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_", name, "_nc_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      activation_op,                                  // operator
+      caffe2::pthreadpool_());                        // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output;
+}
+
+template <typename Create, typename Setup>
+Tensor activation(
+    const Tensor& input,
+    const Create create,
+    const Setup setup,
+    const char* const name) {
+  // XNNPACK may read past the end of the input, which the mobile allocator
+  // pads for. On mobile builds that is the default CPU allocator, so this
+  // only copies the tensors created by other means.
+  const Tensor input_padded_contig =
+      mobile::allocate_padded_contiguous_if_needed(
+          input,
+          input.suggest_memory_format());
+
+  Tensor output_padded_contig = mobile::empty_with_tail_padding(
+      input_padded_contig.sizes(),
+      input_padded_contig.options().dtype(),
+      input.suggest_memory_format(),
+      input_padded_contig.names());
+
+  return activation_out(
+      output_padded_contig, input_padded_contig, create, setup, name);
+}
+
+} // namespace
+
+bool use_hardswish(const Tensor& input) {
+  return use_activation(input);
+}
+
+Tensor hardswish(const Tensor& input) {
+  return activation(
+      input,
+      xnn_create_hardswish_nc_f32,
+      xnn_setup_hardswish_nc_f32,
+      "hardswish");
+}
+
+bool use_hardswish_(const Tensor& input) {
+  return use_activation(input) &&
+      (input.storage().allocator() == c10::GetDefaultMobileCPUAllocator());
+}
+
+Tensor& hardswish_(Tensor& input) {
+  return activation_out(
+      input,
+      input,
+      xnn_create_hardswish_nc_f32,
+      xnn_setup_hardswish_nc_f32,
+      "hardswish");
+}
+
+bool use_sigmoid(const Tensor& input) {
+  return use_activation(input);
+}
+
+Tensor sigmoid(const Tensor& input) {
+  return activation(
+      input,
+      xnn_create_sigmoid_nc_f32,
+      xnn_setup_sigmoid_nc_f32,
+      "sigmoid");
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
@@ -0,0 +1,233 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/xnnpack/Engine.h>
+#include <ATen/native/utils/Factory.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/MemoryOverlap.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+namespace {
+
+// The shape of the tensor in the order its dimensions are laid out in memory,
+// which is what XNNPACK broadcasts over.  Both operands share the same memory
+// format, so broadcasting in memory order is broadcasting in logical order.
+std::vector<size_t> memory_shape(
+    const Tensor& tensor,
+    const MemoryFormat memory_format) {
+  using namespace internal;
+
+  if (MemoryFormat::ChannelsLast == memory_format) {
+    return {
+      static_cast<size_t>(tensor.size(Layout::Activation4D::batch)),
+      static_cast<size_t>(tensor.size(Layout::Activation4D::height)),
+      static_cast<size_t>(tensor.size(Layout::Activation4D::width)),
+      static_cast<size_t>(tensor.size(Layout::Activation4D::channels)),
+    };
+  }
+
+  return std::vector<size_t>(tensor.sizes().cbegin(), tensor.sizes().cend());
+}
+
+bool use_input(const Tensor& input, const MemoryFormat memory_format) {
+  return (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      (input.numel() > 0) &&
+      input.is_contiguous(memory_format) &&
+      !input.has_names() &&
+      !input.requires_grad();
+}
+
+// The output either is to be allocated, or must already be laid out like the
+// broadcasted inputs, and may only alias an input it fully overlaps with.
+bool use_output(
+    const Tensor& output,
+    const Tensor& input1,
+    const Tensor& input2,
+    const MemoryFormat memory_format) {
+  if (!output.defined()) {
+    return true;
+  }
+
+  const std::vector<int64_t> sizes = infer_size(input1.sizes(), input2.sizes());
+
+  const auto use_alias = [&output](const Tensor& input) {
+    const MemOverlapStatus status = get_overlap_status(output, input);
+    return (MemOverlapStatus::NO == status) ||
+        ((MemOverlapStatus::FULL == status) && (input.sizes() == output.sizes()));
+  };
+
+  return (c10::DeviceType::CPU == output.device().type()) &&
+      (kFloat == output.scalar_type()) &&
+      (output.sizes() == IntArrayRef(sizes)) &&
+      output.is_contiguous(memory_format) &&
+      !output.has_names() &&
+      !output.requires_grad() &&
+      use_alias(input1) &&
+      use_alias(input2);
+}
+
+bool use_binary(
+    const Tensor& input1,
+    const Tensor& input2,
+    const Tensor& output) {
+  // Here are the list of conditions required for this code path to be taken:
+  // * Inputs must be CPU float tensors with no gradients, of the same rank, at
+  //   most XNN_MAX_TENSOR_DIMS, and broadcastable against each other.
+  // * Inputs must be contiguous in the same memory format, NCHW or NHWC, so
+  //   that no operand needs to be copied.
+  // * Output, if given, must match the broadcasted shape and memory format.
+  if (!xnnpack::internal::available() ||
+      (input1.dim() != input2.dim()) ||
+      (input1.dim() < 1) ||
+      (input1.dim() > XNN_MAX_TENSOR_DIMS)) {
+    return false;
+  }
+
+  const MemoryFormat memory_format = input1.suggest_memory_format();
+
+  if (!use_input(input1, memory_format) || !use_input(input2, memory_format)) {
+    return false;
+  }
+
+  for (int64_t dim = 0; dim < input1.dim(); ++dim) {
+    if ((input1.size(dim) != input2.size(dim)) &&
+        (input1.size(dim) != 1) &&
+        (input2.size(dim) != 1)) {
+      return false;
+    }
+  }
+
+  return use_output(output, input1, input2, memory_format);
+}
+
+template <typename Create, typename Setup>
+Tensor binary(
+    const Tensor& input1,
+    const Tensor& input2,
+    const Tensor& output,
+    const float output_min,
+    const float output_max,
+    const Create create,
+    const Setup setup,
+    const char* const name) {
+  // A call to binary must have been gated by a call to use_binary, so the
+  // parameters are guaranteed to be valid at this point.
+
+  const MemoryFormat memory_format = input1.suggest_memory_format();
+
+  const Tensor input1_padded_contig =
+      mobile::allocate_padded_contiguous_if_needed(input1, memory_format);
+  const Tensor input2_padded_contig =
+      mobile::allocate_padded_contiguous_if_needed(input2, memory_format);
+
+  const Tensor output_contig = output.defined() ?
+      output :
+      mobile::empty_with_tail_padding(
+          infer_size(input1.sizes(), input2.sizes()),
+          input1.options().dtype(),
+          memory_format,
+          {});
+
+  const std::vector<size_t> input1_shape =
+      memory_shape(input1_padded_contig, memory_format);
+  const std::vector<size_t> input2_shape =
+      memory_shape(input2_padded_contig, memory_format);
+
+  xnn_operator_t binary_op{};
+
+  const xnn_status create_status = create(
+      output_min,                                     // output_min
+      output_max,                                     // output_max
+      0u,                                             // flags
+      &binary_op);                                    // operator
+
+  Operator binary_scoped_op(binary_op);
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_", name, "_nd_f32 failed!");
+
+  const xnn_status setup_status = setup(
+      binary_op,                                      // operator
+      input1_shape.size(),                            // num_input1_dims
+      input1_shape.data(),                            // input1_shape
+      input2_shape.size(),                            // num_input2_dims
+      input2_shape.data(),                            // input2_shape
+      input1_padded_contig.data_ptr<float>(),         // input1
+      input2_padded_contig.data_ptr<float>(),         // input2
+      output_contig.data_ptr<float>(),                // output
+      caffe2::pthreadpool_());                        // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_", name, "_nd_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      binary_op,                                      // operator
+      caffe2::pthreadpool_());                        // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output_contig;
+}
+
+} // namespace
+
+bool use_add(
+    const Tensor& input1,
+    const Tensor& input2,
+    const Tensor& output) {
+  return use_binary(input1, input2, output);
+}
+
+Tensor add(
+    const Tensor& input1,
+    const Tensor& input2,
+    const Tensor& output,
+    const float output_min,
+    const float output_max) {
+  return binary(
+      input1,
+      input2,
+      output,
+      output_min,
+      output_max,
+      xnn_create_add_nd_f32,
+      xnn_setup_add_nd_f32,
+      "add");
+}
+
+bool use_multiply(
+    const Tensor& input1,
+    const Tensor& input2,
+    const Tensor& output) {
+  return use_binary(input1, input2, output);
+}
+
+Tensor multiply(
+    const Tensor& input1,
+    const Tensor& input2,
+    const Tensor& output,
+    const float output_min,
+    const float output_max) {
+  return binary(
+      input1,
+      input2,
+      output,
+      output_min,
+      output_max,
+      xnn_create_multiply_nd_f32,
+      xnn_setup_multiply_nd_f32,
+      "multiply");
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
@@ -0,0 +1,100 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/xnnpack/Engine.h>
+#include <ATen/native/utils/Factory.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+
+bool use_global_average_pool(const Tensor& input) {
+  using namespace internal;
+
+  // Here are the list of conditions required for this code path to be taken:
+  // * Input must be 4D CPU float tensor with no gradients and
+  //   and all dimensions must be positive.
+  // * Input must be NHWC contiguous, since XNNPACK reduces the pixels of each
+  //   channel and NCHW inputs would need to be transposed first.
+  return xnnpack::internal::available() &&
+      (4 == input.dim()) &&
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      (input.size(Layout::Activation4D::batch) > 0) &&
+      (input.size(Layout::Activation4D::channels) > 0) &&
+      (input.size(Layout::Activation4D::height) > 0) &&
+      (input.size(Layout::Activation4D::width) > 0) &&
+      input.is_contiguous(MemoryFormat::ChannelsLast) &&
+      !input.requires_grad() &&
+      true;
+}
+
+Tensor global_average_pool(const Tensor& input) {
+  using namespace internal;
+
+  // A call to global_average_pool must have been gated by a call to
+  // use_global_average_pool, so the parameters are guaranteed to be valid at
+  // this point.
+
+  const Tensor input_padded_contig_nhwc =
+      mobile::allocate_padded_contiguous_if_needed(
+          input,
+          MemoryFormat::ChannelsLast);
+
+  Tensor output_padded_contig_nhwc = mobile::empty_with_tail_padding(
+      {
+        input_padded_contig_nhwc.size(Layout::Activation4D::batch),
+        input_padded_contig_nhwc.size(Layout::Activation4D::channels),
+        1,
+        1,
+      },
+      input_padded_contig_nhwc.options().dtype(),
+      MemoryFormat::ChannelsLast,
+      input_padded_contig_nhwc.names());
+
+  xnn_operator_t global_average_pooling_op{};
+
+  const xnn_status create_status = xnn_create_global_average_pooling_nwc_f32(
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // channels
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // input_stride - NHWC Contiguous
+      output_padded_contig_nhwc.size(Layout::Activation4D::channels), // output_stride - NHWC Contiguous
+      -std::numeric_limits<float>::infinity(),                        // output_min
+      +std::numeric_limits<float>::infinity(),                        // output_max
+      0u,                                                             // flags
+      &global_average_pooling_op);                                    // operator
+
+  Operator global_average_pooling_scoped_op(global_average_pooling_op);
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_global_average_pooling_nwc_f32 failed!");
+
+  const xnn_status setup_status = xnn_setup_global_average_pooling_nwc_f32(
+      global_average_pooling_op,                                      // operator
+      input_padded_contig_nhwc.size(Layout::Activation4D::batch),     // batch_size
+      input_padded_contig_nhwc.size(Layout::Activation4D::height) *
+          input_padded_contig_nhwc.size(Layout::Activation4D::width), // width
+      input_padded_contig_nhwc.data_ptr<float>(),                     // input
+      output_padded_contig_nhwc.data_ptr<float>(),                    // output
+      caffe2::pthreadpool_());                                        // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_global_average_pooling_nwc_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      global_average_pooling_op,  // operator
+      caffe2::pthreadpool_());    // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output_padded_contig_nhwc;
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
@@ -79,6 +79,77 @@ Tensor channel_shuffle(
     const Tensor& input,
     const int64_t groups);
 
+//
+// Activations
+//
+
+bool use_hardswish(const Tensor& input);
+
+Tensor hardswish(const Tensor& input);
+
+bool use_hardswish_(const Tensor& input);
+
+Tensor& hardswish_(Tensor& input);
+
+bool use_sigmoid(const Tensor& input);
+
+Tensor sigmoid(const Tensor& input);
+
+//
+// Global Average Pooling
+//
+
+bool use_global_average_pool(const Tensor& input);
+
+Tensor global_average_pool(const Tensor& input);
+
+//
+// Elementwise Arithmetic
+//
+// The output may be undefined, in which case it is allocated, or else is
+// written in place and returned.
+//
+
+bool use_add(
+    const Tensor& input1,
+    const Tensor& input2,
+    const Tensor& output);
+
+Tensor add(
+    const Tensor& input1,
+    const Tensor& input2,
+    const Tensor& output,
+    float output_min = -std::numeric_limits<float>::infinity(),
+    float output_max = +std::numeric_limits<float>::infinity());
+
+bool use_multiply(
+    const Tensor& input1,
+    const Tensor& input2,
+    const Tensor& output);
+
+Tensor multiply(
+    const Tensor& input1,
+    const Tensor& input2,
+    const Tensor& output,
+    float output_min = -std::numeric_limits<float>::infinity(),
+    float output_max = +std::numeric_limits<float>::infinity());
+
+//
+// Bilinear Upsampling
+//
+
+bool use_upsample_bilinear2d(
+    const Tensor& input,
+    IntArrayRef output_size,
+    bool align_corners,
+    c10::optional<double> scales_h,
+    c10::optional<double> scales_w);
+
+Tensor upsample_bilinear2d(
+    const Tensor& input,
+    IntArrayRef output_size,
+    bool align_corners);
+
 } // namespace xnnpack
 } // namespace native
 } // namespace at
@@ -0,0 +1,134 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/xnnpack/Engine.h>
+#include <ATen/native/utils/Factory.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+namespace {
+
+// XNNPACK derives the scale from the input and output sizes, which matches
+// ATen only if the scale, when given, is the ratio of the two.
+bool use_scale(
+    const int64_t input_size,
+    const int64_t output_size,
+    const c10::optional<double> scale) {
+  return !scale ||
+      (static_cast<double>(input_size) * *scale == static_cast<double>(output_size));
+}
+
+} // namespace
+
+bool use_upsample_bilinear2d(
+    const Tensor& input,
+    const IntArrayRef output_size,
+    const bool align_corners,
+    const c10::optional<double> scales_h,
+    const c10::optional<double> scales_w) {
+  using namespace internal;
+
+  // Here are the list of conditions required for this code path to be taken:
+  // * Input must be 4D CPU float tensor with no gradients and
+  //   and all dimensions must be positive.
+  // * Input must be NHWC contiguous, as XNNPACK interpolates pixels of
+  //   contiguous channels.
+  // * Output size must be 2D and positive, and unless the corners are aligned,
+  //   in which case ATen ignores them, the scales if any must be the ratios of
+  //   the output to the input sizes.
+  return xnnpack::internal::available() &&
+      // Input
+      (4 == input.dim()) &&
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      (input.size(Layout::Activation4D::batch) > 0) &&
+      (input.size(Layout::Activation4D::channels) > 0) &&
+      (input.size(Layout::Activation4D::height) > 0) &&
+      (input.size(Layout::Activation4D::width) > 0) &&
+      input.is_contiguous(MemoryFormat::ChannelsLast) &&
+      !input.requires_grad() &&
+      // Output
+      (2 == output_size.size()) &&
+      (output_size[0] > 0) &&
+      (output_size[1] > 0) &&
+      (align_corners ||
+          (use_scale(input.size(Layout::Activation4D::height), output_size[0], scales_h) &&
+           use_scale(input.size(Layout::Activation4D::width), output_size[1], scales_w))) &&
+      true;
+}
+
+Tensor upsample_bilinear2d(
+    const Tensor& input,
+    const IntArrayRef output_size,
+    const bool align_corners) {
+  using namespace internal;
+
+  // A call to upsample_bilinear2d must have been gated by a call to
+  // use_upsample_bilinear2d, so the parameters are guaranteed to be valid at
+  // this point.
+
+  const Tensor input_padded_contig_nhwc =
+      mobile::allocate_padded_contiguous_if_needed(
+          input,
+          MemoryFormat::ChannelsLast);
+
+  Tensor output_padded_contig_nhwc = mobile::empty_with_tail_padding(
+      {
+        input_padded_contig_nhwc.size(Layout::Activation4D::batch),
+        input_padded_contig_nhwc.size(Layout::Activation4D::channels),
+        output_size[0],
+        output_size[1],
+      },
+      input_padded_contig_nhwc.options().dtype(),
+      MemoryFormat::ChannelsLast,
+      input_padded_contig_nhwc.names());
+
+  xnn_operator_t resize_op{};
+
+  // Without flags, XNNPACK samples at the pixel centers, which is what ATen
+  // does with align_corners=False.
+  const xnn_status create_status = xnn_create_resize_bilinear2d_nhwc_f32(
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // channels
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // input_pixel_stride - NHWC Contiguous
+      output_padded_contig_nhwc.size(Layout::Activation4D::channels), // output_pixel_stride - NHWC Contiguous
+      align_corners ? XNN_FLAG_ALIGN_CORNERS : 0u,                    // flags
+      &resize_op);                                                    // operator
+
+  Operator resize_scoped_op(resize_op);
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_resize_bilinear2d_nhwc_f32 failed!");
+
+  const xnn_status setup_status = xnn_setup_resize_bilinear2d_nhwc_f32(
+      resize_op,                                                      // operator
+      input_padded_contig_nhwc.size(Layout::Activation4D::batch),     // batch_size
+      input_padded_contig_nhwc.size(Layout::Activation4D::height),    // input_height
+      input_padded_contig_nhwc.size(Layout::Activation4D::width),     // input_width
+      output_padded_contig_nhwc.size(Layout::Activation4D::height),   // output_height
+      output_padded_contig_nhwc.size(Layout::Activation4D::width),    // output_width
+      input_padded_contig_nhwc.data_ptr<float>(),                     // input
+      output_padded_contig_nhwc.data_ptr<float>(),                    // output
+      caffe2::pthreadpool_());                                        // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_resize_bilinear2d_nhwc_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      resize_op,                // operator
+      caffe2::pthreadpool_());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output_padded_contig_nhwc;
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
@@ -254,7 +254,7 @@ class TORCH_API Tensor {
       bool channels_last_strides_exact_match = false) const {
     // Setting channels_last_strides_exact_match to true forces function to
     // check 0,1 - sized dimension strides.
-    if (!is_mkldnn() && !is_sparse()) {
+    if (!is_mkldnn() && !is_sparse() && !is_sparse_csr()) {
       if (impl_->is_strides_like_channels_last()) {
         if (!channels_last_strides_exact_match ||
             get_channels_last_strides_2d(sizes()) == strides()) {
@@ -355,6 +355,9 @@ class TORCH_API Tensor {
   /// Returns if a `Tensor` has sparse backend.
   bool is_sparse() const;
 
+  /// Returns if a `Tensor` has the sparse CSR layout.
+  bool is_sparse_csr() const;
+
   /// Returns if a `Tensor` is mkldnn tensor.
   bool is_mkldnn() const;
 
@@ -518,3 +518,32 @@ TEST(DictTest, dictEquality) {
   EXPECT_FALSE(dict.is(dictSameValue));
   EXPECT_TRUE(dict.is(dictRef));
 }
+
+TEST(DictTest, givenStringKeys_whenGrowing_thenFindsAllKeys) {
+  // small dicts with string keys are searched linearly, larger ones through
+  // the hash table
+  Dict<string, int64_t> dict;
+  for (int64_t i = 0; i < 20; ++i) {
+    dict.insert("key" + c10::guts::to_string(i), i);
+    for (int64_t j = 0; j <= i; ++j) {
+      const string key = "key" + c10::guts::to_string(j);
+      EXPECT_TRUE(dict.contains(key));
+      EXPECT_EQ(j, dict.at(key));
+      EXPECT_EQ(j, dict.find(key)->value());
+    }
+    EXPECT_FALSE(dict.contains("key" + c10::guts::to_string(i + 1)));
+    EXPECT_THROW(dict.at("key"), std::out_of_range);
+  }
+}
+
+TEST(DictTest, givenStringKeys_whenKeyIsSharedWithGenericDict_thenFindsKey) {
+  c10::impl::GenericDict dict(c10::StringType::get(), c10::IntType::get());
+  c10::IValue key("key");
+  dict.insert(key, 1);
+  dict.insert(c10::IValue("other"), 2);
+  // the same string, and an equal one
+  EXPECT_EQ(1, dict.at(key).toInt());
+  EXPECT_EQ(1, dict.at(c10::IValue("key")).toInt());
+  EXPECT_EQ(dict.end(), dict.find(c10::IValue("none")));
+  EXPECT_EQ(std::hash<string>()("key"), key.toString()->hash());
+}
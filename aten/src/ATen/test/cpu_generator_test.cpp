@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 #include <ATen/Utils.h>
 #include <ATen/CPUGeneratorImpl.h>
 #include <ATen/core/PhiloxRNGEngine.h>
@@ -233,3 +234,89 @@ TEST(CPUGeneratorImpl, TestMT19937EngineReproducibility) {
   }
   
 }
+
+/**
+ * Counter-based CPU Generator Tests
+ */
+
+TEST(CPUGeneratorImpl, TestCounterBasedThreadIndependence) {
+  // Test Description:
+  //   Tests that the counter-based distributions give the same results
+  //   whatever the number of threads filling the tensor.
+  auto run = [](int num_threads) {
+    at::set_num_threads(num_threads);
+    auto gen = at::detail::createCPUGenerator(123);
+    {
+      std::lock_guard<std::mutex> lock(gen.mutex());
+      gen.get<CPUGeneratorImpl>()->set_counter_based(true);
+    }
+    auto uniform = at::empty({100003}).uniform_(0, 1, gen);
+    auto normal = at::empty({100003}, at::kDouble).normal_(0, 1, gen);
+    auto bernoulli = at::empty({100003}).bernoulli_(0.3, gen);
+    return std::make_tuple(uniform, normal, bernoulli);
+  };
+  const auto num_threads = at::get_num_threads();
+  auto one = run(1);
+  auto many = run(4);
+  at::set_num_threads(num_threads);
+  ASSERT_TRUE(at::equal(std::get<0>(one), std::get<0>(many)));
+  ASSERT_TRUE(at::equal(std::get<1>(one), std::get<1>(many)));
+  ASSERT_TRUE(at::equal(std::get<2>(one), std::get<2>(many)));
+
+  auto& uniform = std::get<0>(one);
+  ASSERT_GE(uniform.min().item<float>(), 0);
+  ASSERT_LT(uniform.max().item<float>(), 1);
+  ASSERT_NEAR(uniform.mean().item<float>(), 0.5, 0.01);
+  ASSERT_NEAR(std::get<1>(one).mean().item<double>(), 0, 0.02);
+  ASSERT_NEAR(std::get<1>(one).std().item<double>(), 1, 0.02);
+  ASSERT_NEAR(std::get<2>(one).mean().item<float>(), 0.3, 0.01);
+}
+
+TEST(CPUGeneratorImpl, TestCounterBasedMatchesPhiloxEngine) {
+  // Test Description:
+  //   Tests that the float uniform numbers are the ones of the Philox engine,
+  //   the first call starting at offset 0.
+  auto gen = at::detail::createCPUGenerator(2147483647);
+  gen.get<CPUGeneratorImpl>()->set_counter_based(true);
+  auto uniform = at::empty({1001}).uniform_(0, 1, gen);
+  auto accessor = uniform.accessor<float, 1>();
+  at::philox_engine engine(2147483647);
+  for (int64_t i = 0; i < uniform.numel(); i++) {
+    ASSERT_EQ(accessor[i], static_cast<float>(engine() >> 8) / (1 << 24));
+  }
+}
+
+TEST(CPUGeneratorImpl, TestCounterBasedNonContiguous) {
+  // Test Description:
+  //   Tests that a strided tensor gets the values of its contiguous copy.
+  auto gen1 = at::detail::createCPUGenerator(42);
+  auto gen2 = at::detail::createCPUGenerator(42);
+  gen1.get<CPUGeneratorImpl>()->set_counter_based(true);
+  gen2.get<CPUGeneratorImpl>()->set_counter_based(true);
+  auto strided = at::empty({64, 32}).t().uniform_(0, 1, gen1);
+  auto contiguous = at::empty({32, 64}).uniform_(0, 1, gen2);
+  ASSERT_TRUE(at::equal(strided, contiguous));
+}
+
+TEST(CPUGeneratorImpl, TestCounterBasedGetSetState) {
+  // Test Description:
+  //   Tests that the state restores the mode and the Philox offset, and that
+  //   the state of a generator in the default mode is left unchanged.
+  auto gen = at::detail::createCPUGenerator(7);
+  const auto default_state_size = gen.get_state().numel();
+  gen.get<CPUGeneratorImpl>()->set_counter_based(true);
+  at::empty({1000}).uniform_(0, 1, gen);
+  auto state = gen.get_state();
+  ASSERT_GT(state.numel(), default_state_size);
+  auto expected = at::empty({1000}).uniform_(0, 1, gen);
+
+  auto other = at::detail::createCPUGenerator();
+  other.set_state(state);
+  ASSERT_TRUE(other.get<CPUGeneratorImpl>()->is_counter_based());
+  ASSERT_TRUE(at::equal(at::empty({1000}).uniform_(0, 1, other), expected));
+
+  gen.get<CPUGeneratorImpl>()->set_counter_based(false);
+  ASSERT_EQ(gen.get_state().numel(), default_state_size);
+  other.set_state(gen.get_state());
+  ASSERT_FALSE(other.get<CPUGeneratorImpl>()->is_counter_based());
+}
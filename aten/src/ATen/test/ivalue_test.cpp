@@ -1,6 +1,7 @@
 #include <ATen/ATen.h>
 #include <gtest/gtest.h>
 #include <torch/torch.h>
+#include <c10/core/thread_pool.h>
 #include <c10/util/intrusive_ptr.h>
 #include <ATen/core/Dict.h>
 
@@ -308,6 +309,22 @@ TEST(IValueTest, FutureExceptions) {
   ASSERT_EQ(f3->tryRetrieveErrorMessage(), std::string("My Error"));
 }
 
+TEST(IValueTest, FutureWaitInThreadPool) {
+  // The only worker of the pool runs the task completing the future while
+  // waiting on it
+  c10::ThreadPool pool(1);
+  pool.setHelpWhileWaiting(true);
+  std::atomic<bool> done{false};
+  pool.run([&pool, &done]() {
+    auto f = c10::make_intrusive<ivalue::Future>(IntType::get());
+    pool.run([f]() { f->markCompleted(IValue(42)); });
+    f->wait();
+    done = f->value().toInt() == 42;
+  });
+  pool.waitWorkComplete();
+  ASSERT_TRUE(done);
+}
+
 TEST(IValueTest, ValueEquality) {
   EXPECT_EQ(IValue("asdf"), IValue("asdf"));
   EXPECT_NE(IValue("asdf"), IValue("ASDF"));
@@ -210,3 +210,69 @@ TEST(TensorIteratorTest, FailNonPromotingBinaryOp) {
   config.add_input(at::ones({1,1}, at::dtype(at::kInt)));
   ASSERT_ANY_THROW(config.build());
 }
+
+// The iterators built from the cache should match the ones built from
+// scratch, and only the data pointers should differ.
+TEST(TensorIteratorTest, Cache) {
+  at::globalContext().setTensorIteratorCache(true);
+  at::reset_tensor_iterator_cache();
+  auto check = [](const Tensor& a, const Tensor& b) {
+    // with the same geometry as a, the copy itself goes through an iterator
+    auto a_copy = a.clone(at::MemoryFormat::Preserve);
+    const auto before = at::get_tensor_iterator_cache_stats();
+    Tensor out1, out2;
+    auto iter1 = TensorIterator::binary_op(out1, a, b);
+    auto iter2 = TensorIterator::binary_op(out2, a_copy, b);
+    const auto after = at::get_tensor_iterator_cache_stats();
+    EXPECT_EQ(after.misses - before.misses, 1u);
+    EXPECT_EQ(after.hits - before.hits, 1u);
+    EXPECT_EQ(iter1.shape(), iter2.shape());
+    for (int i = 0; i < iter1.ntensors(); i++) {
+      EXPECT_EQ(iter1.strides(i), iter2.strides(i));
+      EXPECT_EQ(iter1.dtype(i), iter2.dtype(i));
+    }
+    EXPECT_NE(iter1.data_ptr(0), iter2.data_ptr(0));
+    EXPECT_NE(iter1.data_ptr(1), iter2.data_ptr(1));
+    EXPECT_EQ(out1.sizes(), out2.sizes());
+    EXPECT_EQ(out1.strides(), out2.strides());
+  };
+  auto a = at::randn({4, 1, 3});
+  auto b = at::randn({5, 1});
+  check(a, b);
+  check(a.permute({2, 0, 1}), b);
+  check(at::randn({2, 3}).t(), at::randn({3, 2}));
+
+  // a different geometry or aliasing is another entry, and the iterators
+  // with temporaries of the common dtype aren't cached
+  auto c = a.clone();
+  auto b_t = b.t();
+  auto out_long = at::empty({4, 1, 3}, at::kLong);
+  const auto before = at::get_tensor_iterator_cache_stats();
+  Tensor out;
+  TensorIterator::binary_op(out, a, b_t);
+  TensorIterator::binary_op(c, c, a);
+  for (int i = 0; i < 2; i++) {
+    at::TensorIteratorConfig()
+        .check_all_same_dtype(false)
+        .cast_common_dtype_to_outputs(true)
+        .add_output(out_long)
+        .add_input(a)
+        .build();
+  }
+  EXPECT_EQ(at::get_tensor_iterator_cache_stats().misses - before.misses, 4u);
+  EXPECT_EQ(at::get_tensor_iterator_cache_stats().hits, before.hits);
+
+  // the ops built from the cache compute the same values
+  auto x = at::randn({8, 8});
+  auto y = at::randn({8});
+  auto expected = x + y;
+  EXPECT_TRUE(at::equal(x + y, expected));
+  EXPECT_TRUE(at::equal(x.add(y), expected));
+  EXPECT_TRUE(at::equal(x.t().contiguous().t() + y, expected));
+
+  at::globalContext().setTensorIteratorCache(false);
+  at::reset_tensor_iterator_cache();
+  TensorIterator::binary_op(out, a, b);
+  EXPECT_EQ(at::get_tensor_iterator_cache_stats().hits, 0u);
+  EXPECT_EQ(at::get_tensor_iterator_cache_stats().misses, 0u);
+}
@@ -4,6 +4,7 @@
 #include <ATen/DLConvertor.h>
 #include <ATen/Parallel.h>
 
+#include <atomic>
 #include <iostream>
 #include <string.h>
 #include <sstream>
@@ -36,6 +37,29 @@ TEST(TestParallel, NestedParallel) {
   });
 }
 
+TEST(TestParallel, NestedParallelFor) {
+  // every index of the inner loops must be visited exactly once, whether the
+  // inner parallel_for runs inline or is split across threads
+  const int64_t outer = 64;
+  const int64_t inner = 256;
+  std::vector<std::atomic<int>> visits(outer * inner);
+  for (auto& v : visits) {
+    v = 0;
+  }
+  at::parallel_for(0, outer, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      at::parallel_for(0, inner, 1, [&](int64_t inner_begin, int64_t inner_end) {
+        for (int64_t j = inner_begin; j < inner_end; ++j) {
+          visits[i * inner + j]++;
+        }
+      });
+    }
+  });
+  for (auto& v : visits) {
+    ASSERT_EQ(v, 1);
+  }
+}
+
 TEST(TestParallel, Exceptions) {
   // parallel case
   ASSERT_THROW(
@@ -69,3 +93,35 @@ TEST(TestParallel, IntraOpLaunchFuture) {
 
   ASSERT_TRUE(v1 == 1 && v2 == 2);
 }
+
+TEST(TestParallel, ParallelStats) {
+  at::set_parallel_stats_enabled(true);
+  ASSERT_TRUE(at::parallel_stats_enabled());
+  at::parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) {});
+  at::parallel_for(0, 10, 1, [&](int64_t begin, int64_t end) {
+    // Counted as a fallback when the backend can't nest parallel regions
+    at::parallel_for(0, 10, 1, [&](int64_t inner_begin, int64_t inner_end) {});
+  });
+  auto stats = at::get_parallel_stats();
+  if (at::get_num_threads() > 1) {
+    ASSERT_GE(stats.parallel_regions, 2);
+    ASSERT_GE(stats.chunks, stats.parallel_regions);
+    uint64_t regions = 0;
+    for (auto count : stats.imbalance_histogram) {
+      regions += count;
+    }
+    ASSERT_EQ(regions, stats.parallel_regions);
+  }
+  for (const auto& pool : stats.pools) {
+    ASSERT_EQ(pool.second.busy_ns.size(), pool.second.idle_ns.size());
+  }
+
+  at::reset_parallel_stats();
+  stats = at::get_parallel_stats();
+  ASSERT_EQ(stats.parallel_regions, 0);
+  ASSERT_EQ(stats.nested_fallbacks, 0);
+
+  at::set_parallel_stats_enabled(false);
+  at::parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) {});
+  ASSERT_EQ(at::get_parallel_stats().parallel_regions, 0);
+}
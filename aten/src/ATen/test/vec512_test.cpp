@@ -0,0 +1,124 @@
+#include <ATen/cpu/vec512/functional.h>
+#include <c10/util/BFloat16.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Tests of at::vec, which is Vec512 in the AVX512 build of this test and
+// Vec256 in the others.
+
+namespace {
+
+using namespace at;
+
+template <typename T>
+class VectorizedTest : public ::testing::Test {};
+using VectorizedTestedTypes = ::testing::Types<float, double, c10::BFloat16>;
+TYPED_TEST_CASE(VectorizedTest, VectorizedTestedTypes);
+
+template <typename T>
+bool same(T a, T b) {
+  float fa = static_cast<float>(a);
+  float fb = static_cast<float>(b);
+  return (std::isnan(fa) && std::isnan(fb)) || fa == fb;
+}
+
+template <typename T>
+std::vector<T> random_values(int64_t n, int seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> dist(-4.f, 4.f);
+  std::vector<T> values(n);
+  for (auto& v : values) {
+    v = static_cast<T>(dist(gen));
+  }
+  return values;
+}
+
+TYPED_TEST(VectorizedTest, LoadStoreTails) {
+  using T = TypeParam;
+  using Vec = vec::Vectorized<T>;
+  const auto a = random_values<T>(Vec::size(), 0);
+  for (int64_t count = 0; count <= Vec::size(); ++count) {
+    std::vector<T> out(Vec::size(), T(7));
+    Vec::loadu(a.data(), count).store(out.data(), count);
+    for (int64_t i = 0; i < Vec::size(); ++i) {
+      ASSERT_TRUE(same(out[i], i < count ? a[i] : T(7))) << "count " << count;
+    }
+  }
+}
+
+TYPED_TEST(VectorizedTest, SetAndBlend) {
+  using T = TypeParam;
+  using Vec = vec::Vectorized<T>;
+  const auto a = random_values<T>(Vec::size(), 1);
+  const auto b = random_values<T>(Vec::size(), 2);
+  std::vector<T> out(Vec::size());
+  for (int64_t count = 0; count <= Vec::size(); ++count) {
+    Vec::set(Vec::loadu(a.data()), Vec::loadu(b.data()), count).store(out.data());
+    for (int64_t i = 0; i < Vec::size(); ++i) {
+      ASSERT_TRUE(same(out[i], i < count ? b[i] : a[i])) << "count " << count;
+    }
+  }
+  Vec::template blend<0x5>(Vec::loadu(a.data()), Vec::loadu(b.data())).store(out.data());
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_TRUE(same(out[i], (i == 0 || i == 2) ? b[i] : a[i]));
+  }
+}
+
+TYPED_TEST(VectorizedTest, MaximumPropagatesNaN) {
+  using T = TypeParam;
+  using Vec = vec::Vectorized<T>;
+  auto a = random_values<T>(Vec::size(), 3);
+  const auto b = random_values<T>(Vec::size(), 4);
+  a[1] = static_cast<T>(std::numeric_limits<float>::quiet_NaN());
+  std::vector<T> out(Vec::size());
+  vec::maximum(Vec::loadu(a.data()), Vec::loadu(b.data())).store(out.data());
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    const float ref = i == 1 ? static_cast<float>(a[i])
+                             : std::max(static_cast<float>(a[i]), static_cast<float>(b[i]));
+    ASSERT_TRUE(same(out[i], static_cast<T>(ref)));
+  }
+}
+
+TYPED_TEST(VectorizedTest, Arithmetic) {
+  using T = TypeParam;
+  using Vec = vec::Vectorized<T>;
+  const int64_t n = 3 * Vec::size() + 5;
+  const auto a = random_values<T>(n, 5);
+  const auto b = random_values<T>(n, 6);
+  std::vector<T> out(n);
+  vec::map2([](Vec x, Vec y) { return x * y + x; }, out.data(), a.data(), b.data(), n);
+  for (int64_t i = 0; i < n; ++i) {
+    // the vectors of BFloat16 round to bfloat16 after every operation, like
+    // the scalars do
+    const T ref = a[i] * b[i] + a[i];
+    ASSERT_TRUE(same(out[i], ref)) << "index " << i;
+  }
+}
+
+TYPED_TEST(VectorizedTest, ReduceAll) {
+  using T = TypeParam;
+  using Vec = vec::Vectorized<T>;
+  std::vector<T> values(3 * Vec::size() + 5);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<T>(static_cast<int>(i % 7) - 3);
+  }
+  for (int64_t n : {int64_t(1), int64_t(Vec::size() - 1), int64_t(Vec::size()),
+                    static_cast<int64_t>(values.size())}) {
+    float sum = 0;
+    float max = static_cast<float>(values[0]);
+    for (int64_t i = 0; i < n; ++i) {
+      sum += static_cast<float>(values[i]);
+      max = std::max(max, static_cast<float>(values[i]));
+    }
+    ASSERT_EQ(static_cast<float>(vec::reduce_all<T>(
+        [](Vec& x, Vec& y) { return x + y; }, values.data(), n)), sum);
+    ASSERT_EQ(static_cast<float>(vec::reduce_all<T>(
+        [](Vec& x, Vec& y) { return vec::maximum(x, y); }, values.data(), n)), max);
+  }
+}
+
+} // namespace
@@ -89,3 +89,27 @@ TEST(Vitals, OnAndOff) {
     }
   }
 }
+
+TEST(Vitals, SlowPathCounts) {
+  resetSlowPathCounts();
+  EXPECT_EQ(slowPathCount(SlowPath::NON_CONTIGUOUS_COPY), 0u);
+
+  auto t = at::ones({4, 4});
+  t.contiguous();
+  EXPECT_EQ(slowPathCount(SlowPath::NON_CONTIGUOUS_COPY), 0u);
+  t.t().contiguous();
+  EXPECT_EQ(slowPathCount(SlowPath::NON_CONTIGUOUS_COPY), 1u);
+
+  at::add(t, at::ones({4, 4}, at::kLong));
+  EXPECT_EQ(slowPathCount(SlowPath::TYPE_PROMOTION_COPY), 1u);
+  // scalars aren't counted
+  at::add(t, at::scalar_tensor(1, at::kLong));
+  EXPECT_EQ(slowPathCount(SlowPath::TYPE_PROMOTION_COPY), 1u);
+
+  auto counts = getSlowPathCounts();
+  EXPECT_EQ(counts.size(), kNumSlowPaths);
+  EXPECT_EQ(counts.at("non_contiguous_copy"), 1u);
+
+  resetSlowPathCounts();
+  EXPECT_EQ(slowPathCount(SlowPath::NON_CONTIGUOUS_COPY), 0u);
+}
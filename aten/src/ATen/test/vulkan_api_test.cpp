@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 #include <ATen/ATen.h>
+#include <ATen/native/vulkan/ops/Convolution.h>
 
 // TODO: These functions should move to a common place.
 
@@ -481,6 +482,67 @@ TEST(VulkanAPITest, conv2d_pw) {
   ASSERT_TRUE(check);
 }
 
+TEST(VulkanAPITest, conv2d_clamp_add) {
+  if (!at::is_vulkan_available()) {
+    return;
+  }
+
+  constexpr int64_t channels = 23;
+
+  // 3x3, pointwise and depthwise convolutions, each of which has a shader of
+  // its own adding the residual
+  const struct {
+    std::vector<int64_t> weights;
+    int64_t groups;
+    int64_t padding;
+  } convolutions[] = {
+    {{channels, channels, 3, 3}, 1, 1},
+    {{channels, channels, 1, 1}, 1, 0},
+    {{channels, 1, 3, 3}, channels, 1},
+  };
+
+  for (const auto& convolution : convolutions) {
+    const auto input_cpu = at::rand({1, channels, 31, 47}, at::device(at::kCPU).dtype(at::kFloat));
+    const auto weights_cpu = at::rand(convolution.weights, at::device(at::kCPU).dtype(at::kFloat));
+    const auto bias_cpu = at::rand({channels}, at::device(at::kCPU).dtype(at::kFloat));
+
+    const auto context = at::native::vulkan::ops::conv2d_clamp_prepack(
+        weights_cpu.clone(),
+        bias_cpu.clone(),
+        {1, 1},
+        {convolution.padding, convolution.padding},
+        {1, 1},
+        convolution.groups,
+        0.0,
+        c10::nullopt);
+
+    const auto conv_cpu = at::conv2d(
+        input_cpu,
+        weights_cpu,
+        bias_cpu,
+        {1, 1},
+        {convolution.padding, convolution.padding},
+        {1, 1},
+        convolution.groups);
+
+    const auto other_cpu = at::randn(conv_cpu.sizes(), at::device(at::kCPU).dtype(at::kFloat));
+    const auto output_cpu = at::relu(conv_cpu + other_cpu);
+
+    const auto output_vulkan = at::native::vulkan::ops::conv2d_clamp_add_run(
+        input_cpu.vulkan(),
+        other_cpu.vulkan(),
+        context);
+
+    const bool check = almostEqual(output_cpu, output_vulkan.cpu());
+    if (!check) {
+      std::cout << "Expected:\n" << output_cpu << std::endl;
+      std::cout << "Got:\n" << output_vulkan.cpu() << std::endl;
+    }
+
+    ASSERT_TRUE(check);
+  }
+}
+
 TEST(VulkanAPITest, copy) {
   if (!at::is_vulkan_available()) {
     return;
@@ -1,8 +1,11 @@
 #include <THC/THCCachingHostAllocator.h>
 #include <ATen/DeviceGuard.h>
 #include <ATen/detail/CUDAHooksInterface.h>
+#include <c10/util/llvmMathExtras.h>
 
 
+#include <algorithm>
+#include <array>
 #include <cuda_runtime_api.h>
 #include <deque>
 #include <memory>
@@ -10,75 +13,141 @@
 #include <stdint.h>
 #include <unordered_map>
 #include <unordered_set>
-#include <set>
 #include <utility>
+#include <vector>
 
 namespace {
 
-struct BlockSize
-{
-  size_t  size; // allocation size
-  void*   ptr;  // host memory pointer
+using c10::cuda::CUDACachingAllocator::Stat;
+
+// Note [Host allocator size classes]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Requests are rounded up to size classes, eight between consecutive powers
+// of two, so that at most 1/8 of the pinned memory of a block is unused. Each
+// size class has its own free list and lock, so that threads pinning memory
+// of different sizes, e.g. the data loader's pin memory threads, don't wait
+// for each other. Blocks are looked up by pointer in shards with their own
+// locks, which also guard the state of the blocks.
+//
+// The events recorded when a block used by streams is freed are queried
+// only when a size class has no free block, all of them at once, instead of
+// on every malloc and free.
+//
+// Locks are taken in the order: events, shard, size class.
+constexpr size_t kMinBlockSize = 512;
+constexpr unsigned kSizeClassBits = 3;
+constexpr size_t kNumSizeClasses = 64 << kSizeClassBits;
+constexpr unsigned kShardBits = 4;
+constexpr size_t kNumShards = 1 << kShardBits;
+
+// Returns the size class of size and sets class_size to its size
+size_t sizeClass(size_t size, size_t* class_size) {
+  size = std::max(size, kMinBlockSize);
+  unsigned log2 = llvm::Log2_64(size);
+  size_t step = (size_t)1 << (log2 - kSizeClassBits);
+  size_t rounded = (size + step - 1) & ~(step - 1);
+  // rounding up may reach the next power of two
+  log2 = llvm::Log2_64(rounded);
+  *class_size = rounded;
+  return (log2 << kSizeClassBits) +
+      ((rounded - ((size_t)1 << log2)) >> (log2 - kSizeClassBits));
+}
 
-  BlockSize(size_t size, void* ptr=NULL) : size(size), ptr(ptr) {}
-};
+void update_stat(Stat& stat, int64_t amount) {
+  stat.current += amount;
+  stat.peak = std::max(stat.current, stat.peak);
+  if (amount > 0) {
+    stat.allocated += amount;
+  }
+  if (amount < 0) {
+    stat.freed += -amount;
+  }
+}
 
-struct Block : public BlockSize
+void reset_accumulated_stat(Stat& stat) {
+  stat.allocated = 0;
+  stat.freed = 0;
+}
+
+void reset_peak_stat(Stat& stat) {
+  stat.peak = stat.current;
+}
+
+struct Block
 {
-  bool  allocated;    // true if the block is currently allocated
-  int   event_count;  // number of outstanding cuda events
+  size_t  size;         // allocation size, the size of the size class
+  void*   ptr;          // host memory pointer
+  size_t  size_class;
+  bool    allocated;    // true if the block is currently allocated
+  int     event_count;  // number of outstanding cuda events
   std::unordered_set<at::cuda::CUDAStream> streams;
 
-  Block(size_t size, void* ptr, bool allocated) :
-      BlockSize(size, ptr), allocated(allocated), event_count(0), streams() {}
+  Block(size_t size, void* ptr, size_t size_class) :
+      size(size), ptr(ptr), size_class(size_class), allocated(true),
+      event_count(0), streams() {}
 };
 
-static bool BlockComparator(const BlockSize& a, const BlockSize& b)
+struct BlockShard
 {
-  // sort by size, break ties with pointer
-  if (a.size != b.size) {
-    return a.size < b.size;
-  }
-  return (uintptr_t)a.ptr < (uintptr_t)b.ptr;
-}
+  std::mutex mutex;
+  // blocks by pointer
+  std::unordered_map<void*, Block*> blocks;
+};
 
-struct HostAllocator
+struct SizeClass
 {
-  typedef bool (*Comparison)(const BlockSize&, const BlockSize&);
-
-  // lock around all operations
   std::mutex mutex;
+  // blocks that are ready to be allocated (event_count=0), most recently
+  // freed last
+  std::vector<Block*> free_blocks;
+};
 
-  // blocks by pointer
-  std::unordered_map<void*, Block> blocks;
+struct HostAllocator
+{
+  std::array<SizeClass, kNumSizeClasses> size_classes;
 
-  // pointers that are ready to be allocated (event_count=0)
-  std::set<BlockSize, Comparison> available;
+  std::array<BlockShard, kNumShards> shards;
 
   // outstanding cuda events
-  std::deque<std::pair<cudaEvent_t, void*>> cuda_events;
+  std::mutex events_mutex;
+  std::deque<std::pair<cudaEvent_t, Block*>> cuda_events;
 
-  HostAllocator() : available(BlockComparator) {}
+  std::mutex stats_mutex;
+  THCCachingHostAllocatorStats stats;
 
-  cudaError_t malloc(void** ptr, size_t size)
+  BlockShard& shard(void* ptr)
   {
-    std::lock_guard<std::mutex> lock(mutex);
+    // pinned allocations are page aligned, so hash the pointer
+    uint64_t hash = (uint64_t)(uintptr_t)ptr * 0x9E3779B97F4A7C15ull;
+    return shards[hash >> (64 - kShardBits)];
+  }
 
-    // process outstanding cuda events which may have occurred
-    cudaError_t err = processEvents();
-    if (err != cudaSuccess) {
-      return err;
+  cudaError_t malloc(void** ptr, size_t size)
+  {
+    if (size == 0) {
+      *ptr = nullptr;
+      return cudaSuccess;
     }
 
-    // search for the smallest block which can hold this allocation
-    BlockSize search_key(size);
-    auto it = available.lower_bound(search_key);
-    if (it != available.end()) {
-      Block& block = blocks.at(it->ptr);
-      THAssert(!block.allocated && block.event_count == 0);
-      block.allocated = true;
-      *ptr = block.ptr;
-      available.erase(it);
+    size_t class_size;
+    size_t size_class = sizeClass(size, &class_size);
+    Block* block = popFreeBlock(size_class);
+    if (!block) {
+      // process outstanding cuda events which may have occurred
+      cudaError_t err = processEvents();
+      if (err != cudaSuccess) {
+        return err;
+      }
+      block = popFreeBlock(size_class);
+    }
+    if (block) {
+      {
+        std::lock_guard<std::mutex> lock(shard(block->ptr).mutex);
+        THAssert(!block->allocated && block->event_count == 0);
+        block->allocated = true;
+      }
+      updateStats(block->size, /*segment=*/false);
+      *ptr = block->ptr;
       return cudaSuccess;
     }
 
@@ -93,70 +162,79 @@ struct HostAllocator
       device_guard.reset_device(at::Device(at::DeviceType::CUDA, *primary_ctx_device_index));
     }
 
-    // note that cudaHostAlloc may not touch pointer if size is 0
-    *ptr = 0;
-
     // allocate a new block if no cached allocation is found
-    err = cudaHostAlloc(ptr, size, cudaHostAllocDefault);
+    *ptr = 0;
+    cudaError_t err = cudaHostAlloc(ptr, class_size, cudaHostAllocDefault);
     if (err != cudaSuccess) {
       return err;
     }
 
-    blocks.insert({*ptr, Block(size, *ptr, true)});
+    block = new Block(class_size, *ptr, size_class);
+    {
+      BlockShard& block_shard = shard(*ptr);
+      std::lock_guard<std::mutex> lock(block_shard.mutex);
+      block_shard.blocks.insert({*ptr, block});
+    }
+    updateStats(block->size, /*segment=*/true);
     return cudaSuccess;
   }
 
   cudaError_t free(void* ptr)
   {
-    std::lock_guard<std::mutex> lock(mutex);
-
     if (!ptr) {
       return cudaSuccess;
     }
 
-    // process outstanding cuda events which may have occurred
-    cudaError_t err = processEvents();
-    if (err != cudaSuccess) {
-      return err;
-    }
-
-    auto it = blocks.find(ptr);
-    THAssert(it != blocks.end());
+    Block* block;
+    std::vector<std::pair<cudaEvent_t, Block*>> events;
+    cudaError_t err;
+    {
+      BlockShard& block_shard = shard(ptr);
+      std::lock_guard<std::mutex> lock(block_shard.mutex);
+      auto it = block_shard.blocks.find(ptr);
+      THAssert(it != block_shard.blocks.end());
 
-    Block& block = it->second;
-    THAssert(block.allocated);
+      block = it->second;
+      THAssert(block->allocated);
 
-    // free (on valid memory) shouldn't fail, so mark unallocated before
-    // we process the streams.
-    block.allocated = false;
+      // free (on valid memory) shouldn't fail, so mark unallocated before
+      // we process the streams.
+      block->allocated = false;
 
-    // insert CUDA events for each stream on which this block was used. This
-    err = insertEvents(block);
-    if (err != cudaSuccess) {
-      return err;
+      // insert CUDA events for each stream on which this block was used.
+      err = insertEvents(*block, events);
+    }
+    {
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      update_stat(stats.allocation, -1);
+      update_stat(stats.allocated_bytes, -(int64_t)block->size);
     }
 
-    if (block.event_count == 0) {
+    if (!events.empty()) {
+      std::lock_guard<std::mutex> lock(events_mutex);
+      cuda_events.insert(cuda_events.end(), events.begin(), events.end());
+    } else if (err == cudaSuccess) {
       // the block can be re-used if there are no outstanding cuda events
-      available.insert(block);
+      pushFreeBlock(block);
     }
-    return cudaSuccess;
+    return err;
   }
 
   cudaError_t recordEvent(void* ptr, at::cuda::CUDAStream stream)
   {
-    std::lock_guard<std::mutex> lock(mutex);
+    BlockShard& block_shard = shard(ptr);
+    std::lock_guard<std::mutex> lock(block_shard.mutex);
 
-    auto it = blocks.find(ptr);
-    if (it == blocks.end()) {
+    auto it = block_shard.blocks.find(ptr);
+    if (it == block_shard.blocks.end()) {
       // ignore events for untracked pointers
       return cudaSuccess;
     }
 
-    Block& block = it->second;
-    THAssert(block.allocated);
+    Block* block = it->second;
+    THAssert(block->allocated);
 
-    block.streams.insert(stream);
+    block->streams.insert(stream);
     return cudaSuccess;
   }
 
@@ -164,67 +242,150 @@ struct HostAllocator
   {
     // Process outstanding cudaEvents. Events that are completed are removed
     // from the queue, and the 'event_count' for the corresponding allocation
-    // is decremented. Stops at the first event which has not been completed.
-    // Since events on different devices or streams may occur out of order,
-    // the processing of some events may be delayed.
-    while (!cuda_events.empty()) {
-      auto& e = cuda_events.front();
-      cudaEvent_t event = e.first;
-
-      cudaError_t err = cudaEventQuery(event);
+    // is decremented. Events on different devices or streams may occur out
+    // of order, so all of them are queried. A caller which finds another
+    // thread processing the events waits for it rather than allocating a new
+    // block, and the reclaimed blocks are freed before events_mutex is
+    // released, so that its next popFreeBlock finds them.
+    std::lock_guard<std::mutex> lock(events_mutex);
+
+    std::deque<std::pair<cudaEvent_t, Block*>> pending;
+    std::vector<Block*> ready;
+    cudaError_t err = cudaSuccess;
+    for (auto it = cuda_events.begin(); it != cuda_events.end(); ++it) {
+      err = cudaEventQuery(it->first);
       if (err == cudaErrorNotReady) {
-        break;
-      } else if (err != cudaSuccess) {
-        return err;
+        err = cudaSuccess;
+        pending.push_back(*it);
+        continue;
+      }
+      if (err == cudaSuccess) {
+        err = cudaEventDestroy(it->first);
       }
-      err = cudaEventDestroy(event);
       if (err != cudaSuccess) {
-        return err;
+        pending.insert(pending.end(), it, cuda_events.end());
+        break;
       }
 
-      Block& block = blocks.at(e.second);
-      block.event_count--;
-      if (block.event_count == 0 && !block.allocated) {
-        available.insert(block);
+      Block* block = it->second;
+      std::lock_guard<std::mutex> shard_lock(shard(block->ptr).mutex);
+      block->event_count--;
+      if (block->event_count == 0 && !block->allocated) {
+        ready.push_back(block);
       }
-      cuda_events.pop_front();
     }
-    return cudaSuccess;
+    cuda_events = std::move(pending);
+
+    for (Block* block : ready) {
+      pushFreeBlock(block);
+    }
+    return err;
   }
 
   void emptyCache()
   {
-    std::lock_guard<std::mutex> lock(mutex);
+    std::lock_guard<std::mutex> lock(events_mutex);
 
+    std::vector<Block*> freed;
     // remove events for freed blocks
-    for (auto it = cuda_events.begin(); it != cuda_events.end(); ++it) {
-      cudaEvent_t event = it->first;
-      Block& block = blocks.at(it->second);
-      if (!block.allocated) {
-        THCudaCheckWarn(cudaEventDestroy(event));
-        block.event_count--;
+    for (auto& e : cuda_events) {
+      THCudaCheckWarn(cudaEventDestroy(e.first));
+      Block* block = e.second;
+      std::lock_guard<std::mutex> shard_lock(shard(block->ptr).mutex);
+      block->event_count--;
+      if (block->event_count == 0) {
+        freed.push_back(block);
       }
     }
 
     // all cuda_events have been processed
     cuda_events.clear();
 
-    // clear list of available blocks
-    available.clear();
+    // clear the free lists
+    for (auto& size_class : size_classes) {
+      std::lock_guard<std::mutex> class_lock(size_class.mutex);
+      freed.insert(
+          freed.end(),
+          size_class.free_blocks.begin(),
+          size_class.free_blocks.end());
+      size_class.free_blocks.clear();
+    }
 
     // free and erase non-allocated blocks
-    for (auto it = blocks.begin(); it != blocks.end();) {
-      Block& block = it->second;
-      if (!block.allocated) {
-        THCudaCheckWarn(cudaFreeHost(block.ptr));
-        it = blocks.erase(it);
-      } else {
-        ++it;
+    for (Block* block : freed) {
+      {
+        BlockShard& block_shard = shard(block->ptr);
+        std::lock_guard<std::mutex> shard_lock(block_shard.mutex);
+        block_shard.blocks.erase(block->ptr);
       }
+      THCudaCheckWarn(cudaFreeHost(block->ptr));
+      {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex);
+        update_stat(stats.segment, -1);
+        update_stat(stats.reserved_bytes, -(int64_t)block->size);
+      }
+      delete block;
     }
   }
 
-  cudaError_t insertEvents(Block& block)
+  THCCachingHostAllocatorStats getStats()
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    return stats;
+  }
+
+  void resetAccumulatedStats()
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    reset_accumulated_stat(stats.allocation);
+    reset_accumulated_stat(stats.segment);
+    reset_accumulated_stat(stats.allocated_bytes);
+    reset_accumulated_stat(stats.reserved_bytes);
+  }
+
+  void resetPeakStats()
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    reset_peak_stat(stats.allocation);
+    reset_peak_stat(stats.segment);
+    reset_peak_stat(stats.allocated_bytes);
+    reset_peak_stat(stats.reserved_bytes);
+  }
+
+ private:
+  Block* popFreeBlock(size_t size_class)
+  {
+    SizeClass& free_list = size_classes[size_class];
+    std::lock_guard<std::mutex> lock(free_list.mutex);
+    if (free_list.free_blocks.empty()) {
+      return nullptr;
+    }
+    Block* block = free_list.free_blocks.back();
+    free_list.free_blocks.pop_back();
+    return block;
+  }
+
+  void pushFreeBlock(Block* block)
+  {
+    SizeClass& free_list = size_classes[block->size_class];
+    std::lock_guard<std::mutex> lock(free_list.mutex);
+    free_list.free_blocks.push_back(block);
+  }
+
+  void updateStats(size_t size, bool segment)
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    update_stat(stats.allocation, 1);
+    update_stat(stats.allocated_bytes, size);
+    if (segment) {
+      update_stat(stats.segment, 1);
+      update_stat(stats.reserved_bytes, size);
+    }
+  }
+
+  cudaError_t insertEvents(
+      Block& block,
+      std::vector<std::pair<cudaEvent_t, Block*>>& events)
   {
     cudaError_t err;
 
@@ -245,7 +406,7 @@ struct HostAllocator
       if (err != cudaSuccess) break;
 
       block.event_count++;
-      cuda_events.emplace_back(event, block.ptr);
+      events.emplace_back(event, &block);
     }
 
     cudaSetDevice(prev_device);
@@ -267,6 +428,21 @@ void THCCachingHostAllocator_emptyCache()
   allocator.emptyCache();
 }
 
+THCCachingHostAllocatorStats THCCachingHostAllocator_getStats()
+{
+  return allocator.getStats();
+}
+
+void THCCachingHostAllocator_resetAccumulatedStats()
+{
+  allocator.resetAccumulatedStats();
+}
+
+void THCCachingHostAllocator_resetPeakStats()
+{
+  allocator.resetPeakStats();
+}
+
 static void THCCachingHostDeleter(void* ptr) {
   allocator.free(ptr);
 }
@@ -4,6 +4,7 @@
 #include <THC/THCGeneral.h>
 
 
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/cuda/CUDAStream.h>
 
 //
@@ -19,7 +20,8 @@
 // copy_from_cpu_async_ and copy_to_cpu_async_.
 //
 // Note that this allocator does not split larger allocations into smaller
-// blocks, unlike the caching device allocator.
+// blocks, unlike the caching device allocator. Requests are rounded up to
+// size classes instead, see Note [Host allocator size classes].
 //
 TORCH_CUDA_CPP_API c10::Allocator* getTHCCachingHostAllocator(void);
 
@@ -31,4 +33,21 @@ THCCachingHostAllocator_recordEvent(void* ptr, at::cuda::CUDAStream stream);
 // Releases cached pinned memory allocations via cudaHostFree
 TORCH_CUDA_CPP_API void THCCachingHostAllocator_emptyCache(void);
 
+// Summary statistics of the allocator, with the same meaning as the ones of
+// the caching device allocator
+struct THCCachingHostAllocatorStats {
+  // COUNT: allocations requested by client code
+  c10::cuda::CUDACachingAllocator::Stat allocation;
+  // COUNT: number of allocated blocks from cudaHostAlloc()
+  c10::cuda::CUDACachingAllocator::Stat segment;
+  // SUM: bytes of the blocks allocated by client code
+  c10::cuda::CUDACachingAllocator::Stat allocated_bytes;
+  // SUM: bytes reserved by this allocator (both free and used)
+  c10::cuda::CUDACachingAllocator::Stat reserved_bytes;
+};
+
+TORCH_CUDA_CPP_API THCCachingHostAllocatorStats THCCachingHostAllocator_getStats(void);
+TORCH_CUDA_CPP_API void THCCachingHostAllocator_resetAccumulatedStats(void);
+TORCH_CUDA_CPP_API void THCCachingHostAllocator_resetPeakStats(void);
+
 #endif
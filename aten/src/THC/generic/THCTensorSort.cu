@@ -3,6 +3,7 @@
 #else
 
 #include <c10/cuda/CUDAException.h>
+#include <ATen/native/cuda/SegmentedSort.h>
 
 // In alignment with default sort on a c++ map, this function
 // will permute key and value tensors identically, and
@@ -323,6 +324,11 @@ void THCTensor_(sort)(THCState* state,
     // Sort using our in-place k/v kernel that supports arbitrary
     // layout
     THCTensor_(sortKeyValueInplace)(state, sorted, indices, dim, order);
+  } else if (at::native::can_use_radix_sort(THTensor_wrap(input), dim)) {
+    // Sort all the slices at once with a segmented radix sort
+    at::native::radix_sort_out_cuda(
+        THTensor_wrap(input), dim, (bool) order,
+        THTensor_wrap(sorted), THTensor_wrap(indices));
   } else {
     // Otherwise, fall back upon Thrust, which handles all other cases
     // (potentially slowly, with extra copies/memory allocations)
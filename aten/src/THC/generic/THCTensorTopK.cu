@@ -4,6 +4,7 @@
 
 #include <c10/macros/Macros.h>
 #include <c10/cuda/CUDAException.h>
+#include <ATen/native/cuda/SegmentedSort.h>
 
 void THCTensor_(topk)(THCState* state,
                       THCTensor *topK,
@@ -34,6 +35,21 @@ void THCTensor_(topk)(THCState* state,
   THCTensor_(resize)(state, topK, topKSize, {});
   THCudaLongTensor_resize(state, indices, topKSize, {});
 
+  // For a large k, sorting the whole slices with a segmented radix sort and
+  // keeping their first k elements is faster than selecting the k elements
+  // and then sorting them.
+  if (sorted && k > 2048 && 4 * k >= sliceSize &&
+      at::native::can_use_radix_sort(THTensor_wrap(input), dim)) {
+    at::Tensor input_t = THTensor_wrap(input);
+    at::Tensor sortedInput = at::empty_like(input_t);
+    at::Tensor sortedIndices = at::empty(input_t.sizes(), input_t.options().dtype(at::kLong));
+    at::native::radix_sort_out_cuda(input_t, dim, (bool) dir, sortedInput, sortedIndices);
+    THTensor_wrap(topK).copy_(sortedInput.narrow(dim, 0, k));
+    THTensor_wrap(indices).copy_(sortedIndices.narrow(dim, 0, k));
+    THCudaLongTensor_free(state, input);
+    return;
+  }
+
   // static_cast is required to ensure that the correct type (INDEX_T)
   // is provided to the kernel for the arguments.
 
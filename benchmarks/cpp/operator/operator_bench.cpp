@@ -0,0 +1,439 @@
+// Micro-benchmarks of every ATen operator, run from C++.
+//
+// A benchmark is registered for every operator of the dispatcher (that is,
+// every function of native_functions.yaml) and every combination of the
+// configured dtypes, shapes, memory formats and CPU thread counts. The inputs
+// are made from the schema of the operator: every Tensor argument is a tensor
+// of the benchmark's shape, dtype and memory format, and the other arguments
+// take their default values, or a value derived from the shape when they
+// have none. Operators whose arguments can't be made this way, or which fail
+// on the inputs, are reported as skipped.
+//
+// The operators are called through the boxed dispatcher API, without Python
+// or autograd in the way. Besides the time, each benchmark reports
+//   GB/s:     bytes of the tensor inputs and outputs per second
+//   GFLOP/s:  floating point operations per second, counting one per output
+//             element, except for the matrix products
+//   roofline: fraction of the roofline bound, given --peak_gbps and
+//             --peak_gflops for the machine
+//
+// Options, parsed before the Google Benchmark ones:
+//   --dtypes=float,double,bfloat16,half,int64,int32  (default: float)
+//   --shapes=small,large                              (default: small)
+//   --memory_formats=contiguous,channels_last         (default: both)
+//   --threads=1,4,...                                 (default: 1 and all)
+//   --peak_gbps=N --peak_gflops=N
+//   --include_private              also run the operators starting with _
+//
+// For example, to run the add overloads in float and bfloat16 on 1 thread:
+//   operator_bench --dtypes=float,bfloat16 --threads=1 \
+//       --benchmark_filter='aten::add\.'
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/dispatch/Dispatcher.h>
+#include <ATen/core/stack.h>
+#include <c10/core/InferenceMode.h>
+#include <c10/util/StringUtil.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+  std::vector<at::ScalarType> dtypes{at::kFloat};
+  std::vector<std::string> shapes{"small"};
+  std::vector<at::MemoryFormat> memory_formats{
+      at::MemoryFormat::Contiguous, at::MemoryFormat::ChannelsLast};
+  std::vector<int> threads;
+  double peak_gbps = 0;
+  double peak_gflops = 0;
+  bool include_private = false;
+};
+
+struct Config {
+  at::ScalarType dtype;
+  std::vector<int64_t> shape;
+  at::MemoryFormat memory_format;
+  int threads;
+};
+
+// Shape presets: one shape per rank, so that both the pointwise and the
+// reduction operators see the usual ranks, and the channels last variants
+// have a 4-d shape to work with.
+std::vector<std::vector<int64_t>> presetShapes(const std::string& preset) {
+  if (preset == "small") {
+    return {{4096}, {64, 64}, {8, 16, 16, 16}};
+  }
+  if (preset == "large") {
+    return {{1 << 22}, {1024, 1024}, {32, 64, 56, 56}};
+  }
+  TORCH_CHECK(false, "Unknown shape preset ", preset, ", expected small or large");
+}
+
+at::ScalarType parseDtype(const std::string& name) {
+  if (name == "float") {
+    return at::kFloat;
+  } else if (name == "double") {
+    return at::kDouble;
+  } else if (name == "bfloat16") {
+    return at::kBFloat16;
+  } else if (name == "half") {
+    return at::kHalf;
+  } else if (name == "int64") {
+    return at::kLong;
+  } else if (name == "int32") {
+    return at::kInt;
+  }
+  TORCH_CHECK(false, "Unknown dtype ", name);
+}
+
+at::MemoryFormat parseMemoryFormat(const std::string& name) {
+  if (name == "contiguous") {
+    return at::MemoryFormat::Contiguous;
+  } else if (name == "channels_last") {
+    return at::MemoryFormat::ChannelsLast;
+  }
+  TORCH_CHECK(false, "Unknown memory format ", name);
+}
+
+std::vector<std::string> split(const std::string& list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+// Removes the options of the benchmark from argv, leaving the ones of
+// Google Benchmark
+Options parseOptions(int* argc, char** argv) {
+  Options options;
+  int kept = 1;
+  for (int i = 1; i < *argc; ++i) {
+    const std::string arg = argv[i];
+    const auto value = [&](const char* flag) -> c10::optional<std::string> {
+      const std::string prefix = std::string(flag) + "=";
+      if (arg.compare(0, prefix.size(), prefix) == 0) {
+        return arg.substr(prefix.size());
+      }
+      return c10::nullopt;
+    };
+    if (auto dtypes = value("--dtypes")) {
+      options.dtypes.clear();
+      for (const auto& name : split(*dtypes)) {
+        options.dtypes.push_back(parseDtype(name));
+      }
+    } else if (auto shapes = value("--shapes")) {
+      options.shapes = split(*shapes);
+    } else if (auto formats = value("--memory_formats")) {
+      options.memory_formats.clear();
+      for (const auto& name : split(*formats)) {
+        options.memory_formats.push_back(parseMemoryFormat(name));
+      }
+    } else if (auto threads = value("--threads")) {
+      for (const auto& count : split(*threads)) {
+        options.threads.push_back(std::stoi(count));
+      }
+    } else if (auto gbps = value("--peak_gbps")) {
+      options.peak_gbps = std::stod(*gbps);
+    } else if (auto gflops = value("--peak_gflops")) {
+      options.peak_gflops = std::stod(*gflops);
+    } else if (arg == "--include_private") {
+      options.include_private = true;
+    } else {
+      argv[kept++] = argv[i];
+    }
+  }
+  *argc = kept;
+  if (options.threads.empty()) {
+    options.threads.push_back(1);
+    if (at::get_num_threads() > 1) {
+      options.threads.push_back(at::get_num_threads());
+    }
+  }
+  return options;
+}
+
+at::Tensor makeTensor(const Config& config) {
+  auto options = at::TensorOptions().dtype(config.dtype);
+  // Positive values, which the operators defined on part of the reals
+  // (log, sqrt, ...) accept as well
+  auto tensor = at::isFloatingType(config.dtype)
+      ? at::rand(config.shape, options).add_(0.5)
+      : at::randint(1, 10, config.shape, options);
+  return tensor.contiguous(config.memory_format);
+}
+
+// Makes the value of a non-Tensor argument without a default, or returns
+// nullopt if there is no sensible one
+c10::optional<c10::IValue> makeValue(const c10::Argument& arg, const Config& config) {
+  const auto& type = arg.type();
+  switch (type->kind()) {
+    case c10::TypeKind::IntType:
+      return c10::IValue(
+          static_cast<int64_t>(arg.name().find("dim") != std::string::npos ? 0 : 1));
+    case c10::TypeKind::FloatType:
+      return c10::IValue(1.0);
+    case c10::TypeKind::NumberType:
+      return c10::IValue(at::Scalar(1));
+    case c10::TypeKind::BoolType:
+      return c10::IValue(false);
+    case c10::TypeKind::OptionalType:
+      return c10::IValue();
+    case c10::TypeKind::ListType: {
+      const auto elem_kind = type->expect<c10::ListType>()->getElementType()->kind();
+      if (elem_kind == c10::TypeKind::TensorType) {
+        return c10::IValue(std::vector<at::Tensor>{makeTensor(config), makeTensor(config)});
+      } else if (elem_kind == c10::TypeKind::IntType) {
+        // Sizes and dims lists, which the shape itself suits best
+        return c10::IValue(config.shape);
+      }
+      return c10::nullopt;
+    }
+    default:
+      return c10::nullopt;
+  }
+}
+
+c10::optional<torch::jit::Stack> makeInputs(
+    const c10::FunctionSchema& schema,
+    const Config& config) {
+  torch::jit::Stack inputs;
+  for (const auto& arg : schema.arguments()) {
+    if (arg.type()->kind() == c10::TypeKind::TensorType) {
+      inputs.emplace_back(makeTensor(config));
+    } else if (arg.default_value()) {
+      inputs.push_back(*arg.default_value());
+    } else if (auto value = makeValue(arg, config)) {
+      inputs.push_back(std::move(*value));
+    } else {
+      return c10::nullopt;
+    }
+  }
+  return inputs;
+}
+
+void forEachTensor(const torch::jit::Stack& stack, const std::function<void(const at::Tensor&)>& fn) {
+  for (const auto& value : stack) {
+    if (value.isTensor()) {
+      if (value.toTensor().defined()) {
+        fn(value.toTensor());
+      }
+    } else if (value.isTensorList()) {
+      for (at::Tensor tensor : value.toTensorList()) {
+        fn(tensor);
+      }
+    }
+  }
+}
+
+double tensorBytes(const torch::jit::Stack& stack) {
+  double bytes = 0;
+  forEachTensor(stack, [&](const at::Tensor& tensor) {
+    bytes += tensor.numel() * tensor.element_size();
+  });
+  return bytes;
+}
+
+bool isMatrixProduct(const std::string& name) {
+  static const std::vector<std::string> products = {
+      "aten::mm", "aten::bmm", "aten::matmul", "aten::addmm", "aten::baddbmm",
+      "aten::addbmm", "aten::mv", "aten::addmv", "aten::dot", "aten::linear"};
+  return std::find(products.begin(), products.end(), name) != products.end();
+}
+
+// Counts 2 * K operations per output element of the matrix products, where K
+// is the reduced dimension, and one per output element otherwise
+double estimateFlops(
+    const c10::FunctionSchema& schema,
+    const torch::jit::Stack& inputs,
+    const torch::jit::Stack& outputs) {
+  double output_numel = 0;
+  forEachTensor(outputs, [&](const at::Tensor& tensor) {
+    output_numel += tensor.numel();
+  });
+  if (!isMatrixProduct(schema.name())) {
+    return output_numel;
+  }
+  // The reduced dimension is the last one of the left hand operand
+  const auto& args = schema.arguments();
+  int64_t k = 1;
+  for (size_t i = 0; i < args.size(); ++i) {
+    const auto& name = args[i].name();
+    if (name == "mat1" || name == "batch1" || name == "self" || name == "input") {
+      if (inputs[i].isTensor() && inputs[i].toTensor().dim() > 0) {
+        k = inputs[i].toTensor().size(-1);
+        if (name != "self" && name != "input") {
+          break;
+        }
+      }
+    }
+  }
+  return 2. * k * output_numel;
+}
+
+void runOperator(
+    benchmark::State& state,
+    const c10::OperatorHandle& op,
+    const Config& config,
+    const Options& options) {
+  at::set_num_threads(config.threads);
+  c10::InferenceMode guard;
+
+  const auto inputs = makeInputs(op.schema(), config);
+  if (!inputs) {
+    state.SkipWithError("Unsupported argument types");
+    return;
+  }
+  torch::jit::Stack stack;
+  try {
+    stack = *inputs;
+    op.callBoxed(&stack);
+  } catch (const c10::Error& e) {
+    state.SkipWithError(e.what_without_backtrace());
+    return;
+  } catch (const std::exception& e) {
+    state.SkipWithError(e.what());
+    return;
+  }
+  const double bytes = tensorBytes(*inputs) + tensorBytes(stack);
+  const double flops = estimateFlops(op.schema(), *inputs, stack);
+
+  for (auto _ : state) {
+    // callBoxed pops the inputs, so they are copied (by reference) into the
+    // stack each time
+    stack = *inputs;
+    op.callBoxed(&stack);
+    benchmark::DoNotOptimize(stack);
+  }
+
+  state.counters["GB/s"] =
+      benchmark::Counter(bytes * 1e-9, benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["GFLOP/s"] =
+      benchmark::Counter(flops * 1e-9, benchmark::Counter::kIsIterationInvariantRate);
+  if (options.peak_gbps > 0 && options.peak_gflops > 0 && bytes > 0) {
+    // Bound on the flops per second given the arithmetic intensity
+    const double attainable =
+        std::min(options.peak_gflops, flops / bytes * options.peak_gbps) * 1e9;
+    state.counters["roofline"] = benchmark::Counter(
+        flops / attainable, benchmark::Counter::kIsIterationInvariantRate);
+  }
+}
+
+std::string shapeName(const std::vector<int64_t>& shape) {
+  std::ostringstream name;
+  name << "[" << c10::Join(",", shape) << "]";
+  return name.str();
+}
+
+std::string memoryFormatName(at::MemoryFormat memory_format) {
+  return memory_format == at::MemoryFormat::ChannelsLast ? "channels_last"
+                                                         : "contiguous";
+}
+
+struct OperatorCollector : public c10::OpRegistrationListener {
+  explicit OperatorCollector(std::vector<c10::OperatorHandle>& ops) : ops(ops) {}
+
+  void onOperatorRegistered(const c10::OperatorHandle& op) override {
+    ops.push_back(op);
+  }
+
+  void onOperatorDeregistered(const c10::OperatorHandle& /* unused */) override {}
+
+  std::vector<c10::OperatorHandle>& ops;
+};
+
+bool shouldBenchmark(const c10::OperatorHandle& op, const Options& options) {
+  if (!op.hasSchema()) {
+    return false;
+  }
+  const auto& schema = op.schema();
+  const auto& name = schema.name();
+  if (name.compare(0, 6, "aten::") != 0) {
+    return false;
+  }
+  if (!options.include_private && name.compare(6, 1, "_") == 0) {
+    return false;
+  }
+  // In-place and out= variants would keep writing to the same inputs
+  return !schema.is_mutable();
+}
+
+void registerBenchmarks(const Options& options) {
+  std::vector<c10::OperatorHandle> ops;
+  // The listener is told about the registered operators right away, and
+  // removed when the handle goes out of scope
+  auto handle = c10::Dispatcher::singleton().addRegistrationListener(
+      std::make_unique<OperatorCollector>(ops));
+
+  std::vector<Config> configs;
+  for (const auto dtype : options.dtypes) {
+    for (const auto& preset : options.shapes) {
+      for (const auto& shape : presetShapes(preset)) {
+        for (const auto memory_format : options.memory_formats) {
+          if (memory_format == at::MemoryFormat::ChannelsLast && shape.size() != 4) {
+            continue;
+          }
+          for (const auto threads : options.threads) {
+            configs.push_back({dtype, shape, memory_format, threads});
+          }
+        }
+      }
+    }
+  }
+
+  for (const auto& op : ops) {
+    if (!shouldBenchmark(op, options)) {
+      continue;
+    }
+    const auto& schema = op.schema();
+    std::string op_name = schema.name();
+    if (!schema.overload_name().empty()) {
+      op_name += "." + schema.overload_name();
+    }
+    for (const auto& config : configs) {
+      const auto name = c10::str(
+          op_name, "/", c10::toString(config.dtype), "/",
+          memoryFormatName(config.memory_format), "/", shapeName(config.shape),
+          "/threads:", config.threads);
+      benchmark::RegisterBenchmark(
+          name.c_str(),
+          [op, config, &options](benchmark::State& state) {
+            runOperator(state, op, config, options);
+          })
+          ->Unit(benchmark::kMicrosecond);
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  // Parsed options outlive the benchmarks referring to them
+  static Options options;
+  try {
+    options = parseOptions(&argc, argv);
+    registerBenchmarks(options);
+  } catch (const c10::Error& e) {
+    std::cerr << e.what_without_backtrace() << std::endl;
+    return 1;
+  }
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
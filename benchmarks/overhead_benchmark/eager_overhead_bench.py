@@ -0,0 +1,91 @@
+"""Host overhead of representative eager ops, from Python, per stage.
+
+Runs small ops, whose time is dominated by the host side work, and reports
+the time per op. When PyTorch is built with USE_OVERHEAD_PROBES=1, the time
+is also broken down into the stages of c10/util/OverheadProbe.h: Python
+argument parsing, dispatch, kernel, TensorIterator build, allocator and
+kernel launch (self times, so that they add up to the instrumented time).
+binaries/eager_overhead_benchmark.cc measures the same ops from C++.
+"""
+import argparse
+import json
+import time
+
+import torch
+
+OPS = {
+    'add': lambda a, b: torch.add(a, b),
+    'add_': lambda a, b: a.add_(b),
+    'mul_scalar': lambda a, b: torch.mul(a, 2),
+    'sum': lambda a, b: torch.sum(a),
+    'empty': lambda a, b: torch.empty(1, device=a.device),
+    'view': lambda a, b: a.view(-1),
+    'mm': lambda a, b: torch.mm(a, b),
+}
+
+
+def synchronize(device):
+    if device.startswith('cuda'):
+        torch.cuda.synchronize()
+
+
+def run_op(fn, a, b, args):
+    for _ in range(args.warmup_iter):
+        fn(a, b)
+    synchronize(args.device)
+
+    probes = args.probes and torch._C._overhead_probes_compiled()
+    torch._C._reset_overhead_stats()
+    torch._C._set_overhead_probes_enabled(probes)
+    start = time.perf_counter()
+    for _ in range(args.iter):
+        fn(a, b)
+    elapsed = time.perf_counter() - start
+    torch._C._set_overhead_probes_enabled(False)
+    synchronize(args.device)
+
+    result = {'us_per_op': elapsed * 1e6 / args.iter}
+    if probes:
+        result['self_ns_per_op'] = {
+            stage: self_ns / args.iter
+            for stage, (_, _, self_ns) in torch._C._get_overhead_stats().items()}
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Benchmark the per-op host overhead of eager ops')
+    parser.add_argument('--ops', nargs='*', default=list(OPS.keys()),
+                        help='What ops to run: ' + str(list(OPS.keys())))
+    parser.add_argument('--device', default='cpu')
+    parser.add_argument('--iter', default=10000, type=int)
+    parser.add_argument('--warmup_iter', default=1000, type=int)
+    parser.add_argument('--no_probes', dest='probes', action='store_false',
+                        help='Don\'t enable the overhead probes')
+    parser.add_argument('--json', default=None,
+                        help='Also write the results to this JSON file')
+    args = parser.parse_args()
+
+    if args.probes and not torch._C._overhead_probes_compiled():
+        print('The overhead probes are not compiled in, rebuild with '
+              'USE_OVERHEAD_PROBES=1 for the time per stage')
+
+    a = torch.ones(1, 1, device=args.device)
+    b = torch.ones(1, 1, device=args.device)
+    results = {}
+    for name in args.ops:
+        assert name in OPS, 'Unknown op ' + name
+        results[name] = run_op(OPS[name], a, b, args)
+        line = '{:<12}{:>10.3f} us/op'.format(name, results[name]['us_per_op'])
+        for stage, ns in results[name].get('self_ns_per_op', {}).items():
+            line += '  {} {:.1f}'.format(stage, ns)
+        print(line)
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump({'device': args.device, 'iter': args.iter, 'ops': results},
+                      f, indent=2)
+
+
+if __name__ == '__main__':
+    main()
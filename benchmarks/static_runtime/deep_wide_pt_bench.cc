@@ -1,6 +1,7 @@
 #include <benchmark/benchmark.h>
 #include <torch/csrc/jit/runtime/static/impl.h>
 #include "deep_wide_pt.h"
+#include "sr_report.h"
 
 const int embedding_size = 32;
 const int num_features = 50;
@@ -193,6 +194,9 @@ BENCHMARK(BM_long_static_memory_optimization)
 int main(int argc, char** argv)
 {
   c10::ParseCommandLineFlags(&argc, &argv);
+  if (runStaticRuntimeReport()) {
+    return 0;
+  }
   ::benchmark::Initialize(&argc, argv);
   ::benchmark::RunSpecifiedBenchmarks();
 }
@@ -0,0 +1,234 @@
+#include "sr_report.h"
+
+#include <c10/util/Flags.h>
+#include <caffe2/core/timer.h>
+#include <torch/csrc/jit/runtime/static/impl.h>
+#include <torch/csrc/jit/serialization/import.h>
+#include <torch/csrc/jit/serialization/pickle.h>
+#include "deep_wide_pt.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+C10_DEFINE_string(
+    sr_report,
+    "",
+    "Write a JSON report of the models of the corpus to this path instead of "
+    "running the benchmarks");
+C10_DEFINE_string(
+    sr_models,
+    "",
+    "Comma separated paths of the TorchScript models of the corpus; the deep "
+    "and wide model is used if empty");
+C10_DEFINE_string(
+    sr_inputs,
+    "",
+    "Comma separated paths of the inputs of the models, as lists or tuples "
+    "saved with torch.save, one per model");
+C10_DEFINE_string(
+    sr_threads,
+    "1,2,4,8",
+    "Comma separated numbers of threads of the throughput runs");
+C10_DEFINE_int(sr_warmup_runs, 10, "Warmup iterations per measurement");
+C10_DEFINE_int(sr_main_runs, 100, "Measured iterations per measurement");
+C10_DEFINE_int(
+    sr_batch_size,
+    1,
+    "Batch size of the inputs of the deep and wide model");
+
+namespace {
+
+struct CorpusModel {
+  std::string name;
+  torch::jit::Module module;
+  std::vector<c10::IValue> inputs;
+};
+
+std::vector<std::string> split(const std::string& str) {
+  std::vector<std::string> parts;
+  std::stringstream ss(str);
+  std::string part;
+  while (std::getline(ss, part, ',')) {
+    if (!part.empty()) {
+      parts.push_back(part);
+    }
+  }
+  return parts;
+}
+
+std::string escape(const std::string& str) {
+  std::string escaped;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+std::vector<c10::IValue> loadInputs(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  TORCH_CHECK(file, "Can't open the inputs ", path);
+  std::vector<char> data(
+      (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  c10::IValue inputs = torch::jit::pickle_load(data);
+  if (inputs.isTuple()) {
+    return inputs.toTuple()->elements();
+  }
+  TORCH_CHECK(
+      inputs.isList(), "The inputs ", path, " must be a list or a tuple");
+  auto list = inputs.toList();
+  return std::vector<c10::IValue>(list.begin(), list.end());
+}
+
+std::vector<CorpusModel> loadCorpus() {
+  std::vector<CorpusModel> corpus;
+  const auto models = split(FLAGS_sr_models);
+  const auto inputs = split(FLAGS_sr_inputs);
+  if (models.empty()) {
+    const int batch_size = FLAGS_sr_batch_size;
+    corpus.push_back(
+        {"deep_wide",
+         getDeepAndWideSciptModel(),
+         {torch::randn({batch_size, 1, 32}),
+          torch::randn({batch_size, 1, 32}),
+          torch::randn({batch_size, 50})}});
+    return corpus;
+  }
+  TORCH_CHECK(
+      models.size() == inputs.size(),
+      "--sr_models and --sr_inputs must have as many paths");
+  for (size_t i = 0; i < models.size(); ++i) {
+    corpus.push_back(
+        {models[i], torch::jit::load(models[i]), loadInputs(inputs[i])});
+  }
+  return corpus;
+}
+
+// Iterations per second of num_threads threads, each with its own
+// StaticRuntime of the same InferenceModule
+double measureThroughput(
+    const std::shared_ptr<torch::jit::InferenceModule>& module,
+    const std::vector<c10::IValue>& inputs,
+    int num_threads) {
+  const std::unordered_map<std::string, c10::IValue> kwargs;
+  std::vector<std::unique_ptr<torch::jit::StaticRuntime>> runtimes;
+  for (int i = 0; i < num_threads; ++i) {
+    runtimes.push_back(std::make_unique<torch::jit::StaticRuntime>(module));
+    for (int j = 0; j < FLAGS_sr_warmup_runs; ++j) {
+      runtimes.back()->run(inputs, kwargs);
+    }
+  }
+
+  caffe2::Timer timer;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&runtimes, &inputs, &kwargs, i]() {
+      for (int j = 0; j < FLAGS_sr_main_runs; ++j) {
+        runtimes[i]->run(inputs, kwargs);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const float seconds = timer.Seconds();
+  return num_threads * FLAGS_sr_main_runs / std::max(seconds, 1e-9f);
+}
+
+void writeModelReport(std::ostream& out, const CorpusModel& model) {
+  const std::unordered_map<std::string, c10::IValue> kwargs;
+  auto module = torch::jit::PrepareForStaticRuntime(model.module);
+  torch::jit::StaticRuntime runtime(module);
+  const float ms_per_iter = runtime.benchmark_model(
+      model.inputs, kwargs, FLAGS_sr_warmup_runs, FLAGS_sr_main_runs);
+  const auto metrics = runtime.benchmark_individual_ops(
+      model.inputs, kwargs, FLAGS_sr_warmup_runs, FLAGS_sr_main_runs);
+
+  out << "    {\n";
+  out << "      \"name\": \"" << escape(model.name) << "\",\n";
+  out << "      \"ms_per_iter\": " << ms_per_iter << ",\n";
+  out << "      \"setup_ms\": " << metrics.setup_time << ",\n";
+  out << "      \"nodes_ms\": " << metrics.total_time << ",\n";
+  out << "      \"num_nodes\": " << metrics.total_nodes_count << ",\n";
+  out << "      \"num_out_variant_nodes\": " << metrics.out_nodes_count
+      << ",\n";
+  out << "      \"out_variant_coverage\": "
+      << (metrics.total_nodes_count
+              ? static_cast<float>(metrics.out_nodes_count) /
+                  metrics.total_nodes_count
+              : 0.f)
+      << ",\n";
+
+  std::vector<std::pair<std::string, float>> kinds(
+      metrics.time_per_node_type.begin(), metrics.time_per_node_type.end());
+  std::sort(kinds.begin(), kinds.end(), [](const auto& a, const auto& b) {
+    return a.second > b.second;
+  });
+  out << "      \"node_kinds\": [";
+  for (size_t i = 0; i < kinds.size(); ++i) {
+    const auto& kind = kinds[i].first;
+    out << (i ? ",\n" : "\n") << "        {\"kind\": \"" << escape(kind)
+        << "\", \"ms\": " << kinds[i].second
+        << ", \"percent\": " << metrics.percent_per_node_type.at(kind)
+        << ", \"instances\": " << metrics.instances_per_node_type.at(kind)
+        << ", \"out_variant\": "
+        << (metrics.out_nodes.count(kind) ? "true" : "false") << "}";
+  }
+  out << "\n      ],\n";
+
+  out << "      \"memory_planner\": {\"managed_bytes\": "
+      << metrics.managed_bytes
+      << ", \"reused_bytes\": " << metrics.reused_bytes
+      << ", \"reserved_bytes\": " << metrics.reserved_bytes
+      << ", \"managed_tensors\": " << metrics.num_managed_tensors
+      << ", \"reused_registers\": " << module->reused_regs << "},\n";
+  out << "      \"allocations_per_iter\": " << metrics.allocations_per_iter
+      << ",\n";
+  out << "      \"bytes_allocated_per_iter\": "
+      << metrics.bytes_allocated_per_iter << ",\n";
+
+  out << "      \"throughput\": [";
+  const auto thread_counts = split(FLAGS_sr_threads);
+  for (size_t i = 0; i < thread_counts.size(); ++i) {
+    const int num_threads = std::stoi(thread_counts[i]);
+    TORCH_CHECK(num_threads > 0, "Invalid --sr_threads ", FLAGS_sr_threads);
+    out << (i ? ",\n" : "\n") << "        {\"threads\": " << num_threads
+        << ", \"iters_per_sec\": "
+        << measureThroughput(module, model.inputs, num_threads) << "}";
+  }
+  out << "\n      ]\n";
+  out << "    }";
+}
+
+} // namespace
+
+bool runStaticRuntimeReport() {
+  if (FLAGS_sr_report.empty()) {
+    return false;
+  }
+  const auto corpus = loadCorpus();
+
+  std::ofstream out(FLAGS_sr_report);
+  TORCH_CHECK(out, "Can't open ", FLAGS_sr_report);
+  out << "{\n";
+  out << "  \"num_threads\": " << at::get_num_threads() << ",\n";
+  out << "  \"warmup_runs\": " << FLAGS_sr_warmup_runs << ",\n";
+  out << "  \"main_runs\": " << FLAGS_sr_main_runs << ",\n";
+  out << "  \"models\": [";
+  for (size_t i = 0; i < corpus.size(); ++i) {
+    out << (i ? ",\n" : "\n");
+    writeModelReport(out, corpus[i]);
+  }
+  out << "\n  ]\n}\n";
+  TORCH_CHECK(out, "Failed to write ", FLAGS_sr_report);
+  return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+// Structured benchmark mode of static_runtime_bench.
+//
+// Runs every model of a corpus of TorchScript models (or, without a corpus,
+// the deep and wide model of deep_wide_pt.h) with Static Runtime and writes a
+// JSON report with, per model, the time per iteration and per node kind, the
+// out variant coverage, the MemoryPlanner stats, the allocations made per
+// iteration and the throughput with several threads sharing the model. Two
+// reports of the same corpus can be diffed to compare builds.
+//
+//   static_runtime_bench --sr_report=report.json \
+//       --sr_models=a.pt,b.pt --sr_inputs=a_inputs.pt,b_inputs.pt \
+//       --sr_threads=1,4,8
+//
+// The inputs of each model are a list or tuple of IValues saved with
+// torch.save, passed to forward as positional arguments.
+
+// Returns true if the report mode was requested with --sr_report, in which
+// case the report has been written.
+bool runStaticRuntimeReport();
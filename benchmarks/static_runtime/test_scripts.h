@@ -48,3 +48,29 @@ const auto flatten_script_2 = R"JIT(
       b = a.transpose(0, 1)
       return torch.flatten(b, start_dim, end_dim)
 )JIT";
+
+const auto generic_out_variant_script = R"JIT(
+  def forward(self, a: Tensor, b: Tensor):
+      c = torch.sub(a, b)
+      d = torch.exp(c)
+      return torch.div(d, b)
+)JIT";
+
+const auto cat_flatten_script = R"JIT(
+  def forward(self, a: Tensor, b: Tensor):
+      c = torch.flatten(torch.cat([a, b], 1), 0, 1)
+      return c + c
+)JIT";
+
+const auto to_contiguous_script = R"JIT(
+  def forward(self, a: Tensor):
+      b = a.transpose(0, 1).to(torch.float64).contiguous()
+      return b + b
+)JIT";
+
+const auto parallel_towers_script = R"JIT(
+  def forward(self, a: Tensor, b: Tensor):
+      c = torch.tanh(a) * 2 + 1
+      d = torch.sigmoid(b) * 3 + 1
+      return torch.cat([c, d], 0)
+)JIT";
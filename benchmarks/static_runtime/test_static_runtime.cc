@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <torch/csrc/jit/runtime/static/batcher.h>
 #include <torch/csrc/jit/runtime/static/fusion.h>
 #include <torch/csrc/jit/runtime/static/impl.h>
 #include "deep_wide_pt.h"
@@ -125,6 +126,59 @@ TEST(StaticRuntime, IndividualOps_flatten) {
   test_flatten({}, 0, 0);
 }
 
+TEST(StaticRuntime, GenericOutVariant) {
+  script::Module module("module");
+  module.define(generic_out_variant_script);
+  StaticRuntime runtime(module);
+  for (const auto& pnode : runtime.get_nodes()) {
+    EXPECT_TRUE(pnode.has_out_variant());
+  }
+
+  // the first run allocates the outputs, the later ones reuse them
+  for (auto shape : {std::vector<int64_t>{2, 3}, {4, 5}, {2, 3}}) {
+    auto a = at::randn(shape);
+    auto b = at::rand(shape) + 1;
+    std::vector<IValue> args{a, b};
+    auto expect = module.forward(args).toTensor();
+    auto actual = runtime.run(args, {}).toTensor();
+    EXPECT_TRUE(expect.equal(actual));
+  }
+}
+
+TEST(StaticRuntime, FusedOps) {
+  auto hasNode = [](StaticRuntime& runtime, const char* kind) {
+    for (const auto& pnode : runtime.get_nodes()) {
+      if (pnode.get_node()->kind() == c10::Symbol::fromQualString(kind)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  script::Module cat_flatten("module");
+  cat_flatten.define(cat_flatten_script);
+  StaticRuntime cat_flatten_runtime(cat_flatten);
+  EXPECT_TRUE(hasNode(cat_flatten_runtime, "static_runtime::cat_flatten"));
+  EXPECT_FALSE(hasNode(cat_flatten_runtime, "aten::flatten"));
+  for (int i = 0; i < 2; ++i) {
+    std::vector<IValue> args{at::randn({2, 3, 4}), at::randn({2, 1, 4})};
+    auto expect = cat_flatten.forward(args).toTensor();
+    auto actual = cat_flatten_runtime.run(args, {}).toTensor();
+    EXPECT_TRUE(expect.equal(actual));
+  }
+
+  script::Module to_contiguous("module");
+  to_contiguous.define(to_contiguous_script);
+  StaticRuntime to_contiguous_runtime(to_contiguous);
+  EXPECT_FALSE(hasNode(to_contiguous_runtime, "aten::contiguous"));
+  for (int i = 0; i < 2; ++i) {
+    std::vector<IValue> args{at::randn({2, 3})};
+    auto expect = to_contiguous.forward(args).toTensor();
+    auto actual = to_contiguous_runtime.run(args, {}).toTensor();
+    EXPECT_TRUE(expect.equal(actual));
+  }
+}
+
 TEST(StaticRuntime, LongModel) {
   torch::jit::Module mod = getLongScriptModel();
   auto a = torch::randn({2, 2});
@@ -288,6 +342,124 @@ TEST(StaticRuntime, CleanUpMemory) {
   }
 }
 
+TEST(StaticRuntime, MemoryPlansPerInputShape) {
+  const int embedding_size = 32;
+  const int num_features = 50;
+  torch::jit::Module mod = getDeepAndWideSciptModel();
+  auto g = torch::jit::PrepareForStaticRuntime(mod);
+  torch::jit::StaticRuntime runtime(g);
+
+  size_t reserved = 0;
+  for (int i = 0; i < 3; ++i) {
+    for (int batch_size : {8, 1, 32, 8}) {
+      auto ad_emb_packed = torch::randn({batch_size, 1, embedding_size});
+      auto user_emb = torch::randn({batch_size, 1, embedding_size});
+      auto wide = torch::randn({batch_size, num_features});
+
+      std::vector<at::IValue> inputs({ad_emb_packed, user_emb, wide});
+      auto output_1 = getTensor(mod.forward(inputs));
+
+      std::vector<at::Tensor> input_tensors({ad_emb_packed, user_emb, wide});
+      at::Tensor output_2 = runtime.run(input_tensors)[0];
+      EXPECT_TRUE(output_1.equal(output_2));
+    }
+    const auto* planner = runtime.get_memory_planner();
+    ASSERT_NE(planner, nullptr);
+    EXPECT_EQ(planner->num_cached_plans(), 3u);
+    // the buffer grows to the plan of batch size 32 once that plan is known,
+    // and is then reused by all batch sizes
+    if (i == 1) {
+      reserved = planner->total_reserved();
+    } else if (i == 2) {
+      EXPECT_EQ(planner->total_reserved(), reserved);
+    }
+  }
+}
+
+TEST(StaticRuntime, InterOpParallelism) {
+  script::Module module("module");
+  module.define(parallel_towers_script);
+
+  for (size_t min_region_cost : {0, 100}) {
+    torch::jit::InferenceModuleOptions opts;
+    opts.enable_inter_op_parallelism = true;
+    opts.inter_op_min_region_cost = min_region_cost;
+    auto g = torch::jit::PrepareForStaticRuntime(module, opts);
+
+    // the towers run in parallel unless they are too cheap, and the cat
+    // waits for both of them
+    const auto& steps = g->parallel_steps;
+    ASSERT_EQ(steps.size(), 2u);
+    if (min_region_cost == 0) {
+      ASSERT_EQ(steps[0].size(), 2u);
+      EXPECT_FALSE(steps[0][0].run_inline);
+      EXPECT_FALSE(steps[0][1].run_inline);
+    } else {
+      ASSERT_EQ(steps[0].size(), 1u);
+      EXPECT_TRUE(steps[0][0].run_inline);
+    }
+
+    torch::jit::StaticRuntime runtime(g);
+    for (int i = 0; i < 3; ++i) {
+      std::vector<IValue> args{at::randn({2, 3}), at::randn({4, 3})};
+      auto expect = module.forward(args).toTensor();
+      auto actual = runtime.run(args, {}).toTensor();
+      EXPECT_TRUE(expect.equal(actual));
+    }
+  }
+
+  // the towers of the deep and wide model compute the same results in
+  // parallel
+  torch::jit::Module mod = getDeepAndWideSciptModel();
+  torch::jit::InferenceModuleOptions opts;
+  opts.enable_inter_op_parallelism = true;
+  opts.inter_op_min_region_cost = 0;
+  torch::jit::StaticRuntime runtime(
+      torch::jit::PrepareForStaticRuntime(mod, opts));
+  for (int batch_size : {1, 8, 32}) {
+    auto ad_emb_packed = torch::randn({batch_size, 1, 32});
+    auto user_emb = torch::randn({batch_size, 1, 32});
+    auto wide = torch::randn({batch_size, 50});
+    std::vector<at::IValue> inputs({ad_emb_packed, user_emb, wide});
+    auto output_1 = getTensor(mod.forward(inputs));
+    std::vector<at::Tensor> input_tensors({ad_emb_packed, user_emb, wide});
+    at::Tensor output_2 = runtime.run(input_tensors)[0];
+    EXPECT_TRUE(output_1.equal(output_2));
+  }
+}
+
+TEST(StaticRuntime, Batcher) {
+  const int embedding_size = 32;
+  const int num_features = 50;
+  torch::jit::Module mod = getDeepAndWideSciptModel();
+  auto g = torch::jit::PrepareForStaticRuntime(mod);
+  torch::jit::StaticRuntimeBatcherOptions batcher_opts;
+  batcher_opts.max_batch_size = 16;
+  batcher_opts.max_latency = std::chrono::milliseconds(10);
+  torch::jit::StaticRuntimeBatcher batcher(g, {}, batcher_opts);
+
+  std::vector<at::Tensor> expects;
+  std::vector<c10::intrusive_ptr<c10::ivalue::Future>> futures;
+  for (int batch_size : {1, 3, 8, 1, 20, 2}) {
+    auto ad_emb_packed = torch::randn({batch_size, 1, embedding_size});
+    auto user_emb = torch::randn({batch_size, 1, embedding_size});
+    auto wide = torch::randn({batch_size, num_features});
+
+    std::vector<at::IValue> inputs({ad_emb_packed, user_emb, wide});
+    expects.emplace_back(getTensor(mod.forward(inputs)));
+    futures.emplace_back(batcher.submit({ad_emb_packed, user_emb, wide}));
+  }
+  for (size_t i = 0; i < futures.size(); ++i) {
+    futures[i]->waitAndThrow();
+    EXPECT_TRUE(expects[i].allclose(getTensor(futures[i]->value())));
+  }
+
+  // errors raised by a batch are set on the futures of its requests
+  auto bad = batcher.submit({torch::randn({2, 1, embedding_size})});
+  bad->wait();
+  EXPECT_TRUE(bad->hasError());
+}
+
 TEST(StaticRuntime, FusionPass) {
   const int embedding_size = 32;
   const int num_features = 50;
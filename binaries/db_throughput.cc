@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cstdio>
 #include <thread>
 #include <vector>
@@ -32,6 +33,16 @@ C10_DEFINE_int(
     num_read_threads,
     1,
     "The number of concurrent reading threads.");
+C10_DEFINE_int(
+    readahead,
+    0,
+    "If positive, the number of records the reader reads ahead on a "
+    "background thread. Only used with --use_reader.");
+C10_DEFINE_int(
+    read_batch_size,
+    1,
+    "If larger than 1, read records in batches of this size with "
+    "ReadBatch(). Only used with --use_reader.");
 
 using caffe2::db::Cursor;
 using caffe2::db::DB;
@@ -64,10 +75,20 @@ void TestThroughputWithDB() {
 
 void TestThroughputWithReaderWorker(const DBReader* reader, int thread_id) {
   string key, value;
+  std::vector<string> keys, values;
   for (int iter_id = 0; iter_id < FLAGS_repeat; ++iter_id) {
     caffe2::Timer timer;
-    for (int i = 0; i < FLAGS_report_interval; ++i) {
-      reader->Read(&key, &value);
+    if (FLAGS_read_batch_size > 1) {
+      for (int i = 0; i < FLAGS_report_interval; i += FLAGS_read_batch_size) {
+        reader->ReadBatch(
+            std::min(FLAGS_read_batch_size, FLAGS_report_interval - i),
+            &keys,
+            &values);
+      }
+    } else {
+      for (int i = 0; i < FLAGS_report_interval; ++i) {
+        reader->Read(&key, &value);
+      }
     }
     double elapsed_seconds = timer.Seconds();
     printf(
@@ -82,6 +103,9 @@ void TestThroughputWithReaderWorker(const DBReader* reader, int thread_id) {
 
 void TestThroughputWithReader() {
   caffe2::db::DBReader reader(FLAGS_input_db_type, FLAGS_input_db);
+  if (FLAGS_readahead > 0) {
+    reader.StartReadahead(FLAGS_readahead);
+  }
   std::vector<std::unique_ptr<std::thread>> reading_threads(
       FLAGS_num_read_threads);
   for (int i = 0; i < reading_threads.size(); ++i) {
@@ -0,0 +1,136 @@
+// Host overhead of representative eager ops, per stage.
+//
+// Runs small ops, whose time is dominated by the host side work, on CPU and
+// (if available) CUDA, and reports the time per op. When PyTorch is built
+// with -DUSE_OVERHEAD_PROBES=ON, the time is also broken down into the
+// stages of c10/util/OverheadProbe.h (dispatch, kernel, TensorIterator
+// build, allocator, kernel launch), so that a per-op overhead regression
+// can be attributed to a stage. The Python argument parsing stage is
+// covered by benchmarks/overhead_benchmark/eager_overhead_bench.py.
+
+#include <ATen/ATen.h>
+#include <c10/util/Flags.h>
+#include <c10/util/OverheadProbe.h>
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+C10_DEFINE_int(iter, 10000, "Number of iterations of each op");
+C10_DEFINE_int(warmup_iter, 1000, "Number of warmup iterations of each op");
+C10_DEFINE_bool(cuda, true, "Also run the ops on CUDA, if available");
+C10_DEFINE_bool(
+    probes,
+    true,
+    "Report the time per stage, if the overhead probes are compiled in");
+
+namespace {
+
+struct EagerOp {
+  std::string name;
+  std::function<void(const at::Tensor&, const at::Tensor&)> fn;
+};
+
+std::vector<EagerOp> eagerOps() {
+  return {
+      {"add", [](const at::Tensor& a, const at::Tensor& b) { at::add(a, b); }},
+      {"add_", [](const at::Tensor& a, const at::Tensor& b) { a.add_(b); }},
+      {"mul_scalar",
+       [](const at::Tensor& a, const at::Tensor&) { at::mul(a, 2); }},
+      {"sum", [](const at::Tensor& a, const at::Tensor&) { at::sum(a); }},
+      {"empty",
+       [](const at::Tensor& a, const at::Tensor&) {
+         at::empty({1}, a.options());
+       }},
+      {"view", [](const at::Tensor& a, const at::Tensor&) { a.view({-1}); }},
+      {"mm", [](const at::Tensor& a, const at::Tensor& b) { at::mm(a, b); }},
+  };
+}
+
+void synchronize(const at::Tensor& t) {
+  if (t.is_cuda()) {
+    // Any op that copies to the host waits for the queued kernels
+    t.sum().item();
+  }
+}
+
+// Returns the mean time per op in microseconds
+double runOp(const EagerOp& op, const at::Tensor& a, const at::Tensor& b) {
+  for (int i = 0; i < FLAGS_warmup_iter; ++i) {
+    op.fn(a, b);
+  }
+  synchronize(a);
+
+  using clock = std::chrono::steady_clock;
+  c10::resetOverheadStats();
+  c10::setOverheadProbesEnabled(FLAGS_probes);
+  const auto start = clock::now();
+  for (int i = 0; i < FLAGS_iter; ++i) {
+    op.fn(a, b);
+  }
+  const auto end = clock::now();
+  c10::setOverheadProbesEnabled(false);
+  synchronize(a);
+  return std::chrono::duration<double, std::micro>(end - start).count() /
+      FLAGS_iter;
+}
+
+void runDevice(at::Device device) {
+  const auto options = at::TensorOptions().device(device);
+  const auto a = at::ones({1, 1}, options);
+  const auto b = at::ones({1, 1}, options);
+
+  std::cout << "Device " << device << ", " << FLAGS_iter << " iterations"
+            << std::endl;
+  std::cout << std::left << std::setw(12) << "op" << std::right
+            << std::setw(10) << "us/op";
+  const bool probes = FLAGS_probes && c10::overheadProbesCompiled();
+  if (probes) {
+    for (size_t i = 0; i < c10::kNumOverheadStages; ++i) {
+      std::cout << "  "
+                << c10::overheadStageName(static_cast<c10::OverheadStage>(i));
+    }
+    std::cout << "  (self ns/op)";
+  }
+  std::cout << std::endl;
+
+  for (const auto& op : eagerOps()) {
+    const double us_per_op = runOp(op, a, b);
+    std::cout << std::left << std::setw(12) << op.name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(3)
+              << us_per_op;
+    if (probes) {
+      const auto stats = c10::getOverheadStats();
+      for (size_t i = 0; i < c10::kNumOverheadStages; ++i) {
+        const auto name =
+            c10::overheadStageName(static_cast<c10::OverheadStage>(i));
+        std::cout << "  " << std::setw(std::strlen(name)) << std::setprecision(1)
+                  << static_cast<double>(stats[i].self_ns) / FLAGS_iter;
+      }
+    }
+    std::cout << std::endl;
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cout << "Failed to parse command line flags" << std::endl;
+    return -1;
+  }
+  if (FLAGS_probes && !c10::overheadProbesCompiled()) {
+    std::cout << "The overhead probes are not compiled in, rebuild with "
+              << "USE_OVERHEAD_PROBES=1 for the time per stage" << std::endl;
+  }
+
+  runDevice(at::kCPU);
+  if (FLAGS_cuda && at::hasCUDA()) {
+    runDevice(at::kCUDA);
+  }
+  return 0;
+}
@@ -0,0 +1,220 @@
+// Compares the variants of the embedding lookup kernels in caffe2/perfkernels,
+// which the dispatching functions choose from at runtime.
+
+#include "benchmark/benchmark.h"
+
+#include <cpuinfo.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "caffe2/core/macros.h"
+#include "caffe2/perfkernels/common.h"
+
+namespace caffe2 {
+
+#define DECLARE_EMBEDDING_LOOKUP_VARIANTS(suffix)                              \
+  bool EmbeddingLookupIdx_int64_t_float_float_false##suffix(                   \
+      const int64_t block_size,                                                \
+      const int64_t output_size,                                               \
+      const int64_t index_size,                                                \
+      const int64_t data_size,                                                 \
+      const float* input,                                                      \
+      const int64_t* indices,                                                  \
+      const int64_t* offsets,                                                  \
+      const float* weights,                                                    \
+      const float* scale_bias,                                                 \
+      bool normalize_by_lengths,                                               \
+      float* out);                                                             \
+  bool Fused8BitRowwiseEmbeddingLookupIdx_int64_t_uint8_t_float_false##suffix( \
+      const int64_t block_size,                                                \
+      const int64_t output_size,                                               \
+      const int64_t index_size,                                                \
+      const int64_t data_size,                                                 \
+      const uint8_t* input,                                                    \
+      const int64_t* indices,                                                  \
+      const int64_t* offsets,                                                  \
+      const float* weights,                                                    \
+      bool normalize_by_lengths,                                               \
+      float* out);
+
+DECLARE_EMBEDDING_LOOKUP_VARIANTS(__base)
+#ifdef CAFFE2_PERF_WITH_AVX2
+DECLARE_EMBEDDING_LOOKUP_VARIANTS(__avx2_fma)
+#endif
+#ifdef CAFFE2_PERF_WITH_AVX512
+DECLARE_EMBEDDING_LOOKUP_VARIANTS(__avx512)
+#endif
+#ifdef CAFFE2_PERF_WITH_NEON
+DECLARE_EMBEDDING_LOOKUP_VARIANTS(__neon)
+#endif
+
+#undef DECLARE_EMBEDDING_LOOKUP_VARIANTS
+
+} // namespace caffe2
+
+namespace {
+
+constexpr int64_t kDataSize = 100000;
+constexpr int64_t kOutputSize = 128;
+constexpr int64_t kLookupsPerOutput = 40;
+
+enum class Isa { Base, Avx2Fma, Avx512, Neon };
+
+bool isSupported(Isa isa) {
+  if (!cpuinfo_initialize()) {
+    return isa == Isa::Base;
+  }
+  switch (isa) {
+    case Isa::Base:
+      return true;
+    case Isa::Avx2Fma:
+      return cpuinfo_has_x86_avx2() && cpuinfo_has_x86_fma3();
+    case Isa::Avx512:
+      return cpuinfo_has_x86_avx512f() && cpuinfo_has_x86_avx512dq() &&
+          cpuinfo_has_x86_avx512vl();
+    case Isa::Neon:
+      return cpuinfo_has_arm_neon();
+  }
+  return false;
+}
+
+// Random rows and the bags of indices looked up in them
+struct Lookups {
+  explicit Lookups(int64_t row_size) {
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int64_t> index(0, kDataSize - 1);
+    indices.resize(kOutputSize * kLookupsPerOutput);
+    for (auto& i : indices) {
+      i = index(gen);
+    }
+    offsets.resize(kOutputSize + 1);
+    for (int64_t i = 0; i <= kOutputSize; ++i) {
+      offsets[i] = i * kLookupsPerOutput;
+    }
+    std::uniform_int_distribution<int> byte(0, 255);
+    data.resize(kDataSize * row_size);
+    for (auto& b : data) {
+      b = static_cast<uint8_t>(byte(gen));
+    }
+  }
+
+  std::vector<int64_t> indices;
+  std::vector<int64_t> offsets;
+  std::vector<uint8_t> data;
+};
+
+using FloatLookup = decltype(
+    &caffe2::EmbeddingLookupIdx_int64_t_float_float_false__base);
+using Fused8BitLookup = decltype(
+    &caffe2::Fused8BitRowwiseEmbeddingLookupIdx_int64_t_uint8_t_float_false__base);
+
+void BM_EmbeddingLookupIdx(benchmark::State& state, FloatLookup lookup, Isa isa) {
+  if (!isSupported(isa)) {
+    state.SkipWithError("the CPU doesn't support this variant");
+    return;
+  }
+  const int64_t block_size = state.range(0);
+  Lookups lookups(block_size * sizeof(float));
+  std::vector<float> input(kDataSize * block_size);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = lookups.data[i * sizeof(float)] / 255.f;
+  }
+  std::vector<float> out(kOutputSize * block_size);
+  while (state.KeepRunning()) {
+    lookup(
+        block_size,
+        kOutputSize,
+        lookups.indices.size(),
+        kDataSize,
+        input.data(),
+        lookups.indices.data(),
+        lookups.offsets.data(),
+        nullptr,
+        nullptr,
+        false,
+        out.data());
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(
+      state.iterations() * lookups.indices.size() * block_size * sizeof(float));
+}
+
+void BM_Fused8BitRowwiseEmbeddingLookupIdx(
+    benchmark::State& state,
+    Fused8BitLookup lookup,
+    Isa isa) {
+  if (!isSupported(isa)) {
+    state.SkipWithError("the CPU doesn't support this variant");
+    return;
+  }
+  const int64_t block_size = state.range(0);
+  // each row ends with its float scale and bias
+  const int64_t fused_block_size = block_size + 2 * sizeof(float);
+  Lookups lookups(fused_block_size);
+  for (int64_t i = 0; i < kDataSize; ++i) {
+    const float scale_bias[2] = {1.f / 255, -0.5f};
+    std::memcpy(
+        &lookups.data[i * fused_block_size + block_size],
+        scale_bias,
+        sizeof(scale_bias));
+  }
+  std::vector<float> out(kOutputSize * block_size);
+  while (state.KeepRunning()) {
+    lookup(
+        block_size,
+        kOutputSize,
+        lookups.indices.size(),
+        kDataSize,
+        lookups.data.data(),
+        lookups.indices.data(),
+        lookups.offsets.data(),
+        nullptr,
+        false,
+        out.data());
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(
+      state.iterations() * lookups.indices.size() * fused_block_size);
+}
+
+// The unrolled block sizes, and one going through the generic loops
+#define EMBEDDING_LOOKUP_BENCHMARKS(name, suffix, isa)                            \
+  BENCHMARK_CAPTURE(                                                              \
+      BM_EmbeddingLookupIdx,                                                      \
+      name,                                                                       \
+      &caffe2::EmbeddingLookupIdx_int64_t_float_float_false##suffix,              \
+      isa)                                                                        \
+      ->Arg(16)                                                                   \
+      ->Arg(32)                                                                   \
+      ->Arg(64)                                                                   \
+      ->Arg(128)                                                                  \
+      ->Arg(100);                                                                 \
+  BENCHMARK_CAPTURE(                                                              \
+      BM_Fused8BitRowwiseEmbeddingLookupIdx,                                      \
+      name,                                                                       \
+      &caffe2::                                                                   \
+          Fused8BitRowwiseEmbeddingLookupIdx_int64_t_uint8_t_float_false##suffix, \
+      isa)                                                                        \
+      ->Arg(16)                                                                   \
+      ->Arg(32)                                                                   \
+      ->Arg(64)                                                                   \
+      ->Arg(128)                                                                  \
+      ->Arg(100);
+
+EMBEDDING_LOOKUP_BENCHMARKS(base, __base, Isa::Base)
+#ifdef CAFFE2_PERF_WITH_AVX2
+EMBEDDING_LOOKUP_BENCHMARKS(avx2_fma, __avx2_fma, Isa::Avx2Fma)
+#endif
+#ifdef CAFFE2_PERF_WITH_AVX512
+EMBEDDING_LOOKUP_BENCHMARKS(avx512, __avx512, Isa::Avx512)
+#endif
+#ifdef CAFFE2_PERF_WITH_NEON
+EMBEDDING_LOOKUP_BENCHMARKS(neon, __neon, Isa::Neon)
+#endif
+
+} // namespace
+
+BENCHMARK_MAIN();
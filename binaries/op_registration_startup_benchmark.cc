@@ -0,0 +1,82 @@
+// Startup cost of the operator registrations.
+//
+// Reports the CPU time spent before main (loading libtorch and running the
+// static initializers, where all of the operators are registered), the time
+// to look up the schema of every registered operator the first time (which
+// parses the schemas that were defined lazily, see Note [Lazy schema
+// registration]) and a second time, and the time of the first and of a
+// steady-state call to at::add.
+
+#include <ATen/ATen.h>
+#include <ATen/core/dispatch/Dispatcher.h>
+#include <c10/util/Flags.h>
+
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+C10_DEFINE_int(iter, 1000, "Number of iterations of the steady-state at::add");
+
+namespace {
+
+using steady_clock = std::chrono::steady_clock;
+
+double msSince(steady_clock::time_point start) {
+  const auto elapsed = steady_clock::now() - start;
+  return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+void report(const char* what, double ms) {
+  std::cout << std::left << std::setw(36) << what << std::right
+            << std::setw(12) << std::fixed << std::setprecision(3) << ms
+            << " ms" << std::endl;
+}
+
+// Returns the number of operators that have a schema
+size_t findAllSchemas(const std::vector<c10::OperatorName>& op_names) {
+  size_t found = 0;
+  for (const auto& op_name : op_names) {
+    if (c10::Dispatcher::singleton().findSchema(op_name).has_value()) {
+      ++found;
+    }
+  }
+  return found;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  // Taken first so that the flags parsing isn't included; std::clock() is the
+  // CPU time of the process, so this is the load and static init time
+  const double static_init_ms = 1000.0 * std::clock() / CLOCKS_PER_SEC;
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cout << "Failed to parse command line flags" << std::endl;
+    return -1;
+  }
+
+  const auto op_names = c10::Dispatcher::singleton().getAllOpNames();
+  std::cout << op_names.size() << " registered operators" << std::endl;
+  report("load + static init (cpu)", static_init_ms);
+
+  auto start = steady_clock::now();
+  const size_t with_schema = findAllSchemas(op_names);
+  report("findSchema of all ops, first", msSince(start));
+  start = steady_clock::now();
+  findAllSchemas(op_names);
+  report("findSchema of all ops, second", msSince(start));
+  std::cout << with_schema << " operators with a schema" << std::endl;
+
+  const auto a = at::ones({1});
+  const auto b = at::ones({1});
+  start = steady_clock::now();
+  at::add(a, b);
+  report("first at::add", msSince(start));
+  start = steady_clock::now();
+  for (int i = 0; i < FLAGS_iter; ++i) {
+    at::add(a, b);
+  }
+  report("steady-state at::add", msSince(start) / FLAGS_iter);
+  return 0;
+}
@@ -19,8 +19,11 @@
 
 #include "ATen/ATen.h"
 #include "caffe2/core/timer.h"
+#include "caffe2/serialize/versions.h"
 #include "caffe2/utils/string_utils.h"
 #include "torch/csrc/autograd/grad_mode.h"
+#include "torch/csrc/jit/mobile/function.h"
+#include "torch/csrc/jit/runtime/instruction.h"
 #include "torch/csrc/jit/serialization/import.h"
 #include "torch/script.h"
 
@@ -69,6 +72,13 @@ C10_DEFINE_bool(
 
 C10_DEFINE_int(pytext_len, 0, "Length of input sequence.");
 C10_DEFINE_bool(vulkan, false, "Whether to use Vulkan backend (GPU).");
+C10_DEFINE_bool(metal, false, "Whether to use Metal backend (GPU).");
+C10_DEFINE_int(
+    interpreter_overhead_iters,
+    0,
+    "If positive, ignore the model and time a loop of this many iterations "
+    "of cheap lite interpreter instructions, to report the overhead of one "
+    "instruction.");
 
 namespace {
 
@@ -191,6 +201,87 @@ class vkRunner final : public Runner {
   std::vector<c10::IValue> inputs_;
 };
 
+class mtRunner final : public Runner {
+ public:
+  virtual ~mtRunner() = default;
+  virtual c10::IValue run(
+      torch::jit::Module& module,
+      const std::vector<c10::IValue>& inputs) override {
+    // Upload the input tensor(s) to GPU memory, as fp16 images which the
+    // model keeps until its output.
+    inputs_.clear();
+    inputs_.reserve(inputs.size());
+    for (const auto& input : inputs) {
+      inputs_.emplace_back(input.toTensor().metal());
+    }
+
+    // Run, encoding the whole forward pass in one command buffer, committed
+    // when the output tensor is downloaded to system memory.
+    return module.forward(inputs_).toTensor().cpu();
+  }
+
+ private:
+  std::vector<c10::IValue> inputs_;
+};
+
+// A lite interpreter function that runs a loop of `iters` iterations, with
+// kInstructionsPerIteration instructions per iteration:
+//
+//   for i in range(iters):
+//     x = i
+//     y = 1 + x
+//   return x
+constexpr int64_t kInstructionsPerIteration = 10;
+
+std::unique_ptr<torch::jit::mobile::Function> create_overhead_function(
+    int64_t iters) {
+  using namespace torch::jit;
+  auto function = std::make_unique<mobile::Function>(
+      c10::QualifiedName("interpreter_overhead"));
+  function->append_constant(int64_t(0));
+  function->append_constant(iters);
+  function->append_constant(true);
+  function->append_constant(int64_t(1));
+  CAFFE_ENFORCE(function->append_operator(
+      "aten::add", "int", caffe2::serialize::kProducedBytecodeVersion));
+  function->set_register_size(2);
+
+  function->append_instruction(LOADC, 0, 0); // trip count
+  function->append_instruction(LOADC, 1, 0); // max trip count
+  function->append_instruction(LOADC, 2, 0); // condition
+  function->append_instruction(LOOP, 10, 2); // 3, exits to 13
+  function->append_instruction(STORE, 1, 0); // x = i
+  function->append_instruction(LOADC, 3, 0);
+  function->append_instruction(LOAD, 1, 0); // LOAD_OP
+  function->append_instruction(OP, 0, 0);
+  function->append_instruction(STORE, 2, 0);
+  function->append_instruction(MOVE, 2, 0);
+  function->append_instruction(DROP, 0, 0);
+  function->append_instruction(LOADC, 2, 0); // condition
+  function->append_instruction(JMP, -9, 0); // back to LOOP
+  function->append_instruction(MOVE, 1, 0); // MOVE_RET
+  function->append_instruction(RET, 0, 0);
+  return function;
+}
+
+void benchmark_interpreter_overhead(int64_t iters) {
+  auto function = create_overhead_function(iters);
+  for (int i = 0; i < FLAGS_warmup; ++i) {
+    std::vector<c10::IValue> stack;
+    function->run(stack);
+  }
+  caffe2::Timer timer;
+  for (int i = 0; i < FLAGS_iter; ++i) {
+    std::vector<c10::IValue> stack;
+    function->run(stack);
+    CAFFE_ENFORCE_EQ(stack.back().toInt(), iters - 1);
+  }
+  const auto nanos = timer.NanoSeconds();
+  std::cout << "Lite interpreter overhead: "
+            << nanos / (FLAGS_iter * iters * kInstructionsPerIteration)
+            << " nanoseconds per instruction." << std::endl;
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
@@ -207,6 +298,11 @@ int main(int argc, char** argv) {
     return 1;
   }
 
+  if (FLAGS_interpreter_overhead_iters > 0) {
+    benchmark_interpreter_overhead(FLAGS_interpreter_overhead_iters);
+    return 0;
+  }
+
   std::vector<c10::IValue> inputs = create_inputs();
 
   torch::autograd::AutoGradMode guard(false);
@@ -231,9 +327,17 @@ int main(int argc, char** argv) {
     inputs = all_inputs.get(FLAGS_use_bundled_input).toTuple()->elements();
   }
 
-  const std::unique_ptr<Runner> runner =
-      FLAGS_vulkan ? std::make_unique<vkRunner>() :
-                     std::make_unique<Runner>();
+  CAFFE_ENFORCE(
+      !(FLAGS_vulkan && FLAGS_metal),
+      "Only one of --vulkan and --metal may be given.");
+  std::unique_ptr<Runner> runner;
+  if (FLAGS_vulkan) {
+    runner = std::make_unique<vkRunner>();
+  } else if (FLAGS_metal) {
+    runner = std::make_unique<mtRunner>();
+  } else {
+    runner = std::make_unique<Runner>();
+  }
 
   module.eval();
   if (FLAGS_print_output) {
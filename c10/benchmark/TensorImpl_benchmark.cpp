@@ -0,0 +1,123 @@
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/TensorImpl.h>
+
+#include <benchmark/benchmark.h>
+
+using c10::intrusive_ptr;
+using c10::make_intrusive;
+using c10::TensorImpl;
+
+namespace {
+
+intrusive_ptr<TensorImpl> make_tensor(c10::IntArrayRef sizes) {
+  int64_t numel = 1;
+  for (auto s : sizes) {
+    numel *= s;
+  }
+  c10::Storage storage(
+      c10::Storage::use_byte_size_t(),
+      numel * sizeof(float),
+      c10::GetCPUAllocator(),
+      /*resizable=*/false);
+  auto impl = make_intrusive<TensorImpl>(
+      std::move(storage),
+      c10::DispatchKeySet(c10::DispatchKey::CPU),
+      caffe2::TypeMeta::Make<float>());
+  impl->set_sizes_contiguous(sizes);
+  return impl;
+}
+
+// A view of base with the given geometry, the way as_strided, narrow and
+// select create one.
+intrusive_ptr<TensorImpl> make_view(
+    const intrusive_ptr<TensorImpl>& base,
+    c10::IntArrayRef sizes,
+    c10::IntArrayRef strides,
+    int64_t storage_offset) {
+  auto impl = make_intrusive<TensorImpl>(
+      c10::Storage(base->storage()), base->key_set(), base->dtype());
+  impl->set_sizes_and_strides(sizes, strides);
+  impl->set_storage_offset(storage_offset);
+  return impl;
+}
+
+// The attention reshape: (batch, seq, heads * head_dim) viewed as
+// (batch, heads, seq, head_dim).
+static void BM_TensorImplStridedView(benchmark::State& state) {
+  auto base = make_tensor({8, 128, 512});
+  while (state.KeepRunning()) {
+    auto view = make_view(
+        base, {8, 8, 128, 64}, {128 * 512, 64, 512, 1}, 0);
+    benchmark::DoNotOptimize(view);
+  }
+}
+BENCHMARK(BM_TensorImplStridedView);
+
+// A chain of narrows of dim 0, every one of which restrides the previous.
+static void BM_TensorImplNarrowChain(benchmark::State& state) {
+  auto base = make_tensor({64, 32, 16});
+  const int64_t length = state.range(0);
+  while (state.KeepRunning()) {
+    auto view = make_view(base, {64, 32, 16}, {512, 16, 1}, 0);
+    for (int64_t i = 0; i < length; ++i) {
+      view->set_sizes_and_strides({64 - i - 1, 32, 16}, {512, 16, 1});
+      view->set_storage_offset(512 * (i + 1));
+    }
+    benchmark::DoNotOptimize(view);
+  }
+}
+BENCHMARK(BM_TensorImplNarrowChain)->RangeMultiplier(2)->Range(1, 32);
+
+static void BM_TensorImplSelect(benchmark::State& state) {
+  auto base = make_tensor({16, 3, 224, 224});
+  while (state.KeepRunning()) {
+    auto view = make_view(base, {3, 224, 224}, {224 * 224, 224, 1}, 0);
+    benchmark::DoNotOptimize(view);
+  }
+}
+BENCHMARK(BM_TensorImplSelect);
+
+// View creation followed by the memory format queries of a typical kernel.
+static void BM_TensorImplViewAndQuery(benchmark::State& state) {
+  auto base = make_tensor({16, 3, 224, 224});
+  while (state.KeepRunning()) {
+    auto view = make_view(
+        base, {16, 3, 224, 224}, {3 * 224 * 224, 1, 224 * 3, 3}, 0);
+    benchmark::DoNotOptimize(view->is_contiguous());
+    benchmark::DoNotOptimize(
+        view->is_contiguous(c10::MemoryFormat::ChannelsLast));
+  }
+}
+BENCHMARK(BM_TensorImplViewAndQuery);
+
+static void BM_TensorImplIsContiguous(benchmark::State& state) {
+  auto base = make_tensor({16, 3, 224, 224});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(base->is_contiguous());
+  }
+}
+BENCHMARK(BM_TensorImplIsContiguous);
+
+static void BM_TensorImplIsNonOverlappingAndDense(benchmark::State& state) {
+  auto base = make_tensor({16, 3, 224, 224});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(base->is_non_overlapping_and_dense());
+    benchmark::DoNotOptimize(base->is_strides_like_channels_last());
+  }
+}
+BENCHMARK(BM_TensorImplIsNonOverlappingAndDense);
+
+static void BM_TensorImplSizesAndStrides(benchmark::State& state) {
+  auto base = make_tensor({16, 3, 224, 224});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(base->sizes());
+    benchmark::DoNotOptimize(base->strides());
+    benchmark::DoNotOptimize(base->numel());
+    benchmark::DoNotOptimize(base->dim());
+  }
+}
+BENCHMARK(BM_TensorImplSizesAndStrides);
+
+} // namespace
+
+BENCHMARK_MAIN();
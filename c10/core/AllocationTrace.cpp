@@ -0,0 +1,297 @@
+#include <c10/core/AllocationTrace.h>
+
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace c10 {
+
+namespace {
+
+struct TraceBuffer {
+  std::mutex mutex;
+  std::vector<AllocationTraceEntry> entries;
+  // index the next entry is written at, once entries is full
+  size_t next = 0;
+  size_t dropped = 0;
+};
+
+std::atomic<bool> trace_enabled{false};
+
+// Leaked, so that the allocations freed by static destructors may still be
+// recorded
+TraceBuffer& traceBuffer() {
+  static TraceBuffer* buffer_ = new TraceBuffer();
+  return *buffer_;
+}
+
+uint64_t currentThreadId() {
+  thread_local uint64_t thread_id =
+      std::hash<std::thread::id>()(std::this_thread::get_id());
+  return thread_id;
+}
+
+thread_local std::vector<const char*> context_stack;
+
+std::string escapeJson(const char* str) {
+  std::string escaped;
+  for (const char* c = str; *c; ++c) {
+    switch (*c) {
+      case '"':
+        escaped += "\\\"";
+        break;
+      case '\\':
+        escaped += "\\\\";
+        break;
+      default:
+        if (static_cast<unsigned char>(*c) < 0x20) {
+          char buf[8];
+          snprintf(buf, sizeof(buf), "\\u%04x", *c);
+          escaped += buf;
+        } else {
+          escaped += *c;
+        }
+    }
+  }
+  return escaped;
+}
+
+const char* contextName(const char* context) {
+  return context ? context : "<unknown>";
+}
+
+} // namespace
+
+const char* allocationTraceActionName(AllocationTraceAction action) {
+  switch (action) {
+    case AllocationTraceAction::ALLOC:
+      return "alloc";
+    case AllocationTraceAction::FREE:
+      return "free";
+    case AllocationTraceAction::SEGMENT_ALLOC:
+      return "segment_alloc";
+    case AllocationTraceAction::SEGMENT_FREE:
+      return "segment_free";
+  }
+  return "unknown";
+}
+
+void enableAllocationTrace(size_t capacity) {
+  TORCH_CHECK(capacity > 0, "The allocation trace capacity must be positive");
+  auto& buffer = traceBuffer();
+  std::lock_guard<std::mutex> guard(buffer.mutex);
+  buffer.entries.clear();
+  buffer.entries.shrink_to_fit();
+  buffer.entries.reserve(capacity);
+  buffer.next = 0;
+  buffer.dropped = 0;
+  trace_enabled.store(true);
+}
+
+void disableAllocationTrace() {
+  trace_enabled.store(false);
+}
+
+bool allocationTraceEnabled() {
+  return trace_enabled.load(std::memory_order_relaxed);
+}
+
+void recordAllocationTrace(
+    AllocationTraceAction action,
+    Device device,
+    const void* addr,
+    size_t size,
+    uintptr_t stream,
+    int64_t allocated,
+    int64_t reserved) {
+  AllocationTraceEntry entry{
+      action,
+      device,
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count(),
+      currentThreadId(),
+      reinterpret_cast<uintptr_t>(addr),
+      size,
+      stream,
+      allocated,
+      reserved,
+      currentAllocationTraceContext()};
+
+  auto& buffer = traceBuffer();
+  std::lock_guard<std::mutex> guard(buffer.mutex);
+  // The trace may have been disabled while waiting for the lock
+  if (!trace_enabled.load(std::memory_order_relaxed)) {
+    return;
+  }
+  if (buffer.entries.size() < buffer.entries.capacity()) {
+    buffer.entries.push_back(entry);
+  } else {
+    buffer.entries[buffer.next] = entry;
+    buffer.next = (buffer.next + 1) % buffer.entries.size();
+    buffer.dropped++;
+  }
+}
+
+std::vector<AllocationTraceEntry> getAllocationTrace() {
+  auto& buffer = traceBuffer();
+  std::lock_guard<std::mutex> guard(buffer.mutex);
+  std::vector<AllocationTraceEntry> result;
+  result.reserve(buffer.entries.size());
+  result.insert(
+      result.end(), buffer.entries.begin() + buffer.next, buffer.entries.end());
+  result.insert(
+      result.end(), buffer.entries.begin(), buffer.entries.begin() + buffer.next);
+  return result;
+}
+
+size_t allocationTraceDropped() {
+  auto& buffer = traceBuffer();
+  std::lock_guard<std::mutex> guard(buffer.mutex);
+  return buffer.dropped;
+}
+
+void exportAllocationTraceChrome(const std::string& path) {
+  const auto entries = getAllocationTrace();
+
+  std::ofstream out(path);
+  TORCH_CHECK(out, "Can't open ", path, " to export the allocation trace");
+
+  // One trace process per device, in the order the devices first appear
+  std::vector<Device> devices;
+  const auto pid = [&](Device device) {
+    auto it = std::find(devices.begin(), devices.end(), device);
+    if (it == devices.end()) {
+      devices.push_back(device);
+      return devices.size() - 1;
+    }
+    return static_cast<size_t>(it - devices.begin());
+  };
+  // Index of the first entry with the most bytes allocated, per device
+  std::vector<size_t> peaks;
+
+  const int64_t start_ns = entries.empty() ? 0 : entries.front().time_ns;
+  char ts[32];
+  char addr[32];
+  bool first = true;
+  out << "{\"traceEvents\": [";
+  const auto sep = [&]() -> std::ostream& {
+    out << (first ? "\n" : ",\n");
+    first = false;
+    return out;
+  };
+
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const auto& entry = entries[i];
+    const size_t device_pid = pid(entry.device);
+    if (device_pid == peaks.size()) {
+      peaks.push_back(i);
+    } else if (entry.allocated > entries[peaks[device_pid]].allocated) {
+      peaks[device_pid] = i;
+    }
+
+    snprintf(ts, sizeof(ts), "%.3f", (entry.time_ns - start_ns) / 1000.);
+    snprintf(addr, sizeof(addr), "0x%" PRIxPTR, entry.addr);
+    sep() << "  {\"name\": \"memory\", \"ph\": \"C\", \"ts\": " << ts
+          << ", \"pid\": " << device_pid << ", \"args\": {\"allocated\": "
+          << entry.allocated << ", \"reserved\": " << entry.reserved << "}}";
+    sep() << "  {\"name\": \"" << allocationTraceActionName(entry.action)
+          << "\", \"ph\": \"i\", \"s\": \"t\", \"ts\": " << ts
+          << ", \"pid\": " << device_pid << ", \"tid\": " << entry.thread_id
+          << ", \"args\": {\"addr\": \"" << addr << "\", \"size\": "
+          << entry.size << ", \"stream\": " << entry.stream
+          << ", \"context\": \"" << escapeJson(contextName(entry.context))
+          << "\"}}";
+  }
+
+  for (size_t device_pid = 0; device_pid < devices.size(); ++device_pid) {
+    sep() << "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": "
+          << device_pid << ", \"args\": {\"name\": \""
+          << devices[device_pid].str() << "\"}}";
+
+    // Replays the allocations of the device up to its peak
+    const size_t peak = peaks[device_pid];
+    std::unordered_map<uintptr_t, const AllocationTraceEntry*> live;
+    for (size_t i = 0; i <= peak; ++i) {
+      const auto& entry = entries[i];
+      if (entry.device != devices[device_pid]) {
+        continue;
+      }
+      if (entry.action == AllocationTraceAction::ALLOC) {
+        live[entry.addr] = &entry;
+      } else if (entry.action == AllocationTraceAction::FREE) {
+        live.erase(entry.addr);
+      }
+    }
+    std::map<std::string, int64_t> by_context;
+    int64_t attributed = 0;
+    for (const auto& kv : live) {
+      by_context[contextName(kv.second->context)] += kv.second->size;
+      attributed += kv.second->size;
+    }
+    if (entries[peak].allocated > attributed) {
+      by_context["<before trace>"] += entries[peak].allocated - attributed;
+    }
+
+    snprintf(ts, sizeof(ts), "%.3f", (entries[peak].time_ns - start_ns) / 1000.);
+    sep() << "  {\"name\": \"peak\", \"ph\": \"i\", \"s\": \"p\", \"ts\": "
+          << ts << ", \"pid\": " << device_pid
+          << ", \"args\": {\"allocated\": " << entries[peak].allocated;
+    for (const auto& kv : by_context) {
+      out << ", \"" << escapeJson(kv.first.c_str()) << "\": " << kv.second;
+    }
+    out << "}}";
+  }
+  out << "\n], \"displayTimeUnit\": \"ns\"}\n";
+  TORCH_CHECK(out, "Failed to write the allocation trace to ", path);
+}
+
+const char* internAllocationTraceContext(c10::string_view name) {
+  // Contexts are looked up in a per thread cache first, to avoid taking the
+  // global lock on every push
+  thread_local std::unordered_map<c10::string_view, const char*> cache;
+  auto it = cache.find(name);
+  if (it != cache.end()) {
+    return it->second;
+  }
+
+  static std::mutex mutex;
+  // Leaked, since the contexts must outlive every thread
+  static auto* names = new std::unordered_set<std::string>();
+  const char* interned = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    interned = names->emplace(name.data(), name.size()).first->c_str();
+  }
+  cache.emplace(c10::string_view(interned, name.size()), interned);
+  return interned;
+}
+
+size_t pushAllocationTraceContext(const char* context) {
+  const size_t depth = context_stack.size();
+  context_stack.push_back(context);
+  return depth;
+}
+
+void restoreAllocationTraceContext(size_t depth) {
+  if (context_stack.size() > depth) {
+    context_stack.resize(depth);
+  }
+}
+
+const char* currentAllocationTraceContext() {
+  return context_stack.empty() ? nullptr : context_stack.back();
+}
+
+} // namespace c10
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <c10/core/Device.h>
+#include <c10/macros/Macros.h>
+#include <c10/util/string_view.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Allocation trace recorder.
+//
+// While enabled, the CPU allocator and the CUDA caching allocator record every
+// allocation and free, and every segment (cudaMalloc'd or mapped memory)
+// they reserve and release, into a fixed size ring buffer, along with the
+// bytes allocated and reserved on the device right after the event and the
+// innermost allocation context of the calling thread (e.g. the operator that
+// is running, see torch/csrc/autograd/profiler_memory_timeline.h). Once full,
+// the oldest entries are overwritten.
+//
+// The trace can be read back with getAllocationTrace, or exported in the
+// Chrome trace format with exportAllocationTraceChrome, which turns it into a
+// memory timeline per device and attributes the peak of each device to the
+// allocation contexts.
+
+namespace c10 {
+
+enum class AllocationTraceAction : uint8_t {
+  ALLOC,
+  FREE,
+  SEGMENT_ALLOC,
+  SEGMENT_FREE,
+};
+
+C10_API const char* allocationTraceActionName(AllocationTraceAction action);
+
+struct C10_API AllocationTraceEntry {
+  AllocationTraceAction action;
+  Device device;
+  // steady clock time
+  int64_t time_ns;
+  uint64_t thread_id;
+  uintptr_t addr;
+  size_t size;
+  // stream the memory was allocated on, 0 on CPU
+  uintptr_t stream;
+  // bytes allocated and reserved on the device after the event
+  int64_t allocated;
+  int64_t reserved;
+  // innermost allocation context of the thread, or nullptr
+  const char* context;
+};
+
+// Starts recording into a new ring buffer of capacity entries, dropping the
+// entries recorded so far
+C10_API void enableAllocationTrace(size_t capacity);
+
+// Stops recording; the entries recorded so far are kept
+C10_API void disableAllocationTrace();
+
+C10_API bool allocationTraceEnabled();
+
+// Called by the allocators when allocationTraceEnabled()
+C10_API void recordAllocationTrace(
+    AllocationTraceAction action,
+    Device device,
+    const void* addr,
+    size_t size,
+    uintptr_t stream,
+    int64_t allocated,
+    int64_t reserved);
+
+// Returns the recorded entries, oldest first
+C10_API std::vector<AllocationTraceEntry> getAllocationTrace();
+
+// Returns the number of entries overwritten since the trace was enabled
+C10_API size_t allocationTraceDropped();
+
+// Writes the recorded entries to path as a Chrome trace: a counter of the
+// allocated and reserved bytes, and an instant event per entry, for each
+// device, plus an instant event at the peak of each device listing the bytes
+// live at the peak by allocation context. Memory allocated before the oldest
+// entry is listed as "<before trace>".
+C10_API void exportAllocationTraceChrome(const std::string& path);
+
+// Returns a copy of name that lives as long as the process, to be used as an
+// allocation context. Names are only copied once.
+C10_API const char* internAllocationTraceContext(c10::string_view name);
+
+// Pushes an interned context onto the context stack of the thread and
+// returns the depth of the stack before the push, to be restored with
+// restoreAllocationTraceContext once the context ends.
+C10_API size_t pushAllocationTraceContext(const char* context);
+C10_API void restoreAllocationTraceContext(size_t depth);
+
+// Innermost context of the thread, or nullptr
+C10_API const char* currentAllocationTraceContext();
+
+struct C10_API AllocationTraceContextGuard {
+  explicit AllocationTraceContextGuard(c10::string_view name)
+      : depth_(pushAllocationTraceContext(internAllocationTraceContext(name))) {}
+
+  ~AllocationTraceContextGuard() {
+    restoreAllocationTraceContext(depth_);
+  }
+
+  AllocationTraceContextGuard(const AllocationTraceContextGuard&) = delete;
+  AllocationTraceContextGuard& operator=(const AllocationTraceContextGuard&) = delete;
+
+ private:
+  size_t depth_;
+};
+
+} // namespace c10
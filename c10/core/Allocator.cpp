@@ -2,6 +2,8 @@
 
 #include <c10/util/ThreadLocalDebugInfo.h>
 
+#include <atomic>
+
 namespace c10 {
 
 static void deleteInefficientStdFunctionContext(void* ptr) {
@@ -34,13 +36,31 @@ at::Allocator* GetAllocator(const at::DeviceType& t) {
   return alloc;
 }
 
+namespace {
+std::atomic<MemoryReportingInfoBase*> global_memory_reporter{nullptr};
+} // namespace
+
+void setGlobalMemoryReporter(MemoryReportingInfoBase* reporter) {
+  global_memory_reporter.store(reporter);
+}
+
 bool memoryProfilingEnabled() {
+  auto* global_reporter_ptr =
+      global_memory_reporter.load(std::memory_order_relaxed);
+  if (global_reporter_ptr && global_reporter_ptr->memoryProfilingEnabled()) {
+    return true;
+  }
   auto* reporter_ptr = static_cast<MemoryReportingInfoBase*>(
       ThreadLocalDebugInfo::get(DebugInfoKind::PROFILER_STATE));
   return reporter_ptr && reporter_ptr->memoryProfilingEnabled();
 }
 
 void reportMemoryUsageToProfiler(void* ptr, int64_t alloc_size, Device device) {
+  auto* global_reporter_ptr =
+      global_memory_reporter.load(std::memory_order_relaxed);
+  if (global_reporter_ptr) {
+    global_reporter_ptr->reportMemoryUsage(ptr, alloc_size, device);
+  }
   auto* reporter_ptr = static_cast<MemoryReportingInfoBase*>(
       ThreadLocalDebugInfo::get(DebugInfoKind::PROFILER_STATE));
   if (reporter_ptr) {
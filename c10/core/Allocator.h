@@ -235,4 +235,10 @@ struct C10_API MemoryReportingInfoBase : public c10::DebugInfoBase {
 C10_API bool memoryProfilingEnabled();
 C10_API void reportMemoryUsageToProfiler(void* ptr, int64_t alloc_size, Device device);
 
+// Sets a process wide reporter that is told about the memory usage of every
+// thread, in addition to the thread local reporter of the profiler; used by
+// always-on memory statistics. The reporter must stay alive until it is
+// unset with nullptr.
+C10_API void setGlobalMemoryReporter(MemoryReportingInfoBase* reporter);
+
 } // namespace c10
@@ -45,6 +45,8 @@ enum class Backend {
   QuantizedXPU,
   Undefined,
   MkldnnCPU,
+  SparseCsrCPU,
+  SparseCsrCUDA,
   NumOptions
 };
 
@@ -93,6 +95,10 @@ static inline Backend toDense(Backend b) {
       return Backend::CUDA;
     case Backend::SparseHIP:
       return Backend::HIP;
+    case Backend::SparseCsrCPU:
+      return Backend::CPU;
+    case Backend::SparseCsrCUDA:
+      return Backend::CUDA;
     case Backend::QuantizedCPU:
       return Backend::QuantizedCPU;
     case Backend::QuantizedCUDA:
@@ -127,6 +133,10 @@ static inline Backend dispatchKeyToBackend(DispatchKey t) {
     return Backend::SparseCUDA;
   } else if (t == DispatchKey::SparseHIP) {
     return Backend::SparseHIP;
+  } else if (t == DispatchKey::SparseCsrCPU) {
+    return Backend::SparseCsrCPU;
+  } else if (t == DispatchKey::SparseCsrCUDA) {
+    return Backend::SparseCsrCUDA;
   } else if (t == DispatchKey::MkldnnCPU) {
     return Backend::MkldnnCPU;
   } else if (t == DispatchKey::QuantizedCPU) {
@@ -170,6 +180,10 @@ static inline DispatchKey backendToDispatchKey(Backend b) {
       return DispatchKey::SparseCUDA;
     case Backend::SparseHIP:
       return DispatchKey::SparseHIP;
+    case Backend::SparseCsrCPU:
+      return DispatchKey::SparseCsrCPU;
+    case Backend::SparseCsrCUDA:
+      return DispatchKey::SparseCsrCUDA;
     case Backend::MkldnnCPU:
       return DispatchKey::MkldnnCPU;
     case Backend::Vulkan:
@@ -207,6 +221,10 @@ static inline DeviceType backendToDeviceType(Backend b) {
       return DeviceType::CUDA;
     case Backend::SparseHIP:
       return DeviceType::HIP;
+    case Backend::SparseCsrCPU:
+      return DeviceType::CPU;
+    case Backend::SparseCsrCUDA:
+      return DeviceType::CUDA;
     case Backend::XPU:
     case Backend::SparseXPU:
     case Backend::QuantizedXPU:
@@ -247,6 +265,10 @@ static inline Backend backendToCPU(Backend b) {
       return Backend::SparseCPU;
     case Backend::SparseXPU:
       return Backend::SparseCPU;
+    case Backend::SparseCsrCPU:
+      return Backend::SparseCsrCPU;
+    case Backend::SparseCsrCUDA:
+      return Backend::SparseCsrCPU;
     case Backend::MSNPU:
     case Backend::XLA:
       return Backend::CPU;
@@ -308,6 +330,9 @@ static inline Backend backendToCUDA(Backend b) {
     case Backend::SparseCUDA:
     case Backend::SparseHIP:
       return Backend::SparseCUDA;
+    case Backend::SparseCsrCPU:
+    case Backend::SparseCsrCUDA:
+      return Backend::SparseCsrCUDA;
     case Backend::Undefined:
       return Backend::Undefined;
     default:
@@ -362,6 +387,10 @@ static inline const char* toString(Backend b) {
       return "SparseHIP";
     case Backend::SparseXPU:
       return "SparseXPU";
+    case Backend::SparseCsrCPU:
+      return "SparseCsrCPU";
+    case Backend::SparseCsrCUDA:
+      return "SparseCsrCUDA";
     case Backend::MkldnnCPU:
       return "MkldnnCPU";
     case Backend::Vulkan:
@@ -391,4 +420,14 @@ static inline bool isSparse(Backend b) {
   }
 }
 
+static inline bool isSparseCsr(Backend b) {
+  switch (b) {
+    case Backend::SparseCsrCPU:
+    case Backend::SparseCsrCUDA:
+      return true;
+    default:
+      return false;
+  }
+}
+
 } // namespace c10
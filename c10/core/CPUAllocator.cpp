@@ -1,7 +1,9 @@
+#include <c10/core/AllocationTrace.h>
 #include <c10/core/CPUAllocator.h>
 #include <c10/core/DeviceType.h>
 #include <c10/mobile/CPUCachingAllocator.h>
 #include <c10/mobile/CPUProfilingAllocator.h>
+#include <c10/util/OverheadProbe.h>
 
 // TODO: rename flags to C10
 C10_DEFINE_bool(
@@ -74,8 +76,13 @@ void* alloc_cpu(size_t nbytes) {
       nbytes,
       " bytes. Buy new RAM!");
 
-  // move data to a thread's NUMA node
-  NUMAMove(data, nbytes, GetCurrentNUMANode());
+  // move data to a thread's NUMA node. Large buffers are mostly written by
+  // parallel_for, whose chunks run on the threads of every NUMA node; their
+  // pages are left to be placed on the node of the thread touching them first.
+  constexpr size_t kNUMAFirstTouchMinBytes = 1 << 20;
+  if (nbytes < kNUMAFirstTouchMinBytes) {
+    NUMAMove(data, nbytes, GetCurrentNUMANode());
+  }
   CHECK(
       !FLAGS_caffe2_cpu_allocator_do_zero_fill ||
       !FLAGS_caffe2_cpu_allocator_do_junk_fill)
@@ -101,6 +108,7 @@ struct C10_API DefaultCPUAllocator final : at::Allocator {
   DefaultCPUAllocator() {}
   ~DefaultCPUAllocator() override {}
   at::DataPtr allocate(size_t nbytes) const override {
+    C10_OVERHEAD_PROBE(ALLOCATOR);
     void* data = alloc_cpu(nbytes);
     profiledCPUMemoryReporter().New(data, nbytes);
     return {data, data, &ReportAndDelete, at::Device(at::DeviceType::CPU)};
@@ -155,8 +163,11 @@ class DefaultMobileCPUAllocator final : public at::Allocator {
     if (C10_UNLIKELY(!pointer)) {
       return;
     }
-    // TODO: enable with better TLS support on mobile
-    // profiledCPUMemoryReporter().Delete(pointer);
+    // Only reported while a memory reporter is installed, e.g. the memory
+    // tracker of the lite interpreter (torch/csrc/jit/mobile/observer.h)
+    if (C10_UNLIKELY(memoryProfilingEnabled())) {
+      profiledCPUMemoryReporter().Delete(pointer);
+    }
     auto allocator_ptr = GetThreadLocalCachingAllocator();
     auto profiling_allocator_ptr = GetThreadLocalProfilingAllocator();
     if (allocator_ptr != nullptr) {
@@ -200,7 +211,9 @@ class DefaultMobileCPUAllocator final : public at::Allocator {
         allocation_planner->record_allocation(alloc_size, data);
       }
     }
-    //  profiledCPUMemoryReporter().New(data, alloc_size);
+    if (C10_UNLIKELY(memoryProfilingEnabled())) {
+      profiledCPUMemoryReporter().New(data, alloc_size);
+    }
     return {
         reinterpret_cast<uint8_t*>(data) + PreGuardBytes,
         data,
@@ -264,8 +277,9 @@ void ProfiledCPUMemoryReporter::New(void* ptr, size_t nbytes) {
     return;
   }
   auto profile_memory = memoryProfilingEnabled();
+  auto trace = allocationTraceEnabled();
   size_t allocated = 0;
-  if (FLAGS_caffe2_report_cpu_memory_usage || profile_memory) {
+  if (FLAGS_caffe2_report_cpu_memory_usage || profile_memory || trace) {
     std::lock_guard<std::mutex> guard(mutex_);
     size_table_[ptr] = nbytes;
     allocated_ += nbytes;
@@ -278,13 +292,25 @@ void ProfiledCPUMemoryReporter::New(void* ptr, size_t nbytes) {
   if (profile_memory) {
     reportMemoryUsageToProfiler(ptr, nbytes, c10::Device(c10::DeviceType::CPU));
   }
+  if (trace) {
+    // CPU memory is not cached, so reserved is allocated
+    recordAllocationTrace(
+        AllocationTraceAction::ALLOC,
+        c10::Device(c10::DeviceType::CPU),
+        ptr,
+        nbytes,
+        0,
+        allocated,
+        allocated);
+  }
 }
 
 void ProfiledCPUMemoryReporter::Delete(void* ptr) {
   size_t nbytes = 0;
   auto profile_memory = memoryProfilingEnabled();
+  auto trace = allocationTraceEnabled();
   size_t allocated = 0;
-  if (FLAGS_caffe2_report_cpu_memory_usage || profile_memory) {
+  if (FLAGS_caffe2_report_cpu_memory_usage || profile_memory || trace) {
     std::lock_guard<std::mutex> guard(mutex_);
     auto it = size_table_.find(ptr);
     if (it != size_table_.end()) {
@@ -309,6 +335,16 @@ void ProfiledCPUMemoryReporter::Delete(void* ptr) {
     reportMemoryUsageToProfiler(
         ptr, -nbytes, c10::Device(c10::DeviceType::CPU));
   }
+  if (trace) {
+    recordAllocationTrace(
+        AllocationTraceAction::FREE,
+        c10::Device(c10::DeviceType::CPU),
+        ptr,
+        nbytes,
+        0,
+        allocated,
+        allocated);
+  }
 }
 
 C10_API at::Allocator* cpu_caching_alloc = nullptr;
@@ -0,0 +1,362 @@
+#include <c10/core/CPUArenaAllocator.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/util/numa.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace c10 {
+namespace CPUArenaAllocator {
+
+namespace {
+
+constexpr size_t kMinBlockSize = 64; // smallest size class is 64 bytes
+constexpr size_t kNumSizeClasses = 17; // size classes from 64 bytes to 4 MiB
+constexpr size_t kMaxCachedSize = kMinBlockSize << (kNumSizeClasses - 1);
+constexpr size_t kMaxArenaCachedBytes = 268435456; // an arena caches at most 256 MiB
+constexpr uint32_t kUncached = kNumSizeClasses; // size class of larger blocks
+
+struct Arena;
+
+// Lives in front of the data of every block, so that freeing a block needs
+// no lookup and DataPtr's data and context stay the same pointer.
+struct BlockHeader {
+  Arena* arena; // arena that allocated the block
+  size_t size; // usable size in bytes
+  uint32_t size_class; // index of the size class, or kUncached
+  BlockHeader* next; // next cached block of the same size class
+};
+
+constexpr size_t kHeaderSize =
+    ((sizeof(BlockHeader) + gAlignment - 1) / gAlignment) * gAlignment;
+
+struct Arena {
+  // Only contended when blocks are freed by another thread.
+  std::mutex mutex;
+  int numa_node;
+  bool owned; // guarded by the registry mutex
+  std::array<BlockHeader*, kNumSizeClasses> free_lists;
+  size_t cached_bytes;
+  ArenaStats stats;
+
+  explicit Arena(int numa_node)
+      : numa_node(numa_node), owned(false), free_lists(), cached_bytes(0) {}
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<Arena*> arenas;
+};
+
+// Arenas are never destroyed: blocks may be freed after their thread exited,
+// and at process exit after static destructors ran.
+Registry& registry() {
+  static Registry* registry_ = new Registry();
+  return *registry_;
+}
+
+void update_stat(Stat& stat, int64_t amount) {
+  stat.current += amount;
+  stat.peak = std::max(stat.current, stat.peak);
+  if (amount > 0) {
+    stat.allocated += amount;
+  }
+  if (amount < 0) {
+    stat.freed += -amount;
+  }
+}
+
+void add_stat(Stat& sum, const Stat& stat) {
+  sum.current += stat.current;
+  sum.peak += stat.peak;
+  sum.allocated += stat.allocated;
+  sum.freed += stat.freed;
+}
+
+uint32_t size_class(size_t nbytes) {
+  if (nbytes > kMaxCachedSize) {
+    return kUncached;
+  }
+  uint32_t cls = 0;
+  size_t cls_size = kMinBlockSize;
+  while (cls_size < nbytes) {
+    cls_size <<= 1;
+    ++cls;
+  }
+  return cls;
+}
+
+// Detaches all cached blocks of an arena. Requires arena->mutex.
+BlockHeader* take_cached_blocks(Arena* arena) {
+  BlockHeader* blocks = nullptr;
+  for (auto& head : arena->free_lists) {
+    while (head != nullptr) {
+      BlockHeader* block = head;
+      head = block->next;
+      block->next = blocks;
+      blocks = block;
+      update_stat(arena->stats.reserved_bytes, -block->size);
+    }
+  }
+  arena->cached_bytes = 0;
+  return blocks;
+}
+
+void free_blocks(BlockHeader* blocks) {
+  while (blocks != nullptr) {
+    BlockHeader* next = blocks->next;
+    free_cpu(blocks);
+    blocks = next;
+  }
+}
+
+void release_cached_blocks(Arena* arena) {
+  BlockHeader* blocks = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(arena->mutex);
+    blocks = take_cached_blocks(arena);
+  }
+  free_blocks(blocks);
+}
+
+// Arena used by the calling thread, or nullptr if it hasn't allocated yet.
+thread_local Arena* tls_arena = nullptr;
+
+// Gives the thread's arena up when the thread exits.
+struct ArenaOwner {
+  ~ArenaOwner() {
+    release();
+  }
+
+  void release() {
+    Arena* arena = tls_arena;
+    if (arena == nullptr) {
+      return;
+    }
+    tls_arena = nullptr;
+    release_cached_blocks(arena);
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    arena->owned = false;
+  }
+
+  // Takes an unowned arena of the given NUMA node, or creates one.
+  void adopt(int numa_node) {
+    release();
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    Arena* arena = nullptr;
+    for (Arena* candidate : reg.arenas) {
+      if (!candidate->owned && candidate->numa_node == numa_node) {
+        arena = candidate;
+        break;
+      }
+    }
+    if (arena == nullptr) {
+      arena = new Arena(numa_node);
+      reg.arenas.push_back(arena);
+    }
+    arena->owned = true;
+    tls_arena = arena;
+  }
+};
+
+thread_local ArenaOwner tls_arena_owner;
+
+Arena* local_arena() {
+  Arena* arena = tls_arena;
+  if (C10_UNLIKELY(arena == nullptr)) {
+    tls_arena_owner.adopt(GetCurrentNUMANode());
+    return tls_arena;
+  }
+  if (IsNUMAEnabled()) {
+    const int numa_node = GetCurrentNUMANode();
+    if (C10_UNLIKELY(numa_node != arena->numa_node)) {
+      tls_arena_owner.adopt(numa_node);
+      return tls_arena;
+    }
+  }
+  return arena;
+}
+
+void fill_reused(void* data, size_t nbytes) {
+  if (FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+    memset(data, 0, nbytes);
+  } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+    memset_junk(data, nbytes);
+  }
+}
+
+void* data_of(BlockHeader* block) {
+  return reinterpret_cast<char*>(block) + kHeaderSize;
+}
+
+BlockHeader* header_of(void* data) {
+  return reinterpret_cast<BlockHeader*>(static_cast<char*>(data) - kHeaderSize);
+}
+
+struct ArenaAllocator final : at::Allocator {
+  at::DataPtr allocate(size_t nbytes) const override {
+    if (nbytes == 0) {
+      return {nullptr, nullptr, &Delete, at::Device(at::DeviceType::CPU)};
+    }
+
+    const uint32_t cls = size_class(nbytes);
+    const size_t size = cls == kUncached ? nbytes : kMinBlockSize << cls;
+    Arena* arena = local_arena();
+
+    BlockHeader* block = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(arena->mutex);
+      if (cls != kUncached && arena->free_lists[cls] != nullptr) {
+        block = arena->free_lists[cls];
+        arena->free_lists[cls] = block->next;
+        arena->cached_bytes -= size;
+        arena->stats.num_cache_hits += 1;
+        update_stat(arena->stats.allocation, 1);
+        update_stat(arena->stats.allocated_bytes, size);
+      }
+    }
+
+    if (block != nullptr) {
+      fill_reused(data_of(block), nbytes);
+    } else {
+      void* base = alloc_cpu(kHeaderSize + size);
+      block = new (base) BlockHeader{arena, size, cls, nullptr};
+
+      std::lock_guard<std::mutex> lock(arena->mutex);
+      arena->stats.num_cache_misses += 1;
+      update_stat(arena->stats.allocation, 1);
+      update_stat(arena->stats.allocated_bytes, size);
+      update_stat(arena->stats.reserved_bytes, size);
+    }
+
+    void* data = data_of(block);
+    profiledCPUMemoryReporter().New(data, nbytes);
+    return {data, data, &Delete, at::Device(at::DeviceType::CPU)};
+  }
+
+  static void Delete(void* ptr) {
+    if (!ptr) {
+      return;
+    }
+    profiledCPUMemoryReporter().Delete(ptr);
+
+    BlockHeader* block = header_of(ptr);
+    Arena* arena = block->arena;
+    bool cached = false;
+    {
+      std::lock_guard<std::mutex> lock(arena->mutex);
+      update_stat(arena->stats.allocation, -1);
+      update_stat(arena->stats.allocated_bytes, -block->size);
+      if (tls_arena != arena) {
+        arena->stats.num_cross_thread_frees += 1;
+      }
+      if (block->size_class != kUncached &&
+          arena->cached_bytes + block->size <= kMaxArenaCachedBytes) {
+        block->next = arena->free_lists[block->size_class];
+        arena->free_lists[block->size_class] = block;
+        arena->cached_bytes += block->size;
+        cached = true;
+      } else {
+        update_stat(arena->stats.reserved_bytes, -block->size);
+      }
+    }
+    if (!cached) {
+      free_cpu(block);
+    }
+  }
+
+  at::DeleterFnPtr raw_deleter() const override {
+    return &Delete;
+  }
+};
+
+ArenaAllocator g_arena_allocator;
+
+#ifndef C10_MOBILE
+struct RegisterFromEnvironment {
+  RegisterFromEnvironment() {
+    if (std::getenv("PYTORCH_CPU_ARENA_ALLOCATOR") != nullptr) {
+      // Takes precedence over the default CPU allocator, which is registered
+      // with priority 0.
+      SetCPUAllocator(&g_arena_allocator, /*priority=*/1);
+    }
+  }
+};
+
+RegisterFromEnvironment g_register_from_environment;
+#endif
+
+} // namespace
+
+at::Allocator* get() {
+  return &g_arena_allocator;
+}
+
+ArenaStats getStats() {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> registry_lock(reg.mutex);
+  ArenaStats result;
+  for (Arena* arena : reg.arenas) {
+    std::lock_guard<std::mutex> lock(arena->mutex);
+    const ArenaStats& stats = arena->stats;
+    add_stat(result.allocation, stats.allocation);
+    add_stat(result.allocated_bytes, stats.allocated_bytes);
+    add_stat(result.reserved_bytes, stats.reserved_bytes);
+    result.num_cache_hits += stats.num_cache_hits;
+    result.num_cache_misses += stats.num_cache_misses;
+    result.num_cross_thread_frees += stats.num_cross_thread_frees;
+  }
+  result.num_arenas = reg.arenas.size();
+  return result;
+}
+
+void resetAccumulatedStats() {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> registry_lock(reg.mutex);
+  for (Arena* arena : reg.arenas) {
+    std::lock_guard<std::mutex> lock(arena->mutex);
+    ArenaStats& stats = arena->stats;
+    for (Stat* stat :
+         {&stats.allocation, &stats.allocated_bytes, &stats.reserved_bytes}) {
+      stat->allocated = 0;
+      stat->freed = 0;
+    }
+    stats.num_cache_hits = 0;
+    stats.num_cache_misses = 0;
+    stats.num_cross_thread_frees = 0;
+  }
+}
+
+void resetPeakStats() {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> registry_lock(reg.mutex);
+  for (Arena* arena : reg.arenas) {
+    std::lock_guard<std::mutex> lock(arena->mutex);
+    ArenaStats& stats = arena->stats;
+    for (Stat* stat :
+         {&stats.allocation, &stats.allocated_bytes, &stats.reserved_bytes}) {
+      stat->peak = stat->current;
+    }
+  }
+}
+
+void emptyCache() {
+  Registry& reg = registry();
+  std::vector<Arena*> arenas;
+  {
+    std::lock_guard<std::mutex> registry_lock(reg.mutex);
+    arenas = reg.arenas;
+  }
+  for (Arena* arena : arenas) {
+    release_cached_blocks(arena);
+  }
+}
+
+} // namespace CPUArenaAllocator
+} // namespace c10
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <c10/core/Allocator.h>
+#include <c10/macros/Macros.h>
+
+#include <cstdint>
+
+namespace c10 {
+
+// CPUArenaAllocator is an opt-in caching allocator for CPU tensors.
+//
+// - Every thread allocates from its own arena. An arena caches freed blocks
+//   in power-of-two size classes from 64 bytes to 4 MiB, so that repeated
+//   allocations of small intermediates don't go back to posix_memalign.
+//   Larger requests are passed through to alloc_cpu/free_cpu.
+// - A block freed on another thread is returned to the arena that
+//   allocated it. When a thread exits, its arena gives its cached blocks back
+//   to the system and is reused by the next thread that starts allocating.
+// - If NUMA is enabled (see c10/util/numa.h), arenas are tied to the NUMA
+//   node of the thread that uses them, and a thread that migrates to another
+//   node switches to an arena of that node.
+//
+// The allocator is installed as the CPU allocator by setting
+// PYTORCH_CPU_ARENA_ALLOCATOR=1 in the environment, or explicitly with
+// SetCPUAllocator(CPUArenaAllocator::get(), priority).
+
+namespace CPUArenaAllocator {
+
+struct Stat {
+  int64_t current = 0;
+  int64_t peak = 0;
+  int64_t allocated = 0;
+  int64_t freed = 0;
+};
+
+// Struct containing allocator summary statistics, summed over all arenas.
+// Peaks are the sum of the per-arena peaks, which bounds the peak of the
+// total from above.
+struct ArenaStats {
+  // COUNT: allocations requested by client code
+  Stat allocation;
+  // SUM: bytes of the blocks handed out to client code
+  Stat allocated_bytes;
+  // SUM: bytes held by the allocator (both cached and in use)
+  Stat reserved_bytes;
+
+  // COUNT: allocations served from an arena's cache
+  int64_t num_cache_hits = 0;
+  // COUNT: allocations that had to get memory from the system
+  int64_t num_cache_misses = 0;
+  // COUNT: blocks freed by a thread other than the one that allocated them
+  int64_t num_cross_thread_frees = 0;
+  // COUNT: arenas created so far
+  int64_t num_arenas = 0;
+};
+
+C10_API at::Allocator* get();
+C10_API ArenaStats getStats();
+C10_API void resetAccumulatedStats();
+C10_API void resetPeakStats();
+// Returns all cached (unused) blocks of all arenas to the system.
+C10_API void emptyCache();
+
+} // namespace CPUArenaAllocator
+} // namespace c10
@@ -58,6 +58,10 @@ const char* toString(DispatchKey t) {
       return "SparseHIP";
     case DispatchKey::SparseXPU:
       return "SparseXPU";
+    case DispatchKey::SparseCsrCPU:
+      return "SparseCsrCPU";
+    case DispatchKey::SparseCsrCUDA:
+      return "SparseCsrCUDA";
 
     case DispatchKey::NestedTensor:
       return "NestedTensor";
@@ -98,6 +102,8 @@ const char* toString(DispatchKey t) {
     case DispatchKey::Tracer:
       return "Tracer";
 
+    case DispatchKey::AutocastCPU:
+      return "AutocastCPU";
     case DispatchKey::Autocast:
       return "Autocast";
 
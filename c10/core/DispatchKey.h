@@ -109,6 +109,8 @@ enum class DispatchKey : uint8_t {
   SparseHIP, // TODO: I think this is not actually used, due to Note
   // [Masquerading as CUDA]
   SparseXPU, // For out of tree Intel's heterogeneous computing plug-in
+  SparseCsrCPU, // registered at build/aten/src/ATen/RegisterSparseCsrCPU.cpp
+  SparseCsrCUDA, // registered at build/aten/src/ATen/RegisterSparseCsrCUDA.cpp
 
   NestedTensor, // lives out of tree at https://github.com/pytorch/nestedtensor
   // Here are reserved backends for user-defined backends, see Note [Private use
@@ -237,6 +239,8 @@ enum class DispatchKey : uint8_t {
 
   // Autocasting precedes VariableTypeId, to ensure casts are autograd-exposed
   // and inputs are saved for backward in the post-autocast type.
+  // AutocastCPU casts the CPU ops to bfloat16, Autocast the CUDA ops to float16.
+  AutocastCPU,
   Autocast,
 
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~ WRAPPERS ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
@@ -222,6 +222,8 @@ constexpr DispatchKeySet autogradother_backends = DispatchKeySet({
   DispatchKey::SparseCPU,
   DispatchKey::SparseCUDA,
   DispatchKey::SparseHIP,
+  DispatchKey::SparseCsrCPU,
+  DispatchKey::SparseCsrCUDA,
   DispatchKey::Meta,
 });
 
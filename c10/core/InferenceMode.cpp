@@ -0,0 +1,37 @@
+#include <c10/core/InferenceMode.h>
+
+namespace c10 {
+
+namespace {
+
+thread_local bool InferenceMode_enabled = false;
+
+} // namespace
+
+InferenceMode::InferenceMode(bool enabled)
+    : prev_mode_(InferenceMode_enabled),
+      prev_keyset_(impl::tls_local_dispatch_key_set()) {
+  impl::LocalDispatchKeySet keyset = prev_keyset_;
+  if (enabled) {
+    keyset.excluded_ = keyset.excluded_ | autograd_dispatch_keyset;
+  } else {
+    keyset.excluded_ = keyset.excluded_ - autograd_dispatch_keyset;
+  }
+  impl::_force_tls_local_dispatch_key_set(keyset);
+  InferenceMode_enabled = enabled;
+}
+
+InferenceMode::~InferenceMode() {
+  InferenceMode_enabled = prev_mode_;
+  impl::_force_tls_local_dispatch_key_set(prev_keyset_);
+}
+
+bool InferenceMode::is_enabled() {
+  return InferenceMode_enabled;
+}
+
+void InferenceMode::_set_enabled(bool enabled) {
+  InferenceMode_enabled = enabled;
+}
+
+} // namespace c10
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <c10/core/impl/LocalDispatchKeySet.h>
+#include <c10/macros/Macros.h>
+
+namespace c10 {
+
+// Note [Inference mode]
+// ~~~~~~~~~~~~~~~~~~~~~
+// Inference mode is a thread local (!) mode for code that will never run
+// backward, e.g. serving a model. It removes the per-op and per-tensor
+// overhead of autograd that no_grad still pays:
+//
+//  - The autograd dispatch keys are excluded, so every op goes straight to
+//    the kernel of the first key after autograd (usually the backend kernel)
+//    instead of through the autograd kernel and a redispatch. The tracer,
+//    vmap and any other key in front of autograd still run, as well as the
+//    RecordFunction callbacks of the profiler.
+//
+//  - Grad mode is disabled, and it cannot be enabled again inside inference
+//    mode (at::GradMode::set_enabled is a no-op there).
+//
+//  - Tensors created in inference mode ("inference tensors") have no version
+//    counter, which saves an allocation per tensor. They never have autograd
+//    metadata, as nothing in inference mode requires grad. Outside of
+//    inference mode they can be used as regular inputs, but they cannot be
+//    saved for backward or modified in-place, because neither can be checked
+//    without a version counter.
+struct C10_API InferenceMode {
+  // Enables (or disables, for code that needs autograd inside an inference
+  // region) inference mode until the guard is destroyed.
+  InferenceMode(bool enabled = true);
+  ~InferenceMode();
+
+  InferenceMode(const InferenceMode&) = delete;
+  InferenceMode& operator=(const InferenceMode&) = delete;
+  InferenceMode(InferenceMode&&) = delete;
+  InferenceMode& operator=(InferenceMode&&) = delete;
+
+  static bool is_enabled();
+
+  // Internal, use InferenceMode or ThreadLocalStateGuard
+  static void _set_enabled(bool enabled);
+
+ private:
+  bool prev_mode_;
+  impl::LocalDispatchKeySet prev_keyset_;
+};
+
+} // namespace c10
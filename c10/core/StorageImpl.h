@@ -2,6 +2,7 @@
 
 #include <c10/core/Allocator.h>
 #include <c10/core/ScalarType.h>
+#include <c10/core/impl/SmallObjectPool.h>
 
 #include <c10/util/intrusive_ptr.h>
 
@@ -9,6 +10,9 @@ namespace c10 {
 
 struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
  public:
+  // See Note [Small object pool]
+  C10_SMALL_OBJECT_POOL_ALLOCATION_FUNCTIONS
+
   struct use_byte_size_t {};
 
   StorageImpl(
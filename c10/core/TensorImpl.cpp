@@ -67,6 +67,9 @@ TensorImpl::TensorImpl(DispatchKeySet key_set, const caffe2::TypeMeta data_type,
 TensorImpl::TensorImpl(Storage&& storage, DispatchKeySet key_set, const caffe2::TypeMeta data_type,
                        c10::optional<c10::Device> device_opt)
     : storage_(std::move(storage)),
+      version_counter_(
+          InferenceMode::is_enabled() ? VariableVersion(VariableVersion::DISABLED)
+                                      : VariableVersion(0)),
       storage_offset_(0),
       numel_(0),
       data_type_(data_type),
@@ -213,6 +216,59 @@ bool TensorImpl::compute_non_overlapping_and_dense() const {
   return true;
 }
 
+uint8_t TensorImpl::compute_memory_format_flags() const {
+  uint8_t flags = kMemoryFormatFlagsValid;
+  const bool is_contiguous = compute_contiguous();
+  bool is_channels_last_contiguous = false;
+  bool is_channels_last_3d_contiguous = false;
+  bool is_channels_last = false;
+  bool is_channels_last_3d = false;
+  // Note:
+  // Dim 0, 1, 2 will never be a channels last 2d/3d format
+  // Dim 3+ is possibly be a channels last 2d format (Dim 4 only at this point)
+  // Dim 4+ is possibly be a channels last 3d format (Dim 5 only at this point)
+  // is_channels_last and is_channels_last_3d are suggested memory_format.
+  // Being channels_last_contiguous doesn't necessarily mean the tensor is
+  // strided like channels_last: for strides on channel dimension could suggest
+  // desired memory_layout, but it doesn't affect memory storage
+  switch (dim()) {
+    case 4:
+      is_channels_last_contiguous = compute_channels_last_contiguous_2d();
+      is_channels_last = compute_strides_like_channels_last_2d();
+      break;
+    case 5:
+      is_channels_last_contiguous = compute_channels_last_contiguous_2d();
+      is_channels_last_3d_contiguous = !is_channels_last_contiguous && compute_channels_last_contiguous_3d();
+      is_channels_last = !is_channels_last_3d_contiguous && compute_strides_like_channels_last_2d();
+      is_channels_last_3d = !is_channels_last && compute_strides_like_channels_last_3d();
+      break;
+    default:
+      break;
+  }
+  const bool is_non_overlapping_and_dense = is_contiguous ||
+      is_channels_last_contiguous || is_channels_last_3d_contiguous ||
+      compute_non_overlapping_and_dense();
+  if (is_contiguous) {
+    flags |= kContiguous;
+  }
+  if (is_channels_last_contiguous) {
+    flags |= kChannelsLastContiguous;
+  }
+  if (is_channels_last_3d_contiguous) {
+    flags |= kChannelsLast3dContiguous;
+  }
+  if (is_channels_last) {
+    flags |= kChannelsLast;
+  }
+  if (is_channels_last_3d) {
+    flags |= kChannelsLast3d;
+  }
+  if (is_non_overlapping_and_dense) {
+    flags |= kNonOverlappingAndDense;
+  }
+  return flags;
+}
+
 void TensorImpl::release_resources() {
   autograd_meta_.reset();
   if (storage_) {
@@ -243,16 +299,17 @@ bool TensorImpl::has_storage() const {
 #endif
 
 bool TensorImpl::is_contiguous(at::MemoryFormat memory_format) const {
+  const uint8_t flags = memory_format_flags();
 #ifdef DEBUG
-  AT_ASSERT(compute_contiguous() == is_contiguous_);
+  AT_ASSERT(compute_contiguous() == static_cast<bool>(flags & kContiguous));
 #endif
   if (memory_format == at::MemoryFormat::ChannelsLast) {
-      return is_channels_last_contiguous_;
+      return flags & kChannelsLastContiguous;
   }
   else if (memory_format == at::MemoryFormat::ChannelsLast3d) {
-      return is_channels_last_3d_contiguous_;
+      return flags & kChannelsLast3dContiguous;
   }
-  return is_contiguous_;
+  return flags & kContiguous;
 }
 
 const Storage& TensorImpl::storage() const {
@@ -350,12 +407,9 @@ void TensorImpl::copy_tensor_metadata_except_version_counter(
   dest_impl->data_type_ = src_impl->data_type_;
   dest_impl->device_opt_ = src_impl->device_opt_;
   dest_impl->key_set_ = src_impl->key_set_;
-  dest_impl->is_contiguous_ = src_impl->is_contiguous_;
-  dest_impl->is_channels_last_contiguous_ = src_impl->is_channels_last_contiguous_;
-  dest_impl->is_channels_last_3d_contiguous_ = src_impl->is_channels_last_3d_contiguous_;
-  dest_impl->is_channels_last_ = src_impl->is_channels_last_;
-  dest_impl->is_channels_last_3d_ = src_impl->is_channels_last_3d_;
-  dest_impl->is_non_overlapping_and_dense_ = src_impl->is_non_overlapping_and_dense_;
+  dest_impl->memory_format_flags_.store(
+      src_impl->memory_format_flags_.load(std::memory_order_relaxed),
+      std::memory_order_relaxed);
   dest_impl->is_wrapped_number_ = src_impl->is_wrapped_number_;
   dest_impl->reserved_ = src_impl->reserved_;
   dest_impl->set_allow_tensor_metadata_change(allow_tensor_metadata_change);
@@ -10,8 +10,10 @@
 #include <c10/core/Storage.h>
 #include <c10/core/TensorOptions.h>
 #include <c10/core/DispatchKeySet.h>
+#include <c10/core/InferenceMode.h>
 #include <c10/core/impl/LocalDispatchKeySet.h>
 #include <c10/core/impl/SizesAndStrides.h>
+#include <c10/core/impl/SmallObjectPool.h>
 #include <c10/core/CopyBytes.h>
 
 
@@ -135,6 +137,9 @@ struct C10_API PlacementDeleteContext {
 struct TensorImpl;
 
 struct C10_API AutogradMetaInterface {
+  // See Note [Small object pool]
+  C10_SMALL_OBJECT_POOL_ALLOCATION_FUNCTIONS
+
   virtual void set_requires_grad(bool requires_grad, at::TensorImpl* self_impl) = 0;
   virtual bool requires_grad() const = 0;
   virtual at::Tensor& mutable_grad() = 0;
@@ -238,11 +243,30 @@ struct C10_API VariableVersion {
   VariableVersion(uint32_t version = 0)
       : version_counter_(c10::make_intrusive<VersionCounter>(version)) {}
 
-  void bump() noexcept {
-    ++version_counter_->version_;
+  // A version counter that doesn't track anything, for the tensors created in
+  // inference mode. See Note [Inference mode]
+  enum Disabled { DISABLED };
+  VariableVersion(Disabled) noexcept {}
+
+  bool enabled() const noexcept {
+    return version_counter_.defined();
+  }
+
+  void bump() {
+    TORCH_CHECK(
+        version_counter_ || InferenceMode::is_enabled(),
+        "Inplace update to a tensor created in inference mode is not allowed "
+        "outside of inference mode.");
+    if (version_counter_) {
+      ++version_counter_->version_;
+    }
   }
 
-  uint32_t current_version() const noexcept {
+  uint32_t current_version() const {
+    TORCH_CHECK(
+        version_counter_,
+        "Tensors created in inference mode do not track their version, "
+        "which is required to save them for backward.");
     return version_counter_->version_;
   }
 };
@@ -336,6 +360,9 @@ struct C10_API VariableVersion {
 struct C10_API TensorImpl : public c10::intrusive_ptr_target {
   TensorImpl() = delete;
 
+  // See Note [Small object pool]
+  C10_SMALL_OBJECT_POOL_ALLOCATION_FUNCTIONS
+
   /**
    * Construct a 1-dim 0-size tensor backed by the given storage.
    */
@@ -490,6 +517,12 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
         key_set_.has(DispatchKey::SparseXPU);
   }
 
+  bool is_sparse_csr() const {
+    // NB: This method is not virtual and avoid dispatches for performance reasons.
+    return key_set_.has(DispatchKey::SparseCsrCPU) ||
+        key_set_.has(DispatchKey::SparseCsrCUDA);
+  }
+
   bool is_quantized() const {
     // NB: This method is not virtual and avoid dispatches for performance reasons.
     return key_set_.has(DispatchKey::QuantizedCPU) ||
@@ -506,6 +539,7 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     // NB: This method is not virtual and avoid dispatches for performance reasons.
     return key_set_.has(DispatchKey::CUDA) ||
         key_set_.has(DispatchKey::SparseCUDA) ||
+        key_set_.has(DispatchKey::SparseCsrCUDA) ||
         key_set_.has(DispatchKey::QuantizedCUDA);
   }
 
@@ -567,6 +601,8 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     // NB: This method is not virtual and avoid dispatches for perf.
     if (is_sparse()) {
       return kSparse;
+    } else if (is_sparse_csr()) {
+      return kSparseCsr;
     } else if (is_mkldnn()) {
       return kMkldnn;
     } else {
@@ -1058,10 +1094,18 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     return version_counter_;
   }
 
-  void bump_version() noexcept {
+  void bump_version() {
     version_counter_.bump();
   }
 
+  /**
+   * Whether or not the tensor was created in inference mode, in which case it
+   * has no version counter. See Note [Inference mode]
+   */
+  bool is_inference() const noexcept {
+    return !version_counter_.enabled();
+  }
+
   inline void set_pyobj(PyObject* pyobj) noexcept {
     pyobj_ = pyobj;
   }
@@ -1106,7 +1150,7 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     TORCH_CHECK(sizes_and_strides_.size() >= 1u);
     TORCH_CHECK(num >= 0, "`num` must be non-negative for Extend");
     TORCH_CHECK(
-        is_contiguous_,
+        memory_format_flags() & kContiguous,
         "Right now Extend is only supported for contiguous Tensor.");
     using SizesVector = SmallVector<int64_t, 5>;
     SizesVector newDims(sizes_and_strides_.sizes_begin(), sizes_and_strides_.sizes_end());
@@ -1169,7 +1213,7 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
   template <class T>
   void ReserveSpace(const T& outer_dim) {
     TORCH_CHECK(
-        is_contiguous_,
+        memory_format_flags() & kContiguous,
         "Right now ReserveSpace is only supported for contiguous Tensor.");
     TORCH_CHECK(
         storage_.unique(), "Can't call ReserveSpace on shared storage.");
@@ -1245,7 +1289,7 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
    */
   inline void Reshape(const std::vector<int64_t>& dims) {
     TORCH_CHECK(
-        is_contiguous_,
+        memory_format_flags() & kContiguous,
         "Right now Reshape is only supported for contiguous Tensor.");
     int64_t new_size = 1;
     for (auto d : dims) {
@@ -1512,15 +1556,15 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
   }
 
   bool is_strides_like_channels_last() const {
-    return is_channels_last_;
+    return memory_format_flags() & kChannelsLast;
   }
 
   bool is_strides_like_channels_last_3d() const {
-    return is_channels_last_3d_;
+    return memory_format_flags() & kChannelsLast3d;
   }
 
   bool is_non_overlapping_and_dense() const {
-    return is_non_overlapping_and_dense_;
+    return memory_format_flags() & kNonOverlappingAndDense;
   }
 
 private:
@@ -1618,43 +1662,65 @@ protected:
   }
 
   /**
-   * Recompute the cached contiguity of a tensor.  Call this if you modify sizes
-   * or strides.
+   * Invalidate the cached contiguity of a tensor.  Call this if you modify sizes
+   * or strides.  See Note [Lazily computed memory format flags].
    */
   void refresh_contiguous() {
-    is_contiguous_ = compute_contiguous();
-    // Note:
-    // Dim 0, 1, 2 will never be a channels last 2d/3d format
-    // Dim 3+ is possibly be a channels last 2d format (Dim 4 only at this point)
-    // Dim 4+ is possibly be a channels last 3d format (Dim 5 only at this point)
-    switch (dim()) {
-      case 4:
-        is_channels_last_contiguous_ = compute_channels_last_contiguous_2d();
-        is_channels_last_3d_contiguous_ = false;
-        is_channels_last_ = compute_strides_like_channels_last_2d();
-        is_channels_last_3d_ = false;
-        is_non_overlapping_and_dense_ = is_contiguous_ || is_channels_last_contiguous_ || compute_non_overlapping_and_dense();
-        break;
-      case 5:
-        is_channels_last_contiguous_ = compute_channels_last_contiguous_2d();
-        is_channels_last_3d_contiguous_ = !is_channels_last_contiguous_ && compute_channels_last_contiguous_3d();
-        is_channels_last_ = !is_channels_last_3d_contiguous_ && compute_strides_like_channels_last_2d();
-        is_channels_last_3d_ = !is_channels_last_ && compute_strides_like_channels_last_3d();
-        is_non_overlapping_and_dense_ = is_contiguous_ || is_channels_last_contiguous_ || is_channels_last_3d_contiguous_|| compute_non_overlapping_and_dense();
-        break;
-      default:
-        is_channels_last_contiguous_ = false;
-        is_channels_last_3d_contiguous_ = false;
-        // is_channels_last_ and is_channels_last_3d_ are suggested memory_format.
-        // Being channels_last_contiguous doesn't necessarily mean the tensor is
-        // strided like channels_last: for strides on channel dimension could suggest
-        // desired memory_layout, but it doesn't affect memory storage
-        is_channels_last_ = false;
-        is_channels_last_3d_ = false;
-        is_non_overlapping_and_dense_ = is_contiguous_ || compute_non_overlapping_and_dense();
+    memory_format_flags_.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * Override the cached non-overlapping-and-dense flag, for subclasses whose
+   * strides do not describe their memory.  The override lasts until the next
+   * refresh_contiguous().
+   */
+  void set_non_overlapping_and_dense_flag(bool value) {
+    uint8_t flags = memory_format_flags();
+    flags = value ? (flags | kNonOverlappingAndDense)
+                  : (flags & ~kNonOverlappingAndDense);
+    memory_format_flags_.store(flags, std::memory_order_relaxed);
+  }
+
+  // Bits of memory_format_flags_.
+  enum MemoryFormatFlag : uint8_t {
+    kMemoryFormatFlagsValid = 1 << 0,
+    // See compute_contiguous()
+    kContiguous = 1 << 1,
+    // Channels last contiguous tensor is channel last tensor which occupies
+    // contiguous memory block.
+    kChannelsLastContiguous = 1 << 2,
+    kChannelsLast3dContiguous = 1 << 3,
+    // Tensor is stored in the channels last 2d memory format, when dimensions
+    // order is (N)CHW and C-strides < W-strides < H-strides (< N-strides)
+    // (If size of any dimension is equal to 1, this dimension strides value
+    // is not taken into account).
+    kChannelsLast = 1 << 4,
+    // Tensor is stored in the channels last 3d memory format, when dimensions
+    // order is (N)CDHW and C-strides < W-strides < H-strides < D - strides (< N-strides)
+    // (If size of any dimension is equal to 1, this dimension strides value
+    // is not taken into account).
+    kChannelsLast3d = 1 << 5,
+    // Dense tensor is the tensor that store values in a contiguous block of memory.
+    // Non-overlapping tensor is the tensor in which elements occupy individual
+    // non-repetitive memory.
+    kNonOverlappingAndDense = 1 << 6,
+  };
+
+  // The memory format flags of the current sizes and strides, computed on the
+  // first query after they changed.
+  uint8_t memory_format_flags() const {
+    uint8_t flags = memory_format_flags_.load(std::memory_order_relaxed);
+    if (C10_UNLIKELY(!(flags & kMemoryFormatFlagsValid))) {
+      flags = compute_memory_format_flags();
+      memory_format_flags_.store(flags, std::memory_order_relaxed);
     }
+    return flags;
   }
 
+ private:
+  uint8_t compute_memory_format_flags() const;
+
+ protected:
   /**
    * Copy the tensor metadata fields (e.g. sizes / strides / storage pointer / storage_offset)
    * from one TensorImpl to another TensorImpl.
@@ -1774,46 +1840,25 @@ protected:
   // INVARIANT: named_tensor_meta_ != nullptr  <==>  key_set_.has(DispatchKey::Named)
   DispatchKeySet key_set_;
 
-  // Tensor is contiguous
-  bool is_contiguous_ = true;
+  // Note [Lazily computed memory format flags]
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Whether the tensor is contiguous, channels last, non-overlapping and
+  // dense, etc. is a function of its sizes and strides, packed in the
+  // MemoryFormatFlag bits.  Views and resizes change the sizes and strides
+  // much more often than the flags are queried, so refresh_contiguous() only
+  // clears kMemoryFormatFlagsValid and the flags are computed by the first
+  // query that needs them.  That query may run on a const tensor shared by
+  // several threads, hence the atomic; the threads compute the same value.
+  mutable std::atomic<uint8_t> memory_format_flags_{
+      kMemoryFormatFlagsValid | kContiguous | kNonOverlappingAndDense};
 
   // default member initializers for bit-fields only available with -std=c++2a or -std=gnu++2a
   inline void init_bitfields() {
-    is_channels_last_ = false;
-    is_channels_last_contiguous_ = false;
-    is_channels_last_3d_ = false;
-    is_channels_last_3d_contiguous_ = false;
-    is_non_overlapping_and_dense_ = true;
     is_wrapped_number_ = false;
     allow_tensor_metadata_change_ = true;
     reserved_ = false;
   }
 
-  // Tensor is stored in the channels last 2d memory format, when dimensions
-  // order is (N)CHW and C-strides < W-strides < H-strides (< N-strides)
-  // (If size of any dimension is equal to 1, this dimension strides value
-  // is not taken into account).
-  bool is_channels_last_ : 1;
-
-  // Channels last contiguous tensor is channel last tensor which occupies
-  // contiguous memory block.
-  bool is_channels_last_contiguous_ : 1;
-
-  // Tensor is stored in the channels last 3d memory format, when dimensions
-  // order is (N)CDHW and C-strides < W-strides < H-strides < D - strides (< N-strides)
-  // (If size of any dimension is equal to 1, this dimension strides value
-  // is not taken into account).
-  bool is_channels_last_3d_ : 1;
-
-  // Channels last 3d contiguous tensor is channel last 3d tensor which occupies
-  // contiguous memory block.
-  bool is_channels_last_3d_contiguous_ : 1;
-
-  // Dense tensor is the tensor that store values in a contiguous block of memory.
-  // Non-overlapping tensor is the tensor in which elements occupy individual
-  // non-repetitive memory.
-  bool is_non_overlapping_and_dense_ : 1;
-
   bool is_wrapped_number_ : 1;
 
   // NOTE [ Metadata Change for a Detached Tensor ]
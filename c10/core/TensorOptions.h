@@ -650,6 +650,15 @@ inline DispatchKey computeDispatchKey(c10::optional<ScalarType> dtype, c10::opti
           default:
             AT_ERROR("Unsupported device type for sparse layout: ", device_.type());
         }
+      case Layout::SparseCsr:
+        switch (device_.type()) {
+          case DeviceType::CPU:
+            return DispatchKey::SparseCsrCPU;
+          case DeviceType::CUDA:
+            return DispatchKey::SparseCsrCUDA;
+          default:
+            AT_ERROR("Unsupported device type for sparse CSR layout: ", device_.type());
+        }
       case Layout::Mkldnn:
         switch (device_.type()) {
           case DeviceType::CPU:
@@ -693,6 +702,10 @@ inline DeviceType computeDeviceType(DispatchKey tid) {
     return DeviceType::CUDA;
   } else if (tid == DispatchKey::SparseHIP) {
     return DeviceType::HIP;
+  } else if (tid == DispatchKey::SparseCsrCPU) {
+    return DeviceType::CPU;
+  } else if (tid == DispatchKey::SparseCsrCUDA) {
+    return DeviceType::CUDA;
   } else if (tid == DispatchKey::MkldnnCPU) {
     return DeviceType::CPU;
   } else if (tid == DispatchKey::Vulkan) {
@@ -12,6 +12,9 @@
 
 namespace c10 {
 
+// Forward declaration
+class DataPtr;
+
 /**
  * Flags defining the behavior of events.
  *
@@ -109,6 +112,13 @@ struct C10_API DeviceGuardImplInterface {
     TORCH_CHECK(false, "Backend doesn't support acquiring a default stream.")
   }
 
+  /**
+   * Get a stream from the global pool for a given device.
+   */
+  virtual Stream getStreamFromPool(Device, bool isHighPriority = false) const {
+    TORCH_CHECK(false, "Backend doesn't support acquiring a stream from pool.")
+  }
+
   /**
    * Set a stream to be the thread local current stream for its device.
    * Return the previous stream for that device. You are NOT required
@@ -161,6 +171,15 @@ struct C10_API DeviceGuardImplInterface {
     TORCH_CHECK(false, "Backend doesn't support events.");
   }
 
+  /**
+   * Ensure the caching allocator (if any) is aware that the given DataPtr is
+   * being used on the given stream, and that it should thus avoid recycling the
+   * DataPtr until all work on that stream is done.
+   */
+  virtual void recordDataPtrOnStream(
+    const c10::DataPtr&,
+    const Stream&) const { }
+
   /**
    * Get the number of devices.  WARNING: This is REQUIRED to not raise
    * an exception.  If there is some sort of problem, e.g., driver error,
@@ -0,0 +1,92 @@
+#include <c10/core/impl/SmallObjectPool.h>
+
+#include <new>
+
+namespace c10 {
+namespace impl {
+
+namespace {
+
+constexpr size_t kNumSizeClasses = kMaxSmallObjectSize / kSmallObjectAlignment;
+// Blocks cached per size class and thread
+constexpr size_t kMaxCachedBlocks = 128;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct ThreadCache {
+  FreeBlock* free_lists[kNumSizeClasses] = {};
+  size_t num_cached[kNumSizeClasses] = {};
+
+  ~ThreadCache();
+};
+
+// Trivially destructible, so it can be read while and after the thread local
+// cache is destroyed.
+thread_local bool thread_cache_destroyed = false;
+thread_local ThreadCache thread_cache;
+
+ThreadCache::~ThreadCache() {
+  thread_cache_destroyed = true;
+  for (size_t c = 0; c < kNumSizeClasses; ++c) {
+    FreeBlock* block = free_lists[c];
+    while (block) {
+      FreeBlock* next = block->next;
+      ::operator delete(block);
+      block = next;
+    }
+    free_lists[c] = nullptr;
+  }
+}
+
+// size must be in (0, kMaxSmallObjectSize]
+inline size_t size_class(size_t size) {
+  return (size - 1) / kSmallObjectAlignment;
+}
+
+} // namespace
+
+void* small_object_alloc(size_t size) {
+#ifndef C10_ASAN_ENABLED
+  if (size > 0 && size <= kMaxSmallObjectSize) {
+    const size_t c = size_class(size);
+    if (!thread_cache_destroyed) {
+      ThreadCache& cache = thread_cache;
+      FreeBlock* block = cache.free_lists[c];
+      if (block) {
+        cache.free_lists[c] = block->next;
+        --cache.num_cached[c];
+        return block;
+      }
+    }
+    // a block may be cached by any thread and reused for any object of its
+    // class, so it always has the size of the largest one
+    return ::operator new((c + 1) * kSmallObjectAlignment);
+  }
+#endif
+  return ::operator new(size);
+}
+
+void small_object_free(void* ptr, size_t size) noexcept {
+  if (!ptr) {
+    return;
+  }
+#ifndef C10_ASAN_ENABLED
+  if (size > 0 && size <= kMaxSmallObjectSize && !thread_cache_destroyed) {
+    const size_t c = size_class(size);
+    ThreadCache& cache = thread_cache;
+    if (cache.num_cached[c] < kMaxCachedBlocks) {
+      FreeBlock* block = static_cast<FreeBlock*>(ptr);
+      block->next = cache.free_lists[c];
+      cache.free_lists[c] = block;
+      ++cache.num_cached[c];
+      return;
+    }
+  }
+#endif
+  ::operator delete(ptr);
+}
+
+} // namespace impl
+} // namespace c10
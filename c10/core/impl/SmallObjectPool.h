@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+
+#include <c10/macros/Macros.h>
+
+namespace c10 {
+namespace impl {
+
+// Note [Small object pool]
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+// Every tensor allocates a TensorImpl and a StorageImpl, plus an AutogradMeta
+// when it requires grad, so running small ops one by one is dominated by
+// malloc and free of these objects. The same goes for the lists and tuples
+// that the JIT interpreter creates for the arguments of most ops. These
+// classes allocate from a thread caching pool instead, through class specific
+// operator new and delete.
+//
+// The pool has size classes of kSmallObjectAlignment bytes, up to
+// kMaxSmallObjectSize. Each thread keeps a bounded free list per class, and
+// every block comes from (and eventually goes back to) the global operator
+// new, so a block can be freed by any thread: it is cached by the thread that
+// frees it. Larger objects and the blocks freed once the cache of their
+// thread is full or destroyed go straight to the global operator delete.
+//
+// The buffers of the lists and dicts of the JIT, which are just as short lived
+// and mostly hold a few elements, come from the same pool through
+// SmallObjectAllocator.
+//
+// The pool is disabled under ASAN, which could not detect use after free of
+// cached blocks.
+constexpr size_t kSmallObjectAlignment = 16;
+constexpr size_t kMaxSmallObjectSize = 512;
+
+C10_API void* small_object_alloc(size_t size);
+C10_API void small_object_free(void* ptr, size_t size) noexcept;
+
+// Standard allocator using the small object pool, for the containers of the
+// small objects. The buffers larger than kMaxSmallObjectSize come from the
+// global operator new as usual.
+template <typename T>
+struct SmallObjectAllocator {
+  using value_type = T;
+
+  SmallObjectAllocator() = default;
+  template <typename U>
+  SmallObjectAllocator(const SmallObjectAllocator<U>& /*other*/) noexcept {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(small_object_alloc(n * sizeof(T)));
+  }
+  void deallocate(T* ptr, size_t n) noexcept {
+    small_object_free(ptr, n * sizeof(T));
+  }
+};
+
+template <typename T, typename U>
+bool operator==(
+    const SmallObjectAllocator<T>& /*lhs*/,
+    const SmallObjectAllocator<U>& /*rhs*/) noexcept {
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(
+    const SmallObjectAllocator<T>& /*lhs*/,
+    const SmallObjectAllocator<U>& /*rhs*/) noexcept {
+  return false;
+}
+
+} // namespace impl
+} // namespace c10
+
+// Class specific allocation functions using the small object pool, and the
+// placement new that they would hide otherwise.
+#define C10_SMALL_OBJECT_POOL_ALLOCATION_FUNCTIONS                  \
+  static void* operator new(size_t size) {                         \
+    return ::c10::impl::small_object_alloc(size);                  \
+  }                                                                \
+  static void operator delete(void* ptr, size_t size) noexcept {   \
+    ::c10::impl::small_object_free(ptr, size);                     \
+  }                                                                \
+  static void* operator new(size_t /*size*/, void* place) noexcept { \
+    return place;                                                  \
+  }                                                                \
+  static void operator delete(void* /*ptr*/, void* /*place*/) noexcept {}
@@ -1,7 +1,38 @@
 #include <c10/core/thread_pool.h>
 
+#include <c10/util/llvmMathExtras.h>
+
+#include <algorithm>
+#include <chrono>
+
 namespace c10 {
 
+namespace {
+
+// The pool and the index of the worker running on the current thread
+thread_local ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_worker_index = 0;
+// How many tasks the current thread runs while waiting on futures, each
+// helping task being nested in the wait of the previous one
+thread_local int helping_depth = 0;
+// Bounds the stack of the nested tasks
+constexpr int kMaxHelpingDepth = 16;
+
+int64_t steadyNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+} // namespace
+
+size_t threadPoolStatsBucket(uint64_t ns) {
+  if (ns == 0) {
+    return 0;
+  }
+  return std::min<size_t>(llvm::Log2_64(ns) + 1, kThreadPoolStatsNumBuckets - 1);
+}
+
 ThreadPool::ThreadPool(
       int pool_size,
       int numa_node_id,
@@ -11,7 +42,9 @@ ThreadPool::ThreadPool(
       complete_(true),
       available_(threads_.size()),
       total_(threads_.size()),
-      numa_node_id_(numa_node_id) {
+      numa_node_id_(numa_node_id),
+      stats_enabled_(false),
+      worker_busy_(threads_.size(), false) {
   for (std::size_t i = 0; i < threads_.size(); ++i) {
     threads_[i] = std::thread([this, i, init_thread](){
       if (init_thread) {
@@ -64,8 +97,12 @@ void ThreadPool::run(std::function<void()> func) {
   // Set task and signal condition variable so that a worker thread will
   // wake up and use the task.
   tasks_.emplace(std::move(func));
+  if (stats_enabled_) {
+    recordQueued();
+  }
   complete_ = false;
   condition_.notify_one();
+  wakeHelpingWaiters();
 }
 
 void ThreadPool::waitWorkComplete() {
@@ -75,7 +112,182 @@ void ThreadPool::waitWorkComplete() {
   }
 }
 
+void ThreadPool::enableStats(bool enabled) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (enabled && !stats_enabled_) {
+    const int64_t now_ns = steadyNowNs();
+    stats_ = ThreadPoolStats();
+    stats_.busy_ns.assign(threads_.size(), 0);
+    stats_.idle_ns.assign(threads_.size(), 0);
+    worker_since_ns_.assign(threads_.size(), now_ns);
+  }
+  stats_enabled_ = enabled;
+}
+
+bool ThreadPool::statsEnabled() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return stats_enabled_;
+}
+
+ThreadPoolStats ThreadPool::getStats() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  ThreadPoolStats stats = stats_;
+  if (stats_enabled_) {
+    const int64_t now_ns = steadyNowNs();
+    for (std::size_t i = 0; i < worker_since_ns_.size(); ++i) {
+      const auto ns = static_cast<uint64_t>(
+          std::max<int64_t>(now_ns - worker_since_ns_[i], 0));
+      (worker_busy_[i] ? stats.busy_ns[i] : stats.idle_ns[i]) += ns;
+    }
+  }
+  return stats;
+}
+
+void ThreadPool::resetStats() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const int64_t now_ns = steadyNowNs();
+  const size_t num_workers = stats_.busy_ns.size();
+  stats_ = ThreadPoolStats();
+  stats_.busy_ns.assign(num_workers, 0);
+  stats_.idle_ns.assign(num_workers, 0);
+  std::fill(worker_since_ns_.begin(), worker_since_ns_.end(), now_ns);
+}
+
+void ThreadPool::recordQueued() {
+  tasks_.back().queued_ns = steadyNowNs();
+  ++stats_.tasks_queued;
+}
+
+void ThreadPool::recordDequeued(const task_element_t& task, int64_t now_ns) {
+  if (task.queued_ns != 0) {
+    const auto wait_ns =
+        static_cast<uint64_t>(std::max<int64_t>(now_ns - task.queued_ns, 0));
+    stats_.wait_total_ns += wait_ns;
+    stats_.wait_histogram[threadPoolStatsBucket(wait_ns)]++;
+  }
+}
+
+void ThreadPool::recordWorkerTime(std::size_t index, int64_t now_ns) {
+  const auto ns = static_cast<uint64_t>(
+      std::max<int64_t>(now_ns - worker_since_ns_[index], 0));
+  (worker_busy_[index] ? stats_.busy_ns[index] : stats_.idle_ns[index]) += ns;
+  worker_since_ns_[index] = now_ns;
+}
+
+// Note [Helping while waiting on futures]
+// A task of a pool which waits on a future, e.g. the result of a task it
+// forked with at::launch or torch.jit.fork, blocks its worker. When every
+// worker is blocked this way, the tasks the futures wait for stay queued and
+// the pool deadlocks; before that, the pool runs fewer tasks than it has
+// threads. In pools which enable it with setHelpWhileWaiting(), which only the
+// at::launch inter-op pool does, a worker waiting on a future runs the tasks
+// queued in its pool meanwhile, nested in its wait. This also runs the forked
+// tasks on the thread waiting for them when no other worker is free. When no
+// task is queued, the worker sleeps until the future completes or a task is
+// queued. The nesting is bounded by kMaxHelpingDepth, past which the worker
+// blocks.
+//
+// It's opt-in because a nested task runs with whatever the waiting task holds:
+// a nested task locking a mutex that the waiting task holds deadlocks, and the
+// wait doesn't return before the nested task does. Tasks of such a pool must
+// not wait on futures while holding locks the other tasks take.
+void ThreadPool::HelpingWaiter::complete() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  completed_ = true;
+  cv_.notify_all();
+}
+
+void ThreadPool::setHelpWhileWaiting(bool enabled) {
+  help_while_waiting_ = enabled;
+}
+
+bool ThreadPool::canHelpWhileWaiting() {
+  return current_pool && current_pool->help_while_waiting_ &&
+      helping_depth < kMaxHelpingDepth;
+}
+
+void ThreadPool::helpUntilComplete(
+    const std::shared_ptr<HelpingWaiter>& waiter) {
+  ThreadPool* pool = current_pool;
+  const std::size_t index = current_worker_index;
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(waiter->mutex_);
+      if (waiter->completed_) {
+        break;
+      }
+      waiter->task_queued_ = false;
+    }
+    if (pool->run_pending_task(index)) {
+      continue;
+    }
+    {
+      // A task queued from here on wakes the waiter up
+      std::lock_guard<std::mutex> lock(pool->mutex_);
+      if (!pool->tasks_.empty() && pool->running_) {
+        continue;
+      }
+      pool->helping_waiters_.push_back(waiter);
+    }
+    std::unique_lock<std::mutex> lock(waiter->mutex_);
+    waiter->cv_.wait(
+        lock, [&] { return waiter->completed_ || waiter->task_queued_; });
+  }
+  std::lock_guard<std::mutex> lock(pool->mutex_);
+  auto& waiters = pool->helping_waiters_;
+  waiters.erase(std::remove(waiters.begin(), waiters.end(), waiter), waiters.end());
+}
+
+void ThreadPool::wakeHelpingWaiters() {
+  for (const auto& waiter : helping_waiters_) {
+    std::lock_guard<std::mutex> lock(waiter->mutex_);
+    waiter->task_queued_ = true;
+    waiter->cv_.notify_all();
+  }
+  helping_waiters_.clear();
+}
+
+bool ThreadPool::run_pending_task(std::size_t index) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (tasks_.empty() || !running_) {
+    return false;
+  }
+  {
+    task_element_t task = std::move(tasks_.front());
+    tasks_.pop();
+    // The worker is already counted as busy, running the task it helps from
+    if (stats_enabled_) {
+      recordDequeued(task, steadyNowNs());
+    }
+    lock.unlock();
+    ++helping_depth;
+    run_task(task, index);
+    --helping_depth;
+  }
+  lock.lock();
+  if (stats_enabled_) {
+    ++stats_.tasks_executed;
+  }
+  return true;
+}
+
+void ThreadPool::run_task(task_element_t& task, std::size_t index) {
+  try {
+    if (task.run_with_id) {
+      task.with_id(index);
+    } else {
+      task.no_id();
+    }
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Exception in thread pool task: " << e.what();
+  } catch (...) {
+    LOG(ERROR) << "Exception in thread pool task: unknown";
+  }
+}
+
 void ThreadPool::main_loop(std::size_t index) {
+  current_pool = this;
+  current_worker_index = index;
   std::unique_lock<std::mutex> lock(mutex_);
   while (running_) {
     // Wait on condition variable while the task is empty and
@@ -98,21 +310,17 @@ void ThreadPool::main_loop(std::size_t index) {
       tasks_.pop();
       // Decrement count, indicating thread is no longer available.
       --available_;
+      if (stats_enabled_) {
+        const int64_t now_ns = steadyNowNs();
+        recordDequeued(tasks, now_ns);
+        recordWorkerTime(index, now_ns);
+      }
+      worker_busy_[index] = true;
 
       lock.unlock();
 
       // Run the task.
-      try {
-        if (tasks.run_with_id) {
-          tasks.with_id(index);
-        } else {
-          tasks.no_id();
-        }
-      } catch (const std::exception& e) {
-        LOG(ERROR) << "Exception in thread pool task: " << e.what();
-      } catch (...) {
-        LOG(ERROR) << "Exception in thread pool task: unknown";
-      }
+      run_task(tasks, index);
 
       // Update status of empty, maybe
       // Need to recover the lock first
@@ -120,6 +328,11 @@ void ThreadPool::main_loop(std::size_t index) {
 
       // Increment count, indicating thread is available.
       ++available_;
+      if (stats_enabled_) {
+        ++stats_.tasks_executed;
+        recordWorkerTime(index, steadyNowNs());
+      }
+      worker_busy_[index] = false;
       if (tasks_.empty() && available_ == total_) {
         complete_ = true;
         completed_.notify_one();
@@ -130,6 +343,7 @@ void ThreadPool::main_loop(std::size_t index) {
       // the lock.
     }
   } // while running_
+  current_pool = nullptr;
 }
 
 C10_DEFINE_SHARED_REGISTRY(
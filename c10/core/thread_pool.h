@@ -1,11 +1,15 @@
 #pragma once
 
+#include <array>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <c10/util/Optional.h>
 #include <c10/util/intrusive_ptr.h>
@@ -42,12 +46,39 @@ class C10_API TaskThreadPoolBase {
   }
 };
 
+// Queue wait times in [2^(i - 1), 2^i) nanoseconds fall in bucket i, wait
+// times of at least 2^(kThreadPoolStatsNumBuckets - 2) ns in the last bucket.
+constexpr size_t kThreadPoolStatsNumBuckets = 36;
+
+using ThreadPoolStatsHistogram = std::array<uint64_t, kThreadPoolStatsNumBuckets>;
+
+// Returns the histogram bucket of a duration
+C10_API size_t threadPoolStatsBucket(uint64_t ns);
+
+// Utilization counters of a ThreadPool, gathered while its stats are enabled
+struct C10_API ThreadPoolStats {
+  uint64_t tasks_queued = 0;
+  uint64_t tasks_executed = 0;
+  // Time between the queueing of a task and a worker picking it up
+  uint64_t wait_total_ns = 0;
+  ThreadPoolStatsHistogram wait_histogram{};
+  // Time each worker spent running tasks and waiting for tasks
+  std::vector<uint64_t> busy_ns;
+  std::vector<uint64_t> idle_ns;
+};
+
 class C10_API ThreadPool : public c10::TaskThreadPoolBase {
+ public:
+  class HelpingWaiter;
+
  protected:
   struct task_element_t {
     bool run_with_id;
     const std::function<void()> no_id;
     const std::function<void(std::size_t)> with_id;
+    // Steady clock time the task was queued at, or 0 if the stats were
+    // disabled
+    int64_t queued_ns = 0;
 
     explicit task_element_t(std::function<void()> f)
       : run_with_id(false), no_id(std::move(f)), with_id(nullptr) {}
@@ -65,6 +96,17 @@ class C10_API ThreadPool : public c10::TaskThreadPoolBase {
   std::size_t available_;
   std::size_t total_;
   int numa_node_id_;
+  // The stats are guarded by mutex_, and only updated while stats_enabled_
+  bool stats_enabled_;
+  ThreadPoolStats stats_;
+  // Whether each worker is running a task
+  std::vector<bool> worker_busy_;
+  // Steady clock time each worker's busy or idle time was last counted at
+  std::vector<int64_t> worker_since_ns_;
+  std::atomic_bool help_while_waiting_{false};
+  // The workers blocked in helpUntilComplete(), woken up when a task is
+  // queued. Guarded by mutex_.
+  std::vector<std::shared_ptr<HelpingWaiter>> helping_waiters_;
 
  public:
   ThreadPool() = delete;
@@ -91,16 +133,73 @@ class C10_API ThreadPool : public c10::TaskThreadPoolBase {
     // Set task and signal condition variable so that a worker thread will
     // wake up and use the task.
     tasks_.emplace(static_cast<std::function<void(std::size_t)>>(task));
+    if (stats_enabled_) {
+      recordQueued();
+    }
     complete_ = false;
     condition_.notify_one();
+    wakeHelpingWaiters();
   }
 
   /// @brief Wait for queue to be empty
   void waitWorkComplete();
 
+  /// @brief What a worker helping while it waits blocks on when no task is
+  /// queued, until complete() is called or a task is queued.
+  class C10_API HelpingWaiter {
+   public:
+    /// @brief Called once what the worker waits for is complete
+    void complete();
+
+   private:
+    friend class ThreadPool;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool completed_ = false;
+    bool task_queued_ = false;
+  };
+
+  /// @brief Lets the workers of this pool run its queued tasks while they
+  /// wait on a future, see Note [Helping while waiting on futures]. Off by
+  /// default.
+  void setHelpWhileWaiting(bool enabled);
+
+  /// @brief Whether the calling thread is a worker of a pool which helps
+  /// while waiting, and may nest another task in its wait.
+  static bool canHelpWhileWaiting();
+
+  /// @brief Runs the tasks queued in the pool of the calling worker until
+  /// waiter->complete() is called. Requires canHelpWhileWaiting().
+  static void helpUntilComplete(const std::shared_ptr<HelpingWaiter>& waiter);
+
+  /// @brief Start or stop gathering utilization stats. Enabling the stats
+  /// resets them.
+  void enableStats(bool enabled);
+
+  bool statsEnabled();
+
+  /// @brief Returns the stats gathered so far, including the time the
+  /// workers have been busy or idle for at the time of the call.
+  ThreadPoolStats getStats();
+
+  void resetStats();
+
  private:
   // @brief Entry point for pool threads.
   void main_loop(std::size_t index);
+
+  // Runs a task popped from tasks_ on worker index, without mutex_ held
+  void run_task(task_element_t& task, std::size_t index);
+
+  bool run_pending_task(std::size_t index);
+
+  // Wakes up the helping waiters after a task was queued, with mutex_ held
+  void wakeHelpingWaiters();
+
+  // Stats updates, called with mutex_ held
+  void recordQueued();
+  void recordDequeued(const task_element_t& task, int64_t now_ns);
+  void recordWorkerTime(std::size_t index, int64_t now_ns);
 };
 
 class C10_API TaskThreadPool : public c10::ThreadPool {
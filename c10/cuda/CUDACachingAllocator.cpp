@@ -1,8 +1,10 @@
 #include <c10/cuda/CUDACachingAllocator.h>
 
+#include <c10/core/AllocationTrace.h>
 #include <c10/cuda/CUDAGuard.h>
 #include <c10/cuda/CUDAException.h>
 #include <c10/cuda/CUDAFunctions.h>
+#include <c10/util/OverheadProbe.h>
 #include <c10/util/UniqueVoidPtr.h>
 
 #include <cuda_runtime_api.h>
@@ -18,6 +20,12 @@
 #include <unordered_set>
 #include <vector>
 
+#if !defined(_WIN32) && !defined(__HIP_PLATFORM_HCC__) && \
+    defined(CUDA_VERSION) && CUDA_VERSION >= 10020
+#define C10_CUDA_EXPANDABLE_SEGMENTS
+#include <dlfcn.h>
+#endif
+
 namespace c10 {
 
 C10_DEFINE_REGISTRY(FreeCudaMemoryCallbacksRegistry, FreeMemoryCallback);
@@ -40,6 +48,24 @@ namespace CUDACachingAllocator {
 //   smallest available free block or allocate a new block using cudaMalloc.
 //   To reduce fragmentation, requests between 1MB and 10MB will allocate and
 //   split a 20MB block, if no free block of sufficient size is available.
+// - Optionally (PYTORCH_CUDA_SLAB_ALLOCATOR=1), requests up to 128KB are
+//   instead served from slabs: 2MB segments carved into blocks of a single
+//   power-of-two size class. Freed slab blocks go onto a per-stream, per-class
+//   free list and are never split or merged, so small allocations and frees
+//   are O(1). A slab is returned to the system once none of its blocks are in
+//   use.
+// - Optionally (PYTORCH_CUDA_EXPANDABLE_SEGMENTS=1), large blocks are carved
+//   from one expandable segment per stream instead of separate cudaMalloc
+//   segments. The segment reserves a virtual address range the size of the
+//   device and maps physical memory at its end as needed, so neighbouring
+//   free blocks always coalesce. Emptying the cache unmaps the free tail of
+//   the segment but keeps the address range for later growth.
+// - Allocations made on a stream that is being captured into a CUDA graph
+//   come from a private pool of the capture (see notifyCaptureBegin), and
+//   never from slabs or expandable segments. Blocks of a private pool are
+//   only handed out to captures of that pool, since a graph keeps using the
+//   memory of its freed intermediates on every replay. The pool is released
+//   once all graphs using it are destroyed and all its blocks are free.
 //
 // With this allocator, allocations and frees should logically be considered
 // "usages" of the memory segment associated with streams, just like kernel
@@ -63,6 +89,11 @@ constexpr size_t kSmallBuffer   =  2097152; // "small" allocations are packed in
 constexpr size_t kLargeBuffer   = 20971520; // "large" allocations may be packed in 20 MiB blocks
 constexpr size_t kMinLargeAlloc = 10485760; // allocations between 1 and 10 MiB may use kLargeBuffer
 constexpr size_t kRoundLarge    =  2097152; // round up large allocations to 2 MiB
+constexpr size_t kSlabMaxSize   =   131072; // largest allocation served from slabs is 128 KiB
+constexpr size_t kNumSlabClasses =       9; // power-of-two slab size classes from 512 B to 128 KiB
+
+static_assert(kMinBlockSize << (kNumSlabClasses - 1) == kSlabMaxSize,
+              "slab size classes must cover kMinBlockSize to kSlabMaxSize");
 
 typedef std::bitset<static_cast<size_t>(StatType::NUM_TYPES)> StatTypes;
 
@@ -98,6 +129,8 @@ void update_stat_array(StatArray& stat_array, int64_t amount, const StatTypes& s
 }
 
 struct Block;
+struct Slab;
+struct ExpandableSegment;
 typedef bool (*Comparison)(const Block*, const Block*);
 typedef std::set<Block*, Comparison> BlockPool;
 
@@ -112,21 +145,228 @@ struct Block {
   Block*        prev;        // prev block if split from a larger allocation
   Block*        next;        // next block if split from a larger allocation
   int           event_count; // number of outstanding CUDA events
+  Slab*         slab;        // owning slab if carved from one, else nullptr
+  ExpandableSegment* segment; // owning expandable segment, else nullptr
 
   Block(int device, cudaStream_t stream, size_t size, BlockPool* pool, void* ptr) :
     device(device), stream(stream), stream_uses(), size(size), pool(pool),
-    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    slab(nullptr), segment(nullptr) { }
 
   // constructor for search key
   Block(int device, cudaStream_t stream, size_t size) :
     device(device), stream(stream), stream_uses(), size(size), pool(nullptr),
-    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    slab(nullptr), segment(nullptr) { }
 
   bool is_split() const {
     return (prev != nullptr) || (next != nullptr);
   }
 };
 
+struct Slab {
+  int                 device;     // gpu
+  cudaStream_t        stream;     // allocation stream
+  void*               ptr;        // base address of the segment
+  size_t              size;       // segment size in bytes
+  size_t              block_size; // size class of the blocks carved from it
+  size_t              carved;     // bytes already carved into blocks
+  size_t              live;       // number of blocks allocated or awaiting events
+  std::vector<Block*> blocks;     // blocks carved from this slab
+
+  Slab(int device, cudaStream_t stream, void* ptr, size_t size, size_t block_size) :
+    device(device), stream(stream), ptr(ptr), size(size), block_size(block_size),
+    carved(0), live(0), blocks() { }
+};
+
+// Free slab blocks and the slab currently being carved, per size class.
+struct SlabStreamPool {
+  std::array<std::vector<Block*>, kNumSlabClasses> free_lists;
+  std::array<Slab*, kNumSlabClasses> carving{};
+};
+
+// Index of the smallest power-of-two size class holding size bytes.
+static size_t slab_class(size_t size) {
+  size_t cls = 0;
+  size_t cls_size = kMinBlockSize;
+  while (cls_size < size) {
+    cls_size <<= 1;
+    ++cls;
+  }
+  return cls;
+}
+
+// Returns whether small allocations should be served from fixed size-class
+// slabs instead of the best-fit small pool.
+static bool useSlabAllocator() {
+  static bool use_slab =
+      getenv("PYTORCH_CUDA_SLAB_ALLOCATOR") != nullptr;
+  return use_slab;
+}
+
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+
+// Virtual memory management entry points of the CUDA driver. They are looked
+// up in libcuda at runtime so that c10_cuda doesn't link against the driver.
+#define C10_FORALL_CUDA_VMM_FUNCTIONS(_) \
+  _(cuMemAddressReserve)                 \
+  _(cuMemAddressFree)                    \
+  _(cuMemCreate)                         \
+  _(cuMemRelease)                        \
+  _(cuMemMap)                            \
+  _(cuMemUnmap)                          \
+  _(cuMemSetAccess)                      \
+  _(cuMemGetAllocationGranularity)       \
+  _(cuGetErrorString)
+
+struct DriverAPI {
+#define CREATE_MEMBER(name) decltype(&name) name##_;
+  C10_FORALL_CUDA_VMM_FUNCTIONS(CREATE_MEMBER)
+#undef CREATE_MEMBER
+
+  // Returns nullptr if the driver doesn't provide the VMM functions.
+  static const DriverAPI* get() {
+    static const DriverAPI* singleton = []() -> const DriverAPI* {
+      void* handle = dlopen("libcuda.so.1", RTLD_LAZY);
+      if (handle == nullptr) {
+        return nullptr;
+      }
+      auto api = std::unique_ptr<DriverAPI>(new DriverAPI());
+#define LOOKUP_ENTRY(name)                                                \
+      api->name##_ = reinterpret_cast<decltype(&name)>(dlsym(handle, #name)); \
+      if (api->name##_ == nullptr) {                                      \
+        return nullptr;                                                   \
+      }
+      C10_FORALL_CUDA_VMM_FUNCTIONS(LOOKUP_ENTRY)
+#undef LOOKUP_ENTRY
+      return api.release();
+    }();
+    return singleton;
+  }
+};
+
+#undef C10_FORALL_CUDA_VMM_FUNCTIONS
+
+#define C10_CUDA_DRIVER_CHECK(EXPR)                                 \
+  do {                                                              \
+    CUresult __err = EXPR;                                          \
+    if (__err != CUDA_SUCCESS) {                                    \
+      const char* err_str = "unknown error";                        \
+      DriverAPI::get()->cuGetErrorString_(__err, &err_str);         \
+      TORCH_CHECK(false, "CUDA driver error: ", err_str);           \
+    }                                                               \
+  } while (0)
+
+// A virtual address range reserved for the large blocks of one stream. Only
+// a prefix of mapped_size bytes is backed by physical memory, in pages of
+// the device's allocation granularity, and the blocks carved from the
+// segment exactly cover that prefix.
+struct ExpandableSegment {
+  int                   device;
+  cudaStream_t          stream;
+  char*                 ptr;         // base of the reserved range
+  size_t                max_size;    // size of the reserved range
+  size_t                page_size;   // physical allocation granularity
+  size_t                mapped_size; // bytes backed by physical memory
+  Block*                last;        // block ending at ptr + mapped_size
+  CUmemAllocationProp   prop;        // properties of the physical pages
+  std::vector<CUmemGenericAllocationHandle> handles; // one per mapped page
+
+  ExpandableSegment(int device, cudaStream_t stream, size_t size) :
+    device(device), stream(stream), ptr(nullptr), max_size(0), page_size(0),
+    mapped_size(0), last(nullptr), prop(), handles()
+  {
+    prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+    prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    prop.location.id = device;
+    C10_CUDA_DRIVER_CHECK(DriverAPI::get()->cuMemGetAllocationGranularity_(
+        &page_size, &prop, CU_MEM_ALLOC_GRANULARITY_MINIMUM));
+    max_size = page_size * ((size + page_size - 1) / page_size);
+    CUdeviceptr base = 0;
+    C10_CUDA_DRIVER_CHECK(DriverAPI::get()->cuMemAddressReserve_(&base, max_size, 0, 0, 0));
+    ptr = reinterpret_cast<char*>(base);
+  }
+
+  size_t round_to_pages(size_t size) const {
+    return page_size * ((size + page_size - 1) / page_size);
+  }
+
+  /** backs the next size bytes (a multiple of page_size) with physical memory.
+      returns false if the device is out of memory. */
+  bool map(size_t size)
+  {
+    TORCH_INTERNAL_ASSERT(size % page_size == 0);
+    if (mapped_size + size > max_size) {
+      return false;
+    }
+    const size_t num_mapped = handles.size();
+    for (size_t offset = 0; offset < size; offset += page_size) {
+      CUmemGenericAllocationHandle handle;
+      CUresult status = DriverAPI::get()->cuMemCreate_(&handle, page_size, &prop, 0);
+      if (status == CUDA_ERROR_OUT_OF_MEMORY) {
+        // Roll back the pages mapped so far.
+        unmap_pages(num_mapped);
+        return false;
+      }
+      C10_CUDA_DRIVER_CHECK(status);
+      CUdeviceptr address = reinterpret_cast<CUdeviceptr>(ptr + mapped_size + offset);
+      C10_CUDA_DRIVER_CHECK(DriverAPI::get()->cuMemMap_(address, page_size, 0, handle, 0));
+      handles.push_back(handle);
+    }
+
+    CUmemAccessDesc desc = {};
+    desc.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    desc.location.id = device;
+    desc.flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE;
+    C10_CUDA_DRIVER_CHECK(DriverAPI::get()->cuMemSetAccess_(
+        reinterpret_cast<CUdeviceptr>(ptr + mapped_size), size, &desc, 1));
+    mapped_size += size;
+    return true;
+  }
+
+  /** returns the physical memory of the last size bytes (a multiple of page_size) */
+  void unmap(size_t size)
+  {
+    TORCH_INTERNAL_ASSERT(size % page_size == 0 && size <= mapped_size);
+    // Unmapped memory may still be in use by kernels on the segment's stream.
+    C10_CUDA_CHECK(cudaStreamSynchronize(stream));
+    unmap_pages(handles.size() - size / page_size);
+    mapped_size -= size;
+  }
+
+ private:
+
+  void unmap_pages(size_t num_kept)
+  {
+    for (size_t i = num_kept; i < handles.size(); ++i) {
+      CUdeviceptr address = reinterpret_cast<CUdeviceptr>(ptr + i * page_size);
+      C10_CUDA_DRIVER_CHECK(DriverAPI::get()->cuMemUnmap_(address, page_size));
+      C10_CUDA_DRIVER_CHECK(DriverAPI::get()->cuMemRelease_(handles[i]));
+    }
+    handles.resize(num_kept);
+  }
+};
+
+// Returns whether large blocks should be carved from expandable segments
+// instead of separate cudaMalloc segments.
+static bool useExpandableSegments() {
+  static bool use_expandable = []() {
+    if (getenv("PYTORCH_CUDA_EXPANDABLE_SEGMENTS") == nullptr) {
+      return false;
+    }
+    if (DriverAPI::get() == nullptr) {
+      TORCH_WARN(
+          "PYTORCH_CUDA_EXPANDABLE_SEGMENTS is set, but the CUDA driver doesn't "
+          "support virtual memory management. Falling back to cudaMalloc segments.");
+      return false;
+    }
+    return true;
+  }();
+  return use_expandable;
+}
+
+#endif // C10_CUDA_EXPANDABLE_SEGMENTS
+
 static bool BlockComparator(const Block* a, const Block* b)
 {
   if (a->stream != b->stream) {
@@ -178,6 +418,29 @@ struct AllocParams {
   cudaError_t err;
 };
 
+// Blocks of the allocations made during the CUDA graph captures that share a
+// mempool id.
+struct PrivatePool {
+  PrivatePool() :
+      large_blocks(BlockComparator),
+      small_blocks(BlockComparator) {}
+  PrivatePool(const PrivatePool&) = delete;
+  PrivatePool& operator=(const PrivatePool&) = delete;
+
+  // number of captures (live graphs) using the pool
+  int use_count = 1;
+  // number of segments cudaMalloc'd into the pool and not yet cudaFree'd
+  int cudaMalloc_count = 0;
+  BlockPool large_blocks;
+  BlockPool small_blocks;
+};
+
+struct MempoolIdHash {
+  size_t operator()(const MempoolId_t& mempool_id) const noexcept {
+    return mempool_id.first != 0 ? mempool_id.first : mempool_id.second;
+  }
+};
+
 } // namespace
 
 class DeviceCachingAllocator {
@@ -199,9 +462,36 @@ class DeviceCachingAllocator {
   // allocated or in use by a stream
   std::unordered_set<Block*> active_blocks;
 
+  // segments carved into fixed-size blocks (slab mode only)
+  std::vector<Slab*> slabs;
+
+  // free slab blocks by stream and size class (slab mode only)
+  std::unordered_map<cudaStream_t, SlabStreamPool> slab_pools;
+
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+  // per-stream segments holding the large blocks (expandable segments only)
+  std::unordered_map<cudaStream_t, std::unique_ptr<ExpandableSegment>> expandable_segments;
+#endif
+
   // outstanding cuda events
   std::deque<std::pair<cudaEvent_t, Block*>> cuda_events;
 
+  // number of CUDA graph captures underway on the device
+  int captures_underway = 0;
+
+  // private pool of each capture underway
+  std::unordered_map<CaptureId_t, MempoolId_t> capture_to_pool_map;
+
+  // private pools of the captures, by mempool id
+  std::unordered_map<MempoolId_t, std::unique_ptr<PrivatePool>, MempoolIdHash> graph_pools;
+
+  // private pools no live graph uses, released by free_cached_blocks
+  std::unordered_map<MempoolId_t, PrivatePool*, MempoolIdHash> graph_pools_freeable;
+
+  // blocks freed during a capture, whose stream uses are recorded once no
+  // capture is underway (events can't be recorded or queried during capture)
+  std::vector<Block*> needs_events_deferred_until_no_capture;
+
   // record used memory.
   size_t total_allocated_memory = 0;
 
@@ -222,11 +512,25 @@ class DeviceCachingAllocator {
   {
     std::unique_lock<std::recursive_mutex> lock(mutex);
 
-    // process outstanding cudaEvents
-    process_events();
+    // process outstanding cudaEvents, which must not be queried while a
+    // capture is underway
+    if (C10_LIKELY(captures_underway == 0)) {
+      process_events();
+    }
+
+    PrivatePool* capture_pool = get_capture_pool(stream);
+
+    if (capture_pool == nullptr && useSlabAllocator() && size <= kSlabMaxSize) {
+      // Falls through to the small pool if a new slab can't be reserved, so
+      // that the usual free-and-retry and OOM reporting apply.
+      Block* block = slab_malloc(device, size, stream);
+      if (block != nullptr) {
+        return block;
+      }
+    }
 
     size = round_size(size);
-    auto& pool = get_pool(size);
+    auto& pool = get_pool(size, capture_pool);
     const size_t alloc_size = get_allocation_size(size);
     AllocParams params(device, size, stream, &pool, alloc_size, stats);
     params.stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
@@ -239,8 +543,9 @@ class DeviceCachingAllocator {
       || (trigger_free_memory_callbacks(params) && get_free_block(params))
       // Attempt allocate
       || alloc_block(params, false)
-      // Free all non-split cached blocks and retry alloc.
-      || (free_cached_blocks() && alloc_block(params, true));
+      // Free all non-split cached blocks and retry alloc. cudaFree is illegal
+      // while a capture is underway.
+      || (C10_LIKELY(captures_underway == 0) && free_cached_blocks() && alloc_block(params, true));
 
     if (!block_found) {
       // For any error code other than cudaErrorMemoryAllocation,
@@ -336,6 +641,8 @@ class DeviceCachingAllocator {
     update_stat_array(stats.active, 1, params.stat_types);
     update_stat_array(stats.active_bytes, block->size, params.stat_types);
 
+    record_trace(AllocationTraceAction::ALLOC, device, block->ptr, block->size, stream);
+
     return block;
   }
 
@@ -350,12 +657,18 @@ class DeviceCachingAllocator {
 
     StatTypes stat_types;
     stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
-    stat_types[static_cast<size_t>(get_stat_type_for_pool(*(block->pool)))] = true;
+    stat_types[static_cast<size_t>(get_stat_type_for_block(block))] = true;
     update_stat_array(stats.allocation, -1, {stat_types});
     update_stat_array(stats.allocated_bytes, -block->size, {stat_types});
 
+    record_trace(AllocationTraceAction::FREE, block->device, block->ptr, block->size, block->stream);
+
     if (!block->stream_uses.empty()) {
-      insert_events(block);
+      if (C10_UNLIKELY(captures_underway)) {
+        needs_events_deferred_until_no_capture.push_back(block);
+      } else {
+        insert_events(block);
+      }
     } else {
       free_block(block);
     }
@@ -363,6 +676,12 @@ class DeviceCachingAllocator {
 
   void* getBaseAllocation(Block* block, size_t* outSize) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (block->slab) {
+      if (outSize) {
+        *outSize = block->slab->size;
+      }
+      return block->slab->ptr;
+    }
     while (block->prev) {
       block = block->prev;
     }
@@ -397,6 +716,41 @@ class DeviceCachingAllocator {
     set_fraction = true;
   }
 
+  /** routes the allocations of a capture beginning on the device to the pool of mempool_id **/
+  void notifyCaptureBegin(CaptureId_t graph_id, MempoolId_t mempool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    captures_underway++;
+    auto it = graph_pools.find(mempool_id);
+    if (it == graph_pools.end()) {
+      graph_pools.emplace(mempool_id, std::unique_ptr<PrivatePool>(new PrivatePool()));
+    } else if (it->second->use_count++ == 0) {
+      // The pool outlived its last graph, which the new capture may reuse.
+      graph_pools_freeable.erase(mempool_id);
+    }
+    const bool inserted = capture_to_pool_map.emplace(graph_id, mempool_id).second;
+    TORCH_INTERNAL_ASSERT(inserted, "capture ", graph_id, " already began");
+  }
+
+  /** ends the routing of the allocations of a capture **/
+  void notifyCaptureEnd(CaptureId_t graph_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    TORCH_INTERNAL_ASSERT(capture_to_pool_map.erase(graph_id) == 1,
+                          "capture ", graph_id, " did not begin");
+    captures_underway--;
+  }
+
+  /** lets emptyCache release the pool of mempool_id once no graph uses it **/
+  void notifyCaptureDestroy(MempoolId_t mempool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = graph_pools.find(mempool_id);
+    TORCH_INTERNAL_ASSERT(it != graph_pools.end(), "invalid mempool id");
+    PrivatePool* private_pool = it->second.get();
+    TORCH_INTERNAL_ASSERT(private_pool->use_count > 0);
+    if (--private_pool->use_count == 0) {
+      graph_pools_freeable.emplace(mempool_id, private_pool);
+    }
+  }
+
   /** returns cached blocks to the system allocator **/
   void emptyCache() {
     std::lock_guard<std::recursive_mutex> lock(mutex);
@@ -414,6 +768,9 @@ class DeviceCachingAllocator {
     }
     cache_info_aux(large_blocks, total, largest);
     cache_info_aux(small_blocks, total, largest);
+    for (const Slab* slab : slabs) {
+      *total += slab->size - slab->live * slab->block_size;
+    }
   }
 
   /** Returns a copy of the memory allocator stats **/
@@ -472,7 +829,7 @@ class DeviceCachingAllocator {
       SegmentInfo& segment_info = result.back();
       segment_info.device = head_block->device;
       segment_info.address = reinterpret_cast<int64_t>(head_block->ptr);
-      segment_info.is_large = (head_block->pool == &large_blocks);
+      segment_info.is_large = !is_small_pool(head_block->pool);
 
       const Block* block = head_block;
       while (block != nullptr) {
@@ -495,6 +852,36 @@ class DeviceCachingAllocator {
       }
     }
 
+    for (const Slab* slab : slabs) {
+      result.emplace_back();
+      SegmentInfo& segment_info = result.back();
+      segment_info.device = slab->device;
+      segment_info.address = reinterpret_cast<int64_t>(slab->ptr);
+      segment_info.total_size = slab->size;
+      segment_info.is_slab = true;
+
+      for (const Block* block : slab->blocks) {
+        segment_info.blocks.emplace_back();
+        BlockInfo& block_info = segment_info.blocks.back();
+
+        block_info.size = block->size;
+        block_info.allocated = block->allocated;
+        block_info.active = block->allocated || (block->event_count > 0);
+
+        if (block_info.allocated) {
+          segment_info.allocated_size += block_info.size;
+        }
+        if (block_info.active) {
+          segment_info.active_size += block_info.size;
+        }
+      }
+      if (slab->carved < slab->size) {
+        // The not yet carved tail of the slab.
+        segment_info.blocks.emplace_back();
+        segment_info.blocks.back().size = slab->size - slab->carved;
+      }
+    }
+
     std::sort(result.begin(), result.end(), [](const SegmentInfo& a, const SegmentInfo& b) {
       return a.address < b.address;
     });
@@ -518,13 +905,144 @@ class DeviceCachingAllocator {
     std::vector<const Block*> blocks;
     blocks.insert(blocks.end(), small_blocks.begin(), small_blocks.end());
     blocks.insert(blocks.end(), large_blocks.begin(), large_blocks.end());
+    for (const auto& entry : graph_pools) {
+      const PrivatePool* private_pool = entry.second.get();
+      blocks.insert(blocks.end(), private_pool->small_blocks.begin(), private_pool->small_blocks.end());
+      blocks.insert(blocks.end(), private_pool->large_blocks.begin(), private_pool->large_blocks.end());
+    }
     blocks.insert(blocks.end(), active_blocks.begin(), active_blocks.end());
     return blocks;
   }
 
+  /** serves a small allocation from a slab; returns nullptr if no slab could be reserved */
+  Block* slab_malloc(int device, size_t size, cudaStream_t stream)
+  {
+    const size_t cls = slab_class(size);
+    const size_t block_size = kMinBlockSize << cls;
+    SlabStreamPool& stream_pool = slab_pools[stream];
+    std::vector<Block*>& free_list = stream_pool.free_lists[cls];
+
+    StatTypes stat_types;
+    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+    stat_types[static_cast<size_t>(StatType::SLAB_POOL)] = true;
+
+    Block* block = nullptr;
+    if (!free_list.empty()) {
+      block = free_list.back();
+      free_list.pop_back();
+    } else {
+      Slab*& slab = stream_pool.carving[cls];
+      if (slab == nullptr || slab->carved + block_size > slab->size) {
+        slab = alloc_slab(device, stream, block_size, stat_types);
+        if (slab == nullptr) {
+          return nullptr;
+        }
+      }
+      block = new Block(device, stream, block_size, nullptr,
+                        static_cast<char*>(slab->ptr) + slab->carved);
+      block->slab = slab;
+      slab->carved += block_size;
+      slab->blocks.push_back(block);
+    }
+
+    block->allocated = true;
+    block->slab->live++;
+
+    c10::reportMemoryUsageToProfiler(
+        block, block->size, c10::Device(c10::DeviceType::CUDA, device));
+
+    update_stat_array(stats.allocation, 1, stat_types);
+    update_stat_array(stats.allocated_bytes, block->size, stat_types);
+    update_stat_array(stats.active, 1, stat_types);
+    update_stat_array(stats.active_bytes, block->size, stat_types);
+
+    record_trace(AllocationTraceAction::ALLOC, device, block->ptr, block->size, stream);
+
+    return block;
+  }
+
+  /** reserves a new segment to carve blocks of block_size from */
+  Slab* alloc_slab(int device, cudaStream_t stream, size_t block_size, const StatTypes& stat_types)
+  {
+    AllocParams params(device, kSmallBuffer, stream, nullptr, kSmallBuffer, stats);
+    params.stat_types = stat_types;
+    if (!alloc_block(params, false)) {
+      return nullptr;
+    }
+    Slab* slab = new Slab(device, stream, params.block->ptr, params.block->size, block_size);
+    delete params.block;
+    slabs.push_back(slab);
+    return slab;
+  }
+
+  /** returns a slab block to the free list of its stream and size class */
+  void free_slab_block(Block* block)
+  {
+    TORCH_INTERNAL_ASSERT(!block->allocated && block->event_count == 0);
+
+    block->slab->live--;
+    slab_pools[block->stream].free_lists[slab_class(block->size)].push_back(block);
+
+    StatTypes stat_types;
+    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+    stat_types[static_cast<size_t>(StatType::SLAB_POOL)] = true;
+    update_stat_array(stats.active, -1, stat_types);
+    update_stat_array(stats.active_bytes, -block->size, stat_types);
+  }
+
+  /** frees all slabs none of whose blocks are in use */
+  void free_slabs()
+  {
+    const auto is_idle = [](const Block* block) {
+      return block->slab->live == 0;
+    };
+    for (auto& entry : slab_pools) {
+      SlabStreamPool& stream_pool = entry.second;
+      for (auto& free_list : stream_pool.free_lists) {
+        free_list.erase(
+            std::remove_if(free_list.begin(), free_list.end(), is_idle),
+            free_list.end());
+      }
+      for (Slab*& slab : stream_pool.carving) {
+        if (slab != nullptr && slab->live == 0) {
+          slab = nullptr;
+        }
+      }
+    }
+
+    StatTypes stat_types;
+    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+    stat_types[static_cast<size_t>(StatType::SLAB_POOL)] = true;
+
+    auto it = slabs.begin();
+    while (it != slabs.end()) {
+      Slab* slab = *it;
+      if (slab->live == 0) {
+        C10_CUDA_CHECK(cudaFree(slab->ptr));
+        total_allocated_memory -= slab->size;
+        update_stat_array(stats.segment, -1, stat_types);
+        update_stat_array(stats.reserved_bytes, -slab->size, stat_types);
+        record_trace(AllocationTraceAction::SEGMENT_FREE, slab->device, slab->ptr, slab->size, slab->stream);
+
+        for (Block* block : slab->blocks) {
+          delete block;
+        }
+        delete slab;
+        it = slabs.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
   /** moves a block into a pool of cached free blocks */
   void free_block(Block* block)
   {
+    if (block->slab) {
+      free_slab_block(block);
+      return;
+    }
+
     TORCH_INTERNAL_ASSERT(!block->allocated && block->event_count == 0);
 
     size_t original_block_size = block->size;
@@ -581,6 +1099,12 @@ class DeviceCachingAllocator {
       }
     }
 
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+    if (src->segment && src->segment->last == src) {
+      src->segment->last = dst;
+    }
+#endif
+
     const size_t subsumed_size = src->size;
     dst->size += subsumed_size;
     pool.erase(src);
@@ -589,7 +1113,10 @@ class DeviceCachingAllocator {
     return subsumed_size;
   }
 
-  BlockPool& get_pool(size_t size) {
+  BlockPool& get_pool(size_t size, PrivatePool* private_pool) {
+    if (private_pool != nullptr) {
+      return size <= kSmallSize ? private_pool->small_blocks : private_pool->large_blocks;
+    }
     if (size <= kSmallSize) {
       return small_blocks;
     } else {
@@ -597,24 +1124,70 @@ class DeviceCachingAllocator {
     }
   }
 
-  StatType get_stat_type_for_pool(const BlockPool& pool) {
-    if (&pool == &small_blocks) {
-      return StatType::SMALL_POOL;
-    } else if (&pool == &large_blocks) {
-      return StatType::LARGE_POOL;
-    } else {
-      AT_ERROR("get_stat_type_for_pool: invalid pool");
+  /** returns the private pool if stream is being captured, or nullptr */
+  PrivatePool* get_capture_pool(cudaStream_t stream) {
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+    // cudaStreamGetCaptureInfo is only needed while some capture is underway
+    // on the device, which is rare.
+    if (C10_LIKELY(captures_underway == 0)) {
+      return nullptr;
+    }
+    cudaStreamCaptureStatus status;
+    CaptureId_t id;
+    C10_CUDA_CHECK(cudaStreamGetCaptureInfo(stream, &status, &id));
+    // Nothing is recorded into an invalidated capture anymore, so its
+    // allocations may use the regular pools.
+    if (status != cudaStreamCaptureStatus::cudaStreamCaptureStatusActive) {
+      return nullptr;
     }
+    auto it = capture_to_pool_map.find(id);
+    TORCH_INTERNAL_ASSERT(it != capture_to_pool_map.end(),
+                          "stream is captured without notifyCaptureBegin");
+    return graph_pools.at(it->second).get();
+#else
+    return nullptr;
+#endif
+  }
+
+  /** returns the private pool that pool belongs to, or nullptr for the regular pools */
+  PrivatePool* get_private_pool(const BlockPool* pool) const {
+    if (pool == &small_blocks || pool == &large_blocks) {
+      return nullptr;
+    }
+    for (const auto& entry : graph_pools) {
+      PrivatePool* private_pool = entry.second.get();
+      if (pool == &private_pool->small_blocks || pool == &private_pool->large_blocks) {
+        return private_pool;
+      }
+    }
+    AT_ERROR("get_private_pool: invalid pool");
+  }
+
+  bool is_small_pool(const BlockPool* pool) const {
+    if (pool == &small_blocks) {
+      return true;
+    }
+    const PrivatePool* private_pool = get_private_pool(pool);
+    return private_pool != nullptr && pool == &private_pool->small_blocks;
+  }
+
+  StatType get_stat_type_for_block(const Block* block) {
+    if (block->slab) {
+      return StatType::SLAB_POOL;
+    }
+    return get_stat_type_for_pool(*(block->pool));
+  }
+
+  StatType get_stat_type_for_pool(const BlockPool& pool) {
+    return is_small_pool(&pool) ? StatType::SMALL_POOL : StatType::LARGE_POOL;
   }
 
   bool should_split(const Block* block, size_t size) {
     size_t remaining = block->size - size;
-    if (block->pool == &small_blocks) {
+    if (is_small_pool(block->pool)) {
       return remaining >= kMinBlockSize;
-    } else if (block->pool == &large_blocks) {
-      return remaining > kSmallSize;
     } else {
-      AT_ERROR("should_split: invalid pool");
+      return remaining > kSmallSize;
     }
   }
 
@@ -658,6 +1231,12 @@ class DeviceCachingAllocator {
       stats.num_alloc_retries += 1;
     }
 
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+    if (p.pool == &large_blocks && useExpandableSegments()) {
+      return expand_segment(p);
+    }
+#endif
+
     if (set_fraction && total_allocated_memory + size > allowed_memory_maximum) {
       p.err = cudaErrorMemoryAllocation;
       return false;
@@ -682,8 +1261,12 @@ class DeviceCachingAllocator {
 
     total_allocated_memory += size;
     p.block = new Block(p.device(), p.stream(), size, p.pool, (char*)ptr);
+    if (PrivatePool* private_pool = get_private_pool(p.pool)) {
+      private_pool->cudaMalloc_count++;
+    }
     update_stat_array(stats.segment, 1, p.stat_types);
     update_stat_array(stats.reserved_bytes, size, p.stat_types);
+    record_trace(AllocationTraceAction::SEGMENT_ALLOC, p.device(), ptr, size, p.stream());
 
     // p.block came from new, not cudaMalloc.  It should not be nullptr here.
     TORCH_INTERNAL_ASSERT(p.block != nullptr && p.block->ptr != nullptr);
@@ -699,24 +1282,161 @@ class DeviceCachingAllocator {
     // Free all non-split cached blocks
     free_blocks(large_blocks);
     free_blocks(small_blocks);
+    free_slabs();
+    release_graph_pools();
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+    release_expandable_segments();
+#endif
     return true;
   }
 
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+  /** maps enough memory at the end of the stream's segment to hold p.size() */
+  bool expand_segment(AllocParams& p)
+  {
+    std::unique_ptr<ExpandableSegment>& segment = expandable_segments[p.stream()];
+    if (!segment) {
+      size_t device_free;
+      size_t device_total;
+      C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total));
+      segment.reset(new ExpandableSegment(p.device(), p.stream(), device_total));
+    }
+
+    // A free block at the end of the segment is grown in place.
+    Block* tail = segment->last;
+    const bool tail_free = tail != nullptr && !tail->allocated && tail->event_count == 0;
+    const size_t reused = tail_free ? std::min(tail->size, p.size()) : 0;
+    const size_t growth = segment->round_to_pages(p.size() - reused);
+
+    if (set_fraction && total_allocated_memory + growth > allowed_memory_maximum) {
+      p.err = cudaErrorMemoryAllocation;
+      return false;
+    }
+    void* end = segment->ptr + segment->mapped_size;
+    if (!segment->map(growth)) {
+      p.err = cudaErrorMemoryAllocation;
+      return false;
+    }
+
+    total_allocated_memory += growth;
+    if (tail == nullptr) {
+      update_stat_array(stats.segment, 1, p.stat_types);
+    }
+    update_stat_array(stats.reserved_bytes, growth, p.stat_types);
+    record_trace(AllocationTraceAction::SEGMENT_ALLOC, p.device(), end, growth, p.stream());
+
+    if (tail_free) {
+      large_blocks.erase(tail);
+      tail->size += growth;
+      if (tail->is_split()) {
+        update_stat_array(stats.inactive_split_bytes, growth, p.stat_types);
+      }
+      p.block = tail;
+    } else {
+      Block* block = new Block(p.device(), p.stream(), growth, &large_blocks, end);
+      block->segment = segment.get();
+      block->prev = tail;
+      if (tail) {
+        // Appended after an in-use block, the new block starts out as an
+        // inactive split block, just as if it had been found in the pool.
+        tail->next = block;
+        update_stat_array(stats.inactive_split, 1, p.stat_types);
+        update_stat_array(stats.inactive_split_bytes, growth, p.stat_types);
+      }
+      segment->last = block;
+      p.block = block;
+    }
+    return true;
+  }
+
+  /** unmaps the pages covered by the free tail block of each segment */
+  void release_expandable_segments()
+  {
+    StatTypes stat_types;
+    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+    stat_types[static_cast<size_t>(StatType::LARGE_POOL)] = true;
+
+    for (auto& entry : expandable_segments) {
+      ExpandableSegment* segment = entry.second.get();
+      Block* tail = segment->last;
+      if (tail == nullptr || tail->allocated || tail->event_count > 0) {
+        continue;
+      }
+
+      // The head of the tail block may share a page with the previous block.
+      const size_t offset = static_cast<char*>(tail->ptr) - segment->ptr;
+      const size_t kept = segment->round_to_pages(offset) - offset;
+      if (kept >= tail->size) {
+        continue;
+      }
+      const size_t released = tail->size - kept;
+
+      large_blocks.erase(tail);
+      if (kept > 0) {
+        tail->size = kept;
+        large_blocks.insert(tail);
+        update_stat_array(stats.inactive_split_bytes, -released, stat_types);
+      } else {
+        if (tail->is_split()) {
+          update_stat_array(stats.inactive_split, -1, stat_types);
+          update_stat_array(stats.inactive_split_bytes, -tail->size, stat_types);
+        }
+        segment->last = tail->prev;
+        if (tail->prev) {
+          tail->prev->next = nullptr;
+        }
+        delete tail;
+      }
+
+      segment->unmap(released);
+      total_allocated_memory -= released;
+      update_stat_array(stats.reserved_bytes, -released, stat_types);
+      record_trace(AllocationTraceAction::SEGMENT_FREE, segment->device,
+                   segment->ptr + segment->mapped_size, released, segment->stream);
+      if (segment->mapped_size == 0) {
+        update_stat_array(stats.segment, -1, stat_types);
+      }
+    }
+  }
+#endif // C10_CUDA_EXPANDABLE_SEGMENTS
+
+  /** frees the blocks of private pools no graph uses, and the pools once empty */
+  void release_graph_pools()
+  {
+    auto it = graph_pools_freeable.begin();
+    while (it != graph_pools_freeable.end()) {
+      PrivatePool* private_pool = it->second;
+      free_blocks(private_pool->large_blocks);
+      free_blocks(private_pool->small_blocks);
+      if (private_pool->cudaMalloc_count == 0) {
+        graph_pools.erase(it->first);
+        it = graph_pools_freeable.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
   void free_blocks(BlockPool& blocks)
   {
     // Frees all non-split blocks
     auto it = blocks.begin();
     while (it != blocks.end()) {
       Block* block = *it;
-      if (!block->prev && !block->next) {
+      // Blocks of expandable segments are released by unmapping instead.
+      if (!block->prev && !block->next && !block->segment) {
         C10_CUDA_CHECK(cudaFree((void*)block->ptr));
         total_allocated_memory -= block->size;
+        if (PrivatePool* private_pool = get_private_pool(block->pool)) {
+          private_pool->cudaMalloc_count--;
+        }
 
         StatTypes stat_types;
         stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
         stat_types[static_cast<size_t>(get_stat_type_for_pool(*(block->pool)))] = true;
         update_stat_array(stats.segment, -1, stat_types);
         update_stat_array(stats.reserved_bytes, -block->size, stat_types);
+        record_trace(AllocationTraceAction::SEGMENT_FREE, block->device, block->ptr, block->size, block->stream);
 
         auto cur = it;
         ++it;
@@ -728,6 +1448,22 @@ class DeviceCachingAllocator {
     }
   }
 
+  /** records an event to the allocation trace, if enabled */
+  void record_trace(AllocationTraceAction action, int device, void* ptr, size_t size, cudaStream_t stream)
+  {
+    if (C10_LIKELY(!allocationTraceEnabled())) {
+      return;
+    }
+    recordAllocationTrace(
+        action,
+        c10::Device(c10::DeviceType::CUDA, device),
+        ptr,
+        size,
+        reinterpret_cast<uintptr_t>(stream),
+        stats.allocated_bytes[static_cast<size_t>(StatType::AGGREGATE)].current,
+        stats.reserved_bytes[static_cast<size_t>(StatType::AGGREGATE)].current);
+  }
+
   cudaEvent_t create_event_internal() {
     cudaEvent_t event;
     C10_CUDA_CHECK(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
@@ -777,8 +1513,19 @@ class DeviceCachingAllocator {
     C10_CUDA_CHECK(cudaSetDevice(prev_device));
   }
 
+  void insert_events_deferred_until_no_capture()
+  {
+    for (Block* block : needs_events_deferred_until_no_capture) {
+      TORCH_INTERNAL_ASSERT(!block->stream_uses.empty());
+      insert_events(block);
+    }
+    needs_events_deferred_until_no_capture.clear();
+  }
+
   void process_events()
   {
+    insert_events_deferred_until_no_capture();
+
     // Process outstanding cudaEvents. Events that are completed are removed
     // from the queue, and the 'event_count' for the corresponding allocation
     // is decremented. Stops at the first event which has not been completed.
@@ -871,6 +1618,7 @@ class THCCachingAllocator {
 
   /** allocates a block which is safe to use from the provided stream */
   void malloc(void** devPtr, int device, size_t size, cudaStream_t stream) {
+    C10_OVERHEAD_PROBE(ALLOCATOR);
     TORCH_INTERNAL_ASSERT(
         0 <= device && device < device_allocator.size(),
         "Allocator not initialized for device ",
@@ -1058,6 +1806,21 @@ std::vector<SegmentInfo> snapshot() {
   return caching_allocator.snapshot();
 }
 
+void notifyCaptureBegin(int device, CaptureId_t graph_id, MempoolId_t mempool_id) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->notifyCaptureBegin(graph_id, mempool_id);
+}
+
+void notifyCaptureEnd(int device, CaptureId_t graph_id) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->notifyCaptureEnd(graph_id);
+}
+
+void notifyCaptureDestroy(int device, MempoolId_t mempool_id) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->notifyCaptureDestroy(mempool_id);
+}
+
 //
 // In CUDA IPC, sender sends a tensor to receiver, getIpcDevPtr
 // is called by the receiving process to map the CUDA memory from the sending
@@ -8,6 +8,7 @@
 
 #include <array>
 #include <mutex>
+#include <utility>
 
 namespace c10 {
 
@@ -55,7 +56,8 @@ enum struct StatType : uint64_t {
   AGGREGATE = 0,
   SMALL_POOL = 1,
   LARGE_POOL = 2,
-  NUM_TYPES = 3  // remember to update this whenever a new stat type is added
+  SLAB_POOL = 3,
+  NUM_TYPES = 4  // remember to update this whenever a new stat type is added
 };
 
 typedef std::array<Stat, static_cast<size_t>(StatType::NUM_TYPES)> StatArray;
@@ -102,9 +104,18 @@ struct SegmentInfo {
   int64_t allocated_size = 0;
   int64_t active_size = 0;
   bool is_large = false;
+  bool is_slab = false;
   std::vector<BlockInfo> blocks;
 };
 
+// CUDA graph capture ids and private memory pool ids. Allocations made on a
+// stream that is being captured are served from a private pool of the
+// capture, so that the memory the graph uses is never handed out to work
+// outside the graph, even after the tensors of the capture are freed.
+// Captures that pass the same mempool id share a pool.
+typedef unsigned long long CaptureId_t;
+typedef std::pair<CaptureId_t, CaptureId_t> MempoolId_t;
+
 C10_CUDA_API void* raw_alloc(size_t nbytes);
 C10_CUDA_API void* raw_alloc_with_stream(size_t nbytes, cudaStream_t stream);
 C10_CUDA_API void raw_delete(void* ptr);
@@ -121,6 +132,10 @@ C10_CUDA_API void resetAccumulatedStats(int device);
 C10_CUDA_API void resetPeakStats(int device);
 C10_CUDA_API std::vector<SegmentInfo> snapshot();
 
+C10_CUDA_API void notifyCaptureBegin(int device, CaptureId_t graph_id, MempoolId_t mempool_id);
+C10_CUDA_API void notifyCaptureEnd(int device, CaptureId_t graph_id);
+C10_CUDA_API void notifyCaptureDestroy(int device, MempoolId_t mempool_id);
+
 C10_CUDA_API std::mutex* getFreeMutex();
 
 C10_CUDA_API std::shared_ptr<void> getIpcDevPtr(std::string handle);
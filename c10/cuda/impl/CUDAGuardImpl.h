@@ -4,6 +4,7 @@
 #include <c10/macros/Macros.h>
 #include <c10/util/Exception.h>
 
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/cuda/CUDAException.h>
 #include <c10/cuda/CUDAStream.h>
 #include <c10/cuda/CUDAFunctions.h>
@@ -65,6 +66,9 @@ struct CUDAGuardImpl final : public c10::impl::DeviceGuardImplInterface {
   Stream getDefaultStream(Device d) const override {
     return getDefaultCUDAStream(d.index());
   }
+  Stream getStreamFromPool(Device d, bool isHighPriority = false) const override {
+    return c10::cuda::getStreamFromPool(isHighPriority, d.index()).unwrap();
+  }
   // NB: These do NOT set the current device
   Stream exchangeStream(Stream s) const noexcept override {
     CUDAStream cs(s);
@@ -164,6 +168,13 @@ struct CUDAGuardImpl final : public c10::impl::DeviceGuardImplInterface {
     }
     return (err == cudaSuccess);
   }
+
+  void recordDataPtrOnStream(
+    const c10::DataPtr& data_ptr,
+    const Stream& stream) const override {
+    CUDAStream cuda_stream{stream};
+    CUDACachingAllocator::recordStream(data_ptr, cuda_stream);
+  }
 };
 
 }}} // namespace c10::cuda::impl
@@ -94,7 +94,7 @@ class C10_API CPUCachingAllocator {
 CPUCachingAllocator* GetDefaultCPUCachingAllocator();
 
 bool ThreadLocalCachingAllocatorEnabled();
-CPUCachingAllocator* GetThreadLocalCachingAllocator();
+C10_API CPUCachingAllocator* GetThreadLocalCachingAllocator();
 
 class C10_API WithCPUCachingAllocatorGuard {
   public:
@@ -266,8 +266,17 @@ void AllocationPlanner::record_free(const void* ptr) {
 
 bool AllocationPlanner::validate_allocation(
     const uint64_t size, const void* ptr) {
-  if (allocation_id_ >= allocation_plan_->allocation_sizes.size() ||
-      allocation_plan_->allocation_sizes[allocation_id_] != size) {
+  if (allocation_id_ >= allocation_plan_->allocation_sizes.size()) {
+    TORCH_WARN(
+        "Allocation request does not match plan:",
+        "Allocation id:",
+        allocation_id_,
+        ", Number of recorded allocations:",
+        allocation_plan_->allocation_sizes.size());
+
+    return false;
+  }
+  if (allocation_plan_->allocation_sizes[allocation_id_] != size) {
     TORCH_WARN(
         "Allocation request does not match plan:",
         "Allocation id:",
@@ -339,6 +348,8 @@ void CPUProfilingAllocator::unset_plan() {
 }
 
 void* CPUProfilingAllocator::allocate(const size_t bytes) {
+  TORCH_CHECK(allocation_id_ < plan_->allocation_sizes.size(),
+      "Got more allocation requests than the plan has.");
   TORCH_CHECK(bytes == plan_->allocation_sizes[allocation_id_],
       "Got allocation request that does not match with the plan.");
   if (plan_->allocation_lifetimes[allocation_id_] ==
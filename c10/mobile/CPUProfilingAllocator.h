@@ -123,7 +123,7 @@ class C10_API WithValidateAllocationPlanGuard {
     bool* success_;
 };
 
-AllocationPlanner* GetThreadLocalAllocationPlanner();
+C10_API AllocationPlanner* GetThreadLocalAllocationPlanner();
 
 /*
  * Usage: Allocate tensors accordingly to allocation plan
@@ -144,6 +144,6 @@ class C10_API WithProfilingAllocatorGuard {
     ~WithProfilingAllocatorGuard();
 };
 
-CPUProfilingAllocator* GetThreadLocalProfilingAllocator();
+C10_API CPUProfilingAllocator* GetThreadLocalProfilingAllocator();
 
 } // namespace c10
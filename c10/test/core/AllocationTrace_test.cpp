@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <c10/core/AllocationTrace.h>
+#include <c10/core/CPUAllocator.h>
+
+using namespace c10;
+
+TEST(AllocationTraceTest, RecordsCPUAllocations) {
+  at::Allocator* allocator = GetDefaultCPUAllocator();
+  enableAllocationTrace(16);
+  void* addr = nullptr;
+  {
+    AllocationTraceContextGuard guard("outer");
+    at::DataPtr outer = allocator->allocate(100);
+    {
+      AllocationTraceContextGuard inner_guard("inner");
+      at::DataPtr inner = allocator->allocate(200);
+      addr = inner.get();
+    }
+  }
+  ASSERT_EQ(currentAllocationTraceContext(), nullptr);
+  disableAllocationTrace();
+  // Not recorded once disabled
+  allocator->allocate(300);
+
+  const auto trace = getAllocationTrace();
+  ASSERT_EQ(trace.size(), 4);
+  ASSERT_EQ(trace[0].action, AllocationTraceAction::ALLOC);
+  ASSERT_EQ(trace[0].size, 100);
+  ASSERT_STREQ(trace[0].context, "outer");
+  ASSERT_EQ(trace[1].action, AllocationTraceAction::ALLOC);
+  ASSERT_EQ(trace[1].size, 200);
+  ASSERT_EQ(trace[1].addr, reinterpret_cast<uintptr_t>(addr));
+  ASSERT_STREQ(trace[1].context, "inner");
+  ASSERT_EQ(trace[1].allocated, trace[0].allocated + 200);
+  ASSERT_EQ(trace[2].action, AllocationTraceAction::FREE);
+  ASSERT_EQ(trace[2].addr, reinterpret_cast<uintptr_t>(addr));
+  ASSERT_STREQ(trace[2].context, "inner");
+  ASSERT_EQ(trace[3].action, AllocationTraceAction::FREE);
+  ASSERT_EQ(trace[3].size, 100);
+  ASSERT_STREQ(trace[3].context, "outer");
+  for (const auto& entry : trace) {
+    ASSERT_EQ(entry.device, Device(DeviceType::CPU));
+  }
+  ASSERT_EQ(allocationTraceDropped(), 0);
+}
+
+TEST(AllocationTraceTest, DropsOldestEntries) {
+  at::Allocator* allocator = GetDefaultCPUAllocator();
+  enableAllocationTrace(3);
+  for (size_t size = 1; size <= 4; ++size) {
+    // Each allocation records its alloc and free
+    allocator->allocate(size);
+  }
+  disableAllocationTrace();
+
+  const auto trace = getAllocationTrace();
+  ASSERT_EQ(trace.size(), 3);
+  ASSERT_EQ(allocationTraceDropped(), 5);
+  ASSERT_EQ(trace[0].action, AllocationTraceAction::FREE);
+  ASSERT_EQ(trace[0].size, 3);
+  ASSERT_EQ(trace[1].action, AllocationTraceAction::ALLOC);
+  ASSERT_EQ(trace[1].size, 4);
+  ASSERT_EQ(trace[2].action, AllocationTraceAction::FREE);
+  ASSERT_EQ(trace[2].size, 4);
+}
+
+TEST(AllocationTraceTest, InternsContexts) {
+  std::string name = "context";
+  const char* interned = internAllocationTraceContext(name);
+  name[0] = 'C';
+  ASSERT_STREQ(interned, "context");
+  ASSERT_EQ(internAllocationTraceContext("context"), interned);
+}
+
+TEST(AllocationTraceTest, ExportsChromeTrace) {
+  at::Allocator* allocator = GetDefaultCPUAllocator();
+  enableAllocationTrace(16);
+  {
+    AllocationTraceContextGuard guard("peak \"op\"");
+    at::DataPtr ptr = allocator->allocate(1000);
+  }
+  disableAllocationTrace();
+
+  const std::string path = testing::TempDir() + "allocation_trace_test.json";
+  exportAllocationTraceChrome(path);
+  std::ifstream in(path);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  std::remove(path.c_str());
+
+  const auto json = contents.str();
+  ASSERT_NE(json.find("\"traceEvents\""), std::string::npos);
+  ASSERT_NE(json.find("\"name\": \"alloc\""), std::string::npos);
+  ASSERT_NE(json.find("\"name\": \"free\""), std::string::npos);
+  ASSERT_NE(json.find("\"name\": \"cpu\""), std::string::npos);
+  // The 1000 bytes of the op are live at the peak
+  ASSERT_NE(json.find("\"peak \\\"op\\\"\": 1000"), std::string::npos);
+}
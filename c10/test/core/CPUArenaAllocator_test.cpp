@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/CPUArenaAllocator.h>
+
+using namespace c10;
+
+namespace {
+
+CPUArenaAllocator::ArenaStats statsAfterEmptyCache() {
+  CPUArenaAllocator::emptyCache();
+  return CPUArenaAllocator::getStats();
+}
+
+} // namespace
+
+TEST(CPUArenaAllocatorTest, ReusesFreedBlocks) {
+  at::Allocator* allocator = CPUArenaAllocator::get();
+  void* first = nullptr;
+  {
+    at::DataPtr ptr = allocator->allocate(1000);
+    first = ptr.get();
+    ASSERT_EQ(first, ptr.get_context());
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(first) % gAlignment, 0);
+  }
+  // A request of the same size class is served from the arena's cache.
+  at::DataPtr ptr = allocator->allocate(1024);
+  ASSERT_EQ(ptr.get(), first);
+}
+
+TEST(CPUArenaAllocatorTest, Stats) {
+  at::Allocator* allocator = CPUArenaAllocator::get();
+  const auto before = statsAfterEmptyCache();
+  {
+    at::DataPtr small = allocator->allocate(100);
+    at::DataPtr large = allocator->allocate(10 << 20);
+
+    const auto stats = CPUArenaAllocator::getStats();
+    ASSERT_EQ(stats.allocation.current, before.allocation.current + 2);
+    ASSERT_EQ(
+        stats.allocated_bytes.current,
+        before.allocated_bytes.current + 128 + (10 << 20));
+    ASSERT_EQ(
+        stats.reserved_bytes.current,
+        before.reserved_bytes.current + 128 + (10 << 20));
+  }
+  // The small block stays cached, the large one isn't cached.
+  auto stats = CPUArenaAllocator::getStats();
+  ASSERT_EQ(stats.allocation.current, before.allocation.current);
+  ASSERT_EQ(stats.reserved_bytes.current, before.reserved_bytes.current + 128);
+
+  stats = statsAfterEmptyCache();
+  ASSERT_EQ(stats.reserved_bytes.current, before.reserved_bytes.current);
+}
+
+TEST(CPUArenaAllocatorTest, CrossThreadFreeReturnsToOwningArena) {
+  at::Allocator* allocator = CPUArenaAllocator::get();
+  at::DataPtr ptr = allocator->allocate(4096);
+  void* data = ptr.get();
+  const auto before = CPUArenaAllocator::getStats();
+
+  std::thread([&ptr]() { ptr.clear(); }).join();
+
+  const auto stats = CPUArenaAllocator::getStats();
+  ASSERT_EQ(stats.num_cross_thread_frees, before.num_cross_thread_frees + 1);
+  // The freed block is back in this thread's arena.
+  at::DataPtr reused = allocator->allocate(4096);
+  ASSERT_EQ(reused.get(), data);
+}
+
+TEST(CPUArenaAllocatorTest, ArenasAreReusedAcrossThreads) {
+  at::Allocator* allocator = CPUArenaAllocator::get();
+  std::thread([allocator]() { allocator->allocate(64); }).join();
+  const auto num_arenas = CPUArenaAllocator::getStats().num_arenas;
+  std::thread([allocator]() { allocator->allocate(64); }).join();
+  ASSERT_EQ(CPUArenaAllocator::getStats().num_arenas, num_arenas);
+}
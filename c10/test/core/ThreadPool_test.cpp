@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <thread>
+
+#include <c10/core/thread_pool.h>
+
+using namespace c10;
+
+TEST(ThreadPoolStatsTest, StatsBucket) {
+  EXPECT_EQ(threadPoolStatsBucket(0), 0);
+  EXPECT_EQ(threadPoolStatsBucket(1), 1);
+  EXPECT_EQ(threadPoolStatsBucket(3), 2);
+  EXPECT_EQ(threadPoolStatsBucket(1024), 11);
+  EXPECT_EQ(
+      threadPoolStatsBucket(std::numeric_limits<uint64_t>::max()),
+      kThreadPoolStatsNumBuckets - 1);
+}
+
+TEST(ThreadPoolStatsTest, CountsTasks) {
+  ThreadPool pool(2);
+  EXPECT_FALSE(pool.statsEnabled());
+  // Not counted while disabled
+  pool.run([]() {});
+  pool.waitWorkComplete();
+
+  pool.enableStats(true);
+  EXPECT_TRUE(pool.statsEnabled());
+  std::atomic<int> done{0};
+  for (int i = 0; i < 8; ++i) {
+    pool.run([&done]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      done++;
+    });
+  }
+  pool.runTaskWithID([&done](std::size_t /* unused */) { done++; });
+  pool.waitWorkComplete();
+  ASSERT_EQ(done, 9);
+
+  auto stats = pool.getStats();
+  EXPECT_EQ(stats.tasks_queued, 9);
+  EXPECT_EQ(stats.tasks_executed, 9);
+  EXPECT_EQ(
+      std::accumulate(
+          stats.wait_histogram.begin(), stats.wait_histogram.end(), uint64_t(0)),
+      9);
+  ASSERT_EQ(stats.busy_ns.size(), 2);
+  ASSERT_EQ(stats.idle_ns.size(), 2);
+  // The tasks slept for 8ms in total
+  EXPECT_GE(stats.busy_ns[0] + stats.busy_ns[1], 8000000);
+
+  pool.resetStats();
+  stats = pool.getStats();
+  EXPECT_EQ(stats.tasks_queued, 0);
+  EXPECT_EQ(stats.tasks_executed, 0);
+  EXPECT_EQ(stats.wait_total_ns, 0);
+  ASSERT_EQ(stats.busy_ns.size(), 2);
+
+  pool.enableStats(false);
+  pool.run([]() {});
+  pool.waitWorkComplete();
+  EXPECT_EQ(pool.getStats().tasks_queued, 0);
+}
+
+TEST(ThreadPoolTest, HelpUntilComplete) {
+  EXPECT_FALSE(ThreadPool::canHelpWhileWaiting());
+
+  // Helping is opt-in
+  ThreadPool pool(1);
+  std::atomic<bool> can_help{true};
+  pool.run([&]() { can_help = ThreadPool::canHelpWhileWaiting(); });
+  pool.waitWorkComplete();
+  EXPECT_FALSE(can_help);
+
+  // The only worker runs the task it waits for
+  pool.setHelpWhileWaiting(true);
+  std::atomic<bool> inner_done{false};
+  std::atomic<bool> outer_done{false};
+  pool.run([&]() {
+    ASSERT_TRUE(ThreadPool::canHelpWhileWaiting());
+    auto waiter = std::make_shared<ThreadPool::HelpingWaiter>();
+    pool.run([&inner_done, waiter]() {
+      inner_done = true;
+      waiter->complete();
+    });
+    ThreadPool::helpUntilComplete(waiter);
+    EXPECT_TRUE(inner_done);
+    outer_done = true;
+  });
+  pool.waitWorkComplete();
+  ASSERT_TRUE(outer_done);
+
+  // A waiter completed from another thread wakes the worker up
+  std::atomic<bool> woken{false};
+  auto waiter = std::make_shared<ThreadPool::HelpingWaiter>();
+  pool.run([&woken, waiter]() {
+    ThreadPool::helpUntilComplete(waiter);
+    woken = true;
+  });
+  std::thread([waiter]() { waiter->complete(); }).join();
+  pool.waitWorkComplete();
+  ASSERT_TRUE(woken);
+}
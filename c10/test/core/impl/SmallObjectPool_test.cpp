@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/impl/SmallObjectPool.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace c10::impl;
+
+namespace {
+
+struct Small {
+  C10_SMALL_OBJECT_POOL_ALLOCATION_FUNCTIONS
+
+  virtual ~Small() = default;
+  char data[24];
+};
+
+// Same size class as Small for some sizes, and deleted through a Small*
+struct Derived : public Small {
+  char more[100];
+};
+
+struct Large {
+  C10_SMALL_OBJECT_POOL_ALLOCATION_FUNCTIONS
+
+  char data[kMaxSmallObjectSize + 1];
+};
+
+bool is_aligned(const void* ptr) {
+  return reinterpret_cast<uintptr_t>(ptr) % kSmallObjectAlignment == 0;
+}
+
+} // namespace
+
+TEST(SmallObjectPoolTest, AllocateAndFree) {
+  std::vector<std::unique_ptr<Small>> objects;
+  for (int i = 0; i < 1000; ++i) {
+    if (i % 2) {
+      objects.emplace_back(new Derived());
+    } else {
+      objects.emplace_back(new Small());
+    }
+    ASSERT_TRUE(is_aligned(objects.back().get()));
+    std::memset(objects.back()->data, i, sizeof(Small::data));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(objects[i]->data[0], static_cast<char>(i));
+  }
+  objects.clear();
+
+  // blocks are reused after they are freed
+  for (int i = 0; i < 1000; ++i) {
+    std::unique_ptr<Small> object(new Derived());
+    ASSERT_TRUE(is_aligned(object.get()));
+    std::memset(static_cast<Derived*>(object.get())->more, 0, sizeof(Derived::more));
+  }
+
+  std::unique_ptr<Large> large(new Large());
+  std::memset(large->data, 0, sizeof(Large::data));
+}
+
+TEST(SmallObjectPoolTest, FreeOnAnotherThread) {
+  std::vector<Small*> objects;
+  for (int i = 0; i < 500; ++i) {
+    objects.push_back(new Small());
+  }
+  std::thread thread([&] {
+    for (Small* object : objects) {
+      delete object;
+    }
+    // the blocks cached by this thread are released when it exits
+    for (int i = 0; i < 500; ++i) {
+      delete new Derived();
+    }
+  });
+  thread.join();
+}
+
+TEST(SmallObjectPoolTest, PlacementNew) {
+  alignas(Small) char buffer[sizeof(Small)];
+  Small* object = new (buffer) Small();
+  ASSERT_EQ(static_cast<void*>(object), static_cast<void*>(buffer));
+  object->~Small();
+}
+
+TEST(SmallObjectPoolTest, Allocator) {
+  // the buffer grows from the pool to the global operator new
+  std::vector<int64_t, SmallObjectAllocator<int64_t>> values;
+  for (int64_t i = 0; i < 1000; ++i) {
+    values.push_back(i);
+    ASSERT_TRUE(is_aligned(values.data()));
+  }
+  for (int64_t i = 0; i < 1000; ++i) {
+    ASSERT_EQ(values[i], i);
+  }
+  auto copy = values;
+  values.clear();
+  values.shrink_to_fit();
+  ASSERT_EQ(copy.size(), 1000u);
+  ASSERT_EQ(copy.back(), 999);
+}
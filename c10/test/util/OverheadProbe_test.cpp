@@ -0,0 +1,68 @@
+#include <c10/util/OverheadProbe.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace {
+
+using c10::OverheadProbe;
+using c10::OverheadStage;
+
+const c10::OverheadStageStats& stageStats(
+    const c10::OverheadStats& stats,
+    OverheadStage stage) {
+  return stats[static_cast<size_t>(stage)];
+}
+
+TEST(OverheadProbeTest, StageNames) {
+  EXPECT_STREQ(
+      c10::overheadStageName(OverheadStage::PYTHON_ARG_PARSING),
+      "python_arg_parsing");
+  EXPECT_STREQ(
+      c10::overheadStageName(OverheadStage::KERNEL_LAUNCH), "kernel_launch");
+}
+
+TEST(OverheadProbeTest, DisabledProbesRecordNothing) {
+  c10::setOverheadProbesEnabled(false);
+  c10::resetOverheadStats();
+  { OverheadProbe probe(OverheadStage::DISPATCH); }
+  EXPECT_EQ(
+      stageStats(c10::getOverheadStats(), OverheadStage::DISPATCH).count, 0u);
+}
+
+TEST(OverheadProbeTest, NestedProbes) {
+  c10::setOverheadProbesEnabled(true);
+  c10::resetOverheadStats();
+  {
+    OverheadProbe dispatch(OverheadStage::DISPATCH);
+    {
+      OverheadProbe kernel(OverheadStage::KERNEL);
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    { OverheadProbe kernel(OverheadStage::KERNEL); }
+  }
+  c10::setOverheadProbesEnabled(false);
+  const auto stats = c10::getOverheadStats();
+  const auto& dispatch = stageStats(stats, OverheadStage::DISPATCH);
+  const auto& kernel = stageStats(stats, OverheadStage::KERNEL);
+
+  if (!c10::overheadProbesCompiled()) {
+    // Enabling is a no-op without C10_USE_OVERHEAD_PROBES
+    EXPECT_EQ(dispatch.count, 0u);
+    EXPECT_EQ(kernel.count, 0u);
+    return;
+  }
+  EXPECT_EQ(dispatch.count, 1u);
+  EXPECT_EQ(kernel.count, 2u);
+  EXPECT_EQ(kernel.total_ns, kernel.self_ns);
+  EXPECT_GE(kernel.total_ns, 4000000u);
+  EXPECT_GE(dispatch.total_ns, kernel.total_ns);
+  // The self time of dispatch excludes the sleep in the kernel
+  EXPECT_LT(dispatch.self_ns, dispatch.total_ns - 4000000u);
+
+  c10::resetOverheadStats();
+  EXPECT_EQ(
+      stageStats(c10::getOverheadStats(), OverheadStage::KERNEL).count, 0u);
+}
+
+} // namespace
@@ -0,0 +1,151 @@
+#include <c10/util/OverheadProbe.h>
+
+#include <c10/util/Exception.h>
+
+namespace c10 {
+
+namespace detail {
+std::atomic<bool> overhead_probes_enabled{false};
+} // namespace detail
+
+namespace {
+
+struct StageCounters {
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> total_ticks{0};
+  std::atomic<uint64_t> self_ticks{0};
+};
+
+std::array<StageCounters, kNumOverheadStages>& stageCounters() {
+  static std::array<StageCounters, kNumOverheadStages> counters_;
+  return counters_;
+}
+
+// The innermost active probe of this thread
+thread_local OverheadProbe* current_probe = nullptr;
+
+using steady_clock = std::chrono::steady_clock;
+
+// The ticks and the time at which the ticks per nanosecond are measured
+// from, taken when the probes are first enabled
+struct TickAnchor {
+  TickAnchor() : ticks(readOverheadTicks()), time(steady_clock::now()) {}
+
+  const uint64_t ticks;
+  const steady_clock::time_point time;
+};
+
+const TickAnchor& tickAnchor() {
+  static TickAnchor anchor_;
+  return anchor_;
+}
+
+double nanosecondsPerTick() {
+  const auto& anchor = tickAnchor();
+  // Too short an interval would give an imprecise ratio
+  constexpr auto kMinInterval = std::chrono::milliseconds(10);
+  steady_clock::time_point now;
+  uint64_t ticks = 0;
+  do {
+    ticks = readOverheadTicks();
+    now = steady_clock::now();
+  } while (now - anchor.time < kMinInterval);
+  const auto ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now - anchor.time)
+          .count();
+  return ticks > anchor.ticks ? static_cast<double>(ns) / (ticks - anchor.ticks)
+                              : 1.;
+}
+
+} // namespace
+
+const char* overheadStageName(OverheadStage stage) {
+  switch (stage) {
+    case OverheadStage::PYTHON_ARG_PARSING:
+      return "python_arg_parsing";
+    case OverheadStage::DISPATCH:
+      return "dispatch";
+    case OverheadStage::KERNEL:
+      return "kernel";
+    case OverheadStage::TENSOR_ITERATOR_BUILD:
+      return "tensor_iterator_build";
+    case OverheadStage::ALLOCATOR:
+      return "allocator";
+    case OverheadStage::KERNEL_LAUNCH:
+      return "kernel_launch";
+    default:
+      TORCH_CHECK(false, "Unknown overhead stage ", static_cast<int>(stage));
+  }
+}
+
+bool overheadProbesCompiled() {
+#ifdef C10_USE_OVERHEAD_PROBES
+  return true;
+#else
+  return false;
+#endif
+}
+
+void setOverheadProbesEnabled(bool enabled) {
+  if (!overheadProbesCompiled()) {
+    return;
+  }
+  if (enabled) {
+    tickAnchor();
+  }
+  detail::overhead_probes_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+OverheadStats getOverheadStats() {
+  OverheadStats stats;
+  auto& counters = stageCounters();
+  bool any = false;
+  for (size_t i = 0; i < kNumOverheadStages; ++i) {
+    stats[i].count = counters[i].count.load(std::memory_order_relaxed);
+    any = any || stats[i].count > 0;
+  }
+  if (!any) {
+    return stats;
+  }
+  const double ns_per_tick = nanosecondsPerTick();
+  for (size_t i = 0; i < kNumOverheadStages; ++i) {
+    stats[i].total_ns = static_cast<uint64_t>(
+        counters[i].total_ticks.load(std::memory_order_relaxed) * ns_per_tick);
+    stats[i].self_ns = static_cast<uint64_t>(
+        counters[i].self_ticks.load(std::memory_order_relaxed) * ns_per_tick);
+  }
+  return stats;
+}
+
+void resetOverheadStats() {
+  for (auto& counters : stageCounters()) {
+    counters.count.store(0, std::memory_order_relaxed);
+    counters.total_ticks.store(0, std::memory_order_relaxed);
+    counters.self_ticks.store(0, std::memory_order_relaxed);
+  }
+}
+
+void OverheadProbe::begin(OverheadStage stage) {
+  stage_ = stage;
+  active_ = true;
+  parent_ = current_probe;
+  current_probe = this;
+  start_ticks_ = readOverheadTicks();
+}
+
+void OverheadProbe::end() {
+  const uint64_t end_ticks = readOverheadTicks();
+  const uint64_t ticks = end_ticks > start_ticks_ ? end_ticks - start_ticks_ : 0;
+  auto& counters = stageCounters()[static_cast<size_t>(stage_)];
+  counters.count.fetch_add(1, std::memory_order_relaxed);
+  counters.total_ticks.fetch_add(ticks, std::memory_order_relaxed);
+  counters.self_ticks.fetch_add(
+      ticks > children_ticks_ ? ticks - children_ticks_ : 0,
+      std::memory_order_relaxed);
+  if (parent_) {
+    parent_->children_ticks_ += ticks;
+  }
+  current_probe = parent_;
+}
+
+} // namespace c10
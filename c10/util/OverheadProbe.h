@@ -0,0 +1,134 @@
+#pragma once
+
+#include <c10/macros/Macros.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Overhead probes.
+//
+// Timestamp counter probes at the host side stages of an eager op: Python
+// argument parsing, dispatch, the kernel, the TensorIterator build, the
+// allocator and the CUDA kernel launch. They attribute the per-op host
+// overhead to these stages, e.g. to tell which one a regression comes from
+// (see binaries/eager_overhead_benchmark.cc).
+//
+// The probes are only compiled in with -DUSE_OVERHEAD_PROBES=ON, and then
+// cost one relaxed load each until they are enabled at runtime with
+// setOverheadProbesEnabled. Enabled probes read the timestamp counter twice
+// and update global counters shared by all threads.
+//
+// Probes nest: a stage's self time excludes the time of the probes opened
+// inside it on the same thread, so that e.g. the self time of DISPATCH is
+// the dispatcher overhead without the kernel.
+
+namespace c10 {
+
+enum class OverheadStage : uint8_t {
+  PYTHON_ARG_PARSING = 0,
+  DISPATCH,
+  // The kernel called by the dispatcher, including the compute on CPU
+  KERNEL,
+  TENSOR_ITERATOR_BUILD,
+  ALLOCATOR,
+  KERNEL_LAUNCH,
+  NUM_STAGES // must be the last in the list
+};
+
+constexpr size_t kNumOverheadStages =
+    static_cast<size_t>(OverheadStage::NUM_STAGES);
+
+C10_API const char* overheadStageName(OverheadStage stage);
+
+struct OverheadStageStats {
+  // Number of probes of the stage that have ended
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  // total_ns minus the time of the probes nested in them
+  uint64_t self_ns = 0;
+};
+
+using OverheadStats = std::array<OverheadStageStats, kNumOverheadStages>;
+
+// Whether the probes were compiled in (C10_USE_OVERHEAD_PROBES)
+C10_API bool overheadProbesCompiled();
+
+// A no-op if the probes were not compiled in
+C10_API void setOverheadProbesEnabled(bool enabled);
+
+C10_API OverheadStats getOverheadStats();
+
+C10_API void resetOverheadStats();
+
+namespace detail {
+C10_API extern std::atomic<bool> overhead_probes_enabled;
+} // namespace detail
+
+inline bool overheadProbesEnabled() {
+  return detail::overhead_probes_enabled.load(std::memory_order_relaxed);
+}
+
+// Reads the timestamp counter, or a steady clock where there is none. The
+// ticks are converted to nanoseconds by getOverheadStats.
+inline uint64_t readOverheadTicks() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || \
+    defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__) && !defined(_MSC_VER)
+  uint64_t ticks;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+// Times its scope as one probe of stage, if the probes are enabled
+class C10_API OverheadProbe {
+ public:
+  explicit OverheadProbe(OverheadStage stage) {
+    if (C10_UNLIKELY(overheadProbesEnabled())) {
+      begin(stage);
+    }
+  }
+
+  ~OverheadProbe() {
+    if (C10_UNLIKELY(active_)) {
+      end();
+    }
+  }
+
+  OverheadProbe(const OverheadProbe&) = delete;
+  OverheadProbe& operator=(const OverheadProbe&) = delete;
+
+ private:
+  void begin(OverheadStage stage);
+  void end();
+
+  OverheadProbe* parent_ = nullptr;
+  uint64_t start_ticks_ = 0;
+  uint64_t children_ticks_ = 0;
+  OverheadStage stage_ = OverheadStage::NUM_STAGES;
+  bool active_ = false;
+};
+
+} // namespace c10
+
+#ifdef C10_USE_OVERHEAD_PROBES
+#define C10_OVERHEAD_PROBE(stage)                     \
+  ::c10::OverheadProbe C10_ANONYMOUS_VARIABLE(probe_)( \
+      ::c10::OverheadStage::stage)
+#else
+#define C10_OVERHEAD_PROBE(stage)
+#endif
@@ -103,6 +103,31 @@ int GetCurrentNUMANode() {
   return n;
 }
 
+void NUMAPinCurrentThread(int numa_node_id) {
+  if (numa_node_id < 0) {
+    return;
+  }
+  if (!IsNUMAEnabled()) {
+    return;
+  }
+
+  TORCH_CHECK(
+      numa_run_on_node(numa_node_id) == 0,
+      "Could not run on NUMA node ",
+      numa_node_id,
+      ", errno:",
+      errno);
+}
+
+int GetNUMANodeForThread(size_t index, size_t num_threads) {
+  if (!IsNUMAEnabled() || num_threads == 0) {
+    return -1;
+  }
+
+  size_t num_nodes = numa_num_configured_nodes();
+  return static_cast<int>(index * num_nodes / num_threads);
+}
+
 #else // C10_ENABLE_NUMA
 
 bool IsNUMAEnabled() {
@@ -127,6 +152,13 @@ int GetCurrentNUMANode() {
   return -1;
 }
 
+void NUMAPinCurrentThread(int numa_node_id) {
+}
+
+int GetNUMANodeForThread(size_t index, size_t num_threads) {
+  return -1;
+}
+
 #endif // C10_NUMA_ENABLED
 
 } // namespace c10
@@ -37,4 +37,18 @@ C10_API void NUMAMove(void* ptr, size_t size, int numa_node_id);
  */
 C10_API int GetCurrentNUMANode();
 
+/**
+ * Run the current thread on the CPUs of a given NUMA node. Unlike NUMABind,
+ * the memory it allocates isn't bound, its pages are placed on the node of
+ * the thread touching them first
+ */
+C10_API void NUMAPinCurrentThread(int numa_node_id);
+
+/**
+ * Get the NUMA node of the `index`-th of `num_threads` threads spread evenly
+ * over the NUMA nodes, consecutive threads sharing a node, or -1 if NUMA is
+ * disabled
+ */
+C10_API int GetNUMANodeForThread(size_t index, size_t num_threads);
+
 } // namespace c10
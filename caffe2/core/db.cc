@@ -173,6 +173,96 @@ class MiniDB : public DB {
 REGISTER_CAFFE2_DB(MiniDB, MiniDB);
 REGISTER_CAFFE2_DB(minidb, MiniDB);
 
+void DBReader::StartReadahead(int num_records) {
+  CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
+  CAFFE_ENFORCE_GT(num_records, 0, "Readahead needs at least one record.");
+  {
+    std::lock_guard<std::mutex> mutex_lock(reader_mutex_);
+    readahead_ = num_records;
+    if (readahead_thread_) {
+      // Already running, the new depth takes effect from the next record.
+      // Restarting would drop the records it has queued.
+      readahead_cv_.notify_all();
+      return;
+    }
+  }
+  stop_readahead_ = false;
+  readahead_error_ = nullptr;
+  readahead_thread_.reset(new std::thread([this]() { ReadaheadLoop(); }));
+}
+
+void DBReader::StopReadahead() {
+  if (!readahead_thread_) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> mutex_lock(reader_mutex_);
+    stop_readahead_ = true;
+    readahead_cv_.notify_all();
+  }
+  readahead_thread_->join();
+  readahead_thread_.reset();
+  readahead_queue_.clear();
+}
+
+void DBReader::ReadaheadLoop() const {
+  try {
+    while (true) {
+      {
+        std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+        readahead_cv_.wait(mutex_lock, [this]() {
+          return stop_readahead_ || readahead_queue_.size() < readahead_;
+        });
+        if (stop_readahead_) {
+          return;
+        }
+      }
+      // Hold the cursor from the read until the record is queued, so that a
+      // concurrent SeekToFirst() cannot slip in between and leave a record
+      // from the old position behind.
+      std::lock_guard<std::mutex> cursor_lock(cursor_mutex_);
+      std::pair<string, string> record;
+      ReadAndAdvance(&record.first, &record.second);
+      std::lock_guard<std::mutex> mutex_lock(reader_mutex_);
+      readahead_queue_.push_back(std::move(record));
+      readahead_cv_.notify_all();
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> mutex_lock(reader_mutex_);
+    readahead_error_ = std::current_exception();
+    readahead_cv_.notify_all();
+  }
+}
+
+void DBReader::PopReadahead(
+    std::unique_lock<std::mutex>& mutex_lock,
+    string* key,
+    string* value) const {
+  readahead_cv_.wait(mutex_lock, [this]() {
+    return !readahead_queue_.empty() || readahead_error_;
+  });
+  if (readahead_queue_.empty()) {
+    // The readahead thread failed, surface its error to the consumer.
+    std::rethrow_exception(readahead_error_);
+  }
+  auto& record = readahead_queue_.front();
+  key->swap(record.first);
+  value->swap(record.second);
+  readahead_queue_.pop_front();
+  readahead_cv_.notify_all();
+}
+
+bool DBReader::NextKey(string* key) const {
+  if (!cursor_ || !cursor_->SupportsSeek()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> cursor_lock(cursor_mutex_);
+  std::lock_guard<std::mutex> mutex_lock(reader_mutex_);
+  *key = readahead_queue_.empty() ? cursor_->key()
+                                  : readahead_queue_.front().first;
+  return true;
+}
+
 void DBReaderSerializer::Serialize(
     const void* pointer,
     TypeMeta typeMeta,
@@ -184,8 +274,9 @@ void DBReaderSerializer::Serialize(
   proto.set_name(name);
   proto.set_source(reader.source_);
   proto.set_db_type(reader.db_type_);
-  if (reader.cursor() && reader.cursor()->SupportsSeek()) {
-    proto.set_key(reader.cursor()->key());
+  string key;
+  if (reader.NextKey(&key)) {
+    proto.set_key(key);
   }
   BlobProto blob_proto;
   blob_proto.set_name(name);
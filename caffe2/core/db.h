@@ -1,7 +1,12 @@
 #ifndef CAFFE2_CORE_DB_H_
 #define CAFFE2_CORE_DB_H_
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <mutex>
+#include <thread>
+#include <utility>
 
 #include "c10/util/Registry.h"
 #include "caffe2/core/blob_serialization.h"
@@ -147,6 +152,9 @@ class TORCH_API DBReader {
  public:
   friend class DBReaderSerializer;
   DBReader() {}
+  ~DBReader() {
+    StopReadahead();
+  }
 
   DBReader(
       const string& db_type,
@@ -182,6 +190,7 @@ class TORCH_API DBReader {
       const string& source,
       const int32_t num_shards = 1,
       const int32_t shard_id = 0) {
+    StopReadahead();
     // Note(jiayq): resetting is needed when we re-open e.g. leveldb where no
     // concurrent access is allowed.
     cursor_.reset();
@@ -197,19 +206,38 @@ class TORCH_API DBReader {
         source_,
         ")");
     InitializeCursor(num_shards, shard_id);
+    if (readahead_ > 0) {
+      StartReadahead(readahead_);
+    }
   }
 
   void Open(
       unique_ptr<DB>&& db,
       const int32_t num_shards = 1,
       const int32_t shard_id = 0) {
+    StopReadahead();
     cursor_.reset();
     db_.reset();
     db_ = std::move(db);
     CAFFE_ENFORCE(db_.get(), "Passed null db");
     InitializeCursor(num_shards, shard_id);
+    if (readahead_ > 0) {
+      StartReadahead(readahead_);
+    }
   }
 
+  /**
+   * Starts a background thread that keeps up to num_records records read
+   * ahead of the callers of Read() and ReadBatch(), so that the latency of
+   * the db (e.g. on a network filesystem) overlaps with the work of the
+   * consumers. The records are handed out in the same order, sharding
+   * included, as without readahead. The setting is kept across Open().
+   *
+   * While readahead is running, the cursor is ahead of the records handed
+   * out so far and should not be used directly.
+   */
+  void StartReadahead(int num_records);
+
  public:
   /**
    * Read a set of key and value from the db and move to next. Thread safe.
@@ -230,15 +258,34 @@ class TORCH_API DBReader {
   void Read(string* key, string* value) const {
     CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
     std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
-    *key = cursor_->key();
-    *value = cursor_->value();
+    if (readahead_thread_) {
+      PopReadahead(mutex_lock, key, value);
+    } else {
+      ReadAndAdvance(key, value);
+    }
+  }
 
-    // In sharded mode, each read skips num_shards_ records
-    for (uint32_t s = 0; s < num_shards_; s++) {
-      cursor_->Next();
-      if (!cursor_->Valid()) {
-        MoveToBeginning();
-        break;
+  /**
+   * Read batch_size consecutive sets of key and value from the db under a
+   * single acquisition of the reader lock. Thread safe.
+   *
+   * The vectors are resized to batch_size and filled in read order. Wraps
+   * around at the end of the db in the same way as Read().
+   */
+  void ReadBatch(
+      int batch_size,
+      std::vector<string>* keys,
+      std::vector<string>* values) const {
+    CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
+    CAFFE_ENFORCE_GE(batch_size, 0);
+    keys->resize(batch_size);
+    values->resize(batch_size);
+    std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    for (int i = 0; i < batch_size; ++i) {
+      if (readahead_thread_) {
+        PopReadahead(mutex_lock, &(*keys)[i], &(*values)[i]);
+      } else {
+        ReadAndAdvance(&(*keys)[i], &(*values)[i]);
       }
     }
   }
@@ -248,8 +295,12 @@ class TORCH_API DBReader {
    */
   void SeekToFirst() const {
     CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
+    std::lock_guard<std::mutex> cursor_lock(cursor_mutex_);
     std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    // Drop whatever was read ahead from the old position
+    readahead_queue_.clear();
     MoveToBeginning();
+    readahead_cv_.notify_all();
   }
 
   /**
@@ -276,6 +327,34 @@ class TORCH_API DBReader {
     SeekToFirst();
   }
 
+  void StopReadahead();
+  void ReadaheadLoop() const;
+  // Waits for the readahead thread if needed and hands out the oldest record
+  // it has read. Must be called with mutex_lock holding reader_mutex_.
+  void PopReadahead(
+      std::unique_lock<std::mutex>& mutex_lock,
+      string* key,
+      string* value) const;
+  // The key of the record the next Read() returns, for serialization.
+  // Returns false if the db does not support seeking to it.
+  bool NextKey(string* key) const;
+
+  // Must be called with reader_mutex_ held, or with cursor_mutex_ held while
+  // the readahead thread is running.
+  void ReadAndAdvance(string* key, string* value) const {
+    *key = cursor_->key();
+    *value = cursor_->value();
+
+    // In sharded mode, each read skips num_shards_ records
+    for (uint32_t s = 0; s < num_shards_; s++) {
+      cursor_->Next();
+      if (!cursor_->Valid()) {
+        MoveToBeginning();
+        break;
+      }
+    }
+  }
+
   void MoveToBeginning() const {
     cursor_->SeekToFirst();
     for (uint32_t s = 0; s < shard_id_; s++) {
@@ -293,6 +372,17 @@ class TORCH_API DBReader {
   uint32_t num_shards_{};
   uint32_t shard_id_{};
 
+  // Readahead state. The readahead thread owns the cursor and holds
+  // cursor_mutex_ while it moves it; reader_mutex_ guards the queue. When both
+  // are needed, cursor_mutex_ is taken first.
+  mutable std::mutex cursor_mutex_;
+  mutable std::condition_variable readahead_cv_;
+  mutable std::deque<std::pair<string, string>> readahead_queue_;
+  mutable std::exception_ptr readahead_error_;
+  std::unique_ptr<std::thread> readahead_thread_;
+  size_t readahead_{0};
+  bool stop_readahead_{false};
+
   C10_DISABLE_COPY_AND_ASSIGN(DBReader);
 };
 
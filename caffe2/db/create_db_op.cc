@@ -3,7 +3,13 @@
 namespace caffe2 {
 REGISTER_CPU_OPERATOR(CreateDB, CreateDBOp<CPUContext>);
 
-OPERATOR_SCHEMA(CreateDB).NumInputs(0).NumOutputs(1);
+OPERATOR_SCHEMA(CreateDB)
+    .NumInputs(0)
+    .NumOutputs(1)
+    .Arg(
+        "readahead",
+        "(*int*): if positive, the reader keeps this many records read ahead "
+        "on a background thread.");
 
 NO_GRADIENT(CreateDB);
 }  // namespace caffe2
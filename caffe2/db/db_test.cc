@@ -200,5 +200,39 @@ TEST(DBReaderShardedTest, Reader) {
   EXPECT_EQ(value, "05");
 }
 
+TEST(DBReaderReadaheadTest, Reader) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+  std::unique_ptr<DBReader> reader(new DBReader("leveldb", name, 3, 1));
+  reader->StartReadahead(2);
+  string key;
+  string value;
+  // Readahead hands out the same sharded sequence, wrapping around.
+  for (const char* expected : {"01", "04", "07", "01", "04"}) {
+    reader->Read(&key, &value);
+    EXPECT_EQ(key, expected);
+    EXPECT_EQ(value, expected);
+  }
+  vector<string> keys;
+  vector<string> values;
+  reader->ReadBatch(3, &keys, &values);
+  EXPECT_EQ(keys, (vector<string>{"07", "01", "04"}));
+  EXPECT_EQ(values, keys);
+
+  // Seeking drops the records that were read ahead.
+  reader->SeekToFirst();
+  reader->Read(&key, &value);
+  EXPECT_EQ(key, "01");
+
+  // The serialized key is the next record to hand out, not the cursor's.
+  Blob reader_blob;
+  reader_blob.Reset(reader.release());
+  BlobProto blob_proto;
+  CHECK(blob_proto.ParseFromString(SerializeBlob(reader_blob, "reader")));
+  DBReaderProto proto;
+  CHECK(proto.ParseFromString(blob_proto.content()));
+  EXPECT_EQ(proto.key(), "04");
+}
+
 } // namespace db
 } // namespace caffe2
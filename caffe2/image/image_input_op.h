@@ -5,11 +5,14 @@
 #include <opencv2/opencv.hpp>
 
 #include <algorithm>
+#include <functional>
 #include <iostream>
 
 #include "c10/core/thread_pool.h"
 #include "caffe2/core/common.h"
 #include "caffe2/core/db.h"
+#include "caffe2/core/stats.h"
+#include "caffe2/core/timer.h"
 #include "caffe2/image/transform_gpu.h"
 #include "caffe2/operators/prefetch_op.h"
 #include "caffe2/proto/caffe2_legacy.pb.h"
@@ -98,6 +101,10 @@ class ImageInputOp final : public PrefetchOperator<Context> {
 
   unique_ptr<db::DBReader> owned_reader_;
   const db::DBReader* reader_;
+  // The records of the batch being prefetched, read from reader_ in one go.
+  // The decode tasks reference them in place instead of copying each value.
+  std::vector<std::string> batch_keys_;
+  std::vector<std::string> batch_values_;
   Tensor prefetched_image_;
   Tensor prefetched_label_;
   vector<Tensor> prefetched_additional_outputs_;
@@ -158,6 +165,16 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   std::atomic<long> num_decode_errors_in_batch_{0};
   // opencv exceptions tolerance
   float max_decode_error_ratio_;
+
+  // images_decoded counts the images that went through the decode pool, so
+  // its rate is the images/s of this op as seen by the stats exporter.
+  struct ImageInputOpStats {
+    CAFFE_STAT_CTOR(ImageInputOpStats);
+    CAFFE_EXPORTED_STAT(images_decoded);
+    CAFFE_EXPORTED_STAT(decode_errors);
+    CAFFE_AVG_EXPORTED_STAT(read_time_ns);
+    CAFFE_AVG_EXPORTED_STAT(decode_time_ns);
+  } stats_;
 };
 
 template <class Context>
@@ -218,7 +235,8 @@ ImageInputOp<Context>::ImageInputOp(
           {-1, -1})),
       max_decode_error_ratio_(OperatorBase::template GetSingleArgument<float>(
           "max_decode_error_ratio",
-          1.0)) {
+          1.0)),
+      stats_(std::string("image_input/stats/") + operator_def.output(0)) {
   if ((random_scale_[0] == -1) || (random_scale_[1] == -1)) {
     random_scaling_ = false;
   } else {
@@ -820,14 +838,8 @@ void Brightness(
     std::mt19937* randgen) {
   float alpha = 1.0f +
       std::uniform_real_distribution<float>(-alpha_rand, alpha_rand)(*randgen);
-  int p = 0;
-  for (int h = 0; h < img_size; ++h) {
-    for (int w = 0; w < img_size; ++w) {
-      for (int c = 0; c < 3; ++c) {
-        img[p++] *= alpha;
-      }
-    }
-  }
+  cv::Mat img_mat(img_size, img_size, CV_32FC3, img);
+  img_mat *= alpha;
 }
 
 // assume HWC order and color channels BGR
@@ -932,15 +944,11 @@ void ColorNormalization(
     const int channels,
     const std::vector<float>& mean,
     const std::vector<float>& std) {
-  int p = 0;
-  for (int h = 0; h < img_size; ++h) {
-    for (int w = 0; w < img_size; ++w) {
-      for (int c = 0; c < channels; ++c) {
-        img[p] = (img[p] - mean[c]) * std[c];
-        p++;
-      }
-    }
-  }
+  // std holds the inverse of the std. dev, see the constructor. The opencv
+  // arithmetic is vectorized across the interleaved channels.
+  cv::Mat img_mat(img_size, img_size, CV_32FC(channels), img);
+  cv::subtract(img_mat, cv::Scalar(mean[0], mean[1], mean[2]), img_mat);
+  cv::multiply(img_mat, cv::Scalar(std[0], std[1], std[2]), img_mat);
 }
 
 // Factored out image transformation
@@ -981,28 +989,18 @@ void TransformImage(
         std::uniform_int_distribution<>(0, scaled_img.rows - crop)(*randgen);
   }
 
-  float* image_data_ptr = image_data;
+  // Crop, mirror and convert with opencv, writing straight into image_data
+  const cv::Mat cropped =
+      scaled_img(cv::Rect(width_offset, height_offset, crop, crop));
+  cv::Mat image_mat(crop, crop, CV_32FC(channels), image_data);
   if (!is_test && mirror && (*mirror_this_image)(*randgen)) {
-    // Copy mirrored image.
-    for (int h = height_offset; h < height_offset + crop; ++h) {
-      for (int w = width_offset + crop - 1; w >= width_offset; --w) {
-        const uint8_t* cv_data = scaled_img.ptr(h) + w * channels;
-        for (int c = 0; c < channels; ++c) {
-          *(image_data_ptr++) = static_cast<float>(cv_data[c]);
-        }
-      }
-    }
+    cv::Mat mirrored;
+    cv::flip(cropped, mirrored, 1);
+    mirrored.convertTo(image_mat, CV_32F);
   } else {
-    // Copy normally.
-    for (int h = height_offset; h < height_offset + crop; ++h) {
-      for (int w = width_offset; w < width_offset + crop; ++w) {
-        const uint8_t* cv_data = scaled_img.ptr(h) + w * channels;
-        for (int c = 0; c < channels; ++c) {
-          *(image_data_ptr++) = static_cast<float>(cv_data[c]);
-        }
-      }
-    }
+    cropped.convertTo(image_mat, CV_32F);
   }
+  DCHECK_EQ(image_mat.data, reinterpret_cast<uchar*>(image_data));
 
   if (color_jitter && channels == 3 && !is_test) {
     ColorJitter<Context>(
@@ -1052,27 +1050,15 @@ void CropTransposeImage(
         std::uniform_int_distribution<>(0, scaled_img.rows - crop)(*randgen);
   }
 
+  const cv::Mat cropped =
+      scaled_img(cv::Rect(width_offset, height_offset, crop, crop));
+  cv::Mat cropped_mat(crop, crop, CV_8UC(channels), cropped_data);
   if (mirror && (*mirror_this_image)(*randgen)) {
-    // Copy mirrored image.
-    for (int h = height_offset; h < height_offset + crop; ++h) {
-      for (int w = width_offset + crop - 1; w >= width_offset; --w) {
-        const uint8_t* cv_data = scaled_img.ptr(h) + w * channels;
-        for (int c = 0; c < channels; ++c) {
-          *(cropped_data++) = cv_data[c];
-        }
-      }
-    }
+    cv::flip(cropped, cropped_mat, 1);
   } else {
-    // Copy normally.
-    for (int h = height_offset; h < height_offset + crop; ++h) {
-      for (int w = width_offset; w < width_offset + crop; ++w) {
-        const uint8_t* cv_data = scaled_img.ptr(h) + w * channels;
-        for (int c = 0; c < channels; ++c) {
-          *(cropped_data++) = cv_data[c];
-        }
-      }
-    }
+    cropped.copyTo(cropped_mat);
   }
+  DCHECK_EQ(cropped_mat.data, cropped_data);
 }
 
 // Parse datum, decode image, perform transform
@@ -1166,12 +1152,14 @@ bool ImageInputOp<Context>::Prefetch() {
   prefetched_label_.mutable_data<int>();
   // Prefetching handled with a thread pool of "decode_threads" threads.
 
-  for (int item_id = 0; item_id < batch_size_; ++item_id) {
-    std::string key, value;
-    cv::Mat img;
+  // read the whole batch under one acquisition of the reader lock
+  Timer timer;
+  reader_->ReadBatch(batch_size_, &batch_keys_, &batch_values_);
+  CAFFE_EVENT(stats_, read_time_ns, timer.NanoSeconds());
 
-    // read data
-    reader_->Read(&key, &value);
+  timer.Start();
+  for (int item_id = 0; item_id < batch_size_; ++item_id) {
+    const std::string& value = batch_values_[item_id];
 
     // determine label type based on first item
     if (item_id == 0) {
@@ -1225,7 +1213,7 @@ bool ImageInputOp<Context>::Prefetch() {
       thread_pool_->runTaskWithID(std::bind(
           &ImageInputOp<Context>::DecodeAndTransposeOnly,
           this,
-          std::string(value),
+          std::cref(value),
           image_data,
           item_id,
           channels,
@@ -1236,7 +1224,7 @@ bool ImageInputOp<Context>::Prefetch() {
       thread_pool_->runTaskWithID(std::bind(
           &ImageInputOp<Context>::DecodeAndTransform,
           this,
-          std::string(value),
+          std::cref(value),
           image_data,
           item_id,
           channels,
@@ -1244,6 +1232,9 @@ bool ImageInputOp<Context>::Prefetch() {
     }
   }
   thread_pool_->waitWorkComplete();
+  CAFFE_EVENT(stats_, decode_time_ns, timer.NanoSeconds());
+  CAFFE_EVENT(stats_, images_decoded, batch_size_);
+  CAFFE_EVENT(stats_, decode_errors, num_decode_errors_in_batch_);
 
   // we allow to get at most max_decode_error_ratio from
   // opencv imdecode until raising a runtime exception
@@ -45,6 +45,9 @@ In foo.cc, do:
      BASE_DO(foo, a, b);
    }
 
+On ARM, foo_neon.cc defines foo__neon under #if defined(__aarch64__), and foo()
+calls NEON_DO(foo, a, b) before BASE_DO.
+
 */
 // Details: this functionality basically covers the cases for both build time
 // and run time architecture support.
@@ -59,6 +62,10 @@ In foo.cc, do:
 //    and __AVX__.
 // During run time:
 //    we use cpuinfo to identify cpu support and run the proper functions.
+//
+// NEON is part of every AArch64 target, so the _neon.cc files are built along
+// the common files and CAFFE2_PERF_WITH_NEON follows the __aarch64__ flag of
+// the compiler.
 
 #pragma once
 
@@ -124,3 +131,19 @@ In foo.cc, do:
 #define AVX_DO(funcname, ...)
 #define AVX_F16C_DO(funcname, ...)
 #endif // CAFFE2_PERF_WITH_AVX
+
+#if defined(__aarch64__) && !defined(CAFFE2_PERF_WITH_NEON)
+#define CAFFE2_PERF_WITH_NEON
+#endif
+
+#ifdef CAFFE2_PERF_WITH_NEON
+#define NEON_DO(funcname, ...)                                               \
+  {                                                                          \
+    static const bool isDo = cpuinfo_initialize() && cpuinfo_has_arm_neon(); \
+    if (isDo) {                                                              \
+      return funcname##__neon(__VA_ARGS__);                                  \
+    }                                                                        \
+  }
+#else // CAFFE2_PERF_WITH_NEON
+#define NEON_DO(funcname, ...)
+#endif // CAFFE2_PERF_WITH_NEON
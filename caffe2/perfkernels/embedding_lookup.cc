@@ -105,6 +105,12 @@ static bool EmbeddingLookupGenericSlow(
   decltype(                                                                                        \
       EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL##__base)     \
       EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL##__avx2_fma; \
+  decltype(                                                                                        \
+      EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL##__base)     \
+      EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL##__avx512;   \
+  decltype(                                                                                        \
+      EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL##__base)     \
+      EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL##__neon;     \
   bool                                                                                             \
       EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL(             \
           const int64_t block_size,                                                                \
@@ -123,6 +129,19 @@ static bool EmbeddingLookupGenericSlow(
     } else {                                                                                       \
       CAFFE_ENFORCE(scale_bias == nullptr, "scale_bias must be nullptr");                          \
     }                                                                                              \
+    AVX512_DO(                                                                                     \
+        EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL,           \
+        block_size,                                                                                \
+        output_size,                                                                               \
+        index_size,                                                                                \
+        data_size,                                                                                 \
+        input,                                                                                     \
+        indices,                                                                                   \
+        lengths,                                                                                   \
+        weights,                                                                                   \
+        scale_bias,                                                                                \
+        normalize_by_lengths,                                                                      \
+        out);                                                                                      \
     AVX2_FMA_DO(                                                                                   \
         EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL,           \
         block_size,                                                                                \
@@ -136,6 +155,19 @@ static bool EmbeddingLookupGenericSlow(
         scale_bias,                                                                                \
         normalize_by_lengths,                                                                      \
         out);                                                                                      \
+    NEON_DO(                                                                                       \
+        EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL,           \
+        block_size,                                                                                \
+        output_size,                                                                               \
+        index_size,                                                                                \
+        data_size,                                                                                 \
+        input,                                                                                     \
+        indices,                                                                                   \
+        lengths,                                                                                   \
+        weights,                                                                                   \
+        scale_bias,                                                                                \
+        normalize_by_lengths,                                                                      \
+        out);                                                                                      \
     BASE_DO(                                                                                       \
         EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL,           \
         block_size,                                                                                \
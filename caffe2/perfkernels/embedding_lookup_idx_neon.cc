@@ -0,0 +1,2604 @@
+//// --------------------------
+//// ATTENTION:
+//// THIS CODE IS AUTOGENERATED
+//// BY hp_emblookup_codegen.py
+//// DO NOT MODIFY!!!
+//// --------------------------
+
+#if defined(__aarch64__)
+
+#include <c10/util/Half.h>
+#include <arm_neon.h>
+#include <cstring>
+
+namespace caffe2 {
+
+namespace {
+
+inline float32x4_t load_u8x4_f32(const uint8_t* ptr) {
+  // 4 bytes, which may not be aligned
+  uint32_t bytes;
+  std::memcpy(&bytes, ptr, sizeof(bytes));
+  return vcvtq_f32_u32(vmovl_u16(vget_low_u16(
+      vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(bytes))))));
+}
+
+} // namespace
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool EmbeddingLookupIdx_int32_t_float_float__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const float* input,
+    const int* indices,
+    const int* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  const int prefdist_T0 = 16;
+  const int fused_block_size = block_size + 0;
+  int64_t dataInd = 0;
+  if (block_size == 64) {
+    // unrolling 16 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      float32x4_t vop16 = vdupq_n_f32(0.0f);
+      float32x4_t vop20 = vdupq_n_f32(0.0f);
+      float32x4_t vop24 = vdupq_n_f32(0.0f);
+      float32x4_t vop28 = vdupq_n_f32(0.0f);
+      float32x4_t vop32 = vdupq_n_f32(0.0f);
+      float32x4_t vop36 = vdupq_n_f32(0.0f);
+      float32x4_t vop40 = vdupq_n_f32(0.0f);
+      float32x4_t vop44 = vdupq_n_f32(0.0f);
+      float32x4_t vop48 = vdupq_n_f32(0.0f);
+      float32x4_t vop52 = vdupq_n_f32(0.0f);
+      float32x4_t vop56 = vdupq_n_f32(0.0f);
+      float32x4_t vop60 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(vop0, vwgt, vld1q_f32(ip + (0)));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(vop4, vwgt, vld1q_f32(ip + (4)));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(vop8, vwgt, vld1q_f32(ip + (8)));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(vop12, vwgt, vld1q_f32(ip + (12)));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop16 = vfmaq_f32(vop16, vwgt, vld1q_f32(ip + (16)));
+        __builtin_prefetch(&ip_next_T0[16], 0, 3);
+        vop20 = vfmaq_f32(vop20, vwgt, vld1q_f32(ip + (20)));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop24 = vfmaq_f32(vop24, vwgt, vld1q_f32(ip + (24)));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop28 = vfmaq_f32(vop28, vwgt, vld1q_f32(ip + (28)));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+        vop32 = vfmaq_f32(vop32, vwgt, vld1q_f32(ip + (32)));
+        __builtin_prefetch(&ip_next_T0[32], 0, 3);
+        vop36 = vfmaq_f32(vop36, vwgt, vld1q_f32(ip + (36)));
+        // skip unnecessary prefetch of (&ip_next_T0[36])
+        vop40 = vfmaq_f32(vop40, vwgt, vld1q_f32(ip + (40)));
+        // skip unnecessary prefetch of (&ip_next_T0[40])
+        vop44 = vfmaq_f32(vop44, vwgt, vld1q_f32(ip + (44)));
+        // skip unnecessary prefetch of (&ip_next_T0[44])
+        vop48 = vfmaq_f32(vop48, vwgt, vld1q_f32(ip + (48)));
+        __builtin_prefetch(&ip_next_T0[48], 0, 3);
+        vop52 = vfmaq_f32(vop52, vwgt, vld1q_f32(ip + (52)));
+        // skip unnecessary prefetch of (&ip_next_T0[52])
+        vop56 = vfmaq_f32(vop56, vwgt, vld1q_f32(ip + (56)));
+        // skip unnecessary prefetch of (&ip_next_T0[56])
+        vop60 = vfmaq_f32(vop60, vwgt, vld1q_f32(ip + (60)));
+        // skip unnecessary prefetch of (&ip_next_T0[60])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+        vst1q_f32(&op[16], vop16);
+        vst1q_f32(&op[20], vop20);
+        vst1q_f32(&op[24], vop24);
+        vst1q_f32(&op[28], vop28);
+        vst1q_f32(&op[32], vop32);
+        vst1q_f32(&op[36], vop36);
+        vst1q_f32(&op[40], vop40);
+        vst1q_f32(&op[44], vop44);
+        vst1q_f32(&op[48], vop48);
+        vst1q_f32(&op[52], vop52);
+        vst1q_f32(&op[56], vop56);
+        vst1q_f32(&op[60], vop60);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+        vst1q_f32(&op[16], vmulq_f32(vop16, vlen_inv));
+        vst1q_f32(&op[20], vmulq_f32(vop20, vlen_inv));
+        vst1q_f32(&op[24], vmulq_f32(vop24, vlen_inv));
+        vst1q_f32(&op[28], vmulq_f32(vop28, vlen_inv));
+        vst1q_f32(&op[32], vmulq_f32(vop32, vlen_inv));
+        vst1q_f32(&op[36], vmulq_f32(vop36, vlen_inv));
+        vst1q_f32(&op[40], vmulq_f32(vop40, vlen_inv));
+        vst1q_f32(&op[44], vmulq_f32(vop44, vlen_inv));
+        vst1q_f32(&op[48], vmulq_f32(vop48, vlen_inv));
+        vst1q_f32(&op[52], vmulq_f32(vop52, vlen_inv));
+        vst1q_f32(&op[56], vmulq_f32(vop56, vlen_inv));
+        vst1q_f32(&op[60], vmulq_f32(vop60, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 8 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      float32x4_t vop16 = vdupq_n_f32(0.0f);
+      float32x4_t vop20 = vdupq_n_f32(0.0f);
+      float32x4_t vop24 = vdupq_n_f32(0.0f);
+      float32x4_t vop28 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(vop0, vwgt, vld1q_f32(ip + (0)));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(vop4, vwgt, vld1q_f32(ip + (4)));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(vop8, vwgt, vld1q_f32(ip + (8)));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(vop12, vwgt, vld1q_f32(ip + (12)));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop16 = vfmaq_f32(vop16, vwgt, vld1q_f32(ip + (16)));
+        __builtin_prefetch(&ip_next_T0[16], 0, 3);
+        vop20 = vfmaq_f32(vop20, vwgt, vld1q_f32(ip + (20)));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop24 = vfmaq_f32(vop24, vwgt, vld1q_f32(ip + (24)));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop28 = vfmaq_f32(vop28, vwgt, vld1q_f32(ip + (28)));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+        vst1q_f32(&op[16], vop16);
+        vst1q_f32(&op[20], vop20);
+        vst1q_f32(&op[24], vop24);
+        vst1q_f32(&op[28], vop28);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+        vst1q_f32(&op[16], vmulq_f32(vop16, vlen_inv));
+        vst1q_f32(&op[20], vmulq_f32(vop20, vlen_inv));
+        vst1q_f32(&op[24], vmulq_f32(vop24, vlen_inv));
+        vst1q_f32(&op[28], vmulq_f32(vop28, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 4 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(vop0, vwgt, vld1q_f32(ip + (0)));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(vop4, vwgt, vld1q_f32(ip + (4)));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(vop8, vwgt, vld1q_f32(ip + (8)));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(vop12, vwgt, vld1q_f32(ip + (12)));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 4 <= block_size; j += 4) {
+        vst1q_f32(op + j, vdupq_n_f32(0.0f));
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        j = 0;
+        for (; j + 4 <= block_size; j += 4) {
+          vst1q_f32(
+              &op[j], vfmaq_f32(vld1q_f32(&op[j]), vwgt, vld1q_f32(&ip[j])));
+          __builtin_prefetch(&ip_next_T0[j], 0, 3);
+        }
+        for (; j < block_size; j++) {
+          op[j] = std::fma(wgt, ip[j], op[j]);
+        }
+      }
+      if (normalize_by_lengths && length) {
+        float len_inv = 1.0f / length;
+        float32x4_t vlen_inv = vdupq_n_f32(len_inv);
+        j = 0;
+        for (; j + 4 <= block_size; j += 4) {
+          vst1q_f32(
+              &op[j], vmulq_f32(vld1q_f32(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool EmbeddingLookupIdx_int32_t_float_float_false__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const float* input,
+    const int* indices,
+    const int* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  return EmbeddingLookupIdx_int32_t_float_float__neon<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      offsets,
+      weights,
+      scale_bias,
+      normalize_by_lengths,
+      out);
+}
+bool EmbeddingLookupIdx_int32_t_float_float_true__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const float* input,
+    const int* indices,
+    const int* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  return EmbeddingLookupIdx_int32_t_float_float__neon<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      offsets,
+      weights,
+      scale_bias,
+      normalize_by_lengths,
+      out);
+}
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool EmbeddingLookupIdx_int64_t_float_float__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const float* input,
+    const int64_t* indices,
+    const int64_t* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  const int64_t prefdist_T0 = 16;
+  const int64_t fused_block_size = block_size + 0;
+  int64_t dataInd = 0;
+  if (block_size == 64) {
+    // unrolling 16 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      float32x4_t vop16 = vdupq_n_f32(0.0f);
+      float32x4_t vop20 = vdupq_n_f32(0.0f);
+      float32x4_t vop24 = vdupq_n_f32(0.0f);
+      float32x4_t vop28 = vdupq_n_f32(0.0f);
+      float32x4_t vop32 = vdupq_n_f32(0.0f);
+      float32x4_t vop36 = vdupq_n_f32(0.0f);
+      float32x4_t vop40 = vdupq_n_f32(0.0f);
+      float32x4_t vop44 = vdupq_n_f32(0.0f);
+      float32x4_t vop48 = vdupq_n_f32(0.0f);
+      float32x4_t vop52 = vdupq_n_f32(0.0f);
+      float32x4_t vop56 = vdupq_n_f32(0.0f);
+      float32x4_t vop60 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(vop0, vwgt, vld1q_f32(ip + (0)));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(vop4, vwgt, vld1q_f32(ip + (4)));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(vop8, vwgt, vld1q_f32(ip + (8)));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(vop12, vwgt, vld1q_f32(ip + (12)));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop16 = vfmaq_f32(vop16, vwgt, vld1q_f32(ip + (16)));
+        __builtin_prefetch(&ip_next_T0[16], 0, 3);
+        vop20 = vfmaq_f32(vop20, vwgt, vld1q_f32(ip + (20)));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop24 = vfmaq_f32(vop24, vwgt, vld1q_f32(ip + (24)));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop28 = vfmaq_f32(vop28, vwgt, vld1q_f32(ip + (28)));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+        vop32 = vfmaq_f32(vop32, vwgt, vld1q_f32(ip + (32)));
+        __builtin_prefetch(&ip_next_T0[32], 0, 3);
+        vop36 = vfmaq_f32(vop36, vwgt, vld1q_f32(ip + (36)));
+        // skip unnecessary prefetch of (&ip_next_T0[36])
+        vop40 = vfmaq_f32(vop40, vwgt, vld1q_f32(ip + (40)));
+        // skip unnecessary prefetch of (&ip_next_T0[40])
+        vop44 = vfmaq_f32(vop44, vwgt, vld1q_f32(ip + (44)));
+        // skip unnecessary prefetch of (&ip_next_T0[44])
+        vop48 = vfmaq_f32(vop48, vwgt, vld1q_f32(ip + (48)));
+        __builtin_prefetch(&ip_next_T0[48], 0, 3);
+        vop52 = vfmaq_f32(vop52, vwgt, vld1q_f32(ip + (52)));
+        // skip unnecessary prefetch of (&ip_next_T0[52])
+        vop56 = vfmaq_f32(vop56, vwgt, vld1q_f32(ip + (56)));
+        // skip unnecessary prefetch of (&ip_next_T0[56])
+        vop60 = vfmaq_f32(vop60, vwgt, vld1q_f32(ip + (60)));
+        // skip unnecessary prefetch of (&ip_next_T0[60])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+        vst1q_f32(&op[16], vop16);
+        vst1q_f32(&op[20], vop20);
+        vst1q_f32(&op[24], vop24);
+        vst1q_f32(&op[28], vop28);
+        vst1q_f32(&op[32], vop32);
+        vst1q_f32(&op[36], vop36);
+        vst1q_f32(&op[40], vop40);
+        vst1q_f32(&op[44], vop44);
+        vst1q_f32(&op[48], vop48);
+        vst1q_f32(&op[52], vop52);
+        vst1q_f32(&op[56], vop56);
+        vst1q_f32(&op[60], vop60);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+        vst1q_f32(&op[16], vmulq_f32(vop16, vlen_inv));
+        vst1q_f32(&op[20], vmulq_f32(vop20, vlen_inv));
+        vst1q_f32(&op[24], vmulq_f32(vop24, vlen_inv));
+        vst1q_f32(&op[28], vmulq_f32(vop28, vlen_inv));
+        vst1q_f32(&op[32], vmulq_f32(vop32, vlen_inv));
+        vst1q_f32(&op[36], vmulq_f32(vop36, vlen_inv));
+        vst1q_f32(&op[40], vmulq_f32(vop40, vlen_inv));
+        vst1q_f32(&op[44], vmulq_f32(vop44, vlen_inv));
+        vst1q_f32(&op[48], vmulq_f32(vop48, vlen_inv));
+        vst1q_f32(&op[52], vmulq_f32(vop52, vlen_inv));
+        vst1q_f32(&op[56], vmulq_f32(vop56, vlen_inv));
+        vst1q_f32(&op[60], vmulq_f32(vop60, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 8 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      float32x4_t vop16 = vdupq_n_f32(0.0f);
+      float32x4_t vop20 = vdupq_n_f32(0.0f);
+      float32x4_t vop24 = vdupq_n_f32(0.0f);
+      float32x4_t vop28 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(vop0, vwgt, vld1q_f32(ip + (0)));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(vop4, vwgt, vld1q_f32(ip + (4)));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(vop8, vwgt, vld1q_f32(ip + (8)));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(vop12, vwgt, vld1q_f32(ip + (12)));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop16 = vfmaq_f32(vop16, vwgt, vld1q_f32(ip + (16)));
+        __builtin_prefetch(&ip_next_T0[16], 0, 3);
+        vop20 = vfmaq_f32(vop20, vwgt, vld1q_f32(ip + (20)));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop24 = vfmaq_f32(vop24, vwgt, vld1q_f32(ip + (24)));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop28 = vfmaq_f32(vop28, vwgt, vld1q_f32(ip + (28)));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+        vst1q_f32(&op[16], vop16);
+        vst1q_f32(&op[20], vop20);
+        vst1q_f32(&op[24], vop24);
+        vst1q_f32(&op[28], vop28);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+        vst1q_f32(&op[16], vmulq_f32(vop16, vlen_inv));
+        vst1q_f32(&op[20], vmulq_f32(vop20, vlen_inv));
+        vst1q_f32(&op[24], vmulq_f32(vop24, vlen_inv));
+        vst1q_f32(&op[28], vmulq_f32(vop28, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 4 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(vop0, vwgt, vld1q_f32(ip + (0)));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(vop4, vwgt, vld1q_f32(ip + (4)));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(vop8, vwgt, vld1q_f32(ip + (8)));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(vop12, vwgt, vld1q_f32(ip + (12)));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 4 <= block_size; j += 4) {
+        vst1q_f32(op + j, vdupq_n_f32(0.0f));
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        j = 0;
+        for (; j + 4 <= block_size; j += 4) {
+          vst1q_f32(
+              &op[j], vfmaq_f32(vld1q_f32(&op[j]), vwgt, vld1q_f32(&ip[j])));
+          __builtin_prefetch(&ip_next_T0[j], 0, 3);
+        }
+        for (; j < block_size; j++) {
+          op[j] = std::fma(wgt, ip[j], op[j]);
+        }
+      }
+      if (normalize_by_lengths && length) {
+        float len_inv = 1.0f / length;
+        float32x4_t vlen_inv = vdupq_n_f32(len_inv);
+        j = 0;
+        for (; j + 4 <= block_size; j += 4) {
+          vst1q_f32(
+              &op[j], vmulq_f32(vld1q_f32(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool EmbeddingLookupIdx_int64_t_float_float_false__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const float* input,
+    const int64_t* indices,
+    const int64_t* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  return EmbeddingLookupIdx_int64_t_float_float__neon<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      offsets,
+      weights,
+      scale_bias,
+      normalize_by_lengths,
+      out);
+}
+bool EmbeddingLookupIdx_int64_t_float_float_true__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const float* input,
+    const int64_t* indices,
+    const int64_t* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  return EmbeddingLookupIdx_int64_t_float_float__neon<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      offsets,
+      weights,
+      scale_bias,
+      normalize_by_lengths,
+      out);
+}
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool EmbeddingLookupIdx_int32_t_half_float__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const at::Half* input,
+    const int* indices,
+    const int* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  const int prefdist_T0 = 16;
+  const int fused_block_size = block_size + 0;
+  int64_t dataInd = 0;
+  if (block_size == 64) {
+    // unrolling 16 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      float32x4_t vop16 = vdupq_n_f32(0.0f);
+      float32x4_t vop20 = vdupq_n_f32(0.0f);
+      float32x4_t vop24 = vdupq_n_f32(0.0f);
+      float32x4_t vop28 = vdupq_n_f32(0.0f);
+      float32x4_t vop32 = vdupq_n_f32(0.0f);
+      float32x4_t vop36 = vdupq_n_f32(0.0f);
+      float32x4_t vop40 = vdupq_n_f32(0.0f);
+      float32x4_t vop44 = vdupq_n_f32(0.0f);
+      float32x4_t vop48 = vdupq_n_f32(0.0f);
+      float32x4_t vop52 = vdupq_n_f32(0.0f);
+      float32x4_t vop56 = vdupq_n_f32(0.0f);
+      float32x4_t vop60 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(
+            vop0,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (0)))));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(
+            vop4,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (4)))));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(
+            vop8,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (8)))));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(
+            vop12,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (12)))));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop16 = vfmaq_f32(
+            vop16,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (16)))));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop20 = vfmaq_f32(
+            vop20,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (20)))));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop24 = vfmaq_f32(
+            vop24,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (24)))));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop28 = vfmaq_f32(
+            vop28,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (28)))));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+        vop32 = vfmaq_f32(
+            vop32,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (32)))));
+        __builtin_prefetch(&ip_next_T0[32], 0, 3);
+        vop36 = vfmaq_f32(
+            vop36,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (36)))));
+        // skip unnecessary prefetch of (&ip_next_T0[36])
+        vop40 = vfmaq_f32(
+            vop40,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (40)))));
+        // skip unnecessary prefetch of (&ip_next_T0[40])
+        vop44 = vfmaq_f32(
+            vop44,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (44)))));
+        // skip unnecessary prefetch of (&ip_next_T0[44])
+        vop48 = vfmaq_f32(
+            vop48,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (48)))));
+        // skip unnecessary prefetch of (&ip_next_T0[48])
+        vop52 = vfmaq_f32(
+            vop52,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (52)))));
+        // skip unnecessary prefetch of (&ip_next_T0[52])
+        vop56 = vfmaq_f32(
+            vop56,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (56)))));
+        // skip unnecessary prefetch of (&ip_next_T0[56])
+        vop60 = vfmaq_f32(
+            vop60,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (60)))));
+        // skip unnecessary prefetch of (&ip_next_T0[60])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+        vst1q_f32(&op[16], vop16);
+        vst1q_f32(&op[20], vop20);
+        vst1q_f32(&op[24], vop24);
+        vst1q_f32(&op[28], vop28);
+        vst1q_f32(&op[32], vop32);
+        vst1q_f32(&op[36], vop36);
+        vst1q_f32(&op[40], vop40);
+        vst1q_f32(&op[44], vop44);
+        vst1q_f32(&op[48], vop48);
+        vst1q_f32(&op[52], vop52);
+        vst1q_f32(&op[56], vop56);
+        vst1q_f32(&op[60], vop60);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+        vst1q_f32(&op[16], vmulq_f32(vop16, vlen_inv));
+        vst1q_f32(&op[20], vmulq_f32(vop20, vlen_inv));
+        vst1q_f32(&op[24], vmulq_f32(vop24, vlen_inv));
+        vst1q_f32(&op[28], vmulq_f32(vop28, vlen_inv));
+        vst1q_f32(&op[32], vmulq_f32(vop32, vlen_inv));
+        vst1q_f32(&op[36], vmulq_f32(vop36, vlen_inv));
+        vst1q_f32(&op[40], vmulq_f32(vop40, vlen_inv));
+        vst1q_f32(&op[44], vmulq_f32(vop44, vlen_inv));
+        vst1q_f32(&op[48], vmulq_f32(vop48, vlen_inv));
+        vst1q_f32(&op[52], vmulq_f32(vop52, vlen_inv));
+        vst1q_f32(&op[56], vmulq_f32(vop56, vlen_inv));
+        vst1q_f32(&op[60], vmulq_f32(vop60, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 8 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      float32x4_t vop16 = vdupq_n_f32(0.0f);
+      float32x4_t vop20 = vdupq_n_f32(0.0f);
+      float32x4_t vop24 = vdupq_n_f32(0.0f);
+      float32x4_t vop28 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(
+            vop0,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (0)))));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(
+            vop4,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (4)))));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(
+            vop8,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (8)))));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(
+            vop12,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (12)))));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop16 = vfmaq_f32(
+            vop16,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (16)))));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop20 = vfmaq_f32(
+            vop20,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (20)))));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop24 = vfmaq_f32(
+            vop24,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (24)))));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop28 = vfmaq_f32(
+            vop28,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (28)))));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+        vst1q_f32(&op[16], vop16);
+        vst1q_f32(&op[20], vop20);
+        vst1q_f32(&op[24], vop24);
+        vst1q_f32(&op[28], vop28);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+        vst1q_f32(&op[16], vmulq_f32(vop16, vlen_inv));
+        vst1q_f32(&op[20], vmulq_f32(vop20, vlen_inv));
+        vst1q_f32(&op[24], vmulq_f32(vop24, vlen_inv));
+        vst1q_f32(&op[28], vmulq_f32(vop28, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 4 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(
+            vop0,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (0)))));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(
+            vop4,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (4)))));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(
+            vop8,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (8)))));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(
+            vop12,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (12)))));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 4 <= block_size; j += 4) {
+        vst1q_f32(op + j, vdupq_n_f32(0.0f));
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        j = 0;
+        for (; j + 4 <= block_size; j += 4) {
+          vst1q_f32(
+              &op[j],
+              vfmaq_f32(
+                  vld1q_f32(&op[j]),
+                  vwgt,
+                  vcvt_f32_f16(
+                      vld1_f16(reinterpret_cast<const float16_t*>(&ip[j])))));
+          __builtin_prefetch(&ip_next_T0[j], 0, 3);
+        }
+        for (; j < block_size; j++) {
+          op[j] = std::fma(wgt, static_cast<float>(ip[j]), op[j]);
+        }
+      }
+      if (normalize_by_lengths && length) {
+        float len_inv = 1.0f / length;
+        float32x4_t vlen_inv = vdupq_n_f32(len_inv);
+        j = 0;
+        for (; j + 4 <= block_size; j += 4) {
+          vst1q_f32(
+              &op[j], vmulq_f32(vld1q_f32(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool EmbeddingLookupIdx_int32_t_half_float_false__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const at::Half* input,
+    const int* indices,
+    const int* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  return EmbeddingLookupIdx_int32_t_half_float__neon<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      offsets,
+      weights,
+      scale_bias,
+      normalize_by_lengths,
+      out);
+}
+bool EmbeddingLookupIdx_int32_t_half_float_true__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const at::Half* input,
+    const int* indices,
+    const int* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  return EmbeddingLookupIdx_int32_t_half_float__neon<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      offsets,
+      weights,
+      scale_bias,
+      normalize_by_lengths,
+      out);
+}
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool EmbeddingLookupIdx_int64_t_half_float__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const at::Half* input,
+    const int64_t* indices,
+    const int64_t* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  const int64_t prefdist_T0 = 16;
+  const int64_t fused_block_size = block_size + 0;
+  int64_t dataInd = 0;
+  if (block_size == 64) {
+    // unrolling 16 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      float32x4_t vop16 = vdupq_n_f32(0.0f);
+      float32x4_t vop20 = vdupq_n_f32(0.0f);
+      float32x4_t vop24 = vdupq_n_f32(0.0f);
+      float32x4_t vop28 = vdupq_n_f32(0.0f);
+      float32x4_t vop32 = vdupq_n_f32(0.0f);
+      float32x4_t vop36 = vdupq_n_f32(0.0f);
+      float32x4_t vop40 = vdupq_n_f32(0.0f);
+      float32x4_t vop44 = vdupq_n_f32(0.0f);
+      float32x4_t vop48 = vdupq_n_f32(0.0f);
+      float32x4_t vop52 = vdupq_n_f32(0.0f);
+      float32x4_t vop56 = vdupq_n_f32(0.0f);
+      float32x4_t vop60 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(
+            vop0,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (0)))));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(
+            vop4,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (4)))));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(
+            vop8,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (8)))));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(
+            vop12,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (12)))));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop16 = vfmaq_f32(
+            vop16,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (16)))));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop20 = vfmaq_f32(
+            vop20,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (20)))));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop24 = vfmaq_f32(
+            vop24,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (24)))));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop28 = vfmaq_f32(
+            vop28,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (28)))));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+        vop32 = vfmaq_f32(
+            vop32,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (32)))));
+        __builtin_prefetch(&ip_next_T0[32], 0, 3);
+        vop36 = vfmaq_f32(
+            vop36,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (36)))));
+        // skip unnecessary prefetch of (&ip_next_T0[36])
+        vop40 = vfmaq_f32(
+            vop40,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (40)))));
+        // skip unnecessary prefetch of (&ip_next_T0[40])
+        vop44 = vfmaq_f32(
+            vop44,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (44)))));
+        // skip unnecessary prefetch of (&ip_next_T0[44])
+        vop48 = vfmaq_f32(
+            vop48,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (48)))));
+        // skip unnecessary prefetch of (&ip_next_T0[48])
+        vop52 = vfmaq_f32(
+            vop52,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (52)))));
+        // skip unnecessary prefetch of (&ip_next_T0[52])
+        vop56 = vfmaq_f32(
+            vop56,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (56)))));
+        // skip unnecessary prefetch of (&ip_next_T0[56])
+        vop60 = vfmaq_f32(
+            vop60,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (60)))));
+        // skip unnecessary prefetch of (&ip_next_T0[60])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+        vst1q_f32(&op[16], vop16);
+        vst1q_f32(&op[20], vop20);
+        vst1q_f32(&op[24], vop24);
+        vst1q_f32(&op[28], vop28);
+        vst1q_f32(&op[32], vop32);
+        vst1q_f32(&op[36], vop36);
+        vst1q_f32(&op[40], vop40);
+        vst1q_f32(&op[44], vop44);
+        vst1q_f32(&op[48], vop48);
+        vst1q_f32(&op[52], vop52);
+        vst1q_f32(&op[56], vop56);
+        vst1q_f32(&op[60], vop60);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+        vst1q_f32(&op[16], vmulq_f32(vop16, vlen_inv));
+        vst1q_f32(&op[20], vmulq_f32(vop20, vlen_inv));
+        vst1q_f32(&op[24], vmulq_f32(vop24, vlen_inv));
+        vst1q_f32(&op[28], vmulq_f32(vop28, vlen_inv));
+        vst1q_f32(&op[32], vmulq_f32(vop32, vlen_inv));
+        vst1q_f32(&op[36], vmulq_f32(vop36, vlen_inv));
+        vst1q_f32(&op[40], vmulq_f32(vop40, vlen_inv));
+        vst1q_f32(&op[44], vmulq_f32(vop44, vlen_inv));
+        vst1q_f32(&op[48], vmulq_f32(vop48, vlen_inv));
+        vst1q_f32(&op[52], vmulq_f32(vop52, vlen_inv));
+        vst1q_f32(&op[56], vmulq_f32(vop56, vlen_inv));
+        vst1q_f32(&op[60], vmulq_f32(vop60, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 8 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      float32x4_t vop16 = vdupq_n_f32(0.0f);
+      float32x4_t vop20 = vdupq_n_f32(0.0f);
+      float32x4_t vop24 = vdupq_n_f32(0.0f);
+      float32x4_t vop28 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(
+            vop0,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (0)))));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(
+            vop4,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (4)))));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(
+            vop8,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (8)))));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(
+            vop12,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (12)))));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop16 = vfmaq_f32(
+            vop16,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (16)))));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop20 = vfmaq_f32(
+            vop20,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (20)))));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop24 = vfmaq_f32(
+            vop24,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (24)))));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop28 = vfmaq_f32(
+            vop28,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (28)))));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+        vst1q_f32(&op[16], vop16);
+        vst1q_f32(&op[20], vop20);
+        vst1q_f32(&op[24], vop24);
+        vst1q_f32(&op[28], vop28);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+        vst1q_f32(&op[16], vmulq_f32(vop16, vlen_inv));
+        vst1q_f32(&op[20], vmulq_f32(vop20, vlen_inv));
+        vst1q_f32(&op[24], vmulq_f32(vop24, vlen_inv));
+        vst1q_f32(&op[28], vmulq_f32(vop28, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 4 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(
+            vop0,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (0)))));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(
+            vop4,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (4)))));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(
+            vop8,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (8)))));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(
+            vop12,
+            vwgt,
+            vcvt_f32_f16(
+                vld1_f16(reinterpret_cast<const float16_t*>(ip + (12)))));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 4 <= block_size; j += 4) {
+        vst1q_f32(op + j, vdupq_n_f32(0.0f));
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        j = 0;
+        for (; j + 4 <= block_size; j += 4) {
+          vst1q_f32(
+              &op[j],
+              vfmaq_f32(
+                  vld1q_f32(&op[j]),
+                  vwgt,
+                  vcvt_f32_f16(
+                      vld1_f16(reinterpret_cast<const float16_t*>(&ip[j])))));
+          __builtin_prefetch(&ip_next_T0[j], 0, 3);
+        }
+        for (; j < block_size; j++) {
+          op[j] = std::fma(wgt, static_cast<float>(ip[j]), op[j]);
+        }
+      }
+      if (normalize_by_lengths && length) {
+        float len_inv = 1.0f / length;
+        float32x4_t vlen_inv = vdupq_n_f32(len_inv);
+        j = 0;
+        for (; j + 4 <= block_size; j += 4) {
+          vst1q_f32(
+              &op[j], vmulq_f32(vld1q_f32(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool EmbeddingLookupIdx_int64_t_half_float_false__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const at::Half* input,
+    const int64_t* indices,
+    const int64_t* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  return EmbeddingLookupIdx_int64_t_half_float__neon<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      offsets,
+      weights,
+      scale_bias,
+      normalize_by_lengths,
+      out);
+}
+bool EmbeddingLookupIdx_int64_t_half_float_true__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const at::Half* input,
+    const int64_t* indices,
+    const int64_t* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  return EmbeddingLookupIdx_int64_t_half_float__neon<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      offsets,
+      weights,
+      scale_bias,
+      normalize_by_lengths,
+      out);
+}
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool EmbeddingLookupIdx_int32_t_uint8_t_float__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int* indices,
+    const int* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  const int prefdist_T0 = 16;
+  const int fused_block_size = block_size + 0;
+  int64_t dataInd = 0;
+  if (block_size == 64) {
+    // unrolling 16 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      float32x4_t vop16 = vdupq_n_f32(0.0f);
+      float32x4_t vop20 = vdupq_n_f32(0.0f);
+      float32x4_t vop24 = vdupq_n_f32(0.0f);
+      float32x4_t vop28 = vdupq_n_f32(0.0f);
+      float32x4_t vop32 = vdupq_n_f32(0.0f);
+      float32x4_t vop36 = vdupq_n_f32(0.0f);
+      float32x4_t vop40 = vdupq_n_f32(0.0f);
+      float32x4_t vop44 = vdupq_n_f32(0.0f);
+      float32x4_t vop48 = vdupq_n_f32(0.0f);
+      float32x4_t vop52 = vdupq_n_f32(0.0f);
+      float32x4_t vop56 = vdupq_n_f32(0.0f);
+      float32x4_t vop60 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        bio = wgt * scale_bias[2 * idx + 1];
+        wgt = wgt * scale_bias[2 * idx];
+        float32x4_t vbio = vdupq_n_f32(bio);
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(
+            vaddq_f32(vop0, vbio), vwgt, load_u8x4_f32(ip + (0)));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(
+            vaddq_f32(vop4, vbio), vwgt, load_u8x4_f32(ip + (4)));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(
+            vaddq_f32(vop8, vbio), vwgt, load_u8x4_f32(ip + (8)));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(
+            vaddq_f32(vop12, vbio), vwgt, load_u8x4_f32(ip + (12)));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop16 = vfmaq_f32(
+            vaddq_f32(vop16, vbio), vwgt, load_u8x4_f32(ip + (16)));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop20 = vfmaq_f32(
+            vaddq_f32(vop20, vbio), vwgt, load_u8x4_f32(ip + (20)));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop24 = vfmaq_f32(
+            vaddq_f32(vop24, vbio), vwgt, load_u8x4_f32(ip + (24)));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop28 = vfmaq_f32(
+            vaddq_f32(vop28, vbio), vwgt, load_u8x4_f32(ip + (28)));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+        vop32 = vfmaq_f32(
+            vaddq_f32(vop32, vbio), vwgt, load_u8x4_f32(ip + (32)));
+        // skip unnecessary prefetch of (&ip_next_T0[32])
+        vop36 = vfmaq_f32(
+            vaddq_f32(vop36, vbio), vwgt, load_u8x4_f32(ip + (36)));
+        // skip unnecessary prefetch of (&ip_next_T0[36])
+        vop40 = vfmaq_f32(
+            vaddq_f32(vop40, vbio), vwgt, load_u8x4_f32(ip + (40)));
+        // skip unnecessary prefetch of (&ip_next_T0[40])
+        vop44 = vfmaq_f32(
+            vaddq_f32(vop44, vbio), vwgt, load_u8x4_f32(ip + (44)));
+        // skip unnecessary prefetch of (&ip_next_T0[44])
+        vop48 = vfmaq_f32(
+            vaddq_f32(vop48, vbio), vwgt, load_u8x4_f32(ip + (48)));
+        // skip unnecessary prefetch of (&ip_next_T0[48])
+        vop52 = vfmaq_f32(
+            vaddq_f32(vop52, vbio), vwgt, load_u8x4_f32(ip + (52)));
+        // skip unnecessary prefetch of (&ip_next_T0[52])
+        vop56 = vfmaq_f32(
+            vaddq_f32(vop56, vbio), vwgt, load_u8x4_f32(ip + (56)));
+        // skip unnecessary prefetch of (&ip_next_T0[56])
+        vop60 = vfmaq_f32(
+            vaddq_f32(vop60, vbio), vwgt, load_u8x4_f32(ip + (60)));
+        // skip unnecessary prefetch of (&ip_next_T0[60])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+        vst1q_f32(&op[16], vop16);
+        vst1q_f32(&op[20], vop20);
+        vst1q_f32(&op[24], vop24);
+        vst1q_f32(&op[28], vop28);
+        vst1q_f32(&op[32], vop32);
+        vst1q_f32(&op[36], vop36);
+        vst1q_f32(&op[40], vop40);
+        vst1q_f32(&op[44], vop44);
+        vst1q_f32(&op[48], vop48);
+        vst1q_f32(&op[52], vop52);
+        vst1q_f32(&op[56], vop56);
+        vst1q_f32(&op[60], vop60);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+        vst1q_f32(&op[16], vmulq_f32(vop16, vlen_inv));
+        vst1q_f32(&op[20], vmulq_f32(vop20, vlen_inv));
+        vst1q_f32(&op[24], vmulq_f32(vop24, vlen_inv));
+        vst1q_f32(&op[28], vmulq_f32(vop28, vlen_inv));
+        vst1q_f32(&op[32], vmulq_f32(vop32, vlen_inv));
+        vst1q_f32(&op[36], vmulq_f32(vop36, vlen_inv));
+        vst1q_f32(&op[40], vmulq_f32(vop40, vlen_inv));
+        vst1q_f32(&op[44], vmulq_f32(vop44, vlen_inv));
+        vst1q_f32(&op[48], vmulq_f32(vop48, vlen_inv));
+        vst1q_f32(&op[52], vmulq_f32(vop52, vlen_inv));
+        vst1q_f32(&op[56], vmulq_f32(vop56, vlen_inv));
+        vst1q_f32(&op[60], vmulq_f32(vop60, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 8 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      float32x4_t vop16 = vdupq_n_f32(0.0f);
+      float32x4_t vop20 = vdupq_n_f32(0.0f);
+      float32x4_t vop24 = vdupq_n_f32(0.0f);
+      float32x4_t vop28 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        bio = wgt * scale_bias[2 * idx + 1];
+        wgt = wgt * scale_bias[2 * idx];
+        float32x4_t vbio = vdupq_n_f32(bio);
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(
+            vaddq_f32(vop0, vbio), vwgt, load_u8x4_f32(ip + (0)));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(
+            vaddq_f32(vop4, vbio), vwgt, load_u8x4_f32(ip + (4)));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(
+            vaddq_f32(vop8, vbio), vwgt, load_u8x4_f32(ip + (8)));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(
+            vaddq_f32(vop12, vbio), vwgt, load_u8x4_f32(ip + (12)));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop16 = vfmaq_f32(
+            vaddq_f32(vop16, vbio), vwgt, load_u8x4_f32(ip + (16)));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop20 = vfmaq_f32(
+            vaddq_f32(vop20, vbio), vwgt, load_u8x4_f32(ip + (20)));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop24 = vfmaq_f32(
+            vaddq_f32(vop24, vbio), vwgt, load_u8x4_f32(ip + (24)));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop28 = vfmaq_f32(
+            vaddq_f32(vop28, vbio), vwgt, load_u8x4_f32(ip + (28)));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+        vst1q_f32(&op[16], vop16);
+        vst1q_f32(&op[20], vop20);
+        vst1q_f32(&op[24], vop24);
+        vst1q_f32(&op[28], vop28);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+        vst1q_f32(&op[16], vmulq_f32(vop16, vlen_inv));
+        vst1q_f32(&op[20], vmulq_f32(vop20, vlen_inv));
+        vst1q_f32(&op[24], vmulq_f32(vop24, vlen_inv));
+        vst1q_f32(&op[28], vmulq_f32(vop28, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 4 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        bio = wgt * scale_bias[2 * idx + 1];
+        wgt = wgt * scale_bias[2 * idx];
+        float32x4_t vbio = vdupq_n_f32(bio);
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(
+            vaddq_f32(vop0, vbio), vwgt, load_u8x4_f32(ip + (0)));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(
+            vaddq_f32(vop4, vbio), vwgt, load_u8x4_f32(ip + (4)));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(
+            vaddq_f32(vop8, vbio), vwgt, load_u8x4_f32(ip + (8)));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(
+            vaddq_f32(vop12, vbio), vwgt, load_u8x4_f32(ip + (12)));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 4 <= block_size; j += 4) {
+        vst1q_f32(op + j, vdupq_n_f32(0.0f));
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        bio = wgt * scale_bias[2 * idx + 1];
+        wgt = wgt * scale_bias[2 * idx];
+        float32x4_t vbio = vdupq_n_f32(bio);
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        j = 0;
+        for (; j + 4 <= block_size; j += 4) {
+          vst1q_f32(
+              &op[j],
+              vfmaq_f32(
+                  vaddq_f32(vld1q_f32(&op[j]), vbio),
+                  vwgt,
+                  load_u8x4_f32(&ip[j])));
+          __builtin_prefetch(&ip_next_T0[j], 0, 3);
+        }
+        for (; j < block_size; j++) {
+          op[j] = std::fma(wgt, (float)ip[j], bio + op[j]);
+        }
+      }
+      if (normalize_by_lengths && length) {
+        float len_inv = 1.0f / length;
+        float32x4_t vlen_inv = vdupq_n_f32(len_inv);
+        j = 0;
+        for (; j + 4 <= block_size; j += 4) {
+          vst1q_f32(
+              &op[j], vmulq_f32(vld1q_f32(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool EmbeddingLookupIdx_int32_t_uint8_t_float_false__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int* indices,
+    const int* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  return EmbeddingLookupIdx_int32_t_uint8_t_float__neon<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      offsets,
+      weights,
+      scale_bias,
+      normalize_by_lengths,
+      out);
+}
+bool EmbeddingLookupIdx_int32_t_uint8_t_float_true__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int* indices,
+    const int* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  return EmbeddingLookupIdx_int32_t_uint8_t_float__neon<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      offsets,
+      weights,
+      scale_bias,
+      normalize_by_lengths,
+      out);
+}
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool EmbeddingLookupIdx_int64_t_uint8_t_float__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int64_t* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  const int64_t prefdist_T0 = 16;
+  const int64_t fused_block_size = block_size + 0;
+  int64_t dataInd = 0;
+  if (block_size == 64) {
+    // unrolling 16 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      float32x4_t vop16 = vdupq_n_f32(0.0f);
+      float32x4_t vop20 = vdupq_n_f32(0.0f);
+      float32x4_t vop24 = vdupq_n_f32(0.0f);
+      float32x4_t vop28 = vdupq_n_f32(0.0f);
+      float32x4_t vop32 = vdupq_n_f32(0.0f);
+      float32x4_t vop36 = vdupq_n_f32(0.0f);
+      float32x4_t vop40 = vdupq_n_f32(0.0f);
+      float32x4_t vop44 = vdupq_n_f32(0.0f);
+      float32x4_t vop48 = vdupq_n_f32(0.0f);
+      float32x4_t vop52 = vdupq_n_f32(0.0f);
+      float32x4_t vop56 = vdupq_n_f32(0.0f);
+      float32x4_t vop60 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        bio = wgt * scale_bias[2 * idx + 1];
+        wgt = wgt * scale_bias[2 * idx];
+        float32x4_t vbio = vdupq_n_f32(bio);
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(
+            vaddq_f32(vop0, vbio), vwgt, load_u8x4_f32(ip + (0)));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(
+            vaddq_f32(vop4, vbio), vwgt, load_u8x4_f32(ip + (4)));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(
+            vaddq_f32(vop8, vbio), vwgt, load_u8x4_f32(ip + (8)));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(
+            vaddq_f32(vop12, vbio), vwgt, load_u8x4_f32(ip + (12)));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop16 = vfmaq_f32(
+            vaddq_f32(vop16, vbio), vwgt, load_u8x4_f32(ip + (16)));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop20 = vfmaq_f32(
+            vaddq_f32(vop20, vbio), vwgt, load_u8x4_f32(ip + (20)));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop24 = vfmaq_f32(
+            vaddq_f32(vop24, vbio), vwgt, load_u8x4_f32(ip + (24)));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop28 = vfmaq_f32(
+            vaddq_f32(vop28, vbio), vwgt, load_u8x4_f32(ip + (28)));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+        vop32 = vfmaq_f32(
+            vaddq_f32(vop32, vbio), vwgt, load_u8x4_f32(ip + (32)));
+        // skip unnecessary prefetch of (&ip_next_T0[32])
+        vop36 = vfmaq_f32(
+            vaddq_f32(vop36, vbio), vwgt, load_u8x4_f32(ip + (36)));
+        // skip unnecessary prefetch of (&ip_next_T0[36])
+        vop40 = vfmaq_f32(
+            vaddq_f32(vop40, vbio), vwgt, load_u8x4_f32(ip + (40)));
+        // skip unnecessary prefetch of (&ip_next_T0[40])
+        vop44 = vfmaq_f32(
+            vaddq_f32(vop44, vbio), vwgt, load_u8x4_f32(ip + (44)));
+        // skip unnecessary prefetch of (&ip_next_T0[44])
+        vop48 = vfmaq_f32(
+            vaddq_f32(vop48, vbio), vwgt, load_u8x4_f32(ip + (48)));
+        // skip unnecessary prefetch of (&ip_next_T0[48])
+        vop52 = vfmaq_f32(
+            vaddq_f32(vop52, vbio), vwgt, load_u8x4_f32(ip + (52)));
+        // skip unnecessary prefetch of (&ip_next_T0[52])
+        vop56 = vfmaq_f32(
+            vaddq_f32(vop56, vbio), vwgt, load_u8x4_f32(ip + (56)));
+        // skip unnecessary prefetch of (&ip_next_T0[56])
+        vop60 = vfmaq_f32(
+            vaddq_f32(vop60, vbio), vwgt, load_u8x4_f32(ip + (60)));
+        // skip unnecessary prefetch of (&ip_next_T0[60])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+        vst1q_f32(&op[16], vop16);
+        vst1q_f32(&op[20], vop20);
+        vst1q_f32(&op[24], vop24);
+        vst1q_f32(&op[28], vop28);
+        vst1q_f32(&op[32], vop32);
+        vst1q_f32(&op[36], vop36);
+        vst1q_f32(&op[40], vop40);
+        vst1q_f32(&op[44], vop44);
+        vst1q_f32(&op[48], vop48);
+        vst1q_f32(&op[52], vop52);
+        vst1q_f32(&op[56], vop56);
+        vst1q_f32(&op[60], vop60);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+        vst1q_f32(&op[16], vmulq_f32(vop16, vlen_inv));
+        vst1q_f32(&op[20], vmulq_f32(vop20, vlen_inv));
+        vst1q_f32(&op[24], vmulq_f32(vop24, vlen_inv));
+        vst1q_f32(&op[28], vmulq_f32(vop28, vlen_inv));
+        vst1q_f32(&op[32], vmulq_f32(vop32, vlen_inv));
+        vst1q_f32(&op[36], vmulq_f32(vop36, vlen_inv));
+        vst1q_f32(&op[40], vmulq_f32(vop40, vlen_inv));
+        vst1q_f32(&op[44], vmulq_f32(vop44, vlen_inv));
+        vst1q_f32(&op[48], vmulq_f32(vop48, vlen_inv));
+        vst1q_f32(&op[52], vmulq_f32(vop52, vlen_inv));
+        vst1q_f32(&op[56], vmulq_f32(vop56, vlen_inv));
+        vst1q_f32(&op[60], vmulq_f32(vop60, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 8 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      float32x4_t vop16 = vdupq_n_f32(0.0f);
+      float32x4_t vop20 = vdupq_n_f32(0.0f);
+      float32x4_t vop24 = vdupq_n_f32(0.0f);
+      float32x4_t vop28 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        bio = wgt * scale_bias[2 * idx + 1];
+        wgt = wgt * scale_bias[2 * idx];
+        float32x4_t vbio = vdupq_n_f32(bio);
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(
+            vaddq_f32(vop0, vbio), vwgt, load_u8x4_f32(ip + (0)));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(
+            vaddq_f32(vop4, vbio), vwgt, load_u8x4_f32(ip + (4)));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(
+            vaddq_f32(vop8, vbio), vwgt, load_u8x4_f32(ip + (8)));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(
+            vaddq_f32(vop12, vbio), vwgt, load_u8x4_f32(ip + (12)));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop16 = vfmaq_f32(
+            vaddq_f32(vop16, vbio), vwgt, load_u8x4_f32(ip + (16)));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop20 = vfmaq_f32(
+            vaddq_f32(vop20, vbio), vwgt, load_u8x4_f32(ip + (20)));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop24 = vfmaq_f32(
+            vaddq_f32(vop24, vbio), vwgt, load_u8x4_f32(ip + (24)));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop28 = vfmaq_f32(
+            vaddq_f32(vop28, vbio), vwgt, load_u8x4_f32(ip + (28)));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+        vst1q_f32(&op[16], vop16);
+        vst1q_f32(&op[20], vop20);
+        vst1q_f32(&op[24], vop24);
+        vst1q_f32(&op[28], vop28);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+        vst1q_f32(&op[16], vmulq_f32(vop16, vlen_inv));
+        vst1q_f32(&op[20], vmulq_f32(vop20, vlen_inv));
+        vst1q_f32(&op[24], vmulq_f32(vop24, vlen_inv));
+        vst1q_f32(&op[28], vmulq_f32(vop28, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 4 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      float32x4_t vop0 = vdupq_n_f32(0.0f);
+      float32x4_t vop4 = vdupq_n_f32(0.0f);
+      float32x4_t vop8 = vdupq_n_f32(0.0f);
+      float32x4_t vop12 = vdupq_n_f32(0.0f);
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        bio = wgt * scale_bias[2 * idx + 1];
+        wgt = wgt * scale_bias[2 * idx];
+        float32x4_t vbio = vdupq_n_f32(bio);
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = vfmaq_f32(
+            vaddq_f32(vop0, vbio), vwgt, load_u8x4_f32(ip + (0)));
+        __builtin_prefetch(&ip_next_T0[0], 0, 3);
+        vop4 = vfmaq_f32(
+            vaddq_f32(vop4, vbio), vwgt, load_u8x4_f32(ip + (4)));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop8 = vfmaq_f32(
+            vaddq_f32(vop8, vbio), vwgt, load_u8x4_f32(ip + (8)));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop12 = vfmaq_f32(
+            vaddq_f32(vop12, vbio), vwgt, load_u8x4_f32(ip + (12)));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+      }
+      if (!normalize_by_lengths || length == 0) {
+        vst1q_f32(&op[0], vop0);
+        vst1q_f32(&op[4], vop4);
+        vst1q_f32(&op[8], vop8);
+        vst1q_f32(&op[12], vop12);
+      } else {
+        float32x4_t vlen_inv = vdupq_n_f32(1.0f / length);
+        vst1q_f32(&op[0], vmulq_f32(vop0, vlen_inv));
+        vst1q_f32(&op[4], vmulq_f32(vop4, vlen_inv));
+        vst1q_f32(&op[8], vmulq_f32(vop8, vlen_inv));
+        vst1q_f32(&op[12], vmulq_f32(vop12, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 4 <= block_size; j += 4) {
+        vst1q_f32(op + j, vdupq_n_f32(0.0f));
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd != offsets[rangeIndex] - offsets[0]) {
+        return false;
+      }
+      int64_t end_offset = offsets[rangeIndex + 1];
+      int64_t length = end_offset - offsets[rangeIndex];
+      for (int64_t start = dataInd; dataInd < end_offset - offsets[0];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        bio = wgt * scale_bias[2 * idx + 1];
+        wgt = wgt * scale_bias[2 * idx];
+        float32x4_t vbio = vdupq_n_f32(bio);
+        float32x4_t vwgt = vdupq_n_f32(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        j = 0;
+        for (; j + 4 <= block_size; j += 4) {
+          vst1q_f32(
+              &op[j],
+              vfmaq_f32(
+                  vaddq_f32(vld1q_f32(&op[j]), vbio),
+                  vwgt,
+                  load_u8x4_f32(&ip[j])));
+          __builtin_prefetch(&ip_next_T0[j], 0, 3);
+        }
+        for (; j < block_size; j++) {
+          op[j] = std::fma(wgt, (float)ip[j], bio + op[j]);
+        }
+      }
+      if (normalize_by_lengths && length) {
+        float len_inv = 1.0f / length;
+        float32x4_t vlen_inv = vdupq_n_f32(len_inv);
+        j = 0;
+        for (; j + 4 <= block_size; j += 4) {
+          vst1q_f32(
+              &op[j], vmulq_f32(vld1q_f32(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool EmbeddingLookupIdx_int64_t_uint8_t_float_false__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int64_t* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  return EmbeddingLookupIdx_int64_t_uint8_t_float__neon<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      offsets,
+      weights,
+      scale_bias,
+      normalize_by_lengths,
+      out);
+}
+bool EmbeddingLookupIdx_int64_t_uint8_t_float_true__neon(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int64_t* offsets,
+    const float* weights,
+    const float* scale_bias,
+    bool normalize_by_lengths,
+    float* out) {
+  return EmbeddingLookupIdx_int64_t_uint8_t_float__neon<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      offsets,
+      weights,
+      scale_bias,
+      normalize_by_lengths,
+      out);
+}
+
+} // namespace caffe2
+
+#endif // defined(__aarch64__)
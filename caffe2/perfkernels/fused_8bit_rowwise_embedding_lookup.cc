@@ -108,6 +108,12 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlow(
   decltype(                                                                              \
       Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__base)     \
       Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__avx2_fma; \
+  decltype(                                                                              \
+      Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__base)     \
+      Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__avx512;   \
+  decltype(                                                                              \
+      Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__base)     \
+      Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__neon;     \
   bool Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType(                  \
       const int64_t block_size,                                                          \
       const int64_t output_size,                                                         \
@@ -124,6 +130,18 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlow(
         reinterpret_cast<const uint8_t*>(&one)[0],                                       \
         1,                                                                               \
         "Fused8BitRowwiseEmbeddingLookup is not supported on this platform");            \
+    AVX512_DO(                                                                           \
+        Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false,         \
+        block_size,                                                                      \
+        output_size,                                                                     \
+        index_size,                                                                      \
+        data_size,                                                                       \
+        input,                                                                           \
+        indices,                                                                         \
+        lengths,                                                                         \
+        weights,                                                                         \
+        normalize_by_lengths,                                                            \
+        out);                                                                            \
     AVX2_FMA_DO(                                                                         \
         Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false,         \
         block_size,                                                                      \
@@ -136,6 +154,18 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlow(
         weights,                                                                         \
         normalize_by_lengths,                                                            \
         out);                                                                            \
+    NEON_DO(                                                                             \
+        Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false,         \
+        block_size,                                                                      \
+        output_size,                                                                     \
+        index_size,                                                                      \
+        data_size,                                                                       \
+        input,                                                                           \
+        indices,                                                                         \
+        lengths,                                                                         \
+        weights,                                                                         \
+        normalize_by_lengths,                                                            \
+        out);                                                                            \
     BASE_DO(                                                                             \
         Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false,         \
         block_size,                                                                      \
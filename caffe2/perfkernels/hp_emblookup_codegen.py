@@ -6,36 +6,123 @@ import sys
 
 sizeof = {"float": 4, "at::Half": 2, "uint8_t": 1}
 
+# The vector extensions the kernels are generated for. width is the number of
+# floats in a vector register, and the block sizes are only unrolled when
+# they fit in max_unroll accumulators.
+isas = {
+    "avx2": {
+        "suffix": "__avx2_fma",
+        "width": 8,
+        "vec": "__m256",
+        "p": "_mm256",
+        "half_load": "_mm_loadu_si128",
+        "half_vec": "__m128i",
+        "u8_load": "_mm_loadl_epi64",
+        "max_unroll": 16,
+    },
+    "avx512": {
+        "suffix": "__avx512",
+        "width": 16,
+        "vec": "__m512",
+        "p": "_mm512",
+        "half_load": "_mm256_loadu_si256",
+        "half_vec": "__m256i",
+        "u8_load": "_mm_loadu_si128",
+        "max_unroll": 16,
+    },
+    "neon": {
+        "suffix": "__neon",
+        "width": 4,
+        "vec": "float32x4_t",
+        "max_unroll": 16,
+    },
+}
+
+
+def vset1(isa, value):
+    if isa["name"] == "neon":
+        return "vdupq_n_f32(" + value + ")"
+    return isa["p"] + "_set1_ps(" + value + ")"
+
+
+def vsetzero(isa):
+    if isa["name"] == "neon":
+        return "vdupq_n_f32(0.0f)"
+    return isa["p"] + "_setzero_ps()"
+
+
+def vstore(isa, ptr, value):
+    if isa["name"] == "neon":
+        return "vst1q_f32(" + ptr + ", " + value + ")"
+    return isa["p"] + "_storeu_ps(" + ptr + ", " + value + ")"
+
+
+def vmul(isa, a, b):
+    if isa["name"] == "neon":
+        return "vmulq_f32(" + a + ", " + b + ")"
+    return isa["p"] + "_mul_ps(" + a + ", " + b + ")"
+
+
+def vload(isa, ptr):
+    if isa["name"] == "neon":
+        return "vld1q_f32(" + ptr + ")"
+    return isa["p"] + "_loadu_ps(" + ptr + ")"
+
 
 def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     def compute(regid, InType, use_weights, isa, prefetch):
         code = []
 
-        if InType == "float":
+        if isa["name"] == "neon":
+            if InType == "float":
+                code.append(
+                    "        vop%d = vfmaq_f32(vop%d, vwgt, vld1q_f32(ip + (%d)));"
+                    % (regid, regid, regid)
+                )
+            elif InType == "at::Half":
+                code.append(
+                    "        vop%d = vfmaq_f32(\n"
+                    "            vop%d,\n"
+                    "            vwgt,\n"
+                    "            vcvt_f32_f16(\n"
+                    "                vld1_f16(reinterpret_cast<const float16_t*>(ip + (%d)))));"  # noqa
+                    % (regid, regid, regid)
+                )
+            elif InType == "uint8_t":
+                code.append(
+                    "        vop%d = vfmaq_f32(\n"
+                    "            vaddq_f32(vop%d, vbio), vwgt, load_u8x4_f32(ip + (%d)));"
+                    % (regid, regid, regid)
+                )
+            else:
+                assert False
+        elif InType == "float":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(vwgt, _mm256_loadu_ps(ip + (%d)), vop%d);"  # noqa
+                "        vop%d = {p}_fmadd_ps(vwgt, {p}_loadu_ps(ip + (%d)), vop%d);".format(**isa)  # noqa
                 % (regid, regid, regid)
             )
         elif InType == "at::Half":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
-                "            vwgt,\n"
-                "            _mm256_cvtph_ps(\n"
-                "                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (%d)))),\n"  # noqa
-                "            vop%d);" % (regid, regid, regid)
+                ("        vop%d = {p}_fmadd_ps(\n"
+                 "            vwgt,\n"
+                 "            {p}_cvtph_ps(\n"
+                 "                {half_load}(reinterpret_cast<const {half_vec}*>(ip + (%d)))),\n"  # noqa
+                 "            vop%d);").format(**isa) % (regid, regid, regid)
             )
         elif InType == "uint8_t":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
-                "            vwgt,\n"
-                "            _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(\n"
-                "                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(ip + (%d))))),\n"  # noqa
-                "            _mm256_add_ps(vop%d, vbio));" % (regid, regid, regid)
+                ("        vop%d = {p}_fmadd_ps(\n"
+                 "            vwgt,\n"
+                 "            {p}_cvtepi32_ps({p}_cvtepu8_epi32(\n"
+                 "                {u8_load}(reinterpret_cast<const __m128i*>(ip + (%d))))),\n"  # noqa
+                 "            {p}_add_ps(vop%d, vbio));").format(**isa) % (regid, regid, regid)
             )
         else:
             assert False
 
-        if prefetch:
+        if prefetch and isa["name"] == "neon":
+            code.append("        __builtin_prefetch(&ip_next_T0[%d], 0, 3);" % (regid))
+        elif prefetch:
             code.append(
                 "        _mm_prefetch(\n"
                 "            reinterpret_cast<const char*>(&ip_next_T0[%d]), _MM_HINT_T0);"
@@ -66,8 +153,8 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
 
     code.append("      " + OutType + "* op = &out[rangeIndex * block_size];")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("      __m256 vop" + str(j) + " = _mm256_setzero_ps();")
+        j = isa["width"] * i
+        code.append("      " + isa["vec"] + " vop" + str(j) + " = " + vsetzero(isa) + ";")
 
     # inner loop
     if use_offsets:
@@ -120,7 +207,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        " + isa["vec"] + " vbio = " + vset1(isa, "bio") + ";")
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -128,7 +215,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        " + isa["vec"] + " vwgt = " + vset1(isa, "wgt") + ";")
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -150,7 +237,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     )
 
     for i in range(0, uf):
-        j = 8 * i
+        j = isa["width"] * i
         cachelinesize = 64
         byteoffset = sizeof[InType] * j
         prefetch = (byteoffset % cachelinesize) == 0
@@ -162,23 +249,21 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     else:
         code.append("      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("        _mm256_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");")
+        j = isa["width"] * i
+        code.append("        " + vstore(isa, "&op[" + str(j) + "]", "vop" + str(j)) + ";")
     code.append("      } else {")
     # inv of length
     if use_offsets:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / length);")
+        inv = "1.0f / length"
     else:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);")
+        inv = "1.0f / lengths[rangeIndex]"
+    code.append("        " + isa["vec"] + " vlen_inv = " + vset1(isa, inv) + ";")
     for i in range(0, uf):
-        j = 8 * i
+        j = isa["width"] * i
         code.append(
-            "        _mm256_storeu_ps(&op["
-            + str(j)
-            + "], _mm256_mul_ps("
-            + "vop"
-            + str(j)
-            + ", vlen_inv));"
+            "        "
+            + vstore(isa, "&op[" + str(j) + "]", vmul(isa, "vop" + str(j), "vlen_inv"))
+            + ";"
         )
     code.append("      }")
 
@@ -189,32 +274,63 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
 def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     def compute(InType, use_weights, isa):
         code = []
+        if isa["name"] == "neon":
+            if InType == "float":
+                code.append(
+                    "          vst1q_f32(\n"
+                    "              &op[j], vfmaq_f32(vld1q_f32(&op[j]), vwgt, vld1q_f32(&ip[j])));"  # noqa
+                )
+            elif InType == "at::Half":
+                code.append(
+                    "          vst1q_f32(\n"
+                    "              &op[j],\n"
+                    "              vfmaq_f32(\n"
+                    "                  vld1q_f32(&op[j]),\n"
+                    "                  vwgt,\n"
+                    "                  vcvt_f32_f16(\n"
+                    "                      vld1_f16(reinterpret_cast<const float16_t*>(&ip[j])))));"  # noqa
+                )
+            elif InType == "uint8_t":
+                code.append(
+                    "          vst1q_f32(\n"
+                    "              &op[j],\n"
+                    "              vfmaq_f32(\n"
+                    "                  vaddq_f32(vld1q_f32(&op[j]), vbio),\n"
+                    "                  vwgt,\n"
+                    "                  load_u8x4_f32(&ip[j])));"
+                )
+            else:
+                assert False
+
+            code.append("          __builtin_prefetch(&ip_next_T0[j], 0, 3);")
+            return code
+
         if InType == "float":
             code.append(
-                "          _mm256_storeu_ps(\n"
-                "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
-                "                  vwgt, _mm256_loadu_ps(&ip[j]), _mm256_loadu_ps(&op[j])));"  # noqa
+                ("          {p}_storeu_ps(\n"
+                 "              &op[j],\n"
+                 "              {p}_fmadd_ps(\n"
+                 "                  vwgt, {p}_loadu_ps(&ip[j]), {p}_loadu_ps(&op[j])));").format(**isa)  # noqa
             )
         elif InType == "at::Half":
             code.append(
-                "          _mm256_storeu_ps(\n"
-                "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
-                "                  vwgt,\n"
-                "                  _mm256_cvtph_ps(_mm_loadu_si128(\n"
-                "                      reinterpret_cast<const __m128i*>(&ip[j]))),\n"
-                "                  _mm256_loadu_ps(&op[j])));"
+                ("          {p}_storeu_ps(\n"
+                 "              &op[j],\n"
+                 "              {p}_fmadd_ps(\n"
+                 "                  vwgt,\n"
+                 "                  {p}_cvtph_ps({half_load}(\n"
+                 "                      reinterpret_cast<const {half_vec}*>(&ip[j]))),\n"
+                 "                  {p}_loadu_ps(&op[j])));").format(**isa)
             )
         elif InType == "uint8_t":
             code.append(
-                "          _mm256_storeu_ps(\n"
-                "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
-                "                  vwgt,\n"
-                "                  _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(\n"  # noqa
-                "                      reinterpret_cast<const __m128i*>(&ip[j])))),\n"
-                "                  _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio)));"
+                ("          {p}_storeu_ps(\n"
+                 "              &op[j],\n"
+                 "              {p}_fmadd_ps(\n"
+                 "                  vwgt,\n"
+                 "                  {p}_cvtepi32_ps({p}_cvtepu8_epi32({u8_load}(\n"  # noqa
+                 "                      reinterpret_cast<const __m128i*>(&ip[j])))),\n"
+                 "                  {p}_add_ps({p}_loadu_ps(&op[j]), vbio)));").format(**isa)
             )
         else:
             assert False
@@ -227,8 +343,8 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
         return code
 
     code = []
-    if InType == "at::Half":
-        code.append("    alignas(64) at::Half vtmp1[8] = {0};")
+    if InType == "at::Half" and isa["name"] != "neon":
+        code.append("    alignas(64) at::Half vtmp1[{}] = {{0}};".format(isa["width"]))
 
 
 
@@ -249,8 +365,8 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # initialize to 0
     code.append("      int64_t j = 0;")
-    code.append("      for (; j + 8 <= block_size; j += 8) {")
-    code.append("        _mm256_storeu_ps(op + j, _mm256_setzero_ps());")
+    code.append("      for (; j + {0} <= block_size; j += {0}) {{".format(isa["width"]))
+    code.append("        " + vstore(isa, "op + j", vsetzero(isa)) + ";")
     code.append("      }")
     code.append("      for (; j < block_size; j++) {")
     code.append("        op[j] = 0.0f;")
@@ -307,7 +423,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        " + isa["vec"] + " vbio = " + vset1(isa, "bio") + ";")
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -315,7 +431,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        " + isa["vec"] + " vwgt = " + vset1(isa, "wgt") + ";")
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -337,18 +453,20 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # compute and store main loop
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
+    code.append("        for (; j + {0} <= block_size; j += {0}) {{".format(isa["width"]))
     code.extend(compute(InType, use_weights, isa))
     code.append("        }")
     # leftover
     code.append("        for (; j < block_size; j++) {")
     if InType == "float":
         code.append("          op[j] = std::fma(wgt, ip[j], op[j]);")
+    elif InType == "at::Half" and isa["name"] == "neon":
+        code.append("          op[j] = std::fma(wgt, static_cast<float>(ip[j]), op[j]);")
     elif InType == "at::Half":
         code.append("          vtmp1[0] = ip[j];")
         code.append(
-            "          __m256 vtmp2 =\n"
-            "              _mm256_cvtph_ps(*(reinterpret_cast<const __m128i*>(vtmp1)));"
+            ("          {vec} vtmp2 =\n"
+             "              {p}_cvtph_ps(*(reinterpret_cast<const {half_vec}*>(vtmp1)));").format(**isa)  # noqa
         )
         code.append("          op[j] = std::fma(wgt, ((float*)(&vtmp2))[0], op[j]);")
     elif InType == "uint8_t":
@@ -366,12 +484,11 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     else:
         code.append("      if (normalize_by_lengths && lengths[rangeIndex]) {")
         code.append("        float len_inv = 1.0f / lengths[rangeIndex];")
-    code.append("        __m256 vlen_inv = _mm256_set1_ps(len_inv);")
+    code.append("        " + isa["vec"] + " vlen_inv = " + vset1(isa, "len_inv") + ";")
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
+    code.append("        for (; j + {0} <= block_size; j += {0}) {{".format(isa["width"]))
     code.append(
-        "          _mm256_storeu_ps(\n"
-        "              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));"
+        "          " + vstore(isa, "\n              &op[j]", vmul(isa, vload(isa, "&op[j]"), "vlen_inv")) + ";"  # noqa
     )
     code.append("        }")
     code.append("        for (; j < block_size; j++) {")
@@ -389,19 +506,21 @@ parser = argparse.ArgumentParser()
 parser.add_argument("-f", "--filename", help="file name")
 parser.add_argument("--fused", action="store_true")
 parser.add_argument("--use-offsets", action="store_true")
+parser.add_argument("--isa", choices=sorted(isas.keys()), default="avx2")
 opts = parser.parse_args()
+isa = dict(isas[opts.isa], name=opts.isa)
 if opts.filename:
     filename = opts.filename
 elif opts.fused:
     if opts.use_offsets:
-        filename = "embedding_lookup_fused_8bit_rowwise_idx_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_fused_8bit_rowwise_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_{}.cc".format(opts.isa)
 else:
     if opts.use_offsets:
-        filename = "embedding_lookup_idx_avx2.cc"
+        filename = "embedding_lookup_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_avx2.cc"
+        filename = "embedding_lookup_{}.cc".format(opts.isa)
 
 options = [
     ["int32_t", "int", "float", "float", "float", "float"],
@@ -421,10 +540,28 @@ code.append("//// BY {}".format(sys.argv[0]))
 code.append("//// DO NOT MODIFY!!!")
 code.append("//// --------------------------\n")
 
-code.append("#include <c10/util/Half.h>")
-code.append("#include <immintrin.h>")
+if isa["name"] == "neon":
+    # The kernels use the AArch64 FMA and half conversions, and the file is
+    # built along the common sources on every platform
+    code.append("#if defined(__aarch64__)\n")
+    code.append("#include <c10/util/Half.h>")
+    code.append("#include <arm_neon.h>")
+    code.append("#include <cstring>\n")
+    code.append("namespace caffe2 {\n")
+    code.append("namespace {\n")
+    code.append("inline float32x4_t load_u8x4_f32(const uint8_t* ptr) {")
+    code.append("  // 4 bytes, which may not be aligned")
+    code.append("  uint32_t bytes;")
+    code.append("  std::memcpy(&bytes, ptr, sizeof(bytes));")
+    code.append("  return vcvtq_f32_u32(vmovl_u16(vget_low_u16(")
+    code.append("      vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(bytes))))));")
+    code.append("}\n")
+    code.append("} // namespace\n")
+else:
+    code.append("#include <c10/util/Half.h>")
+    code.append("#include <immintrin.h>")
 
-code.append("namespace caffe2 {\n")
+    code.append("namespace caffe2 {\n")
 for o in options:
     [IndexTypeName, IndexType, InTypeName, InType, OutTypeName, OutType] = o
 
@@ -438,7 +575,7 @@ for o in options:
         fn_base = "{}EmbeddingLookup_{}_{}_{}".format(
             prefix, IndexTypeName, InTypeName, OutTypeName
         )
-    suffix = "__avx2_fma"
+    suffix = isa["suffix"]
     fn = "static bool " + fn_base + suffix
     code.append(fn + "(")
 
@@ -474,17 +611,17 @@ for o in options:
 
     # code.append("printf(\"calling " + fn + "\\n\");");
 
-    code.append("  if (block_size == 128) {")
-    code += unroll(16, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 64) {")
-    code += unroll(8, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 32) {")
-    code += unroll(4, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 16) {")
-    code += unroll(2, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    branch = "  if"
+    for unrolled_size in [128, 64, 32, 16]:
+        uf = unrolled_size // isa["width"]
+        if uf < 1 or uf > isa["max_unroll"]:
+            continue
+        code.append(branch + " (block_size == {}) {{".format(unrolled_size))
+        code += unroll(uf, IndexType, InType, OutType, True, isa, opts.fused, opts.use_offsets)
+        branch = "  } else if"
     code.append("  } else {")
     code.append("    // generic code")
-    code += generic(IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    code += generic(IndexType, InType, OutType, True, isa, opts.fused, opts.use_offsets)
     code.append("  }")
     code.append("  return dataInd == index_size;")
 
@@ -520,6 +657,8 @@ for o in options:
     code.append("")
 
 code.append("} // namespace caffe2")
+if isa["name"] == "neon":
+    code.append("\n#endif // defined(__aarch64__)")
 
 with open(filename, "w") as fout:
     for c in code:
@@ -41,42 +41,67 @@ Predictor::Predictor(
           optimization)) {}
 
 Predictor::Predictor(PredictorConfig config) : config_(std::move(config)) {
-  const auto& initialized_vec = config_.ws->Blobs();
-  const std::unordered_set<std::string> initialized{initialized_vec.begin(),
-                                                    initialized_vec.end()};
+  if (config_.async_num_workers > 0) {
+    config_.predict_net->set_type("async_scheduling");
+    config_.predict_net->set_num_workers(config_.async_num_workers);
+  }
+  // The blobs created in the shared workspace would be found by the thread
+  // workspaces in place of their own ones, so the net is only created in
+  // there when it runs there
+  if (!config_.per_thread_workspaces) {
+    create_net(config_.ws.get());
+  }
+}
+
+void Predictor::create_net(Workspace* ws) {
   for (const auto& name : config_.predict_net->external_input()) {
-    if (!initialized.count(name)) {
-      auto* blob = config_.ws->CreateBlob(name);
+    if (!ws->HasBlob(name)) {
+      auto* blob = ws->CreateBlob(name);
       BlobGetMutableTensor(blob, CPU);
     }
   }
-  CAFFE_ENFORCE(config_.ws->CreateNet(config_.predict_net));
+  CAFFE_ENFORCE(ws->CreateNet(config_.predict_net));
+}
+
+Workspace* Predictor::run_ws() {
+  if (!config_.per_thread_workspaces) {
+    return config_.ws.get();
+  }
+  auto* ws = thread_ws_.get();
+  if (!ws) {
+    auto thread_ws = std::make_unique<Workspace>(config_.ws.get());
+    create_net(thread_ws.get());
+    ws = thread_ws.get();
+    thread_ws_.reset(std::move(thread_ws));
+  }
+  return ws;
 }
 
 bool Predictor::operator()(const TensorList& inputs, TensorList* outputs) {
   CAFFE_ENFORCE(
       inputs.size() <=
       static_cast<unsigned>(config_.predict_net->external_input_size()));
+  auto* ws = run_ws();
   for (size_t i = 0; i < inputs.size(); ++i) {
     // This is evil and shares the same underlying tensor
     BlobSetTensor(
-        getBlob(config_.ws.get(), config_.predict_net->external_input(i)),
+        getBlob(ws, config_.predict_net->external_input(i)),
         inputs[i].UnsafeSharedInstance());
   }
 
-  if (!config_.ws->RunNet(config_.predict_net->name())) {
+  if (!ws->RunNet(config_.predict_net->name())) {
     return false;
   }
   outputs->clear();
   for (size_t i = 0; i < config_.predict_net->external_output_size(); ++i) {
     outputs->emplace_back(
-        getTensor(config_.ws.get(), config_.predict_net->external_output(i))
+        getTensor(ws, config_.predict_net->external_output(i))
             .UnsafeSharedInstance());
   }
   return true;
 }
 
-bool Predictor::run_map_workspace(const TensorMap& inputs) {
+bool Predictor::run_map_workspace(Workspace* ws, const TensorMap& inputs) {
   if (!config_.input_names.empty()) {
     CAFFE_ENFORCE_EQ(inputs.size(), input_names().size());
   }
@@ -90,35 +115,37 @@ bool Predictor::run_map_workspace(const TensorMap& inputs) {
     }
     // This is evil and shares the same underlying tensor
     BlobSetTensor(
-        getBlob(config_.ws.get(), input.first),
+        getBlob(ws, input.first),
         input.second.UnsafeSharedInstance());
   }
 
-  return config_.ws->RunNet(config_.predict_net->name());
+  return ws->RunNet(config_.predict_net->name());
 }
 
 bool Predictor::operator()(const TensorMap& inputs, TensorList* outputs) {
-  if (!run_map_workspace(inputs)) {
+  auto* ws = run_ws();
+  if (!run_map_workspace(ws, inputs)) {
     return false;
   }
   outputs->clear();
   for (size_t i = 0; i < config_.predict_net->external_output_size(); ++i) {
     outputs->push_back(
-        getTensor(config_.ws.get(), config_.predict_net->external_output(i))
+        getTensor(ws, config_.predict_net->external_output(i))
             .UnsafeSharedInstance());
   }
   return true;
 }
 
 bool Predictor::operator()(const TensorMap& inputs, TensorMap* outputs) {
-  if (!run_map_workspace(inputs)) {
+  auto* ws = run_ws();
+  if (!run_map_workspace(ws, inputs)) {
     return false;
   }
 
   for (const std::string& outputName : output_names()) {
     outputs->emplace(
         outputName,
-        getTensor(config_.ws.get(), outputName).UnsafeSharedInstance());
+        getTensor(ws, outputName).UnsafeSharedInstance());
   }
   return true;
 }
@@ -3,6 +3,7 @@
 #include <unordered_set>
 #include "caffe2/core/net.h"
 #include "caffe2/core/tensor.h"
+#include "caffe2/predictor/ThreadLocalPtr.h"
 #include "caffe2/predictor/predictor_config.h"
 
 namespace caffe2 {
@@ -35,6 +36,8 @@ class TORCH_API Predictor {
 
   // NOTE: output is a part of thread local workspace
   // and is only valid until the next predictor execution.
+  // It is only safe to run the predictor from several threads at once with
+  // config.per_thread_workspaces set, see PredictorConfig.
 
   // Returns true on success
   virtual bool operator()(const TensorList& inputs, TensorList* outputs);
@@ -50,6 +53,8 @@ class TORCH_API Predictor {
     return *config_.predict_net;
   };
 
+  // The workspace holding the parameters, which is also the one running
+  // the net unless config.per_thread_workspaces is set
   Workspace* ws() {
     return config_.ws.get();
   };
@@ -63,9 +68,17 @@ class TORCH_API Predictor {
   }
 
  private:
-  bool run_map_workspace(const TensorMap& inputs);
+  // The workspace running the net in this thread
+  Workspace* run_ws();
+  void create_net(Workspace* ws);
+  bool run_map_workspace(Workspace* ws, const TensorMap& inputs);
 
  protected:
   PredictorConfig config_;
+
+ private:
+  // Declared after config_ so that the workspaces sharing its parameters are
+  // destroyed first
+  ThreadLocalPtr<Workspace> thread_ws_;
 };
 } // namespace caffe2
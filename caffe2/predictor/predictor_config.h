@@ -39,6 +39,17 @@ struct TORCH_API PredictorConfig {
   // tensor. Once tensor support intrusive_ptr, we'll get rid of this and use
   // parameters to construct Workspace
   std::shared_ptr<Workspace> ws;
+
+  // When set, the predictor may be run from several threads at once. Each
+  // thread runs predict_net in a workspace of its own, which looks up the
+  // parameters in ws, so that only the inputs and the intermediate blobs are
+  // allocated per thread, once, and reused by the following runs.
+  bool per_thread_workspaces{false};
+
+  // When positive, predict_net runs on the async_scheduling executor, with
+  // this many workers taken from the CPU thread pool shared by all the nets,
+  // instead of running its operators one after the other.
+  int async_num_workers{0};
 };
 
 TORCH_API Workspace makeWorkspace(std::shared_ptr<PredictorParameters> parameters);
@@ -6,6 +6,8 @@
 
 #include <gtest/gtest.h>
 
+#include <thread>
+
 namespace caffe2 {
 
 namespace {
@@ -205,4 +207,39 @@ TEST_F(PredictorTest, SimpleBatchSizedMapInput) {
   EXPECT_NEAR(output.front().data<float>()[4], 4.9556, 1E-4);
 }
 
+TEST_F(PredictorTest, SimpleBatchSizedPerThreadWorkspaces) {
+  auto config =
+      makePredictorConfig(parseNetDef(initSpec), parseNetDef(predictSpec));
+  config.per_thread_workspaces = true;
+  config.async_num_workers = 2;
+  Predictor p(std::move(config));
+
+  auto inputData = randomTensor({1, 4}, ctx_.get());
+  auto tensor = BlobGetMutableTensor(inputData.get(), CPU);
+
+  std::vector<std::thread> threads;
+  std::vector<float> results(4);
+  for (size_t i = 0; i < results.size(); ++i) {
+    threads.emplace_back([&, i]() {
+      for (int run = 0; run < 3; ++run) {
+        Predictor::TensorList input;
+        input.emplace_back(tensor->Alias());
+        Predictor::TensorList output;
+        CAFFE_ENFORCE(p(input, &output));
+        CAFFE_ENFORCE_EQ(output.size(), 1);
+        results[i] = output.front().data<float>()[4];
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto result : results) {
+    EXPECT_NEAR(result, 4.9556, 1E-4);
+  }
+  // The parameters are shared, and the inputs and outputs are per thread
+  EXPECT_TRUE(p.ws()->HasBlob("W"));
+  EXPECT_FALSE(p.ws()->HasBlob("y"));
+}
+
 } // namespace caffe2
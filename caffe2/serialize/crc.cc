@@ -1,12 +1,45 @@
 #include "miniz.h"
+#include <algorithm>
 #include <iostream>
+#include <vector>
+
+#include <ATen/Parallel.h>
 
 #include "caffe2/serialize/crc_alt.h"
 
+namespace {
+// Buffers larger than this, e.g. the records of the tensors written by
+// PyTorchStreamWriter, are checksummed in parallel, one chunk per task, and
+// the CRCs of the chunks are combined.
+constexpr size_t kParallelCrcChunkSize = 4 * 1024 * 1024;
+
+uint32_t parallel_crc32(const uint8_t* data, size_t size, uint32_t crc) {
+  const size_t num_chunks =
+      (size + kParallelCrcChunkSize - 1) / kParallelCrcChunkSize;
+  std::vector<uint32_t> crcs(num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const size_t offset = i * kParallelCrcChunkSize;
+      crcs[i] = crc32_fast(
+          data + offset, std::min(kParallelCrcChunkSize, size - offset));
+    }
+  });
+  for (size_t i = 0; i < num_chunks; i++) {
+    const size_t offset = i * kParallelCrcChunkSize;
+    crc = crc32_combine(
+        crc, crcs[i], std::min(kParallelCrcChunkSize, size - offset));
+  }
+  return crc;
+}
+} // namespace
+
 extern "C" {
 // See: miniz.h
-#if defined(USE_EXTERNAL_MZCRC) 
+#if defined(USE_EXTERNAL_MZCRC)
 mz_ulong mz_crc32(mz_ulong crc, const mz_uint8* ptr, size_t buf_len) {
+  if (ptr && buf_len > kParallelCrcChunkSize && !at::in_parallel_region()) {
+    return parallel_crc32(ptr, buf_len, crc);
+  }
   auto z = crc32_fast(ptr, buf_len, crc);
   return z;
 };
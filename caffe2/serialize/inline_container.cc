@@ -6,6 +6,7 @@
 #include <fstream>
 #include <algorithm>
 
+#include <ATen/Parallel.h>
 #include <c10/core/Allocator.h>
 #include <c10/core/CPUAllocator.h>
 #include <c10/core/Backend.h>
@@ -19,6 +20,9 @@
 
 #include "miniz.h"
 
+// defined in caffe2/serialize/crc_alt.h, which is compiled by crc.cc
+uint32_t crc32_combine(uint32_t crcA, uint32_t crcB, size_t lengthB);
+
 namespace caffe2 {
 namespace serialize {
 
@@ -147,6 +151,7 @@ void PyTorchStreamReader::valid(const char* what, const char* info) {
 }
 
 constexpr int MZ_ZIP_LOCAL_DIR_HEADER_SIZE = 30;
+constexpr uint32_t MZ_ZIP_LOCAL_DIR_HEADER_SIG = 0x04034b50;
 constexpr int MZ_ZIP_LDH_FILENAME_LEN_OFS = 26;
 constexpr int MZ_ZIP_LDH_EXTRA_LEN_OFS = 28;
 
@@ -225,36 +230,388 @@ size_t PyTorchStreamReader::getRecordID(const std::string& name) {
   return result;
 }
 
+static int64_t read_le_16(uint8_t* buf) {
+  return buf[0] + (buf[1] << 8);
+}
+
+// Offset of the data of the record whose local header starts at local_header_ofs.
+static size_t record_data_offset(
+    const ReadAdapterInterface& in,
+    mz_uint64 local_header_ofs) {
+  uint8_t local_header[MZ_ZIP_LOCAL_DIR_HEADER_SIZE];
+  in.read(
+      local_header_ofs,
+      local_header,
+      MZ_ZIP_LOCAL_DIR_HEADER_SIZE,
+      "reading file header");
+  size_t filename_len = read_le_16(local_header + MZ_ZIP_LDH_FILENAME_LEN_OFS);
+  size_t extra_len = read_le_16(local_header + MZ_ZIP_LDH_EXTRA_LEN_OFS);
+  return local_header_ofs + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + filename_len + extra_len;
+}
+
+// Context of records that alias the memory of a mapped archive: keeps the
+// adapter, and with it the mapping, alive until the last record is freed.
+static void deleteMappedRecord(void* ctx) {
+  delete static_cast<std::shared_ptr<ReadAdapterInterface>*>(ctx);
+}
+
+// The tag of the local extra field of compressed records, see
+// Note [Compressed records]
+constexpr char kCompressedTag[2] = {'T', 'C'};
+// The extra field is at most 0xFFFF bytes long, which bounds the number of
+// chunks of a record. Larger records get larger chunks.
+constexpr size_t kMaxCompressedChunks = 16000;
+
+static uint32_t read_le_32(const uint8_t* buf) {
+  return buf[0] | (buf[1] << 8) | (buf[2] << 16) | (uint32_t(buf[3]) << 24);
+}
+
+static void write_le_32(std::string& buf, uint32_t value) {
+  for (int i = 0; i < 4; i++) {
+    buf.push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+// Transposes the n elements of element_size bytes of src into element_size
+// byte planes of n bytes in dst, or back if unshuffle.
+static void shuffle_bytes(
+    const uint8_t* src,
+    uint8_t* dst,
+    size_t size,
+    size_t element_size,
+    bool unshuffle) {
+  const size_t n = size / element_size;
+  for (size_t b = 0; b < element_size; b++) {
+    for (size_t j = 0; j < n; j++) {
+      if (unshuffle) {
+        dst[j * element_size + b] = src[b * n + j];
+      } else {
+        dst[b * n + j] = src[j * element_size + b];
+      }
+    }
+  }
+}
+
+// CRC-32 of the chunks of chunk_size bytes of data, computed in parallel.
+static uint32_t chunked_crc32(
+    const uint8_t* data,
+    size_t size,
+    size_t chunk_size) {
+  const size_t num_chunks = (size + chunk_size - 1) / chunk_size;
+  std::vector<uint32_t> crcs(num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const size_t offset = i * chunk_size;
+      crcs[i] = mz_crc32(
+          MZ_CRC32_INIT, data + offset, std::min(chunk_size, size - offset));
+    }
+  });
+  uint32_t crc = MZ_CRC32_INIT;
+  for (size_t i = 0; i < num_chunks; i++) {
+    const size_t offset = i * chunk_size;
+    crc = i == 0
+        ? crcs[i]
+        : crc32_combine(crc, crcs[i], std::min(chunk_size, size - offset));
+  }
+  return crc;
+}
+
+// Inflates the record of stat into out if it was compressed by
+// PyTorchStreamWriter, see Note [Compressed records]. Returns false for the
+// records of other writers, which have no "TC" extra field.
+static bool readCompressedChunks(
+    const ReadAdapterInterface& in,
+    const mz_zip_archive_file_stat& stat,
+    void* out,
+    const std::string& name) {
+  uint8_t local_header[MZ_ZIP_LOCAL_DIR_HEADER_SIZE];
+  in.read(
+      stat.m_local_header_ofs,
+      local_header,
+      MZ_ZIP_LOCAL_DIR_HEADER_SIZE,
+      "reading file header");
+  TORCH_CHECK(
+      MZ_READ_LE32(local_header) == MZ_ZIP_LOCAL_DIR_HEADER_SIG,
+      "PytorchStreamReader failed reading file ",
+      name,
+      ": invalid header");
+  const size_t filename_len =
+      read_le_16(local_header + MZ_ZIP_LDH_FILENAME_LEN_OFS);
+  const size_t extra_len = read_le_16(local_header + MZ_ZIP_LDH_EXTRA_LEN_OFS);
+  std::vector<uint8_t> extra(extra_len);
+  in.read(
+      stat.m_local_header_ofs + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + filename_len,
+      extra.data(),
+      extra_len,
+      "reading file header");
+
+  const uint8_t* field = nullptr;
+  size_t field_len = 0;
+  for (size_t pos = 0; pos + 4 <= extra_len;) {
+    const size_t len = read_le_16(&extra[pos + 2]);
+    if (extra[pos] == kCompressedTag[0] && extra[pos + 1] == kCompressedTag[1] &&
+        pos + 4 + len <= extra_len) {
+      field = &extra[pos + 4];
+      field_len = len;
+      break;
+    }
+    pos += 4 + len;
+  }
+  if (field == nullptr || field_len < 8) {
+    return false;
+  }
+  const size_t size = stat.m_uncomp_size;
+  const size_t element_size = read_le_32(field);
+  const size_t chunk_size = read_le_32(field + 4);
+  const size_t num_chunks = (field_len - 8) / 4;
+  TORCH_CHECK(
+      element_size > 0 && chunk_size > 0 &&
+          chunk_size % element_size == 0 && size % element_size == 0 &&
+          num_chunks == (size + chunk_size - 1) / chunk_size,
+      "PytorchStreamReader failed reading file ",
+      name,
+      ": invalid compressed record");
+  std::vector<size_t> chunk_offsets(num_chunks + 1, 0);
+  for (size_t i = 0; i < num_chunks; i++) {
+    chunk_offsets[i + 1] = chunk_offsets[i] + read_le_32(field + 8 + 4 * i);
+  }
+  TORCH_CHECK(
+      chunk_offsets[num_chunks] == stat.m_comp_size,
+      "PytorchStreamReader failed reading file ",
+      name,
+      ": invalid compressed record");
+
+  std::vector<uint8_t> compressed(stat.m_comp_size);
+  in.read(
+      stat.m_local_header_ofs + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + filename_len +
+          extra_len,
+      compressed.data(),
+      compressed.size(),
+      "reading file");
+
+  auto dst = static_cast<uint8_t*>(out);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    std::unique_ptr<tinfl_decompressor> decompressor(new tinfl_decompressor);
+    std::vector<uint8_t> shuffled;
+    for (int64_t i = begin; i < end; i++) {
+      const size_t offset = i * chunk_size;
+      const size_t len = std::min(chunk_size, size - offset);
+      const bool last = static_cast<size_t>(i) + 1 == num_chunks;
+      uint8_t* chunk = dst + offset;
+      if (element_size > 1) {
+        shuffled.resize(len);
+        chunk = shuffled.data();
+      }
+      size_t in_size = chunk_offsets[i + 1] - chunk_offsets[i];
+      size_t out_size = len;
+      tinfl_init(decompressor.get());
+      const tinfl_status status = tinfl_decompress(
+          decompressor.get(),
+          compressed.data() + chunk_offsets[i],
+          &in_size,
+          chunk,
+          chunk,
+          &out_size,
+          TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF |
+              (last ? 0 : TINFL_FLAG_HAS_MORE_INPUT));
+      // The chunks before the last one end with a flush rather than with the
+      // end of the stream.
+      const bool complete = last ? status == TINFL_STATUS_DONE
+                                 : status == TINFL_STATUS_NEEDS_MORE_INPUT ||
+              status == TINFL_STATUS_HAS_MORE_OUTPUT;
+      TORCH_CHECK(
+          complete && out_size == len,
+          "PytorchStreamReader failed reading file ",
+          name,
+          ": decompression failed");
+      if (element_size > 1) {
+        shuffle_bytes(chunk, dst + offset, len, element_size, true);
+      }
+    }
+  });
+  TORCH_CHECK(
+      chunked_crc32(dst, size, chunk_size) == stat.m_crc32,
+      "PytorchStreamReader failed reading file ",
+      name,
+      ": CRC-32 check failed");
+  return true;
+}
+
 // return dataptr, size
 std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string& name) {
+  auto prefetched = prefetched_.find(name);
+  if (prefetched != prefetched_.end()) {
+    auto retval = std::move(prefetched->second);
+    prefetched_.erase(prefetched);
+    return retval;
+  }
+
   size_t key = getRecordID(name);
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), key, &stat);
   valid("retrieving file meta-data for ", name.c_str());
+
+  // Records that are stored uncompressed in a mapped archive are returned
+  // without copying. Note that their CRC is not checked.
+  char* mapped = static_cast<char*>(in_->data());
+  if (mapped != nullptr && stat.m_method == 0 &&
+      stat.m_comp_size == stat.m_uncomp_size) {
+    size_t offset = record_data_offset(*in_, stat.m_local_header_ofs);
+    TORCH_CHECK(
+        offset + stat.m_uncomp_size <= in_->size(),
+        "PytorchStreamReader failed reading file ",
+        name,
+        ": record extends past the end of the archive");
+    auto ctx = new std::shared_ptr<ReadAdapterInterface>(in_);
+    at::DataPtr retval(
+        mapped + offset, ctx, &deleteMappedRecord, at::DeviceType::CPU);
+    return std::make_tuple(std::move(retval), stat.m_uncomp_size);
+  }
+
   at::DataPtr retval = c10::GetCPUAllocator()->allocate(stat.m_uncomp_size);
-  mz_zip_reader_extract_to_mem(ar_.get(), key, retval.get(), stat.m_uncomp_size, 0);
-  valid("reading file ", name.c_str());
+  if (stat.m_method != MZ_DEFLATED ||
+      !readCompressedChunks(*in_, stat, retval.get(), name)) {
+    mz_zip_reader_extract_to_mem(
+        ar_.get(), key, retval.get(), stat.m_uncomp_size, 0);
+    valid("reading file ", name.c_str());
+  }
 
   return std::make_tuple(std::move(retval), stat.m_uncomp_size);
 }
 
-static int64_t read_le_16(uint8_t* buf) {
-  return buf[0] + (buf[1] << 8);
+// Runs of prefetched records are read with a single read as long as they are
+// at most this large, a larger record is read on its own.
+constexpr size_t kMaxPrefetchRunSize = 64 * 1024 * 1024;
+// largest gap between two records of a run, e.g. a record that isn't
+// prefetched
+constexpr size_t kMaxPrefetchGap = 64 * 1024;
+// upper bound of the header of a record, whose extra field is only known once
+// it's read
+constexpr size_t kMaxLocalHeaderSize = MZ_ZIP_LOCAL_DIR_HEADER_SIZE +
+    MZ_ZIP_MAX_ARCHIVE_FILENAME_SIZE + 0xFFFF;
+
+static void deletePrefetchedRecord(void* ctx) {
+  delete static_cast<std::shared_ptr<at::DataPtr>*>(ctx);
+}
+
+void PyTorchStreamReader::prefetchRecords(
+    const std::vector<std::string>& names,
+    c10::Allocator* allocator) {
+  if (in_->data() != nullptr) {
+    return;
+  }
+  if (allocator == nullptr) {
+    allocator = c10::GetCPUAllocator();
+  }
+
+  struct Record {
+    const std::string* name;
+    size_t key;
+    mz_zip_archive_file_stat stat;
+  };
+  std::vector<Record> stored;
+  std::vector<Record> compressed;
+  for (const std::string& name : names) {
+    if (prefetched_.count(name)) {
+      continue;
+    }
+    Record record{&name, getRecordID(name), {}};
+    mz_zip_reader_file_stat(ar_.get(), record.key, &record.stat);
+    valid("retrieving file meta-data for ", name.c_str());
+    if (record.stat.m_method == 0 &&
+        record.stat.m_comp_size == record.stat.m_uncomp_size) {
+      stored.push_back(record);
+    } else {
+      compressed.push_back(record);
+    }
+  }
+  auto by_offset = [](const Record& a, const Record& b) {
+    return a.stat.m_local_header_ofs < b.stat.m_local_header_ofs;
+  };
+  std::sort(stored.begin(), stored.end(), by_offset);
+  std::sort(compressed.begin(), compressed.end(), by_offset);
+
+  for (size_t begin = 0, end = 0; begin < stored.size(); begin = end) {
+    // Starts the read at the alignment of the record data before the first
+    // header, so that the data of the records remains aligned in memory.
+    const size_t run_start =
+        stored[begin].stat.m_local_header_ofs / detail::kFieldAlignment *
+        detail::kFieldAlignment;
+    size_t run_end = 0;
+    for (end = begin; end < stored.size(); end++) {
+      const auto& stat = stored[end].stat;
+      const size_t record_end = std::min<size_t>(
+          in_->size(),
+          stat.m_local_header_ofs + kMaxLocalHeaderSize + stat.m_comp_size);
+      if (end > begin &&
+          (record_end - run_start > kMaxPrefetchRunSize ||
+           stat.m_local_header_ofs > run_end + kMaxPrefetchGap)) {
+        break;
+      }
+      run_end = record_end;
+    }
+
+    auto run = std::make_shared<at::DataPtr>(
+        allocator->allocate(run_end - run_start));
+    char* data = static_cast<char*>(run->get());
+    const size_t run_size = in_->read(
+        run_start, data, run_end - run_start, "reading prefetched records");
+    for (size_t i = begin; i < end; i++) {
+      const std::string& name = *stored[i].name;
+      const auto& stat = stored[i].stat;
+      const size_t header = stat.m_local_header_ofs - run_start;
+      auto local_header = reinterpret_cast<uint8_t*>(data + header);
+      TORCH_CHECK(
+          header + MZ_ZIP_LOCAL_DIR_HEADER_SIZE <= run_size &&
+              MZ_READ_LE32(local_header) == MZ_ZIP_LOCAL_DIR_HEADER_SIG,
+          "PytorchStreamReader failed reading file ",
+          name,
+          ": invalid header");
+      const size_t offset = header + MZ_ZIP_LOCAL_DIR_HEADER_SIZE +
+          read_le_16(local_header + MZ_ZIP_LDH_FILENAME_LEN_OFS) +
+          read_le_16(local_header + MZ_ZIP_LDH_EXTRA_LEN_OFS);
+      TORCH_CHECK(
+          offset + stat.m_uncomp_size <= run_size,
+          "PytorchStreamReader failed reading file ",
+          name,
+          ": record extends past the end of the archive");
+      TORCH_CHECK(
+          mz_crc32(
+              MZ_CRC32_INIT,
+              reinterpret_cast<const uint8_t*>(data + offset),
+              stat.m_uncomp_size) == stat.m_crc32,
+          "PytorchStreamReader failed reading file ",
+          name,
+          ": CRC-32 check failed");
+      at::DataPtr record(
+          data + offset,
+          new std::shared_ptr<at::DataPtr>(run),
+          &deletePrefetchedRecord,
+          run->device());
+      prefetched_.emplace(
+          name, std::make_tuple(std::move(record), stat.m_uncomp_size));
+    }
+  }
+
+  for (const Record& record : compressed) {
+    at::DataPtr data = allocator->allocate(record.stat.m_uncomp_size);
+    if (record.stat.m_method != MZ_DEFLATED ||
+        !readCompressedChunks(*in_, record.stat, data.get(), *record.name)) {
+      mz_zip_reader_extract_to_mem(
+          ar_.get(), record.key, data.get(), record.stat.m_uncomp_size, 0);
+      valid("reading file ", record.name->c_str());
+    }
+    prefetched_.emplace(
+        *record.name,
+        std::make_tuple(std::move(data), record.stat.m_uncomp_size));
+  }
 }
 
 size_t PyTorchStreamReader::getRecordOffset(const std::string& name) {
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), getRecordID(name), &stat);
   valid("retrieving file meta-data for ", name.c_str());
-  uint8_t local_header[MZ_ZIP_LOCAL_DIR_HEADER_SIZE];
-  in_->read(
-      stat.m_local_header_ofs,
-      local_header,
-      MZ_ZIP_LOCAL_DIR_HEADER_SIZE,
-      "reading file header");
-  size_t filename_len = read_le_16(local_header + MZ_ZIP_LDH_FILENAME_LEN_OFS);
-  size_t extra_len = read_le_16(local_header + MZ_ZIP_LDH_EXTRA_LEN_OFS);
-  return stat.m_local_header_ofs + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + filename_len + extra_len;
+  return record_data_offset(*in_, stat.m_local_header_ofs);
 }
 
 
@@ -324,17 +681,131 @@ void PyTorchStreamWriter::setMinVersion(const uint64_t version) {
   version_ = std::max(version, version_);
 }
 
+void PyTorchStreamWriter::setCompressionLevel(int level) {
+  TORCH_CHECK(
+      level >= 0 && level <= MZ_BEST_COMPRESSION,
+      "compression level must be between 0 and ",
+      MZ_BEST_COMPRESSION,
+      ", got ",
+      level);
+  compression_level_ = level;
+}
+
+static mz_bool appendCompressedChunk(const void* buf, int len, void* user) {
+  auto chunk = static_cast<std::vector<uint8_t>*>(user);
+  auto bytes = static_cast<const uint8_t*>(buf);
+  chunk->insert(chunk->end(), bytes, bytes + len);
+  return MZ_TRUE;
+}
+
+// See Note [Compressed records]
+bool PyTorchStreamWriter::writeCompressedRecord(
+    const std::string& full_name,
+    const void* data,
+    size_t size,
+    size_t element_size) {
+  if (element_size == 0 || size % element_size != 0) {
+    element_size = 1;
+  }
+  size_t chunk_size =
+      std::max<size_t>(detail::kCompressedChunkSize / element_size, 1) *
+      element_size;
+  if ((size + chunk_size - 1) / chunk_size > kMaxCompressedChunks) {
+    chunk_size = (size + kMaxCompressedChunks - 1) / kMaxCompressedChunks;
+    chunk_size = (chunk_size + element_size - 1) / element_size * element_size;
+  }
+  if (chunk_size > MZ_UINT32_MAX) {
+    return false;
+  }
+  const size_t num_chunks = (size + chunk_size - 1) / chunk_size;
+
+  auto src = static_cast<const uint8_t*>(data);
+  std::vector<std::vector<uint8_t>> chunks(num_chunks);
+  const mz_uint flags = tdefl_create_comp_flags_from_zip_params(
+      compression_level_, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    std::unique_ptr<tdefl_compressor> compressor(new tdefl_compressor);
+    std::vector<uint8_t> shuffled;
+    for (int64_t i = begin; i < end; i++) {
+      const size_t offset = i * chunk_size;
+      const size_t len = std::min(chunk_size, size - offset);
+      const bool last = static_cast<size_t>(i) + 1 == num_chunks;
+      const uint8_t* chunk = src + offset;
+      if (element_size > 1) {
+        shuffled.resize(len);
+        shuffle_bytes(chunk, shuffled.data(), len, element_size, false);
+        chunk = shuffled.data();
+      }
+      const tdefl_status init_status = tdefl_init(
+          compressor.get(), appendCompressedChunk, &chunks[i], flags);
+      const tdefl_status status = tdefl_compress_buffer(
+          compressor.get(),
+          chunk,
+          len,
+          last ? TDEFL_FINISH : TDEFL_FULL_FLUSH);
+      TORCH_CHECK(
+          init_status == TDEFL_STATUS_OKAY &&
+              status == (last ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY),
+          "PytorchStreamWriter failed compressing file ",
+          full_name);
+    }
+  });
+
+  size_t comp_size = 0;
+  for (const auto& chunk : chunks) {
+    comp_size += chunk.size();
+  }
+  if (comp_size >= size) {
+    return false;
+  }
+  std::string extra(kCompressedTag, sizeof(kCompressedTag));
+  const size_t field_len = 8 + 4 * num_chunks;
+  extra.push_back(static_cast<char>(field_len));
+  extra.push_back(static_cast<char>(field_len >> 8));
+  write_le_32(extra, element_size);
+  write_le_32(extra, chunk_size);
+  std::vector<uint8_t> compressed;
+  compressed.reserve(comp_size);
+  for (const auto& chunk : chunks) {
+    write_le_32(extra, chunk.size());
+    compressed.insert(compressed.end(), chunk.begin(), chunk.end());
+  }
+  const uint32_t crc = chunked_crc32(src, size, chunk_size);
+
+  mz_zip_writer_add_mem_ex_v2(
+      ar_.get(),
+      full_name.c_str(),
+      compressed.data(),
+      compressed.size(),
+      nullptr,
+      0,
+      compression_level_ | MZ_ZIP_FLAG_COMPRESSED_DATA,
+      size,
+      crc,
+      nullptr,
+      extra.data(),
+      extra.size(),
+      nullptr,
+      0);
+  return true;
+}
+
 void PyTorchStreamWriter::writeRecord(
     const std::string& name,
     const void* data,
     size_t size,
-    bool compress) {
+    bool compress,
+    size_t element_size) {
   AT_ASSERT(!finalized_);
   AT_ASSERT(!archive_name_plus_slash_.empty());
   std::string full_name = archive_name_plus_slash_ + name;
+  if (compress && compression_level_ > 0 && size > 0 &&
+      writeCompressedRecord(full_name, data, size, element_size)) {
+    valid("writing file ", name.c_str());
+    return;
+  }
   size_t padding_size =
       detail::getPadding(ar_->m_archive_size, full_name.size(), size, padding_);
-  uint32_t flags = compress ? MZ_BEST_COMPRESSION : 0;
   mz_zip_writer_add_mem_ex_v2(
       ar_.get(),
       full_name.c_str(),
@@ -342,7 +813,7 @@ void PyTorchStreamWriter::writeRecord(
       size,
       nullptr,
       0,
-      flags,
+      0,
       0,
       0,
       nullptr,
@@ -6,6 +6,7 @@
 #include <fstream>
 #include <istream>
 #include <ostream>
+#include <unordered_map>
 
 #include <c10/core/Allocator.h>
 #include <c10/core/Backend.h>
@@ -40,10 +41,11 @@ typedef struct mz_zip_archive mz_zip_archive;
 //
 // The PyTorchStreamWriter also ensures additional useful properties for these
 // files
-// 1. All files are stored uncompressed.
-// 2. All files in the archive are aligned to 64 byte boundaries such that
-//    it is possible to mmap the entire file and get an aligned pointer to
-//    tensor data.
+// 1. All files are stored uncompressed unless writeRecord is asked to compress
+//    them, see Note [Compressed records].
+// 2. All uncompressed files in the archive are aligned to 64 byte boundaries
+//    such that it is possible to mmap the entire file and get an aligned
+//    pointer to tensor data.
 // 3. We universally write in ZIP64 format for consistency.
 
 // The PyTorchStreamReader also provides additional properties:
@@ -53,6 +55,12 @@ typedef struct mz_zip_archive mz_zip_archive;
 // 2. It provides a getRecordOffset function which returns the offset into the
 //    raw file where file data lives. If the file was written with
 //    PyTorchStreamWriter it is guaranteed to be 64 byte aligned.
+// 3. If it reads through an adapter that maps the archive in memory (see
+//    caffe2/serialize/mmap_file_adapter.h), getRecord returns uncompressed
+//    records as pointers into the mapping instead of copying them. Each
+//    such record keeps the mapping alive.
+// 4. It decompresses the chunks of the records compressed by
+//    PyTorchStreamWriter in parallel.
 
 // PyTorchReader/Writer handle checking the version number on the archive format
 // and ensure that all files are written to a archive_name directory so they
@@ -83,6 +91,27 @@ typedef struct mz_zip_archive mz_zip_archive;
 // serialized model is likely to change, so we store it as the last record, and
 // we don't need to move previous records when updating the model data.
 
+// Note [Compressed records]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+// A record written with compress = true is split into chunks of about
+// kCompressedChunkSize bytes, which are deflated independently of each other
+// and in parallel (at::parallel_for). Every chunk but the last ends with a full
+// flush, so that their concatenation is a single valid deflate stream and the
+// record can be read by any zip tool. The local extra field "TC" of the record
+// holds the element size and the chunk size of the record followed by the
+// compressed size of each chunk, which lets PyTorchStreamReader inflate the
+// chunks in parallel as well.
+//
+// When the element size is larger than 1, the bytes of each chunk are
+// shuffled into byte planes before deflating it, i.e. the first bytes of all
+// of the elements come first, then their second bytes and so on. The high
+// bytes of floating point data are much more alike than the elements
+// themselves, which deflate takes advantage of. Records whose compressed size
+// wouldn't be smaller than their size are stored uncompressed.
+//
+// Compressed records are neither aligned nor mmap-able, which is why the
+// records are stored uncompressed by default.
+
 // The zip format is sufficiently flexible to handle the above use-case.
 // it puts its central directory at the end of the archive and we write
 // model.json as the last file when writing after we have accumulated all
@@ -100,6 +129,16 @@ class TORCH_API PyTorchStreamReader final {
   // return dataptr, size
   std::tuple<at::DataPtr, size_t> getRecord(const std::string& name);
   size_t getRecordOffset(const std::string& name);
+  // Reads the records of names ahead of the getRecord calls for them, in the
+  // order of their offsets in the archive. Each run of adjacent uncompressed
+  // records is read with a single read into memory from allocator (the CPU
+  // allocator by default), which the records of the run share and which is
+  // freed with the last of them. getRecord returns every prefetched record
+  // once. This is a no-op for mapped archives, whose records getRecord
+  // returns without copying.
+  void prefetchRecords(
+      const std::vector<std::string>& names,
+      c10::Allocator* allocator = nullptr);
   bool hasRecord(const std::string& name);
   std::vector<std::string> getAllRecords();
 
@@ -121,6 +160,8 @@ class TORCH_API PyTorchStreamReader final {
   std::string archive_name_plus_slash_;
   std::shared_ptr<ReadAdapterInterface> in_;
   int64_t version_;
+  std::unordered_map<std::string, std::tuple<at::DataPtr, size_t>>
+      prefetched_;
 };
 
 class TORCH_API PyTorchStreamWriter final {
@@ -130,12 +171,18 @@ class TORCH_API PyTorchStreamWriter final {
       const std::function<size_t(const void*, size_t)>& writer_func);
 
   void setMinVersion(const uint64_t version);
+  // The deflate level of the compressed records, from 1 (fastest) to 9
+  // (smallest), 9 by default. 0 stores them uncompressed.
+  void setCompressionLevel(int level);
 
+  // Writes data, an array of size / element_size elements of element_size
+  // bytes, see Note [Compressed records] for compress.
   void writeRecord(
       const std::string& name,
       const void* data,
       size_t size,
-      bool compress = false);
+      bool compress = false,
+      size_t element_size = 1);
   void writeEndOfFile();
 
   bool finalized() const {
@@ -151,7 +198,13 @@ class TORCH_API PyTorchStreamWriter final {
  private:
   void setup(const std::string& file_name);
   void valid(const char* what, const char* info = "");
+  bool writeCompressedRecord(
+      const std::string& full_name,
+      const void* data,
+      size_t size,
+      size_t element_size);
   size_t current_pos_ = 0;
+  int compression_level_ = 9;
   std::unique_ptr<mz_zip_archive> ar_;
   std::string archive_name_;
   std::string archive_name_plus_slash_;
@@ -171,6 +224,9 @@ class TORCH_API PyTorchStreamWriter final {
 namespace detail {
 // Writer-specific constants
 constexpr uint64_t kFieldAlignment = 64;
+// Compressed records are split into chunks of (about) this size, see
+// Note [Compressed records]
+constexpr size_t kCompressedChunkSize = 4 * 1024 * 1024;
 
 // Returns a record to be appended to the local user extra data entry in order
 // to make data beginning aligned at kFieldAlignment bytes boundary.
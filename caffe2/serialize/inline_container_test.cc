@@ -1,10 +1,16 @@
+#include <algorithm>
 #include <cstdio>
 #include <string>
 #include <array>
+#include <random>
+#include <sstream>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "caffe2/serialize/inline_container.h"
+#include "caffe2/serialize/mmap_file_adapter.h"
+#include "miniz.h"
 
 namespace caffe2 {
 namespace serialize {
@@ -63,6 +69,179 @@ TEST(PyTorchStreamWriterAndReader, SaveAndLoad) {
   ASSERT_EQ(memcmp(the_file.c_str() + off2, data2.data(), data2.size()), 0);
 }
 
+TEST(PyTorchStreamWriterAndReader, PrefetchRecords) {
+  std::ostringstream oss;
+  PyTorchStreamWriter writer([&](const void* b, size_t n) -> size_t {
+    oss.write(static_cast<const char*>(b), n);
+    return oss ? n : 0;
+  });
+  std::vector<std::string> records;
+  for (int i = 0; i < 10; ++i) {
+    records.push_back(std::string(100 + i, 'a' + i));
+    writer.writeRecord(
+        "data/" + std::to_string(i),
+        records.back().data(),
+        records.back().size(),
+        /*compress=*/i == 3);
+  }
+  writer.writeRecord("code", "code", 4);
+  writer.writeEndOfFile();
+
+  std::istringstream iss(oss.str());
+  PyTorchStreamReader reader(&iss);
+  // in another order than the records are stored
+  reader.prefetchRecords({"data/7", "data/3", "data/0", "data/1", "data/9"});
+  for (int i = 0; i < 10; ++i) {
+    at::DataPtr data_ptr;
+    size_t size;
+    std::tie(data_ptr, size) = reader.getRecord("data/" + std::to_string(i));
+    ASSERT_EQ(size, records[i].size());
+    ASSERT_EQ(memcmp(data_ptr.get(), records[i].data(), size), 0);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(data_ptr.get()) % 64, 0);
+  }
+  // prefetched records are returned once, and then read again
+  at::DataPtr data_ptr;
+  size_t size;
+  std::tie(data_ptr, size) = reader.getRecord("data/7");
+  ASSERT_EQ(size, records[7].size());
+  ASSERT_EQ(memcmp(data_ptr.get(), records[7].data(), size), 0);
+}
+
+TEST(PyTorchStreamWriterAndReader, CompressedRecords) {
+  std::ostringstream oss;
+  PyTorchStreamWriter writer([&](const void* b, size_t n) -> size_t {
+    oss.write(static_cast<const char*>(b), n);
+    return oss ? n : 0;
+  });
+  writer.setCompressionLevel(1);
+  // several chunks, the last of which is shorter
+  std::vector<float> floats(detail::kCompressedChunkSize / 2 + 1000);
+  for (size_t i = 0; i < floats.size(); ++i) {
+    floats[i] = static_cast<float>(i % 1000) / 7;
+  }
+  const size_t float_bytes = floats.size() * sizeof(float);
+  writer.writeRecord(
+      "floats", floats.data(), float_bytes, /*compress=*/true, sizeof(float));
+  std::string text(3 * detail::kCompressedChunkSize, 'z');
+  writer.writeRecord("text", text.data(), text.size(), /*compress=*/true);
+  // stored as is, since it doesn't compress
+  std::mt19937 generator(0);
+  std::vector<char> noise(1000);
+  for (size_t i = 0; i < noise.size(); ++i) {
+    noise[i] = static_cast<char>(generator());
+  }
+  writer.writeRecord("noise", noise.data(), noise.size(), /*compress=*/true);
+  writer.writeEndOfFile();
+
+  std::string the_file = oss.str();
+  ASSERT_LT(the_file.size(), float_bytes / 2);
+  std::istringstream iss(the_file);
+  PyTorchStreamReader reader(&iss);
+  at::DataPtr data_ptr;
+  size_t size;
+  std::tie(data_ptr, size) = reader.getRecord("floats");
+  ASSERT_EQ(size, float_bytes);
+  ASSERT_EQ(memcmp(data_ptr.get(), floats.data(), size), 0);
+
+  reader.prefetchRecords({"text", "noise"});
+  std::tie(data_ptr, size) = reader.getRecord("text");
+  ASSERT_EQ(size, text.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), text.data(), size), 0);
+  std::tie(data_ptr, size) = reader.getRecord("noise");
+  ASSERT_EQ(size, noise.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), noise.data(), size), 0);
+  ASSERT_EQ(reader.getRecordOffset("noise") % 64, 0);
+}
+
+TEST(PyTorchStreamWriterAndReader, LargeRecords) {
+  // checksummed in parallel, by several chunks the last of which is shorter
+  std::vector<uint8_t> data(10 * 1024 * 1024 + 1000);
+  std::mt19937 generator(0);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(generator());
+  }
+  mz_ulong crc = MZ_CRC32_INIT;
+  for (size_t offset = 0; offset < data.size(); offset += 1000) {
+    crc = mz_crc32(
+        crc, data.data() + offset, std::min<size_t>(1000, data.size() - offset));
+  }
+  ASSERT_EQ(mz_crc32(MZ_CRC32_INIT, data.data(), data.size()), crc);
+  // continuing the CRC-32 of the previous data
+  const size_t half = data.size() / 2;
+  ASSERT_EQ(
+      mz_crc32(
+          mz_crc32(MZ_CRC32_INIT, data.data(), half),
+          data.data() + half,
+          data.size() - half),
+      crc);
+
+  std::ostringstream oss;
+  PyTorchStreamWriter writer([&](const void* b, size_t n) -> size_t {
+    oss.write(static_cast<const char*>(b), n);
+    return oss ? n : 0;
+  });
+  writer.writeRecord("data", data.data(), data.size());
+  writer.writeEndOfFile();
+
+  // the reader checks the CRC-32 of the record
+  std::istringstream iss(oss.str());
+  PyTorchStreamReader reader(&iss);
+  at::DataPtr data_ptr;
+  size_t size;
+  std::tie(data_ptr, size) = reader.getRecord("data");
+  ASSERT_EQ(size, data.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), data.data(), size), 0);
+}
+
+#ifndef _WIN32
+TEST(PyTorchStreamWriterAndReader, LoadFromMappedFile) {
+  const std::string file_name = "mapped_output.zip";
+  std::array<char, 127> data1;
+  for (int i = 0; i < data1.size(); ++i) {
+    data1[i] = data1.size() - i;
+  }
+  std::string data2(1000, 'x');
+  {
+    PyTorchStreamWriter writer(file_name);
+    writer.writeRecord("key1", data1.data(), data1.size());
+    writer.writeRecord("key2", data2.data(), data2.size(), /*compress=*/true);
+    writer.writeEndOfFile();
+  }
+
+  auto adapter = std::make_shared<MmapFileAdapter>(file_name);
+  auto mapped = static_cast<char*>(adapter->data());
+  ASSERT_NE(mapped, nullptr);
+
+  at::DataPtr data_ptr;
+  int64_t size;
+  {
+    PyTorchStreamReader reader(adapter);
+    // uncompressed records alias the mapping
+    std::tie(data_ptr, size) = reader.getRecord("key1");
+    ASSERT_EQ(size, data1.size());
+    ASSERT_EQ(data_ptr.get(), mapped + reader.getRecordOffset("key1"));
+
+    // compressed records are copied
+    at::DataPtr compressed_ptr;
+    std::tie(compressed_ptr, size) = reader.getRecord("key2");
+    ASSERT_EQ(size, data2.size());
+    ASSERT_EQ(memcmp(compressed_ptr.get(), data2.data(), data2.size()), 0);
+  }
+  adapter.reset();
+
+  // the record keeps the mapping alive, and writing to it doesn't touch the file
+  ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+  static_cast<char*>(data_ptr.get())[0] = 0;
+  data_ptr.clear();
+  PyTorchStreamReader reader(std::make_shared<MmapFileAdapter>(file_name));
+  std::tie(data_ptr, size) = reader.getRecord("key1");
+  ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+  data_ptr.clear();
+
+  std::remove(file_name.c_str());
+}
+#endif
+
 } // namespace
 } // namespace serialize
 } // namespace caffe2
@@ -0,0 +1,88 @@
+#include "caffe2/serialize/mmap_file_adapter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <c10/util/Exception.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace caffe2 {
+namespace serialize {
+
+#ifndef _WIN32
+
+MmapFileAdapter::MmapFileAdapter(const std::string& file_name) {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd == -1) {
+    AT_ERROR(
+        "open file failed, file path: ", file_name, ": ", strerror(errno));
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1) {
+    int err = errno;
+    close(fd);
+    AT_ERROR("fstat failed, file path: ", file_name, ": ", strerror(err));
+  }
+  size_ = file_stat.st_size;
+  if (size_ > 0) {
+    // MAP_PRIVATE gives copy-on-write pages, so records can be handed out as
+    // writable storages without ever touching the file.
+    void* base =
+        mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED) {
+      int err = errno;
+      close(fd);
+      AT_ERROR("mmap failed, file path: ", file_name, ": ", strerror(err));
+    }
+    base_ = base;
+  }
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+}
+
+MmapFileAdapter::~MmapFileAdapter() {
+  if (base_ != nullptr) {
+    munmap(base_, size_);
+  }
+}
+
+#else // _WIN32
+
+MmapFileAdapter::MmapFileAdapter(const std::string& file_name) {
+  AT_ERROR(
+      "MmapFileAdapter is not supported on Windows, use FileAdapter instead. "
+      "File path: ",
+      file_name);
+}
+
+MmapFileAdapter::~MmapFileAdapter() {}
+
+#endif // _WIN32
+
+size_t MmapFileAdapter::size() const {
+  return size_;
+}
+
+size_t MmapFileAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
+    const {
+  if (pos >= size_) {
+    return 0;
+  }
+  n = std::min<size_t>(n, size_ - pos);
+  memcpy(buf, static_cast<char*>(base_) + pos, n);
+  return n;
+}
+
+void* MmapFileAdapter::data() const {
+  return base_;
+}
+
+} // namespace serialize
+} // namespace caffe2
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+
+#include "c10/macros/Macros.h"
+#include "caffe2/serialize/read_adapter_interface.h"
+
+namespace caffe2 {
+namespace serialize {
+
+// Maps the whole file into memory. PyTorchStreamReader returns records that
+// are stored uncompressed as pointers into the mapping instead of copies, and
+// every such record keeps the mapping alive. Pages are mapped copy-on-write,
+// so writing to a record never modifies the file, and unmodified pages are
+// shared through the page cache with every process that maps the same file.
+//
+// The file must not be truncated or rewritten while records alias it.
+//
+// E.g. torch::jit::load(std::make_shared<MmapFileAdapter>(file_name)) loads a
+// module whose CPU tensors alias the mapped file.
+class TORCH_API MmapFileAdapter final : public ReadAdapterInterface {
+ public:
+  C10_DISABLE_COPY_AND_ASSIGN(MmapFileAdapter);
+  explicit MmapFileAdapter(const std::string& file_name);
+  size_t size() const override;
+  size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
+      const override;
+  void* data() const override;
+  ~MmapFileAdapter();
+
+ private:
+  void* base_ = nullptr;
+  size_t size_ = 0;
+};
+
+} // namespace serialize
+} // namespace caffe2
@@ -16,6 +16,12 @@ class TORCH_API ReadAdapterInterface {
   virtual size_t size() const = 0;
   virtual size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
       const = 0;
+  // Returns the whole content if the adapter keeps it in (writable) memory,
+  // nullptr otherwise. PyTorchStreamReader returns uncompressed records as
+  // pointers into this memory instead of copies.
+  virtual void* data() const {
+    return nullptr;
+  }
   virtual ~ReadAdapterInterface();
 };
 
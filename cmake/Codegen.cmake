@@ -106,10 +106,23 @@ if(INTERN_BUILD_ATEN_OPS)
     if(MSVC)
       list(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG}/arch:AVX2")
     else(MSVC)
-      list(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG} -mavx2 -mfma ${CPU_NO_AVX256_SPLIT_FLAGS}")
+      list(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG} -mavx2 -mfma -mf16c ${CPU_NO_AVX256_SPLIT_FLAGS}")
     endif(MSVC)
   endif(CXX_AVX2_FOUND)
 
+  # The AVX512 kernels are also compiled with CPU_CAPABILITY_AVX2 (see
+  # EXTRA_FLAGS below), so that the Vec256 code they share with the AVX2
+  # kernels keeps its vectorized paths.
+  if(CXX_AVX512_FOUND)
+    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DHAVE_AVX512_CPU_DEFINITION")
+    list(APPEND CPU_CAPABILITY_NAMES "AVX512")
+    if(MSVC)
+      list(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG}/arch:AVX512")
+    else(MSVC)
+      list(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG} -mavx512f -mavx512dq -mavx512vl -mavx512bw -mfma -mf16c")
+    endif(MSVC)
+  endif(CXX_AVX512_FOUND)
+
   if(CXX_VSX_FOUND)
     SET(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DHAVE_VSX_CPU_DEFINITION")
     LIST(APPEND CPU_CAPABILITY_NAMES "VSX")
@@ -134,6 +147,13 @@ if(INTERN_BUILD_ATEN_OPS)
       else(MSVC)
         set(EXTRA_FLAGS "-DCPU_CAPABILITY=${CPU_CAPABILITY} -DCPU_CAPABILITY_${CPU_CAPABILITY}")
       endif(MSVC)
+      if("${CPU_CAPABILITY}" STREQUAL "AVX512")
+        if(MSVC)
+          set(EXTRA_FLAGS "${EXTRA_FLAGS} /DCPU_CAPABILITY_AVX2")
+        else(MSVC)
+          set(EXTRA_FLAGS "${EXTRA_FLAGS} -DCPU_CAPABILITY_AVX2")
+        endif(MSVC)
+      endif()
       # Disable certain warnings for GCC-9.X
       if(CMAKE_COMPILER_IS_GNUCXX AND (CMAKE_CXX_COMPILER_VERSION VERSION_GREATER 9.0.0))
         if(("${NAME}" STREQUAL "native/cpu/GridSamplerKernel.cpp") AND ("${CPU_CAPABILITY}" STREQUAL "DEFAULT"))
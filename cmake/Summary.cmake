@@ -24,6 +24,7 @@ function(caffe2_print_configuration_summary)
   message(STATUS "  BUILD_CAFFE2_MOBILE   : ${BUILD_CAFFE2_MOBILE}")
   message(STATUS "  BUILD_STATIC_RUNTIME_BENCHMARK: ${BUILD_STATIC_RUNTIME_BENCHMARK}")
   message(STATUS "  BUILD_TENSOREXPR_BENCHMARK: ${BUILD_TENSOREXPR_BENCHMARK}")
+  message(STATUS "  BUILD_OPERATOR_BENCHMARK: ${BUILD_OPERATOR_BENCHMARK}")
   message(STATUS "  BUILD_BINARY          : ${BUILD_BINARY}")
   message(STATUS "  BUILD_CUSTOM_PROTOBUF : ${BUILD_CUSTOM_PROTOBUF}")
   if(${CAFFE2_LINK_LOCAL_PROTOBUF})
@@ -134,6 +135,7 @@ function(caffe2_print_configuration_summary)
   message(STATUS "  USE_NUMPY             : ${USE_NUMPY}")
   message(STATUS "  USE_OBSERVERS         : ${USE_OBSERVERS}")
   message(STATUS "  USE_OPENCL            : ${USE_OPENCL}")
+  message(STATUS "  USE_OVERHEAD_PROBES   : ${USE_OVERHEAD_PROBES}")
   message(STATUS "  USE_OPENCV            : ${USE_OPENCV}")
   if(${USE_OPENCV})
     message(STATUS "    OpenCV version      : ${OpenCV_VERSION}")
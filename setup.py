@@ -158,6 +158,7 @@
 #     possible values:
 #       OMP - use OpenMP for intra-op and native backend for inter-op tasks
 #       NATIVE - use native thread pool for both intra- and inter-op tasks
+#       NATIVE_WORK_STEALING - like NATIVE, with a work-stealing intra-op scheduler
 #       TBB - using TBB for intra- and native thread pool for inter-op parallelism
 #
 #   USE_TBB
@@ -861,6 +862,7 @@ if __name__ == '__main__':
                 'include/ATen/*.h',
                 'include/ATen/cpu/*.h',
                 'include/ATen/cpu/vec256/*.h',
+                'include/ATen/cpu/vec512/*.h',
                 'include/ATen/core/*.h',
                 'include/ATen/cuda/*.cuh',
                 'include/ATen/cuda/*.h',
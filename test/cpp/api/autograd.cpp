@@ -2,6 +2,7 @@
 
 #include <torch/torch.h>
 
+#include <torch/csrc/autograd/checkpoint.h>
 #include <torch/csrc/autograd/functions/basic_ops.h>
 
 #include <test/cpp/api/support.h>
@@ -794,6 +795,69 @@ TEST(CustomAutogradTest, BackwardWithNonLeafInputs) {
   ASSERT_THROWS_WITH(w.backward(torch::ones({5, 5}), false, false, {z}), "is not a leaf Tensor");
 }
 
+TEST(CheckpointTest, Checkpoint) {
+  Variable x = torch::randn({4, 5}, torch::requires_grad());
+  Variable w = torch::randn({5, 3}, torch::requires_grad());
+  int calls = 0;
+  auto fn = [&](const variable_list& inputs) -> variable_list {
+    calls++;
+    return {inputs[0].mm(w).sigmoid().mul(2).tanh()};
+  };
+
+  auto expected = fn({x})[0];
+  auto expected_grads = torch::autograd::grad({expected.sum()}, {x, w});
+  calls = 0;
+  auto out = checkpoint(fn, {x})[0];
+  ASSERT_VARIABLE_EQ(out, expected);
+  ASSERT_EQ(calls, 1);
+  auto grads = torch::autograd::grad({out.sum()}, {x, w});
+  ASSERT_EQ(calls, 2);
+  ASSERT_VARIABLE_EQ(grads[0], expected_grads[0]);
+  ASSERT_VARIABLE_EQ(grads[1], expected_grads[1]);
+}
+
+TEST(CheckpointTest, Policy) {
+  Variable x = torch::randn({5, 5}, torch::requires_grad());
+  int calls = 0;
+  int ends = 0;
+  auto fn = [&](const variable_list& inputs) -> variable_list {
+    calls++;
+    auto a = inputs[0].sin();
+    auto b = a.cos();
+    ends++;
+    return {b};
+  };
+
+  // everything is kept
+  auto out = checkpoint(fn, {x}, [](const Variable&) { return true; })[0];
+  out.sum().backward();
+  ASSERT_EQ(calls, 1);
+  ASSERT_VARIABLE_EQ(x.grad(), -x.cos() * x.sin().sin());
+
+  // cos saves the output of sin, which is kept, so the recomputation of the
+  // input saved by sin stops before cos runs again
+  x.grad().zero_();
+  calls = ends = 0;
+  out = checkpoint(fn, {x}, keep_outputs_of({"SinBackward"}))[0];
+  out.sum().backward();
+  ASSERT_EQ(calls, 2);
+  ASSERT_EQ(ends, 1);
+  ASSERT_VARIABLE_EQ(x.grad(), -x.cos() * x.sin().sin());
+}
+
+TEST(CheckpointTest, ModifiedInput) {
+  Variable x = torch::randn({5, 5}, torch::requires_grad());
+  Variable y = x * 2;
+  auto out = checkpoint(
+      [](const variable_list& inputs) -> variable_list {
+        return {inputs[0].exp().sin()};
+      },
+      {y})[0];
+  y.add_(1);
+  ASSERT_THROWS_WITH(
+      out.sum().backward(), "modified by an inplace operation before");
+}
+
 // TODO add these tests if needed
 // test_once_differentiable
 // test_sparse_backward
@@ -688,6 +688,82 @@ TEST(DataTest, QueueClearEmptiesTheQueue) {
   ASSERT_THROWS_WITH(queue.pop(1 * kMillisecond), "Timeout");
 }
 
+TEST(DataTest, BoundedQueuePushAndPopFromSameThread) {
+  torch::data::detail::BoundedQueue<int> queue(4);
+  queue.push(1);
+  queue.push(2);
+  ASSERT_EQ(queue.pop(), 1);
+  ASSERT_EQ(queue.pop(), 2);
+}
+
+TEST(DataTest, BoundedQueueRoundsCapacityUpToPowerOfTwo) {
+  ASSERT_EQ(torch::data::detail::BoundedQueue<int>(0).capacity(), 2);
+  ASSERT_EQ(torch::data::detail::BoundedQueue<int>(5).capacity(), 8);
+  ASSERT_EQ(torch::data::detail::BoundedQueue<int>(16).capacity(), 16);
+}
+
+TEST(DataTest, BoundedQueuePopWithTimeoutThrowsUponTimeout) {
+  torch::data::detail::BoundedQueue<int> queue(4);
+  ASSERT_THROWS_WITH(
+      queue.pop(10 * kMillisecond),
+      "Timeout in DataLoader queue while waiting for next batch "
+      "(timeout was 10 ms)");
+}
+
+TEST(DataTest, BoundedQueuePushBlocksWhileFull) {
+  torch::data::detail::BoundedQueue<int> queue(2);
+  queue.push(0);
+  queue.push(1);
+  std::thread thread([&queue] {
+    std::this_thread::sleep_for(20 * kMillisecond);
+    ASSERT_EQ(queue.pop(), 0);
+  });
+  queue.push(2);
+  thread.join();
+  ASSERT_EQ(queue.pop(), 1);
+  ASSERT_EQ(queue.pop(), 2);
+}
+
+TEST(DataTest, BoundedQueueClearEmptiesTheQueue) {
+  torch::data::detail::BoundedQueue<int> queue(4);
+  queue.push(1);
+  queue.push(2);
+  queue.push(3);
+  ASSERT_EQ(queue.clear(), 3);
+  ASSERT_THROWS_WITH(queue.pop(1 * kMillisecond), "Timeout");
+}
+
+TEST(DataTest, BoundedQueueManyProducersAndConsumers) {
+  const int kThreads = 4;
+  const int kValuesPerThread = 10000;
+  torch::data::detail::BoundedQueue<int> queue(8);
+  std::vector<std::thread> producers;
+  std::vector<std::future<int64_t>> sums;
+  for (int t = 0; t < kThreads; ++t) {
+    producers.emplace_back([&queue, t] {
+      for (int i = 0; i < kValuesPerThread; ++i) {
+        queue.push(t * kValuesPerThread + i);
+      }
+    });
+    sums.push_back(std::async(std::launch::async, [&queue] {
+      int64_t sum = 0;
+      for (int i = 0; i < kValuesPerThread; ++i) {
+        sum += queue.pop();
+      }
+      return sum;
+    }));
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  int64_t total = 0;
+  for (auto& sum : sums) {
+    total += sum.get();
+  }
+  const int64_t n = kThreads * kValuesPerThread;
+  ASSERT_EQ(total, n * (n - 1) / 2);
+}
+
 TEST(DataTest, DataShuttleCanPushAndPopJob) {
   torch::data::detail::DataShuttle<int, int> shuttle;
   shuttle.push_job(1);
@@ -934,6 +1010,109 @@ TEST(DataTest, CanSaveAndLoadDistributedRandomSampler) {
   }
 }
 
+TEST(DataTest, DistributedStreamingRandomSamplerProduceCorrectSamples) {
+  const size_t sample_count = 103;
+  for (size_t block_size : {1, 4, 16}) {
+    for (size_t num_replicas : {1, 3}) {
+      std::vector<size_t> res;
+      for (size_t rank = 0; rank < num_replicas; ++rank) {
+        samplers::DistributedStreamingRandomSampler sampler(
+            sample_count, num_replicas, rank, /*allow_duplicates=*/true,
+            block_size);
+        torch::optional<std::vector<size_t>> idx;
+        while ((idx = sampler.next(5)).has_value()) {
+          res.insert(std::end(res), std::begin(*idx), std::end(*idx));
+        }
+      }
+      ASSERT_EQ(
+          res.size(),
+          (sample_count + num_replicas - 1) / num_replicas * num_replicas);
+      std::sort(res.begin(), res.end());
+      res.erase(std::unique(res.begin(), res.end()), res.end());
+      ASSERT_EQ(res.size(), sample_count);
+      ASSERT_EQ(res.back(), sample_count - 1);
+    }
+  }
+}
+
+TEST(DataTest, DistributedStreamingRandomSamplerShufflesByEpoch) {
+  samplers::DistributedStreamingRandomSampler a(100);
+  samplers::DistributedStreamingRandomSampler b(100);
+  auto first = a.next(100).value();
+  ASSERT_EQ(b.next(100).value(), first);
+  std::vector<size_t> sequential(100);
+  std::iota(sequential.begin(), sequential.end(), 0);
+  ASSERT_NE(first, sequential);
+
+  a.set_epoch(1);
+  a.reset();
+  ASSERT_NE(a.next(100).value(), first);
+}
+
+TEST(DataTest, DistributedStreamingRandomSamplerKeepsBlocksTogether) {
+  const size_t block_size = 8;
+  const size_t num_replicas = 2;
+  samplers::DistributedStreamingRandomSampler sampler(
+      64, num_replicas, /*rank=*/1, /*allow_duplicates=*/true, block_size);
+  auto res = sampler.next(32).value();
+  for (size_t i = 0; i < res.size(); ++i) {
+    ASSERT_EQ(
+        res[i] / block_size,
+        res[i - i % (block_size / num_replicas)] / block_size);
+  }
+}
+
+TEST(DataTest, CanResumeDistributedStreamingRandomSamplerWithOtherReplicas) {
+  const size_t sample_count = 60;
+  std::vector<size_t> res;
+  std::stringstream stream;
+  {
+    // two replicas draw 3 batches of 4 samples each
+    for (size_t rank = 0; rank < 2; ++rank) {
+      samplers::DistributedStreamingRandomSampler sampler(
+          sample_count, 2, rank, /*allow_duplicates=*/false);
+      sampler.set_epoch(2);
+      for (size_t i = 0; i < 3; ++i) {
+        auto idx = sampler.next(4).value();
+        res.insert(std::end(res), std::begin(idx), std::end(idx));
+      }
+      ASSERT_EQ(sampler.index(), 24);
+      if (rank == 0) {
+        torch::save(sampler, stream);
+      }
+    }
+  }
+  {
+    // three replicas draw the rest of the epoch, and the first one changes to
+    // a single replica halfway through
+    std::string saved = stream.str();
+    for (size_t rank = 0; rank < 3; ++rank) {
+      samplers::DistributedStreamingRandomSampler sampler(
+          sample_count, 3, rank, /*allow_duplicates=*/false);
+      std::stringstream rank_stream(saved);
+      torch::load(sampler, rank_stream);
+      ASSERT_EQ(sampler.epoch(), 2);
+      ASSERT_EQ(sampler.index(), 24);
+      auto idx = sampler.next(6).value();
+      res.insert(std::end(res), std::begin(idx), std::end(idx));
+      if (rank == 0) {
+        ASSERT_EQ(sampler.index(), 42);
+        sampler.set_replicas(1, 0);
+        torch::optional<std::vector<size_t>> rest;
+        while ((rest = sampler.next(5)).has_value()) {
+          res.insert(std::end(res), std::begin(*rest), std::end(*rest));
+        }
+        ASSERT_EQ(sampler.index(), sample_count);
+      }
+    }
+  }
+  ASSERT_EQ(res.size(), sample_count);
+  std::sort(res.begin(), res.end());
+  for (size_t i = 0; i < res.size(); ++i) {
+    ASSERT_EQ(res[i], i);
+  }
+}
+
 TEST(DataTest, DistributedSequentialSamplerSingleReplicaProduceCorrectSamples) {
   size_t sample_count = 10;
   size_t batch_size = 3;
@@ -1030,6 +1209,7 @@ TEST(DataLoaderTest, DataLoaderOptionsDefaultAsExpected) {
   ASSERT_EQ(full_options.max_jobs, 0);
   ASSERT_FALSE(full_options.timeout.has_value());
   ASSERT_TRUE(full_options.enforce_ordering);
+  ASSERT_FALSE(full_options.pin_memory);
 }
 
 TEST(DataLoaderTest, DataLoaderOptionsCoalesceOptionalValues) {
@@ -1039,6 +1219,66 @@ TEST(DataLoaderTest, DataLoaderOptionsCoalesceOptionalValues) {
   ASSERT_EQ(full_options.max_jobs, 2 * 10);
 }
 
+TEST(DataLoaderTest, DataLoaderOptionsMaxJobsFollowsPrefetchFactor) {
+  auto partial_options = DataLoaderOptions(32).workers(10).prefetch_factor(3);
+  ASSERT_EQ(FullDataLoaderOptions(partial_options).max_jobs, 3 * 10);
+  partial_options.max_jobs(7);
+  ASSERT_EQ(FullDataLoaderOptions(partial_options).max_jobs, 7);
+}
+
+TEST(DataLoaderTest, PinMemoryPinsBatches_CUDA) {
+  auto dataset = datasets::TensorDataset(torch::ones({8, 3}))
+                     .map(transforms::Stack<TensorExample>());
+  for (size_t workers : {0, 2}) {
+    auto data_loader = torch::data::make_data_loader(
+        dataset, DataLoaderOptions(2).workers(workers).pin_memory(true));
+    for (auto& batch : *data_loader) {
+      ASSERT_TRUE(batch.data.is_pinned());
+      ASSERT_TRUE(batch.data.equal(torch::ones({2, 3})));
+    }
+  }
+}
+
+TEST(DataLoaderTest, PinMemoryPacksBatch_CUDA) {
+  auto batch = transforms::PinMemory<std::vector<torch::Tensor>>().apply_batch(
+      {torch::arange(5), torch::ones({2, 3}, torch::kFloat64), torch::Tensor()});
+  ASSERT_TRUE(batch[0].is_pinned());
+  ASSERT_TRUE(batch[1].is_pinned());
+  ASSERT_FALSE(batch[2].defined());
+  ASSERT_TRUE(batch[0].equal(torch::arange(5)));
+  ASSERT_TRUE(batch[1].equal(torch::ones({2, 3}, torch::kFloat64)));
+  // one pinned buffer for the whole batch
+  ASSERT_TRUE(batch[0].storage().is_alias_of(batch[1].storage()));
+}
+
+TEST(DataLoaderTest, ToDeviceCopiesBatch_CUDA) {
+  auto dataset = datasets::TensorDataset(torch::arange(24).view({8, 3}))
+                     .map(transforms::Stack<TensorExample>())
+                     .map(transforms::ToDevice<TensorExample>(torch::kCUDA));
+  auto data_loader = torch::data::make_data_loader(
+      std::move(dataset), DataLoaderOptions(2).workers(2));
+  std::vector<torch::Tensor> batches;
+  for (auto& batch : *data_loader) {
+    ASSERT_TRUE(batch.data.is_cuda());
+    batches.push_back(batch.data.cpu());
+  }
+  ASSERT_TRUE(torch::cat(batches).equal(torch::arange(24).view({8, 3})));
+
+  Example<> example{torch::ones({4, 2}), torch::arange(4)};
+  auto copied = transforms::ToDevice<>(torch::kCUDA).apply_batch(example);
+  ASSERT_TRUE(copied.data.is_cuda());
+  ASSERT_TRUE(copied.data.storage().is_alias_of(copied.target.storage()));
+  ASSERT_TRUE(copied.data.cpu().equal(example.data));
+  ASSERT_TRUE(copied.target.cpu().equal(example.target));
+}
+
+TEST(DataLoaderTest, ToDeviceLeavesCPUBatchesAlone) {
+  Example<> example{torch::ones({4, 2}), torch::arange(4)};
+  auto batch = transforms::ToDevice<>(torch::kCPU).apply_batch(example);
+  ASSERT_TRUE(batch.data.is_same(example.data));
+  ASSERT_TRUE(batch.target.is_same(example.target));
+}
+
 TEST(DataLoaderTest, MakeDataLoaderDefaultsAsExpected) {
   auto data_loader = torch::data::make_data_loader(
       DummyDataset().map(transforms::Lambda<int>([](int x) { return x + 1; })));
@@ -1690,6 +1930,64 @@ TEST(DataLoaderTest, ChunkDataSetGetBatch) {
   }
 }
 
+// chunk data reader with 3 chunks of 10 scalar tensors each, counting up from
+// 0.
+struct TensorChunkDataReader
+    : public datasets::ChunkDataReader<torch::Tensor> {
+ public:
+  using BatchType = datasets::ChunkDataReader<torch::Tensor>::ChunkType;
+
+  BatchType read_chunk(size_t chunk_index) override {
+    BatchType batch_data;
+    for (size_t i = 0; i < chunk_size_; ++i) {
+      batch_data.push_back(torch::tensor(
+          static_cast<int64_t>(chunk_index * chunk_size_ + i), torch::kLong));
+    }
+    return batch_data;
+  }
+
+  size_t chunk_count() override {
+    return chunk_count_;
+  };
+
+  void reset() override{};
+
+  const static size_t chunk_count_ = 3;
+  const static size_t chunk_size_ = 10;
+};
+
+TEST(DataLoaderTest, ChunkDataSetPrefetchesToDevice_CUDA) {
+  const size_t batch_size = 5;
+  samplers::SequentialSampler sampler(0);
+  datasets::ChunkDataset<
+      TensorChunkDataReader,
+      samplers::SequentialSampler,
+      samplers::SequentialSampler>
+      dataset(
+          TensorChunkDataReader(),
+          sampler,
+          sampler,
+          datasets::ChunkDatasetOptions(1, batch_size)
+              .device(torch::Device(torch::kCUDA, 0))
+              .device_prefetch_count(2));
+
+  // test functionality across epoch boundary
+  for (int epoch_index = 0; epoch_index < 2; ++epoch_index) {
+    dataset.reset();
+    int64_t expected = 0;
+    while (auto batch = dataset.get_batch(batch_size)) {
+      ASSERT_EQ(batch->size(), batch_size);
+      for (auto& tensor : *batch) {
+        ASSERT_TRUE(tensor.is_cuda());
+        ASSERT_EQ(tensor.item<int64_t>(), expected++);
+      }
+    }
+    ASSERT_EQ(expected, 30);
+    // Exhausted datasets keep returning no batch.
+    ASSERT_FALSE(dataset.get_batch(batch_size).has_value());
+  }
+}
+
 TEST(DataLoaderTest, ChunkDataSetWithBatchSizeMismatch) {
   const size_t prefetch_count = 1;
   const size_t batch_size = 5;
@@ -595,8 +595,8 @@ struct ParameterTestModule : Module {
 
 TEST_F(ModuleTest, HasCorrectNumberOfParameters) {
   ParameterTestModule module;
-  ASSERT_EQ(module.parameters().size(), 3);
-  ASSERT_EQ(module.named_parameters().size(), 3);
+  ASSERT_EQ(module.parameters().size(), 3u);
+  ASSERT_EQ(module.named_parameters().size(), 3u);
 }
 
 TEST_F(ModuleTest, ContainsParametersWithTheCorrectName) {
@@ -1015,3 +1015,83 @@ TEST_F(ModuleTest, CanCallForwardOnNonTensorForwardThroughPimpl) {
   ModuleWithNonTensorForward m;
   ASSERT_EQ(m(torch::ones(123)), 123);
 }
+
+TEST_F(ModuleTest, RecursiveParametersFollowRegistrations) {
+  torch::nn::Sequential model(torch::nn::Linear(3, 4));
+  ASSERT_EQ(model->parameters().size(), 2u);
+  ASSERT_EQ(model->parameters()[0].data_ptr(), model[0]->as<Linear>()->weight.data_ptr());
+
+  // registered in a submodule, which the cache of the container can't see
+  model[0]->as<Linear>()->register_buffer("scale", torch::ones(1));
+  model[0]->as<Linear>()->register_parameter("extra", torch::ones(2));
+  ASSERT_EQ(model->parameters().size(), 3u);
+  ASSERT_TRUE(model->named_parameters().contains("0.extra"));
+  ASSERT_TRUE(model->named_buffers().contains("0.scale"));
+
+  model->push_back(torch::nn::Linear(4, 5));
+  ASSERT_EQ(model->parameters().size(), 5u);
+
+  auto root = std::make_shared<torch::nn::Module>();
+  root->register_module("model", model);
+  ASSERT_EQ(root->parameters().size(), 5u);
+  torch::nn::ParameterDict dict;
+  root->register_module("dict", dict);
+  dict->insert("a", torch::ones(1));
+  ASSERT_EQ(root->parameters().size(), 6u);
+  dict->pop("a");
+  ASSERT_EQ(root->parameters().size(), 5u);
+  root->unregister_module("model");
+  ASSERT_TRUE(root->parameters().empty());
+
+  auto copy = std::dynamic_pointer_cast<torch::nn::SequentialImpl>(model->clone());
+  const auto parameters = model->parameters();
+  const auto copy_parameters = copy->parameters();
+  ASSERT_EQ(copy_parameters.size(), parameters.size());
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    ASSERT_NE(copy_parameters[i].data_ptr(), parameters[i].data_ptr());
+  }
+}
+
+TEST_F(ModuleTest, FlattenParameterStorage) {
+  torch::nn::Sequential model(
+      torch::nn::Linear(3, 4), torch::nn::ReLU(), torch::nn::Linear(4, 2));
+  const auto input = torch::randn({5, 3});
+  const auto expected = model->forward(input);
+  const auto parameters = model->parameters();
+  const auto values = torch::nn::utils::parameters_to_vector(parameters);
+
+  const auto buffers = model->flatten_parameter_storage();
+  ASSERT_EQ(buffers.size(), 1u);
+  const auto& buffer = buffers[0];
+  ASSERT_TRUE(torch::equal(buffer, values));
+  ASSERT_TRUE(torch::allclose(model->forward(input), expected));
+  int64_t offset = 0;
+  for (const auto& parameter : model->parameters()) {
+    ASSERT_EQ(
+        parameter.data_ptr(),
+        static_cast<char*>(buffer.data_ptr()) + offset * buffer.element_size());
+    offset += parameter.numel();
+  }
+
+  // the gradients accumulate into the gradient buffer
+  model->forward(input).sum().backward();
+  model->forward(input).sum().backward();
+  std::vector<torch::Tensor> grads;
+  for (const auto& parameter : model->parameters()) {
+    ASSERT_TRUE(parameter.requires_grad());
+    grads.push_back(parameter.grad().view(-1));
+  }
+  ASSERT_TRUE(torch::equal(buffer.grad(), torch::cat(grads)));
+  ASSERT_GT(buffer.grad().abs().sum().item<float>(), 0);
+
+  // an optimizer sweeps all the parameters at once
+  torch::optim::SGD optimizer(buffers, /*lr=*/0.1);
+  const auto before = buffer.clone();
+  optimizer.step();
+  ASSERT_TRUE(torch::allclose(buffer, before - 0.1 * buffer.grad()));
+  ASSERT_TRUE(torch::equal(
+      torch::nn::utils::parameters_to_vector(model->parameters()), buffer));
+
+  model->zero_grad();
+  ASSERT_EQ(buffer.grad().abs().sum().item<float>(), 0);
+}
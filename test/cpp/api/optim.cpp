@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <torch/torch.h>
+#include <torch/csrc/autograd/functions/accumulate_grad.h>
 
 #include <test/cpp/api/optim_baseline.h>
 #include <test/cpp/api/support.h>
@@ -373,6 +374,50 @@ TEST(OptimTest, ProducesPyTorchValues_SGDWithWeightDecayAndNesterovMomentum) {
       expected_parameters::SGD_with_weight_decay_and_nesterov_momentum());
 }
 
+// Checks that the fused CUDA steps produce the values of the CPU steps
+template <typename OptimizerClass, typename Options>
+void check_cuda_matches_cpu(Options options) {
+  torch::manual_seed(0);
+  std::vector<torch::Tensor> cpu_parameters = {
+      torch::randn({3, 5}, torch::kFloat64),
+      torch::randn({70000}, torch::kFloat64),
+      torch::randn({4, 4}, torch::kFloat64).t()};
+  std::vector<torch::Tensor> cuda_parameters;
+  for (auto& parameter : cpu_parameters) {
+    cuda_parameters.push_back(parameter.to(torch::kCUDA));
+  }
+  OptimizerClass cpu_optimizer(cpu_parameters, options);
+  OptimizerClass cuda_optimizer(cuda_parameters, options);
+
+  for (int step = 0; step < 5; step++) {
+    for (size_t p = 0; p < cpu_parameters.size(); p++) {
+      auto grad = torch::randn_like(cpu_parameters[p]);
+      cpu_parameters[p].mutable_grad() = grad;
+      cuda_parameters[p].mutable_grad() = grad.to(torch::kCUDA);
+    }
+    cpu_optimizer.step();
+    cuda_optimizer.step();
+    for (size_t p = 0; p < cpu_parameters.size(); p++) {
+      ASSERT_TRUE(cpu_parameters[p].allclose(
+          cuda_parameters[p].cpu(), /*rtol=*/1e-7, /*atol=*/1e-9));
+    }
+  }
+}
+
+TEST(OptimTest, FusedStepMatchesCPU_Adam_CUDA) {
+  check_cuda_matches_cpu<Adam>(
+      AdamOptions(0.01).weight_decay(0.1).amsgrad(true));
+}
+
+TEST(OptimTest, FusedStepMatchesCPU_AdamW_CUDA) {
+  check_cuda_matches_cpu<AdamW>(AdamWOptions(0.01).weight_decay(0.1));
+}
+
+TEST(OptimTest, FusedStepMatchesCPU_SGD_CUDA) {
+  check_cuda_matches_cpu<SGD>(
+      SGDOptions(0.1).weight_decay(0.01).momentum(0.9).nesterov(true));
+}
+
 TEST(OptimTest, ProducesPyTorchValues_LBFGS) {
   check_exact_values<LBFGS>(
       LBFGSOptions(1.0),
@@ -412,6 +457,34 @@ TEST(OptimTest, ZeroGrad) {
   }
 }
 
+TEST(OptimTest, SparseAdagradMatchesDense) {
+  torch::manual_seed(0);
+
+  auto weight = torch::randn({10, 4}, torch::requires_grad());
+  auto dense_weight = weight.detach().clone().requires_grad_();
+  const auto indices = torch::tensor({1, 7, 1, 3, 7, 7});
+  Adagrad sparse_optimizer({weight}, AdagradOptions(0.1));
+  Adagrad dense_optimizer({dense_weight}, AdagradOptions(0.1));
+
+  torch::autograd::SparseGradDeduplicationMode::set_enabled(true);
+  for (int64_t step = 0; step < 3; step++) {
+    sparse_optimizer.zero_grad();
+    dense_optimizer.zero_grad();
+    for (int64_t i = 0; i < 2; i++) {
+      torch::embedding(weight, indices, -1, false, /*sparse=*/true).pow(2).sum().backward();
+      torch::embedding(dense_weight, indices).pow(2).sum().backward();
+    }
+    // the accumulated rows are deduplicated
+    ASSERT_TRUE(weight.grad().is_coalesced());
+    ASSERT_EQ(weight.grad()._nnz(), 3);
+
+    sparse_optimizer.step();
+    dense_optimizer.step();
+    ASSERT_TRUE(weight.allclose(dense_weight));
+  }
+  torch::autograd::SparseGradDeduplicationMode::set_enabled(false);
+}
+
 TEST(OptimTest, ExternalVectorOfParameters) {
   torch::manual_seed(0);
 
@@ -291,3 +291,61 @@ TEST_F(ParallelTest, DataParallelNumericalEquivalence_MultiCUDA) {
       }
     }
 }
+
+TEST_F(ParallelTest, DataParallelModuleMatchesTheModule_MultiCUDA) {
+  torch::NoGradGuard no_grad;
+  Linear linear(3, 4);
+  auto expected_linear = std::dynamic_pointer_cast<LinearImpl>(linear->clone());
+  parallel::DataParallelModule<LinearImpl> model(linear);
+  ASSERT_EQ(model.replicas().size(), torch::cuda::device_count());
+
+  auto input = torch::randn({10, 3});
+  for (int i = 0; i < 3; ++i) {
+    auto output = model.forward(input);
+    ASSERT_EQ(output.device(), torch::Device(torch::kCUDA, 0));
+    ASSERT_TRUE(
+        torch::allclose(output.cpu(), expected_linear->forward(input)));
+  }
+
+  auto output = model.forward_async(input).get();
+  ASSERT_TRUE(torch::allclose(output.cpu(), expected_linear->forward(input)));
+}
+
+TEST_F(ParallelTest, DataParallelModuleSyncsModifiedParameters_MultiCUDA) {
+  torch::NoGradGuard no_grad;
+  Linear linear(3, 4);
+  parallel::DataParallelModule<LinearImpl> model(linear);
+  auto input = torch::randn({10, 3});
+  model.forward(input);
+
+  // nothing was modified since the last call
+  ASSERT_EQ(model.sync(), 0);
+
+  linear->weight.fill_(1);
+  ASSERT_EQ(model.sync(), 1);
+  ASSERT_EQ(model.sync(), 0);
+
+  linear->bias.zero_();
+  auto output = model.forward(input);
+  auto expected = input.sum(1, /*keepdim=*/true).expand({10, 4});
+  ASSERT_TRUE(torch::allclose(output.cpu(), expected));
+  for (const auto& replica : model.replicas()) {
+    ASSERT_TRUE(torch::allclose(replica->weight.cpu(), torch::ones({4, 3})));
+  }
+}
+
+TEST_F(ParallelTest, DataParallelModuleRethrowsException_MultiCUDA) {
+  struct M : torch::nn::Cloneable<M> {
+    void reset() override {}
+    torch::Tensor forward(torch::Tensor input) {
+      throw std::runtime_error("Badness!");
+    }
+  };
+
+  torch::NoGradGuard no_grad;
+  parallel::DataParallelModule<M> model(std::make_shared<M>());
+  auto input = torch::ones({10, 3});
+  ASSERT_THROWS_WITH(model.forward(input), "Badness!");
+  // the threads keep serving the next calls
+  ASSERT_THROWS_WITH(model.forward_async(input).get(), "Badness!");
+}
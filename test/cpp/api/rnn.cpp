@@ -701,3 +701,52 @@ TEST_F(RNNTest, UsePackedSequenceAsInput) {
     ASSERT_TRUE(torch::allclose(std::get<0>(rnn_output).data(), expected_output, 1e-05, 2e-04));
   }
 }
+
+TEST_F(RNNTest, FusedInferenceMatchesAutogradLSTM) {
+  torch::manual_seed(0);
+  auto m = LSTM(LSTMOptions(4, 3).num_layers(2).bidirectional(true));
+  auto input = torch::randn({5, 3, 4});
+  auto packed_input = torch::nn::utils::rnn::pack_sequence(
+      {torch::randn({5, 4}), torch::randn({3, 4}), torch::randn({1, 4})});
+
+  // the parameters require a gradient, which takes the generic path
+  auto output = m->forward(input);
+  auto packed_output = m->forward_with_packed_input(packed_input);
+
+  torch::NoGradGuard no_grad;
+  auto fused_output = m->forward(input);
+  auto fused_packed_output = m->forward_with_packed_input(packed_input);
+  ASSERT_TRUE(torch::allclose(std::get<0>(output), std::get<0>(fused_output), 1e-05, 1e-05));
+  ASSERT_TRUE(torch::allclose(
+      std::get<0>(std::get<1>(output)), std::get<0>(std::get<1>(fused_output)), 1e-05, 1e-05));
+  ASSERT_TRUE(torch::allclose(
+      std::get<1>(std::get<1>(output)), std::get<1>(std::get<1>(fused_output)), 1e-05, 1e-05));
+  ASSERT_TRUE(torch::allclose(
+      std::get<0>(packed_output).data(), std::get<0>(fused_packed_output).data(), 1e-05, 1e-05));
+  // the final states of the sequences of different lengths
+  ASSERT_TRUE(torch::allclose(
+      std::get<0>(std::get<1>(packed_output)), std::get<0>(std::get<1>(fused_packed_output)), 1e-05, 1e-05));
+  ASSERT_TRUE(torch::allclose(
+      std::get<1>(std::get<1>(packed_output)), std::get<1>(std::get<1>(fused_packed_output)), 1e-05, 1e-05));
+}
+
+TEST_F(RNNTest, FusedInferenceMatchesAutogradGRU) {
+  torch::manual_seed(0);
+  auto m = GRU(GRUOptions(4, 3).num_layers(2).bidirectional(true).batch_first(true));
+  auto input = torch::randn({3, 5, 4});
+  auto packed_input = torch::nn::utils::rnn::pack_sequence(
+      {torch::randn({5, 4}), torch::randn({3, 4}), torch::randn({1, 4})});
+  auto hx = torch::randn({4, 3, 3});
+
+  auto output = m->forward(input, hx);
+  auto packed_output = m->forward_with_packed_input(packed_input, hx);
+
+  torch::NoGradGuard no_grad;
+  auto fused_output = m->forward(input, hx);
+  auto fused_packed_output = m->forward_with_packed_input(packed_input, hx);
+  ASSERT_TRUE(torch::allclose(std::get<0>(output), std::get<0>(fused_output), 1e-05, 1e-05));
+  ASSERT_TRUE(torch::allclose(std::get<1>(output), std::get<1>(fused_output), 1e-05, 1e-05));
+  ASSERT_TRUE(torch::allclose(
+      std::get<0>(packed_output).data(), std::get<0>(fused_packed_output).data(), 1e-05, 1e-05));
+  ASSERT_TRUE(torch::allclose(std::get<1>(packed_output), std::get<1>(fused_packed_output), 1e-05, 1e-05));
+}
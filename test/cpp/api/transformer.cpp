@@ -1028,6 +1028,76 @@ TEST_F(TransformerTest, TransformerDecoder_CUDA) {
   transformer_decoder_test_helper(true);
 }
 
+TEST_F(TransformerTest, MultiheadAttentionIncremental) {
+  MultiheadAttention attn(MultiheadAttentionOptions(8, 2));
+  attn->eval();
+  const auto x = torch::randn({7, 3, 8});
+  const auto mask = Transformer::Impl::generate_square_subsequent_mask(7);
+  const auto expected = std::get<0>(attn(x, x, x, torch::Tensor(), false, mask));
+
+  // a cache smaller than the sequence, which grows while priming with 3
+  // positions at once and then decoding one at a time
+  MultiheadAttentionCache cache(/*capacity=*/2);
+  std::vector<torch::Tensor> outputs{
+    attn->forward_incremental(x.slice(0, 0, 3), x.slice(0, 0, 3), x.slice(0, 0, 3), cache)};
+  for (int64_t i = 3; i < 7; ++i) {
+    const auto step = x.slice(0, i, i + 1);
+    outputs.push_back(attn->forward_incremental(step, step, step, cache));
+  }
+  ASSERT_EQ(cache.length, 7);
+  ASSERT_GE(cache.key.size(2), 7);
+  ASSERT_TRUE(torch::allclose(torch::cat(outputs), expected, 1e-5, 1e-6));
+
+  // attention to a static memory
+  const auto memory = torch::randn({5, 3, 8});
+  const auto memory_expected = std::get<0>(attn(x, memory, memory, torch::Tensor(), false));
+  MultiheadAttentionCache memory_cache;
+  outputs.clear();
+  for (int64_t i = 0; i < 7; ++i) {
+    outputs.push_back(attn->forward_incremental(
+      x.slice(0, i, i + 1), memory, memory, memory_cache, /*static_kv=*/true));
+  }
+  ASSERT_EQ(memory_cache.length, 5);
+  ASSERT_TRUE(torch::allclose(torch::cat(outputs), memory_expected, 1e-5, 1e-6));
+
+  MultiheadAttention attn_bias_kv(MultiheadAttentionOptions(8, 2).add_bias_kv(true));
+  ASSERT_THROWS_WITH(
+    attn_bias_kv->forward_incremental(x, x, x, cache),
+    "forward_incremental doesn't support add_bias_kv nor add_zero_attn");
+}
+
+TEST_F(TransformerTest, TransformerDecoderIncremental) {
+  TransformerDecoder decoder(TransformerDecoderOptions(
+    TransformerDecoderLayerOptions(8, 2).dim_feedforward(16).dropout(0.0), 2)
+    .norm(AnyModule(LayerNorm(LayerNormOptions({8})))));
+  decoder->eval();
+  torch::NoGradGuard no_grad;
+  const int64_t length = 6;
+  const auto tgt = torch::randn({length, 4, 8});
+  const auto memory = torch::randn({5, 4, 8});
+  const auto tgt_mask = Transformer::Impl::generate_square_subsequent_mask(length);
+  const auto expected = decoder(tgt, memory, tgt_mask);
+
+  TransformerDecoderCache cache;
+  for (int64_t i = 0; i < length; ++i) {
+    const auto out = decoder->forward_incremental(tgt.slice(0, i, i + 1), memory, cache);
+    ASSERT_TRUE(torch::allclose(out[0], expected[i], 1e-5, 1e-6));
+  }
+  ASSERT_EQ(cache.length(), length);
+  ASSERT_EQ(cache.layers.size(), 2u);
+
+  // the batch entries a beam search keeps, some of them twice
+  const auto index = torch::tensor({2, 0, 0, 3});
+  cache.reorder(index);
+  const auto next = torch::randn({1, 4, 8});
+  const auto reordered_tgt = torch::cat({tgt.index_select(1, index), next});
+  const auto reordered_memory = memory.index_select(1, index);
+  const auto reordered_expected = decoder(
+    reordered_tgt, reordered_memory,
+    Transformer::Impl::generate_square_subsequent_mask(length + 1));
+  const auto out = decoder->forward_incremental(next, reordered_memory, cache);
+  ASSERT_TRUE(torch::allclose(out[0], reordered_expected[length], 1e-5, 1e-6));
+}
 
 TEST_F(TransformerTest, PrettyPrintTransformerDecoder) {
   LayerNorm norm = LayerNorm(LayerNormOptions({4}));
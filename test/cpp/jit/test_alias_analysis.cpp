@@ -559,6 +559,44 @@ TEST(WriteTrackingTest, HasWriters) {
   EXPECT_TRUE(aliasDb.isMutable(add));
 }
 
+TEST(WriteTrackingTest, AddAndRemoveNodes) {
+  auto graph = std::make_shared<Graph>();
+  std::unordered_map<std::string, Value*> vmap;
+  parseIR(
+      R"IR(
+  graph(%x: Tensor, %y : Tensor):
+    %a : Tensor = aten::mul(%x, %y)
+    return (%a)
+    )IR",
+      &*graph,
+      vmap);
+  auto a = vmap["a"];
+  auto y = vmap["y"];
+  AliasDb aliasDb(graph);
+  EXPECT_FALSE(aliasDb.hasWriters(a->node()));
+
+  WithInsertPoint guard(graph->return_node());
+  auto view = graph->insert(aten::t, {a})->node();
+  aliasDb.addNode(view);
+  EXPECT_TRUE(aliasDb.mayAlias(view->output(), a));
+  EXPECT_FALSE(aliasDb.mayAlias(view->output(), y));
+  EXPECT_FALSE(aliasDb.hasWriters(a->node()));
+
+  // a write to the view is a write to %a
+  auto write = graph->insert(aten::add_, {view->output(), y})->node();
+  aliasDb.addNode(write);
+  EXPECT_TRUE(aliasDb.hasWriters(a->node()));
+  EXPECT_TRUE(
+      aliasDb.writesToAlias(write, std::unordered_set<const Value*>{a}));
+  Lint(&aliasDb);
+
+  aliasDb.removeNode(write);
+  write->destroy();
+  EXPECT_FALSE(aliasDb.hasWriters(a->node()));
+  EXPECT_TRUE(aliasDb.mayAlias(view->output(), a));
+  Lint(&aliasDb);
+}
+
 TEST(ContainerAliasingTest, MayContainAlias) {
   auto graph = std::make_shared<Graph>();
   std::unordered_map<std::string, Value*> vmap;
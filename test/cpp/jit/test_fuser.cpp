@@ -8,6 +8,7 @@
 #include <torch/csrc/autograd/generated/variable_factories.h>
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/codegen/fuser/binary_cache.h>
 #include <torch/csrc/jit/codegen/fuser/interface.h>
 #include <torch/csrc/jit/frontend/ir_emitter.h>
 #include <torch/csrc/jit/frontend/tracer.h>
@@ -41,6 +42,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <functional>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
@@ -50,6 +52,11 @@
 #include <utility>
 #include <vector>
 
+#ifndef _WIN32
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
 namespace torch {
 namespace jit {
 
@@ -262,5 +269,132 @@ TEST(FuserTest, KernelCaching) {
   // and therefore share a KernelSpec to share kernels for specializations
   ASSERT_EQ(second_key, expected_key);
 }
+
+#ifndef _WIN32
+TEST(FuserTest, KernelBinaryCache) {
+  char dir_template[] = "/tmp/fuser_kernel_cache_XXXXXX";
+  ASSERT_NE(mkdtemp(dir_template), nullptr);
+  const std::string dir = dir_template;
+  const std::string old_dir = fuser::getKernelBinaryCacheDir();
+  fuser::getKernelBinaryCacheDir() = dir;
+  fuser::clearKernelBinaryCache();
+
+  const std::vector<const char*> args = {"--std=c++14", "-default-device"};
+  const auto key = fuser::kernelBinaryKey(
+      "kernel", args, 8, 0, /*compile_to_sass=*/true, 11, 1);
+  // Any part of the key distinguishes the kernels
+  const auto other_arch = fuser::kernelBinaryKey(
+      "kernel", args, 7, 5, /*compile_to_sass=*/true, 11, 1);
+  const auto other_nvrtc = fuser::kernelBinaryKey(
+      "kernel", args, 8, 0, /*compile_to_sass=*/true, 11, 2);
+  ASSERT_NE(key, other_arch);
+  ASSERT_NE(key, other_nvrtc);
+
+  ASSERT_FALSE(fuser::loadKernelBinary(key));
+  // The image may hold NULs
+  fuser::KernelBinary binary{{'\x7f', 'E', 'L', 'F', '\0', 'x'}, "_Z6kernelv"};
+  fuser::storeKernelBinary(key, binary);
+  ASSERT_FALSE(fuser::loadKernelBinary(other_arch));
+  ASSERT_FALSE(fuser::loadKernelBinary(other_nvrtc));
+
+  auto loaded = fuser::loadKernelBinary(key);
+  ASSERT_TRUE(loaded);
+  ASSERT_EQ(loaded->image, binary.image);
+  ASSERT_EQ(loaded->function_name, binary.function_name);
+
+  // A process loading the model preloads the entries listed in the manifest,
+  // and no longer needs the files
+  const std::string manifest = dir + "/manifest.txt";
+  fuser::writeKernelBinaryManifest(manifest);
+  fuser::clearKernelBinaryCache();
+  ASSERT_EQ(fuser::preloadKernelBinaries(manifest), 1);
+  std::ifstream manifest_file(manifest);
+  std::string entry;
+  ASSERT_TRUE(std::getline(manifest_file, entry));
+  ASSERT_EQ(std::remove((dir + "/" + entry).c_str()), 0);
+  loaded = fuser::loadKernelBinary(key);
+  ASSERT_TRUE(loaded);
+  ASSERT_EQ(loaded->image, binary.image);
+
+  fuser::clearKernelBinaryCache();
+  ASSERT_FALSE(fuser::loadKernelBinary(key));
+  std::remove(manifest.c_str());
+  rmdir(dir.c_str());
+  fuser::getKernelBinaryCacheDir() = old_dir;
+}
+
+TEST(FuserTest, LaunchConfigCache) {
+  char dir_template[] = "/tmp/fuser_kernel_cache_XXXXXX";
+  ASSERT_NE(mkdtemp(dir_template), nullptr);
+  const std::string dir = dir_template;
+  const std::string old_dir = fuser::getKernelBinaryCacheDir();
+  fuser::getKernelBinaryCacheDir() = dir;
+
+  const std::vector<const char*> args = {"--std=c++14", "-default-device"};
+  const auto binary_key = fuser::kernelBinaryKey(
+      "kernel", args, 8, 0, /*compile_to_sass=*/true, 11, 1);
+  const auto key =
+      fuser::launchConfigKey(binary_key, "NVIDIA A100-SXM4-40GB", 108);
+  // The configuration is tuned for a specific device
+  const auto other_device = fuser::launchConfigKey(binary_key, "Tesla T4", 40);
+  ASSERT_NE(key, other_device);
+
+  ASSERT_FALSE(fuser::loadLaunchConfig(key));
+  fuser::storeLaunchConfig(key, {256, 864});
+  ASSERT_FALSE(fuser::loadLaunchConfig(other_device));
+  // The configurations don't shadow the binaries
+  ASSERT_FALSE(fuser::loadKernelBinary(binary_key));
+
+  auto loaded = fuser::loadLaunchConfig(key);
+  ASSERT_TRUE(loaded);
+  ASSERT_EQ(loaded->block_size, 256);
+  ASSERT_EQ(loaded->max_blocks, 864);
+
+  fuser::getKernelBinaryCacheDir() = old_dir;
+  DIR* entries = opendir(dir.c_str());
+  ASSERT_NE(entries, nullptr);
+  while (const dirent* entry = readdir(entries)) {
+    std::remove((dir + "/" + entry->d_name).c_str());
+  }
+  closedir(entries);
+  rmdir(dir.c_str());
+}
+#endif
+
+#ifdef TORCH_ENABLE_LLVM
+TEST(FuserTest, LLVMKernelCPU) {
+  const auto graph_string = R"IR(
+      graph(%0 : Tensor,
+            %1 : Tensor):
+        %2 : float = prim::Constant[value=0.5]()
+        %3 : int = prim::Constant[value=1]()
+        %4 : Tensor = aten::mul(%0, %1)
+        %5 : Tensor = aten::sigmoid(%4)
+        %6 : Tensor = aten::add(%5, %2, %3)
+        %7 : Tensor = aten::gt(%6, %1)
+        return (%6, %7))IR";
+  Graph graph;
+  torch::jit::parseIR(graph_string, &graph);
+
+  torch::jit::overrideCanFuseOnCPU(true);
+  // Contiguous inputs use the vectorized loop and its remaining elements,
+  // permuted ones compute the offsets from the strides
+  auto testWithInputs = [&](const at::Tensor& a, const at::Tensor& b) {
+    auto code = debugGetFusedKernelCode(graph, {a, b});
+    // Compiled by LLVM, not by the C++ compiler
+    ASSERT_EQ(code.find("extern \"C\""), std::string::npos);
+
+    auto outputs = debugLaunchGraph(graph, {a, b});
+    ASSERT_EQ(outputs.size(), 2);
+    auto out0 = (a * b).sigmoid() + 0.5;
+    ASSERT_TRUE(at::allclose(outputs[0], out0));
+    ASSERT_TRUE(at::equal(outputs[1], outputs[0] > b));
+  };
+  testWithInputs(at::rand({3, 37}), at::rand({3, 37}));
+  testWithInputs(at::rand({1024, 257}), at::rand({257, 1024}).t());
+  torch::jit::overrideCanFuseOnCPU(false);
+}
+#endif
+
 } // namespace jit
 } // namespace torch
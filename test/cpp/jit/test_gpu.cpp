@@ -5161,6 +5161,33 @@ TEST(NVFuserTest, FusionReductionScheduler_CUDA) {
       aten_output.sub(outputs[0]).abs().max());
 }
 
+// Varying sizes of the same bucket reuse the kernel of the first one
+TEST(NVFuserTest, FusionReductionSchedulerDynamicShape_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeDummyTensor(2);
+  fusion.addInput(tv0);
+  TensorView* tv1 = sum(tv0, {1});
+  fusion.addOutput(tv1);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+
+  const auto options =
+      at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (int seq_len : {1000, 1017, 1024, 1001}) {
+    at::Tensor input = at::randn({128, seq_len}, options);
+    auto outputs = fec.runFusionWithInputs({input});
+    auto aten_output = input.sum({1});
+    TORCH_CHECK(
+        aten_output.allclose(outputs[0], 1e-04, 1e-04),
+        "Error of: ",
+        aten_output.sub(outputs[0]).abs().max());
+  }
+  TORCH_CHECK(fec.compiledKernelCount() == 1);
+}
+
 // Simple reduction parallelized on a symbolic size.
 TEST(NVFuserTest, FusionSymbolicReduction_CUDA) {
   Fusion fusion;
@@ -6382,6 +6409,121 @@ TEST(NVFuserTest, FusionSmemDynamicPersistentBatchNorm_CUDA) {
       at_norm_gamma_beta.sub(outputs[0]).abs().max());
 }
 
+TEST(NVFuserTest, FusionNormalizationSchedulerLayerNormGelu_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* x = makeDummyTensor(3);
+  TensorView* weight = makeDummyTensor(1);
+  TensorView* bias = makeDummyTensor(1);
+  Float* eps = new Float();
+  Int* N = new Int();
+  fusion.addInput(x);
+  fusion.addInput(weight);
+  fusion.addInput(bias);
+  fusion.addInput(eps);
+  fusion.addInput(N);
+
+  auto x_sum = sum(x, {-1}); // (A, B, R)
+  auto x_mean = div(x_sum, N); // (A, B)
+  auto x_mean_bcast = broadcast(x_mean, {false, false, true}); // (A, B, B)
+  auto x_mean_sub = sub(x, x_mean_bcast); // (A, B, N)
+  auto x_mean_sub_pow = mul(x_mean_sub, x_mean_sub); // (A, B, N)
+  auto var_sum = sum(x_mean_sub_pow, {-1}); // (A, B, R)
+  auto var = div(var_sum, N); // (A, B)
+  auto var_eps = add(var, eps); // (A, B)
+  auto rvar = unaryOp(UnaryOpType::Rsqrt, var_eps); // (A, B)
+  auto rvar_bcast = broadcast(rvar, {false, false, true}); // (A, B, B)
+  auto x_norm = mul(x_mean_sub, rvar_bcast); // (A, B, N)
+  auto weight_bcast = broadcast(weight, {true, true, false}); // (B, B, N)
+  auto bias_bcast = broadcast(bias, {true, true, false}); // (B, B, N)
+  auto x_norm_gamma = mul(x_norm, weight_bcast); // (A, B, N)
+  auto x_norm_gamma_beta = add(x_norm_gamma, bias_bcast); // (A, B, N)
+  auto gelu = unaryOp(UnaryOpType::Gelu, x_norm_gamma_beta); // (A, B, N)
+  fusion.addOutput(gelu);
+
+  const int dimx = 8;
+  const int dimy = 128;
+  const int dimz = 768;
+  const float kEps = 1e-5;
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({dimx, dimy, dimz}, options);
+  at::Tensor t1 = at::randn({dimz}, options);
+  at::Tensor t2 = at::randn({dimz}, options);
+  std::vector<IValue> inputs = {t0, t1, t2, kEps, dimz};
+
+  auto norm_params =
+      getNormalizationHeuristics(&fusion, inputs, {x_sum, var_sum});
+  TORCH_CHECK(norm_params, "Normalization schedule was not generated!");
+  scheduleNormalization(&fusion, norm_params.value(), {x_sum, var_sum});
+
+  // x and x - mean are read by two stages
+  TORCH_CHECK(x_mean_sub->getMemoryType() == MemoryType::Shared);
+
+  torch::jit::fuser::cuda::FusionExecutor fe;
+  fe.compileFusion(&fusion);
+  auto outputs = fe.runFusion(inputs, norm_params.value().lparams);
+
+  auto aten_output = at::gelu(at::layer_norm(t0, {dimz}, t1, t2, kEps));
+  TORCH_CHECK(
+      aten_output.allclose(outputs[0], 1e-4, 1e-4),
+      "Error of: ",
+      aten_output.sub(outputs[0]).abs().max());
+}
+
+// The input gradient of layer_norm, from the saved mean and inverse of the
+// standard deviation, through the kernel cache
+TEST(NVFuserTest, FusionNormalizationSchedulerLayerNormBackward_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  TensorView* dy = makeDummyTensor(2);
+  TensorView* x = makeDummyTensor(2);
+  TensorView* mean = makeDummyTensor(1);
+  TensorView* rstd = makeDummyTensor(1);
+  Float* N = new Float();
+  fusion.addInput(dy);
+  fusion.addInput(x);
+  fusion.addInput(mean);
+  fusion.addInput(rstd);
+  fusion.addInput(N);
+
+  auto mean_bcast = broadcast(mean, {false, true}); // (M, B)
+  auto rstd_bcast = broadcast(rstd, {false, true}); // (M, B)
+  auto x_hat = mul(sub(x, mean_bcast), rstd_bcast); // (M, N)
+  auto dy_sum = sum(dy, {-1}); // (M, R)
+  auto dy_x_hat_sum = sum(mul(dy, x_hat), {-1}); // (M, R)
+  auto dy_sum_bcast = broadcast(dy_sum, {false, true}); // (M, B)
+  auto dy_x_hat_sum_bcast = broadcast(dy_x_hat_sum, {false, true}); // (M, B)
+  auto dx = sub(mul(dy, N), dy_sum_bcast); // (M, N)
+  dx = sub(dx, mul(x_hat, dy_x_hat_sum_bcast)); // (M, N)
+  dx = div(mul(dx, rstd_bcast), N); // (M, N)
+  fusion.addOutput(dx);
+
+  const int dimx = 1024;
+  const int dimy = 4096;
+  const float kEps = 1e-5;
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({dimx, dimy}, options);
+  at::Tensor t1 = at::randn({dimx, dimy}, options);
+  at::Tensor t2 = at::mean(t1, -1);
+  at::Tensor t3 = at::rsqrt(at::add(at::var(t1, -1, false), kEps));
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto outputs =
+      fec.runFusionWithInputs({t0, t1, t2, t3, static_cast<float>(dimy)});
+
+  auto at_x_hat = at::mul(at::sub(t1, t2.unsqueeze(1)), t3.unsqueeze(1));
+  auto at_dx = at::sub(at::mul(t0, dimy), t0.sum({-1}, true));
+  at_dx = at::sub(at_dx, at_x_hat * at::mul(t0, at_x_hat).sum({-1}, true));
+  at_dx = at::div(at::mul(at_dx, t3.unsqueeze(1)), dimy);
+  TORCH_CHECK(
+      at_dx.allclose(outputs[0], 1e-3, 1e-3),
+      "Error of: ",
+      at_dx.sub(outputs[0]).abs().max());
+}
+
 TEST(NVFuserTest, FusionSmemDynamicReductionSymbolic_CUDA) {
   Fusion fusion;
   FusionGuard fg(&fusion);
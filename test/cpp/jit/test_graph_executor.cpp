@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include "test/cpp/jit/test_utils.h"
+#include "torch/csrc/jit/ir/irparser.h"
 #include "torch/csrc/jit/runtime/graph_executor.h"
 #include "torch/jit.h"
 #include "torch/script.h"
@@ -32,6 +33,56 @@ TEST(GraphExecutorTest, Basic_CUDA) {
   ASSERT_TRUE(almostEqual(stack[1].toTensor(), r1));
 }
 
+TEST(GraphExecutorTest, ProfilingPlanCache) {
+  if (!getExecutorMode() || !getProfilingMode()) {
+    return;
+  }
+  auto graph = std::make_shared<Graph>();
+  parseIR(
+      R"IR(
+graph(%a : Tensor, %b : Tensor):
+  %c : Tensor = aten::mul(%a, %b)
+  return (%c))IR",
+      &*graph);
+
+  size_t old_cache_size = getProfilingPlanCacheSize();
+  size_t old_num_profiled_runs = getNumProfiledRuns();
+  getProfilingPlanCacheSize() = 2;
+  getNumProfiledRuns() = 1;
+  auto& stats = getProfilingPlanCacheStats();
+  size_t hits = stats.hits;
+  size_t misses = stats.misses;
+  size_t evictions = stats.evictions;
+
+  GraphExecutor executor(graph, "");
+  auto run = [&](int64_t size) {
+    auto a = at::randn({size});
+    auto b = at::randn({size});
+    auto stack = createStack({a, b});
+    executor.run(stack);
+    ASSERT_TRUE(almostEqual(stack[0].toTensor(), a * b));
+  };
+  // 8 and 16 are in one shape class, 3 and 5 in another
+  run(8);
+  run(8);
+  run(16);
+  ASSERT_EQ(stats.misses - misses, 1u);
+  ASSERT_EQ(stats.hits - hits, 2u);
+  run(3);
+  run(5);
+  ASSERT_EQ(stats.misses - misses, 2u);
+  ASSERT_EQ(stats.hits - hits, 3u);
+  ASSERT_EQ(stats.evictions - evictions, 0u);
+  // evicts the least recently used class of 8
+  run(1);
+  run(8);
+  ASSERT_EQ(stats.misses - misses, 4u);
+  ASSERT_EQ(stats.evictions - evictions, 2u);
+
+  getProfilingPlanCacheSize() = old_cache_size;
+  getNumProfiledRuns() = old_num_profiled_runs;
+}
+
 TEST(GraphExecutorTest, runAsync_executor) {
   /*
   TODO: there are some problem with C++ parsing script program involving
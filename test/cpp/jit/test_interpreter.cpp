@@ -2,6 +2,7 @@
 
 #include <ATen/Parallel.h>
 #include "test/cpp/jit/test_utils.h"
+#include "torch/csrc/jit/runtime/instruction.h"
 #include "torch/jit.h"
 #include "torch/script.h"
 #include "torch/torch.h"
@@ -178,5 +179,52 @@ TEST(InterpreterTest, runAsyncBasicTest) {
   interp.runAsync(stack)->wait();
   ASSERT_TRUE(asyncCounter > 0);
 }
+TEST(InterpreterTest, PrimitiveInstructions) {
+  auto graph = std::make_shared<Graph>();
+  parseIR(
+      R"IR(
+graph(%a : Tensor,
+      %b : Tensor?):
+  %none : NoneType = prim::Constant()
+  %i : int = prim::Constant[value=-1]()
+  %t : (Tensor, Tensor?) = prim::TupleConstruct(%a, %b)
+  %x : Tensor? = prim::TupleIndex(%t, %i)
+  %is_none : bool = aten::__is__(%x, %none)
+  %is_not_none : bool = aten::__isnot__(%x, %none)
+  %y : Tensor = prim::unchecked_cast(%x)
+  return (%y, %is_none, %is_not_none)
+  )IR",
+      &*graph);
+
+  auto count = [](const Code& code, OpCode op) {
+    const auto& instructions = code.instructions();
+    return std::count_if(
+        instructions.begin(),
+        instructions.end(),
+        [&](const Instruction& inst) { return inst.op == op; });
+  };
+
+  Code code(graph, "");
+  ASSERT_EQ(count(code, OP), 0);
+  ASSERT_EQ(count(code, TUPLE_INDEX), 1);
+  ASSERT_EQ(count(code, IS), 1);
+  ASSERT_EQ(count(code, IS_NOT), 1);
+
+  // the same ops as OPs, for mobile
+  Code mobile_code(graph, "", 0, /*emit_primitive_instructions=*/false);
+  ASSERT_EQ(count(mobile_code, OP), 4);
+  ASSERT_EQ(count(mobile_code, TUPLE_INDEX), 0);
+
+  for (Code* c : {&code, &mobile_code}) {
+    auto a = at::rand({2});
+    auto b = at::rand({3});
+    std::vector<IValue> stack({a, b});
+    InterpreterState(*c).run(stack);
+    ASSERT_EQ(stack.size(), 3u);
+    ASSERT_TRUE(exactlyEqual(stack[0].toTensor(), b));
+    ASSERT_FALSE(stack[1].toBool());
+    ASSERT_TRUE(stack[2].toBool());
+  }
+}
 } // namespace jit
 } // namespace torch
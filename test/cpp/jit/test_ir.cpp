@@ -93,6 +93,37 @@ TEST(IRTest, Blocks) {
       ->run(*g2);
 }
 
+TEST(IRTest, CreateAndFreeMany) {
+  // Enough values for several chunks of value storage, and nodes freed in
+  // the middle of the lists the graph tracks them in
+  auto g = std::make_shared<Graph>();
+  Value* input = g->addInput();
+  std::vector<Node*> nodes;
+  for (int i = 0; i < 1000; i++) {
+    Node* n = g->appendNode(g->create(aten::relu, {input}, 2));
+    nodes.push_back(n);
+  }
+  for (size_t i = 0; i < nodes.size(); i += 2) {
+    nodes[i]->eraseOutput(1);
+    nodes[i + 1]->destroy();
+  }
+  // The storage of the freed values is reused
+  for (size_t i = 0; i < nodes.size(); i += 2) {
+    nodes[i]->addOutput();
+  }
+  g->registerOutput(nodes[nodes.size() - 2]->outputs()[0]);
+  g->lint();
+
+  auto g2 = g->copy();
+  g2->lint();
+  size_t num_nodes = 0;
+  for (Node* n : g2->nodes()) {
+    ASSERT_EQ(n->outputs().size(), 2);
+    num_nodes++;
+  }
+  ASSERT_EQ(num_nodes, nodes.size() / 2);
+}
+
 TEST(IRTest, CommonAncestor) {
   std::string input_str = R"(
 graph(%x : Tensor,
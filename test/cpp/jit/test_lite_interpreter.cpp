@@ -1,11 +1,14 @@
 #include <gtest/gtest.h>
 
 #include <c10/core/TensorOptions.h>
+#include <caffe2/serialize/versions.h>
 #include <torch/csrc/autograd/generated/variable_factories.h>
 #include <torch/csrc/jit/api/module.h>
 #include <torch/csrc/jit/frontend/resolver.h>
 #include <torch/csrc/jit/mobile/import.h>
+#include <torch/csrc/jit/mobile/interpreter.h>
 #include <torch/csrc/jit/mobile/module.h>
+#include <torch/csrc/jit/mobile/observer.h>
 #include <torch/csrc/jit/serialization/export.h>
 #include <torch/csrc/jit/serialization/import.h>
 #include <torch/custom_class.h>
@@ -905,6 +908,188 @@ TEST(LiteInterpreterTest, OpNameExportFetchRootOperators) {
       << "Expected the root operator lists to be the same";
 }
 
+TEST(LiteInterpreterTest, Superinstructions) {
+  // for i in range(3):
+  //   x = i
+  //   y = 1 + x
+  // return x + y
+  mobile::Function function(c10::QualifiedName("superinstructions"));
+  function.append_constant(int64_t(0));
+  function.append_constant(int64_t(3));
+  function.append_constant(true);
+  function.append_constant(int64_t(1));
+  ASSERT_TRUE(function.append_operator(
+      "aten::add", "int", caffe2::serialize::kProducedBytecodeVersion));
+  function.set_register_size(2);
+  function.append_instruction(LOADC, 0, 0);
+  function.append_instruction(LOADC, 1, 0);
+  function.append_instruction(LOADC, 2, 0);
+  function.append_instruction(LOOP, 8, 2);
+  function.append_instruction(STORE, 1, 0);
+  function.append_instruction(LOADC, 3, 0);
+  function.append_instruction(LOAD, 1, 0);
+  function.append_instruction(OP, 0, 0);
+  function.append_instruction(STORE, 2, 0);
+  function.append_instruction(LOADC, 2, 0);
+  function.append_instruction(JMP, -7, 0);
+  function.append_instruction(LOAD, 1, 0);
+  function.append_instruction(LOAD, 2, 0);
+  function.append_instruction(OP, 0, 0);
+  function.append_instruction(STORE, 1, 0);
+  function.append_instruction(MOVE, 1, 0);
+  function.append_instruction(RET, 0, 0);
+
+  const auto& instructions = function.get_code()->instructions_;
+  ASSERT_EQ(instructions.size(), 17u);
+  // the second instruction of a pair is kept
+  ASSERT_EQ(instructions[6].op, LOAD_OP);
+  ASSERT_EQ(instructions[7].op, OP);
+  ASSERT_EQ(instructions[12].op, LOAD_OP);
+  ASSERT_EQ(instructions[15].op, MOVE_RET);
+  ASSERT_EQ(instructions[16].op, RET);
+
+  for (int i = 0; i < 2; ++i) {
+    Stack stack;
+    function.run(stack);
+    ASSERT_EQ(stack.size(), 1u);
+    ASSERT_EQ(stack[0].toInt(), 2 + 3);
+  }
+
+  // superinstructions can't be loaded from bytecode
+  ASSERT_THROWS_WITH(
+      function.append_instruction(LOAD_OP, 1, 0),
+      "LOAD_OP is not supported in mobile module.");
+}
+
+TEST(LiteInterpreterTest, MemoryPlanning) {
+  Module m("m");
+  m.register_parameter("weight", torch::rand({4, 4}), false);
+  m.define(R"(
+    def forward(self, x):
+      y = torch.mm(x, self.weight)
+      z = torch.relu(y) + y
+      return torch.mm(z, self.weight)
+  )");
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+  bc.get_method("forward").function().set_memory_planning(true);
+
+  // profiled, validated and planned runs for each shape
+  for (int64_t rows : {2, 3}) {
+    for (int i = 0; i < 4; ++i) {
+      auto x = torch::rand({rows, 4});
+      auto ref = m.forward({x}).toTensor();
+      auto res = bc.forward({x}).toTensor();
+      ASSERT_TRUE(res.allclose(ref));
+    }
+  }
+}
+
+TEST(LiteInterpreterTest, OperatorCache) {
+  // the functions of a module share the operators resolved for it
+  mobile::OperatorCache cache;
+  for (int i = 0; i < 2; ++i) {
+    mobile::Function function(c10::QualifiedName("add"));
+    function.append_constant(int64_t(2));
+    function.append_constant(int64_t(3));
+    ASSERT_TRUE(function.append_operator(
+        "aten::add",
+        "int",
+        caffe2::serialize::kProducedBytecodeVersion,
+        &cache));
+    function.set_register_size(0);
+    function.append_instruction(LOADC, 0, 0);
+    function.append_instruction(LOADC, 1, 0);
+    function.append_instruction(OP, 0, 0);
+    function.append_instruction(RET, 0, 0);
+    ASSERT_EQ(cache.size(), 1u);
+
+    Stack stack;
+    function.run(stack);
+    ASSERT_EQ(stack.size(), 1u);
+    ASSERT_EQ(stack[0].toInt(), 5);
+  }
+
+  // operators that can't be found are not cached
+  mobile::Function function(c10::QualifiedName("missing"));
+  ASSERT_FALSE(function.append_operator(
+      "aten::does_not_exist",
+      "",
+      caffe2::serialize::kProducedBytecodeVersion,
+      &cache));
+  ASSERT_EQ(cache.size(), 1u);
+}
+
+namespace {
+class StatsObserver : public torch::MobileModuleObserver {
+ public:
+  void onRunMethodStats(const int32_t, const torch::MobileDebugInfo& info)
+      override {
+    num_reports++;
+    method_name = info.getMethodName();
+    op_stats = info.getOpStats();
+    peak_memory_bytes = info.getPeakMemoryBytes();
+    num_allocations = info.getNumAllocations();
+  }
+
+  int num_reports = 0;
+  std::string method_name;
+  std::unordered_map<c10::OperatorName, torch::MobileOpStats> op_stats;
+  int64_t peak_memory_bytes = 0;
+  size_t num_allocations = 0;
+};
+} // namespace
+
+TEST(LiteInterpreterTest, ObserverStats) {
+  Module m("m");
+  m.define(R"(
+    def forward(self, x):
+      y = x + x
+      return y * y + x
+  )");
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+
+  auto& config = torch::observerConfig();
+  auto observer = std::make_unique<StatsObserver>();
+  const auto* stats = observer.get();
+  config.setModuleObserver(std::move(observer));
+
+  // not sampled by default
+  bc.forward({torch::ones({16, 16})});
+  EXPECT_EQ(stats->num_reports, 0);
+
+  config.setOpStatsSamplingRate(1.);
+  config.setMemoryStatsSamplingRate(1.);
+  bc.forward({torch::ones({16, 16})});
+  config.setOpStatsSamplingRate(0.);
+  config.setMemoryStatsSamplingRate(0.);
+
+  EXPECT_EQ(stats->num_reports, 1);
+  EXPECT_EQ(stats->method_name, "forward");
+  uint64_t num_adds = 0;
+  uint64_t num_muls = 0;
+  for (const auto& kv : stats->op_stats) {
+    EXPECT_GE(kv.second.total_ns, kv.second.max_ns);
+    if (kv.first.name == "aten::add") {
+      num_adds += kv.second.count;
+    } else if (kv.first.name == "aten::mul") {
+      num_muls += kv.second.count;
+    }
+  }
+  EXPECT_EQ(num_adds, 2u);
+  EXPECT_EQ(num_muls, 1u);
+  // y and y * y are alive at the same time
+  EXPECT_GE(
+      stats->peak_memory_bytes,
+      static_cast<int64_t>(2 * 16 * 16 * sizeof(float)));
+  EXPECT_GE(stats->num_allocations, 3u);
+
+  config.setModuleObserver(nullptr);
+}
+
 namespace {
 static auto reg =
     torch::class_<TorchBindLiteInterpreterTestStruct>(
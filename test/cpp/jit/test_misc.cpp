@@ -9,6 +9,8 @@
 
 #include <torch/csrc/autograd/engine.h>
 #include <torch/csrc/autograd/generated/variable_factories.h>
+#include <torch/csrc/autograd/profiler_op_stats.h>
+#include <torch/csrc/autograd/profiler_sampling.h>
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/jit/api/module.h>
 #include <torch/csrc/jit/codegen/fuser/interface.h>
@@ -57,6 +59,7 @@
 #include <c10/util/ThreadLocalDebugInfo.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <functional>
 #include <iostream>
@@ -1202,6 +1205,110 @@ TEST(RecordFunctionTest, OperatorNameOverload) {
       << "Expected aten::pow.Tensor_Scalar to have been called and recorded, but it was not";
 }
 
+TEST(RecordFunctionTest, OpStats) {
+  namespace profiler = torch::autograd::profiler;
+  EXPECT_EQ(profiler::opStatsBucket(0), 0);
+  EXPECT_EQ(profiler::opStatsBucket(1), 1);
+  EXPECT_EQ(profiler::opStatsBucket(1023), 10);
+  EXPECT_EQ(profiler::opStatsBucket(1024), 11);
+  EXPECT_EQ(
+      profiler::opStatsBucket(std::numeric_limits<uint64_t>::max()),
+      profiler::kOpStatsNumBuckets - 1);
+
+  profiler::OpStatsConfig config;
+  config.memory = true;
+  profiler::enableOpStats(config);
+  ASSERT_TRUE(profiler::isOpStatsEnabled());
+  profiler::resetOpStats();
+
+  auto run = []() {
+    auto t = torch::randn({4, 4}, at::kCPU);
+    for (int i = 0; i < 10; ++i) {
+      t.mm(t);
+    }
+  };
+  run();
+  std::thread thread(run);
+  thread.join();
+  {
+    RECORD_USER_SCOPE("test_op_stats_scope");
+    run();
+  }
+  profiler::disableOpStats();
+  ASSERT_FALSE(profiler::isOpStatsEnabled());
+  // disabled, not counted
+  run();
+
+  auto find = [](const std::vector<profiler::OpStats>& stats,
+                 const std::string& name) {
+    auto it = std::find_if(
+        stats.begin(), stats.end(), [&](const profiler::OpStats& op_stats) {
+          return op_stats.name == name;
+        });
+    TORCH_CHECK(it != stats.end(), "no stats for ", name);
+    return *it;
+  };
+  auto stats = profiler::getOpStats();
+  auto mm = find(stats, "aten::mm");
+  EXPECT_EQ(mm.count, 30);
+  uint64_t histogram_count = 0;
+  for (auto bucket : mm.cpu_histogram) {
+    histogram_count += bucket;
+  }
+  EXPECT_EQ(histogram_count, mm.count);
+  EXPECT_GT(mm.cpu_total_ns, 0);
+  EXPECT_EQ(mm.cuda_count, 0);
+  EXPECT_GE(mm.bytes_allocated, 30 * 16 * sizeof(float));
+
+  auto scope = find(stats, "test_op_stats_scope");
+  EXPECT_EQ(scope.count, 1);
+  EXPECT_GT(scope.cpu_total_ns, 0);
+  EXPECT_GE(scope.bytes_allocated, 10 * 16 * sizeof(float));
+
+  profiler::resetOpStats();
+  EXPECT_EQ(find(profiler::getOpStats(), "aten::mm").count, 0);
+}
+
+TEST(RecordFunctionTest, SamplingProfiler) {
+  namespace profiler = torch::autograd::profiler;
+  profiler::SamplingProfilerConfig config;
+  config.frequency_hz = 1000;
+  profiler::enableSamplingProfiler(config);
+  ASSERT_TRUE(profiler::isSamplingProfilerEnabled());
+
+  // Runs until some samples land in the scope, since the sampler may be
+  // delayed on a loaded machine
+  auto t = torch::randn({64, 64}, at::kCPU);
+  const std::string stack = "test_sampling_scope;aten::mm";
+  auto sampled = [&]() {
+    for (const auto& kv : profiler::getSampledStacks()) {
+      if (kv.first == stack) {
+        return true;
+      }
+    }
+    return false;
+  };
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(30);
+  while (!sampled() && std::chrono::steady_clock::now() < deadline) {
+    RECORD_USER_SCOPE("test_sampling_scope");
+    for (int i = 0; i < 100; ++i) {
+      t.mm(t);
+    }
+  }
+  profiler::disableSamplingProfiler();
+  ASSERT_FALSE(profiler::isSamplingProfilerEnabled());
+  ASSERT_TRUE(sampled());
+  EXPECT_GT(profiler::numStackSamples(), 0);
+
+  const auto folded = profiler::getFoldedStacks();
+  EXPECT_NE(folded.find(stack + " "), std::string::npos);
+
+  profiler::resetSampledStacks();
+  EXPECT_TRUE(profiler::getSampledStacks().empty());
+  EXPECT_EQ(profiler::numStackSamples(), 0);
+}
+
 class TestThreadLocalDebugInfo : public c10::DebugInfoBase {
  public:
   int getModelId() const {
@@ -2387,5 +2494,64 @@ TEST(ComputeFlopsTest, Basic) {
   ASSERT_EQ(flops, 360);
 }
 
+TEST(ComputeOpCostTest, Basic) {
+  // Unknown operator
+  ASSERT_FALSE(computeOpCost("aten::unknown", "", {}));
+
+  // aten::mm of [3, 4] by [4, 5] floats
+  auto cost = computeOpCost("aten::mm", "", {at::ones({3, 4}), at::ones({4, 5})});
+  ASSERT_TRUE(cost);
+  ASSERT_EQ(cost->flops, 2 * 3 * 4 * 5);
+  ASSERT_EQ(cost->bytes_read, (3 * 4 + 4 * 5) * 4);
+  ASSERT_EQ(cost->bytes_written, 3 * 5 * 4);
+
+  // aten::add.Tensor broadcasting [3, 1] with [4] doubles
+  cost = computeOpCost(
+      "aten::add", "Tensor", {at::ones({3, 1}, at::kDouble), at::ones({4}, at::kDouble), 1});
+  ASSERT_TRUE(cost);
+  ASSERT_EQ(cost->flops, 12);
+  ASSERT_EQ(cost->bytes_read, (3 + 4) * 8);
+  ASSERT_EQ(cost->bytes_written, 12 * 8);
+
+  // Inputs that don't broadcast
+  ASSERT_FALSE(computeOpCost("aten::add", "Tensor", {at::ones({3}), at::ones({4}), 1}));
+
+  // aten::sum.dim_IntList over dim 1 of [2, 3, 4]
+  cost = computeOpCost(
+      "aten::sum", "dim_IntList", {at::ones({2, 3, 4}), std::vector<int64_t>{1}, false, c10::IValue()});
+  ASSERT_TRUE(cost);
+  ASSERT_EQ(cost->flops, 24);
+  ASSERT_EQ(cost->bytes_written, 8 * 4);
+
+  // aten::conv2d agrees with computeFlops
+  cost = computeOpCost(
+      "aten::conv2d", "",
+      {at::ones({4, 5, 6, 7}), at::ones({3, 5, 2, 1}), c10::IValue(),
+       std::vector<int64_t>{1, 1}, std::vector<int64_t>{1, 0},
+       std::vector<int64_t>{1, 1}, 1});
+  ASSERT_TRUE(cost);
+  ASSERT_EQ(cost->flops, 2 * 4 * 3 * 7 * 7 * 5 * 2);
+  ASSERT_EQ(cost->bytes_written, 4 * 3 * 7 * 7 * 4);
+
+  // aten::embedding_bag of 6 indices in 2 bags of a [10, 8] table
+  cost = computeOpCost(
+      "aten::embedding_bag", "",
+      {at::ones({10, 8}), at::zeros({6}, at::kLong), at::zeros({2}, at::kLong),
+       false, 0, false, c10::IValue(), false});
+  ASSERT_TRUE(cost);
+  ASSERT_EQ(cost->flops, 6 * 8);
+  ASSERT_EQ(cost->bytes_written, 2 * 8 * 4);
+
+  // Overloads take precedence over the operator
+  registerOpCostFunction("aten::mm.test_overload", [](const std::vector<c10::IValue>&) {
+    OpCost cost;
+    cost.flops = 1;
+    return c10::optional<OpCost>(cost);
+  });
+  cost = computeOpCost("aten::mm", "test_overload", {at::ones({3, 4}), at::ones({4, 5})});
+  ASSERT_TRUE(cost);
+  ASSERT_EQ(cost->flops, 1);
+}
+
 } // namespace jit
 } // namespace torch
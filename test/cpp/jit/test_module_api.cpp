@@ -5,6 +5,8 @@
 #include <ATen/core/qualified_name.h>
 #include <torch/csrc/jit/api/module.h>
 #include <torch/csrc/jit/frontend/resolver.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/share_frozen_constants.h>
 #include <torch/csrc/jit/serialization/import.h>
 #include <torch/csrc/jit/serialization/import_source.h>
 #include <torch/csrc/jit/testing/file_check.h>
@@ -357,6 +359,43 @@ TEST(ModuleAPITest, Freezing) {
   ;
 }
 
+TEST(ModuleAPITest, FreezingSharesConstants) {
+  auto make_module = [](const at::Tensor& weight) {
+    Module m("m");
+    m.register_buffer("weight", weight);
+    m.define(R"(
+      def forward(self, x):
+        return x + self.weight
+    )");
+    m.eval();
+    return m;
+  };
+  auto constant_of = [](const Module& m) {
+    for (Node* n : m.get_method("forward").graph()->nodes()) {
+      if (n->kind() == prim::Constant &&
+          n->kindOf(attr::value) == AttributeKind::t) {
+        return n->t(attr::value);
+      }
+    }
+    return at::Tensor();
+  };
+
+  bool old_value = getShareFrozenConstants();
+  getShareFrozenConstants() = true;
+  auto a = freeze_module(make_module(torch::arange(8, at::kFloat)));
+  auto b = freeze_module(make_module(torch::arange(8, at::kFloat)));
+  auto c = freeze_module(make_module(torch::arange(8, at::kFloat) + 1));
+  getShareFrozenConstants() = old_value;
+
+  ASSERT_TRUE(constant_of(a).defined());
+  // same contents, same tensor
+  ASSERT_TRUE(constant_of(a).is_same(constant_of(b)));
+  ASSERT_FALSE(constant_of(a).is_same(constant_of(c)));
+  ASSERT_TRUE(constant_of(c).equal(torch::arange(8, at::kFloat) + 1));
+  auto x = torch::ones({8});
+  ASSERT_TRUE(a.forward({x}).toTensor().equal(b.forward({x}).toTensor()));
+}
+
 TEST(ModuleAPITest, To_CUDA) {
   Module m("test");
   {
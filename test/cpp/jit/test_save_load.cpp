@@ -120,6 +120,46 @@ TEST(SerializationTest, TypeTags) {
   }
 }
 
+TEST(SerializationTest, LazyMethodCompilation) {
+  Module sub("sub");
+  sub.register_parameter("weight", torch::ones({2, 2}), false);
+  sub.define(R"JIT(
+    def forward(self, x):
+        return x.mm(self.weight)
+  )JIT");
+  Module m("m");
+  m.register_module("sub", sub);
+  m.define(R"JIT(
+    def helper(self, x):
+        return x + 1
+
+    def forward(self, x):
+        return self.sub(self.helper(x))
+
+    def unused(self, x):
+        return x.t()
+  )JIT");
+  std::stringstream ss;
+  m.save(ss);
+
+  bool old_value = getLazyMethodCompilation();
+  getLazyMethodCompilation() = true;
+  ss.seekg(0);
+  auto loaded = torch::jit::load(ss);
+  getLazyMethodCompilation() = old_value;
+
+  // The methods are compiled when they are first called or inspected, after
+  // the archive has been closed by the load.
+  auto x = torch::ones({2, 2});
+  auto expected = (x + 1).mm(torch::ones({2, 2}));
+  ASSERT_TRUE(loaded.forward({x}).toTensor().equal(expected));
+  ASSERT_TRUE(loaded.get_method("helper")({x}).toTensor().equal(x + 1));
+  auto unused = loaded.get_method("unused");
+  ASSERT_EQ(unused.function().getSchema().arguments().size(), 2);
+  ASSERT_EQ(unused.num_inputs(), 2);
+  ASSERT_EQ(unused.graph()->outputs().size(), 1);
+}
+
 TEST(SerializationTest, TestJitStream_CUDA) {
   torch::jit::Module model;
   std::vector<torch::jit::IValue> inputs;
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/passes/substitute_inplace_ops.h>
+#include <torch/csrc/jit/testing/file_check.h>
+
+namespace torch {
+namespace jit {
+
+TEST(SubstituteInplaceOpsTest, Chain) {
+  auto graph = std::make_shared<Graph>();
+  parseIR(
+      R"IR(
+graph(%x : Float(2, 3, strides=[3, 1], requires_grad=0, device=cpu),
+      %y : Float(3, strides=[1], requires_grad=0, device=cpu)):
+  %one : int = prim::Constant[value=1]()
+  %two : float = prim::Constant[value=2.]()
+  %a : Float(2, 3, strides=[3, 1], requires_grad=0, device=cpu) = aten::add(%x, %y, %one)
+  %b : Float(2, 3, strides=[3, 1], requires_grad=0, device=cpu) = aten::relu(%a)
+  %c : Float(2, 3, strides=[3, 1], requires_grad=0, device=cpu) = aten::mul(%b, %y)
+  %d : Float(2, 3, strides=[3, 1], requires_grad=0, device=cpu) = aten::div(%c, %two)
+  return (%d)
+  )IR",
+      &*graph);
+  EXPECT_TRUE(SubstituteInplaceOps(graph));
+  // the input of add is a graph input, the other ones are dead temporaries
+  testing::FileCheck()
+      .check("aten::add(")
+      ->check("aten::relu_")
+      ->check("aten::mul_")
+      ->check("aten::div_")
+      ->run(*graph);
+}
+
+TEST(SubstituteInplaceOpsTest, LiveInputs) {
+  auto graph = std::make_shared<Graph>();
+  parseIR(
+      R"IR(
+graph(%x : Float(2, 3, strides=[3, 1], requires_grad=0, device=cpu)):
+  %minus_one : int = prim::Constant[value=-1]()
+  %a : Float(2, 3, strides=[3, 1], requires_grad=0, device=cpu) = aten::sigmoid(%x)
+  %b : Float(2, 3, strides=[3, 1], requires_grad=0, device=cpu) = aten::tanh(%a)
+  %size : int[] = prim::ListConstruct(%minus_one)
+  %v : Float(6, strides=[1], requires_grad=0, device=cpu) = aten::view(%b, %size)
+  %c : Float(2, 3, strides=[3, 1], requires_grad=0, device=cpu) = aten::exp(%b)
+  %d : Float(2, 3, strides=[3, 1], requires_grad=0, device=cpu) = aten::relu(%a)
+  return (%c, %d, %v)
+  )IR",
+      &*graph);
+  // a is used by relu after tanh, and v is a view of b used after exp
+  EXPECT_TRUE(SubstituteInplaceOps(graph));
+  testing::FileCheck()
+      .check("aten::sigmoid(")
+      ->check("aten::tanh(")
+      ->check("aten::exp(")
+      ->check("aten::relu_")
+      ->run(*graph);
+}
+
+TEST(SubstituteInplaceOpsTest, SizesAndTypes) {
+  auto graph = std::make_shared<Graph>();
+  parseIR(
+      R"IR(
+graph(%x : Float(3, strides=[1], requires_grad=0, device=cpu),
+      %y : Float(2, 3, strides=[3, 1], requires_grad=0, device=cpu),
+      %z : Tensor,
+      %i : Long(3, strides=[1], requires_grad=0, device=cpu)):
+  %a : Float(3, strides=[1], requires_grad=0, device=cpu) = aten::relu(%x)
+  %b : Float(2, 3, strides=[3, 1], requires_grad=0, device=cpu) = aten::mul(%a, %y)
+  %c : Tensor = aten::relu(%z)
+  %d : Tensor = aten::sigmoid(%c)
+  %e : Long(3, strides=[1], requires_grad=0, device=cpu) = aten::neg(%i)
+  %f : Long(3, strides=[1], requires_grad=0, device=cpu) = aten::abs(%e)
+  return (%b, %d, %f)
+  )IR",
+      &*graph);
+  // mul broadcasts a to a larger size, the dtype of c is unknown and f is
+  // not floating point
+  EXPECT_FALSE(SubstituteInplaceOps(graph));
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,248 @@
+#include <gtest/gtest.h>
+
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/passes/symbolic_shape_analysis.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+using c10::ShapeSymbol;
+using Dims = std::vector<ShapeSymbol>;
+
+ShapeSymbol sz(int64_t size) {
+  return ShapeSymbol::fromStaticSize(size);
+}
+
+// Parses ir and gives its first inputs the sizes in input_dims
+std::shared_ptr<Graph> parseGraph(
+    const std::string& ir,
+    const std::vector<Dims>& input_dims) {
+  auto graph = std::make_shared<Graph>();
+  parseIR(ir, graph.get());
+  // the first inputs are the tensors
+  for (size_t i = 0; i < input_dims.size(); ++i) {
+    graph->inputs()[i]->setType(TensorType::get()->withSymbolicShapes(
+        c10::SymbolicShape(input_dims[i])));
+  }
+  return graph;
+}
+
+c10::optional<Dims> outputDims(const std::shared_ptr<Graph>& graph, size_t i) {
+  return graph->outputs().at(i)->type()->expect<TensorType>()->symbolic_sizes()
+      .sizes();
+}
+
+} // namespace
+
+TEST(SymbolicShapeAnalysisTest, Broadcast) {
+  auto s0 = ShapeSymbol::newSymbol();
+  auto s1 = ShapeSymbol::newSymbol();
+  auto graph = parseGraph(
+      R"IR(
+graph(%x : Tensor, %y : Tensor):
+  %one : int = prim::Constant[value=1]()
+  %two : int = prim::Constant[value=2]()
+  %a : Tensor = aten::add(%x, %y, %one)
+  %b : Tensor = aten::mul(%x, %two)
+  %c : Tensor = aten::relu(%a)
+  return (%a, %b, %c)
+  )IR",
+      {{s0, sz(1), sz(4)}, {s1, sz(4)}});
+  PropagateSymbolicShapes(graph);
+  EXPECT_EQ(outputDims(graph, 0), Dims({s0, s1, sz(4)}));
+  EXPECT_EQ(outputDims(graph, 1), Dims({s0, sz(1), sz(4)}));
+  EXPECT_EQ(outputDims(graph, 2), outputDims(graph, 0));
+}
+
+TEST(SymbolicShapeAnalysisTest, BroadcastOfTwoSymbols) {
+  auto s0 = ShapeSymbol::newSymbol();
+  auto s1 = ShapeSymbol::newSymbol();
+  auto graph = parseGraph(
+      R"IR(
+graph(%x : Tensor, %y : Tensor):
+  %one : int = prim::Constant[value=1]()
+  %a : Tensor = aten::add(%x, %y, %one)
+  %b : Tensor = aten::sub(%y, %x, %one)
+  return (%a, %b)
+  )IR",
+      {{s0}, {s1}});
+  PropagateSymbolicShapes(graph);
+  auto a = outputDims(graph, 0);
+  ASSERT_TRUE(a.has_value());
+  ASSERT_EQ(a->size(), 1u);
+  EXPECT_FALSE((*a)[0].is_static());
+  EXPECT_FALSE((*a)[0] == s0);
+  EXPECT_FALSE((*a)[0] == s1);
+  // either order of the operands broadcasts to the same size
+  EXPECT_EQ(outputDims(graph, 1), a);
+}
+
+TEST(SymbolicShapeAnalysisTest, LinearAndMatmul) {
+  auto s0 = ShapeSymbol::newSymbol();
+  auto s1 = ShapeSymbol::newSymbol();
+  auto graph = parseGraph(
+      R"IR(
+graph(%x : Tensor, %w : Tensor, %m : Tensor, %v : Tensor):
+  %none : NoneType = prim::Constant()
+  %a : Tensor = aten::linear(%x, %w, %none)
+  %b : Tensor = aten::matmul(%x, %m)
+  %c : Tensor = aten::matmul(%v, %m)
+  return (%a, %b, %c)
+  )IR",
+      {{s0, s1, sz(16)}, {sz(32), sz(16)}, {sz(16), sz(8)}, {sz(16)}});
+  PropagateSymbolicShapes(graph);
+  EXPECT_EQ(outputDims(graph, 0), Dims({s0, s1, sz(32)}));
+  EXPECT_EQ(outputDims(graph, 1), Dims({s0, s1, sz(8)}));
+  EXPECT_EQ(outputDims(graph, 2), Dims({sz(8)}));
+}
+
+TEST(SymbolicShapeAnalysisTest, Conv2d) {
+  auto s0 = ShapeSymbol::newSymbol();
+  auto s1 = ShapeSymbol::newSymbol();
+  auto s2 = ShapeSymbol::newSymbol();
+  auto graph = parseGraph(
+      R"IR(
+graph(%x : Tensor, %w : Tensor, %y : Tensor):
+  %none : NoneType = prim::Constant()
+  %zero : int = prim::Constant[value=0]()
+  %one : int = prim::Constant[value=1]()
+  %two : int = prim::Constant[value=2]()
+  %ones : int[] = prim::ListConstruct(%one, %one)
+  %twos : int[] = prim::ListConstruct(%two, %two)
+  %zeros : int[] = prim::ListConstruct(%zero, %zero)
+  %same : Tensor = aten::conv2d(%x, %w, %none, %ones, %ones, %ones, %one)
+  %a : Tensor = aten::conv2d(%x, %w, %none, %twos, %zeros, %ones, %one)
+  %b : Tensor = aten::conv2d(%x, %w, %none, %twos, %zeros, %ones, %one)
+  %c : Tensor = aten::conv2d(%y, %w, %none, %twos, %zeros, %ones, %one)
+  return (%same, %a, %b, %c)
+  )IR",
+      {{s0, sz(3), s1, s2},
+       {sz(16), sz(3), sz(3), sz(3)},
+       {sz(2), sz(3), sz(9), sz(9)}});
+  PropagateSymbolicShapes(graph);
+  EXPECT_EQ(outputDims(graph, 0), Dims({s0, sz(16), s1, s2}));
+  auto a = outputDims(graph, 1);
+  ASSERT_TRUE(a.has_value());
+  ASSERT_EQ(a->size(), 4u);
+  EXPECT_EQ((*a)[0], s0);
+  EXPECT_FALSE((*a)[2].is_static());
+  EXPECT_FALSE((*a)[2] == (*a)[3]);
+  // the same convolution of the same input
+  EXPECT_EQ(outputDims(graph, 2), a);
+  EXPECT_EQ(outputDims(graph, 3), Dims({sz(2), sz(16), sz(4), sz(4)}));
+}
+
+TEST(SymbolicShapeAnalysisTest, Cat) {
+  auto s0 = ShapeSymbol::newSymbol();
+  auto s1 = ShapeSymbol::newSymbol();
+  auto graph = parseGraph(
+      R"IR(
+graph(%x : Tensor, %y : Tensor, %z : Tensor):
+  %zero : int = prim::Constant[value=0]()
+  %xy : Tensor[] = prim::ListConstruct(%x, %y)
+  %yx : Tensor[] = prim::ListConstruct(%y, %x)
+  %zz : Tensor[] = prim::ListConstruct(%z, %z)
+  %a : Tensor = aten::cat(%xy, %zero)
+  %b : Tensor = aten::cat(%yx, %zero)
+  %c : Tensor = aten::cat(%zz, %zero)
+  return (%a, %b, %c)
+  )IR",
+      {{s0, sz(4)}, {s1, sz(4)}, {sz(3), sz(4)}});
+  PropagateSymbolicShapes(graph);
+  auto a = outputDims(graph, 0);
+  ASSERT_TRUE(a.has_value());
+  ASSERT_EQ(a->size(), 2u);
+  EXPECT_FALSE((*a)[0].is_static());
+  EXPECT_EQ((*a)[1], sz(4));
+  EXPECT_EQ(outputDims(graph, 1), a);
+  EXPECT_EQ(outputDims(graph, 2), Dims({sz(6), sz(4)}));
+}
+
+TEST(SymbolicShapeAnalysisTest, ViewWithSizeOfInput) {
+  auto s0 = ShapeSymbol::newSymbol();
+  auto s1 = ShapeSymbol::newSymbol();
+  auto graph = parseGraph(
+      R"IR(
+graph(%x : Tensor):
+  %zero : int = prim::Constant[value=0]()
+  %one : int = prim::Constant[value=1]()
+  %minus_one : int = prim::Constant[value=-1]()
+  %n : int = aten::size(%x, %zero)
+  %size : int[] = prim::ListConstruct(%n, %minus_one)
+  %a : Tensor = aten::view(%x, %size)
+  %b : Tensor = aten::flatten(%x, %one, %minus_one)
+  %sizes : int[] = aten::size(%x)
+  %c : Tensor = aten::reshape(%a, %sizes)
+  return (%a, %b, %c)
+  )IR",
+      {{s0, sz(3), s1}});
+  PropagateSymbolicShapes(graph);
+  auto a = outputDims(graph, 0);
+  ASSERT_TRUE(a.has_value());
+  ASSERT_EQ(a->size(), 2u);
+  EXPECT_EQ((*a)[0], s0);
+  EXPECT_FALSE((*a)[1].is_static());
+  // view(n, -1) and flatten(1) both multiply the other dimensions
+  EXPECT_EQ(outputDims(graph, 1), a);
+  EXPECT_EQ(outputDims(graph, 2), Dims({s0, sz(3), s1}));
+}
+
+TEST(SymbolicShapeAnalysisTest, Reductions) {
+  auto s0 = ShapeSymbol::newSymbol();
+  auto s1 = ShapeSymbol::newSymbol();
+  auto graph = parseGraph(
+      R"IR(
+graph(%x : Tensor):
+  %none : NoneType = prim::Constant()
+  %false : bool = prim::Constant[value=0]()
+  %true : bool = prim::Constant[value=1]()
+  %one : int = prim::Constant[value=1]()
+  %dims : int[] = prim::ListConstruct(%one)
+  %a : Tensor = aten::sum(%x, %dims, %false, %none)
+  %b : Tensor = aten::mean(%x, %dims, %true, %none)
+  %c : Tensor = aten::sum(%x, %none)
+  return (%a, %b, %c)
+  )IR",
+      {{s0, s1, sz(4)}});
+  PropagateSymbolicShapes(graph);
+  EXPECT_EQ(outputDims(graph, 0), Dims({s0, sz(4)}));
+  EXPECT_EQ(outputDims(graph, 1), Dims({s0, sz(1), sz(4)}));
+  EXPECT_EQ(outputDims(graph, 2), Dims());
+}
+
+TEST(SymbolicShapeAnalysisTest, ControlFlow) {
+  auto s0 = ShapeSymbol::newSymbol();
+  auto graph = parseGraph(
+      R"IR(
+graph(%x : Tensor, %y : Tensor, %cond : bool, %n : int):
+  %zero : int = prim::Constant[value=0]()
+  %a : Tensor = prim::If(%cond)
+    block0():
+      %r : Tensor = aten::relu(%x)
+      -> (%r)
+    block1():
+      -> (%x)
+  %b : Tensor = prim::Loop(%n, %cond, %x)
+    block0(%i : int, %acc : Tensor):
+      %list : Tensor[] = prim::ListConstruct(%acc, %y)
+      %next : Tensor = aten::cat(%list, %zero)
+      -> (%cond, %next)
+  return (%a, %b)
+  )IR",
+      {{s0, sz(4)}, {sz(1), sz(4)}});
+  PropagateSymbolicShapes(graph);
+  EXPECT_EQ(outputDims(graph, 0), Dims({s0, sz(4)}));
+  auto b = outputDims(graph, 1);
+  ASSERT_TRUE(b.has_value());
+  ASSERT_EQ(b->size(), 2u);
+  // the loop grows the first dimension
+  EXPECT_FALSE((*b)[0].is_static());
+  EXPECT_FALSE((*b)[0] == s0);
+  EXPECT_EQ((*b)[1], sz(4));
+}
+
+} // namespace jit
+} // namespace torch
@@ -49,6 +49,39 @@ TEST(WireSerialize, RecopySparseTensors) {
   EXPECT_LT(ser.size(), (tiny.element_size() * k1K) + k1K);
 }
 
+TEST(WireSerialize, NoCopy) {
+  constexpr size_t k1K = 1024;
+  at::Tensor big = torch::randn({k1K, k1K});
+  at::Tensor row = big.select(0, 2);
+  at::Tensor column = big.select(1, 2);
+  std::vector<char> payload = {'h', 'i'};
+  auto ser = torch::distributed::rpc::wireSerializeNoCopy(
+      payload, {big, row, column});
+  // big and the row share the data of big, the column is cloned.
+  ASSERT_EQ(ser.second.size(), 3);
+  EXPECT_EQ(ser.second[0].data_ptr(), big.data_ptr());
+  EXPECT_EQ(ser.second[1].data_ptr(), row.data_ptr());
+  EXPECT_EQ(ser.second[1].numel(), row.numel() * row.element_size());
+  EXPECT_EQ(ser.second[2].numel(), column.numel() * column.element_size());
+
+  auto sizes = torch::distributed::rpc::wireTensorSectionSizes(
+      ser.first.data(), ser.first.size());
+  ASSERT_EQ(sizes.size(), ser.second.size());
+  std::vector<at::Tensor> received;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    EXPECT_EQ(sizes[i], ser.second[i].numel());
+    received.push_back(ser.second[i].clone());
+  }
+  auto deser = torch::distributed::rpc::wireDeserializeNoCopy(
+      ser.first.data(), ser.first.size(), received);
+  EXPECT_EQ(deser.first, payload);
+  ASSERT_EQ(deser.second.size(), 3);
+  EXPECT_TRUE(torch::equal(big, deser.second[0]));
+  EXPECT_TRUE(torch::equal(row, deser.second[1]));
+  EXPECT_TRUE(torch::equal(column, deser.second[2]));
+  EXPECT_EQ(deser.second[0].data_ptr(), received[0].data_ptr());
+}
+
 TEST(WireSerialize, CloneSparseTensors) {
   constexpr size_t k1K = 1024;
   at::Tensor big = torch::randn({k1K, k1K});
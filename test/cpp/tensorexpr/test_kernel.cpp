@@ -9,7 +9,9 @@
 #include <torch/csrc/jit/tensorexpr/tensor.h>
 #include <torch/csrc/jit/testing/file_check.h>
 #include <torch/torch.h>
+#include <c10/util/tempfile.h>
 #include <cmath>
+#include <fstream>
 #include <sstream>
 #include <stdexcept>
 
@@ -949,6 +951,43 @@ TEST(Kernel, Softmax4D) {
   }
 }
 
+TEST(Kernel, MatmulWithEpilogue) {
+  const auto graph_template = R"IR(
+      graph(%a : Float(4, 3, strides=[3, 1], device=${device}),
+            %b : Float(3, 5, strides=[5, 1], device=${device}),
+            %c : Float(4, 5, strides=[5, 1], device=${device})):
+        %one : int = prim::Constant[value=1]()
+        %1 : Float(4, 5, strides=[5, 1]) = aten::mm(%a, %b)
+        %2 : Float(4, 5, strides=[5, 1]) = aten::add(%1, %c, %one)
+        %3 : Float(4, 5, strides=[5, 1]) = aten::relu(%2)
+        return (%3))IR";
+  for (bool use_cuda : {false, true}) {
+    if (!torch::cuda::is_available() && use_cuda) {
+      continue;
+    }
+    auto device = use_cuda ? kCUDA : kCPU;
+    auto options = TensorOptions(device).dtype(at::kFloat);
+    auto a = at::rand({4, 3}, options);
+    auto b = at::rand({3, 5}, options);
+    auto c = at::rand({4, 5}, options) - 1.f;
+    auto ref = at::relu(at::mm(a, b) + c);
+
+    KernelScope kernel_scope;
+    TemplateEnv env;
+    env.s("device", use_cuda ? "cuda:0" : "cpu");
+    const auto graph_string = format(graph_template, env);
+    auto graph = std::make_shared<Graph>();
+    parseIR(graph_string, &*graph);
+    TensorExprKernel k(graph);
+    std::vector<at::Tensor> inputs = {a, b, c};
+    std::vector<IValue> stack = fmap<IValue>(inputs);
+    k.run(stack);
+    auto output = stack[0].toTensor();
+    ASSERT_EQ(output.sizes(), ref.sizes());
+    ASSERT_TRUE(at::allclose(output, ref));
+  }
+}
+
 TEST(Kernel, DISABLED_InlineProducerIntoReduction) {
   // see : [zero-dim tensors]
   KernelScope kernel_scope;
@@ -1035,5 +1074,45 @@ TEST(Kernel, DISABLED_InlineReductionIntoConsumer) {
   ASSERT_TRUE(at::allclose(o, ref));
 }
 
+#ifdef TORCH_ENABLE_LLVM
+TEST(Kernel, TuneCPUSchedule) {
+  const auto graph_string = R"IR(
+      graph(%0 : Float(64, 3, strides=[3, 1], device=cpu),
+            %1 : Float(64, 3, strides=[3, 1], device=cpu)):
+        %2 : Float(64, 3, strides=[3, 1]) = aten::mul(%0, %1)
+        %3 : Float(64, 3, strides=[3, 1]) = aten::mul(%0, %2)
+        return (%3))IR";
+  auto a = at::rand({64, 3}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto b = at::rand({64, 3}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto ref = a * (a * b);
+
+  auto db = c10::make_tempfile();
+  const bool old_tune = getTETuneCPUKernels();
+  const std::string old_path = getTETuningDatabasePath();
+  getTETuningDatabasePath() = db.name;
+  // The first kernel is tuned, the second one uses the schedule it stored.
+  for (bool tune : {true, false}) {
+    getTETuneCPUKernels() = tune;
+    KernelScope kernel_scope;
+    auto graph = std::make_shared<Graph>();
+    parseIR(graph_string, &*graph);
+    TensorExprKernel k(graph);
+    std::vector<IValue> stack = fmap<IValue>(std::vector<at::Tensor>{a, b});
+    k.run(stack);
+    ASSERT_TRUE(at::allclose(stack[0].toTensor(), ref));
+  }
+  getTETuneCPUKernels() = old_tune;
+  getTETuningDatabasePath() = old_path;
+
+  std::ifstream file(db.name);
+  std::string line;
+  int lines = 0;
+  while (std::getline(file, line)) {
+    lines++;
+  }
+  ASSERT_EQ(lines, 1);
+}
+#endif // TORCH_ENABLE_LLVM
+
 } // namespace jit
 } // namespace torch
@@ -6,6 +6,7 @@
 #include <test/cpp/tensorexpr/padded_buffer.h>
 #include <test/cpp/tensorexpr/test_utils.h>
 #include <torch/csrc/jit/tensorexpr/eval.h>
+#include <torch/csrc/jit/tensorexpr/execution_counter.h>
 #include <torch/csrc/jit/tensorexpr/ir.h>
 #include <torch/csrc/jit/tensorexpr/ir_printer.h>
 #include <torch/csrc/jit/tensorexpr/ir_simplifier.h>
@@ -16,6 +17,11 @@
 #include <cmath>
 #include <numeric>
 
+#ifndef _WIN32
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
 namespace torch {
 namespace jit {
 using namespace torch::jit::tensorexpr;
@@ -1507,6 +1513,82 @@ TEST(LLVM, RFactorReduction) {
   ExpectAllNear(b_v, b_ref, 1e-5);
 }
 
+TEST(LLVM, ParallelizedLoop) {
+  KernelScope kernel_scope;
+  const int M = 64;
+  const int N = 32;
+  Placeholder a(BufHandle("a", {M, N}, kFloat));
+  Placeholder b(BufHandle("b", {N}, kFloat));
+  Tensor* c = Compute(
+      "c", {{M, "m"}, {N, "n"}}, [&](const VarHandle& m, const VarHandle& n) {
+        return a.load(m, n) * b.load(n) + cast<float>(m);
+      });
+  LoopNest l({c});
+  std::vector<For*> loops = l.getLoopStmtsFor(c);
+  l.parallelize(loops[0]);
+  l.prepareForCodegen();
+  Stmt* s = IRSimplifier::simplify(l.root_stmt());
+  std::ostringstream oss;
+  oss << *s;
+  ASSERT_NE(oss.str().find("parallel"), std::string::npos);
+
+  LLVMCodeGen cg(s, {a, b, c});
+
+  PaddedBuffer<float> a_v(M, N, "a_v");
+  PaddedBuffer<float> b_v(N, "b_v");
+  PaddedBuffer<float> c_v(M, N, "c_v");
+  PaddedBuffer<float> c_ref(M, N, "c_ref");
+  for (int m = 0; m < M; m++) {
+    for (int n = 0; n < N; n++) {
+      a_v(m, n) = m + n;
+    }
+  }
+  for (int n = 0; n < N; n++) {
+    b_v(n) = 0.5f * n;
+  }
+  for (int m = 0; m < M; m++) {
+    for (int n = 0; n < N; n++) {
+      c_ref(m, n) = a_v(m, n) * b_v(n) + m;
+    }
+  }
+
+  cg.call({a_v, b_v, c_v});
+
+  ExpectAllNear(c_v, c_ref, 1e-5);
+}
+
+TEST(LLVM, ParallelizedReduction) {
+  KernelScope kernel_scope;
+  const int M = 64;
+  const int N = 128;
+  Placeholder a("a", kFloat, {M, N});
+  Tensor* b = Reduce("sum", {{M, "m"}}, Sum(), a, {{N, "n"}});
+  LoopNest l({b});
+  std::vector<For*> loops = l.getLoopStmtsFor(b);
+  // Every iteration of the reduction axis accumulates into the same element
+  ASSERT_THROW(l.parallelize(loops[1]), std::logic_error);
+  l.parallelize(loops[0]);
+  l.prepareForCodegen();
+  Stmt* s = IRSimplifier::simplify(l.root_stmt());
+
+  LLVMCodeGen cg(s, {a, b});
+
+  PaddedBuffer<float> a_v(M, N, "a_v");
+  PaddedBuffer<float> b_v(M, "b_v");
+  PaddedBuffer<float> b_ref(M, "b_ref");
+  for (int m = 0; m < M; m++) {
+    b_ref(m) = 0;
+    for (int n = 0; n < N; n++) {
+      a_v(m, n) = m - n;
+      b_ref(m) += m - n;
+    }
+  }
+
+  cg.call({a_v, b_v});
+
+  ExpectAllNear(b_v, b_ref, 1e-5);
+}
+
 TEST(LLVM, RFactorVectorizedReduction) {
   KernelScope kernel_scope;
 
@@ -1650,6 +1732,69 @@ TEST(LLVM, VectorizedGEMM) {
   ExpectAllNear(c_v, c_ref, 1e-5);
 }
 
+#ifndef _WIN32
+static std::vector<std::string> listDir(const std::string& dir) {
+  std::vector<std::string> files;
+  DIR* d = opendir(dir.c_str());
+  while (dirent* entry = readdir(d)) {
+    std::string name = entry->d_name;
+    if (name != "." && name != "..") {
+      files.push_back(dir + "/" + name);
+    }
+  }
+  closedir(d);
+  return files;
+}
+
+TEST(LLVM, KernelCache) {
+  char dir_template[] = "/tmp/nnc_llvm_cache_XXXXXX";
+  ASSERT_NE(mkdtemp(dir_template), nullptr);
+  const std::string dir = dir_template;
+  const std::string old_dir = getLLVMKernelCacheDir();
+  getLLVMKernelCacheDir() = dir;
+
+  ExecutionCounter hits(*ExecutionTriggerList::GetInstance().FindByName(
+      "llvm_codegen_cache_hit"));
+  constexpr int N = 1024;
+  auto run = [&](int increment) {
+    KernelScope kernel_scope;
+    Placeholder a(BufHandle("A", {N}, kFloat));
+    Placeholder b(BufHandle("B", {N}, kFloat));
+    VarHandle i("i", kInt);
+    auto stmt = For::make(
+        i, 0, N, b.store({i}, a.load(i) + FloatImm::make(increment)));
+    LLVMCodeGen cg(stmt, {a, b});
+
+    PaddedBuffer<float> a_v(N);
+    PaddedBuffer<float> b_v(N);
+    for (int j = 0; j < N; j++) {
+      a_v(j) = j;
+    }
+    cg.call({a_v, b_v});
+    for (int j = 0; j < N; j++) {
+      ASSERT_EQ(b_v(j), j + increment);
+    }
+  };
+
+  run(1);
+  ASSERT_EQ(hits.elapsed_value(), 0);
+  ASSERT_EQ(listDir(dir).size(), 1);
+  // The same kernel is loaded from the cache.
+  run(1);
+  ASSERT_EQ(hits.elapsed_value(), 1);
+  // Another kernel is not.
+  run(2);
+  ASSERT_EQ(hits.elapsed_value(), 1);
+  ASSERT_EQ(listDir(dir).size(), 2);
+
+  getLLVMKernelCacheDir() = old_dir;
+  for (const auto& file : listDir(dir)) {
+    unlink(file.c_str());
+  }
+  rmdir(dir.c_str());
+}
+#endif // _WIN32
+
 } // namespace jit
 } // namespace torch
 
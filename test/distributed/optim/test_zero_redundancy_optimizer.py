@@ -308,6 +308,40 @@ class TestZeroRedundancyOptimizerDistributed(TestZeroRedundancyOptimizer):
             self.assertEqual(m.weight, torch.tensor([[1.1]]))
             self.assertEqual(m.bias, torch.tensor([2.1]))
 
+    @skip_if_rocm
+    def test_overlap_param_sync_with_forward(self):
+        """ Check that deferring the parameter broadcasts to the next forward gives the same parameters"""
+        if self.rank > 1 or (BACKEND == dist.Backend.NCCL and torch.cuda.device_count() < 2):
+            return
+
+        self.dist_init(self.rank, world_size=2)
+
+        context = suppress() if not torch.cuda.is_available() else torch.cuda.device(self.rank)
+
+        with context:
+            torch.manual_seed(0)
+            model = torch.nn.Sequential(torch.nn.Linear(4, 8), torch.nn.ReLU(), torch.nn.Linear(8, 2)).to(self.device)
+            reference = copy.deepcopy(model)
+
+            o = ZeroRedundancyOptimizer(model.parameters(), optim=SGD, lr=0.1)
+            o.overlap_param_sync_with_forward(model)
+            reference_o = SGD(reference.parameters(), lr=0.1)
+
+            torch.manual_seed(self.rank)
+            for _ in range(3):
+                x = torch.rand(3, 4, device=self.device)
+                for m, opt in ((model, o), (reference, reference_o)):
+                    opt.zero_grad()
+                    m(x).sum().backward()
+                    for p in m.parameters():
+                        dist.all_reduce(p.grad.data, op=dist.ReduceOp.SUM)
+                        p.grad.data /= self.world_size
+                    opt.step()
+
+            o.sync_params()
+            for p, reference_p in zip(model.parameters(), reference.parameters()):
+                self.assertEqual(p, reference_p)
+
     def test_sharding(self):
         """ Check the sharding at construction time"""
         self.dist_init(self.rank)
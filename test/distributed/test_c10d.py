@@ -340,6 +340,22 @@ class TCPStoreTest(TestCase, StoreTestBase):
     def test_numkeys_delkeys(self):
         self._test_numkeys_delkeys(self._create_store())
 
+    def test_multi_set_get(self):
+        store = self._create_store()
+        store.multi_set(["key0", "key1"], ["value0", "value1"])
+        self.assertEqual([b"value1", b"value0"], store.multi_get(["key1", "key0"]))
+        self.assertEqual(b"value0", store.get("key0"))
+        with self.assertRaisesRegex(ValueError, "as many values as keys"):
+            store.multi_set(["key0"], [])
+
+    def test_compare_set(self):
+        store = self._create_store()
+        self.assertEqual(b"old", store.compare_set("key", "old", "new"))
+        self.assertEqual(b"first", store.compare_set("key", "", "first"))
+        self.assertEqual(b"first", store.compare_set("key", "old", "new"))
+        self.assertEqual(b"second", store.compare_set("key", "first", "second"))
+        self.assertEqual(b"second", store.get("key"))
+
 
 class PrefixTCPStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -923,6 +939,28 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
         inputs = [torch.tensor([i + self.rank]).cuda() for i in range(1000)]
         self._test_allreduce_stress(inputs)
 
+    def test_allreduce_chunked(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        opts = self.opts(threads=4)
+        opts.allreduce_chunk_bytes = 1024
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, opts)
+
+        # Split in 3 chunks of uneven sizes, then in 2, then not split.
+        for numel in [1001, 600, 300]:
+            tensor = torch.arange(numel, dtype=torch.float32).view(-1, 1) + self.rank
+            work = pg.allreduce([tensor])
+            work.wait()
+            expected = (torch.arange(numel, dtype=torch.float32).view(-1, 1) * self.world_size +
+                        self.world_size * (self.world_size - 1) / 2)
+            self.assertEqual(expected, tensor)
+            self.assertEqual([tensor], work.result())
+
+        # Chunks are consumed in order with the other collectives.
+        works = [pg.allreduce([torch.ones(1000) * i]) for i in range(10)]
+        works.append(pg.broadcast([torch.ones(10) * self.rank]))
+        for work in works:
+            work.wait()
+
     def test_allreduce_coalesced_checks(self):
         store = c10d.FileStore(self.file_name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
@@ -1672,6 +1710,35 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
             pg.broadcast(tensor, root=0).wait()
             self.assertEqual(torch.full([100, 100], 0.0), tensor)
 
+    @skip_if_win32()
+    def test_round_robin_split(self):
+        num_process_groups = 3
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d._round_robin_process_groups(
+            [
+                c10d.ProcessGroupGloo(
+                    c10d.PrefixStore(str(i), store), self.rank, self.world_size
+                )
+                for i in range(num_process_groups)
+            ],
+            split_threshold_bytes=1024,
+        )
+
+        # Large tensors are split across all process groups, small ones go
+        # to the least loaded one
+        for size in [10, 1000, 1001, 10]:
+            tensor = torch.arange(size, dtype=torch.float) + self.rank
+            pg.allreduce(tensor).wait()
+            expected = torch.arange(size, dtype=torch.float) * self.world_size
+            expected += sum(range(self.world_size))
+            self.assertEqual(expected, tensor)
+
+            tensor = torch.full([size], float(self.rank))
+            work = pg.broadcast(tensor, root=0)
+            work.wait()
+            self.assertEqual(torch.zeros(size), tensor)
+            self.assertEqual(torch.zeros(size), work.result()[0])
+
     @skip_if_win32()
     def test_round_robin_create_destroy(self):
         store = c10d.FileStore(self.file_name, self.world_size)
@@ -1990,6 +2057,34 @@ class ProcessGroupNCCLTest(TestCase):
             # TODO(#38095): Replace assertEqualIgnoreType. See issue #38095
             self.assertEqualIgnoreType(expected, output[i])
 
+    @requires_nccl()
+    def test_round_robin_split(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d._round_robin_process_groups(
+            [
+                c10d.ProcessGroupNCCL(
+                    c10d.PrefixStore(str(i), store), self.rank, self.world_size
+                )
+                for i in range(2)
+            ],
+            split_threshold_bytes=1024,
+        )
+
+        # Each part runs on its own communicator, and the future of the work
+        # completes once all of them did, also on the CUDA streams
+        size = 100000
+        tensors = [
+            torch.arange(size, dtype=torch.float, device=i) + i
+            for i in range(self.num_gpus)
+        ]
+        fut = pg.allreduce(tensors).get_future()
+        fut = fut.then(lambda fut: [t * 2 for t in fut.value()])
+        expected = torch.arange(size, dtype=torch.float) * self.num_gpus
+        expected += sum(range(self.num_gpus))
+        for i, result in enumerate(fut.wait()):
+            self.assertEqual(expected.cuda(i) * 2, result)
+            self.assertEqual(expected.cuda(i), tensors[i])
+
     @requires_nccl()
     def test_barrier(self):
         store = c10d.FileStore(self.file.name, self.world_size)
@@ -2319,6 +2414,43 @@ class DistributedDataParallelTest(MultiProcessTestCase):
     def test_gloo_backend_cpu_module_grad_is_view(self):
         self._test_gloo_backend([torch.device("cpu")], [], gradient_as_bucket_view=True)
 
+    @requires_gloo()
+    def test_accumulate_gradients_no_sync_into_bucket_views(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        options = c10d.ProcessGroupGloo.Options()
+        options.devices = [create_device(interface=LOOPBACK)]
+        process_group = c10d.ProcessGroupGloo(
+            store, self.rank, self.world_size, options
+        )
+
+        torch.manual_seed(0)
+        model = nn.Sequential(nn.Linear(2, 4), nn.ReLU(), nn.Linear(4, 2))
+        ddp_model = DistributedDataParallel(
+            copy.deepcopy(model),
+            process_group=process_group,
+            gradient_as_bucket_view=True,
+        )
+        # Each rank runs the same micro-batches, so the averaged gradients
+        # are the local ones.
+        inputs = [torch.rand(3, 2) for _ in range(3)]
+
+        with ddp_model.no_sync():
+            for input in inputs[:-1]:
+                ddp_model(input).sum().backward()
+                # Accumulated in place, in the buckets.
+                bucket_storages = [
+                    t[0].storage().data_ptr()
+                    for t in ddp_model.reducer.get_bucket_tensors()
+                ]
+                for p in ddp_model.parameters():
+                    self.assertIn(p.grad.storage().data_ptr(), bucket_storages)
+        ddp_model(inputs[-1]).sum().backward()
+
+        for input in inputs:
+            model(input).sum().backward()
+        for p, ddp_p in zip(model.parameters(), ddp_model.parameters()):
+            self.assertEqual(p.grad, ddp_p.grad)
+
     @requires_gloo()
     @skip_if_not_multigpu
     def test_gloo_backend_1gpu_module_device_ids_integer_list(self):
@@ -3783,8 +3915,8 @@ class DistributedDataParallelTest(MultiProcessTestCase):
 
     def _test_builtin_ddp_comm_hooks_nccl(self, gradient_as_bucket_view=False):
         """
-        This unit test verifies whether built-in C++ DDP communication hooks ALLREDUCE and FP16_COMPRESS
-        can give the same result with the case of no hook registered.
+        This unit test verifies whether built-in C++ DDP communication hooks ALLREDUCE and the
+        compression hooks can give the same result with the case of no hook registered.
         """
         store = c10d.FileStore(self.file_name, self.world_size)
         process_group = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
@@ -3792,6 +3924,9 @@ class DistributedDataParallelTest(MultiProcessTestCase):
         for comm_hook_type in [
             dist.BuiltinCommHookType.ALLREDUCE,
             dist.BuiltinCommHookType.FP16_COMPRESS,
+            dist.BuiltinCommHookType.BF16_COMPRESS,
+            dist.BuiltinCommHookType.FP16_COMPRESS_WITH_ERROR_FEEDBACK,
+            dist.BuiltinCommHookType.BF16_COMPRESS_WITH_ERROR_FEEDBACK,
         ]:
             # Get GPU model with the built-in communication hook.
             gpu_model = self._gpu_model_with_builtin_ddp_comm_hook(
@@ -4159,6 +4294,33 @@ class ReducerTest(TestCase):
             output.backward()
             optimizer.step()
 
+    def test_rebuild_buckets_periodically(self):
+        batch_size = 10
+        model = ReducerModule()
+        reducer = self._create_reducer_for_models([model])
+        reducer._set_bucket_rebuild_period(2)
+        loss = nn.CrossEntropyLoss()
+        rebuilt = []
+        for i in range(6):
+            rebuilt.append(reducer._rebuild_buckets())
+            input = torch.rand([batch_size, 2])
+            target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+            output = loss(model(input), target)
+            reducer.prepare_for_backward(output)
+            output.backward()
+            for parameter in model.parameters():
+                self.assertIsNotNone(parameter.grad)
+
+        # Buckets are rebuilt after the first iteration. The gradient order of
+        # this model is fixed, so periodic rebuilds keep the assignment.
+        self.assertEqual([False, True, False, False, False, False], rebuilt)
+
+    def test_rebuild_buckets_periodically_unused_parameters(self):
+        model = ReducerModule()
+        reducer = self._create_reducer_for_models([model], find_unused_parameters=True)
+        with self.assertRaisesRegex(RuntimeError, "find_unused_parameters"):
+            reducer._set_bucket_rebuild_period(2)
+
     def test_ddp_comm_hook_multiple_replica_check(self):
         """
         DDP communication hook does not support single process multiple device mode.
@@ -4636,6 +4798,76 @@ class CommTest(MultiProcessTestCase):
         with self.assertRaisesRegex(RuntimeError, "device_ids not supported"):
             c10d.barrier(device_ids=[self.rank])
 
+
+class HierarchicalAllreduceTest(MultiProcessTestCase):
+    def setUp(self):
+        super(HierarchicalAllreduceTest, self).setUp()
+        self._fork_processes()
+
+    def tearDown(self):
+        super(HierarchicalAllreduceTest, self).tearDown()
+        try:
+            os.remove(self.file_name)
+        except OSError:
+            pass
+
+    @property
+    def world_size(self):
+        return 4
+
+    @requires_nccl()
+    @skip_if_lt_x_gpu(4)
+    def test_hierarchical_allreduce(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        options = c10d.ProcessGroupNCCL.Options()
+        # two "nodes" of two ranks each
+        options.local_size = 2
+        pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size, options)
+        device = torch.device("cuda:%d" % self.rank)
+
+        # odd numbers of elements have a tail allreduced by the flat communicator
+        for numel in [1, 2, 7, 1024, 1025]:
+            for op, expected in [
+                (c10d.ReduceOp.SUM, 1 + 2 + 3 + 4),
+                (c10d.ReduceOp.MAX, 4),
+                (c10d.ReduceOp.MIN, 1),
+            ]:
+                base = torch.arange(numel, dtype=torch.float32, device=device)
+                t = base * (self.rank + 1)
+                opts = c10d.AllreduceOptions()
+                opts.reduceOp = op
+                pg.allreduce([t], opts).wait()
+                self.assertEqual(t, base * expected)
+
+    @requires_nccl()
+    @requires_nccl_version(2700, "Need NCCL 2.7+ for send/recv")
+    @skip_if_lt_x_gpu(4)
+    def test_hierarchical_alltoall(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        options = c10d.ProcessGroupNCCL.Options()
+        options.local_size = 2
+        pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size, options)
+        device = torch.device("cuda:%d" % self.rank)
+
+        for chunk in [1, 3, 256]:
+            # element k of the chunk sent by rank src to rank dst
+            input = torch.stack([
+                torch.arange(chunk, dtype=torch.float32) + 1000 * (self.rank * self.world_size + dst)
+                for dst in range(self.world_size)
+            ]).view(-1).to(device)
+            output = torch.empty_like(input)
+            pg.alltoall_base(output, input, [], [], c10d.AllToAllOptions()).wait()
+            expected = torch.stack([
+                torch.arange(chunk, dtype=torch.float32) + 1000 * (src * self.world_size + self.rank)
+                for src in range(self.world_size)
+            ]).view(-1).to(device)
+            self.assertEqual(output, expected)
+
+        sent, received = pg._get_alltoall_bytes()
+        self.assertEqual(sent, [(1 + 3 + 256) * 4] * self.world_size)
+        self.assertEqual(received, [(1 + 3 + 256) * 4] * self.world_size)
+
+
 if __name__ == '__main__':
     assert (
         not torch.cuda._initialized
@@ -1502,6 +1502,70 @@ class TestFrozenOptimizations(JitTestCase):
             test_conv_fusion(use_bias, nn.Conv2d, False, pytorch_op, False,
                              add_tensor=torch.rand(1).to(torch.int), expect_success=False)
 
+    def test_concat_frozen_linear(self):
+        class QKV(nn.Module):
+            def __init__(self):
+                super(QKV, self).__init__()
+                self.q = nn.Linear(16, 16)
+                self.k = nn.Linear(16, 16, bias=False)
+                self.v = nn.Linear(16, 8)
+
+            def forward(self, x):
+                q = self.q(x).view(2, 4, 4, 4)
+                return q, self.k(x) * 2, self.v(x)
+
+        mod_eager = QKV().eval()
+        inp = torch.rand(2, 4, 16)
+        scripted_mod = torch.jit.freeze(torch.jit.script(mod_eager), optimize_numerics=False)
+        FileCheck().check_count("aten::linear", 3, exactly=True).run(scripted_mod.graph)
+        self.run_pass("concat_frozen_linear", scripted_mod.graph)
+        FileCheck().check_count("aten::linear", 1, exactly=True).check("aten::slice") \
+            .check_not("aten::view").run(scripted_mod.graph)
+        self.assertEqual(mod_eager(inp), scripted_mod(inp))
+
+        # a linear whose output is mutated keeps its own output
+        class Mutated(nn.Module):
+            def __init__(self):
+                super(Mutated, self).__init__()
+                self.a = nn.Linear(16, 16)
+                self.b = nn.Linear(16, 16)
+
+            def forward(self, x):
+                a = self.a(x)
+                a.add_(1)
+                return a, self.b(x)
+
+        mod_eager = Mutated().eval()
+        scripted_mod = torch.jit.freeze(torch.jit.script(mod_eager), optimize_numerics=False)
+        self.run_pass("concat_frozen_linear", scripted_mod.graph)
+        FileCheck().check_count("aten::linear", 2, exactly=True).run(scripted_mod.graph)
+        self.assertEqual(mod_eager(inp), scripted_mod(inp))
+
+    def test_batch_frozen_linear(self):
+        class Experts(nn.Module):
+            def __init__(self):
+                super(Experts, self).__init__()
+                self.experts = nn.ModuleList([nn.Linear(16, 8, bias=(i != 1)) for i in range(3)])
+
+            def forward(self, x, y, z):
+                a = self.experts[0](x)
+                b = self.experts[1](y)
+                c = self.experts[2](z + a.sum())
+                return a, b, c
+
+        mod_eager = Experts().eval()
+        inps = (torch.rand(4, 16), torch.rand(4, 16), torch.rand(4, 16))
+        traced_mod = torch.jit.freeze(torch.jit.trace(mod_eager, inps), optimize_numerics=False)
+        # the third linear uses the output of the first
+        self.run_pass("batch_frozen_linear", traced_mod.graph)
+        FileCheck().check("aten::baddbmm").check_count("aten::linear", 1, exactly=True).run(traced_mod.graph)
+        self.assertEqual(mod_eager(*inps), traced_mod(*inps))
+
+        # without complete shapes nothing is batched
+        scripted_mod = torch.jit.freeze(torch.jit.script(mod_eager), optimize_numerics=False)
+        self.run_pass("batch_frozen_linear", scripted_mod.graph)
+        FileCheck().check_not("aten::baddbmm").run(scripted_mod.graph)
+
     def test_optimize_freeze_module(self):
         in_channels, out_channels = 3, 32
         conv = torch.nn.Conv2d(in_channels, out_channels, kernel_size=3, stride=2, bias=True)
@@ -2,7 +2,10 @@
 # torch
 import torch
 from torch.testing import FileCheck
-from torch.testing._internal.common_quantization import QuantizationTestCase
+from torch.testing._internal.common_quantization import (
+    QuantizationTestCase,
+    skipIfNoFBGEMM,
+)
 
 class TestFusionPasses(QuantizationTestCase):
     def test_quantized_add_relu_fusion(self):
@@ -117,3 +120,73 @@ class TestFusionPasses(QuantizationTestCase):
                    .run(scripted_m.graph)
         output = scripted_m(qA, 3., qC)
         self.assertEqual(ref_output, output)
+
+    @skipIfNoFBGEMM
+    def test_quantized_residual_add_fusion(self):
+        class MConvAdd(torch.nn.Module):
+            __constants__ = ['relu', 'accum_first']
+
+            def __init__(self, relu, accum_first):
+                super(MConvAdd, self).__init__()
+                w = torch.quantize_per_tensor(torch.randn(4, 4, 3, 3), 0.05, 0, torch.qint8)
+                self.packed = torch.ops.quantized.conv2d_prepack(
+                    w, torch.randn(4), [1, 1], [1, 1], [1, 1], 1)
+                self.relu = relu
+                self.accum_first = accum_first
+
+            def forward(self, x, accum):
+                y = torch.ops.quantized.conv2d(x, self.packed, 0.2, 64)
+                if self.accum_first:
+                    y = torch.ops.quantized.add(accum, y, 0.3, 70)
+                else:
+                    y = torch.ops.quantized.add(y, accum, 0.3, 70)
+                if self.relu:
+                    y = torch.relu(y)
+                return y
+
+        class MLinearAdd(torch.nn.Module):
+            __constants__ = ['relu']
+
+            def __init__(self, relu):
+                super(MLinearAdd, self).__init__()
+                w = torch.quantize_per_tensor(torch.randn(6, 5), 0.05, 0, torch.qint8)
+                self.packed = torch.ops.quantized.linear_prepack(w, torch.randn(6))
+                self.relu = relu
+
+            def forward(self, x, accum):
+                y = torch.ops.quantized.linear(x, self.packed, 0.2, 64)
+                if self.relu:
+                    y = torch.ops.quantized.add_relu(y, accum, 0.3, 70)
+                else:
+                    y = torch.ops.quantized.add(y, accum, 0.3, 70)
+                return y
+
+        qx = torch.quantize_per_tensor(torch.randn(2, 4, 5, 5), 0.1, 128, torch.quint8)
+        qaccum = torch.quantize_per_tensor(torch.randn(2, 4, 5, 5), 0.1, 128, torch.quint8)
+        for relu in [False, True]:
+            fused_op = "quantized::conv2d_add_relu" if relu else "quantized::conv2d_add("
+            for accum_first in [False, True]:
+                scripted_m = torch.jit.script(MConvAdd(relu, accum_first))
+                ref_output = scripted_m(qx, qaccum)
+                torch._C._jit_pass_inline(scripted_m.graph)
+                torch._C._jit_pass_fuse_quantized_residual_add(scripted_m.graph)
+                FileCheck().check_not("quantized::conv2d(") \
+                           .check_not("aten::relu") \
+                           .check(fused_op) \
+                           .run(scripted_m.graph)
+                output = scripted_m(qx, qaccum)
+                self.assertEqual(ref_output, output)
+
+        qx = torch.quantize_per_tensor(torch.randn(3, 5), 0.1, 128, torch.quint8)
+        qaccum = torch.quantize_per_tensor(torch.randn(3, 6), 0.1, 128, torch.quint8)
+        for relu in [False, True]:
+            fused_op = "quantized::linear_add_relu" if relu else "quantized::linear_add("
+            scripted_m = torch.jit.script(MLinearAdd(relu))
+            ref_output = scripted_m(qx, qaccum)
+            torch._C._jit_pass_inline(scripted_m.graph)
+            torch._C._jit_pass_fuse_quantized_residual_add(scripted_m.graph)
+            FileCheck().check_not("quantized::linear(") \
+                       .check(fused_op) \
+                       .run(scripted_m.graph)
+            output = scripted_m(qx, qaccum)
+            self.assertEqual(ref_output, output)
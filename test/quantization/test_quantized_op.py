@@ -1,6 +1,7 @@
 from builtins import round
 
 import copy
+import io
 import itertools
 import numpy as np
 import sys
@@ -2594,6 +2595,61 @@ class TestDynamicQuantizedLinear(TestCase):
         self.assertEqual(Y_fp32, Y_fp32_ref,
                          msg="torch.ops.quantized.fbgemm_linear_dynamic results are off")
 
+    @skipIfNoFBGEMM
+    @given(
+        batch_size=st.integers(1, 8),
+        num_groups=st.integers(1, 4),
+        group_size=st.sampled_from([2, 8, 32, 64]),
+        output_channels=st.integers(1, 16),
+        use_bias=st.booleans(),
+        use_relu=st.booleans(),
+    )
+    def test_qlinear_int4(self, batch_size, num_groups, group_size, output_channels, use_bias, use_relu):
+        input_channels = num_groups * group_size
+        X = torch.randn(batch_size, input_channels)
+        W = torch.randn(output_channels, input_channels)
+        b = torch.randn(output_channels) if use_bias else None
+
+        W_prepack = torch.ops.quantized.linear_prepack_int4(W, b, group_size)
+        W_packed, b_unpacked = torch.ops.quantized.linear_unpack_int4(W_prepack)
+        self.assertEqual(W_packed.dtype, torch.uint8)
+        self.assertEqual(W_packed.size(), (output_channels, num_groups, group_size // 2 + 4))
+        self.assertEqual(b_unpacked, b)
+
+        # Dequantize the packed weight: two 4-bit values per byte, then the
+        # fp16 scale and offset of the group.
+        data = W_packed[:, :, :group_size // 2].to(torch.int32)
+        W_q = torch.stack([data & 0xF, data >> 4], dim=-1).view(output_channels, num_groups, group_size)
+        qparams = torch.from_numpy(
+            W_packed[:, :, group_size // 2:].contiguous().numpy().view(np.float16)).to(torch.float)
+        scale, offset = qparams[:, :, 0:1], qparams[:, :, 1:2]
+        W_dq = (W_q * scale + offset).view(output_channels, input_channels)
+        # within half a quantization step, up to the rounding of the offset to fp16
+        self.assertTrue(((W_dq - W).abs() <= scale.expand(-1, -1, group_size).reshape_as(W) / 2 + 1e-2).all())
+
+        if use_relu:
+            Y = torch.ops.quantized.linear_relu_dynamic(X, W_prepack)
+            Y_ref = F.relu(F.linear(X, W_dq, b))
+        else:
+            Y = torch.ops.quantized.linear_dynamic(X, W_prepack)
+            Y_ref = F.linear(X, W_dq, b)
+        self.assertEqual(Y, Y_ref, atol=1e-4, rtol=1e-4)
+
+        # The weight is serialized in its packed representation.
+        class LinearInt4(torch.nn.Module):
+            def __init__(self, packed_params):
+                super(LinearInt4, self).__init__()
+                self.packed_params = packed_params
+
+            def forward(self, x):
+                return torch.ops.quantized.linear_dynamic(x, self.packed_params)
+
+        buffer = io.BytesIO()
+        torch.jit.save(torch.jit.script(LinearInt4(W_prepack)), buffer)
+        buffer.seek(0)
+        loaded = torch.jit.load(buffer)
+        self.assertEqual(loaded(X), torch.ops.quantized.linear_dynamic(X, W_prepack))
+
 
 class TestDynamicQuantizedRNNOp(TestCase):
     """Tests the correctness of the dynamic quantized lstm/gru."""
@@ -2994,6 +3050,67 @@ class TestQuantizedLinear(unittest.TestCase):
             np.testing.assert_equal(
                 W_q.q_zero_point(), W_q_origin.q_zero_point())
 
+    """Tests the int8 quantized linear op of QuantizedCUDA against the
+    floating point reference."""
+    @unittest.skipIf(not torch.cuda.is_available(), "CUDA unavailable")
+    @given(batch_size=st.integers(1, 4),
+           input_channels=st.integers(1, 32),
+           output_channels=st.integers(1, 8),
+           use_bias=st.booleans(),
+           use_relu=st.booleans())
+    def test_qlinear_cuda(self, batch_size, input_channels, output_channels,
+                          use_bias, use_relu):
+        X_scale, X_zp = 0.1, 110
+        W_scale = 0.05
+        Y_scale, Y_zp = 0.2, 120
+        X = torch.rand(batch_size, input_channels) * 20 - 11
+        W = torch.rand(output_channels, input_channels) * 10 - 5
+        b = torch.rand(output_channels) * 10 - 5 if use_bias else None
+
+        X_q = torch.quantize_per_tensor(X, X_scale, X_zp, torch.quint8)
+        W_q = torch.quantize_per_tensor(W, W_scale, 0, torch.qint8)
+        Y_ref = F.linear(X_q.dequantize(), W_q.dequantize(), b)
+        if use_relu:
+            Y_ref = F.relu(Y_ref)
+        Y_ref_q = torch.quantize_per_tensor(Y_ref, Y_scale, Y_zp, torch.quint8)
+
+        qlinear = torch.ops.quantized.linear_relu if use_relu else torch.ops.quantized.linear
+        W_prepack = torch.ops.quantized.linear_prepack(
+            W_q.cuda(), b.cuda() if use_bias else None)
+        Y_q = qlinear(X_q.cuda(), W_prepack, Y_scale, Y_zp)
+        self.assertEqual(Y_q.q_scale(), Y_scale)
+        self.assertEqual(Y_q.q_zero_point(), Y_zp)
+        # the requantization rounds once in float, allow a difference of one
+        np.testing.assert_allclose(Y_q.int_repr().cpu().numpy().astype(np.int32),
+                                   Y_ref_q.int_repr().numpy().astype(np.int32),
+                                   atol=1, rtol=0)
+        W_q_origin, b_origin = torch.ops.quantized.linear_unpack(W_prepack)
+        self.assertEqual(W_q_origin.int_repr(), W_q.int_repr().cuda())
+
+    """Tests the linear ops with a fused hardswish or sigmoid against the
+    linear followed by the activation."""
+    def test_qlinear_activation_fusion(self):
+        X = torch.rand(5, 24) * 20 - 11
+        W = torch.rand(40, 24) * 10 - 5
+        b = torch.rand(40) * 10 - 5
+        X_q = torch.quantize_per_tensor(X, 0.1, 110, torch.quint8)
+        W_q = torch.quantize_per_tensor(W, 0.05, 0, torch.qint8)
+        fused_ops = [
+            (torch.ops.quantized.linear_hardswish, torch.ops.quantized.hardswish, 0.05, 20),
+            (torch.ops.quantized.linear_sigmoid, torch.ops.quantized.sigmoid, 1.0 / 256, 0),
+        ]
+        for qengine in supported_qengines:
+            with override_quantized_engine(qengine):
+                W_prepack = torch.ops.quantized.linear_prepack(W_q, b)
+                for fused_op, activation, Y_scale, Y_zp in fused_ops:
+                    Y_ref = activation(
+                        torch.ops.quantized.linear(X_q, W_prepack, 0.3, 120),
+                        Y_scale, Y_zp)
+                    Y_q = fused_op(X_q, W_prepack, 0.3, 120, Y_scale, Y_zp)
+                    self.assertEqual(Y_q.q_scale(), Y_ref.q_scale())
+                    self.assertEqual(Y_q.q_zero_point(), Y_ref.q_zero_point())
+                    self.assertEqual(Y_q.int_repr(), Y_ref.int_repr())
+
 
 @unittest.skipIf(sys.platform == "darwin", "Known test failure on Mac.")
 class TestQuantizedEmbeddingOps(TestCase):
@@ -4233,6 +4350,75 @@ class TestQuantizedConv(TestCase):
             (stride_d, stride_h, stride_w), (pad_d, pad_h, pad_w), (o_pad, o_pad, o_pad),
             channelwise)
 
+    """Tests the int8 quantized conv2d op of QuantizedCUDA against the
+    floating point reference."""
+    @unittest.skipIf(not torch.cuda.is_available(), "CUDA unavailable")
+    @given(batch_size=st.integers(1, 3),
+           input_channels=st.integers(1, 8),
+           output_channels=st.integers(1, 8),
+           height=st.integers(4, 10),
+           width=st.integers(4, 10),
+           kernel=st.integers(1, 3),
+           stride=st.integers(1, 2),
+           pad=st.integers(0, 2),
+           dilation=st.integers(1, 2),
+           use_bias=st.booleans(),
+           use_relu=st.booleans())
+    def test_qconv2d_cuda(self, batch_size, input_channels, output_channels,
+                          height, width, kernel, stride, pad, dilation,
+                          use_bias, use_relu):
+        assume(height + 2 * pad >= dilation * (kernel - 1) + 1)
+        assume(width + 2 * pad >= dilation * (kernel - 1) + 1)
+        X_scale, X_zp = 0.1, 110
+        W_scale = 0.05
+        Y_scale, Y_zp = 0.5, 120
+        X = torch.rand(batch_size, input_channels, height, width) * 20 - 11
+        W = torch.rand(output_channels, input_channels, kernel, kernel) * 10 - 5
+        b = torch.rand(output_channels) * 10 - 5 if use_bias else None
+
+        X_q = torch.quantize_per_tensor(X, X_scale, X_zp, torch.quint8)
+        W_q = torch.quantize_per_tensor(W, W_scale, 0, torch.qint8)
+        Y_ref = F.conv2d(X_q.dequantize(), W_q.dequantize(), b, stride, pad, dilation)
+        if use_relu:
+            Y_ref = F.relu(Y_ref)
+        Y_ref_q = torch.quantize_per_tensor(Y_ref, Y_scale, Y_zp, torch.quint8)
+
+        qconv = torch.ops.quantized.conv2d_relu if use_relu else torch.ops.quantized.conv2d
+        W_prepack = torch.ops.quantized.conv2d_prepack(
+            W_q.cuda(), b.cuda() if use_bias else None,
+            [stride, stride], [pad, pad], [dilation, dilation], 1)
+        Y_q = qconv(X_q.cuda(), W_prepack, Y_scale, Y_zp)
+        self.assertEqual(Y_q.shape, Y_ref_q.shape)
+        # the requantization rounds once in float, allow a difference of one
+        np.testing.assert_allclose(Y_q.int_repr().cpu().numpy().astype(np.int32),
+                                   Y_ref_q.int_repr().numpy().astype(np.int32),
+                                   atol=1, rtol=0)
+
+    """Tests the conv2d ops with a fused hardswish or sigmoid against the
+    conv2d followed by the activation."""
+    def test_qconv2d_activation_fusion(self):
+        X = torch.rand(2, 8, 9, 9) * 20 - 11
+        W = torch.rand(16, 8, 3, 3) * 10 - 5
+        b = torch.rand(16) * 10 - 5
+        X_q = torch.quantize_per_tensor(X, 0.1, 110, torch.quint8)
+        W_q = torch.quantize_per_tensor(W, 0.05, 0, torch.qint8)
+        fused_ops = [
+            (torch.ops.quantized.conv2d_hardswish, torch.ops.quantized.hardswish, 0.05, 20),
+            (torch.ops.quantized.conv2d_sigmoid, torch.ops.quantized.sigmoid, 1.0 / 256, 0),
+        ]
+        for qengine in supported_qengines:
+            with override_quantized_engine(qengine):
+                W_prepack = torch.ops.quantized.conv2d_prepack(
+                    W_q, b, [1, 1], [1, 1], [1, 1], 1)
+                for fused_op, activation, Y_scale, Y_zp in fused_ops:
+                    Y_ref = activation(
+                        torch.ops.quantized.conv2d(X_q, W_prepack, 0.3, 120),
+                        Y_scale, Y_zp)
+                    Y_q = fused_op(X_q, W_prepack, 0.3, 120, Y_scale, Y_zp)
+                    self.assertEqual(Y_q.q_scale(), Y_ref.q_scale())
+                    self.assertEqual(Y_q.q_zero_point(), Y_ref.q_zero_point())
+                    self.assertEqual(Y_q.int_repr(), Y_ref.int_repr())
+
 class TestPadding(TestCase):
     @given(batch_size=st.integers(1, 64),
            channels=st.integers(1, 64),
@@ -4679,6 +4865,56 @@ class TestQNNPackOps(TestCase):
                     qY, qY_hat,
                     msg="hardtanh failed:\nactual {}\nexpected {}\nmemory_format {}".format(qY_hat, qY, memory_format))
 
+    """Tests the correctness of the block sparse quantized::linear of QNNPACK."""
+    @given(batch_size=st.integers(1, 4),
+           input_channels=st.integers(1, 33),
+           output_channels=st.integers(1, 16),
+           use_relu=st.booleans())
+    def test_qlinear_sparse(self, batch_size, input_channels, output_channels, use_relu):
+        with override_quantized_engine('qnnpack'):
+            W = torch.randn(output_channels, input_channels)
+            # prune 3 out of 4 blocks of 1 x 4 elements of the rows
+            num_blocks = (input_channels + 3) // 4
+            mask = (torch.rand(output_channels, num_blocks) < 0.25).float()
+            W = W * mask.repeat_interleave(4, dim=1)[:, :input_channels]
+            W_scale = float(W.abs().max()) / 127 + 1e-6
+            qW = torch.quantize_per_tensor(W, W_scale, 0, torch.qint8)
+            b = torch.randn(output_channels)
+            X = torch.rand(batch_size, input_channels)
+
+            W_prepack = torch.ops.quantized.linear_prepack_sparse(qW, b)
+            W_unpacked, b_unpacked = torch.ops.quantized.linear_unpack(W_prepack)
+            self.assertEqual(qW, W_unpacked)
+            self.assertEqual(b, b_unpacked)
+
+            # dynamic
+            linear_dynamic = (torch.ops.quantized.linear_relu_dynamic if use_relu
+                              else torch.ops.quantized.linear_dynamic)
+            Y_ref = F.linear(X, qW.dequantize(), b)
+            if use_relu:
+                Y_ref = F.relu(Y_ref)
+            Y = linear_dynamic(X, W_prepack)
+            tolerance = Y_ref.abs().max().item() * 0.02 + 0.05
+            self.assertEqual(Y_ref, Y, atol=tolerance, rtol=0)
+
+            # static
+            qX = torch.quantize_per_tensor(X, 1.0 / 255, 0, torch.quint8)
+            Y_ref = F.linear(qX.dequantize(), qW.dequantize(), b)
+            if use_relu:
+                Y_ref = F.relu(Y_ref)
+            Y_scale = Y_ref.abs().max().item() / 127 + 1e-6
+            qY_ref = torch.quantize_per_tensor(Y_ref, Y_scale, 128, torch.quint8)
+            linear = torch.ops.quantized.linear_relu if use_relu else torch.ops.quantized.linear
+            qY = linear(qX, W_prepack, Y_scale, 128)
+            np.testing.assert_array_almost_equal(qY_ref.int_repr().numpy(), qY.int_repr().numpy(), decimal=0)
+
+            # a weight as sparse is packed as sparse by linear_prepack too
+            qY_auto = linear(qX, torch.ops.quantized.linear_prepack(qW, b), Y_scale, 128)
+            self.assertEqual(qY, qY_auto)
+
+            with self.assertRaisesRegex(RuntimeError, "only blocks of 1 x 4"):
+                torch.ops.quantized.linear_prepack_sparse(qW, b, 8, 1)
+
 """Tests the correctness of the tensor comparators."""
 class TestComparatorOps(TestCase):
     """Tests the element-wise equality ops."""
@@ -387,6 +387,23 @@ class TestQuantizedTensor(TestCase):
         zero_points = torch.tensor([5, 10, 7], dtype=torch.long)
         self._test_quantize_per_channel(r, scales, zero_points, 0, False)
 
+    def test_qtensor_quantize_per_channel_many_channels(self):
+        # enough channels and elements for the vectorized loops of the kernels
+        r = torch.randn(2, 19, 5, 11, dtype=torch.float) * 4
+        scales = torch.rand(19, dtype=torch.double) * 0.1 + 0.01
+        for dtype, zero_points in ((torch.quint8, torch.randint(0, 20, (19,))),
+                                   (torch.qint8, torch.randint(-10, 10, (19,)))):
+            for memory_format in (torch.contiguous_format, torch.channels_last):
+                r_contig = r.contiguous(memory_format=memory_format)
+                qr = torch.quantize_per_channel(r_contig, scales, zero_points, 1, dtype)
+                rqr = qr.dequantize()
+                for c in range(19):
+                    # per channel quantization is per tensor quantization of each channel
+                    q_ref = torch.quantize_per_tensor(
+                        r[:, c], float(scales[c]), int(zero_points[c]), dtype)
+                    self.assertEqual(q_ref.int_repr(), qr.int_repr()[:, c])
+                    self.assertEqual(q_ref.dequantize(), rqr[:, c])
+
     def test_quantize_per_channel_float_qparams(self):
         r = torch.rand(3, 2, dtype=torch.float) * 4
         scales = torch.tensor([0.2, 0.03], dtype=torch.float)
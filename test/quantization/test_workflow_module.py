@@ -800,6 +800,27 @@ class TestHistogramObserver(QuantizationTestCase):
         self.assertEqual(myobs.max_val, 8.0)
         self.assertEqual(myobs.histogram, [2., 3., 3.])
 
+    def test_histogram_observer_update(self):
+        obs = HistogramObserver(bins=16, upsample_rate=4)
+        x = torch.tensor([0.1, 0.35, 0.6, 1.3])
+        obs(x)
+        self.assertEqual(obs.min_val, 0.1)
+        self.assertEqual(obs.max_val, 1.3)
+        self.assertEqual(obs.histogram, torch.histc(x, 16, min=0.1, max=1.3))
+        # The range grows on both sides, the old histogram is rebinned into
+        # the new one, which keeps every observed value
+        total = x.numel()
+        min_val = x.min()
+        for _ in range(5):
+            y = torch.randn(100) * 4
+            obs(y)
+            total += y.numel()
+            min_val = torch.min(min_val, y.min())
+            self.assertEqual(obs.min_val, min_val)
+            self.assertGreaterEqual(obs.max_val, y.max())
+            self.assertEqual(obs.histogram.sum().item(), total, atol=1e-3, rtol=0)
+            self.assertTrue((obs.histogram >= 0).all())
+
     @given(N=st.sampled_from([10, 1000]),
            bins=st.sampled_from([256, 512, 1024, 2048]),
            dtype=st.sampled_from([torch.qint8, torch.quint8]),
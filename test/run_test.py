@@ -21,6 +21,7 @@ from typing import Dict, Optional
 TESTS = [
     'test_type_hints',
     'test_autograd',
+    'test_autocast',
     'benchmark_utils/test_benchmark_utils',
     'test_binary_ufuncs',
     'test_bundled_inputs',
@@ -55,8 +56,10 @@ TESTS = [
     'test_multiprocessing_spawn',
     'distributed/test_nccl',
     'test_native_functions',
+    'test_nestedtensor',
     'test_numba_integration',
     'test_nn',
+    'test_nnapi',
     'test_ops',
     'test_optim',
     'test_pytree',
@@ -64,6 +67,7 @@ TESTS = [
     'test_xnnpack_integration',
     'test_vulkan',
     'test_sparse',
+    'test_sparse_csr',
     'test_quantization',
     'test_pruning_op',
     'test_spectral_ops',
@@ -231,6 +235,7 @@ SLOW_TESTS = [
     'distributions/test_distributions',
     'test_nn',
     'test_autograd',
+    'test_autocast',
     'test_cpp_extensions_jit',
     'test_jit_legacy',
     'test_dataloader',
@@ -0,0 +1,143 @@
+import torch
+from torch.testing._internal.common_utils import TestCase, run_tests
+
+
+class TestAutocastCPU(TestCase):
+    def test_lower_precision_ops(self):
+        x = torch.randn(4, 8)
+        linear = torch.nn.Linear(8, 3)
+        conv = torch.nn.Conv2d(2, 3, 3)
+        with torch.cpu.amp.autocast():
+            self.assertTrue(torch.is_autocast_cpu_enabled())
+            self.assertEqual(linear(x).dtype, torch.bfloat16)
+            self.assertEqual(torch.mm(x, x.t()).dtype, torch.bfloat16)
+            self.assertEqual(torch.bmm(x.unsqueeze(0), x.t().unsqueeze(0)).dtype, torch.bfloat16)
+            self.assertEqual(conv(torch.randn(1, 2, 5, 5)).dtype, torch.bfloat16)
+            # unlisted ops run in their inputs' type
+            self.assertEqual(torch.relu(x).dtype, torch.float32)
+        self.assertFalse(torch.is_autocast_cpu_enabled())
+        expected = torch.nn.functional.linear(x.bfloat16(), linear.weight.bfloat16(), linear.bias.bfloat16())
+        with torch.cpu.amp.autocast():
+            self.assertEqual(linear(x), expected)
+
+    def test_fp32_and_promote_ops(self):
+        x = torch.randn(4, 8, dtype=torch.bfloat16)
+        with torch.cpu.amp.autocast():
+            self.assertEqual(torch.softmax(x, 1).dtype, torch.float32)
+            self.assertEqual(torch.softmax(x, 1, dtype=torch.bfloat16).dtype, torch.bfloat16)
+            self.assertEqual(torch.nn.functional.layer_norm(x, (8,)).dtype, torch.float32)
+            self.assertEqual(x.sum().dtype, torch.float32)
+            self.assertEqual(torch.cat((x, x.float())).dtype, torch.float32)
+            self.assertEqual(torch.cat((x, x)).dtype, torch.bfloat16)
+            # double tensors are left alone
+            self.assertEqual(torch.mm(x.double(), x.double().t()).dtype, torch.float64)
+
+    def test_nesting(self):
+        x = torch.randn(4, 4)
+        with torch.cpu.amp.autocast():
+            with torch.cpu.amp.autocast(enabled=False):
+                self.assertFalse(torch.is_autocast_cpu_enabled())
+                self.assertEqual(torch.mm(x, x).dtype, torch.float32)
+            self.assertEqual(torch.mm(x, x).dtype, torch.bfloat16)
+        # the CUDA autocast is independent of the CPU one
+        self.assertFalse(torch.is_autocast_enabled())
+
+    def test_decorator(self):
+        @torch.cpu.amp.autocast()
+        def mm(a, b):
+            return torch.mm(a, b)
+
+        x = torch.randn(4, 4)
+        self.assertEqual(mm(x, x).dtype, torch.bfloat16)
+        self.assertFalse(torch.is_autocast_cpu_enabled())
+
+    def test_backward(self):
+        linear = torch.nn.Linear(8, 3)
+        x = torch.randn(4, 8)
+        with torch.cpu.amp.autocast():
+            out = linear(x)
+        out.float().sum().backward()
+        self.assertEqual(linear.weight.grad.dtype, torch.float32)
+
+
+class TestAutocastPersistentCache(TestCase):
+    def setUp(self):
+        super().setUp()
+        self.prev_max_size = torch._C._get_autocast_persistent_cache_max_size()
+        torch._C._set_autocast_persistent_cache_enabled(True)
+
+    def tearDown(self):
+        torch._C._set_autocast_persistent_cache_enabled(False)
+        torch._C._set_autocast_persistent_cache_max_size(self.prev_max_size)
+        super().tearDown()
+
+    def _run(self, linear, x):
+        with torch.no_grad(), torch.cpu.amp.autocast():
+            return linear(x)
+
+    def test_persists_across_regions(self):
+        linear = torch.nn.Linear(8, 16, bias=False)
+        x = torch.randn(4, 8)
+        self.assertEqual(torch._C._get_autocast_persistent_cache_size(), 0)
+        out = self._run(linear, x)
+        weight_nbytes = linear.weight.numel() * 2
+        self.assertEqual(torch._C._get_autocast_persistent_cache_size(), weight_nbytes)
+        self.assertEqual(self._run(linear, x), out)
+        self.assertEqual(torch._C._get_autocast_persistent_cache_size(), weight_nbytes)
+
+        torch._C._clear_autocast_persistent_cache()
+        self.assertEqual(torch._C._get_autocast_persistent_cache_size(), 0)
+
+    def test_invalidation(self):
+        linear = torch.nn.Linear(8, 16, bias=False)
+        x = torch.randn(4, 8)
+        self._run(linear, x)
+        with torch.no_grad():
+            linear.weight.mul_(2)
+        expected = torch.mm(x.bfloat16(), linear.weight.bfloat16().t())
+        self.assertEqual(self._run(linear, x), expected)
+
+        linear.weight.data = torch.randn(16, 8)
+        expected = torch.mm(x.bfloat16(), linear.weight.bfloat16().t())
+        self.assertEqual(self._run(linear, x), expected)
+        self.assertEqual(torch._C._get_autocast_persistent_cache_size(), linear.weight.numel() * 2)
+
+    def test_grad_mode(self):
+        linear = torch.nn.Linear(8, 16, bias=False)
+        with torch.cpu.amp.autocast():
+            out = linear(torch.randn(4, 8))
+        # the casts recorded by autograd stay in the region's cache
+        self.assertEqual(torch._C._get_autocast_persistent_cache_size(), 0)
+        self.assertTrue(out.requires_grad)
+
+    def test_max_size(self):
+        x = torch.randn(4, 8)
+        first = torch.nn.Linear(8, 16, bias=False)
+        second = torch.nn.Linear(8, 16, bias=False)
+        weight_nbytes = first.weight.numel() * 2
+        torch._C._set_autocast_persistent_cache_max_size(weight_nbytes)
+        self.assertEqual(torch._C._get_autocast_persistent_cache_max_size(), weight_nbytes)
+        self._run(first, x)
+        self._run(second, x)
+        # the least recently used cast was evicted
+        self.assertEqual(torch._C._get_autocast_persistent_cache_size(), weight_nbytes)
+
+        torch._C._set_autocast_persistent_cache_max_size(weight_nbytes - 1)
+        self.assertEqual(torch._C._get_autocast_persistent_cache_size(), 0)
+        self._run(first, x)
+        self.assertEqual(torch._C._get_autocast_persistent_cache_size(), 0)
+
+        with self.assertRaisesRegex(RuntimeError, "non-negative"):
+            torch._C._set_autocast_persistent_cache_max_size(-1)
+
+    def test_disable_clears(self):
+        linear = torch.nn.Linear(8, 16, bias=False)
+        self._run(linear, torch.randn(4, 8))
+        self.assertGreater(torch._C._get_autocast_persistent_cache_size(), 0)
+        torch._C._set_autocast_persistent_cache_enabled(False)
+        self.assertFalse(torch._C._is_autocast_persistent_cache_enabled())
+        self.assertEqual(torch._C._get_autocast_persistent_cache_size(), 0)
+
+
+if __name__ == '__main__':
+    run_tests()
@@ -794,6 +794,32 @@ class TestAutograd(TestCase):
         (fn.apply(x, sparse_grad1) + fn.apply(x, sparse_grad2)).sum().backward()
         self.assertEqual(x.grad, sparse_grad1 + sparse_grad2)
 
+    def test_sparse_grad_deduplication(self):
+        weight = torch.randn(10, 3, dtype=torch.double, requires_grad=True)
+        inputs = [torch.tensor([[7, 1, 3], [1, 1, 9]]), torch.tensor([3, 0, 0, 7]), torch.tensor([2])]
+        expected = torch.zeros_like(weight)
+        for input in inputs:
+            expected.index_add_(0, input.flatten(), torch.ones(input.numel(), 3, dtype=torch.double))
+
+        with torch.autograd.set_sparse_grad_deduplication(True):
+            self.assertTrue(torch._C._is_sparse_grad_deduplication_enabled())
+            for _ in range(2):
+                for input in inputs:
+                    torch.nn.functional.embedding(input, weight, sparse=True).sum().backward()
+                    self.assertTrue(weight.grad.is_coalesced())
+                self.assertEqual(weight.grad._indices(), expected.sum(1).nonzero().t())
+                self.assertEqual(weight.grad.to_dense(), expected)
+                # a zeroed gradient keeps accumulating without duplicates
+                weight.grad.zero_()
+        self.assertFalse(torch._C._is_sparse_grad_deduplication_enabled())
+
+        # the indices are concatenated otherwise
+        weight.grad = None
+        for input in inputs:
+            torch.nn.functional.embedding(input, weight, sparse=True).sum().backward()
+        self.assertEqual(weight.grad._nnz(), sum(input.numel() for input in inputs))
+        self.assertEqual(weight.grad.to_dense(), expected)
+
     def test_sparse_mm_backward(self):
         size = (3, 3)
         sparse = torch.sparse_coo_tensor(size, requires_grad=True)
@@ -1670,6 +1696,186 @@ class TestAutograd(TestCase):
         c.backward(torch.tensor([1, 1, 1], dtype=torch.double), retain_graph=True)
         c.backward(torch.tensor([1, 1, 1], dtype=torch.double))
 
+    def test_inference_mode(self):
+        x = torch.randn(3, 4, requires_grad=True)
+        self.assertFalse(torch.is_inference_mode_enabled())
+        with torch.inference_mode():
+            self.assertTrue(torch.is_inference_mode_enabled())
+            self.assertFalse(torch.is_grad_enabled())
+            # grad mode can't be enabled in inference mode
+            with torch.enable_grad():
+                self.assertFalse(torch.is_grad_enabled())
+            y = x * x
+            y.add_(1)
+            self.assertFalse(y.requires_grad)
+            self.assertIsNone(y.grad_fn)
+            with torch.inference_mode(False):
+                self.assertFalse(torch.is_inference_mode_enabled())
+                self.assertTrue(torch.is_grad_enabled())
+                z = x * 2
+                self.assertTrue(z.requires_grad)
+                self.assertEqual(z._version, 0)
+            self.assertTrue(torch.is_inference_mode_enabled())
+        self.assertFalse(torch.is_inference_mode_enabled())
+        self.assertTrue(torch.is_grad_enabled())
+        self.assertEqual(y, x.detach() * x.detach() + 1)
+
+        # inference tensors are regular inputs outside of inference mode,
+        # but they have no version counter
+        with self.assertRaisesRegex(RuntimeError, 'do not track their version'):
+            y._version
+        out = (y + x).sum()
+        out.backward()
+        self.assertEqual(x.grad, torch.ones_like(x))
+        with self.assertRaisesRegex(RuntimeError, 'do not track their version'):
+            y * x
+        with self.assertRaisesRegex(RuntimeError, 'Inplace update to a tensor created in inference mode'):
+            y.add_(1)
+
+        @torch.inference_mode()
+        def func(t):
+            self.assertTrue(torch.is_inference_mode_enabled())
+            return t * 2
+
+        self.assertFalse(func(x).requires_grad)
+        self.assertFalse(torch.is_inference_mode_enabled())
+
+    def test_inference_mode_threads(self):
+        # inference mode is thread local
+        results = []
+
+        def check():
+            results.append(torch.is_inference_mode_enabled())
+
+        with torch.inference_mode():
+            t = threading.Thread(target=check)
+            t.start()
+            t.join()
+        self.assertEqual(results, [False])
+
+    def test_saved_tensors_hooks(self):
+        packed = []
+
+        def pack_hook(x):
+            packed.append(x)
+            return len(packed) - 1
+
+        def unpack_hook(i):
+            return packed[i]
+
+        a = torch.randn(5, requires_grad=True, dtype=torch.double)
+        with torch.autograd.graph.saved_tensors_hooks(pack_hook, unpack_hook):
+            y = a * a
+        self.assertEqual(len(packed), 2)
+        y.sum().backward()
+        self.assertEqual(a.grad, 2 * a)
+
+        # outside of the context, tensors are saved as usual
+        packed.clear()
+        (a * a).sum().backward()
+        self.assertEqual(len(packed), 0)
+
+        # backward twice without retain_graph still raises
+        with torch.autograd.graph.saved_tensors_hooks(pack_hook, unpack_hook):
+            y = a.exp()
+        y.sum().backward()
+        self.assertRaisesRegex(RuntimeError, 'Specify retain_graph=True', lambda: y.sum().backward())
+
+    def test_saved_tensors_hooks_nested(self):
+        outer, inner = [], []
+
+        def make_hooks(saved):
+            def pack_hook(x):
+                # tensors saved by the pack hook itself are not packed
+                saved.append((x * torch.ones_like(x, requires_grad=True)).detach())
+                return len(saved) - 1
+
+            return pack_hook, lambda i: saved[i]
+
+        a = torch.randn(5, requires_grad=True, dtype=torch.double)
+        with torch.autograd.graph.saved_tensors_hooks(*make_hooks(outer)):
+            b = a.sin()
+            with torch.autograd.graph.saved_tensors_hooks(*make_hooks(inner)):
+                c = b.exp()
+        self.assertEqual(len(outer), 1)
+        self.assertEqual(len(inner), 1)
+        c.sum().backward()
+        self.assertEqual(a.grad, b.exp() * a.cos())
+
+    def test_saved_tensors_hooks_wrong_unpack(self):
+        a = torch.randn(5, requires_grad=True)
+        with torch.autograd.graph.saved_tensors_hooks(lambda x: x, lambda x: "not a tensor"):
+            y = a * a
+        with self.assertRaisesRegex(TypeError, 'Output of saved tensor unpack_hook'):
+            y.sum().backward()
+
+    def test_compress_saved_tensors(self):
+        a = torch.randn(10, 10, requires_grad=True)
+        w = torch.randn(10, 10, requires_grad=True)
+        with torch.autograd.graph.compress_saved_tensors(torch.bfloat16):
+            y = (a @ w).tanh()
+        y.sum().backward()
+        a_grad, w_grad = a.grad, w.grad
+        a.grad, w.grad = None, None
+        (a @ w).tanh().sum().backward()
+        self.assertEqual(a_grad, a.grad, atol=5e-2, rtol=5e-2)
+        self.assertEqual(w_grad, w.grad, atol=5e-2, rtol=5e-2)
+
+        with self.assertRaisesRegex(ValueError, 'torch.float16 or torch.bfloat16'):
+            torch.autograd.graph.compress_saved_tensors(torch.int8)
+
+    def test_recompute_saved_tensors(self):
+        x = torch.randn(5, 4, requires_grad=True, dtype=torch.double)
+        w = torch.randn(4, 3, requires_grad=True, dtype=torch.double)
+        calls = []
+
+        def sigmoid(t):
+            calls.append(1)
+            return torch.sigmoid(t)
+
+        with torch.autograd.graph.recompute_saved_tensors() as recompute:
+            h = recompute(sigmoid, x)
+            loss = (h @ w).sum()
+        del h
+        loss.backward()
+        # once in forward, then once for each of the sigmoid and mm backward
+        self.assertEqual(len(calls), 3)
+        x_grad, w_grad = x.grad, w.grad
+        x.grad, w.grad = None, None
+        (torch.sigmoid(x) @ w).sum().backward()
+        self.assertEqual(x_grad, x.grad)
+        self.assertEqual(w_grad, w.grad)
+
+        y = torch.randn(5, 4, dtype=torch.double).requires_grad_()
+        with torch.autograd.graph.recompute_saved_tensors() as recompute:
+            z = y.clone()
+            h = recompute(torch.exp, z)
+            loss = (h * 2).sum()
+        with torch.no_grad():
+            z.add_(1)
+        with self.assertRaisesRegex(RuntimeError, 'modified by an inplace operation'):
+            loss.backward()
+
+    @unittest.skipIf(not torch.cuda.is_available(), "CUDA unavailable")
+    def test_save_on_cpu(self):
+        a = torch.randn(5, 5, device="cuda", requires_grad=True)
+        layers = [torch.randn(5, 5, device="cuda", requires_grad=True) for _ in range(4)]
+        with torch.autograd.graph.save_on_cpu(prefetch=1):
+            y = a
+            for w in layers:
+                y = (y @ w).sigmoid()
+        y.sum().backward()
+        grads = [a.grad] + [w.grad for w in layers]
+        a.grad = None
+        for w in layers:
+            w.grad = None
+        y = a
+        for w in layers:
+            y = (y @ w).sigmoid()
+        y.sum().backward()
+        for grad, ref in zip(grads, [a.grad] + [w.grad for w in layers]):
+            self.assertEqual(grad, ref)
+
     def test_next_functions(self):
         x = torch.randn(5, 5, requires_grad=True)
         y = torch.randn(5, 5, requires_grad=True)
@@ -7794,6 +8000,73 @@ class TestMultithreadAutograd(TestCase):
             tb_str = "\n".join(traceback.format_tb(tb))
             self.assertTrue('raise ValueError("something")' in tb_str)
 
+    def test_multithreaded_cpu_backward(self):
+        # many independent branches, as in a multi tower model, with python
+        # nodes among them and a reentrant backward in one of them
+        class Reentrant(Function):
+            @staticmethod
+            def forward(ctx, x):
+                ctx.save_for_backward(x)
+                return x * 2
+
+            @staticmethod
+            def backward(ctx, grad):
+                x, = ctx.saved_tensors
+                with torch.enable_grad():
+                    y = x.detach().requires_grad_()
+                    (y * y).sum().backward()
+                return grad * 2 + y.grad
+
+        def run(num_threads):
+            prev = torch._C._get_autograd_cpu_threads()
+            torch._C._set_autograd_cpu_threads(num_threads)
+            try:
+                torch.manual_seed(0)
+                xs = [torch.randn(10, 10, requires_grad=True) for _ in range(50)]
+                w = torch.randn(10, 10, requires_grad=True)
+                outs = []
+                for i, x in enumerate(xs):
+                    y = (x.tanh() @ w).sigmoid()
+                    if i % 5 == 0:
+                        y = Reentrant.apply(y)
+                    outs.append(y.sum())
+                torch.stack(outs).sum().backward()
+                grads = [x.grad for x in xs] + [w.grad]
+                # grad() only runs the nodes needed for the requested inputs
+                z = torch.stack([(x * w).sum() for x in xs]).sum()
+                grads += list(torch.autograd.grad(z, xs[:3]))
+                return grads
+            finally:
+                torch._C._set_autograd_cpu_threads(prev)
+
+        self.assertEqual(torch._C._get_autograd_cpu_threads(), 1)
+        expected = run(1)
+        for num_threads in [2, 4]:
+            for _ in range(3):
+                self.assertEqual(run(num_threads), expected)
+
+        with self.assertRaisesRegex(RuntimeError, "positive number of autograd CPU threads"):
+            torch._C._set_autograd_cpu_threads(0)
+
+        # errors are propagated from the helper threads as well
+        class Fail(Function):
+            @staticmethod
+            def forward(ctx, x):
+                return x.clone()
+
+            @staticmethod
+            def backward(ctx, grad):
+                raise ValueError("fail in backward")
+
+        torch._C._set_autograd_cpu_threads(4)
+        try:
+            x = torch.randn(3, requires_grad=True)
+            outs = [x.exp() for _ in range(20)] + [Fail.apply(x)]
+            with self.assertRaisesRegex(ValueError, "fail in backward"):
+                torch.stack(outs).sum().backward()
+        finally:
+            torch._C._set_autograd_cpu_threads(1)
+
     # TODO(@anjali411): add an OpInfo based test for torch.cat
     # Issue: https://github.com/pytorch/pytorch/issues/51627
     def test_cat_r_to_c(self):
@@ -793,6 +793,32 @@ class TestBinaryUfuncs(TestCase):
             for x, y, z in zip(a.tolist(), b.tolist(), c.tolist()):
                 self.assertEqual(x + y, z)
 
+    @dtypes(torch.half, torch.float, torch.cdouble)
+    def test_add_broadcast_and_transposed_layouts(self, device, dtype):
+        # broadcast inputs with a contiguous innermost dimension are
+        # vectorized, and inputs transposed with respect to the output are
+        # tiled through shared memory on CUDA
+        def check(a, b, out=None):
+            expected = a.cpu() + b.cpu()
+            actual = torch.add(a, b, out=out) if out is not None else a + b
+            self.assertEqual(actual.cpu(), expected)
+
+        for n, c, h, w in [(2, 64, 7, 9), (3, 5, 16, 33), (1, 128, 2, 2)]:
+            x = make_tensor((n, c, h, w), device, dtype, low=-9, high=9)
+            x_cl = x.contiguous(memory_format=torch.channels_last)
+            bias = make_tensor((c,), device, dtype, low=-9, high=9)
+            row = make_tensor((w,), device, dtype, low=-9, high=9)
+            check(x, bias.view(1, c, 1, 1))
+            check(x_cl, bias.view(1, c, 1, 1))
+            check(x, row)
+            check(x[..., 1:], row[1:])
+            check(x, x_cl)
+            check(x_cl, x.transpose(-2, -1).contiguous().transpose(-2, -1))
+            check(x, x_cl, out=torch.empty_like(x_cl))
+            m = make_tensor((h * c, w * n + 1), device, dtype, low=-9, high=9)[:, 1:]
+            check(m, m.t().contiguous().t())
+            check(m.t(), m.contiguous().t())
+
     # Tests that CUDA tensors on different devices cannot be used in the same
     # binary operation, and that CUDA "scalars" cannot be used in the same
     # binary operation as non-scalar CPU tensors.
@@ -3,6 +3,7 @@ from typing import NamedTuple
 import collections
 import gc
 import io
+import math
 import os
 import pickle
 import queue
@@ -315,6 +316,57 @@ class TestCuda(TestCase):
                 torch.cuda.caching_allocator_delete(mem)
                 self.assertEqual(torch.cuda.memory_allocated(), prev)
 
+    @unittest.skipIf(IS_SANDCASTLE or IS_REMOTE_GPU, "Does not work on Sandcastle")
+    def test_memory_stats_slab_allocator(self):
+        import subprocess
+        env = dict(os.environ, PYTORCH_CUDA_SLAB_ALLOCATOR="1")
+        subprocess.check_call([sys.executable, '-c', """\
+import torch
+
+tensors = [torch.empty(n, dtype=torch.uint8, device='cuda') for n in (1, 600, 4096, 131072)]
+stats = torch.cuda.memory_stats()
+assert stats['allocation.slab_pool.current'] == 4, stats
+assert stats['allocated_bytes.slab_pool.current'] == 512 + 1024 + 4096 + 131072, stats
+assert stats['allocation.small_pool.current'] == 0, stats
+large = torch.empty(131073, dtype=torch.uint8, device='cuda')
+assert torch.cuda.memory_stats()['allocation.small_pool.current'] == 1
+
+del tensors
+torch.cuda.empty_cache()
+stats = torch.cuda.memory_stats()
+assert stats['allocation.slab_pool.current'] == 0, stats
+assert stats['reserved_bytes.slab_pool.current'] == 0, stats
+"""], env=env)
+
+    @unittest.skipIf(IS_SANDCASTLE or IS_REMOTE_GPU, "Does not work on Sandcastle")
+    def test_memory_stats_expandable_segments(self):
+        import subprocess
+        env = dict(os.environ, PYTORCH_CUDA_EXPANDABLE_SEGMENTS="1")
+        subprocess.check_call([sys.executable, '-c', """\
+import torch
+
+mb = 1024 * 1024
+a = torch.empty(30 * mb, dtype=torch.uint8, device='cuda')
+b = torch.empty(50 * mb, dtype=torch.uint8, device='cuda')
+stats = torch.cuda.memory_stats()
+assert stats['segment.large_pool.current'] == 1, stats
+assert stats['reserved_bytes.large_pool.current'] >= 80 * mb, stats
+
+# Freeing a leaves a hole that coalesces with the free tail after b is freed.
+del a
+del b
+c = torch.empty(80 * mb, dtype=torch.uint8, device='cuda')
+stats = torch.cuda.memory_stats()
+assert stats['segment.large_pool.current'] == 1, stats
+assert stats['reserved_bytes.large_pool.current'] < 90 * mb, stats
+
+del c
+torch.cuda.empty_cache()
+stats = torch.cuda.memory_stats()
+assert stats['segment.large_pool.current'] == 0, stats
+assert stats['reserved_bytes.large_pool.current'] == 0, stats
+"""], env=env)
+
     def test_check_error(self):
         # Assert this call doesn't raise.
         torch.cuda.check_error(0)
@@ -1337,6 +1389,28 @@ class TestCuda(TestCase):
         self.assertNotEqual(t.data_ptr(), ptr, msg='allocation re-used too soon')
         self.assertEqual(list(gpu_tensor), [1])
 
+    def test_caching_pinned_memory_stats(self):
+        torch.cuda.reset_peak_host_memory_stats()
+        before = torch.cuda.host_memory_stats()
+
+        # 1000 bytes are rounded up to the size class of 1024 bytes
+        t = torch.empty(250, dtype=torch.float).pin_memory()
+        stats = torch.cuda.host_memory_stats()
+        self.assertEqual(stats["allocation.current"], before["allocation.current"] + 1)
+        self.assertEqual(stats["allocated_bytes.current"], before["allocated_bytes.current"] + 1024)
+        self.assertGreaterEqual(stats["reserved_bytes.current"], stats["allocated_bytes.current"])
+        self.assertGreaterEqual(stats["allocated_bytes.peak"], stats["allocated_bytes.current"])
+
+        # requests of the same size class share the blocks
+        ptr = t.data_ptr()
+        del t
+        t = torch.empty(245, dtype=torch.float).pin_memory()
+        self.assertEqual(t.data_ptr(), ptr, msg='allocation not reused')
+        del t
+        stats = torch.cuda.host_memory_stats()
+        self.assertEqual(stats["allocation.current"], before["allocation.current"])
+        self.assertEqual(stats["allocated_bytes.current"], before["allocated_bytes.current"])
+
     @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
     def test_caching_pinned_memory_multi_gpu(self):
         # checks that the events preventing pinned memory from being re-used
@@ -1918,6 +1992,77 @@ t2.start()
                 # inf was injected, ensures inf was found.
                 self.assertTrue(sum(v.item() for v in found_inf_per_device.values()) == 1)
 
+    def test_fused_optimizer_steps(self):
+        torch.manual_seed(0)
+        sizes = [(3, 5), (70000,), (4, 4)]
+        lr, beta1, beta2, weight_decay, eps = 0.01, 0.9, 0.999, 0.1, 1e-8
+
+        def lists(dtype=torch.float):
+            return [torch.randn(size, device="cuda", dtype=dtype) for size in sizes]
+
+        def clones(tensors):
+            return [t.clone() for t in tensors]
+
+        # Adam with fp16 model params, fp32 master params and unscaled grads
+        params = lists()
+        model_params = [p.half() for p in params]
+        grads = [g.half() for g in lists()]
+        exp_avgs, exp_avg_sqs = lists(), [t.abs() for t in lists()]
+        ref_params, ref_exp_avgs, ref_exp_avg_sqs = clones(params), clones(exp_avgs), clones(exp_avg_sqs)
+        inv_scale = torch.full((1,), 0.5, device="cuda")
+        found_inf = torch.zeros((1,), device="cuda")
+        torch._amp_foreach_non_finite_check(grads, found_inf)
+        self.assertEqual(found_inf, 0.0)
+        torch._fused_adam_(params, grads, exp_avgs, exp_avg_sqs, [], model_params,
+                           lr=lr, beta1=beta1, beta2=beta2, weight_decay=weight_decay, eps=eps, step=3,
+                           decoupled_weight_decay=True, inv_grad_scale=inv_scale, found_inf=found_inf)
+        for p, m, v, g, ref_p, ref_m, ref_v, model_p in zip(params, exp_avgs, exp_avg_sqs, grads, ref_params,
+                                                            ref_exp_avgs, ref_exp_avg_sqs, model_params):
+            g = g.float() * 0.5
+            ref_p.mul_(1 - lr * weight_decay)
+            ref_m.mul_(beta1).add_(g, alpha=1 - beta1)
+            ref_v.mul_(beta2).addcmul_(g, g, value=1 - beta2)
+            denom = (ref_v.sqrt() / math.sqrt(1 - beta2 ** 3)).add_(eps)
+            ref_p.addcdiv_(ref_m, denom, value=-lr / (1 - beta1 ** 3))
+            self.assertEqual(m, ref_m)
+            self.assertEqual(v, ref_v)
+            self.assertEqual(p, ref_p)
+            self.assertEqual(model_p, ref_p.half())
+
+        # a step is skipped if found_inf is set
+        grads[1][7] = float('inf')
+        torch._amp_foreach_non_finite_check(grads, found_inf)
+        self.assertEqual(found_inf, 1.0)
+        torch._fused_adam_(params, grads, exp_avgs, exp_avg_sqs, [], model_params,
+                           lr=lr, beta1=beta1, beta2=beta2, weight_decay=weight_decay, eps=eps, step=4,
+                           inv_grad_scale=inv_scale, found_inf=found_inf)
+        self.assertEqual(params, ref_params)
+
+        # SGD with nesterov momentum
+        params, grads, bufs = lists(), lists(), lists()
+        ref_params, ref_bufs = clones(params), clones(bufs)
+        torch._fused_sgd_(params, grads, bufs, [], lr=lr, momentum=0.9, weight_decay=weight_decay, nesterov=True)
+        for p, b, g, ref_p, ref_b in zip(params, bufs, grads, ref_params, ref_bufs):
+            d_p = g.add(ref_p, alpha=weight_decay)
+            ref_b.mul_(0.9).add_(d_p)
+            ref_p.add_(d_p.add(ref_b, alpha=0.9), alpha=-lr)
+            self.assertEqual(b, ref_b)
+            self.assertEqual(p, ref_p)
+
+        # LAMB
+        params, grads, exp_avgs, exp_avg_sqs = lists(), lists(), lists(), [t.abs() for t in lists()]
+        ref_params, ref_exp_avgs, ref_exp_avg_sqs = clones(params), clones(exp_avgs), clones(exp_avg_sqs)
+        torch._fused_lamb_(params, grads, exp_avgs, exp_avg_sqs, [],
+                           lr=lr, beta1=beta1, beta2=beta2, weight_decay=weight_decay, eps=eps, step=2)
+        for p, g, ref_p, ref_m, ref_v in zip(params, grads, ref_params, ref_exp_avgs, ref_exp_avg_sqs):
+            ref_m.mul_(beta1).add_(g, alpha=1 - beta1)
+            ref_v.mul_(beta2).addcmul_(g, g, value=1 - beta2)
+            update = (ref_m / (1 - beta1 ** 2)) / ((ref_v.sqrt() / math.sqrt(1 - beta2 ** 2)).add_(eps))
+            update.add_(ref_p, alpha=weight_decay)
+            trust_ratio = ref_p.norm() / update.norm()
+            ref_p.add_(update * trust_ratio, alpha=-lr)
+            self.assertEqual(p, ref_p)
+
     def test_grad_scaling_update_scale(self, device="cuda", dtype=torch.float):
         growth = 2.0
         backoff = 0.25
@@ -3105,6 +3250,117 @@ t2.start()
             # Adds an empty dict for kwargs, which none of the Tensor methods use
             run("Tensor", *(meth_with_args + ({},)))
 
+    @unittest.skipIf((not TEST_CUDA) or
+                     TEST_WITH_ROCM or
+                     int(torch.version.cuda.split(".")[0]) < 11, "CUDA >= 11.0 required for graphs")
+    def test_graph_private_pool(self):
+        s = torch.cuda.Stream()
+        a = torch.ones((1000,), device="cuda")
+        s.wait_stream(torch.cuda.current_stream())
+        with torch.cuda.stream(s):
+            g = torch.cuda._Graph()
+            g.capture_begin()
+            # b is freed during capture, but replay keeps writing to its memory
+            b = a * 2
+            c = b + 1
+            del b
+            g.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+
+        # Outside of the graph, the memory of b is not handed out again.
+        with torch.cuda.stream(s):
+            d = torch.full((1000,), 7., device="cuda")
+        torch.cuda.current_stream().wait_stream(s)
+        a.fill_(3.)
+        g.replay()
+        self.assertEqual(c, torch.full((1000,), 7., device="cuda"))
+        self.assertEqual(d, torch.full((1000,), 7., device="cuda"))
+
+        # A second graph may share the pool of the first.
+        with torch.cuda.stream(s):
+            g2 = torch.cuda._Graph()
+            g2.capture_begin(pool=g.pool())
+            e = c * 2
+            g2.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+        self.assertEqual(g2.pool(), g.pool())
+        g.replay()
+        g2.replay()
+        self.assertEqual(e, torch.full((1000,), 14., device="cuda"))
+
+        del c, e
+        g.reset()
+        g2.reset()
+        torch.cuda.synchronize()
+        torch.cuda.empty_cache()
+
+    @unittest.skipIf((not TEST_CUDA) or
+                     TEST_WITH_ROCM or
+                     int(torch.version.cuda.split(".")[0]) < 11, "CUDA >= 11.0 required for graphs")
+    def test_graph_jit_capture_mode(self):
+        @torch.jit.script
+        def fn(x, y, alpha: float):
+            z = (x * alpha + y).relu()
+            return z, z.sum(1)
+
+        def eager(x, y, alpha: float):
+            z = (x * alpha + y).relu()
+            return z, z.sum(1)
+
+        old_mode = torch._C._jit_set_cuda_graph_capture_mode(True)
+        old_runs = torch._C._jit_set_cuda_graph_warmup_runs(1)
+        try:
+            with torch.no_grad():
+                for shape in ((4, 8), (4, 8), (4, 8), (4, 8), (3, 5), (3, 5), (3, 5), (4, 8)):
+                    for alpha in (2., 2., 0.5):
+                        x = torch.randn(shape, device="cuda")
+                        y = torch.randn(shape, device="cuda")
+                        self.assertEqual(fn(x, y, alpha), eager(x, y, alpha))
+
+            # Inputs that require grad run eagerly.
+            x = torch.randn((4, 8), device="cuda", requires_grad=True)
+            y = torch.randn((4, 8), device="cuda")
+            z, _ = fn(x, y, 2.)
+            z.sum().backward()
+            self.assertEqual(x.grad, (x * 2. + y > 0).float() * 2.)
+        finally:
+            torch._C._jit_set_cuda_graph_capture_mode(old_mode)
+            torch._C._jit_set_cuda_graph_warmup_runs(old_runs)
+
+    def test_jit_num_cuda_streams(self):
+        @torch.jit.script
+        def fn(x, w1, w2, w3):
+            a = torch.mm(x, w1).relu()
+            b = torch.mm(x, w2).sigmoid()
+            c = torch.mm(x, w3).tanh()
+            return torch.cat([a, b, c], 1) + a.sum()
+
+        def eager(x, w1, w2, w3):
+            a = torch.mm(x, w1).relu()
+            b = torch.mm(x, w2).sigmoid()
+            c = torch.mm(x, w3).tanh()
+            return torch.cat([a, b, c], 1) + a.sum()
+
+        x = torch.randn(64, 32, device="cuda")
+        ws = [torch.randn(32, 16, device="cuda") for _ in range(3)]
+        old_num = torch._C._jit_set_num_cuda_streams(4)
+        try:
+            with torch.no_grad():
+                for _ in range(4):
+                    self.assertEqual(fn(x, *ws), eager(x, *ws))
+            graph = torch.jit.last_executed_optimized_graph()
+            self.assertIn("cuda::_stream_use", str(graph))
+            self.assertIn("cuda::_streams_end", str(graph))
+
+            # The side streams are joined back before the outputs are used.
+            s = torch.cuda.Stream()
+            with torch.no_grad(), torch.cuda.stream(s):
+                out = fn(x, *ws)
+                self.assertEqual(torch.cuda.current_stream(), s)
+                self.assertEqual(out, eager(x, *ws))
+        finally:
+            torch._C._jit_set_num_cuda_streams(old_num)
+
     def test_batch_norm_gather_stats(self):
         input = torch.randn(1, 3, 3, 3, device='cuda')
         mean, invstd = torch.batch_norm_gather_stats(
@@ -1,3 +1,4 @@
+import math
 import torch
 import unittest
 from torch.testing._internal.common_utils import TestCase, run_tests, TEST_WITH_ROCM, TEST_WITH_SLOW
@@ -916,6 +917,94 @@ class TestForeach(TestCase):
         torch._foreach_add_([tensor1], [tensor2])
         self.assertEqual(res, [tensor1])
 
+    @dtypes(torch.float, torch.double)
+    def test_mixed_sizes(self, device, dtype):
+        # empty, smaller than a vector, split across threads and transposed tensors
+        sizes = [(0,), (3,), (37, 41), (0, 5), (70001,), (1,), (9, 8)]
+
+        def make(positive=False):
+            tensors = [torch.randn(size, device=device, dtype=dtype) for size in sizes]
+            tensors.append(torch.randn(6, 5, device=device, dtype=dtype).t())
+            return [t.abs() + 0.5 for t in tensors] if positive else tensors
+
+        tensors1, tensors2, tensors3 = make(), make(), make(positive=True)
+        tensors1[2][3, 4] = nan
+        scalars = [0.5 + i for i in range(len(tensors1))]
+
+        self.assertEqual(torch._foreach_add(tensors1, tensors2, alpha=2),
+                         [torch.add(t1, t2, alpha=2) for t1, t2 in zip(tensors1, tensors2)])
+        self.assertEqual(torch._foreach_sub(tensors1, scalars),
+                         [torch.sub(t, s) for t, s in zip(tensors1, scalars)])
+        self.assertEqual(torch._foreach_div(tensors1, tensors3),
+                         [torch.div(t1, t3) for t1, t3 in zip(tensors1, tensors3)])
+        self.assertEqual(torch._foreach_maximum(tensors1, tensors2),
+                         [torch.maximum(t1, t2) for t1, t2 in zip(tensors1, tensors2)])
+        self.assertEqual(torch._foreach_minimum(tensors1, tensors2),
+                         [torch.minimum(t1, t2) for t1, t2 in zip(tensors1, tensors2)])
+        self.assertEqual(torch._foreach_addcmul(tensors1, tensors2, tensors3, scalars),
+                         [torch.addcmul(t1, t2, t3, value=s)
+                          for t1, t2, t3, s in zip(tensors1, tensors2, tensors3, scalars)])
+        self.assertEqual(torch._foreach_addcdiv(tensors1, tensors2, tensors3, 0.3),
+                         [torch.addcdiv(t1, t2, t3, value=0.3) for t1, t2, t3 in zip(tensors1, tensors2, tensors3)])
+        for foreach_op, torch_op in [(torch._foreach_sqrt, torch.sqrt), (torch._foreach_sigmoid, torch.sigmoid),
+                                     (torch._foreach_log1p, torch.log1p), (torch._foreach_trunc, torch.trunc)]:
+            self.assertEqual(foreach_op(tensors3), [torch_op(t) for t in tensors3])
+
+        expected = [t1.mul(t2) for t1, t2 in zip(tensors1, tensors2)]
+        torch._foreach_mul_(tensors1, tensors2)
+        self.assertEqual(tensors1, expected)
+
+        # corresponding tensors of different strides
+        tensors2[-1] = tensors2[-1].contiguous()
+        tensors2[2] = tensors2[2].t().contiguous().t()
+        self.assertEqual(torch._foreach_add(tensors1, tensors2),
+                         [torch.add(t1, t2) for t1, t2 in zip(tensors1, tensors2)])
+
+    @dtypes(torch.float, torch.double)
+    def test_fused_adam(self, device, dtype):
+        sizes = [(3, 5), (70000,), (0,), (4, 4)]
+        lr, beta1, beta2, weight_decay, eps, step = 0.01, 0.9, 0.999, 0.1, 1e-8, 3
+
+        def lists(positive=False):
+            tensors = [torch.randn(size, device=device, dtype=dtype) for size in sizes]
+            return [t.abs() for t in tensors] if positive else tensors
+
+        def clones(tensors):
+            return [t.clone() for t in tensors]
+
+        for amsgrad, decoupled_weight_decay in [(False, False), (True, True)]:
+            params, grads, exp_avgs = lists(), lists(), lists()
+            exp_avg_sqs, max_exp_avg_sqs = lists(positive=True), lists(positive=True)
+            ref_params, ref_exp_avgs = clones(params), clones(exp_avgs)
+            ref_exp_avg_sqs, ref_max_exp_avg_sqs = clones(exp_avg_sqs), clones(max_exp_avg_sqs)
+            torch._fused_adam_(params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs if amsgrad else [], [],
+                               lr=lr, beta1=beta1, beta2=beta2, weight_decay=weight_decay, eps=eps, step=step,
+                               amsgrad=amsgrad, decoupled_weight_decay=decoupled_weight_decay)
+            for g, ref_p, ref_m, ref_v, ref_max_v in zip(grads, ref_params, ref_exp_avgs,
+                                                         ref_exp_avg_sqs, ref_max_exp_avg_sqs):
+                if decoupled_weight_decay:
+                    ref_p.mul_(1 - lr * weight_decay)
+                else:
+                    g = g.add(ref_p, alpha=weight_decay)
+                ref_m.mul_(beta1).add_(g, alpha=1 - beta1)
+                ref_v.mul_(beta2).addcmul_(g, g, value=1 - beta2)
+                if amsgrad:
+                    torch.maximum(ref_max_v, ref_v, out=ref_max_v)
+                denom = ((ref_max_v if amsgrad else ref_v).sqrt() / math.sqrt(1 - beta2 ** step)).add_(eps)
+                ref_p.addcdiv_(ref_m, denom, value=-lr / (1 - beta1 ** step))
+            self.assertEqual(exp_avgs, ref_exp_avgs)
+            self.assertEqual(exp_avg_sqs, ref_exp_avg_sqs)
+            if amsgrad:
+                self.assertEqual(max_exp_avg_sqs, ref_max_exp_avg_sqs)
+            self.assertEqual(params, ref_params)
+
+        # a step is skipped if found_inf is set
+        found_inf = torch.ones((1,), device=device)
+        torch._fused_adam_(params, grads, exp_avgs, exp_avg_sqs, [], [],
+                           lr=lr, beta1=beta1, beta2=beta2, weight_decay=weight_decay, eps=eps, step=step + 1,
+                           found_inf=found_inf)
+        self.assertEqual(params, ref_params)
+
 instantiate_device_type_tests(TestForeach, globals())
 
 if __name__ == '__main__':
@@ -1041,6 +1041,51 @@ class TestIndexing(TestCase):
         for accumulate in [True, False]:
             self.assertRaises(RuntimeError, lambda: torch.index_put_(b, (idx,), c, accumulate=accumulate))
 
+    @onlyCUDA
+    def test_lazy_index_bounds_check(self, device):
+        # Out of bounds indices are reported at the next synchronization
+        x = torch.zeros(5, device=device)
+        x.index_put_((torch.tensor([1, 7], device=device),), torch.ones(2, device=device), accumulate=True)
+        with self.assertRaisesRegex(IndexError, 'index 7 is out of bounds for dimension 0 with size 5'):
+            torch.cuda.synchronize()
+        # and only once
+        torch.cuda.synchronize()
+
+        x.index_select(0, torch.tensor([2, -1], device=device))
+        with self.assertRaisesRegex(IndexError, 'index -1 is out of bounds for dimension 0 with size 5'):
+            x.sum().item()
+
+        x.index_add_(0, torch.tensor([0, 5], device=device), torch.ones(2, device=device))
+        with self.assertRaisesRegex(IndexError, 'index 5 is out of bounds for dimension 0 with size 5'):
+            x.cpu()
+
+        # The elements with a bad index are skipped, so nothing is modified
+        x = torch.arange(15., device=device).view(5, 3)
+        x.index_put_((torch.tensor([0, 9], device=device),), torch.ones(2, 3, device=device), accumulate=True)
+        with self.assertRaisesRegex(IndexError, 'index 9 is out of bounds for dimension 0 with size 5'):
+            torch.cuda.synchronize()
+        self.assertEqual(x[0], torch.tensor([1., 2., 3.]))
+        self.assertEqual(x[1:], torch.arange(3., 15.).view(4, 3))
+
+        x = torch.zeros(4, 5, device=device)
+        rows = torch.tensor([1, 2, 3], device=device)
+        cols = torch.tensor([-1, 5, 0], device=device)
+        x.index_put_((rows, cols), torch.ones(3, device=device), accumulate=True)
+        with self.assertRaisesRegex(IndexError, 'index 5 is out of bounds for dimension 1 with size 5'):
+            x.sum().item()
+        expected = torch.zeros(4, 5)
+        expected[1, 4] = expected[3, 0] = 1
+        self.assertEqual(x, expected)
+
+        # Trusted indices aren't checked before use
+        torch._C._set_trusted_indices(True)
+        try:
+            x = torch.zeros(5, device=device)
+            x.index_put_((torch.tensor([1, -1], device=device),), torch.ones(2, device=device), accumulate=True)
+            self.assertEqual(x, torch.tensor([0., 1., 0., 0., 1.]))
+        finally:
+            torch._C._set_trusted_indices(False)
+
 
 # The tests below are from NumPy test_indexing.py with some modifications to
 # make them compatible with PyTorch. It's licensed under the BDS license below:
@@ -605,6 +605,75 @@ class TestJit(JitTestCase):
         # a_copy is modified
         torch.testing.assert_allclose(orig_res, a_copy)
 
+    def test_add_layer_norm_fusion(self):
+        def dropout_add_layer_norm(x, y, w, b):
+            return torch.layer_norm(x + torch.dropout(y, 0.1, False), [11], w, b)
+
+        def add_layer_norm(x, y, w, b):
+            return torch.layer_norm(torch.add(x, y), [11], w, b)
+
+        x = torch.rand((7, 11))
+        y = torch.rand((7, 11))
+        w = torch.rand(11)
+        b = torch.rand(11)
+        for fn in (dropout_add_layer_norm, add_layer_norm):
+            m = torch.jit.script(fn)
+            orig_res = fn(x, y, w, b)
+            torch._C._jit_pass_fuse_add_layer_norm(m.graph)
+            FileCheck().check_not("aten::add(") \
+                .check_not("aten::layer_norm(") \
+                .check("aten::add_layer_norm(") \
+                .run(m.graph)
+            torch.testing.assert_allclose(orig_res, m(x, y, w, b))
+
+    def test_conv_batch_norm_fusion(self):
+        def conv_bn(x, cw, cb, w, b, m, v, training: bool):
+            y = torch.conv2d(x, cw, cb, 1, 1)
+            return torch.batch_norm(y, w, b, m, v, training, 0.1, 1e-5, True)
+
+        x = torch.randn(4, 3, 7, 7)
+        cw = torch.randn(8, 3, 3, 3)
+        cb = torch.randn(8)
+        w = torch.rand(8)
+        b = torch.rand(8)
+        for training in (True, False):
+            m = torch.randn(8)
+            v = torch.rand(8) + 0.5
+            m_ref, v_ref = m.clone(), v.clone()
+            s = torch.jit.script(conv_bn)
+            orig_res = conv_bn(x, cw, cb, w, b, m_ref, v_ref, training)
+            torch._C._jit_pass_fuse_conv_batch_norm(s.graph)
+            FileCheck().check_not("aten::conv2d(") \
+                .check_not("aten::batch_norm(") \
+                .check("aten::conv_batch_norm(") \
+                .run(s.graph)
+            torch.testing.assert_allclose(orig_res, s(x, cw, cb, w, b, m, v, training))
+            torch.testing.assert_allclose(m, m_ref)
+            torch.testing.assert_allclose(v, v_ref)
+
+    def test_batch_norm_add_relu_fusion(self):
+        def bn_add_relu(x, y, w, b, m, v):
+            return torch.relu(torch.batch_norm(x, w, b, m, v, False, 0.1, 1e-5, True) + y)
+
+        def add_bn_relu_(x, y, w, b, m, v):
+            return torch.add(y, torch.batch_norm(x, w, b, m, v, False, 0.1, 1e-5, True)).relu_()
+
+        x = torch.randn((4, 3, 5, 5))
+        y = torch.randn((4, 3, 5, 5))
+        w = torch.rand(3)
+        b = torch.rand(3)
+        m = torch.randn(3)
+        v = torch.rand(3) + 0.5
+        for fn in (bn_add_relu, add_bn_relu_):
+            s = torch.jit.script(fn)
+            orig_res = fn(x, y, w, b, m, v)
+            torch._C._jit_pass_fuse_batch_norm_add_relu(s.graph)
+            FileCheck().check_not("aten::batch_norm(") \
+                .check_not("aten::add(") \
+                .check("aten::batch_norm_add_relu(") \
+                .run(s.graph)
+            torch.testing.assert_allclose(orig_res, s(x, y, w, b, m, v))
+
     @unittest.skipIf(GRAPH_EXECUTOR != ProfilingMode.LEGACY, "Simple executor doesn't have shape information")
     def test_peephole_optimize_shape_ops(self):
         def test_input(func, input, result):
@@ -1287,6 +1356,32 @@ graph(%Ra, %Rb):
         torch._C._jit_pass_complete_shape_analysis(graph, (x, mask), False)
         FileCheck().run(input_str, graph)
 
+    def test_plan_memory(self):
+        def fn(x, y):
+            a = x + y
+            b = a * 2
+            c = b + b
+            d = c.t()
+            return torch.relu(d)
+
+        graph = torch.jit.script(fn).graph
+        # meta inputs only carry the sizes and strides
+        x = torch.empty(16, 32, device='meta')
+        torch._C._jit_pass_complete_shape_analysis(graph, (x, x), False)
+        allocations, arena_size, peak_live_bytes = torch._C._jit_pass_plan_memory(graph)
+
+        # a, b and c, but not the view of c nor the output
+        nbytes = 16 * 32 * 4
+        self.assertEqual(len(allocations), 3)
+        self.assertTrue(all(size == nbytes for _, size, _, _, _ in allocations))
+        # c reuses the memory of a, which is dead by then
+        self.assertEqual(peak_live_bytes, 2 * nbytes)
+        self.assertEqual(arena_size, 2 * nbytes)
+        for i, (_, size, offset, begin, end) in enumerate(allocations):
+            for _, other_size, other_offset, other_begin, other_end in allocations[i + 1:]:
+                if begin <= other_end and other_begin <= end:
+                    self.assertTrue(offset + size <= other_offset or other_offset + other_size <= offset)
+
     # TODO: update verify to work with GraphExecutors
     @unittest.skip("verify needs to be updated to work with GraphExecutors")
     def test_verify(self):
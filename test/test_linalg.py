@@ -5056,6 +5056,30 @@ else:
         for b1, b2, ref, out_tensor in generate_tensor():
             self._test_addbmm_baddbmm("baddbmm", b1, b2, ref, out_tensor)
 
+    # Sizes of the register-blocked kernel for small matrices, which is used
+    # when MKL's batch gemm is not, with remainders of its row and column tiles
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_bmm_small_matrices(self, device, dtype):
+        def invert_perm(p):
+            d = {x: i for i, x in enumerate(p)}
+            return (d[0], d[1], d[2])
+
+        for (num_batches, M, N, O), perm1, perm2 in itertools.product(
+                ((64, 7, 13, 9), (3, 64, 64, 64), (5, 5, 17, 33), (2, 1, 128, 20), (4, 33, 2, 128)),
+                itertools.permutations((0, 1, 2)), ((0, 1, 2), (0, 2, 1))):
+            b1 = make_tensor((num_batches, M, N), device, dtype, low=-1, high=1)
+            b2 = make_tensor((num_batches, N, O), device, dtype, low=-1, high=1)
+            b1 = b1.permute(perm1).contiguous().permute(invert_perm(perm1))
+            b2 = b2.permute(perm2).contiguous().permute(invert_perm(perm2))
+            ref = torch.from_numpy(b1.cpu().numpy() @ b2.cpu().numpy())
+            self.assertEqual(torch.bmm(b1, b2), ref)
+
+            t = make_tensor((num_batches, M, O), device, dtype, low=-1, high=1)
+            self.assertEqual(torch.baddbmm(t, b1, b2, beta=.5, alpha=-2), t * .5 - 2 * ref)
+            nan = torch.full_like(t, math.nan)
+            self.assertEqual(torch.baddbmm(nan, b1, b2, beta=0, alpha=3), 3 * ref)
+
     # TODO: update to compare against NumPy
     @onlyCUDA
     def test_solve_methods_arg_device(self, device):
@@ -6130,6 +6154,49 @@ else:
         run_test((5, 65536), (65536, 5, 10))
         run_test((5, 262144), (262144, 5, 10))
 
+    # Sizes of the register-resident kernels for tiny matrices (up to 32, with
+    # segments of 4, 8, 16 and 32 threads per matrix) and of the cuBLAS batched
+    # path for mid-sized ones, checked against the CPU
+    @onlyCUDA
+    @skipCUDAIfNoMagma
+    @skipCUDAIfRocm
+    @dtypes(torch.float32, torch.float64)
+    @precisionOverride({torch.float32: 1e-3, torch.float64: 1e-8})
+    def test_batched_solvers_small_matrices(self, device, dtype):
+        from torch.testing._internal.common_utils import \
+            (random_fullrank_matrix_distinct_singular_value, random_hermitian_pd_matrix)
+
+        for n, batch in itertools.product([1, 3, 4, 7, 16, 29, 32, 40], [(), (1,), (5,), (2, 3)]):
+            A = random_fullrank_matrix_distinct_singular_value(n, *batch, dtype=dtype)
+            b = torch.randn(*batch, n, 2, dtype=dtype)
+            A_cuda, b_cuda = A.to(device), b.to(device)
+
+            x_exp = torch.linalg.solve(A, b)
+            self.assertEqual(torch.linalg.solve(A_cuda, b_cuda), x_exp)
+            x, LU = torch.solve(b_cuda, A_cuda)
+            self.assertEqual(x, x_exp)
+            self.assertEqual(LU, torch.lu(A)[0])
+            self.assertEqual(torch.inverse(A_cuda), torch.inverse(A))
+            self.assertEqual(torch.linalg.inv(A_cuda), torch.linalg.inv(A))
+
+            LU_data, LU_pivots = torch.lu(A_cuda)
+            self.assertEqual(torch.lu_solve(b_cuda, LU_data, LU_pivots), x_exp)
+
+            S = random_hermitian_pd_matrix(n, *batch, dtype=dtype)
+            for upper in [False, True]:
+                chol = torch.cholesky(S, upper=upper)
+                self.assertEqual(torch.cholesky_solve(b_cuda, chol.to(device), upper=upper),
+                                 torch.cholesky_solve(b, chol, upper=upper))
+
+        # Non-contiguous inputs and a singular matrix in the batch
+        A = torch.randn(6, 5, 5, dtype=dtype, device=device).transpose(-2, -1)
+        self.assertEqual(torch.inverse(A), torch.inverse(A.cpu()))
+        A[3] = 0
+        with self.assertRaisesRegex(RuntimeError, "For batch 3: U\\(1,1\\) is zero"):
+            torch.linalg.inv(A)
+        with self.assertRaisesRegex(RuntimeError, "For batch 3: U\\(1,1\\) is zero"):
+            torch.linalg.solve(A, torch.randn(6, 5, 1, dtype=dtype, device=device))
+
     @skipCUDAIfNoMagma
     @skipCPUIfNoLapack
     @dtypes(torch.float32, torch.float64, torch.complex64, torch.complex128)
@@ -195,6 +195,55 @@ class TestMkldnn(TestCase):
             self._test_serialization(mkldnn_conv2d, (x.to_mkldnn(),))
             self._test_tracing(mkldnn_conv2d, (x.to_mkldnn(),))
 
+    def test_weight_cache(self):
+        weight_cache = torch.backends.mkldnn.weight_cache
+        original_max_size = weight_cache.max_size
+        weight_cache.clear()
+        try:
+            conv2d = torch.nn.Conv2d(4, 8, kernel_size=3, padding=1).float()
+            linear = torch.nn.Linear(16, 32).float()
+            x = torch.randn(2, 4, 16, 16, dtype=torch.float32)
+            y = torch.randn(3, 16, dtype=torch.float32)
+
+            def check():
+                with torch.backends.mkldnn.flags(enabled=False):
+                    expected_conv = conv2d(x)
+                self.assertEqual(torch.mkldnn_convolution(x, conv2d.weight, conv2d.bias,
+                                                          [1, 1], [1, 1], [1, 1], 1),
+                                 expected_conv)
+                self.assertEqual(torch._C._nn.mkldnn_linear(y.to_mkldnn(), linear.weight,
+                                                            linear.bias).to_dense(),
+                                 linear(y))
+
+            with torch.no_grad():
+                check()
+                size = weight_cache.size
+                self.assertGreater(size, 0)
+                # the reordered weights are reused
+                check()
+                self.assertEqual(weight_cache.size, size)
+                # and reordered again after the parameters are mutated
+                conv2d.weight.mul_(2)
+                linear.weight.add_(1)
+                check()
+                self.assertEqual(weight_cache.size, size)
+
+            # trained weights are not cached
+            weight_cache.clear()
+            check()
+            self.assertEqual(weight_cache.size, 0)
+
+            with torch.no_grad():
+                weight_cache.max_size = 0
+                check()
+                self.assertEqual(weight_cache.size, 0)
+        finally:
+            weight_cache.max_size = original_max_size
+            weight_cache.clear()
+
+        with self.assertRaisesRegex(RuntimeError, 'read-only'):
+            weight_cache.size = 1
+
     def test_conv2d_legacy_jit_model(self):
         """
         MKLDNN integration used to serialize models with 5d weight for grouped
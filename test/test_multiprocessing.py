@@ -11,6 +11,7 @@ import torch
 import torch.cuda
 import torch.multiprocessing as mp
 import torch.utils.hooks
+from torch.multiprocessing import shm_pool
 from torch.nn import Parameter
 from torch.testing._internal.common_utils import (TestCase, run_tests, IS_WINDOWS, NO_MULTIPROCESSING_SPAWN, TEST_WITH_ASAN,
                                                   load_tests, slowTest, TEST_WITH_TSAN)
@@ -102,6 +103,16 @@ def sum_tensors(inq, outq):
                       tensor.numel(), tensor.storage().size()))
 
 
+def sum_tensors_one_at_a_time(inq, outq, n):
+    for _ in range(n):
+        tensor = inq.get()
+        outq.put(tensor.sum().item())
+        del tensor
+    # returns the reference counters held back for the retained segments
+    torch.cuda.ipc_collect()
+    outq.put(None)
+
+
 def queue_get_exception(inqueue, outqueue):
     os.close(2)  # hide expected error message
     try:
@@ -179,6 +190,18 @@ def fs_sharing():
         mp.set_sharing_strategy(prev_strategy)
 
 
+@contextlib.contextmanager
+def shm_pool_sharing():
+    prev_strategy = mp.get_sharing_strategy()
+    mp.set_sharing_strategy('shm_pool')
+    try:
+        yield
+    finally:
+        mp.set_sharing_strategy(prev_strategy)
+        # the arenas are kept for the next storages otherwise
+        shm_pool.clear()
+
+
 class leak_checker(object):
 
     def __init__(self, test_case):
@@ -348,6 +371,56 @@ class TestMultiprocessing(TestCase):
         with fs_sharing():
             self._test_pool(repeat=TEST_REPEATS)
 
+    @unittest.skipIf(platform == 'darwin' or IS_WINDOWS, "shm_pool strategy is not supported on macOS and Windows")
+    @unittest.skipIf(TEST_WITH_ASAN,
+                     "seems to hang with ASAN, see https://github.com/pytorch/pytorch/issues/5326")
+    def test_shm_pool_sharing(self):
+        with shm_pool_sharing():
+            self._test_sharing(repeat=TEST_REPEATS)
+
+    @unittest.skipIf(platform == 'darwin' or IS_WINDOWS, "shm_pool strategy is not supported on macOS and Windows")
+    def test_shm_pool_preserve_sharing(self):
+        with shm_pool_sharing():
+            self._test_preserve_sharing(repeat=TEST_REPEATS)
+
+    @unittest.skipIf(platform == 'darwin' or IS_WINDOWS, "shm_pool strategy is not supported on macOS and Windows")
+    def test_shm_pool_pool(self):
+        with shm_pool_sharing():
+            self._test_pool(repeat=TEST_REPEATS)
+
+    @unittest.skipIf(platform == 'darwin' or IS_WINDOWS, "shm_pool strategy is not supported on macOS and Windows")
+    def test_shm_pool_block_reuse(self):
+        with leak_checker(self), shm_pool_sharing():
+            q = mp.Queue()
+            x = torch.arange(100.)
+            q.put(x)
+            y = q.get(timeout=1)
+            self.assertEqual(y.storage()._cdata, x.storage()._cdata)
+            self.assertIsNotNone(mp._shm_pool_block(x.storage()))
+            free_blocks = shm_pool.num_free_blocks()
+            del x, y
+            gc.collect()
+            self.assertEqual(shm_pool.num_free_blocks(), free_blocks + 1)
+
+            # the freed block is used again
+            for _ in range(TEST_REPEATS):
+                q.put(torch.ones(100))
+                self.assertEqual(q.get(timeout=1), torch.ones(100), atol=0, rtol=0)
+            gc.collect()
+            self.assertEqual(shm_pool.num_free_blocks(), free_blocks + 1)
+
+    @unittest.skipIf(platform == 'darwin' or IS_WINDOWS, "shm_pool strategy is not supported on macOS and Windows")
+    def test_shm_pool_fallback(self):
+        with leak_checker(self), shm_pool_sharing():
+            q = mp.Queue()
+            # larger than the largest blocks
+            x = torch.zeros(shm_pool.MAX_BLOCK_SIZE // 4 + 1)
+            q.put(x)
+            y = q.get(timeout=10)
+            self.assertEqual(y.storage()._cdata, x.storage()._cdata)
+            self.assertIsNone(mp._shm_pool_block(x.storage()))
+            self.assertTrue(x.is_shared())
+
     @unittest.skipIf(not HAS_SHM_FILES, "don't not how to check if shm files exist")
     def test_fs(self):
         def queue_put():
@@ -508,6 +581,31 @@ class TestMultiprocessing(TestCase):
         # memory 'file' for performance reason
         torch.cuda.ipc_collect()
 
+    @unittest.skipIf(NO_MULTIPROCESSING_SPAWN, "Disabled for environments that \
+                     don't support multiprocessing with spawn start method")
+    @unittest.skipIf(not TEST_CUDA_IPC, 'CUDA IPC not available')
+    def test_cuda_retained_segments(self):
+        # The small tensors come from the same segment, which the consumer
+        # keeps mapped in between them
+        ctx = mp.get_context('spawn')
+        inq = ctx.Queue()
+        outq = ctx.Queue()
+        os.environ['PYTORCH_CUDA_IPC_RETAINED_SEGMENTS'] = '2'
+        try:
+            p = ctx.Process(target=sum_tensors_one_at_a_time, args=(inq, outq, 10))
+            p.start()
+        finally:
+            del os.environ['PYTORCH_CUDA_IPC_RETAINED_SEGMENTS']
+
+        for i in range(10):
+            tensor = torch.full((5,), float(i), device='cuda')
+            inq.put(tensor)
+            self.assertEqual(outq.get(), 5. * i)
+            del tensor
+        self.assertIsNone(outq.get())
+        p.join()
+        torch.cuda.ipc_collect()
+
     @unittest.skipIf(IS_WINDOWS, 'not applicable to Windows (only fails with fork)')
     @unittest.skipIf(not torch.cuda.is_available(), 'CUDA not available')
     def test_cuda_bad_call(self):
@@ -15,7 +15,7 @@ all_operators_with_namedtuple_return = {
     'qr', 'geqrf', 'solve', 'slogdet', 'sort', 'topk', 'lstsq',
     'triangular_solve', 'cummax', 'cummin', 'linalg_eigh', "_unpack_dual", 'linalg_qr',
     '_svd_helper', 'linalg_svd', 'linalg_slogdet', 'fake_quantize_per_tensor_affine_cachemask',
-    'fake_quantize_per_channel_affine_cachemask',
+    'fake_quantize_per_channel_affine_cachemask', 'aminmax_var_mean',
 }
 
 
@@ -77,6 +77,7 @@ class TestNamedTupleAPI(TestCase):
                input=(per_channel_scale, per_channel_zp, 1, 0, 255),
                names=('output', 'mask',), hasout=False),
             op(operators=['_unpack_dual'], input=(0,), names=('primal', 'tangent'), hasout=False),
+            op(operators=['aminmax_var_mean'], input=(0,), names=('min', 'max', 'var', 'mean'), hasout=True),
         ]
 
         def get_func(f):
@@ -0,0 +1,131 @@
+import torch
+import torch.nn.functional as F
+from torch.testing._internal.common_utils import TestCase, run_tests, load_tests
+from torch.testing._internal.common_device_type import \
+    (instantiate_device_type_tests, dtypes)
+
+# load_tests from torch.testing._internal.common_utils is used to automatically filter tests for
+# sharding on sandcastle. This line silences flake warnings
+load_tests = load_tests
+
+
+class TestNestedTensor(TestCase):
+    def _make_components(self, lengths, features, device, dtype):
+        return [torch.randn(length, features, device=device, dtype=dtype) for length in lengths]
+
+    @dtypes(torch.float, torch.double)
+    def test_nested_tensor_conversions(self, device, dtype):
+        components = self._make_components([3, 1, 4, 0], 5, device, dtype)
+        nt = torch.nested_tensor(components)
+        self.assertEqual(nt.dim(), 3)
+        self.assertEqual(nt.numel(), 8 * 5)
+        self.assertEqual(nt.dtype, dtype)
+        self.assertEqual(nt.unbind(), components)
+        nt.clone().unbind()[0].zero_()
+        self.assertEqual(nt.unbind(), components)
+
+        padded = nt.to_padded_tensor(-1.)
+        self.assertEqual(padded.shape, (4, 4, 5))
+        for i, component in enumerate(components):
+            self.assertEqual(padded[i, :len(component)], component)
+            self.assertTrue((padded[i, len(component):] == -1).all())
+        self.assertEqual(torch.to_padded_tensor(nt, 0., (5, 6, 7))[:, :4, :5],
+                         nt.to_padded_tensor(0.))
+
+        lengths = torch.tensor([len(component) for component in components], device=device)
+        self.assertEqual(torch.nested_tensor_from_padded(padded, lengths).unbind(), components)
+
+        with self.assertRaisesRegex(RuntimeError, "do not have sizes"):
+            nt.size()
+        with self.assertRaisesRegex(RuntimeError, "same dim, dtype and device"):
+            torch.nested_tensor([torch.randn(2, 3, device=device), torch.randn(3, device=device)])
+        with self.assertRaisesRegex(RuntimeError, "smaller than the size"):
+            nt.to_padded_tensor(0., (4, 3, 5))
+        with self.assertRaisesRegex(RuntimeError, "expected lengths between"):
+            torch.nested_tensor_from_padded(padded, lengths + 1)
+
+    @dtypes(torch.float, torch.double)
+    def test_nested_tensor_pointwise(self, device, dtype):
+        components = self._make_components([2, 5, 3], 4, device, dtype)
+        others = self._make_components([2, 5, 3], 4, device, dtype)
+        nt = torch.nested_tensor(components)
+        other = torch.nested_tensor(others)
+        bias = torch.randn(4, device=device, dtype=dtype)
+
+        def check(result, fn):
+            self.assertEqual(result.unbind(), [fn(i, c) for i, c in enumerate(components)])
+
+        check(torch.relu(nt), lambda i, c: torch.relu(c))
+        check(F.gelu(nt), lambda i, c: F.gelu(c))
+        check(torch.sigmoid(nt), lambda i, c: torch.sigmoid(c))
+        check(torch.tanh(nt), lambda i, c: torch.tanh(c))
+        check(nt + other, lambda i, c: c + others[i])
+        check(torch.add(nt, other, alpha=2), lambda i, c: c + 2 * others[i])
+        check(nt * other, lambda i, c: c * others[i])
+        check(nt * 3, lambda i, c: c * 3)
+        check(nt + bias, lambda i, c: c + bias)
+        check(bias * nt, lambda i, c: bias * c)
+
+        result = nt.clone()
+        result.add_(other).mul_(bias).relu_()
+        check(result, lambda i, c: ((c + others[i]) * bias).relu())
+
+        with self.assertRaisesRegex(RuntimeError, "same sizes"):
+            nt + torch.nested_tensor(self._make_components([2, 5, 4], 4, device, dtype))
+        with self.assertRaisesRegex(RuntimeError, "regular last dim"):
+            nt + torch.randn(3, device=device, dtype=dtype)
+
+    @dtypes(torch.float, torch.double)
+    def test_nested_tensor_nn(self, device, dtype):
+        components = self._make_components([6, 1, 3], 8, device, dtype)
+        nt = torch.nested_tensor(components)
+        weight = torch.randn(5, 8, device=device, dtype=dtype)
+        bias = torch.randn(5, device=device, dtype=dtype)
+        ln_weight = torch.randn(8, device=device, dtype=dtype)
+        ln_bias = torch.randn(8, device=device, dtype=dtype)
+
+        self.assertEqual(F.linear(nt, weight, bias).unbind(),
+                         [F.linear(c, weight, bias) for c in components])
+        self.assertEqual(F.layer_norm(nt, (8,), ln_weight, ln_bias).unbind(),
+                         [F.layer_norm(c, (8,), ln_weight, ln_bias) for c in components])
+        # regular and ragged dims
+        self.assertEqual(torch.softmax(nt, -1).unbind(), [torch.softmax(c, -1) for c in components])
+        self.assertEqual(torch.softmax(nt, 1).unbind(), [torch.softmax(c, 0) for c in components])
+
+        with self.assertRaisesRegex(RuntimeError, "regular last dim"):
+            F.linear(nt, torch.randn(5, 7, device=device, dtype=dtype))
+        with self.assertRaisesRegex(RuntimeError, "regular last dims"):
+            F.layer_norm(nt, (6, 8))
+        with self.assertRaisesRegex(RuntimeError, "along dim 0"):
+            torch.softmax(nt, 0)
+
+    @dtypes(torch.float, torch.double)
+    def test_nested_tensor_attention(self, device, dtype):
+        lengths = [5, 2, 7]
+        batch, heads, features, max_length = len(lengths), 2, 4, max(lengths)
+        query, key, value = (
+            torch.randn(batch, heads, max_length, features, device=device, dtype=dtype) for _ in range(3))
+        nested = [torch.nested_tensor([t[i, :, :length] for i, length in enumerate(lengths)])
+                  for t in (query, key, value)]
+        # masked out where true
+        mask = (torch.arange(max_length, device=device)[None, :] >=
+                torch.tensor(lengths, device=device)[:, None]).view(batch, 1, 1, max_length)
+
+        output, _ = torch._scaled_dot_product_attention(*nested)
+        expected, _ = torch._scaled_dot_product_attention(query, key, value, mask)
+        self.assertEqual(output.unbind(), [expected[i, :, :length] for i, length in enumerate(lengths)])
+
+        output, _ = torch._scaled_dot_product_attention(*nested, is_causal=True)
+        for i, length in enumerate(lengths):
+            causal, _ = torch._scaled_dot_product_attention(
+                query[i, :, :length], key[i, :, :length], value[i, :, :length], is_causal=True)
+            self.assertEqual(output.unbind()[i], causal)
+
+        with self.assertRaisesRegex(RuntimeError, "don't take a mask"):
+            torch._scaled_dot_product_attention(*nested, attn_mask=mask)
+
+
+instantiate_device_type_tests(TestNestedTensor, globals(), except_for='meta')
+
+if __name__ == '__main__':
+    run_tests()
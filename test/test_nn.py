@@ -8,6 +8,8 @@ import unittest.mock as mock
 import itertools
 import warnings
 import pickle
+import os
+import tempfile
 from copy import deepcopy
 from itertools import repeat, product
 from functools import reduce
@@ -36,7 +38,8 @@ from torch.testing import get_all_fp_dtypes
 from torch.testing._internal.common_utils import freeze_rng_state, run_tests, TestCase, skipIfNoLapack, skipIfRocm, \
     TEST_NUMPY, TEST_SCIPY, TEST_WITH_ROCM, download_file, \
     get_function_arglist, load_tests, repeat_test_for_types, ALL_TENSORTYPES, \
-    ALL_TENSORTYPES2, suppress_warnings, TemporaryFileName, TEST_WITH_UBSAN, IS_PPC
+    ALL_TENSORTYPES2, suppress_warnings, TemporaryFileName, TEST_WITH_UBSAN, IS_PPC, \
+    DeterministicGuard
 from torch.testing._internal.common_cuda import TEST_CUDA, TEST_MULTIGPU, TEST_CUDNN, TEST_CUDNN_VERSION
 from torch.testing._internal.common_nn import NNTestCase, NewModuleTest, CriterionTest, \
     module_tests, criterion_tests, loss_reference_fns, \
@@ -4357,6 +4360,29 @@ class TestNN(NNTestCase):
             self.assertEqual(conv1.bias.grad.data, conv2.bias.grad.data, atol=0.0, rtol=0)
             self.assertEqual(conv1.weight.grad.data, conv2.weight.grad.data, atol=0.0, rtol=0)
 
+    @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
+    @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
+    def test_cudnn_benchmark_cache(self):
+        inputs = torch.randn(2, 3, 9, 9, device="cuda", requires_grad=True)
+        conv = torch.nn.Conv2d(3, 4, 3).cuda()
+        with cudnn.flags(enabled=True, benchmark=True, deterministic=False):
+            conv(inputs).sum().backward()
+        with tempfile.TemporaryDirectory() as tmpdir:
+            path = os.path.join(tmpdir, "cudnn_benchmark_cache")
+            cudnn.save_benchmark_cache(path)
+            torch._C._cudnn.clearBenchmarkCache()
+            # the forward, backward data and backward filter algorithms
+            self.assertGreaterEqual(cudnn.load_benchmark_cache(path), 3)
+            state = torch._C._cudnn.exportBenchmarkCache()
+            torch._C._cudnn.clearBenchmarkCache()
+            self.assertGreaterEqual(torch._C._cudnn.importBenchmarkCache(state), 3)
+            # saving merges the entries already in the file
+            torch._C._cudnn.clearBenchmarkCache()
+            cudnn.save_benchmark_cache(path)
+            self.assertGreaterEqual(cudnn.load_benchmark_cache(path), 3)
+        with cudnn.flags(enabled=True, benchmark=True, deterministic=False):
+            conv(inputs).sum().backward()
+
     def test_Conv2d_missing_argument(self):
         c = nn.Conv2d(3, 3, 3)
         self.assertRaises(TypeError, lambda: c(None))
@@ -5155,6 +5181,19 @@ class TestNN(NNTestCase):
 
             (hx + cx).sum().backward()
 
+    def test_RNN_fused_cell_pointwise_cpu(self):
+        # Without autograd, the CPU LSTM and GRU run the gate nonlinearities of
+        # a time step in one kernel. Compare them to the autograd path.
+        for module, dtype, hidden_size in itertools.product(
+                (nn.LSTM, nn.GRU), (torch.float, torch.double), (5, 19)):
+            rnn = module(7, hidden_size, num_layers=2, bidirectional=True).to(dtype)
+            input = torch.randn(4, 3, 7, dtype=dtype)
+            with torch.no_grad():
+                output, hidden = rnn(input)
+            output_ref, hidden_ref = rnn(input)
+            self.assertEqual(output, output_ref)
+            self.assertEqual(hidden, hidden_ref)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_pack_sequence_batch_sizes_throw(self):
         with self.assertRaisesRegex(ValueError, r"batch_sizes should always be on CPU"):
@@ -11014,6 +11053,146 @@ class TestNNDeviceType(NNTestCase):
         if self.device_type == 'cuda':
             self._test_LayerNorm_cuda_half(device)
 
+    def test_add_layer_norm(self, device):
+        x = torch.randn(4, 3, 5, device=device, dtype=torch.double, requires_grad=True)
+        r = torch.randn(4, 3, 5, device=device, dtype=torch.double, requires_grad=True)
+        w = torch.randn(5, device=device, dtype=torch.double, requires_grad=True)
+        b = torch.randn(5, device=device, dtype=torch.double, requires_grad=True)
+        self.assertEqual(torch.add_layer_norm(x, r, [5], w, b),
+                         F.layer_norm(r + x, [5], w, b))
+        self.assertTrue(gradcheck(lambda x, r, w, b: torch.add_layer_norm(x, r, [5], w, b), (x, r, w, b)))
+        self.assertTrue(gradgradcheck(lambda x, r, w, b: torch.add_layer_norm(x, r, [5], w, b), (x, r, w, b)))
+
+        # residual broadcast against the input
+        r1 = torch.randn(3, 5, device=device, dtype=torch.double, requires_grad=True)
+        self.assertEqual(torch.add_layer_norm(x, r1, [5], w, b),
+                         F.layer_norm(r1 + x, [5], w, b))
+        self.assertTrue(gradcheck(lambda x, r: torch.add_layer_norm(x, r, [5], w, b), (x, r1)))
+
+        # dropout is applied only in training
+        self.assertEqual(torch.add_layer_norm(x, r, [5], w, b, p=1., train=False),
+                         F.layer_norm(r + x, [5], w, b))
+        self.assertEqual(torch.add_layer_norm(x, r, [5], w, b, p=1., train=True),
+                         F.layer_norm(r, [5], w, b))
+        out = torch.add_layer_norm(x, r, [5], w, b, p=0.5, train=True)
+        out.sum().backward()
+        # every element of the input is either dropped or scaled by 2
+        self.assertTrue(((x.grad == 0) | (r.grad * 2 - x.grad).abs().lt(1e-6)).all())
+
+        # float calls the fused kernel on CPU
+        xf = torch.randn(6, 32, device=device)
+        rf = torch.randn(6, 32, device=device)
+        self.assertEqual(torch.add_layer_norm(xf, rf, [32], eps=1e-5),
+                         F.layer_norm(rf + xf, [32], eps=1e-5))
+
+    def test_conv_batch_norm(self, device):
+        for conv_bias, channels_last, training in product([False, True], [False, True], [False, True]):
+            x = torch.randn(4, 3, 9, 9, device=device, dtype=torch.double)
+            if channels_last:
+                x = x.to(memory_format=torch.channels_last)
+            x.requires_grad_()
+            cw = torch.randn(8, 3, 3, 3, device=device, dtype=torch.double, requires_grad=True)
+            cb = torch.randn(8, device=device, dtype=torch.double, requires_grad=True) if conv_bias else None
+            w = torch.randn(8, device=device, dtype=torch.double, requires_grad=True)
+            b = torch.randn(8, device=device, dtype=torch.double, requires_grad=True)
+            m = torch.randn(8, device=device, dtype=torch.double)
+            v = torch.rand(8, device=device, dtype=torch.double) + 0.5
+            m_ref, v_ref = m.clone(), v.clone()
+
+            out = torch.conv_batch_norm(x, cw, cb, [2], [1], [1], 1, w, b, m, v, training, 0.1, 1e-5)
+            out_ref = F.batch_norm(F.conv2d(x, cw, cb, stride=2, padding=1), m_ref, v_ref, w, b,
+                                   training=training)
+            self.assertEqual(out, out_ref)
+            self.assertEqual(m, m_ref)
+            self.assertEqual(v, v_ref)
+
+            grad = torch.randn_like(out)
+            grads = torch.autograd.grad(out, (x, cw, w, b), grad)
+            grads_ref = torch.autograd.grad(out_ref, (x, cw, w, b), grad)
+            self.assertEqual(grads, grads_ref)
+
+    def test_batch_norm_train_memory_formats(self, device):
+        # the blocked CPU kernels take contiguous and channels last inputs
+        for shape, channels_last in [((5, 7), False), ((4, 3, 17), False), ((2, 5, 70, 70), False),
+                                     ((4, 3, 6, 6), True), ((20, 300, 4, 4), True)]:
+            x = torch.randn(shape, device=device, dtype=torch.double)
+            if channels_last:
+                x = x.to(memory_format=torch.channels_last)
+            x.requires_grad_()
+            c = shape[1]
+            w = torch.randn(c, device=device, dtype=torch.double, requires_grad=True)
+            b = torch.randn(c, device=device, dtype=torch.double, requires_grad=True)
+            m = torch.zeros(c, device=device, dtype=torch.double)
+            v = torch.ones(c, device=device, dtype=torch.double)
+            out = F.batch_norm(x, m, v, w, b, training=True)
+
+            dims = [0] + list(range(2, x.dim()))
+            stats_shape = [1, c] + [1] * (x.dim() - 2)
+            var, mean = torch.var_mean(x, dims, unbiased=False)
+            expected = (x - mean.view(stats_shape)) / (var.view(stats_shape) + 1e-5).sqrt() \
+                * w.view(stats_shape) + b.view(stats_shape)
+            self.assertEqual(out, expected)
+            self.assertEqual(m, 0.1 * mean.detach())
+            self.assertEqual(v, 0.9 + 0.1 * torch.var(x.detach(), dims))
+
+            grad = torch.randn_like(out)
+            self.assertEqual(torch.autograd.grad(out, (x, w, b), grad),
+                             torch.autograd.grad(expected, (x, w, b), grad))
+
+    def test_batch_norm_add_relu(self, device):
+        def reference(x, y, w, b, m, v, training):
+            return F.relu(F.batch_norm(x, m, v, w, b, training=training) + y)
+
+        for shape, channels_last, training in product([(4, 3, 5, 5), (6, 5, 7), (3, 70, 2, 3)],
+                                                      [False, True], [False, True]):
+            x = torch.randn(shape, device=device, dtype=torch.double)
+            y = torch.randn(shape, device=device, dtype=torch.double)
+            if channels_last:
+                x = x.movedim(1, -1).contiguous().movedim(-1, 1)
+                y = y.movedim(1, -1).contiguous().movedim(-1, 1)
+            x.requires_grad_()
+            y.requires_grad_()
+            c = shape[1]
+            w = torch.randn(c, device=device, dtype=torch.double, requires_grad=True)
+            b = torch.randn(c, device=device, dtype=torch.double, requires_grad=True)
+            m = torch.randn(c, device=device, dtype=torch.double)
+            v = torch.rand(c, device=device, dtype=torch.double) + 0.5
+            m_ref, v_ref = m.clone(), v.clone()
+
+            out = torch.batch_norm_add_relu(x, y, w, b, m, v, training, 0.1, 1e-5)
+            out_ref = reference(x, y, w, b, m_ref, v_ref, training)
+            self.assertEqual(out, out_ref)
+            self.assertEqual(m, m_ref)
+            self.assertEqual(v, v_ref)
+
+            grad = torch.randn(shape, device=device, dtype=torch.double)
+            grads = torch.autograd.grad(out, (x, y, w, b), grad)
+            grads_ref = torch.autograd.grad(out_ref, (x, y, w, b), grad)
+            self.assertEqual(grads, grads_ref)
+
+        x = torch.randn(4, 3, 5, 5, device=device, dtype=torch.double, requires_grad=True)
+        y = torch.randn(4, 3, 5, 5, device=device, dtype=torch.double, requires_grad=True)
+        w = torch.randn(3, device=device, dtype=torch.double, requires_grad=True)
+        b = torch.randn(3, device=device, dtype=torch.double, requires_grad=True)
+        self.assertTrue(gradcheck(lambda x, y, w, b: torch.batch_norm_add_relu(x, y, w, b, None, None, True, 0.1, 1e-5),
+                                  (x, y, w, b)))
+        x = x.detach().to(memory_format=torch.channels_last).requires_grad_()
+        self.assertTrue(gradcheck(lambda x: torch.batch_norm_add_relu(x, None, None, None, None, None, True, 0.1, 1e-5),
+                                  (x,)))
+
+        if self.device_type == 'cuda':
+            # half inputs with float parameters and stats
+            x = torch.randn(8, 16, 4, 4, device=device, dtype=torch.half).to(memory_format=torch.channels_last)
+            y = torch.randn(8, 16, 4, 4, device=device, dtype=torch.half).to(memory_format=torch.channels_last)
+            m = torch.zeros(16, device=device)
+            v = torch.ones(16, device=device)
+            m_ref, v_ref = m.clone(), v.clone()
+            out = torch.batch_norm_add_relu(x, y, None, None, m, v, True, 0.1, 1e-5)
+            self.assertEqual(out, reference(x.float(), y.float(), None, None, m_ref, v_ref, True).half(),
+                             atol=2e-3, rtol=2e-3)
+            self.assertEqual(m, m_ref)
+            self.assertEqual(v, v_ref)
+
     @onlyOnCPUAndCUDA
     def test_GroupNorm_general(self, device):
         self._test_GroupNorm_general(device)
@@ -11824,27 +12003,56 @@ class TestNNDeviceType(NNTestCase):
         tensorTwice = tensorTwice.to(device)
         onesTwice = onesTwice.to(device)
 
+        # The CUDA gradient is coalesced, with a row per unique index
+        def assert_grad(indices, values):
+            grad = embedding.weight.grad
+            expected = torch.sparse_coo_tensor(indices, values, grad.size())
+            if self.device_type == 'cuda':
+                grad, expected = grad.coalesce(), expected.coalesce()
+            self.assertEqual(grad._indices(), expected._indices())
+            # TODO(#38095): Replace assertEqualIgnoreType. See issue #38095
+            self.assertEqualIgnoreType(grad._values(), expected._values())
+
         embedding.zero_grad()
         embedding(tensor[0]).sum().backward()
-        self.assertEqual(embedding.weight.grad._indices(), tensor)
-        # TODO(#38095): Replace assertEqualIgnoreType. See issue #38095
-        self.assertEqualIgnoreType(embedding.weight.grad._values(), ones)
+        assert_grad(tensor, ones)
 
         embedding.zero_grad()
         embedding(tensor[0]).sum().backward()
         embedding(tensor[0]).sum().backward()
-        self.assertEqual(embedding.weight.grad._indices(), tensorTwice)
-        # TODO(#38095): Replace assertEqualIgnoreType. See issue #38095
-        self.assertEqualIgnoreType(embedding.weight.grad._values(), onesTwice)
+        assert_grad(tensorTwice, onesTwice)
 
         embedding.zero_grad()
         embedding(tensor[0]).sum().backward()
         tensor[0, 0] = 8
         embedding(tensor[0]).sum().backward()
         tensorTwice[0, 3] = 8
-        self.assertEqual(embedding.weight.grad._indices(), tensorTwice)
-        # TODO(#38095): Replace assertEqualIgnoreType. See issue #38095
-        self.assertEqualIgnoreType(embedding.weight.grad._values(), onesTwice)
+        assert_grad(tensorTwice, onesTwice)
+
+    @onlyCUDA
+    @dtypes(torch.float16, torch.float32, torch.float64)
+    def test_embedding_sparse_backward_coalesced(self, device, dtype):
+        indices = torch.randint(0, 50, (7, 300), device=device)
+        indices[0, :20] = 3
+        grad = torch.randn(7, 300, 5, device=device, dtype=dtype)
+        expected = torch.zeros(1000, 5, device=device, dtype=torch.double)
+        expected.index_add_(0, indices.view(-1), grad.view(-1, 5).double())
+        for padding_idx in (-1, 3):
+            if padding_idx >= 0:
+                expected[padding_idx] = 0
+            rows = indices.unique()
+            rows = rows[rows != padding_idx]
+            for deterministic in (False, True):
+                with DeterministicGuard(deterministic):
+                    out = torch.embedding_backward(grad, indices, 1000, padding_idx, False, True)
+                self.assertTrue(out.is_coalesced())
+                self.assertEqual(out._indices()[0], rows)
+                self.assertEqual(out.to_dense(), expected.to(dtype), atol=1e-2 if dtype == torch.half else None,
+                                 rtol=1e-2 if dtype == torch.half else None)
+            with DeterministicGuard(True):
+                first = torch.embedding_backward(grad, indices, 1000, padding_idx, False, True)
+                self.assertEqual(first._values(), torch.embedding_backward(grad, indices, 1000, padding_idx, False, True)._values(),
+                                 atol=0, rtol=0)
 
     @dtypesIfCUDA(*ALL_TENSORTYPES2)
     @dtypes(torch.float32)
@@ -11974,6 +12182,85 @@ class TestNNDeviceType(NNTestCase):
         input_large = torch.randn(1, 1, 2048, 1024 , dtype=dtype, device=device)
         conv2(input_large)
 
+    @onlyCPU
+    def test_conv2d_cpu_inference_kernels(self, device):
+        # Winograd F(2x2, 3x3) and F(4x4, 3x3), and the direct NHWC convolution,
+        # that are used for float inference
+        for (n, c, h, w), (k, kh, kw), stride, padding, dilation, bias, channels_last in [
+                ((2, 16, 9, 11), (19, 3, 3), 1, 1, 1, True, False),
+                ((1, 17, 6, 7), (16, 3, 3), 1, 0, 1, False, True),
+                ((2, 16, 20, 23), (21, 3, 3), 1, 1, 1, True, False),
+                ((1, 64, 17, 18), (32, 3, 3), 1, 2, 1, False, True),
+                ((2, 3, 15, 17), (21, 7, 7), 2, 3, 1, True, False),
+                ((1, 5, 12, 13), (8, 3, 5), 1, 2, 2, False, False),
+                ((2, 16, 9, 9), (33, 1, 1), 1, 0, 1, True, True)]:
+            x = torch.randn(n, c, h, w, device=device)
+            weight = torch.randn(k, c, kh, kw, device=device)
+            b = torch.randn(k, device=device) if bias else None
+            if channels_last:
+                x = x.contiguous(memory_format=torch.channels_last)
+            expected = F.conv2d(x.double(), weight.double(), b.double() if bias else None,
+                                stride, padding, dilation)
+            actual = F.conv2d(x, weight, b, stride, padding, dilation)
+            self.assertEqual(actual, expected, atol=5e-4, rtol=1e-4, exact_dtype=False)
+            memory_format = torch.channels_last if channels_last else torch.contiguous_format
+            self.assertTrue(actual.is_contiguous(memory_format=memory_format))
+
+    @onlyCPU
+    def test_thnn_conv2d_blocked_inference(self, device):
+        # without autograd, the output is computed by tiles of rows instead of
+        # through the im2col of the whole batch
+        for (n, c, h, w), (k, kh, kw), stride, padding, bias in [
+                ((3, 16, 64, 64), (8, 3, 3), (1, 1), (1, 1), True),
+                ((2, 7, 33, 70), (5, 5, 3), (2, 1), (2, 0), False),
+                ((1, 40, 9, 300), (6, 3, 3), (1, 3), (0, 1), True),
+                ((0, 4, 8, 8), (3, 3, 3), (1, 1), (1, 1), True)]:
+            x = torch.randn(n, c, h, w, device=device, requires_grad=True)
+            weight = torch.randn(k, c, kh, kw, device=device, requires_grad=True)
+            b = torch.randn(k, device=device, requires_grad=True) if bias else None
+            expected = torch._C._nn.thnn_conv2d(x, weight, (kh, kw), b, stride, padding)
+            with torch.no_grad():
+                actual = torch._C._nn.thnn_conv2d(x, weight, (kh, kw), b, stride, padding)
+            self.assertEqual(actual, expected)
+            expected_double = F.conv2d(x.double(), weight.double(), b.double() if bias else None, stride, padding)
+            self.assertEqual(actual, expected_double, atol=5e-4, rtol=1e-4, exact_dtype=False)
+
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_conv2d_depthwise_cpu(self, device, dtype):
+        # the direct depthwise kernels, against the convolutions of each channel
+        for (n, c, h, w), (multiplier, kh, kw), stride, padding, dilation, channels_last in [
+                ((2, 8, 9, 11), (1, 3, 3), 1, 1, 1, False),
+                ((1, 11, 12, 10), (2, 5, 5), 2, 2, 1, True),
+                ((2, 5, 13, 14), (1, 7, 7), 1, 3, 2, False),
+                ((1, 9, 8, 9), (3, 3, 1), (2, 1), (1, 0), (1, 2), True),
+                ((0, 4, 6, 6), (1, 3, 3), 1, 1, 1, False),
+                ((2, 3, 10, 7), (2, 4, 2), 3, 1, (2, 3), False)]:
+            x = torch.randn(n, c, h, w, device=device, dtype=dtype)
+            weight = torch.randn(c * multiplier, 1, kh, kw, device=device, dtype=dtype)
+            bias = torch.randn(c * multiplier, device=device, dtype=dtype)
+            if channels_last:
+                x = x.contiguous(memory_format=torch.channels_last)
+            x.requires_grad_()
+            weight.requires_grad_()
+            bias.requires_grad_()
+            actual = F.conv2d(x, weight, bias, stride, padding, dilation, groups=c)
+            expected = torch.cat([F.conv2d(x[:, i // multiplier:i // multiplier + 1], weight[i:i + 1], bias[i:i + 1],
+                                           stride, padding, dilation) for i in range(c * multiplier)], 1)
+            self.assertEqual(actual, expected, atol=1e-4, rtol=1e-4)
+            memory_format = torch.channels_last if channels_last else torch.contiguous_format
+            self.assertTrue(actual.is_contiguous(memory_format=memory_format))
+
+            grad = torch.randn_like(expected)
+            grads = torch.autograd.grad(actual, (x, weight, bias), grad)
+            expected_grads = torch.autograd.grad(expected, (x, weight, bias), grad)
+            self.assertEqual(grads, expected_grads, atol=1e-4, rtol=1e-4)
+
+        x = torch.randn(2, 4, 7, 6, device=device, dtype=torch.double, requires_grad=True)
+        weight = torch.randn(8, 1, 3, 3, device=device, dtype=torch.double, requires_grad=True)
+        self.assertTrue(gradcheck(lambda x, weight: F.conv2d(x, weight, None, 2, 1, (1, 2), groups=4), (x, weight)))
+        self.assertTrue(gradgradcheck(lambda x, weight: F.conv2d(x, weight, None, 2, 1, (1, 2), groups=4), (x, weight)))
+
     def test_conv_noncontig_weights(self, device):
         for dim in (1, 2, 3):
             for grouped in (False, True):
@@ -12331,6 +12618,105 @@ class TestNNDeviceType(NNTestCase):
         out_ref = m(inp_ref)
         self.assertEqual(out_ref, out)
 
+    @onlyCUDA
+    @dtypes(torch.float, torch.half, torch.bfloat16)
+    def test_upsampling2d_channels_last(self, device, dtype):
+        tol = dict(atol=1e-5, rtol=1e-5) if dtype == torch.float else dict(atol=1e-2, rtol=1e-2)
+        for mode, align_corners in (('nearest', None), ('bilinear', True), ('bilinear', False)):
+            # 8, 6 and 3 channels load 4, 2 and 1 channels at once
+            for size, channels in (((11, 9), 8), ((3, 4), 6), ((5, 13), 3), ((5, 6), 8)):
+                x = torch.randn(2, channels, 5, 6, device=device, dtype=dtype)
+                x_cl = x.contiguous(memory_format=torch.channels_last).requires_grad_()
+                x_ref = x.double().requires_grad_()
+                out = F.interpolate(x_cl, size=size, mode=mode, align_corners=align_corners)
+                out_ref = F.interpolate(x_ref, size=size, mode=mode, align_corners=align_corners)
+                self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+                self.assertEqual(out, out_ref.to(dtype), **tol)
+
+                grad = torch.randn(out.shape, device=device, dtype=torch.double)
+                out.backward(grad.to(dtype).contiguous(memory_format=torch.channels_last))
+                out_ref.backward(grad.to(dtype).double())
+                self.assertTrue(x_cl.grad.is_contiguous(memory_format=torch.channels_last))
+                self.assertEqual(x_cl.grad, x_ref.grad.to(dtype), **tol)
+
+    @onlyCPU
+    @dtypes(torch.float, torch.double, torch.bfloat16)
+    def test_pooling2d_channels_last(self, device, dtype):
+        tol = dict(atol=1e-5, rtol=1e-5) if dtype != torch.bfloat16 else dict(atol=1e-2, rtol=1e-2)
+        pools = (
+            lambda x: F.max_pool2d(x, 3, 2, padding=1),
+            lambda x: F.max_pool2d(x, (2, 3), 1, dilation=(2, 1), ceil_mode=True),
+            lambda x: F.avg_pool2d(x, 3, 2, padding=1),
+            lambda x: F.avg_pool2d(x, (2, 3), 1, padding=1, count_include_pad=False, ceil_mode=True),
+            lambda x: F.avg_pool2d(x, 2, divisor_override=3),
+            lambda x: F.adaptive_avg_pool2d(x, (3, 4)),
+        )
+        # more channels than a block of the backward kernels, and fewer than a vector
+        for channels in (3, 67):
+            for pool in pools:
+                x = torch.randn(2, channels, 7, 9, device=device).to(dtype)
+                x_cl = x.contiguous(memory_format=torch.channels_last).requires_grad_()
+                x_ref = x.double().requires_grad_()
+                out = pool(x_cl)
+                out_ref = pool(x_ref)
+                self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+                self.assertEqual(out, out_ref.to(dtype), **tol)
+
+                grad = torch.randn(out.shape, device=device).to(dtype)
+                out.backward(grad.contiguous(memory_format=torch.channels_last))
+                out_ref.backward(grad.double())
+                self.assertTrue(x_cl.grad.is_contiguous(memory_format=torch.channels_last))
+                self.assertEqual(x_cl.grad, x_ref.grad.to(dtype), **tol)
+
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_grid_sample_channels_last(self, device, dtype):
+        modes = ('bilinear', 'nearest', 'bicubic')
+        # the backward threads split the output pixels of a single image, and
+        # the images when there are as many as threads
+        for dim, nbatch, mode, padding_mode, align_corners in product(
+                (2, 3), (1, 16), modes, ('zeros', 'border', 'reflection'), (True, False)):
+            if dim == 3 and mode == 'bicubic':
+                continue
+            memory_format = torch.channels_last if dim == 2 else torch.channels_last_3d
+            x = torch.randn(nbatch, 11, *((4, 5, 6)[-dim:]), device=device, dtype=dtype)
+            grid = torch.rand(nbatch, *((3, 4, 7)[-dim:]), dim, device=device, dtype=dtype) * 2.4 - 1.2
+            x_cl = x.contiguous(memory_format=memory_format).requires_grad_()
+            x_ref = x.clone().requires_grad_()
+            grid_cl = grid.clone().requires_grad_()
+            grid_ref = grid.clone().requires_grad_()
+            out = F.grid_sample(x_cl, grid_cl, mode=mode, padding_mode=padding_mode, align_corners=align_corners)
+            out_ref = F.grid_sample(x_ref, grid_ref, mode=mode, padding_mode=padding_mode, align_corners=align_corners)
+            self.assertTrue(out.is_contiguous(memory_format=memory_format))
+            self.assertEqual(out, out_ref)
+
+            grad = torch.randn_like(out_ref)
+            out.backward(grad.contiguous(memory_format=memory_format))
+            out_ref.backward(grad)
+            self.assertTrue(x_cl.grad.is_contiguous(memory_format=memory_format))
+            self.assertEqual(x_cl.grad, x_ref.grad)
+            self.assertEqual(grid_cl.grad, grid_ref.grad)
+
+            theta = torch.randn(nbatch, dim, dim + 1, device=device, dtype=dtype) * 0.5
+            size = [nbatch, 11, *((3, 4, 7)[-dim:])]
+            expected = F.grid_sample(x, F.affine_grid(theta, size, align_corners=align_corners),
+                                     mode=mode, padding_mode=padding_mode, align_corners=align_corners)
+            out = F.affine_grid_sample(x_cl.detach(), theta, size, mode=mode,
+                                       padding_mode=padding_mode, align_corners=align_corners)
+            self.assertTrue(out.is_contiguous(memory_format=memory_format))
+            # a location computed differently may round to another pixel
+            if mode != 'nearest':
+                self.assertEqual(out, expected)
+
+        # the grid is materialized for inputs which require grad
+        x = torch.randn(2, 3, 5, 6, device=device, dtype=dtype).contiguous(memory_format=torch.channels_last)
+        theta = torch.randn(2, 2, 3, device=device, dtype=dtype, requires_grad=True)
+        out = F.affine_grid_sample(x, theta, [2, 3, 4, 4], align_corners=False)
+        out.sum().backward()
+        theta_ref = theta.detach().requires_grad_()
+        F.grid_sample(x, F.affine_grid(theta_ref, [2, 3, 4, 4], align_corners=False), align_corners=False).sum().backward()
+        self.assertEqual(theta.grad, theta_ref.grad)
+
     @unittest.expectedFailure
     @skipIfRocm
     @onlyCUDA
@@ -13054,6 +13440,61 @@ class TestNNDeviceType(NNTestCase):
             )
         self.assertEqual(output_non_contig, output_contig)
 
+    @onlyCPU
+    @dtypes(*itertools.product((torch.int, torch.long), (torch.float, torch.half, torch.bfloat16)))
+    def test_embedding_bag_sum_mean_kernel(self, device, dtypes):
+        # dims with a specialized kernel and not, and bags long enough to prefetch
+        for num_features, mode, weighted in itertools.product((64, 7), ('sum', 'mean'), (False, True)):
+            if mode == 'mean' and weighted:
+                continue
+            weight = torch.randn(100, num_features, device=device).to(dtypes[1])
+            input = torch.randint(100, (300,), device=device, dtype=dtypes[0])
+            offsets = torch.tensor([0, 0, 1, 40, 40, 200], device=device, dtype=dtypes[0])
+            per_sample_weights = None
+            ref_per_sample_weights = None
+            if weighted:
+                per_sample_weights = torch.randn(300, device=device).to(dtypes[1])
+                ref_per_sample_weights = per_sample_weights.float()
+            expected = self._embedding_bag_reference_impl(
+                input, weight.float(), offsets, mode, ref_per_sample_weights)
+            result = F.embedding_bag(input, weight, offsets, mode=mode,
+                                     per_sample_weights=per_sample_weights)
+            self.assertEqual(result.dtype, dtypes[1])
+            self.assertEqual(result.float(), expected, atol=dtype2prec_DONTUSE[dtypes[1]] * 10, rtol=0)
+
+
+    @dtypesIfCUDA(*itertools.product((torch.int, torch.long), (torch.float, torch.double, torch.half)))
+    @dtypes(*itertools.product((torch.int, torch.long), (torch.float, torch.double)))
+    def test_embedding_bag_multi(self, device, dtypes):
+        num_features = (3, 16, 64, 5)
+        num_weights = (10, 20, 1, 7)
+        offsets = ([0, 2, 2, 5], [0], [0, 0], [0, 1, 3])
+        for mode, sparse, include_last_offset in itertools.product(('sum', 'mean'), (False, True), (False, True)):
+            weights = [torch.randn(n, d, device=device, dtype=dtypes[1], requires_grad=True)
+                       for n, d in zip(num_weights, num_features)]
+            indices = [torch.randint(n, (6,), device=device, dtype=dtypes[0]) for n in num_weights]
+            table_offsets = [torch.tensor(o + [6] if include_last_offset else o, device=device, dtype=dtypes[0])
+                             for o in offsets]
+            mode_int = 0 if mode == 'sum' else 1
+            results = torch._embedding_bag_multi(weights, indices, table_offsets, mode_int, sparse, include_last_offset)
+
+            ref_weights = [w.detach().clone().requires_grad_() for w in weights]
+            expected = [F.embedding_bag(i, w, o, mode=mode, sparse=sparse, include_last_offset=include_last_offset)
+                        for w, i, o in zip(ref_weights, indices, table_offsets)]
+            self.assertEqual(len(results), len(expected))
+            for result, ref in zip(results, expected):
+                self.assertEqual(result, ref, atol=dtype2prec_DONTUSE[dtypes[1]], rtol=0)
+
+            # the output of the last table is unused
+            grads = [torch.randn_like(r) for r in results[:-1]]
+            torch.autograd.backward(results[:-1], grads)
+            torch.autograd.backward(expected[:-1], grads)
+            for w, ref_w in zip(weights, ref_weights):
+                if ref_w.grad is None:
+                    self.assertEqual(w.grad.to_dense(), torch.zeros_like(w))
+                    continue
+                self.assertEqual(w.grad.is_sparse, sparse)
+                self.assertEqual(w.grad.to_dense(), ref_w.grad.to_dense(), atol=dtype2prec_DONTUSE[dtypes[1]], rtol=0)
 
     @onlyCUDA
     @dtypes(torch.int, torch.long)
@@ -13077,6 +13518,74 @@ class TestNNDeviceType(NNTestCase):
         self.assertEqual(q.size(), out[0].size())
         self.assertEqual(dtype, out[0].dtype)
 
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    @dtypes(torch.float, torch.double)
+    def test_scaled_dot_product_attention(self, device, dtype):
+        def reference(q, k, v, mask, is_causal, scale):
+            scores = q.double() @ k.double().transpose(-2, -1) * scale
+            if mask is not None:
+                if mask.dtype == torch.bool:
+                    scores = scores.masked_fill(mask, float('-inf'))
+                else:
+                    scores = scores + mask.double()
+            if is_causal:
+                causal = torch.ones(scores.size(-2), scores.size(-1), dtype=torch.bool, device=device).triu(1)
+                scores = scores.masked_fill(causal, float('-inf'))
+            return scores.softmax(-1) @ v.double(), scores.logsumexp(-1)
+
+        tol = {torch.half: 2e-2, torch.float: 2e-4, torch.double: 1e-7}[dtype]
+        # the last head dimension is too large for the fused CUDA kernels
+        sizes = [(2, 3, 37, 45, 16, 24), (1, 2, 70, 70, 64, 64), (2, 1, 5, 9, 160, 8)]
+        for (B, H, L, S, E, Ev), mask_type, is_causal in product(sizes, [None, 'bool', 'float'], [False, True]):
+            q = torch.randn(B, H, L, E, device=device, dtype=dtype, requires_grad=True)
+            k = torch.randn(B, H, S, E, device=device, dtype=dtype, requires_grad=True)
+            v = torch.randn(B, H, S, Ev, device=device, dtype=dtype, requires_grad=True)
+            mask = None
+            if mask_type == 'bool':
+                mask = torch.rand(L, S, device=device) < 0.3
+                # every query attends to the first key
+                mask[:, 0] = False
+            elif mask_type == 'float':
+                mask = torch.randn(B, 1, L, S, device=device, dtype=dtype)
+
+            out, lse = torch._scaled_dot_product_attention(q, k, v, mask, is_causal)
+            expected_out, expected_lse = reference(q, k, v, mask, is_causal, E ** -0.5)
+            self.assertEqual(out, expected_out.to(dtype), atol=tol, rtol=tol)
+            self.assertEqual(lse, expected_lse.to(lse.dtype), atol=tol, rtol=tol)
+
+            grad = torch.randn_like(out)
+            grads = torch.autograd.grad(out, (q, k, v), grad)
+            expected_grads = torch.autograd.grad(expected_out, (q, k, v), grad.double())
+            for actual, expected in zip(grads, expected_grads):
+                self.assertEqual(actual, expected.to(dtype), atol=tol, rtol=tol)
+
+        # 3-d inputs and an explicit scale
+        q = torch.randn(4, 11, 8, device=device, dtype=dtype)
+        k = torch.randn(4, 13, 8, device=device, dtype=dtype)
+        v = torch.randn(4, 13, 8, device=device, dtype=dtype)
+        out, lse = torch._scaled_dot_product_attention(q, k, v, scale=0.5)
+        self.assertEqual(lse.size(), (4, 11))
+        self.assertEqual(out, reference(q, k, v, None, False, 0.5)[0].to(dtype), atol=tol, rtol=tol)
+
+    @dtypes(torch.float, torch.double)
+    def test_multihead_attention_fused(self, device, dtype):
+        # without the weights, the output comes from _scaled_dot_product_attention
+        embed_dim, num_heads, bsz, tgt_len, src_len = 32, 4, 3, 7, 9
+        model = nn.MultiheadAttention(embed_dim, num_heads).to(device, dtype)
+        query = torch.randn(tgt_len, bsz, embed_dim, device=device, dtype=dtype)
+        key = torch.randn(src_len, bsz, embed_dim, device=device, dtype=dtype)
+        bool_mask = torch.rand(tgt_len, src_len, device=device) < 0.3
+        bool_mask[:, 0] = False
+        float_mask = torch.randn(tgt_len, src_len, device=device, dtype=dtype)
+        key_padding_mask = torch.zeros(bsz, src_len, dtype=torch.bool, device=device)
+        key_padding_mask[:, -2:] = True
+        for attn_mask, padding_mask in product([None, bool_mask, float_mask], [None, key_padding_mask]):
+            expected, _ = model(query, key, key, key_padding_mask=padding_mask, attn_mask=attn_mask)
+            actual, weights = model(query, key, key, key_padding_mask=padding_mask, attn_mask=attn_mask,
+                                    need_weights=False)
+            self.assertIsNone(weights)
+            self.assertEqual(actual, expected)
+
     @dtypesIfCUDA(*get_all_fp_dtypes(include_bfloat16=AMPERE_OR_ROCM))
     @dtypes(torch.float)
     def test_Conv2d_naive_groups(self, device, dtype):
@@ -13860,6 +14369,77 @@ class TestNNDeviceType(NNTestCase):
         helper([2, 3, 5, 7])
         helper([2, 3, 5, 7, 9])
 
+    @dtypes(torch.float, torch.double)
+    def test_log_softmax_nll_loss(self, device, dtype):
+        for num_classes in [5, 33, 5000]:
+            input = torch.randn(7, num_classes, device=device, dtype=dtype, requires_grad=True)
+            target = torch.randint(num_classes, (7,), device=device)
+            target[2] = -100
+            weight = torch.rand(num_classes, device=device, dtype=dtype)
+            for (reduction_enum, reduction), w in product(enumerate(['none', 'mean', 'sum']), [None, weight]):
+                out = torch._C._nn.log_softmax_nll_loss(input, target, w, reduction_enum, -100)
+                expected = F.nll_loss(F.log_softmax(input, 1), target, w, reduction=reduction)
+                self.assertEqual(out, expected)
+                grad_output = torch.rand_like(out)
+                grad, = torch.autograd.grad(out, input, grad_output)
+                expected_grad, = torch.autograd.grad(expected, input, grad_output)
+                self.assertEqual(grad, expected_grad)
+
+        input = torch.randn(4, 6, device=device, dtype=torch.double, requires_grad=True)
+        target = torch.tensor([0, 5, -100, 2], device=device)
+        weight = torch.rand(6, device=device, dtype=torch.double)
+        for reduction in range(3):
+            fn = lambda i: torch._C._nn.log_softmax_nll_loss(i, target, weight, reduction, -100)
+            self.assertTrue(gradcheck(fn, (input,)))
+            self.assertTrue(gradgradcheck(fn, (input,)))
+
+        with self.assertRaisesRegex(IndexError, 'out of bounds'):
+            torch._C._nn.log_softmax_nll_loss(input, torch.tensor([0, 6, 1, 2], device=device))
+
+    def test_log_softmax_ctc_loss(self, device):
+        # targets of very different lengths, with repeated labels and an empty one
+        target_lengths = [30, 0, 3, 12, 1]
+        input_lengths = [50, 20, 7, 40, 50]
+        targets = torch.randint(1, 5, (sum(target_lengths),), dtype=torch.long, device=device)
+        targets[:4] = 2
+        logits = torch.randn(50, 5, 6, dtype=torch.double, device=device, requires_grad=True)
+        for (reduction_enum, reduction), zero_infinity in product(enumerate(['none', 'mean', 'sum']), [False, True]):
+            out = torch._C._nn.log_softmax_ctc_loss(logits, targets, input_lengths, target_lengths, 0,
+                                                    reduction_enum, zero_infinity)
+            expected = F.ctc_loss(F.log_softmax(logits, 2), targets, input_lengths, target_lengths,
+                                  reduction=reduction, zero_infinity=zero_infinity)
+            self.assertEqual(out, expected)
+            grad_output = torch.rand_like(out)
+            grad, = torch.autograd.grad(out, logits, grad_output)
+            expected_grad, = torch.autograd.grad(expected, logits, grad_output)
+            self.assertEqual(grad, expected_grad)
+
+        # an input too short for its target has an infinite loss
+        input_lengths = [50, 20, 7, 5, 50]
+        out = torch._C._nn.log_softmax_ctc_loss(logits, targets, input_lengths, target_lengths, 0, 0, True)
+        self.assertEqual(out[3], 0)
+        grad, = torch.autograd.grad(out.sum(), logits)
+        self.assertEqual(grad[:, 3], torch.zeros_like(grad[:, 3]))
+
+        logits = torch.randn(12, 3, 5, dtype=torch.double, device=device, requires_grad=True)
+        targets = torch.tensor([[1, 2, 2, 3], [4, 1, 0, 0], [3, 3, 3, 0]], device=device)
+        fn = lambda x: torch._C._nn.log_softmax_ctc_loss(x, targets, [12, 9, 10], [4, 2, 3], 0, 0, False)
+        self.assertTrue(gradcheck(fn, (logits,)))
+
+    @dtypes(torch.float, torch.double)
+    def test_softmax_long_rows(self, device, dtype):
+        # rows that are masked out at the start, in the middle or entirely
+        input = torch.randn(4, 20000, device=device, dtype=dtype) * 10
+        input[0, :15000] = float('-inf')
+        input[1, 5000:10000] = float('-inf')
+        input[2, -1] = 100
+        input[3] = float('-inf')
+        log_prob = input[:3].double() - input[:3].double().logsumexp(1, keepdim=True)
+        for fn, expected in [(F.softmax, log_prob.exp()), (F.log_softmax, log_prob)]:
+            out = fn(input, 1)
+            self.assertEqual(out[:3], expected.to(dtype))
+            self.assertTrue(out[3].isnan().all())
+
     def test_softshrink_negative(self, device):
         input = torch.randn(5, device=device, requires_grad=True)
         m = torch.nn.Softshrink(-1)
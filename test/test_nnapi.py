@@ -0,0 +1,153 @@
+import struct
+
+import torch
+from torch.backends._nnapi.partition import (
+    _Subgraph,
+    _find_runs,
+    _probe,
+    _serialize,
+    partition_model_for_nnapi,
+)
+from torch.backends._nnapi.serializer import _NnapiSerializer, serialize_model
+from torch.testing._internal.common_utils import TestCase, run_tests
+
+FileCheck = torch._C.FileCheck
+
+
+class Supported(torch.nn.Module):
+    def forward(self, x):
+        return torch.sigmoid(torch.relu(x))
+
+
+class Mixed(torch.nn.Module):
+    def forward(self, x):
+        y = torch.sigmoid(torch.relu(x))
+        # aten::log is not supported by the serializer
+        z = torch.log(y)
+        return torch.relu(z) * z
+
+
+class Rejected(torch.nn.Module):
+    def forward(self, x):
+        # The serializer supports aten::add, but not with a scalar operand
+        y = torch.relu(x) + 1.0
+        return torch.sigmoid(torch.relu(y))
+
+
+def _kinds(nodes):
+    return [node.kind() for node in nodes]
+
+
+def _computed_kinds(graph):
+    """The kinds of the nodes of graph other than constants and lists."""
+    return [
+        kind for kind in _kinds(graph.nodes())
+        if kind.startswith("aten::") or kind == "prim::CallMethod"]
+
+
+def _frozen(module):
+    return torch.jit.freeze(torch.jit.script(module).eval())
+
+
+class TestNnapiPartition(TestCase):
+    def setUp(self):
+        super().setUp()
+        self.inputs = [torch.rand(1, 2, 3, 4)]
+
+    def _probe_runs(self, model, runs):
+        values = list(model.graph.inputs())[1:]
+        for run in runs:
+            for node in run:
+                values.extend(node.outputs())
+                values.extend(
+                    v for v in node.inputs()
+                    if v not in values and v.type().kind() == "TensorType")
+        return _probe(model, values, self.inputs)
+
+    def test_find_runs(self):
+        model = _frozen(Mixed())
+        runs = _find_runs(model.graph)
+        self.assertEqual(
+            [_kinds(run) for run in runs],
+            [["aten::relu", "aten::sigmoid"], ["aten::relu", "aten::mul"]])
+
+        positions = {node: idx for idx, node in enumerate(model.graph.nodes())}
+        first = _Subgraph(runs[0], positions)
+        x = list(model.graph.inputs())[1]
+        self.assertEqual(first.input_values, [x])
+        self.assertEqual(first.output_values, [runs[0][-1].output()])
+
+        # The output of the unsupported log is used twice by the second run
+        second = _Subgraph(runs[1], positions)
+        self.assertEqual(_kinds(v.node() for v in second.input_values), ["aten::log"])
+        self.assertEqual(second.output_values, [runs[1][-1].output()])
+
+    def test_split_around_rejected_node(self):
+        model = _frozen(Rejected())
+        runs = _find_runs(model.graph)
+        self.assertEqual(
+            [_kinds(run) for run in runs],
+            [["aten::relu", "aten::add", "aten::relu", "aten::sigmoid"]])
+
+        positions = {node: idx for idx, node in enumerate(model.graph.nodes())}
+        tensors = self._probe_runs(model, runs)
+        result, failed = _serialize(model, _Subgraph(runs[0], positions), tensors)
+        self.assertIsNone(result)
+        self.assertEqual(failed, 1)
+
+        # The single relu before the add is too short to be partitioned
+        partitioned = partition_model_for_nnapi(Rejected(), self.inputs)
+        self.assertEqual(
+            _computed_kinds(partitioned.graph), ["aten::relu", "aten::add", "prim::CallMethod"])
+
+        partitioned = partition_model_for_nnapi(Rejected(), self.inputs, min_nodes=1)
+        self.assertEqual(
+            _computed_kinds(partitioned.graph),
+            ["prim::CallMethod", "aten::add", "prim::CallMethod"])
+
+    def test_replace(self):
+        partitioned = partition_model_for_nnapi(Mixed(), self.inputs)
+        self.assertEqual(
+            _computed_kinds(partitioned.graph),
+            ["prim::CallMethod", "aten::log", "prim::CallMethod"])
+        # The outputs of the first partition are unpacked into the log
+        FileCheck().check("prim::CallMethod").check("prim::ListUnpack").check("aten::log") \
+            .check("prim::ListConstruct").check("prim::CallMethod").run(str(partitioned.graph))
+
+        expected = Mixed()(*self.inputs)
+        for name in ("_nnapi_partition_0", "_nnapi_partition_1"):
+            nnapi_module = getattr(partitioned, name).nnapi_module
+            self.assertEqual(nnapi_module.inp_mem_fmts, [0])
+            self.assertEqual(nnapi_module.out_mem_fmts, [0])
+            self.assertEqual(nnapi_module.out_templates[0].shape, expected.shape)
+
+    def test_serialize_model_round_trip(self):
+        model = _frozen(Supported())
+        expected = serialize_model(model, self.inputs)
+
+        # serialize_model is add_model_inputs, add_node and serialize_outputs
+        serializer = _NnapiSerializer(None)
+        inp_dim_orders = serializer.add_model_inputs(
+            model, list(model.graph.inputs())[1:], self.inputs)
+        for node in model.graph.nodes():
+            serializer.add_node(node)
+        output_values = [model.graph.return_node().inputsAt(0)]
+        self.assertEqual(serializer.serialize_outputs(output_values, inp_dim_orders), expected)
+
+        # A partition of the whole graph is serialized like it
+        positions = {node: idx for idx, node in enumerate(model.graph.nodes())}
+        runs = _find_runs(model.graph)
+        self.assertEqual(len(runs), 1)
+        result, failed = _serialize(
+            model, _Subgraph(runs[0], positions), self._probe_runs(model, runs))
+        self.assertIsNone(failed)
+        self.assertEqual(result[0], expected[0])
+        self.assertEqual(result[2:], expected[2:])
+
+        version, _, _, num_operations, num_inputs, num_outputs = struct.unpack(
+            "iiiiii", expected[0][:24])
+        self.assertEqual((version, num_operations, num_inputs, num_outputs), (1, 2, 1, 1))
+
+
+if __name__ == "__main__":
+    run_tests()
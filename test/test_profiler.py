@@ -2,6 +2,7 @@ import collections
 import gc
 import io
 import os
+import time
 import unittest
 
 import torch
@@ -399,6 +400,45 @@ class TestProfiler(TestCase):
             sort_by="self_cuda_time_total", row_limit=-1)
         self.assertIn("FLOPS", profiler_output)
 
+    def test_flops_and_bytes(self):
+        x = torch.randn(8, 16)
+        w = torch.randn(16, 4)
+        with _profile(with_flops=True, use_kineto=kineto_available()) as prof:
+            torch.mm(x, w)
+        mm_events = [evt for evt in prof.function_events if evt.name == "aten::mm"]
+        self.assertEqual(len(mm_events), 1)
+        self.assertEqual(mm_events[0].flops, 2 * 8 * 16 * 4)
+        self.assertEqual(mm_events[0].bytes_read, (8 * 16 + 16 * 4) * 4)
+        self.assertEqual(mm_events[0].bytes_written, 8 * 4 * 4)
+        self.assertIn("B/s", prof.key_averages().table(sort_by="cpu_time_total"))
+
+    def test_sampling_profile(self):
+        x = torch.randn(64, 64)
+
+        def sampled_fn():
+            for _ in range(100):
+                torch.mm(x, x)
+
+        def sampled(stacks):
+            return any("sampled_fn" in stack and stack.endswith(";aten::mm")
+                       for stack, _ in stacks)
+
+        # Runs until some samples land in sampled_fn, since the sampler may be
+        # delayed on a loaded machine
+        with torch.autograd.profiler.sampling_profile(frequency_hz=1000) as prof:
+            deadline = time.time() + 30
+            while not sampled(torch.autograd._sampled_stacks()) and time.time() < deadline:
+                sampled_fn()
+        self.assertFalse(torch.autograd._sampling_profiler_enabled())
+        self.assertGreater(prof.num_samples, 0)
+        self.assertTrue(sampled(prof.stacks))
+
+        lines = prof.folded_stacks().splitlines()
+        self.assertEqual(len(lines), len(prof.stacks))
+        for line in lines:
+            stack, count = line.rsplit(" ", 1)
+            self.assertGreater(int(count), 0)
+
     @unittest.skipIf(not kineto_available(), "Kineto is required")
     @unittest.skipIf(not torch.cuda.is_available(), "CUDA is required")
     def test_kineto_profiler_api(self):
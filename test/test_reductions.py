@@ -11,7 +11,7 @@ from itertools import product, combinations, permutations
 from torch._six import inf, nan, istuple
 from torch.testing._internal.common_utils import (
     TestCase, run_tests, TEST_SCIPY, slowTest, torch_to_numpy_dtype_dict,
-    IS_WINDOWS)
+    IS_WINDOWS, gradcheck)
 from torch.testing._internal.common_device_type import (
     instantiate_device_type_tests, onlyCPU, dtypes, dtypesIfCUDA, dtypesIfCPU,
     onlyOnCPUAndCUDA, onlyCUDA, expectedAlertNondeterministic, largeTensorTest)
@@ -610,6 +610,50 @@ class TestReductions(TestCase):
         self._test_minmax_helper(_amin_wrapper, np.amin, device, dtype)
         self._test_minmax_helper(_amax_wrapper, np.amax, device, dtype)
 
+    @onlyOnCPUAndCUDA
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    @dtypes(torch.float, torch.double)
+    def test_aminmax_var_mean(self, device, dtype):
+        x = torch.randn(10, 30, 40, device=device, dtype=dtype)
+        x[1, 2, 3] = float('nan')
+        for dim in [None, 0, 1, 2, (0, 2), (1, 2)]:
+            for unbiased in [False, True]:
+                for keepdim in [False, True]:
+                    if dim is None:
+                        if keepdim:
+                            continue
+                        res = torch.aminmax_var_mean(x, unbiased=unbiased)
+                        var, mean = torch.var_mean(x, unbiased=unbiased)
+                        expected = (torch.amin(x), torch.amax(x), var, mean)
+                    else:
+                        res = torch.aminmax_var_mean(x, dim, unbiased=unbiased, keepdim=keepdim)
+                        var, mean = torch.var_mean(x, dim, unbiased=unbiased, keepdim=keepdim)
+                        expected = (torch.amin(x, dim, keepdim), torch.amax(x, dim, keepdim), var, mean)
+                    self.assertEqual(res, expected, atol=1e-2 if dtype == torch.half else None, rtol=0)
+                    self.assertEqual(res.min, expected[0], atol=0, rtol=0)
+                    self.assertEqual(res.max, expected[1], atol=0, rtol=0)
+
+        # the unbiased variance of a single element is nan
+        res = torch.aminmax_var_mean(torch.tensor([2.], device=device, dtype=dtype))
+        self.assertEqual(res, (2., 2., float('nan'), 2.), exact_dtype=False)
+
+        out = tuple(torch.empty(0, device=device, dtype=dtype) for _ in range(4))
+        torch.aminmax_var_mean(x, 1, out=out)
+        self.assertEqual(out, torch.aminmax_var_mean(x, 1))
+
+        with self.assertRaisesRegex(RuntimeError, 'operation does not have an identity'):
+            torch.aminmax_var_mean(torch.empty(0, 3, device=device, dtype=dtype), 0)
+        with self.assertRaisesRegex(RuntimeError, 'only support floating-point dtypes'):
+            torch.aminmax_var_mean(torch.ones(3, device=device, dtype=torch.long))
+
+        if dtype == torch.double:
+            x = torch.randn(4, 5, 6, device=device, dtype=dtype, requires_grad=True)
+            for dim in [(), 1, (0, 2)]:
+                def fn(x):
+                    res = torch.aminmax_var_mean(x, dim)
+                    return res.min, res.max, res.var, res.mean
+                self.assertTrue(gradcheck(fn, (x,)))
+
     # TODO: bincount isn't a classic reduction -- maybe this test suite is
     #   reductions and summary ops?
     def test_bincount(self, device):
@@ -941,6 +985,26 @@ class TestReductions(TestCase):
         test_output_dtype(torch.int32, False)
         test_output_dtype(torch.int64, True)
 
+    @dtypes(torch.float, torch.double, torch.int, torch.long)
+    def test_bucketization_large_boundaries(self, device, dtype):
+        # Many values searched in many 1d boundaries take the Eytzinger layout
+        # on CPU and the shared memory kernel on CUDA
+        for num_boundaries in (64, 100, 1000, 5000):
+            boundaries = torch.randint(-500, 500, (num_boundaries,), device=device).sort()[0].to(dtype)
+            values = torch.randint(-600, 600, (3, 10000), device=device).to(dtype)
+            if dtype.is_floating_point:
+                boundaries[-1] = inf
+                values[0, :10] = nan
+                values[1, :10] = inf
+                values[2, :10] = -inf
+            for right in (False, True):
+                side = 'right' if right else 'left'
+                expected = np.searchsorted(boundaries.cpu().numpy(), values.cpu().numpy(), side=side)
+                self.assertEqual(torch.searchsorted(boundaries, values, right=right),
+                                 torch.from_numpy(expected))
+                self.assertEqual(torch.bucketize(values, boundaries, right=right, out_int32=True),
+                                 torch.from_numpy(expected).int())
+
     @dtypesIfCUDA(torch.half, torch.float, torch.double,
                   torch.int8, torch.short, torch.int, torch.long)
     @dtypes(torch.float, torch.double,
@@ -733,6 +733,29 @@ class TestSerialization(TestCase, SerializationMixin):
             f.seek(0)
             state = torch.load(f)
 
+    def test_serialization_compressed(self):
+        data = self._test_serialization_data()
+        # several compressed chunks, and tensors of other element sizes
+        data.append(torch.arange(3 * 1024 * 1024, dtype=torch.float).remainder(100))
+        data.append(torch.zeros(1000, dtype=torch.uint8))
+        data.append(torch.zeros(1000, dtype=torch.double))
+        with BytesIOContext() as f:
+            torch.save(data, f)
+            uncompressed_size = f.tell()
+        for level in [1, 9]:
+            with BytesIOContext() as f:
+                torch.save(data, f, compression_level=level)
+                self.assertLess(f.tell(), uncompressed_size / 2)
+                f.seek(0)
+                self.assertEqual(torch.load(f), data)
+            with BytesIOContext() as f:
+                torch.serialization.async_save(data, f, compression_level=level).result()
+                f.seek(0)
+                self.assertEqual(torch.load(f), data)
+
+        with self.assertRaises(RuntimeError):
+            torch.save(data, io.BytesIO(), compression_level=10)
+
     def test_pathlike_serialization(self):
         model = torch.nn.Conv2d(20, 3200, kernel_size=3)
 
@@ -741,6 +764,47 @@ class TestSerialization(TestCase, SerializationMixin):
             torch.save(model, path)
             torch.load(path)
 
+    def test_async_save(self):
+        data = self._test_serialization_data()
+        expected = copy.deepcopy(data)
+
+        def test(name_or_buffer):
+            fut = torch.serialization.async_save(data, name_or_buffer)
+            # The saved file is a snapshot of the time of the call.
+            data[0].fill_(-1)
+            fut.result()
+            data[0].copy_(expected[0])
+
+            if hasattr(name_or_buffer, 'seek'):
+                name_or_buffer.seek(0)
+
+            result = torch.load(name_or_buffer)
+            self.assertEqual(result, expected)
+
+        with TemporaryFileName() as fname:
+            test(fname)
+
+        test(io.BytesIO())
+
+    @unittest.skipIf(not torch.cuda.is_available(), "CUDA not available")
+    def test_async_save_cuda(self):
+        x = torch.randn(1000, device='cuda')
+        expected = x.clone()
+        with BytesIOContext() as f:
+            fut = torch.serialization.async_save({'x': x}, f)
+            x.add_(1)
+            fut.result()
+            f.seek(0)
+            result = torch.load(f)
+        self.assertEqual(result['x'].device, x.device)
+        self.assertEqual(result['x'], expected)
+
+    def test_async_save_error(self):
+        with TemporaryFileName() as fname:
+            fut = torch.serialization.async_save(torch.ones(2), os.path.join(fname, 'missing', 'file.pt'))
+            with self.assertRaises(Exception):
+                fut.result()
+
     def run(self, *args, **kwargs):
         with serialization_method(use_zip=True):
             return super(TestSerialization, self).run(*args, **kwargs)
@@ -612,6 +612,43 @@ class TestShapeOps(TestCase):
         nz = x.nonzero()
         self.assertFalse(nz.requires_grad)
 
+    @onlyOnCPUAndCUDA
+    def test_nonzero_static(self, device):
+        for shape in ((), (0,), (7,), (4, 5), (3, 0, 2), (2, 3, 4)):
+            mask = torch.randint(2, shape, device=device, dtype=torch.bool)
+            expected = mask.nonzero()
+            count = expected.size(0)
+            for max_size in (0, count // 2, count, count + 3):
+                indices, nonzeros = torch.nonzero_static(mask, max_size)
+                self.assertEqual(indices.size(), (max_size, mask.dim()))
+                self.assertEqual(nonzeros, count)
+                kept = min(count, max_size)
+                self.assertEqual(indices[:kept], expected[:kept], atol=0, rtol=0)
+                self.assertTrue((indices[kept:] == 0).all())
+
+    @onlyOnCPUAndCUDA
+    def test_index_static(self, device):
+        x = torch.randn(4, 5, 3, device=device, requires_grad=True)
+        for mask_shape in ((4,), (4, 5), (4, 5, 3)):
+            mask = torch.randint(2, mask_shape, device=device, dtype=torch.bool)
+            expected = x[mask]
+            count = expected.size(0)
+            max_size = count + 2
+            result = torch.index_static(x, *torch.nonzero_static(mask, max_size))
+            self.assertEqual(result.size(), (max_size,) + expected.size()[1:])
+            self.assertEqual(result[:count], expected)
+            self.assertTrue((result[count:] == 0).all())
+            result.sum().backward()
+            expected_grad = torch.zeros_like(x)
+            expected_grad[mask] = 1
+            self.assertEqual(x.grad, expected_grad)
+            x.grad = None
+
+        values, count = torch.masked_select_static(torch.arange(6., device=device).view(2, 3),
+                                                   torch.tensor([True, False, True], device=device), 5)
+        self.assertEqual(values, torch.tensor([0., 2., 3., 5., 0.], device=device))
+        self.assertEqual(count, 4)
+
 class TestShapeFuncs(TestCase):
     """Test suite for Shape manipulating operators using the ShapeFuncInfo."""
 
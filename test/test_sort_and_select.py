@@ -9,7 +9,7 @@ from torch.testing._internal.common_utils import \
     (TestCase, run_tests, make_tensor)
 from torch.testing._internal.common_device_type import \
     (instantiate_device_type_tests, dtypes, onlyOnCPUAndCUDA,
-     skipCUDAIfRocm, onlyCUDA, dtypesIfCUDA)
+     skipCUDAIfRocm, onlyCUDA, onlyCPU, dtypesIfCUDA)
 
 # TODO: remove this
 SIZE = 100
@@ -113,6 +113,80 @@ class TestSortAndSelect(TestCase):
         self.assertIsOrdered('descending', x, res2val, res2ind,
                              'random with NaNs')
 
+    @onlyCPU
+    @dtypes(torch.uint8, torch.int8, torch.int16, torch.int32, torch.int64, torch.float, torch.double)
+    def test_sort_large_slice(self, device, dtype):
+        # slices of at least 2 ** 16 elements are radix sorted on CPU
+        n = 2 ** 16 + 7
+        x = make_tensor((n,), device, dtype, low=-50, high=50)
+        if dtype.is_floating_point:
+            x[::101] = nan
+            x[::103] = -0.0
+        xn = x.double().numpy()
+        nans = np.nonzero(np.isnan(xn))[0]
+        others = np.nonzero(~np.isnan(xn))[0]
+        for descending in (False, True):
+            values, indices = torch.sort(x, descending=descending)
+            # the radix sort is stable, and puts NaNs last if ascending, and
+            # first if descending
+            if descending:
+                expected_indices = np.concatenate(
+                    (nans, others[np.argsort(-xn[others], kind='stable')]))
+            else:
+                expected_indices = np.argsort(xn, kind='stable')
+            expected = x.numpy()[expected_indices]
+            self.assertEqual(values, torch.from_numpy(expected), atol=0, rtol=0)
+            self.assertEqual(indices, torch.from_numpy(expected_indices), atol=0, rtol=0)
+
+        # few slices, and a strided sort dimension
+        x = make_tensor((n, 3), device, dtype, low=-50, high=50)
+        values, indices = torch.sort(x, dim=0)
+        self.assertEqual(values, torch.from_numpy(np.sort(x.numpy(), axis=0)), atol=0, rtol=0)
+        self.assertEqual(x.gather(0, indices), values, atol=0, rtol=0)
+
+    @onlyCUDA
+    @dtypes(torch.uint8, torch.int32, torch.int64, torch.half, torch.float, torch.double)
+    def test_sort_segmented_radix(self, device, dtype):
+        # slices of more than 2048 elements are radix sorted, many per launch
+        x = make_tensor((37, 5003), device, dtype, low=-50, high=50)
+        if dtype.is_floating_point:
+            x[:, ::101] = nan
+            x[:, ::103] = -0.0
+        xn = x.cpu().double().numpy()
+        for descending in (False, True):
+            values, indices = torch.sort(x, dim=1, descending=descending)
+            if descending:
+                # NaNs first, then stable by decreasing value
+                keys = np.where(np.isnan(xn), -np.inf, -xn)
+                expected_indices = np.argsort(keys, axis=1, kind='stable')
+            else:
+                expected_indices = np.argsort(xn, axis=1, kind='stable')
+            expected_indices = torch.from_numpy(expected_indices).to(device)
+            self.assertEqual(indices, expected_indices, atol=0, rtol=0)
+            self.assertEqual(values, x.gather(1, expected_indices), atol=0, rtol=0)
+            self.assertEqual(torch.argsort(x, dim=1, descending=descending), indices)
+
+            # a strided sort dimension, and non-contiguous outputs
+            xt = x.t()
+            out_values = torch.empty_like(x).t()
+            out_indices = torch.empty(x.shape, device=device, dtype=torch.long).t()
+            torch.sort(xt, dim=0, descending=descending, out=(out_values, out_indices))
+            self.assertEqual(out_indices, indices.t(), atol=0, rtol=0)
+            self.assertEqual(out_values, values.t(), atol=0, rtol=0)
+
+            # topk of a large k sorts the whole slices
+            topk_values, topk_indices = x.topk(3000, dim=1, largest=descending)
+            self.assertEqual(topk_values, values[:, :3000], atol=0, rtol=0)
+            self.assertEqual(x.gather(1, topk_indices), topk_values, atol=0, rtol=0)
+
+        if not dtype.is_floating_point:
+            unique, inverse, counts = torch.unique(x, return_inverse=True, return_counts=True)
+            expected_unique, expected_inverse, expected_counts = torch.unique(
+                x.cpu(), return_inverse=True, return_counts=True)
+            self.assertEqual(unique, expected_unique)
+            self.assertEqual(inverse, expected_inverse)
+            self.assertEqual(counts, expected_counts)
+
     @dtypes(*(torch.testing.get_all_int_dtypes() + torch.testing.get_all_fp_dtypes(include_bfloat16=False)))
     def test_msort(self, device, dtype):
         def test(shape):
@@ -460,6 +534,22 @@ class TestSortAndSelect(TestCase):
         self.assertEqual(val, expected_val, atol=0, rtol=0)
         self.assertEqual(ind, expected_ind, atol=0, rtol=0)
 
+    @onlyCPU
+    @dtypes(torch.int32, torch.float, torch.double)
+    def test_topk_large_slices(self, device, dtype):
+        # a single huge slice is split into chunks selected in parallel, and
+        # small k is selected with a heap
+        for shape, dim, k in (((2 ** 17 + 3,), 0, 100), ((3, 2 ** 16 + 1), 1, 1000),
+                              ((2 ** 16, 5), 0, 7), ((64, 5000), 1, 50)):
+            x = make_tensor(shape, device, dtype, low=-1000, high=1000)
+            if dtype.is_floating_point:
+                x.view(-1)[::997] = nan
+            for largest in (True, False):
+                values, indices = x.topk(k, dim=dim, largest=largest)
+                expected = x.sort(dim=dim, descending=largest)[0].narrow(dim, 0, k)
+                self.assertEqual(values, expected, atol=0, rtol=0)
+                self.assertEqual(x.gather(dim, indices), values, atol=0, rtol=0)
+
     def _test_unique_scalar_empty(self, dtype, device, f):
         # test scalar
         x = torch.tensor(0, dtype=dtype, device=device)
@@ -564,6 +654,39 @@ class TestSortAndSelect(TestCase):
                                     count += 1
                             self.assertEqual(j, count)
 
+    @onlyCPU
+    @dtypes(torch.long, torch.int, torch.double)
+    def test_unique_large(self, device, dtype):
+        # Inputs split across threads, with few and with mostly unique values,
+        # which take the hash and the sort paths
+        for high in (100, 10 ** 7):
+            x = torch.randint(-high, high, (300000,), device=device).to(dtype)
+            expected_unique, expected_inverse, expected_counts = np.unique(
+                x.numpy(), return_inverse=True, return_counts=True)
+            unique, inverse, counts = torch.unique(x, sorted=True, return_inverse=True, return_counts=True)
+            self.assertEqual(unique, torch.from_numpy(expected_unique), atol=0, rtol=0)
+            self.assertEqual(inverse, torch.from_numpy(expected_inverse), atol=0, rtol=0)
+            self.assertEqual(counts, torch.from_numpy(expected_counts), atol=0, rtol=0)
+
+            unique, inverse, counts = torch.unique(x, sorted=False, return_inverse=True, return_counts=True)
+            self.assertEqual(unique[inverse], x, atol=0, rtol=0)
+            self.assertEqual(unique.sort()[0], torch.from_numpy(expected_unique), atol=0, rtol=0)
+            self.assertEqual(counts, torch.bincount(inverse, minlength=unique.numel()), atol=0, rtol=0)
+
+            y = x.sort()[0]
+            unique, inverse, counts = torch.unique_consecutive(y, return_inverse=True, return_counts=True)
+            self.assertEqual(unique, torch.from_numpy(expected_unique), atol=0, rtol=0)
+            self.assertEqual(unique[inverse], y, atol=0, rtol=0)
+            self.assertEqual(counts, torch.from_numpy(expected_counts), atol=0, rtol=0)
+
+        # NaNs are all different, -0.0 is 0.0
+        x = torch.tensor([0., -0., float('nan'), 1., float('nan')] * 20000, device=device)
+        for sorted in (True, False):
+            unique, counts = torch.unique(x, sorted=sorted, return_counts=True)
+            self.assertEqual(unique.numel(), 2 + 40000)
+            self.assertEqual(counts[~unique.isnan()].tolist(), [40000, 20000])
+            self.assertTrue((counts[unique.isnan()] == 1).all())
+
     @dtypes(*set(torch.testing.get_all_dtypes()) - {torch.bfloat16, torch.complex64, torch.complex128})
     def test_unique_consecutive(self, device, dtype):
         if dtype is torch.half and self.device_type == 'cpu':
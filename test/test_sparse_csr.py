@@ -0,0 +1,199 @@
+import torch
+import itertools
+import functools
+from torch.testing._internal.common_utils import TestCase, run_tests, load_tests, gradcheck
+from torch.testing._internal.common_device_type import \
+    (instantiate_device_type_tests, dtypes)
+
+# load_tests from torch.testing._internal.common_utils is used to automatically filter tests for
+# sharding on sandcastle. This line silences flake warnings
+load_tests = load_tests
+
+# batched grad doesn't support sparse
+gradcheck = functools.partial(gradcheck, check_batched_grad=False)
+
+index_dtypes = [torch.int32, torch.int64]
+
+
+class TestSparseCSR(TestCase):
+    exact_dtype = True
+
+    def _make_dense(self, rows, cols, device, dtype, density=0.4):
+        dense = torch.randn(rows, cols, device=device, dtype=dtype)
+        return dense * (torch.rand(rows, cols, device=device) < density).to(dtype)
+
+    def _make_csr(self, dense, index_dtype):
+        csr = dense.to_sparse_csr()
+        return torch.sparse_csr_tensor(csr.crow_indices().to(index_dtype),
+                                       csr.col_indices().to(index_dtype),
+                                       csr.values(), dense.shape)
+
+    @dtypes(torch.float, torch.double)
+    def test_csr_layout(self, device, dtype):
+        for index_dtype in index_dtypes:
+            crow_indices = torch.tensor([0, 2, 4], dtype=index_dtype, device=device)
+            col_indices = torch.tensor([0, 1, 0, 1], dtype=index_dtype, device=device)
+            values = torch.tensor([1, 2, 3, 4], dtype=dtype, device=device)
+            csr = torch.sparse_csr_tensor(crow_indices, col_indices, values, size=(2, 2))
+            self.assertEqual(csr.layout, torch.sparse_csr)
+            self.assertTrue(csr.is_sparse_csr)
+            self.assertFalse(csr.is_sparse)
+            self.assertEqual(csr.shape, torch.Size([2, 2]))
+            self.assertEqual(csr.dtype, dtype)
+            self.assertEqual(csr.device, values.device)
+            self.assertEqual(csr._nnz(), 4)
+            self.assertEqual(csr.crow_indices(), crow_indices)
+            self.assertEqual(csr.col_indices(), col_indices)
+            self.assertEqual(csr.values(), values)
+            self.assertEqual(csr.to_dense(), torch.tensor([[1, 2], [3, 4]], dtype=dtype, device=device))
+
+    def test_csr_constructor_inference(self, device):
+        csr = torch.sparse_csr_tensor([0, 1, 3], [2, 0, 1], [1., 2., 3.], device=device)
+        self.assertEqual(csr.shape, torch.Size([2, 3]))
+        self.assertEqual(csr.crow_indices().dtype, torch.int64)
+        self.assertEqual(csr.dtype, torch.get_default_dtype())
+        self.assertEqual(csr.to_dense(), torch.tensor([[0., 0., 1.], [2., 3., 0.]], device=device))
+
+        csr = torch.sparse_csr_tensor([0, 1, 3], [2, 0, 1], [1, 2, 3], (2, 4), dtype=torch.double, device=device)
+        self.assertEqual(csr.shape, torch.Size([2, 4]))
+        self.assertEqual(csr.dtype, torch.double)
+
+    def test_csr_constructor_validation(self, device):
+        values = torch.tensor([1., 2., 3.], device=device)
+        with self.assertRaisesRegex(RuntimeError, r"crow_indices\[0\] must be 0"):
+            torch.sparse_csr_tensor([1, 1, 3], [0, 1, 2], values, (2, 3), device=device)
+        with self.assertRaisesRegex(RuntimeError, r"crow_indices\[-1\] must be nnz"):
+            torch.sparse_csr_tensor([0, 1, 2], [0, 1, 2], values, (2, 3), device=device)
+        with self.assertRaisesRegex(RuntimeError, "crow_indices must be non-decreasing"):
+            torch.sparse_csr_tensor([0, 2, 1, 3], [0, 1, 2], values, (3, 3), device=device)
+        with self.assertRaisesRegex(RuntimeError, "crow_indices must have rows"):
+            torch.sparse_csr_tensor([0, 1, 3], [0, 1, 2], values, (3, 3), device=device)
+        with self.assertRaisesRegex(RuntimeError, "size is inconsistent with col_indices"):
+            torch.sparse_csr_tensor([0, 1, 3], [0, 1, 3], values, (2, 3), device=device)
+        with self.assertRaisesRegex(RuntimeError, "found negative column index"):
+            torch.sparse_csr_tensor([0, 1, 3], [0, -1, 2], values, (2, 3), device=device)
+        with self.assertRaisesRegex(RuntimeError, "must have the same dtype"):
+            torch.sparse_csr_tensor(torch.tensor([0, 1, 3], dtype=torch.int32),
+                                    torch.tensor([0, 1, 2]), values, (2, 3), device=device)
+        with self.assertRaisesRegex(RuntimeError, "must be 2-D"):
+            torch.sparse_csr_tensor([0, 1, 3], [0, 1, 2], values, (2, 3, 1), device=device)
+
+    @dtypes(torch.float, torch.double)
+    def test_csr_conversions(self, device, dtype):
+        for rows, cols in [(0, 0), (1, 5), (5, 1), (7, 9), (20, 10)]:
+            dense = self._make_dense(rows, cols, device, dtype)
+            csr = dense.to_sparse_csr()
+            self.assertEqual(csr.layout, torch.sparse_csr)
+            self.assertEqual(csr.shape, dense.shape)
+            self.assertEqual(csr._nnz(), int((dense != 0).sum()))
+            self.assertEqual(csr.to_dense(), dense)
+
+            coo = dense.to_sparse()
+            self.assertEqual(coo.to_sparse_csr().to_dense(), dense)
+            # COO -> CSR works on uncoalesced tensors too
+            uncoalesced = torch.sparse_coo_tensor(torch.cat([coo._indices(), coo._indices()], 1),
+                                                  torch.cat([coo._values(), coo._values()]), coo.shape)
+            self.assertEqual(uncoalesced.to_sparse_csr().to_dense(), 2 * dense)
+
+            back = csr.to_sparse()
+            self.assertTrue(back.is_coalesced())
+            self.assertEqual(back.to_dense(), dense)
+
+    @dtypes(torch.float, torch.double)
+    def test_csr_mm(self, device, dtype):
+        for index_dtype, (m, k, n) in itertools.product(index_dtypes, [(10, 20, 5), (1, 7, 3), (15, 1, 8), (5, 5, 0)]):
+            dense = self._make_dense(m, k, device, dtype)
+            csr = self._make_csr(dense, index_dtype)
+            mat = torch.randn(k, n, device=device, dtype=dtype)
+            self.assertEqual(torch.mm(csr, mat), torch.mm(dense, mat))
+            self.assertEqual(csr.mm(mat), dense.mm(mat))
+            # a transposed (column-major) dense operand
+            mat_t = torch.randn(n, k, device=device, dtype=dtype).t()
+            self.assertEqual(torch.mm(csr, mat_t), torch.mm(dense, mat_t))
+
+            out = torch.empty(0, device=device, dtype=dtype)
+            torch.mm(csr, mat, out=out)
+            self.assertEqual(out, torch.mm(dense, mat))
+
+            other = torch.randn(m, n, device=device, dtype=dtype)
+            self.assertEqual(torch._sparse_csr_transposed_mm(csr, other), dense.t().mm(other))
+
+    @dtypes(torch.float, torch.double)
+    def test_csr_addmm(self, device, dtype):
+        for index_dtype, (beta, alpha) in itertools.product(index_dtypes, [(1, 1), (0, 1), (0.5, -2), (2, 0)]):
+            dense = self._make_dense(10, 20, device, dtype)
+            csr = self._make_csr(dense, index_dtype)
+            mat = torch.randn(20, 30, device=device, dtype=dtype)
+            t = torch.randn(10, 30, device=device, dtype=dtype)
+            expected = torch.addmm(t, dense, mat, beta=beta, alpha=alpha)
+            self.assertEqual(torch.addmm(t, csr, mat, beta=beta, alpha=alpha), expected)
+            # broadcasting of self
+            t_row = torch.randn(30, device=device, dtype=dtype)
+            self.assertEqual(torch.addmm(t_row, csr, mat, beta=beta, alpha=alpha),
+                             torch.addmm(t_row, dense, mat, beta=beta, alpha=alpha))
+
+            out = torch.empty(0, device=device, dtype=dtype)
+            torch.addmm(t, csr, mat, beta=beta, alpha=alpha, out=out)
+            self.assertEqual(out, expected)
+
+    @dtypes(torch.float, torch.double)
+    def test_csr_mv(self, device, dtype):
+        for index_dtype in index_dtypes:
+            dense = self._make_dense(10, 20, device, dtype)
+            csr = self._make_csr(dense, index_dtype)
+            vec = torch.randn(20, device=device, dtype=dtype)
+            self.assertEqual(torch.mv(csr, vec), torch.mv(dense, vec))
+            self.assertEqual(csr.mv(vec), dense.mv(vec))
+
+            out = torch.empty(0, device=device, dtype=dtype)
+            torch.mv(csr, vec, out=out)
+            self.assertEqual(out, torch.mv(dense, vec))
+
+    def test_csr_errors(self, device):
+        csr = self._make_dense(4, 5, device, torch.double).to_sparse_csr()
+        with self.assertRaisesRegex(RuntimeError, "Expected dim 0 size"):
+            torch.mm(csr, torch.randn(4, 3, device=device, dtype=torch.double))
+        with self.assertRaisesRegex(RuntimeError, "same dtype"):
+            torch.mm(csr, torch.randn(5, 3, device=device, dtype=torch.float))
+        with self.assertRaisesRegex(RuntimeError, "only 2-D tensors can be converted"):
+            torch.randn(2, 3, 4, device=device).to_sparse_csr()
+        with self.assertRaisesRegex(RuntimeError, "do not have strides"):
+            csr.stride()
+
+    def test_csr_backward(self, device):
+        dense = self._make_dense(6, 8, device, torch.double)
+        csr = dense.to_sparse_csr()
+
+        def fn_mm(mat):
+            return torch.mm(csr, mat)
+
+        def fn_addmm(t, mat):
+            return torch.addmm(t, csr, mat, beta=0.5, alpha=2)
+
+        def fn_mv(vec):
+            return torch.mv(csr, vec)
+
+        mat = torch.randn(8, 3, device=device, dtype=torch.double, requires_grad=True)
+        t = torch.randn(6, 3, device=device, dtype=torch.double, requires_grad=True)
+        vec = torch.randn(8, device=device, dtype=torch.double, requires_grad=True)
+        self.assertTrue(gradcheck(fn_mm, (mat,)))
+        self.assertTrue(gradcheck(fn_addmm, (t, mat)))
+        self.assertTrue(gradcheck(fn_mv, (vec,)))
+
+        # gradients for the sparse operand are not supported
+        csr.requires_grad_(True)
+        with self.assertRaisesRegex(RuntimeError, "requires the 'self' tensor to be strided"):
+            torch.mm(csr, mat)
+
+    def test_csr_print(self, device):
+        csr = torch.sparse_csr_tensor([0, 2, 4], [0, 1, 0, 1], [1., 2., 3., 4.], device=device)
+        printed = str(csr)
+        self.assertIn('crow_indices=tensor([0, 2, 4]', printed)
+        self.assertIn('col_indices=tensor([0, 1, 0, 1]', printed)
+        self.assertIn('layout=torch.sparse_csr', printed)
+
+
+instantiate_device_type_tests(TestSparseCSR, globals(), except_for='meta')
+
+if __name__ == '__main__':
+    run_tests()
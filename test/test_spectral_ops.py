@@ -4,12 +4,13 @@ import math
 from contextlib import contextmanager
 from itertools import product
 import itertools
+import threading
 
 from torch.testing._internal.common_utils import \
     (TestCase, run_tests, TEST_NUMPY, TEST_LIBROSA, TEST_MKL)
 from torch.testing._internal.common_device_type import \
     (instantiate_device_type_tests, ops, dtypes, onlyOnCPUAndCUDA,
-     skipCPUIfNoMkl, skipCUDAIfRocm, deviceCountAtLeast, onlyCUDA, OpDTypes,
+     skipCPUIfNoMkl, skipCUDAIfRocm, deviceCountAtLeast, onlyCUDA, onlyCPU, OpDTypes,
      skipIf)
 from torch.testing._internal.common_methods_invocations import spectral_funcs
 
@@ -679,6 +680,61 @@ class TestFFT(TestCase):
                             self.assertEqual(torch.backends.cuda.cufft_plan_cache.max_size, 10)  # default is cuda:0
                         self.assertEqual(torch.backends.cuda.cufft_plan_cache.max_size, 11)  # default is cuda:1
 
+    @skipCPUIfNoMkl
+    @onlyCPU
+    @dtypes(torch.double)
+    def test_mkl_fft_plan_cache(self, device, dtype):
+        plan_cache = torch.backends.mkl.fft_plan_cache
+
+        @contextmanager
+        def plan_cache_max_size(n):
+            original = plan_cache.max_size
+            plan_cache.max_size = n
+            yield
+            plan_cache.max_size = original
+
+        with plan_cache_max_size(max(1, plan_cache.size - 10)):
+            self._test_fft_ifft_rfft_irfft(device, dtype)
+
+        with plan_cache_max_size(0):
+            self._test_fft_ifft_rfft_irfft(device, dtype)
+            self.assertEqual(plan_cache.size, 0)
+
+        plan_cache.clear()
+        self.assertEqual(plan_cache.size, 0)
+
+        # check that stll works after clearing cache, and that repeated
+        # transforms of the same shape reuse their plan
+        with plan_cache_max_size(10):
+            self._test_fft_ifft_rfft_irfft(device, dtype)
+            self.assertLessEqual(plan_cache.size, 10)
+            plan_cache.clear()
+            x = torch.randn(4, 33, device=device, dtype=dtype)
+            expected = torch.fft.rfft(x)
+            for _ in range(3):
+                self.assertEqual(torch.fft.rfft(x), expected)
+            self.assertEqual(plan_cache.size, 1)
+
+        # each thread has its own cache
+        def run():
+            results.append(torch.fft.fft(x.to(torch.complex128)))
+
+        plan_cache.clear()
+        results = []
+        threads = [threading.Thread(target=run) for _ in range(4)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        for result in results:
+            self.assertEqual(result, torch.fft.fft(x.to(torch.complex128)))
+
+        with self.assertRaisesRegex(RuntimeError, r"must be non-negative"):
+            plan_cache.max_size = -1
+
+        with self.assertRaisesRegex(RuntimeError, r"read-only property"):
+            plan_cache.size = -1
+
     # passes on ROCm w/ python 2.7, fails w/ python 3.6
     @skipCUDAIfRocm
     @skipCPUIfNoMkl
@@ -933,6 +989,35 @@ class TestFFT(TestCase):
         with self.assertRaisesRegex(RuntimeError, 'complex'):
             x.stft(10, pad_mode='constant', onesided=True)
 
+    @onlyOnCPUAndCUDA
+    @skipCUDAIfRocm
+    @skipCPUIfNoMkl
+    @dtypes(torch.float, torch.double)
+    def test_mel_spectrogram(self, device, dtype):
+        def reference(x, n_fft, mel_basis, hop_length, win_length, window, power, normalized):
+            spec = torch.stft(x, n_fft, hop_length, win_length, window, center=False,
+                              normalized=normalized, onesided=True, return_complex=True)
+            return torch.matmul(mel_basis, spec.abs().pow(power))
+
+        for size, n_fft, hop_length, win_length, use_window, power, normalized in [
+                ((400,), 64, None, None, True, 2.0, False),
+                ((3, 4000), 64, 16, 48, True, 1.0, True),
+                ((2, 1000), 33, 7, None, False, 1.5, False),
+                ((1, 64), 64, 10, 64, True, 2.0, True),
+                ((5, 20000), 256, 64, 200, True, 2.0, False)]:
+            x = torch.randn(size, device=device, dtype=dtype)
+            mel_basis = torch.rand(12, n_fft // 2 + 1, device=device, dtype=dtype)
+            window = torch.hann_window(win_length or n_fft, device=device, dtype=dtype) if use_window else None
+            actual = torch._mel_spectrogram(x, n_fft, mel_basis, hop_length, win_length, window, power, normalized)
+            expected = reference(x, n_fft, mel_basis, hop_length, win_length, window, power, normalized)
+            self.assertEqual(actual, expected)
+
+        x = torch.randn(100, device=device, dtype=dtype)
+        with self.assertRaisesRegex(RuntimeError, 'mel_basis of size'):
+            torch._mel_spectrogram(x, 16, torch.rand(4, 8, device=device, dtype=dtype))
+        with self.assertRaisesRegex(RuntimeError, 'expected power > 0'):
+            torch._mel_spectrogram(x, 16, torch.rand(4, 9, device=device, dtype=dtype), power=0.)
+
     # stft is currently warning that it requires return-complex while an upgrader is written
     def test_stft_requires_complex(self, device):
         x = torch.rand(100)
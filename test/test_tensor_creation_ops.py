@@ -677,6 +677,33 @@ class TestTensorCreation(TestCase):
             self.assertTrue(res2.is_contiguous(memory_format=torch.channels_last))
             self.assertEqual(res1, res2)
 
+    @onlyCPU
+    def test_cat_many_inputs(self, device):
+        # many small inputs of different sizes and dtypes, and outputs both
+        # smaller and larger than the grain size
+        for num_inputs, dim, memory_format in product((3, 600), range(4),
+                                                      (torch.contiguous_format, torch.channels_last)):
+            sizes = [random.randint(0, 3) for _ in range(num_inputs)]
+            sizes[0] = max(sizes[0], 1)
+            inputs = []
+            for i, size in enumerate(sizes):
+                shape = [2, 3, 4, 5]
+                shape[dim] = size
+                dtype = (torch.float, torch.double, torch.int)[i % 3]
+                inputs.append(torch.randint(-9, 10, shape, device=device).to(dtype)
+                              .contiguous(memory_format=memory_format))
+            res = torch.cat(inputs, dim=dim)
+            self.assertEqual(res.dtype, torch.double)
+            self.assertTrue(res.is_contiguous(memory_format=memory_format))
+            offset = 0
+            for t in inputs:
+                self.assertEqual(res.narrow(dim, offset, t.size(dim)), t.double())
+                offset += t.size(dim)
+            self.assertEqual(offset, res.size(dim))
+
+        with self.assertRaisesRegex(RuntimeError, "can't be cast to the desired output type"):
+            torch.cat((torch.randn(2), torch.randn(2)), out=torch.empty(4, dtype=torch.long))
+
     @onlyCUDA
     def test_cat_preserve_channels_last(self, device):
         x = torch.randn((4, 3, 8, 8), device=device)
@@ -2071,6 +2098,78 @@ class TestTensorCreation(TestCase):
             n_astensor[0][2] = 250.9
             self.assertNotEqual(torch.tensor(n, device='cuda'), n_astensor)
 
+    @onlyCPU
+    def test_as_tensor_from_buffer(self, device):
+        import array
+
+        # the same values and inferred dtypes as the equivalent lists
+        for typecode in 'bBhilqfd':
+            a = array.array(typecode, [0, 1, 2, 3])
+            self.assertEqual(torch.tensor(a), torch.tensor(a.tolist()), exact_dtype=True)
+            self.assertEqual(torch.as_tensor(a), torch.tensor(a.tolist()), exact_dtype=True)
+        self.assertEqual(torch.tensor(b'\x00\x01\xff'), torch.tensor([0, 1, 255]), exact_dtype=True)
+        self.assertEqual(torch.tensor(bytearray(4), dtype=torch.uint8), torch.zeros(4, dtype=torch.uint8))
+
+        # the buffers with the requested dtype aren't copied
+        a = array.array('f', [0, 1, 2, 3])
+        t = torch.as_tensor(a, dtype=torch.float32)
+        t[0] = 5
+        self.assertEqual(a[0], 5)
+        b = bytearray(b'\x00\x01')
+        t = torch.as_tensor(b, dtype=torch.uint8)
+        t[1] = 7
+        self.assertEqual(b[1], 7)
+
+        # unless they're converted, or copied by torch.tensor
+        t = torch.as_tensor(a, dtype=torch.float64)
+        t[1] = 9
+        self.assertEqual(a[1], 1)
+        t = torch.tensor(a, dtype=torch.float32)
+        t[1] = 9
+        self.assertEqual(a[1], 1)
+
+        # multidimensional and strided memoryviews
+        m = memoryview(array.array('d', range(12))).cast('B').cast('d', [3, 4])
+        self.assertEqual(torch.as_tensor(m, dtype=torch.float64),
+                         torch.arange(12, dtype=torch.float64).view(3, 4))
+        m = memoryview(array.array('q', range(12)))[::3]
+        t = torch.as_tensor(m)
+        self.assertEqual(t, torch.tensor([0, 3, 6, 9]), exact_dtype=True)
+        self.assertEqual(t.stride(), (3,))
+
+        # the formats without a matching dtype fall back to the lists
+        a = array.array('I', [0, 1, 2**32 - 1])
+        self.assertEqual(torch.tensor(a), torch.tensor(a.tolist()), exact_dtype=True)
+
+    @onlyCPU
+    def test_as_tensor_from_dlpack(self, device):
+        from torch.utils.dlpack import to_dlpack
+        x = torch.arange(6.).view(2, 3)
+        y = torch.as_tensor(to_dlpack(x))
+        self.assertEqual(y.data_ptr(), x.data_ptr())
+        self.assertEqual(y, x)
+        self.assertEqual(torch.as_tensor(to_dlpack(x), dtype=torch.int64), x.long())
+        capsule = to_dlpack(x)
+        torch.as_tensor(capsule)
+        with self.assertRaisesRegex(RuntimeError, "Could not infer dtype of PyCapsule"):
+            torch.as_tensor(capsule)
+
+    def test_tensor_from_nested_lists(self, device):
+        data = [[random.random() for _ in range(7)] for _ in range(5)]
+        for dtype in [torch.float32, torch.float64, torch.int64, torch.int32, torch.bool, torch.complex64]:
+            expected = torch.tensor(np.array(data), dtype=dtype, device=device)
+            self.assertEqual(torch.tensor(data, dtype=dtype, device=device), expected)
+
+        # the ints are stored exactly, and mixed with the other scalars
+        ints = [[2**62 + i, -i] for i in range(4)]
+        self.assertEqual(torch.tensor(ints, device=device)[:, 0].tolist(), [2**62 + i for i in range(4)])
+        self.assertEqual(torch.tensor([[1, 2.5], [True, np.float64(3)]], device=device),
+                         torch.tensor([[1., 2.5], [1., 3.]], device=device))
+        with self.assertRaisesRegex(RuntimeError, "Overflow"):
+            torch.tensor([[2**64]], device=device)
+        with self.assertRaisesRegex(ValueError, "expected sequence of length 2 at dim 1"):
+            torch.tensor([[1, 2], [3]], device=device)
+
     # TODO: this test should be updated
     @suppress_warnings
     def test_range(self, device):
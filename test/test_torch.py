@@ -304,6 +304,40 @@ class AbstractTestCases:
             self.assertEqual(y[:, 0], range(100))
             self.assertEqual(y[:, 40], range(4000, 4100))
 
+        def test_copy_permuted(self):
+            # the copies transposing the innermost dimension, for each element size
+            for dtype in [torch.uint8, torch.half, torch.float, torch.double, torch.cdouble]:
+                x = torch.arange(2 * 37 * 9 * 11).reshape(2, 37, 9, 11).to(dtype)
+                for dims in [(0, 2, 3, 1), (0, 3, 1, 2), (3, 2, 1, 0), (1, 3, 0, 2)]:
+                    permuted = x.permute(dims)
+                    y = permuted.contiguous()
+                    self.assertEqual(y.tolist(), permuted.tolist())
+                # NCHW to NHWC
+                y = torch.empty(2, 37, 9, 11, dtype=dtype).to(memory_format=torch.channels_last)
+                y.copy_(x)
+                self.assertEqual(y.tolist(), x.tolist())
+                # into a strided destination
+                y = torch.zeros(11, 9, 2, 38, dtype=dtype)[:, :, :, :37]
+                y.copy_(x.permute(3, 2, 0, 1))
+                self.assertEqual(y.tolist(), x.permute(3, 2, 0, 1).tolist())
+
+        def test_copy_reduced_float(self):
+            # the contiguous copies between float and bfloat16 or half are
+            # vectorized, and must round as the strided ones do
+            x = torch.randn(1000 * 37 + 3) * 1000
+            x[:4] = torch.tensor([float('inf'), -float('inf'), 65520., 1e-7])
+            for dtype in [torch.bfloat16, torch.half]:
+                strided = torch.empty(x.numel() * 2, dtype=dtype)[::2]
+                strided.copy_(x)
+                y = x.to(dtype)
+                self.assertEqual(y.view(torch.int16), strided.contiguous().view(torch.int16))
+                self.assertEqual(y.float(), strided.float())
+                if dtype == torch.half:
+                    self.assertEqual(y.float().numpy(), x.numpy().astype(np.float16).astype(np.float32))
+                nan = torch.full((100,), float('nan')).to(dtype)
+                self.assertTrue(nan.isnan().all())
+                self.assertTrue(nan.float().isnan().all())
+
         def test_device(self):
             cpu = torch.device('cpu')
             self.assertEqual('cpu', str(cpu))
@@ -1718,6 +1752,54 @@ class AbstractTestCases:
                                    "missing 1 required positional arguments",
                                    lambda: torch.tensor().new_zeros((5, 5), 0))
 
+        def test_parsing_signature_cache(self):
+            x = torch.randn(2, 3)
+            y = torch.randn(2, 3)
+            t = torch.tensor(2.)
+            calls = [
+                lambda: torch.add(x, y),
+                lambda: torch.add(x, 2),
+                lambda: torch.add(x, t),
+                lambda: torch.add(x, y, alpha=2),
+                lambda: x.add(t, alpha=t),
+                lambda: x.to(torch.float64),
+                lambda: x.to('cpu', torch.float16),
+                lambda: x.to(y),
+                lambda: x.to(float),
+                lambda: x.view(3, 2),
+                lambda: x.view((3, 2)),
+                lambda: x.view(torch.int32),
+                lambda: x.sum(),
+                lambda: x.sum(1, keepdim=True),
+                lambda: x.sum((0, 1)),
+                lambda: torch.full((2,), t),
+                lambda: torch.cat([x, y], 1),
+                lambda: torch.ones(torch.tensor(3), torch.tensor(4)),
+                lambda: x.max(),
+                lambda: x.max(1),
+                lambda: x.max(y),
+            ]
+
+            prev_enabled = torch._C._get_python_arg_parser_cache_enabled()
+            try:
+                torch._C._set_python_arg_parser_cache_enabled(False)
+                expected = [fn() for fn in calls]
+                torch._C._set_python_arg_parser_cache_enabled(True)
+                torch._C._reset_python_arg_parser_cache_stats()
+                for _ in range(3):
+                    for fn, ref in zip(calls, expected):
+                        self.assertEqual(fn(), ref)
+                hits, misses = torch._C._get_python_arg_parser_cache_stats()
+                self.assertGreater(hits, 0)
+                self.assertGreaterEqual(hits, misses)
+
+                # a call whose arguments match a cached signature only by type
+                # still fails like without the cache
+                self.assertRaises(TypeError, lambda: torch.cumsum(x, torch.tensor(0.)))
+                self.assertRaises(TypeError, lambda: torch.isclose(x, x, t, torch.tensor(1., requires_grad=True)))
+            finally:
+                torch._C._set_python_arg_parser_cache_enabled(prev_enabled)
+
         def test_half_tensor(self):
             devices = ["cpu"]
             if torch.cuda.is_available():
@@ -3927,6 +4009,26 @@ class TestTorchDeviceType(TestCase):
             self.assertTrue(y.is_contiguous())
             self.assertEqual(expected, actual)
 
+    @tf32_on_and_off()
+    def test_cdist_topk(self, device):
+        # more rows than a block of rows and more columns than a tile of columns
+        for r1, r2, k in [(1100, 4200, 5), (7, 30, 30), (3, 10, 1), (0, 10, 3), (4, 10, 0)]:
+            for dtype in [torch.float, torch.double]:
+                x = torch.randn(r1, 9, device=device, dtype=dtype)
+                y = torch.randn(r2, 9, device=device, dtype=dtype)
+                dist = torch.cdist(x, y)
+                values, indices = torch._cdist_topk(x, y, k)
+                expected = dist.topk(k, largest=False).values
+                self.assertEqual(values, expected)
+                # the distances of ties may be ordered differently
+                self.assertEqual(dist.gather(-1, indices), expected)
+
+        x = torch.randn(6, 5, device=device).t()
+        y = torch.randn(20, 5, device=device)
+        self.assertEqual(torch._cdist_topk(x, y, 4)[0], torch.cdist(x, y).topk(4, largest=False).values)
+        with self.assertRaisesRegex(RuntimeError, "must be between 0 and the number of rows"):
+            torch._cdist_topk(x, y, 21)
+
     def test_multinomial_constraints(self, device):
         x = torch.empty(1, 2, 3, dtype=torch.double, device=device)
         self.assertRaisesRegex(
@@ -3958,6 +4060,54 @@ class TestTorchDeviceType(TestCase):
             RuntimeError, "number of categories cannot exceed",
             lambda: torch.multinomial(x, 3))
 
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    def test_sample_top_k_top_p(self, device, dtype):
+        # probabilities .5, .3, .1, .07 and .03
+        logits = torch.tensor([.07, .5, .03, .3, .1], device=device).log().to(dtype)
+        n = 20000
+        rows = logits.expand(n, 5)
+
+        def frequencies(samples):
+            self.assertEqual(samples.shape, (n, 1))
+            self.assertEqual(samples.dtype, torch.long)
+            return torch.bincount(samples.view(-1).cpu(), minlength=5).double() / n
+
+        # top_k alone renormalizes the top_k probabilities
+        freq = frequencies(torch._sample_top_k_top_p(rows, top_k=3))
+        self.assertEqual(freq, torch.tensor([0, 5, 0, 3, 1], dtype=torch.double) / 9, atol=.02, rtol=0)
+        # top_p keeps the smallest set reaching it: .5 + .3 >= .7
+        freq = frequencies(torch._sample_top_k_top_p(rows, top_p=.7))
+        self.assertEqual(freq, torch.tensor([0, 5, 0, 3, 0], dtype=torch.double) / 8, atol=.02, rtol=0)
+        # top_p of the top_k: .5 / .9 < .6 <= .8 / .9
+        freq = frequencies(torch._sample_top_k_top_p(rows, top_k=3, top_p=.6))
+        self.assertEqual(freq, torch.tensor([0, 5, 0, 3, 0], dtype=torch.double) / 8, atol=.02, rtol=0)
+        # neither keeps all the logits
+        freq = frequencies(torch._sample_top_k_top_p(rows))
+        self.assertEqual(freq, torch.tensor([.07, .5, .03, .3, .1], dtype=torch.double), atol=.02, rtol=0)
+
+        # a single logit is the max, for a vocabulary larger than a block
+        big = torch.randn(7, 5000, device=device, dtype=dtype)
+        expected = big.max(1, keepdim=True)[0]
+        self.assertEqual(big.gather(1, torch._sample_top_k_top_p(big, top_k=1)), expected)
+        self.assertEqual(big.gather(1, torch._sample_top_k_top_p(big, top_p=1e-6)), expected)
+        self.assertEqual(big[0][torch._sample_top_k_top_p(big[0], top_k=1)], expected[0])
+        samples = torch._sample_top_k_top_p(big, top_k=50, top_p=.9)
+        self.assertTrue((big.gather(1, samples) >= big.topk(50, dim=1)[0][:, -1:]).all())
+
+        gen = torch.Generator(device=device)
+        gen.manual_seed(0)
+        first = torch._sample_top_k_top_p(big, top_k=1000, generator=gen)
+        gen.manual_seed(0)
+        self.assertEqual(torch._sample_top_k_top_p(big, top_k=1000, generator=gen), first)
+
+        self.assertRaisesRegex(RuntimeError, "logits must be 1 or 2 dim",
+                               lambda: torch._sample_top_k_top_p(big.view(7, 50, 100)))
+        self.assertRaisesRegex(RuntimeError, "top_p must be in",
+                               lambda: torch._sample_top_k_top_p(big, top_p=0))
+        self.assertRaisesRegex(RuntimeError, "top_k must be non-negative",
+                               lambda: torch._sample_top_k_top_p(big, top_k=-1))
+
     def test_cumsum(self, device):
         x = torch.rand(100, 100, device=device)
         res1 = torch.cumsum(x, 1)
@@ -4008,6 +4158,21 @@ class TestTorchDeviceType(TestCase):
         # Check that output maintained correct shape
         self.assertEqual(raw_tensor.shape, raw_tensor.grad.shape)
 
+    @onlyCPU
+    def test_cumulative_ops_long_dim_and_contiguous_rows(self, device):
+        # Long scans are done in blocks, and scans over rows which are
+        # contiguous go over many rows at a time
+        x = torch.randn(100003, dtype=torch.double, device=device)
+        expected = torch.from_numpy(np.cumsum(x.numpy()))
+        self.assertEqual(torch.cumsum(x, 0), expected)
+        self.assertEqual(torch.cumsum(x.float(), 0), expected.float(), atol=1e-3, rtol=1e-5)
+        self.assertEqual(torch.logcumsumexp(x, 0), torch.from_numpy(np.logaddexp.accumulate(x.numpy())))
+
+        m = torch.rand(7, 300, dtype=torch.double, device=device) + 0.5
+        self.assertEqual(torch.cumsum(m, 0), torch.from_numpy(np.cumsum(m.numpy(), 0)))
+        self.assertEqual(torch.cumprod(m, 0), torch.from_numpy(np.cumprod(m.numpy(), 0)))
+        self.assertEqual(torch.logcumsumexp(m, 0), torch.from_numpy(np.logaddexp.accumulate(m.numpy(), 0)))
+
     def test_cumprod(self, device):
         x = torch.rand(100, 100, device=device)
         res1 = torch.cumprod(x, 1)
@@ -4620,6 +4785,50 @@ class TestTorchDeviceType(TestCase):
                                               [1, 0, 0, 0],
                                               [0, 0, 0, 0]], device=device, dtype=torch.float32))
 
+    @onlyCPU
+    def test_index_add_segments(self, device):
+        num_nodes, num_edges, features = 1000, 100000, 4
+        index = torch.randint(num_nodes, (num_edges,), device=device)
+        # zipf-like destinations: a few of them get most of the edges
+        index[::3] = 7
+        src = torch.randint(-10, 10, (num_edges, features), device=device)
+
+        perm, offsets = torch._index_segments(index, num_nodes)
+        self.assertEqual(perm, torch.sort(index * num_edges + torch.arange(num_edges, device=device))[1])
+        self.assertEqual(offsets[1:] - offsets[:-1], torch.bincount(index, minlength=num_nodes))
+
+        expected = torch.zeros(num_nodes, features, dtype=torch.long, device=device)
+        for i in range(0, num_edges, 1000):
+            expected.index_add_(0, index[i:i + 1000], src[i:i + 1000])
+
+        for dtype in (torch.long, torch.float, torch.double):
+            out = torch.zeros(num_nodes, features, dtype=dtype, device=device)
+            self.assertEqual(out._index_add_segments_(0, perm, offsets, src.to(dtype)), expected.to(dtype))
+            out = torch.zeros(num_nodes, features, dtype=dtype, device=device)
+            self.assertEqual(out.index_add_(0, index, src.to(dtype)), expected.to(dtype))
+            out = torch.zeros(num_nodes, features, dtype=dtype, device=device)
+            self.assertEqual(out.scatter_add_(0, index.unsqueeze(-1).expand_as(src), src.to(dtype)),
+                             expected.to(dtype))
+            out = torch.zeros(num_nodes, features, dtype=dtype, device=device)
+            self.assertEqual(out.index_put_((index - num_nodes,), src.to(dtype), accumulate=True), expected.to(dtype))
+
+        # 1-D destinations and sources along dim 1
+        out = torch.zeros(num_nodes, dtype=torch.long, device=device)
+        self.assertEqual(out.scatter_add_(0, index, src[:, 0]), expected[:, 0])
+        out = torch.zeros(features, num_nodes, dtype=torch.long, device=device)
+        self.assertEqual(out.index_add_(1, index, src.t()), expected.t())
+
+        src = src.double().requires_grad_()
+        out = torch.zeros(num_nodes, features, dtype=torch.double, device=device)
+        out._index_add_segments_(0, perm, offsets, src).sum(1).dot(torch.arange(num_nodes, dtype=torch.double)).backward()
+        self.assertEqual(src.grad, index.double().unsqueeze(-1).expand_as(src))
+
+        with self.assertRaisesRegex(IndexError, "out of bounds for dimension 0"):
+            torch._index_segments(torch.tensor([0, num_nodes], device=device), num_nodes)
+        with self.assertRaises(IndexError):
+            torch.zeros(num_nodes, device=device).index_add_(0, index.clone().fill_(num_nodes),
+                                                             torch.ones(num_edges, device=device))
+
     def test_scatter_bool(self, device):
         x = torch.tensor([[True, True, True], [True, True, True]], device=device)
         res = torch.zeros(3, 3, dtype=torch.bool, device=device)
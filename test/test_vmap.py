@@ -497,6 +497,23 @@ class TestVmapAPI(TestCase):
             self.assertEqual(len(wa), 2)
             self.assertRegex(str(wa[-1].message), FALLBACK_REGEX)
 
+    def test_fallback_counts(self):
+        # NB: One day we will implement a batching rule for torch.atan2.
+        # If/when we do, this test should be replaced to test the fallback
+        # path on another operator to avoid bitrot.
+        x = torch.randn(11)
+        y = torch.randn(11)
+        torch._C._debug_only_reset_vmap_fallback_counts()
+        vmap(torch.atan2)(x, y)
+        vmap(vmap(torch.atan2))(x.view(1, 11), y.view(1, 11))
+        vmap(torch.add)(x, y)
+        counts = torch._C._debug_only_vmap_fallback_counts()
+        self.assertEqual(counts.get('aten::atan2'), 2)
+        self.assertNotIn('aten::add.Tensor', counts)
+
+        torch._C._debug_only_reset_vmap_fallback_counts()
+        self.assertEqual(torch._C._debug_only_vmap_fallback_counts(), {})
+
     def _assert_uses_vmap_fallback(self, vmap_args, inputs):
         with warnings.catch_warnings(record=True) as wa:
             with EnableVmapFallbackWarnings():
@@ -1867,6 +1884,213 @@ class TestVmapOperators(Namespace.TestVmapBase):
         test(vmap(lambda x: x.sum(2), in_dims=2), [torch.randn([2, 5, B0, B1, 3])],
              in_dims=2, out_dims=2)
 
+    def test_reductions(self):
+        test = self._vmap_test
+        B0, B1 = 5, 7
+
+        def check(op, check_propagates_grad=True):
+            kwargs = {'check_propagates_grad': check_propagates_grad}
+            test(op, [torch.randn(B0, 2, 3)], **kwargs)
+            test(op, [torch.randn(2, B0, 3)], in_dims=1, **kwargs)
+            test(vmap(op), [torch.randn(B0, B1, 2, 3)], **kwargs)
+            test(vmap(op, in_dims=1), [torch.randn(2, B0, B1, 3)], in_dims=1, **kwargs)
+
+        # full reductions
+        for op in (torch.sum, torch.mean, torch.prod, torch.std, torch.var,
+                   torch.norm, torch.max, torch.min, torch.amax, torch.amin):
+            check(op)
+        check(torch.argmax, check_propagates_grad=False)
+        check(lambda x: (x > 0).all(), check_propagates_grad=False)
+        check(lambda x: (x > 0).any(), check_propagates_grad=False)
+
+        # reductions over dims
+        check(lambda x: x.mean(-1))
+        check(lambda x: x.mean([0, 1], keepdim=True))
+        check(lambda x: x.prod(0, keepdim=True))
+        check(lambda x: x.std(1))
+        check(lambda x: x.var(0, unbiased=False, keepdim=True))
+        check(lambda x: x.norm(dim=1))
+        check(lambda x: x.norm(dim=[0, 1], keepdim=True))
+        check(lambda x: x.norm(p=1, dim=[0, 1]))
+        check(lambda x: x.norm(3))
+        check(lambda x: x.amax(1))
+        check(lambda x: x.amin([0, 1], keepdim=True))
+        check(lambda x: torch.logsumexp(x, 0))
+        check(lambda x: x.max(1))
+        check(lambda x: x.min(0, keepdim=True))
+        check(lambda x: x.argmin(1, keepdim=True), check_propagates_grad=False)
+        check(lambda x: (x > 0).all(1), check_propagates_grad=False)
+        check(lambda x: (x > 0).any(-1, keepdim=True), check_propagates_grad=False)
+
+        # reductions allow dim 0 and dim -1 on the per-example scalars
+        test(lambda x: x.mean(0), [torch.randn(B0)])
+        test(lambda x: x.amax(-1, keepdim=True), [torch.randn(B0)])
+        test(lambda x: x.max(0), [torch.randn(B0)])
+        test(torch.prod, [torch.randn(B0)])
+
+    def test_index_select(self):
+        test = self._vmap_test
+        B0, B1 = 5, 7
+        op = torch.index_select
+        index = torch.tensor([0, 2, 2])
+
+        test(op, (torch.randn(B0, 2, 3), 1, index), in_dims=(0, None, None))
+        test(op, (torch.randn(2, B0, 3), 0, index[:2] % 2), in_dims=(1, None, None))
+        test(op, (torch.randn(2, 3), 1, torch.randint(3, (B0, 4))), in_dims=(None, None, 0))
+        test(op, (torch.randn(B0, 2, 3), 0, torch.randint(2, (4, B0))), in_dims=(0, None, 1))
+        test(op, (torch.randn(B0, 2, 3), 1, torch.randint(3, (B0,))), in_dims=(0, None, 0))
+        test(vmap(op, in_dims=(None, None, 0)),
+             (torch.randn(B0, 2, 3), 0, torch.randint(2, (B0, B1, 4))), in_dims=(0, None, 0))
+
+    def test_gather(self):
+        test = self._vmap_test
+        B0, B1 = 5, 7
+        op = torch.gather
+
+        test(op, (torch.randn(B0, 3, 4), 1, torch.randint(3, (2, 4))), in_dims=(0, None, None))
+        test(op, (torch.randn(3, 4), 0, torch.randint(3, (B0, 2, 4))), in_dims=(None, None, 0))
+        test(op, (torch.randn(B0, 3, 4), -1, torch.randint(4, (3, B0, 2))), in_dims=(0, None, 1))
+        test(vmap(op, in_dims=(None, None, 0)),
+             (torch.randn(B0, 3, 4), 1, torch.randint(4, (B0, B1, 3, 2))), in_dims=(0, None, 0))
+
+    def test_scatter(self):
+        test = self._vmap_test
+        B0, B1 = 5, 7
+
+        # indices without duplicates along dim 1, for a deterministic scatter
+        def unique_index(*sizes):
+            return torch.rand(*sizes, 3, 4).argsort(dim=-2)[..., :2, :]
+
+        for op in (torch.scatter, torch.scatter_add):
+            test(op, (torch.randn(B0, 3, 4), 0, unique_index(B0), torch.randn(B0, 2, 4)),
+                 in_dims=(0, None, 0, 0))
+            test(op, (torch.randn(B0, 3, 4), 0, unique_index(), torch.randn(2, 4)),
+                 in_dims=(0, None, None, None))
+            test(op, (torch.randn(3, 4), 0, unique_index(B0), torch.randn(2, 4)),
+                 in_dims=(None, None, 0, None))
+            test(op, (torch.randn(3, 4), 0, unique_index(), torch.randn(B0, 2, 4)),
+                 in_dims=(None, None, None, 0))
+            test(vmap(op, in_dims=(0, None, 0, None)),
+                 (torch.randn(B1, B0, 3, 4), 0, unique_index(B0, B1), torch.randn(B0, 2, 4)),
+                 in_dims=(1, None, 0, 0))
+
+        test(lambda x, index: torch.scatter(x, 0, index, 2.5), (torch.randn(B0, 3, 4), unique_index(B0)))
+        test(lambda x, index: torch.scatter(x, 0, index, 2.5), (torch.randn(3, 4), unique_index(B0)),
+             in_dims=(None, 0))
+
+    def test_embedding(self):
+        test = self._vmap_test
+        B0, B1 = 5, 7
+
+        def op(weight, indices, **kwargs):
+            return F.embedding(indices, weight, **kwargs)
+
+        test(op, (torch.randn(10, 3), torch.randint(10, (B0, 4))), in_dims=(None, 0))
+        test(op, (torch.randn(B0, 10, 3), torch.randint(10, (4, 2))), in_dims=(0, None))
+        test(op, (torch.randn(10, B0, 3), torch.randint(10, (B0, 4, 2))), in_dims=(1, 0))
+        test(op, (torch.randn(B0, 10, 3), torch.randint(10, (B0,))), in_dims=(0, 0))
+        test(vmap(op, in_dims=(0, None)), (torch.randn(B0, B1, 10, 3), torch.randint(10, (B0, 4))))
+
+        # The rows of padding_idx don't get gradients
+        weight = torch.randn(B0, 10, 3, requires_grad=True)
+        indices = torch.randint(10, (B0, 4))
+        indices[:, 0] = 2
+        padded_op = functools.partial(op, padding_idx=2)
+        result = vmap(padded_op)(weight, indices)
+        expected = torch.stack([padded_op(weight[b], indices[b]) for b in range(B0)])
+        self.assertEqual(result, expected)
+        grad, = torch.autograd.grad(result.sum(), weight)
+        expected_grad, = torch.autograd.grad(expected.sum(), weight)
+        self.assertEqual(grad, expected_grad)
+        self.assertEqual(grad[:, 2], torch.zeros(B0, 3))
+
+    def test_conv(self):
+        test = self._vmap_test
+        B0, B1 = 3, 2
+
+        for op, spatial in ((F.conv1d, (7,)), (F.conv2d, (5, 6)), (F.conv3d, (4, 5, 3))):
+            kernel = (3,) * len(spatial)
+            x = torch.randn(B0, 2, 4, *spatial)
+            weight = torch.randn(B0, 6, 4, *kernel)
+            bias = torch.randn(B0, 6)
+
+            # batched inputs only
+            test(op, (x, weight[0], bias[0]), in_dims=(0, None, None))
+            test(op, (x.movedim(0, 2), weight[0]), in_dims=(2, None))
+            # batched weights or biases, folded into the groups
+            test(op, (x[0], weight, bias[0]), in_dims=(None, 0, None))
+            test(op, (x[0], weight[0], bias), in_dims=(None, None, 0))
+            test(op, (x, weight, bias), in_dims=(0, 0, 0))
+            test(op, (x, weight.movedim(0, 1)), in_dims=(0, 1))
+            test(functools.partial(op, stride=2, padding=1, dilation=2, groups=2),
+                 (x, torch.randn(B0, 6, 2, *kernel), bias))
+            # nested vmap
+            test(vmap(op, in_dims=(None, 0, None)),
+                 (x, torch.randn(B0, B1, 6, 4, *kernel), bias[0]), in_dims=(0, 0, None))
+            test(vmap(op, in_dims=(0, None)),
+                 (torch.randn(B1, B0, 2, 4, *spatial), weight), in_dims=(1, 0))
+
+    def test_layer_norm(self):
+        test = self._vmap_test
+        B0, B1 = 5, 7
+
+        def op(x, weight=None, bias=None):
+            return F.layer_norm(x, [4], weight, bias)
+
+        test(op, (torch.randn(B0, 2, 3, 4),))
+        test(op, (torch.randn(2, B0, 4), torch.randn(4), torch.randn(4)), in_dims=(1, None, None))
+        test(op, (torch.randn(B0, 3, 4), torch.randn(B0, 4), torch.randn(4)), in_dims=(0, 0, None))
+        test(op, (torch.randn(3, 4), torch.randn(4), torch.randn(B0, 4)), in_dims=(None, None, 0))
+        test(vmap(op), (torch.randn(B0, B1, 3, 4), torch.randn(B0, B1, 4), torch.randn(B0, B1, 4)))
+        test(lambda x: F.layer_norm(x, [3, 4]), (torch.randn(B0, 2, 3, 4),))
+
+    def test_group_norm(self):
+        test = self._vmap_test
+        B0, B1 = 5, 7
+
+        def op(x, weight=None, bias=None):
+            return F.group_norm(x, 2, weight, bias)
+
+        test(op, (torch.randn(B0, 3, 4, 5),))
+        test(op, (torch.randn(3, B0, 4, 5), torch.randn(4), torch.randn(4)), in_dims=(1, None, None))
+        test(op, (torch.randn(B0, 3, 4, 5), torch.randn(B0, 4), torch.randn(4)), in_dims=(0, 0, None))
+        test(op, (torch.randn(3, 4, 5), torch.randn(4), torch.randn(B0, 4)), in_dims=(None, None, 0))
+        test(vmap(op), (torch.randn(B0, B1, 3, 4, 5), torch.randn(B0, B1, 4), torch.randn(4)),
+             in_dims=(0, 0, None))
+
+    def test_batch_norm(self):
+        test = self._vmap_test
+        B0, B1 = 5, 7
+
+        def train(x, weight=None, bias=None):
+            return F.batch_norm(x, None, None, weight, bias, training=True)
+
+        def evaluate(x, running_mean, running_var, weight=None, bias=None):
+            return F.batch_norm(x, running_mean, running_var, weight, bias, training=False)
+
+        # Every example normalizes with the statistics of its own samples
+        test(train, (torch.randn(B0, 3, 4, 5),))
+        test(train, (torch.randn(3, B0, 4), torch.randn(4), torch.randn(4)), in_dims=(1, None, None))
+        test(train, (torch.randn(B0, 3, 4, 5), torch.randn(B0, 4), torch.randn(4)), in_dims=(0, 0, None))
+        test(vmap(train), (torch.randn(B0, B1, 3, 4, 5),))
+
+        running_mean = torch.randn(4)
+        running_var = torch.rand(4) + 0.5
+        test(evaluate, (torch.randn(B0, 3, 4, 5), running_mean, running_var), in_dims=(0, None, None))
+        test(evaluate, (torch.randn(3, 4, B0), running_mean, running_var, torch.randn(4), torch.randn(4)),
+             in_dims=(2, None, None, None, None))
+        test(evaluate, (torch.randn(B0, 3, 4), torch.randn(B0, 4), torch.rand(B0, 4) + 0.5),
+             in_dims=(0, 0, 0))
+        test(evaluate, (torch.randn(3, 4), running_mean, running_var, torch.randn(B0, 4)),
+             in_dims=(None, None, None, 0))
+        test(vmap(evaluate, in_dims=(0, None, None)),
+             (torch.randn(B0, B1, 3, 4), running_mean, running_var), in_dims=(0, None, None))
+
+        msg = 'batch_norm.*training=True.*is not supported'
+        with self.assertRaisesRegex(RuntimeError, msg):
+            vmap(functools.partial(F.batch_norm, training=True), in_dims=(0, None, None))(
+                torch.randn(B0, 3, 4), running_mean, running_var)
+
     def test_reshape(self):
         test = self._vmap_test
         B0, B1, B2 = 7, 11, 13
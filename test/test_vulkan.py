@@ -157,6 +157,44 @@ class TestVulkanRewritePass(TestCase):
             data_shape,
             prepack_removal=True,
             fuse_clamping_ops=True)
+        class Conv2DAddRelu(torch.nn.Module):
+            def __init__(self):
+                super(Conv2DAddRelu, self).__init__()
+                self.weight = torch.nn.Parameter(torch.Tensor(torch.rand(conv_weight_shape)), requires_grad=False)
+                self.bias = torch.nn.Parameter(torch.Tensor(torch.rand(conv_bias_shape)), requires_grad=False)
+                self.strides = strides
+                self.paddings = paddings
+                self.dilations = dilations
+                self.groups = groups
+
+            def forward(self, x):
+                o = F.conv2d(x, self.weight, self.bias,
+                             self.strides, self.paddings, self.dilations, self.groups)
+                o = o + x
+                o = F.relu(o)
+                return o
+
+        data_shape = (batch_size, input_channels, height, width)
+        pattern_count_map = {"Tensor = aten::conv2d": -1,
+                             "vulkan_prepack::conv2d_clamp_prepack": 1,
+                             "vulkan_prepack::conv2d_clamp_run": 1,
+                             "aten::add": 1,
+                             "aten::relu": 1}
+        TestVulkanRewritePass.validate_transformed_module(
+            Conv2DAddRelu(), pattern_count_map, data_shape)
+        pattern_count_map = {"Tensor = aten::conv2d": -1,
+                             "vulkan_prepack::conv2d_clamp_prepack": -1,
+                             "vulkan_prepack::conv2d_clamp_run": -1,
+                             "vulkan_prepack::conv2d_clamp_add_run": 1,
+                             "aten::add": -1,
+                             "aten::relu": -1}
+        TestVulkanRewritePass.validate_transformed_module(
+            Conv2DAddRelu(),
+            pattern_count_map,
+            data_shape,
+            prepack_removal=True,
+            fuse_clamping_ops=True)
+
 
 if __name__ == "__main__":
     run_tests()
@@ -831,11 +831,14 @@ def main() -> None:
     dispatch_keys = [
         DispatchKey.CPU,
         DispatchKey.SparseCPU,
+        DispatchKey.SparseCsrCPU,
         DispatchKey.MkldnnCPU,
         DispatchKey.CUDA,
         DispatchKey.SparseCUDA,
+        DispatchKey.SparseCsrCUDA,
         DispatchKey.QuantizedCPU,
         DispatchKey.QuantizedCUDA,
+        DispatchKey.NestedTensor,
         DispatchKey.Math,
         DispatchKey.DefaultBackend,
         # Meta is a magic key: it is automatically generated for structured
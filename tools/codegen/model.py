@@ -78,6 +78,8 @@ class DispatchKey(Enum):
     SparseCUDA = auto()
     SparseHIP = auto()
     SparseXPU = auto()
+    SparseCsrCPU = auto()
+    SparseCsrCUDA = auto()
     NestedTensor = auto()
     PrivateUse1 = auto()
     PrivateUse2 = auto()
@@ -97,6 +99,7 @@ class DispatchKey(Enum):
     AutogradPrivateUse2 = auto()
     AutogradPrivateUse3 = auto()
     Tracer = auto()
+    AutocastCPU = auto()
     Autocast = auto()
     Batched = auto()
     VmapMode = auto()
@@ -145,6 +148,7 @@ def is_cuda_dispatch_key(dk: DispatchKey) -> bool:
         DispatchKey.QuantizedCUDA,
         DispatchKey.ComplexCUDA,
         DispatchKey.SparseCUDA,
+        DispatchKey.SparseCsrCUDA,
         DispatchKey.AutogradCUDA,
         DispatchKey.CUDATensorId,
     }
@@ -579,6 +583,9 @@ class FunctionSchema:
             # TODO: fixme
             if str(self.name) not in [
                     '_amp_foreach_non_finite_check_and_unscale_',
+                    '_fused_adam_',
+                    '_fused_sgd_',
+                    '_fused_lamb_',
                     '_foreach_add_.ScalarList',
                     '_foreach_sub_.ScalarList',
                     '_foreach_mul_.ScalarList',
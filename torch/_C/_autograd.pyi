@@ -1,4 +1,4 @@
-from typing import List, Set
+from typing import Callable, List, Set, Tuple
 from enum import Enum
 
 # Defined in tools/autograd/init.cpp
@@ -46,6 +46,8 @@ class ProfilerEvent:
     def shapes(self) -> List[List[int]]: ...
     def thread_id(self) -> int: ...
     def flops(self) -> float: ...
+    def bytes_read(self) -> int: ...
+    def bytes_written(self) -> int: ...
     ...
 
 class KinetoEvent:
@@ -53,6 +55,9 @@ class KinetoEvent:
     def device_index(self) -> int: ...
     def start_us(self) -> int: ...
     def duration_us(self) -> int: ...
+    def flops(self) -> int: ...
+    def bytes_read(self) -> int: ...
+    def bytes_written(self) -> int: ...
     ...
 
 class ProfilerResult:
@@ -67,6 +72,16 @@ def _profiler_enabled() -> bool: ...
 def kineto_available() -> bool: ...
 def _enable_record_function(enable: bool) -> None: ...
 def _set_empty_test_observer(is_global: bool, sampling_prob: float) -> None: ...
+def _push_saved_tensors_default_hooks(pack_hook: Callable, unpack_hook: Callable) -> None: ...
+def _pop_saved_tensors_default_hooks() -> None: ...
 
 def _enable_profiler_legacy(config: ProfilerConfig) -> None: ...
 def _disable_profiler_legacy() -> List[List[ProfilerEvent]]: ...
+
+def _enable_sampling_profiler(frequency_hz: float = ..., record_python: bool = ...) -> None: ...
+def _disable_sampling_profiler() -> None: ...
+def _sampling_profiler_enabled() -> bool: ...
+def _sampled_stacks() -> List[Tuple[str, int]]: ...
+def _folded_stacks() -> str: ...
+def _num_stack_samples() -> int: ...
+def _reset_sampled_stacks() -> None: ...
@@ -8,6 +8,11 @@ is_cuda: _bool
 def getRuntimeVersion() -> Tuple[int, int, int]: ...
 def getCompileVersion() -> Tuple[int, int, int]: ...
 def getVersionInt() -> int: ...
+def exportBenchmarkCache() -> bytes: ...
+def importBenchmarkCache(state: bytes) -> int: ...
+def saveBenchmarkCache(path: str) -> None: ...
+def loadBenchmarkCache(path: str) -> int: ...
+def clearBenchmarkCache() -> None: ...
 
 class RNNMode(int, Enum):
     value: int
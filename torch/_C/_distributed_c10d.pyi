@@ -11,6 +11,9 @@ _DEFAULT_NO_TIMEOUT: timedelta
 class BuiltinCommHookType(Enum):
     ALLREDUCE = ...
     FP16_COMPRESS = ...
+    BF16_COMPRESS = ...
+    FP16_COMPRESS_WITH_ERROR_FEEDBACK = ...
+    BF16_COMPRESS_WITH_ERROR_FEEDBACK = ...
 
 def _register_comm_hook(reducer: Reducer, state: Any, comm_hook: Any): ...
 def _register_builtin_comm_hook(reducer: Reducer, comm_hook_type: BuiltinCommHookType): ...
@@ -102,6 +105,9 @@ class Store:
     def wait(self, keys: List[str]): ...
     @overload
     def wait(self, keys: List[str], timeout: timedelta): ...
+    def compare_set(self, key: str, expected_value: str, desired_value: str) -> bytes: ...
+    def multi_get(self, keys: List[str]) -> List[bytes]: ...
+    def multi_set(self, keys: List[str], values: List[str]): ...
 
 class FileStore(Store):
     def __init__(
@@ -308,6 +314,7 @@ class ProcessGroup:
 class ProcessGroupRoundRobin(ProcessGroup): ...
 def _round_robin_process_groups(
     process_groups: List[ProcessGroup],
+    split_threshold_bytes: int = ...,
 ) -> ProcessGroupRoundRobin: ...
 
 
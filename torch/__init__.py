@@ -357,6 +357,8 @@ def use_deterministic_algorithms(d):
           ``indices`` is a list of tensors
         * :func:`torch.index_put` with ``accumulate=True`` when called on a CPU
           tensor
+        * :class:`torch.nn.Embedding` with ``sparse=True`` when called on a CUDA
+          tensor that requires grad
 
     The following normally-nondeterministic operations will throw a
     :class:`RuntimeError` when `d=True`:
@@ -372,7 +374,7 @@ def use_deterministic_algorithms(d):
           and one of the following modes is used:
 
           - `linear`
-          - `bilinear`
+          - `bilinear`, unless the input is in channels last memory format
           - `bicubic`
           - `trilinear`
 
@@ -602,11 +604,13 @@ def _assert(condition, message):
 # side effect of adding to the imported module's members for other users.
 
 from torch import cuda as cuda
+from torch import cpu as cpu
 from torch import autograd as autograd
 from torch.autograd import (
     no_grad as no_grad,
     enable_grad as enable_grad,
     set_grad_enabled as set_grad_enabled,
+    inference_mode as inference_mode,
 )
 from torch import fft as fft
 from torch import futures as futures
@@ -1630,6 +1630,33 @@ See also :meth:`Tensor.indices`.
   :meth:`Tensor.coalesce` for details.
 """)
 
+add_docstr_all('crow_indices',
+               r"""
+crow_indices() -> Tensor
+
+Return the compressed row indices of a :ref:`sparse CSR tensor
+<sparse-csr-docs>`: ``crow_indices[i + 1] - crow_indices[i]`` is the number
+of non-zero values in row ``i``.
+
+.. warning::
+  Throws an error if :attr:`self` is not a sparse CSR tensor.
+
+See also :meth:`Tensor.col_indices` and :meth:`Tensor.values`.
+""")
+
+add_docstr_all('col_indices',
+               r"""
+col_indices() -> Tensor
+
+Return the column indices of the values of a :ref:`sparse CSR tensor
+<sparse-csr-docs>`.
+
+.. warning::
+  Throws an error if :attr:`self` is not a sparse CSR tensor.
+
+See also :meth:`Tensor.crow_indices` and :meth:`Tensor.values`.
+""")
+
 add_docstr_all('gt', r"""
 gt(other) -> Tensor
 
@@ -3929,6 +3956,13 @@ Example::
             [ 0,  0,  0]])
 """)
 
+add_docstr_all('to_padded_tensor',
+               r"""
+to_padded_tensor(padding, output_size=None) -> Tensor
+
+See :func:`torch.to_padded_tensor`
+""")
+
 add_docstr_all('to_sparse',
                r"""
 to_sparse(sparseDims) -> Tensor
@@ -3956,6 +3990,23 @@ Example::
            size=(3, 3), nnz=1, layout=torch.sparse_coo)
 """)
 
+add_docstr_all('to_sparse_csr',
+               r"""
+to_sparse_csr() -> Tensor
+
+Returns a copy of a 2-D strided or sparse COO tensor in the :ref:`CSR
+(Compressed Sparse Row) format <sparse-csr-docs>`, with int64 indices.
+
+Example::
+
+    >>> d = torch.tensor([[0., 0., 0.], [9., 0., 10.], [0., 0., 0.]])
+    >>> d.to_sparse_csr()
+    tensor(crow_indices=tensor([0, 0, 2, 2]),
+           col_indices=tensor([0, 2]),
+           values=tensor([ 9., 10.]), size=(3, 3), nnz=2,
+           layout=torch.sparse_csr)
+""")
+
 add_docstr_all('to_mkldnn',
                r"""
 to_mkldnn() -> Tensor
@@ -4621,6 +4672,11 @@ add_docstr_all('is_sparse',
 Is ``True`` if the Tensor uses sparse storage layout, ``False`` otherwise.
 """)
 
+add_docstr_all('is_sparse_csr',
+               r"""
+Is ``True`` if the Tensor uses the sparse CSR storage layout, ``False`` otherwise.
+""")
+
 add_docstr_all('device',
                r"""
 Is the :class:`torch.device` where this Tensor is.
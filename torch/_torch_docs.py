@@ -3850,6 +3850,32 @@ Example::
             [-1.1734,  0.7230]])
 """.format(**common_args))
 
+add_docstr(torch.index_static,
+           r"""
+index_static(input, indices, count) -> Tensor
+
+Indexes :attr:`input` with the indices and the count returned by
+:func:`torch.nonzero_static`, so that ``torch.index_static(input,
+*torch.nonzero_static(mask, max_size))`` is ``input[mask]`` followed by zeros,
+with :attr:`max_size` rows. The rows after :attr:`count` are zeros.
+
+It doesn't copy :attr:`count` to the host, so that it doesn't synchronize a
+CUDA device and can be captured in a CUDA graph.
+
+Args:
+    {input}
+    indices (LongTensor): the indices of the rows, one column per indexed dim
+    count (LongTensor): the number of rows which aren't padding
+
+Example::
+
+    >>> x = torch.tensor([[1., 2.], [3., 4.]])
+    >>> indices, count = torch.nonzero_static(torch.tensor([False, True]), 2)
+    >>> torch.index_static(x, indices, count)
+    tensor([[3., 4.],
+            [0., 0.]])
+""".format(**common_args))
+
 add_docstr(torch.inverse, r"""
 inverse(input, *, out=None) -> Tensor
 
@@ -4074,6 +4100,13 @@ Args:
     {input}
 """.format(**common_args))
 
+add_docstr(torch.is_inference_mode_enabled, r"""
+is_inference_mode_enabled() -> (bool)
+
+Returns True if inference mode is enabled in the current thread, see
+:class:`torch.inference_mode`.
+""")
+
 add_docstr(torch.is_nonzero, r"""
 is_nonzero(input) -> (bool)
 
@@ -4975,6 +5008,31 @@ Example::
     tensor([ 1.2252,  0.5002,  0.6248,  2.0139])
 """.format(**common_args))
 
+add_docstr(torch.masked_select_static,
+           r"""
+masked_select_static(input, mask, max_size) -> (Tensor, LongTensor)
+
+Like :func:`torch.masked_select`, but returns a tensor of :attr:`max_size`
+elements, and the number of elements selected as a 0-dim tensor. The selected
+elements are followed by zeros, and only the first :attr:`max_size` are kept
+when there are more.
+
+Unlike :func:`torch.masked_select`, it doesn't wait for the number of elements
+selected on the host, so that it doesn't synchronize a CUDA device and can be
+captured in a CUDA graph.
+
+Args:
+    {input}
+    mask  (BoolTensor): the tensor containing the binary mask to index with
+    max_size (int): the number of elements of the output
+
+Example::
+
+    >>> x = torch.tensor([[0.3, 1.2], [0.7, -0.5]])
+    >>> torch.masked_select_static(x, x.ge(0.5), 3)
+    (tensor([1.2000, 0.7000, 0.0000]), tensor(2))
+""".format(**common_args))
+
 add_docstr(torch.matrix_rank, r"""
 matrix_rank(input, tol=None, symmetric=False, *, out=None) -> Tensor
 
@@ -5716,6 +5774,45 @@ Example::
     tensor([-1.3312, -0.5744, -1.7268, -1.6165])
 """.format(**multi_dim_common))
 
+add_docstr(torch.aminmax_var_mean,
+           r"""
+aminmax_var_mean(input, dim=None, unbiased=True, keepdim=False, *, out=None) -> (Tensor, Tensor, Tensor, Tensor)
+
+Returns a namedtuple ``(min, max, var, mean)`` of the minimum value, the
+maximum value, the variance and the mean of each slice of the :attr:`input`
+tensor in the given dimension(s) :attr:`dim`, computed in a single pass over
+:attr:`input`. If :attr:`dim` is not given, all the elements are reduced.
+
+The values are the same as the ones of :func:`torch.amin`, :func:`torch.amax`
+and :func:`torch.var_mean`, and the gradient of the minimum and the maximum is
+evenly distributed between equal values as for :func:`torch.amin` and
+:func:`torch.amax`. Only floating point inputs are supported.
+
+If :attr:`unbiased` is ``False``, then the variance will be calculated via the
+biased estimator. Otherwise, Bessel's correction will be used.
+
+{keepdim_details}
+
+Args:
+    {input}
+    {dim}
+    unbiased (bool): whether to use the unbiased estimation or not
+    {keepdim}
+
+Keyword args:
+    out (tuple, optional): the output tuple of four tensors
+
+Example::
+
+    >>> a = torch.tensor([[1., 2., 3.], [4., 6., 8.]])
+    >>> torch.aminmax_var_mean(a, 1)
+    torch.return_types.aminmax_var_mean(
+    min=tensor([1., 4.]),
+    max=tensor([3., 8.]),
+    var=tensor([1., 4.]),
+    mean=tensor([2., 6.]))
+""".format(**multi_dim_common))
+
 add_docstr(torch.argmin,
            r"""
 argmin(input, dim=None, keepdim=False) -> LongTensor
@@ -6257,6 +6354,83 @@ Example::
             [ 8,  9]])
 """)
 
+add_docstr(torch.nested_tensor,
+           r"""
+nested_tensor(tensors) -> Tensor
+
+Creates a nested tensor of the tensors of the list :attr:`tensors`, its
+components, which have the same dtype, device and number of dimensions, but
+may have different sizes. The components are stacked along the dim 0 of the
+nested tensor, and copied one after the other to its buffer, without padding
+them to the same sizes.
+
+Nested tensors have no sizes, strides or storage, and don't support
+autograd. The pointwise ops, :func:`torch.nn.functional.linear` and
+:func:`torch.nn.functional.layer_norm` along dims of the same size in all of
+the components, :func:`torch.softmax` and the attention of nested tensors
+run on their components. :meth:`~Tensor.unbind` returns the components, and
+:func:`torch.to_padded_tensor` pads them to a regular tensor.
+
+Args:
+    tensors (sequence of Tensors): the components
+
+Example::
+
+    >>> nt = torch.nested_tensor([torch.ones(2, 3), torch.ones(1, 3)])
+    >>> nt.dim()
+    3
+    >>> torch.nn.functional.linear(nt, torch.ones(2, 3)).to_padded_tensor(0.)
+    tensor([[[3., 3.],
+             [3., 3.]],
+
+            [[3., 3.],
+             [0., 0.]]])
+""")
+
+add_docstr(torch.nested_tensor_from_padded,
+           r"""
+nested_tensor_from_padded(padded, lengths) -> Tensor
+
+Creates the nested tensor of the components ``padded[i, :lengths[i]]`` of
+a batch :attr:`padded` of sequences padded to the same length, see
+:func:`torch.nested_tensor`.
+
+Args:
+    padded (Tensor): the padded sequences, of size :math:`(B, L, *)`
+    lengths (LongTensor): the lengths of the :math:`B` sequences, at most :math:`L`
+
+Example::
+
+    >>> padded = torch.arange(6.).view(2, 3)
+    >>> torch.nested_tensor_from_padded(padded, torch.tensor([1, 3])).unbind()
+    (tensor([0.]), tensor([3., 4., 5.]))
+""")
+
+add_docstr(torch.to_padded_tensor,
+           r"""
+to_padded_tensor(input, padding, output_size=None) -> Tensor
+
+Returns the components of the nested tensor :attr:`input` stacked along
+dim 0, with each of their dims padded with :attr:`padding` to the largest
+size of the components along it, or to :attr:`output_size`.
+
+Args:
+    input (Tensor): the nested tensor
+    padding (float): the value of the padding
+    output_size (tuple of ints, optional): the size of the padded tensor, at
+        least the size the components are padded to
+
+Example::
+
+    >>> nt = torch.nested_tensor([torch.ones(2), torch.ones(1)])
+    >>> torch.to_padded_tensor(nt, 0.)
+    tensor([[1., 1.],
+            [1., 0.]])
+    >>> torch.to_padded_tensor(nt, -1., (2, 3))
+    tensor([[ 1.,  1., -1.],
+            [ 1., -1., -1.]])
+""")
+
 add_docstr(torch.nan_to_num,
            r"""
 nan_to_num(input, nan=0.0, posinf=None, neginf=None, *, out=None) -> Tensor
@@ -6457,6 +6631,33 @@ Example::
     (tensor([0]),)
 """.format(**common_args))
 
+add_docstr(torch.nonzero_static,
+           r"""
+nonzero_static(input, max_size) -> (LongTensor, LongTensor)
+
+Like :func:`torch.nonzero`, but returns a tensor of :attr:`max_size` rows of
+indices, and the number of nonzero elements as a 0-dim tensor. The indices of
+the nonzero elements are followed by rows of zeros, and only the first
+:attr:`max_size` are kept when there are more.
+
+Unlike :func:`torch.nonzero`, it doesn't wait for the number of nonzero
+elements on the host, so that it doesn't synchronize a CUDA device and can be
+captured in a CUDA graph. The indices and the count can be passed to
+:func:`torch.index_static` to index another tensor.
+
+Args:
+    {input}
+    max_size (int): the number of rows of indices returned
+
+Example::
+
+    >>> torch.nonzero_static(torch.tensor([[0, 1], [1, 1]]), 4)
+    (tensor([[0, 1],
+            [1, 0],
+            [1, 1],
+            [0, 0]]), tensor(3))
+""".format(**common_args))
+
 add_docstr(torch.normal,
            r"""
 normal(mean, std, *, generator=None, out=None) -> Tensor
@@ -8049,6 +8250,53 @@ Example::
 .. _torch.sparse: https://pytorch.org/docs/stable/sparse.html
 """.format(**factory_common_args))
 
+add_docstr(torch.sparse_csr_tensor,
+           r"""
+sparse_csr_tensor(crow_indices, col_indices, values, size=None, *, dtype=None, device=None, requires_grad=False) -> Tensor
+
+Constructs a 2-D :ref:`sparse tensor in CSR (Compressed Sparse Row) format
+<sparse-csr-docs>` with specified values at the given :attr:`crow_indices`
+and :attr:`col_indices`.
+
+Args:
+    crow_indices (array_like): One-dimensional array of size ``rows + 1``.
+        ``crow_indices[i + 1] - crow_indices[i]`` is the number of non-zero
+        values in row ``i``, so that the first element is 0 and the last one
+        is the number of non-zero values. A tensor keeps its dtype, which must
+        be :class:`torch.int32` or :class:`torch.int64`; Python sequences are
+        cast to :class:`torch.int64`.
+    col_indices (array_like): One-dimensional array of size ``nnz``, with
+        the column of each value and the same dtype as :attr:`crow_indices`.
+    values (array_like): Initial values for the tensor. Can be a list, tuple,
+        NumPy ``ndarray``, scalar, and other types.
+    size (list, tuple, or :class:`torch.Size`, optional): Size of the sparse
+        tensor. If not provided, the number of rows is inferred from
+        :attr:`crow_indices` and the number of columns is the largest column
+        index plus one.
+
+Keyword args:
+    dtype (:class:`torch.dtype`, optional): the desired data type of returned tensor.
+        Default: if None, infers data type from :attr:`values`.
+    device (:class:`torch.device`, optional): the desired device of returned tensor.
+        Default: if None, uses the current device for the default tensor type
+        (see :func:`torch.set_default_tensor_type`). :attr:`device` will be the CPU
+        for CPU tensor types and the current CUDA device for CUDA tensor types.
+    {requires_grad}
+
+Example::
+
+    >>> crow_indices = [0, 2, 4]
+    >>> col_indices = [0, 1, 0, 1]
+    >>> values = [1, 2, 3, 4]
+    >>> torch.sparse_csr_tensor(torch.tensor(crow_indices, dtype=torch.int32),
+    ...                         torch.tensor(col_indices, dtype=torch.int32),
+    ...                         torch.tensor(values, dtype=torch.float), size=(2, 2))
+    tensor(crow_indices=tensor([0, 2, 4], dtype=torch.int32),
+           col_indices=tensor([0, 1, 0, 1], dtype=torch.int32),
+           values=tensor([1., 2., 3., 4.]), size=(2, 2), nnz=4,
+           layout=torch.sparse_csr)
+""".format(**factory_common_args))
+
 add_docstr(torch.sqrt,
            r"""
 sqrt(input, *, out=None) -> Tensor
@@ -10514,6 +10762,39 @@ Example::
 """)
 
 
+add_docstr(torch.Generator.set_counter_based,
+           r"""
+Generator.set_counter_based(enabled) -> Generator
+
+Switches a CPU Generator between the default Mersenne Twister engine and a
+counter-based Philox engine for :meth:`~Tensor.uniform_`, :meth:`~Tensor.normal_`
+and :meth:`~Tensor.bernoulli_` (and so dropout). In counter-based mode every
+element is computed from the seed and its own offset, so the tensors are filled
+in parallel and the results don't depend on the number of threads. The other
+distributions keep using the Mersenne Twister. Returns the Generator.
+
+The state returned by :meth:`get_state` records the mode and the Philox offset.
+
+Arguments:
+    enabled (bool): whether to use the counter-based engine.
+
+Example::
+
+    >>> g_cpu = torch.Generator().manual_seed(2147483647)
+    >>> g_cpu.set_counter_based(True)
+    >>> torch.empty(1000000).uniform_(generator=g_cpu)
+""")
+
+
+add_docstr(torch.Generator.is_counter_based,
+           r"""
+Generator.is_counter_based() -> bool
+
+Returns whether the Generator uses the counter-based Philox engine, see
+:meth:`set_counter_based`.
+""")
+
+
 add_docstr(torch.Generator.device,
            r"""
 Generator.device -> device
@@ -15,11 +15,13 @@ from typing import Any, Callable, List, Optional, Sequence, Tuple, Union
 from .variable import Variable
 from .function import Function, NestedIOFunction
 from .gradcheck import gradcheck, gradgradcheck
-from .grad_mode import no_grad, enable_grad, set_grad_enabled
+from .grad_mode import no_grad, enable_grad, set_grad_enabled, inference_mode
 from .anomaly_mode import detect_anomaly, set_detect_anomaly
+from .sparse_grad_mode import set_sparse_grad_deduplication
 from ..overrides import has_torch_function, handle_torch_function
 from . import functional
 from . import forward_ad
+from . import graph
 
 __all__ = ['Variable', 'Function', 'backward', 'grad_mode']
 
@@ -253,7 +255,10 @@ if not torch._C._autograd_init():
 # Import all native method/classes
 from torch._C._autograd import (DeviceType, ProfilerActivity, ProfilerState, ProfilerConfig, ProfilerEvent,
                                 _enable_profiler_legacy, _disable_profiler_legacy, _profiler_enabled,
-                                _enable_record_function, _set_empty_test_observer, kineto_available)
+                                _enable_record_function, _set_empty_test_observer, kineto_available,
+                                _enable_sampling_profiler, _disable_sampling_profiler,
+                                _sampling_profiler_enabled, _sampled_stacks, _num_stack_samples,
+                                _reset_sampled_stacks)
 
 if kineto_available():
     from torch._C._autograd import (ProfilerResult, KinetoEvent,
@@ -5,7 +5,7 @@ import inspect
 from typing import Any, Callable, TypeVar, cast
 
 
-__all__ = ['no_grad', 'enable_grad', 'set_grad_enabled']
+__all__ = ['no_grad', 'enable_grad', 'set_grad_enabled', 'inference_mode']
 
 
 # Used for annotating the decorator usage of 'no_grad' and 'enable_grad'.
@@ -23,7 +23,7 @@ class _DecoratorContextManager:
 
         @functools.wraps(func)
         def decorate_context(*args, **kwargs):
-            with self.__class__():
+            with self.clone():
                 return func(*args, **kwargs)
         return cast(F, decorate_context)
 
@@ -37,10 +37,9 @@ class _DecoratorContextManager:
             # make sure the grad mode is properly set every time the execution
             # flow returns into the wrapped generator and restored when it
             # returns through our `yield` to our caller (see PR #49017).
-            cls = type(self)
             try:
                 # Issuing `None` to a generator fires it up
-                with cls():
+                with self.clone():
                     response = gen.send(None)
 
                 while True:
@@ -50,18 +49,18 @@ class _DecoratorContextManager:
 
                     except GeneratorExit:
                         # Inform the still active generator about its imminent closure
-                        with cls():
+                        with self.clone():
                             gen.close()
                         raise
 
                     except BaseException:
                         # Propagate the exception thrown at us by the caller
-                        with cls():
+                        with self.clone():
                             response = gen.throw(*sys.exc_info())
 
                     else:
                         # Pass the last request to the generator and get its response
-                        with cls():
+                        with self.clone():
                             response = gen.send(request)
 
             # We let the exceptions raised above by the generator's `.throw` or
@@ -80,6 +79,10 @@ class _DecoratorContextManager:
     def __exit__(self, exc_type: Any, exc_value: Any, traceback: Any) -> None:
         raise NotImplementedError
 
+    def clone(self):
+        # override this method if your children class takes __init__ parameters
+        return self.__class__()
+
 
 class no_grad(_DecoratorContextManager):
     r"""Context-manager that disabled gradient calculation.
@@ -206,3 +209,62 @@ class set_grad_enabled(object):
 
     def __exit__(self, exc_type: Any, exc_value: Any, traceback: Any) -> None:
         torch._C._set_grad_enabled(self.prev)
+
+
+class inference_mode(_DecoratorContextManager):
+    r"""Context-manager that enables or disables inference mode.
+
+    Inference mode is a stricter version of :class:`~no_grad` for code that
+    will never run backward, e.g. serving a model. On top of disabling
+    gradient calculation, every operation skips the autograd layer of the
+    dispatcher and calls its kernel directly, and the tensors created in this
+    mode have no version counter. This removes most of the per-operation
+    overhead of autograd, which matters for models made of many small
+    operations.
+
+    The tensors created in inference mode can be used as inputs outside of
+    it, but they cannot be saved for backward or modified in-place there.
+    Gradient calculation cannot be enabled inside of inference mode.
+
+    This context manager is thread local; it will not affect computation
+    in other threads.
+
+    Also functions as a decorator. (Make sure to instantiate with parenthesis.)
+
+    Args:
+        mode (bool): Flag whether to enable inference mode (``True``), or
+            disable it (``False``) inside an inference region. Default: ``True``
+
+    Example::
+
+        >>> x = torch.ones(1, 2, 3, requires_grad=True)
+        >>> with torch.inference_mode():
+        ...   y = x * x
+        >>> y.requires_grad
+        False
+        >>> y._version
+        Traceback (most recent call last):
+        RuntimeError: Tensors created in inference mode do not track their version, which is required to save them for backward.
+        >>> @torch.inference_mode()
+        ... def func(x):
+        ...   return x * x
+        >>> out = func(x)
+        >>> out.requires_grad
+        False
+    """
+    def __init__(self, mode: bool = True) -> None:
+        if not torch._jit_internal.is_scripting():
+            super().__init__()
+        # Holds a c10::InferenceMode guard, which restores the previous state
+        # when it is destroyed
+        self._inference_mode_raii_guard = None
+        self.mode = mode
+
+    def __enter__(self) -> None:
+        self._inference_mode_raii_guard = torch._C._InferenceMode(self.mode)
+
+    def __exit__(self, exc_type: Any, exc_value: Any, traceback: Any) -> None:
+        del self._inference_mode_raii_guard
+
+    def clone(self):
+        return self.__class__(self.mode)
@@ -0,0 +1,297 @@
+import weakref
+from typing import Any, Callable, Dict, List, Optional
+
+import torch
+
+
+class saved_tensors_hooks(object):
+    r"""Context-manager that sets a pair of pack / unpack hooks for the tensors
+    saved for backward.
+
+    Every tensor saved for backward by an operation run under this context is
+    passed to ``pack_hook`` when it is saved, and only the object returned by
+    ``pack_hook`` is kept by the graph. During the backward pass, this object
+    is passed to ``unpack_hook``, which must return a tensor with the same
+    content, sizes, dtype and device as the tensor that was packed.
+
+    The hooks are set for the current thread only, and contexts can be nested:
+    the innermost pair of hooks is used. The tensors saved by ``pack_hook``
+    itself are not packed.
+
+    Args:
+        pack_hook (Callable): a function ``pack_hook(tensor) -> Any``
+        unpack_hook (Callable): a function ``unpack_hook(packed) -> Tensor``
+
+    Example::
+
+        >>> def pack_hook(x):
+        ...     return x.cpu()
+        >>> def unpack_hook(x):
+        ...     return x.cuda()
+        >>> a = torch.ones(5, requires_grad=True, device="cuda")
+        >>> with torch.autograd.graph.saved_tensors_hooks(pack_hook, unpack_hook):
+        ...     y = a * a
+        >>> y.sum().backward()
+    """
+    def __init__(self, pack_hook: Callable[[torch.Tensor], Any], unpack_hook: Callable[[Any], torch.Tensor]) -> None:
+        self.pack_hook = pack_hook
+        self.unpack_hook = unpack_hook
+
+    def __enter__(self) -> None:
+        torch._C._autograd._push_saved_tensors_default_hooks(self.pack_hook, self.unpack_hook)
+
+    def __exit__(self, *args: Any) -> None:
+        torch._C._autograd._pop_saved_tensors_default_hooks()
+
+
+def _is_compressible(tensor: torch.Tensor, dtype: torch.dtype) -> bool:
+    return (tensor.layout == torch.strided and tensor.is_floating_point() and
+            tensor.element_size() > torch.empty((), dtype=dtype).element_size())
+
+
+class compress_saved_tensors(saved_tensors_hooks):
+    r"""Context-manager under which the floating point tensors saved for
+    backward are kept in a smaller floating point :attr:`dtype`, and cast
+    back to their dtype when they are used in backward.
+
+    This halves the memory used by saved float32 activations, at the cost of
+    gradients computed from rounded values. Tensors whose dtype is already
+    as small as :attr:`dtype` are saved unchanged.
+
+    Args:
+        dtype (torch.dtype): the dtype of the saved tensors, ``torch.float16``
+            (default) or ``torch.bfloat16``
+
+    Example::
+
+        >>> with torch.autograd.graph.compress_saved_tensors(torch.bfloat16):
+        ...     loss = model(input).sum()
+        >>> loss.backward()
+    """
+    def __init__(self, dtype: torch.dtype = torch.float16) -> None:
+        if dtype not in (torch.float16, torch.bfloat16):
+            raise ValueError("compress_saved_tensors expects torch.float16 or torch.bfloat16, "
+                             "got {}".format(dtype))
+
+        def pack_hook(tensor):
+            if not _is_compressible(tensor, dtype):
+                return tensor
+            return (tensor.to(dtype), tensor.dtype)
+
+        def unpack_hook(packed):
+            if isinstance(packed, torch.Tensor):
+                return packed
+            tensor, orig_dtype = packed
+            return tensor.to(orig_dtype)
+
+        super(compress_saved_tensors, self).__init__(pack_hook, unpack_hook)
+
+
+class _OffloadedTensor(object):
+    __slots__ = ['index', 'device', 'dtype', 'cpu', 'd2h_event', 'gpu', 'h2d_event', '__weakref__']
+
+    def __init__(self, index, device, dtype, cpu, d2h_event):
+        self.index = index
+        self.device = device
+        self.dtype = dtype
+        self.cpu = cpu
+        self.d2h_event = d2h_event
+        self.gpu: Optional[torch.Tensor] = None
+        self.h2d_event: Optional[torch.cuda.Event] = None
+
+
+class save_on_cpu(saved_tensors_hooks):
+    r"""Context-manager under which the CUDA tensors saved for backward are
+    moved to CPU memory, and copied back to their device when they are used
+    in backward.
+
+    The copies to the CPU run on a side stream, so they overlap with the
+    forward computation. During backward, when a saved tensor is used, the
+    next :attr:`prefetch` tensors that were saved before it (which the
+    backward pass usually needs next) are copied back to the device ahead of
+    time on the side stream as well. Tensors that are not dense CUDA tensors
+    are saved unchanged.
+
+    Args:
+        pin_memory (bool): whether to copy to page-locked memory, which the
+            asynchronous copies require. Default: ``True``
+        prefetch (int): the number of saved tensors to copy back to the
+            device ahead of their use. Default: ``2``
+        dtype (torch.dtype, optional): if ``torch.float16`` or
+            ``torch.bfloat16``, the floating point tensors are also kept in
+            this dtype in CPU memory, see :class:`compress_saved_tensors`.
+            Default: ``None``
+
+    Example::
+
+        >>> with torch.autograd.graph.save_on_cpu():
+        ...     loss = model(input.cuda()).sum()
+        >>> loss.backward()
+    """
+    def __init__(self, pin_memory: bool = True, prefetch: int = 2, dtype: Optional[torch.dtype] = None) -> None:
+        if prefetch < 0:
+            raise ValueError("save_on_cpu expects a non-negative prefetch, got {}".format(prefetch))
+        if dtype is not None and dtype not in (torch.float16, torch.bfloat16):
+            raise ValueError("save_on_cpu expects a dtype of torch.float16 or torch.bfloat16, "
+                             "got {}".format(dtype))
+        self.pin_memory = pin_memory
+        self.prefetch = prefetch
+        self.dtype = dtype
+        self._streams: Dict[torch.device, torch.cuda.Stream] = {}
+        # in the order they were saved
+        self._packed: List[Any] = []
+        super(save_on_cpu, self).__init__(self._pack_hook, self._unpack_hook)
+
+    def _side_stream(self, device):
+        stream = self._streams.get(device)
+        if stream is None:
+            stream = torch.cuda.Stream(device=device)
+            self._streams[device] = stream
+        return stream
+
+    def _pack_hook(self, tensor):
+        if not tensor.is_cuda or tensor.layout != torch.strided:
+            return tensor
+        stream = self._side_stream(tensor.device)
+        stream.wait_stream(torch.cuda.current_stream(tensor.device))
+        with torch.cuda.stream(stream):
+            src = tensor
+            if self.dtype is not None and _is_compressible(tensor, self.dtype):
+                src = tensor.to(self.dtype)
+            cpu = torch.empty(src.size(), dtype=src.dtype, pin_memory=self.pin_memory)
+            cpu.copy_(src, non_blocking=self.pin_memory)
+            d2h_event = torch.cuda.Event()
+            d2h_event.record(stream)
+        # the caching allocator must not reuse the memory of the tensor before
+        # the side stream is done reading it
+        tensor.record_stream(stream)
+        packed = _OffloadedTensor(len(self._packed), tensor.device, tensor.dtype, cpu, d2h_event)
+        self._packed.append(weakref.ref(packed))
+        return packed
+
+    def _copy_to_device(self, packed):
+        stream = self._side_stream(packed.device)
+        with torch.cuda.stream(stream):
+            stream.wait_event(packed.d2h_event)
+            packed.gpu = packed.cpu.to(packed.device, non_blocking=self.pin_memory).to(packed.dtype)
+            packed.h2d_event = torch.cuda.Event()
+            packed.h2d_event.record(stream)
+
+    def _unpack_hook(self, packed):
+        if isinstance(packed, torch.Tensor):
+            return packed
+        if packed.gpu is None:
+            self._copy_to_device(packed)
+        for index in range(packed.index - 1, max(packed.index - 1 - self.prefetch, -1), -1):
+            other = self._packed[index]()
+            if other is not None and other.gpu is None:
+                self._copy_to_device(other)
+        current_stream = torch.cuda.current_stream(packed.device)
+        current_stream.wait_event(packed.h2d_event)
+        gpu = packed.gpu
+        # the unpacked tensor owns the device memory, which is freed once the
+        # backward function is done with it; another unpack copies again
+        packed.gpu = None
+        packed.h2d_event = None
+        gpu.record_stream(current_stream)
+        return gpu
+
+
+class _RecomputedTensor(object):
+    __slots__ = ['fn', 'args', 'arg_versions']
+
+    def __init__(self, fn, args, arg_versions):
+        self.fn = fn
+        self.args = args
+        self.arg_versions = arg_versions
+
+
+def _tensor_versions(args):
+    return [arg._version if isinstance(arg, torch.Tensor) else None for arg in args]
+
+
+class recompute_saved_tensors(saved_tensors_hooks):
+    r"""Context-manager under which the outputs of cheap functions are not
+    kept for backward but computed again when backward needs them.
+
+    Calling the context object as ``ctx(fn, *args)`` runs ``fn(*args)`` and
+    records that its output can be recomputed from ``args``. When that output
+    is saved for backward under this context, only ``fn`` and ``args`` are
+    kept, so the memory of the output is freed as soon as the forward pass is
+    done with it. It is intended for cheap pointwise functions whose inputs
+    are kept anyway, e.g. activations. ``fn`` must be deterministic, and
+    ``args`` must not be modified in-place before backward.
+
+    Example::
+
+        >>> with torch.autograd.graph.recompute_saved_tensors() as recompute:
+        ...     h = recompute(torch.sigmoid, x)
+        ...     loss = (h @ w).sum()
+        >>> # the backward of sigmoid and of the matmul compute sigmoid(x) again
+        >>> loss.backward()
+    """
+    def __init__(self) -> None:
+        # data_ptr of a recomputable output -> (weakref to the output, fn, args,
+        # versions of the args, version of the output)
+        self._outputs: Dict[int, Any] = {}
+        super(recompute_saved_tensors, self).__init__(self._pack_hook, self._unpack_hook)
+
+    def __enter__(self) -> "recompute_saved_tensors":  # type: ignore[override]
+        super(recompute_saved_tensors, self).__enter__()
+        return self
+
+    def __call__(self, fn: Callable[..., torch.Tensor], *args: Any) -> torch.Tensor:
+        # the backward of fn itself may save its output (e.g. sigmoid) before
+        # the output is known to be recomputable, so what fn saves is kept in
+        # holders that are resolved once fn returns
+        holders = []
+
+        def pack_hook(tensor):
+            packed = self._pack_hook(tensor)
+            if isinstance(packed, torch.Tensor):
+                packed = [packed]
+                holders.append(packed)
+            return packed
+
+        with saved_tensors_hooks(pack_hook, self._unpack_hook):
+            out = fn(*args)
+        if not isinstance(out, torch.Tensor):
+            raise TypeError("recompute_saved_tensors expects fn to return a Tensor, "
+                            "got {}".format(type(out)))
+        if out.numel() == 0:
+            return out
+        key = out.data_ptr()
+        outputs = self._outputs
+
+        def remove(ref):
+            entry = outputs.get(key)
+            if entry is not None and entry[0] is ref:
+                del outputs[key]
+
+        self._outputs[key] = (weakref.ref(out, remove), fn, args, _tensor_versions(args), out._version)
+        for holder in holders:
+            holder[0] = self._pack_hook(holder[0])
+        return out
+
+    def _pack_hook(self, tensor):
+        entry = self._outputs.get(tensor.data_ptr()) if tensor.numel() > 0 else None
+        if entry is None:
+            return tensor
+        ref, fn, args, arg_versions, version = entry
+        out = ref()
+        if (out is None or tensor._version != version or tensor.size() != out.size() or
+                tensor.stride() != out.stride() or tensor.dtype != out.dtype or
+                tensor.storage_offset() != out.storage_offset()):
+            return tensor
+        return _RecomputedTensor(fn, args, arg_versions)
+
+    def _unpack_hook(self, packed):
+        if isinstance(packed, list):
+            packed = packed[0]
+        if isinstance(packed, torch.Tensor):
+            return packed
+        if _tensor_versions(packed.args) != packed.arg_versions:
+            raise RuntimeError("an input of a function recomputed by recompute_saved_tensors has been "
+                               "modified by an inplace operation")
+        with torch.no_grad():
+            return packed.fn(*packed.args)
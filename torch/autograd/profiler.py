@@ -215,6 +215,10 @@ class EventList(list):
             for evt in self:
                 if evt.trace_name is None:
                     continue
+                args = ''
+                if evt.flops or evt.bytes_read or evt.bytes_written:
+                    args = '"FLOPs": %s, "Bytes read": %s, "Bytes written": %s' % (
+                        evt.flops or 0, evt.bytes_read, evt.bytes_written)
                 f.write(
                     '{"name": "%s", '
                     '"ph": "X", '
@@ -222,7 +226,7 @@ class EventList(list):
                     '"dur": %s, '
                     '"tid": %s, '
                     '"pid": "CPU functions", '
-                    '"args": {}}, '
+                    '"args": {%s}}, '
                     % (
                         evt.trace_name,
                         evt.time_range.start,
@@ -230,6 +234,7 @@ class EventList(list):
                         evt.thread
                         if not evt.is_remote
                         else f'" node_id:{evt.node_id}, thread_id:{evt.thread} "',
+                        args,
                     )
                 )
                 for k in evt.kernels:
@@ -365,8 +370,11 @@ class profile(object):
 
         with_flops (bool, optional): If with_flops is set, the profiler will estimate
             the FLOPS (floating pointer operations per second) value using the operator's input shape
-            and total time. This allows one to estimate the hardware performance. Currently,
-            this option only works for the matrix multiplication and 2D convolution operators.
+            and total time, along with the memory bandwidth from the bytes the operator reads
+            and writes. This allows one to estimate the hardware performance. Currently,
+            this option works for the matrix multiplication, convolution, common pointwise,
+            reduction and embedding operators (see ``registerOpCostFunction`` in
+            ``torch/csrc/autograd/profiler_utils.h``).
 
         profile_memory (bool, optional): track tensor memory allocation/deallocation.
 
@@ -649,6 +657,72 @@ class record_function(ContextDecorator):
         return profiled_future
 
 
+class sampling_profile(object):
+    """Context manager that samples the Python and operator stacks of every
+    thread at a fixed frequency.
+
+    Unlike ``profile(with_stack=True)``, which records the Python stack of
+    every operator call, only the operator (RecordFunction) stack of each
+    thread is maintained on every call, and a worker thread captures it,
+    along with the Python frames of every thread, ``frequency_hz`` times per
+    second. The overhead makes it suitable for long running workloads.
+
+    The samples are aggregated into folded stacks, the input format of
+    flame graph tools such as flamegraph.pl: one line per distinct stack,
+    with the Python frames (outermost first) then the operators, separated
+    by ``;``, followed by the number of samples of that stack.
+
+    Only one sampling profiler can be active at a time, and it should be
+    entered and exited while no other thread is running operators.
+
+    Args:
+        frequency_hz (float): Number of times per second the stacks are
+            sampled. Default: ``100``.
+        record_python (bool): Include the Python frames in the stacks.
+            Default: ``True``.
+
+    Example:
+        >>> with torch.autograd.profiler.sampling_profile(frequency_hz=500) as prof:
+        ...     train()
+        >>> prof.export_folded_stacks("/tmp/train.folded")
+        >>> # flamegraph.pl /tmp/train.folded > train.svg
+    """
+    def __init__(self, frequency_hz: float = 100., record_python: bool = True):
+        self.frequency_hz = frequency_hz
+        self.record_python = record_python
+        self.stacks: Optional[List[Tuple[str, int]]] = None
+        self.num_samples = 0
+
+    def __enter__(self):
+        if torch.autograd._sampling_profiler_enabled():
+            raise RuntimeError("sampling profiler is already enabled")
+        self.stacks = None
+        torch.autograd._enable_sampling_profiler(self.frequency_hz, self.record_python)
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        torch.autograd._disable_sampling_profiler()
+        self.stacks = torch.autograd._sampled_stacks()
+        self.num_samples = torch.autograd._num_stack_samples()
+        torch.autograd._reset_sampled_stacks()
+        return False
+
+    def _check_finish(self):
+        if self.stacks is None:
+            raise RuntimeError("sampling profiler didn't finish running")
+
+    def folded_stacks(self) -> str:
+        """Returns the sampled stacks in the folded format, most sampled first."""
+        self._check_finish()
+        assert self.stacks is not None
+        return "".join("{} {}\n".format(stack, count) for stack, count in self.stacks)
+
+    def export_folded_stacks(self, path: str):
+        """Writes the folded stacks to ``path``."""
+        with open(path, "w") as f:
+            f.write(self.folded_stacks())
+
+
 class emit_nvtx(object):
     """Context manager that makes every autograd operation emit an NVTX range.
 
@@ -847,7 +921,7 @@ class FunctionEvent(FormattedTimesMixin):
             self, id, name, thread, start_us, end_us, fwd_thread=None, input_shapes=None,
             stack=None, scope=0, cpu_memory_usage=0, cuda_memory_usage=0, is_async=False,
             is_remote=False, sequence_nr=-1, node_id=-1, device_type=DeviceType.CPU, device_index=0,
-            is_legacy=False, flops=None, trace_name=None):
+            is_legacy=False, flops=None, bytes_read=0, bytes_written=0, trace_name=None):
         self.id: int = id
         self.node_id: int = node_id
         self.name: str = name
@@ -871,6 +945,8 @@ class FunctionEvent(FormattedTimesMixin):
         self.device_index: int = device_index
         self.is_legacy: bool = is_legacy
         self.flops: Optional[float] = flops
+        self.bytes_read: int = bytes_read
+        self.bytes_written: int = bytes_written
 
     def append_kernel(self, name, device, start, end):
         assert self.device_type == DeviceType.CPU
@@ -1014,6 +1090,8 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.device_type: DeviceType = DeviceType.CPU
         self.is_legacy: bool = False
         self.flops: float = 0.0
+        self.bytes_read: int = 0
+        self.bytes_written: int = 0
 
     def add(self, other):
         if self.key is None:
@@ -1047,6 +1125,8 @@ class FunctionEventAvg(FormattedTimesMixin):
             self.flops = other.flops
         elif other.flops is not None:
             self.flops += other.flops
+        self.bytes_read += other.bytes_read
+        self.bytes_written += other.bytes_written
         return self
 
     def __iadd__(self, other):
@@ -1172,6 +1252,8 @@ def parse_kineto_results(result):
             device_type=kineto_event.device_type(),
             device_index=kineto_event.device_index(),
             flops=kineto_event.flops(),
+            bytes_read=kineto_event.bytes_read(),
+            bytes_written=kineto_event.bytes_written(),
         )
         function_events.append(fe)
         corr_id = kineto_event.linked_correlation_id()
@@ -1332,6 +1414,8 @@ def parse_legacy_records(thread_records):
                     device_type=DeviceType.CPU,
                     is_legacy=True,
                     flops=start_flops,
+                    bytes_read=start.bytes_read(),
+                    bytes_written=start.bytes_written(),
                 )
                 # note: async events have only cpu total time
                 if not is_async and start.has_cuda():
@@ -1567,6 +1651,18 @@ def build_table(
         assert log_flops >= 0 and log_flops < len(flop_headers)
         return (pow(10, (math.floor(log_flops) * -3.0)), flop_headers[int(log_flops)])
 
+    def auto_scale_bandwidth(bandwidth):
+        bandwidth_headers = [
+            'B/s',
+            'KB/s',
+            'MB/s',
+            'GB/s',
+            'TB/s',
+        ]
+        assert bandwidth > 0
+        log_bandwidth = max(0, min(math.log10(bandwidth) / 3, float(len(bandwidth_headers) - 1)))
+        return (pow(10, (math.floor(log_bandwidth) * -3.0)), bandwidth_headers[int(log_bandwidth)])
+
     add_column(name_column_width)
     for _ in headers[1:]:
         add_column(DEFAULT_COLUMN_WIDTH)
@@ -1579,6 +1675,7 @@ def build_table(
         headers.append('Source Location')
         add_column(src_column_width, text_dir='<')
 
+    bandwidths: Dict[int, float] = {}
     if with_flops:
         # Auto-scaling of flops header
         US_IN_SECOND = 1000.0 * 1000.0  # cpu_time_total is in us
@@ -1597,6 +1694,17 @@ def build_table(
         else:
             with_flops = False  # can't find any valid flops
 
+        # Memory bandwidth from the estimated bytes read and written
+        for evt in events:
+            evt_bytes = evt.bytes_read + evt.bytes_written
+            evt_time_total = evt.cuda_time_total if evt.cuda_time_total != 0 else evt.cpu_time_total
+            if evt_bytes > 0 and evt_time_total > 0:
+                bandwidths[id(evt)] = float(evt_bytes) / evt_time_total * US_IN_SECOND
+        if len(bandwidths) != 0:
+            (bandwidth_scale, bandwidth_header) = auto_scale_bandwidth(min(bandwidths.values()))
+            headers.append(bandwidth_header)
+            add_column(flops_column_width)
+
     row_format = row_format_lst[0]
     header_sep = header_sep_lst[0]
     line_length = line_length_lst[0]
@@ -1697,6 +1805,11 @@ def build_table(
                 row_values.append("--")
             else:
                 row_values.append('{0:8.3f}'.format(evt.flops * flops_scale))
+        if len(bandwidths) != 0:
+            if id(evt) not in bandwidths:
+                row_values.append("--")
+            else:
+                row_values.append('{0:8.3f}'.format(bandwidths[id(evt)] * bandwidth_scale))
         if has_stack:
             src_field = ""
             if len(evt.stack) > 0:
@@ -0,0 +1,43 @@
+import torch
+
+from typing import Any
+
+class set_sparse_grad_deduplication(object):
+    r"""Context-manager that sets whether sparse gradients are accumulated
+    into deduplicated buffers.
+
+    When it is on, the CPU sparse gradients with a single sparse dimension
+    that are accumulated into the ``.grad`` of a leaf tensor over several
+    backward calls (for instance those of :class:`~torch.nn.Embedding` with
+    ``sparse=True``) are summed into a coalesced tensor, in which the rows are
+    deduplicated by hashing. Otherwise their indices are concatenated, and the
+    duplicate rows pile up until the gradient is coalesced, usually by the
+    optimizer.
+
+    The gradients have the same values either way, only their indices differ.
+    It can be used as a context-manager or as a function.
+
+    Args:
+        mode (bool): Flag whether to deduplicate the sparse gradients
+                     (``True``), or not (``False``).
+
+    Example::
+
+        >>> embedding = torch.nn.Embedding(10, 3, sparse=True)
+        >>> input = torch.tensor([1, 2, 1])
+        >>> with torch.autograd.set_sparse_grad_deduplication(True):
+        ...     embedding(input).sum().backward()
+        ...     embedding(input).sum().backward()
+        >>> embedding.weight.grad._indices()
+        tensor([[1, 2]])
+    """
+
+    def __init__(self, mode: bool) -> None:
+        self.prev = torch._C._is_sparse_grad_deduplication_enabled()
+        torch._C._set_sparse_grad_deduplication_enabled(mode)
+
+    def __enter__(self) -> None:
+        pass
+
+    def __exit__(self, *args: Any) -> None:
+        torch._C._set_sparse_grad_deduplication_enabled(self.prev)
@@ -0,0 +1,258 @@
+"""
+Partitioning of models between NNAPI and TorchScript.
+
+convert_model_to_nnapi requires every operation of the model to be supported
+by the NNAPI serializer.  partition_model_for_nnapi instead finds the maximal
+runs of supported operations in the frozen graph, compiles each of them
+ahead of time into a separate NNAPI model, and replaces it with a call to an
+NnapiModule, leaving the unsupported operations to the interpreter.
+"""
+from typing import List
+
+import torch
+from torch.backends._nnapi.serializer import _NnapiSerializer
+from torch.backends._nnapi.prepare import (
+    NnapiModule,
+    NnapiInitWrapper,
+    _condensed_zeros_like,
+)
+
+# The nodes the serializer turns into constants rather than operations
+_CONSTANT_KINDS = ("prim::Constant", "prim::GetAttr", "prim::ListConstruct")
+
+
+def _is_tensor(value):
+    return value.type().kind() == "TensorType"
+
+
+def _is_self(value):
+    return value.node().kind() == "prim::Param" and value.offset() == 0
+
+
+def _constant_nodes(value):
+    """The nodes computing value that the serializer folds into constants, or
+    None if value isn't a constant."""
+    node = value.node()
+    kind = node.kind()
+    if kind == "prim::Constant":
+        return [node]
+    if kind == "prim::GetAttr":
+        owner = node.inputsAt(0)
+        if _is_self(owner):
+            return [node]
+        owners = _constant_nodes(owner)
+        return None if owners is None else owners + [node]
+    if kind == "prim::ListConstruct":
+        nodes = []
+        for inp in node.inputs():
+            # Lists of tensors are operations, e.g. the inputs of a cat
+            if _is_tensor(inp) and inp.node().kind() != "prim::Constant":
+                return None
+            producers = _constant_nodes(inp)
+            if producers is None:
+                return None
+            nodes.extend(producers)
+        return nodes + [node]
+    return None
+
+
+def _is_candidate(node):
+    """Whether the node may be serialized, provided the serializer handles
+    its arguments."""
+    if node.kind() not in _NnapiSerializer.ADDER_MAP or node.kind() in _CONSTANT_KINDS:
+        return False
+    if list(node.blocks()):
+        return False
+    if not all(_is_tensor(out) for out in node.outputs()):
+        return False
+    # The arguments other than the tensors computed by the model, such as the
+    # sizes or the weights, must be constants
+    return all(
+        _is_tensor(inp) or _constant_nodes(inp) is not None
+        for inp in node.inputs())
+
+
+def _find_runs(graph):
+    """The runs of consecutive candidate nodes, skipping over the constants,
+    which are convex since nothing is computed between their nodes."""
+    runs = []
+    run = []
+    for node in graph.nodes():
+        if node.kind() in _CONSTANT_KINDS and all(
+                _constant_nodes(out) is not None for out in node.outputs()):
+            continue
+        if _is_candidate(node):
+            run.append(node)
+        else:
+            if run:
+                runs.append(run)
+            run = []
+    if run:
+        runs.append(run)
+    return runs
+
+
+class _Subgraph(object):
+    def __init__(self, nodes, positions):
+        members = set(nodes)
+        self.nodes = nodes
+        self.input_values = []
+        constants = set()
+        for node in nodes:
+            for inp in node.inputs():
+                producers = _constant_nodes(inp)
+                if producers is not None:
+                    constants.update(producers)
+                elif inp.node() not in members and inp not in self.input_values:
+                    self.input_values.append(inp)
+        # The constants are shared with the rest of the graph, and are left in
+        # place for dead code elimination to remove
+        self.serialized_nodes = sorted(constants | members, key=lambda n: positions[n])
+
+        # Including the uses nested in the blocks of the other nodes
+        self.output_values = [
+            out for node in nodes for out in node.outputs()
+            if any(use.user not in members for use in out.uses())]
+
+
+def _probe(model, values, inputs):
+    """Runs the model on inputs and returns the tensors held by values."""
+    graph = model.graph.copy()
+    # The copy keeps the order of the nodes and their outputs
+    copies = {}
+    for value, copy in zip(model.graph.inputs(), graph.inputs()):
+        copies[value] = copy
+    for node, copy in zip(model.graph.nodes(), graph.nodes()):
+        for value, copy_value in zip(node.outputs(), copy.outputs()):
+            copies[value] = copy_value
+
+    copied_values = [copies[v] for v in values]
+    probe = graph.create("prim::TupleConstruct", copied_values)
+    probe.output().setType(torch._C.TupleType([v.type() for v in copied_values]))
+    graph.appendNode(probe)
+    graph.eraseOutput(0)
+    graph.registerOutput(probe.output())
+
+    fn = torch._C._create_function_from_graph("probe", graph)
+    return dict(zip(values, fn(model, *inputs)))
+
+
+def _serialize(model, subgraph, tensors):
+    """Serializes the subgraph.  On failure, returns None and the position of
+    the first node which couldn't be serialized, or None if the subgraph can't
+    be serialized at all."""
+    if not subgraph.input_values or not subgraph.output_values:
+        return None, None
+    serializer = _NnapiSerializer(None)
+    try:
+        inp_dim_orders = serializer.add_model_inputs(
+            model, subgraph.input_values, [tensors[v] for v in subgraph.input_values])
+    except Exception:
+        return None, 0
+    members = set(subgraph.nodes)
+    failed = 0
+    for node in subgraph.serialized_nodes:
+        try:
+            serializer.add_node(node)
+        except Exception:
+            return None, failed
+        if node in members:
+            failed += 1
+    return serializer.serialize_outputs(subgraph.output_values, inp_dim_orders), None
+
+
+def _replace(model, subgraph, tensors, result, name, replacements):
+    ser_model, used_weights, inp_mem_fmts, out_mem_fmts = result
+    nnapi_module = torch.jit.script(NnapiInitWrapper(NnapiModule(
+        torch.tensor(list(ser_model), dtype=torch.uint8),
+        used_weights,
+        inp_mem_fmts,
+        out_mem_fmts,
+        [_condensed_zeros_like(tensors[v]) for v in subgraph.output_values])))
+    model._c._register_attribute(name, nnapi_module._c._type(), nnapi_module)
+
+    graph = model.graph
+    tensor_list = torch._C.ListType.ofTensors()
+
+    module = graph.create("prim::GetAttr", [next(graph.inputs())])
+    module.s_("name", name)
+    module.output().setType(nnapi_module._c._type())
+    module.insertAfter(subgraph.nodes[-1])
+
+    # The inputs computed by the partitions replaced before this one
+    input_values = [replacements.get(v, v) for v in subgraph.input_values]
+    args = graph.create("prim::ListConstruct", input_values)
+    args.output().setType(tensor_list)
+    args.insertAfter(module)
+
+    call = graph.create("prim::CallMethod", [module.output(), args.output()])
+    call.s_("name", "forward")
+    call.output().setType(tensor_list)
+    call.insertAfter(args)
+
+    outs = graph.create("prim::ListUnpack", [call.output()], len(subgraph.output_values))
+    outs.insertAfter(call)
+
+    for value, out in zip(subgraph.output_values, outs.outputs()):
+        out.setType(value.type())
+        value.replaceAllUsesWith(out)
+        replacements[value] = out
+    for node in reversed(subgraph.nodes):
+        node.destroy()
+
+
+def partition_model_for_nnapi(model, inputs, min_nodes=2):
+    """Freezes the model, and compiles into NNAPI models the runs of at least
+    min_nodes operations which the serializer supports.
+
+    The inputs are example inputs of the model, used to find the shapes,
+    dtypes and quantization parameters of the values between the partitions.
+    Each partition converts its inputs and outputs between the memory formats
+    of TorchScript and NNAPI, so the runs are only worth partitioning when
+    they are long enough to make up for it.  As with convert_model_to_nnapi,
+    the NNAPI models are compiled when the returned model is loaded.
+    """
+    model = torch.jit.freeze(model)
+    if isinstance(inputs, torch.Tensor):
+        inputs = [inputs]
+    graph = model.graph
+
+    positions = {node: idx for idx, node in enumerate(graph.nodes())}
+    runs = _find_runs(graph)
+
+    values = [v for v in list(graph.inputs())[1:] if _is_tensor(v)]
+    for run in runs:
+        for node in run:
+            values.extend(node.outputs())
+            values.extend(
+                v for v in node.inputs()
+                if _is_tensor(v) and _constant_nodes(v) is None and v not in values)
+    tensors = _probe(model, values, inputs)
+
+    partitions: List[_Subgraph] = []
+    results = []
+    while runs:
+        run = runs.pop(0)
+        if len(run) < min_nodes:
+            continue
+        subgraph = _Subgraph(run, positions)
+        result, failed = _serialize(model, subgraph, tensors)
+        if result is not None:
+            partitions.append(subgraph)
+            results.append(result)
+            continue
+        if failed is None:
+            continue
+        # Split around the first node which couldn't be serialized, the nodes
+        # before it are serialized anew with the inputs they actually use
+        runs.insert(0, run[failed + 1:])
+        if failed > 0:
+            runs.insert(0, run[:failed])
+
+    replacements = {}
+    for idx, (subgraph, result) in enumerate(zip(partitions, results)):
+        _replace(model, subgraph, tensors, result, "_nnapi_partition_%d" % idx, replacements)
+
+    torch._C._jit_pass_dce(graph)
+    graph.lint()
+    return model
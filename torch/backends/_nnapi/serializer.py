@@ -501,20 +501,24 @@ class _NnapiSerializer(object):
 
         return ConvPoolArgs2d(*(kernels + strides + real_paddings + dilations + [group_num]))
 
-    def serialize_model(self, model, inputs):
+    def add_model_inputs(self, model, input_values, inputs):
         self.add_immediate_bool_scalar(False)
         self.add_immediate_bool_scalar(True)
 
         inp_dim_orders = []
-        out_dim_orders = []
 
         self_jitval = next(model.graph.inputs())
         self.add_constant_value(self_jitval, self_jitval.type(), model)
 
-        for input_value, input_tensor in zip(list(model.graph.inputs())[1:], inputs):
+        for input_value, input_tensor in zip(input_values, inputs):
             op_id = self.add_tensor_operand_for_input(input_value, input_tensor)
             inp_dim_orders.append(self.operands[op_id].dim_order.value)
 
+        return inp_dim_orders
+
+    def serialize_model(self, model, inputs):
+        inp_dim_orders = self.add_model_inputs(model, list(model.graph.inputs())[1:], inputs)
+
         for idx, node in enumerate(model.graph.nodes()):
             LOG.debug("Processing node #%d: %r", idx, node)
             self.add_node(node)
@@ -523,16 +527,21 @@ class _NnapiSerializer(object):
         assert retn.inputsSize() == 1
         assert retn.outputsSize() == 0
         retn_input = retn.inputsAt(0)
+        output_values = []
         if retn_input.type().kind() == "TensorType":
-            op_id = self.jitval_operand_map[retn_input]
+            output_values = [retn_input]
+        elif retn_input.type().kind() == "TupleType":
+            output_values = self.tensor_tuples[retn_input]
+
+        return self.serialize_outputs(output_values, inp_dim_orders)
+
+    def serialize_outputs(self, output_values, inp_dim_orders):
+        out_dim_orders = []
+        for v in output_values:
+            op_id = self.jitval_operand_map[v]
             # TODO: Make outputs a local variable?
             self.outputs.append(op_id)
             out_dim_orders.append(self.operands[op_id].dim_order.value)
-        elif retn_input.type().kind() == "TupleType":
-            for v in self.tensor_tuples[retn_input]:
-                op_id = self.jitval_operand_map[v]
-                self.outputs.append(op_id)
-                out_dim_orders.append(self.operands[op_id].dim_order.value)
 
         model = []
 
@@ -84,6 +84,51 @@ def is_acceptable(tensor):
     return True
 
 
+def _benchmark_cache():
+    if _cudnn is None or not _cudnn.is_cuda:
+        raise RuntimeError("The cuDNN benchmark cache requires PyTorch to be built with cuDNN")
+    return _cudnn
+
+
+def save_benchmark_cache(path):
+    r"""Saves the convolution algorithms found by this process to the file at
+    ``path``, merged with the ones already saved there by other processes.
+
+    If the environment variable ``TORCH_CUDNN_BENCHMARK_CACHE_FILE`` is set,
+    the algorithms are loaded from that file on first use and saved to it
+    whenever one is benchmarked.
+    """
+    _benchmark_cache().saveBenchmarkCache(path)
+
+
+def load_benchmark_cache(path):
+    r"""Loads the convolution algorithms saved to the file at ``path`` for the
+    current device and cuDNN version, so that they are not benchmarked again,
+    and returns their number.
+    """
+    return _benchmark_cache().loadBenchmarkCache(path)
+
+
+def broadcast_benchmark_cache(src=0, group=None):
+    r"""Broadcasts the convolution algorithms found by rank ``src`` to the
+    other ranks of ``group``, which then don't benchmark them again, and
+    returns the number of algorithms received by this rank.
+
+    Typically rank ``src`` runs a warmup iteration with
+    :attr:`torch.backends.cudnn.benchmark` enabled before all ranks call this
+    function. A rank only imports the algorithms found on a device of the same
+    name as its current device, with the same cuDNN version.
+    """
+    import torch.distributed as dist
+    cache = _benchmark_cache()
+    is_src = dist.get_rank() == src
+    state = [cache.exportBenchmarkCache() if is_src else None]
+    dist.broadcast_object_list(state, src=src, group=group)
+    if is_src:
+        return 0
+    return cache.importBenchmarkCache(state[0])
+
+
 def set_flags(_enabled=None, _benchmark=None, _deterministic=None, _allow_tf32=None):
     orig_flags = (torch._C._get_cudnn_enabled(),
                   torch._C._get_cudnn_benchmark(),
@@ -22,6 +22,36 @@ def flags(enabled=False):
         with __allow_nonbracketed_mutation():
             set_flags(orig_flags[0])
 
+class MkldnnWeightCache(object):
+    r"""
+    Represents the cache of the dense weights reordered for the MKL-DNN
+    kernels. The attributes `size` and `max_size` (in bytes), and method
+    `clear`, can fetch and/ or change properties of the C++ cache.
+    """
+    @property
+    def size(self):
+        return torch._mkldnn_weight_cache_get_size()
+
+    @size.setter
+    def size(self, val):
+        raise RuntimeError(
+            '.size is a read-only property showing the bytes of weights currently in the '
+            'cache. To change the cache capacity, set weight_cache.max_size.')
+
+    @property
+    def max_size(self):
+        return torch._mkldnn_weight_cache_get_max_size()
+
+    @max_size.setter
+    def max_size(self, val):
+        torch._mkldnn_weight_cache_set_max_size(val)
+
+    def clear(self):
+        return torch._mkldnn_weight_cache_clear()
+
+
+weight_cache = MkldnnWeightCache()
+
 class MkldnnModule(PropModule):
     def __init__(self, m, name):
         super(MkldnnModule, self).__init__(m, name)
@@ -0,0 +1,6 @@
+r"""
+This package contains the CPU counterparts of the :mod:`torch.cuda` utilities
+that don't depend on a device runtime, such as :mod:`torch.cpu.amp`.
+"""
+
+from . import amp  # noqa: F401
@@ -0,0 +1,51 @@
+import torch
+import functools
+
+
+class autocast(object):
+    r"""
+    Instances of :class:`autocast` serve as context managers or decorators that
+    allow regions of your script to run in mixed precision on the CPU.
+
+    In these regions, convolutions and matrix products on CPU tensors run in
+    ``torch.bfloat16``, while the ops that need the range or the accuracy of
+    ``torch.float32`` (normalizations, losses, softmax, sums) run in ``torch.float32``.
+    See the :ref:`CPU Autocast Op Reference<autocast-cpu-op-reference>` for details.
+
+    It behaves like :class:`torch.cuda.amp.autocast`: the casts are autograd-exposed,
+    the bfloat16 casts of the float32 weights are cached for the duration of the
+    outermost region (or across regions with the persistent cache, see
+    :ref:`autocast-persistent-cache`), and the CPU and CUDA autocasts can be
+    enabled independently of each other.
+
+    Example::
+
+        model = Net()
+
+        with torch.no_grad(), torch.cpu.amp.autocast():
+            output = model(input)
+
+    Arguments:
+        enabled(bool, optional, default=True):  Whether autocasting should be enabled in the region.
+    """
+    def __init__(self, enabled=True):
+        self._enabled = enabled
+
+    def __enter__(self):
+        self.prev = torch.is_autocast_cpu_enabled()
+        torch.set_autocast_cpu_enabled(self._enabled)
+        torch.autocast_increment_nesting()
+
+    def __exit__(self, *args):
+        # Drop the cache when we exit to a nesting level that's outside any instance of autocast.
+        if torch.autocast_decrement_nesting() == 0:
+            torch.clear_autocast_cache()
+        torch.set_autocast_cpu_enabled(self.prev)
+        return False
+
+    def __call__(self, func):
+        @functools.wraps(func)
+        def decorate_autocast(*args, **kwargs):
+            with self:
+                return func(*args, **kwargs)
+        return decorate_autocast
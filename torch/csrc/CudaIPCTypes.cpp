@@ -1,8 +1,12 @@
 #include <torch/csrc/CudaIPCTypes.h>
 #include <TH/THAllocator.h>
+#include <cstdlib>
+#include <list>
 #include <map>
 #include <mutex>
 #include <random>
+#include <unordered_map>
+#include <vector>
 
 #ifdef _MSC_VER
 #include <c10/util/win32-headers.h>
@@ -116,8 +120,159 @@ void ReturnRefCounter(const std::string& handle, uint64_t offset /* unused */) {
   }
 }
 
+// Note [Retaining received CUDA segments]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Received storages are views of the cudaMalloc'd segments of the producer's
+// caching allocator, which getIpcDevPtr opens once per segment and closes
+// when the last of its storages is freed. A pipeline receiving one batch at
+// a time from the same segments pays cudaIpcOpenMemHandle, which takes
+// milliseconds, for every batch.
+//
+// With PYTORCH_CUDA_IPC_RETAINED_SEGMENTS=N the consumer keeps the mappings
+// of the N segments it released a storage of most recently open. It keeps
+// them safe to reuse by holding back the reference counter of the last storage
+// released in each of them: the producer keeps that block in limbo, so the
+// segment can't be cudaFree'd, and its address reused, while mapped here.
+// The counter is returned when a newer storage of the same segment is
+// released, when the segment is evicted, or on torch.cuda.ipc_collect().
+// Retaining is off by default, as the producer can only release its memory
+// and reference counter files once the consumer lets go of the segments.
+struct CudaIPCRetainedSegment {
+  std::shared_ptr<void> segment_ptr_;
+  std::shared_ptr<at::DataPtr> ref_counters_file_;
+  int64_t ref_counter_offset_;
+
+  void return_ref_counter() {
+    *(static_cast<int64_t*>(ref_counters_file_->get()) + ref_counter_offset_) -=
+        1;
+  }
+};
+
+std::shared_ptr<at::DataPtr> mapReceivedRefCountersFile(
+    const std::string& handle) {
+  int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
+  return std::make_shared<at::DataPtr>(THRefcountedMapAllocator::makeDataPtr(
+      handle.c_str(),
+      flags,
+      sizeof(int64_t) * CUDA_IPC_REF_COUNTER_FILE_SIZE,
+      nullptr));
+}
+
+struct CudaIPCReceivedSegments {
+  CudaIPCReceivedSegments() {
+    const char* env = std::getenv("PYTORCH_CUDA_IPC_RETAINED_SEGMENTS");
+    capacity_ = env ? std::strtoul(env, nullptr, 10) : 0;
+  }
+  ~CudaIPCReceivedSegments() {
+    for (auto& segment : release_all()) {
+      segment.return_ref_counter();
+      // CUDA may already be deinitialized at exit, so don't close the mapping
+      new std::shared_ptr<void>(std::move(segment.segment_ptr_));
+    }
+  }
+
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  std::shared_ptr<at::DataPtr> ref_counters_file(const std::string& handle) {
+    auto it = ref_counters_files_.find(handle);
+    if (it != ref_counters_files_.end()) {
+      if (auto file = it->second.lock()) {
+        return file;
+      }
+    }
+    auto file = mapReceivedRefCountersFile(handle);
+    ref_counters_files_[handle] = file;
+    return file;
+  }
+
+  // Returns the entries released to make room for the new one
+  std::vector<CudaIPCRetainedSegment> retain(
+      const std::string& segment_handle,
+      CudaIPCRetainedSegment segment) {
+    std::vector<CudaIPCRetainedSegment> released;
+    auto it = segments_.find(segment_handle);
+    if (it != segments_.end()) {
+      released.push_back(std::move(it->second.first));
+      order_.erase(it->second.second);
+      segments_.erase(it);
+    }
+    order_.push_back(segment_handle);
+    segments_.emplace(
+        segment_handle, std::make_pair(std::move(segment), --order_.end()));
+    while (segments_.size() > capacity_) {
+      auto oldest = segments_.find(order_.front());
+      released.push_back(std::move(oldest->second.first));
+      segments_.erase(oldest);
+      order_.pop_front();
+    }
+    return released;
+  }
+
+  std::vector<CudaIPCRetainedSegment> release_all() {
+    std::vector<CudaIPCRetainedSegment> released;
+    for (auto& segment : segments_) {
+      released.push_back(std::move(segment.second.first));
+    }
+    segments_.clear();
+    order_.clear();
+    ref_counters_files_.clear();
+    return released;
+  }
+
+  std::mutex mutex_;
+
+ private:
+  size_t capacity_;
+  // least recently released first
+  std::list<std::string> order_;
+  std::unordered_map<
+      std::string,
+      std::pair<CudaIPCRetainedSegment, std::list<std::string>::iterator>>
+      segments_;
+  std::unordered_map<std::string, std::weak_ptr<at::DataPtr>>
+      ref_counters_files_;
+};
+
+CudaIPCReceivedSegments cuda_ipc_received_segments;
+
 } // namespace
 
+void CudaIPCReturnReceivedData(
+    const std::string& segment_handle,
+    std::shared_ptr<void> segment_ptr,
+    const std::string& ref_counter_handle,
+    int64_t ref_counter_offset) {
+  // We don't want to break existing code, so resource deletion is best
+  // effort basis. Exception expected if producer process terminated
+  // before consumer released data.
+  std::vector<CudaIPCRetainedSegment> released;
+  try {
+    if (cuda_ipc_received_segments.capacity() == 0) {
+      CudaIPCRetainedSegment{nullptr,
+                             mapReceivedRefCountersFile(ref_counter_handle),
+                             ref_counter_offset}
+          .return_ref_counter();
+      return;
+    }
+    std::lock_guard<std::mutex> lock(cuda_ipc_received_segments.mutex_);
+    released = cuda_ipc_received_segments.retain(
+        segment_handle,
+        CudaIPCRetainedSegment{
+            std::move(segment_ptr),
+            cuda_ipc_received_segments.ref_counters_file(ref_counter_handle),
+            ref_counter_offset});
+  } catch (c10::Error& err) {
+    // Already warned inside of producer process
+  }
+  // Out of the critical section, as closing the segments takes the lock of
+  // getIpcDevPtr
+  for (auto& segment : released) {
+    segment.return_ref_counter();
+  }
+}
+
 CudaIPCSentData::CudaIPCSentData(
     std::string handle,
     int64_t offset,
@@ -228,6 +383,14 @@ at::DataPtr GetNewRefCountedSentData(void* data, at::Device device) {
 }
 
 bool CudaIPCCollect() {
+  std::vector<CudaIPCRetainedSegment> released;
+  {
+    std::lock_guard<std::mutex> lock(cuda_ipc_received_segments.mutex_);
+    released = cuda_ipc_received_segments.release_all();
+  }
+  for (auto& segment : released) {
+    segment.return_ref_counter();
+  }
   bool freed_memory = cuda_ipc_global_entities.CudaIPCSentDataLimbo_.collect();
   if (cuda_ipc_global_entities.CudaIPCSentDataLimbo_.size() == 0) {
     cuda_ipc_global_entities.safe_clean_current_file();
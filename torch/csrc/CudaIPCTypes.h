@@ -49,6 +49,15 @@ struct CudaIPCSentData final {
 
 TORCH_CUDA_CU_API at::DataPtr GetNewRefCountedSentData(void* data, at::Device device);
 
+// Called once a storage received from another process is freed and its uses
+// on the current stream are done, to return its reference counter to the
+// producer, see Note [Retaining received CUDA segments]
+TORCH_CUDA_CU_API void CudaIPCReturnReceivedData(
+    const std::string& segment_handle,
+    std::shared_ptr<void> segment_ptr,
+    const std::string& ref_counter_handle,
+    int64_t ref_counter_offset);
+
 namespace {
 
 constexpr int64_t CUDA_IPC_REF_COUNTER_FILE_SIZE = 10000;
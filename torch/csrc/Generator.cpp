@@ -158,6 +158,41 @@ static PyObject * THPGenerator_initialSeed(PyObject *_self, PyObject *noargs)
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * THPGenerator_setCounterBased(PyObject *_self, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  auto self = (THPGenerator*)_self;
+  auto generator = self->cdata;
+  THPUtils_assert(PyBool_Check(arg), "set_counter_based expected a bool, "
+          "but got %s", THPUtils_typename(arg));
+  TORCH_CHECK(generator.device().type() == at::kCPU,
+      "set_counter_based is only supported by CPU generators, but got a ",
+      generator.device().type(), " generator");
+  // See Note [Acquire lock when using random generators]
+  std::lock_guard<std::mutex> lock(generator.mutex());
+  generator.get<at::CPUGeneratorImpl>()->set_counter_based(arg == Py_True);
+  Py_INCREF(self);
+  return (PyObject*)self;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * THPGenerator_isCounterBased(PyObject *_self, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  auto self = (THPGenerator*)_self;
+  auto generator = self->cdata;
+  if (generator.device().type() != at::kCPU) {
+    Py_RETURN_FALSE;
+  }
+  // See Note [Acquire lock when using random generators]
+  std::lock_guard<std::mutex> lock(generator.mutex());
+  if (generator.get<at::CPUGeneratorImpl>()->is_counter_based()) {
+    Py_RETURN_TRUE;
+  }
+  Py_RETURN_FALSE;
+  END_HANDLE_TH_ERRORS
+}
+
 static PyObject * THPGenerator_get_device(THPGenerator *self, void *unused) {
   HANDLE_TH_ERRORS
   return THPDevice_New(self->cdata.device());
@@ -175,6 +210,8 @@ static PyMethodDef THPGenerator_methods[] = {
   {"manual_seed",     THPGenerator_manualSeed,     METH_O,       nullptr},
   {"seed",            THPGenerator_seed,           METH_NOARGS,  nullptr},
   {"initial_seed",    THPGenerator_initialSeed,    METH_NOARGS,  nullptr},
+  {"set_counter_based", THPGenerator_setCounterBased, METH_O,    nullptr},
+  {"is_counter_based", THPGenerator_isCounterBased, METH_NOARGS, nullptr},
   {nullptr}
 };
 
@@ -10,11 +10,15 @@
 #include <libshm.h>
 #include <TH/TH.h>
 #include <c10/util/Logging.h>
+#include <c10/util/OverheadProbe.h>
 #include <ATen/ATen.h>
+#include <ATen/BatchedFallback.h>
 #include <ATen/ExpandUtils.h>
+#include <ATen/core/Vitals.h>
 #include <ATen/dlpack.h>
 #include <ATen/DLConvertor.h>
 #include <ATen/Parallel.h>
+#include <ATen/TensorIterator.h>
 #include <ATen/Utils.h>
 #include <ATen/VmapMode.h>
 #include <pybind11/pybind11.h>
@@ -41,6 +45,7 @@
 #include <torch/csrc/utils/disable_torch_function.h>
 #include <torch/csrc/utils/tensor_dtypes.h>
 #include <torch/csrc/utils/python_compat.h>
+#include <torch/csrc/utils/python_arg_parser.h>
 #include <torch/csrc/utils/python_strings.h>
 #include <torch/csrc/utils/tensor_layouts.h>
 #include <torch/csrc/utils/tensor_memoryformats.h>
@@ -598,6 +603,27 @@ static PyObject * THPModule_are_vmap_fallback_warnings_enabled(PyObject* _unused
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * THPModule_vmap_fallback_counts(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  THPObjectPtr counts(PyDict_New());
+  if (!counts) throw python_error();
+  for (const auto& count : at::getVmapFallbackCounts()) {
+    THPObjectPtr value(THPUtils_packInt64(count.second));
+    if (!value || PyDict_SetItemString(counts.get(), count.first.c_str(), value.get()) != 0) {
+      throw python_error();
+    }
+  }
+  return counts.release();
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * THPModule_reset_vmap_fallback_counts(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  at::resetVmapFallbackCounts();
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 //NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, modernize-avoid-c-arrays)
 static PyMethodDef TorchMethods[] = {
   {"_initExtension",  THPModule_initExtension,   METH_O,       nullptr},
@@ -640,6 +666,8 @@ static PyMethodDef TorchMethods[] = {
   {"_vmapmode_decrement_nesting", THPModule_vmapmode_decrement_nesting, METH_NOARGS, nullptr},
   {"_debug_only_display_vmap_fallback_warnings", THPModule_set_display_vmap_fallback_warnings_mode, METH_O, nullptr},
   {"_debug_only_are_vmap_fallback_warnings_enabled", THPModule_are_vmap_fallback_warnings_enabled, METH_NOARGS, nullptr},
+  {"_debug_only_vmap_fallback_counts", THPModule_vmap_fallback_counts, METH_NOARGS, nullptr},
+  {"_debug_only_reset_vmap_fallback_counts", THPModule_reset_vmap_fallback_counts, METH_NOARGS, nullptr},
   {"_to_dlpack",      THPModule_toDLPack,          METH_O,       nullptr},
   {"_from_dlpack",    THPModule_fromDLPack,        METH_O,       nullptr},
   {"set_flush_denormal", THPModule_setFlushDenormal, METH_O,     nullptr},
@@ -850,6 +878,55 @@ PyObject* initModule() {
   py_module.def("_demangle", &c10::demangle);
   py_module.def("_log_api_usage_once", &LogAPIUsageOnceFromPython);
 
+  // See Note [PythonArgParser signature cache]
+  py_module.def("_get_python_arg_parser_cache_stats", []() {
+    auto stats = torch::get_python_arg_parser_cache_stats();
+    return std::make_tuple(stats.hits, stats.misses);
+  });
+  py_module.def("_reset_python_arg_parser_cache_stats", &torch::reset_python_arg_parser_cache_stats);
+  py_module.def("_set_python_arg_parser_cache_enabled", &torch::set_python_arg_parser_cache_enabled);
+  py_module.def("_get_python_arg_parser_cache_enabled", &torch::python_arg_parser_cache_enabled);
+
+  // See c10/util/OverheadProbe.h
+  py_module.def("_overhead_probes_compiled", &c10::overheadProbesCompiled);
+  py_module.def("_set_overhead_probes_enabled", &c10::setOverheadProbesEnabled);
+  py_module.def("_get_overhead_stats", []() {
+    const auto stats = c10::getOverheadStats();
+    std::unordered_map<std::string, std::tuple<uint64_t, uint64_t, uint64_t>> result;
+    for (size_t i = 0; i < c10::kNumOverheadStages; ++i) {
+      result.emplace(
+          c10::overheadStageName(static_cast<c10::OverheadStage>(i)),
+          std::make_tuple(stats[i].count, stats[i].total_ns, stats[i].self_ns));
+    }
+    return result;
+  });
+  py_module.def("_reset_overhead_stats", &c10::resetOverheadStats);
+
+  // See Note [Slow path counters]
+  py_module.def("_get_slow_path_counts", &at::vitals::getSlowPathCounts);
+  py_module.def("_reset_slow_path_counts", &at::vitals::resetSlowPathCounts);
+
+  // See Note [TensorIterator cache]
+  py_module.def("_set_tensor_iterator_cache", [](bool enabled) {
+    at::globalContext().setTensorIteratorCache(enabled);
+  });
+  py_module.def("_get_tensor_iterator_cache", []() {
+    return at::globalContext().tensorIteratorCache();
+  });
+  py_module.def("_get_tensor_iterator_cache_stats", []() {
+    const auto stats = at::get_tensor_iterator_cache_stats();
+    return std::make_tuple(stats.hits, stats.misses);
+  });
+  py_module.def("_reset_tensor_iterator_cache", &at::reset_tensor_iterator_cache);
+
+  // See Note [Lazy index bounds checks]
+  py_module.def("_set_trusted_indices", [](bool trusted) {
+    at::globalContext().setTrustedIndices(trusted);
+  });
+  py_module.def("_get_trusted_indices", []() {
+    return at::globalContext().trustedIndices();
+  });
+
   py_module.def(
     "init_num_threads",
     torch::wrap_pybind_function(at::init_num_threads),
@@ -2,6 +2,7 @@
 
 #include <torch/data/dataloader_options.h>
 #include <torch/data/detail/data_shuttle.h>
+#include <torch/data/detail/pin_memory.h>
 #include <torch/data/detail/sequencers.h>
 #include <torch/data/iterator.h>
 #include <torch/data/samplers/random.h>
@@ -13,6 +14,7 @@
 
 #include <c10/util/Exception.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <exception>
 #include <memory>
@@ -37,6 +39,9 @@ class DataLoaderBase {
       std::unique_ptr<Dataset> main_thread_dataset = nullptr)
       : options_(std::move(options)),
         main_thread_dataset_(std::move(main_thread_dataset)),
+        // The job queue holds at most `max_jobs` jobs while loading, and one
+        // quit message per worker when joining.
+        shuttle_(std::max(options_.max_jobs, options_.workers)),
         sequencer_(new_sequencer()) {}
 
   virtual ~DataLoaderBase() {
@@ -173,7 +178,8 @@ class DataLoaderBase {
         }
       }
     } else if (auto batch_request = get_batch_request()) {
-      return this->main_thread_dataset_->get_batch(std::move(*batch_request));
+      return maybe_pin_memory(
+          this->main_thread_dataset_->get_batch(std::move(*batch_request)));
     }
     return nullopt;
   }
@@ -186,7 +192,8 @@ class DataLoaderBase {
         break;
       }
       try {
-        auto batch = dataset.get_batch(std::move(*job.batch_request));
+        auto batch = maybe_pin_memory(
+            dataset.get_batch(std::move(*job.batch_request)));
         shuttle_.push_result({std::move(batch), job.sequence_number});
       } catch (...) {
         shuttle_.push_result({std::current_exception(), job.sequence_number});
@@ -194,6 +201,16 @@ class DataLoaderBase {
     }
   }
 
+  /// Returns `batch`, copied into pinned memory if the `pin_memory` option is
+  /// set.
+  template <typename T>
+  T maybe_pin_memory(T batch) {
+    if (options_.pin_memory) {
+      return detail::pin_batch(std::move(batch));
+    }
+    return batch;
+  }
+
   /// Convenience method that calls `shuttle_.push_job()` with the next sequence
   /// number.
   template <typename T>
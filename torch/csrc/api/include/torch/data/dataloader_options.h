@@ -1,6 +1,7 @@
 #pragma once
 
 #include <torch/arg.h>
+#include <torch/cuda.h>
 #include <torch/types.h>
 
 #include <chrono>
@@ -23,9 +24,20 @@ struct DataLoaderOptions {
   TORCH_ARG(size_t, workers) = 0;
 
   /// The maximum number of jobs to enqueue for fetching by worker threads.
-  /// Defaults to two times the number of worker threads.
+  /// Defaults to `prefetch_factor` times the number of worker threads.
   TORCH_ARG(optional<size_t>, max_jobs);
 
+  /// The number of batches loaded in advance by each worker thread, unless
+  /// `max_jobs` is set explicitly.
+  TORCH_ARG(size_t, prefetch_factor) = 2;
+
+  /// Whether to copy batches into pinned (page-locked) host memory before they
+  /// are returned, so that they can be copied to CUDA devices asynchronously.
+  /// Worker threads pin the batches they load. Applies to the tensors of
+  /// batches that are tensors, `Example`s or vectors of those. Ignored if no
+  /// CUDA device is available.
+  TORCH_ARG(bool, pin_memory) = false;
+
   /// An optional limit on the time to wait for the next batch.
   TORCH_ARG(optional<std::chrono::milliseconds>, timeout);
 
@@ -41,7 +53,7 @@ struct DataLoaderOptions {
 
 /// Like `DataLoaderOptions`, but without any unconfigured state.
 /// `DataLoaderOptions` has some options that depend on other options
-/// (`max_jobs` => `2 * workers`). In the spirit of properly using the C++ type
+/// (`max_jobs` => `prefetch_factor * workers`). In the spirit of properly using the C++ type
 /// system, `DataLoaderOptions` allows only setting values. To access values,
 /// you must create a `FullDataLoaderOptions` from a `DataLoaderOptions`
 /// instance, which will do any necessary coalescing.
@@ -49,10 +61,12 @@ struct FullDataLoaderOptions {
   explicit FullDataLoaderOptions(DataLoaderOptions options)
       : batch_size(options.batch_size()),
         workers(options.workers()),
-        max_jobs(options.max_jobs().value_or(2 * workers)),
+        max_jobs(
+            options.max_jobs().value_or(options.prefetch_factor() * workers)),
         timeout(options.timeout()),
         enforce_ordering(options.enforce_ordering()),
-        drop_last(options.drop_last()) {}
+        drop_last(options.drop_last()),
+        pin_memory(options.pin_memory() && torch::cuda::is_available()) {}
 
   size_t batch_size;
   size_t workers;
@@ -60,6 +74,7 @@ struct FullDataLoaderOptions {
   optional<std::chrono::milliseconds> timeout;
   bool enforce_ordering;
   bool drop_last;
+  bool pin_memory;
 };
 } // namespace data
 } // namespace torch
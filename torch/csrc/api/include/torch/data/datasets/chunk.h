@@ -3,10 +3,16 @@
 #include <torch/arg.h>
 #include <torch/csrc/utils/memory.h>
 #include <torch/data/datasets/stateful.h>
+#include <torch/data/detail/map_tensors.h>
 #include <torch/data/samplers.h>
+#include <deque>
 #include <queue>
 #include <thread>
 
+#include <c10/core/Event.h>
+#include <c10/core/StreamGuard.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
+
 #include <torch/serialize.h>
 
 namespace torch {
@@ -241,6 +247,165 @@ class BatchDataBuffer {
   // the program to hang. This boolean is used to break this waiting condition.
   bool stop_ = false;
 };
+
+/// DevicePrefetcher copies the batches of a BatchDataBuffer to a device
+/// ahead of time. A dedicated thread takes batches from the buffer, pins their
+/// CPU tensors and copies them to the device on a stream of its own, so that
+/// the copies overlap with the computation on the current stream. Up to
+/// `prefetch_count` batches are kept resident on the device. Every batch
+/// carries an event recorded after its copies; get_batch makes the current
+/// stream of the calling thread wait on that event, so the batch is ready for
+/// use on that stream without synchronizing the host.
+template <
+    typename UnwrappedBatch,
+    typename ExampleSampler = samplers::RandomSampler>
+class DevicePrefetcher {
+ public:
+  using UnwrappedBatchType = UnwrappedBatch;
+  using BatchType = torch::optional<UnwrappedBatchType>;
+
+  DevicePrefetcher(
+      BatchDataBuffer<UnwrappedBatchType, ExampleSampler>& batch_buffer,
+      Device device,
+      size_t prefetch_count)
+      : batch_buffer_(batch_buffer),
+        device_(device),
+        impl_(device.type()),
+        stream_(impl_.getStreamFromPool(device)),
+        prefetch_count_(prefetch_count) {
+    prefetch_thread_ = std::thread([this] { this->prefetch(); });
+  }
+
+  ~DevicePrefetcher() {
+    stop();
+    prefetch_thread_.join();
+  }
+
+  /// Return the next batch, already copied to the device. Called from the
+  /// ChunkDataset main thread.
+  BatchType get_batch() {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    cv_read_.wait(
+        lock, [this] { return !this->batch_queue_.empty() || this->stop_; });
+    if (batch_queue_.empty() ||
+        (!batch_queue_.front().batch && !batch_queue_.front().exception)) {
+      // Stopped, or the batch buffer is exhausted. Keep the end marker for
+      // further calls.
+      return nullopt;
+    }
+    PrefetchedBatch prefetched = std::move(batch_queue_.front());
+    batch_queue_.pop_front();
+    lock.unlock();
+    cv_write_.notify_all();
+
+    if (prefetched.exception) {
+      std::rethrow_exception(prefetched.exception);
+    }
+
+    // Hand the batch over to the current stream: the stream waits for the
+    // copies, and the caching allocator must not reuse the memory of the
+    // batch before the work queued on that stream is done.
+    const Stream stream = impl_.getStream(device_);
+    prefetched.ready.block(stream);
+    return torch::data::detail::map_tensors(
+        std::move(prefetched.batch), [this, &stream](Tensor tensor) {
+          if (tensor.defined() && tensor.device() == this->device_) {
+            this->impl_.recordDataPtrOnStream(
+                tensor.storage().data_ptr(), stream);
+          }
+          return tensor;
+        });
+  }
+
+  /// Wakes up the prefetching thread and makes it exit. The batch buffer must
+  /// be stopped too if the thread may be waiting for it.
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      stop_ = true;
+    }
+    cv_write_.notify_all();
+    cv_read_.notify_all();
+  }
+
+ private:
+  /// A batch copied to the device, or the exception thrown while loading it.
+  /// An entry with neither marks the end of the epoch.
+  struct PrefetchedBatch {
+    explicit PrefetchedBatch(DeviceType device_type) : ready(device_type) {}
+
+    BatchType batch;
+    std::exception_ptr exception;
+    c10::Event ready;
+  };
+
+  /// Runs on the prefetching thread.
+  void prefetch() {
+    c10::StreamGuard stream_guard(stream_);
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        cv_write_.wait(lock, [this] {
+          return this->batch_queue_.size() < this->prefetch_count_ ||
+              this->stop_;
+        });
+        if (stop_) {
+          return;
+        }
+      }
+
+      PrefetchedBatch prefetched(device_.type());
+      try {
+        prefetched.batch = torch::data::detail::map_tensors(
+            batch_buffer_.get_batch(), [this](Tensor tensor) {
+              if (tensor.defined() && tensor.device().is_cpu()) {
+                // Copies from pinned memory don't block the host.
+                return tensor.pin_memory().to(
+                    this->device_, /*non_blocking=*/true);
+              }
+              return tensor;
+            });
+        prefetched.ready.record(stream_);
+      } catch (...) {
+        prefetched.exception = std::current_exception();
+      }
+      const bool exhausted = !prefetched.batch && !prefetched.exception;
+
+      {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        batch_queue_.push_back(std::move(prefetched));
+      }
+      cv_read_.notify_all();
+      if (exhausted) {
+        return;
+      }
+    }
+  }
+
+  BatchDataBuffer<UnwrappedBatchType, ExampleSampler>& batch_buffer_;
+
+  /// The device to copy the batches to, and the stream the copies run on.
+  const Device device_;
+  const c10::impl::VirtualGuardImpl impl_;
+  const Stream stream_;
+
+  /// The maximum number of batches resident on the device.
+  const size_t prefetch_count_;
+
+  /// Batches copied to the device, in the order of the batch buffer.
+  std::deque<PrefetchedBatch> batch_queue_;
+
+  // sync batch_queue_ and stop_.
+  std::mutex queue_mutex_;
+
+  std::condition_variable cv_read_;
+  std::condition_variable cv_write_;
+
+  // When set to true, the prefetching thread exits.
+  bool stop_ = false;
+
+  std::thread prefetch_thread_;
+};
 } // namespace detail
 
 /// Options to configure a `ChunkDataset`.
@@ -292,6 +457,15 @@ struct ChunkDatasetOptions {
   // penalty when this value is greater than 1, as we need to do extra merge
   // between multiple chunks before performing example sampling.
   TORCH_ARG(size_t, cross_chunk_shuffle_count) = 1;
+
+  // The device to copy batches to ahead of time. If set, `get_batch` returns
+  // batches whose tensors already live on this device, copied on a dedicated
+  // stream while the previous batches are being used. See
+  // `detail::DevicePrefetcher`.
+  TORCH_ARG(optional<Device>, device) = nullopt;
+
+  // The number of batches to keep ready on `device`.
+  TORCH_ARG(size_t, device_prefetch_count) = 2;
 };
 
 /// A stateful dataset that support hierarchical sampling and prefetching of
@@ -332,13 +506,24 @@ class ChunkDataset final
         preprocessing_policy_(preprocessing_policy),
         quit_worker_(false),
         running_preloaders_(0),
-        load_checkpoint_(false) {}
+        load_checkpoint_(false) {
+    if (options_.device()) {
+      TORCH_CHECK(
+          !options_.device()->is_cpu(),
+          "Batches can only be prefetched to non-CPU devices.");
+      TORCH_CHECK(
+          options_.device_prefetch_count() > 0,
+          "device_prefetch_count is 0. At least one batch needs to be "
+          "prefetched to the device.");
+    }
+  }
 
   virtual ~ChunkDataset() {
     // stop batch buffer first.
     if (batch_buffer_) {
       batch_buffer_->stop();
     }
+    device_prefetcher_.reset();
     free_workers();
   }
 
@@ -356,6 +541,9 @@ class ChunkDataset final
       "The requested batch size does not match with the initialized batch size.\n"
       " The requested batch size is ", batch_size,
       ", while the dataset is created with batch size equal to ", options_.batch_size());
+    if (device_prefetcher_) {
+      return device_prefetcher_->get_batch();
+    }
     return batch_buffer_->get_batch();
   }
 
@@ -371,6 +559,9 @@ class ChunkDataset final
     if (batch_buffer_) {
       batch_buffer_->stop();
     }
+    // the prefetcher may be waiting on the batch buffer, so stop it after the
+    // buffer.
+    device_prefetcher_.reset();
     // free workers from previous reset if there is any.
     free_workers();
     preload_threads_.clear();
@@ -389,6 +580,14 @@ class ChunkDataset final
         example_sampler_,
         options_.cache_size());
 
+    if (options_.device()) {
+      device_prefetcher_ = torch::make_unique<
+          detail::DevicePrefetcher<UnwrappedBatchType, ExampleSamplerType>>(
+          *batch_buffer_,
+          *options_.device(),
+          options_.device_prefetch_count());
+    }
+
     // create new workers for this new epoch.
     quit_worker_ = false;
 
@@ -485,6 +684,11 @@ class ChunkDataset final
   std::shared_ptr<detail::BatchDataBuffer<UnwrappedBatchType, ExampleSamplerType>>
       batch_buffer_;
 
+  // copies batches from batch_buffer_ to options_.device(), if it is set.
+  std::unique_ptr<
+      detail::DevicePrefetcher<UnwrappedBatchType, ExampleSamplerType>>
+      device_prefetcher_;
+
   // worker thread pool
   std::vector<std::thread> preload_threads_;
 
@@ -96,6 +96,20 @@ class MapDataset : public BatchDataset<
   AppliedTransform transform_;
 };
 
+namespace detail {
+/// The batch type of a dataset, unwrapped from the `optional` of the stateful
+/// datasets. Only stateful batch types are required to have a `value_type`.
+template <typename DatasetType, bool = DatasetType::is_stateful>
+struct UnwrappedBatch {
+  using type = typename DatasetType::BatchType;
+};
+
+template <typename DatasetType>
+struct UnwrappedBatch<DatasetType, true> {
+  using type = typename DatasetType::BatchType::value_type;
+};
+} // namespace detail
+
 /// Creates a `MapDataset` with the given dataset and transform.
 template <typename DatasetType, typename TransformType>
 MapDataset<DatasetType, TransformType> map(
@@ -103,10 +117,7 @@ MapDataset<DatasetType, TransformType> map(
     TransformType transform) {
   static_assert(
       std::is_same<
-          typename std::conditional<
-              DatasetType::is_stateful,
-              typename DatasetType::BatchType::value_type,
-              typename DatasetType::BatchType>::type,
+          typename detail::UnwrappedBatch<DatasetType>::type,
           typename TransformType::InputBatchType>::value,
       "BatchType type of dataset does not match input type of transform");
   return {std::move(dataset), std::move(transform)};
@@ -22,9 +22,15 @@ namespace detail {
 /// dequeues a result is the count of in-flight jobs decremented. When the main
 /// thread attempts to dequeue a job but no jobs are in-flight, that means the
 /// epoch is complete and `pop_result` returns an empty optional.
+///
+/// Jobs and results are passed through bounded lock-free queues, which must be
+/// able to hold all jobs that are in flight at the same time.
 template <typename Job, typename Result>
 class DataShuttle {
  public:
+  explicit DataShuttle(size_t capacity = kDefaultCapacity)
+      : new_jobs_(capacity), results_(capacity) {}
+
   /// Pushes a new job. Called by the main thread.
   void push_job(Job job) {
     new_jobs_.push(std::move(job));
@@ -73,13 +79,15 @@ class DataShuttle {
   }
 
  private:
+  static constexpr size_t kDefaultCapacity = 64;
+
   /// The queue for jobs that are not yet in flight.
-  Queue<Job> new_jobs_;
+  BoundedQueue<Job> new_jobs_;
   /// The number of in-flight jobs.
   /// NOTE: Not atomic because only manipulated by the main thread.
   size_t in_flight_jobs_ = 0;
   /// The queue for results of finished jobs.
-  Queue<Result> results_;
+  BoundedQueue<Result> results_;
 };
 
 } // namespace detail
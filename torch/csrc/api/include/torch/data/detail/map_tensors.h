@@ -0,0 +1,72 @@
+#pragma once
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// Applies `fn` to the tensors of a batch and returns the batch made of the
+/// results. Tensors can be wrapped in `Example`s, `std::vector`s and
+/// `optional`s; batches of any other type are returned unchanged.
+template <typename F>
+Tensor map_tensors(Tensor tensor, const F& fn);
+template <typename Data, typename Target, typename F>
+Example<Data, Target> map_tensors(Example<Data, Target> example, const F& fn);
+template <typename Data, typename F>
+Example<Data, example::NoTarget> map_tensors(
+    Example<Data, example::NoTarget> example,
+    const F& fn);
+template <typename T, typename F>
+std::vector<T> map_tensors(std::vector<T> batch, const F& fn);
+template <typename T, typename F>
+optional<T> map_tensors(optional<T> batch, const F& fn);
+template <typename T, typename F>
+T map_tensors(T batch, const F& fn);
+
+template <typename F>
+Tensor map_tensors(Tensor tensor, const F& fn) {
+  return fn(std::move(tensor));
+}
+
+template <typename Data, typename Target, typename F>
+Example<Data, Target> map_tensors(Example<Data, Target> example, const F& fn) {
+  return {map_tensors(std::move(example.data), fn),
+          map_tensors(std::move(example.target), fn)};
+}
+
+template <typename Data, typename F>
+Example<Data, example::NoTarget> map_tensors(
+    Example<Data, example::NoTarget> example,
+    const F& fn) {
+  return {map_tensors(std::move(example.data), fn)};
+}
+
+template <typename T, typename F>
+std::vector<T> map_tensors(std::vector<T> batch, const F& fn) {
+  for (auto& element : batch) {
+    element = map_tensors(std::move(element), fn);
+  }
+  return batch;
+}
+
+template <typename T, typename F>
+optional<T> map_tensors(optional<T> batch, const F& fn) {
+  if (batch) {
+    return map_tensors(std::move(*batch), fn);
+  }
+  return batch;
+}
+
+template <typename T, typename F>
+T map_tensors(T batch, const F& fn) {
+  return batch;
+}
+
+} // namespace detail
+} // namespace data
+} // namespace torch
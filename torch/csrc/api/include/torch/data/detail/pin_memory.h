@@ -0,0 +1,63 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/data/detail/map_tensors.h>
+#include <torch/types.h>
+
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// Copies `tensors` into a single pinned buffer, each at an aligned offset, and
+/// returns contiguous views of that buffer. One pinned allocation serves the
+/// whole batch, and the caching host allocator recycles it once every view and
+/// every asynchronous copy reading it are gone.
+TORCH_API std::vector<Tensor> pin_packed(ArrayRef<Tensor> tensors);
+
+/// Copies the CPU `tensors` to `device` by packing them into one pinned buffer
+/// and copying it asynchronously in one go, on a stream of the device's pool.
+/// Returns contiguous views of a single device buffer. The current stream of
+/// the device waits for the copy, and the buffer is recorded on that stream, so
+/// the tensors are ready to use on it.
+TORCH_API std::vector<Tensor> to_device_packed(
+    ArrayRef<Tensor> tensors,
+    Device device);
+
+/// Replaces the defined CPU tensors of a batch with `fn` applied to all of them
+/// at once. See `map_tensors()` for the batch types whose tensors are found.
+template <typename Batch, typename F>
+Batch map_cpu_tensors_packed(Batch batch, const F& fn) {
+  std::vector<Tensor> tensors;
+  batch = map_tensors(std::move(batch), [&tensors](Tensor tensor) {
+    if (tensor.defined() && tensor.device().is_cpu()) {
+      tensors.push_back(tensor);
+    }
+    return tensor;
+  });
+  if (tensors.empty()) {
+    return batch;
+  }
+  const std::vector<Tensor> results = fn(tensors);
+  size_t next = 0;
+  return map_tensors(std::move(batch), [&results, &next](Tensor tensor) {
+    if (tensor.defined() && tensor.device().is_cpu()) {
+      return results[next++];
+    }
+    return tensor;
+  });
+}
+
+/// Copies the CPU tensors of a batch into pinned memory, all in one pinned
+/// buffer. See `map_tensors()` for the batch types whose tensors are found.
+template <typename Batch>
+Batch pin_batch(Batch batch) {
+  return map_cpu_tensors_packed(
+      std::move(batch), [](ArrayRef<Tensor> tensors) { return pin_packed(tensors); });
+}
+
+} // namespace detail
+} // namespace data
+} // namespace torch
@@ -4,11 +4,14 @@
 
 #include <c10/util/Exception.h>
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <cstddef>
+#include <memory>
 #include <mutex>
 #include <queue>
+#include <thread>
 
 namespace torch {
 namespace data {
@@ -79,6 +82,198 @@ class Queue {
   std::mutex mutex_;
   std::condition_variable cv_;
 };
+
+/// A bounded, blocking MPMC queue that doesn't take a lock to push or pop.
+///
+/// The elements live in a ring of `capacity` slots (rounded up to a power of
+/// two, and at least two). Every slot carries a sequence number that tells producers and
+/// consumers whether it is free for the current lap of the ring, so threads
+/// only contend on the atomic head and tail counters. A thread that finds the
+/// queue empty (when popping) or full (when pushing) spins for a while and
+/// then sleeps on a condition variable; the mutex is only taken when there are
+/// sleeping threads to wake up.
+///
+/// It has the same interface as `Queue` and is likewise tailored to the
+/// `DataLoader`, which bounds the number of jobs in flight.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(size_t capacity)
+      : capacity_(round_up_to_power_of_two(capacity)),
+        slots_(new Slot[capacity_]) {
+    for (size_t i = 0; i < capacity_; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /// Pushes a new value to the back of the `BoundedQueue`, blocking while the
+  /// queue is full, and wakes up threads waiting inside a call to `pop()`.
+  void push(T value) {
+    wait_until(nullopt, [this, &value] { return try_push(value); });
+  }
+
+  /// Blocks until at least one element is ready to be popped from the front of
+  /// the queue. An optional `timeout` in seconds can be used to limit the time
+  /// spent waiting for an element. If the wait times out, an exception is
+  /// raised.
+  T pop(optional<std::chrono::milliseconds> timeout = nullopt) {
+    optional<T> value;
+    if (!wait_until(timeout, [this, &value] { return try_pop(value); })) {
+      // clang-format off
+      AT_ERROR(
+          "Timeout in DataLoader queue while waiting for next batch"
+          " (timeout was ", timeout->count(), " ms)");
+      // clang-format on
+    }
+    return std::move(*value);
+  }
+
+  /// Empties the queue and returns the number of elements that were popped.
+  /// As for `Queue`, this is assumed to be used to drain the queue during
+  /// shutdown of a `DataLoader`.
+  size_t clear() {
+    size_t size = 0;
+    optional<T> value;
+    while (try_pop(value)) {
+      value.reset();
+      ++size;
+    }
+    if (size > 0) {
+      notify_waiters();
+    }
+    return size;
+  }
+
+  size_t capacity() const noexcept {
+    return capacity_;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    optional<T> value;
+  };
+
+  static size_t round_up_to_power_of_two(size_t n) {
+    // With a single slot, a free and a full slot would have the same
+    // sequence number.
+    size_t result = 2;
+    while (result < n) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  /// Moves `value` into the slot at the tail, or returns false if the queue
+  /// is full. The slot at position `pos` is free for this lap if its sequence
+  /// is `pos`, and holds an element once its sequence is `pos + 1`.
+  bool try_push(T& value) {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      Slot& slot = slots_[pos & (capacity_ - 1)];
+      const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(sequence) -
+          static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          slot.value = std::move(value);
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Moves the element at the head into `value`, or returns false if the
+  /// queue is empty. Popping frees the slot for the next lap.
+  bool try_pop(optional<T>& value) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    while (true) {
+      Slot& slot = slots_[pos & (capacity_ - 1)];
+      const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(sequence) -
+          static_cast<std::ptrdiff_t>(pos + 1);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          value = std::move(slot.value);
+          slot.value.reset();
+          slot.sequence.store(pos + capacity_, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Retries `attempt` until it succeeds, first spinning and then sleeping
+  /// until another thread pushes or pops. Returns false if `timeout` expired.
+  template <typename Attempt>
+  bool wait_until(
+      optional<std::chrono::milliseconds> timeout,
+      const Attempt& attempt) {
+    for (int spin = 0; spin < kSpinCount; ++spin) {
+      if (attempt()) {
+        notify_waiters();
+        return true;
+      }
+      std::this_thread::yield();
+    }
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      waiters_.fetch_add(1);
+      // Pairs with the fence in notify_waiters(): either our retry below sees
+      // the other thread's push or pop, or it sees us waiting and wakes us.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      bool success = true;
+      if (timeout) {
+        success = cv_.wait_for(lock, *timeout, attempt);
+      } else {
+        cv_.wait(lock, attempt);
+      }
+      waiters_.fetch_sub(1);
+      if (!success) {
+        return false;
+      }
+    }
+    notify_waiters();
+    return true;
+  }
+
+  /// Wakes up sleeping threads, which may be waiting either for an element
+  /// or for a free slot.
+  void notify_waiters() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) > 0) {
+      // Taking the lock ensures a waiter is either before its retry or already
+      // inside wait(), so the notification can't be lost.
+      { std::lock_guard<std::mutex> lock(mutex_); }
+      cv_.notify_all();
+    }
+  }
+
+  static constexpr int kSpinCount = 64;
+
+  const size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  /// Head and tail are padded to separate cache lines, so that producers and
+  /// consumers don't invalidate each other's counter.
+  std::atomic<size_t> head_{0};
+  char head_padding_[64 - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> tail_{0};
+  char tail_padding_[64 - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> waiters_{0};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
 } // namespace detail
 } // namespace data
 } // namespace torch
@@ -4,6 +4,7 @@
 #include <torch/data/samplers/base.h>
 
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace torch {
@@ -96,6 +97,65 @@ class TORCH_API DistributedRandomSampler : public DistributedSampler<> {
   std::vector<size_t> all_indices_;
 };
 
+/// Select samples randomly, like `DistributedRandomSampler`, but without
+/// materializing the indices of the dataset: the sampling order is a
+/// bijective shuffle of `[0, size)`, seeded with `seed` and the epoch, which
+/// computes every index on the fly with O(1) memory.
+///
+/// The shuffled order is shared by all replicas, and replica `rank` draws
+/// every `num_replicas`-th sample of it. To keep the accesses of each replica
+/// local, e.g. when a `ChunkDataset` stores `block_size` consecutive examples
+/// per chunk, the shuffle permutes blocks of `block_size` consecutive
+/// indices, and the indices within each block. A replica then draws
+/// `block_size / num_replicas` consecutive samples from the same block.
+///
+/// As all replicas draw the same number of samples, what is left of the epoch
+/// is known from the state of any of them. `save()` and `load()`, as well as
+/// `set_replicas()`, distribute it among any number of replicas, so training
+/// can resume exactly with another world size.
+class TORCH_API DistributedStreamingRandomSampler : public DistributedSampler<> {
+ public:
+  DistributedStreamingRandomSampler(
+      size_t size,
+      size_t num_replicas = 1,
+      size_t rank = 0,
+      bool allow_duplicates = true,
+      size_t block_size = 1,
+      uint64_t seed = 0);
+
+  /// Resets the `DistributedStreamingRandomSampler` to the start of an epoch.
+  void reset(optional<size_t> new_size = nullopt) override;
+
+  /// Returns the next batch of indices.
+  optional<std::vector<size_t>> next(size_t batch_size) override;
+
+  /// Changes the number of replicas and the rank of this one. The samples
+  /// left in the current epoch are distributed among the new replicas.
+  void set_replicas(size_t num_replicas, size_t rank);
+
+  /// Serializes the `DistributedStreamingRandomSampler` to the `archive`.
+  void save(serialize::OutputArchive& archive) const override;
+
+  /// Deserializes the `DistributedStreamingRandomSampler` from the `archive`,
+  /// which may have been saved with another number of replicas.
+  void load(serialize::InputArchive& archive) override;
+
+  /// Returns the number of samples of the current epoch drawn by all
+  /// replicas.
+  size_t index() const noexcept;
+
+ private:
+  size_t local_samples_left() const;
+  size_t sample(size_t position, uint64_t key) const;
+
+  size_t block_size_;
+  uint64_t seed_;
+  // The position in the shuffled order of the first sample not drawn by any
+  // replica when this one drew its first `sample_index_` samples
+  size_t begin_index_;
+  size_t sample_index_;
+};
+
 /// Select samples sequentially.
 class TORCH_API DistributedSequentialSampler : public DistributedSampler<> {
  public:
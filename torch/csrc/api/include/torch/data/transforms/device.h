@@ -0,0 +1,58 @@
+#pragma once
+
+#include <torch/data/detail/pin_memory.h>
+#include <torch/data/example.h>
+#include <torch/data/transforms/base.h>
+#include <torch/types.h>
+
+#include <utility>
+
+namespace torch {
+namespace data {
+namespace transforms {
+
+/// A `BatchTransform` that copies the CPU tensors of each batch into a single
+/// pinned buffer, so that they can be copied to a device asynchronously.
+/// Batches can be any type `map_tensors()` looks into, e.g. the `Example` made
+/// by `Stack`.
+template <typename Batch = Example<>>
+struct PinMemory : public BatchTransform<Batch, Batch> {
+  Batch apply_batch(Batch batch) override {
+    return torch::data::detail::pin_batch(std::move(batch));
+  }
+};
+
+/// A `BatchTransform` that copies the CPU tensors of each batch to a device.
+/// All the tensors of a batch are packed into one pinned buffer and moved with
+/// a single asynchronous copy on a transfer stream; the returned tensors are
+/// views of one device buffer, ready to use on the current stream.
+///
+/// \rst
+/// .. code-block:: cpp
+///
+///   auto dataset = MyDataset()
+///                      .map(torch::data::transforms::Stack<>())
+///                      .map(torch::data::transforms::ToDevice<>(torch::kCUDA));
+/// \endrst
+template <typename Batch = Example<>>
+class ToDevice : public BatchTransform<Batch, Batch> {
+ public:
+  explicit ToDevice(Device device) : device_(device) {}
+
+  Batch apply_batch(Batch batch) override {
+    if (device_.is_cpu()) {
+      return batch;
+    }
+    return torch::data::detail::map_cpu_tensors_packed(
+        std::move(batch), [this](ArrayRef<Tensor> tensors) {
+          return torch::data::detail::to_device_packed(tensors, this->device_);
+        });
+  }
+
+ private:
+  Device device_;
+};
+
+} // namespace transforms
+} // namespace data
+} // namespace torch
@@ -95,6 +95,7 @@ class Cloneable : public virtual Module {
         "Attempted to clone submodule, but it is of a "
         "different type than the submodule it was to be cloned into");
     static_cast<Derived&>(*this) = std::move(*clone);
+    invalidate_cached_parameters();
   }
 };
 
@@ -801,6 +801,31 @@ inline std::tuple<Tensor, Tensor> multi_head_attention_forward(
         }, /*dim=*/1);
     }
   }
+  // Without the weights to return or dropout to apply to them, the fused
+  // kernel computes the output without materializing the weights.
+  if (!need_weights && (dropout_p == 0 || !training) &&
+      !(attn_mask_.defined() &&
+        (attn_mask_.requires_grad() || attn_mask_.scalar_type() != q.scalar_type()))) {
+    Tensor mask;
+    if (attn_mask_.defined()) {
+      mask = attn_mask_.reshape({1, 1, tgt_len, src_len});
+    }
+    if (key_padding_mask_.defined()) {
+      auto padding_mask = torch::zeros({bsz, 1, 1, src_len}, q.options()).masked_fill(
+        key_padding_mask_.view({bsz, 1, 1, src_len}),
+        -std::numeric_limits<double>::infinity());
+      mask = mask.defined() ? mask + padding_mask : padding_mask;
+    }
+    // q is already scaled
+    auto attn_output = std::get<0>(torch::_scaled_dot_product_attention(
+      q.view({bsz, num_heads, tgt_len, head_dim}),
+      k.view({bsz, num_heads, src_len, head_dim}),
+      v.view({bsz, num_heads, src_len, head_dim}),
+      mask, /*is_causal=*/false, /*scale=*/1.0));
+    attn_output = attn_output.permute({2, 0, 1, 3}).reshape({tgt_len, bsz, embed_dim});
+    attn_output = F::linear(attn_output, out_proj_weight, out_proj_bias);
+    return std::make_tuple(attn_output, Tensor());
+  }
   auto attn_output_weights = torch::bmm(q, k.transpose(1, 2));
   TORCH_CHECK(attn_output_weights.sizes() == IntArrayRef({bsz * num_heads, tgt_len, src_len}));
   if (attn_mask_.defined()) {
@@ -840,6 +840,15 @@ inline Tensor cross_entropy(
       enumtype::get_enum_name(reduction),
       " is not valid");
   }
+  if (input.dim() == 2) {
+    // doesn't keep the log-probabilities for the backward
+    return torch::log_softmax_nll_loss(
+      input,
+      target,
+      weight,
+      enumtype::reduction_get_enum(reduction_),
+      ignore_index);
+  }
   return torch::nn::functional::detail::nll_loss(
     torch::nn::functional::detail::log_softmax(input, 1, c10::nullopt),
     target,
@@ -56,6 +56,17 @@ inline Tensor layer_norm(const Tensor& input,
                          double eps) {
     return torch::layer_norm(input, normalized_shape, weight, bias, eps);
 }
+
+inline Tensor add_layer_norm(const Tensor& input,
+                             const Tensor& residual,
+                             const std::vector<int64_t>& normalized_shape,
+                             const Tensor& weight,
+                             const Tensor& bias,
+                             double eps,
+                             double p,
+                             bool training) {
+    return torch::add_layer_norm(input, residual, normalized_shape, weight, bias, eps, p, training);
+}
 } // namespace detail
 #endif /* DOXYGEN_SHOULD_SKIP_THIS */
 
@@ -13,6 +13,7 @@
 #include <iosfwd>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <type_traits>
 
@@ -205,6 +206,10 @@ class TORCH_API Module : public std::enable_shared_from_this<Module> {
 
   /// Returns the parameters of this `Module` and if `recurse` is true, also
   /// recursively of every submodule.
+  ///
+  /// The recursive lists of parameters and buffers are cached, and only built
+  /// again once a parameter, buffer or submodule was registered, replaced or
+  /// unregistered in any `Module`.
   std::vector<Tensor> parameters(bool recurse = true) const;
 
   /// Returns an `OrderedDict` with the parameters of this `Module` along with
@@ -219,6 +224,26 @@ class TORCH_API Module : public std::enable_shared_from_this<Module> {
   /// their keys, and if `recurse` is true also recursively of every submodule.
   OrderedDict<std::string, Tensor> named_buffers(bool recurse = true) const;
 
+  /// Moves the parameters of this `Module` and of every submodule into one
+  /// contiguous buffer per device and dtype, each parameter becoming a view of
+  /// its buffer in the order of `parameters()`, and gives them gradients which
+  /// are views of a gradient buffer laid out the same way. Returns the
+  /// parameter buffers, whose `grad()` is their gradient buffer, so that an
+  /// optimizer, `zero_grad()` or `broadcast_coalesced` can sweep all the
+  /// parameters at once.
+  ///
+  /// The gradients are accumulated in place into their buffer by `backward()`.
+  /// Moving the module with `to()`, or assigning new gradients to its
+  /// parameters, takes them out of the buffers.
+  ///
+  /// \rst
+  /// .. code-block:: cpp
+  ///
+  ///   auto flat_parameters = model->flatten_parameter_storage();
+  ///   torch::optim::SGD optimizer(flat_parameters, /*lr=*/0.1);
+  /// \endrst
+  std::vector<Tensor> flatten_parameter_storage();
+
   /// Returns the submodules of this `Module` (the entire submodule hierarchy)
   /// and if `include_self` is true, also inserts a `shared_ptr` to this module
   /// in the first position.
@@ -538,6 +563,11 @@ class TORCH_API Module : public std::enable_shared_from_this<Module> {
       "`FORWARD_HAS_DEFAULT_ARGS` macro to do so.");
   }
 
+  /// Invalidates the recursive lists of parameters and buffers cached by every
+  /// `Module`, since a module doesn't know the modules containing it. Called
+  /// whenever `parameters_`, `buffers_` or `children_` is changed.
+  static void invalidate_cached_parameters();
+
   /// The registered parameters of this `Module`.
   /// Inorder to access parameters_ in ParameterDict and ParameterList
   OrderedDict<std::string, Tensor> parameters_;
@@ -584,6 +614,11 @@ class TORCH_API Module : public std::enable_shared_from_this<Module> {
       const NamedModulePointerApplyFunction& function,
       const std::string& name_prefix = std::string()) const;
 
+  /// Builds the cached recursive lists of parameters or buffers again if a
+  /// module hierarchy changed since. Called with the cache locked.
+  void update_cached_parameters() const;
+  void update_cached_buffers() const;
+
   /// Returns a shared_ptr to `this` in a safe (checked) way.
   std::shared_ptr<Module> shared_from_this_checked() const;
 
@@ -598,6 +633,30 @@ class TORCH_API Module : public std::enable_shared_from_this<Module> {
 
   /// Whether the module is in training mode.
   bool is_training_{true};
+
+  /// The recursive lists of parameters and buffers built by the last calls to
+  /// `named_parameters()` and `named_buffers()`, along with the version of the
+  /// module hierarchies they were built at. The copies of a `Module` start
+  /// without them.
+  struct RecursiveCache {
+    RecursiveCache() = default;
+    RecursiveCache(const RecursiveCache&) {}
+    RecursiveCache& operator=(const RecursiveCache&) {
+      std::lock_guard<std::mutex> guard(mutex);
+      parameters_version = 0;
+      buffers_version = 0;
+      return *this;
+    }
+
+    std::mutex mutex;
+    uint64_t parameters_version = 0;
+    OrderedDict<std::string, Tensor> named_parameters;
+    std::vector<Tensor> parameters;
+    uint64_t buffers_version = 0;
+    OrderedDict<std::string, Tensor> named_buffers;
+    std::vector<Tensor> buffers;
+  };
+  mutable RecursiveCache recursive_cache_;
 };
 
 /// Serialize a `Module` pointer into an `OutputArchive`.
@@ -647,6 +706,7 @@ std::shared_ptr<ModuleType> Module::register_module(
       name,
       "')");
   auto& base_module = children_.insert(std::move(name), std::move(module));
+  invalidate_cached_parameters();
   return std::dynamic_pointer_cast<ModuleType>(base_module);
 }
 
@@ -662,6 +722,7 @@ std::shared_ptr<ModuleType> Module::replace_module(
     const std::string& name,
     std::shared_ptr<ModuleType> module) {
   auto& base_module = (children_[name] = std::move(module));
+  invalidate_cached_parameters();
   return std::dynamic_pointer_cast<ModuleType>(base_module);
 }
 
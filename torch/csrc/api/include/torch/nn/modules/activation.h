@@ -781,6 +781,51 @@ TORCH_MODULE(Threshold);
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~ MultiheadAttention ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+/// The keys and values a `MultiheadAttention` projected for the positions
+/// decoded so far, kept across the calls to
+/// `MultiheadAttentionImpl::forward_incremental` so that each decoding step
+/// only projects its new positions and attends from them. The buffers hold
+/// `capacity` positions up front and double when they are full, each step
+/// writing its keys and values in place.
+struct TORCH_API MultiheadAttentionCache {
+  explicit MultiheadAttentionCache(int64_t capacity = 16) : capacity(capacity) {}
+
+  /// The keys of the cached positions, of shape
+  /// (batch, num_heads, length, head_dim).
+  Tensor keys() const;
+
+  /// The values of the cached positions, of shape
+  /// (batch, num_heads, length, head_dim).
+  Tensor values() const;
+
+  /// Appends the keys and values of new positions, of shape
+  /// (batch, num_heads, new_length, head_dim).
+  void append(const Tensor& new_keys, const Tensor& new_values);
+
+  /// Keeps the entries of the batch given by `index`, e.g. the hypotheses a
+  /// beam search carries over to its next step.
+  void reorder(const Tensor& index);
+
+  /// Drops the cached positions, keeping the buffers.
+  void clear() {
+    length = 0;
+  }
+
+  bool empty() const {
+    return length == 0;
+  }
+
+  /// The number of positions the buffers are first allocated for.
+  int64_t capacity;
+
+  /// The number of cached positions.
+  int64_t length = 0;
+
+  /// The buffers, of shape (batch, num_heads, allocated_length, head_dim).
+  Tensor key;
+  Tensor value;
+};
+
 /// Applies the MultiheadAttention function element-wise.
 /// See https://pytorch.org/docs/master/nn.html#torch.nn.MultiheadAttention
 /// to learn about the exact behavior of this module.
@@ -802,6 +847,24 @@ class TORCH_API MultiheadAttentionImpl
   std::tuple<Tensor, Tensor> forward(const Tensor& query, const Tensor& key,
                  const Tensor& value, const Tensor& key_padding_mask = {},
                  bool need_weights = true, const Tensor& attn_mask = {});
+
+  /// Attends from the new positions `query`, of shape
+  /// (new_length, batch, embed_dim), through the keys and values kept in
+  /// `cache`, for decoding one step at a time.
+  ///
+  /// Unless `static_kv`, `key` and `value` are the new positions of the
+  /// sequence attended to, appended to the cache, and each new position
+  /// attends to the cached positions and to the new ones up to itself. With
+  /// `static_kv`, e.g. for the encoder memory, `key` and `value` are only
+  /// projected by the first call and the following ones reuse them.
+  ///
+  /// `key_padding_mask` is of shape (batch, cache.length) and `attn_mask` of
+  /// shape (new_length, cache.length), the length after the new positions
+  /// are appended. Bias keys and values and zero attention aren't supported.
+  Tensor forward_incremental(const Tensor& query, const Tensor& key,
+                 const Tensor& value, MultiheadAttentionCache& cache,
+                 bool static_kv = false, const Tensor& key_padding_mask = {},
+                 const Tensor& attn_mask = {});
  protected:
   FORWARD_HAS_DEFAULT_ARGS({3, AnyValue(Tensor())}, {4, AnyValue(true)}, {5, AnyValue(Tensor())})
 
@@ -49,6 +49,7 @@ class ParameterDictImpl : public Cloneable<ParameterDictImpl> {
   Tensor pop(const std::string& key) {
     torch::Tensor v = parameters_[key];
     parameters_.erase(key);
+    invalidate_cached_parameters();
     return v;
   }
 
@@ -64,6 +65,7 @@ class ParameterDictImpl : public Cloneable<ParameterDictImpl> {
 
   /// Return an iterator to the start of ParameterDict
   Iterator begin() {
+    invalidate_cached_parameters();
     return parameters_.begin();
   }
 
@@ -99,11 +101,13 @@ class ParameterDictImpl : public Cloneable<ParameterDictImpl> {
     for (auto& item : container) {
       parameters_[item.key()] = item.value();
     }
+    invalidate_cached_parameters();
   }
 
   /// Remove all parameters in the ParameterDict
   void clear() {
     parameters_.clear();
+    invalidate_cached_parameters();
   }
 
   /// Check if the centain parameter with the key in the ParameterDict
@@ -122,6 +126,7 @@ class ParameterDictImpl : public Cloneable<ParameterDictImpl> {
   /// no such key is stored in the `ParameterDict`. Check contains(key) before 
   /// for a non-throwing way of access
   Tensor& get(const std::string& key) {
+    invalidate_cached_parameters();
     return parameters_[key];
   }
 
@@ -129,6 +134,7 @@ class ParameterDictImpl : public Cloneable<ParameterDictImpl> {
   /// no such key is stored in the `ParameterDict`. Check contains(key) before 
   /// for a non-throwing way of access
   Tensor& operator[](const std::string& key) {
+    invalidate_cached_parameters();
     return parameters_[key];
   }
 
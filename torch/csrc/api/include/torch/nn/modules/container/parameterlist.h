@@ -82,6 +82,7 @@ class ParameterListImpl : public Cloneable<ParameterListImpl> {
   /// the iterator returned will be type of `OrderedDict<std::string,
   /// torch::Tensor>::Item`
   Iterator begin() {
+    invalidate_cached_parameters();
     return parameters_.begin();
   }
 
@@ -111,6 +112,7 @@ class ParameterListImpl : public Cloneable<ParameterListImpl> {
   /// for a non-throwing way of access
   at::Tensor& at(size_t idx) {
     TORCH_CHECK(idx < size(), "Index out of range");
+    invalidate_cached_parameters();
     return parameters_[c10::to_string(idx)];
   }
 
@@ -50,6 +50,15 @@ class TORCH_API LayerNormImpl : public torch::nn::Cloneable<LayerNormImpl> {
   /// `Layer Normalization`: https://arxiv.org/abs/1607.06450
   Tensor forward(const Tensor& input);
 
+  /// Applies layer normalization to `residual + dropout(input, dropout_p)`,
+  /// the residual connection of a transformer block. The sum is normalized
+  /// in the same pass over memory on CPU. Dropout is only applied in training
+  /// mode.
+  Tensor forward_residual(
+      const Tensor& input,
+      const Tensor& residual,
+      double dropout_p = 0.);
+
   /// The options with which this module was constructed.
   LayerNormOptions options;
 
@@ -11,6 +11,7 @@
 #include <torch/types.h>
 
 #include <ostream>
+#include <vector>
 
 namespace torch {
 namespace nn {
@@ -71,6 +72,41 @@ TORCH_MODULE(TransformerEncoder);
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ TransformerDecoder ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+/// The attention caches of the layers of a `TransformerDecoder`, filled by
+/// `TransformerDecoderImpl::forward_incremental`.
+///
+/// Example:
+/// ```
+/// TransformerDecoderCache cache(/*capacity=*/max_length);
+/// for (int64_t step = 0; step < max_length; ++step) {
+///   auto out = transformer_decoder->forward_incremental(tgt_step, memory, cache);
+///   ...
+///   // keep the best hypotheses of a beam search
+///   cache.reorder(beam_index);
+/// }
+/// ```
+struct TORCH_API TransformerDecoderCache {
+  explicit TransformerDecoderCache(int64_t capacity = 16) : capacity(capacity) {}
+
+  /// The number of target positions decoded so far.
+  int64_t length() const {
+    return layers.empty() ? 0 : layers.front().self_attn.length;
+  }
+
+  /// Keeps the entries of the batch given by `index`, see
+  /// `MultiheadAttentionCache::reorder`.
+  void reorder(const Tensor& index) {
+    for (auto& layer : layers) {
+      layer.reorder(index);
+    }
+  }
+
+  /// The number of target positions the caches are first allocated for.
+  int64_t capacity;
+
+  std::vector<TransformerDecoderLayerCache> layers;
+};
+
 /// TransformerDecoder is a stack of N decoder layers.
 /// See https://pytorch.org/docs/master/generated/torch.nn.TransformerDecoder.html to
 /// learn abouut the exact behavior of this decoder module
@@ -113,6 +149,24 @@ class TORCH_API TransformerDecoderImpl : public Cloneable<TransformerDecoderImpl
       const Tensor& tgt_key_padding_mask = {},
       const Tensor& memory_key_padding_mask = {});
 
+    /// Pass the new positions of the target through the decoder layers in
+    /// turn, for decoding one step at a time, see
+    /// `TransformerDecoderLayerImpl::forward_incremental`.
+    /// Args:
+    ///       tgt: the new positions of the target, of shape (new_length, batch, d_model) (required).
+    ///       memory: the sequence from the last layer of the encoder (required).
+    ///       cache: the keys and values of the previous calls (required).
+    ///       memory_mask: the mask for the memory sequence, of shape (new_length, memory_length) (optional).
+    ///       tgt_key_padding_mask: the mask for all the tgt keys per batch, cached and new (optional).
+    ///       memory_key_padding_mask: the mask for the memory keys per batch (optional).
+    Tensor forward_incremental(
+      const Tensor& tgt,
+      const Tensor& memory,
+      TransformerDecoderCache& cache,
+      const Tensor& memory_mask = {},
+      const Tensor& tgt_key_padding_mask = {},
+      const Tensor& memory_key_padding_mask = {});
+
     /// The options used to configure this module.
     TransformerDecoderOptions options;
 
@@ -88,6 +88,25 @@ TORCH_MODULE(TransformerEncoderLayer);
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ TransformerDecoderLayer ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+/// The attention caches of a `TransformerDecoderLayer`, filled by
+/// `TransformerDecoderLayerImpl::forward_incremental`: the keys and values of
+/// the target positions decoded so far for the self attention, and those of
+/// the memory for the multi-head attention.
+struct TORCH_API TransformerDecoderLayerCache {
+  explicit TransformerDecoderLayerCache(int64_t capacity = 16)
+    : self_attn(capacity) {}
+
+  /// Keeps the entries of the batch given by `index`, see
+  /// `MultiheadAttentionCache::reorder`.
+  void reorder(const Tensor& index) {
+    self_attn.reorder(index);
+    multihead_attn.reorder(index);
+  }
+
+  MultiheadAttentionCache self_attn;
+  MultiheadAttentionCache multihead_attn;
+};
+
 /// TransformerDecoderLayer is made up of self-attn, multi-head-attn and feedforward network.
 /// This standard decoder layer is based on the paper "Attention Is All You Need".
 /// Ashish Vaswani, Noam Shazeer, Niki Parmar, Jakob Uszkoreit, Llion Jones, Aidan N Gomez,
@@ -129,6 +148,25 @@ class TORCH_API TransformerDecoderLayerImpl : public Cloneable<TransformerDecode
                  const Tensor& tgt_key_padding_mask = {},
                  const Tensor& memory_key_padding_mask = {});
 
+  /// Pass the new positions of the target through the decoder layer, for
+  /// decoding one step at a time. The positions decoded by the previous calls
+  /// are read from `cache`, and each new position attends to them and to the
+  /// new ones up to itself, as `forward` does with a square subsequent
+  /// `tgt_mask`. The memory is only projected by the first call.
+  ///Args:
+  ///       tgt: the new positions of the target, of shape (new_length, batch, d_model) (required).
+  ///       memory: the sequence from the last layer of the encoder (required).
+  ///       cache: the keys and values of the previous calls (required).
+  ///       memory_mask: the mask for the memory sequence, of shape (new_length, memory_length) (optional).
+  ///       tgt_key_padding_mask: the mask for all the tgt keys per batch, cached and new (optional).
+  ///       memory_key_padding_mask: the mask for the memory keys per batch (optional).
+  Tensor forward_incremental(Tensor tgt,
+                 const Tensor& memory,
+                 TransformerDecoderLayerCache& cache,
+                 const Tensor& memory_mask = {},
+                 const Tensor& tgt_key_padding_mask = {},
+                 const Tensor& memory_key_padding_mask = {});
+
   /// The options used to configure this module.
   TransformerDecoderLayerOptions options;
 
@@ -7,17 +7,24 @@
 
 #include <torch/csrc/autograd/functions/comm.h>
 #include <torch/csrc/autograd/functions/utils.h>
+#include <torch/csrc/cuda/comm.h>
 #include <ATen/core/functional.h>
 
 #include <ATen/Device.h>
 #include <ATen/Parallel.h>
+#include <c10/core/DeviceGuard.h>
 #include <c10/core/TensorOptions.h>
 #include <c10/util/Exception.h>
 
+#include <condition_variable>
 #include <cstddef>
+#include <deque>
 #include <exception>
+#include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 namespace torch {
@@ -134,6 +141,77 @@ void replicate_grad_edges(
 
 namespace parallel {
 
+namespace detail {
+
+/// All the CUDA devices.
+inline std::vector<Device> default_devices() {
+  const auto device_count = torch::cuda::device_count();
+  TORCH_CHECK(
+      device_count > 0, "Expected at least one CUDA device to be available");
+  std::vector<Device> devices;
+  devices.reserve(device_count);
+  for (size_t index = 0; index < device_count; ++index) {
+    devices.emplace_back(kCUDA, static_cast<torch::DeviceIndex>(index));
+  }
+  return devices;
+}
+
+/// A thread running the tasks submitted to it one after the other, with its
+/// device set as the current device.
+class DeviceWorker {
+ public:
+  explicit DeviceWorker(Device device)
+      : device_(device), thread_([this] { run(); }) {}
+
+  DeviceWorker(const DeviceWorker&) = delete;
+
+  /// Runs the tasks submitted so far, then joins the thread.
+  ~DeviceWorker() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    condition_.notify_one();
+    thread_.join();
+  }
+
+  void submit(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    condition_.notify_one();
+  }
+
+ private:
+  void run() {
+    c10::DeviceGuard guard(device_);
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  Device device_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<std::function<void()>> tasks_;
+  bool stop_ = false;
+  // last, as it starts running in the constructor
+  std::thread thread_;
+};
+
+} // namespace detail
+
 /// Replicates a module on the given list of devices.
 /// A replica is created by calling `clone()` on the module. For this, the
 /// module must inherit from `nn::Cloneable`, or define its own `clone()`
@@ -250,14 +328,7 @@ Tensor data_parallel(
     optional<Device> output_device = nullopt,
     int64_t dim = 0) {
   if (!devices) {
-    const auto device_count = torch::cuda::device_count();
-    TORCH_CHECK(
-        device_count > 0, "Expected at least one CUDA device to be available");
-    devices = std::vector<Device>();
-    devices->reserve(device_count);
-    for (size_t index = 0; index < device_count; ++index) {
-      devices->emplace_back(kCUDA, static_cast<torch::DeviceIndex>(index));
-    }
+    devices = detail::default_devices();
   }
   if (!output_device) {
     output_device = devices->front();
@@ -283,6 +354,234 @@ Tensor data_parallel(
       .front();
 }
 
+/// Evaluates a module in parallel across devices like `data_parallel()`, but
+/// keeps its replicas from one call to the next instead of cloning the module
+/// in each of them.
+///
+/// The module is moved to the first device, and cloned on the others. Before
+/// each call, the parameters and buffers of the module modified since the
+/// previous one, as told by their version counters, are broadcast to the
+/// replicas. Each replica runs on a thread of its own, kept for the lifetime
+/// of the wrapper, and the outputs are gathered on the thread of the first
+/// device, so that `forward_async()` returns as soon as the inputs are
+/// scattered.
+///
+/// The replicas don't propagate gradients to the module: the calls made with
+/// gradient mode enabled, for a module with parameters requiring a gradient,
+/// go through `data_parallel()` instead.
+///
+/// \rst
+/// .. code-block:: cpp
+///
+///   torch::NoGradGuard no_grad;
+///   torch::nn::parallel::DataParallelModule<Net> model(net);
+///   for (auto& batch : *data_loader) {
+///     auto output = model.forward(batch.data);
+///   }
+/// \endrst
+template <typename ModuleType>
+class DataParallelModule {
+ public:
+  explicit DataParallelModule(
+      std::shared_ptr<ModuleType> module,
+      optional<std::vector<Device>> devices = nullopt,
+      optional<Device> output_device = nullopt,
+      int64_t dim = 0)
+      : module_(std::move(module)),
+        devices_(devices ? std::move(*devices) : detail::default_devices()),
+        output_device_(output_device ? *output_device : devices_.front()),
+        dim_(dim) {
+    TORCH_CHECK(!devices_.empty(), "DataParallelModule expects at least one device");
+    module_->to(devices_.front());
+    replicas_.push_back(module_);
+    for (size_t i = 1; i < devices_.size(); ++i) {
+      TORCH_CHECK(
+          devices_[i].is_cuda(),
+          "DataParallelModule replicates modules on CUDA devices, but got ",
+          devices_[i]);
+      replicas_.push_back(
+          std::dynamic_pointer_cast<ModuleType>(module_->clone(devices_[i])));
+    }
+    for (const auto& replica : replicas_) {
+      replica_tensors_.push_back(module_tensors(*replica));
+    }
+    for (const auto& tensor : replica_tensors_.front()) {
+      synced_.push_back({tensor._version(), tensor.data_ptr()});
+    }
+    for (const auto& device : devices_) {
+      workers_.push_back(std::make_unique<detail::DeviceWorker>(device));
+    }
+  }
+
+  /// Wraps a module holder, such as `Linear`.
+  explicit DataParallelModule(
+      const ModuleHolder<ModuleType>& module,
+      optional<std::vector<Device>> devices = nullopt,
+      optional<Device> output_device = nullopt,
+      int64_t dim = 0)
+      : DataParallelModule(module.ptr(), std::move(devices), output_device, dim) {}
+
+  DataParallelModule(const DataParallelModule&) = delete;
+
+  /// Evaluates the module on the input and waits for the output.
+  Tensor forward(Tensor input) {
+    return forward_async(std::move(input)).get();
+  }
+
+  /// Scatters the input to the replicas and returns a future holding the
+  /// output gathered on the output device, which rethrows the first exception
+  /// thrown by a replica.
+  std::future<Tensor> forward_async(Tensor input) {
+    if (at::GradMode::is_enabled()) {
+      for (const auto& parameter : module_->parameters()) {
+        if (parameter.requires_grad()) {
+          std::promise<Tensor> output;
+          output.set_value(
+              data_parallel(module_, std::move(input), devices_, output_device_, dim_));
+          return output.get_future();
+        }
+      }
+    }
+    sync();
+
+    if (devices_.size() == 1) {
+      const auto output_device = output_device_;
+      return run_on(0, [this, input, output_device] {
+        return replicas_[0]->forward(input.to(devices_[0])).to(output_device);
+      });
+    }
+
+    autograd::Scatter scatter(devices_, /*chunk_sizes=*/nullopt, dim_);
+    auto inputs = fmap<Tensor>(scatter.apply({std::move(input)}));
+    // the input may have fewer chunks than there are devices
+    auto outputs = std::make_shared<std::vector<std::future<Tensor>>>();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      auto replica_input = inputs[i];
+      outputs->push_back(run_on(i, [this, i, replica_input] {
+        return replicas_[i]->forward(replica_input);
+      }));
+    }
+    // the first replica has run by the time its thread gets to the gather
+    const auto output_device = output_device_;
+    const auto dim = dim_;
+    return run_on(0, [outputs, output_device, dim] {
+      autograd::variable_list replica_outputs;
+      replica_outputs.reserve(outputs->size());
+      for (auto& output : *outputs) {
+        replica_outputs.push_back(output.get());
+      }
+      return autograd::Gather(output_device, dim)
+          .apply(std::move(replica_outputs))
+          .front();
+    });
+  }
+
+  /// Broadcasts the parameters and buffers of the module modified since the
+  /// last call to the replicas, and returns how many there were. The replicas
+  /// pick them up once done with the calls already started. Called by
+  /// `forward_async()`.
+  size_t sync() {
+    std::lock_guard<std::mutex> lock(sync_mutex_);
+    const auto& sources = replica_tensors_.front();
+    std::vector<size_t> stale;
+    for (size_t i = 0; i < sources.size(); ++i) {
+      const SyncState state{sources[i]._version(), sources[i].data_ptr()};
+      if (state.version != synced_[i].version || state.data != synced_[i].data) {
+        stale.push_back(i);
+        synced_[i] = state;
+      }
+    }
+    if (stale.empty() || replicas_.size() == 1) {
+      return stale.size();
+    }
+
+    std::vector<Tensor> tensors;
+    tensors.reserve(stale.size());
+    for (const auto i : stale) {
+      tensors.push_back(sources[i]);
+    }
+    std::vector<int64_t> device_indices;
+    for (const auto& device : devices_) {
+      device_indices.push_back(device.index());
+    }
+    std::shared_ptr<torch::cuda::tensor_list2d> broadcasts;
+    {
+      at::NoGradGuard no_grad;
+      broadcasts = std::make_shared<torch::cuda::tensor_list2d>(
+          torch::cuda::broadcast_coalesced(tensors, device_indices, kBroadcastBufferSize));
+    }
+    for (size_t r = 1; r < replicas_.size(); ++r) {
+      workers_[r]->submit([this, r, stale, broadcasts] {
+        at::NoGradGuard no_grad;
+        for (size_t j = 0; j < stale.size(); ++j) {
+          replica_tensors_[r][stale[j]].set_data((*broadcasts)[r][j]);
+        }
+      });
+    }
+    return stale.size();
+  }
+
+  /// The module, on the first device.
+  const std::shared_ptr<ModuleType>& module() const {
+    return module_;
+  }
+
+  /// The replicas, the first being the module itself.
+  const std::vector<std::shared_ptr<ModuleType>>& replicas() const {
+    return replicas_;
+  }
+
+  const std::vector<Device>& devices() const {
+    return devices_;
+  }
+
+ private:
+  struct SyncState {
+    int64_t version;
+    void* data;
+  };
+
+  static constexpr size_t kBroadcastBufferSize = 10 * 1024 * 1024;
+
+  static std::vector<Tensor> module_tensors(const Module& module) {
+    auto tensors = module.parameters();
+    auto buffers = module.buffers();
+    tensors.insert(tensors.end(), buffers.begin(), buffers.end());
+    return tensors;
+  }
+
+  // Runs the function on the thread of the i-th device, with the gradient
+  // mode of the caller
+  template <typename Function>
+  std::future<Tensor> run_on(size_t i, Function function) {
+    auto promise = std::make_shared<std::promise<Tensor>>();
+    auto future = promise->get_future();
+    const bool grad_mode = at::GradMode::is_enabled();
+    workers_[i]->submit([promise, function, grad_mode] {
+      try {
+        at::AutoGradMode guard(grad_mode);
+        promise->set_value(function());
+      } catch (...) {
+        promise->set_exception(std::current_exception());
+      }
+    });
+    return future;
+  }
+
+  std::shared_ptr<ModuleType> module_;
+  std::vector<Device> devices_;
+  Device output_device_;
+  int64_t dim_;
+  std::vector<std::shared_ptr<ModuleType>> replicas_;
+  // the parameters then the buffers of each replica
+  std::vector<std::vector<Tensor>> replica_tensors_;
+  // the state of the tensors of the module at the last sync
+  std::vector<SyncState> synced_;
+  std::mutex sync_mutex_;
+  // last, so that the threads are done before the replicas are destroyed
+  std::vector<std::unique_ptr<detail::DeviceWorker>> workers_;
+};
+
 } // namespace parallel
 } // namespace nn
 } // namespace torch
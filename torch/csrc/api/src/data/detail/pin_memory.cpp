@@ -0,0 +1,107 @@
+#include <torch/data/detail/pin_memory.h>
+
+#include <c10/core/Event.h>
+#include <c10/core/StreamGuard.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
+#include <torch/types.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+namespace {
+
+// The alignment of the tensors in the packed buffers, a multiple of the size of
+// any dtype
+constexpr int64_t kPackedAlignment = 64;
+
+// The byte offset of each tensor in the packed buffer, followed by the size of
+// the buffer
+std::vector<int64_t> packed_offsets(ArrayRef<Tensor> tensors) {
+  std::vector<int64_t> offsets;
+  offsets.reserve(tensors.size() + 1);
+  int64_t offset = 0;
+  for (const auto& tensor : tensors) {
+    offsets.push_back(offset);
+    const int64_t nbytes = tensor.numel() * tensor.element_size();
+    offset += (nbytes + kPackedAlignment - 1) / kPackedAlignment *
+        kPackedAlignment;
+  }
+  offsets.push_back(offset);
+  return offsets;
+}
+
+// A contiguous tensor with the dtype and sizes of `like`, 'offset' bytes into
+// the byte tensor `buffer`
+Tensor packed_view(const Tensor& buffer, int64_t offset, const Tensor& like) {
+  return torch::empty({0}, buffer.options().dtype(like.dtype()))
+      .set_(buffer.storage(), offset / like.element_size(), like.sizes());
+}
+
+// Copies `tensors` into a new pinned byte buffer, at `offsets`
+Tensor pack_pinned(ArrayRef<Tensor> tensors, const std::vector<int64_t>& offsets) {
+  auto buffer = torch::empty(
+      {offsets.back()},
+      torch::TensorOptions().dtype(torch::kUInt8).pinned_memory(true));
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    packed_view(buffer, offsets[i], tensors[i]).copy_(tensors[i]);
+  }
+  return buffer;
+}
+
+std::vector<Tensor> unpack(
+    const Tensor& buffer,
+    ArrayRef<Tensor> tensors,
+    const std::vector<int64_t>& offsets) {
+  std::vector<Tensor> views;
+  views.reserve(tensors.size());
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    views.push_back(packed_view(buffer, offsets[i], tensors[i]));
+  }
+  return views;
+}
+
+} // namespace
+
+std::vector<Tensor> pin_packed(ArrayRef<Tensor> tensors) {
+  const auto offsets = packed_offsets(tensors);
+  return unpack(pack_pinned(tensors, offsets), tensors, offsets);
+}
+
+std::vector<Tensor> to_device_packed(ArrayRef<Tensor> tensors, Device device) {
+  const c10::impl::VirtualGuardImpl impl(device.type());
+  if (!device.has_index()) {
+    device = Device(device.type(), impl.getDevice().index());
+  }
+  const auto offsets = packed_offsets(tensors);
+  const auto pinned = pack_pinned(tensors, offsets);
+
+  const Stream current = impl.getStream(device);
+  const Stream transfer = impl.getStreamFromPool(device);
+  c10::Event copied(device.type());
+  Tensor buffer;
+  {
+    // Allocated on the transfer stream, the buffer can't be memory the
+    // current stream is still using.
+    c10::StreamGuard stream_guard(transfer);
+    buffer = torch::empty(
+        {offsets.back()},
+        torch::TensorOptions().dtype(torch::kUInt8).device(device));
+    // The caching host allocator keeps the pinned buffer until the copy is
+    // done.
+    buffer.copy_(pinned, /*non_blocking=*/true);
+    copied.record(transfer);
+  }
+  // Hand the buffer over to the current stream: the stream waits for the copy,
+  // and the caching allocator must not reuse the buffer before the work queued
+  // on that stream is done.
+  copied.block(current);
+  impl.recordDataPtrOnStream(buffer.storage().data_ptr(), current);
+  return unpack(buffer, tensors, offsets);
+}
+
+} // namespace detail
+} // namespace data
+} // namespace torch
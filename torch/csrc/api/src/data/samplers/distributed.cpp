@@ -4,12 +4,62 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <random>
 #include <vector>
 
 namespace torch {
 namespace data {
 namespace samplers {
+namespace {
+uint64_t splitmix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// A keyed bijection of `[0, size)`: a Feistel network permutes the integers
+/// of the smallest even number of bits that holds `size - 1`, and it's
+/// applied again to the ones that are out of range (cycle walking). As this
+/// range is below `4 * size`, it takes a few rounds on average.
+class FeistelPermutation {
+ public:
+  FeistelPermutation(uint64_t size, uint64_t key) : size_(size) {
+    while (half_bits_ < 32 && (uint64_t(1) << (2 * half_bits_)) < size) {
+      ++half_bits_;
+    }
+    mask_ = (uint64_t(1) << half_bits_) - 1;
+    for (auto& round_key : round_keys_) {
+      round_key = key = splitmix64(key);
+    }
+  }
+
+  uint64_t operator()(uint64_t x) const {
+    do {
+      x = encrypt(x);
+    } while (x >= size_);
+    return x;
+  }
+
+ private:
+  uint64_t encrypt(uint64_t x) const {
+    uint64_t left = x >> half_bits_;
+    uint64_t right = x & mask_;
+    for (const auto round_key : round_keys_) {
+      const uint64_t next = left ^ (splitmix64(right ^ round_key) & mask_);
+      left = right;
+      right = next;
+    }
+    return (left << half_bits_) | right;
+  }
+
+  uint64_t size_;
+  unsigned half_bits_ = 0;
+  uint64_t mask_;
+  uint64_t round_keys_[4];
+};
+} // namespace
 
 DistributedRandomSampler::DistributedRandomSampler(
     size_t size,
@@ -93,6 +143,115 @@ size_t DistributedRandomSampler::index() const noexcept {
   return sample_index_;
 }
 
+DistributedStreamingRandomSampler::DistributedStreamingRandomSampler(
+    size_t size,
+    size_t num_replicas,
+    size_t rank,
+    bool allow_duplicates,
+    size_t block_size,
+    uint64_t seed)
+    : DistributedSampler(size, num_replicas, rank, allow_duplicates),
+      block_size_(block_size),
+      seed_(seed),
+      begin_index_(0),
+      sample_index_(0) {
+  TORCH_CHECK(block_size_ > 0, "block_size must be positive");
+}
+
+optional<std::vector<size_t>> DistributedStreamingRandomSampler::next(
+    size_t batch_size) {
+  const size_t local_samples = local_samples_left();
+  if (sample_index_ == local_samples) {
+    return nullopt;
+  }
+
+  size_t end = sample_index_ + batch_size;
+  if (end > local_samples) {
+    end = local_samples;
+  }
+
+  const uint64_t key = splitmix64(seed_ ^ splitmix64(epoch_));
+  std::vector<size_t> res;
+  res.reserve(end - sample_index_);
+  for (size_t i = sample_index_; i < end; ++i) {
+    // the positions past the end are the duplicates added to make all
+    // replicas have the same number of samples
+    const size_t position = begin_index_ + i * num_replicas_ + rank_;
+    res.push_back(sample(position % size_, key));
+  }
+  sample_index_ = end;
+  return res;
+}
+
+size_t DistributedStreamingRandomSampler::sample(
+    size_t position,
+    uint64_t key) const {
+  const size_t num_blocks = size_ / block_size_;
+  const size_t blocked_size = num_blocks * block_size_;
+  if (position < blocked_size) {
+    const size_t block = position / block_size_;
+    const FeistelPermutation blocks(num_blocks, key);
+    const FeistelPermutation offsets(block_size_, splitmix64(key ^ block));
+    return blocks(block) * block_size_ + offsets(position % block_size_);
+  }
+  // the last, partial block stays at the end
+  const FeistelPermutation offsets(
+      size_ - blocked_size, splitmix64(key ^ num_blocks));
+  return blocked_size + offsets(position - blocked_size);
+}
+
+size_t DistributedStreamingRandomSampler::local_samples_left() const {
+  const size_t samples_left = begin_index_ < size_ ? size_ - begin_index_ : 0;
+  if (allow_duplicates_) {
+    return (samples_left + num_replicas_ - 1) / num_replicas_;
+  } else {
+    return samples_left / num_replicas_;
+  }
+}
+
+void DistributedStreamingRandomSampler::reset(optional<size_t> new_size) {
+  size_ = new_size.value_or(size_);
+  begin_index_ = 0;
+  sample_index_ = 0;
+}
+
+void DistributedStreamingRandomSampler::set_replicas(
+    size_t num_replicas,
+    size_t rank) {
+  begin_index_ = index();
+  sample_index_ = 0;
+  num_replicas_ = num_replicas;
+  rank_ = rank;
+}
+
+void DistributedStreamingRandomSampler::save(
+    serialize::OutputArchive& archive) const {
+  archive.write(
+      "begin_index_",
+      torch::tensor(static_cast<int64_t>(index())),
+      /*is_buffer=*/true);
+  archive.write(
+      "epoch_",
+      torch::tensor(static_cast<int64_t>(epoch_)),
+      /*is_buffer=*/true);
+}
+
+void DistributedStreamingRandomSampler::load(
+    serialize::InputArchive& archive) {
+  auto tensor = torch::empty(1, torch::kInt64);
+  archive.read("epoch_", tensor, /*is_buffer=*/true);
+  epoch_ = tensor.item<int64_t>();
+
+  tensor = torch::empty(1, torch::kInt64);
+  archive.read("begin_index_", tensor, /*is_buffer=*/true);
+  begin_index_ = tensor.item<int64_t>();
+  sample_index_ = 0;
+}
+
+size_t DistributedStreamingRandomSampler::index() const noexcept {
+  return std::min(begin_index_ + sample_index_ * num_replicas_, size_);
+}
+
 DistributedSequentialSampler::DistributedSequentialSampler(
     size_t size,
     size_t num_replicas,
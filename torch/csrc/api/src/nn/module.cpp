@@ -7,11 +7,14 @@
 #include <c10/util/Exception.h>
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <map>
 #include <ostream>
 #include <string>
 #include <typeinfo>
+#include <unordered_set>
+#include <utility>
 
 namespace torch {
 namespace nn {
@@ -32,8 +35,16 @@ std::string join_name(const std::string& name_prefix, const std::string& name) {
   full_name += name;
   return full_name;
 }
+
+/// Bumped whenever the parameters, buffers or submodules registered in any
+/// module change, invalidating the recursive lists cached by all of them.
+std::atomic<uint64_t> module_hierarchy_version{1};
 } // namespace
 
+void Module::invalidate_cached_parameters() {
+  module_hierarchy_version.fetch_add(1);
+}
+
 Module::Module()
     : parameters_("Parameter"), buffers_("Buffer"), children_("Submodule") {}
 
@@ -132,49 +143,136 @@ void Module::apply(
 }
 
 std::vector<Tensor> Module::parameters(bool recurse) const {
-  return named_parameters(recurse).values();
+  if (!recurse) {
+    return named_parameters(/*recurse=*/false).values();
+  }
+  std::lock_guard<std::mutex> guard(recursive_cache_.mutex);
+  update_cached_parameters();
+  return recursive_cache_.parameters;
 }
 
 OrderedDict<std::string, Tensor> Module::named_parameters(bool recurse) const {
-  OrderedDict<std::string, Tensor> result;
   if (!recurse) {
+    OrderedDict<std::string, Tensor> result;
     for (const auto& parameter : parameters_) {
       if (parameter.value().defined()) {
         result.insert(parameter.key(), parameter.value());
       }
     }
-  } else {
-    apply([&result](const std::string& name, const Module& module) {
-      for (const auto& parameter : module.named_parameters(/*recurse=*/false)) {
-        TORCH_INTERNAL_ASSERT(parameter.value().defined());
+    return result;
+  }
+  std::lock_guard<std::mutex> guard(recursive_cache_.mutex);
+  update_cached_parameters();
+  return recursive_cache_.named_parameters;
+}
+
+void Module::update_cached_parameters() const {
+  const uint64_t version = module_hierarchy_version.load();
+  if (recursive_cache_.parameters_version == version) {
+    return;
+  }
+  OrderedDict<std::string, Tensor> result;
+  apply([&result](const std::string& name, const Module& module) {
+    for (const auto& parameter : module.parameters_) {
+      if (parameter.value().defined()) {
         result.insert(join_name(name, parameter.key()), parameter.value());
       }
-    });
-  }
-  return result;
+    }
+  });
+  recursive_cache_.parameters = result.values();
+  recursive_cache_.named_parameters = std::move(result);
+  recursive_cache_.parameters_version = version;
 }
 
 std::vector<Tensor> Module::buffers(bool recurse) const {
-  return named_buffers(recurse).values();
+  if (!recurse) {
+    return named_buffers(/*recurse=*/false).values();
+  }
+  std::lock_guard<std::mutex> guard(recursive_cache_.mutex);
+  update_cached_buffers();
+  return recursive_cache_.buffers;
 }
 
 OrderedDict<std::string, Tensor> Module::named_buffers(bool recurse) const {
-  OrderedDict<std::string, Tensor> result;
   if (!recurse) {
+    OrderedDict<std::string, Tensor> result;
     for (const auto& buffer : buffers_) {
       if (buffer.value().defined()) {
         result.insert(buffer.key(), buffer.value());
       }
     }
-  } else {
-    apply([&result](const std::string& name, const Module& module) {
-      for (const auto& buffer : module.named_buffers(/*recurse=*/false)) {
-        TORCH_INTERNAL_ASSERT(buffer.value().defined());
+    return result;
+  }
+  std::lock_guard<std::mutex> guard(recursive_cache_.mutex);
+  update_cached_buffers();
+  return recursive_cache_.named_buffers;
+}
+
+void Module::update_cached_buffers() const {
+  const uint64_t version = module_hierarchy_version.load();
+  if (recursive_cache_.buffers_version == version) {
+    return;
+  }
+  OrderedDict<std::string, Tensor> result;
+  apply([&result](const std::string& name, const Module& module) {
+    for (const auto& buffer : module.buffers_) {
+      if (buffer.value().defined()) {
         result.insert(join_name(name, buffer.key()), buffer.value());
       }
+    }
+  });
+  recursive_cache_.buffers = result.values();
+  recursive_cache_.named_buffers = std::move(result);
+  recursive_cache_.buffers_version = version;
+}
+
+std::vector<Tensor> Module::flatten_parameter_storage() {
+  NoGradGuard no_grad;
+  // The distinct parameters, grouped by device and dtype in the order of
+  // their first parameter
+  std::vector<std::vector<Tensor>> groups;
+  std::unordered_set<const c10::TensorImpl*> seen;
+  for (const auto& parameter : parameters()) {
+    if (!seen.insert(parameter.unsafeGetTensorImpl()).second) {
+      continue;
+    }
+    auto group = std::find_if(groups.begin(), groups.end(), [&](const std::vector<Tensor>& group) {
+      return group.front().device() == parameter.device() &&
+          group.front().scalar_type() == parameter.scalar_type();
     });
+    if (group == groups.end()) {
+      groups.emplace_back();
+      group = groups.end() - 1;
+    }
+    group->push_back(parameter);
   }
-  return result;
+
+  std::vector<Tensor> buffers;
+  buffers.reserve(groups.size());
+  for (auto& group : groups) {
+    int64_t numel = 0;
+    for (const auto& parameter : group) {
+      numel += parameter.numel();
+    }
+    auto buffer = torch::empty({numel}, group.front().options());
+    auto grad_buffer = torch::zeros({numel}, group.front().options());
+    int64_t offset = 0;
+    for (auto& parameter : group) {
+      const auto n = parameter.numel();
+      auto data = buffer.narrow(/*dim=*/0, offset, n).view(parameter.sizes());
+      data.copy_(parameter);
+      auto grad = grad_buffer.narrow(/*dim=*/0, offset, n).view(parameter.sizes());
+      if (parameter.grad().defined()) {
+        grad.copy_(parameter.grad());
+      }
+      parameter.set_data(data);
+      parameter.mutable_grad() = grad;
+      offset += n;
+    }
+    buffer.mutable_grad() = grad_buffer;
+    buffers.push_back(std::move(buffer));
+  }
+  return buffers;
 }
 
 std::vector<std::shared_ptr<Module>> Module::modules(bool include_self) const {
@@ -254,7 +352,10 @@ void Module::zero_grad() {
   for (auto& child : children_) {
     child.value()->zero_grad();
   }
-  for (auto& parameter : named_parameters(/*recurse=*/false)) {
+  for (auto& parameter : parameters_) {
+    if (!parameter.value().defined()) {
+      continue;
+    }
     auto& grad = parameter->mutable_grad();
     if (grad.defined()) {
       grad = grad.detach();
@@ -318,7 +419,9 @@ Tensor& Module::register_parameter(
   } else {
     tensor.set_requires_grad(requires_grad);
   }
-  return parameters_.insert(std::move(name), std::move(tensor));
+  auto& parameter = parameters_.insert(std::move(name), std::move(tensor));
+  invalidate_cached_parameters();
+  return parameter;
 }
 
 Tensor& Module::register_buffer(std::string name, Tensor tensor) {
@@ -328,7 +431,9 @@ Tensor& Module::register_buffer(std::string name, Tensor tensor) {
       "Buffer name must not contain a dot (got '",
       name,
       "')");
-  return buffers_.insert(std::move(name), std::move(tensor));
+  auto& buffer = buffers_.insert(std::move(name), std::move(tensor));
+  invalidate_cached_parameters();
+  return buffer;
 }
 
 void Module::unregister_module(const std::string& name) {
@@ -338,6 +443,7 @@ void Module::unregister_module(const std::string& name) {
       name,
       "` is registered");
   children_.erase(name);
+  invalidate_cached_parameters();
 }
 
 void Module::pretty_print(std::ostream& stream) const {
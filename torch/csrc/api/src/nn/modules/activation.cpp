@@ -2,6 +2,10 @@
 #include <torch/nn/functional/activation.h>
 #include <torch/nn/init.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace F = torch::nn::functional;
 
 namespace torch {
@@ -405,6 +409,58 @@ void ThresholdImpl::pretty_print(std::ostream& stream) const {
 
 // ============================================================================
 
+Tensor MultiheadAttentionCache::keys() const {
+  return key.defined() ? key.narrow(/*dim=*/2, 0, length) : key;
+}
+
+Tensor MultiheadAttentionCache::values() const {
+  return value.defined() ? value.narrow(/*dim=*/2, 0, length) : value;
+}
+
+void MultiheadAttentionCache::append(const Tensor& new_keys, const Tensor& new_values) {
+  TORCH_CHECK(
+    new_keys.dim() == 4 && new_values.sizes() == new_keys.sizes(),
+    "MultiheadAttentionCache: expected keys and values of the same shape "
+    "(batch, num_heads, new_length, head_dim), but got ",
+    new_keys.sizes(), " and ", new_values.sizes());
+  const auto new_length = new_keys.size(2);
+  if (!key.defined() || (length == 0 && key.sizes().slice(0, 2) != new_keys.sizes().slice(0, 2))) {
+    auto sizes = new_keys.sizes().vec();
+    sizes[2] = std::max(capacity, new_length);
+    key = torch::empty(sizes, new_keys.options());
+    value = torch::empty(sizes, new_values.options());
+    length = 0;
+  } else {
+    TORCH_CHECK(
+      new_keys.size(0) == key.size(0) && new_keys.size(1) == key.size(1) &&
+        new_keys.size(3) == key.size(3),
+      "MultiheadAttentionCache: expected new keys of shape (", key.size(0), ", ",
+      key.size(1), ", new_length, ", key.size(3), "), but got ", new_keys.sizes());
+    if (length + new_length > key.size(2)) {
+      auto sizes = key.sizes().vec();
+      sizes[2] = std::max(2 * key.size(2), length + new_length);
+      auto grown_key = torch::empty(sizes, key.options());
+      auto grown_value = torch::empty(sizes, value.options());
+      grown_key.narrow(/*dim=*/2, 0, length).copy_(keys());
+      grown_value.narrow(/*dim=*/2, 0, length).copy_(values());
+      key = std::move(grown_key);
+      value = std::move(grown_value);
+    }
+  }
+  key.narrow(/*dim=*/2, length, new_length).copy_(new_keys);
+  value.narrow(/*dim=*/2, length, new_length).copy_(new_values);
+  length += new_length;
+}
+
+void MultiheadAttentionCache::reorder(const Tensor& index) {
+  if (key.defined()) {
+    key = key.index_select(/*dim=*/0, index);
+    value = value.index_select(/*dim=*/0, index);
+  }
+}
+
+// ============================================================================
+
 MultiheadAttentionImpl::MultiheadAttentionImpl(const MultiheadAttentionOptions& options_)
     : Module("torch::nn::MultiheadAttention"), options(options_) {
   reset();
@@ -459,6 +515,110 @@ std::tuple<Tensor, Tensor> MultiheadAttentionImpl::forward(
   }
 }
 
+namespace {
+// (length, batch, num_heads * head_dim) -> (batch, num_heads, length, head_dim)
+Tensor split_heads(const Tensor& input, int64_t num_heads, int64_t head_dim) {
+  return input.view({input.size(0), input.size(1), num_heads, head_dim})
+    .permute({1, 2, 0, 3});
+}
+} // namespace
+
+Tensor MultiheadAttentionImpl::forward_incremental(
+  const Tensor& query, const Tensor& key,
+  const Tensor& value, MultiheadAttentionCache& cache,
+  bool static_kv, const Tensor& key_padding_mask,
+  const Tensor& attn_mask) {
+  TORCH_CHECK(!bias_k.defined() && !bias_v.defined() && !options.add_zero_attn(),
+    "MultiheadAttention: forward_incremental doesn't support add_bias_kv nor add_zero_attn");
+  TORCH_CHECK(query.dim() == 3 && query.size(2) == options.embed_dim(),
+    "MultiheadAttention: expected a query of shape (new_length, batch, ",
+    options.embed_dim(), "), but got ", query.sizes());
+  const auto embed_dim = options.embed_dim();
+  const auto num_heads = options.num_heads();
+  const auto tgt_len = query.size(0);
+  const auto bsz = query.size(1);
+
+  // The rows of the input projection for q, k or v
+  const auto in_proj = [&](const Tensor& input, int64_t chunk, const Tensor& separate_weight) {
+    const auto weight = _qkv_same_embed_dim
+      ? in_proj_weight.slice(/*dim=*/0, chunk * embed_dim, (chunk + 1) * embed_dim)
+      : separate_weight;
+    const auto bias = in_proj_bias.defined()
+      ? in_proj_bias.slice(/*dim=*/0, chunk * embed_dim, (chunk + 1) * embed_dim)
+      : in_proj_bias;
+    return F::linear(input, weight, bias);
+  };
+
+  Tensor q;
+  if (!static_kv && _qkv_same_embed_dim && query.is_same(key) && key.is_same(value)) {
+    // self-attention, projected at once
+    const auto chunks =
+      F::linear(query, in_proj_weight, in_proj_bias).chunk(3, /*dim=*/-1);
+    q = chunks[0];
+    cache.append(
+      split_heads(chunks[1], num_heads, head_dim),
+      split_heads(chunks[2], num_heads, head_dim));
+  } else {
+    q = in_proj(query, 0, q_proj_weight);
+    if (!static_kv || cache.empty()) {
+      TORCH_CHECK(key.defined() && value.defined(),
+        "MultiheadAttention: expected the key and value to append to the cache");
+      cache.append(
+        split_heads(in_proj(key, 1, k_proj_weight), num_heads, head_dim),
+        split_heads(in_proj(value, 2, v_proj_weight), num_heads, head_dim));
+    }
+  }
+  TORCH_CHECK(cache.key.size(0) == bsz,
+    "MultiheadAttention: the cache holds a batch of ", cache.key.size(0),
+    ", but the query has a batch of ", bsz);
+  const auto src_len = cache.length;
+  q = split_heads(q * (1 / std::sqrt(head_dim)), num_heads, head_dim)
+    .reshape({bsz * num_heads, tgt_len, head_dim});
+
+  // The cached keys and values are strided views of the buffers, which the
+  // batched matrix products read in place
+  auto attn_output_weights = torch::bmm(
+    q, cache.keys().reshape({bsz * num_heads, src_len, head_dim}).transpose(1, 2))
+    .view({bsz, num_heads, tgt_len, src_len});
+  if (!static_kv && tgt_len > 1) {
+    // the new positions attend to the cached ones and to those up to themselves
+    attn_output_weights.masked_fill_(
+      torch::ones({tgt_len, src_len}, query.options().dtype(torch::kBool))
+        .triu(src_len - tgt_len + 1),
+      -std::numeric_limits<double>::infinity());
+  }
+  if (attn_mask.defined()) {
+    TORCH_CHECK(attn_mask.numel() == tgt_len * src_len,
+      "MultiheadAttention: expected an attn_mask of shape (", tgt_len, ", ",
+      src_len, "), but got ", attn_mask.sizes());
+    const auto mask = attn_mask.reshape({tgt_len, src_len});
+    if (mask.scalar_type() == torch::kBool) {
+      attn_output_weights.masked_fill_(mask, -std::numeric_limits<double>::infinity());
+    } else {
+      attn_output_weights.add_(mask);
+    }
+  }
+  if (key_padding_mask.defined()) {
+    TORCH_CHECK(key_padding_mask.size(0) == bsz && key_padding_mask.size(1) == src_len,
+      "MultiheadAttention: expected a key_padding_mask of shape (", bsz, ", ",
+      src_len, "), but got ", key_padding_mask.sizes());
+    attn_output_weights.masked_fill_(
+      key_padding_mask.to(torch::kBool).view({bsz, 1, 1, src_len}),
+      -std::numeric_limits<double>::infinity());
+  }
+  attn_output_weights = F::dropout(
+    F::softmax(attn_output_weights, F::SoftmaxFuncOptions(-1)),
+    F::DropoutFuncOptions().p(options.dropout()).training(is_training()));
+
+  auto attn_output = torch::bmm(
+    attn_output_weights.view({bsz * num_heads, tgt_len, src_len}),
+    cache.values().reshape({bsz * num_heads, src_len, head_dim}));
+  attn_output = attn_output.view({bsz, num_heads, tgt_len, head_dim})
+    .permute({2, 0, 1, 3})
+    .reshape({tgt_len, bsz, embed_dim});
+  return F::linear(attn_output, out_proj->weight, out_proj->bias);
+}
+
 void MultiheadAttentionImpl::reset() {
   _qkv_same_embed_dim = options.kdim() == options.embed_dim() &&
                         options.vdim() == options.embed_dim();
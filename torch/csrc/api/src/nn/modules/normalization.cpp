@@ -46,6 +46,15 @@ torch::Tensor LayerNormImpl::forward(const Tensor& input) {
   return F::detail::layer_norm(input, options.normalized_shape(), weight, bias, options.eps());
 }
 
+torch::Tensor LayerNormImpl::forward_residual(
+    const Tensor& input,
+    const Tensor& residual,
+    double dropout_p) {
+  return F::detail::add_layer_norm(
+      input, residual, options.normalized_shape(), weight, bias, options.eps(),
+      dropout_p, is_training());
+}
+
 // ============================================================================
 
 LocalResponseNormImpl::LocalResponseNormImpl(const LocalResponseNormOptions& options_)
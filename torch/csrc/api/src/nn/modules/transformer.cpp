@@ -60,7 +60,7 @@ Tensor TransformerEncoderLayerImpl::forward(
   // multihead attention
   Tensor src2 = std::get<0>(self_attn(src, src, src, src_key_padding_mask, /*need_weights=*/true, src_mask));
   // add & norm
-  Tensor ret = norm1(src + dropout1(src2));
+  Tensor ret = norm1->forward_residual(src2, src, dropout1->options.p());
 
   // feedforward
   if (c10::get_if<enumtype::kGELU>(&options.activation())) {
@@ -74,7 +74,7 @@ Tensor TransformerEncoderLayerImpl::forward(
   }
 
   // add & norm
-  return norm2(ret + dropout2(src2));
+  return norm2->forward_residual(src2, ret, dropout2->options.p());
 }
 
 
@@ -156,8 +156,7 @@ Tensor TransformerDecoderLayerImpl::forward(
     false, //need_weights
     tgt_mask)//attn_mask
   );
-  tgt = tgt + dropout1(tgt2);
-  tgt = norm1(tgt);
+  tgt = norm1->forward_residual(tgt2, tgt, dropout1->options.p());
 
   tgt2 = std::get<0>(multihead_attn(
     tgt, //query
@@ -167,12 +166,44 @@ Tensor TransformerDecoderLayerImpl::forward(
     false, //need_weights
     memory_mask)//attn_mask
   );
-  tgt = tgt + dropout2(tgt2);
-  tgt = norm2(tgt);
+  tgt = norm2->forward_residual(tgt2, tgt, dropout2->options.p());
 
   tgt2 = linear2(dropout(activation(linear1(tgt))));
-  tgt = tgt + dropout3(tgt2);
-  tgt = norm3(tgt);
+  tgt = norm3->forward_residual(tgt2, tgt, dropout3->options.p());
+
+  return tgt;
+}
+
+Tensor TransformerDecoderLayerImpl::forward_incremental(
+  Tensor tgt,
+  const Tensor& memory,
+  TransformerDecoderLayerCache& cache,
+  const Tensor& memory_mask,
+  const Tensor& tgt_key_padding_mask,
+  const Tensor& memory_key_padding_mask){
+
+  Tensor tgt2 = self_attn->forward_incremental(
+    tgt, //query
+    tgt, //key
+    tgt, //value
+    cache.self_attn,
+    false, //static_kv
+    tgt_key_padding_mask, //key_padding_mask
+    {}); //attn_mask
+  tgt = norm1->forward_residual(tgt2, tgt, dropout1->options.p());
+
+  tgt2 = multihead_attn->forward_incremental(
+    tgt, //query
+    memory, //key
+    memory, //value
+    cache.multihead_attn,
+    true, //static_kv
+    memory_key_padding_mask, //key_padding_mask
+    memory_mask); //attn_mask
+  tgt = norm2->forward_residual(tgt2, tgt, dropout2->options.p());
+
+  tgt2 = linear2(dropout(activation(linear1(tgt))));
+  tgt = norm3->forward_residual(tgt2, tgt, dropout3->options.p());
 
   return tgt;
 }
@@ -326,6 +357,35 @@ Tensor TransformerDecoderImpl::forward(
   return output;
 }
 
+Tensor TransformerDecoderImpl::forward_incremental(
+  const Tensor& tgt,
+  const Tensor& memory,
+  TransformerDecoderCache& cache,
+  const Tensor& memory_mask,
+  const Tensor& tgt_key_padding_mask,
+  const Tensor& memory_key_padding_mask){
+
+  size_t num_layers = layers->size();
+  while (cache.layers.size() < num_layers) {
+    cache.layers.emplace_back(cache.capacity);
+  }
+  Tensor output = tgt;
+  for (size_t i = 0; i < num_layers; ++i) {
+    output = layers->at<TransformerDecoderLayerImpl>(i).forward_incremental(
+      output,
+      memory,
+      cache.layers[i],
+      memory_mask,
+      tgt_key_padding_mask,
+      memory_key_padding_mask);
+  }
+
+  if (!norm.is_empty()) {
+    output = norm.forward<Tensor>(output);
+  }
+
+  return output;
+}
 
 // =======================================TransformerImpl================================
 TransformerImpl::TransformerImpl(TransformerOptions options_ ) : options(std::move(options_)){
@@ -81,7 +81,20 @@ Tensor Adagrad::step(LossClosure closure) {
       const auto clr = options.lr() /
           (1 + static_cast<double>(state.step() - 1) * options.lr_decay());
 
-      if (grad.is_sparse()) {
+      if (grad.is_sparse() && grad.sparse_dim() == 1 && !state.sum().is_sparse()) {
+        // Updates the rows of the gradient in place, without building sparse
+        // tensors. The update is non-linear, so the rows must be unique:
+        // coalesce() is a no-op for the deduplicated gradients of
+        // torch::autograd::SparseGradDeduplicationMode.
+        grad = grad.coalesce();
+        const auto rows = grad._indices()[0];
+        const auto grad_values = grad._values();
+        auto sum_rows = state.sum().index_select(0, rows).addcmul_(grad_values, grad_values);
+        state.sum().index_copy_(0, rows, sum_rows);
+        const auto std_values = sum_rows.sqrt_().add_(options.eps());
+        p.index_add_(0, rows, grad_values.div(std_values).mul_(-clr));
+      }
+      else if (grad.is_sparse()) {
         grad = grad.coalesce();
         auto grad_indices = grad._indices();
         auto grad_values = grad._values();
@@ -9,6 +9,8 @@
 
 #include <cmath>
 #include <functional>
+#include <map>
+#include <tuple>
 
 namespace torch {
 namespace optim {
@@ -61,6 +63,31 @@ void AdamParamState::serialize(torch::serialize::InputArchive& archive) {
   _TORCH_OPTIM_DESERIALIZE_TORCH_ARG(Tensor, max_exp_avg_sq);
 }
 
+namespace {
+// The parameters of a group that are updated by a single fused kernel
+struct FusedAdamBucket {
+  std::vector<Tensor> params;
+  std::vector<Tensor> grads;
+  std::vector<Tensor> exp_avgs;
+  std::vector<Tensor> exp_avg_sqs;
+  std::vector<Tensor> max_exp_avg_sqs;
+};
+
+// Whether the step of p can be taken by at::_fused_adam_, which sweeps p, its
+// grad and its state linearly.
+bool can_use_fused_adam(const Tensor& p, const Tensor& grad, const AdamParamState& state, bool amsgrad) {
+  auto same_layout = [&](const Tensor& t) {
+    return t.defined() && t.scalar_type() == p.scalar_type() && t.strides() == p.strides();
+  };
+  // The CPU kernel only takes float and double params
+  const bool fused_dtype = p.is_cuda() ? at::isFloatingType(p.scalar_type())
+      : p.device().is_cpu() && (p.scalar_type() == kFloat || p.scalar_type() == kDouble);
+  return fused_dtype && p.is_non_overlapping_and_dense() && grad.scalar_type() == p.scalar_type() &&
+      same_layout(state.exp_avg()) && same_layout(state.exp_avg_sq()) &&
+      (!amsgrad || same_layout(state.max_exp_avg_sq()));
+}
+} // namespace
+
 Tensor Adam::step(LossClosure closure)  {
   NoGradGuard no_grad;
   Tensor loss = {};
@@ -69,6 +96,9 @@ Tensor Adam::step(LossClosure closure)  {
     loss = closure();
   }
   for (auto& group : param_groups_) {
+    auto& options = static_cast<AdamOptions&>(group.options());
+    // CPU and CUDA parameters by device, dtype and step
+    std::map<std::tuple<int64_t, ScalarType, int64_t>, FusedAdamBucket> fused_buckets;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
@@ -76,7 +106,6 @@ Tensor Adam::step(LossClosure closure)  {
       auto grad = p.grad();
       TORCH_CHECK(!grad.is_sparse(), "Adam does not support sparse gradients"/*, please consider SparseAdam instead*/);
       auto param_state = state_.find(c10::guts::to_string(p.unsafeGetTensorImpl()));
-      auto& options = static_cast<AdamOptions&>(group.options());
 
       // State initialization
       if(param_state == state_.end()) {
@@ -99,6 +128,20 @@ Tensor Adam::step(LossClosure closure)  {
       auto& max_exp_avg_sq = state.max_exp_avg_sq();
 
       state.step(state.step()+1);
+
+      if (can_use_fused_adam(p, grad, state, options.amsgrad())) {
+        auto& bucket = fused_buckets[std::make_tuple(
+            p.device().index(), p.scalar_type(), state.step())];
+        bucket.params.push_back(p);
+        bucket.grads.push_back(grad);
+        bucket.exp_avgs.push_back(exp_avg);
+        bucket.exp_avg_sqs.push_back(exp_avg_sq);
+        if (options.amsgrad()) {
+          bucket.max_exp_avg_sqs.push_back(max_exp_avg_sq);
+        }
+        continue;
+      }
+
       auto beta1 = std::get<0>(options.betas());
       auto beta2 = std::get<1>(options.betas());
 
@@ -126,6 +169,25 @@ Tensor Adam::step(LossClosure closure)  {
       auto step_size = options.lr() / bias_correction1;
       p.addcdiv_(exp_avg, denom, -step_size);
     }
+
+    for (auto& it : fused_buckets) {
+      auto& bucket = it.second;
+      at::_fused_adam_(
+          bucket.params,
+          bucket.grads,
+          bucket.exp_avgs,
+          bucket.exp_avg_sqs,
+          bucket.max_exp_avg_sqs,
+          /*model_params=*/{},
+          options.lr(),
+          std::get<0>(options.betas()),
+          std::get<1>(options.betas()),
+          options.weight_decay(),
+          options.eps(),
+          /*step=*/std::get<2>(it.first),
+          options.amsgrad(),
+          /*decoupled_weight_decay=*/false);
+    }
   }
   return loss;
 }
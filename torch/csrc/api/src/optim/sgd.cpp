@@ -10,6 +10,8 @@
 #include <ATen/ATen.h>
 
 #include <functional>
+#include <map>
+#include <tuple>
 
 namespace torch {
 namespace optim {
@@ -52,6 +54,25 @@ void SGDParamState::serialize(torch::serialize::InputArchive& archive) {
   _TORCH_OPTIM_DESERIALIZE_TORCH_ARG(Tensor, momentum_buffer);
 }
 
+namespace {
+// The parameters of a group that are updated by a single fused kernel
+struct FusedSGDBucket {
+  std::vector<Tensor> params;
+  std::vector<Tensor> grads;
+  std::vector<Tensor> momentum_buffers;
+};
+
+// Whether the step of p can be taken by at::_fused_sgd_, which sweeps p, its
+// grad and its momentum buffer linearly.
+bool can_use_fused_sgd(const Tensor& p, const Tensor& grad, const Tensor& momentum_buffer) {
+  return p.is_cuda() && at::isFloatingType(p.scalar_type()) &&
+      p.is_non_overlapping_and_dense() && grad.scalar_type() == p.scalar_type() &&
+      (!momentum_buffer.defined() ||
+       (momentum_buffer.scalar_type() == p.scalar_type() &&
+        momentum_buffer.strides() == p.strides()));
+}
+} // namespace
+
 Tensor SGD::step(LossClosure closure)  {
   NoGradGuard no_grad;
   Tensor loss = {};
@@ -65,19 +86,47 @@ Tensor SGD::step(LossClosure closure)  {
     auto momentum = options.momentum();
     auto dampening = options.dampening();
     auto nesterov = options.nesterov();
+    // CUDA parameters by device, dtype and whether their momentum buffers are
+    // initialized by this step
+    std::map<std::tuple<int64_t, ScalarType, bool>, FusedSGDBucket> fused_buckets;
 
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
       }
+      auto param_state = state_.find(c10::guts::to_string(p.unsafeGetTensorImpl()));
+      const bool first_step = param_state == state_.end();
+      Tensor fused_buffer;
+      if (momentum != 0) {
+        fused_buffer = first_step
+            ? Tensor()
+            : static_cast<SGDParamState&>(*param_state->second).momentum_buffer();
+      }
+      if (can_use_fused_sgd(p, p.grad(), fused_buffer)) {
+        auto& bucket = fused_buckets[std::make_tuple(
+            p.device().index(), p.scalar_type(), momentum != 0 && first_step)];
+        if (momentum != 0) {
+          if (first_step) {
+            // written with the grad by the kernel
+            fused_buffer = torch::empty_like(p, MemoryFormat::Preserve);
+            auto state = std::make_unique<SGDParamState>();
+            state->momentum_buffer(fused_buffer);
+            state_[c10::guts::to_string(p.unsafeGetTensorImpl())] = std::move(state);
+          }
+          bucket.momentum_buffers.push_back(fused_buffer);
+        }
+        bucket.params.push_back(p);
+        bucket.grads.push_back(p.grad());
+        continue;
+      }
+
       auto d_p = p.grad().data();
       if (weight_decay != 0) {
         d_p = d_p.add(p.data(), weight_decay);
       }
       if (momentum != 0) {
         Tensor buf;
-        auto param_state = state_.find(c10::guts::to_string(p.unsafeGetTensorImpl()));
-        if(param_state == state_.end()) {
+        if(first_step) {
           buf = torch::clone(d_p).detach();
           auto state = std::make_unique<SGDParamState>();
           state->momentum_buffer(buf);
@@ -94,6 +143,21 @@ Tensor SGD::step(LossClosure closure)  {
       }
       p.data().add_(d_p, -1 * options.lr());
     }
+
+    for (auto& it : fused_buckets) {
+      auto& bucket = it.second;
+      at::_fused_sgd_(
+          bucket.params,
+          bucket.grads,
+          bucket.momentum_buffers,
+          /*model_params=*/{},
+          options.lr(),
+          momentum,
+          dampening,
+          weight_decay,
+          nesterov,
+          /*first_step=*/std::get<2>(it.first));
+    }
   }
   return loss;
 }
@@ -638,7 +638,7 @@ at::IntArrayRef strides_or_error(const Tensor & input, c10::string_view const &
   // check.
   if (input.requires_grad()) {
     TORCH_CHECK(
-      !input.is_sparse(),
+      !input.is_sparse() && !input.is_sparse_csr(),
       "The backward pass for this operation requires the '", input_name,
       "' tensor to be strided, but a sparse tensor was given instead. ",
       "Please either use a strided tensor or set requires_grad=False for '",
@@ -660,6 +660,11 @@ Tensor mm_mat1_backward(const Tensor & grad, const Tensor & mat2, at::IntArrayRe
 }
 
 Tensor mm_mat2_backward(const Tensor & grad, const Tensor & mat1, IntArrayRef sizes, IntArrayRef strides, const Scalar & alpha) {
+  if (mat1.is_sparse_csr()) {
+    // A sparse CSR matrix can't be transposed, but it can be multiplied as
+    // if it were.
+    return maybe_multiply(at::_sparse_csr_transposed_mm(mat1, grad), alpha.conj());
+  }
   // if input was column-major, return grad as column-order for efficiency
   if (strides[0] == 1 && strides[1] == sizes[0]) {
     if (mat1.is_sparse()) {
@@ -679,6 +684,14 @@ Tensor mm_mat2_backward(const Tensor & grad, const Tensor & mat1, IntArrayRef si
   }
 }
 
+Tensor values_backward(const Tensor& grad, const Tensor& self) {
+  if (self.is_sparse_csr()) {
+    return at::_sparse_csr_tensor_unsafe(
+        self.crow_indices(), self.col_indices(), grad, self.sizes(), grad.options().layout(at::kSparseCsr));
+  }
+  return at::_sparse_coo_tensor_unsafe(self.indices(), grad, self.sizes())._coalesced_(true);
+}
+
 Tensor _sparse_addmm_sparse_backward(const Tensor& grad, const Tensor& sparse_, const Tensor& dense, const Scalar& alpha) {
   AT_ASSERT(sparse_.is_sparse());
   auto sparse = sparse_.coalesce();
@@ -914,6 +927,35 @@ Tensor var_std_mean_backward(const variable_list& grads, const Tensor & self, co
   return grad;
 }
 
+Tensor aminmax_var_mean_backward(const variable_list& grads, const Tensor & self, const Tensor & min, const Tensor & max, IntArrayRef dim, bool unbiased, bool keepdim) {
+  // an empty dim reduces all the dims
+  std::vector<int64_t> all_dims;
+  if (dim.empty()) {
+    all_dims.resize(self.dim());
+    std::iota(all_dims.begin(), all_dims.end(), 0);
+    dim = all_dims;
+  }
+  Tensor grad;
+  auto accumulate = [&](Tensor g) {
+    grad = grad.defined() ? grad + g : g;
+  };
+  // the gradient of the min and the max is evenly distributed between the
+  // elements equal to them, as for amin and amax
+  if (grads[0].defined()) {
+    accumulate(scale_grad_by_count(restore_reduced_dims(grads[0], dim, keepdim), restore_reduced_dims(min, dim, keepdim) == self, dim));
+  }
+  if (grads[1].defined()) {
+    accumulate(scale_grad_by_count(restore_reduced_dims(grads[1], dim, keepdim), restore_reduced_dims(max, dim, keepdim) == self, dim));
+  }
+  if (grads[2].defined()) {
+    accumulate(var_backward(grads[2], self, dim, unbiased, keepdim));
+  }
+  if (grads[3].defined()) {
+    accumulate(mean_backward(grads[3], self.sizes(), dim, keepdim));
+  }
+  return grad;
+}
+
 Tensor masked_scatter_backward(const Tensor & grad, const Tensor & mask, IntArrayRef sizes) {
   int64_t numel = 1;
   for (auto size : sizes) {
@@ -2822,6 +2864,88 @@ infinitely_differentiable_native_layer_norm_backward(
   return std::make_tuple(dX, dgamma, dbeta);
 }
 
+// Gradients of _add_layer_norm for input, residual, weight and bias. The sum
+// = residual + input * noise receives the gradient of the normalization and
+// the gradient of the sum output, if it is used; input and residual may have
+// been broadcast to it.
+std::tuple<Tensor, Tensor, Tensor, Tensor> add_layer_norm_backward(
+    const Tensor& grad_out,
+    const Tensor& grad_sum,
+    IntArrayRef input_sizes,
+    IntArrayRef residual_sizes,
+    const Tensor& sum,
+    const Tensor& noise,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const c10::optional<Tensor>& weight,
+    const c10::optional<Tensor>& bias,
+    IntArrayRef normalized_shape,
+    double eps,
+    std::array<bool, 4> grad_input_mask) {
+  Tensor dsum;
+  Tensor dweight;
+  Tensor dbias;
+  if (grad_out.defined()) {
+    const std::array<bool, 3> layer_norm_mask{
+        grad_input_mask[0] || grad_input_mask[1],
+        grad_input_mask[2],
+        grad_input_mask[3]};
+    std::tie(dsum, dweight, dbias) = GradMode::is_enabled()
+        ? infinitely_differentiable_native_layer_norm_backward(
+              grad_out, Tensor(), Tensor(), sum, mean, rstd, weight,
+              normalized_shape, eps, layer_norm_mask)
+        : at::native_layer_norm_backward(
+              grad_out.is_contiguous() ? grad_out : grad_out.contiguous(),
+              sum, normalized_shape, mean, rstd, weight, bias, layer_norm_mask);
+  }
+  if (grad_sum.defined()) {
+    dsum = dsum.defined() ? dsum + grad_sum : grad_sum;
+  }
+  Tensor dinput;
+  Tensor dresidual;
+  if (dsum.defined()) {
+    if (grad_input_mask[0]) {
+      dinput = at::sum_to(noise.defined() ? dsum * noise : dsum, input_sizes);
+    }
+    if (grad_input_mask[1]) {
+      dresidual = at::sum_to(dsum, residual_sizes);
+    }
+  }
+  return std::make_tuple(dinput, dresidual, dweight, dbias);
+}
+
+// The gradient of _log_softmax_nll_loss_forward is
+// grad * weight[target] * (softmax(self) - one_hot(target)) for every row.
+// With grad mode enabled it is computed with differentiable operations from
+// the softmax of self, instead of the saved logsumexp, so that it can be
+// differentiated again.
+Tensor log_softmax_nll_loss_backward(
+    const Tensor& grad,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t reduction,
+    int64_t ignore_index,
+    const Tensor& lse,
+    const Tensor& total_weight) {
+  if (!GradMode::is_enabled()) {
+    return at::_log_softmax_nll_loss_backward(
+        grad, self, target, weight, reduction, ignore_index, lse, total_weight);
+  }
+  auto keep = target != ignore_index;
+  auto safe_target = target.masked_fill(keep.logical_not(), 0);
+  auto row_weights = weight.defined() ? weight.index_select(0, safe_target)
+                                      : at::ones_like(target, self.options());
+  auto grad_rows = grad;
+  if (reduction != at::Reduction::None) {
+    grad_rows = (reduction == at::Reduction::Mean ? grad / total_weight : grad)
+                    .expand({self.size(0)});
+  }
+  grad_rows = (grad_rows * row_weights * keep).unsqueeze(1);
+  return (at::softmax(self, 1) * grad_rows)
+      .scatter_add(1, safe_target.unsqueeze(1), -grad_rows);
+}
+
 std::tuple<Tensor, Tensor, Tensor>
 infinitely_differentiable_native_group_norm_backward(
     const Tensor& dY,
@@ -2970,6 +3094,36 @@ Tensor embedding_dense_double_backward(const Tensor & grad, const Tensor & indic
   return gg_weight.view(size);
 }
 
+std::vector<Tensor> embedding_bag_multi_backward(const variable_list& grads, TensorList indices, TensorList offsets,
+                                                 const std::vector<std::vector<int64_t>>& weight_sizes,
+                                                 const std::vector<ScalarType>& weight_dtypes,
+                                                 int64_t mode, bool sparse, bool include_last_offset) {
+  // it's possible some of the grads are not defined (the output of a table
+  // wasn't used). Since the fused backward takes all tables, let's define them
+  std::vector<Tensor> grads_all_defined(grads.size());
+  std::vector<int64_t> num_weights(grads.size());
+  for (size_t t = 0; t < grads.size(); ++t) {
+    num_weights[t] = weight_sizes[t][0];
+    if (grads[t].defined()) {
+      grads_all_defined[t] = grads[t];
+    } else {
+      const int64_t num_bags = offsets[t].size(0) - (include_last_offset ? 1 : 0);
+      grads_all_defined[t] = at::zeros({num_bags, weight_sizes[t][1]},
+                                       offsets[t].options().dtype(weight_dtypes[t]));
+    }
+  }
+  return at::_embedding_bag_multi_backward(grads_all_defined, indices, offsets, num_weights,
+                                           mode, sparse, include_last_offset);
+}
+
+Tensor index_add_segments_source_backward(const Tensor& grad, int64_t dim, const Tensor& perm, const Tensor& offsets) {
+  // The destination of source.select(dim, perm[k]) is the segment of k
+  const int64_t num_segments = offsets.numel() - 1;
+  auto lengths = offsets.narrow(0, 1, num_segments) - offsets.narrow(0, 0, num_segments);
+  auto index = at::empty_like(perm).index_copy_(0, perm, at::repeat_interleave(lengths));
+  return grad.index_select(dim, index);
+}
+
 Tensor index_backward(Tensor zeros_like_self, const torch::List<c10::optional<Tensor>>& indices, const Tensor& grad) {
   return at::_index_put_impl_(zeros_like_self, indices, grad, true, true);
 }
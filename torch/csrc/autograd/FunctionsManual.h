@@ -83,6 +83,7 @@ at::Tensor clamp_backward(const at::Tensor & grad, const at::Tensor &self, const
 at::IntArrayRef strides_or_error(const Tensor & input, c10::string_view const & input_name);
 at::Tensor mm_mat1_backward(const Tensor & grad, const Tensor & mat2, at::IntArrayRef mat1_sizes, at::IntArrayRef mat1_strides, const Scalar & alpha);
 at::Tensor mm_mat2_backward(const at::Tensor & grad, const at::Tensor & mat1, at::IntArrayRef sizes, at::IntArrayRef strides, const at::Scalar & alpha);
+at::Tensor values_backward(const at::Tensor& grad, const at::Tensor& self);
 at::Tensor _sparse_addmm_sparse_backward(const at::Tensor& grad, const at::Tensor& sparse_, const at::Tensor& dense, const at::Scalar& alpha);
 at::Tensor sparse_sparse_matmul_backward(const at::Tensor& grad, const at::Tensor& mat1, const at::Tensor& mat2,int64_t grad_order);
 at::Tensor renorm_backward(const at::Tensor & grad, const at::Tensor & self, at::Scalar p, int64_t dim, at::Scalar maxnorm);
@@ -98,6 +99,7 @@ at::Tensor mean_backward(at::Tensor grad, const at::IntArrayRef sizes, at::IntAr
 at::Tensor mean_backward(at::Tensor grad, const at::IntArrayRef sizes, int numel);
 at::Tensor var_std_mean_backward(const variable_list& grads, const at::Tensor & self, const at::Tensor & r1, const at::Tensor & r2, at::IntArrayRef dim, bool unbiased, bool keepdim, bool is_std);
 at::Tensor var_std_mean_backward(const variable_list& grads, const at::Tensor & self, const at::Tensor & r1, const at::Tensor & r2, bool unbiased, bool is_std);
+at::Tensor aminmax_var_mean_backward(const variable_list& grads, const at::Tensor & self, const at::Tensor & min, const at::Tensor & max, at::IntArrayRef dim, bool unbiased, bool keepdim);
 at::Tensor masked_scatter_backward(const at::Tensor & grad, const at::Tensor & mask, at::IntArrayRef sizes);
 at::Tensor cholesky_backward(at::Tensor grad, bool upper, at::Tensor L);
 at::Tensor cholesky_inverse_backward(at::Tensor grad, at::Tensor L, bool upper, at::Tensor inverse);
@@ -130,6 +132,8 @@ at::Tensor slogdet_backward(const at::Tensor& grad_logabsdet, const at::Tensor&
 at::Tensor log1p_backward(const at::Tensor& grad, const at::Tensor& self);
 at::Tensor sparse_constructor_values_backward(const at::Tensor& sparse_grad_out, const at::Tensor& indices, at::IntArrayRef values_shape);
 at::Tensor embedding_dense_double_backward(const at::Tensor & grad, const at::Tensor & indices, int64_t padding_idx);
+std::vector<at::Tensor> embedding_bag_multi_backward(const variable_list& grads, at::TensorList indices, at::TensorList offsets, const std::vector<std::vector<int64_t>>& weight_sizes, const std::vector<ScalarType>& weight_dtypes, int64_t mode, bool sparse, bool include_last_offset);
+at::Tensor index_add_segments_source_backward(const at::Tensor& grad, int64_t dim, const at::Tensor& perm, const at::Tensor& offsets);
 at::Tensor index_backward(at::Tensor zeros_like_self, const torch::List<c10::optional<Tensor>>& indices, const at::Tensor& grad);
 at::Tensor _cudnn_ctc_loss_backward(const at::Tensor& grad_out, const at::Tensor& loss, const at::Tensor& raw_grad, bool zero_infinity);
 at::Tensor elu_double_backward(const Tensor& grad, const Tensor& grad_output, Scalar alpha, Scalar scale, Scalar input_scale, bool is_result, const Tensor& self_or_result);
@@ -222,6 +226,31 @@ infinitely_differentiable_native_layer_norm_backward(
     double eps,
     std::array<bool, 3> grad_input_mask);
 
+std::tuple<Tensor, Tensor, Tensor, Tensor> add_layer_norm_backward(
+    const Tensor& grad_out,
+    const Tensor& grad_sum,
+    IntArrayRef input_sizes,
+    IntArrayRef residual_sizes,
+    const Tensor& sum,
+    const Tensor& noise,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const c10::optional<Tensor>& weight,
+    const c10::optional<Tensor>& bias,
+    IntArrayRef normalized_shape,
+    double eps,
+    std::array<bool, 4> grad_input_mask);
+
+Tensor log_softmax_nll_loss_backward(
+    const Tensor& grad,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t reduction,
+    int64_t ignore_index,
+    const Tensor& lse,
+    const Tensor& total_weight);
+
 
 } // namespace details
 } // namespace generated
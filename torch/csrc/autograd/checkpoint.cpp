@@ -0,0 +1,281 @@
+#include <torch/csrc/autograd/checkpoint.h>
+
+#include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/autograd/saved_variable_hooks.h>
+
+#include <ATen/CPUGeneratorImpl.h>
+#include <ATen/detail/CUDAHooksInterface.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace torch { namespace autograd {
+
+namespace {
+
+// The states of the CPU generator and of the default CUDA generators of the
+// devices of the inputs
+struct GeneratorStates {
+  static GeneratorStates of(const variable_list& inputs) {
+    GeneratorStates states;
+    states.add(at::detail::getDefaultCPUGenerator());
+    for (const auto& input : inputs) {
+      if (input.defined() && input.is_cuda()) {
+        states.add(at::detail::getCUDAHooks().getDefaultCUDAGenerator(
+            input.device().index()));
+      }
+    }
+    return states;
+  }
+
+  // Sets these states, and returns the ones they replace
+  GeneratorStates set() const {
+    GeneratorStates previous;
+    for (const auto& state : states_) {
+      at::Generator generator = state.first;
+      std::lock_guard<std::mutex> lock(generator.mutex());
+      previous.states_.emplace_back(generator, generator.get_state());
+      generator.set_state(state.second);
+    }
+    return previous;
+  }
+
+ private:
+  void add(at::Generator generator) {
+    for (const auto& state : states_) {
+      if (state.first.device() == generator.device()) {
+        return;
+      }
+    }
+    std::lock_guard<std::mutex> lock(generator.mutex());
+    at::Tensor state = generator.get_state();
+    states_.emplace_back(std::move(generator), std::move(state));
+  }
+
+  std::vector<std::pair<at::Generator, at::Tensor>> states_;
+};
+
+struct GeneratorStatesGuard {
+  explicit GeneratorStatesGuard(const GeneratorStates& states)
+      : previous_(states.set()) {}
+  ~GeneratorStatesGuard() {
+    previous_.set();
+  }
+
+ private:
+  GeneratorStates previous_;
+};
+
+struct DefaultHooksGuard {
+  explicit DefaultHooksGuard(SavedVariableHooksFactory factory) {
+    impl::push_default_saved_variable_hooks(std::move(factory));
+  }
+  ~DefaultHooksGuard() {
+    impl::pop_default_saved_variable_hooks();
+  }
+};
+
+// Thrown out of fn by the pack hook of the last dropped tensor when it's
+// recomputed. It's not a std::exception, so that fn doesn't catch it by
+// mistake.
+struct StopRecomputation {};
+
+// What the saved variables of a run of a checkpointed function share. The
+// saved tensors are numbered in the order fn saves them, which is the same in
+// every run.
+struct CheckpointState {
+  CheckpointState(
+      CheckpointFunction fn,
+      const variable_list& inputs,
+      CheckpointPolicy policy)
+      : fn_(std::move(fn)),
+        inputs_(inputs),
+        policy_(std::move(policy)),
+        generator_states_(GeneratorStates::of(inputs)) {
+    versions_.reserve(inputs.size());
+    for (const auto& input : inputs) {
+      versions_.push_back(
+          input.defined() ? impl::version_counter(input).current_version() : 0);
+    }
+  }
+
+  size_t next_index() {
+    return num_saved_++;
+  }
+
+  bool keeps(const Variable& saved) const {
+    return policy_ && policy_(saved);
+  }
+
+  void drop(size_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dropped_.insert(index);
+  }
+
+  // The saved variable of a dropped tensor was released, e.g. after its node
+  // ran and the graph is not retained
+  void release(size_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dropped_.erase(index);
+    recomputed_tensors_.erase(index);
+  }
+
+  at::Tensor unpack(size_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!recomputed_) {
+      recompute();
+      recomputed_ = true;
+    }
+    auto it = recomputed_tensors_.find(index);
+    TORCH_INTERNAL_ASSERT(
+        it != recomputed_tensors_.end(),
+        "Saved tensor ", index, " of a checkpointed function was not recomputed");
+    return it->second;
+  }
+
+  // Called by the pack hooks of the recomputation
+  void record(size_t index, const at::Tensor& tensor) {
+    if (dropped_.count(index) > 0) {
+      recomputed_tensors_.emplace(index, tensor);
+    }
+    if (index == last_dropped_) {
+      throw StopRecomputation();
+    }
+  }
+
+ private:
+  void recompute() {
+    for (size_t i = 0; i < inputs_.size(); ++i) {
+      TORCH_CHECK(
+          !inputs_[i].defined() ||
+              impl::version_counter(inputs_[i]).current_version() == versions_[i],
+          "Input ", i, " of a checkpointed function was modified by an inplace "
+          "operation before the function was recomputed in backward");
+    }
+    if (dropped_.empty()) {
+      return;
+    }
+    last_dropped_ = *std::max_element(dropped_.begin(), dropped_.end());
+
+    // The inputs are detached so that the recomputation is not part of the
+    // graph, but they require grad as in the first run, for fn to save the
+    // same tensors
+    variable_list inputs;
+    inputs.reserve(inputs_.size());
+    for (const auto& input : inputs_) {
+      inputs.push_back(
+          input.defined() ? input.detach().requires_grad_(input.requires_grad())
+                          : input);
+    }
+
+    struct RecordingHooks : public SavedVariableHooks {
+      RecordingHooks(CheckpointState& state, size_t index)
+          : state_(state), index_(index) {}
+      void call_pack_hook(const at::Tensor& tensor) override {
+        state_.record(index_, tensor);
+      }
+      at::Tensor call_unpack_hook() override {
+        TORCH_INTERNAL_ASSERT(
+            false, "The recomputation of a checkpointed function can't be backpropagated through");
+      }
+
+     private:
+      CheckpointState& state_;
+      size_t index_;
+    };
+
+    bool stopped = false;
+    {
+      AutoGradMode enable_grad(true);
+      GeneratorStatesGuard generator_guard(generator_states_);
+      size_t next_index = 0;
+      DefaultHooksGuard hooks_guard([this, &next_index]() {
+        return std::make_unique<RecordingHooks>(*this, next_index++);
+      });
+      try {
+        fn_(inputs);
+      } catch (const StopRecomputation&) {
+        stopped = true;
+      }
+    }
+    TORCH_CHECK(
+        stopped,
+        "A checkpointed function saved fewer tensors for backward when it was "
+        "recomputed than in its first run. It must run the same ops every time.");
+  }
+
+  CheckpointFunction fn_;
+  variable_list inputs_;
+  std::vector<uint32_t> versions_;
+  CheckpointPolicy policy_;
+  GeneratorStates generator_states_;
+  size_t num_saved_ = 0;
+
+  std::mutex mutex_;
+  // The saved tensors that are not kept, and whose saved variables are alive
+  std::unordered_set<size_t> dropped_;
+  size_t last_dropped_ = 0;
+  bool recomputed_ = false;
+  std::unordered_map<size_t, at::Tensor> recomputed_tensors_;
+};
+
+struct CheckpointHooks : public SavedVariableHooks {
+  CheckpointHooks(std::shared_ptr<CheckpointState> state, size_t index)
+      : state_(std::move(state)), index_(index) {}
+
+  ~CheckpointHooks() override {
+    if (dropped_) {
+      state_->release(index_);
+    }
+  }
+
+  void call_pack_hook(const at::Tensor& tensor) override {
+    dropped_ = true;
+    state_->drop(index_);
+  }
+
+  void call_pack_hook_with_variable(const at::Tensor& tensor, const at::Tensor& variable) override {
+    if (state_->keeps(variable)) {
+      kept_ = tensor;
+    } else {
+      call_pack_hook(tensor);
+    }
+  }
+
+  at::Tensor call_unpack_hook() override {
+    return dropped_ ? state_->unpack(index_) : kept_;
+  }
+
+ private:
+  std::shared_ptr<CheckpointState> state_;
+  size_t index_;
+  bool dropped_ = false;
+  at::Tensor kept_;
+};
+
+} // namespace
+
+variable_list checkpoint(
+    const CheckpointFunction& fn,
+    const variable_list& inputs,
+    CheckpointPolicy policy) {
+  auto state = std::make_shared<CheckpointState>(fn, inputs, std::move(policy));
+  DefaultHooksGuard hooks_guard([state]() {
+    return std::make_unique<CheckpointHooks>(state, state->next_index());
+  });
+  return fn(inputs);
+}
+
+CheckpointPolicy keep_outputs_of(std::unordered_set<std::string> node_names) {
+  return [node_names = std::move(node_names)](const Variable& saved) {
+    const auto& grad_fn = saved.grad_fn();
+    return grad_fn && node_names.count(grad_fn->name()) > 0;
+  };
+}
+
+}} // namespace torch::autograd
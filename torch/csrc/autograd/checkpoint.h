@@ -0,0 +1,43 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/variable.h>
+
+#include <functional>
+#include <string>
+#include <unordered_set>
+
+namespace torch { namespace autograd {
+
+using CheckpointFunction = std::function<variable_list(const variable_list&)>;
+
+/// Decides which of the tensors saved for backward by a checkpointed function
+/// are kept, instead of being recomputed. It's given each saved variable, with
+/// its `grad_fn`, which is the node of the op that computed it (or null for
+/// the inputs of the function and the other leaves).
+using CheckpointPolicy = std::function<bool(const Variable& saved)>;
+
+/// Runs `fn(inputs)` without keeping the tensors its ops save for backward,
+/// except for the ones `policy` keeps (none by default). The first time
+/// backward needs one of the others, `fn` is run again from the same inputs,
+/// and with the same CPU and CUDA random number generator states, on the
+/// thread of the backward node. The recomputation is not recorded by
+/// autograd: the tensors it saves replace the dropped ones, and it stops as
+/// soon as the last of them is saved, so the ops after it are not run again.
+///
+/// Unlike `torch.utils.checkpoint`, backward is not reentrant: the graph
+/// recorded by the first run of `fn` is the one that computes the gradients,
+/// in the same GraphTask as the rest of the model. `fn` must therefore run the
+/// same ops every time, and the inputs must not be modified in-place before
+/// backward.
+TORCH_API variable_list checkpoint(
+    const CheckpointFunction& fn,
+    const variable_list& inputs,
+    CheckpointPolicy policy = nullptr);
+
+/// A policy keeping the tensors computed by the ops with the given backward
+/// nodes, e.g. `{"MmBackward", "AddmmBackward"}` to keep the outputs of matrix
+/// multiplications and recompute the cheaper pointwise ops between them.
+TORCH_API CheckpointPolicy keep_outputs_of(std::unordered_set<std::string> node_names);
+
+}} // namespace torch::autograd
@@ -156,6 +156,27 @@ static thread_local std::shared_ptr<ReadyQueue> local_ready_queue = nullptr;
 // the leaf streams with the default streams is sufficient to implement
 // the historic behavior.
 
+// Note [Multithreaded CPU backward]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// By default, all the CPU nodes of a backward call run on the thread that
+// called it, so the independent branches of a wide graph run one after the
+// other. With Engine::set_num_cpu_threads(n) and n > 1, a backward call
+// that is not reentrant also wakes up n - 1 threads of the reentrant thread
+// pool (see Note [Reentrant backwards]). They run thread_main on the
+// cpu_ready_queue_ of the GraphTask, exactly like a reentrant thread, so the
+// calling thread and the helpers pop the ready NodeTasks of the same heap, in
+// the usual order of reentrant depth and sequence_nr, and run them
+// concurrently. The nodes of a graph must already be safe to run concurrently
+// with each other, since device threads run at the same time as the CPU
+// thread.
+//
+// Several threads can now wait on the same CPU ready queue, so the dummy task
+// sent on completion may not reach the thread that waits for that GraphTask.
+// Threads running thread_main for a GraphTask wait with
+// ReadyQueue::pop(graph_task), which also returns once the GraphTask is
+// completed, and the completion of a GraphTask owned by a CPU thread calls
+// ReadyQueue::notifyAll on its queue.
+
 int NodeTask::getReentrantDepth() const {
   std::shared_ptr<GraphTask> graph_task = base_.lock();
   if (graph_task) {
@@ -169,14 +190,16 @@ int NodeTask::getReentrantDepth() const {
 }
 
 auto ReadyQueue::push(NodeTask item, bool incrementOutstandingTasks) -> void {
+  // outstanding_tasks_ is atomic and only needs to be incremented before the
+  // task can be popped, so it is kept out of the critical section.
+  if (incrementOutstandingTasks) {
+    std::shared_ptr<GraphTask> graph_task = item.base_.lock();
+    TORCH_INTERNAL_ASSERT(graph_task, "GraphTask is no longer valid!");
+    ++graph_task->outstanding_tasks_;
+  }
   {
     // Lock mutex for writing to heap_
     std::lock_guard<std::mutex> lock(mutex_);
-    if (incrementOutstandingTasks) {
-      std::shared_ptr<GraphTask> graph_task = item.base_.lock();
-      TORCH_INTERNAL_ASSERT(graph_task, "GraphTask is no longer valid!");
-      ++graph_task->outstanding_tasks_;
-    }
     heap_.push(std::move(item));
   }
   not_empty_.notify_one();
@@ -205,13 +228,39 @@ auto ReadyQueue::pop() -> NodeTask {
   return task;
 }
 
+auto ReadyQueue::pop(const std::shared_ptr<GraphTask>& graph_task) -> NodeTask {
+  if (!graph_task) {
+    return pop();
+  }
+  // Lock mutex for accesses to heap_
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_empty_.wait(lock, [this, &graph_task]{
+    return !heap_.empty() || graph_task->future_result_->completed();
+  });
+  if (heap_.empty()) {
+    return NodeTask({}, nullptr, InputBuffer(0));
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  auto task = std::move(const_cast<NodeTask&>(heap_.top())); heap_.pop();
+  return task;
+}
+
+void ReadyQueue::notifyAll() {
+  {
+    // The waiters check their predicate under mutex_, so taking it here
+    // ensures that none of them misses the notification.
+    std::lock_guard<std::mutex> lock(mutex_);
+  }
+  not_empty_.notify_all();
+}
+
 bool ReadyQueue::empty() const {
   // Lock mutex for accesses to heap_
   std::unique_lock<std::mutex> lock(mutex_);
   return heap_.empty();
 }
 
-Engine::Engine() : max_recursion_depth_(MAX_DEPTH), non_reentrant_device_thread_count_(0) {}
+Engine::Engine() : max_recursion_depth_(MAX_DEPTH), num_cpu_threads_(1), non_reentrant_device_thread_count_(0) {}
 
 // Send shutdown tasks to all device_ready_queues_ if no backward tasks are running
 // Even though readyQueue should be empty, shutdown tasks have the highest priority
@@ -243,6 +292,15 @@ void Engine::release_workers() {
   non_reentrant_device_thread_condvar_.notify_one();
 }
 
+void Engine::set_num_cpu_threads(int num_threads) {
+  TORCH_CHECK(num_threads > 0, "Expected a positive number of autograd CPU threads, got ", num_threads);
+  num_cpu_threads_.store(num_threads);
+}
+
+int Engine::num_cpu_threads() const {
+  return num_cpu_threads_.load();
+}
+
 void Engine::increment_non_reentrant_thread_count() {
   std::unique_lock<std::mutex> lk(non_reentrant_device_thread_mutex_);
   non_reentrant_device_thread_count_.fetch_add(1);
@@ -353,7 +411,7 @@ auto Engine::thread_main(const std::shared_ptr<GraphTask>& graph_task) -> void {
       // Scope this block of execution since NodeTask is not needed after this
       // block and can be deallocated (release any references to grad tensors
       // as part of inputs_).
-      NodeTask task = local_ready_queue->pop();
+      NodeTask task = local_ready_queue->pop(graph_task);
       // This will only work if the worker is running a non backward task
       // TODO Needs to be fixed this to work in all cases
       if (task.isShutdownTask_) {
@@ -405,6 +463,11 @@ auto Engine::thread_main(const std::shared_ptr<GraphTask>& graph_task) -> void {
         ready_queue_by_index(local_graph_task->cpu_ready_queue_, base_owner)
             ->push(NodeTask(local_graph_task, nullptr, InputBuffer(0)));
       }
+      // Other CPU threads can wait for this graph_task on the same queue.
+      // See Note [Multithreaded CPU backward]
+      if (base_owner == CPU_DEVICE) {
+        local_graph_task->cpu_ready_queue_->notifyAll();
+      }
     }
   }
 }
@@ -932,6 +995,12 @@ std::shared_ptr<at::ivalue::Future> Engine::execute_with_graph_task(
     // we can enqueue it.
     queue->push(NodeTask(graph_task, std::move(graph_root), std::move(input_buffer)));
 
+    // See Note [Multithreaded CPU backward]
+    const int num_cpu_threads = num_cpu_threads_.load();
+    for (int i = 1; i < num_cpu_threads; ++i) {
+      add_thread_pool_task(graph_task);
+    }
+
     // The owning thread start to drive the engine execution for any CPU task that
     // was just pushed or will be added later from other worker threads
     lock.unlock();
@@ -249,6 +249,13 @@ struct ReadyQueue {
   void push(NodeTask item, bool incrementOutstandingTasks = true);
   void pushShutdownTask();
   NodeTask pop();
+  // Like pop(), but also returns an empty NodeTask once graph_task is
+  // completed, for threads that may share the queue with other CPU workers.
+  // See Note [Multithreaded CPU backward]
+  NodeTask pop(const std::shared_ptr<GraphTask>& graph_task);
+  // Wakes up all the threads waiting in pop(graph_task) to check if their
+  // graph_task is completed.
+  void notifyAll();
   bool empty() const;
   size_t size() const;
 };
@@ -312,6 +319,12 @@ struct TORCH_API Engine {
   // Should be called after fork to notify that worker threads are gone
   void release_workers();
 
+  // Number of threads running the CPU nodes of a backward call, including the
+  // calling thread. 1, the default, runs them all on the calling thread.
+  // See Note [Multithreaded CPU backward]
+  void set_num_cpu_threads(int num_threads);
+  int num_cpu_threads() const;
+
   // Initializes a device thread for the autograd engine.
   virtual void thread_init(
       int device,
@@ -354,6 +367,9 @@ struct TORCH_API Engine {
   // How many nested reentrant calls are allowed until a new thread is used
   int max_recursion_depth_;
 
+  // See Note [Multithreaded CPU backward]
+  std::atomic<int> num_cpu_threads_;
+
   struct ThreadPoolShared {
     // Data structures used by the threads for executing reentrant backwards
     // tasks. See Note [Reentrant backwards]
@@ -14,6 +14,8 @@ using at::Tensor;
 
 namespace torch { namespace autograd {
 
+bool SparseGradDeduplicationMode::_enabled = false;
+
 // AccumulateGrad sets sequence_nr to the max value so it's always called
 // ASAP during backwards.
 AccumulateGrad::AccumulateGrad(Variable variable_)
@@ -22,6 +22,22 @@ namespace torch { namespace autograd {
     } \
   }
 
+// Whether AccumulateGrad sums the CPU sparse gradients of a single sparse
+// dimension (such as those of embedding(sparse=True)) into a coalesced buffer,
+// in which the rows are deduplicated by hashing, instead of concatenating
+// their indices until they get coalesced by the optimizer.
+struct TORCH_API SparseGradDeduplicationMode {
+  static bool is_enabled() {
+    return _enabled;
+  }
+  static void set_enabled(bool enabled) {
+    _enabled = enabled;
+  }
+
+ private:
+  static bool _enabled;
+};
+
 struct TORCH_API AccumulateGrad : public Node {
   explicit AccumulateGrad(Variable variable_);
 
@@ -36,6 +52,22 @@ struct TORCH_API AccumulateGrad : public Node {
     return new_grad;
   }
 
+  static bool deduplicates_sparse_grad(const at::Tensor& new_grad) {
+    return SparseGradDeduplicationMode::is_enabled() && new_grad.is_sparse() &&
+        new_grad.sparse_dim() == 1 && new_grad.device().is_cpu();
+  }
+
+  // A zeroed grad may have lost its sparse dimensions, the accumulation
+  // restores them
+  static bool deduplicates_sparse_grad(
+      const at::Tensor& variable_grad,
+      const at::Tensor& new_grad) {
+    return deduplicates_sparse_grad(new_grad) && variable_grad.is_sparse() &&
+        (variable_grad.sparse_dim() == 1 || variable_grad._nnz() == 0) &&
+        variable_grad.device().is_cpu() &&
+        variable_grad.scalar_type() == new_grad.scalar_type();
+  }
+
   // Given a variable with its current grad as variable_grad, accumulates
   // new_grad into variable_grad if in place accumulation is possible.
   // Otherwise, uses 'update_grad' to update the grad for the variable.
@@ -108,6 +140,12 @@ struct TORCH_API AccumulateGrad : public Node {
         // new_grad obeys the "Gradient Layout Contract"
         // Under these conditions, we can steal new_grad without a deep copy.
         update_grad(new_grad.detach());
+      } else if (!GradMode::is_enabled() && deduplicates_sparse_grad(new_grad)) {
+        // The buffer into which the next gradients get accumulated
+        auto grad = at::_sparse_coo_tensor_with_dims(
+            1, new_grad.dense_dim(), new_grad.sizes(), new_grad.options());
+        at::_sparse_accumulate_rows_(grad, new_grad);
+        update_grad(std::move(grad));
       } else if (
           !GradMode::is_enabled() && new_grad.is_sparse() &&
           new_grad._indices().is_contiguous() &&
@@ -155,6 +193,9 @@ struct TORCH_API AccumulateGrad : public Node {
         auto result = new_grad + variable_grad;
         CHECK_RESULT(result, variable);
         update_grad(std::move(result));
+      } else if (deduplicates_sparse_grad(variable_grad, new_grad)) {
+        // Accumulates in place, like the case below, without duplicate rows
+        at::_sparse_accumulate_rows_(variable_grad, new_grad);
       } else if (!at::inplaceIsVmapCompatible(variable_grad, new_grad)) {
         // Ideally we'd perform an in-place operation to avoid changing
         // the grad tensor. However, if that's impossible because the grads
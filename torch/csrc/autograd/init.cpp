@@ -1,17 +1,74 @@
 #include <torch/csrc/python_headers.h>
 
 #include <c10/core/DeviceType.h>
+#include <c10/core/InferenceMode.h>
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/utils/pybind.h>
 #include <torch/csrc/autograd/autograd.h>
+#include <torch/csrc/autograd/engine.h>
 #include <torch/csrc/autograd/grad_mode.h>
 #include <ATen/autocast_mode.h>
 #include <torch/csrc/autograd/profiler.h>
+#include <torch/csrc/autograd/profiler_sampling.h>
 #include <torch/csrc/autograd/python_function.h>
+#include <torch/csrc/autograd/python_saved_variable_hooks.h>
 #include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/functions/accumulate_grad.h>
 #include <torch/csrc/autograd/utils/wrap_outputs.h>
 #include <torch/csrc/autograd/utils/python_arg_parsing.h>
 #include <torch/csrc/utils/pycfunction_helpers.h>
+#include <torch/csrc/utils/python_strings.h>
+
+#include <algorithm>
+
+namespace {
+
+// The Python stacks of the sampling profiler
+std::unordered_map<uint64_t, std::vector<std::string>> samplingPythonStacks() {
+  std::unordered_map<uint64_t, std::vector<std::string>> stacks;
+#if PY_VERSION_HEX >= 0x03070000
+  if (!Py_IsInitialized()) {
+    return stacks;
+  }
+  pybind11::gil_scoped_acquire gil;
+  for (PyThreadState* state =
+           PyInterpreterState_ThreadHead(PyThreadState_Get()->interp);
+       state != nullptr;
+       state = PyThreadState_Next(state)) {
+    std::vector<std::string> frames;
+#if PY_VERSION_HEX >= 0x03090000
+    // Frames and codes are new references
+    PyFrameObject* frame = PyThreadState_GetFrame(state);
+    while (frame != nullptr) {
+      PyCodeObject* code = PyFrame_GetCode(frame);
+      frames.push_back(
+          THPUtils_unpackString(code->co_name) + " (" +
+          THPUtils_unpackString(code->co_filename) + ":" +
+          std::to_string(PyFrame_GetLineNumber(frame)) + ")");
+      Py_DECREF(code);
+      PyFrameObject* back = PyFrame_GetBack(frame);
+      Py_DECREF(frame);
+      frame = back;
+    }
+#else
+    for (PyFrameObject* frame = state->frame; frame != nullptr;
+         frame = frame->f_back) {
+      frames.push_back(
+          THPUtils_unpackString(frame->f_code->co_name) + " (" +
+          THPUtils_unpackString(frame->f_code->co_filename) + ":" +
+          std::to_string(PyFrame_GetLineNumber(frame)) + ")");
+    }
+#endif
+    if (!frames.empty()) {
+      std::reverse(frames.begin(), frames.end());
+      stacks[state->thread_id] = std::move(frames);
+    }
+  }
+#endif
+  return stacks;
+}
+
+} // namespace
 
 PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
   using namespace torch::autograd::profiler;
@@ -48,6 +105,10 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
   if (!ParameterClass)
     return nullptr;
 
+  // RAII guard held by torch.inference_mode
+  py::class_<c10::InferenceMode>(_C_m, "_InferenceMode")
+      .def(py::init<bool>());
+
   py::enum_<ProfilerState>(m, "ProfilerState")
       .value("Disabled", ProfilerState::Disabled)
       .value("CPU", ProfilerState::CPU)
@@ -82,7 +143,9 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       .def("scope", &LegacyEvent::scope)
       .def("correlation_id", &LegacyEvent::correlationId)
       .def("start_us", &LegacyEvent::cpuUs)
-      .def("flops", &LegacyEvent::flops);
+      .def("flops", &LegacyEvent::flops)
+      .def("bytes_read", &LegacyEvent::bytesRead)
+      .def("bytes_written", &LegacyEvent::bytesWritten);
 
   py::enum_<c10::DeviceType>(m, "DeviceType")
       .value("CPU", c10::DeviceType::CPU)
@@ -163,6 +226,13 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       // compute flops
       .def("flops", [](const KinetoEvent& e) {
         return e.flops();
+      })
+      // estimated bytes read and written
+      .def("bytes_read", [](const KinetoEvent& e) {
+        return e.bytesRead();
+      })
+      .def("bytes_written", [](const KinetoEvent& e) {
+        return e.bytesWritten();
       });
 
   py::class_<ProfilerResult>(m, "ProfilerResult")
@@ -185,6 +255,28 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       disableProfilerLegacy,
       py::arg("profiler_disable_options") = ProfilerDisableOptions());
   m.def("_profiler_enabled", profilerEnabled);
+
+  setSamplingPythonStacksFn(samplingPythonStacks);
+  m.def(
+      "_enable_sampling_profiler",
+      [](double frequency_hz, bool record_python) {
+        SamplingProfilerConfig config;
+        config.frequency_hz = frequency_hz;
+        config.record_python = record_python;
+        enableSamplingProfiler(config);
+      },
+      py::arg("frequency_hz") = 100.,
+      py::arg("record_python") = true);
+  // Joins the sampler, which may be waiting for the GIL
+  m.def(
+      "_disable_sampling_profiler",
+      disableSamplingProfiler,
+      py::call_guard<py::gil_scoped_release>());
+  m.def("_sampling_profiler_enabled", isSamplingProfilerEnabled);
+  m.def("_sampled_stacks", getSampledStacks);
+  m.def("_folded_stacks", getFoldedStacks);
+  m.def("_num_stack_samples", numStackSamples);
+  m.def("_reset_sampled_stacks", resetSampledStacks);
   m.def("_enable_record_function", [](bool enable) {
     at::enableRecordFunction(enable);
   });
@@ -202,6 +294,13 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
     at::clearCallbacks();
   });
 
+  m.def("_push_saved_tensors_default_hooks", [](py::function& pack_hook, py::function& unpack_hook) {
+    torch::autograd::push_py_saved_variable_default_hooks(pack_hook.ptr(), unpack_hook.ptr());
+  });
+  m.def("_pop_saved_tensors_default_hooks", []() {
+    torch::autograd::impl::pop_default_saved_variable_hooks();
+  });
+
   Py_RETURN_TRUE;
 }
 
@@ -227,6 +326,26 @@ static PyObject * is_autocast_enabled(PyObject* _unused, PyObject *arg) {
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * set_autocast_cpu_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!PyBool_Check(arg)) {
+    throw TypeError("enabled must be a bool (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  at::autocast::set_cpu_enabled(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * is_autocast_cpu_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (at::autocast::is_cpu_enabled()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
 static PyObject * clear_autocast_cache(PyObject* _unused, PyObject *arg) {
   HANDLE_TH_ERRORS
   at::autocast::clear_cache();
@@ -234,6 +353,55 @@ static PyObject * clear_autocast_cache(PyObject* _unused, PyObject *arg) {
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * set_autocast_persistent_cache_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!PyBool_Check(arg)) {
+    throw TypeError("enabled must be a bool (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  at::autocast::set_persistent_cache_enabled(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * is_autocast_persistent_cache_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (at::autocast::is_persistent_cache_enabled()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * set_autocast_persistent_cache_max_size(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!THPUtils_checkLong(arg)) {
+    throw TypeError("max_size must be an int (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  at::autocast::set_persistent_cache_max_size(THPUtils_unpackLong(arg));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * get_autocast_persistent_cache_max_size(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  return THPUtils_packInt64(at::autocast::get_persistent_cache_max_size());
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * get_autocast_persistent_cache_size(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  return THPUtils_packInt64(at::autocast::get_persistent_cache_size());
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * clear_autocast_persistent_cache(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  at::autocast::clear_persistent_cache();
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 static PyObject * autocast_increment_nesting(PyObject* _unused, PyObject *arg) {
   HANDLE_TH_ERRORS
   return THPUtils_packInt64(at::autocast::increment_nesting());
@@ -286,6 +454,16 @@ static PyObject * is_grad_enabled(PyObject* _unused, PyObject *arg) {
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * is_inference_mode_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (c10::InferenceMode::is_enabled()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
 static PyObject * set_anomaly_mode_enabled(PyObject* _unused, PyObject *arg) {
   HANDLE_TH_ERRORS
   if (!PyBool_Check(arg)) {
@@ -306,6 +484,42 @@ static PyObject * is_anomaly_mode_enabled(PyObject* _unused, PyObject *arg) {
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * set_sparse_grad_deduplication_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!PyBool_Check(arg)) {
+    throw TypeError("enabled must be a bool (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  SparseGradDeduplicationMode::set_enabled(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * is_sparse_grad_deduplication_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (SparseGradDeduplicationMode::is_enabled()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * set_autograd_cpu_threads(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!THPUtils_checkLong(arg)) {
+    throw TypeError("num_threads must be an int (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  Engine::get_default_engine().set_num_cpu_threads(static_cast<int>(THPUtils_unpackLong(arg)));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * get_autograd_cpu_threads(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  return THPUtils_packInt64(Engine::get_default_engine().num_cpu_threads());
+  END_HANDLE_TH_ERRORS
+}
+
 static PyObject * python_enter_dual_level(PyObject* _unused, PyObject* arg) {
   HANDLE_TH_ERRORS
   // It is unlikely that the depth of forward nesting will overflow int64_t so we
@@ -332,15 +546,28 @@ static PyObject * python_exit_dual_level(PyObject* _unused, PyObject* args, PyOb
 static PyMethodDef methods[] = { // NOLINT
   {"_set_grad_enabled", set_grad_enabled, METH_O, nullptr},
   {"is_grad_enabled", is_grad_enabled, METH_NOARGS, nullptr},
+  {"is_inference_mode_enabled", is_inference_mode_enabled, METH_NOARGS, nullptr},
   {"_set_forward_AD_enabled", set_forward_AD_enabled, METH_O, nullptr},
   {"_is_forward_AD_enabled", is_forward_AD_enabled, METH_NOARGS, nullptr},
   {"set_autocast_enabled", set_autocast_enabled, METH_O, nullptr},
   {"is_autocast_enabled", is_autocast_enabled, METH_NOARGS, nullptr},
+  {"set_autocast_cpu_enabled", set_autocast_cpu_enabled, METH_O, nullptr},
+  {"is_autocast_cpu_enabled", is_autocast_cpu_enabled, METH_NOARGS, nullptr},
   {"clear_autocast_cache", clear_autocast_cache, METH_NOARGS, nullptr},
+  {"_set_autocast_persistent_cache_enabled", set_autocast_persistent_cache_enabled, METH_O, nullptr},
+  {"_is_autocast_persistent_cache_enabled", is_autocast_persistent_cache_enabled, METH_NOARGS, nullptr},
+  {"_set_autocast_persistent_cache_max_size", set_autocast_persistent_cache_max_size, METH_O, nullptr},
+  {"_get_autocast_persistent_cache_max_size", get_autocast_persistent_cache_max_size, METH_NOARGS, nullptr},
+  {"_get_autocast_persistent_cache_size", get_autocast_persistent_cache_size, METH_NOARGS, nullptr},
+  {"_clear_autocast_persistent_cache", clear_autocast_persistent_cache, METH_NOARGS, nullptr},
   {"autocast_increment_nesting", autocast_increment_nesting, METH_NOARGS, nullptr},
   {"autocast_decrement_nesting", autocast_decrement_nesting, METH_NOARGS, nullptr},
   {"set_anomaly_enabled", set_anomaly_mode_enabled, METH_O, nullptr},
   {"is_anomaly_enabled", is_anomaly_mode_enabled, METH_NOARGS, nullptr},
+  {"_set_sparse_grad_deduplication_enabled", set_sparse_grad_deduplication_enabled, METH_O, nullptr},
+  {"_is_sparse_grad_deduplication_enabled", is_sparse_grad_deduplication_enabled, METH_NOARGS, nullptr},
+  {"_set_autograd_cpu_threads", set_autograd_cpu_threads, METH_O, nullptr},
+  {"_get_autograd_cpu_threads", get_autograd_cpu_threads, METH_NOARGS, nullptr},
   {"_enter_dual_level", python_enter_dual_level, METH_NOARGS, nullptr},
   {"_exit_dual_level", castPyCFunctionWithKeywords(python_exit_dual_level), METH_VARARGS | METH_KEYWORDS, nullptr},
   {nullptr, nullptr, 0, nullptr}
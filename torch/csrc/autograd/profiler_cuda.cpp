@@ -52,6 +52,17 @@ struct CUDAMethods : public CUDAStubs {
     return ms*1000.0;
   }
 
+  bool ready(const CUDAEventStub* event) const override {
+    cudaError_t err = cudaEventQuery(event->get());
+    if (err == cudaErrorNotReady) {
+      // ignore and clear the error if not ready
+      cudaGetLastError();
+      return false;
+    }
+    TORCH_CUDA_CHECK(err);
+    return true;
+  }
+
   void nvtxMarkA(const char* name) const override {
     ::nvtxMark(name);
   }
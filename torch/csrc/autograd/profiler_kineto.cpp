@@ -37,6 +37,7 @@ inline int64_t getTimeUs() {
 
 std::string shapesToStr(const std::vector<std::vector<int64_t>>& shapes);
 std::string stacksToStr(const std::vector<std::string>& stacks);
+std::string costToStr(const KinetoEvent& event);
 
 struct TORCH_API KinetoThreadLocalState : public ProfilerThreadLocalState {
   using ProfilerThreadLocalState::ProfilerThreadLocalState;
@@ -88,7 +89,10 @@ struct TORCH_API KinetoThreadLocalState : public ProfilerThreadLocalState {
         kineto_events_.back().stack(*ctx->stack);
       }
       if (ctx->extraArgs && !ctx->extraArgs->empty()) {
-        kineto_events_.back().flops(computeFlops(std::string(fn.name().str()), *ctx->extraArgs));
+        kineto_events_.back()
+            .flops(computeFlops(std::string(fn.name().str()), *ctx->extraArgs))
+            .bytesRead(computeBytesRead(*ctx->extraArgs))
+            .bytesWritten(computeBytesWritten(*ctx->extraArgs));
       }
       cpu_trace->activities.emplace_back(std::move(op));
     }
@@ -135,6 +139,10 @@ struct TORCH_API KinetoThreadLocalState : public ProfilerThreadLocalState {
       if (kineto_events_[idx].hasStack()) {
         cpu_trace->activities[idx].callStack = stacksToStr(kineto_events_[idx].stack());
       }
+      if (kineto_events_[idx].flops() || kineto_events_[idx].bytesRead() ||
+          kineto_events_[idx].bytesWritten()) {
+        cpu_trace->activities[idx].arguments = costToStr(kineto_events_[idx]);
+      }
     }
   }
 
@@ -206,7 +214,7 @@ void pushProfilingCallbacks() {
         state_ptr->reportClientActivity(fn, kineto_ctx_ptr);
         libkineto::api().activityProfiler().popCorrelationId();
       })
-    .needsInputs(state_ptr->config().report_input_shapes)
+    .needsInputs(state_ptr->config().report_input_shapes || state_ptr->config().with_flops)
     .needsIds(true));
   state_ptr->setCallbackHandle(handle);
 }
@@ -239,6 +247,14 @@ std::string stacksToStr(const std::vector<std::string>& stacks) {
   return rc;
 }
 
+std::string costToStr(const KinetoEvent& event) {
+  std::ostringstream oss;
+  oss << "{\"FLOPs\": " << event.flops()
+      << ", \"Bytes read\": " << event.bytesRead()
+      << ", \"Bytes written\": " << event.bytesWritten() << "}";
+  return oss.str();
+}
+
 } // namespace
 
 void prepareProfiler(
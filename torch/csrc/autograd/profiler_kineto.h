@@ -66,6 +66,14 @@ struct TORCH_API KinetoEvent {
     return flops_;
   }
 
+  uint64_t bytesRead() const {
+    return bytes_read_;
+  }
+
+  uint64_t bytesWritten() const {
+    return bytes_written_;
+  }
+
   int64_t sequenceNr() const {
     return sequence_nr_;
   }
@@ -107,6 +115,16 @@ struct TORCH_API KinetoEvent {
     return *this;
   }
 
+  KinetoEvent& bytesRead(uint64_t bytes_read) {
+    bytes_read_ = bytes_read;
+    return *this;
+  }
+
+  KinetoEvent& bytesWritten(uint64_t bytes_written) {
+    bytes_written_ = bytes_written;
+    return *this;
+  }
+
   KinetoEvent& sequenceNr(int64_t sequence_nr) {
     sequence_nr_ = sequence_nr;
     return *this;
@@ -171,6 +189,8 @@ struct TORCH_API KinetoEvent {
   c10::optional<std::vector<std::vector<int64_t>>> shapes_;
   c10::optional<std::vector<std::string>> stack_;
   uint64_t flops_ = 0;
+  uint64_t bytes_read_ = 0;
+  uint64_t bytes_written_ = 0;
 
   std::string name_;
   uint64_t device_index_ = 0;
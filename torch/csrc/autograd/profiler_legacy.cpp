@@ -229,6 +229,8 @@ void ProfilerThreadLocalState::pushRange(
     if (config_.with_flops) {
       evt.setExtraArgs(saveExtraArgs(fn));
       evt.setFlops(computeFlops(std::string(fn.name().str()), evt.extraArgs()));
+      evt.setBytesRead(computeBytesRead(evt.extraArgs()));
+      evt.setBytesWritten(computeBytesWritten(evt.extraArgs()));
     }
 #ifndef C10_MOBILE
     // backward nodes source range corresponds to the forward node
@@ -451,7 +453,7 @@ void pushProfilingCallbacksLegacy() {
         }
         state_ptr->popRange(fn, record_cuda);
       })
-    .needsInputs(state_ptr->config().report_input_shapes)
+    .needsInputs(state_ptr->config().report_input_shapes || state_ptr->config().with_flops)
     .needsIds(true));
   state_ptr->setCallbackHandle(handle);
 }
@@ -464,6 +466,10 @@ void registerCUDAMethods(CUDAStubs* stubs) {
   cuda_stubs() = stubs;
 }
 
+const CUDAStubs* cudaStubs() {
+  return cuda_stubs();
+}
+
 at::IValue ProfilerConfig::toIValue() const {
   c10::impl::GenericList eventIValueList(at::AnyType::get());
   eventIValueList.reserve(NUM_PROFILER_CFG_IVALUE_IDX);
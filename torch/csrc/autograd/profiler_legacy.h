@@ -40,6 +40,11 @@ struct TORCH_API CUDAStubs {
     fail();
     return 0.f;
   }
+  // Whether the work before the event is done, without blocking on it
+  virtual bool ready(const CUDAEventStub* event) const {
+    fail();
+    return false;
+  }
   virtual void nvtxMarkA(const char* name) const {
     fail();
   }
@@ -67,6 +72,7 @@ private:
 };
 
 TORCH_API void registerCUDAMethods(CUDAStubs* stubs);
+TORCH_API const CUDAStubs* cudaStubs();
 
 constexpr inline size_t ceilToMultiple(size_t a, size_t b) {
   return ((a + b - 1) / b) * b;
@@ -308,6 +314,22 @@ struct TORCH_API LegacyEvent {
     flops_ = flops;
   }
 
+  uint64_t bytesRead() {
+    return bytes_read_;
+  }
+
+  void setBytesRead(uint64_t bytes_read) {
+    bytes_read_ = bytes_read;
+  }
+
+  uint64_t bytesWritten() {
+    return bytes_written_;
+  }
+
+  void setBytesWritten(uint64_t bytes_written) {
+    bytes_written_ = bytes_written;
+  }
+
  private:
   // signed to allow for negative intervals, initialized for safety.
   int64_t cpu_ns_ = 0;
@@ -332,6 +354,8 @@ struct TORCH_API LegacyEvent {
   // Extra arguments for computing op flops
   std::unordered_map<std::string, c10::IValue> extra_args_;
   uint64_t flops_ = 0;
+  uint64_t bytes_read_ = 0;
+  uint64_t bytes_written_ = 0;
 };
 
 // a linked-list of fixed sized vectors, to avoid
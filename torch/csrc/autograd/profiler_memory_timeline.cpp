@@ -0,0 +1,76 @@
+#include <torch/csrc/autograd/profiler_memory_timeline.h>
+
+#include <ATen/record_function.h>
+#include <c10/core/AllocationTrace.h>
+#include <c10/util/Exception.h>
+
+#include <memory>
+#include <thread>
+
+namespace torch { namespace autograd { namespace profiler {
+
+namespace {
+
+struct MemoryTimelineContext : public at::ObserverContext {
+  // The thread the op started on and the depth of its context stack before
+  // the op
+  std::thread::id thread_id;
+  size_t depth = 0;
+};
+
+c10::optional<at::CallbackHandle>& callbackHandle() {
+  static c10::optional<at::CallbackHandle> handle_;
+  return handle_;
+}
+
+std::unique_ptr<at::ObserverContext> onFunctionEnter(
+    const at::RecordFunction& fn) {
+  auto ctx = std::make_unique<MemoryTimelineContext>();
+  ctx->thread_id = std::this_thread::get_id();
+  ctx->depth = c10::pushAllocationTraceContext(
+      c10::internAllocationTraceContext(fn.name().str()));
+  return ctx;
+}
+
+void onFunctionExit(const at::RecordFunction& /* unused */, at::ObserverContext* ctx_ptr) {
+  auto* ctx = static_cast<MemoryTimelineContext*>(ctx_ptr);
+  TORCH_INTERNAL_ASSERT(ctx);
+  // Async ops may end on another thread, which has its own context stack
+  if (ctx->thread_id == std::this_thread::get_id()) {
+    c10::restoreAllocationTraceContext(ctx->depth);
+  }
+}
+
+} // namespace
+
+void enableMemoryTimeline(size_t capacity, bool record_ops) {
+  disableMemoryTimeline();
+  c10::enableAllocationTrace(capacity);
+  if (record_ops) {
+    callbackHandle() = at::addGlobalCallback(
+        at::RecordFunctionCallback(&onFunctionEnter, &onFunctionExit)
+            .scopes({at::RecordScope::FUNCTION,
+                     at::RecordScope::BACKWARD_FUNCTION,
+                     at::RecordScope::TORCHSCRIPT_FUNCTION,
+                     at::RecordScope::USER_SCOPE}));
+  }
+}
+
+void disableMemoryTimeline() {
+  auto& handle = callbackHandle();
+  if (handle) {
+    at::removeCallback(*handle);
+    handle = c10::nullopt;
+  }
+  c10::disableAllocationTrace();
+}
+
+bool isMemoryTimelineEnabled() {
+  return c10::allocationTraceEnabled();
+}
+
+void exportMemoryTimeline(const std::string& path) {
+  c10::exportAllocationTraceChrome(path);
+}
+
+}}} // namespace torch::autograd::profiler
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+// Memory timeline of the CPU and CUDA caching allocators.
+//
+// Records every allocation, free and segment event of the allocators into
+// the ring buffer of c10/core/AllocationTrace.h, with the operator (or
+// record_function scope) that is running on the allocating thread as the
+// allocation context, so that the peak of each device can be attributed to
+// the operators that allocated the memory live at the peak.
+//
+// Like the op stats observer, the operator context is a global RecordFunction
+// callback, so the timeline must be enabled and disabled when no other code
+// is running (see record_function.h).
+
+namespace torch { namespace autograd { namespace profiler {
+
+// Starts a new timeline of at most capacity events, dropping the oldest ones
+// once full. With record_ops, the allocations are attributed to the
+// innermost operator running on their thread.
+TORCH_API void enableMemoryTimeline(size_t capacity, bool record_ops = true);
+
+// Stops recording; the events recorded so far are kept until the next enable
+TORCH_API void disableMemoryTimeline();
+
+TORCH_API bool isMemoryTimelineEnabled();
+
+// Writes the recorded events to path in the Chrome trace format, see
+// c10::exportAllocationTraceChrome
+TORCH_API void exportMemoryTimeline(const std::string& path);
+
+}}} // namespace torch::autograd::profiler
@@ -0,0 +1,339 @@
+#include <torch/csrc/autograd/profiler_op_stats.h>
+#include <torch/csrc/autograd/profiler_legacy.h>
+
+#include <ATen/record_function.h>
+#include <c10/core/Allocator.h>
+#include <c10/util/Exception.h>
+#include <c10/util/llvmMathExtras.h>
+#include <c10/util/string_view.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace torch { namespace autograd { namespace profiler {
+
+namespace {
+
+// Upper bound on the CUDA timings a thread waits for; beyond it, the oldest
+// ones are dropped rather than blocking on the device.
+constexpr size_t kMaxPendingCudaTimings = 4096;
+
+struct Histogram {
+  Histogram() {
+    for (auto& bucket : buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  void add(uint64_t ns) {
+    buckets[opStatsBucket(ns)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void addTo(OpStatsHistogram& histogram) const {
+    for (size_t i = 0; i < kOpStatsNumBuckets; ++i) {
+      histogram[i] += buckets[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  void reset() {
+    for (auto& bucket : buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  std::array<std::atomic<uint64_t>, kOpStatsNumBuckets> buckets;
+};
+
+// The counters of an operator name in a thread. They are only incremented by
+// their thread (or, for async ops, by the thread the op ends on), and read by
+// getOpStats, hence the relaxed atomics.
+struct OpEntry {
+  explicit OpEntry(std::string name) : name(std::move(name)) {}
+
+  const std::string name;
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> cpu_total_ns{0};
+  Histogram cpu_histogram;
+  std::atomic<uint64_t> cuda_count{0};
+  std::atomic<uint64_t> cuda_total_ns{0};
+  Histogram cuda_histogram;
+  std::atomic<uint64_t> bytes_allocated{0};
+
+  void addTo(OpStats& stats) const {
+    stats.count += count.load(std::memory_order_relaxed);
+    stats.cpu_total_ns += cpu_total_ns.load(std::memory_order_relaxed);
+    cpu_histogram.addTo(stats.cpu_histogram);
+    stats.cuda_count += cuda_count.load(std::memory_order_relaxed);
+    stats.cuda_total_ns += cuda_total_ns.load(std::memory_order_relaxed);
+    cuda_histogram.addTo(stats.cuda_histogram);
+    stats.bytes_allocated += bytes_allocated.load(std::memory_order_relaxed);
+  }
+
+  void reset() {
+    count.store(0, std::memory_order_relaxed);
+    cpu_total_ns.store(0, std::memory_order_relaxed);
+    cpu_histogram.reset();
+    cuda_count.store(0, std::memory_order_relaxed);
+    cuda_total_ns.store(0, std::memory_order_relaxed);
+    cuda_histogram.reset();
+    bytes_allocated.store(0, std::memory_order_relaxed);
+  }
+};
+
+struct PendingCudaTiming {
+  OpEntry* entry;
+  CUDAEventStub start;
+  CUDAEventStub end;
+};
+
+// The counters of a thread. ThreadStats are never freed: when a thread exits,
+// its ThreadStats (and the counters it gathered) are handed to the next new
+// thread, so that the end callbacks of async ops may still refer to them.
+struct ThreadStats {
+  // Looks up the entry of an operator name, only called by the owning thread
+  OpEntry* entry(const char* name) {
+    c10::string_view key(name);
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+      return it->second.get();
+    }
+    auto entry = std::make_unique<OpEntry>(name);
+    auto* entry_ptr = entry.get();
+    std::lock_guard<std::mutex> guard(mutex);
+    entries.emplace(c10::string_view(entry_ptr->name), std::move(entry));
+    return entry_ptr;
+  }
+
+  // Reads the CUDA timings that are done, only called by the owning thread
+  void readCudaTimings() {
+    const auto* stubs = cudaStubs();
+    while (!pending_cuda_timings.empty() &&
+           stubs->ready(&pending_cuda_timings.front().end)) {
+      auto& timing = pending_cuda_timings.front();
+      const auto ns = static_cast<uint64_t>(
+          std::max(stubs->elapsed(&timing.start, &timing.end), 0.f) * 1000.);
+      timing.entry->cuda_count.fetch_add(1, std::memory_order_relaxed);
+      timing.entry->cuda_total_ns.fetch_add(ns, std::memory_order_relaxed);
+      timing.entry->cuda_histogram.add(ns);
+      pending_cuda_timings.pop_front();
+    }
+    while (pending_cuda_timings.size() > kMaxPendingCudaTimings) {
+      pending_cuda_timings.pop_front();
+    }
+  }
+
+  // Guards the structure of entries (not the counters) between insertions
+  // by the owning thread and the other threads reading the counters.
+  std::mutex mutex;
+  std::unordered_map<c10::string_view, std::unique_ptr<OpEntry>> entries;
+  std::deque<PendingCudaTiming> pending_cuda_timings;
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadStats>> all;
+  std::vector<ThreadStats*> free;
+};
+
+// Leaked, so that the thread local destructors may run after it would be
+// destroyed
+Registry& registry() {
+  static Registry* registry_ = new Registry();
+  return *registry_;
+}
+
+struct ThreadStatsHolder {
+  ThreadStatsHolder() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    if (!reg.free.empty()) {
+      stats = reg.free.back();
+      reg.free.pop_back();
+    } else {
+      reg.all.push_back(std::make_unique<ThreadStats>());
+      stats = reg.all.back().get();
+    }
+  }
+
+  ~ThreadStatsHolder() {
+    stats->pending_cuda_timings.clear();
+    auto& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    reg.free.push_back(stats);
+  }
+
+  ThreadStats* stats;
+};
+
+ThreadStats& threadStats() {
+  thread_local ThreadStatsHolder holder;
+  return *holder.stats;
+}
+
+// The observed operators running on this thread, outermost first, which the
+// allocations are counted against
+thread_local std::vector<OpEntry*> active_ops;
+
+struct OpStatsMemoryReporter : public c10::MemoryReportingInfoBase {
+  void reportMemoryUsage(void* /* unused */, int64_t alloc_size, c10::Device /* unused */)
+      override {
+    if (alloc_size <= 0) {
+      return;
+    }
+    for (auto it = active_ops.begin(); it != active_ops.end(); ++it) {
+      // Count recursive ops once
+      if (std::find(active_ops.begin(), it, *it) == it) {
+        (*it)->bytes_allocated.fetch_add(alloc_size, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool memoryProfilingEnabled() const override {
+    return true;
+  }
+};
+
+c10::MemoryReportingInfoBase* memoryReporter() {
+  static auto* reporter_ = new OpStatsMemoryReporter();
+  return reporter_;
+}
+
+struct OpStatsContext : public at::ObserverContext {
+  OpEntry* entry = nullptr;
+  int64_t start_ns = 0;
+  CUDAEventStub start_event;
+  // The active_ops of the thread the op started on and their number before
+  // the op, when counting allocations
+  std::vector<OpEntry*>* active_ops = nullptr;
+  size_t depth = 0;
+};
+
+std::atomic<bool> record_cuda{false};
+std::atomic<bool> record_memory{false};
+
+c10::optional<at::CallbackHandle>& callbackHandle() {
+  static c10::optional<at::CallbackHandle> handle_;
+  return handle_;
+}
+
+std::unique_ptr<at::ObserverContext> onFunctionEnter(
+    const at::RecordFunction& fn) {
+  auto ctx = std::make_unique<OpStatsContext>();
+  ctx->entry = threadStats().entry(fn.name().str());
+  if (record_memory.load(std::memory_order_relaxed)) {
+    ctx->active_ops = &active_ops;
+    ctx->depth = active_ops.size();
+    active_ops.push_back(ctx->entry);
+  }
+  if (record_cuda.load(std::memory_order_relaxed)) {
+    int device = 0;
+    int64_t cpu_ns = 0;
+    cudaStubs()->record(&device, &ctx->start_event, &cpu_ns);
+  }
+  ctx->start_ns = getTime();
+  return ctx;
+}
+
+void onFunctionExit(const at::RecordFunction& fn, at::ObserverContext* ctx_ptr) {
+  const int64_t end_ns = getTime();
+  auto* ctx = static_cast<OpStatsContext*>(ctx_ptr);
+  TORCH_INTERNAL_ASSERT(ctx);
+  auto* entry = ctx->entry;
+  const auto ns = static_cast<uint64_t>(std::max<int64_t>(end_ns - ctx->start_ns, 0));
+  entry->count.fetch_add(1, std::memory_order_relaxed);
+  entry->cpu_total_ns.fetch_add(ns, std::memory_order_relaxed);
+  entry->cpu_histogram.add(ns);
+
+  // Async ops may end on another thread, which has its own active_ops
+  if (ctx->active_ops == &active_ops && active_ops.size() > ctx->depth) {
+    active_ops.resize(ctx->depth);
+  }
+  if (ctx->start_event) {
+    PendingCudaTiming timing{entry, std::move(ctx->start_event), nullptr};
+    int device = 0;
+    int64_t cpu_ns = 0;
+    cudaStubs()->record(&device, &timing.end, &cpu_ns);
+    auto& stats = threadStats();
+    stats.pending_cuda_timings.push_back(std::move(timing));
+    stats.readCudaTimings();
+  }
+}
+
+} // namespace
+
+size_t opStatsBucket(uint64_t ns) {
+  if (ns == 0) {
+    return 0;
+  }
+  return std::min<size_t>(llvm::Log2_64(ns) + 1, kOpStatsNumBuckets - 1);
+}
+
+void enableOpStats(const OpStatsConfig& config) {
+  TORCH_CHECK(
+      !config.cuda || cudaStubs()->enabled(),
+      "Can't time operators on CUDA: PyTorch was built without CUDA support");
+  disableOpStats();
+  record_cuda = config.cuda;
+  record_memory = config.memory;
+  c10::setGlobalMemoryReporter(config.memory ? memoryReporter() : nullptr);
+  callbackHandle() = at::addGlobalCallback(
+      at::RecordFunctionCallback(&onFunctionEnter, &onFunctionExit)
+          .samplingProb(config.sampling_prob)
+          .scopes({at::RecordScope::FUNCTION,
+                   at::RecordScope::BACKWARD_FUNCTION,
+                   at::RecordScope::TORCHSCRIPT_FUNCTION,
+                   at::RecordScope::USER_SCOPE}));
+}
+
+void disableOpStats() {
+  auto& handle = callbackHandle();
+  if (handle) {
+    at::removeCallback(*handle);
+    handle = c10::nullopt;
+  }
+  c10::setGlobalMemoryReporter(nullptr);
+  record_cuda = false;
+  record_memory = false;
+}
+
+bool isOpStatsEnabled() {
+  return callbackHandle().has_value();
+}
+
+std::vector<OpStats> getOpStats() {
+  std::map<std::string, OpStats> merged;
+  auto& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.mutex);
+  for (const auto& stats : reg.all) {
+    std::lock_guard<std::mutex> stats_guard(stats->mutex);
+    for (const auto& kv : stats->entries) {
+      auto& op_stats = merged[kv.second->name];
+      kv.second->addTo(op_stats);
+    }
+  }
+  std::vector<OpStats> result;
+  result.reserve(merged.size());
+  for (auto& kv : merged) {
+    kv.second.name = kv.first;
+    result.push_back(std::move(kv.second));
+  }
+  return result;
+}
+
+void resetOpStats() {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.mutex);
+  for (const auto& stats : reg.all) {
+    std::lock_guard<std::mutex> stats_guard(stats->mutex);
+    for (const auto& kv : stats->entries) {
+      kv.second->reset();
+    }
+  }
+}
+
+}}} // namespace torch::autograd::profiler
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+// Always-on aggregated operator statistics.
+//
+// Unlike the legacy and Kineto profilers, which record every event of the
+// profiled range, the op stats observer only keeps, per operator name, a call
+// count, the total and a log2-bucketed histogram of the CPU latency, and,
+// optionally, the same for the latency on the CUDA device and the bytes
+// allocated by the operator. It is meant to stay enabled in production, with
+// the statistics pulled periodically with getOpStats.
+//
+// The counters are per thread: the observer only does relaxed atomic adds on
+// counters owned by the calling thread, and takes a (per thread, uncontended)
+// lock only the first time a thread sees an operator name. getOpStats sums
+// the counters of all the threads, including the threads that have exited.
+//
+// The observer is a global RecordFunction callback, so it must be enabled and
+// disabled when no other code is running (see record_function.h).
+
+namespace torch { namespace autograd { namespace profiler {
+
+// Latencies in [2^(i - 1), 2^i) nanoseconds fall in bucket i, latencies of at
+// least 2^(kOpStatsNumBuckets - 2) ns in the last bucket.
+constexpr size_t kOpStatsNumBuckets = 36;
+
+using OpStatsHistogram = std::array<uint64_t, kOpStatsNumBuckets>;
+
+struct TORCH_API OpStatsConfig {
+  // Fraction of the calls that are observed, see
+  // RecordFunctionCallback::samplingProb
+  double sampling_prob = 1.0;
+  // Also time the operators on the current CUDA stream with CUDA events.
+  // The events are read once done, without synchronizing, so the CUDA
+  // statistics lag the CPU ones; this adds the cost of two event records to
+  // every call and should be combined with sampling.
+  bool cuda = false;
+  // Also count the bytes allocated by the operators, including by their
+  // nested operators. This makes every allocation report to the observer.
+  bool memory = false;
+};
+
+struct TORCH_API OpStats {
+  std::string name;
+  uint64_t count = 0;
+  uint64_t cpu_total_ns = 0;
+  OpStatsHistogram cpu_histogram{};
+  // Number of calls with a CUDA timing, which is less than count when some
+  // of the timings have not been read yet (or were dropped).
+  uint64_t cuda_count = 0;
+  uint64_t cuda_total_ns = 0;
+  OpStatsHistogram cuda_histogram{};
+  uint64_t bytes_allocated = 0;
+};
+
+// Returns the histogram bucket of a latency
+TORCH_API size_t opStatsBucket(uint64_t ns);
+
+// Enables the observer, or changes its config if it is enabled
+TORCH_API void enableOpStats(const OpStatsConfig& config = OpStatsConfig());
+
+// Disables the observer; the statistics gathered so far are kept
+TORCH_API void disableOpStats();
+
+TORCH_API bool isOpStatsEnabled();
+
+// Returns the statistics gathered since the last reset, sorted by name. The
+// counters of each operator are read one by one while the other threads may
+// be updating them, so a snapshot may be off by the calls in flight.
+TORCH_API std::vector<OpStats> getOpStats();
+
+// Resets the statistics of all the threads to zero
+TORCH_API void resetOpStats();
+
+}}} // namespace torch::autograd::profiler
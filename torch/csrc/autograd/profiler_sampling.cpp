@@ -0,0 +1,344 @@
+#include <torch/csrc/autograd/profiler_sampling.h>
+
+#include <ATen/record_function.h>
+#include <c10/util/Exception.h>
+#include <c10/util/Optional.h>
+#include <c10/util/string_view.h>
+#include <c10/util/thread_name.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace torch { namespace autograd { namespace profiler {
+
+namespace {
+
+// Ops nested deeper than this are counted but not sampled
+constexpr size_t kMaxSampledDepth = 64;
+
+// Same as PyThreadState::thread_id, to match the Python stacks
+uint64_t nativeThreadId() {
+#ifdef _WIN32
+  return GetCurrentThreadId();
+#else
+  return (uint64_t)(uintptr_t)pthread_self();
+#endif
+}
+
+// Returns a copy of name that lives as long as the process
+const char* internName(c10::string_view name) {
+  // Names are looked up in a per thread cache first, to avoid taking the
+  // global lock on every op
+  thread_local std::unordered_map<c10::string_view, const char*> cache;
+  auto it = cache.find(name);
+  if (it != cache.end()) {
+    return it->second;
+  }
+
+  static std::mutex mutex;
+  // Leaked, since the names must outlive every thread
+  static auto* names = new std::unordered_set<std::string>();
+  const char* interned = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    interned = names->emplace(name.data(), name.size()).first->c_str();
+  }
+  cache.emplace(c10::string_view(interned, name.size()), interned);
+  return interned;
+}
+
+// The ops running on a thread, outermost first. Only written by the owning
+// thread, and read by the sampler, hence the atomics.
+struct ThreadOpStack {
+  ThreadOpStack() {
+    for (auto& name : names) {
+      name.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  std::atomic<uint64_t> thread_id{0};
+  std::atomic<size_t> depth{0};
+  std::array<std::atomic<const char*>, kMaxSampledDepth> names;
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadOpStack>> all;
+  std::vector<ThreadOpStack*> free;
+};
+
+// Leaked, so that the thread local destructors may run after it would be
+// destroyed
+Registry& registry() {
+  static Registry* registry_ = new Registry();
+  return *registry_;
+}
+
+// ThreadOpStacks are never freed: when a thread exits, its stack is handed
+// to the next new thread, so that the sampler may still read it.
+struct ThreadOpStackHolder {
+  ThreadOpStackHolder() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    if (!reg.free.empty()) {
+      stack = reg.free.back();
+      reg.free.pop_back();
+    } else {
+      reg.all.push_back(std::make_unique<ThreadOpStack>());
+      stack = reg.all.back().get();
+    }
+    stack->depth.store(0, std::memory_order_relaxed);
+    stack->thread_id.store(nativeThreadId(), std::memory_order_release);
+  }
+
+  ~ThreadOpStackHolder() {
+    stack->thread_id.store(0, std::memory_order_release);
+    stack->depth.store(0, std::memory_order_release);
+    auto& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    reg.free.push_back(stack);
+  }
+
+  ThreadOpStack* stack;
+};
+
+ThreadOpStack& threadOpStack() {
+  thread_local ThreadOpStackHolder holder;
+  return *holder.stack;
+}
+
+std::unique_ptr<at::ObserverContext> onFunctionEnter(
+    const at::RecordFunction& fn) {
+  auto& stack = threadOpStack();
+  const size_t depth = stack.depth.load(std::memory_order_relaxed);
+  if (depth < kMaxSampledDepth) {
+    stack.names[depth].store(
+        internName(fn.name().str()), std::memory_order_relaxed);
+  }
+  stack.depth.store(depth + 1, std::memory_order_release);
+  return nullptr;
+}
+
+void onFunctionExit(
+    const at::RecordFunction& fn,
+    at::ObserverContext* /* unused */) {
+  // Async ops may end on another thread, whose stack they are not on
+  if (fn.threadId() != at::RecordFunction::currentThreadId()) {
+    return;
+  }
+  auto& stack = threadOpStack();
+  const size_t depth = stack.depth.load(std::memory_order_relaxed);
+  if (depth > 0) {
+    stack.depth.store(depth - 1, std::memory_order_release);
+  }
+}
+
+std::atomic<PythonStacksFn> python_stacks_fn{nullptr};
+
+struct SampledStacks {
+  std::mutex mutex;
+  std::unordered_map<std::string, uint64_t> counts;
+  uint64_t num_samples = 0;
+};
+
+SampledStacks& sampledStacks() {
+  static SampledStacks stacks_;
+  return stacks_;
+}
+
+void appendFrame(std::string& stack, const char* frame) {
+  if (!stack.empty()) {
+    stack += ';';
+  }
+  // ';' separates the frames of a folded stack
+  for (const char* c = frame; *c; ++c) {
+    stack += *c == ';' ? ',' : *c;
+  }
+}
+
+void sampleOnce(bool record_python) {
+  std::unordered_map<uint64_t, std::vector<std::string>> python_stacks;
+  auto fn = python_stacks_fn.load();
+  if (record_python && fn) {
+    python_stacks = fn();
+  }
+
+  std::vector<std::string> stacks;
+  {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    for (const auto& op_stack : reg.all) {
+      const uint64_t thread_id =
+          op_stack->thread_id.load(std::memory_order_acquire);
+      if (thread_id == 0) {
+        continue;
+      }
+      const size_t depth = std::min(
+          op_stack->depth.load(std::memory_order_acquire), kMaxSampledDepth);
+      std::string stack;
+      auto python_it = python_stacks.find(thread_id);
+      if (python_it != python_stacks.end()) {
+        for (const auto& frame : python_it->second) {
+          appendFrame(stack, frame.c_str());
+        }
+        python_stacks.erase(python_it);
+      }
+      for (size_t i = 0; i < depth; ++i) {
+        const char* name = op_stack->names[i].load(std::memory_order_relaxed);
+        appendFrame(stack, name ? name : "<unknown>");
+      }
+      if (!stack.empty()) {
+        stacks.push_back(std::move(stack));
+      }
+    }
+  }
+  // Python threads that never ran an op
+  for (const auto& kv : python_stacks) {
+    std::string stack;
+    for (const auto& frame : kv.second) {
+      appendFrame(stack, frame.c_str());
+    }
+    if (!stack.empty()) {
+      stacks.push_back(std::move(stack));
+    }
+  }
+
+  auto& sampled = sampledStacks();
+  std::lock_guard<std::mutex> guard(sampled.mutex);
+  sampled.num_samples++;
+  for (auto& stack : stacks) {
+    sampled.counts[std::move(stack)]++;
+  }
+}
+
+class Sampler {
+ public:
+  explicit Sampler(const SamplingProfilerConfig& config) {
+    TORCH_CHECK(
+        config.frequency_hz > 0,
+        "The sampling frequency must be positive, got ",
+        config.frequency_hz);
+    const auto period = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(1. / config.frequency_hz));
+    const bool record_python = config.record_python;
+    thread_ = std::thread([this, period, record_python]() {
+      c10::setThreadName("pt_sampling");
+      auto next = std::chrono::steady_clock::now() + period;
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (!cv_.wait_until(lock, next, [this] { return stopped_; })) {
+        lock.unlock();
+        sampleOnce(record_python);
+        lock.lock();
+        // Skip the ticks missed while sampling instead of catching up
+        next = std::max(next + period, std::chrono::steady_clock::now());
+      }
+    });
+  }
+
+  ~Sampler() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopped_ = false;
+  std::thread thread_;
+};
+
+struct SamplingState {
+  c10::optional<at::CallbackHandle> handle;
+  std::unique_ptr<Sampler> sampler;
+};
+
+SamplingState& samplingState() {
+  static SamplingState state_;
+  return state_;
+}
+
+} // namespace
+
+void setSamplingPythonStacksFn(PythonStacksFn fn) {
+  python_stacks_fn = fn;
+}
+
+void enableSamplingProfiler(const SamplingProfilerConfig& config) {
+  disableSamplingProfiler();
+  resetSampledStacks();
+  auto& state = samplingState();
+  state.handle = at::addGlobalCallback(
+      at::RecordFunctionCallback(&onFunctionEnter, &onFunctionExit)
+          .scopes({at::RecordScope::FUNCTION,
+                   at::RecordScope::BACKWARD_FUNCTION,
+                   at::RecordScope::TORCHSCRIPT_FUNCTION,
+                   at::RecordScope::USER_SCOPE}));
+  state.sampler = std::make_unique<Sampler>(config);
+}
+
+void disableSamplingProfiler() {
+  auto& state = samplingState();
+  state.sampler.reset();
+  if (state.handle) {
+    at::removeCallback(*state.handle);
+    state.handle = c10::nullopt;
+  }
+}
+
+bool isSamplingProfilerEnabled() {
+  return samplingState().handle.has_value();
+}
+
+std::vector<std::pair<std::string, uint64_t>> getSampledStacks() {
+  std::vector<std::pair<std::string, uint64_t>> result;
+  {
+    auto& sampled = sampledStacks();
+    std::lock_guard<std::mutex> guard(sampled.mutex);
+    result.assign(sampled.counts.begin(), sampled.counts.end());
+  }
+  std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+    return a.second > b.second || (a.second == b.second && a.first < b.first);
+  });
+  return result;
+}
+
+std::string getFoldedStacks() {
+  std::ostringstream ss;
+  for (const auto& kv : getSampledStacks()) {
+    ss << kv.first << " " << kv.second << "\n";
+  }
+  return ss.str();
+}
+
+uint64_t numStackSamples() {
+  auto& sampled = sampledStacks();
+  std::lock_guard<std::mutex> guard(sampled.mutex);
+  return sampled.num_samples;
+}
+
+void resetSampledStacks() {
+  auto& sampled = sampledStacks();
+  std::lock_guard<std::mutex> guard(sampled.mutex);
+  sampled.counts.clear();
+  sampled.num_samples = 0;
+}
+
+}}} // namespace torch::autograd::profiler
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+// Sampling stack profiler.
+//
+// Instead of recording every operator like the legacy and Kineto profilers
+// (whose with_stack mode captures the Python stack on every call), the
+// sampling profiler wakes up a worker thread at a fixed frequency, which
+// captures the operator (RecordFunction) stack and, from Python, the Python
+// frame chain of every thread. The samples are aggregated into folded
+// stacks, one line per distinct stack, "frame;frame;...;op;op count", ready
+// to be turned into a flame graph (e.g. with flamegraph.pl).
+//
+// The only per-op cost is a global RecordFunction callback pushing and
+// popping the op name on a stack owned by the calling thread. The worker
+// reads the stacks of the other threads with atomic loads only, without
+// stopping or signaling them; a sample taken while a thread pushes or pops
+// an op may be off by that op.
+//
+// The profiler is a global RecordFunction callback, so it must be enabled
+// and disabled when no other code is running (see record_function.h).
+
+namespace torch { namespace autograd { namespace profiler {
+
+struct TORCH_API SamplingProfilerConfig {
+  double frequency_hz = 100.;
+  // Also sample the Python stacks, when a Python stacks function is set
+  bool record_python = true;
+};
+
+// The frames of the Python threads, outermost first, by native thread id
+// (PyThreadState::thread_id)
+using PythonStacksFn =
+    std::unordered_map<uint64_t, std::vector<std::string>> (*)();
+
+// Set by the Python bindings
+TORCH_API void setSamplingPythonStacksFn(PythonStacksFn fn);
+
+// Starts sampling; the stacks sampled so far are dropped
+TORCH_API void enableSamplingProfiler(
+    const SamplingProfilerConfig& config = SamplingProfilerConfig());
+
+// Stops sampling; the stacks sampled so far are kept
+TORCH_API void disableSamplingProfiler();
+
+TORCH_API bool isSamplingProfilerEnabled();
+
+// Returns the folded stacks sampled so far and the number of samples of
+// each, most sampled first. Python frames come before the ops.
+TORCH_API std::vector<std::pair<std::string, uint64_t>> getSampledStacks();
+
+// Returns the sampled stacks in the folded format, one "stack count" line
+// per stack
+TORCH_API std::string getFoldedStacks();
+
+// Number of times the stacks were sampled, including the samples where no
+// thread was running an op or Python code
+TORCH_API uint64_t numStackSamples();
+
+TORCH_API void resetSampledStacks();
+
+}}} // namespace torch::autograd::profiler
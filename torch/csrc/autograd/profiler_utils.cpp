@@ -1,11 +1,11 @@
 #include <torch/csrc/autograd/profiler_utils.h>
 
-namespace torch { namespace autograd { namespace profiler {
+#include <ATen/ExpandUtils.h>
+#include <ATen/WrapDimUtils.h>
+
+#include <mutex>
 
-static constexpr auto kConv2dStride = 3;
-static constexpr auto kConv2dPadding = 4;
-static constexpr auto kConv2dDilation = 5;
-static constexpr auto kConv2dGroups = 6;
+namespace torch { namespace autograd { namespace profiler {
 
 // List of supported operators
 static constexpr auto kConv2dOp = "aten::conv2d";
@@ -23,96 +23,426 @@ static constexpr auto kMatSize = "mat_size";
 static constexpr auto kMat1Size = "mat1_size";
 static constexpr auto kMat2Size = "mat2_size";
 
-static bool validateInput(const std::string &op_name, size_t min_size,
-                       const std::vector<c10::IValue>& inputs,
-                       const std::vector<int>& should_be_tensor) {
-  std::stringstream ss;
-  if (inputs.size() < min_size) {
-      ss << "Failed to save extra arguments for flops compuation of op "
-         << op_name
-         << ", min size: " << min_size
-         << ", actual size: " << inputs.size();
-      TORCH_WARN(ss.str());
-      return false;
+static constexpr auto kFlops = "flops";
+static constexpr auto kBytesRead = "bytes_read";
+static constexpr auto kBytesWritten = "bytes_written";
+
+namespace {
+
+uint64_t numel(at::IntArrayRef sizes) {
+  uint64_t n = 1;
+  for (auto size : sizes) {
+    n *= size;
   }
-  for (auto index : should_be_tensor) {
-    if (!inputs[index].isTensor()) {
-      ss << "Failed to save extra arguments for flops compuation of op "
-         << op_name
-         << ", input[" << index
-         << "] must be a tensor.";
-      TORCH_WARN(ss.str());
-      return false;
+  return n;
+}
+
+uint64_t bytes(const at::Tensor& tensor) {
+  return tensor.numel() * tensor.element_size();
+}
+
+bool isTensor(const std::vector<c10::IValue>& inputs, size_t i) {
+  return i < inputs.size() && inputs[i].isTensor() && inputs[i].toTensor().defined();
+}
+
+// Elementwise ops: the output has the broadcast shape of the tensor inputs
+OpCostFunction pointwiseCost(
+    uint64_t flops_per_element,
+    c10::optional<at::ScalarType> out_dtype = c10::nullopt) {
+  return [=](const std::vector<c10::IValue>& inputs) -> c10::optional<OpCost> {
+    OpCost cost;
+    std::vector<int64_t> out_sizes;
+    c10::optional<at::ScalarType> dtype;
+    for (const auto& input : inputs) {
+      if (!input.isTensor() || !input.toTensor().defined()) {
+        continue;
+      }
+      const auto& tensor = input.toTensor();
+      cost.bytes_read += bytes(tensor);
+      out_sizes = dtype ? at::infer_size(out_sizes, tensor.sizes()) : tensor.sizes().vec();
+      dtype = dtype ? at::promoteTypes(*dtype, tensor.scalar_type()) : tensor.scalar_type();
+    }
+    if (!dtype) {
+      return c10::nullopt;
+    }
+    const uint64_t n = numel(out_sizes);
+    cost.flops = flops_per_element * n;
+    cost.bytes_written = n * at::elementSize(out_dtype.value_or(*dtype));
+    return cost;
+  };
+}
+
+// Reductions of self over the dims of input dim_index (an int, a list of
+// ints, or none for all the dims)
+OpCostFunction reductionCost(size_t dim_index) {
+  return [=](const std::vector<c10::IValue>& inputs) -> c10::optional<OpCost> {
+    if (!isTensor(inputs, 0)) {
+      return c10::nullopt;
+    }
+    const auto& self = inputs[0].toTensor();
+    std::vector<int64_t> dims;
+    if (dim_index < inputs.size() && inputs[dim_index].isIntList()) {
+      dims = inputs[dim_index].toIntVector();
+    } else if (dim_index < inputs.size() && inputs[dim_index].isInt()) {
+      dims.push_back(inputs[dim_index].toInt());
+    }
+    uint64_t out_numel = 1;
+    if (!dims.empty()) {
+      std::vector<bool> reduced(self.dim(), false);
+      for (auto dim : dims) {
+        reduced[at::maybe_wrap_dim(dim, self.dim())] = true;
+      }
+      for (int64_t i = 0; i < self.dim(); ++i) {
+        out_numel *= reduced[i] ? 1 : self.size(i);
+      }
+    }
+    OpCost cost;
+    cost.flops = self.numel();
+    cost.bytes_read = bytes(self);
+    cost.bytes_written = out_numel * self.element_size();
+    return cost;
+  };
+}
+
+// Matrix products of the [..., M, K] operand at index left with the
+// [..., K, N] operand at index right (either may be a vector), batched over
+// the broadcast leading dims, plus the addition of the optional input at
+// index bias to the result
+OpCostFunction matmulCost(size_t left, size_t right, c10::optional<size_t> bias = c10::nullopt) {
+  return [=](const std::vector<c10::IValue>& inputs) -> c10::optional<OpCost> {
+    if (!isTensor(inputs, left) || !isTensor(inputs, right)) {
+      return c10::nullopt;
+    }
+    const auto& a = inputs[left].toTensor();
+    const auto& b = inputs[right].toTensor();
+    if (a.dim() == 0 || b.dim() == 0) {
+      return c10::nullopt;
     }
+    const int64_t m = a.dim() > 1 ? a.size(-2) : 1;
+    const int64_t k = a.size(-1);
+    const int64_t n = b.dim() > 1 ? b.size(-1) : 1;
+    const auto a_batch = a.dim() > 2 ? a.sizes().slice(0, a.dim() - 2) : at::IntArrayRef();
+    const auto b_batch = b.dim() > 2 ? b.sizes().slice(0, b.dim() - 2) : at::IntArrayRef();
+    const uint64_t batch = numel(at::infer_size(a_batch, b_batch));
+    const uint64_t out_numel = batch * m * n;
+
+    OpCost cost;
+    cost.flops = 2 * out_numel * k;
+    cost.bytes_read = bytes(a) + bytes(b);
+    cost.bytes_written = out_numel * at::elementSize(at::promoteTypes(a.scalar_type(), b.scalar_type()));
+    if (bias && isTensor(inputs, *bias)) {
+      cost.flops += out_numel;
+      cost.bytes_read += bytes(inputs[*bias].toTensor());
+    }
+    return cost;
+  };
+}
+
+// addbmm sums the products of the batch into a single [M, N] output
+c10::optional<OpCost> addbmmCost(const std::vector<c10::IValue>& inputs) {
+  auto cost = matmulCost(1, 2, 0)(inputs);
+  if (cost && isTensor(inputs, 0)) {
+    cost->bytes_written = bytes(inputs[0].toTensor());
   }
-  return true;
+  return cost;
 }
 
-std::unordered_map<std::string, c10::IValue> saveExtraArgs(const at::RecordFunction& fn) {
-  // for specific types of fn, return the saved extra args for computing flops
-  std::unordered_map<std::string, c10::IValue> map;
-  std::vector<c10::IValue> inputs = fn.inputs();
-  std::string fname(fn.name().str());
+// linear(input, weight, bias): the product of input with weight transposed
+c10::optional<OpCost> linearCost(const std::vector<c10::IValue>& inputs) {
+  if (!isTensor(inputs, 0) || !isTensor(inputs, 1)) {
+    return c10::nullopt;
+  }
+  const auto& input = inputs[0].toTensor();
+  const auto& weight = inputs[1].toTensor();
+  if (input.dim() == 0 || weight.dim() != 2) {
+    return c10::nullopt;
+  }
+  const uint64_t rows = input.numel() / std::max<int64_t>(input.size(-1), 1);
+  const uint64_t out_numel = rows * weight.size(0);
+  OpCost cost;
+  cost.flops = 2 * out_numel * weight.size(1);
+  cost.bytes_read = bytes(input) + bytes(weight);
+  cost.bytes_written = out_numel * input.element_size();
+  if (isTensor(inputs, 2)) {
+    cost.flops += out_numel;
+    cost.bytes_read += bytes(inputs[2].toTensor());
+  }
+  return cost;
+}
 
-  if (inputs.empty()) {
-    // Input shape is unavailable, return empty map
-    return map;
+std::vector<int64_t> expandParam(const c10::IValue& param, size_t dims, int64_t fallback) {
+  if (param.isIntList()) {
+    auto values = param.toIntVector();
+    if (values.size() == 1) {
+      values.resize(dims, values[0]);
+    }
+    if (values.size() == dims) {
+      return values;
+    }
+  }
+  return std::vector<int64_t>(dims, fallback);
+}
+
+// Convolutions with the arguments of aten::conv<N>d given transposed:
+// (input, weight, bias, stride, padding, dilation, groups), or else of
+// aten::convolution: (input, weight, bias, stride, padding, dilation,
+// transposed, output_padding, groups)
+OpCostFunction convolutionCost(c10::optional<bool> transposed) {
+  return [=](const std::vector<c10::IValue>& inputs) -> c10::optional<OpCost> {
+    const size_t groups_index = transposed ? 6 : 8;
+    if (!isTensor(inputs, 0) || !isTensor(inputs, 1) || inputs.size() <= groups_index) {
+      return c10::nullopt;
+    }
+    const auto& input = inputs[0].toTensor();
+    const auto& weight = inputs[1].toTensor();
+    const bool is_transposed = transposed
+        ? *transposed
+        : inputs[6].isBool() && inputs[6].toBool();
+    const int64_t spatial = weight.dim() - 2;
+    const int64_t groups = inputs[groups_index].isInt() ? inputs[groups_index].toInt() : 1;
+    if (spatial <= 0 || input.dim() != spatial + 2 || groups <= 0) {
+      return c10::nullopt;
+    }
+    const auto stride = expandParam(inputs[3], spatial, 1);
+    const auto dilation = expandParam(inputs[5], spatial, 1);
+    // padding="same" keeps the input size, padding="valid" is no padding
+    const bool same = inputs[4].isString() && inputs[4].toStringRef() == "same";
+    const auto padding = expandParam(inputs[4], spatial, 0);
+
+    // Every output element of a convolution, and every input element of a
+    // transposed one, takes a multiply-add per kernel element and channel of
+    // its group
+    const int64_t batch = input.size(0);
+    uint64_t kernel = 1;
+    std::vector<int64_t> out_sizes{batch};
+    if (!is_transposed) {
+      const int64_t out_channels = weight.size(0);
+      out_sizes.push_back(out_channels);
+      for (int64_t d = 0; d < spatial; ++d) {
+        const int64_t kernel_size = weight.size(d + 2);
+        kernel *= kernel_size;
+        out_sizes.push_back(same ? input.size(d + 2)
+            : (input.size(d + 2) + 2 * padding[d] - dilation[d] * (kernel_size - 1) - 1) / stride[d] + 1);
+      }
+    } else {
+      const int64_t out_channels = weight.size(1) * groups;
+      out_sizes.push_back(out_channels);
+      const auto output_padding = expandParam(inputs[7], spatial, 0);
+      for (int64_t d = 0; d < spatial; ++d) {
+        const int64_t kernel_size = weight.size(d + 2);
+        kernel *= kernel_size;
+        out_sizes.push_back((input.size(d + 2) - 1) * stride[d] - 2 * padding[d] +
+                            dilation[d] * (kernel_size - 1) + output_padding[d] + 1);
+      }
+    }
+    // weight.size(1) is the number of input channels per group of a
+    // convolution, and of output channels per group of a transposed one
+    const uint64_t macs_per_element = kernel * weight.size(1);
+    const uint64_t out_numel = numel(out_sizes);
+    const uint64_t macs = is_transposed
+        ? input.numel() * macs_per_element
+        : out_numel * macs_per_element;
+
+    OpCost cost;
+    cost.flops = 2 * macs;
+    cost.bytes_read = bytes(input) + bytes(weight);
+    cost.bytes_written = out_numel * input.element_size();
+    if (isTensor(inputs, 2)) {
+      cost.flops += out_numel;
+      cost.bytes_read += bytes(inputs[2].toTensor());
+    }
+    return cost;
+  };
+}
+
+// embedding(weight, indices, ...): gathers a row of weight per index
+c10::optional<OpCost> embeddingCost(const std::vector<c10::IValue>& inputs) {
+  if (!isTensor(inputs, 0) || !isTensor(inputs, 1)) {
+    return c10::nullopt;
+  }
+  const auto& weight = inputs[0].toTensor();
+  const auto& indices = inputs[1].toTensor();
+  if (weight.dim() != 2) {
+    return c10::nullopt;
+  }
+  const uint64_t gathered = indices.numel() * weight.size(1) * weight.element_size();
+  OpCost cost;
+  cost.bytes_read = bytes(indices) + gathered;
+  cost.bytes_written = gathered;
+  return cost;
+}
+
+// embedding_bag(weight, indices, offsets, scale_grad_by_freq, mode, sparse,
+// per_sample_weights, include_last_offset, ...): reduces the gathered rows of
+// each bag
+c10::optional<OpCost> embeddingBagCost(const std::vector<c10::IValue>& inputs) {
+  if (!isTensor(inputs, 0) || !isTensor(inputs, 1) || !isTensor(inputs, 2)) {
+    return c10::nullopt;
+  }
+  const auto& weight = inputs[0].toTensor();
+  const auto& indices = inputs[1].toTensor();
+  const auto& offsets = inputs[2].toTensor();
+  if (weight.dim() != 2) {
+    return c10::nullopt;
+  }
+  const int64_t dim = weight.size(1);
+  const bool include_last_offset = inputs.size() > 7 && inputs[7].isBool() && inputs[7].toBool();
+  const int64_t bags = indices.dim() == 2
+      ? indices.size(0)
+      : std::max<int64_t>(offsets.numel() - (include_last_offset ? 1 : 0), 0);
+  OpCost cost;
+  cost.flops = indices.numel() * dim;
+  cost.bytes_read = bytes(indices) + bytes(offsets) + indices.numel() * dim * weight.element_size();
+  if (isTensor(inputs, 6)) {
+    cost.flops += indices.numel() * dim;
+    cost.bytes_read += bytes(inputs[6].toTensor());
   }
+  cost.bytes_written = bags * dim * weight.element_size();
+  return cost;
+}
 
-  if (fname == kConv2dOp) {
-    std::vector<int> tensors{0, 1};
-    bool check = validateInput(fname, kConv2dGroups + 1, inputs, tensors);
-    if (!check) {
-      return map;
+struct OpCostRegistry {
+  OpCostRegistry() {
+    for (const char* name : {"aten::mm", "aten::bmm", "aten::matmul", "aten::mv", "aten::dot"}) {
+      functions[name] = matmulCost(0, 1);
+    }
+    for (const char* name : {"aten::addmm", "aten::addmm_", "aten::baddbmm", "aten::baddbmm_",
+                             "aten::addmv", "aten::addmv_"}) {
+      functions[name] = matmulCost(1, 2, 0);
     }
+    functions["aten::addbmm"] = addbmmCost;
+    functions["aten::addbmm_"] = addbmmCost;
+    functions["aten::linear"] = linearCost;
 
-    at::Tensor input = inputs[0].toTensor();
-    at::Tensor weight = inputs[1].toTensor();
-    if (weight.sizes().size() != 4) {
-      TORCH_WARN("Failed to compute flops for op aten::conv2d because it requires a 4D kernel tensor.");
-      return map;
+    for (const char* name : {"aten::conv1d", "aten::conv2d", "aten::conv3d"}) {
+      functions[name] = convolutionCost(false);
     }
-    map[kInputSize] = at::IValue(input.sizes());
-    map[kWeightSize] = at::IValue(weight.sizes());
-    map[kStride] = inputs[kConv2dStride];
-    map[kPadding] = inputs[kConv2dPadding];
-    map[kDilation] = inputs[kConv2dDilation];
-    map[kGroups] = inputs[kConv2dGroups];
-  } else if (fname == kGemmOp) {
-    std::vector<int> tensors{0, 1};
-    bool check = validateInput(fname, 2, inputs, tensors);
-    if (!check) {
-      return map;
+    for (const char* name : {"aten::convolution", "aten::_convolution"}) {
+      functions[name] = convolutionCost(c10::nullopt);
     }
 
-    at::Tensor left = inputs[0].toTensor();
-    at::Tensor right = inputs[1].toTensor();
-    map[kMat1Size] = at::IValue(left.sizes());
-    map[kMat2Size] = at::IValue(right.sizes());
-  } else if (fname == kMulOp) {
-    std::vector<int> tensors{0};
-    bool check = validateInput(fname, 1, inputs, tensors);
-    if (!check) {
-      return map;
+    for (const char* name : {"add", "sub", "mul", "div", "neg", "abs", "relu", "threshold",
+                             "clamp", "clamp_min", "clamp_max", "where", "leaky_relu",
+                             "hardtanh", "maximum", "minimum", "reciprocal", "sign"}) {
+      registerPointwise(name, pointwiseCost(1));
+    }
+    for (const char* name : {"addcmul", "addcdiv", "lerp", "hardsigmoid", "square"}) {
+      registerPointwise(name, pointwiseCost(2));
+    }
+    // Transcendental functions count as a few operations
+    for (const char* name : {"exp", "log", "sqrt", "rsqrt", "sigmoid", "tanh", "pow",
+                             "gelu", "silu", "hardswish", "elu", "softplus", "erf", "sin", "cos"}) {
+      registerPointwise(name, pointwiseCost(4));
+    }
+    for (const char* name : {"eq", "ne", "lt", "le", "gt", "ge"}) {
+      registerPointwise(name, pointwiseCost(1, at::kBool));
+    }
+    for (const char* name : {"softmax", "_softmax", "log_softmax", "_log_softmax", "layer_norm"}) {
+      functions[std::string("aten::") + name] = pointwiseCost(5);
     }
 
-    at::Tensor mat = inputs[0].toTensor();
-    map[kMatSize] = at::IValue(mat.sizes());
-  } else if (fname == kAddOp) {
-    std::vector<int> tensors{0};
-    bool check = validateInput(fname, 1, inputs, tensors);
-    if (!check) {
-      return map;
+    for (const char* name : {"sum", "mean", "prod", "amax", "amin", "max", "min", "argmax",
+                             "argmin", "var", "std", "logsumexp", "all", "any"}) {
+      functions[std::string("aten::") + name] = reductionCost(1);
     }
+    functions["aten::norm"] = reductionCost(2);
 
-    at::Tensor mat = inputs[0].toTensor();
-    map[kMatSize] = at::IValue(mat.sizes());
+    functions["aten::embedding"] = embeddingCost;
+    functions["aten::embedding_bag"] = embeddingBagCost;
+    functions["aten::_embedding_bag"] = embeddingBagCost;
   }
 
+  // Registers the op and its in-place variant
+  void registerPointwise(const char* name, const OpCostFunction& fn) {
+    functions[std::string("aten::") + name] = fn;
+    functions[std::string("aten::") + name + "_"] = fn;
+  }
+
+  std::mutex mutex;
+  std::unordered_map<std::string, OpCostFunction> functions;
+};
+
+OpCostRegistry& opCostRegistry() {
+  static OpCostRegistry registry_;
+  return registry_;
+}
+
+} // namespace
+
+void registerOpCostFunction(const std::string& name, OpCostFunction fn) {
+  auto& registry = opCostRegistry();
+  std::lock_guard<std::mutex> guard(registry.mutex);
+  registry.functions[name] = std::move(fn);
+}
+
+c10::optional<OpCost> computeOpCost(
+    const std::string& name,
+    const std::string& overload_name,
+    const std::vector<c10::IValue>& inputs) {
+  OpCostFunction fn;
+  {
+    auto& registry = opCostRegistry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    auto it = registry.functions.end();
+    if (!overload_name.empty()) {
+      it = registry.functions.find(name + "." + overload_name);
+    }
+    if (it == registry.functions.end()) {
+      it = registry.functions.find(name);
+    }
+    if (it == registry.functions.end()) {
+      return c10::nullopt;
+    }
+    fn = it->second;
+  }
+  try {
+    return fn(inputs);
+  } catch (const c10::Error&) {
+    // The inputs are those of a call that hasn't run yet (e.g. tensors that
+    // don't broadcast), so they may be invalid
+    return c10::nullopt;
+  }
+}
+
+std::unordered_map<std::string, c10::IValue> saveExtraArgs(const at::RecordFunction& fn) {
+  // for the ops with a cost function, return the saved extra args for
+  // computing flops and bytes
+  std::unordered_map<std::string, c10::IValue> map;
+  const std::vector<c10::IValue>& inputs = fn.inputs();
+
+  if (inputs.empty()) {
+    // Input shape is unavailable, return empty map
+    return map;
+  }
+
+  const auto op_name = fn.operator_name();
+  auto cost = op_name
+      ? computeOpCost(op_name->name, op_name->overload_name, inputs)
+      : computeOpCost(std::string(fn.name().str()), "", inputs);
+  if (cost) {
+    map[kFlops] = at::IValue(static_cast<int64_t>(cost->flops));
+    map[kBytesRead] = at::IValue(static_cast<int64_t>(cost->bytes_read));
+    map[kBytesWritten] = at::IValue(static_cast<int64_t>(cost->bytes_written));
+  }
   return map;
 }
 
+uint64_t computeBytesRead(const std::unordered_map<std::string, c10::IValue> &extra_args) {
+  auto it = extra_args.find(kBytesRead);
+  return it != extra_args.end() && it->second.isInt() ? it->second.toInt() : 0;
+}
+
+uint64_t computeBytesWritten(const std::unordered_map<std::string, c10::IValue> &extra_args) {
+  auto it = extra_args.find(kBytesWritten);
+  return it != extra_args.end() && it->second.isInt() ? it->second.toInt() : 0;
+}
+
 uint64_t computeFlops(const std::string &op_name, const std::unordered_map<std::string, c10::IValue> &extra_args) {
+  // Saved by saveExtraArgs from the cost function of the op
+  auto flops_it = extra_args.find(kFlops);
+  if (flops_it != extra_args.end() && flops_it->second.isInt()) {
+    return flops_it->second.toInt();
+  }
   if (op_name == kConv2dOp) {
     if (extra_args.find(kInputSize) == extra_args.end()
         || extra_args.find(kWeightSize) == extra_args.end()
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <ATen/ATen.h>
@@ -8,9 +9,40 @@
 namespace torch { namespace autograd {
 namespace profiler {
 
+// Analytic cost of an operator call
+struct TORCH_API OpCost {
+  uint64_t flops = 0;
+  uint64_t bytes_read = 0;
+  uint64_t bytes_written = 0;
+};
+
+// Estimates the cost of a call from its inputs, or returns nullopt if the
+// inputs don't allow it (e.g. they are not the expected tensors)
+using OpCostFunction =
+    std::function<c10::optional<OpCost>(const std::vector<c10::IValue>& inputs)>;
+
+// Registers the cost function of an operator, replacing any previous one.
+// name is either an operator name (e.g. "aten::add"), for all its overloads,
+// or an overload name (e.g. "aten::add.Tensor"), which takes precedence.
+// The costs of the GEMM, convolution, common pointwise, reduction and
+// embedding operators are registered by default.
+TORCH_API void registerOpCostFunction(const std::string& name, OpCostFunction fn);
+
+// Returns the cost of a call of the operator, if its cost function is
+// registered
+TORCH_API c10::optional<OpCost> computeOpCost(
+    const std::string& name,
+    const std::string& overload_name,
+    const std::vector<c10::IValue>& inputs);
+
 std::unordered_map<std::string, c10::IValue> TORCH_API saveExtraArgs(const at::RecordFunction& fn);
 
 uint64_t TORCH_API computeFlops(const std::string &op_name,
                                 const std::unordered_map<std::string, c10::IValue> &extra_args);
 
+// Bytes read and written by the op, from the extra arguments saved by
+// saveExtraArgs
+uint64_t TORCH_API computeBytesRead(const std::unordered_map<std::string, c10::IValue> &extra_args);
+uint64_t TORCH_API computeBytesWritten(const std::unordered_map<std::string, c10::IValue> &extra_args);
+
 }}}
@@ -0,0 +1,80 @@
+#include <torch/csrc/autograd/python_saved_variable_hooks.h>
+
+#include <torch/csrc/THP.h>
+#include <torch/csrc/Exceptions.h>
+#include <torch/csrc/autograd/python_variable.h>
+#include <torch/csrc/utils/object_ptr.h>
+#include <torch/csrc/utils/python_strings.h>
+
+namespace torch { namespace autograd {
+
+PySavedVariableHooks::PySavedVariableHooks(PyObject* pack_hook, PyObject* unpack_hook)
+  : pack_hook_(pack_hook), unpack_hook_(unpack_hook) {
+  pybind11::gil_scoped_acquire gil;
+  Py_INCREF(pack_hook_);
+  Py_INCREF(unpack_hook_);
+}
+
+PySavedVariableHooks::~PySavedVariableHooks() {
+  // The hooks of the saved variables of a graph kept alive at exit can be
+  // destroyed after the interpreter, leak the python objects then.
+  if (Py_IsInitialized()) {
+    pybind11::gil_scoped_acquire gil;
+    Py_DECREF(pack_hook_);
+    Py_DECREF(unpack_hook_);
+    Py_XDECREF(data_);
+  }
+}
+
+void PySavedVariableHooks::call_pack_hook(const at::Tensor& tensor) {
+  pybind11::gil_scoped_acquire gil;
+  THPObjectPtr obj(THPVariable_Wrap(tensor));
+  if (!obj) throw python_error();
+  PyObject* packed = PyObject_CallFunctionObjArgs(pack_hook_, obj.get(), nullptr);
+  if (!packed) throw python_error();
+  Py_XDECREF(data_);
+  data_ = packed;
+}
+
+at::Tensor PySavedVariableHooks::call_unpack_hook() {
+  pybind11::gil_scoped_acquire gil;
+  TORCH_INTERNAL_ASSERT(data_, "unpack hook called before the pack hook");
+  THPObjectPtr res(PyObject_CallFunctionObjArgs(unpack_hook_, data_, nullptr));
+  if (!res) throw python_error();
+  TORCH_CHECK_TYPE(THPVariable_Check(res.get()),
+      "Output of saved tensor unpack_hook expected to be a Tensor but got result of type ",
+      THPUtils_typename(res.get()));
+  return THPVariable_Unpack(res.get());
+}
+
+namespace {
+
+// Holds a reference to the hooks of the factory, which can be destroyed
+// without the GIL
+struct PyHooksPair {
+  PyHooksPair(PyObject* pack_hook, PyObject* unpack_hook)
+    : pack_hook(pack_hook), unpack_hook(unpack_hook) {
+    Py_INCREF(pack_hook);
+    Py_INCREF(unpack_hook);
+  }
+  ~PyHooksPair() {
+    if (Py_IsInitialized()) {
+      pybind11::gil_scoped_acquire gil;
+      Py_DECREF(pack_hook);
+      Py_DECREF(unpack_hook);
+    }
+  }
+  PyObject* pack_hook;
+  PyObject* unpack_hook;
+};
+
+} // namespace
+
+void push_py_saved_variable_default_hooks(PyObject* pack_hook, PyObject* unpack_hook) {
+  auto hooks = std::make_shared<PyHooksPair>(pack_hook, unpack_hook);
+  impl::push_default_saved_variable_hooks([hooks]() -> std::unique_ptr<SavedVariableHooks> {
+    return std::make_unique<PySavedVariableHooks>(hooks->pack_hook, hooks->unpack_hook);
+  });
+}
+
+}}
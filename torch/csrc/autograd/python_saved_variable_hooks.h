@@ -0,0 +1,28 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <torch/csrc/autograd/saved_variable_hooks.h>
+#include <torch/csrc/python_headers.h>
+
+namespace torch { namespace autograd {
+
+// Saved variable hooks calling a pair of python functions: pack_hook(tensor)
+// returns any python object, that unpack_hook(packed) turns back into the
+// tensor.
+struct PySavedVariableHooks : public SavedVariableHooks {
+  PySavedVariableHooks(PyObject* pack_hook, PyObject* unpack_hook);
+  ~PySavedVariableHooks() override;
+  void call_pack_hook(const at::Tensor& tensor) override;
+  at::Tensor call_unpack_hook() override;
+
+ private:
+  PyObject* pack_hook_;
+  PyObject* unpack_hook_;
+  PyObject* data_ = nullptr;
+};
+
+// Pushes pack_hook and unpack_hook as the default hooks of the variables
+// saved on this thread, see impl::push_default_saved_variable_hooks.
+void push_py_saved_variable_default_hooks(PyObject* pack_hook, PyObject* unpack_hook);
+
+}}
@@ -11,9 +11,40 @@
 #include <list>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 namespace torch { namespace autograd {
 
+namespace {
+
+thread_local std::vector<SavedVariableHooksFactory> default_hooks_stack;
+// True while a pack hook runs on this thread, so that the variables it saves
+// itself are not packed recursively
+thread_local bool in_pack_hook = false;
+
+} // namespace
+
+namespace impl {
+
+void push_default_saved_variable_hooks(SavedVariableHooksFactory factory) {
+  default_hooks_stack.push_back(std::move(factory));
+}
+
+void pop_default_saved_variable_hooks() {
+  TORCH_INTERNAL_ASSERT(!default_hooks_stack.empty(),
+      "pop_default_saved_variable_hooks called without default hooks");
+  default_hooks_stack.pop_back();
+}
+
+std::unique_ptr<SavedVariableHooks> make_default_saved_variable_hooks() {
+  if (default_hooks_stack.empty() || in_pack_hook) {
+    return nullptr;
+  }
+  return default_hooks_stack.back()();
+}
+
+} // namespace impl
+
 SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_inplace_view) {
   if (variable.defined()) {
     was_default_constructed_ = false;
@@ -39,6 +70,19 @@ SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_i
     }
     version_counter_ = impl::version_counter(variable);
     saved_version_ = version_counter_.current_version();
+
+    hooks_ = impl::make_default_saved_variable_hooks();
+    if (hooks_) {
+      in_pack_hook = true;
+      try {
+        hooks_->call_pack_hook_with_variable(data_, variable);
+      } catch (...) {
+        in_pack_hook = false;
+        throw;
+      }
+      in_pack_hook = false;
+      data_.reset();
+    }
   }
 }
 
@@ -46,7 +90,7 @@ SavedVariable::SavedVariable(const c10::optional<Variable>& variable, bool is_ou
   : SavedVariable(variable.has_value() ? *variable : Variable(), is_output, is_inplace_view) {}
 
 Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
-  if (!data_.defined()) {
+  if (!data_.defined() && !hooks_) {
     if (!was_default_constructed_) {
       throw std::runtime_error(ERR_BACKWARD_TWICE);
     }
@@ -63,11 +107,15 @@ Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
     grad_fn = std::move(saved_for);
   }
 
+  // The version check is done before calling the unpack hook: the tensor it
+  // returns can have its own version counter.
   if (saved_version_ != version_counter_.current_version()) {
     std::stringstream message;
     message << "one of the variables needed for gradient computation has been "
-        "modified by an inplace operation: [" << data_.toString() << " "
-        << data_.sizes() << "]";
+        "modified by an inplace operation";
+    if (data_.defined()) {
+      message << ": [" << data_.toString() << " " << data_.sizes() << "]";
+    }
     if (grad_fn) {
         message << ", which is output " << output_nr_
             << " of " << grad_fn->name() << ",";
@@ -87,14 +135,20 @@ Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
     throw std::runtime_error(message.str());
   }
 
+  at::Tensor data = data_;
+  if (hooks_) {
+    data = hooks_->call_unpack_hook();
+    TORCH_CHECK(data.defined(), "The unpack hook of a saved tensor returned an undefined tensor");
+  }
+
   // NB: saved views are unpacked as normal Variables (not views) even though
   // they still share the same storage. This works only because we never call
   // in-place functions on unpacked variables.
   Variable var;
   if (grad_fn) {
-    var = make_variable(data_, Edge(std::move(grad_fn), output_nr_));
+    var = make_variable(data, Edge(std::move(grad_fn), output_nr_));
   } else {
-    var = make_variable(data_, requires_grad_);
+    var = make_variable(data, requires_grad_);
   }
   impl::set_version_counter(var, saved_version_);
 
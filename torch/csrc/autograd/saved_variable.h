@@ -2,6 +2,7 @@
 
 #include <torch/csrc/WindowsTorchApiMacro.h>
 #include <torch/csrc/autograd/forward_grad.h>
+#include <torch/csrc/autograd/saved_variable_hooks.h>
 
 #include <ATen/ATen.h>
 
@@ -37,6 +38,7 @@ class TORCH_API SavedVariable {
   Variable unpack(std::shared_ptr<Node> saved_for = nullptr) const;
 
   void reset_data() {
+    hooks_.reset();
     return data_.reset();
   }
 
@@ -47,6 +49,10 @@ class TORCH_API SavedVariable {
  private:
   at::Tensor data_;
 
+  // When set, the hooks keep the saved tensor instead of data_, which stays
+  // undefined. See SavedVariableHooks
+  std::unique_ptr<SavedVariableHooks> hooks_;
+
   // This field is used to store the forward AD gradients associated with
   // the saved Tensor. Note that this shared_ptr must never be shared with
   // either the saved Tensor or the unpacked Tensor. See note [ Using ForwardGrad ]
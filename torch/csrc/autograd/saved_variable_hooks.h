@@ -0,0 +1,45 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <ATen/Tensor.h>
+
+#include <functional>
+#include <memory>
+
+namespace torch { namespace autograd {
+
+/// Hooks that replace how a `SavedVariable` keeps its tensor until backward.
+/// `call_pack_hook` is called once, when the variable is saved, and may keep
+/// any representation of the tensor (e.g. a copy in CPU memory, or what is
+/// needed to recompute it). `call_unpack_hook` is called every time the
+/// variable is unpacked and must return a tensor with the same values,
+/// sizes, dtype and device as the packed one.
+struct TORCH_API SavedVariableHooks {
+  virtual void call_pack_hook(const at::Tensor& tensor) = 0;
+  /// What `SavedVariable` calls: `call_pack_hook`, unless overridden by hooks
+  /// that also look at the saved variable itself (e.g. at its `grad_fn`),
+  /// which `tensor` is the data of.
+  virtual void call_pack_hook_with_variable(const at::Tensor& tensor, const at::Tensor& variable) {
+    call_pack_hook(tensor);
+  }
+  virtual at::Tensor call_unpack_hook() = 0;
+  virtual ~SavedVariableHooks() = default;
+};
+
+using SavedVariableHooksFactory =
+    std::function<std::unique_ptr<SavedVariableHooks>()>;
+
+namespace impl {
+
+// The default hooks are a thread local stack: every `SavedVariable` created
+// on a thread while the stack is not empty gets hooks made by the factory at
+// its top. The hooks are not used for the variables saved while a pack hook
+// runs.
+TORCH_API void push_default_saved_variable_hooks(SavedVariableHooksFactory factory);
+TORCH_API void pop_default_saved_variable_hooks();
+TORCH_API std::unique_ptr<SavedVariableHooks> make_default_saved_variable_hooks();
+
+} // namespace impl
+
+}} // namespace torch::autograd
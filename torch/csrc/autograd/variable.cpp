@@ -38,7 +38,8 @@ DifferentiableViewMeta::DifferentiableViewMeta(at::TensorImpl* self_impl,
   is_view_ = true;
   if (backward_info_.has_value()) {
     self_impl->set_version_counter(impl::version_counter(backward_info_.value().base_));
-    attr_version = self_impl->version_counter().current_version();
+    // views of inference tensors have no version, see Note [Inference mode]
+    attr_version = self_impl->is_inference() ? 0 : self_impl->version_counter().current_version();
   }
 }
 
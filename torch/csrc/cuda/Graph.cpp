@@ -27,7 +27,10 @@ void THCPGraph_init(PyObject *module) {
       .def("capture_begin",
            &::at::cuda::CUDAGraph::capture_begin,
            py::call_guard<py::gil_scoped_release>(),
-           R"(``capture_begin`` begins Cuda graph capture on the current stream.)")
+           py::arg("pool") = c10::cuda::CUDACachingAllocator::MempoolId_t{0, 0},
+           R"(``capture_begin`` begins Cuda graph capture on the current stream.
+           Allocations during capture come from a private memory pool, or from the
+           pool of another graph if ``pool`` is that graph's ``pool()``.)")
       .def("capture_end",
            &::at::cuda::CUDAGraph::capture_end,
            py::call_guard<py::gil_scoped_release>(),
@@ -37,6 +40,9 @@ void THCPGraph_init(PyObject *module) {
            &::at::cuda::CUDAGraph::replay,
            py::call_guard<py::gil_scoped_release>(),
            R"(``replay`` replays the Cuda graph captured by this instance.)")
+      .def("pool",
+           &::at::cuda::CUDAGraph::pool,
+           R"(``pool`` returns the id of the memory pool of this instance's capture.)")
       // reset is called in __del__ on the Python side
       // (see class Graph in torch/cuda/streams.py for reasons and caveats)
       .def("reset",
@@ -7,8 +7,10 @@
 #include <ATen/ATen.h>
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/CUDAGeneratorImpl.h>
+#include <ATen/native/cuda/IndexBoundsCheck.cuh>
 #include <c10/cuda/CUDAFunctions.h>
 #include <c10/cuda/CUDACachingAllocator.h>
+#include <THC/THCCachingHostAllocator.h>
 #ifdef USE_NCCL
 #include <torch/csrc/cuda/python_nccl.h>
 #endif
@@ -219,6 +221,7 @@ PyObject * THCPModule_cudaSynchronize(PyObject *_unused, PyObject *noargs)
 {
   HANDLE_TH_ERRORS
   c10::cuda::device_synchronize();
+  at::native::throwPendingIndexError();
   Py_RETURN_NONE;
   END_HANDLE_TH_ERRORS
 }
@@ -342,7 +345,7 @@ PyObject * THCPModule_memoryStats(PyObject *_unused, PyObject *arg)
 
   const auto statArrayToDict = [=](const StatArray& statArray) {
     const std::array<const char*, static_cast<size_t>(StatType::NUM_TYPES)> statTypeNames = {
-      "all", "small_pool", "large_pool"
+      "all", "small_pool", "large_pool", "slab_pool"
     };
     py::dict dict;
     for (size_t i = 0; i < statTypeNames.size(); ++i) {
@@ -389,6 +392,49 @@ PyObject * THCPModule_resetPeakMemoryStats(PyObject *_unused, PyObject *arg)
   Py_RETURN_NONE;
 }
 
+PyObject * THCPModule_hostMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  using c10::cuda::CUDACachingAllocator::Stat;
+
+  const auto statToDict = [](const Stat& stat) {
+    py::dict dict;
+
+    dict["current"] = stat.current;
+    dict["peak"] = stat.peak;
+    dict["allocated"] = stat.allocated;
+    dict["freed"] = stat.freed;
+    return dict;
+  };
+
+  const THCCachingHostAllocatorStats stats = THCCachingHostAllocator_getStats();
+
+  py::dict result;
+  result["allocation"] = statToDict(stats.allocation);
+  result["segment"] = statToDict(stats.segment);
+  result["allocated_bytes"] = statToDict(stats.allocated_bytes);
+  result["reserved_bytes"] = statToDict(stats.reserved_bytes);
+
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject * THCPModule_resetAccumulatedHostMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  THCCachingHostAllocator_resetAccumulatedStats();
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject * THCPModule_resetPeakHostMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  THCCachingHostAllocator_resetPeakStats();
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
 PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
 {
   HANDLE_TH_ERRORS
@@ -403,7 +449,7 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
     segmentDict["total_size"] = segmentInfo.total_size;
     segmentDict["allocated_size"] = segmentInfo.allocated_size;
     segmentDict["active_size"] = segmentInfo.active_size;
-    segmentDict["segment_type"] = (segmentInfo.is_large ? "large" : "small");
+    segmentDict["segment_type"] = (segmentInfo.is_slab ? "slab" : (segmentInfo.is_large ? "large" : "small"));
 
     py::list blocks;
     for (const auto& blockInfo : segmentInfo.blocks) {
@@ -553,6 +599,9 @@ static struct PyMethodDef _THCPModule_methods[] = {
   {"_cuda_resetAccumulatedMemoryStats", THCPModule_resetAccumulatedMemoryStats, METH_O, nullptr},
   {"_cuda_resetPeakMemoryStats", THCPModule_resetPeakMemoryStats, METH_O,  nullptr},
   {"_cuda_memorySnapshot", THCPModule_memorySnapshot, METH_NOARGS, nullptr},
+  {"_cuda_hostMemoryStats", THCPModule_hostMemoryStats, METH_NOARGS, nullptr},
+  {"_cuda_resetAccumulatedHostMemoryStats", THCPModule_resetAccumulatedHostMemoryStats, METH_NOARGS, nullptr},
+  {"_cuda_resetPeakHostMemoryStats", THCPModule_resetPeakHostMemoryStats, METH_NOARGS, nullptr},
   {"_cuda_cudaHostAllocator", THCPModule_cudaHostAllocator, METH_NOARGS, nullptr},
   {"_cuda_cudaCachingAllocator_raw_alloc", THCPModule_cudaCachingAllocator_raw_alloc, METH_VARARGS, nullptr},
   {"_cuda_cudaCachingAllocator_raw_delete", THCPModule_cudaCachingAllocator_raw_delete, METH_O, nullptr},
@@ -11,6 +11,7 @@ using version_tuple = std::tuple<size_t, size_t, size_t>;
 }
 
 #ifdef USE_CUDNN
+#include <ATen/native/cudnn/BenchmarkCache.h>
 #include <cudnn.h>
 
 namespace {
@@ -95,6 +96,18 @@ void initCudnnBindings(PyObject* module) {
   cudnn.def("getRuntimeVersion", getRuntimeVersion);
   cudnn.def("getCompileVersion", getCompileVersion);
   cudnn.def("getVersionInt", getVersionInt);
+
+#ifdef USE_CUDNN
+  cudnn.def("exportBenchmarkCache", []() {
+    return py::bytes(at::native::exportCudnnBenchmarkCache());
+  });
+  cudnn.def("importBenchmarkCache", [](const py::bytes& state) {
+    return at::native::importCudnnBenchmarkCache(state);
+  });
+  cudnn.def("saveBenchmarkCache", &at::native::saveCudnnBenchmarkCache);
+  cudnn.def("loadBenchmarkCache", &at::native::loadCudnnBenchmarkCache);
+  cudnn.def("clearBenchmarkCache", &at::native::clearCudnnBenchmarkCache);
+#endif
 }
 
 } // namespace shared
@@ -190,6 +190,7 @@ extern "C" struct _frozen _PyImport_FrozenModules[];
 extern "C" struct _frozen _PyImport_FrozenModules_torch[];
 
 static std::atomic<size_t> s_id;
+// the models loaded in this interpreter, by id
 std::map<size_t, py::object> forwards;
 
 __attribute__((constructor)) void init() {
@@ -246,6 +247,8 @@ void startup() {
 
 void teardown() {
   PyGILState_Ensure();
+  // the models must be released before the interpreter goes away
+  forwards.clear();
 
   if (Py_FinalizeEx() < 0) {
     std::cout << "IT BROKE SO WE ARE EXITING\n";
@@ -297,6 +300,7 @@ model = i.load_pickle('model', 'model.pkl')
     py::exec(code);
 
   auto id = ++s_id;
+  forwards[id] = py::globals()["model"];
 
   PyGILState_Release(gstate);
   return id;
@@ -307,7 +311,7 @@ at::Tensor forward_model(size_t model_id, at::Tensor const & input) {
   PyGILState_STATE gstate = PyGILState_Ensure();
   {
     TORCH_INTERNAL_ASSERT(PyGILState_Check() == 1);
-    auto forward = py::globals()["model"].attr("forward");
+    auto forward = forwards.at(model_id).attr("forward");
 
     py::object py_output = forward(input);
     // TODO is this going to leak?
@@ -322,3 +326,39 @@ at::Tensor forward_model(size_t model_id, at::Tensor const & input) {
   return output;
   // return input;
 }
+
+std::vector<std::pair<std::string, at::Tensor>> model_weights(size_t model_id) {
+  py::gil_scoped_acquire gil;
+  std::vector<std::pair<std::string, at::Tensor>> weights;
+  auto state_dict = forwards.at(model_id).attr("state_dict")("keep_vars"_a = true);
+  for (const auto& item : py::cast<py::dict>(state_dict)) {
+    weights.emplace_back(py::cast<std::string>(item.first), py::cast<at::Tensor>(item.second));
+  }
+  return weights;
+}
+
+// Forwards the model's parameters and buffers to the tensors of another
+// interpreter, which share the same storages: the tensors live in the common
+// libtorch, so only their python wrappers are per interpreter.
+const char* share_weights = R"RAW(
+with torch.no_grad():
+    state_dict = model.state_dict(keep_vars=True)
+    for name, tensor in shared.items():
+        if name not in state_dict:
+            raise RuntimeError(f"share_model_weights: the model has no weight '{name}'")
+        if state_dict[name].shape != tensor.shape or state_dict[name].dtype != tensor.dtype:
+            raise RuntimeError(f"share_model_weights: mismatched weight '{name}'")
+        state_dict[name].set_(tensor)
+)RAW";
+
+void share_model_weights(
+    size_t model_id,
+    std::vector<std::pair<std::string, at::Tensor>> const& weights) {
+  py::gil_scoped_acquire gil;
+  py::dict shared;
+  for (const auto& weight : weights) {
+    shared[py::str(weight.first)] = py::cast(weight.second);
+  }
+  py::dict locals("model"_a = forwards.at(model_id), "shared"_a = shared);
+  py::exec(share_weights, py::globals(), locals);
+}
@@ -1,6 +1,10 @@
 #pragma once
 #include <ATen/ATen.h>
 
+#include <string>
+#include <utility>
+#include <vector>
+
 // NOTE- if adding new interface functions,
 // update interpreter.cpp initialize_interface.
 size_t load_model(const char* model_file, bool hermetic=false);
@@ -9,6 +13,13 @@ void run_some_python(const char* code);
 void startup();
 void teardown();
 void run_python_file(const char* code);
+// The named parameters and buffers of a loaded model
+std::vector<std::pair<std::string, at::Tensor>> model_weights(size_t model_id);
+// Makes the weights of a loaded model alias 'weights' (e.g. the weights of the
+// same model in another interpreter), freeing their own copy
+void share_model_weights(
+    size_t model_id,
+    std::vector<std::pair<std::string, at::Tensor>> const& weights);
 
 
 #define FOREACH_INTERFACE_FUNCTION(_) \
@@ -17,7 +28,9 @@ void run_python_file(const char* code);
   _(run_some_python)                  \
   _(startup)                          \
   _(teardown)                         \
-  _(run_python_file)
+  _(run_python_file)                  \
+  _(model_weights)                    \
+  _(share_model_weights)
 
 struct InterpreterImpl {
 #define DEFINE_POINTER(func) decltype(&::func) func;
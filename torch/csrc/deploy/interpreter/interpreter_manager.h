@@ -0,0 +1,116 @@
+#pragma once
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <torch/csrc/deploy/interpreter/interpreter.h>
+
+// A pool of interpreters serving the same models. Each model is loaded in all
+// the interpreters, but its weights are only kept once: the other interpreters
+// alias the tensors of the first one. Every call goes to the interpreter with
+// the fewest calls in flight, so that concurrent callers don't serialize on a
+// single GIL.
+class InterpreterManager {
+ private:
+  struct Slot {
+    std::unique_ptr<Interpreter> interp;
+    // the calls handed to this interpreter and not yet returned, including
+    // the one it is running
+    std::atomic<size_t> pending{0};
+  };
+
+  // Counts a call in its slot's queue for as long as it runs
+  struct PendingGuard {
+    explicit PendingGuard(Slot& slot) : slot_(slot) {
+      ++slot_.pending;
+    }
+    ~PendingGuard() {
+      --slot_.pending;
+    }
+    Slot& slot_;
+  };
+
+  std::vector<std::unique_ptr<Slot>> slots_;
+  // the id of each model in each interpreter
+  std::vector<std::vector<size_t>> model_ids_;
+
+  size_t least_loaded() const {
+    size_t best = 0;
+    size_t best_pending = std::numeric_limits<size_t>::max();
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      const size_t pending = slots_[i]->pending.load();
+      if (pending < best_pending) {
+        best = i;
+        best_pending = pending;
+      }
+    }
+    return best;
+  }
+
+ public:
+  explicit InterpreterManager(size_t n_interp = 2) {
+    if (n_interp == 0) {
+      throw std::runtime_error("InterpreterManager needs at least one interpreter.");
+    }
+    // created one after the other, as the torch import isn't thread safe
+    for (size_t i = 0; i < n_interp; ++i) {
+      auto slot = std::make_unique<Slot>();
+      slot->interp = std::make_unique<Interpreter>();
+      slots_.push_back(std::move(slot));
+    }
+  }
+  InterpreterManager(const InterpreterManager&) = delete;
+
+  // Loads the model in all the interpreters and returns its id in the
+  // manager. Not thread safe with respect to the other calls.
+  size_t load_model(const char* model_file, bool hermetic = false) {
+    std::vector<size_t> ids;
+    ids.reserve(slots_.size());
+    std::vector<std::pair<std::string, at::Tensor>> weights;
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      auto& interp = *slots_[i]->interp;
+      const size_t id = interp.load_model(model_file, hermetic);
+      if (i == 0) {
+        weights = interp.model_weights(id);
+      } else {
+        interp.share_model_weights(id, weights);
+      }
+      ids.push_back(id);
+    }
+    model_ids_.push_back(std::move(ids));
+    return model_ids_.size() - 1;
+  }
+
+  // Runs the model in the least loaded interpreter; safe to call from
+  // several threads
+  at::Tensor forward_model(size_t model_id, at::Tensor const& input) {
+    const auto& ids = model_ids_.at(model_id);
+    const size_t i = least_loaded();
+    PendingGuard guard(*slots_[i]);
+    return slots_[i]->interp->forward_model(ids[i], input);
+  }
+
+  // The number of calls in flight in each interpreter
+  std::vector<size_t> queue_depths() const {
+    std::vector<size_t> depths;
+    depths.reserve(slots_.size());
+    for (const auto& slot : slots_) {
+      depths.push_back(slot->pending.load());
+    }
+    return depths;
+  }
+
+  size_t size() const {
+    return slots_.size();
+  }
+
+  Interpreter& interpreter(size_t i) {
+    return *slots_.at(i)->interp;
+  }
+
+  // The id of the model in the i-th interpreter
+  size_t interpreter_model_id(size_t model_id, size_t i) const {
+    return model_ids_.at(model_id).at(i);
+  }
+};
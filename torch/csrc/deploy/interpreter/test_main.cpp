@@ -1,9 +1,11 @@
 #include <gtest/gtest.h>
+#include <atomic>
 #include <iostream>
 #include <string>
 #include <torch/script.h>
 #include <torch/torch.h>
 #include <torch/csrc/deploy/interpreter/interpreter.h>
+#include <torch/csrc/deploy/interpreter/interpreter_manager.h>
 
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -47,3 +49,56 @@ TEST(Interpreter, SimpleModel) {
   compare_torchpy_jit(
       model_path, torch::ones(at::IntArrayRef({A, B})));
 }
+
+TEST(InterpreterManager, SharedWeights) {
+  char* model_path = std::getenv("SIMPLE_MODEL_PATH");
+  ASSERT_NE(model_path, nullptr);
+  InterpreterManager manager(3);
+  auto model_id = manager.load_model(model_path, false);
+
+  auto first = manager.interpreter(0).model_weights(manager.interpreter_model_id(model_id, 0));
+  ASSERT_FALSE(first.empty());
+  for (size_t i = 1; i < manager.size(); ++i) {
+    auto weights = manager.interpreter(i).model_weights(manager.interpreter_model_id(model_id, i));
+    ASSERT_EQ(weights.size(), first.size());
+    for (size_t w = 0; w < weights.size(); ++w) {
+      ASSERT_EQ(weights[w].first, first[w].first);
+      // zero-copy: the interpreters see the same storage
+      ASSERT_EQ(weights[w].second.data_ptr(), first[w].second.data_ptr());
+    }
+  }
+
+  auto input = torch::ones(at::IntArrayRef({10, 20}));
+  auto ref_model = torch::jit::load(model_path);
+  std::vector<torch::jit::IValue> ref_inputs{torch::jit::IValue(input)};
+  at::Tensor ref_output = ref_model.forward(ref_inputs).toTensor();
+  ASSERT_TRUE(ref_output.equal(manager.forward_model(model_id, input)));
+}
+
+TEST(InterpreterManager, Scheduling) {
+  char* model_path = std::getenv("SIMPLE_MODEL_PATH");
+  ASSERT_NE(model_path, nullptr);
+  InterpreterManager manager(2);
+  auto model_id = manager.load_model(model_path, false);
+  auto input = torch::ones(at::IntArrayRef({10, 20}));
+  auto expected = manager.forward_model(model_id, input);
+
+  std::vector<std::thread> threads;
+  std::atomic<int> failures(0);
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 10; ++i) {
+        if (!expected.equal(manager.forward_model(model_id, input))) {
+          ++failures;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(failures.load(), 0);
+  for (auto depth : manager.queue_depths()) {
+    ASSERT_EQ(depth, 0);
+  }
+}
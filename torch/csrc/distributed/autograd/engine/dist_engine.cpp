@@ -329,6 +329,8 @@ void DistEngine::execute_graph_task_until_ready_queue_empty(
 
   torch::autograd::set_device(torch::autograd::CPU_DEVICE);
   graph_task->owner_ = torch::autograd::CPU_DEVICE;
+  // See Note [Batching gradients per worker]
+  BatchedGradientsGuard batchedGradients;
   while (!cpu_ready_queue->empty()) {
     std::shared_ptr<GraphTask> local_graph_task;
     {
@@ -345,6 +347,12 @@ void DistEngine::execute_graph_task_until_ready_queue_empty(
           GraphTaskGuard guard(local_graph_task);
           engine_.evaluate_function(
               local_graph_task, task.fn_.get(), task.inputs_, cpu_ready_queue);
+          // Send the batched gradients before the last task is accounted
+          // for, so that the graph task can't complete before their RPCs
+          // are recorded in the autograd context.
+          if (cpu_ready_queue->empty()) {
+            batchedGradients.flush();
+          }
         } catch (std::exception& e) {
           engine_.thread_on_exception(local_graph_task, task.fn_, e);
           // break the loop in error so that we immediately stop the execution
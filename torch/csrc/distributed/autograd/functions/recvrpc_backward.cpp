@@ -1,5 +1,9 @@
 #include <torch/csrc/distributed/autograd/functions/recvrpc_backward.h>
+
+#include <algorithm>
+
 #include <ATen/core/functional.h>
+#include <c10/util/Logging.h>
 #include <torch/csrc/distributed/autograd/rpc_messages/propagate_gradients_req.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 
@@ -40,27 +44,105 @@ variable_list RecvRpcBackward::apply(variable_list&& grads) {
           "means the autograd context was cleaned up by a different thread due ",
           "to an error before RecvRcpBackward had a chance to run"));
 
-  // Send the gradients over the wire and record the future in the autograd
-  // context.
+  // Send the gradients over the wire, or leave them to the batch of the
+  // current thread. See Note [Batching gradients per worker].
+  if (auto guard = BatchedGradientsGuard::current()) {
+    guard->add(
+        sharedContext,
+        fromWorkerId_,
+        deviceMap_,
+        autogradMetadata_,
+        std::move(outputGrads));
+  } else {
+    sendGradients(
+        sharedContext,
+        fromWorkerId_,
+        deviceMap_,
+        {autogradMetadata_},
+        {std::move(outputGrads)});
+  }
+
+  // 'recv' function sends the gradients over the wire using RPC, it doesn't
+  // need to return anything for any downstream autograd function.
+  return variable_list();
+}
+
+void RecvRpcBackward::sendGradients(
+    const std::shared_ptr<DistAutogradContext>& autogradContext,
+    rpc::worker_id_t toWorkerId,
+    const std::unordered_map<c10::DeviceIndex, c10::DeviceIndex>& deviceMap,
+    std::vector<AutogradMetadata> autogradMetadata,
+    std::vector<variable_list> grads) {
   PropagateGradientsReq gradCall(
-      autogradMetadata_,
-      outputGrads,
-      sharedContext->retrieveGraphTask()->keep_graph_);
+      std::move(autogradMetadata),
+      std::move(grads),
+      autogradContext->retrieveGraphTask()->keep_graph_);
 
   // Send the gradients over to the appropriate node.
   auto rpcAgent = rpc::RpcAgent::getCurrentRpcAgent();
   auto jitFuture = rpcAgent->send(
-      rpcAgent->getWorkerInfo(fromWorkerId_),
+      rpcAgent->getWorkerInfo(toWorkerId),
       std::move(gradCall).toMessage(),
       rpc::kUnsetRpcTimeout,
-      deviceMap_);
+      deviceMap);
 
   // Record the future in the context.
-  sharedContext->addOutstandingRpc(jitFuture);
+  autogradContext->addOutstandingRpc(jitFuture);
+}
 
-  // 'recv' function sends the gradients over the wire using RPC, it doesn't
-  // need to return anything for any downstream autograd function.
-  return variable_list();
+namespace {
+
+thread_local BatchedGradientsGuard* currentBatchedGradientsGuard = nullptr;
+
+} // namespace
+
+BatchedGradientsGuard::BatchedGradientsGuard()
+    : prev_(currentBatchedGradientsGuard) {
+  currentBatchedGradientsGuard = this;
+}
+
+BatchedGradientsGuard::~BatchedGradientsGuard() {
+  currentBatchedGradientsGuard = prev_;
+  try {
+    flush();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to send batched gradients: " << e.what();
+  }
+}
+
+BatchedGradientsGuard* BatchedGradientsGuard::current() {
+  return currentBatchedGradientsGuard;
+}
+
+void BatchedGradientsGuard::add(
+    const std::shared_ptr<DistAutogradContext>& autogradContext,
+    rpc::worker_id_t toWorkerId,
+    const std::unordered_map<c10::DeviceIndex, c10::DeviceIndex>& deviceMap,
+    const AutogradMetadata& autogradMetadata,
+    variable_list grads) {
+  auto it = std::find_if(batches_.begin(), batches_.end(), [&](const Batch& b) {
+    return b.autogradContext == autogradContext &&
+        b.toWorkerId == toWorkerId && b.deviceMap == deviceMap;
+  });
+  if (it == batches_.end()) {
+    batches_.push_back({autogradContext, toWorkerId, deviceMap, {}, {}});
+    it = batches_.end() - 1;
+  }
+  it->autogradMetadata.push_back(autogradMetadata);
+  it->grads.push_back(std::move(grads));
+}
+
+void BatchedGradientsGuard::flush() {
+  auto batches = std::move(batches_);
+  batches_.clear();
+  for (auto& batch : batches) {
+    RecvRpcBackward::sendGradients(
+        batch.autogradContext,
+        batch.toWorkerId,
+        batch.deviceMap,
+        std::move(batch.autogradMetadata),
+        std::move(batch.grads));
+  }
 }
 
 } // namespace autograd
@@ -29,6 +29,17 @@ class TORCH_API RecvRpcBackward : public torch::autograd::Node {
       torch::autograd::variable_list&& grads) override;
 
  private:
+  friend class BatchedGradientsGuard;
+
+  // Sends the gradients of the given `send` functions to `toWorkerId` and
+  // records the future in the autograd context.
+  static void sendGradients(
+      const std::shared_ptr<DistAutogradContext>& autogradContext,
+      rpc::worker_id_t toWorkerId,
+      const std::unordered_map<c10::DeviceIndex, c10::DeviceIndex>& deviceMap,
+      std::vector<AutogradMetadata> autogradMetadata,
+      std::vector<torch::autograd::variable_list> grads);
+
   const AutogradMetadata autogradMetadata_;
 
   // Hold a weak reference to the autograd context to avoid circular
@@ -44,6 +55,54 @@ class TORCH_API RecvRpcBackward : public torch::autograd::Node {
   const std::unordered_map<c10::DeviceIndex, c10::DeviceIndex> deviceMap_;
 };
 
+// Note [Batching gradients per worker]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Every RecvRpcBackward sends its gradients back to the worker the RPC came
+// from. A model sharded over RPC has many of them per backward pass, and one
+// message per function means thousands of small messages. While a
+// BatchedGradientsGuard is alive on a thread, the RecvRpcBackward functions
+// that this thread runs only collect their gradients. flush() then sends all
+// of them in one PropagateGradientsReq per destination worker (and autograd
+// context). The distributed engine keeps a guard alive while it drains the
+// ready queue of a graph task, so gradients are still sent as soon as the
+// local part of the graph that produced them is done. RecvRpcBackward
+// functions run on other threads, e.g. device threads, send right away.
+class TORCH_API BatchedGradientsGuard {
+ public:
+  BatchedGradientsGuard();
+  ~BatchedGradientsGuard();
+
+  BatchedGradientsGuard(const BatchedGradientsGuard&) = delete;
+  BatchedGradientsGuard& operator=(const BatchedGradientsGuard&) = delete;
+
+  // Sends the gradients collected so far.
+  void flush();
+
+  // Returns the guard of the current thread, nullptr if there is none.
+  static BatchedGradientsGuard* current();
+
+ private:
+  friend class RecvRpcBackward;
+
+  struct Batch {
+    std::shared_ptr<DistAutogradContext> autogradContext;
+    rpc::worker_id_t toWorkerId;
+    std::unordered_map<c10::DeviceIndex, c10::DeviceIndex> deviceMap;
+    std::vector<AutogradMetadata> autogradMetadata;
+    std::vector<torch::autograd::variable_list> grads;
+  };
+
+  void add(
+      const std::shared_ptr<DistAutogradContext>& autogradContext,
+      rpc::worker_id_t toWorkerId,
+      const std::unordered_map<c10::DeviceIndex, c10::DeviceIndex>& deviceMap,
+      const AutogradMetadata& autogradMetadata,
+      torch::autograd::variable_list grads);
+
+  std::vector<Batch> batches_;
+  BatchedGradientsGuard* prev_;
+};
+
 } // namespace autograd
 } // namespace distributed
 } // namespace torch
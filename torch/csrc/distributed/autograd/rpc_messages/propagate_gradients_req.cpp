@@ -14,20 +14,39 @@ PropagateGradientsReq::PropagateGradientsReq(
     const AutogradMetadata& autogradMetadata,
     std::vector<Variable> grads,
     bool retainGraph)
-    : autogradMetadata_(autogradMetadata),
+    : retainGraph_(retainGraph) {
+  autogradMetadata_.push_back(autogradMetadata);
+  grads_.push_back(std::move(grads));
+}
+
+PropagateGradientsReq::PropagateGradientsReq(
+    std::vector<AutogradMetadata> autogradMetadata,
+    std::vector<std::vector<Variable>> grads,
+    bool retainGraph)
+    : autogradMetadata_(std::move(autogradMetadata)),
       grads_(std::move(grads)),
-      retainGraph_(retainGraph) {}
+      retainGraph_(retainGraph) {
+  TORCH_INTERNAL_ASSERT(
+      !autogradMetadata_.empty() && autogradMetadata_.size() == grads_.size());
+}
 
 Message PropagateGradientsReq::toMessageImpl() && {
   std::vector<at::IValue> ivalues;
-  // Add all the grad tensors.
-  for (const auto& grad : grads_) {
-    ivalues.emplace_back(grad);
+  // Add all the grad tensors, `send` function after `send` function.
+  for (const auto& grads : grads_) {
+    for (const auto& grad : grads) {
+      ivalues.emplace_back(grad);
+    }
   }
 
-  // Now add autograd metadata.
-  ivalues.emplace_back(autogradMetadata_.autogradContextId);
-  ivalues.emplace_back(autogradMetadata_.autogradMessageId);
+  // Now add the autograd metadata and the number of grads of every `send`
+  // function.
+  for (size_t i = 0; i < autogradMetadata_.size(); i++) {
+    ivalues.emplace_back(autogradMetadata_[i].autogradContextId);
+    ivalues.emplace_back(autogradMetadata_[i].autogradMessageId);
+    ivalues.emplace_back(static_cast<int64_t>(grads_[i].size()));
+  }
+  ivalues.emplace_back(static_cast<int64_t>(autogradMetadata_.size()));
 
   // Add retain graph.
   ivalues.emplace_back(retainGraph_);
@@ -53,41 +72,57 @@ std::unique_ptr<PropagateGradientsReq> PropagateGradientsReq::fromMessage(
       payload_size,
       *rpc::RpcAgent::getCurrentRpcAgent()->getTypeResolver(),
       &message.tensors());
-  std::vector<at::IValue> tupleElements = tuple.toTuple()->elements();
+  const std::vector<at::IValue>& tupleElements = tuple.toTuple()->elements();
 
   // Build PropagateGradientsReq.
-  TORCH_INTERNAL_ASSERT(tupleElements.size() >= 3);
+  TORCH_INTERNAL_ASSERT(tupleElements.size() >= 5);
 
   // Retrieve retainGraph.
   bool retainGraph = tupleElements.back().toBool();
-  tupleElements.pop_back();
-
-  // Build AutogradMetadata.
-  int64_t autogradContextId, autogradMessageId;
-  autogradMessageId = tupleElements.back().toInt();
-  tupleElements.pop_back();
-  autogradContextId = tupleElements.back().toInt();
-  tupleElements.pop_back();
-
-  AutogradMetadata autogradMetadata(autogradContextId, autogradMessageId);
 
-  // Retrieve the gradient tensors.
-  std::vector<Variable> grads(tupleElements.size());
-  for (size_t i = 0; i < tupleElements.size(); i++) {
-    grads[i] = tupleElements[i].toTensor();
+  // Build the AutogradMetadata of every `send` function.
+  const size_t numSendFunctions =
+      tupleElements[tupleElements.size() - 2].toInt();
+  TORCH_INTERNAL_ASSERT(tupleElements.size() >= 2 + 3 * numSendFunctions);
+  const size_t metadataStart = tupleElements.size() - 2 - 3 * numSendFunctions;
+
+  std::vector<AutogradMetadata> autogradMetadata;
+  std::vector<std::vector<Variable>> grads;
+  autogradMetadata.reserve(numSendFunctions);
+  grads.reserve(numSendFunctions);
+  size_t gradIndex = 0;
+  for (size_t i = 0; i < numSendFunctions; i++) {
+    const size_t pos = metadataStart + 3 * i;
+    autogradMetadata.emplace_back(
+        tupleElements[pos].toInt(), tupleElements[pos + 1].toInt());
+
+    // Retrieve the gradient tensors.
+    const size_t numGrads = tupleElements[pos + 2].toInt();
+    TORCH_INTERNAL_ASSERT(gradIndex + numGrads <= metadataStart);
+    std::vector<Variable> sendGrads(numGrads);
+    for (size_t j = 0; j < numGrads; j++) {
+      sendGrads[j] = tupleElements[gradIndex++].toTensor();
+    }
+    grads.push_back(std::move(sendGrads));
   }
+  TORCH_INTERNAL_ASSERT(gradIndex == metadataStart);
+
+  return std::unique_ptr<PropagateGradientsReq>(new PropagateGradientsReq(
+      std::move(autogradMetadata), std::move(grads), retainGraph));
+}
 
-  return std::unique_ptr<PropagateGradientsReq>(
-      new PropagateGradientsReq(autogradMetadata, grads, retainGraph));
+size_t PropagateGradientsReq::numSendFunctions() const {
+  return autogradMetadata_.size();
 }
 
-const AutogradMetadata& PropagateGradientsReq::getAutogradMetadata() {
-  return autogradMetadata_;
+const AutogradMetadata& PropagateGradientsReq::getAutogradMetadata(
+    size_t index) {
+  return autogradMetadata_.at(index);
 }
 
-const std::vector<torch::autograd::Variable>& PropagateGradientsReq::
-    getGrads() {
-  return grads_;
+const std::vector<torch::autograd::Variable>& PropagateGradientsReq::getGrads(
+    size_t index) {
+  return grads_.at(index);
 }
 
 bool PropagateGradientsReq::retainGraph() {
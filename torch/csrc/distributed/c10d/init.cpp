@@ -246,9 +246,17 @@ PyObject* c10d_init(PyObject* _unused, PyObject* noargs) {
           py::call_guard<py::gil_scoped_release>());
 
   py::enum_<::c10d::BuiltinCommHookType>(module, "BuiltinCommHookType", R"(
-An enum-like class for built-in communication hooks: ``ALLREDUCE`` and ``FP16_COMPRESS``.)")
+An enum-like class for built-in communication hooks: ``ALLREDUCE``, ``FP16_COMPRESS``,
+``BF16_COMPRESS``, ``FP16_COMPRESS_WITH_ERROR_FEEDBACK`` and ``BF16_COMPRESS_WITH_ERROR_FEEDBACK``.)")
       .value("ALLREDUCE", ::c10d::BuiltinCommHookType::ALLREDUCE)
-      .value("FP16_COMPRESS", ::c10d::BuiltinCommHookType::FP16_COMPRESS);
+      .value("FP16_COMPRESS", ::c10d::BuiltinCommHookType::FP16_COMPRESS)
+      .value("BF16_COMPRESS", ::c10d::BuiltinCommHookType::BF16_COMPRESS)
+      .value(
+          "FP16_COMPRESS_WITH_ERROR_FEEDBACK",
+          ::c10d::BuiltinCommHookType::FP16_COMPRESS_WITH_ERROR_FEEDBACK)
+      .value(
+          "BF16_COMPRESS_WITH_ERROR_FEEDBACK",
+          ::c10d::BuiltinCommHookType::BF16_COMPRESS_WITH_ERROR_FEEDBACK);
 
   shared_ptr_class_<::c10d::Reducer>(module, "Reducer")
       .def(
@@ -290,6 +298,11 @@ An enum-like class for built-in communication hooks: ``ALLREDUCE`` and ``FP16_CO
           "get_bucket_tensors",
           &::c10d::Reducer::get_bucket_tensors,
           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "_set_bucket_rebuild_period",
+          &::c10d::Reducer::set_bucket_rebuild_period,
+          py::arg("period"),
+          py::call_guard<py::gil_scoped_release>())
       .def(
           "_push_all_rebuilt_params",
           &::c10d::Reducer::push_rebuilt_params_for_all_indices,
@@ -586,6 +599,111 @@ Example::
     >>> store = dist.TCPStore("127.0.0.1", 0, 1, True, timedelta(seconds=30))
     >>> # This will throw an exception after 10 seconds
     >>> store.wait(["bad_key"], timedelta(seconds=10))
+)")
+          .def(
+              "compare_set",
+              [](::c10d::Store& store,
+                 const std::string& key,
+                 const std::string& expected_value,
+                 const std::string& desired_value) -> py::bytes {
+                std::vector<uint8_t> expectedValue(
+                    expected_value.begin(), expected_value.end());
+                std::vector<uint8_t> desiredValue(
+                    desired_value.begin(), desired_value.end());
+                auto value =
+                    store.compareSet(key, expectedValue, desiredValue);
+                return py::bytes(
+                    reinterpret_cast<char*>(value.data()), value.size());
+              },
+              py::call_guard<py::gil_scoped_release>(),
+              R"(
+Sets ``key`` to ``desired_value`` if its value is ``expected_value``, or if
+``key`` is not in the store and ``expected_value`` is empty, in one atomic
+operation.
+
+.. warning::
+    The ``compare_set`` API is only supported by the :class:`~torch.distributed.TCPStore` and :class:`~torch.distributed.HashStore`. Using this API
+    with the :class:`~torch.distributed.FileStore` will result in an exception.
+
+Arguments:
+    key (str): The key to be set in the store.
+    expected_value (str): The value ``key`` must have for it to be set.
+    desired_value (str): The value to set ``key`` to.
+
+Returns:
+    The value of ``key`` after the operation, or ``expected_value`` if ``key``
+    is not in the store and ``expected_value`` is not empty.
+
+Example::
+    >>> import torch.distributed as dist
+    >>> from datetime import timedelta
+    >>> store = dist.TCPStore("127.0.0.1", 0, 1, True, timedelta(seconds=30))
+    >>> store.set("key", "first_value")
+    >>> # Should return "second_value"
+    >>> store.compare_set("key", "first_value", "second_value")
+)")
+          .def(
+              "multi_get",
+              [](::c10d::Store& store, const std::vector<std::string>& keys) {
+                auto values = store.multiGet(keys);
+                py::gil_scoped_acquire guard;
+                std::vector<py::bytes> pyValues;
+                pyValues.reserve(values.size());
+                for (auto& value : values) {
+                  pyValues.emplace_back(
+                      reinterpret_cast<char*>(value.data()), value.size());
+                }
+                return pyValues;
+              },
+              py::call_guard<py::gil_scoped_release>(),
+              R"(
+Retrieves the values associated with the given ``keys`` in the store, waiting
+for all of them like :meth:`~torch.distributed.store.get`. The
+:class:`~torch.distributed.TCPStore` gets all of them in one request.
+
+Arguments:
+    keys (list): The keys whose values to return.
+
+Returns:
+    The list of the values associated with ``keys``.
+
+Example::
+    >>> import torch.distributed as dist
+    >>> from datetime import timedelta
+    >>> store = dist.TCPStore("127.0.0.1", 0, 1, True, timedelta(seconds=30))
+    >>> store.multi_set(["first_key", "second_key"], ["po", "tato"])
+    >>> # Should return [b"po", b"tato"]
+    >>> store.multi_get(["first_key", "second_key"])
+)")
+          .def(
+              "multi_set",
+              [](::c10d::Store& store,
+                 const std::vector<std::string>& keys,
+                 const std::vector<std::string>& values) {
+                std::vector<std::vector<uint8_t>> values_;
+                values_.reserve(values.size());
+                for (const auto& value : values) {
+                  values_.emplace_back(value.begin(), value.end());
+                }
+                store.multiSet(keys, values_);
+              },
+              py::call_guard<py::gil_scoped_release>(),
+              R"(
+Inserts the key-value pairs of ``keys`` and ``values`` into the store, like
+:meth:`~torch.distributed.store.set` does for one of them. The
+:class:`~torch.distributed.TCPStore` sets all of them in one request.
+
+Arguments:
+    keys (list): The keys to be added to the store.
+    values (list): The values associated with ``keys``.
+
+Example::
+    >>> import torch.distributed as dist
+    >>> from datetime import timedelta
+    >>> store = dist.TCPStore("127.0.0.1", 0, 1, True, timedelta(seconds=30))
+    >>> store.multi_set(["first_key", "second_key"], ["po", "tato"])
+    >>> # Should return "tato"
+    >>> store.get("second_key")
 )");
 
   intrusive_ptr_class_<::c10d::FileStore>(
@@ -954,16 +1072,22 @@ Arguments:
 #ifndef _WIN32
   module.def(
       "_round_robin_process_groups",
-      [](std::vector<c10::intrusive_ptr<::c10d::ProcessGroup>> processGroups)
+      [](std::vector<c10::intrusive_ptr<::c10d::ProcessGroup>> processGroups,
+         int64_t splitThresholdBytes)
           -> c10::intrusive_ptr<::c10d::ProcessGroup> {
         if (processGroups.size() == 0) {
           throw std::invalid_argument("Specify at least 1 process group");
         }
         const auto& first = processGroups.front();
         return c10::make_intrusive<::c10d::ProcessGroupRoundRobin>(
-            first->getRank(), first->getSize(), std::move(processGroups));
+            first->getRank(),
+            first->getSize(),
+            std::move(processGroups),
+            splitThresholdBytes);
       },
       py::arg("process_groups"),
+      py::arg("split_threshold_bytes") =
+          ::c10d::ProcessGroupRoundRobin::kDefaultSplitThresholdBytes,
       py::call_guard<py::gil_scoped_release>());
 #endif
 
@@ -978,7 +1102,10 @@ Arguments:
       .def(py::init<>())
       .def_readwrite("devices", &::c10d::ProcessGroupGloo::Options::devices)
       .def_readwrite("timeout", &::c10d::ProcessGroupGloo::Options::timeout)
-      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads);
+      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads)
+      .def_readwrite(
+          "allreduce_chunk_bytes",
+          &::c10d::ProcessGroupGloo::Options::allreduceChunkBytes);
 
   processGroupGloo.def_static(
       "create_device",
@@ -1074,11 +1201,23 @@ Arguments:
           "is_high_priority",
           &::c10d::ProcessGroupNCCL::Options::isHighPriorityStream)
       .def_readwrite(
-          "op_timeout", &::c10d::ProcessGroupNCCL::Options::opTimeout);
+          "op_timeout", &::c10d::ProcessGroupNCCL::Options::opTimeout)
+      .def_readwrite(
+          "local_size", &::c10d::ProcessGroupNCCL::Options::localSize);
   processGroupNCCL.def_static(
       "_group_start", []() { ::c10d::ProcessGroupNCCL::groupStart(); });
   processGroupNCCL.def_static(
       "_group_end", []() { ::c10d::ProcessGroupNCCL::groupEnd(); });
+  processGroupNCCL.def(
+      "_get_alltoall_bytes",
+      [](::c10d::ProcessGroupNCCL& self) {
+        return std::make_pair(
+            self.getAlltoallBytesSent(), self.getAlltoallBytesReceived());
+      },
+      R"(
+        Returns the lists of the bytes sent to and received from every rank
+        by the ``all_to_all`` calls of this process group so far.
+      )");
 #endif
 
 #ifdef USE_C10D_MPI
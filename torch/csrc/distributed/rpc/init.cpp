@@ -722,6 +722,13 @@ PyObject* rpc_init(PyObject* _unused, PyObject* noargs) {
     RRefContext::getInstance().destroyInstance(ignoreRRefLeak).clear();
   });
 
+  module.def(
+      "_to_here_batch",
+      &PyRRef::toHereBatch,
+      py::arg("rrefs"),
+      py::arg("timeout") = py::cast(kUnsetRpcTimeout),
+      py::call_guard<py::gil_scoped_release>());
+
   module.def("_rref_context_get_debug_info", []() {
     return RRefContext::getInstance().getDebugInfo();
   });
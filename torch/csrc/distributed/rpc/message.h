@@ -85,6 +85,14 @@ enum MessageType {
   RREF_BACKWARD_REQ = 23 | MessageTypeFlags::REQUEST_TYPE,
   RREF_BACKWARD_RESP = 24 | MessageTypeFlags::RESPONSE_TYPE,
 
+  // Messages to fetch the values of several RRefs from their owner at once.
+  RREF_FETCH_BATCH_CALL = 25 | MessageTypeFlags::REQUEST_TYPE,
+  RREF_FETCH_BATCH_RET = 26 | MessageTypeFlags::RESPONSE_TYPE,
+
+  // Fork requests, child accepts and user deletes to the same worker that are
+  // sent together, see Note [Batched RRef control messages].
+  RREF_CONTROL_BATCH = 27 | MessageTypeFlags::REQUEST_TYPE,
+
   // Other internal message types
   EXCEPTION = 55 | MessageTypeFlags::RESPONSE_TYPE,
   UNKNOWN = 60
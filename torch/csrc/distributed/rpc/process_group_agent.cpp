@@ -57,6 +57,22 @@ const std::string kClientActiveCalls = "agent.client_active_calls";
 const std::string kServerActiveCalls = "agent.server_active_calls";
 const std::string kServerActiveAsyncCalls = "agent.server_active_async_calls";
 
+// Note [Wire format of ProcessGroupAgent]
+// A message goes to another worker as:
+//  - a preamble of kPreambleItems int64s: the rank of the sender, the size of
+//    the string of wireSerializeNoCopy(), the type and the id of the message,
+//    followed by the string itself in the remaining kMaxInlineSize bytes if
+//    it fits there, which saves a send per small message;
+//  - the string, if it did not fit in the preamble;
+//  - the non-empty tensor sections, one send each, from the storages of the
+//    tensors, so that the data of the tensors is never copied on the sending
+//    side; the receiver allocates them from wireTensorSectionSizes() and
+//    deserializes the tensors in place.
+constexpr int64_t kPreambleHeaderItems = 4;
+constexpr int64_t kMaxInlineSize = 512;
+constexpr int64_t kPreambleItems =
+    kPreambleHeaderItems + kMaxInlineSize / sizeof(int64_t);
+
 void ProcessGroupAgent::collectNames() {
   const std::string& workerName = workerInfo_.name_;
   const auto worldSize = pg_->getSize();
@@ -388,38 +404,61 @@ std::shared_ptr<JitFuture> ProcessGroupAgent::send(
 }
 
 void ProcessGroupAgent::handleSend(const SendWork& work) {
-  auto serializedPayload = std::make_unique<std::string>(std::move(
-      wireSerialize(work.message_.payload(), work.message_.tensors())));
-
-  std::vector<torch::Tensor> preamble = {torch::tensor(
-      {(int64_t)pg_->getRank(),
-       (int64_t)serializedPayload->length(),
-       (int64_t)work.message_.type(),
-       (int64_t)work.message_.id()},
-      {torch::kInt64})};
+  // See Note [Wire format of ProcessGroupAgent]
+  auto serialized =
+      wireSerializeNoCopy(work.message_.payload(), work.message_.tensors());
+  auto serializedPayload =
+      std::make_unique<std::string>(std::move(serialized.first));
+  const auto& tensorSections = serialized.second;
+  const bool inlined =
+      static_cast<int64_t>(serializedPayload->size()) <= kMaxInlineSize;
+
+  std::vector<torch::Tensor> preamble = {
+      torch::zeros({kPreambleItems}, {torch::kInt64})};
+  int64_t* preambleItems = preamble.front().data_ptr<int64_t>();
+  preambleItems[0] = pg_->getRank();
+  preambleItems[1] = serializedPayload->length();
+  preambleItems[2] = work.message_.type();
+  preambleItems[3] = work.message_.id();
+  if (inlined) {
+    memcpy(
+        preambleItems + kPreambleHeaderItems,
+        serializedPayload->data(),
+        serializedPayload->size());
+  }
 
   // ProcessGroup is not thread-safe when sending with the same tag,
   // hence the lock
   std::vector<c10::intrusive_ptr<c10d::ProcessGroup::Work>> pendingSends;
   const auto dst = work.to_.id_;
 
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
-  auto serializedPayloadData = const_cast<char*>(serializedPayload->data());
-  auto serializedPayloadSize = serializedPayload->size();
-  std::string* deleteWhenDone = serializedPayload.release();
-  std::vector<torch::Tensor> payload = {torch::from_blob(
-      reinterpret_cast<void*>(serializedPayloadData),
-      serializedPayloadSize,
-      [deleteWhenDone](void*) { delete deleteWhenDone; },
-      {torch::kChar})};
-  pendingSends.reserve(2);
+  std::vector<std::vector<torch::Tensor>> sends = {std::move(preamble)};
+  sends.reserve(2 + tensorSections.size());
+  if (!inlined) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    auto serializedPayloadData = const_cast<char*>(serializedPayload->data());
+    auto serializedPayloadSize = serializedPayload->size();
+    std::string* deleteWhenDone = serializedPayload.release();
+    sends.push_back({torch::from_blob(
+        reinterpret_cast<void*>(serializedPayloadData),
+        serializedPayloadSize,
+        [deleteWhenDone](void*) { delete deleteWhenDone; },
+        {torch::kChar})});
+  }
+  for (const auto& section : tensorSections) {
+    if (section.numel() > 0) {
+      sends.push_back({section});
+    }
+  }
+  pendingSends.reserve(sends.size());
 
   sendCounts_.increment(dst);
 
   {
     std::lock_guard<std::mutex> guard(sendMutexes_[dst]);
-    pendingSends.emplace_back(pg_->send(preamble, dst, dst /* channelTag */));
-    pendingSends.emplace_back(pg_->send(payload, dst, dst /* channelTag */));
+    for (auto& tensors : sends) {
+      pendingSends.emplace_back(pg_->send(tensors, dst, dst /* channelTag */));
+    }
   }
   // Write pendingSends to a global map so that they can be interrupted by
   // ::shutdown().
@@ -456,9 +495,16 @@ void ProcessGroupAgent::sendToSelf(Message&& message) {
         // data outlives the scope of this function. It's shared_ptr<> due
         // to c++11 lambda capture limitations with unique_ptr<>.
         std::unique_ptr<std::string> payload;
+        std::vector<torch::Tensor> tensorSections;
         try {
-          payload = std::make_unique<std::string>(
-              wireSerialize(message.payload(), message.tensors()));
+          // The tensor sections share the storages of the tensors of the
+          // sender, so they are copied, once, for the receiver.
+          auto serialized =
+              wireSerializeNoCopy(message.payload(), message.tensors());
+          payload = std::make_unique<std::string>(std::move(serialized.first));
+          for (const auto& section : serialized.second) {
+            tensorSections.push_back(section.clone());
+          }
           // only increment sendCounts when the message is indeed added into
           // local recv.
           sendCounts_.increment(pg_->getRank());
@@ -477,7 +523,8 @@ void ProcessGroupAgent::sendToSelf(Message&& message) {
                 (void*)data,
                 len,
                 [delete_when_done](void*) { delete delete_when_done; },
-                {torch::kChar})));
+                {torch::kChar}),
+            std::move(tensorSections)));
       },
       std::move(message)));
 }
@@ -510,7 +557,8 @@ void ProcessGroupAgent::enqueueSend(SendWork work) {
 
 bool ProcessGroupAgent::handleRecv(RecvWork& work) {
   torch::Tensor& payload = work.payload_;
-  auto data = wireDeserialize(payload.storage().data(), payload.numel());
+  auto data = wireDeserializeNoCopy(
+      payload.storage().data(), payload.numel(), work.tensorSections_);
   Message message(
       std::move(data.first), std::move(data.second), work.type_, work.id_);
   if (message.isRequest()) {
@@ -718,8 +766,10 @@ void ProcessGroupAgent::listenLoop() {
 
 void ProcessGroupAgent::listenLoopInternal() {
   while (rpcAgentRunning_.load()) {
-    // rank, tensor size, message type
-    std::vector<torch::Tensor> preamble = {torch::empty({4}, {torch::kInt64})};
+    // rank, tensor size, message type, message id and maybe the payload, see
+    // Note [Wire format of ProcessGroupAgent]
+    std::vector<torch::Tensor> preamble = {
+        torch::empty({kPreambleItems}, {torch::kInt64})};
     auto work = pg_->recvAnysource(preamble, pg_->getRank());
     {
       // Write class variable so it can be aborted by shutdown()
@@ -738,20 +788,44 @@ void ProcessGroupAgent::listenLoopInternal() {
     MessageType type = MessageType(preamble_items[2]);
     int64_t id = preamble_items[3];
 
+    // Receives into tensors, returns false if aborted by shutdown().
+    auto recv = [&](std::vector<torch::Tensor>& tensors) {
+      auto recvWork = pg_->recv(tensors, srcRank, pg_->getRank());
+      {
+        // Write class variable so it can be aborted by shutdown()
+        std::lock_guard<std::mutex> guard(recvWorkMutex_);
+        recvWork_ = recvWork;
+      }
+      return rpcAgentRunning_.load() && recvWork->wait();
+    };
+
     std::vector<torch::Tensor> tensors = {torch::empty({size}, {torch::kChar})};
-    work = pg_->recv(tensors, srcRank, pg_->getRank());
-    {
-      // Write class variable so it can be aborted by shutdown()
-      std::lock_guard<std::mutex> guard(recvWorkMutex_);
-      recvWork_ = work;
+    if (size <= kMaxInlineSize) {
+      memcpy(
+          tensors[0].data_ptr(),
+          preamble_items + kPreambleHeaderItems,
+          size);
+    } else if (!recv(tensors)) {
+      return;
     }
 
-    if (!rpcAgentRunning_.load() || !work->wait() /* aborted */) {
-      return;
+    std::vector<torch::Tensor> tensorSections;
+    for (auto sectionSize :
+         wireTensorSectionSizes(tensors[0].data_ptr(), size)) {
+      std::vector<torch::Tensor> section = {
+          torch::empty({static_cast<int64_t>(sectionSize)}, {torch::kChar})};
+      if (sectionSize > 0 && !recv(section)) {
+        return;
+      }
+      tensorSections.push_back(std::move(section[0]));
     }
 
-    enqueueRecv(
-        RecvWork(allWorkerInfo_[srcRank], type, id, std::move(tensors[0])));
+    enqueueRecv(RecvWork(
+        allWorkerInfo_[srcRank],
+        type,
+        id,
+        std::move(tensors[0]),
+        std::move(tensorSections)));
   }
 }
 
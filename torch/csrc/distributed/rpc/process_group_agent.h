@@ -41,20 +41,27 @@ struct SendWork {
   Message message_;
 };
 
-// SendWork wraps a Message and RecvWork wraps a Tensor. The difference here is
+// SendWork wraps a Message and RecvWork wraps Tensors. The difference here is
 // to allow us to run serialization/deserialization in the worker threads.
 struct RecvWork {
   RecvWork(
       const WorkerInfo& from,
       MessageType type,
       int64_t id,
-      torch::Tensor&& payload)
-      : from_(from), type_(type), id_(id), payload_(payload) {}
+      torch::Tensor&& payload,
+      std::vector<torch::Tensor>&& tensorSections)
+      : from_(from),
+        type_(type),
+        id_(id),
+        payload_(payload),
+        tensorSections_(tensorSections) {}
 
   const WorkerInfo& from_;
   const MessageType type_;
   const int64_t id_;
+  // The string of wireSerializeNoCopy() and its tensor sections.
   torch::Tensor payload_;
+  std::vector<torch::Tensor> tensorSections_;
 };
 
 class TORCH_API ProcessGroupAgent : public RpcAgent {
@@ -191,6 +191,49 @@ py::object PyRRef::toHere(const float timeoutSeconds) const {
   }
 }
 
+py::list PyRRef::toHereBatch(
+    const std::vector<PyRRef>& rrefs,
+    const float timeoutSeconds) {
+  std::vector<c10::intrusive_ptr<UserRRef>> userRRefs;
+  for (const auto& rref : rrefs) {
+    if (!rref.rref_->isOwner()) {
+      userRRefs.push_back(
+          c10::static_intrusive_pointer_cast<UserRRef>(rref.rref_));
+    }
+  }
+  auto userValues = UserRRef::toHereBatch(userRRefs, timeoutSeconds);
+
+  auto& pythonRpcHandler = PythonRpcHandler::getInstance();
+  std::vector<py::object> values;
+  values.reserve(rrefs.size());
+  size_t userIndex = 0;
+  for (const auto& rref : rrefs) {
+    if (rref.rref_->isOwner()) {
+      values.push_back(rref.localValue());
+    } else if (rref.rref_->isPyObj()) {
+      // python_rpc_handler deserialization will acquires GIL.
+      auto rfr_values = userValues[userIndex++].toTuple()->elements();
+      auto ret = pythonRpcHandler.deserialize(
+          SerializedPyObj::fromIValues(rfr_values));
+      pythonRpcHandler.handleException(ret);
+      values.push_back(std::move(ret));
+    } else {
+      pybind11::gil_scoped_acquire ag;
+      values.push_back(
+          torch::jit::toPyObject(std::move(userValues[userIndex++])));
+    }
+  }
+
+  pybind11::gil_scoped_acquire ag;
+  py::list list;
+  for (auto& value : values) {
+    list.append(std::move(value));
+  }
+  // The values must be released with the GIL held.
+  values.clear();
+  return list;
+}
+
 py::object PyRRef::localValue() const {
   TORCH_CHECK(
       rref_->isOwner(),
@@ -28,6 +28,11 @@ class PYBIND11_EXPORT PyRRef {
       const float timeoutSeconds =
           torch::distributed::rpc::kUnsetRpcTimeout) const;
   py::object localValue() const;
+  // Returns the values of rrefs like toHere, fetching the values of the
+  // UserRRefs with a single RPC to each of their owners.
+  static py::list toHereBatch(
+      const std::vector<PyRRef>& rrefs,
+      const float timeoutSeconds = torch::distributed::rpc::kUnsetRpcTimeout);
   std::string str() const;
   py::tuple pickle() const;
   static PyRRef unpickle(const py::tuple& t);
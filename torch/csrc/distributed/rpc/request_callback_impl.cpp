@@ -482,6 +482,28 @@ void RequestCallbackImpl::processPythonRRefFetchCall(
   });
 }
 
+IValue RequestCallbackImpl::rrefFetchValue(
+    const c10::intrusive_ptr<OwnerRRef>& rref) const {
+  if (!rref->isPyObj()) {
+    return rref->getValue();
+  }
+  auto& pythonRpcHandler = PythonRpcHandler::getInstance();
+  try {
+    // Need this GIL to guard jit::toPyObj and destruct its returned py::object
+    py::gil_scoped_acquire acquire;
+    return c10::ivalue::Tuple::create(
+        pythonRpcHandler.serialize(jit::toPyObject(rref->getValue()))
+            .toIValues());
+  } catch (py::error_already_set& e) {
+    // py::error_already_set requires GIL to destruct, take special care.
+    std::runtime_error error(e.what());
+    py::gil_scoped_acquire acquire;
+    e.restore();
+    PyErr_Clear();
+    throw error;
+  }
+}
+
 void RequestCallbackImpl::handleRRefDelete(
     c10::intrusive_ptr<RRef>& rref) const {
   if (rref && rref->isPyObj()) {
@@ -46,6 +46,9 @@ class TORCH_API RequestCallbackImpl : public RequestCallbackNoPython {
       const int64_t messageId,
       const std::shared_ptr<JitFuture>& responseFuture) const override;
 
+  IValue rrefFetchValue(
+      const c10::intrusive_ptr<OwnerRRef>& rref) const override;
+
   void handleRRefDelete(c10::intrusive_ptr<RRef>& rref) const override;
 
   void processRpcWithErrors(
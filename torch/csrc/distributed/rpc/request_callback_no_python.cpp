@@ -306,6 +306,80 @@ void RequestCallbackNoPython::processPythonRRefFetchCall(
   C10_THROW_ERROR(Error, "Python call not supported!");
 }
 
+void RequestCallbackNoPython::processRRefFetchBatchCall(
+    RpcCommandBase& rpc,
+    const int64_t messageId,
+    const std::shared_ptr<JitFuture>& responseFuture) const {
+  auto& rfb = static_cast<RRefFetchBatchCall&>(rpc);
+  auto& ctx = RRefContext::getInstance();
+  const auto& rrefIds = rfb.rrefIds();
+
+  // The response is sent once the values of all of the RRefs are set, or
+  // with the first error.
+  struct FetchState {
+    explicit FetchState(size_t size) : values(size), remaining(size) {}
+    std::vector<IValue> values;
+    std::atomic<size_t> remaining;
+    std::atomic<bool> failed{false};
+  };
+  auto state = std::make_shared<FetchState>(rrefIds.size());
+  if (rrefIds.empty()) {
+    Message m = RRefFetchBatchRet({}).toMessage();
+    m.setId(messageId);
+    responseFuture->markCompleted(
+        IValue(c10::make_intrusive<Message>(std::move(m))));
+    return;
+  }
+  for (size_t i = 0; i < rrefIds.size(); ++i) {
+    auto futureOwner = ctx.getOwnerRRef(rrefIds[i]);
+    futureOwner->addCallback(
+        [this, i, state, responseFuture, messageId, futureOwner]() {
+          const auto& rref = futureOwner->constValue();
+          auto whenValueSet = rref->getFuture();
+          whenValueSet->addCallback([this,
+                                     i,
+                                     state,
+                                     responseFuture,
+                                     messageId,
+                                     rref,
+                                     whenValueSet]() {
+            if (whenValueSet->hasError()) {
+              if (!state->failed.exchange(true)) {
+                responseFuture->setError(whenValueSet->exception_ptr());
+              }
+              return;
+            }
+            try {
+              state->values[i] = rrefFetchValue(rref);
+            } catch (const std::exception& /* unused */) {
+              if (!state->failed.exchange(true)) {
+                responseFuture->setError(std::current_exception());
+              }
+              return;
+            }
+            if (--state->remaining > 0 || state->failed) {
+              return;
+            }
+            try {
+              Message m =
+                  RRefFetchBatchRet(std::move(state->values)).toMessage();
+              m.setId(messageId);
+              responseFuture->markCompleted(
+                  IValue(c10::make_intrusive<Message>(std::move(m))));
+            } catch (const std::exception& /* unused */) {
+              responseFuture->setError(std::current_exception());
+            }
+          });
+        });
+  }
+}
+
+IValue RequestCallbackNoPython::rrefFetchValue(
+    const c10::intrusive_ptr<OwnerRRef>& rref) const {
+  TORCH_CHECK(!rref->isPyObj(), "RRefs with python objects not supported!");
+  return rref->getValue();
+}
+
 void RequestCallbackNoPython::processRRefUserDelete(
     RpcCommandBase& rpc,
     const std::function<void(Message)>& markComplete) const {
@@ -318,7 +392,8 @@ void RequestCallbackNoPython::processRRefUserDelete(
 
 void RequestCallbackNoPython::handleRRefDelete(
     c10::intrusive_ptr<RRef>& rref) const {
-  TORCH_CHECK(!rref->isPyObj(), "RRefs with python objects not supported!");
+  TORCH_CHECK(
+      !rref || !rref->isPyObj(), "RRefs with python objects not supported!");
 }
 
 void RequestCallbackNoPython::processRRefChildAccept(
@@ -339,6 +414,24 @@ void RequestCallbackNoPython::processRRefForkRequest(
   markComplete(RRefAck().toMessage());
 }
 
+void RequestCallbackNoPython::processRRefControlBatch(
+    RpcCommandBase& rpc,
+    const std::function<void(Message)>& markComplete) const {
+  auto& rcb = static_cast<RRefControlBatch&>(rpc);
+  auto& ctx = RRefContext::getInstance();
+  for (const auto& fork : rcb.forkRequests()) {
+    ctx.addForkOfOwnerIfNotPresent(fork.first, fork.second);
+  }
+  for (const auto& forkId : rcb.childAccepts()) {
+    ctx.delPendingChild(forkId);
+  }
+  for (const auto& fork : rcb.userDeletes()) {
+    auto deletedRRef = ctx.delForkOfOwner(fork.first, fork.second);
+    handleRRefDelete(deletedRRef);
+  }
+  markComplete(RRefAck().toMessage());
+}
+
 void RequestCallbackNoPython::processForwardAutogradReq(
     RpcCommandBase& rpc,
     const int64_t messageId,
@@ -427,34 +520,64 @@ void RequestCallbackNoPython::processBackwardAutogradReq(
     const int64_t messageId,
     const std::shared_ptr<JitFuture>& responseFuture) const {
   auto& gradientsCall = static_cast<PropagateGradientsReq&>(rpc);
-  const auto& autogradMetadata = gradientsCall.getAutogradMetadata();
-
-  // Retrieve the appropriate autograd context.
-  auto autogradContext = DistAutogradContainer::getInstance().retrieveContext(
-      autogradMetadata.autogradContextId);
-
-  // Lookup the appropriate 'send' function to enqueue.
-  std::shared_ptr<SendRpcBackward> sendFunction =
-      autogradContext->retrieveSendFunction(autogradMetadata.autogradMessageId);
-
-  // Attach the gradients to the send function.
-  sendFunction->setGrads(gradientsCall.getGrads());
-
-  // Now execute the autograd graph using the "distributed engine."
-  auto execFuture = DistEngine::getInstance().executeSendFunctionAsync(
-      autogradContext, sendFunction, gradientsCall.retainGraph());
-
-  // Our response is satisfied when the rpcs come back.
-  execFuture->addCallback([responseFuture, messageId, execFuture]() {
-    if (!execFuture->hasError()) {
-      Message m = std::move(PropagateGradientsResp()).toMessage();
-      m.setId(messageId);
-      responseFuture->markCompleted(
-          IValue(c10::make_intrusive<Message>(std::move(m))));
-    } else {
-      responseFuture->setError(execFuture->exception_ptr());
-    }
-  });
+  const auto numSendFunctions = gradientsCall.numSendFunctions();
+
+  // The request may carry the gradients of several 'send' functions, see
+  // Note [Batching gradients per worker]. Our response is satisfied when the
+  // execution started from every one of them is done.
+  struct PendingExecutions {
+    std::mutex mutex;
+    size_t remaining;
+    std::exception_ptr eptr;
+  };
+  auto pending = std::make_shared<PendingExecutions>();
+  pending->remaining = numSendFunctions;
+
+  std::vector<std::shared_ptr<JitFuture>> execFutures;
+  execFutures.reserve(numSendFunctions);
+  for (size_t i = 0; i < numSendFunctions; i++) {
+    const auto& autogradMetadata = gradientsCall.getAutogradMetadata(i);
+
+    // Retrieve the appropriate autograd context.
+    auto autogradContext = DistAutogradContainer::getInstance().retrieveContext(
+        autogradMetadata.autogradContextId);
+
+    // Lookup the appropriate 'send' function to enqueue.
+    std::shared_ptr<SendRpcBackward> sendFunction =
+        autogradContext->retrieveSendFunction(
+            autogradMetadata.autogradMessageId);
+
+    // Attach the gradients to the send function.
+    sendFunction->setGrads(gradientsCall.getGrads(i));
+
+    // Now execute the autograd graph using the "distributed engine."
+    execFutures.push_back(DistEngine::getInstance().executeSendFunctionAsync(
+        autogradContext, sendFunction, gradientsCall.retainGraph()));
+  }
+
+  for (const auto& execFuture : execFutures) {
+    execFuture->addCallback([responseFuture, messageId, execFuture, pending]() {
+      std::exception_ptr eptr;
+      {
+        std::lock_guard<std::mutex> lock(pending->mutex);
+        if (execFuture->hasError() && !pending->eptr) {
+          pending->eptr = execFuture->exception_ptr();
+        }
+        if (--pending->remaining > 0) {
+          return;
+        }
+        eptr = pending->eptr;
+      }
+      if (!eptr) {
+        Message m = std::move(PropagateGradientsResp()).toMessage();
+        m.setId(messageId);
+        responseFuture->markCompleted(
+            IValue(c10::make_intrusive<Message>(std::move(m))));
+      } else {
+        responseFuture->setError(eptr);
+      }
+    });
+  }
 }
 
 void RequestCallbackNoPython::processCleanupAutogradContextReq(
@@ -619,6 +742,14 @@ void RequestCallbackNoPython::processRpc(
       processRRefForkRequest(rpc, markComplete);
       return;
     }
+    case MessageType::RREF_FETCH_BATCH_CALL: {
+      processRRefFetchBatchCall(rpc, messageId, responseFuture);
+      return;
+    }
+    case MessageType::RREF_CONTROL_BATCH: {
+      processRRefControlBatch(rpc, markComplete);
+      return;
+    }
     case MessageType::FORWARD_AUTOGRAD_REQ: {
       processForwardAutogradReq(rpc, messageId, responseFuture);
       return;
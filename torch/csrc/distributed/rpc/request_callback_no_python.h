@@ -76,6 +76,14 @@ class TORCH_API RequestCallbackNoPython : public RequestCallback {
       const int64_t messageId,
       const std::shared_ptr<JitFuture>& responseFuture) const;
 
+  void processRRefFetchBatchCall(
+      RpcCommandBase& rpc,
+      const int64_t messageId,
+      const std::shared_ptr<JitFuture>& responseFuture) const;
+
+  // The value of rref in an RRefFetchBatchRet.
+  virtual IValue rrefFetchValue(const c10::intrusive_ptr<OwnerRRef>& rref) const;
+
   void processRRefUserDelete(
       RpcCommandBase& rpc,
       const std::function<void(Message)>& markComplete) const;
@@ -88,6 +96,10 @@ class TORCH_API RequestCallbackNoPython : public RequestCallback {
       RpcCommandBase& rpc,
       const std::function<void(Message)>& markComplete) const;
 
+  void processRRefControlBatch(
+      RpcCommandBase& rpc,
+      const std::function<void(Message)>& markComplete) const;
+
   void processForwardAutogradReq(
       RpcCommandBase& rpc,
       const int64_t messageId,
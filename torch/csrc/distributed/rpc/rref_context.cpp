@@ -211,16 +211,8 @@ void RRefContext::delUser(
       // Sending an RRefUserDelete causes the receiver to run delForkOfOwner,
       // which is now idempotent. See the comment at RRefContext::delForkOfOwner
       // for more details.
-      ++numPendingFutures_;
-      auto jitFuture = agent_->sendWithRetries(
-          agent_->getWorkerInfo(owner),
-          RRefUserDelete(rrefId, forkId).toMessage());
-
-      std::weak_ptr<JitFuture> wp = jitFuture;
-      jitFuture->addCallback([this, wp]() {
-        handleException(*wp.lock());
-        --numPendingFutures_;
-      });
+      sendControlMessage(
+          owner, {MessageType::RREF_USER_DELETE, rrefId, forkId, nullptr});
     }
   }
 
@@ -486,30 +478,17 @@ void RRefContext::notifyOwnerAndParentOfFork(
     // In this case, the owner is the caller, and it does not add the fork id
     // into forks_. Because, there will be no real `UserRRef` associated
     // with this fork ID.
-    ++numPendingFutures_;
-    auto jitFuture = agent_->sendWithRetries(
-        agent_->getWorkerInfo(parent), RRefChildAccept(forkId).toMessage());
-    std::weak_ptr<JitFuture> wp = jitFuture;
-    jitFuture->addCallback([this, wp]() {
-      handleException(*wp.lock());
-      --numPendingFutures_;
-    });
+    sendControlMessage(
+        parent, {MessageType::RREF_CHILD_ACCEPT, forkId, forkId, nullptr});
   } else {
-    ++numPendingFutures_;
-    auto jitFuture = agent_->sendWithRetries(
-        agent_->getWorkerInfo(rref->owner()),
-        RRefForkRequest(rref->rrefId(), forkId).toMessage());
-
+    // The pending user must be added before the fork request is acked.
     addPendingUser(forkId, rref);
-
-    std::weak_ptr<JitFuture> wp = jitFuture;
-    jitFuture->addCallback([this, forkId, parent, wp]() {
-      handleException(*wp.lock());
-      this->finishForkRequest(forkId, parent);
-      // Decrease after calling finishForkRequest because, as that creates a new
-      // future, it might otherwise cause the count to briefly go to zero.
-      --numPendingFutures_;
-    });
+    sendControlMessage(
+        rref->owner(),
+        {MessageType::RREF_FORK_REQUEST,
+         rref->rrefId(),
+         forkId,
+         [this, forkId, parent]() { finishForkRequest(forkId, parent); }});
   }
 }
 
@@ -682,14 +661,100 @@ void RRefContext::clearRecordedPendingRRefsOnError() {
 
 void RRefContext::finishForkRequest(const ForkId& forkId, worker_id_t parent) {
   delPendingUser(forkId);
+  sendControlMessage(
+      parent, {MessageType::RREF_CHILD_ACCEPT, forkId, forkId, nullptr});
+}
+
+void RRefContext::sendControlMessage(
+    worker_id_t dst,
+    ControlMessage message) {
   ++numPendingFutures_;
-  auto jitFuture = agent_->sendWithRetries(
-      agent_->getWorkerInfo(parent), RRefChildAccept(forkId).toMessage());
+  std::vector<ControlMessage> messages;
+  {
+    std::lock_guard<std::mutex> lock(controlMessagesMutex_);
+    auto iter = pendingControlMessages_.find(dst);
+    if (iter != pendingControlMessages_.end()) {
+      // see Note [Batched RRef control messages]
+      iter->second.push_back(std::move(message));
+      return;
+    }
+    pendingControlMessages_.emplace(dst, std::vector<ControlMessage>());
+  }
+  messages.push_back(std::move(message));
+  sendControlMessages(dst, std::move(messages));
+}
+
+void RRefContext::sendControlMessages(
+    worker_id_t dst,
+    std::vector<ControlMessage> messages) {
+  Message message;
+  if (messages.size() == 1) {
+    const auto& m = messages.front();
+    switch (m.type) {
+      case MessageType::RREF_FORK_REQUEST:
+        message = RRefForkRequest(m.rrefId, m.forkId).toMessage();
+        break;
+      case MessageType::RREF_CHILD_ACCEPT:
+        message = RRefChildAccept(m.forkId).toMessage();
+        break;
+      case MessageType::RREF_USER_DELETE:
+        message = RRefUserDelete(m.rrefId, m.forkId).toMessage();
+        break;
+      default:
+        TORCH_INTERNAL_ASSERT(
+            false, "Unexpected RRef control message type ", m.type);
+    }
+  } else {
+    std::vector<std::pair<RRefId, ForkId>> forkRequests;
+    std::vector<ForkId> childAccepts;
+    std::vector<std::pair<RRefId, ForkId>> userDeletes;
+    for (const auto& m : messages) {
+      if (m.type == MessageType::RREF_FORK_REQUEST) {
+        forkRequests.emplace_back(m.rrefId, m.forkId);
+      } else if (m.type == MessageType::RREF_CHILD_ACCEPT) {
+        childAccepts.push_back(m.forkId);
+      } else {
+        userDeletes.emplace_back(m.rrefId, m.forkId);
+      }
+    }
+    message = RRefControlBatch(
+                  std::move(forkRequests),
+                  std::move(childAccepts),
+                  std::move(userDeletes))
+                  .toMessage();
+  }
+  auto jitFuture =
+      agent_->sendWithRetries(agent_->getWorkerInfo(dst), std::move(message));
 
+  auto sent =
+      std::make_shared<std::vector<ControlMessage>>(std::move(messages));
   std::weak_ptr<JitFuture> wp = jitFuture;
-  jitFuture->addCallback([this, wp]() {
+  jitFuture->addCallback([this, dst, sent, wp]() {
+    // Sends the messages that were queued while these were in flight, if any,
+    // before handling the ack.
+    std::vector<ControlMessage> queued;
+    {
+      std::lock_guard<std::mutex> lock(controlMessagesMutex_);
+      auto iter = pendingControlMessages_.find(dst);
+      TORCH_INTERNAL_ASSERT(iter != pendingControlMessages_.end());
+      if (iter->second.empty()) {
+        pendingControlMessages_.erase(iter);
+      } else {
+        queued.swap(iter->second);
+      }
+    }
+    if (!queued.empty()) {
+      sendControlMessages(dst, std::move(queued));
+    }
     handleException(*wp.lock());
-    --numPendingFutures_;
+    for (const auto& m : *sent) {
+      if (m.onAck) {
+        m.onAck();
+      }
+      // Decrease after calling onAck because, as that might send a new
+      // message, it might otherwise cause the count to briefly go to zero.
+      --numPendingFutures_;
+    }
   });
 }
 
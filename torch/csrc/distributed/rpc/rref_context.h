@@ -222,6 +222,31 @@ class TORCH_API RRefContext {
     Future<bool> future_;
   };
 
+  // Note [Batched RRef control messages]
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // RREF_FORK_REQUEST, RREF_CHILD_ACCEPT and RREF_USER_DELETE messages carry
+  // no payload but the ids of an RRef, and workers that create and pass many
+  // RRefs send many of them. RRefContext keeps at most one of these messages in
+  // flight to each worker. The ones to send to a worker while an earlier one is
+  // in flight are queued, and are sent together in a single
+  // RREF_CONTROL_BATCH message once it is acked. A lone message is still sent
+  // as itself, so that workers that send few of them see no difference, and
+  // busy workers send one message per round trip to each worker rather than
+  // one per RRef. The order of the messages doesn't matter, as the RRef
+  // protocol doesn't rely on messages arriving in order anyway.
+  struct ControlMessage {
+    // The message type of the message when it is sent on its own
+    MessageType type;
+    RRefId rrefId;
+    ForkId forkId;
+    // Runs once the owner or parent acked the message
+    std::function<void()> onAck;
+  };
+  void sendControlMessage(worker_id_t dst, ControlMessage message);
+  void sendControlMessages(
+      worker_id_t dst,
+      std::vector<ControlMessage> messages);
+
   RRefContext(std::shared_ptr<RpcAgent>);
 
   c10::intrusive_ptr<UserRRef> createUserRRef(
@@ -299,6 +324,13 @@ class TORCH_API RRefContext {
   // these pending requests, so that users can wait for it to reach zero.
   std::atomic<int64_t> numPendingFutures_{0};
 
+  // The control messages to each worker that wait for the one in flight to it,
+  // see Note [Batched RRef control messages]. A worker is in the map while a
+  // message to it is in flight.
+  std::mutex controlMessagesMutex_;
+  std::unordered_map<worker_id_t, std::vector<ControlMessage>>
+      pendingControlMessages_;
+
   std::mutex destroyedMutex_;
   bool destroyed_;
 
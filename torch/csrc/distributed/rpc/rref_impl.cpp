@@ -123,7 +123,7 @@ const ForkId& UserRRef::forkId() const {
   return forkId_;
 }
 
-IValue UserRRef::toHere(const float timeoutSeconds) const {
+void UserRRef::checkFetchable() const {
   TORCH_CHECK(
       !getTimedOut(),
       "RRef creation via rpc.remote() timed out, and it "
@@ -133,14 +133,6 @@ IValue UserRRef::toHere(const float timeoutSeconds) const {
       !deletedOnOwner_,
       *this,
       " has been deleted. Cannot call to_here() on it after deletion.");
-  auto toHereKey = std::string("");
-  if (torch::autograd::profiler::profilerEnabled()) {
-    toHereKey = fmt::format(
-        "to_here#({})->({})",
-        RpcAgent::getCurrentRpcAgent()->getWorkerInfo().name_,
-        RpcAgent::getCurrentRpcAgent()->getWorkerInfo(ownerId_).name_);
-  }
-  RECORD_USER_SCOPE(toHereKey);
   TORCH_CHECK(
       !type_->is_module(),
       *this,
@@ -151,6 +143,18 @@ IValue UserRRef::toHere(const float timeoutSeconds) const {
       ", to user, ",
       RpcAgent::getCurrentRpcAgent()->getWorkerInfo(),
       ".");
+}
+
+IValue UserRRef::toHere(const float timeoutSeconds) const {
+  checkFetchable();
+  auto toHereKey = std::string("");
+  if (torch::autograd::profiler::profilerEnabled()) {
+    toHereKey = fmt::format(
+        "to_here#({})->({})",
+        RpcAgent::getCurrentRpcAgent()->getWorkerInfo().name_,
+        RpcAgent::getCurrentRpcAgent()->getWorkerInfo(ownerId_).name_);
+  }
+  RECORD_USER_SCOPE(toHereKey);
 
   auto agent = RpcAgent::getCurrentRpcAgent();
 
@@ -199,6 +203,62 @@ IValue UserRRef::toHere(const float timeoutSeconds) const {
   }
 }
 
+std::vector<IValue> UserRRef::toHereBatch(
+    const std::vector<c10::intrusive_ptr<UserRRef>>& rrefs,
+    const float timeoutSeconds) {
+  auto agent = RpcAgent::getCurrentRpcAgent();
+  // The indices of the rrefs of each owner
+  std::unordered_map<worker_id_t, std::vector<size_t>> owners;
+  for (size_t i = 0; i < rrefs.size(); ++i) {
+    rrefs[i]->checkFetchable();
+    owners[rrefs[i]->owner()].push_back(i);
+  }
+
+  std::vector<std::pair<const std::vector<size_t>*, std::shared_ptr<JitFuture>>>
+      futures;
+  for (const auto& owner : owners) {
+    std::vector<RRefId> rrefIds;
+    for (size_t i : owner.second) {
+      rrefIds.push_back(rrefs[i]->rrefId());
+    }
+    // Like toHere, the call always carries the autograd context id, as the
+    // response would potentially contain tensors.
+    auto jitFuture = autograd::sendMessageWithAutograd(
+        *agent,
+        agent->getWorkerInfo(owner.first),
+        RRefFetchBatchCall(agent->getWorkerInfo().id_, std::move(rrefIds))
+            .toMessage(),
+        true /* forceGradRecording */,
+        timeoutSeconds,
+        true /* forceDisableProfiling */);
+    futures.emplace_back(&owner.second, std::move(jitFuture));
+  }
+
+  std::vector<IValue> values(rrefs.size());
+  for (const auto& future : futures) {
+    future.second->waitAndThrow();
+    auto messagePtr = future.second->constValue().toCustomClass<Message>();
+    MessageType msgType = messagePtr->type();
+    auto response = deserializeResponse(*messagePtr, msgType);
+    TORCH_INTERNAL_ASSERT(
+        msgType == MessageType::RREF_FETCH_BATCH_RET,
+        "Message type should be RREF_FETCH_BATCH_RET");
+    RpcCommandBase& rpc = *response;
+    const auto& fetched = static_cast<RRefFetchBatchRet&>(rpc).values();
+    const auto& indices = *future.first;
+    TORCH_INTERNAL_ASSERT(
+        fetched.size() == indices.size(),
+        "Expected ",
+        indices.size(),
+        " RRef values from the owner, but got ",
+        fetched.size());
+    for (size_t j = 0; j < indices.size(); ++j) {
+      values[indices[j]] = fetched[j];
+    }
+  }
+  return values;
+}
+
 RRefForkData UserRRef::fork() const {
   // Note [Best-Effort Check on Deleted UserRRefs]
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
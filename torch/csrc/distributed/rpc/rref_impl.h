@@ -309,6 +309,12 @@ class TORCH_API UserRRef final : public RRef {
       const float timeoutSeconds =
           torch::distributed::rpc::kUnsetRpcTimeout) const;
 
+  // Fetches the values of rrefs like toHere, with a single RPC to each of
+  // their owners. Returns the values in the order of rrefs.
+  static std::vector<IValue> toHereBatch(
+      const std::vector<c10::intrusive_ptr<UserRRef>>& rrefs,
+      const float timeoutSeconds = torch::distributed::rpc::kUnsetRpcTimeout);
+
   void tryDel() override;
 
   // Will be called when refcount reaches 0.
@@ -328,6 +334,8 @@ class TORCH_API UserRRef final : public RRef {
   inline void confirm() {
     confirmedByOwner_ = true;
   }
+  // Throws if the value of this RRef can't be fetched from the owner.
+  void checkFetchable() const;
 
   const ForkId forkId_;
 
@@ -130,10 +130,11 @@ const std::vector<at::IValue>& RRefFetchRet::values() {
 }
 
 Message RRefFetchRet::toMessageImpl() && {
-  std::vector<at::IValue> ivalues = values_;
+  // The tensors of the values go to the tensor table of the message, which the
+  // agents send without copying them into the payload.
   std::vector<torch::Tensor> tensor_table;
-  auto payload =
-      jit::pickle(c10::ivalue::Tuple::create(ivalues), &tensor_table);
+  auto payload = jit::pickle(
+      c10::ivalue::Tuple::create(std::move(values_)), &tensor_table);
   return Message(std::move(payload), std::move(tensor_table), type_);
 }
 
@@ -153,6 +154,45 @@ std::unique_ptr<PythonRRefFetchRet> PythonRRefFetchRet::fromMessage(
       toIValues(message, MessageType::PYTHON_RREF_FETCH_RET));
 }
 
+const std::vector<RRefId>& RRefFetchBatchCall::rrefIds() const {
+  return rrefIds_;
+}
+
+Message RRefFetchBatchCall::toMessageImpl() && {
+  std::vector<at::IValue> rrefIds;
+  rrefIds.reserve(rrefIds_.size());
+  for (const auto& rrefId : rrefIds_) {
+    rrefIds.emplace_back(rrefId.toIValue());
+  }
+  return fromIValues(
+      {c10::ivalue::Tuple::create(std::move(rrefIds)), fromWorkerId_},
+      MessageType::RREF_FETCH_BATCH_CALL);
+}
+
+std::unique_ptr<RRefFetchBatchCall> RRefFetchBatchCall::fromMessage(
+    const Message& message) {
+  auto values = toIValues(message, MessageType::RREF_FETCH_BATCH_CALL);
+  TORCH_INTERNAL_ASSERT(
+      values.size() == 2, "RRefFetchBatchCall expects 2 IValues from message");
+  auto id = values[1].toInt();
+  TORCH_INTERNAL_ASSERT(
+      id >= std::numeric_limits<worker_id_t>::min() &&
+          id <= std::numeric_limits<worker_id_t>::max(),
+      "RRefFetchBatchCall fromWorkerId exceeds worker_id_t limit.")
+  std::vector<RRefId> rrefIds;
+  for (const auto& rrefId : values[0].toTuple()->elements()) {
+    rrefIds.push_back(RRefId::fromIValue(rrefId));
+  }
+  return std::make_unique<RRefFetchBatchCall>(
+      worker_id_t(id), std::move(rrefIds));
+}
+
+std::unique_ptr<RRefFetchBatchRet> RRefFetchBatchRet::fromMessage(
+    const Message& message) {
+  return std::make_unique<RRefFetchBatchRet>(
+      toIValues(message, MessageType::RREF_FETCH_BATCH_RET));
+}
+
 std::unique_ptr<RRefUserDelete> RRefUserDelete::fromMessage(
     const Message& message) {
   auto pair =
@@ -189,6 +229,75 @@ std::unique_ptr<RRefForkRequest> RRefForkRequest::fromMessage(
   return std::make_unique<RRefForkRequest>(pair.first, pair.second);
 }
 
+namespace {
+
+IValue forksToIValue(const std::vector<std::pair<RRefId, ForkId>>& forks) {
+  std::vector<at::IValue> ivalues;
+  ivalues.reserve(2 * forks.size());
+  for (const auto& fork : forks) {
+    ivalues.emplace_back(fork.first.toIValue());
+    ivalues.emplace_back(fork.second.toIValue());
+  }
+  return c10::ivalue::Tuple::create(std::move(ivalues));
+}
+
+std::vector<std::pair<RRefId, ForkId>> forksFromIValue(const IValue& value) {
+  const auto& list = value.toTuple()->elements();
+  TORCH_INTERNAL_ASSERT(
+      list.size() % 2 == 0, "Expect pairs of RRefId and ForkId.");
+  std::vector<std::pair<RRefId, ForkId>> forks;
+  forks.reserve(list.size() / 2);
+  for (size_t i = 0; i < list.size(); i += 2) {
+    forks.emplace_back(
+        RRefId::fromIValue(list[i]), ForkId::fromIValue(list[i + 1]));
+  }
+  return forks;
+}
+
+} // namespace
+
+const std::vector<std::pair<RRefId, ForkId>>& RRefControlBatch::forkRequests()
+    const {
+  return forkRequests_;
+}
+
+const std::vector<ForkId>& RRefControlBatch::childAccepts() const {
+  return childAccepts_;
+}
+
+const std::vector<std::pair<RRefId, ForkId>>& RRefControlBatch::userDeletes()
+    const {
+  return userDeletes_;
+}
+
+Message RRefControlBatch::toMessageImpl() && {
+  std::vector<at::IValue> childAccepts;
+  childAccepts.reserve(childAccepts_.size());
+  for (const auto& forkId : childAccepts_) {
+    childAccepts.emplace_back(forkId.toIValue());
+  }
+  return fromIValues(
+      {forksToIValue(forkRequests_),
+       c10::ivalue::Tuple::create(std::move(childAccepts)),
+       forksToIValue(userDeletes_)},
+      MessageType::RREF_CONTROL_BATCH);
+}
+
+std::unique_ptr<RRefControlBatch> RRefControlBatch::fromMessage(
+    const Message& message) {
+  auto values = toIValues(message, MessageType::RREF_CONTROL_BATCH);
+  TORCH_INTERNAL_ASSERT(
+      values.size() == 3, "RRefControlBatch expects 3 IValues from message");
+  std::vector<ForkId> childAccepts;
+  for (const auto& forkId : values[1].toTuple()->elements()) {
+    childAccepts.push_back(ForkId::fromIValue(forkId));
+  }
+  return std::make_unique<RRefControlBatch>(
+      forksFromIValue(values[0]),
+      std::move(childAccepts),
+      forksFromIValue(values[2]));
+}
+
 Message RRefAck::toMessageImpl() && {
   return Message({}, {}, MessageType::RREF_ACK);
 }
@@ -113,6 +113,40 @@ class TORCH_API PythonRRefFetchRet final : public RRefFetchRet {
       const Message& message);
 };
 
+// UserRRefs use this message to fetch the values of several RRefs from their
+// owner in a single round trip.
+class TORCH_API RRefFetchBatchCall final : public RpcCommandBase {
+ public:
+  RRefFetchBatchCall(worker_id_t fromWorkerId, std::vector<RRefId> rrefIds)
+      : fromWorkerId_(fromWorkerId), rrefIds_(std::move(rrefIds)) {}
+
+  inline worker_id_t fromWorkerId() const {
+    return fromWorkerId_;
+  }
+
+  const std::vector<RRefId>& rrefIds() const;
+
+  Message toMessageImpl() && override;
+  static std::unique_ptr<RRefFetchBatchCall> fromMessage(
+      const Message& message);
+
+ private:
+  const worker_id_t fromWorkerId_;
+  const std::vector<RRefId> rrefIds_;
+};
+
+// The owner's response to RRefFetchBatchCall, which holds one value for each of
+// the RRefs, in the order of the call. The value of an RRef of a py::object is
+// the tuple of the IValues of the pickled object, as in PythonRRefFetchRet.
+class TORCH_API RRefFetchBatchRet final : public RRefFetchRet {
+ public:
+  explicit RRefFetchBatchRet(std::vector<at::IValue> values)
+      : RRefFetchRet(std::move(values), MessageType::RREF_FETCH_BATCH_RET) {}
+
+  static std::unique_ptr<RRefFetchBatchRet> fromMessage(
+      const Message& message);
+};
+
 // UserRRef (regardless it's the creator or not) uses this message to notiify
 // OwnerRRef on delete.
 class TORCH_API RRefUserDelete final : public ForkMessageBase {
@@ -155,6 +189,34 @@ class TORCH_API RRefForkRequest final : public ForkMessageBase {
   static std::unique_ptr<RRefForkRequest> fromMessage(const Message& message);
 };
 
+// The fork requests, child accepts and user deletes that a worker sends to the
+// same destination while an earlier one is in flight, see
+// Note [Batched RRef control messages]. The receiver handles them as if they
+// were separate RREF_FORK_REQUEST, RREF_CHILD_ACCEPT and RREF_USER_DELETE
+// messages, in this order, and responds with a single RRefAck.
+class TORCH_API RRefControlBatch final : public RpcCommandBase {
+ public:
+  RRefControlBatch(
+      std::vector<std::pair<RRefId, ForkId>> forkRequests,
+      std::vector<ForkId> childAccepts,
+      std::vector<std::pair<RRefId, ForkId>> userDeletes)
+      : forkRequests_(std::move(forkRequests)),
+        childAccepts_(std::move(childAccepts)),
+        userDeletes_(std::move(userDeletes)) {}
+
+  const std::vector<std::pair<RRefId, ForkId>>& forkRequests() const;
+  const std::vector<ForkId>& childAccepts() const;
+  const std::vector<std::pair<RRefId, ForkId>>& userDeletes() const;
+
+  Message toMessageImpl() && override;
+  static std::unique_ptr<RRefControlBatch> fromMessage(const Message& message);
+
+ private:
+  const std::vector<std::pair<RRefId, ForkId>> forkRequests_;
+  const std::vector<ForkId> childAccepts_;
+  const std::vector<std::pair<RRefId, ForkId>> userDeletes_;
+};
+
 class TORCH_API RRefAck final : public RpcCommandBase {
  public:
   RRefAck() {}
@@ -2,6 +2,7 @@
 
 #ifdef USE_TENSORPIPE
 
+#include <fstream>
 #include <limits>
 
 #include <fmt/format.h>
@@ -14,11 +15,10 @@
 #include <ATen/cuda/CUDAMultiStreamGuard.h>
 #endif
 
-#if TENSORPIPE_HAS_SHM_TRANSPORT
-// Needed for ::getpid(), which is used to create a unique address.
+// Needed for ::getpid(), which is used to create a unique address, and for
+// ::readlink(), which is used to identify the host of the agent.
 #include <sys/types.h>
 #include <unistd.h>
-#endif
 
 namespace torch {
 namespace distributed {
@@ -39,6 +39,48 @@ const std::string kClientActiveCalls = "agent.client_active_calls";
 const std::string kServerActiveCalls = "agent.server_active_calls";
 const std::string kServerActiveAsyncCalls = "agent.server_active_async_calls";
 
+// Per-transport metrics, e.g. "agent.transport.shm.bytes_sent".
+const std::string kTransportMetricPrefix = "agent.transport.";
+const std::string kBytesSent = ".bytes_sent";
+const std::string kBytesReceived = ".bytes_received";
+const std::string kAverageRpcLatency = ".average_rpc_latency_us";
+
+// Note [Same-host pipes]
+// Every agent publishes, next to its bootstrap URL, the URL of the transport
+// with the highest priority (shm, unless overridden) and a key identifying its
+// host, the boot id of the kernel and the network and IPC namespaces, as the
+// shm transport needs both sides to share them. Pipes to agents with the same
+// key connect to that URL directly, instead of bootstrapping over the uv
+// transport and upgrading during the handshake. TensorPipe then picks the
+// channels of the pipe by priority among the ones that both sides can use, so
+// that co-located workers use cma for CPU tensors and cuda_ipc for CUDA
+// tensors, while workers on other hosts stay on the network.
+std::string getHostKey() {
+  std::string bootId;
+  std::ifstream bootIdFile("/proc/sys/kernel/random/boot_id");
+  if (!std::getline(bootIdFile, bootId) || bootId.empty()) {
+    return "";
+  }
+  std::string key = bootId;
+  for (const char* ns : {"/proc/self/ns/net", "/proc/self/ns/ipc"}) {
+    char buf[64];
+    ssize_t len = ::readlink(ns, buf, sizeof(buf));
+    if (len <= 0) {
+      return "";
+    }
+    key.append(" ").append(buf, len);
+  }
+  return key;
+}
+
+size_t messageSize(const Message& message) {
+  size_t size = message.payload().size();
+  for (const auto& tensor : message.tensors()) {
+    size += tensor.storage().nbytes();
+  }
+  return size;
+}
+
 std::vector<c10::DeviceIndex> getDevicesForTensors(
     const std::vector<torch::Tensor>& tensors,
     const tensorpipe::DeviceMap& deviceMap,
@@ -471,6 +513,7 @@ TensorPipeAgent::TensorPipeAgent(
           tensorpipe::ContextOptions().name(workerInfo_.name_))),
       rankToNameStore_("names", store),
       nameToAddressStore_("addrs", store),
+      nameToLocalAddressStore_("local_addrs", store),
       worldSize_(worldSize),
       processGroup_(std::move(processGroup)) {
   collectNames();
@@ -490,6 +533,9 @@ void TensorPipeAgent::startImpl() {
   std::vector<std::string> addresses;
   int lowestPriority = std::numeric_limits<int>::max();
   std::string lowestPriorityTransport;
+  int highestPriority = std::numeric_limits<int>::min();
+  std::string highestPriorityTransport;
+  std::vector<std::string> transports;
 
   for (auto& key : TensorPipeTransportRegistry()->Keys()) {
     int64_t priority = -1;
@@ -516,7 +562,12 @@ void TensorPipeAgent::startImpl() {
       lowestPriority = priority;
       lowestPriorityTransport = key;
     }
+    if (priority > highestPriority) {
+      highestPriority = priority;
+      highestPriorityTransport = key;
+    }
     addresses.push_back(c10::str(key, "://", reg->address));
+    transports.push_back(key);
     context_->registerTransport(
         priority, std::move(key), std::move(reg->transport));
   }
@@ -568,6 +619,14 @@ void TensorPipeAgent::startImpl() {
   const std::vector<uint8_t> selfAddrData(address.begin(), address.end());
   nameToAddressStore_.set(workerInfo_.name_, selfAddrData);
 
+  // See Note [Same-host pipes]
+  const auto hostKey = getHostKey();
+  const auto localAddress =
+      c10::str(hostKey, "\n", listener_->url(highestPriorityTransport));
+  nameToLocalAddressStore_.set(
+      workerInfo_.name_,
+      std::vector<uint8_t>(localAddress.begin(), localAddress.end()));
+
   VLOG(1) << "RPC agent for " << workerInfo_.name_ << " is using address "
           << address;
 
@@ -576,6 +635,23 @@ void TensorPipeAgent::startImpl() {
     auto nodeAddrData = nameToAddressStore_.get(name);
     auto nodeAddrStr =
         std::string((const char*)nodeAddrData.data(), nodeAddrData.size());
+    auto nodeLocalAddrData = nameToLocalAddressStore_.get(name);
+    auto nodeLocalAddrStr = std::string(
+        (const char*)nodeLocalAddrData.data(), nodeLocalAddrData.size());
+    auto sep = nodeLocalAddrStr.find('\n');
+    if (!hostKey.empty() && sep != std::string::npos &&
+        nodeLocalAddrStr.compare(0, sep, hostKey) == 0) {
+      auto localAddrStr = nodeLocalAddrStr.substr(sep + 1);
+      // We can only connect with the transports we registered ourselves.
+      const auto localTransport =
+          localAddrStr.substr(0, localAddrStr.find("://"));
+      if (std::find(transports.begin(), transports.end(), localTransport) !=
+          transports.end()) {
+        nodeAddrStr = std::move(localAddrStr);
+      }
+    }
+    VLOG(1) << "RPC agent for " << workerInfo_.name_ << " will connect to "
+            << name << " at " << nodeAddrStr;
     workerNameToURL_.insert({name, nodeAddrStr});
   }
 
@@ -925,6 +1001,12 @@ std::shared_ptr<JitFuture> TensorPipeAgent::send(
   VLOG(1) << "RPC agent for " << workerInfo_.name_ << " is sending request #"
           << messageId << " to " << clientPipe.pipe_->getRemoteName();
 
+  // The transport the pipe was connected with, i.e. the part of its URL
+  // before "://", to attribute the metrics of this call to.
+  std::string transport = url.substr(0, url.find("://"));
+  const uint64_t requestSize = messageSize(requestMessage);
+  const auto startTime = std::chrono::steady_clock::now();
+
   auto ctx = createLazyStreamContext();
   ctx->waitForCurrentStreams(requestMessage.tensors());
   pipeWrite(
@@ -932,8 +1014,13 @@ std::shared_ptr<JitFuture> TensorPipeAgent::send(
       std::move(requestMessage),
       std::move(devices),
       std::move(ctx),
-      [this, &clientPipe, messageId, expirationTime](
-          const tensorpipe::Error& error) mutable {
+      [this,
+       &clientPipe,
+       messageId,
+       expirationTime,
+       transport{std::move(transport)},
+       requestSize,
+       startTime](const tensorpipe::Error& error) mutable {
         if (error) {
           if (error.isOfType<tensorpipe::PipeClosedError>() &&
               !rpcAgentRunning_.load()) {
@@ -945,6 +1032,7 @@ std::shared_ptr<JitFuture> TensorPipeAgent::send(
                          << clientPipe.pipe_->getRemoteName() << ": "
                          << error.what();
           }
+          trackNetworkError(requestSize, clientPipe.pipe_->getRemoteName());
           auto pendingFutIt =
               clientPipe.pendingResponseMessage_.find(messageId);
           if (pendingFutIt != clientPipe.pendingResponseMessage_.end()) {
@@ -958,7 +1046,12 @@ std::shared_ptr<JitFuture> TensorPipeAgent::send(
 
         pipeRead(
             clientPipe.pipe_,
-            [this, &clientPipe, expirationTime](
+            [this,
+             &clientPipe,
+             expirationTime,
+             transport{std::move(transport)},
+             requestSize,
+             startTime](
                 const tensorpipe::Error& error,
                 Message&& responseMessage,
                 std::shared_ptr<LazyStreamContext> ctx) {
@@ -1019,6 +1112,17 @@ std::shared_ptr<JitFuture> TensorPipeAgent::send(
               // Remove entry from timeoutMap_.
               removeFromTimeoutMap(messageId, expirationTime);
 
+              trackTransportData(
+                  transport,
+                  requestSize,
+                  messageSize(responseMessage),
+                  std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - startTime));
+              trackNetworkData(
+                  requestSize,
+                  messageSize(responseMessage),
+                  clientPipe.pipe_->getRemoteName());
+
               if (responseMessage.type() == MessageType::EXCEPTION) {
                 markFutureWithError(
                     std::move(futureResponseMessage),
@@ -1222,6 +1326,22 @@ std::unordered_map<std::string, std::string> TensorPipeAgent::getMetrics() {
       metrics[kGilAverageWaitTime] = c10::to_string(averageGilWaitTime);
     }
   }
+  {
+    std::lock_guard<std::mutex> lock(networkDataMutex_);
+    for (const auto& p : transportData_) {
+      const auto prefix = kTransportMetricPrefix + p.first;
+      metrics[prefix + kBytesSent] = c10::to_string(p.second.totalSentBytes);
+      metrics[prefix + kBytesReceived] =
+          c10::to_string(p.second.totalRecvBytes);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(metricsMutex_);
+    for (const auto& p : transportRpcLatencies_) {
+      metrics[kTransportMetricPrefix + p.first + kAverageRpcLatency] =
+          c10::to_string(p.second.computeAverage());
+    }
+  }
 
   return metrics;
 }
@@ -1255,6 +1375,22 @@ void TensorPipeAgent::trackNetworkData(
   networkData_[destWorkerName].totalRecvBytes += responseSize;
 }
 
+void TensorPipeAgent::trackTransportData(
+    const std::string& transport,
+    uint64_t requestSize,
+    uint64_t responseSize,
+    std::chrono::microseconds latency) {
+  {
+    std::lock_guard<std::mutex> lock(networkDataMutex_);
+    auto& data = transportData_[transport];
+    data.numCalls++;
+    data.totalSentBytes += requestSize;
+    data.totalRecvBytes += responseSize;
+  }
+  std::lock_guard<std::mutex> lock(metricsMutex_);
+  transportRpcLatencies_[transport].addData(latency.count());
+}
+
 void TensorPipeAgent::trackNetworkError(
     uint64_t requestSize,
     const std::string& destWorkerName) {
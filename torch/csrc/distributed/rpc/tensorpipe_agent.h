@@ -275,6 +275,13 @@ class TensorPipeAgent : public RpcAgent {
       uint64_t responseSize,
       const std::string& destWorkerName);
 
+  // Collects the metrics of the transport of successful RPC calls
+  void trackTransportData(
+      const std::string& transport,
+      uint64_t requestSize,
+      uint64_t responseSize,
+      std::chrono::microseconds latency);
+
   // Collects metrics from failed RPC calls
   void trackNetworkError(
       uint64_t requestSize,
@@ -358,6 +365,9 @@ class TensorPipeAgent : public RpcAgent {
 
   ::c10d::PrefixStore rankToNameStore_;
   ::c10d::PrefixStore nameToAddressStore_;
+  // The host key and the URL that agents on the same host connect to, see
+  // Note [Same-host pipes]
+  ::c10d::PrefixStore nameToLocalAddressStore_;
   const int worldSize_;
 
   // The join method is required to behave like a barrier and perform collective
@@ -431,11 +441,16 @@ class TensorPipeAgent : public RpcAgent {
 
   // Map of Time-Series metrics tracked by the RPC Agent
   std::unordered_map<std::string, TimeSeriesMetricsTracker> timeSeriesMetrics_;
+  // Round-trip latency of the RPC calls, by transport of their pipe
+  std::unordered_map<std::string, TimeSeriesMetricsTracker>
+      transportRpcLatencies_;
   // Mutex to guard timeSeriesMetrics_
   std::mutex metricsMutex_;
 
   // Map to Track Network Data
   NetworkDataDict networkData_;
+  // Network Data of the RPC calls, by transport of their pipe
+  NetworkDataDict transportData_;
   // Mutex to guard networkData_
   std::mutex networkDataMutex_;
 
@@ -124,6 +124,12 @@ std::unique_ptr<RpcCommandBase> deserializeRequest(const Message& request) {
     case MessageType::RREF_FORK_REQUEST: {
       return RRefForkRequest::fromMessage(request);
     }
+    case MessageType::RREF_FETCH_BATCH_CALL: {
+      return RRefFetchBatchCall::fromMessage(request);
+    }
+    case MessageType::RREF_CONTROL_BATCH: {
+      return RRefControlBatch::fromMessage(request);
+    }
     case MessageType::FORWARD_AUTOGRAD_REQ: {
       return autograd::RpcWithAutograd::fromMessage(request);
     }
@@ -165,6 +171,9 @@ std::unique_ptr<RpcCommandBase> deserializeResponse(
     case MessageType::PYTHON_RREF_FETCH_RET: {
       return PythonRRefFetchRet::fromMessage(response);
     }
+    case MessageType::RREF_FETCH_BATCH_RET: {
+      return RRefFetchBatchRet::fromMessage(response);
+    }
     case MessageType::RREF_ACK: {
       return RRefAck::fromMessage(response);
     }
@@ -247,6 +256,13 @@ IValue deserializeRespToIValue(const Message& message) {
 
 namespace {
 
+static const char* kMeta = "meta";
+static const char* kPayload = "payload";
+
+bool isTensorSection(const std::string& name) {
+  return name != kMeta && name != kPayload;
+}
+
 // Helper for wireDeserialize() below.
 //
 // The format we use below looks like:
@@ -261,10 +277,14 @@ namespace {
 //    - "meta"    - metadata for the unpickler
 //    - "0" ...   - tensor sections for the unpickler
 //
+// wireSerializeNoCopy() leaves the tensor sections out of the sections that
+// follow the header, hence tensorsInline: if false, the tensor sections are
+// returned with a null data pointer and their size.
+//
 // Note that per the header comments, the format is subject to change,
 // and is best used for rpcs, rather than persistent disk storage.
 std::unordered_map<std::string, std::pair<const char*, size_t>>
-parseWireSections(const void* data, size_t data_size) {
+parseWireSections(const void* data, size_t data_size, bool tensorsInline) {
   const char* ptr = static_cast<const char*>(data);
   const char* endp = ptr + data_size;
 
@@ -306,6 +326,10 @@ parseWireSections(const void* data, size_t data_size) {
 
   std::unordered_map<std::string, std::pair<const char*, size_t>> out;
   for (const auto& headerEnt : headerEnts) {
+    if (!tensorsInline && isTensorSection(headerEnt.first)) {
+      out[headerEnt.first] = {nullptr, headerEnt.second};
+      continue;
+    }
     out[headerEnt.first] = {ptr, headerEnt.second};
     ptr += headerEnt.second;
   }
@@ -315,37 +339,33 @@ parseWireSections(const void* data, size_t data_size) {
   return out;
 }
 
-static const char* kMeta = "meta";
-static const char* kPayload = "payload";
-}; // namespace
+// A DataPtr to data, which lies in storage, that keeps storage alive.
+at::DataPtr dataPtrInStorage(const c10::Storage& storage, void* data) {
+  return at::DataPtr(
+      data,
+      new c10::Storage(storage),
+      [](void* ctx) { delete static_cast<c10::Storage*>(ctx); },
+      storage.device());
+}
 
-c10::List<at::Tensor> cloneSparseTensors(
-    const std::vector<at::Tensor>& tensors) {
-  // Sanity-check: If the majority of bits don't need to go over the wire,
-  // force a clone(). Some Tensors are effectively small views, only using
-  // ~1% of the underlying Storage.
-  auto worthRecopying = [](const at::Tensor& t) -> bool {
-    if (!t.has_storage()) {
-      return false; // avoid throwing below.
-    }
-    auto storageSize = t.storage().nbytes();
-    auto usefulSize = t.element_size() * t.numel();
-    constexpr size_t kMinMultiple = 2;
-    constexpr size_t kMinRecopyBytes = 8 * 1024;
-    return storageSize >= kMinRecopyBytes &&
-        storageSize >= usefulSize * kMinMultiple;
+// The sections of a message but their header, see parseWireSections().
+struct WireSections {
+  struct Ent {
+    std::string name;
+    const char* data;
+    size_t size;
   };
-  c10::List<at::Tensor> pTensors;
-  pTensors.reserve(tensors.size());
-  for (const auto& t : tensors) {
-    pTensors.push_back(worthRecopying(t) ? t.clone() : t);
-  }
-  return pTensors;
-}
+  // "payload" and "meta", which point to the payload and to metaEntry
+  std::vector<Ent> entries;
+  std::string metaEntry;
+  // The tensors whose storages are the tensor sections, in order.
+  std::vector<at::Tensor> tensorData;
+};
 
-std::string wireSerialize(
+void collectWireSections(
     const std::vector<char>& payload,
-    const std::vector<at::Tensor>& tensors) {
+    const std::vector<at::Tensor>& tensors,
+    WireSections& sections) {
   for (const auto& tensor : tensors) {
     TORCH_CHECK(
         tensor.device().is_cpu(),
@@ -355,70 +375,43 @@ std::string wireSerialize(
         tensor.device());
   }
 
-  struct Ent {
-    std::string name;
-    const char* data;
-    size_t size;
-  };
-  std::vector<Ent> entries;
-  std::string metaEntry;
-  std::vector<at::Tensor> tensorData;
-
   if (!payload.empty()) {
-    entries.push_back({kPayload, payload.data(), payload.size()});
+    sections.entries.push_back({kPayload, payload.data(), payload.size()});
   }
 
   if (!tensors.empty()) {
     torch::jit::Pickler pickler([&](const void* buf, size_t sz) -> size_t {
-      metaEntry.append(static_cast<const char*>(buf), sz);
+      sections.metaEntry.append(static_cast<const char*>(buf), sz);
       return sz;
     });
     pickler.protocol();
     pickler.pushIValue(cloneSparseTensors(tensors));
     pickler.stop();
-    tensorData = pickler.tensorData();
-    entries.push_back({kMeta, metaEntry.data(), metaEntry.size()});
-    for (size_t i = 0; i < tensorData.size(); i++) {
-      // Construct WritableTensorData for each tensor in the pickler tensorData
-      // Since tensorData is in function scope, and getWritableTensorData just
-      // record the tensors, the data() pointers stay valid for CPU tensors
-      // Note that RPC serde doesn't support CUDA tensors yet, if we should
-      // support CUDA tensor, we need to be careful since getWritableTensorData
-      // converts CUDA tensor to cpu and data() might get destructed as we go
-      // out of scope of this loop.
-      auto writeableTensorData = jit::getWriteableTensorData(tensorData[i]);
-      entries.push_back(
-          {c10::to_string(i),
-           writeableTensorData.data(),
-           writeableTensorData.sizeInBytes()});
-    }
+    sections.tensorData = pickler.tensorData();
+    sections.entries.push_back(
+        {kMeta, sections.metaEntry.data(), sections.metaEntry.size()});
   }
+}
 
+std::string wireHeader(const WireSections& sections) {
   std::string header;
-  size_t tot = 0;
-  for (const auto& e : entries) {
-    tot += e.size;
-    header.append(e.name)
-        .append(" ")
-        .append(c10::to_string(e.size))
-        .append("\n");
+  auto appendEnt = [&](const std::string& name, size_t size) {
+    header.append(name).append(" ").append(c10::to_string(size)).append("\n");
+  };
+  for (const auto& e : sections.entries) {
+    appendEnt(e.name, e.size);
   }
-  header.push_back('\n');
-
-  std::string out;
-  out.reserve(header.size() + tot);
-  out.append(header);
-  for (const auto& e : entries) {
-    out.append(e.data, e.size);
+  for (size_t i = 0; i < sections.tensorData.size(); i++) {
+    appendEnt(c10::to_string(i), sections.tensorData[i].storage().nbytes());
   }
-  return out;
+  header.push_back('\n');
+  return header;
 }
 
-std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
-    const void* data,
-    size_t data_size) {
-  auto sections = parseWireSections(data, data_size);
-
+std::pair<std::vector<char>, std::vector<at::Tensor>> deserializeWireSections(
+    const std::unordered_map<std::string, std::pair<const char*, size_t>>&
+        sections,
+    const std::function<at::DataPtr(const std::string&)>& sectionReadFunc) {
   std::vector<char> payload;
   auto payloadIt = sections.find(kPayload);
   if (payloadIt != sections.end() && payloadIt->second.second != 0) {
@@ -441,18 +434,6 @@ std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
       metaDataPos += toCopy;
       return toCopy;
     };
-    auto sectionReadFunc = [&](const std::string& ename) -> at::DataPtr {
-      auto it = sections.find(ename);
-      if (it == sections.end()) {
-        throw std::runtime_error("Couldn't find entity " + ename);
-      }
-      const auto& idat = it->second;
-      auto dptr = at::getCPUAllocator()->allocate(idat.second);
-      if (idat.second != 0) {
-        memcpy(dptr.get(), idat.first, idat.second);
-      }
-      return dptr;
-    };
 
     // No need to pass typeResolver here, as it always processes string and
     // tensors only
@@ -466,6 +447,176 @@ std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
   return {std::move(payload), std::move(tensors)};
 }
 
+}; // namespace
+
+c10::List<at::Tensor> cloneSparseTensors(
+    const std::vector<at::Tensor>& tensors) {
+  // Sanity-check: If the majority of bits don't need to go over the wire,
+  // force a clone(). Some Tensors are effectively small views, only using
+  // ~1% of the underlying Storage.
+  constexpr size_t kMinMultiple = 2;
+  constexpr size_t kMinRecopyBytes = 8 * 1024;
+  auto worthRecopying = [&](const at::Tensor& t) -> bool {
+    if (!t.has_storage()) {
+      return false; // avoid throwing below.
+    }
+    auto storageSize = t.storage().nbytes();
+    auto usefulSize = t.element_size() * t.numel();
+    return storageSize >= kMinRecopyBytes &&
+        storageSize >= usefulSize * kMinMultiple;
+  };
+  // The bytes of the storage that the view reaches, from its first element.
+  auto spannedSize = [](const at::Tensor& t) -> size_t {
+    int64_t span = 1;
+    for (int64_t d = 0; d < t.dim(); d++) {
+      span += (t.size(d) - 1) * t.stride(d);
+    }
+    return span * t.element_size();
+  };
+  // Views which are dense in a slice of the storage, e.g. rows of a matrix,
+  // get a storage of this slice only, which shares the data of the original
+  // storage instead of copying it.
+  auto sliceStorage = [&](const at::Tensor& t) -> at::Tensor {
+    const auto& storage = t.storage();
+    void* data = static_cast<char*>(storage.data()) +
+        t.storage_offset() * t.element_size();
+    c10::Storage slice(
+        c10::Storage::use_byte_size_t(),
+        spannedSize(t),
+        dataPtrInStorage(storage, data),
+        /*allocator=*/nullptr,
+        /*resizable=*/false);
+    return at::empty({0}, t.options())
+        .set_(std::move(slice), /*storage_offset=*/0, t.sizes(), t.strides());
+  };
+  c10::List<at::Tensor> pTensors;
+  pTensors.reserve(tensors.size());
+  for (const auto& t : tensors) {
+    if (!worthRecopying(t)) {
+      pTensors.push_back(t);
+    } else if (
+        t.layout() == at::kStrided && t.numel() > 0 &&
+        spannedSize(t) < t.element_size() * t.numel() * kMinMultiple) {
+      pTensors.push_back(sliceStorage(t));
+    } else {
+      pTensors.push_back(t.clone());
+    }
+  }
+  return pTensors;
+}
+
+std::string wireSerialize(
+    const std::vector<char>& payload,
+    const std::vector<at::Tensor>& tensors) {
+  WireSections sections;
+  collectWireSections(payload, tensors, sections);
+  std::string header = wireHeader(sections);
+
+  // Since tensorData is in function scope, and getWritableTensorData just
+  // record the tensors, the data() pointers stay valid for CPU tensors
+  // Note that RPC serde doesn't support CUDA tensors yet, if we should
+  // support CUDA tensor, we need to be careful since getWritableTensorData
+  // converts CUDA tensor to cpu and data() might get destructed as we go
+  // out of scope of this loop.
+  std::vector<jit::WriteableTensorData> writeableTensorData;
+  size_t tot = header.size();
+  for (const auto& e : sections.entries) {
+    tot += e.size;
+  }
+  for (const auto& t : sections.tensorData) {
+    writeableTensorData.push_back(jit::getWriteableTensorData(t));
+    tot += writeableTensorData.back().sizeInBytes();
+  }
+
+  std::string out;
+  out.reserve(tot);
+  out.append(header);
+  for (const auto& e : sections.entries) {
+    out.append(e.data, e.size);
+  }
+  for (const auto& w : writeableTensorData) {
+    out.append(w.data(), w.sizeInBytes());
+  }
+  return out;
+}
+
+std::pair<std::string, std::vector<at::Tensor>> wireSerializeNoCopy(
+    const std::vector<char>& payload,
+    const std::vector<at::Tensor>& tensors) {
+  WireSections sections;
+  collectWireSections(payload, tensors, sections);
+  std::string out = wireHeader(sections);
+  for (const auto& e : sections.entries) {
+    out.append(e.data, e.size);
+  }
+
+  std::vector<at::Tensor> tensorSections;
+  tensorSections.reserve(sections.tensorData.size());
+  for (const auto& t : sections.tensorData) {
+    tensorSections.push_back(at::empty({0}, at::kChar)
+                                 .set_(
+                                     t.storage(),
+                                     /*storage_offset=*/0,
+                                     {static_cast<int64_t>(t.storage().nbytes())},
+                                     /*stride=*/{1}));
+  }
+  return {std::move(out), std::move(tensorSections)};
+}
+
+std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
+    const void* data,
+    size_t data_size) {
+  auto sections = parseWireSections(data, data_size, /*tensorsInline=*/true);
+  return deserializeWireSections(
+      sections, [&](const std::string& ename) -> at::DataPtr {
+        auto it = sections.find(ename);
+        if (it == sections.end()) {
+          throw std::runtime_error("Couldn't find entity " + ename);
+        }
+        const auto& idat = it->second;
+        auto dptr = at::getCPUAllocator()->allocate(idat.second);
+        if (idat.second != 0) {
+          memcpy(dptr.get(), idat.first, idat.second);
+        }
+        return dptr;
+      });
+}
+
+std::vector<size_t> wireTensorSectionSizes(const void* data, size_t data_size) {
+  auto sections = parseWireSections(data, data_size, /*tensorsInline=*/false);
+  std::vector<size_t> sizes;
+  for (size_t i = 0;; i++) {
+    auto it = sections.find(c10::to_string(i));
+    if (it == sections.end()) {
+      break;
+    }
+    sizes.push_back(it->second.second);
+  }
+  return sizes;
+}
+
+std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserializeNoCopy(
+    const void* data,
+    size_t data_size,
+    const std::vector<at::Tensor>& tensorSections) {
+  auto sections = parseWireSections(data, data_size, /*tensorsInline=*/false);
+  return deserializeWireSections(
+      sections, [&](const std::string& ename) -> at::DataPtr {
+        auto it = sections.find(ename);
+        if (it == sections.end()) {
+          throw std::runtime_error("Couldn't find entity " + ename);
+        }
+        const size_t index = c10::stoll(ename);
+        if (index >= tensorSections.size() ||
+            tensorSections[index].numel() !=
+                static_cast<int64_t>(it->second.second)) {
+          throw std::runtime_error("Mismatched tensor section " + ename);
+        }
+        const auto& section = tensorSections[index];
+        return dataPtrInStorage(section.storage(), section.data_ptr());
+      });
+}
+
 void writeWrappedPayload(
     std::vector<char>& originalPayload,
     std::vector<char>& additionalPayload) {
@@ -54,6 +54,30 @@ TORCH_API std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
     const void* data,
     size_t data_size);
 
+// Like wireSerialize(), but the tensor sections are left out of the returned
+// string, which ends after the payload and the metadata. They are returned as
+// 1-D kChar tensors sharing the storages of the tensors, in order, so that a
+// transport can send them from where they are, as buffers of their own,
+// instead of copying them into the string.
+TORCH_API std::pair<std::string, std::vector<at::Tensor>> wireSerializeNoCopy(
+    const std::vector<char>& payload,
+    const std::vector<at::Tensor>& tensors);
+
+// The sizes in bytes of the tensor sections of a string of
+// wireSerializeNoCopy(), in order, for the receiver to allocate them.
+TORCH_API std::vector<size_t> wireTensorSectionSizes(
+    const void* data,
+    size_t data_size);
+
+// Deserializes a string of wireSerializeNoCopy() and its tensor sections,
+// received as 1-D contiguous kChar tensors. The returned tensors use the
+// memory of the tensor sections, which is not copied.
+TORCH_API std::pair<std::vector<char>, std::vector<at::Tensor>>
+wireDeserializeNoCopy(
+    const void* data,
+    size_t data_size,
+    const std::vector<at::Tensor>& tensorSections);
+
 // We use vector<char> as the type of blobs because it's what rpc::Message uses
 // for its payload, even though it has the disadvantage that it cannot be
 // allocated with uninitialized memory: it is always zeroed out.
@@ -62,7 +86,9 @@ TORCH_API std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
 // subset of the Storage data is referenced. This normally is good and avoids
 // copies when kept locally, but if we naively push the whole Storage over the
 // wire, we'll end up with excess network traffic. This change clones tensors if
-// we'd save at least half the data, and over a minimum hurdle.
+// we'd save at least half the data, and over a minimum hurdle. Views that are
+// dense within a slice of the Storage, e.g. rows of a matrix, get a Storage of
+// that slice instead, which shares the data rather than copying it.
 TORCH_API c10::List<at::Tensor> cloneSparseTensors(
     const std::vector<at::Tensor>& tensors);
 
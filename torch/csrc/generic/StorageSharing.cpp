@@ -410,8 +410,10 @@ static PyObject * THPStorage_(newSharedCuda)(PyObject *_unused, PyObject *args)
 
   auto c = new torch::CudaIPCReceivedData(std::move(basePtr));
   auto sp = std::shared_ptr<void>(
-      (void*)c, [ref_counter_handle, ref_counter_offset, device](void* ptr) {
-        delete static_cast<torch::CudaIPCReceivedData*>(ptr);
+      (void*)c, [s_handle, ref_counter_handle, ref_counter_offset, device](void* ptr) {
+        auto received_data = static_cast<torch::CudaIPCReceivedData*>(ptr);
+        std::shared_ptr<void> segment_ptr = std::move(received_data->shared_ptr_);
+        delete received_data;
         // Sync default stream to make sure all operations related to the storage is
         // finished (otherwise another process may reuse memory and corrupt
         // data)
@@ -426,21 +428,8 @@ static PyObject * THPStorage_(newSharedCuda)(PyObject *_unused, PyObject *args)
         // Callback and release counter inside of it (need to check performance impact)
         cudaStreamSynchronize(c10::cuda::getCurrentCUDAStream(device));
 
-        // We don't want to break existing code, so resource deletion is best
-        // effort basis. Exception expected if producer process terminated
-        // before consumer released data.
-        int flags =
-            TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
-        try {
-          auto sptr = THRefcountedMapAllocator::makeDataPtr(
-              ref_counter_handle.c_str(),
-              flags,
-              sizeof(int64_t) * torch::CUDA_IPC_REF_COUNTER_FILE_SIZE,
-              nullptr);
-          *(static_cast<int64_t*>(sptr.get()) + ref_counter_offset) -= 1;
-        } catch (c10::Error& err) {
-          // Already warned inside of producer process
-        }
+        torch::CudaIPCReturnReceivedData(
+            s_handle, std::move(segment_ptr), ref_counter_handle, ref_counter_offset);
       });
 
   THWStoragePtr base(THWStorage_(newWithDataAndAllocator)(
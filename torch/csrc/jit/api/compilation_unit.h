@@ -98,7 +98,11 @@ struct TORCH_API CompilationUnit {
       // if non-null, the first argument to each def, is bound to this value
       const Self* self,
       // see [name mangling]
-      bool shouldMangle = false);
+      bool shouldMangle = false,
+      // if true, the methods other than __init__ are only compiled on first
+      // use, see GraphFunction::set_lazy. Requires self, which the caller
+      // keeps alive along with the resolvers.
+      bool lazy = false);
 
   void define_hooks(
       const c10::optional<c10::QualifiedName>& prefix,
@@ -54,6 +54,9 @@ IValue GraphFunction::operator()(
 }
 
 void GraphFunction::ensure_defined() {
+  if (lazy_) {
+    define_lazily();
+  }
   if (function_creator_) {
     auto creator = function_creator_;
     function_creator_ = placeholderCreator;
@@ -63,7 +66,42 @@ void GraphFunction::ensure_defined() {
   check_single_output();
 }
 
+void GraphFunction::define_lazily() const {
+  // Lazy functions may be first used from several threads at once. Defining
+  // one can define others and import types into the CompilationUnit they
+  // share, so all of them are defined under one lock.
+  static std::recursive_mutex lazy_definition_mutex;
+  std::lock_guard<std::recursive_mutex> guard(lazy_definition_mutex);
+  // The function may be being defined further up this thread's stack, in
+  // which case to_ir is asking for the graph it emits into.
+  if (!lazy_ || lazy_definition_underway_) {
+    return;
+  }
+  lazy_definition_underway_ = true;
+  auto creator = function_creator_;
+  function_creator_ = placeholderCreator;
+  try {
+    creator(const_cast<GraphFunction&>(*this));
+  } catch (...) {
+    // The graph is left half built, so later uses report the same error
+    // instead of defining the function again.
+    auto error = std::current_exception();
+    function_creator_ = [error](GraphFunction&) {
+      std::rethrow_exception(error);
+    };
+    lazy_definition_underway_ = false;
+    throw;
+  }
+  function_creator_ = nullptr;
+  lazy_definition_underway_ = false;
+  // cleared last, other threads only skip the lock once the graph is done
+  lazy_ = false;
+}
+
 const c10::FunctionSchema& GraphFunction::getSchema() const {
+  if (lazy_) {
+    define_lazily();
+  }
   if (schema_ == nullptr) {
     schema_ = std::make_unique<c10::FunctionSchema>(defaultSchemaFor(*this));
   }
@@ -5,6 +5,8 @@
 #include <torch/csrc/jit/runtime/graph_executor.h>
 #include <torch/csrc/utils/memory.h>
 
+#include <atomic>
+
 namespace torch {
 namespace jit {
 
@@ -33,6 +35,9 @@ struct TORCH_API GraphFunction : public Function {
       override;
 
   std::shared_ptr<Graph> graph() const override {
+    if (lazy_) {
+      define_lazily();
+    }
     return graph_;
   }
 
@@ -41,7 +46,7 @@ struct TORCH_API GraphFunction : public Function {
     if (optimized_graph_) {
       return *optimized_graph_;
     }
-    optimized_graph_ = graph_->copy();
+    optimized_graph_ = graph()->copy();
     if (getGraphExecutorOptimize()) {
       preoptimizeGraph(*optimized_graph_);
     }
@@ -67,6 +72,16 @@ struct TORCH_API GraphFunction : public Function {
   // if this isn't yet defined, run its method_creator function
   void ensure_defined() override;
 
+  // Defers running the function_creator until the function is first used,
+  // i.e. until its graph, schema or executor is requested. The caller has to
+  // keep everything the creator refers to alive until then. Does nothing if
+  // the function is already defined.
+  void set_lazy() {
+    if (function_creator_) {
+      lazy_ = true;
+    }
+  }
+
   size_t num_inputs() const override {
     return graph()->inputs().size();
   }
@@ -114,6 +129,8 @@ struct TORCH_API GraphFunction : public Function {
   }
 
  private:
+  void define_lazily() const;
+
   c10::QualifiedName name_;
   // The original, non-optimized graph
   std::shared_ptr<Graph> graph_; // for debugging and for inlining
@@ -135,7 +152,13 @@ struct TORCH_API GraphFunction : public Function {
   // an optional function that actually creates the method when
   // ensure_defined() is called. This is used by the compiler so
   // that it can construct methods out of order
-  std::function<void(GraphFunction&)> function_creator_;
+  // mutable because a lazy function is defined when its graph is requested
+  mutable std::function<void(GraphFunction&)> function_creator_;
+
+  // set while the function_creator has been deferred until first use
+  mutable std::atomic<bool> lazy_{false};
+  // guarded by the lock of define_lazily
+  mutable bool lazy_definition_underway_ = false;
 
   // if absent, then we generate a default schema based on the graph
   // mutable because getSchema caches the default schema if one is requested
@@ -8,6 +8,7 @@
 #include <torch/csrc/jit/codegen/cuda/executor.h>
 
 #include <ATen/core/LegacyTypeDispatch.h>
+#include <ATen/record_function.h>
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/Exceptions.h>
 #include <ATen/cuda/nvrtc_stub/ATenNVRTC.h>
@@ -97,6 +98,8 @@ void FusionExecutor::debugCompileFusionFromStr(
 
 void FusionExecutor::compileFusion(Fusion* fusion, CompileOptions options) {
   FUSER_PERF_SCOPE("compileFusion");
+  // Shows the number and the duration of the compilations in the profiler
+  RECORD_FUNCTION("CudaFusionCompile", std::vector<c10::IValue>());
 
   TORCH_INTERNAL_ASSERT(
       !fusion->outputs().empty(), "No output found for this kernel, aborting.");
@@ -7,6 +7,7 @@
 #include <torch/csrc/jit/codegen/cuda/executor_utils.h>
 #include <torch/csrc/jit/codegen/cuda/instrumentation.h>
 #include <torch/csrc/jit/codegen/cuda/ir_all_nodes.h>
+#include <torch/csrc/jit/codegen/fuser/binary_cache.h>
 #include <torch/csrc/jit/codegen/fuser/cuda/fused_kernel.h>
 #include <torch/csrc/jit/resource_guard.h>
 
@@ -265,20 +266,6 @@ NvrtcFunction nvrtcCompile(
   bool compile_to_sass = false;
   codegenOutputQuery(prop, major, minor, compile_to_sass);
 
-  nvrtcProgram program; // NOLINT(cppcoreguidelines-init-variables)
-
-  {
-    FUSER_PERF_SCOPE("nvrtcCreateProgram");
-    AT_CUDA_NVRTC_CHECK(at::globalContext().getNVRTC().nvrtcCreateProgram(
-        &program, code.c_str(), nullptr, 0, nullptr, nullptr));
-  }
-
-  ResourceGuard holdProgram([&] {
-    FUSER_PERF_SCOPE("nvrtcDestroyProgram");
-    AT_CUDA_NVRTC_CHECK(
-        at::globalContext().getNVRTC().nvrtcDestroyProgram(&program));
-  });
-
 #ifdef __HIP_PLATFORM_HCC__
   std::vector<const char*> args = {"--std=c++14"};
 #else
@@ -326,54 +313,81 @@ NvrtcFunction nvrtcCompile(
     }
   }
 
-  at::globalContext().getNVRTC().nvrtcAddNameExpression(
-      program, func_name.c_str());
+  // See Note [Fuser kernel binary cache]
+  const auto cache_key =
+      kernelBinaryCacheKey(code, args, major, minor, compile_to_sass);
+  std::vector<char> ptx;
+  std::string lowered_kernel_name;
+  if (auto cached = fuser::loadKernelBinary(cache_key)) {
+    ptx = std::move(cached->image);
+    lowered_kernel_name = std::move(cached->function_name);
+  } else {
+    nvrtcProgram program; // NOLINT(cppcoreguidelines-init-variables)
 
-  {
-    FUSER_PERF_SCOPE("nvrtcCompileProgram");
+    {
+      FUSER_PERF_SCOPE("nvrtcCreateProgram");
+      AT_CUDA_NVRTC_CHECK(at::globalContext().getNVRTC().nvrtcCreateProgram(
+          &program, code.c_str(), nullptr, 0, nullptr, nullptr));
+    }
 
-    const auto result = at::globalContext().getNVRTC().nvrtcCompileProgram(
-        program, args.size(), args.data());
+    ResourceGuard holdProgram([&] {
+      FUSER_PERF_SCOPE("nvrtcDestroyProgram");
+      AT_CUDA_NVRTC_CHECK(
+          at::globalContext().getNVRTC().nvrtcDestroyProgram(&program));
+    });
 
-    if (result != NVRTC_SUCCESS) {
-      size_t logsize;
-      at::globalContext().getNVRTC().nvrtcGetProgramLogSize(program, &logsize);
-      std::vector<char> log(logsize);
-      at::globalContext().getNVRTC().nvrtcGetProgramLog(program, log.data());
+    at::globalContext().getNVRTC().nvrtcAddNameExpression(
+        program, func_name.c_str());
 
-      TORCH_INTERNAL_ASSERT(
-          false, code.c_str(), "\nCUDA NVRTC compile error: ", log.data());
-    }
+    {
+      FUSER_PERF_SCOPE("nvrtcCompileProgram");
 
-    AT_CUDA_NVRTC_CHECK(result);
-  }
+      const auto result = at::globalContext().getNVRTC().nvrtcCompileProgram(
+          program, args.size(), args.data());
 
-  const char* lowered_kernel_name = nullptr;
-  at::globalContext().getNVRTC().nvrtcGetLoweredName(
-      program, func_name.c_str(), &lowered_kernel_name);
+      if (result != NVRTC_SUCCESS) {
+        size_t logsize;
+        at::globalContext().getNVRTC().nvrtcGetProgramLogSize(
+            program, &logsize);
+        std::vector<char> log(logsize);
+        at::globalContext().getNVRTC().nvrtcGetProgramLog(program, log.data());
 
-  size_t ptx_size = 0;
-  std::vector<char> ptx;
+        TORCH_INTERNAL_ASSERT(
+            false, code.c_str(), "\nCUDA NVRTC compile error: ", log.data());
+      }
+
+      AT_CUDA_NVRTC_CHECK(result);
+    }
+
+    const char* lowered_name = nullptr;
+    at::globalContext().getNVRTC().nvrtcGetLoweredName(
+        program, func_name.c_str(), &lowered_name);
+    lowered_kernel_name = lowered_name;
 
-  {
-    FUSER_PERF_SCOPE("get PTX");
+    {
+      FUSER_PERF_SCOPE("get PTX");
 #if CUDA_VERSION >= 11010
-    // compile_to_sass determines whether we are generating SASS or PTX, hence
-    // the different API.
-    const auto getSize = compile_to_sass
-        ? at::globalContext().getNVRTC().nvrtcGetCUBINSize
-        : at::globalContext().getNVRTC().nvrtcGetPTXSize;
-    const auto getFunc = compile_to_sass
-        ? at::globalContext().getNVRTC().nvrtcGetCUBIN
-        : at::globalContext().getNVRTC().nvrtcGetPTX;
+      // compile_to_sass determines whether we are generating SASS or PTX,
+      // hence the different API.
+      const auto getSize = compile_to_sass
+          ? at::globalContext().getNVRTC().nvrtcGetCUBINSize
+          : at::globalContext().getNVRTC().nvrtcGetPTXSize;
+      const auto getFunc = compile_to_sass
+          ? at::globalContext().getNVRTC().nvrtcGetCUBIN
+          : at::globalContext().getNVRTC().nvrtcGetPTX;
 #else
-    const auto getSize = at::globalContext().getNVRTC().nvrtcGetPTXSize;
-    const auto getFunc = at::globalContext().getNVRTC().nvrtcGetPTX;
+      const auto getSize = at::globalContext().getNVRTC().nvrtcGetPTXSize;
+      const auto getFunc = at::globalContext().getNVRTC().nvrtcGetPTX;
 #endif
-    AT_CUDA_NVRTC_CHECK(getSize(program, &ptx_size));
-    ptx.resize(ptx_size);
-    AT_CUDA_NVRTC_CHECK(getFunc(program, ptx.data()));
+      size_t ptx_size = 0;
+      AT_CUDA_NVRTC_CHECK(getSize(program, &ptx_size));
+      ptx.resize(ptx_size);
+      AT_CUDA_NVRTC_CHECK(getFunc(program, ptx.data()));
+    }
+
+    fuser::storeKernelBinary(cache_key, {ptx, lowered_kernel_name});
   }
+  const size_t ptx_size = ptx.size();
 
   NvrtcFunction compiled_kernel_;
 
@@ -452,7 +466,7 @@ NvrtcFunction nvrtcCompile(
   AT_CUDA_DRIVER_CHECK(at::globalContext().getNVRTC().cuModuleGetFunction(
       &(compiled_kernel_.function),
       compiled_kernel_.module,
-      lowered_kernel_name));
+      lowered_kernel_name.c_str()));
 
   return compiled_kernel_;
 }
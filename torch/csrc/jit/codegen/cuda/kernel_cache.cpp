@@ -33,6 +33,26 @@ int getCommonDeviceCUDA(const at::ArrayRef<IValue>& inputs) {
   return index;
 }
 
+// Returns the tensors of the fusion with a reduction, asserting there's one
+std::vector<TensorView*> findReductionTensors(Fusion* fusion) {
+  // Use dependency check to find the reduction tvs as it returns used values
+  // instead of exprs.
+  auto used_vals = DependencyCheck::getAllValsBetween(
+      {fusion->inputs().begin(), fusion->inputs().end()}, fusion->outputs());
+
+  std::vector<TensorView*> reduction_tvs;
+  for (auto tv : ir_utils::filterByType<TensorView>(used_vals)) {
+    if (tv->hasReduction()) {
+      reduction_tvs.push_back(tv);
+    }
+  }
+
+  TORCH_INTERNAL_ASSERT(
+      !reduction_tvs.empty(),
+      "Could not find the reduction tensor view in the fusion.");
+  return reduction_tvs;
+}
+
 // TODO: temporary hack to resolve my is_constructible issue;
 std::vector<size_t> toVector(const at::DimVector& small_vec) {
   return std::vector<size_t>(small_vec.begin(), small_vec.end());
@@ -290,39 +310,23 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
       // Grab the fusion to analyze for heuristics
       FusionGuard fg(fusion_.get());
 
-      TensorView* reduction_tv = nullptr;
-      // Use dependency check to find the reduction tv as it returns used values
-      // instead of exprs.
-
       // The call is relatively heavy weight, consider caching
-      auto used_vals = DependencyCheck::getAllValsBetween(
-          {fusion_->inputs().begin(), fusion_->inputs().end()},
-          fusion_->outputs());
-
-      // Find the reduction tensor view, make sure there's only one
-      for (auto val : used_vals) {
-        if (val->getValType().value() == ValType::TensorView) {
-          auto tv = val->as<TensorView>();
-          if (tv->hasReduction()) {
-            TORCH_INTERNAL_ASSERT(
-                reduction_tv == nullptr,
-                "Already found a reduction tensorview, cannot handle fusion of multiple reductions.");
-            reduction_tv = tv;
-          }
-        }
-      }
+      auto reduction_tvs = findReductionTensors(fusion_.get());
 
-      TORCH_INTERNAL_ASSERT(
-          reduction_tv != nullptr,
-          "Could not find the reduction tensor view in the fusion.");
+      // Several reductions make a normalization, which keeps its rows on chip
+      // across the reductions
+      const bool is_normalization = reduction_tvs.size() > 1;
 
       // Generate the reduction parameters
-      auto reduction_params =
-          getReductionHeuristics(fusion_.get(), inputs, reduction_tv);
+      auto reduction_params = is_normalization
+          ? getNormalizationHeuristics(fusion_.get(), inputs, reduction_tvs)
+          : getReductionHeuristics(fusion_.get(), inputs, reduction_tvs[0]);
 
       TORCH_INTERNAL_ASSERT(
           reduction_params.has_value(),
-          "Error getting reduction heuristics for scheduling.");
+          is_normalization
+              ? "Cannot schedule fusion of multiple reductions, they must reduce the same innermost dimensions and their rows must fit in shared memory."
+              : "Error getting reduction heuristics for scheduling.");
 
       launch_params = reduction_params.value().lparams;
 
@@ -336,42 +340,30 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
         FusionGuard fg(&fusion);
 
         // Heavy weight call
-        auto used_vals = DependencyCheck::getAllValsBetween(
-            {fusion.inputs().begin(), fusion.inputs().end()}, fusion.outputs());
-
-        TensorView* reduction_tv = nullptr;
-
-        for (auto val : used_vals) {
-          if (val->getValType().value() == ValType::TensorView) {
-            auto tv = val->as<TensorView>();
-            if (tv->hasReduction()) {
-              TORCH_INTERNAL_ASSERT(
-                  reduction_tv == nullptr,
-                  "Already found a reduction tensorview, cannot handle fusion of multiple reductions.");
-              reduction_tv = tv;
-            }
-          }
-        }
+        auto reduction_tvs = findReductionTensors(&fusion);
 
-        TORCH_INTERNAL_ASSERT(
-            reduction_tv != nullptr,
-            "Could not find the reduction tensor view in the fusion.");
+        if (reduction_params.value().persistent_kernel) {
+          scheduleNormalization(
+              &fusion, reduction_params.value(), reduction_tvs);
+        } else {
+          auto reduction_tv = reduction_tvs[0];
 
-        // Heavy weight call
-        auto outputsOfReduction =
-            DependencyCheck::getAllOutputsOf({reduction_tv});
+          // Heavy weight call
+          auto outputsOfReduction =
+              DependencyCheck::getAllOutputsOf({reduction_tv});
 
-        auto tv_entries =
-            ir_utils::filterByType<TensorView>(outputsOfReduction);
+          auto tv_entries =
+              ir_utils::filterByType<TensorView>(outputsOfReduction);
 
-        std::vector<TensorView*> tvOutputsOfReduction(
-            tv_entries.begin(), tv_entries.end());
+          std::vector<TensorView*> tvOutputsOfReduction(
+              tv_entries.begin(), tv_entries.end());
 
-        scheduleReduction(
-            &fusion,
-            reduction_params.value(),
-            reduction_tv,
-            tvOutputsOfReduction);
+          scheduleReduction(
+              &fusion,
+              reduction_params.value(),
+              reduction_tv,
+              tvOutputsOfReduction);
+        }
 
         // This means we have not found a previously generated kernel that's
         // compatible with the new reduction params. We need to finish codegen.
@@ -405,6 +397,23 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
       inputs, launch_params, unique_id);
 }
 
+size_t FusionExecutorCache::compiledKernelCount() const {
+  size_t count = 0;
+  for (const auto& device_executor : pw_fusion_executor_cache_) {
+    if (device_executor.second->compiled()) {
+      count++;
+    }
+  }
+  for (const auto& device_executors : red_fusion_executor_cache_) {
+    for (const auto& params_executor : device_executors.second) {
+      if (params_executor.second.compiled()) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
 bool GraphCache::requiresPermutation() {
   const size_t input_rank = input_permutation_.size();
   for (size_t i = 0; i < input_rank; i++) {
@@ -121,6 +121,14 @@ class TORCH_CUDA_CU_API InputsIdLookup {
 //!     c) broadcasting semantics (size-1 or not);
 //!     d) rank;
 //!     e) scalar type;
+//!
+//! * note on dynamic shape
+//! Kernels are generated for symbolic sizes, and their launch parameters are
+//! computed from the extents of the inputs at runtime, so a new input shape
+//! only compiles a new kernel when it changes the schedule the heuristics pick
+//! (`ReductionParams` without its launch parameters). The heuristics work on
+//! sizes rounded up to a power of 2, so close shapes share their schedule. Each
+//! compilation shows as a `CudaFusionCompile` event in the profiler.
 
 class FusionExecutorCache {
  public:
@@ -133,6 +141,9 @@ class FusionExecutorCache {
   std::vector<at::Tensor> runFusionWithInputs(
       const at::ArrayRef<IValue>& inputs);
 
+  //! debugging API that returns the number of kernels compiled so far
+  size_t compiledKernelCount() const;
+
  private:
   //! evict cached short cut entry in `code_to_fe_lookup_` as well as cached
   //! entry in `FusionExecutor`
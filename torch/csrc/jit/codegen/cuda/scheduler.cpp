@@ -11,6 +11,8 @@
 
 #include <ATen/cuda/CUDAContext.h>
 
+#include <algorithm>
+
 namespace torch {
 namespace jit {
 namespace fuser {
@@ -142,6 +144,19 @@ constexpr int lastPow2(int n) {
   return std::max(1, n - (n >> 1));
 }
 
+// Sizes go through the heuristics rounded up to a power of 2, so that all the
+// shapes of a bucket, e.g. varying sequence lengths, get the same parameters
+// and share a kernel, instead of flipping between schedules as the sizes
+// cross the thresholds of the heuristics. The kernels are generated for
+// symbolic sizes, so the parameters of a bucket are valid for all its sizes.
+int64_t heuristicBucket(int64_t n) {
+  int64_t bucket = 1;
+  while (bucket < n) {
+    bucket <<= 1;
+  }
+  return bucket;
+}
+
 ReductionParams reductionHeuristic(
     int red_elems,
     int red_outputs,
@@ -337,7 +352,10 @@ TORCH_CUDA_CU_API c10::optional<ReductionParams> getReductionHeuristics(
     }
   }
 
-  return reductionHeuristic(red_elements, red_outputs, red_on_fastest_dim);
+  return reductionHeuristic(
+      heuristicBucket(red_elements),
+      heuristicBucket(red_outputs),
+      red_on_fastest_dim);
 }
 
 // fusion is the input IR that will be modified by this function
@@ -678,6 +696,285 @@ void scheduleReduction(
   }
 }
 
+
+namespace {
+
+// Tensors of the fusion in topological order, starting with its inputs
+std::vector<TensorView*> allTensorsInOrder(Fusion* fusion) {
+  std::vector<TensorView*> tvs;
+  for (auto input : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    tvs.push_back(input);
+  }
+  for (auto expr : fusion->exprs(true)) {
+    for (auto output : ir_utils::filterByType<TensorView>(expr->outputs())) {
+      tvs.push_back(output);
+    }
+  }
+  return tvs;
+}
+
+// Returns the number of the outer (non-normalized) dimensions if all the
+// reductions of the fusion reduce the same innermost dimensions of tensors of
+// the same rank. The other tensors, but the inputs, must have either that rank
+// or the rank of the outer dimensions, like the results of the reductions
+// before they're broadcast back.
+c10::optional<size_t> normalizationOuterDims(
+    Fusion* fusion,
+    const std::vector<TensorView*>& reduction_tvs) {
+  if (reduction_tvs.empty()) {
+    return c10::nullopt;
+  }
+  const auto& first_root = reduction_tvs[0]->getRootDomain();
+  const size_t n_dims = first_root.size();
+  size_t n_outer = 0;
+  while (n_outer < n_dims && !first_root[n_outer]->isReduction()) {
+    n_outer++;
+  }
+  if (n_outer == 0 || n_outer == n_dims) {
+    return c10::nullopt;
+  }
+
+  for (auto tv : allTensorsInOrder(fusion)) {
+    const auto& root = tv->getRootDomain();
+    if (fusion->hasInput(tv)) {
+      continue;
+    }
+    if (root.size() != n_dims && root.size() != n_outer) {
+      return c10::nullopt;
+    }
+    const bool is_reduction = std::find(
+                                  reduction_tvs.begin(),
+                                  reduction_tvs.end(),
+                                  tv) != reduction_tvs.end();
+    for (size_t i = 0; i < root.size(); i++) {
+      if (root[i]->isReduction() != (is_reduction && i >= n_outer)) {
+        return c10::nullopt;
+      }
+    }
+  }
+  return n_outer;
+}
+
+// Whether the tensor has a value for every element of its rows, as opposed to
+// the reductions and the per row values broadcast back to the rows
+bool holdsRows(TensorView* tv, size_t n_outer, size_t n_dims) {
+  const auto& root = tv->getRootDomain();
+  return root.size() == n_dims &&
+      std::none_of(root.begin() + n_outer, root.end(), [](IterDomain* id) {
+           return id->isReduction() || id->isBroadcast();
+         });
+}
+
+// Tensors holding rows which are read by several exprs. They are kept in
+// shared memory, rather than read again from global memory (inputs) or
+// recomputed (intermediates).
+std::vector<TensorView*> persistentTensors(
+    Fusion* fusion,
+    size_t n_outer,
+    size_t n_dims) {
+  std::vector<TensorView*> persistent_tvs;
+  for (auto tv : allTensorsInOrder(fusion)) {
+    if (holdsRows(tv, n_outer, n_dims) && !fusion->hasOutput(tv) &&
+        fusion->unordered_uses(tv).size() > 1) {
+      persistent_tvs.push_back(tv);
+    }
+  }
+  return persistent_tvs;
+}
+
+ReductionParams normalizationHeuristic(int red_elems, int red_outputs) {
+  ReductionParams rparams;
+  rparams.fastest_dim = true;
+  rparams.cross_block = true;
+  rparams.persistent_kernel = true;
+  rparams.loop_unroll = 1;
+
+  TORCH_INTERNAL_ASSERT(red_elems > 0 && red_outputs > 0);
+
+  // A block per row, each thread handling a few elements of it at every stage
+  constexpr int kMaxNumThreads = 512;
+  constexpr int kMinValuesPerThread = 4;
+  const int device_warp_size = at::cuda::warp_size();
+
+  int bdimx = lastPow2(ceilDiv(red_elems, kMinValuesPerThread));
+  bdimx = std::max(std::min(bdimx, kMaxNumThreads), device_warp_size);
+
+  const char* debug_env = getenv("PYTORCH_CUDA_FUSER_RED_SCHED_DEBUG");
+  if (debug_env && atoi(debug_env)) {
+    std::cout << "\n===== Normalization Parameters ========" << std::endl
+              << "Inputs:" << std::endl
+              << "\tRed Elems: " << red_elems << " Red Outputs: " << red_outputs
+              << std::endl
+              << "Recommended Blocking:" << std::endl
+              << "\tGridX: " << red_outputs << " BlckX: " << bdimx << std::endl
+              << "====================================" << std::endl;
+  }
+
+  rparams.lparams = LaunchParams(
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL,
+      bdimx,
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL);
+  return rparams;
+}
+
+} // namespace
+
+TORCH_CUDA_CU_API c10::optional<ReductionParams> getNormalizationHeuristics(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& fusion_inputs,
+    const std::vector<TensorView*>& reduction_tvs) {
+  FUSER_PERF_SCOPE("getNormalizationHeuristics");
+
+  FusionGuard fg(fusion);
+
+  const auto n_outer = normalizationOuterDims(fusion, reduction_tvs);
+  if (!n_outer.has_value()) {
+    return c10::nullopt;
+  }
+
+  StatefulExpressionEvaluator evaluator(
+      executor_utils::statefulBindInputs(fusion_inputs, fusion));
+
+  int64_t red_outputs = 1;
+  int64_t red_elements = 1;
+
+  const auto& red_root_dom = reduction_tvs[0]->getRootDomain();
+  for (auto id : red_root_dom) {
+    auto inferred_val = evaluator.inferValue(id->rawExtent());
+    TORCH_INTERNAL_ASSERT(
+        inferred_val.has_value(), "Error inferring reduction size.");
+    if (id->isReduction()) {
+      red_elements *= inferred_val.value();
+    } else {
+      red_outputs *= inferred_val.value();
+    }
+  }
+
+  // The persistent rows and the workspace of the block reductions have to fit
+  // in the shared memory of a block
+  constexpr int64_t kReductionWorkspaceSize = 512 * sizeof(double);
+  int64_t smem_size = kReductionWorkspaceSize;
+  for (auto tv :
+       persistentTensors(fusion, n_outer.value(), red_root_dom.size())) {
+    smem_size += red_elements * dataTypeSize(tv->getDataType().value());
+  }
+  if (smem_size >
+      static_cast<int64_t>(
+          at::cuda::getCurrentDeviceProperties()->sharedMemPerBlock)) {
+    return c10::nullopt;
+  }
+
+  return normalizationHeuristic(
+      heuristicBucket(red_elements), heuristicBucket(red_outputs));
+}
+
+// Generalizes the persistent softmax of the tests to any number of reductions
+// over the normalized dimensions. Every tensor is viewed as
+//   [outer, normalized / TIDx, TIDx]
+// and computed at the outer axis, parallelized by BIDx, so that a block goes
+// through all the stages of its row. Within a row, the reductions are block
+// reductions over TIDx, and the values computed per row between a reduction
+// and its broadcast are computed by every thread of the block. The rows used
+// by a single expr are inlined in it, and the others are kept in shared
+// memory.
+void scheduleNormalization(
+    Fusion* fusion,
+    const ReductionParams& rparams,
+    const std::vector<TensorView*>& reduction_tvs) {
+  FUSER_PERF_SCOPE("scheduleNormalization");
+
+  FusionGuard fg(fusion);
+
+  TORCH_INTERNAL_ASSERT(
+      rparams.persistent_kernel,
+      "scheduleNormalization requires persistent kernel parameters.");
+  const auto n_outer_opt = normalizationOuterDims(fusion, reduction_tvs);
+  TORCH_INTERNAL_ASSERT(
+      n_outer_opt.has_value(),
+      "Reductions of a normalization must reduce the same innermost dimensions.");
+  const int n_outer = static_cast<int>(n_outer_opt.value());
+  const int n_dims = static_cast<int>(reduction_tvs[0]->getRootDomain().size());
+
+  // Read the inputs used by several stages once, into shared memory
+  for (auto tv : persistentTensors(fusion, n_outer, n_dims)) {
+    if (fusion->hasInput(tv)) {
+      tv = tv->cache_after();
+    }
+    tv->setMemoryType(MemoryType::Shared);
+  }
+
+  const auto all_tvs = allTensorsInOrder(fusion);
+  for (auto tv : all_tvs) {
+    const int tv_dims = static_cast<int>(tv->nDims());
+    if (tv_dims == n_dims) {
+      // [outer dims, normalized dims] -> [outer, normalized]
+      for (int i = n_dims - 1; i > n_outer; i--) {
+        tv->merge(i - 1);
+      }
+      for (int i = n_outer - 1; i > 0; i--) {
+        tv->merge(i - 1);
+      }
+      // [outer, normalized / TIDx, TIDx]
+      tv->split(1, NamedScalar::getParallelDim(ParallelType::TIDx));
+    } else if (tv_dims == n_outer && !fusion->hasInput(tv)) {
+      // Per row values, computed by every thread of the block
+      for (int i = n_outer - 1; i > 0; i--) {
+        tv->merge(i - 1);
+      }
+    }
+    // Other inputs, like the weights of layer_norm, are only read through
+    // broadcasts
+  }
+
+  std::vector<TensorView*> rf_tvs;
+  for (auto red_tv : reduction_tvs) {
+    rf_tvs.push_back(red_tv->rFactor({1}));
+  }
+
+  // A block per row
+  for (auto output : ir_utils::filterByType<TensorView>(fusion->outputs())) {
+    for (auto input : fusion->inputsOf(output)) {
+      if (input->getValType().value() == ValType::TensorView) {
+        input->as<TensorView>()->computeAt(output, 1);
+      }
+    }
+  }
+
+  // Inline the other rows in their only consumer, at the serial axis of the
+  // row, so that they're never allocated
+  for (auto tv : all_tvs) {
+    if (fusion->hasInput(tv) || fusion->hasOutput(tv) ||
+        tv->getMemoryType() == MemoryType::Shared ||
+        !holdsRows(tv, n_outer, n_dims)) {
+      continue;
+    }
+    const auto uses = fusion->unordered_uses(tv);
+    TORCH_INTERNAL_ASSERT(uses.size() == 1);
+    auto consumers =
+        ir_utils::filterByType<TensorView>((*uses.begin())->outputs());
+    if (consumers.begin() != consumers.end()) {
+      tv->computeAt(*consumers.begin(), 2);
+    }
+  }
+
+  for (auto tv : all_tvs) {
+    if (fusion->hasInput(tv)) {
+      continue;
+    }
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    if (static_cast<int>(tv->getRootDomain().size()) == n_dims) {
+      tv->axis(-1)->parallelize(ParallelType::TIDx);
+    }
+  }
+  for (auto rf_tv : rf_tvs) {
+    rf_tv->axis(0)->parallelize(ParallelType::BIDx);
+    rf_tv->axis(-1)->parallelize(ParallelType::TIDx);
+  }
+}
+
 } // namespace cuda
 } // namespace fuser
 } // namespace jit
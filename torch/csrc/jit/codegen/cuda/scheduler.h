@@ -30,6 +30,9 @@ struct ReductionParams {
   bool mul_reds_per_blk = false;
   // Unrolling factor
   int loop_unroll = 4;
+  // Keep the rows on chip across several reductions (see
+  // scheduleNormalization)?
+  bool persistent_kernel = false;
 
   LaunchParams lparams;
 
@@ -38,7 +41,8 @@ struct ReductionParams {
     bool attr_equal = other.fastest_dim == fastest_dim &&
         other.cross_block == cross_block && other.cross_grid == cross_grid &&
         other.mul_reds_per_blk == mul_reds_per_blk &&
-        other.loop_unroll == loop_unroll;
+        other.loop_unroll == loop_unroll &&
+        other.persistent_kernel == persistent_kernel;
     return attr_equal;
   }
 };
@@ -51,7 +55,8 @@ class ReductionParamsHash {
     size_t attr_hash = static_cast<size_t>(rp.fastest_dim) << (bits - 1) |
         static_cast<size_t>(rp.cross_block) << (bits - 2) |
         static_cast<size_t>(rp.cross_grid) << (bits - 3) |
-        static_cast<size_t>(rp.mul_reds_per_blk) << (bits - 4);
+        static_cast<size_t>(rp.mul_reds_per_blk) << (bits - 4) |
+        static_cast<size_t>(rp.persistent_kernel) << (bits - 5);
     return attr_hash;
   }
 };
@@ -67,6 +72,22 @@ TORCH_CUDA_CU_API void scheduleReduction(
     TensorView* red_tv,
     std::vector<TensorView*> outs_of_red);
 
+// Heuristics of a normalization, i.e. a fusion of several reductions over the
+// same innermost dimensions with the pointwise ops between them, like
+// softmax or layer_norm. Returns nullopt when the fusion can't be scheduled
+// as a single persistent kernel, e.g. when its rows don't fit in shared memory.
+TORCH_CUDA_CU_API c10::optional<ReductionParams> getNormalizationHeuristics(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& fusion_inputs,
+    const std::vector<TensorView*>& reduction_tvs);
+
+// Schedules a normalization with one block per row, which reads its row once
+// and keeps the tensors used by several stages in shared memory.
+TORCH_CUDA_CU_API void scheduleNormalization(
+    Fusion* fusion,
+    const ReductionParams& rparams,
+    const std::vector<TensorView*>& reduction_tvs);
+
 } // namespace cuda
 } // namespace fuser
 } // namespace jit
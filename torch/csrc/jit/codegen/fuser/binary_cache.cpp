@@ -0,0 +1,330 @@
+#include <torch/csrc/jit/codegen/fuser/binary_cache.h>
+
+#include <c10/util/Exception.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+
+// Note [Fuser kernel binary cache]
+// NVRTC takes from tens of milliseconds to seconds to compile a fused kernel,
+// and every process running a model compiles the same kernels again. When
+// getKernelBinaryCacheDir() is set, the CUBIN or PTX of every kernel compiled
+// is written to a file of that directory, and any later process compiling the
+// same kernel loads the file instead.
+//
+// The key of a kernel is its source, the options it's compiled with, the
+// compute capability and whether it's compiled to SASS or PTX, and the NVRTC
+// version. The name of a file is a hash of the key, and the file starts with
+// the key itself, which is compared on load so that a collision is a miss.
+// Files are written to a temporary name and renamed, so that processes sharing
+// the directory never read a file being written.
+//
+// The entries a process used can be listed in a manifest, which another
+// process preloads when loading the model, so that its first runs don't wait
+// for the reads either.
+namespace {
+
+struct CachedBinary {
+  std::string key;
+  KernelBinary binary;
+};
+
+struct BinaryCacheImpl {
+  std::mutex mutex_;
+  // Map of entry file name to the entries read by preloadKernelBinaries
+  std::unordered_map<std::string, CachedBinary> preloaded_;
+  // Names of the entries loaded or stored by this process
+  std::set<std::string> used_;
+};
+
+BinaryCacheImpl& getBinaryCache() {
+  static BinaryCacheImpl cache;
+  return cache;
+}
+
+// A hash which is the same in every process and build, as opposed to
+// std::hash (64-bit FNV-1a)
+uint64_t stableHash(const std::string& s) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const char c : s) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+std::string entryName(const std::string& key) {
+  std::ostringstream name;
+  name << "fuser_kernel_" << std::hex << stableHash(key) << ".bin";
+  return name.str();
+}
+
+std::string launchConfigEntryName(const std::string& key) {
+  std::ostringstream name;
+  name << "fuser_launch_" << std::hex << stableHash(key) << ".txt";
+  return name.str();
+}
+
+std::string entryPath(const std::string& dir, const std::string& name) {
+  return dir + "/" + name;
+}
+
+// An entry is the key, the function name and the image, the first two ending
+// with a NUL
+c10::optional<CachedBinary> readEntry(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return c10::nullopt;
+  }
+  const std::string contents(
+      (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  const auto key_end = contents.find('\0');
+  if (key_end == std::string::npos) {
+    return c10::nullopt;
+  }
+  const auto name_end = contents.find('\0', key_end + 1);
+  if (name_end == std::string::npos) {
+    return c10::nullopt;
+  }
+  CachedBinary entry;
+  entry.key = contents.substr(0, key_end);
+  entry.binary.function_name =
+      contents.substr(key_end + 1, name_end - key_end - 1);
+  entry.binary.image.assign(contents.begin() + name_end + 1, contents.end());
+  return entry;
+}
+
+bool writeFileAtomically(const std::string& path, const std::string& contents) {
+  const std::string tmp_path =
+      path + ".tmp" + std::to_string(std::random_device()());
+  {
+    std::ofstream file(tmp_path, std::ios::binary);
+    file.write(contents.data(), contents.size());
+    if (!file) {
+      file.close();
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+  // Another process may have stored the same entry meanwhile, either file is
+  // fine.
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+std::string kernelBinaryKey(
+    const std::string& code,
+    const std::vector<const char*>& compile_args,
+    int compute_major,
+    int compute_minor,
+    bool compile_to_sass,
+    int nvrtc_major,
+    int nvrtc_minor) {
+  std::ostringstream key;
+  key << "nvrtc " << nvrtc_major << "." << nvrtc_minor << "\n";
+  key << (compile_to_sass ? "sm_" : "compute_") << compute_major
+      << compute_minor << "\n";
+  for (const char* arg : compile_args) {
+    key << arg << "\n";
+  }
+  key << code;
+  return key.str();
+}
+
+std::string& getKernelBinaryCacheDir() {
+  static std::string cache_dir = []() -> std::string {
+    const char* dir = std::getenv("PYTORCH_FUSER_KERNEL_CACHE_DIR");
+    return dir ? dir : "";
+  }();
+  return cache_dir;
+}
+
+c10::optional<KernelBinary> loadKernelBinary(const std::string& key) {
+  const std::string& dir = getKernelBinaryCacheDir();
+  if (dir.empty()) {
+    return c10::nullopt;
+  }
+  const auto name = entryName(key);
+  auto& cache = getBinaryCache();
+  {
+    std::lock_guard<std::mutex> guard{cache.mutex_};
+    auto it = cache.preloaded_.find(name);
+    if (it != cache.preloaded_.end() && it->second.key == key) {
+      cache.used_.insert(name);
+      return it->second.binary;
+    }
+  }
+  auto entry = readEntry(entryPath(dir, name));
+  if (!entry || entry->key != key) {
+    return c10::nullopt;
+  }
+  std::lock_guard<std::mutex> guard{cache.mutex_};
+  cache.used_.insert(name);
+  return std::move(entry->binary);
+}
+
+void storeKernelBinary(const std::string& key, const KernelBinary& binary) {
+  const std::string& dir = getKernelBinaryCacheDir();
+  if (dir.empty()) {
+    return;
+  }
+  std::string contents;
+  contents.reserve(
+      key.size() + binary.function_name.size() + binary.image.size() + 2);
+  contents.append(key);
+  contents.push_back('\0');
+  contents.append(binary.function_name);
+  contents.push_back('\0');
+  contents.append(binary.image.begin(), binary.image.end());
+
+  const auto name = entryName(key);
+  if (writeFileAtomically(entryPath(dir, name), contents)) {
+    auto& cache = getBinaryCache();
+    std::lock_guard<std::mutex> guard{cache.mutex_};
+    cache.used_.insert(name);
+  }
+}
+
+int64_t preloadKernelBinaries(const std::string& manifest) {
+  const std::string& dir = getKernelBinaryCacheDir();
+  if (dir.empty()) {
+    return 0;
+  }
+  std::ifstream file(manifest);
+  if (!file) {
+    return 0;
+  }
+  std::unordered_map<std::string, CachedBinary> entries;
+  std::string name;
+  while (std::getline(file, name)) {
+    // The manifest only names files of the cache directory
+    if (name.empty() || name.find('/') != std::string::npos) {
+      continue;
+    }
+    auto entry = readEntry(entryPath(dir, name));
+    if (entry && entryName(entry->key) == name) {
+      entries.emplace(name, std::move(*entry));
+    }
+  }
+  const int64_t count = entries.size();
+  auto& cache = getBinaryCache();
+  std::lock_guard<std::mutex> guard{cache.mutex_};
+  for (auto& entry : entries) {
+    cache.preloaded_[entry.first] = std::move(entry.second);
+  }
+  return count;
+}
+
+void writeKernelBinaryManifest(const std::string& manifest) {
+  std::ostringstream contents;
+  {
+    auto& cache = getBinaryCache();
+    std::lock_guard<std::mutex> guard{cache.mutex_};
+    for (const auto& name : cache.used_) {
+      contents << name << "\n";
+    }
+  }
+  TORCH_CHECK(
+      writeFileAtomically(manifest, contents.str()),
+      "Failed to write the fuser kernel cache manifest ",
+      manifest);
+}
+
+// Note [Tuning of fuser launch configurations]
+// The fused kernels of the legacy fuser loop over their elements with a grid
+// stride, so their block size and number of blocks are only chosen at launch.
+// The default of 128 threads per block and as many blocks as fit on the device
+// at once reaches very different fractions of the bandwidth of different GPUs.
+// When getTuneLaunchConfigs() is set, the first run of a kernel times it with
+// a few block sizes, each with the most blocks resident at once and with half
+// as many, where every thread processes twice the elements, and keeps the
+// fastest.
+//
+// The kernel keeps the configuration for its lifetime, and when
+// getKernelBinaryCacheDir() is set, it's also stored next to the binary of the
+// kernel, keyed by the binary and the name and multiprocessor count of the
+// device. Later processes on the same GPU model use it whether tuning is
+// enabled in them or not.
+bool& getTuneLaunchConfigs() {
+  static bool tune = []() {
+    const char* enable = std::getenv("PYTORCH_FUSER_TUNE_LAUNCH");
+    return enable && std::string(enable) == "1";
+  }();
+  return tune;
+}
+
+std::string launchConfigKey(
+    const std::string& binary_key,
+    const std::string& device_name,
+    int multiprocessor_count) {
+  std::ostringstream key;
+  key << device_name << "\n"
+      << multiprocessor_count << " SMs\n"
+      << binary_key;
+  return key.str();
+}
+
+// An entry is the key ending with a NUL, followed by the block size and the
+// maximum number of blocks
+c10::optional<LaunchConfig> loadLaunchConfig(const std::string& key) {
+  const std::string& dir = getKernelBinaryCacheDir();
+  if (dir.empty()) {
+    return c10::nullopt;
+  }
+  std::ifstream file(entryPath(dir, launchConfigEntryName(key)));
+  if (!file) {
+    return c10::nullopt;
+  }
+  const std::string contents(
+      (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  const auto key_end = contents.find('\0');
+  if (key_end == std::string::npos || contents.substr(0, key_end) != key) {
+    return c10::nullopt;
+  }
+  std::istringstream values(contents.substr(key_end + 1));
+  LaunchConfig config;
+  if (!(values >> config.block_size >> config.max_blocks) ||
+      config.block_size <= 0 || config.max_blocks <= 0) {
+    return c10::nullopt;
+  }
+  return config;
+}
+
+void storeLaunchConfig(const std::string& key, const LaunchConfig& config) {
+  const std::string& dir = getKernelBinaryCacheDir();
+  if (dir.empty()) {
+    return;
+  }
+  std::ostringstream contents;
+  contents << key << '\0' << config.block_size << " " << config.max_blocks
+           << "\n";
+  writeFileAtomically(
+      entryPath(dir, launchConfigEntryName(key)), contents.str());
+}
+
+void clearKernelBinaryCache() {
+  auto& cache = getBinaryCache();
+  std::lock_guard<std::mutex> guard{cache.mutex_};
+  cache.preloaded_.clear();
+  cache.used_.clear();
+}
+
+} // namespace fuser
+} // namespace jit
+} // namespace torch
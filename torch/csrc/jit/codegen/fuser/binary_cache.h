@@ -0,0 +1,86 @@
+#pragma once
+
+#include <c10/util/Optional.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+
+// An on-disk cache of the binaries NVRTC compiles fused kernels to, shared by
+// the legacy CUDA fuser and nvFuser (see Note [Fuser kernel binary cache]).
+
+// A compiled kernel: its CUBIN or PTX, and the name of its entry point
+struct KernelBinary {
+  std::vector<char> image;
+  std::string function_name;
+};
+
+// The key of a kernel, made of everything its binary depends on
+TORCH_API std::string kernelBinaryKey(
+    const std::string& code,
+    const std::vector<const char*>& compile_args,
+    int compute_major,
+    int compute_minor,
+    bool compile_to_sass,
+    int nvrtc_major,
+    int nvrtc_minor);
+
+// The directory of the cache, the cache is disabled when it's empty.
+// Initialized from PYTORCH_FUSER_KERNEL_CACHE_DIR.
+TORCH_API std::string& getKernelBinaryCacheDir();
+
+// Returns the binary stored for key, from the preloaded entries or the cache
+// directory, if there is one
+TORCH_API c10::optional<KernelBinary> loadKernelBinary(const std::string& key);
+
+// Stores the binary of a kernel in the cache directory
+TORCH_API void storeKernelBinary(
+    const std::string& key,
+    const KernelBinary& binary);
+
+// Reads the entries listed in a manifest, written by writeKernelBinaryManifest,
+// from the cache directory into memory, and returns how many were found
+TORCH_API int64_t preloadKernelBinaries(const std::string& manifest);
+
+// Writes the list of the entries loaded or stored by this process
+TORCH_API void writeKernelBinaryManifest(const std::string& manifest);
+
+// The launch configuration of a grid-stride kernel, tuned on its first run
+// (see Note [Tuning of fuser launch configurations])
+struct LaunchConfig {
+  int block_size;
+  // The most blocks launched, each thread loops over the remaining elements
+  int max_blocks;
+};
+
+// Whether the CUDA fuser benchmarks the candidate launch configurations of a
+// kernel on its first run. Initialized from PYTORCH_FUSER_TUNE_LAUNCH.
+TORCH_API bool& getTuneLaunchConfigs();
+
+// The key of the launch configuration of a kernel, which adds the device the
+// kernel is tuned for to the key of its binary
+TORCH_API std::string launchConfigKey(
+    const std::string& binary_key,
+    const std::string& device_name,
+    int multiprocessor_count);
+
+// Returns the launch configuration stored for key in the cache directory
+TORCH_API c10::optional<LaunchConfig> loadLaunchConfig(const std::string& key);
+
+// Stores the tuned launch configuration of a kernel in the cache directory
+TORCH_API void storeLaunchConfig(
+    const std::string& key,
+    const LaunchConfig& config);
+
+// Drops the preloaded entries and forgets the entries used so far.
+// Only used for testing.
+TORCH_API void clearKernelBinaryCache();
+
+} // namespace fuser
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,564 @@
+#ifdef TORCH_ENABLE_LLVM
+#include <torch/csrc/jit/codegen/fuser/cpu/llvm_kernel.h>
+
+#include <ATen/Parallel.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/jit/codegen/fuser/compiler.h>
+#include <torch/csrc/jit/codegen/fuser/tensor_info.h>
+#include <torch/csrc/jit/tensorexpr/ir_printer.h>
+#include <torch/csrc/jit/tensorexpr/ir_simplifier.h>
+#include <torch/csrc/jit/tensorexpr/llvm_codegen.h>
+#include <torch/csrc/jit/tensorexpr/loopnest.h>
+#include <torch/csrc/jit/tensorexpr/tensor.h>
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+namespace cpu {
+
+// Note [LLVM CPU fusion kernels]
+// By default the CPU fuser writes the C++ code of generateKernel() to a
+// temporary file and compiles it by running the system C++ compiler, which
+// must then be installed wherever the model runs. When PyTorch is built with
+// LLVM, the graph of the fusion group is instead lowered to a tensor
+// expression statement and compiled in-process by LLVMCodeGen.
+//
+// The kernel has the same interface as the compiled C++ one: it maps the
+// linear index of each element to the offset of the element in every
+// flattened input and output, from the sizes and strides of their TensorInfo,
+// so that it's shared by all the sizes of the inputs. The statement loops over
+// a [start, stop) range of the linear indices, and launch_raw() splits the
+// elements between the threads of at::parallel_for, as the C++ kernel does
+// with OpenMP. When every input and output is contiguous, the offset is the
+// linear index itself, and the loop is vectorized.
+//
+// The operators are computed as generateKernel() does, e.g. the operands
+// are converted to the type of the result except for the comparisons.
+namespace {
+
+using namespace tensorexpr;
+
+constexpr int kVectorWidth = 8;
+
+Dtype dtypeOf(const c10::ScalarType type) {
+  return ToDtype(static_cast<ScalarType>(type));
+}
+
+Dtype dtypeOf(const torch::jit::Value* v) {
+  const auto& type = v->type();
+  if (type->kind() == TypeKind::IntType) {
+    return kLong;
+  } else if (type->kind() == TypeKind::FloatType) {
+    return kDouble;
+  } else if (type->kind() == TypeKind::BoolType) {
+    return kBool;
+  } else if (auto tensor_type = type->cast<TensorType>()) {
+    if (auto scalar_type = tensor_type->scalarType()) {
+      return dtypeOf(*scalar_type);
+    }
+  }
+  throw std::runtime_error(
+      "unknown scalar type during JIT fusion code generation");
+}
+
+ExprHandle castTo(const ExprHandle& e, const Dtype dtype) {
+  if (e.dtype() == dtype) {
+    return e;
+  }
+  return Cast::make(dtype, e);
+}
+
+ExprHandle immediate(const Dtype dtype, const int value) {
+  return ExprHandle(getImmediateByType(dtype, value));
+}
+
+class FusionGroupLowering {
+ public:
+  FusionGroupLowering(
+      const Graph& graph,
+      const std::vector<
+          std::pair<const torch::jit::Value*, const c10::optional<TensorDesc>>>&
+          flat_inputs,
+      const std::vector<std::pair<const torch::jit::Value*, const TensorDesc>>&
+          flat_outputs)
+      : graph_(graph),
+        flat_inputs_(flat_inputs),
+        flat_outputs_(flat_outputs),
+        start_("start", kLong),
+        stop_("stop", kLong) {
+    int64_t dims_size = 0;
+    auto addTensor = [&](const TensorDesc& desc, const std::string& name) {
+      // Note: as with the C++ kernels, halfs are only supported on CUDA
+      if (desc.scalar_type == at::ScalarType::Half) {
+        throw std::runtime_error("Cannot fuse halfs on the CPU");
+      }
+      const int64_t ndim = desc.nDim();
+      arg_dims_.push_back(ndim);
+      dims_offsets_.push_back(dims_size);
+      dims_size += 2 * ndim;
+      // The offset of a 0-dim tensor is always 0
+      contiguous_.push_back(
+          ndim == 0 || (ndim == 1 && desc.lastIsContiguous()));
+      buffers_.emplace_back(
+          BufHandle(name, {stop_}, dtypeOf(desc.scalar_type)));
+    };
+
+    for (size_t i = 0; i < flat_inputs_.size(); ++i) {
+      const auto& input = flat_inputs_[i];
+      const std::string name = "t" + c10::to_string(i);
+      if (input.second) {
+        addTensor(*input.second, name);
+        continue;
+      }
+      arg_dims_.push_back(-1);
+      dims_offsets_.push_back(-1);
+      contiguous_.push_back(true);
+      buffers_.emplace_back(c10::nullopt);
+      scalars_.emplace(i, VarHandle("s" + c10::to_string(i), kDouble));
+    }
+    for (size_t i = 0; i < flat_outputs_.size(); ++i) {
+      addTensor(
+          flat_outputs_[i].second,
+          "t" + c10::to_string(flat_inputs_.size() + i));
+    }
+    dims_.emplace(BufHandle("dims", {std::max<int64_t>(dims_size, 1)}, kLong));
+  }
+
+  // The number of dims of each flattened argument, see FusedKernelLLVM
+  const std::vector<int64_t>& argDims() const {
+    return arg_dims_;
+  }
+
+  // The arguments of the kernel: the range of the linear indices, the sizes
+  // and strides of the tensors, and the flattened arguments
+  std::vector<CodeGen::BufferArg> bufferArgs() const {
+    std::vector<CodeGen::BufferArg> args = {start_, stop_, *dims_};
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+      if (buffers_[i]) {
+        args.emplace_back(*buffers_[i]);
+      } else {
+        args.emplace_back(scalars_.at(i));
+      }
+    }
+    return args;
+  }
+
+  Stmt* lower() {
+    const bool vectorize = std::all_of(
+        contiguous_.begin(), contiguous_.end(), [](bool c) { return c; });
+    if (!vectorize) {
+      VarHandle i("i", kLong);
+      return IRSimplifier::simplify(
+          tensorexpr::Block::make({For::make(i, start_, stop_, body(i))}));
+    }
+
+    // Splits the range into vectors and the remaining elements
+    const ExprHandle vectors = (stop_ - start_) / ExprHandle(kVectorWidth);
+    VarHandle i_outer("i_outer", kLong);
+    VarHandle i_inner("i_inner", kInt);
+    For* inner = For::make(
+        i_inner,
+        0,
+        kVectorWidth,
+        body(start_ + i_outer * ExprHandle(kVectorWidth) + i_inner));
+    For* outer = For::make(i_outer, 0, vectors, inner);
+    VarHandle i_tail("i_tail", kLong);
+    For* tail = For::make(
+        i_tail,
+        start_ + vectors * ExprHandle(kVectorWidth),
+        stop_,
+        body(i_tail));
+    Stmt* root = tensorexpr::Block::make({outer, tail});
+    LoopNest::vectorize(inner);
+    return IRSimplifier::simplify(root);
+  }
+
+ private:
+  // Mirrors emitIndexingFor() in codegen.cpp
+  ExprHandle offset(const size_t arg, const ExprHandle& index) const {
+    const int64_t ndim = arg_dims_[arg];
+    if (ndim == 0) {
+      return LongImm::make(0);
+    }
+    if (contiguous_[arg]) {
+      return index;
+    }
+    const int64_t base = dims_offsets_[arg];
+    const Placeholder dims(*dims_);
+    const bool last_is_contiguous = arg < flat_inputs_.size()
+        ? flat_inputs_[arg].second->lastIsContiguous()
+        : flat_outputs_[arg - flat_inputs_.size()].second.lastIsContiguous();
+    ExprHandle result = LongImm::make(0);
+    ExprHandle linear_index = index;
+    for (int64_t d = ndim - 1; d >= 0; --d) {
+      const ExprHandle size = dims.load(LongImm::make(base + d));
+      const ExprHandle stride = dims.load(LongImm::make(base + ndim + d));
+      const ExprHandle dim_index = d > 0 ? linear_index % size : linear_index;
+      result = (d < ndim - 1 || !last_is_contiguous)
+          ? result + dim_index * stride
+          : result + dim_index;
+      if (d > 0) {
+        linear_index = linear_index / size;
+      }
+    }
+    return result;
+  }
+
+  // The loads, computations and stores of the element at index
+  Stmt* body(const ExprHandle& index) {
+    values_.clear();
+    for (size_t i = 0; i < flat_inputs_.size(); ++i) {
+      const torch::jit::Value* input = flat_inputs_[i].first;
+      if (buffers_[i]) {
+        values_.emplace(
+            input, Placeholder(*buffers_[i]).load(offset(i, index)));
+      } else {
+        values_.emplace(input, scalars_.at(i));
+      }
+    }
+
+    for (const auto n : graph_.nodes()) {
+      // FusedConcat and ConstantChunk are handled by the flattened arguments
+      if (n->kind() == prim::FusedConcat || n->kind() == prim::ConstantChunk ||
+          n->mustBeNone()) {
+        continue;
+      }
+      if (n->kind() == prim::Constant) {
+        const auto val = toIValue(n->output()).value();
+        if (val.isDouble()) {
+          values_.emplace(n->output(), ExprHandle(val.toDouble()));
+        } else if (val.isBool()) {
+          values_.emplace(n->output(), ExprHandle(val.toBool()));
+        } else {
+          AT_ASSERT(val.isInt());
+          values_.emplace(n->output(), ExprHandle(val.toInt()));
+        }
+        continue;
+      }
+      values_.emplace(n->output(), computeNode(n));
+    }
+
+    std::vector<Stmt*> stores;
+    for (size_t i = 0; i < flat_outputs_.size(); ++i) {
+      const auto& output = flat_outputs_[i];
+      const size_t arg = flat_inputs_.size() + i;
+      stores.push_back(Placeholder(*buffers_[arg])
+                           .store(
+                               {offset(arg, index)},
+                               castTo(
+                                   values_.at(output.first),
+                                   dtypeOf(output.second.scalar_type))));
+    }
+    return tensorexpr::Block::make(stores);
+  }
+
+  // Mirrors encodeRHS() in codegen.cpp
+  ExprHandle computeNode(const Node* n) {
+    const Dtype out = dtypeOf(n->output());
+    auto input = [&](size_t i) { return castTo(values_.at(n->input(i)), out); };
+    // The operands of the comparisons are converted to their common type
+    auto compare = [&](CompareSelectOperation op) {
+      const ExprHandle& lhs = values_.at(n->input(0));
+      const ExprHandle& rhs = values_.at(n->input(1));
+      const Dtype common = promoteTypes(lhs.dtype(), rhs.dtype());
+      return CompareSelect::make(
+          castTo(lhs, common),
+          castTo(rhs, common),
+          immediate(out, 1),
+          immediate(out, 0),
+          op);
+    };
+    auto integral = [&](const ExprHandle& e) {
+      if (!out.is_integral()) {
+        throw std::runtime_error(
+            "Bitwise operators are only fused for integral types");
+      }
+      return e;
+    };
+
+    switch (n->kind()) {
+      // unary
+      case aten::_cast_Float:
+        return castTo(values_.at(n->input(0)), kFloat);
+      case aten::abs:
+        return abs(input(0));
+      case aten::sigmoid:
+        return sigmoid(input(0));
+      case aten::relu:
+        return CompareSelect::make(
+            input(0), immediate(out, 0), immediate(out, 0), input(0), kLT);
+      case aten::threshold:
+        return CompareSelect::make(input(0), input(1), input(2), input(0), kLE);
+      case aten::log:
+        return log(input(0));
+      case aten::log10:
+        return log10(input(0));
+      case aten::log1p:
+        return log1p(input(0));
+      case aten::log2:
+        return log2(input(0));
+      case aten::lgamma:
+        return lgamma(input(0));
+      case aten::exp:
+        return exp(input(0));
+      case aten::expm1:
+        return expm1(input(0));
+      case aten::erf:
+        return erf(input(0));
+      case aten::erfc:
+        return erfc(input(0));
+      case aten::cos:
+        return cos(input(0));
+      case aten::acos:
+        return acos(input(0));
+      case aten::cosh:
+        return cosh(input(0));
+      case aten::sin:
+        return sin(input(0));
+      case aten::asin:
+        return asin(input(0));
+      case aten::sinh:
+        return sinh(input(0));
+      case aten::tan:
+        return tan(input(0));
+      case aten::atan:
+        return atan(input(0));
+      case aten::tanh:
+        return tanh(input(0));
+      case aten::sqrt:
+        return sqrt(input(0));
+      case aten::rsqrt:
+        return rsqrt(input(0));
+      case aten::ceil:
+        return ceil(input(0));
+      case aten::floor:
+        return floor(input(0));
+      case aten::round:
+        return round(input(0));
+      case aten::trunc:
+        return trunc(input(0));
+      case aten::frac:
+        return frac(input(0));
+      case aten::reciprocal:
+        return immediate(out, 1) / input(0);
+      case aten::neg:
+        return input(0) * immediate(out, -1);
+      // simple binary
+      case aten::atan2:
+        return atan2(input(0), input(1));
+      case aten::min:
+        return Min::make(input(0), input(1), /*propagate_nans=*/true);
+      case aten::max:
+        return Max::make(input(0), input(1), /*propagate_nans=*/true);
+      // binary with other
+      case aten::__and__:
+        return integral(input(0) & input(1));
+      case aten::__lshift__:
+        return integral(input(0) << input(1));
+      case aten::__or__:
+        return integral(input(0) | input(1));
+      case aten::__rshift__:
+        return integral(input(0) >> input(1));
+      case aten::__xor__:
+        return integral(input(0) ^ input(1));
+      case aten::addcmul:
+        return input(0) + input(3) * input(1) * input(2);
+      case aten::div:
+        return input(0) / input(1);
+      case aten::eq:
+        return compare(kEQ);
+      case aten::fmod:
+        return fmod(input(0), input(1));
+      case aten::ge:
+        return compare(kGE);
+      case aten::gt:
+        return compare(kGT);
+      case aten::le:
+        return compare(kLE);
+      case aten::lt:
+        return compare(kLT);
+      case aten::lerp:
+        return input(0) + input(2) * (input(1) - input(0));
+      case aten::type_as:
+        return input(0);
+      case aten::mul:
+        return input(0) * input(1);
+      case aten::ne:
+        return compare(kNE);
+      case aten::remainder:
+        return fmod(input(1) + fmod(input(0), input(1)), input(1));
+      case aten::pow:
+        return pow(input(0), input(1));
+      // alpha
+      case aten::add:
+        return input(0) + input(2) * input(1);
+      case aten::sub:
+        return input(0) - input(2) * input(1);
+      // where
+      case aten::where: {
+        const ExprHandle& condition = values_.at(n->input(0));
+        return CompareSelect::make(
+            condition,
+            immediate(condition.dtype(), 0),
+            input(1),
+            input(2),
+            kNE);
+      }
+      // special case for clamp fusion on missing min/max inputs, see
+      // encodeSpecialRHS()
+      case aten::clamp: {
+        const bool has_min = !n->input(1)->node()->mustBeNone();
+        const bool has_max = !n->input(2)->node()->mustBeNone();
+        if (!has_min && !has_max) {
+          throw std::runtime_error(
+              "At least one of 'min' or 'max' must not be None");
+        }
+        ExprHandle result = input(0);
+        if (has_max) {
+          result = CompareSelect::make(input(0), input(2), input(2), result, kGT);
+        }
+        if (has_min) {
+          result = CompareSelect::make(input(0), input(1), input(1), result, kLT);
+        }
+        return result;
+      }
+      default:
+        // Note: the CPU fuser doesn't support random numbers either
+        throw std::runtime_error(
+            std::string("Cannot fuse with LLVM, op not supported: ") +
+            n->kind().toQualString());
+    }
+  }
+
+  const Graph& graph_;
+  const std::vector<std::pair<const torch::jit::Value*, const c10::optional<TensorDesc>>>&
+      flat_inputs_;
+  const std::vector<std::pair<const torch::jit::Value*, const TensorDesc>>& flat_outputs_;
+
+  VarHandle start_;
+  VarHandle stop_;
+  c10::optional<BufHandle> dims_;
+  // For each flattened input and output
+  std::vector<int64_t> arg_dims_;
+  std::vector<int64_t> dims_offsets_;
+  std::vector<bool> contiguous_;
+  std::vector<c10::optional<BufHandle>> buffers_;
+  // The scalar inputs, by index of flattened input
+  std::unordered_map<size_t, VarHandle> scalars_;
+
+  std::unordered_map<const torch::jit::Value*, ExprHandle> values_;
+};
+
+} // namespace
+
+FusedKernelLLVM::FusedKernelLLVM(
+    std::string name,
+    std::string code,
+    std::vector<TensorDesc> input_desc,
+    std::vector<TensorDesc> output_desc,
+    std::vector<PartitionDesc> chunk_desc,
+    std::vector<PartitionDesc> concat_desc,
+    bool has_random,
+    std::vector<int64_t> arg_dims,
+    std::unique_ptr<tensorexpr::KernelArena> arena,
+    std::unique_ptr<tensorexpr::LLVMCodeGen> codegen)
+    : FusedKernel(
+          std::move(name),
+          std::move(code),
+          std::move(input_desc),
+          std::move(output_desc),
+          std::move(chunk_desc),
+          std::move(concat_desc),
+          has_random),
+      arg_dims_(std::move(arg_dims)),
+      arena_(std::move(arena)),
+      codegen_(std::move(codegen)) {}
+
+FusedKernelLLVM::~FusedKernelLLVM() = default;
+
+void FusedKernelLLVM::launch_raw(
+    const uint32_t numel,
+    std::vector<void*>& arguments) const {
+  // The arguments are laid out as for the C++ kernel, see launchFusion().
+  // The kernel takes the data of the tensors and the pointers to the scalars
+  // as they are, and the sizes and strides of the tensors widened to 64 bits.
+  std::vector<int64_t> dims;
+  std::vector<void*> args(3);
+  args.reserve(3 + arg_dims_.size());
+  for (size_t i = 0; i < arg_dims_.size(); ++i) {
+    void* arg = arguments.at(i + 1);
+    const int64_t ndim = arg_dims_[i];
+    if (ndim < 0) {
+      args.push_back(arg);
+      continue;
+    }
+    auto ti = static_cast<TensorInfo*>(arg);
+    args.push_back(ti->data);
+    const uint32_t* sizes = ti->sizes(ndim);
+    const uint32_t* strides = ti->strides(ndim);
+    dims.insert(dims.end(), sizes, sizes + ndim);
+    dims.insert(dims.end(), strides, strides + ndim);
+  }
+  args[2] = dims.data();
+
+  at::parallel_for(
+      0, numel, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        std::vector<void*> thread_args = args;
+        thread_args[0] = &begin;
+        thread_args[1] = &end;
+        codegen_->value<int>(thread_args);
+      });
+}
+
+std::shared_ptr<FusedKernel> createLLVMFusionKernel(
+    std::string name,
+    const Graph& graph,
+    const std::vector<std::pair<const torch::jit::Value*, const c10::optional<TensorDesc>>>&
+        flat_inputs,
+    const std::vector<std::pair<const torch::jit::Value*, const TensorDesc>>& flat_outputs,
+    std::vector<TensorDesc> input_desc,
+    std::vector<TensorDesc> output_desc,
+    std::vector<PartitionDesc> chunk_desc,
+    std::vector<PartitionDesc> concat_desc,
+    bool has_random) {
+  if (has_random) {
+    throw std::runtime_error("Cannot fuse random numbers with LLVM");
+  }
+  auto arena = std::make_unique<tensorexpr::KernelArena>();
+  tensorexpr::KernelScope scope(arena.get());
+
+  FusionGroupLowering lowering(graph, flat_inputs, flat_outputs);
+  tensorexpr::Stmt* stmt = lowering.lower();
+  std::ostringstream code;
+  code << *stmt;
+  if (debugFuser()) {
+    std::cerr << "fusion code:" << code.str() << std::endl;
+  }
+  auto codegen = std::make_unique<tensorexpr::LLVMCodeGen>(
+      stmt, lowering.bufferArgs(), at::kCPU, name);
+
+  return std::make_shared<FusedKernelLLVM>(
+      std::move(name),
+      code.str(),
+      std::move(input_desc),
+      std::move(output_desc),
+      std::move(chunk_desc),
+      std::move(concat_desc),
+      has_random,
+      lowering.argDims(),
+      std::move(arena),
+      std::move(codegen));
+}
+
+} // namespace cpu
+} // namespace fuser
+} // namespace jit
+} // namespace torch
+
+#endif // TORCH_ENABLE_LLVM
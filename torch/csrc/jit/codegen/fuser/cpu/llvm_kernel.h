@@ -0,0 +1,80 @@
+#pragma once
+
+#ifdef TORCH_ENABLE_LLVM
+#include <ATen/ATen.h>
+#include <c10/util/Optional.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/codegen/fuser/fused_kernel.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace tensorexpr {
+class KernelArena;
+class LLVMCodeGen;
+} // namespace tensorexpr
+
+namespace fuser {
+namespace cpu {
+
+// Represents a CPU kernel compiled in-process by the LLVM backend of the
+// tensor expressions (see Note [LLVM CPU fusion kernels])
+struct TORCH_API FusedKernelLLVM : public FusedKernel {
+  FusedKernelLLVM(
+      std::string name,
+      std::string code,
+      std::vector<TensorDesc> input_desc,
+      std::vector<TensorDesc> output_desc,
+      std::vector<PartitionDesc> chunk_desc,
+      std::vector<PartitionDesc> concat_desc,
+      bool has_random,
+      std::vector<int64_t> arg_dims,
+      std::unique_ptr<tensorexpr::KernelArena> arena,
+      std::unique_ptr<tensorexpr::LLVMCodeGen> codegen);
+
+  ~FusedKernelLLVM() override;
+
+  at::Backend backend() const override {
+    return at::Backend::CPU;
+  }
+
+  void launch_raw(const uint32_t numel, std::vector<void*>& arguments)
+      const override;
+
+ private:
+  // For each flattened input and output, the number of (compressed) dims of
+  // its TensorInfo, or -1 for the scalars
+  const std::vector<int64_t> arg_dims_;
+  // Owns the statement compiled by codegen_, declared first to outlive it
+  std::unique_ptr<tensorexpr::KernelArena> arena_;
+  std::unique_ptr<tensorexpr::LLVMCodeGen> codegen_;
+};
+
+// Compiles the graph of a fusion group with LLVM, using the same flattened
+// inputs and outputs as generateKernel(). Throws if the graph uses an operator
+// or a type which isn't supported, in which case the caller falls back to the
+// C++ compiler.
+TORCH_API std::shared_ptr<FusedKernel> createLLVMFusionKernel(
+    std::string name,
+    const Graph& graph,
+    const std::vector<std::pair<const Value*, const c10::optional<TensorDesc>>>&
+        flat_inputs,
+    const std::vector<std::pair<const Value*, const TensorDesc>>& flat_outputs,
+    std::vector<TensorDesc> input_desc,
+    std::vector<TensorDesc> output_desc,
+    std::vector<PartitionDesc> chunk_desc,
+    std::vector<PartitionDesc> concat_desc,
+    bool has_random);
+
+} // namespace cpu
+} // namespace fuser
+} // namespace jit
+} // namespace torch
+
+#endif // TORCH_ENABLE_LLVM
@@ -1,5 +1,6 @@
 #include <torch/csrc/jit/codegen/fuser/cuda/fused_kernel.h>
 
+#include <torch/csrc/jit/codegen/fuser/binary_cache.h>
 #include <torch/csrc/jit/codegen/fuser/compiler.h>
 
 #include <ATen/ATen.h>
@@ -14,6 +15,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 #include <tuple>
@@ -75,6 +77,29 @@ void codegenOutputQuery(
   compile_to_sass = ((major == prop->major) && (minor == prop->minor));
 }
 
+std::string kernelBinaryCacheKey(
+    const std::string& code,
+    const std::vector<const char*>& args,
+    int major,
+    int minor,
+    bool compile_to_sass) {
+#ifdef __HIP_PLATFORM_HCC__
+  const int compiler_major = HIP_VERSION / 100;
+  const int compiler_minor = HIP_VERSION % 100;
+#else
+  int compiler_major = 0, compiler_minor = 0;
+  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcVersion(&compiler_major, &compiler_minor));
+#endif
+  return fuser::kernelBinaryKey(
+      code,
+      args,
+      major,
+      minor,
+      compile_to_sass,
+      compiler_major,
+      compiler_minor);
+}
+
 // Compiles the specified kernel and stores the metadata required to run it
 FusedKernelCUDA::FusedKernelCUDA(
     at::DeviceIndex device,
@@ -115,11 +140,6 @@ FusedKernelCUDA::FusedKernelCUDA(
   bool compile_to_sass = false;
   codegenOutputQuery(prop_, major, minor, compile_to_sass);
 
-  // Creates the NVRTC program
-  nvrtcProgram program;
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcCreateProgram(
-      &program, code_.c_str(), nullptr, 0, nullptr, nullptr));
-
 #ifdef __HIP_PLATFORM_HCC__
   std::vector<const char*> args = {};
 #else
@@ -140,61 +160,161 @@ FusedKernelCUDA::FusedKernelCUDA(
   const std::vector<const char*> args = {
       "--std=c++14", compute.c_str(), "-default-device"};
 #endif
-  const auto result =
-      nvrtc().nvrtcCompileProgram(program, args.size(), args.data());
-  if (result != NVRTC_SUCCESS) {
-    size_t logsize;
-    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetProgramLogSize(program, &logsize));
-    std::vector<char> log(logsize);
-    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetProgramLog(program, log.data()));
-    std::stringstream cu;
-    cu << log.data();
-    throw std::runtime_error(cu.str());
-  }
-  ResourceGuard holdProgram(
-      [&] { AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcDestroyProgram(&program)); });
-  AT_CUDA_NVRTC_CHECK(result);
-  size_t ptx_size;
+
+  // See Note [Fuser kernel binary cache]
+  const auto cache_key =
+      kernelBinaryCacheKey(code_, args, major, minor, compile_to_sass);
+  if (auto cached = fuser::loadKernelBinary(cache_key)) {
+    ptx_ = std::move(cached->image);
+  } else {
+    // Creates the NVRTC program
+    nvrtcProgram program;
+    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcCreateProgram(
+        &program, code_.c_str(), nullptr, 0, nullptr, nullptr));
+    const auto result =
+        nvrtc().nvrtcCompileProgram(program, args.size(), args.data());
+    if (result != NVRTC_SUCCESS) {
+      size_t logsize;
+      AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetProgramLogSize(program, &logsize));
+      std::vector<char> log(logsize);
+      AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetProgramLog(program, log.data()));
+      std::stringstream cu;
+      cu << log.data();
+      throw std::runtime_error(cu.str());
+    }
+    ResourceGuard holdProgram(
+        [&] { AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcDestroyProgram(&program)); });
+    AT_CUDA_NVRTC_CHECK(result);
+    size_t ptx_size;
 #if CUDA_VERSION >= 11010
-  // compile_to_sass determines whether we are generating SASS or PTX, hence
-  // the different API.
-  const auto getSize = compile_to_sass
-      ? at::globalContext().getNVRTC().nvrtcGetCUBINSize
-      : at::globalContext().getNVRTC().nvrtcGetPTXSize;
-  const auto getFunc = compile_to_sass
-      ? at::globalContext().getNVRTC().nvrtcGetCUBIN
-      : at::globalContext().getNVRTC().nvrtcGetPTX;
+    // compile_to_sass determines whether we are generating SASS or PTX, hence
+    // the different API.
+    const auto getSize = compile_to_sass
+        ? at::globalContext().getNVRTC().nvrtcGetCUBINSize
+        : at::globalContext().getNVRTC().nvrtcGetPTXSize;
+    const auto getFunc = compile_to_sass
+        ? at::globalContext().getNVRTC().nvrtcGetCUBIN
+        : at::globalContext().getNVRTC().nvrtcGetPTX;
 #else
-  const auto getSize = at::globalContext().getNVRTC().nvrtcGetPTXSize;
-  const auto getFunc = at::globalContext().getNVRTC().nvrtcGetPTX;
+    const auto getSize = at::globalContext().getNVRTC().nvrtcGetPTXSize;
+    const auto getFunc = at::globalContext().getNVRTC().nvrtcGetPTX;
 #endif
-  AT_CUDA_NVRTC_CHECK(getSize(program, &ptx_size));
-  ptx_.resize(ptx_size);
-  AT_CUDA_NVRTC_CHECK(getFunc(program, ptx_.data()));
+    AT_CUDA_NVRTC_CHECK(getSize(program, &ptx_size));
+    ptx_.resize(ptx_size);
+    AT_CUDA_NVRTC_CHECK(getFunc(program, ptx_.data()));
+    fuser::storeKernelBinary(cache_key, {ptx_, name_});
+  }
 
   AT_CUDA_DRIVER_CHECK(nvrtc().cuModuleLoadData(&module_, ptx_.data()));
   AT_CUDA_DRIVER_CHECK(
       nvrtc().cuModuleGetFunction(&function_, module_, name_.c_str()));
 
   // Computes max blocks
+  maxBlocks_ = maxResidentBlocks(kBlockSize);
+
+  // Picks the launch configuration, see
+  // Note [Tuning of fuser launch configurations]
+  launch_config_ = {kBlockSize, maxBlocks_};
+  launch_config_key_ = fuser::launchConfigKey(
+      cache_key, prop_->name, prop_->multiProcessorCount);
+  if (auto tuned = fuser::loadLaunchConfig(launch_config_key_)) {
+    launch_config_ = *tuned;
+  } else {
+    // The random numbers drawn by a kernel depend on its launch configuration
+    needs_tuning_ = fuser::getTuneLaunchConfigs() && !has_random_;
+  }
+
+  // Resets device (end of hacked at::DeviceGuard)
+  at::cuda::set_device(prior_device);
+}
+
+static int ceilDiv(const int a, const int b) {
+  return (a + b - 1) / b;
+}
+
+int FusedKernelCUDA::maxResidentBlocks(const int block_size) const {
 #if defined(__HIP_PLATFORM_HCC__) && HIP_VERSION < 305
   // HIP function signature is not compatible yet
   uint32_t max_blocks;
   AT_CUDA_DRIVER_CHECK(nvrtc().hipOccupancyMaxActiveBlocksPerMultiprocessor(
-      &max_blocks, function_, 128, 0));
-  maxBlocks_ = max_blocks;
+      &max_blocks, function_, block_size, 0));
 #else
+  int max_blocks;
   AT_CUDA_DRIVER_CHECK(nvrtc().cuOccupancyMaxActiveBlocksPerMultiprocessor(
-      &maxBlocks_, function_, 128, 0));
+      &max_blocks, function_, block_size, 0));
 #endif
-  maxBlocks_ *= prop_->multiProcessorCount;
+  return max_blocks * prop_->multiProcessorCount;
+}
 
-  // Resets device (end of hacked at::DeviceGuard)
-  at::cuda::set_device(prior_device);
+void FusedKernelCUDA::launch(
+    const fuser::LaunchConfig& config,
+    const uint32_t numel,
+    void** arguments) const {
+  const auto nBlocks =
+      std::min(config.max_blocks, ceilDiv(numel, config.block_size));
+
+  // Launches kernel on current stream (device was set by executor)
+  auto stream = at::cuda::getCurrentCUDAStream();
+  AT_CUDA_DRIVER_CHECK(nvrtc().cuLaunchKernel(
+      function_,
+      nBlocks,
+      1,
+      1,
+      config.block_size,
+      1,
+      1,
+      0,
+      stream,
+      arguments,
+      nullptr));
 }
 
-static int ceilDiv(const int a, const int b) {
-  return (a + b - 1) / b;
+void FusedKernelCUDA::tuneLaunchConfig(
+    const uint32_t numel,
+    std::vector<void*>& arguments) const {
+  constexpr int kTuningRuns = 10;
+
+  // The default configuration comes first, so that it wins ties.
+  std::vector<fuser::LaunchConfig> candidates = {launch_config_};
+  for (const int block_size : {128, 256, 512}) {
+    const int max_blocks = maxResidentBlocks(block_size);
+    // The kernel may use too many registers for the larger blocks
+    if (max_blocks == 0) {
+      continue;
+    }
+    if (block_size != kBlockSize || max_blocks != maxBlocks_) {
+      candidates.push_back({block_size, max_blocks});
+    }
+    candidates.push_back({block_size, std::max(max_blocks / 2, 1)});
+  }
+
+  auto stream = at::cuda::getCurrentCUDAStream();
+  cudaEvent_t start, stop;
+  AT_CUDA_CHECK(cudaEventCreate(&start));
+  ResourceGuard destroyStart([&] { AT_CUDA_CHECK(cudaEventDestroy(start)); });
+  AT_CUDA_CHECK(cudaEventCreate(&stop));
+  ResourceGuard destroyStop([&] { AT_CUDA_CHECK(cudaEventDestroy(stop)); });
+
+  fuser::LaunchConfig best = launch_config_;
+  float best_time = std::numeric_limits<float>::infinity();
+  for (const auto& candidate : candidates) {
+    // The first launch warms up the caches.
+    launch(candidate, numel, arguments.data());
+    AT_CUDA_CHECK(cudaEventRecord(start, stream));
+    for (int i = 0; i < kTuningRuns; i++) {
+      launch(candidate, numel, arguments.data());
+    }
+    AT_CUDA_CHECK(cudaEventRecord(stop, stream));
+    AT_CUDA_CHECK(cudaEventSynchronize(stop));
+    float time = 0;
+    AT_CUDA_CHECK(cudaEventElapsedTime(&time, start, stop));
+    if (time < best_time) {
+      best = candidate;
+      best_time = time;
+    }
+  }
+  launch_config_ = best;
+  fuser::storeLaunchConfig(launch_config_key_, best);
 }
 
 void FusedKernelCUDA::launch_raw(
@@ -205,7 +325,13 @@ void FusedKernelCUDA::launch_raw(
   const auto prior_device = at::cuda::current_device();
   at::cuda::set_device(device_);
 
-  const auto nBlocks = std::min(maxBlocks_, ceilDiv(numel, kBlockSize));
+  if (needs_tuning_) {
+    std::call_once(
+        tuning_flag_, [&] { tuneLaunchConfig(numel, arguments); });
+  }
+  const auto& config = launch_config_;
+  const auto nBlocks =
+      std::min(config.max_blocks, ceilDiv(numel, config.block_size));
 
   // Adds random state to arguments if necessary
   // Note: philox_engine_inputs defined here so its lifetime extends to the
@@ -213,7 +339,7 @@ void FusedKernelCUDA::launch_raw(
   std::pair<uint64_t, uint64_t> philox_engine_inputs;
   if (has_random_) {
     const auto rand_offset =
-        4 * (std::ceil(numel / (4.0 * kBlockSize * nBlocks)) + 1);
+        4 * (std::ceil(numel / (4.0 * config.block_size * nBlocks)) + 1);
     auto gen = at::cuda::detail::getDefaultCUDAGenerator();
     {
       // See Note [Acquire lock when using random generators]
@@ -226,20 +352,7 @@ void FusedKernelCUDA::launch_raw(
     arguments.push_back(&philox_engine_inputs.second);
   }
 
-  // Launches kernel on current stream (device was set by executor)
-  auto stream = at::cuda::getCurrentCUDAStream();
-  AT_CUDA_DRIVER_CHECK(nvrtc().cuLaunchKernel(
-      function_,
-      nBlocks,
-      1,
-      1,
-      kBlockSize,
-      1,
-      1,
-      0,
-      stream,
-      arguments.data(),
-      nullptr));
+  launch(config, numel, arguments.data());
 
   // Resets device (see at::DeviceGuard notes above)
   at::cuda::set_device(prior_device);
@@ -2,6 +2,7 @@
 
 #include <ATen/ATen.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/codegen/fuser/binary_cache.h>
 #include <torch/csrc/jit/codegen/fuser/fused_kernel.h>
 
 #include <cuda.h>
@@ -9,6 +10,7 @@
 #include <nvrtc.h>
 
 #include <cstdint>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -24,6 +26,15 @@ TORCH_CUDA_CU_API void codegenOutputQuery(
     int& minor,
     bool& compile_to_sass);
 
+// The key of a kernel in the on-disk binary cache, which adds the version of
+// NVRTC to the options the kernel is compiled with
+TORCH_CUDA_CU_API std::string kernelBinaryCacheKey(
+    const std::string& code,
+    const std::vector<const char*>& args,
+    int major,
+    int minor,
+    bool compile_to_sass);
+
 // A class holding metadata for an actual CUDA function.
 // Note: CUDA functions are per device.
 struct TORCH_CUDA_CU_API FusedKernelCUDA
@@ -50,10 +61,28 @@ struct TORCH_CUDA_CU_API FusedKernelCUDA
  private:
   static constexpr auto kBlockSize = 128;
 
+  // The most blocks of block_size threads resident on the device at once
+  int maxResidentBlocks(int block_size) const;
+
+  void launch(
+      const fuser::LaunchConfig& config,
+      const uint32_t numel,
+      void** arguments) const;
+
+  // Times the candidate launch configurations on the arguments of the first
+  // run, see Note [Tuning of fuser launch configurations]
+  void tuneLaunchConfig(const uint32_t numel, std::vector<void*>& arguments)
+      const;
+
   // Note: per device to store device properties and compute launch heuristics
   //  Acquiring these values at launch time would be too slow
   at::DeviceIndex device_;
   int maxBlocks_;
+  std::string launch_config_key_;
+  // Written once by tuneLaunchConfig(), under tuning_flag_, when needs_tuning_
+  mutable fuser::LaunchConfig launch_config_;
+  bool needs_tuning_ = false;
+  mutable std::once_flag tuning_flag_;
   cudaDeviceProp* prop_;
   std::vector<char> ptx_;
   CUmodule module_;
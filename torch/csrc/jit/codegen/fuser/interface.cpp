@@ -20,6 +20,8 @@ bool cpu_fuser_enabled = false;
 
 bool gpu_fuser_enabled = true;
 
+bool cpu_fuser_uses_llvm = true;
+
 } // namespace detail
 
 int64_t registerFusion(const Node* fusion_group) {
@@ -45,6 +47,14 @@ void overrideCanFuseOnCPU(bool value) {
   detail::cpu_fuser_enabled = value;
 }
 
+void overrideCPUFuserUsesLLVM(bool value) {
+  detail::cpu_fuser_uses_llvm = value;
+}
+
+bool cpuFuserUsesLLVM() {
+  return detail::cpu_fuser_uses_llvm;
+}
+
 void overrideCanFuseOnGPU(bool value) {
   detail::gpu_fuser_enabled = value;
 }
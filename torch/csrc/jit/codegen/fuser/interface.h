@@ -32,6 +32,12 @@ TORCH_API bool canFuseOnGPU();
 // flakiness)
 TORCH_API void overrideCanFuseOnCPU(bool value);
 
+// Sets whether the CPU fuser compiles its kernels in-process with LLVM, when
+// PyTorch is built with it, rather than with the system C++ compiler
+// (enabled by default)
+TORCH_API void overrideCPUFuserUsesLLVM(bool value);
+TORCH_API bool cpuFuserUsesLLVM();
+
 // Sets whether fusion on CPU must use LLVM Codegen and not SimplieIREval
 TORCH_API void overrideMustUseLLVMOnCPU(bool value);
 
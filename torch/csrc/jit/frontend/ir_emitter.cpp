@@ -4185,9 +4185,13 @@ std::vector<Function*> CompilationUnit::define(
     const std::vector<Def>& definitions,
     const std::vector<ResolverPtr>& defResolvers,
     const Self* self,
-    bool shouldMangle) {
+    bool shouldMangle,
+    bool lazy) {
   TORCH_INTERNAL_ASSERT(definitions.size() == defResolvers.size());
   TORCH_INTERNAL_ASSERT(properties.size() == propResolvers.size());
+  // Free functions are resolved through a function table that only lives
+  // for this call, so they can't be compiled later.
+  TORCH_INTERNAL_ASSERT(!lazy || self);
   std::vector<Function*> functions;
   std::unordered_map<std::string, Function*> function_table;
 
@@ -4241,7 +4245,11 @@ std::vector<Function*> CompilationUnit::define(
   }
 
   for (Function* function : functions) {
-    function->ensure_defined();
+    if (lazy && function->name() != "__init__") {
+      static_cast<GraphFunction*>(function)->set_lazy();
+    } else {
+      function->ensure_defined();
+    }
   }
 
   return functions;
@@ -155,7 +155,7 @@ AliasDb::AliasDb(std::shared_ptr<Graph> graph, bool isFrozen)
   analyze(graph_);
 
   memoryDAG_ = std::make_unique<MemoryDAG>(std::move(memoryDAGBuilder_));
-  memoryDAGBuilder_ = nullptr; // to make further access a hard error
+  memoryDAGBuilder_ = nullptr; // from now on the DAG is edited in place
 
   memoryDAG_->setWildcards(
       wildcards_, elementMap_, [&](const Value* v) -> Element* {
@@ -163,8 +163,13 @@ AliasDb::AliasDb(std::shared_ptr<Graph> graph, bool isFrozen)
       });
 
   // Now we build up the various write indices based on information in the write
-  // registry that we populated during analysis
+  // registry that we populated during analysis. The registry is kept, so that
+  // addNode() can register the writes of new nodes and rebuild the indices.
+  rebuildWriteIndex();
+  GRAPH_DEBUG(toString());
+}
 
+void AliasDb::rebuildWriteIndex() {
   // Initialize the write index
   writeIndex_ = TWriteIndex();
   auto& writeIndex = *writeIndex_; // to make operator[] less ugly
@@ -172,7 +177,7 @@ AliasDb::AliasDb(std::shared_ptr<Graph> graph, bool isFrozen)
   // build the write index
   for (const auto& write : writeRegistry_->writes_) {
     Node* node = write.first;
-    const std::vector<const Value*> writtenValues = write.second;
+    const std::vector<const Value*>& writtenValues = write.second;
     for (const Value* writtenValue : writtenValues) {
       auto it = elementMap_.find(writtenValue);
       TORCH_INTERNAL_ASSERT(
@@ -188,10 +193,7 @@ AliasDb::AliasDb(std::shared_ptr<Graph> graph, bool isFrozen)
     const std::vector<const Value*>& writtenValues = write.second;
     for (const Value* writtenValue : writtenValues) {
       auto elem = elementMap_.at(writtenValue);
-      MemoryLocations writtenMemoryLocations;
-      memoryDAG_->collectAllContainedMemoryLocations(
-          elem, writtenMemoryLocations);
-      writeIndex[node] |= writtenMemoryLocations;
+      writeIndex[node] |= memoryDAG_->getAllContainedMemoryLocations(elem);
     }
   }
 
@@ -201,14 +203,68 @@ AliasDb::AliasDb(std::shared_ptr<Graph> graph, bool isFrozen)
     }
   }
 
-  // Now that we've built the write index, we can null out the WriteRegistry to
-  // make future access an error. In this way we prevent the index from getting
-  // out of sync (since we have no way of registering new writes)
-  writeRegistry_ = nullptr;
-
   // initialize the write cache
   writtenToLocationsIndex_ = buildWrittenToLocationsIndex();
-  GRAPH_DEBUG(toString());
+}
+
+void AliasDb::addNode(Node* n) {
+  // Analyze the node against the elements already in the DAG, and only set the
+  // wildcards it adds.
+  std::unordered_set<const Value*> oldWildcards;
+  std::swap(oldWildcards, wildcards_);
+  analyze(n);
+  memoryDAG_->setWildcards(
+      wildcards_, elementMap_, [&](const Value* v) -> Element* {
+        return getWildcard(v->type());
+      });
+  wildcards_.insert(oldWildcards.begin(), oldWildcards.end());
+
+  // The node may have made existing values point to more memory locations, so
+  // the writes of the other nodes are indexed again.
+  rebuildWriteIndex();
+}
+
+void AliasDb::removeNode(Node* n) {
+  // The elements of the values stay in the DAG, since other values may point
+  // to them.
+  std::function<void(Node*)> forgetValues = [&](Node* node) {
+    for (const Value* v : node->outputs()) {
+      auto it = elementMap_.find(v);
+      if (it != elementMap_.end()) {
+        it->second->values.erase(v);
+        elementMap_.erase(it);
+      }
+      wildcards_.erase(v);
+    }
+    for (Block* block : node->blocks()) {
+      for (const Value* v : block->inputs()) {
+        auto it = elementMap_.find(v);
+        if (it != elementMap_.end()) {
+          it->second->values.erase(v);
+          elementMap_.erase(it);
+        }
+        wildcards_.erase(v);
+      }
+      for (Node* inner : block->nodes()) {
+        forgetValues(inner);
+      }
+    }
+  };
+  forgetValues(n);
+
+  std::function<void(Node*)> forgetWrites = [&](Node* node) {
+    writeRegistry_->writes_.erase(node);
+    writeRegistry_->containedWrites_.erase(node);
+    writeRegistry_->writesToAllWildcards_.erase(node);
+    writeIndex_->erase(node);
+    for (Block* block : node->blocks()) {
+      for (Node* inner : block->nodes()) {
+        forgetWrites(inner);
+      }
+    }
+  };
+  forgetWrites(n);
+  writtenToLocationsIndex_ = buildWrittenToLocationsIndex();
 }
 
 bool AliasDb::isMutable(Node* n) const {
@@ -1022,8 +1078,7 @@ void AliasDb::analyzeContainerConstruct(Node* node) {
   for (auto input : node->inputs()) {
     auto maybe_wildcard_elem = setWildcard(input);
     if (maybe_wildcard_elem) {
-      memoryDAGBuilder_->addToContainedElements(
-          *maybe_wildcard_elem, container_elem);
+      addToContainedElementsImpl(*maybe_wildcard_elem, container_elem);
     }
   }
 }
@@ -1093,7 +1148,7 @@ void AliasDb::makePointerTo(const Value* from, const Value* to) {
   auto fromEl = getOrCreateElement(from);
   auto toEl = getOrCreateElement(to);
 
-  memoryDAGBuilder_->makePointerTo(fromEl, toEl);
+  makePointerToImpl(fromEl, toEl);
 }
 
 void AliasDb::addToContainedElements(
@@ -1108,7 +1163,32 @@ void AliasDb::addToContainedElements(
   auto elemEl = getOrCreateElement(elem);
   auto contEl = getOrCreateElement(container);
 
-  memoryDAGBuilder_->addToContainedElements(elemEl, contEl);
+  addToContainedElementsImpl(elemEl, contEl);
+}
+
+// The DAG is built by memoryDAGBuilder_ while the constructor analyzes the
+// graph, and edited in place when addNode() analyzes a node later on.
+void AliasDb::makePointerToImpl(Element* from, Element* to) {
+  if (memoryDAGBuilder_) {
+    memoryDAGBuilder_->makePointerTo(from, to);
+  } else {
+    memoryDAG_->unsafeMakePointerTo(from, to);
+  }
+}
+
+void AliasDb::addToContainedElementsImpl(Element* elem, Element* container) {
+  if (memoryDAGBuilder_) {
+    memoryDAGBuilder_->addToContainedElements(elem, container);
+  } else {
+    memoryDAG_->unsafeAddToContainedElements(elem, container);
+  }
+}
+
+Element* AliasDb::makeFreshValueImpl(const Value* v) {
+  if (memoryDAGBuilder_) {
+    return memoryDAGBuilder_->makeFreshValue(v);
+  }
+  return memoryDAG_->unsafeMakeFreshValue(v);
 }
 
 bool AliasDb::mayAlias(const Value* a, const Value* b) const {
@@ -1204,7 +1284,7 @@ void AliasDb::giveFreshAlias(
     return;
   }
 
-  auto new_elem = memoryDAGBuilder_->makeFreshValue(value);
+  auto new_elem = makeFreshValueImpl(value);
   elementMap_[value] = new_elem;
   if (add_wildcard_to_contained_elems) {
     addContainedTypesToFreshElement(new_elem, *maybe_mut_type);
@@ -1633,7 +1713,7 @@ c10::optional<Element*> AliasDb::tryGetOrCreateWildcard(const TypePtr& type) {
     return existing_wildcard->second;
   }
 
-  auto wildcard_elem = memoryDAGBuilder_->makeFreshValue(nullptr);
+  auto wildcard_elem = makeFreshValueImpl(nullptr);
   wildcardIndex_.emplace(mapped_type, wildcard_elem);
   addContainedTypesToFreshElement(wildcard_elem, mapped_type);
   return wildcard_elem;
@@ -1645,7 +1725,7 @@ void AliasDb::addContainedTypesToFreshElement(
   for (const auto& contained : mut_type->containedTypes()) {
     auto maybe_elem = tryGetOrCreateWildcard(contained);
     if (maybe_elem) {
-      memoryDAGBuilder_->addToContainedElements(*maybe_elem, container_elem);
+      addToContainedElementsImpl(*maybe_elem, container_elem);
     }
   }
 }
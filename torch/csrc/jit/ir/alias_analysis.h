@@ -146,6 +146,18 @@ class AliasDb {
   // Create a new `value` that does not alias anything else.
   void createValue(const Value* value);
 
+  // Keep the AliasDb up to date with the graph instead of building a new one
+  // for every change: call `addNode` after inserting `n` (and its inputs into
+  // the graph), and `removeNode` before destroying `n`. Replacing a node is
+  // `addNode` of the new node, `replaceAllUsesWith` and `removeNode` of the old
+  // one.
+  //
+  // Aliasing relationships are only ever added, so that removing a node
+  // leaves the aliases it created in place. The AliasDb stays correct but may
+  // become more conservative than a fresh one.
+  TORCH_API void addNode(Node* n);
+  TORCH_API void removeNode(Node* n);
+
   friend struct MutationRemover;
 
  private:
@@ -220,6 +232,9 @@ class AliasDb {
       const Value* value,
       bool add_wildcard_to_contained_elems = true);
   Element* getOrCreateElement(const Value* value);
+  void makePointerToImpl(Element* from, Element* to);
+  void addToContainedElementsImpl(Element* elem, Element* container);
+  Element* makeFreshValueImpl(const Value* v);
 
   c10::optional<TypePtr> getMutableTypePtr(const TypePtr& type) const;
   bool functionalNonEscapingListUse(const Use& use) const;
@@ -270,6 +285,8 @@ class AliasDb {
   // Collection of all memory locations that are written to.
   c10::optional<MemoryLocations> writtenToLocationsIndex_;
   MemoryLocations buildWrittenToLocationsIndex() const;
+  // Build writeIndex_ and writtenToLocationsIndex_ from writeRegistry_
+  void rebuildWriteIndex();
 
   std::unordered_set<const Value*> wildcards_;
 
@@ -398,7 +398,7 @@ void Node::lint() const {
       AT_ASSERT(
           std::find(ALL_OF(input->uses_), Use(const_cast<Node*>(this), i)) !=
           input->uses_.end());
-      AT_ASSERT(graph_->all_nodes.count(this) == 1);
+      AT_ASSERT(Graph::isTracked(graph_->all_nodes, this));
       i++;
     }
   }
@@ -508,7 +508,7 @@ void Graph::lint() const {
 
       for (auto use : v->uses()) {
         AT_ASSERT(!scope->contains(use.user));
-        AT_ASSERT(g.all_nodes.count(use.user) == 1);
+        AT_ASSERT(Graph::isTracked(g.all_nodes, use.user));
         anticipated_uses[use.user]++; // int default constructs to 0
       }
     }
@@ -624,7 +624,7 @@ Block::Block(Graph* graph_, Node* node_)
   output_->next() = input_;
   output_->prev() = input_;
 
-  graph_->all_blocks.emplace(this);
+  Graph::track(graph_->all_blocks, this);
   output_->owning_block_ = this;
   output_->topo_position_ = kUpperBound;
   input_->owning_block_ = this;
@@ -1084,6 +1084,11 @@ bool Node::hasSideEffects() const {
     case cuda::_set_device:
     case cuda::_current_device:
 #endif
+    case cuda::_streams_begin:
+    case cuda::_stream_use:
+    case cuda::_stream_wait:
+    case cuda::_stream_record:
+    case cuda::_streams_end:
     case prim::Enter:
     case prim::Exit:
       return true;
@@ -1194,7 +1199,7 @@ Node::Node(Graph* graph_, NodeKind kind_)
       callstack_(c10::nullopt),
       op_(nullptr),
       topo_position_(0) {
-  graph_->all_nodes.emplace(this);
+  Graph::track(graph_->all_nodes, this);
 }
 
 void Node::eraseOutput(size_t i) {
@@ -1304,14 +1309,14 @@ void Node::replaceInputWith(Value* from, Value* to) {
 }
 
 Value* Node::addOutput() {
-  outputs_.push_back(new Value(this, outputs_.size()));
+  outputs_.push_back(graph_->allocValue(this, outputs_.size()));
   op_ = nullptr;
   return outputs_.back();
 }
 
 Value* Node::insertOutput(size_t i) {
   op_ = nullptr;
-  outputs_.insert(outputs_.begin() + i, new Value(this, i));
+  outputs_.insert(outputs_.begin() + i, graph_->allocValue(this, i));
   for (size_t itr = i + 1; itr < outputs_.size(); ++itr) {
     outputs_[itr]->setOffset(outputs_[itr]->offset() + 1);
   }
@@ -1842,36 +1847,61 @@ std::string Graph::toString(bool print_source_locations) const {
   return oss.str();
 }
 
+// Note [Graph allocation]
+// Copying, specializing and fusing graphs creates and frees many nodes and
+// values, whose allocation and tracking used to dominate the passes on large
+// graphs. The graph tracks the objects it owns in vectors, each object holding
+// its position in them, so that tracking an object is a push_back and
+// untracking it moves the last object of the vector to its position. The
+// values, which outnumber the nodes, are also placed in chunks of storage
+// owned by the graph rather than allocated one by one, and the storage of the
+// freed values is reused. The nodes are still allocated separately, as the
+// subclasses of Node (e.g. PythonOp) differ in size.
 Graph::~Graph() {
   for (const Node* n : all_nodes) {
     delete n;
   }
-  for (const Value* v : all_values) {
-    delete v;
+  for (Value* v : all_values) {
+    v->~Value();
   }
   for (const Block* b : all_blocks) {
     delete b;
   }
 }
 
+Value* Graph::allocValue(Node* node, size_t offset) {
+  if (free_values_.empty()) {
+    // The chunks double in size up to kMaxValueChunkSize values
+    constexpr size_t kMinValueChunkSize = 16;
+    constexpr size_t kMaxValueChunkSize = 1024;
+    const size_t chunk_size = std::min(
+        kMinValueChunkSize << std::min<size_t>(value_chunks_.size(), 6),
+        kMaxValueChunkSize);
+    value_chunks_.emplace_back(new ValueStorage[chunk_size]);
+    ValueStorage* chunk = value_chunks_.back().get();
+    free_values_.reserve(chunk_size);
+    for (size_t i = chunk_size; i > 0; --i) {
+      free_values_.push_back(&chunk[i - 1]);
+    }
+  }
+  ValueStorage* storage = free_values_.back();
+  free_values_.pop_back();
+  return new (storage) Value(node, offset);
+}
+
 void Graph::freeNode(Node* n) {
-  auto it = all_nodes.find(n);
-  AT_ASSERT(it != all_nodes.end());
-  delete *it;
-  all_nodes.erase(it);
+  untrack(all_nodes, n);
+  delete n;
 }
 void Graph::freeValue(Value* v) {
   v->setDebugName("");
-  auto it = all_values.find(v);
-  AT_ASSERT(it != all_values.end());
-  delete *it;
-  all_values.erase(it);
+  untrack(all_values, v);
+  v->~Value();
+  free_values_.push_back(reinterpret_cast<ValueStorage*>(v));
 }
 void Graph::freeBlock(Block* b) {
-  auto it = all_blocks.find(b);
-  AT_ASSERT(it != all_blocks.end());
-  delete *it;
-  all_blocks.erase(it);
+  untrack(all_blocks, b);
+  delete b;
 }
 
 at::ArrayRef<Value*> createTupleUnpack(Value* v) {
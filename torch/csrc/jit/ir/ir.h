@@ -21,6 +21,8 @@
 
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <type_traits>
 #include <unordered_set>
 #include <vector>
 
@@ -169,14 +171,16 @@ struct Wrap {
 
 struct Value {
   TH_DISALLOW_COPY_AND_ASSIGN(Value);
-  Value(Node* node_, size_t offset_);
 
  private:
   friend struct Node;
   friend struct Graph;
+  // Values are created by Node::addOutput, in the storage of the graph
+  Value(Node* node_, size_t offset_);
   Node* node_;
   size_t offset_;
   size_t unique_ = 0; // unique id
+  size_t graph_index_ = 0; // position in the all_values of the graph
   use_list uses_;
   std::string unique_name_;
   TypePtr type_;
@@ -309,6 +313,7 @@ struct TORCH_API Node {
   // change the schema. note: mutable because schema_ is effectively a cache
   mutable const Operator* op_;
   topo_position_t topo_position_ = 0;
+  size_t graph_index_ = 0; // position in the all_nodes of the graph
   // a managing wrapper for Python to allow invalidation
   std::shared_ptr<Wrap<Node>> wrap_;
 
@@ -1067,6 +1072,7 @@ struct Block {
   Node* const input_;
   Node* const
       owning_node_; // either the node that has this block or nullptr for root
+  size_t graph_index_ = 0; // position in the all_blocks of the graph
   // a managing wrapper for Python to allow invalidation
   std::shared_ptr<Wrap<Block>> wrap_;
 };
@@ -1081,12 +1087,21 @@ struct Graph {
   // only used to keep track of allocated nodes
   // actual representation of Graph is done with
   // inputs, outputs, nodes
-
-  std::unordered_set<const Node*> all_nodes;
-  std::unordered_set<const Value*> all_values;
-  std::unordered_set<const Block*> all_blocks;
+  //
+  // Each node, value and block holds its position in these lists, so that it
+  // is tracked and untracked without hashing (see Note [Graph allocation])
+  std::vector<Node*> all_nodes;
+  std::vector<Value*> all_values;
+  std::vector<Block*> all_blocks;
   size_t next_unique_;
 
+  // The values are placed in chunks of storage owned by the graph, which are
+  // reused as values are freed
+  using ValueStorage =
+      std::aligned_storage<sizeof(Value), alignof(Value)>::type;
+  std::vector<std::unique_ptr<ValueStorage[]>> value_chunks_;
+  std::vector<ValueStorage*> free_values_;
+
   std::unordered_map<std::string, Value*> unique_names_;
 
   ScopePtr current_scope_;
@@ -1324,6 +1339,26 @@ struct Graph {
 
  private:
   friend void Lint(const AliasDb* db);
+  // Adding and removing the objects of all_nodes, all_values and all_blocks
+  template <typename T>
+  static void track(std::vector<T*>& all, T* item) {
+    item->graph_index_ = all.size();
+    all.push_back(item);
+  }
+  template <typename T>
+  static void untrack(std::vector<T*>& all, T* item) {
+    AT_ASSERT(isTracked(all, item));
+    T* last = all.back();
+    all[item->graph_index_] = last;
+    last->graph_index_ = item->graph_index_;
+    all.pop_back();
+  }
+  template <typename T>
+  static bool isTracked(const std::vector<T*>& all, const T* item) {
+    return item->graph_index_ < all.size() && all[item->graph_index_] == item;
+  }
+
+  TORCH_API Value* allocValue(Node* node, size_t offset);
   TORCH_API void freeNode(Node* n);
   TORCH_API void freeValue(Value* v);
   TORCH_API void freeBlock(Block* b);
@@ -1373,7 +1408,7 @@ inline Value::Value(Node* node_, size_t offset_)
       offset_(offset_),
       unique_(node_->graph_->next_unique_++),
       type_(TensorType::get()) {
-  node_->graph_->all_values.emplace(this);
+  Graph::track(node_->graph_->all_values, this);
 }
 
 inline Value* Value::setType(TypePtr type) {
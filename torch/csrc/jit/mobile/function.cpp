@@ -1,19 +1,98 @@
 #include <torch/csrc/jit/mobile/function.h>
 
+#include <c10/mobile/CPUCachingAllocator.h>
+#include <c10/mobile/CPUProfilingAllocator.h>
 #include <caffe2/serialize/inline_container.h>
 #include <torch/csrc/jit/mobile/interpreter.h>
 #include <torch/csrc/jit/runtime/instruction.h>
 #include <torch/csrc/jit/runtime/operator.h>
 #include <torch/custom_class_detail.h>
 
+#include <cstring>
+#include <map>
+#include <mutex>
+
 namespace torch {
 namespace jit {
 
 char const* toString(OpCode op);
 namespace mobile {
+
+// Note [Mobile memory planning]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// With memory planning, a function plans the CPU allocations of its runs
+// with the profiling allocator of c10/mobile, separately for each shape of
+// the tensor inputs and value of the scalar inputs:
+//  1. The first run records the size and lifetime of each allocation it
+//     makes, and the allocations freed before the end of the run get an
+//     offset in one arena.
+//  2. The second run checks that it makes the same allocations, which fail
+//     to match when they depend on the values in the input tensors.
+//  3. The later runs place the planned allocations in the arena, which is
+//     allocated once for the largest plan, instead of going to the allocator.
+// The outputs and the other tensors that outlive a run are allocated as
+// usual. A planned run whose allocations differ from the plan fails, so
+// functions whose allocations depend on anything but the inputs, e.g. on
+// the attributes of the module, must not be planned.
+//
+// The arena is used by one run at a time: runs concurrent with a planned
+// run, nested in the run of another planned function, or in the scope of
+// another mobile allocator run unplanned. Plans only take effect with the
+// mobile CPU allocator, i.e. in C10_MOBILE builds.
+
+constexpr size_t kMaxMemoryPlans = 8;
+
+struct Function::MemoryPlans {
+  enum class State { Unprofiled, Profiled, Validated, Invalid };
+  struct Plan {
+    State state = State::Unprofiled;
+    c10::AllocationPlan plan;
+  };
+
+  // held while running under a plan
+  std::mutex mutex;
+  std::map<std::vector<int64_t>, Plan> plans;
+  c10::CPUProfilingAllocator allocator;
+};
+
+namespace {
+// The shapes of the tensors and the values of the scalars in the inputs
+std::vector<int64_t> memoryPlanKey(const Stack& stack) {
+  std::vector<int64_t> key;
+  for (const IValue& input : stack) {
+    if (input.isTensor()) {
+      const at::Tensor& t = input.toTensor();
+      key.push_back(0);
+      key.push_back(t.defined() ? t.dim() : -1);
+      if (t.defined()) {
+        key.push_back(static_cast<int64_t>(t.scalar_type()));
+        key.insert(key.end(), t.sizes().begin(), t.sizes().end());
+      }
+    } else if (input.isInt()) {
+      key.push_back(1);
+      key.push_back(input.toInt());
+    } else if (input.isBool()) {
+      key.push_back(2);
+      key.push_back(input.toBool());
+    } else if (input.isDouble()) {
+      double value = input.toDouble();
+      int64_t bits = 0;
+      std::memcpy(&bits, &value, sizeof(bits));
+      key.push_back(3);
+      key.push_back(bits);
+    } else {
+      key.push_back(4);
+    }
+  }
+  return key;
+}
+} // namespace
+
 Function::Function(c10::QualifiedName name)
     : name_(std::move(name)), code_(std::make_shared<Code>()) {}
 
+Function::~Function() = default;
+
 const c10::QualifiedName& Function::qualname() const {
   return name_;
 }
@@ -27,29 +106,49 @@ void Function::append_instruction(OpCode op, int X, int N) {
       isOpSupportedInMobile(op),
       toString(op),
       " is not supported in mobile module.");
-  code_->instructions_.emplace_back(op, X, N);
+  // Fuse the superinstructions, see Note [Mobile interpreter dispatch]
+  auto& instructions = code_->instructions_;
+  if (!instructions.empty()) {
+    Instruction& prev = instructions.back();
+    if (prev.op == LOAD && op == OP) {
+      prev.op = LOAD_OP;
+    } else if (prev.op == MOVE && op == RET) {
+      prev.op = MOVE_RET;
+    }
+  }
+  instructions.emplace_back(op, X, N);
 }
 
 bool Function::append_operator(
     const std::string& name,
     const std::string& overload_name,
-    int64_t model_version) {
+    int64_t model_version,
+    OperatorCache* cache) {
   // Keep the original opname in code_
   code_->op_names_.emplace_back(name, overload_name);
-  auto opname = code_->op_names_.back();
+  const auto& opname = code_->op_names_.back();
 
-  const auto& opname_c10 = opname;
   std::function<void(Stack&)> fn;
-
-  auto jit_op = findOperatorFor(opname);
-  if (jit_op) {
-    fn = [jit_op](Stack& stack) { jit_op->getOperation()(&stack); };
-  } else {
-    auto op = c10::Dispatcher::singleton().findSchema(opname_c10);
-    if (op.has_value()) {
-      fn = [op](Stack& stack) { op->callBoxed(&stack); };
+  if (cache) {
+    auto it = cache->find(opname);
+    if (it != cache->end()) {
+      fn = it->second;
+    }
+  }
+  if (!fn) {
+    auto jit_op = findOperatorFor(opname);
+    if (jit_op) {
+      fn = [jit_op](Stack& stack) { jit_op->getOperation()(&stack); };
     } else {
-      return false;
+      auto op = c10::Dispatcher::singleton().findSchema(opname);
+      if (op.has_value()) {
+        fn = [op](Stack& stack) { op->callBoxed(&stack); };
+      } else {
+        return false;
+      }
+    }
+    if (cache) {
+      cache->emplace(opname, fn);
     }
   }
 
@@ -66,15 +165,24 @@ bool Function::append_operator(
     };
   }
 
-  code_->operators_.emplace_back(fn);
+  code_->operators_.emplace_back(std::move(fn));
   return true;
 }
 
+void Function::reserve(
+    size_t num_instructions,
+    size_t num_operators,
+    size_t num_constants,
+    size_t num_types) {
+  code_->instructions_.reserve(num_instructions);
+  code_->op_names_.reserve(num_operators);
+  code_->operators_.reserve(num_operators);
+  code_->constants_.reserve(num_constants);
+  code_->types_.reserve(num_types);
+}
+
 void Function::set_module_debug_info_list_size(size_t size) {
   pc_to_module_debug_info_.resize(size);
-  for (size_t i = 0; i < size; ++i) {
-    pc_to_module_debug_info_[i] = "<no module info>";
-  }
 }
 
 void Function::set_module_info(const std::string& module_info, size_t pc) {
@@ -100,7 +208,8 @@ std::string Function::get_module_debug_info(size_t pc) const {
   TORCH_CHECK(
       pc < pc_to_module_debug_info_.size(),
       "Module debug info index out of boundary.");
-  return pc_to_module_debug_info_[pc];
+  const std::string& module_info = pc_to_module_debug_info_[pc];
+  return module_info.empty() ? "<no module info>" : module_info;
 }
 
 void Function::setSchema(c10::FunctionSchema schema) {
@@ -117,10 +226,81 @@ bool Function::run(Stack& stack) const {
     schema->checkAndNormalizeInputs(
         stack, std::unordered_map<std::string, IValue>{} /*kwargs*/);
   }
+  if (memory_plans_) {
+    return run_with_memory_plan(stack);
+  }
   InterpreterState interp_state(code_);
   return interp_state.run(stack);
 }
 
+void Function::set_memory_planning(bool enabled) {
+  if (!enabled) {
+    memory_plans_.reset();
+  } else if (!memory_plans_) {
+    memory_plans_ = std::make_unique<MemoryPlans>();
+  }
+}
+
+bool Function::run_with_memory_plan(Stack& stack) const {
+  auto run_interpreter = [&]() {
+    InterpreterState interp_state(code_);
+    return interp_state.run(stack);
+  };
+  std::unique_lock<std::mutex> lock(memory_plans_->mutex, std::try_to_lock);
+  if (!lock.owns_lock() || c10::GetThreadLocalAllocationPlanner() ||
+      c10::GetThreadLocalProfilingAllocator() ||
+      c10::GetThreadLocalCachingAllocator()) {
+    return run_interpreter();
+  }
+
+  auto& plans = memory_plans_->plans;
+  auto key = memoryPlanKey(stack);
+  auto it = plans.find(key);
+  if (it == plans.end()) {
+    if (plans.size() >= kMaxMemoryPlans) {
+      return run_interpreter();
+    }
+    it = plans.emplace(std::move(key), MemoryPlans::Plan()).first;
+  }
+  MemoryPlans::Plan& entry = it->second;
+  using State = MemoryPlans::State;
+  bool result = false;
+  switch (entry.state) {
+    case State::Unprofiled: {
+      // until the run completes
+      entry.state = State::Invalid;
+      {
+        c10::WithProfileAllocationsGuard guard(&entry.plan);
+        result = run_interpreter();
+      }
+      entry.state = State::Profiled;
+    } break;
+    case State::Profiled: {
+      entry.state = State::Invalid;
+      bool success = false;
+      {
+        c10::WithValidateAllocationPlanGuard guard(&entry.plan, &success);
+        result = run_interpreter();
+      }
+      entry.state = success ? State::Validated : State::Invalid;
+    } break;
+    case State::Validated: {
+      try {
+        c10::WithProfilingAllocatorGuard guard(
+            &memory_plans_->allocator, &entry.plan);
+        result = run_interpreter();
+      } catch (...) {
+        entry.state = State::Invalid;
+        throw;
+      }
+    } break;
+    case State::Invalid:
+      result = run_interpreter();
+      break;
+  }
+  return result;
+}
+
 c10::IValue Function::operator()(Stack& stack) const {
   run(stack);
   return stack.front();
@@ -2,6 +2,9 @@
 
 #include <ATen/core/function_schema.h>
 #include <ATen/core/ivalue.h>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace torch {
@@ -12,9 +15,16 @@ enum OpCode : uint8_t;
 namespace mobile {
 struct Code;
 
+// The operators already looked up while loading a module, by name. A module
+// uses few distinct operators across its functions, so resolving them through
+// the cache saves most of the searches of the operator registry.
+using OperatorCache =
+    std::unordered_map<c10::OperatorName, std::function<void(Stack&)>>;
+
 class Function {
  public:
   Function(c10::QualifiedName name);
+  ~Function();
   bool run(Stack& stack) const;
   c10::IValue operator()(Stack& stack) const;
   const std::string& name() const;
@@ -23,7 +33,14 @@ class Function {
   bool append_operator(
       const std::string& name,
       const std::string& overload_name,
-      int64_t model_version);
+      int64_t model_version,
+      OperatorCache* cache = nullptr);
+  // Reserves the tables of the code for the given numbers of entries.
+  void reserve(
+      size_t num_instructions,
+      size_t num_operators,
+      size_t num_constants,
+      size_t num_types);
   void set_module_debug_info_list_size(size_t size);
   void set_module_info(const std::string& module_info, size_t pc);
   void append_constant(const c10::IValue& constant);
@@ -37,11 +54,22 @@ class Function {
   void setSchema(c10::FunctionSchema schema);
   const at::optional<c10::FunctionSchema>& getSchema() const;
 
+  // Plans the CPU memory of the later runs from the allocations of the
+  // earlier runs with the same inputs, see Note [Mobile memory planning].
+  // Off by default.
+  void set_memory_planning(bool enabled);
+
  private:
+  struct MemoryPlans;
+  bool run_with_memory_plan(Stack& stack) const;
+
   c10::QualifiedName name_;
   std::shared_ptr<Code> code_;
   at::optional<c10::FunctionSchema> schema_; // (byte-code version 4+)
+  // empty for the instructions without module info
   std::vector<std::string> pc_to_module_debug_info_;
+  // set if memory planning is enabled
+  std::unique_ptr<MemoryPlans> memory_plans_;
 };
 
 } // namespace mobile
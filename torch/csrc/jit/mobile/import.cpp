@@ -195,6 +195,8 @@ void BytecodeDeserializer::parseMethods(
         "The numbers of bytecode values and debug info values do not match.");
   }
 
+  mobile::OperatorCache operator_cache;
+
   // Process all methods in this mobile module.
   for (size_t i = method_i_start; i < vals.size(); ++i) {
     const auto& element = vals[i];
@@ -250,22 +252,24 @@ void BytecodeDeserializer::parseMethods(
           "The numbers of operators and module info strings do not match.");
     }
 
+    function->reserve(
+        ins_list.size(),
+        ops_list.size(),
+        consts_list.size(),
+        types_list.size());
     function->set_module_debug_info_list_size(ins_list.size());
     for (size_t i = 0; i < ins_list.size(); ++i) {
-      auto ins_item = ins_list[i].toTuple()->elements();
+      const auto& ins_item = ins_list[i].toTuple()->elements();
       TORCH_CHECK(
           ins_item.size() == 3,
           "There should be three parts in an instruction. The function name is ",
           function_name);
-      OpCode op_code = parseOpCode(ins_item[0].toString()->string().c_str());
+      OpCode op_code = parseOpCode(ins_item[0].toStringRef().c_str());
       int X = ins_item[1].toInt();
       int N = ins_item[2].toInt();
       function->append_instruction(op_code, X, N);
-      if (op_code == OP) {
-        std::string module_debug_info = (has_debug_info)
-            ? module_debug_info_list[X].toString()->string()
-            : "";
-        function->set_module_info(module_debug_info, i);
+      if (op_code == OP && has_debug_info) {
+        function->set_module_info(module_debug_info_list[X].toStringRef(), i);
       }
     }
 
@@ -273,17 +277,16 @@ void BytecodeDeserializer::parseMethods(
     // ops_list is the list of operator names that were read in from
     // bytecode.plk for the method that is currently being processed.
     for (const auto& op : ops_list) {
-      auto op_item = op.toTuple()->elements();
+      const auto& op_item = op.toTuple()->elements();
       TORCH_CHECK(
           op_item.size() == 2,
           "There should be two parts in an operator name.");
+      const std::string& name = op_item[0].toStringRef();
+      const std::string& overload_name = op_item[1].toStringRef();
       auto op_found = function->append_operator(
-          op_item[0].toString()->string(),
-          op_item[1].toString()->string(),
-          model_version);
+          name, overload_name, model_version, &operator_cache);
       if (!op_found) {
-        unsupported_op_names.emplace(operator_str(
-            op_item[0].toString()->string(), op_item[1].toString()->string()));
+        unsupported_op_names.emplace(operator_str(name, overload_name));
       }
     }
     if (!unsupported_op_names.empty()) {
@@ -401,7 +404,8 @@ mobile::Module BytecodeDeserializer::deserialize(
   // being a Tuple (int, table), and the integer stands for the bytecode version
   // number. The rest of the elements are the same as before.
   //
-  auto bvals = readArchive("bytecode", mcu).toTuple()->elements();
+  auto bytecode = readArchive("bytecode", mcu).toTuple();
+  const auto& bvals = bytecode->elements();
 
   c10::optional<std::vector<IValue>> debug_info_bvals;
   if (reader_->hasRecord("mobile_debug.pkl")) {
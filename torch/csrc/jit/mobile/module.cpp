@@ -6,6 +6,7 @@
 #include <exception>
 
 #include <ATen/record_function.h>
+#include <c10/util/Optional.h>
 
 namespace torch {
 namespace jit {
@@ -128,6 +129,13 @@ const std::vector<Method> Module::get_methods() const {
 Method::Method(const Module* owner, Function* function)
     : owner_(owner), function_(function) {}
 
+namespace {
+// Whether to sample a method invocation for stats, at rate from 0 to 1
+bool sampleInvocation(double rate) {
+  return rate >= 1. || (rate > 0. && std::rand() < rate * RAND_MAX);
+}
+} // namespace
+
 void Method::run(Stack& stack) const {
   auto observer = torch::observerConfig().getModuleObserver();
   auto instance_key = std::rand();
@@ -147,12 +155,36 @@ void Method::run(Stack& stack) const {
   std::string name = copied_metadata["model_name"];
   debug_info->setModelName(name);
   debug_info->setMethodName(function_->name());
+  if (observer) {
+    const auto& config = torch::observerConfig();
+    debug_info->setRecordsOpStats(
+        sampleInvocation(config.getOpStatsSamplingRate()));
+    // The memory tracker would take the place of the state of a running
+    // profiler
+    debug_info->setRecordsMemoryStats(
+        sampleInvocation(config.getMemoryStatsSamplingRate()) &&
+        !c10::ThreadLocalDebugInfo::get(c10::DebugInfoKind::PROFILER_STATE));
+  }
   at::DebugInfoGuard guard(at::DebugInfoKind::MOBILE_RUNTIME_INFO, debug_info);
 
+  std::shared_ptr<MobileMemoryTracker> memory_tracker;
+  c10::optional<at::DebugInfoGuard> memory_guard;
+  if (debug_info->recordsMemoryStats()) {
+    memory_tracker = std::make_shared<MobileMemoryTracker>();
+    memory_guard.emplace(c10::DebugInfoKind::PROFILER_STATE, memory_tracker);
+  }
+
   try {
     stack.insert(stack.begin(), owner_->_ivalue()); // self
     function_->run(stack);
     if (observer) {
+      if (memory_tracker) {
+        debug_info->setPeakMemoryBytes(memory_tracker->getPeakBytes());
+        debug_info->setNumAllocations(memory_tracker->getNumAllocations());
+      }
+      if (debug_info->recordsOpStats() || debug_info->recordsMemoryStats()) {
+        observer->onRunMethodStats(instance_key, *debug_info);
+      }
       observer->onExitRunMethod(instance_key);
     }
   } catch (c10::Error& error) {
@@ -7,4 +7,18 @@ MobileObserverConfig& observerConfig() {
   return instance;
 }
 
+void MobileMemoryTracker::reportMemoryUsage(
+    void* /* unused */,
+    int64_t alloc_size,
+    c10::Device device) {
+  if (!device.is_cpu()) {
+    return;
+  }
+  if (alloc_size > 0) {
+    num_allocations_++;
+  }
+  allocated_bytes_ += alloc_size;
+  peak_bytes_ = std::max(peak_bytes_, allocated_bytes_);
+}
+
 } // namespace torch
@@ -1,14 +1,26 @@
 #pragma once
 
+#include <ATen/core/operator_name.h>
+#include <c10/core/Allocator.h>
 #include <c10/util/ThreadLocalDebugInfo.h>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
 namespace torch {
 
+// Latency of the runs of an operator within one method invocation
+struct MobileOpStats {
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+};
+
 class MobileDebugInfo : public c10::DebugInfoBase {
  public:
-  const std::string& getModelName() {
+  const std::string& getModelName() const {
     return model_name_;
   }
 
@@ -16,7 +28,7 @@ class MobileDebugInfo : public c10::DebugInfoBase {
     model_name_ = model_name;
   }
 
-  const std::string& getMethodName() {
+  const std::string& getMethodName() const {
     return method_name_;
   }
 
@@ -24,7 +36,7 @@ class MobileDebugInfo : public c10::DebugInfoBase {
     method_name_ = method_name;
   }
 
-  size_t getOpIdx() {
+  size_t getOpIdx() const {
     return op_idx_;
   }
 
@@ -32,6 +44,56 @@ class MobileDebugInfo : public c10::DebugInfoBase {
     op_idx_ = op_idx;
   }
 
+  // Whether the lite interpreter times the operators of this invocation,
+  // see MobileObserverConfig::setOpStatsSamplingRate
+  bool recordsOpStats() const {
+    return records_op_stats_;
+  }
+
+  void setRecordsOpStats(bool records_op_stats) {
+    records_op_stats_ = records_op_stats;
+  }
+
+  void recordOpLatency(const c10::OperatorName& op_name, uint64_t ns) {
+    auto& stats = op_stats_[op_name];
+    stats.count++;
+    stats.total_ns += ns;
+    stats.max_ns = std::max(stats.max_ns, ns);
+  }
+
+  const std::unordered_map<c10::OperatorName, MobileOpStats>& getOpStats()
+      const {
+    return op_stats_;
+  }
+
+  // Whether the CPU allocations of this invocation are tracked, see
+  // MobileObserverConfig::setMemoryStatsSamplingRate
+  bool recordsMemoryStats() const {
+    return records_memory_stats_;
+  }
+
+  void setRecordsMemoryStats(bool records_memory_stats) {
+    records_memory_stats_ = records_memory_stats;
+  }
+
+  // High-water mark of the CPU memory allocated during the invocation, on
+  // top of the memory allocated before it
+  int64_t getPeakMemoryBytes() const {
+    return peak_memory_bytes_;
+  }
+
+  void setPeakMemoryBytes(int64_t peak_memory_bytes) {
+    peak_memory_bytes_ = peak_memory_bytes;
+  }
+
+  size_t getNumAllocations() const {
+    return num_allocations_;
+  }
+
+  void setNumAllocations(size_t num_allocations) {
+    num_allocations_ = num_allocations;
+  }
+
   virtual ~MobileDebugInfo() {}
 
  private:
@@ -62,6 +124,37 @@ class MobileDebugInfo : public c10::DebugInfoBase {
   // getting bothered about passing CachingAllocatorInfo across thread
   // boundaries. c10::CachingAllocatorInfo caching_allocator_info;
   size_t op_idx_ = 0;
+  bool records_op_stats_ = false;
+  bool records_memory_stats_ = false;
+  std::unordered_map<c10::OperatorName, MobileOpStats> op_stats_;
+  int64_t peak_memory_bytes_ = 0;
+  size_t num_allocations_ = 0;
+};
+
+// Tracks the CPU memory allocated while it is the PROFILER_STATE debug info
+// of the thread. The profilers keep their state there as well, so the
+// invocations run under a profiler are not tracked.
+class MobileMemoryTracker : public c10::MemoryReportingInfoBase {
+ public:
+  void reportMemoryUsage(void* ptr, int64_t alloc_size, c10::Device device)
+      override;
+
+  bool memoryProfilingEnabled() const override {
+    return true;
+  }
+
+  int64_t getPeakBytes() const {
+    return peak_bytes_;
+  }
+
+  size_t getNumAllocations() const {
+    return num_allocations_;
+  }
+
+ private:
+  int64_t allocated_bytes_ = 0;
+  int64_t peak_bytes_ = 0;
+  size_t num_allocations_ = 0;
 };
 
 class MobileModuleObserver {
@@ -73,6 +166,9 @@ class MobileModuleObserver {
       const int32_t,
       const std::string&) {}
   virtual void onExitRunMethod(const int32_t) {}
+  // Called before onExitRunMethod, for the method invocations sampled for
+  // op or memory stats
+  virtual void onRunMethodStats(const int32_t, const MobileDebugInfo&) {}
   virtual void onFailRunMethod(const int32_t, const char*) {}
   virtual void onEnterLoadModel(const int32_t) {}
   virtual void onExitLoadModel(
@@ -94,8 +190,27 @@ class MobileObserverConfig {
     return module_observer_.get();
   }
 
+  // Fraction of the method invocations whose operators are timed (0 to 1)
+  void setOpStatsSamplingRate(double rate) {
+    op_stats_sampling_rate_ = rate;
+  }
+  double getOpStatsSamplingRate() const {
+    return op_stats_sampling_rate_;
+  }
+
+  // Fraction of the method invocations whose peak CPU memory is tracked
+  // (0 to 1)
+  void setMemoryStatsSamplingRate(double rate) {
+    memory_stats_sampling_rate_ = rate;
+  }
+  double getMemoryStatsSamplingRate() const {
+    return memory_stats_sampling_rate_;
+  }
+
  private:
   std::unique_ptr<MobileModuleObserver> module_observer_;
+  double op_stats_sampling_rate_ = 0.;
+  double memory_stats_sampling_rate_ = 0.;
 };
 
 MobileObserverConfig& observerConfig();
@@ -0,0 +1,309 @@
+#include <torch/csrc/jit/passes/assign_cuda_streams.h>
+
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/jit_log.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+bool isTensor(const Value* v) {
+  return v->type()->kind() == TypeKind::TensorType;
+}
+
+bool isTensorList(const Value* v) {
+  auto list = v->type()->cast<ListType>();
+  return list && list->getElementType()->kind() == TypeKind::TensorType;
+}
+
+bool containsTensors(const TypePtr& type) {
+  if (type->kind() == TypeKind::TensorType) {
+    return true;
+  }
+  for (const TypePtr& contained : type->containedTypes()) {
+    if (containsTensors(contained)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool hasCudaTensors(const Block* block) {
+  auto is_cuda = [](const Value* v) {
+    auto tensor = v->type()->cast<TensorType>();
+    return tensor && tensor->device() && tensor->device()->is_cuda();
+  };
+  if (std::any_of(block->inputs().begin(), block->inputs().end(), is_cuda)) {
+    return true;
+  }
+  for (const Node* n : block->nodes()) {
+    if (std::any_of(n->outputs().begin(), n->outputs().end(), is_cuda)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Nodes that don't launch work on a device: those without tensors, and the
+// constants
+bool isHostNode(const Node* n) {
+  if (n->kind() == prim::Constant) {
+    return true;
+  }
+  auto has_tensors = [](const Value* v) { return containsTensors(v->type()); };
+  return std::none_of(n->inputs().begin(), n->inputs().end(), has_tensors) &&
+      std::none_of(n->outputs().begin(), n->outputs().end(), has_tensors);
+}
+
+// Nodes that run on the stream the graph started on, once all the streams
+// are joined. The order of the nodes that use mutated values is not given by
+// their data dependencies, and the tensors in values of other types than
+// Tensor and Tensor[] can't be recorded on the streams that use them.
+bool isBarrier(const Node* n, const AliasDb& alias_db) {
+  if (!n->blocks().empty() || n->hasSideEffects() || alias_db.hasWriters(n)) {
+    return true;
+  }
+  auto unrecordable = [](const Value* v) {
+    return containsTensors(v->type()) && !isTensor(v) && !isTensorList(v);
+  };
+  return std::any_of(n->inputs().begin(), n->inputs().end(), unrecordable) ||
+      std::any_of(n->outputs().begin(), n->outputs().end(), unrecordable);
+}
+
+class CudaStreamAssigner {
+ public:
+  CudaStreamAssigner(std::shared_ptr<Graph> graph, size_t num_streams)
+      : graph_(std::move(graph)),
+        num_streams_(num_streams),
+        nodes_(graph_->nodes().begin(), graph_->nodes().end()),
+        launches_(num_streams, 0),
+        waited_(num_streams, std::vector<int64_t>(num_streams, 0)) {}
+
+  void run() {
+    if (num_streams_ < 2 || nodes_.empty() || !hasCudaTensors(graph_->block())) {
+      return;
+    }
+    alias_db_ = std::make_unique<AliasDb>(graph_);
+    if (!assignStreams()) {
+      GRAPH_DEBUG("No independent branches to run on several streams");
+      return;
+    }
+    insertStreamOps();
+  }
+
+ private:
+  // Returns whether any node runs on another stream than the first one
+  bool assignStreams() {
+    std::unordered_set<const Value*> in_region;
+    std::unordered_set<const Node*> continued;
+    bool entry_continued = false;
+    int64_t next_stream = 1;
+    bool forked = false;
+    for (Node* n : nodes_) {
+      if (isBarrier(n, *alias_db_)) {
+        barriers_.insert(n);
+        in_region.clear();
+        continued.clear();
+        entry_continued = false;
+        continue;
+      }
+      if (isHostNode(n)) {
+        continue;
+      }
+      int64_t stream = -1;
+      bool has_region_inputs = false;
+      for (Value* input : n->inputs()) {
+        if (!in_region.count(input)) {
+          continue;
+        }
+        has_region_inputs = true;
+        if (continued.insert(input->node()).second) {
+          stream = stream_of_.at(input->node());
+          break;
+        }
+      }
+      if (stream < 0) {
+        if (!has_region_inputs && !entry_continued) {
+          entry_continued = true;
+          stream = 0;
+        } else {
+          stream = next_stream;
+          next_stream = next_stream % (num_streams_ - 1) + 1;
+        }
+      }
+      forked |= stream != 0;
+      stream_of_[n] = stream;
+      for (Value* output : n->outputs()) {
+        in_region.insert(output);
+      }
+    }
+    return forked;
+  }
+
+  struct Production {
+    int64_t stream;
+    // position of the producer among the nodes launched on its stream
+    int64_t launch;
+  };
+
+  void insertStreamOps() {
+    {
+      WithInsertPoint guard(nodes_.front());
+      insertOp(
+          cuda::_streams_begin,
+          {graph_->insertConstant(static_cast<int64_t>(num_streams_))});
+    }
+    beginRegion();
+    for (Node* n : nodes_) {
+      if (barriers_.count(n)) {
+        joinStreams(n);
+        beginRegion();
+        continue;
+      }
+      if (isHostNode(n)) {
+        continue;
+      }
+      const int64_t stream = stream_of_.at(n);
+      WithInsertPoint guard(n);
+      std::vector<Value*> recorded;
+      for (Value* input : n->inputs()) {
+        if (!containsTensors(input->type()) ||
+            input->node()->kind() == prim::Constant) {
+          continue;
+        }
+        auto it = produced_.find(input);
+        const Production production = it != produced_.end()
+            ? it->second
+            : Production{0, entry_launch_};
+        if (production.stream == stream) {
+          continue;
+        }
+        if (production.launch >= waited_[stream][production.stream]) {
+          waitFor(production.stream, stream);
+        }
+        recorded.push_back(input);
+      }
+      recordOn(recorded, stream);
+      useStream(stream);
+      for (Value* output : n->outputs()) {
+        produced_[output] = Production{stream, launches_[stream]};
+      }
+      launches_[stream]++;
+    }
+    joinStreams(graph_->return_node());
+    WithInsertPoint guard(graph_->return_node());
+    insertOp(cuda::_streams_end, {});
+  }
+
+  // The values of the graph inputs and of the nodes before a barrier are
+  // ready on the first stream once its launches so far are done
+  void beginRegion() {
+    produced_.clear();
+    entry_launch_ = launches_[0]++;
+  }
+
+  // Makes the first stream wait for the others before node, and records the
+  // tensors of the other streams that node or the nodes after it use
+  void joinStreams(Node* node) {
+    WithInsertPoint guard(node);
+    useStream(0);
+    for (size_t stream = 1; stream < num_streams_; stream++) {
+      if (launches_[stream] > waited_[0][stream]) {
+        waitFor(stream, 0);
+      }
+    }
+    std::vector<Value*> recorded;
+    for (const auto& entry : produced_) {
+      if (entry.second.stream != 0 && isUsedFrom(entry.first, node)) {
+        recorded.push_back(entry.first);
+      }
+    }
+    // the order of produced_ is arbitrary
+    std::sort(
+        recorded.begin(), recorded.end(), [](const Value* a, const Value* b) {
+          return a->unique() < b->unique();
+        });
+    recordOn(recorded, 0);
+  }
+
+  static bool isUsedFrom(const Value* value, Node* node) {
+    for (const Use& use : value->uses()) {
+      Node* user = use.user;
+      while (user->owningBlock() != node->owningBlock()) {
+        user = user->owningBlock()->owningNode();
+      }
+      if (user == node || node->isBefore(user)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void waitFor(int64_t producer, int64_t consumer) {
+    insertOp(
+        cuda::_stream_wait,
+        {graph_->insertConstant(producer), graph_->insertConstant(consumer)});
+    waited_[consumer][producer] = launches_[producer];
+  }
+
+  void recordOn(const std::vector<Value*>& values, int64_t stream) {
+    std::vector<Value*> tensors;
+    for (Value* value : values) {
+      if (isTensorList(value)) {
+        insertOp(cuda::_stream_record, {value, graph_->insertConstant(stream)});
+      } else {
+        tensors.push_back(value);
+      }
+    }
+    if (!tensors.empty()) {
+      Value* list =
+          graph_->insertNode(graph_->createList(TensorType::get(), tensors))
+              ->output();
+      insertOp(cuda::_stream_record, {list, graph_->insertConstant(stream)});
+    }
+  }
+
+  void useStream(int64_t stream) {
+    if (stream != current_stream_) {
+      insertOp(cuda::_stream_use, {graph_->insertConstant(stream)});
+      current_stream_ = stream;
+    }
+  }
+
+  void insertOp(Symbol kind, at::ArrayRef<Value*> inputs) {
+    graph_->insertNode(graph_->create(kind, inputs, /*num_outputs=*/0));
+  }
+
+  std::shared_ptr<Graph> graph_;
+  const size_t num_streams_;
+  // the top-level nodes, without the ones the pass inserts
+  const std::vector<Node*> nodes_;
+  std::unique_ptr<AliasDb> alias_db_;
+  std::unordered_map<const Node*, int64_t> stream_of_;
+  std::unordered_set<const Node*> barriers_;
+
+  std::unordered_map<Value*, Production> produced_;
+  int64_t entry_launch_ = 0;
+  int64_t current_stream_ = 0;
+  // number of nodes launched on each stream
+  std::vector<int64_t> launches_;
+  // waited_[consumer][producer]: the number of the launches of the producer
+  // stream the consumer stream waited for
+  std::vector<std::vector<int64_t>> waited_;
+};
+
+} // namespace
+
+void AssignCudaStreams(std::shared_ptr<Graph>& graph, size_t num_streams) {
+  CudaStreamAssigner(graph, num_streams).run();
+  GRAPH_DUMP("After AssignCudaStreams: ", graph);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Spreads the nodes of the top-level block of a graph of CUDA tensors over
+// num_streams streams, so that the kernels of branches without data
+// dependencies between each other can run concurrently. A node continues on
+// the stream of the first of its producers that no other consumer has
+// continued on yet, and the other nodes start on the next stream in round
+// robin order. Before a node, the pass inserts
+// - cuda::_stream_wait, making its stream wait for the streams of its inputs,
+// - cuda::_stream_record, recording the tensors of other streams on its
+//   stream for the caching allocator,
+// - cuda::_stream_use, setting the current stream.
+// Nodes with blocks or side effects run on the stream the graph started on,
+// after all the streams are joined. Graphs without CUDA tensors or without
+// independent branches are left alone.
+TORCH_API void AssignCudaStreams(
+    std::shared_ptr<Graph>& graph,
+    size_t num_streams);
+
+} // namespace jit
+} // namespace torch
@@ -5,6 +5,7 @@
 #include <torch/csrc/jit/ir/alias_analysis.h>
 #include <torch/csrc/jit/passes/clear_profiling.h>
 #include <torch/csrc/jit/passes/inliner.h>
+#include <torch/csrc/jit/passes/share_frozen_constants.h>
 #include <torch/csrc/jit/runtime/graph_executor_impl.h>
 
 #include <stack>
@@ -764,6 +765,12 @@ Module freeze_module(
   AttributePropagator attrPropagator(
       moduleClone, preservedAttrs, freezeInterfaces, preserveParameters);
   attrPropagator.run();
+  if (getShareFrozenConstants()) {
+    for (auto& method : moduleClone.get_methods()) {
+      auto graph = method.graph();
+      ShareFrozenConstants(graph);
+    }
+  }
   return moduleClone;
 }
 
@@ -8,6 +8,7 @@
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
 #include <torch/csrc/jit/passes/fold_conv_bn.h>
 #include <torch/csrc/jit/passes/frozen_conv_folding.h>
+#include <torch/csrc/jit/passes/share_frozen_constants.h>
 #include <torch/csrc/jit/tensorexpr/types.h>
 
 namespace torch {
@@ -359,16 +360,25 @@ void FoldFrozenConvMulOrDiv(Block* b) {
 void FoldFrozenConvBatchnorm(std::shared_ptr<Graph>& graph) {
   FoldFrozenConvBatchnorm(graph->block());
   EliminateDeadCode(graph);
+  if (getShareFrozenConstants()) {
+    ShareFrozenConstants(graph);
+  }
 }
 
 void FoldFrozenConvAddOrSub(std::shared_ptr<Graph>& graph) {
   FoldFrozenConvAddOrSub(graph->block());
   EliminateDeadCode(graph);
+  if (getShareFrozenConstants()) {
+    ShareFrozenConstants(graph);
+  }
 }
 
 void FoldFrozenConvMulOrDiv(std::shared_ptr<Graph>& graph) {
   FoldFrozenConvMulOrDiv(graph->block());
   EliminateDeadCode(graph);
+  if (getShareFrozenConstants()) {
+    ShareFrozenConstants(graph);
+  }
 }
 
 } // namespace jit
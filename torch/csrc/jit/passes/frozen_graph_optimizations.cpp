@@ -2,6 +2,8 @@
 #include <torch/csrc/jit/ir/ir_views.h>
 #include <torch/csrc/jit/passes/frozen_conv_folding.h>
 #include <torch/csrc/jit/passes/frozen_graph_optimizations.h>
+#include <torch/csrc/jit/passes/frozen_linear_batching.h>
+#include <torch/csrc/jit/passes/fuse_add_layer_norm.h>
 #include <torch/csrc/jit/runtime/graph_executor.h>
 #include <torch/csrc/utils/memory.h>
 
@@ -18,7 +20,11 @@ void OptimizeFrozenGraph(
       FoldFrozenConvAddOrSub(graph);
       FoldFrozenConvMulOrDiv(graph);
     }
+    // the batched GEMMs may round differently
+    FrozenConcatLinear(graph);
+    FrozenBatchLinear(graph);
   }
+  FuseAddLayerNorm(graph);
 }
 
 } // namespace jit
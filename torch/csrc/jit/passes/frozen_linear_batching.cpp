@@ -0,0 +1,350 @@
+#include <ATen/Utils.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/frozen_linear_batching.h>
+
+#include <map>
+
+namespace torch {
+namespace jit {
+
+using Tensor = at::Tensor;
+
+namespace {
+
+// The constant weight and bias of an aten::linear, which has an undefined
+// bias if it has none.
+struct LinearParameters {
+  Tensor weight;
+  Tensor bias;
+};
+
+c10::optional<LinearParameters> frozenLinearParameters(
+    Node* n,
+    const AliasDb& aliasDb) {
+  if (!n->matches(
+          "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor")) {
+    return c10::nullopt;
+  }
+  // the outputs become views of a shared output
+  if (aliasDb.hasWriters(n->output())) {
+    return c10::nullopt;
+  }
+  auto weight = constant_as<Tensor>(n->namedInput("weight"));
+  if (!weight || weight->dim() != 2) {
+    return c10::nullopt;
+  }
+  LinearParameters params;
+  params.weight = *weight;
+  auto bias = toIValue(n->namedInput("bias"));
+  if (!bias) {
+    return c10::nullopt;
+  }
+  if (bias->isTensor()) {
+    params.bias = bias->toTensor();
+    if (params.bias.dim() != 1 ||
+        params.bias.size(0) != params.weight.size(0) ||
+        params.bias.scalar_type() != params.weight.scalar_type() ||
+        params.bias.device() != params.weight.device()) {
+      return c10::nullopt;
+    }
+  }
+  return params;
+}
+
+// Weights that can be concatenated or stacked with each other
+struct WeightKey {
+  c10::ScalarType dtype;
+  c10::Device device;
+  std::vector<int64_t> sizes;
+
+  bool operator<(const WeightKey& other) const {
+    return std::make_tuple(dtype, device.type(), device.index(), sizes) <
+        std::make_tuple(
+               other.dtype,
+               other.device.type(),
+               other.device.index(),
+               other.sizes);
+  }
+};
+
+struct LinearGroup {
+  std::vector<Node*> linears;
+  std::vector<LinearParameters> params;
+};
+
+// The biases of a group, with zeros for the linears without one. Returns none
+// if no linear of the group has a bias.
+std::vector<Tensor> groupBiases(const LinearGroup& group) {
+  bool has_bias = false;
+  for (const LinearParameters& params : group.params) {
+    has_bias |= params.bias.defined();
+  }
+  std::vector<Tensor> biases;
+  if (!has_bias) {
+    return biases;
+  }
+  for (const LinearParameters& params : group.params) {
+    biases.push_back(
+        params.bias.defined()
+            ? params.bias
+            : at::zeros({params.weight.size(0)}, params.weight.options()));
+  }
+  return biases;
+}
+
+Value* insertBias(Graph* graph, const std::vector<Tensor>& biases, int dim) {
+  if (biases.empty()) {
+    return graph->insertConstant(IValue());
+  }
+  return graph->insertConstant(
+      dim == 0 ? at::cat(biases, 0) : at::stack(biases, 0).unsqueeze(1));
+}
+
+// Replaces the aten::view uses of the output of a linear, which is sliced out
+// of a larger output and thus not contiguous, with aten::reshape. The output
+// has no writers, so the copy reshape may make is not observable.
+void replaceViewsWithReshapes(Node* linear) {
+  std::vector<Node*> views;
+  for (const Use& use : linear->output()->uses()) {
+    if (use.offset == 0 &&
+        use.user->matches(
+            "aten::view(Tensor(a) self, int[] size) -> Tensor(a)")) {
+      views.push_back(use.user);
+    }
+  }
+  for (Node* view : views) {
+    WithInsertPoint guard(view);
+    Value* reshape = view->owningGraph()->insert(
+        aten::reshape, {view->input(0), view->input(1)});
+    reshape->setType(view->output()->type());
+    view->output()->replaceAllUsesWith(reshape);
+    view->destroy();
+  }
+}
+
+void concatLinears(const LinearGroup& group) {
+  Node* first = group.linears.front();
+  Graph* graph = first->owningGraph();
+  std::vector<Tensor> weights;
+  for (const LinearParameters& params : group.params) {
+    weights.push_back(params.weight);
+  }
+
+  WithInsertPoint guard(first);
+  Value* weight = graph->insertConstant(at::cat(weights, 0));
+  Value* bias = insertBias(graph, groupBiases(group), 0);
+  Value* output = graph->insert(
+      aten::linear, {first->namedInput("input"), weight, bias});
+  int64_t start = 0;
+  for (size_t i = 0; i < group.linears.size(); i++) {
+    Node* linear = group.linears[i];
+    const int64_t end = start + group.params[i].weight.size(0);
+    Value* slice = graph->insert(aten::slice, {output, -1, start, end, 1});
+    slice->setType(linear->output()->type());
+    replaceViewsWithReshapes(linear);
+    linear->output()->replaceAllUsesWith(slice);
+    start = end;
+  }
+  for (Node* linear : group.linears) {
+    linear->destroy();
+  }
+}
+
+// Collects the groups of the linears of b and its nested blocks, before any
+// of them is replaced, so that aliasDb remains valid.
+void collectConcatGroups(
+    Block* b,
+    const AliasDb& aliasDb,
+    std::vector<LinearGroup>& all_groups) {
+  std::vector<LinearGroup> groups;
+  // by input, then by the dtype, device and number of input features of the
+  // weights
+  std::map<std::pair<Value*, WeightKey>, size_t> group_of;
+  for (Node* n : b->nodes()) {
+    for (Block* block : n->blocks()) {
+      collectConcatGroups(block, aliasDb, all_groups);
+    }
+    auto params = frozenLinearParameters(n, aliasDb);
+    if (!params) {
+      continue;
+    }
+    WeightKey key{params->weight.scalar_type(),
+                  params->weight.device(),
+                  {params->weight.size(1)}};
+    auto it = group_of
+                  .emplace(
+                      std::make_pair(n->namedInput("input"), key),
+                      groups.size())
+                  .first;
+    if (it->second == groups.size()) {
+      groups.emplace_back();
+    }
+    groups[it->second].linears.push_back(n);
+    groups[it->second].params.push_back(*params);
+  }
+
+  for (LinearGroup& group : groups) {
+    if (group.linears.size() > 1) {
+      all_groups.push_back(std::move(group));
+    }
+  }
+}
+
+// The node of b that is or contains n
+Node* ancestorIn(Node* n, Block* b) {
+  while (n->owningBlock() != b) {
+    n = n->owningBlock()->owningNode();
+    if (n == nullptr) {
+      return nullptr;
+    }
+  }
+  return n;
+}
+
+// Whether the outputs of group are only used after n, where the batched
+// linear of the group would be inserted if n joins it.
+bool unusedBefore(const LinearGroup& group, Node* n) {
+  for (Node* linear : group.linears) {
+    for (const Use& use : linear->output()->uses()) {
+      Node* user = ancestorIn(use.user, n->owningBlock());
+      if (user == nullptr || !user->isAfter(n)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void batchLinears(const LinearGroup& group) {
+  Node* last = group.linears.back();
+  Graph* graph = last->owningGraph();
+  const auto num_linears = static_cast<int64_t>(group.linears.size());
+  std::vector<Value*> inputs;
+  std::vector<Tensor> weights;
+  for (size_t i = 0; i < group.linears.size(); i++) {
+    inputs.push_back(group.linears[i]->namedInput("input"));
+    weights.push_back(group.params[i].weight);
+  }
+  const Tensor& weight = group.params.front().weight;
+  const int64_t in_features = weight.size(1);
+  const int64_t out_features = weight.size(0);
+  std::vector<int64_t> output_sizes =
+      *inputs.front()->type()->expect<TensorType>()->sizes().concrete_sizes();
+  output_sizes.back() = out_features;
+  output_sizes.insert(output_sizes.begin(), num_linears);
+
+  WithInsertPoint guard(last);
+  Value* input_list =
+      graph->insertNode(graph->createList(TensorType::get(), inputs))
+          ->output();
+  Value* stacked = graph->insert(aten::stack, {input_list, 0});
+  Value* batched = graph->insert(
+      aten::reshape,
+      {stacked,
+       graph->insertConstant(
+           std::vector<int64_t>{num_linears, -1, in_features})});
+  // [num_linears, in_features, out_features]
+  Value* batched_weight = graph->insertConstant(
+      at::stack(weights, 0).transpose(1, 2).contiguous());
+  std::vector<Tensor> biases = groupBiases(group);
+  Value* output = biases.empty()
+      ? graph->insert(aten::bmm, {batched, batched_weight})
+      : graph->insert(
+            aten::baddbmm,
+            {insertBias(graph, biases, 1), batched, batched_weight});
+  output = graph->insert(
+      aten::reshape, {output, graph->insertConstant(output_sizes)});
+  for (size_t i = 0; i < group.linears.size(); i++) {
+    Node* linear = group.linears[i];
+    Value* select =
+        graph->insert(aten::select, {output, 0, static_cast<int64_t>(i)});
+    select->setType(linear->output()->type());
+    linear->output()->replaceAllUsesWith(select);
+  }
+  for (Node* linear : group.linears) {
+    linear->destroy();
+  }
+}
+
+void collectBatchGroups(
+    Block* b,
+    const AliasDb& aliasDb,
+    std::vector<LinearGroup>& all_groups) {
+  std::vector<LinearGroup> groups;
+  // the open group of linears of the same input sizes and weights
+  std::map<std::pair<std::vector<int64_t>, WeightKey>, size_t> group_of;
+  for (Node* n : b->nodes()) {
+    for (Block* block : n->blocks()) {
+      collectBatchGroups(block, aliasDb, all_groups);
+    }
+    auto params = frozenLinearParameters(n, aliasDb);
+    if (!params) {
+      continue;
+    }
+    auto input_type = n->namedInput("input")->type()->cast<TensorType>();
+    if (!input_type || !input_type->sizes().concrete_sizes() ||
+        input_type->sizes().concrete_sizes()->empty()) {
+      continue;
+    }
+    WeightKey key{params->weight.scalar_type(),
+                  params->weight.device(),
+                  params->weight.sizes().vec()};
+    auto it = group_of.emplace(
+        std::make_pair(*input_type->sizes().concrete_sizes(), key),
+        groups.size());
+    if (!it.second && !unusedBefore(groups[it.first->second], n)) {
+      // n depends on an output of the open group, or is after a use of one
+      it.first->second = groups.size();
+    }
+    if (it.first->second == groups.size()) {
+      groups.emplace_back();
+    }
+    groups[it.first->second].linears.push_back(n);
+    groups[it.first->second].params.push_back(*params);
+  }
+
+  for (LinearGroup& group : groups) {
+    if (group.linears.size() > 1) {
+      all_groups.push_back(std::move(group));
+    }
+  }
+}
+
+} // namespace
+
+void FrozenConcatLinear(std::shared_ptr<Graph>& graph) {
+  std::vector<LinearGroup> groups;
+  {
+    AliasDb aliasDb(graph);
+    collectConcatGroups(graph->block(), aliasDb, groups);
+  }
+  for (const LinearGroup& group : groups) {
+    GRAPH_DEBUG(
+        "Concatenating ", group.linears.size(), " linears of the same input");
+    concatLinears(group);
+  }
+  EliminateDeadCode(graph);
+  GRAPH_DUMP("After FrozenConcatLinear: ", graph);
+}
+
+void FrozenBatchLinear(std::shared_ptr<Graph>& graph) {
+  std::vector<LinearGroup> groups;
+  {
+    AliasDb aliasDb(graph);
+    collectBatchGroups(graph->block(), aliasDb, groups);
+  }
+  for (const LinearGroup& group : groups) {
+    GRAPH_DEBUG("Batching ", group.linears.size(), " linears");
+    batchLinears(group);
+  }
+  EliminateDeadCode(graph);
+  GRAPH_DUMP("After FrozenBatchLinear: ", graph);
+}
+
+} // namespace jit
+} // namespace torch
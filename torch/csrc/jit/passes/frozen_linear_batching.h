@@ -0,0 +1,24 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Concatenates the weights and biases of the aten::linear nodes of a block
+// that share their input, e.g. the query, key and value projections of an
+// attention layer, into a single aten::linear whose output is sliced into the
+// outputs of the original nodes.
+// This pass only works on Frozen Graphs; otherwise it is a No-Op.
+TORCH_API void FrozenConcatLinear(std::shared_ptr<Graph>& graph);
+
+// Batches the aten::linear nodes of a block with different inputs of the same
+// complete shape and weights of the same shape, e.g. the heads of a model of
+// experts, into a single aten::baddbmm over the stacked inputs and weights.
+// The shapes of the inputs are only known for traced or shape specialized
+// graphs.
+// This pass only works on Frozen Graphs; otherwise it is a No-Op.
+TORCH_API void FrozenBatchLinear(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,62 @@
+#include <torch/csrc/jit/passes/fuse_add_layer_norm.h>
+
+#include <torch/csrc/jit/passes/quantization/helper.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+
+namespace torch {
+namespace jit {
+
+void FuseAddLayerNorm(std::shared_ptr<Graph>& graph) {
+  // The sum must not be used outside of the pattern, which the subgraph
+  // matcher guarantees for the values that are not outputs of the pattern.
+  // Operands that broadcast or promote are handled by add_layer_norm itself.
+  std::string dropout_add_layer_norm = R"IR(
+    graph(%input, %residual, %p, %train, %alpha, %shape, %weight, %bias, %eps, %cudnn):
+        %dropout = aten::dropout(%input, %p, %train)
+        %sum = aten::add(%residual, %dropout, %alpha)
+        %res = aten::layer_norm(%sum, %shape, %weight, %bias, %eps, %cudnn)
+        return (%res))IR";
+  std::string add_dropout_layer_norm = R"IR(
+    graph(%input, %residual, %p, %train, %alpha, %shape, %weight, %bias, %eps, %cudnn):
+        %dropout = aten::dropout(%input, %p, %train)
+        %sum = aten::add(%dropout, %residual, %alpha)
+        %res = aten::layer_norm(%sum, %shape, %weight, %bias, %eps, %cudnn)
+        return (%res))IR";
+  std::string fused_dropout = R"IR(
+    graph(%input, %residual, %p, %train, %alpha, %shape, %weight, %bias, %eps, %cudnn):
+        %res = aten::add_layer_norm(%input, %residual, %shape, %weight, %bias, %eps, %p, %train)
+        return (%res))IR";
+
+  std::string add_layer_norm = R"IR(
+    graph(%input, %residual, %alpha, %shape, %weight, %bias, %eps, %cudnn):
+        %sum = aten::add(%residual, %input, %alpha)
+        %res = aten::layer_norm(%sum, %shape, %weight, %bias, %eps, %cudnn)
+        return (%res))IR";
+  std::string fused = R"IR(
+    graph(%input, %residual, %alpha, %shape, %weight, %bias, %eps, %cudnn):
+        %p : float = prim::Constant[value=0.0]()
+        %train : bool = prim::Constant[value=0]()
+        %res = aten::add_layer_norm(%input, %residual, %shape, %weight, %bias, %eps, %p, %train)
+        return (%res))IR";
+
+  // aten::add also matches add.Scalar
+  auto operands_are_tensors =
+      [](const Match& match,
+         const std::unordered_map<std::string, Value*>& vmap) {
+        const auto& match_vmap = match.values_map;
+        return match_vmap.at(vmap.at("input"))->type()->cast<TensorType>() &&
+            match_vmap.at(vmap.at("residual"))->type()->cast<TensorType>();
+      };
+
+  SubgraphRewriter rewriter;
+  rewriter.RegisterRewritePattern(dropout_add_layer_norm, fused_dropout);
+  rewriter.RegisterRewritePattern(add_dropout_layer_norm, fused_dropout);
+  rewriter.runOnGraph(graph, {aten_add_alpha_is_one, operands_are_tensors});
+
+  SubgraphRewriter no_dropout_rewriter;
+  no_dropout_rewriter.RegisterRewritePattern(add_layer_norm, fused);
+  no_dropout_rewriter.runOnGraph(graph, {aten_add_alpha_is_one, operands_are_tensors});
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Replaces layer_norm(residual + dropout(input)) and layer_norm(a + b) with
+// aten::add_layer_norm, which computes the sum and the normalization in one
+// pass on CPU.
+TORCH_API void FuseAddLayerNorm(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,44 @@
+#include <torch/csrc/jit/passes/fuse_batch_norm_add_relu.h>
+
+#include <torch/csrc/jit/passes/quantization/helper.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+
+namespace torch {
+namespace jit {
+
+void FuseBatchNormAddRelu(std::shared_ptr<Graph>& graph) {
+  // The normalized input and the sum must not be used outside of the
+  // pattern, which the subgraph matcher guarantees for the values that are
+  // not outputs of the pattern.
+  std::string fused = R"IR(
+    graph(%input, %other, %weight, %bias, %mean, %var, %training, %momentum, %eps, %cudnn, %alpha):
+        %res = aten::batch_norm_add_relu(%input, %other, %weight, %bias, %mean, %var, %training, %momentum, %eps)
+        return (%res))IR";
+
+  // aten::add also matches add.Scalar
+  auto other_is_tensor =
+      [](const Match& match,
+         const std::unordered_map<std::string, Value*>& vmap) {
+        return match.values_map.at(vmap.at("other"))
+            ->type()
+            ->cast<TensorType>() != nullptr;
+      };
+
+  SubgraphRewriter rewriter;
+  for (const char* relu : {"aten::relu", "aten::relu_"}) {
+    for (const char* operands : {"%normalized, %other", "%other, %normalized"}) {
+      std::string pattern = std::string(R"IR(
+    graph(%input, %other, %weight, %bias, %mean, %var, %training, %momentum, %eps, %cudnn, %alpha):
+        %normalized = aten::batch_norm(%input, %weight, %bias, %mean, %var, %training, %momentum, %eps, %cudnn)
+        %sum = aten::add()IR") +
+          operands + R"IR(, %alpha)
+        %res = )IR" + relu + R"IR((%sum)
+        return (%res))IR";
+      rewriter.RegisterRewritePattern(pattern, fused);
+    }
+  }
+  rewriter.runOnGraph(graph, {aten_add_alpha_is_one, other_is_tensor});
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Replaces relu(batch_norm(input) + other) with aten::batch_norm_add_relu,
+// which normalizes, adds and applies the ReLU in one pass over channels last
+// CUDA inputs and saves the ReLU mask as bits for the backward.
+TORCH_API void FuseBatchNormAddRelu(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
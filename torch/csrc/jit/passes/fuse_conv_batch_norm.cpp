@@ -0,0 +1,31 @@
+#include <torch/csrc/jit/passes/fuse_conv_batch_norm.h>
+
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+
+namespace torch {
+namespace jit {
+
+void FuseConvBatchNorm(std::shared_ptr<Graph>& graph) {
+  // The output of the convolution must not be used outside of the pattern,
+  // which the subgraph matcher guarantees for the values that are not
+  // outputs of the pattern.
+  std::string fused = R"IR(
+    graph(%input, %conv_weight, %conv_bias, %stride, %padding, %dilation, %groups, %weight, %bias, %mean, %var, %training, %momentum, %eps, %cudnn):
+        %res = aten::conv_batch_norm(%input, %conv_weight, %conv_bias, %stride, %padding, %dilation, %groups, %weight, %bias, %mean, %var, %training, %momentum, %eps)
+        return (%res))IR";
+
+  SubgraphRewriter rewriter;
+  for (const char* conv : {"aten::conv1d", "aten::conv2d", "aten::conv3d"}) {
+    std::string pattern = std::string(R"IR(
+    graph(%input, %conv_weight, %conv_bias, %stride, %padding, %dilation, %groups, %weight, %bias, %mean, %var, %training, %momentum, %eps, %cudnn):
+        %conv_out = )IR") +
+        conv + R"IR((%input, %conv_weight, %conv_bias, %stride, %padding, %dilation, %groups)
+        %res = aten::batch_norm(%conv_out, %weight, %bias, %mean, %var, %training, %momentum, %eps, %cudnn)
+        return (%res))IR";
+    rewriter.RegisterRewritePattern(pattern, fused);
+  }
+  rewriter.runOnGraph(graph);
+}
+
+} // namespace jit
+} // namespace torch
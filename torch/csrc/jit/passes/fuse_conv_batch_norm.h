@@ -0,0 +1,15 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Replaces batch_norm(conv1d/conv2d/conv3d(input, ...)) with
+// aten::conv_batch_norm. Unlike FoldConvBatchNorm, which folds the batch norm
+// into the weights of frozen inference modules, this also applies to
+// training graphs, where the fused op skips the bias of the convolution.
+TORCH_API void FuseConvBatchNorm(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,137 @@
+#include <torch/csrc/jit/passes/memory_planning.h>
+
+#include <torch/csrc/jit/ir/alias_analysis.h>
+
+#include <algorithm>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// the alignment of the CPU allocator
+constexpr size_t kAlignment = 64;
+
+c10::optional<size_t> allocationSize(Value* v) {
+  auto type = v->type()->cast<TensorType>();
+  if (!type || !type->isComplete()) {
+    return c10::nullopt;
+  }
+  auto sizes = *type->sizes().concrete_sizes();
+  auto strides = *type->strides().concrete_sizes();
+  // the extent of the storage, which is larger than the number of elements
+  // for expanded or permuted strides
+  size_t extent = 1;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (sizes[i] == 0) {
+      return 0;
+    }
+    extent += (sizes[i] - 1) * strides[i];
+  }
+  size_t size = extent * c10::elementSize(*type->scalarType());
+  return (size + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+void collectUses(Node* node, std::vector<Value*>& uses) {
+  uses.insert(uses.end(), node->inputs().begin(), node->inputs().end());
+  for (Block* block : node->blocks()) {
+    for (Node* n : block->nodes()) {
+      collectUses(n, uses);
+    }
+    uses.insert(
+        uses.end(), block->outputs().begin(), block->outputs().end());
+  }
+}
+
+bool overlaps(const PlannedAllocation& a, const PlannedAllocation& b) {
+  return a.begin <= b.end && b.begin <= a.end;
+}
+
+} // namespace
+
+MemoryPlan PlanMemory(const std::shared_ptr<Graph>& graph) {
+  AliasDb alias_db(graph);
+  std::vector<Node*> nodes(
+      graph->block()->nodes().begin(), graph->block()->nodes().end());
+  // the values used by each top level node, within its blocks included
+  std::vector<std::vector<Value*>> uses(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    collectUses(nodes[i], uses[i]);
+  }
+
+  MemoryPlan plan;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    Node* node = nodes[i];
+    // nodes without schemas, e.g. constants, and nodes with blocks don't
+    // allocate their outputs themselves
+    if (!node->blocks().empty() || !node->maybeSchema()) {
+      continue;
+    }
+    for (Value* output : node->outputs()) {
+      auto size = allocationSize(output);
+      if (!size || *size == 0 ||
+          alias_db.mayContainAlias({output}, node->inputs()) ||
+          alias_db.mayContainAlias({output}, graph->inputs()) ||
+          alias_db.mayContainAlias({output}, graph->outputs())) {
+        continue;
+      }
+      PlannedAllocation allocation{output, *size, 0, i, i};
+      for (size_t j = i + 1; j < nodes.size(); ++j) {
+        if (alias_db.mayContainAlias({output}, uses[j])) {
+          allocation.end = j;
+        }
+      }
+      plan.allocations.push_back(allocation);
+    }
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    size_t live_bytes = 0;
+    for (const auto& allocation : plan.allocations) {
+      if (allocation.begin <= i && i <= allocation.end) {
+        live_bytes += allocation.size;
+      }
+    }
+    plan.peak_live_bytes = std::max(plan.peak_live_bytes, live_bytes);
+  }
+
+  // place the largest allocations first, which keeps the arena close to the
+  // peak for the usual chains of ops
+  std::vector<size_t> order(plan.allocations.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return plan.allocations[a].size > plan.allocations[b].size;
+  });
+  std::vector<const PlannedAllocation*> placed;
+  for (size_t index : order) {
+    auto& allocation = plan.allocations[index];
+    std::vector<const PlannedAllocation*> conflicts;
+    for (const auto* other : placed) {
+      if (overlaps(allocation, *other)) {
+        conflicts.push_back(other);
+      }
+    }
+    std::sort(
+        conflicts.begin(),
+        conflicts.end(),
+        [](const PlannedAllocation* a, const PlannedAllocation* b) {
+          return a->offset < b->offset;
+        });
+    size_t offset = 0;
+    for (const auto* other : conflicts) {
+      if (offset + allocation.size <= other->offset) {
+        break;
+      }
+      offset = std::max(offset, other->offset + other->size);
+    }
+    allocation.offset = offset;
+    plan.arena_size = std::max(plan.arena_size, offset + allocation.size);
+    placed.push_back(&allocation);
+  }
+  return plan;
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// A tensor produced by a top level node of the graph, to be placed at
+// offset inside of the arena. It's live from the node producing it, at
+// index begin in the top level node list, up to and including the last node
+// using it or one of its aliases, at index end.
+struct PlannedAllocation {
+  Value* value;
+  size_t size;
+  size_t offset;
+  size_t begin;
+  size_t end;
+};
+
+struct MemoryPlan {
+  std::vector<PlannedAllocation> allocations;
+  // the size of the arena holding all of the allocations
+  size_t arena_size = 0;
+  // the largest sum of the sizes of the allocations live at the same time,
+  // a lower bound of arena_size
+  size_t peak_live_bytes = 0;
+};
+
+// Plans the memory of the intermediate tensors of graph ahead of time, with
+// the sizes and strides recorded in their complete TensorTypes, e.g. after
+// running PropagateInputShapes with example (or meta) inputs. Only tensors
+// freshly allocated by top level nodes are planned; graph inputs and outputs,
+// their aliases, views and values without complete types are left to the
+// allocator. Allocations are placed greedily, the largest first, at the
+// lowest offset not overlapping any of the allocations placed so far with
+// an overlapping lifetime.
+TORCH_API MemoryPlan PlanMemory(const std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -4,6 +4,7 @@
 #include <torch/csrc/jit/passes/constant_pooling.h>
 #include <torch/csrc/jit/passes/constant_propagation.h>
 #include <torch/csrc/jit/passes/prepack_folding.h>
+#include <torch/csrc/jit/passes/share_frozen_constants.h>
 
 namespace torch {
 namespace jit {
@@ -39,7 +40,10 @@ void PrePackingOpsFolder(
               m.type()->name()->qualifiedName(),
               ". Please make sure that",
               " FoldPrePackingOps is run at the top level module only.");
-          m.register_attribute(attr_name, n->output(0)->type(), outputs[0]);
+          IValue packed_weight = getShareFrozenConstants()
+              ? shareFrozenConstant(outputs[0])
+              : outputs[0];
+          m.register_attribute(attr_name, n->output(0)->type(), packed_weight);
           Value* prepack_op_value = n->output(0);
           WithInsertPoint ins(prepack_op_value->node());
           Value* packed_weight_attr =
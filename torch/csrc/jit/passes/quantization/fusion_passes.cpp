@@ -53,11 +53,49 @@ void fuseQuantizeAddReluImpl(std::shared_ptr<Graph>& graph) {
       quantized_add_scalar_out_relu_pattern, fused_add_scalar_out_relu_pattern);
   fused_add_relu_rewriter.runOnGraph(graph);
 }
+
+void fuseQuantizedResidualAddImpl(std::shared_ptr<Graph>& graph) {
+  // quantized::add followed by aten::relu becomes quantized::add_relu first
+  fuseQuantizeAddReluImpl(graph);
+  SubgraphRewriter fused_residual_add_rewriter;
+  const std::vector<std::pair<std::string, std::string>> producers = {
+      {"quantized::conv2d", "quantized::conv2d_add"},
+      {"quantized::linear", "quantized::linear_add"}};
+  const std::vector<std::pair<std::string, std::string>> adds = {
+      {"quantized::add", ""}, {"quantized::add_relu", "_relu"}};
+  for (const auto& producer : producers) {
+    for (const auto& add : adds) {
+      const std::string fused_pattern = R"(
+    graph(%a_quant, %packed_params, %p_scale, %p_zero_point, %accum, %scale, %zero_point):
+         %r = )" + producer.second + add.second +
+          R"((%a_quant, %packed_params, %p_scale, %p_zero_point, %accum, %scale, %zero_point)
+         return (%r) )";
+      // the residual may be either operand of the add
+      for (const std::string& operands :
+           {std::string("%p_out, %accum"), std::string("%accum, %p_out")}) {
+        const std::string pattern = R"(
+    graph(%a_quant, %packed_params, %p_scale, %p_zero_point, %accum, %scale, %zero_point):
+         %p_out = )" + producer.first +
+            R"((%a_quant, %packed_params, %p_scale, %p_zero_point)
+         %r = )" + add.first +
+            "(" + operands + R"(, %scale, %zero_point)
+         return (%r) )";
+        fused_residual_add_rewriter.RegisterRewritePattern(
+            pattern, fused_pattern);
+      }
+    }
+  }
+  fused_residual_add_rewriter.runOnGraph(graph);
+}
 } // namespace
 
 void FuseQuantizedAddRelu(std::shared_ptr<Graph>& graph) {
   fuseQuantizeAddReluImpl(graph);
 }
 
+void FuseQuantizedResidualAdd(std::shared_ptr<Graph>& graph) {
+  fuseQuantizedResidualAddImpl(graph);
+}
+
 } // namespace jit
 } // namespace torch
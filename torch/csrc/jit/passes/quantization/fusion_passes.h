@@ -5,5 +5,12 @@
 namespace torch {
 namespace jit {
 TORCH_API void FuseQuantizedAddRelu(std::shared_ptr<Graph>& graph);
+
+// Fuses quantized::add and quantized::add_relu (or quantized::add followed by
+// aten::relu) into the quantized::conv2d or quantized::linear producing one
+// of their operands, when the add is the only use of that output. The result
+// is quantized::conv2d_add(_relu) or quantized::linear_add(_relu), which
+// write the sum over the conv or linear output. Numerics are unchanged.
+TORCH_API void FuseQuantizedResidualAdd(std::shared_ptr<Graph>& graph);
 } // namespace jit
 } // namespace torch
@@ -11,6 +11,7 @@
 #include <torch/csrc/autograd/variable.h>
 
 #include <ATen/DeviceGuard.h>
+#include <ATen/core/dispatch/Dispatcher.h>
 #include <ATen/ExpandUtils.h>
 
 #include <exception>
@@ -153,13 +154,23 @@ class ShapePropagator {
     return device == -1 ? at::kCPU : at::Device(at::kCUDA, device);
   }
 
-  IValue representativeValue(Value* v) {
+  // With meta set, complete tensor types are represented by meta tensors,
+  // which carry the sizes, strides and device but own no storage
+  IValue representativeValue(Value* v, bool meta = false) {
     TypePtr type_ = v->type();
     // if the value is actually constant, just use it!
     if (auto iv = toIValue(v)) {
       return *iv;
     }
     if (TensorTypePtr type = type_->cast<TensorType>()) {
+      if (type->isComplete() && meta) {
+        auto tensor = at::empty_meta(
+            {0},
+            at::TensorOptions(*type->device()).dtype(*type->scalarType()));
+        tensor.unsafeGetTensorImpl()->set_sizes_and_strides(
+            *type->sizes().concrete_sizes(), *type->strides().concrete_sizes());
+        return tensor;
+      }
       if (type->isComplete()) {
         auto attype = type->device()->is_cpu() ? at::CPU(*type->scalarType())
                                                : at::CUDA(*type->scalarType());
@@ -387,6 +398,21 @@ class ShapePropagator {
     return true;
   }
 
+  bool canRunOnMeta(Node* node) {
+    // constant tensors would be mixed with meta tensors
+    for (Value* input : node->inputs()) {
+      if (input->type()->cast<TensorType>() && toIValue(input)) {
+        return false;
+      }
+    }
+    auto schema = node->maybeSchema();
+    if (!schema) {
+      return false;
+    }
+    auto handle = c10::Dispatcher::singleton().findOp(schema->operator_name());
+    return handle && handle->hasKernelForDispatchKey(c10::DispatchKey::Meta);
+  }
+
   // If there's no Tensor in outputs, e.g float / float,
   // we don't need to propagate shape.
   bool DoesntRefineOutputs(Node* node) {
@@ -403,13 +429,16 @@ class ShapePropagator {
     if (!canPropagateShapeByRunningIt(node))
       return false;
 
+    // Operators with a Meta kernel only compute the output metadata, so
+    // running them needs neither real allocations nor zero filled inputs
+    bool meta = !op && canRunOnMeta(node);
     if (!op)
       op = node->getOperation();
 
     Stack stack;
 
     for (auto input : node->inputs()) {
-      stack.push_back(representativeValue(input));
+      stack.push_back(representativeValue(input, meta));
     }
 
     // XXX: we're not catching any exceptions from the op for now. This
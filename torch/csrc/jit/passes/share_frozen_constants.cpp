@@ -0,0 +1,401 @@
+#include <torch/csrc/jit/passes/share_frozen_constants.h>
+
+#include <TH/THAllocator.h>
+#include <c10/util/hash.h>
+#include <torch/csrc/jit/api/object.h>
+#include <torch/csrc/jit/jit_log.h>
+
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+static std::atomic<bool> share_frozen_constants{false};
+static std::atomic<bool> share_frozen_constants_across_processes{false};
+
+std::atomic<bool>& getShareFrozenConstants() {
+  return share_frozen_constants;
+}
+
+std::atomic<bool>& getShareFrozenConstantsAcrossProcesses() {
+  return share_frozen_constants_across_processes;
+}
+
+namespace {
+
+constexpr size_t kMinSweepSize = 64;
+
+// Tensors whose bytes are their contents.
+bool isPoolableTensor(const at::Tensor& t) {
+  return t.defined() && t.has_storage() && t.device().is_cpu() &&
+      t.layout() == at::kStrided && !t.is_quantized() && !t.requires_grad() &&
+      !t.has_names() && t.is_contiguous();
+}
+
+// The packed params of the backends, which don't change once packed.
+bool isPoolableObject(const IValue& value) {
+  if (!value.isCustomClass()) {
+    return false;
+  }
+  const auto& type = value.toObjectRef().type();
+  const auto name = type->name()->qualifiedName();
+  return (name.rfind("__torch__.torch.classes.quantized.", 0) == 0 ||
+          name.rfind("__torch__.torch.classes.xnnpack.", 0) == 0) &&
+      type->findMethod("__getstate__") != nullptr;
+}
+
+IValue getState(const IValue& object) {
+  return Object(object.toObject()).run_method("__getstate__");
+}
+
+size_t hashBytes(const char* data, size_t nbytes) {
+  // FNV-1a over 8 byte words
+  uint64_t hash = 14695981039346656037ull;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= nbytes; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * 1099511628211ull;
+  }
+  for (; i < nbytes; i++) {
+    hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+  }
+  return static_cast<size_t>(hash);
+}
+
+// Hashes the contents of the supported parts of the state of a packed params
+// object. Returns false if the state has other parts.
+bool hashContents(const IValue& v, size_t& hash);
+
+bool hashTensorContents(const at::Tensor& t, size_t& hash) {
+  if (!t.defined()) {
+    hash = c10::hash_combine(hash, 0);
+    return true;
+  }
+  if (!t.device().is_cpu() || t.layout() != at::kStrided) {
+    return false;
+  }
+  hash = c10::hash_combine(hash, static_cast<size_t>(t.scalar_type()));
+  for (int64_t size : t.sizes()) {
+    hash = c10::hash_combine(hash, std::hash<int64_t>()(size));
+  }
+  if (t.is_quantized()) {
+    if (t.qscheme() == at::kPerTensorAffine) {
+      hash = c10::hash_combine(hash, std::hash<double>()(t.q_scale()));
+      hash = c10::hash_combine(hash, std::hash<int64_t>()(t.q_zero_point()));
+    } else if (
+        t.qscheme() == at::kPerChannelAffine ||
+        t.qscheme() == at::kPerChannelAffineFloatQParams) {
+      hash = c10::hash_combine(
+          hash, std::hash<int64_t>()(t.q_per_channel_axis()));
+      if (!hashTensorContents(t.q_per_channel_scales(), hash) ||
+          !hashTensorContents(t.q_per_channel_zero_points(), hash)) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+    return hashTensorContents(t.int_repr(), hash);
+  }
+  const at::Tensor contiguous = t.contiguous();
+  hash = c10::hash_combine(
+      hash,
+      hashBytes(
+          static_cast<const char*>(contiguous.data_ptr()),
+          contiguous.nbytes()));
+  return true;
+}
+
+bool hashContents(const IValue& v, size_t& hash) {
+  hash = c10::hash_combine(hash, std::hash<std::string>()(v.tagKind()));
+  if (v.isTensor()) {
+    return hashTensorContents(v.toTensor(), hash);
+  } else if (v.isNone()) {
+    return true;
+  } else if (v.isInt()) {
+    hash = c10::hash_combine(hash, std::hash<int64_t>()(v.toInt()));
+  } else if (v.isDouble()) {
+    hash = c10::hash_combine(hash, std::hash<double>()(v.toDouble()));
+  } else if (v.isBool()) {
+    hash = c10::hash_combine(hash, std::hash<bool>()(v.toBool()));
+  } else if (v.isString()) {
+    hash = c10::hash_combine(hash, std::hash<std::string>()(v.toStringRef()));
+  } else if (v.isTuple()) {
+    for (const IValue& element : v.toTuple()->elements()) {
+      if (!hashContents(element, hash)) {
+        return false;
+      }
+    }
+  } else if (v.isList()) {
+    for (const IValue& element : v.toListRef()) {
+      if (!hashContents(element, hash)) {
+        return false;
+      }
+    }
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool sameContents(const IValue& a, const IValue& b);
+
+bool sameTensorContents(const at::Tensor& a, const at::Tensor& b) {
+  if (!a.defined() || !b.defined()) {
+    return a.defined() == b.defined();
+  }
+  if (a.scalar_type() != b.scalar_type() || a.sizes() != b.sizes() ||
+      a.is_quantized() != b.is_quantized()) {
+    return false;
+  }
+  if (a.is_quantized()) {
+    if (a.qscheme() != b.qscheme()) {
+      return false;
+    }
+    if (a.qscheme() == at::kPerTensorAffine) {
+      if (a.q_scale() != b.q_scale() ||
+          a.q_zero_point() != b.q_zero_point()) {
+        return false;
+      }
+    } else if (
+        a.q_per_channel_axis() != b.q_per_channel_axis() ||
+        !sameTensorContents(
+            a.q_per_channel_scales(), b.q_per_channel_scales()) ||
+        !sameTensorContents(
+            a.q_per_channel_zero_points(), b.q_per_channel_zero_points())) {
+      return false;
+    }
+    return sameTensorContents(a.int_repr(), b.int_repr());
+  }
+  const at::Tensor a_contiguous = a.contiguous();
+  const at::Tensor b_contiguous = b.contiguous();
+  return std::memcmp(
+             a_contiguous.data_ptr(),
+             b_contiguous.data_ptr(),
+             a_contiguous.nbytes()) == 0;
+}
+
+bool sameContents(const IValue& a, const IValue& b) {
+  if (a.tagKind() != b.tagKind()) {
+    return false;
+  }
+  if (a.isTensor()) {
+    return sameTensorContents(a.toTensor(), b.toTensor());
+  } else if (a.isTuple() || a.isList()) {
+    c10::ArrayRef<IValue> a_elements =
+        a.isTuple() ? a.toTuple()->elements() : a.toListRef();
+    c10::ArrayRef<IValue> b_elements =
+        b.isTuple() ? b.toTuple()->elements() : b.toListRef();
+    if (a_elements.size() != b_elements.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < a_elements.size(); i++) {
+      if (!sameContents(a_elements[i], b_elements[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return a == b;
+}
+
+// A copy of t in the named shared memory segment of its contents, which other
+// processes with the same tensor map as well. The segment is refcounted by
+// THRefcountedMapAllocator and unlinked with its last mapping. Returns t if
+// the segment can't be created or holds other contents, e.g. because another
+// process is still filling it.
+at::Tensor shareMemory(const at::Tensor& t, size_t hash) {
+  const size_t nbytes = t.nbytes();
+  if (nbytes == 0) {
+    return t;
+  }
+  std::ostringstream name;
+  name << "/torch_frozen_constant_" << std::hex << std::setfill('0')
+       << std::setw(16) << hash << "_" << std::dec << nbytes;
+  const int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM;
+  at::DataPtr data;
+  bool created = false;
+  // a segment may be created by another process in between the two attempts
+  for (int attempt = 0; attempt < 2 && !data; attempt++) {
+    try {
+      data = THRefcountedMapAllocator::makeDataPtr(
+          name.str().c_str(),
+          flags | TH_ALLOCATOR_MAPPED_NOCREATE,
+          nbytes,
+          nullptr);
+    } catch (const c10::Error&) {
+      try {
+        data = THRefcountedMapAllocator::makeDataPtr(
+            name.str().c_str(),
+            flags | TH_ALLOCATOR_MAPPED_EXCLUSIVE,
+            nbytes,
+            nullptr);
+        created = true;
+      } catch (const c10::Error& e) {
+        GRAPH_DEBUG("Failed to create ", name.str(), ": ", e.what());
+      }
+    }
+  }
+  if (!data) {
+    return t;
+  }
+  if (created) {
+    std::memcpy(data.get(), t.data_ptr(), nbytes);
+  } else if (std::memcmp(data.get(), t.data_ptr(), nbytes) != 0) {
+    GRAPH_DEBUG("Not sharing ", name.str(), " with other contents");
+    return t;
+  }
+  c10::Storage storage(
+      c10::Storage::use_byte_size_t(),
+      nbytes,
+      std::move(data),
+      /*allocator=*/nullptr,
+      /*resizable=*/false);
+  at::Tensor shared = at::empty({0}, t.options());
+  shared.set_(storage, 0, t.sizes(), t.strides());
+  return shared;
+}
+
+class FrozenConstantPool {
+ public:
+  static FrozenConstantPool& get() {
+    static FrozenConstantPool pool;
+    return pool;
+  }
+
+  IValue share(const IValue& value) {
+    const bool is_tensor = value.isTensor();
+    if (is_tensor ? !isPoolableTensor(value.toTensor())
+                  : !isPoolableObject(value)) {
+      return value;
+    }
+    size_t hash = 0;
+    IValue state;
+    if (is_tensor) {
+      hashTensorContents(value.toTensor(), hash);
+    } else {
+      state = getState(value);
+      if (!hashContents(state, hash)) {
+        return value;
+      }
+      hash = c10::hash_combine(
+          hash,
+          std::hash<std::string>()(
+              value.toObjectRef().type()->name()->qualifiedName()));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto range = entries_.equal_range(hash);
+    for (auto it = range.first; it != range.second;) {
+      if (it->second.unused()) {
+        it = entries_.erase(it);
+        continue;
+      }
+      IValue pooled = it->second.weak.lock();
+      if (is_tensor ? pooled.isTensor() &&
+                  sameTensorContents(pooled.toTensor(), value.toTensor())
+                    : pooled.isObject() &&
+                  pooled.toObjectRef().type() == value.toObjectRef().type() &&
+                  sameContents(getState(pooled), state)) {
+        return pooled;
+      }
+      ++it;
+    }
+
+    IValue shared = value;
+    if (is_tensor && getShareFrozenConstantsAcrossProcesses()) {
+      shared = shareMemory(value.toTensor(), hash);
+    }
+    Entry entry;
+    entry.weak = c10::WeakIValue(shared);
+    if (!is_tensor) {
+      // objects don't release their slots while weakly referenced, so the
+      // pool holds them until they are unused
+      entry.strong = shared;
+    }
+    entries_.emplace(hash, std::move(entry));
+    if (entries_.size() >= next_sweep_size_) {
+      sweep();
+    }
+    return shared;
+  }
+
+  void releaseUnused() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sweep();
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t live = 0;
+    for (const auto& entry : entries_) {
+      live += entry.second.unused() ? 0 : 1;
+    }
+    return live;
+  }
+
+ private:
+  struct Entry {
+    c10::WeakIValue weak;
+    IValue strong;
+
+    bool unused() const {
+      return weak.use_count() <= (strong.isNone() ? 0 : 1);
+    }
+  };
+
+  void sweep() {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      it = it->second.unused() ? entries_.erase(it) : std::next(it);
+    }
+    next_sweep_size_ = std::max(kMinSweepSize, 2 * entries_.size());
+  }
+
+  std::mutex mutex_;
+  std::unordered_multimap<size_t, Entry> entries_;
+  size_t next_sweep_size_{kMinSweepSize};
+};
+
+void shareFrozenConstants(Block* block) {
+  for (Node* n : block->nodes()) {
+    for (Block* b : n->blocks()) {
+      shareFrozenConstants(b);
+    }
+    if (n->kind() != prim::Constant || !n->hasAttribute(attr::value)) {
+      continue;
+    }
+    if (n->kindOf(attr::value) == AttributeKind::t) {
+      IValue shared = shareFrozenConstant(n->t(attr::value));
+      n->t_(attr::value, shared.toTensor());
+    } else if (n->kindOf(attr::value) == AttributeKind::ival) {
+      IValue shared = shareFrozenConstant(n->ival(attr::value));
+      n->ival_(attr::value, shared);
+    }
+  }
+}
+
+} // namespace
+
+IValue shareFrozenConstant(const IValue& value) {
+  return FrozenConstantPool::get().share(value);
+}
+
+void ShareFrozenConstants(std::shared_ptr<Graph>& graph) {
+  shareFrozenConstants(graph->block());
+  GRAPH_DUMP("After ShareFrozenConstants: ", graph);
+}
+
+void releaseUnusedFrozenConstants() {
+  FrozenConstantPool::get().releaseUnused();
+}
+
+size_t numSharedFrozenConstants() {
+  return FrozenConstantPool::get().size();
+}
+
+} // namespace jit
+} // namespace torch
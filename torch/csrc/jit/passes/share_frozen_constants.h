@@ -0,0 +1,47 @@
+/** \brief This file defines the sharing of the constants of frozen modules
+ * across the modules of a process.
+ *
+ * A process that loads the same model several times, e.g. once per worker,
+ * holds one copy of its weights per frozen instance. With sharing enabled the
+ * tensor constants and the prepacked weights of frozen graphs are looked up by
+ * content in a process-wide pool, and modules with the same weights use the
+ * same tensors and packed params objects.
+ */
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+#include <atomic>
+
+namespace torch {
+namespace jit {
+
+// Opt-in, since the modules sharing a constant observe each other's in-place
+// updates to it. Used by freeze_module and the folding passes of frozen graphs.
+TORCH_API std::atomic<bool>& getShareFrozenConstants();
+
+// Also backs the shared tensors by named POSIX shared memory, so that the
+// processes of a host loading the same model share their pages as well. The
+// packed params objects can't be shared across processes, since their packed
+// buffers are allocated by the quantized backends.
+TORCH_API std::atomic<bool>& getShareFrozenConstantsAcrossProcesses();
+
+// Returns the pooled value with the contents of value, after adding value to
+// the pool if there is none. Contiguous CPU tensors and the packed params of
+// the quantized and xnnpack backends are pooled, other values are returned
+// as is.
+TORCH_API IValue shareFrozenConstant(const IValue& value);
+
+// Replaces the tensor and packed params constants of graph by pooled ones.
+TORCH_API void ShareFrozenConstants(std::shared_ptr<Graph>& graph);
+
+// The pool keeps tensors alive as long as a module uses them. Packed params
+// objects are held until a call to this function finds them unused, which
+// also happens as the pool grows.
+TORCH_API void releaseUnusedFrozenConstants();
+
+// number of constants in the pool, for testing
+TORCH_API size_t numSharedFrozenConstants();
+
+} // namespace jit
+} // namespace torch
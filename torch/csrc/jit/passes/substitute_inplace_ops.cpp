@@ -0,0 +1,216 @@
+#include <torch/csrc/jit/passes/substitute_inplace_ops.h>
+
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/liveness.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Ops taking a single tensor, which have the dtype of self and its sizes
+bool isUnaryOp(Node* n) {
+  static const OperatorSet unary_ops{
+      "aten::relu(Tensor self) -> Tensor",
+      "aten::sigmoid(Tensor self) -> Tensor",
+      "aten::tanh(Tensor self) -> Tensor",
+      "aten::exp(Tensor self) -> Tensor",
+      "aten::log(Tensor self) -> Tensor",
+      "aten::sqrt(Tensor self) -> Tensor",
+      "aten::rsqrt(Tensor self) -> Tensor",
+      "aten::abs(Tensor self) -> Tensor",
+      "aten::neg(Tensor self) -> Tensor",
+      "aten::reciprocal(Tensor self) -> Tensor",
+      "aten::hardsigmoid(Tensor self) -> Tensor",
+      "aten::hardswish(Tensor self) -> Tensor",
+      "aten::leaky_relu(Tensor self, Scalar negative_slope=0.01) -> Tensor",
+      "aten::hardtanh(Tensor self, Scalar min_val=-1, Scalar max_val=1) -> Tensor",
+      "aten::clamp(Tensor self, Scalar? min=None, Scalar? max=None) -> Tensor",
+  };
+  return n->isMemberOf(unary_ops);
+}
+
+// Ops with a Scalar other, which have the sizes of self, and its dtype if
+// other is a real number
+bool isScalarBinaryOp(Node* n) {
+  static const OperatorSet scalar_binary_ops{
+      "aten::add.Scalar(Tensor self, Scalar other, Scalar alpha=1) -> Tensor",
+      "aten::sub.Scalar(Tensor self, Scalar other, Scalar alpha=1) -> Tensor",
+      "aten::mul.Scalar(Tensor self, Scalar other) -> Tensor",
+      "aten::div.Scalar(Tensor self, Scalar other) -> Tensor",
+  };
+  return n->isMemberOf(scalar_binary_ops);
+}
+
+// Ops with a Tensor other, which have the sizes of self if other broadcasts
+// to them, and its dtype if other has the same one
+bool isTensorBinaryOp(Node* n) {
+  static const OperatorSet tensor_binary_ops{
+      "aten::add.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+      "aten::sub.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+      "aten::mul.Tensor(Tensor self, Tensor other) -> Tensor",
+      "aten::div.Tensor(Tensor self, Tensor other) -> Tensor",
+  };
+  return n->isMemberOf(tensor_binary_ops);
+}
+
+bool isRealNumber(const Value* v) {
+  const auto kind = v->type()->kind();
+  return kind == IntType::Kind || kind == FloatType::Kind ||
+      kind == BoolType::Kind;
+}
+
+// Floating point and known not to require grad
+bool isInferenceTensor(const TensorTypePtr& type) {
+  return type && type->scalarType() &&
+      isFloatingType(*type->scalarType()) && type->requiresGrad() &&
+      !*type->requiresGrad();
+}
+
+// Does a tensor of sizes other broadcast to self without changing its sizes
+bool broadcastsTo(
+    const std::vector<int64_t>& other,
+    const std::vector<int64_t>& self) {
+  if (other.size() > self.size()) {
+    return false;
+  }
+  for (size_t i = 1; i <= other.size(); ++i) {
+    const int64_t size = other[other.size() - i];
+    if (size != 1 && size != self[self.size() - i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct InplaceOpsSubstitution {
+  explicit InplaceOpsSubstitution(std::shared_ptr<Graph> graph)
+      // the liveness analysis adds and removes nodes, so it runs first
+      : graph_(std::move(graph)),
+        liveness_(BuildLivenessSets(graph_)),
+        aliasDb_(graph_) {}
+
+  bool run() {
+    // Decided on the original graph: an op is only substituted if its self
+    // and all of its aliases are dead after it, so the substitutions don't
+    // change the liveness of the buffers that the next ones rely on
+    std::vector<Node*> nodes;
+    collect(graph_->block(), nodes);
+    for (Node* n : nodes) {
+      substitute(n);
+    }
+    return !nodes.empty();
+  }
+
+ private:
+  void collect(Block* block, std::vector<Node*>& nodes) {
+    for (Node* n : block->nodes()) {
+      for (Block* b : n->blocks()) {
+        collect(b, nodes);
+      }
+      if (canSubstitute(n)) {
+        nodes.push_back(n);
+      }
+    }
+  }
+
+  // The values used after n, if known
+  const std::vector<Value*>* liveAfter(Node* n) const {
+    Node* next = n->next();
+    if (next != n->owningBlock()->return_node()) {
+      auto it = liveness_.find(next);
+      return it != liveness_.end() ? &it->second : nullptr;
+    }
+    // what is used after the last node of a nested block depends on the node
+    // owning it, e.g. the next iteration of a loop
+    return n->owningBlock() == graph_->block() ? &graph_outputs_ : nullptr;
+  }
+
+  // Is v a new tensor, and not e.g. a view of an input of its node, a graph
+  // or block input or a constant, which would outlive this run of the graph
+  bool isFreshTensor(Value* v) const {
+    Node* node = v->node();
+    return node->kind() != prim::Param && node->kind() != prim::Constant &&
+        node->blocks().empty() && !node->hasSideEffects() &&
+        !aliasDb_.mayContainAlias(node->inputs(), v) &&
+        !aliasDb_.mayContainAlias(graph_->inputs(), v);
+  }
+
+  bool canSubstitute(Node* n) const {
+    const bool tensor_binary = isTensorBinaryOp(n);
+    if (!tensor_binary && !isScalarBinaryOp(n) && !isUnaryOp(n)) {
+      return false;
+    }
+    Value* self = n->inputs().at(0);
+    const auto self_type = self->type()->cast<TensorType>();
+    if (!isInferenceTensor(self_type)) {
+      return false;
+    }
+
+    if (tensor_binary) {
+      Value* other = n->inputs().at(1);
+      const auto other_type = other->type()->cast<TensorType>();
+      if (!isInferenceTensor(other_type) ||
+          *other_type->scalarType() != *self_type->scalarType()) {
+        return false;
+      }
+      const auto self_sizes = self_type->sizes().concrete_sizes();
+      const auto other_sizes = other_type->sizes().concrete_sizes();
+      if (!self_sizes || !other_sizes ||
+          !broadcastsTo(*other_sizes, *self_sizes)) {
+        return false;
+      }
+      // elementwise ops may read the very elements they write, but not the
+      // ones of an overlapping view
+      if (other != self && aliasDb_.mayContainAlias(other, self)) {
+        return false;
+      }
+    }
+    // the Scalar other and alpha of add, sub, mul and div
+    if (!isUnaryOp(n)) {
+      for (size_t i = 1; i < n->inputs().size(); ++i) {
+        Value* input = n->inputs().at(i);
+        if (!input->type()->cast<TensorType>() && !isRealNumber(input)) {
+          return false;
+        }
+      }
+    }
+
+    if (!isFreshTensor(self)) {
+      return false;
+    }
+    const std::vector<Value*>* live = liveAfter(n);
+    return live && !aliasDb_.mayContainAlias(*live, self);
+  }
+
+  void substitute(Node* n) {
+    WithInsertPoint guard(n);
+    const Symbol inplace_kind =
+        Symbol::fromQualString(std::string(n->kind().toQualString()) + "_");
+    Node* inplace = graph_->insertNode(graph_->create(inplace_kind, n->inputs()));
+    inplace->copyMetadata(n);
+    inplace->output()->copyMetadata(n->output());
+    TORCH_INTERNAL_ASSERT(
+        inplace->maybeOperator(), "No in-place variant of ", *n);
+    GRAPH_UPDATE("Replacing ", *n, " with ", *inplace);
+    n->output()->replaceAllUsesWith(inplace->output());
+    n->destroy();
+  }
+
+  std::shared_ptr<Graph> graph_;
+  std::unordered_map<Node*, std::vector<Value*>> liveness_;
+  AliasDb aliasDb_;
+  std::vector<Value*> graph_outputs_{graph_->outputs().vec()};
+};
+
+} // namespace
+
+bool SubstituteInplaceOps(const std::shared_ptr<Graph>& graph) {
+  const bool changed = InplaceOpsSubstitution(graph).run();
+  GRAPH_DUMP("After SubstituteInplaceOps: ", graph);
+  return changed;
+}
+
+} // namespace jit
+} // namespace torch
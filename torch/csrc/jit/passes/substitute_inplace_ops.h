@@ -0,0 +1,22 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Replaces out-of-place elementwise ops, e.g. aten::add or aten::relu, with
+// their in-place variants when their first input is dead after them, so that
+// a chain like relu(add(x, y)) computes relu in the buffer allocated by add
+// instead of allocating a new tensor at every step.
+//
+// The first input must be freshly allocated by its node and, according to
+// BuildLivenessSets and AliasDb, neither it nor any of its aliases may be used
+// after the op. Its complete TensorType must show that the op keeps its sizes
+// and its (floating point) dtype, and that it doesn't require grad. The pass
+// introduces mutation, so it's meant to run last, on inference graphs.
+// Returns true if it changed the graph.
+TORCH_API bool SubstituteInplaceOps(const std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
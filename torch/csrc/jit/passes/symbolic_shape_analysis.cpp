@@ -0,0 +1,1078 @@
+#include <torch/csrc/jit/passes/symbolic_shape_analysis.h>
+
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/runtime/operator.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+using c10::ShapeSymbol;
+using Dims = std::vector<ShapeSymbol>;
+
+bool isStaticOne(const ShapeSymbol& s) {
+  return s.is_static() && s.static_size() == 1;
+}
+
+bool allStatic(const Dims& dims) {
+  return std::all_of(dims.begin(), dims.end(), [](const ShapeSymbol& s) {
+    return s.is_static();
+  });
+}
+
+c10::optional<size_t> wrapDim(int64_t dim, size_t rank) {
+  const auto r = static_cast<int64_t>(rank);
+  if (dim < 0) {
+    dim += r;
+  }
+  if (dim < 0 || dim >= r) {
+    return c10::nullopt;
+  }
+  return static_cast<size_t>(dim);
+}
+
+c10::optional<int64_t> constantInt(Value* v) {
+  auto ival = toIValue(v);
+  if (!ival || !ival->isInt()) {
+    return c10::nullopt;
+  }
+  return ival->toInt();
+}
+
+c10::optional<bool> constantBool(Value* v) {
+  auto ival = toIValue(v);
+  if (!ival || !ival->isBool()) {
+    return c10::nullopt;
+  }
+  return ival->toBool();
+}
+
+// A constant int[], or a prim::ListConstruct of constant ints
+c10::optional<std::vector<int64_t>> constantIntList(Value* v) {
+  if (v->node()->kind() == prim::ListConstruct) {
+    std::vector<int64_t> values;
+    for (Value* element : v->node()->inputs()) {
+      auto value = constantInt(element);
+      if (!value) {
+        return c10::nullopt;
+      }
+      values.push_back(*value);
+    }
+    return values;
+  }
+  auto ival = toIValue(v);
+  if (!ival || !ival->isIntList()) {
+    return c10::nullopt;
+  }
+  return ival->toIntVector();
+}
+
+// The two symbols of a dimension that has to be the same in both of the
+// operands, e.g. the batch dimension of bmm; a static one is more useful
+ShapeSymbol unify(const ShapeSymbol& a, const ShapeSymbol& b) {
+  return b.is_static() && !a.is_static() ? b : a;
+}
+
+// The symbol of the dimension of a value that is one of two others, e.g.
+// an output of a prim::If
+ShapeSymbol join(const ShapeSymbol& a, const ShapeSymbol& b) {
+  return a == b ? a : ShapeSymbol::newSymbol();
+}
+
+Dims join(const Dims& a, const Dims& b) {
+  Dims result;
+  result.reserve(a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    result.push_back(join(a[i], b[i]));
+  }
+  return result;
+}
+
+class SymbolicShapePropagator {
+ public:
+  explicit SymbolicShapePropagator(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)) {}
+
+  void run() {
+    propagateBlock(graph_->block());
+  }
+
+ private:
+  void propagateBlock(Block* block) {
+    for (Node* node : block->nodes()) {
+      propagateNode(node);
+    }
+  }
+
+  void propagateNode(Node* node) {
+    if (node->kind() == prim::If) {
+      propagateIf(node);
+      return;
+    }
+    if (node->kind() == prim::Loop) {
+      propagateLoop(node);
+      return;
+    }
+    for (Block* block : node->blocks()) {
+      propagateBlock(block);
+    }
+    if (node->outputs().empty() ||
+        !node->output(0)->type()->cast<TensorType>()) {
+      return;
+    }
+    if (auto dims = outputDims(node)) {
+      // Every op with a formula returns tensors of the same shape
+      for (Value* output : node->outputs()) {
+        setDims(output, *dims);
+      }
+    }
+  }
+
+  void propagateIf(Node* node) {
+    for (Block* block : node->blocks()) {
+      propagateBlock(block);
+    }
+    for (size_t i = 0; i < node->outputs().size(); ++i) {
+      auto then_dims = dimsOf(node->blocks().at(0)->outputs().at(i));
+      auto else_dims = dimsOf(node->blocks().at(1)->outputs().at(i));
+      if (then_dims && else_dims && then_dims->size() == else_dims->size()) {
+        setDims(node->output(i), join(*then_dims, *else_dims));
+      }
+    }
+  }
+
+  // The body is propagated with the shapes the loop-carried values enter
+  // with; the dimensions the body changes are then replaced with new symbols
+  // and the body is propagated once more, which is a fixed point since a new
+  // symbol doesn't say anything about the size.
+  void propagateLoop(Node* node) {
+    Block* body = node->blocks().at(0);
+    const size_t num_carried = node->outputs().size();
+    auto carriedIn = [&](size_t i) { return body->inputs().at(i + 1); };
+    auto carriedOut = [&](size_t i) { return body->outputs().at(i + 1); };
+
+    // The second pass starts over from the types the body had, so that it
+    // doesn't keep the static sizes the first one computed
+    std::vector<std::pair<Value*, TypePtr>> body_types;
+    saveTypes(body, body_types);
+
+    for (size_t i = 0; i < num_carried; ++i) {
+      if (auto dims = dimsOf(node->input(i + 2))) {
+        setDims(carriedIn(i), *dims);
+      }
+    }
+    propagateBlock(body);
+
+    std::vector<c10::optional<Dims>> widened(num_carried);
+    bool any_widened = false;
+    for (size_t i = 0; i < num_carried; ++i) {
+      auto in_dims = dimsOf(carriedIn(i));
+      auto out_dims = dimsOf(carriedOut(i));
+      if (!in_dims || !out_dims || in_dims->size() != out_dims->size()) {
+        continue;
+      }
+      auto joined = join(*in_dims, *out_dims);
+      if (joined != *in_dims) {
+        widened[i] = std::move(joined);
+        any_widened = true;
+      }
+    }
+    if (any_widened) {
+      for (const auto& value_type : body_types) {
+        value_type.first->setType(value_type.second);
+      }
+      for (size_t i = 0; i < num_carried; ++i) {
+        if (widened[i]) {
+          // the sizes of the first iteration don't hold for the next ones
+          setDims(carriedIn(i), *widened[i], /*keep_static=*/false);
+        } else if (auto dims = dimsOf(node->input(i + 2))) {
+          setDims(carriedIn(i), *dims);
+        }
+      }
+      propagateBlock(body);
+    }
+
+    for (size_t i = 0; i < num_carried; ++i) {
+      auto in_dims = dimsOf(carriedIn(i));
+      auto out_dims = dimsOf(carriedOut(i));
+      if (in_dims && out_dims && in_dims->size() == out_dims->size()) {
+        setDims(node->output(i), join(*in_dims, *out_dims));
+      }
+    }
+  }
+
+  static void saveTypes(
+      Block* block,
+      std::vector<std::pair<Value*, TypePtr>>& types) {
+    for (Value* input : block->inputs()) {
+      types.emplace_back(input, input->type());
+    }
+    for (Node* node : block->nodes()) {
+      for (Value* output : node->outputs()) {
+        types.emplace_back(output, output->type());
+      }
+      for (Block* sub_block : node->blocks()) {
+        saveTypes(sub_block, types);
+      }
+    }
+  }
+
+  c10::optional<Dims> dimsOf(Value* v) {
+    auto type = v->type()->cast<TensorType>();
+    if (!type) {
+      return c10::nullopt;
+    }
+    return type->symbolic_sizes().sizes();
+  }
+
+  // Static dimensions already in the type of v are kept, e.g. the profiled
+  // ones, unless keep_static is false
+  void setDims(Value* v, Dims dims, bool keep_static = true) {
+    auto type = v->type()->cast<TensorType>();
+    if (!type) {
+      return;
+    }
+    auto current = type->symbolic_sizes().sizes();
+    if (current && keep_static) {
+      if (current->size() != dims.size()) {
+        GRAPH_DEBUG(
+            "Keeping the rank ",
+            current->size(),
+            " of %",
+            v->debugName(),
+            " over the rank ",
+            dims.size(),
+            " of its shape formula");
+        return;
+      }
+      for (size_t i = 0; i < dims.size(); ++i) {
+        if ((*current)[i].is_static()) {
+          dims[i] = (*current)[i];
+        }
+      }
+    }
+    v->setType(type->withSymbolicShapes(c10::SymbolicShape(std::move(dims))));
+  }
+
+  // The symbol of a dimension given as an int argument: its value if it is a
+  // constant, the symbol of the dimension it was read from with aten::size,
+  // or else a symbol of its own, which is the same for every use of v.
+  // nullopt for negative constants, which have a special meaning in most ops
+  c10::optional<ShapeSymbol> symbolOfInt(Value* v) {
+    if (auto value = constantInt(v)) {
+      if (*value < 0) {
+        return c10::nullopt;
+      }
+      return ShapeSymbol::fromStaticSize(*value);
+    }
+    if (!v->type()->isSubtypeOf(IntType::get())) {
+      return c10::nullopt;
+    }
+    Node* n = v->node();
+    c10::optional<Dims> dims;
+    c10::optional<int64_t> dim;
+    if (n->matches("aten::size(Tensor self, int dim) -> int")) {
+      dims = dimsOf(n->input(0));
+      dim = constantInt(n->input(1));
+    } else if (
+        n->kind() == aten::__getitem__ && n->inputs().size() == 2 &&
+        n->input(0)->node()->matches("aten::size(Tensor self) -> int[]")) {
+      dims = dimsOf(n->input(0)->node()->input(0));
+      dim = constantInt(n->input(1));
+    }
+    if (dims && dim) {
+      if (auto wrapped = wrapDim(*dim, dims->size())) {
+        return (*dims)[*wrapped];
+      }
+    }
+    auto it = int_symbols_.find(v);
+    if (it == int_symbols_.end()) {
+      it = int_symbols_.emplace(v, ShapeSymbol::newSymbol()).first;
+    }
+    return it->second;
+  }
+
+  // An int[] argument of sizes, with nullopt for the elements that are
+  // negative constants, e.g. the -1 of view
+  c10::optional<std::vector<c10::optional<ShapeSymbol>>> symbolsOfIntList(
+      Value* v) {
+    std::vector<c10::optional<ShapeSymbol>> result;
+    if (auto values = constantIntList(v)) {
+      for (int64_t value : *values) {
+        result.push_back(
+            value < 0 ? c10::nullopt
+                      : c10::make_optional(ShapeSymbol::fromStaticSize(value)));
+      }
+      return result;
+    }
+    Node* n = v->node();
+    if (n->matches("aten::size(Tensor self) -> int[]")) {
+      auto dims = dimsOf(n->input(0));
+      if (!dims) {
+        return c10::nullopt;
+      }
+      result.assign(dims->begin(), dims->end());
+      return result;
+    }
+    if (n->kind() != prim::ListConstruct) {
+      return c10::nullopt;
+    }
+    for (Value* element : n->inputs()) {
+      result.push_back(symbolOfInt(element));
+    }
+    return result;
+  }
+
+  // The symbol of a dimension computed by formula from the sizes of the
+  // operands and the constant params. It is the same for the same formula,
+  // operands and params, which is what relates the symbols of e.g. two
+  // concatenations of the same tensors. compute gets the sizes of the
+  // operands when they are all static.
+  ShapeSymbol derive(
+      const char* formula,
+      Dims operands,
+      std::vector<int64_t> params,
+      const std::function<int64_t(const std::vector<int64_t>&)>& compute) {
+    if (allStatic(operands)) {
+      std::vector<int64_t> sizes;
+      sizes.reserve(operands.size());
+      for (const auto& s : operands) {
+        sizes.push_back(s.static_size());
+      }
+      const int64_t size = compute(sizes);
+      // A negative size is an error of the op, leave it to the op to report
+      return size >= 0 ? ShapeSymbol::fromStaticSize(size)
+                       : ShapeSymbol::newSymbol();
+    }
+    auto key = std::make_tuple(
+        std::string(formula), std::move(operands), std::move(params));
+    auto it = derived_symbols_.find(key);
+    if (it == derived_symbols_.end()) {
+      it = derived_symbols_.emplace(std::move(key), ShapeSymbol::newSymbol())
+               .first;
+    }
+    return it->second;
+  }
+
+  ShapeSymbol product(Dims dims) {
+    if (dims.size() == 1) {
+      return dims[0];
+    }
+    std::sort(dims.begin(), dims.end());
+    return derive(
+        "product", std::move(dims), {}, [](const std::vector<int64_t>& sizes) {
+          int64_t result = 1;
+          for (int64_t size : sizes) {
+            result *= size;
+          }
+          return result;
+        });
+  }
+
+  c10::optional<ShapeSymbol> broadcast(
+      const ShapeSymbol& a,
+      const ShapeSymbol& b) {
+    if (a == b || isStaticOne(b)) {
+      return a;
+    }
+    if (isStaticOne(a)) {
+      return b;
+    }
+    if (a.is_static() && b.is_static()) {
+      // Not broadcastable, leave it to the op to report
+      return c10::nullopt;
+    }
+    // The other one has to be 1 or the same
+    if (a.is_static()) {
+      return a;
+    }
+    if (b.is_static()) {
+      return b;
+    }
+    Dims operands = {a, b};
+    std::sort(operands.begin(), operands.end());
+    return derive("broadcast", std::move(operands), {}, nullptr);
+  }
+
+  c10::optional<Dims> broadcast(const Dims& a, const Dims& b) {
+    const size_t rank = std::max(a.size(), b.size());
+    Dims result(rank);
+    for (size_t i = 0; i < rank; ++i) {
+      // aligned from the last dimension
+      const size_t a_offset = rank - a.size();
+      const size_t b_offset = rank - b.size();
+      if (i < a_offset) {
+        result[i] = b[i - b_offset];
+      } else if (i < b_offset) {
+        result[i] = a[i - a_offset];
+      } else {
+        auto s = broadcast(a[i - a_offset], b[i - b_offset]);
+        if (!s) {
+          return c10::nullopt;
+        }
+        result[i] = *s;
+      }
+    }
+    return result;
+  }
+
+  c10::optional<Dims> broadcastTensorInputs(Node* node) {
+    c10::optional<Dims> result;
+    for (Value* input : node->inputs()) {
+      if (!input->type()->cast<TensorType>()) {
+        continue;
+      }
+      auto dims = dimsOf(input);
+      if (!dims) {
+        return c10::nullopt;
+      }
+      result = result ? broadcast(*result, *dims) : dims;
+      if (!result) {
+        return c10::nullopt;
+      }
+    }
+    return result;
+  }
+
+  c10::optional<Dims> matmul(const Dims& a, const Dims& b) {
+    if (a.empty() || b.empty()) {
+      return c10::nullopt;
+    }
+    // A 1-d operand is a row (or column) vector whose dimension is removed
+    // from the result
+    const Dims batch_a(a.begin(), a.end() - std::min<size_t>(a.size(), 2));
+    const Dims batch_b(b.begin(), b.end() - std::min<size_t>(b.size(), 2));
+    auto result = broadcast(batch_a, batch_b);
+    if (!result) {
+      return c10::nullopt;
+    }
+    if (a.size() >= 2) {
+      result->push_back(a[a.size() - 2]);
+    }
+    if (b.size() >= 2) {
+      result->push_back(b.back());
+    }
+    return result;
+  }
+
+  c10::optional<Dims> convolution(Node* node, size_t num_spatial) {
+    auto input = dimsOf(node->input(0));
+    auto weight = dimsOf(node->input(1));
+    auto stride = constantIntList(node->input(3));
+    auto padding = constantIntList(node->input(4));
+    auto dilation = constantIntList(node->input(5));
+    if (!input || !weight || !stride || !padding || !dilation ||
+        input->size() != num_spatial + 2 || weight->size() != num_spatial + 2) {
+      return c10::nullopt;
+    }
+    // A single value applies to all of the spatial dimensions
+    auto param = [&](const std::vector<int64_t>& values, size_t i) {
+      return values.size() == 1 ? values[0] : values.at(i);
+    };
+    for (const auto* values : {&*stride, &*padding, &*dilation}) {
+      if (values->size() != 1 && values->size() != num_spatial) {
+        return c10::nullopt;
+      }
+    }
+    Dims result = {(*input)[0], (*weight)[0]};
+    for (size_t i = 0; i < num_spatial; ++i) {
+      const ShapeSymbol& in = (*input)[i + 2];
+      const ShapeSymbol& kernel = (*weight)[i + 2];
+      const int64_t s = param(*stride, i);
+      const int64_t p = param(*padding, i);
+      const int64_t d = param(*dilation, i);
+      if (s == 1 && kernel.is_static() &&
+          d * (kernel.static_size() - 1) == 2 * p) {
+        // "same" padding keeps the size
+        result.push_back(in);
+        continue;
+      }
+      result.push_back(derive(
+          "convolution",
+          {in, kernel},
+          {s, p, d},
+          [s, p, d](const std::vector<int64_t>& sizes) {
+            return (sizes[0] + 2 * p - d * (sizes[1] - 1) - 1) / s + 1;
+          }));
+    }
+    return result;
+  }
+
+  c10::optional<Dims> cat(Node* node) {
+    auto dim = constantInt(node->input(1));
+    Node* list = node->input(0)->node();
+    if (!dim || list->kind() != prim::ListConstruct || list->inputs().empty()) {
+      return c10::nullopt;
+    }
+    std::vector<Dims> inputs;
+    for (Value* tensor : list->inputs()) {
+      auto dims = dimsOf(tensor);
+      if (!dims || (!inputs.empty() && dims->size() != inputs[0].size())) {
+        return c10::nullopt;
+      }
+      inputs.push_back(std::move(*dims));
+    }
+    auto cat_dim = wrapDim(*dim, inputs[0].size());
+    if (!cat_dim) {
+      return c10::nullopt;
+    }
+    Dims result = inputs[0];
+    Dims cat_sizes;
+    for (const auto& dims : inputs) {
+      for (size_t i = 0; i < dims.size(); ++i) {
+        if (i != *cat_dim) {
+          result[i] = unify(result[i], dims[i]);
+        }
+      }
+      cat_sizes.push_back(dims[*cat_dim]);
+    }
+    if (cat_sizes.size() > 1) {
+      std::sort(cat_sizes.begin(), cat_sizes.end());
+      result[*cat_dim] = derive(
+          "sum",
+          std::move(cat_sizes),
+          {},
+          [](const std::vector<int64_t>& sizes) {
+            int64_t result = 0;
+            for (int64_t size : sizes) {
+              result += size;
+            }
+            return result;
+          });
+    }
+    return result;
+  }
+
+  c10::optional<Dims> view(Node* node) {
+    auto sizes = symbolsOfIntList(node->input(1));
+    if (!sizes) {
+      return c10::nullopt;
+    }
+    Dims result;
+    Dims known;
+    c10::optional<size_t> inferred;
+    for (size_t i = 0; i < sizes->size(); ++i) {
+      if ((*sizes)[i]) {
+        result.push_back(*(*sizes)[i]);
+        known.push_back(*(*sizes)[i]);
+      } else if (!inferred) {
+        // -1, filled in below
+        inferred = i;
+        result.emplace_back();
+      } else {
+        return c10::nullopt;
+      }
+    }
+    if (!inferred) {
+      return result;
+    }
+    auto input = dimsOf(node->input(0));
+    if (!input) {
+      result[*inferred] = ShapeSymbol::newSymbol();
+      return result;
+    }
+    // numel(input) / prod(known), cancelling the symbols on both sides, so
+    // that e.g. x.view(x.size(0), -1) only multiplies the other dimensions
+    Dims numerator = *input;
+    Dims denominator;
+    for (const auto& s : known) {
+      auto it = std::find(numerator.begin(), numerator.end(), s);
+      if (it != numerator.end()) {
+        numerator.erase(it);
+      } else {
+        denominator.push_back(s);
+      }
+    }
+    if (denominator.empty()) {
+      result[*inferred] = numerator.empty() ? ShapeSymbol::fromStaticSize(1)
+                                            : product(numerator);
+      return result;
+    }
+    std::sort(numerator.begin(), numerator.end());
+    std::sort(denominator.begin(), denominator.end());
+    const auto num_numerator = static_cast<int64_t>(numerator.size());
+    Dims operands = std::move(numerator);
+    operands.insert(operands.end(), denominator.begin(), denominator.end());
+    result[*inferred] = derive(
+        "view",
+        std::move(operands),
+        {num_numerator},
+        [num_numerator](const std::vector<int64_t>& sizes) -> int64_t {
+          int64_t numel = 1;
+          int64_t known_numel = 1;
+          for (size_t i = 0; i < sizes.size(); ++i) {
+            (static_cast<int64_t>(i) < num_numerator ? numel : known_numel) *=
+                sizes[i];
+          }
+          if (known_numel == 0 || numel % known_numel != 0) {
+            return -1;
+          }
+          return numel / known_numel;
+        });
+    return result;
+  }
+
+  c10::optional<Dims> flatten(Node* node) {
+    auto input = dimsOf(node->input(0));
+    auto start = constantInt(node->input(1));
+    auto end = constantInt(node->input(2));
+    if (!input || !start || !end) {
+      return c10::nullopt;
+    }
+    if (input->empty()) {
+      return Dims{ShapeSymbol::fromStaticSize(1)};
+    }
+    auto start_dim = wrapDim(*start, input->size());
+    auto end_dim = wrapDim(*end, input->size());
+    if (!start_dim || !end_dim || *start_dim > *end_dim) {
+      return c10::nullopt;
+    }
+    Dims result(input->begin(), input->begin() + *start_dim);
+    result.push_back(product(
+        Dims(input->begin() + *start_dim, input->begin() + *end_dim + 1)));
+    result.insert(result.end(), input->begin() + *end_dim + 1, input->end());
+    return result;
+  }
+
+  c10::optional<Dims> expand(Node* node) {
+    auto input = dimsOf(node->input(0));
+    auto sizes = symbolsOfIntList(node->input(1));
+    if (!input || !sizes || sizes->size() < input->size()) {
+      return c10::nullopt;
+    }
+    const size_t offset = sizes->size() - input->size();
+    Dims result;
+    for (size_t i = 0; i < sizes->size(); ++i) {
+      if ((*sizes)[i]) {
+        result.push_back(*(*sizes)[i]);
+      } else if (i >= offset) {
+        // -1 keeps the size
+        result.push_back((*input)[i - offset]);
+      } else {
+        return c10::nullopt;
+      }
+    }
+    return result;
+  }
+
+  c10::optional<Dims> slice(Node* node) {
+    auto input = dimsOf(node->input(0));
+    auto dim = constantInt(node->input(1));
+    if (!input || !dim) {
+      return c10::nullopt;
+    }
+    auto wrapped = wrapDim(*dim, input->size());
+    if (!wrapped) {
+      return c10::nullopt;
+    }
+    auto start_ival = toIValue(node->input(2));
+    auto end_ival = toIValue(node->input(3));
+    auto step = constantInt(node->input(4));
+    Dims result = *input;
+    if (!start_ival || !end_ival || !step || *step <= 0 ||
+        !(start_ival->isNone() || start_ival->isInt()) ||
+        !(end_ival->isNone() || end_ival->isInt())) {
+      result[*wrapped] = ShapeSymbol::newSymbol();
+      return result;
+    }
+    const int64_t start = start_ival->isNone() ? 0 : start_ival->toInt();
+    const int64_t end = end_ival->isNone()
+        ? std::numeric_limits<int64_t>::max()
+        : end_ival->toInt();
+    if (start == 0 && end == std::numeric_limits<int64_t>::max() &&
+        *step == 1) {
+      return result;
+    }
+    const int64_t s = *step;
+    result[*wrapped] = derive(
+        "slice",
+        {(*input)[*wrapped]},
+        {start, end, s},
+        [start, end, s](const std::vector<int64_t>& sizes) {
+          const int64_t size = sizes[0];
+          auto clamp = [size](int64_t i) {
+            if (i < 0) {
+              i += size;
+            }
+            return std::min(std::max<int64_t>(i, 0), size);
+          };
+          const int64_t begin_index = clamp(start);
+          const int64_t end_index = clamp(end);
+          return end_index <= begin_index
+              ? int64_t(0)
+              : (end_index - begin_index + s - 1) / s;
+        });
+    return result;
+  }
+
+  // A reduction over dims, all of them if dims is empty
+  c10::optional<Dims> reduce(
+      Node* node,
+      const c10::optional<std::vector<int64_t>>& dims,
+      Value* keepdim_value) {
+    auto input = dimsOf(node->input(0));
+    auto keepdim = constantBool(keepdim_value);
+    if (!input || !dims || !keepdim) {
+      return c10::nullopt;
+    }
+    std::vector<bool> reduced(input->size(), dims->empty());
+    for (int64_t dim : *dims) {
+      auto wrapped = wrapDim(dim, input->size());
+      if (!wrapped) {
+        return c10::nullopt;
+      }
+      reduced[*wrapped] = true;
+    }
+    Dims result;
+    for (size_t i = 0; i < input->size(); ++i) {
+      if (!reduced[i]) {
+        result.push_back((*input)[i]);
+      } else if (*keepdim) {
+        result.push_back(ShapeSymbol::fromStaticSize(1));
+      }
+    }
+    return result;
+  }
+
+  c10::optional<Dims> outputDims(Node* node) {
+    // Requirements:
+    //   dims           : the ones of the first input
+    static const OperatorSet shape_preserving_ops{
+        "aten::acos(Tensor self) -> Tensor",
+        "aten::asin(Tensor self) -> Tensor",
+        "aten::atan(Tensor self) -> Tensor",
+        "aten::abs(Tensor self) -> Tensor",
+        "aten::neg(Tensor self) -> Tensor",
+        "aten::sigmoid(Tensor self) -> Tensor",
+        "aten::logit(Tensor self, float? eps=None) -> Tensor",
+        "aten::tanh(Tensor self) -> Tensor",
+        "aten::relu(Tensor self) -> Tensor",
+        "aten::gelu(Tensor self) -> Tensor",
+        "aten::ceil(Tensor self) -> Tensor",
+        "aten::floor(Tensor self) -> Tensor",
+        "aten::round(Tensor self) -> Tensor",
+        "aten::trunc(Tensor self) -> Tensor",
+        "aten::frac(Tensor self) -> Tensor",
+        "aten::sign(Tensor self) -> Tensor",
+        "aten::clone(Tensor self, *, MemoryFormat? memory_format=None) -> Tensor",
+        "aten::contiguous(Tensor(a) self, *, MemoryFormat memory_format=contiguous_format) -> Tensor(a)",
+        "aten::clamp(Tensor self, Scalar? min, Scalar? max) -> Tensor",
+        "aten::clamp_max(Tensor self, Scalar max) -> Tensor",
+        "aten::clamp_min(Tensor self, Scalar min) -> Tensor",
+        "aten::celu(Tensor self, Scalar alpha) -> Tensor",
+        "aten::elu(Tensor self, Scalar alpha, Scalar scale, Scalar input_scale) -> Tensor",
+        "aten::selu(Tensor self) -> Tensor",
+        "aten::leaky_relu(Tensor self, Scalar negative_slope) -> Tensor",
+        "aten::hardtanh(Tensor self, Scalar min_val, Scalar max_val) -> Tensor",
+        "aten::hardshrink(Tensor self, Scalar lambd) -> Tensor",
+        "aten::softshrink(Tensor self, Scalar lambd) -> Tensor",
+        "aten::softplus(Tensor self, Scalar beta, Scalar threshold) -> Tensor",
+        "aten::threshold(Tensor self, Scalar threshold, Scalar value) -> Tensor",
+        "aten::log_sigmoid(Tensor self) -> Tensor",
+        "aten::prelu(Tensor self, Tensor weight) -> Tensor",
+        "aten::cos(Tensor self) -> Tensor",
+        "aten::cosh(Tensor self) -> Tensor",
+        "aten::sin(Tensor self) -> Tensor",
+        "aten::sinh(Tensor self) -> Tensor",
+        "aten::tan(Tensor self) -> Tensor",
+        "aten::erf(Tensor self) -> Tensor",
+        "aten::erfc(Tensor self) -> Tensor",
+        "aten::erfinv(Tensor self) -> Tensor",
+        "aten::exp(Tensor self) -> Tensor",
+        "aten::expm1(Tensor self) -> Tensor",
+        "aten::log(Tensor self) -> Tensor",
+        "aten::log10(Tensor self) -> Tensor",
+        "aten::log1p(Tensor self) -> Tensor",
+        "aten::log2(Tensor self) -> Tensor",
+        "aten::digamma(Tensor self) -> Tensor",
+        "aten::lgamma(Tensor self) -> Tensor",
+        "aten::reciprocal(Tensor self) -> Tensor",
+        "aten::rsqrt(Tensor self) -> Tensor",
+        "aten::sqrt(Tensor self) -> Tensor",
+        "aten::tril(Tensor self, int diagonal) -> Tensor",
+        "aten::triu(Tensor self, int diagonal) -> Tensor",
+        "aten::flip(Tensor self, int[] dims) -> Tensor",
+        "aten::alias(Tensor self) -> Tensor",
+        "aten::dropout(Tensor input, float p, bool train) -> Tensor",
+        "aten::feature_dropout(Tensor input, float p, bool train) -> Tensor",
+        "aten::alpha_dropout(Tensor input, float p, bool train) -> Tensor",
+        "aten::softmax(Tensor self, int dim, int? dtype) -> Tensor",
+        "aten::log_softmax(Tensor self, int dim, int? dtype) -> Tensor",
+        "aten::batch_norm(Tensor input, Tensor? weight, Tensor? bias, Tensor? running_mean, Tensor? running_var, bool training, float momentum, float eps, bool cudnn_enabled) -> Tensor",
+        "aten::layer_norm(Tensor input, int[] normalized_shape, Tensor? weight, Tensor? bias, float eps, bool cudnn_enable) -> Tensor",
+        "aten::add(Tensor self, Scalar other, Scalar alpha) -> Tensor",
+        "aten::sub(Tensor self, Scalar other, Scalar alpha) -> Tensor",
+        "aten::mul(Tensor self, Scalar other) -> Tensor",
+        "aten::div(Tensor self, Scalar other) -> Tensor",
+        "aten::pow(Tensor self, Scalar exponent) -> Tensor",
+        "aten::fmod(Tensor self, Scalar other) -> Tensor",
+        "aten::remainder(Tensor self, Scalar other) -> Tensor",
+        "aten::lt(Tensor self, Scalar other) -> Tensor",
+        "aten::le(Tensor self, Scalar other) -> Tensor",
+        "aten::gt(Tensor self, Scalar other) -> Tensor",
+        "aten::ge(Tensor self, Scalar other) -> Tensor",
+        "aten::eq(Tensor self, Scalar other) -> Tensor",
+        "aten::ne(Tensor self, Scalar other) -> Tensor",
+    };
+    // Requirements:
+    //   dims           : broadcast all tensor args
+    static const OperatorSet broadcasting_ops{
+        "aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+        "aten::sub(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+        "aten::mul(Tensor self, Tensor other) -> Tensor",
+        "aten::div(Tensor self, Tensor other) -> Tensor",
+        "aten::pow(Tensor self, Tensor exponent) -> Tensor",
+        "aten::fmod(Tensor self, Tensor other) -> Tensor",
+        "aten::remainder(Tensor self, Tensor other) -> Tensor",
+        "aten::atan2(Tensor self, Tensor other) -> Tensor",
+        "aten::max(Tensor self, Tensor other) -> Tensor",
+        "aten::min(Tensor self, Tensor other) -> Tensor",
+        "aten::lerp(Tensor self, Tensor end, Scalar weight) -> Tensor",
+        "aten::lerp(Tensor self, Tensor end, Tensor weight) -> Tensor",
+        "aten::addcdiv(Tensor self, Tensor tensor1, Tensor tensor2, *, Scalar value) -> Tensor",
+        "aten::addcmul(Tensor self, Tensor tensor1, Tensor tensor2, *, Scalar value) -> Tensor",
+        "aten::where(Tensor condition, Tensor self, Tensor other) -> Tensor",
+        "aten::lt(Tensor self, Tensor other) -> Tensor",
+        "aten::le(Tensor self, Tensor other) -> Tensor",
+        "aten::gt(Tensor self, Tensor other) -> Tensor",
+        "aten::ge(Tensor self, Tensor other) -> Tensor",
+        "aten::eq(Tensor self, Tensor other) -> Tensor",
+        "aten::ne(Tensor self, Tensor other) -> Tensor",
+        "aten::__and__(Tensor self, Tensor other) -> Tensor",
+        "aten::__or__(Tensor self, Tensor other) -> Tensor",
+        "aten::__xor__(Tensor self, Tensor other) -> Tensor",
+    };
+
+    if (node->isMemberOf(shape_preserving_ops)) {
+      return dimsOf(node->input(0));
+    }
+    if (node->isMemberOf(broadcasting_ops)) {
+      return broadcastTensorInputs(node);
+    }
+
+    if (node->matches("aten::matmul(Tensor self, Tensor other) -> Tensor")) {
+      auto a = dimsOf(node->input(0));
+      auto b = dimsOf(node->input(1));
+      return a && b ? matmul(*a, *b) : c10::nullopt;
+    }
+    if (node->matches("aten::mm(Tensor self, Tensor mat2) -> Tensor")) {
+      auto a = dimsOf(node->input(0));
+      auto b = dimsOf(node->input(1));
+      if (!a || !b || a->size() != 2 || b->size() != 2) {
+        return c10::nullopt;
+      }
+      return Dims{(*a)[0], (*b)[1]};
+    }
+    if (node->matches("aten::bmm(Tensor self, Tensor mat2) -> Tensor")) {
+      auto a = dimsOf(node->input(0));
+      auto b = dimsOf(node->input(1));
+      if (!a || !b || a->size() != 3 || b->size() != 3) {
+        return c10::nullopt;
+      }
+      return Dims{unify((*a)[0], (*b)[0]), (*a)[1], (*b)[2]};
+    }
+    if (node->matches(
+            "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta, Scalar alpha) -> Tensor")) {
+      auto a = dimsOf(node->input(1));
+      auto b = dimsOf(node->input(2));
+      if (!a || !b || a->size() != 2 || b->size() != 2) {
+        return c10::nullopt;
+      }
+      return Dims{(*a)[0], (*b)[1]};
+    }
+    if (node->matches(
+            "aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor")) {
+      auto input = dimsOf(node->input(0));
+      auto weight = dimsOf(node->input(1));
+      if (!input || !weight || input->empty() || weight->size() != 2) {
+        return c10::nullopt;
+      }
+      Dims result(input->begin(), input->end() - 1);
+      result.push_back((*weight)[0]);
+      return result;
+    }
+    if (node->matches(
+            "aten::conv1d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor")) {
+      return convolution(node, 1);
+    }
+    if (node->matches(
+            "aten::conv2d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor")) {
+      return convolution(node, 2);
+    }
+    if (node->matches(
+            "aten::conv3d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor")) {
+      return convolution(node, 3);
+    }
+    if (node->matches("aten::cat(Tensor[] tensors, int dim) -> Tensor")) {
+      return cat(node);
+    }
+    if (node->matches("aten::view(Tensor self, int[] size) -> Tensor") ||
+        node->matches(
+            "aten::reshape(Tensor(a) self, int[] shape) -> Tensor(a)")) {
+      return view(node);
+    }
+    if (node->matches(
+            "aten::flatten(Tensor self, int start_dim, int end_dim) -> Tensor")) {
+      return flatten(node);
+    }
+    if (node->matches(
+            "aten::expand(Tensor self, int[] size, *, bool implicit) -> Tensor")) {
+      return expand(node);
+    }
+    if (node->matches(
+            "aten::slice(Tensor self, int dim, int? start=0, int? end=9223372036854775807, int step=1) -> Tensor")) {
+      return slice(node);
+    }
+
+    auto input = dimsOf(node->input(0));
+    if (!input) {
+      return c10::nullopt;
+    }
+    if (node->matches("aten::unsqueeze(Tensor self, int dim) -> Tensor")) {
+      auto dim = constantInt(node->input(1));
+      auto wrapped = dim ? wrapDim(*dim, input->size() + 1) : c10::nullopt;
+      if (!wrapped) {
+        return c10::nullopt;
+      }
+      input->insert(input->begin() + *wrapped, ShapeSymbol::fromStaticSize(1));
+      return input;
+    }
+    if (node->matches("aten::squeeze(Tensor self, int dim) -> Tensor")) {
+      auto dim = constantInt(node->input(1));
+      auto wrapped = dim ? wrapDim(*dim, input->size()) : c10::nullopt;
+      if (!wrapped) {
+        return input->empty() && dim && (*dim == 0 || *dim == -1)
+            ? input
+            : c10::nullopt;
+      }
+      const ShapeSymbol& s = (*input)[*wrapped];
+      if (!s.is_static()) {
+        // the rank depends on the size
+        return c10::nullopt;
+      }
+      if (isStaticOne(s)) {
+        input->erase(input->begin() + *wrapped);
+      }
+      return input;
+    }
+    if (node->matches("aten::squeeze(Tensor self) -> Tensor")) {
+      if (!allStatic(*input)) {
+        return c10::nullopt;
+      }
+      input->erase(
+          std::remove_if(input->begin(), input->end(), isStaticOne),
+          input->end());
+      return input;
+    }
+    if (node->matches("aten::select(Tensor self, int dim, int index) -> Tensor")) {
+      auto dim = constantInt(node->input(1));
+      auto wrapped = dim ? wrapDim(*dim, input->size()) : c10::nullopt;
+      if (!wrapped) {
+        return c10::nullopt;
+      }
+      input->erase(input->begin() + *wrapped);
+      return input;
+    }
+    if (node->matches(
+            "aten::narrow(Tensor self, int dim, int start, int length) -> Tensor")) {
+      auto dim = constantInt(node->input(1));
+      auto wrapped = dim ? wrapDim(*dim, input->size()) : c10::nullopt;
+      auto length = symbolOfInt(node->input(3));
+      if (!wrapped || !length) {
+        return c10::nullopt;
+      }
+      (*input)[*wrapped] = *length;
+      return input;
+    }
+    if (node->matches(
+            "aten::transpose(Tensor self, int dim0, int dim1) -> Tensor")) {
+      auto dim0 = constantInt(node->input(1));
+      auto dim1 = constantInt(node->input(2));
+      auto wrapped0 = dim0 ? wrapDim(*dim0, input->size()) : c10::nullopt;
+      auto wrapped1 = dim1 ? wrapDim(*dim1, input->size()) : c10::nullopt;
+      if (!wrapped0 || !wrapped1) {
+        return c10::nullopt;
+      }
+      std::swap((*input)[*wrapped0], (*input)[*wrapped1]);
+      return input;
+    }
+    if (node->matches("aten::t(Tensor self) -> Tensor")) {
+      if (input->size() == 2) {
+        std::swap((*input)[0], (*input)[1]);
+      }
+      return input->size() <= 2 ? input : c10::nullopt;
+    }
+    if (node->matches("aten::permute(Tensor self, int[] dims) -> Tensor")) {
+      auto dims = constantIntList(node->input(1));
+      if (!dims || dims->size() != input->size()) {
+        return c10::nullopt;
+      }
+      Dims result;
+      for (int64_t dim : *dims) {
+        auto wrapped = wrapDim(dim, input->size());
+        if (!wrapped) {
+          return c10::nullopt;
+        }
+        result.push_back((*input)[*wrapped]);
+      }
+      return result;
+    }
+
+    if (node->matches(
+            "aten::sum(Tensor self, int[] dim, bool keepdim, *, int? dtype) -> Tensor") ||
+        node->matches(
+            "aten::mean(Tensor self, int[] dim, bool keepdim, *, int? dtype) -> Tensor") ||
+        node->matches(
+            "aten::amax(Tensor self, int[] dim, bool keepdim) -> Tensor") ||
+        node->matches(
+            "aten::amin(Tensor self, int[] dim, bool keepdim) -> Tensor")) {
+      return reduce(node, constantIntList(node->input(1)), node->input(2));
+    }
+    if (node->matches(
+            "aten::max(Tensor self, int dim, bool keepdim) -> (Tensor, Tensor)") ||
+        node->matches(
+            "aten::min(Tensor self, int dim, bool keepdim) -> (Tensor, Tensor)")) {
+      auto dim = constantInt(node->input(1));
+      return reduce(
+          node,
+          dim ? c10::make_optional(std::vector<int64_t>{*dim}) : c10::nullopt,
+          node->input(2));
+    }
+    if (node->matches("aten::sum(Tensor self, *, int? dtype) -> Tensor") ||
+        node->matches("aten::mean(Tensor self, *, int? dtype) -> Tensor") ||
+        node->matches("aten::max(Tensor self) -> Tensor") ||
+        node->matches("aten::min(Tensor self) -> Tensor")) {
+      return Dims{};
+    }
+    return c10::nullopt;
+  }
+
+  std::shared_ptr<Graph> graph_;
+  // the symbols of the ints that aren't constants or read from a size
+  std::unordered_map<Value*, ShapeSymbol> int_symbols_;
+  std::map<std::tuple<std::string, Dims, std::vector<int64_t>>, ShapeSymbol>
+      derived_symbols_;
+};
+
+} // namespace
+
+void PropagateSymbolicShapes(const std::shared_ptr<Graph>& graph) {
+  SymbolicShapePropagator(graph).run();
+  GRAPH_DUMP("After PropagateSymbolicShapes: ", graph);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <memory>
+
+namespace torch {
+namespace jit {
+
+struct Graph;
+
+// Propagates the symbolic shapes (c10::SymbolicShape) of the tensors of the
+// graph, e.g. the ones recorded by the profiling executor, from the inputs
+// of every node to its outputs with a shape formula per op: broadcasting,
+// matmul/mm/bmm/linear, convolutions, cat, view/reshape/flatten/expand and
+// other view ops, reductions and the ops that preserve the shape.
+//
+// Unlike PropagateInputShapes, which only knows concrete sizes, the formulas
+// keep the symbols of the dimensions they don't change, so e.g. the batch
+// dimension of the output of a linear layer is the very symbol of the batch
+// dimension of its input, and give the same new symbol to the dimensions
+// they compute the same way from the same symbols, e.g. two concatenations
+// of the same tensors. Sizes computed with aten::size() keep their symbol as
+// well when they are passed on to view, reshape, expand or narrow. Consumers
+// can therefore specialize once per set of symbols instead of once per
+// concrete size.
+//
+// Static dimensions that are already in the type of a value are kept, the
+// other ones are replaced with the symbols of the formula. Values of ops
+// without a formula keep their type.
+TORCH_API void PropagateSymbolicShapes(const std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
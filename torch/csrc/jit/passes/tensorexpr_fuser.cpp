@@ -178,6 +178,9 @@ bool isSupported(Node* node) {
       "aten::sum.dim_IntList(Tensor self, int[1] dim, bool keepdim=False, *, ScalarType? dtype=None) -> Tensor",
       "aten::softmax.int(Tensor self, int dim , ScalarType? dtype=None) -> Tensor",
       "aten::log_softmax.int(Tensor self, int dim, ScalarType? dtype=None) -> Tensor",
+      // Only small matmuls are fused, see Note [Fused matmuls]
+      "aten::mm(Tensor self, Tensor mat2) -> Tensor",
+      "aten::matmul(Tensor self, Tensor other) -> Tensor",
   };
   static const OperatorSet supported_misc_set{
       "aten::cat(Tensor[] tensors, int dim=0) -> Tensor",
@@ -947,6 +950,29 @@ class TensorExprFuser {
     return true;
   }
 
+  // Matmuls are only fused when the generated loops are expected to beat the
+  // BLAS call, see Note [Fused matmuls]
+  bool isFusibleMatmul(Node* node) {
+    auto a = node->input(0)->type()->cast<TensorType>();
+    auto b = node->input(1)->type()->cast<TensorType>();
+    if (!a || !b) {
+      return false;
+    }
+    auto sizes_a = a->sizes().concrete_sizes();
+    auto sizes_b = b->sizes().concrete_sizes();
+    if (!sizes_a || !sizes_b || sizes_a->size() != 2 || sizes_b->size() != 2) {
+      return false;
+    }
+    if (!a->scalarType() || a->scalarType() != b->scalarType() ||
+        !isFloatingType(*a->scalarType())) {
+      return false;
+    }
+    auto device = tensorexpr::pickDeviceType(node->inputs());
+    return device &&
+        tensorexpr::isFusibleMatmul(
+               *device, (*sizes_a)[0], (*sizes_b)[1], (*sizes_a)[1]);
+  }
+
 #define REQ(cond)                           \
   if (!(cond)) {                            \
     GRAPH_DEBUG("Failed cond " #cond "\n"); \
@@ -982,6 +1008,9 @@ class TensorExprFuser {
 
     REQ(tensorexpr::isSupported(node));
     REQ(typesAreSupported(node));
+    if (node->kind() == aten::mm || node->kind() == aten::matmul) {
+      REQ(isFusibleMatmul(node));
+    }
 
     // A hook to optimizations limitter to allow bisecting the pass
     if (!JIT_OPT_ALLOWED) {
@@ -51,8 +51,8 @@ bool MemoryDAG::mayAlias(const Element* a, const Element* b) const {
 }
 
 bool MemoryDAG::mayAliasImpl(const Element* a, const Element* b) const {
-  const auto aMemLoc = getMemoryLocations(a);
-  const auto bMemLoc = getMemoryLocations(b);
+  const auto& aMemLoc = getMemoryLocations(a);
+  const auto& bMemLoc = getMemoryLocations(b);
 
   return aMemLoc.intersects(bMemLoc);
 }
@@ -84,14 +84,22 @@ void MemoryDAG::collectAllContainedMemoryLocations(
   }
 }
 
-bool MemoryDAG::mayContainAliasImpl(const Element* a, const Element* b) const {
-  MemoryLocations all_a_mlocs;
-  MemoryLocations all_b_mlocs;
-
-  collectAllContainedMemoryLocations(a, all_a_mlocs);
-  collectAllContainedMemoryLocations(b, all_b_mlocs);
+const MemoryLocations& MemoryDAG::getAllContainedMemoryLocations(
+    const Element* elem) const {
+  // Only the closure of `elem` itself is memoized: the traversal stops at the
+  // elements it already visited, so the partial sets it goes through aren't
+  // the closures of the other elements.
+  if (!elem->cachedAllContainedMemoryLocations_) {
+    MemoryLocations cont;
+    collectAllContainedMemoryLocations(elem, cont);
+    elem->cachedAllContainedMemoryLocations_ = std::move(cont);
+  }
+  return *elem->cachedAllContainedMemoryLocations_;
+}
 
-  return all_a_mlocs.intersects(all_b_mlocs);
+bool MemoryDAG::mayContainAliasImpl(const Element* a, const Element* b) const {
+  return getAllContainedMemoryLocations(a).intersects(
+      getAllContainedMemoryLocations(b));
 }
 
 bool MemoryDAG::mayContainAlias(
@@ -103,12 +111,12 @@ bool MemoryDAG::mayContainAlias(
 
   MemoryLocations all_a_mlocs;
   for (const auto& elem : a) {
-    collectAllContainedMemoryLocations(elem, all_a_mlocs);
+    all_a_mlocs |= getAllContainedMemoryLocations(elem);
   }
 
   MemoryLocations all_b_mlocs;
   for (const auto& elem : b) {
-    collectAllContainedMemoryLocations(elem, all_b_mlocs);
+    all_b_mlocs |= getAllContainedMemoryLocations(elem);
   }
 
   return all_a_mlocs.intersects(all_b_mlocs);
@@ -209,10 +217,51 @@ void MemoryDAG::setWildcards(
       e->cachedMemoryLocations_->set(wildcardElement->index);
     }
   }
+  invalidateContainedMemoryLocations();
 }
 
 Element* MemoryDAG::unsafeMakeFreshValue(const Value* v) {
   return makeFreshValueImpl(v, indexToElementMap_);
 }
+
+void MemoryDAG::unsafeMakePointerTo(Element* from, Element* to) {
+  makePointerToImpl(from, to);
+
+  // `from` and everything pointing to it may now point to the memory locations
+  // of `to` too.
+  const MemoryLocations added = getMemoryLocations(to);
+  MemoryLocations visited;
+  std::vector<const Element*> worklist = {from};
+  while (!worklist.empty()) {
+    const Element* e = worklist.back();
+    worklist.pop_back();
+    if (visited.test(e->index)) {
+      continue;
+    }
+    visited.set(e->index);
+    if (e->cachedMemoryLocations_) {
+      *e->cachedMemoryLocations_ |= added;
+    }
+    for (const auto pointer : e->pointedFrom) {
+      worklist.push_back(fromIndex(pointer));
+    }
+  }
+  invalidateContainedMemoryLocations();
+}
+
+void MemoryDAG::unsafeAddToContainedElements(
+    Element* contained,
+    Element* container) {
+  TORCH_INTERNAL_ASSERT(
+      contained != container, "Elements cannot contain themselves");
+  container->containedElements.set(contained->index);
+  invalidateContainedMemoryLocations();
+}
+
+void MemoryDAG::invalidateContainedMemoryLocations() {
+  for (const std::unique_ptr<Element>& e : indexToElementMap_) {
+    e->cachedAllContainedMemoryLocations_ = c10::nullopt;
+  }
+}
 } // namespace jit
 } // namespace torch
@@ -94,6 +94,9 @@ class TORCH_API MemoryDAG {
   void collectAllContainedMemoryLocations(
       const Element* elem,
       MemoryLocations& cont) const;
+  // The memory locations of `elem` and of everything it contains, memoized
+  const MemoryLocations& getAllContainedMemoryLocations(
+      const Element* elem) const;
 
   /**
    * The following methods are special cases where we need to reach mutate the
@@ -109,8 +112,15 @@ class TORCH_API MemoryDAG {
       const ska::flat_hash_map<const Value*, Element*>& elementMap,
       const std::function<Element*(const Value*)>& getWildcardElement);
   Element* unsafeMakeFreshValue(const Value* v);
+  // Edit the DAG after it's been built, as AliasDb::addNode does. The memoized
+  // memory locations are extended in place rather than recomputed, as
+  // setWildcards does, so that they stay consistent with the locations already
+  // indexed by AliasDb.
+  void unsafeMakePointerTo(Element* from, Element* to);
+  void unsafeAddToContainedElements(Element* contained, Element* container);
 
  private:
+  void invalidateContainedMemoryLocations();
   bool mayAliasImpl(const Element* a, const Element* b) const;
   bool mayContainAliasImpl(const Element* contained, const Element* container)
       const;
@@ -148,9 +158,12 @@ struct Element {
 
   friend class MemoryDAG;
   // We memoize the results of `getMemoryLocations` to speed up queries.
-  // A nullopt means that this cache is not yet populated. Since `MemoryDAG` is
-  // immutable, this cache should never need to be invalidated.
+  // A nullopt means that this cache is not yet populated. `MemoryDAG` is only
+  // edited by its unsafe methods, which update this cache in place.
   mutable c10::optional<MemoryLocations> cachedMemoryLocations_;
+  // Same for `getAllContainedMemoryLocations`, dropped on every edit of the
+  // DAG since containers aren't tracked from their contained elements.
+  mutable c10::optional<MemoryLocations> cachedAllContainedMemoryLocations_;
 };
 
 } // namespace jit
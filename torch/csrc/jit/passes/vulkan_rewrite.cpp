@@ -173,6 +173,147 @@ void fuseReluWithPackedOps(std::shared_ptr<Graph>& graph) {
   rewriter.runOnGraph(graph, torch::jit::graph_rewrite_helper::isClampFusable);
 }
 
+#ifdef USE_VULKAN_API
+
+// Folds the residual additions of ResNet-like blocks into the convolutions
+// producing them, so that the sum is computed in the epilogue of the
+// convolution shader rather than by a dispatch of its own.  Goes before the
+// clamp fusions, which then apply to the sum, as the shader clamps last.
+void fuseAddWithPackedOps(std::shared_ptr<Graph>& graph) {
+  SubgraphRewriter rewriter;
+
+  std::string conv2d_prepack_run_add_fused = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %dilation:int[], %groups:int, %other, %alpha, %dummy_min_max):
+        %packed_weight_bias : __torch__.torch.classes.vulkan.Conv2dOpContext = vulkan_prepack::conv2d_clamp_prepack(
+            %weight, %bias, %stride, %padding, %dilation, %groups,
+            %dummy_min_max, %dummy_min_max)
+        %r = vulkan_prepack::conv2d_clamp_add_run(%input, %other, %packed_weight_bias)
+        return (%r) )";
+
+  std::string conv2d_prepack_run_add = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %dilation:int[], %groups:int, %other, %alpha, %dummy_min_max):
+        %packed_weight_bias = vulkan_prepack::conv2d_clamp_prepack(
+            %weight, %bias, %stride, %padding, %dilation, %groups,
+            %dummy_min_max, %dummy_min_max)
+        %conv2d_res = vulkan_prepack::conv2d_clamp_run(%input, %packed_weight_bias)
+        %r = aten::add(%conv2d_res, %other, %alpha)
+        return (%r) )";
+
+  rewriter.RegisterRewritePattern(
+      conv2d_prepack_run_add, conv2d_prepack_run_add_fused);
+
+  std::string conv2d_prepack_run_add_swapped = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %dilation:int[], %groups:int, %other, %alpha, %dummy_min_max):
+        %packed_weight_bias = vulkan_prepack::conv2d_clamp_prepack(
+            %weight, %bias, %stride, %padding, %dilation, %groups,
+            %dummy_min_max, %dummy_min_max)
+        %conv2d_res = vulkan_prepack::conv2d_clamp_run(%input, %packed_weight_bias)
+        %r = aten::add(%other, %conv2d_res, %alpha)
+        return (%r) )";
+
+  rewriter.RegisterRewritePattern(
+      conv2d_prepack_run_add_swapped, conv2d_prepack_run_add_fused);
+
+  // Only the in-place addition to the result of the convolution, the other
+  // operand may be used afterwards.
+  std::string conv2d_prepack_run_add_inplace = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %dilation:int[], %groups:int, %other, %alpha, %dummy_min_max):
+        %packed_weight_bias = vulkan_prepack::conv2d_clamp_prepack(
+            %weight, %bias, %stride, %padding, %dilation, %groups,
+            %dummy_min_max, %dummy_min_max)
+        %conv2d_res = vulkan_prepack::conv2d_clamp_run(%input, %packed_weight_bias)
+        %r = aten::add_(%conv2d_res, %other, %alpha)
+        return (%r) )";
+
+  rewriter.RegisterRewritePattern(
+      conv2d_prepack_run_add_inplace, conv2d_prepack_run_add_fused);
+
+  const auto filter = [](const Match& match,
+                         const std::unordered_map<std::string, Value*>& vmap) {
+    // The sizes of the operands are seldom known at this point, the residuals
+    // the shader can't add as is, because they broadcast, are added by a
+    // dispatch of their own at run time.
+    const auto alpha =
+        graph_rewrite_helper::getIValue("alpha", match.values_map, vmap);
+    const auto other = match.values_map.at(vmap.at("other"));
+    return alpha &&
+        ((alpha->isInt() && (1 == alpha->toInt())) ||
+         (alpha->isDouble() && (1.0 == alpha->toDouble()))) &&
+        other->type()->isSubtypeOf(TensorType::get()) &&
+        graph_rewrite_helper::isClampFusable(match, vmap);
+  };
+
+  rewriter.runOnGraph(graph, filter);
+}
+
+void fuseHardtanhWithPackedAddOps(std::shared_ptr<Graph>& graph) {
+  SubgraphRewriter rewriter;
+
+  std::string conv2d_prepack_run_add_hardtanh_fused = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %dilation:int[], %groups:int, %other, %output_min, %output_max, %dummy_min_max):
+        %packed_weight_bias : __torch__.torch.classes.vulkan.Conv2dOpContext = vulkan_prepack::conv2d_clamp_prepack(
+            %weight, %bias, %stride, %padding, %dilation, %groups,
+            %output_min, %output_max)
+        %r = vulkan_prepack::conv2d_clamp_add_run(%input, %other, %packed_weight_bias)
+        return (%r) )";
+
+  for (const auto& hardtanh : {"aten::hardtanh", "aten::hardtanh_"}) {
+    std::string conv2d_prepack_run_add_hardtanh = std::string(R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %dilation:int[], %groups:int, %other, %output_min, %output_max, %dummy_min_max):
+        %packed_weight_bias = vulkan_prepack::conv2d_clamp_prepack(
+            %weight, %bias, %stride, %padding, %dilation, %groups,
+            %dummy_min_max, %dummy_min_max)
+        %add_res = vulkan_prepack::conv2d_clamp_add_run(%input, %other, %packed_weight_bias)
+        %r = )") + hardtanh + R"((%add_res, %output_min, %output_max)
+        return (%r) )";
+
+    rewriter.RegisterRewritePattern(
+        conv2d_prepack_run_add_hardtanh, conv2d_prepack_run_add_hardtanh_fused);
+  }
+
+  rewriter.runOnGraph(graph, torch::jit::graph_rewrite_helper::isClampFusable);
+}
+
+void fuseReluWithPackedAddOps(std::shared_ptr<Graph>& graph) {
+  SubgraphRewriter rewriter;
+
+  std::string conv2d_prepack_run_add_relu_fused = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %dilation:int[], %groups:int, %other, %dummy_min_max):
+        %output_min: float = prim::Constant[value=0.0]()
+        %output_max: None = prim::Constant()
+        %packed_weight_bias : __torch__.torch.classes.vulkan.Conv2dOpContext = vulkan_prepack::conv2d_clamp_prepack(
+            %weight, %bias, %stride, %padding, %dilation, %groups,
+            %output_min, %output_max)
+        %r = vulkan_prepack::conv2d_clamp_add_run(%input, %other, %packed_weight_bias)
+        return (%r) )";
+
+  for (const auto& relu : {"aten::relu", "aten::relu_"}) {
+    std::string conv2d_prepack_run_add_relu = std::string(R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %dilation:int[], %groups:int, %other, %dummy_min_max):
+        %packed_weight_bias = vulkan_prepack::conv2d_clamp_prepack(
+            %weight, %bias, %stride, %padding, %dilation, %groups,
+            %dummy_min_max, %dummy_min_max)
+        %add_res = vulkan_prepack::conv2d_clamp_add_run(%input, %other, %packed_weight_bias)
+        %r = )") + relu + R"((%add_res)
+        return (%r) )";
+
+    rewriter.RegisterRewritePattern(
+        conv2d_prepack_run_add_relu, conv2d_prepack_run_add_relu_fused);
+  }
+
+  rewriter.runOnGraph(graph, torch::jit::graph_rewrite_helper::isClampFusable);
+}
+
+#endif /* USE_VULKAN_API */
+
 } // namespace
 
 void vulkanInsertPrePackedOps(std::shared_ptr<Graph>& graph) {
@@ -192,6 +333,11 @@ void vulkanInsertPrePackedOps(script::Module& module) {
 
 void vulkanFusePrePackedConvWithClamp(script::Module& module) {
   auto graph = module.get_method("forward").graph();
+#ifdef USE_VULKAN_API
+  fuseAddWithPackedOps(graph);
+  fuseReluWithPackedAddOps(graph);
+  fuseHardtanhWithPackedAddOps(graph);
+#endif /* USE_VULKAN_API */
   fuseReluWithPackedOps(graph);
   fuseHardtanhWithPackedOps(graph);
 }
@@ -4,6 +4,7 @@
 #include <torch/csrc/jit/api/module.h>
 #include <torch/csrc/jit/backends/backend_init.h>
 #include <torch/csrc/jit/codegen/cuda/interface.h>
+#include <torch/csrc/jit/codegen/fuser/binary_cache.h>
 #include <torch/csrc/jit/codegen/fuser/interface.h>
 #include <torch/csrc/jit/codegen/fuser/kernel_cache.h>
 #include <torch/csrc/jit/frontend/ir_emitter.h>
@@ -24,7 +25,12 @@
 #include <torch/csrc/jit/passes/freeze_module.h>
 #include <torch/csrc/jit/passes/frozen_conv_folding.h>
 #include <torch/csrc/jit/passes/frozen_graph_optimizations.h>
+#include <torch/csrc/jit/passes/frozen_linear_batching.h>
 #include <torch/csrc/jit/passes/fuse_linear.h>
+#include <torch/csrc/jit/passes/assign_cuda_streams.h>
+#include <torch/csrc/jit/passes/fuse_add_layer_norm.h>
+#include <torch/csrc/jit/passes/fuse_batch_norm_add_relu.h>
+#include <torch/csrc/jit/passes/fuse_conv_batch_norm.h>
 #include <torch/csrc/jit/passes/fuse_relu.h>
 #include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/inline_fork_wait.h>
@@ -32,6 +38,7 @@
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_graph.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
 #include <torch/csrc/jit/passes/metal_rewrite.h>
 #include <torch/csrc/jit/passes/normalize_ops.h>
 #include <torch/csrc/jit/passes/onnx.h>
@@ -62,8 +69,11 @@
 #include <torch/csrc/jit/passes/remove_inplace_ops.h>
 #include <torch/csrc/jit/passes/remove_mutation.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
+#include <torch/csrc/jit/passes/symbolic_shape_analysis.h>
+#include <torch/csrc/jit/passes/share_frozen_constants.h>
 #include <torch/csrc/jit/passes/specialize_autogradzero.h>
 #include <torch/csrc/jit/passes/subgraph_rewrite.h>
+#include <torch/csrc/jit/passes/substitute_inplace_ops.h>
 #include <torch/csrc/jit/passes/tensorexpr_fuser.h>
 #include <torch/csrc/jit/passes/utils/check_alias_annotation.h>
 #include <torch/csrc/jit/passes/vulkan_rewrite.h>
@@ -77,6 +87,8 @@
 #include <torch/csrc/jit/python/script_init.h>
 #include <torch/csrc/jit/runtime/argument_spec.h>
 #include <torch/csrc/jit/runtime/autodiff.h>
+#include <torch/csrc/jit/runtime/cuda_graph_capture.h>
+#include <torch/csrc/jit/runtime/cuda_streams.h>
 #include <torch/csrc/jit/runtime/graph_executor.h>
 #include <torch/csrc/jit/runtime/jit_exception.h>
 #include <torch/csrc/jit/runtime/operator.h>
@@ -143,6 +155,26 @@ void initJITBindings(PyObject* module) {
       .def(
           "_jit_debug_fuser_num_cached_kernel_specs",
           torch::jit::fuser::debugNumCachedKernelSpecs)
+      .def(
+          "_jit_fuser_get_kernel_cache_dir",
+          []() { return torch::jit::fuser::getKernelBinaryCacheDir(); })
+      .def(
+          "_jit_fuser_set_kernel_cache_dir",
+          [](const std::string& dir) {
+            torch::jit::fuser::getKernelBinaryCacheDir() = dir;
+          })
+      .def(
+          "_jit_fuser_get_tune_launch_configs",
+          []() { return torch::jit::fuser::getTuneLaunchConfigs(); })
+      .def(
+          "_jit_fuser_set_tune_launch_configs",
+          [](bool tune) { torch::jit::fuser::getTuneLaunchConfigs() = tune; })
+      .def(
+          "_jit_fuser_preload_kernel_cache",
+          torch::jit::fuser::preloadKernelBinaries)
+      .def(
+          "_jit_fuser_write_kernel_cache_manifest",
+          torch::jit::fuser::writeKernelBinaryManifest)
       .def("_jit_pass_onnx_remove_print", RemovePrintOps)
       .def("_jit_pass_onnx_preprocess_caffe2", PreprocessCaffe2Ops)
       .def("_jit_pass_onnx", ToONNX)
@@ -249,6 +281,11 @@ void initJITBindings(PyObject* module) {
           [](std::shared_ptr<Graph>& g) {
             return FuseQuantizedAddRelu(g); // overload resolution
           })
+      .def(
+          "_jit_pass_fuse_quantized_residual_add",
+          [](std::shared_ptr<Graph>& g) {
+            return FuseQuantizedResidualAdd(g); // overload resolution
+          })
       .def(
           "_jit_pass_insert_observers",
           [](Module& module,
@@ -313,11 +350,21 @@ void initJITBindings(PyObject* module) {
       .def("_jit_pass_fold_frozen_conv_bn", &FoldFrozenConvBatchnorm)
       .def("_jit_pass_fold_frozen_conv_add_or_sub", &FoldFrozenConvAddOrSub)
       .def("_jit_pass_fold_frozen_conv_mul_or_div", &FoldFrozenConvMulOrDiv)
+      .def("_jit_pass_concat_frozen_linear", &FrozenConcatLinear)
+      .def("_jit_pass_batch_frozen_linear", &FrozenBatchLinear)
       .def("_jit_pass_optimize_frozen_graph", &OptimizeFrozenGraph)
       .def("_jit_pass_fuse_linear", &FuseLinear)
       .def(
           "_jit_pass_fuse_add_relu",
           [](std::shared_ptr<Graph>& graph) { FuseAddRelu(graph); })
+      .def("_jit_pass_fuse_add_layer_norm", &FuseAddLayerNorm)
+      .def("_jit_pass_fuse_batch_norm_add_relu", &FuseBatchNormAddRelu)
+      .def("_jit_pass_fuse_conv_batch_norm", &FuseConvBatchNorm)
+      .def(
+          "_jit_pass_assign_cuda_streams",
+          [](std::shared_ptr<Graph>& g, size_t num_streams) {
+            AssignCudaStreams(g, num_streams);
+          })
       .def("_jit_pass_dedup_module_uses", &DedupModuleUses)
       .def("_jit_pass_replicate_dequantize", &ReplicateDeQuant)
       .def(
@@ -371,6 +418,11 @@ void initJITBindings(PyObject* module) {
             RemoveListMutation(g);
             return RemoveTensorMutation(g);
           })
+      .def(
+          "_jit_pass_substitute_inplace_ops",
+          [](const std::shared_ptr<Graph>& g) {
+            return SubstituteInplaceOps(g);
+          })
       .def(
           "_jit_pass_inline_functional_graphs",
           [](std::shared_ptr<Graph>& g) { return InlineFunctionalGraphs(g); })
@@ -412,6 +464,27 @@ void initJITBindings(PyObject* module) {
             }
             PropagateInputShapes(graph);
           })
+      .def(
+          "_jit_pass_propagate_symbolic_shapes",
+          [](const std::shared_ptr<Graph>& graph) {
+            PropagateSymbolicShapes(graph);
+          })
+      .def(
+          "_jit_pass_plan_memory",
+          [](const std::shared_ptr<Graph>& graph) {
+            auto plan = PlanMemory(graph);
+            py::list allocations;
+            for (const auto& allocation : plan.allocations) {
+              allocations.append(py::make_tuple(
+                  allocation.value->debugName(),
+                  allocation.size,
+                  allocation.offset,
+                  allocation.begin,
+                  allocation.end));
+            }
+            return py::make_tuple(
+                allocations, plan.arena_size, plan.peak_live_bytes);
+          })
       .def(
           "_jit_interpret_graph",
           [](std::shared_ptr<Graph>& graph, const py::tuple& inputs) {
@@ -498,6 +571,8 @@ void initJITBindings(PyObject* module) {
       .def("_jit_override_can_fuse_on_gpu", &overrideCanFuseOnGPU)
       .def("_jit_can_fuse_on_cpu", &canFuseOnCPU)
       .def("_jit_can_fuse_on_gpu", &canFuseOnGPU)
+      .def("_jit_set_cpu_fuser_uses_llvm", &overrideCPUFuserUsesLLVM)
+      .def("_jit_cpu_fuser_uses_llvm", &cpuFuserUsesLLVM)
       .def(
           "_jit_differentiate",
           [](Graph& g) {
@@ -552,6 +627,58 @@ void initJITBindings(PyObject* module) {
             size_t num_runs = getNumProfiledRuns();
             return num_runs;
           })
+      .def(
+          "_jit_set_cuda_graph_capture_mode",
+          [](bool enabled) {
+            bool old_enabled = getCudaGraphCaptureMode();
+            getCudaGraphCaptureMode() = enabled;
+            return old_enabled;
+          })
+      .def(
+          "_jit_set_cuda_graph_warmup_runs",
+          [](size_t num) {
+            size_t old_num = getCudaGraphWarmupRuns();
+            getCudaGraphWarmupRuns() = num;
+            return old_num;
+          })
+      .def(
+          "_jit_set_num_cuda_streams",
+          [](size_t num) {
+            size_t old_num = getNumCudaStreams();
+            getNumCudaStreams() = num;
+            return old_num;
+          })
+      .def(
+          "_jit_set_lazy_method_compilation",
+          [](bool enabled) {
+            bool old_value = getLazyMethodCompilation();
+            getLazyMethodCompilation() = enabled;
+            return old_value;
+          })
+      .def(
+          "_jit_set_prefetch_tensor_records",
+          [](bool enabled) {
+            bool old_value = getPrefetchTensorRecords();
+            getPrefetchTensorRecords() = enabled;
+            return old_value;
+          })
+      .def(
+          "_jit_get_prefetch_tensor_records",
+          []() { return getPrefetchTensorRecords().load(); })
+      .def(
+          "_jit_set_share_frozen_constants",
+          [](bool enabled) {
+            bool old_value = getShareFrozenConstants();
+            getShareFrozenConstants() = enabled;
+            return old_value;
+          })
+      .def(
+          "_jit_set_share_frozen_constants_across_processes",
+          [](bool enabled) {
+            bool old_value = getShareFrozenConstantsAcrossProcesses();
+            getShareFrozenConstantsAcrossProcesses() = enabled;
+            return old_value;
+          })
       .def(
           "_jit_set_bailout_depth",
           [](size_t depth) {
@@ -559,6 +686,24 @@ void initJITBindings(PyObject* module) {
             getBailoutDepth() = depth;
             return old_depth;
           })
+      .def(
+          "_jit_set_profiling_plan_cache_size",
+          [](size_t size) {
+            size_t old_size = getProfilingPlanCacheSize();
+            getProfilingPlanCacheSize() = size;
+            return old_size;
+          })
+      .def(
+          "_jit_get_profiling_plan_cache_stats",
+          []() {
+            const auto& stats = getProfilingPlanCacheStats();
+            py::dict result;
+            result["hits"] = stats.hits.load();
+            result["misses"] = stats.misses.load();
+            result["evictions"] = stats.evictions.load();
+            result["bailouts"] = stats.bailouts.load();
+            return result;
+          })
       .def(
           "_jit_set_inline_everything_mode",
           [](bool enabled) { getInlineEverythingMode() = enabled; })
@@ -854,6 +999,8 @@ void initJITBindings(PyObject* module) {
       .def(py::init<std::string>())
       .def(py::init([](const py::object& buffer) {
         auto writer_func = [=](const void* data, size_t size) {
+          // write_record releases the GIL
+          py::gil_scoped_acquire acquire;
           auto bytes = py::bytes(reinterpret_cast<const char*>(data), size);
           buffer.attr("write")(std::move(bytes));
           return size;
@@ -866,17 +1013,34 @@ void initJITBindings(PyObject* module) {
           [](PyTorchStreamWriter& self,
              const std::string& name,
              const char* data,
-             size_t size) { return self.writeRecord(name, data, size); })
-      .def("write_end_of_file", &PyTorchStreamWriter::writeEndOfFile)
+             size_t size) { return self.writeRecord(name, data, size); },
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "write_end_of_file",
+          &PyTorchStreamWriter::writeEndOfFile,
+          py::call_guard<py::gil_scoped_release>())
       .def(
           "write_record",
           [](PyTorchStreamWriter& self,
              const std::string& name,
              uintptr_t data,
-             size_t size) {
+             size_t size,
+             bool compress,
+             size_t element_size) {
             return self.writeRecord(
-                name, reinterpret_cast<const char*>(data), size);
-          });
+                name,
+                reinterpret_cast<const char*>(data),
+                size,
+                compress,
+                element_size);
+          },
+          py::arg("name"),
+          py::arg("data"),
+          py::arg("size"),
+          py::arg("compress") = false,
+          py::arg("element_size") = 1,
+          py::call_guard<py::gil_scoped_release>())
+      .def("set_compression_level", &PyTorchStreamWriter::setCompressionLevel);
 
   py::enum_<MobileOptimizerType>(m, "MobileOptimizerType")
       .value("CONV_BN_FUSION", MobileOptimizerType::CONV_BN_FUSION)
@@ -990,6 +1154,11 @@ void initJITBindings(PyObject* module) {
                     at::CPU(scalar_type).typeMeta());
             return at::Tensor(std::move(ptr));
           })
+      .def(
+          "prefetch_records",
+          [](PyTorchStreamReader& self, const std::vector<std::string>& keys) {
+            self.prefetchRecords(keys);
+          })
       .def("get_all_records", [](PyTorchStreamReader& self) {
         return self.getAllRecords();
       });
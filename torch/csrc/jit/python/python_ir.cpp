@@ -253,7 +253,6 @@ void initPythonIRBindings(PyObject* module_) {
                 add_node_names,
                 use_external_data_format,
                 onnx_file_path);
-            graph = serialize_model_proto_to_string(model_proto);
             std::unordered_map<std::string, py::bytes>
                 python_serialized_export_map;
             for (auto& kv : export_map) {
@@ -266,6 +265,9 @@ void initPythonIRBindings(PyObject* module_) {
                   py::bytes(static_cast<const char*>(t.data_ptr()), copy_bytes);
             }
             graph = serialize_model_proto_to_string(model_proto);
+            // Only one serialized copy of the model needs to be alive when
+            // it's handed over to Python
+            model_proto.reset();
             return std::make_tuple(
                 py::bytes(graph), python_serialized_export_map);
           },
@@ -0,0 +1,333 @@
+#include <torch/csrc/jit/runtime/cuda_graph_capture.h>
+
+#include <ATen/core/grad_mode.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/runtime/graph_executor.h>
+#include <torch/csrc/jit/runtime/interpreter.h>
+
+namespace torch {
+namespace jit {
+
+constexpr size_t kDefaultCudaGraphWarmupRuns = 3;
+
+static std::atomic<bool> cuda_graph_capture_mode{false};
+static std::atomic<size_t> cuda_graph_warmup_runs{kDefaultCudaGraphWarmupRuns};
+static std::atomic<CapturedCudaGraphFactory> captured_cuda_graph_factory{
+    nullptr};
+
+std::atomic<bool>& getCudaGraphCaptureMode() {
+  return cuda_graph_capture_mode;
+}
+
+std::atomic<size_t>& getCudaGraphWarmupRuns() {
+  return cuda_graph_warmup_runs;
+}
+
+void registerCapturedCudaGraphFactory(CapturedCudaGraphFactory factory) {
+  captured_cuda_graph_factory = factory;
+}
+
+namespace {
+
+// Ops whose effects happen on the host, which a replay would not repeat.
+bool isCapturableBlock(Block* block) {
+  for (Node* n : block->nodes()) {
+    switch (n->kind()) {
+      case prim::PythonOp:
+      case prim::IgnoredPythonOp:
+      case prim::Print:
+      case prim::SetAttr:
+      case aten::warn:
+      case aten::save:
+      case aten::manual_seed:
+      case prim::AddStatValue:
+      case prim::TimePoint:
+      case prim::fork:
+      case prim::rpc_async:
+      case prim::rpc_sync:
+      case prim::rpc_remote:
+      case aten::wait:
+#ifndef __HIP_PLATFORM_HCC__
+      case cuda::set_stream:
+      case cuda::_set_device:
+      case cuda::_current_device:
+#endif
+      case cuda::_streams_begin:
+      case prim::Enter:
+      case prim::Exit:
+        GRAPH_DEBUG("Not capturing a CUDA graph of ", *n);
+        return false;
+      default:
+        break;
+    }
+    for (Block* b : n->blocks()) {
+      if (!isCapturableBlock(b)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Collects the geometry of the CUDA tensor inputs, which all have to be on
+// one device. Returns false if an input can't be replayed.
+bool replayableInputs(
+    at::ArrayRef<IValue> inputs,
+    c10::optional<c10::DeviceIndex>& device,
+    std::vector<int64_t>& geometry) {
+  for (const IValue& input : inputs) {
+    if (input.isTensor()) {
+      const at::Tensor& t = input.toTensor();
+      if (!t.defined() || !t.is_cuda() ||
+          (device && *device != t.get_device())) {
+        return false;
+      }
+      device = t.get_device();
+      geometry.push_back(t.dim());
+      geometry.insert(geometry.end(), t.sizes().begin(), t.sizes().end());
+      geometry.insert(geometry.end(), t.strides().begin(), t.strides().end());
+    } else if (
+        !input.isNone() && !input.isInt() && !input.isDouble() &&
+        !input.isBool() && !input.isString() && !input.isObject()) {
+      return false;
+    }
+  }
+  return device.has_value();
+}
+
+// Only CUDA tensors are computed by a replay, and the outputs must not share
+// mutable containers across calls.
+bool isReplayableOutput(const IValue& output) {
+  if (output.isTensor()) {
+    return !output.toTensor().defined() || output.toTensor().is_cuda();
+  }
+  if (output.isTuple()) {
+    for (const IValue& element : output.toTuple()->elements()) {
+      if (!isReplayableOutput(element)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (output.isTensorList()) {
+    for (const at::Tensor& t : output.toTensorVector()) {
+      if (!t.is_cuda()) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return output.isNone() || output.isInt() || output.isDouble() ||
+      output.isBool() || output.isString();
+}
+
+// Copies the tensors of a static output, which the next replay overwrites.
+IValue copyOutput(const IValue& output) {
+  if (output.isTensor()) {
+    const at::Tensor& t = output.toTensor();
+    return t.defined() ? IValue(t.clone()) : output;
+  }
+  if (output.isTuple()) {
+    std::vector<IValue> elements;
+    for (const IValue& element : output.toTuple()->elements()) {
+      elements.push_back(copyOutput(element));
+    }
+    return c10::ivalue::Tuple::create(std::move(elements));
+  }
+  if (output.isTensorList()) {
+    c10::List<at::Tensor> tensors;
+    for (const at::Tensor& t : output.toTensorVector()) {
+      tensors.push_back(t.clone());
+    }
+    return tensors;
+  }
+  return output;
+}
+
+bool sameNonTensorInput(const IValue& a, const IValue& b) {
+  if (a.isObject() || b.isObject()) {
+    return a.isSameIdentity(b);
+  }
+  return a == b;
+}
+
+} // namespace
+
+struct CudaGraphCache::Entry {
+  // geometry of the tensor inputs and values of the other inputs of the last
+  // calls, with None in the place of the tensors
+  std::vector<int64_t> geometry;
+  std::vector<IValue> non_tensor_inputs;
+  // number of calls in a row with these inputs
+  size_t hits = 0;
+  bool capture_failed = false;
+
+  // the graph captured for the inputs, over the static inputs and outputs
+  std::unique_ptr<CapturedCudaGraph> graph;
+  std::vector<at::Tensor> static_inputs;
+  Stack static_outputs;
+
+  bool matches(at::ArrayRef<IValue> inputs, const std::vector<int64_t>& g)
+      const {
+    if (geometry != g) {
+      return false;
+    }
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      if (!inputs[i].isTensor() &&
+          !sameNonTensorInput(inputs[i], non_tensor_inputs[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void reset(at::ArrayRef<IValue> inputs, std::vector<int64_t> g) {
+    geometry = std::move(g);
+    non_tensor_inputs.clear();
+    for (const IValue& input : inputs) {
+      non_tensor_inputs.push_back(input.isTensor() ? IValue() : input);
+    }
+    hits = 0;
+    static_outputs.clear();
+    static_inputs.clear();
+    graph.reset();
+  }
+};
+
+CudaGraphCache::CudaGraphCache(Graph& graph, size_t num_inputs)
+    : arg_spec_creator_(graph), num_inputs_(num_inputs) {}
+
+CudaGraphCache::~CudaGraphCache() = default;
+
+bool CudaGraphCache::isCapturable(const ExecutionPlan& plan) {
+  auto it = plan_is_capturable_.find(&plan);
+  if (it == plan_is_capturable_.end()) {
+    it = plan_is_capturable_
+             .emplace(&plan, isCapturableBlock(plan.graph->block()))
+             .first;
+  }
+  return it->second;
+}
+
+bool CudaGraphCache::capture(
+    const ExecutionPlan& plan,
+    Entry& entry,
+    c10::DeviceIndex device,
+    at::ArrayRef<IValue> inputs) {
+  CapturedCudaGraphFactory factory = captured_cuda_graph_factory;
+  if (factory == nullptr) {
+    return false;
+  }
+
+  Stack stack;
+  for (const IValue& input : inputs) {
+    if (input.isTensor()) {
+      entry.static_inputs.push_back(input.toTensor().clone());
+      stack.emplace_back(entry.static_inputs.back());
+    } else {
+      entry.static_inputs.emplace_back();
+      stack.push_back(input);
+    }
+  }
+
+  std::unique_ptr<CapturedCudaGraph> graph;
+  try {
+    graph = factory(device);
+    graph->captureBegin();
+  } catch (const std::exception& e) {
+    GRAPH_DEBUG("Failed to begin CUDA graph capture: ", e.what());
+    return false;
+  }
+  // Nothing ran during the capture, so a plan that failed for an input
+  // related reason fails again when the caller runs it.
+  try {
+    InterpreterState(plan.code).run(stack);
+  } catch (const std::exception& e) {
+    GRAPH_DEBUG("Failed to capture CUDA graph: ", e.what());
+    try {
+      graph->captureEnd();
+    } catch (const std::exception&) {
+    }
+    return false;
+  }
+  try {
+    graph->captureEnd();
+  } catch (const std::exception& e) {
+    GRAPH_DEBUG("Failed to capture CUDA graph: ", e.what());
+    return false;
+  }
+  for (const IValue& output : stack) {
+    if (!isReplayableOutput(output)) {
+      GRAPH_DEBUG("Not replaying a CUDA graph with output ", output.tagKind());
+      return false;
+    }
+  }
+  entry.static_outputs = std::move(stack);
+  entry.graph = std::move(graph);
+  return true;
+}
+
+bool CudaGraphCache::run(const ExecutionPlan& plan, Stack& stack) {
+  // The static buffers are used by one call at a time; concurrent calls run
+  // eagerly instead of waiting.
+  std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+  if (!lock.owns_lock() || !isCapturable(plan)) {
+    return false;
+  }
+
+  const auto inputs = last(stack, num_inputs_);
+  c10::optional<c10::DeviceIndex> device;
+  std::vector<int64_t> geometry;
+  if (!replayableInputs(inputs, device, geometry)) {
+    return false;
+  }
+  const bool with_grad = at::GradMode::is_enabled();
+  ArgumentSpec spec = arg_spec_creator_.create(with_grad, stack);
+  for (size_t i = 0; i < spec.numTensors(); ++i) {
+    if (spec.tensorAt(i).requires_grad()) {
+      return false;
+    }
+  }
+
+  std::unique_ptr<Entry>& entry = entries_[spec];
+  if (!entry) {
+    entry.reset(new Entry());
+  }
+  if (entry->capture_failed) {
+    return false;
+  }
+  if (!entry->matches(inputs, geometry)) {
+    // Shapes changed, the graph of the old shapes is given up.
+    entry->reset(inputs, std::move(geometry));
+  }
+
+  if (entry->graph) {
+    entry->graph->waitLastReplay();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      if (inputs[i].isTensor()) {
+        entry->static_inputs[i].copy_(inputs[i].toTensor());
+      }
+    }
+  } else {
+    if (++entry->hits <= getCudaGraphWarmupRuns()) {
+      return false;
+    }
+    if (!capture(plan, *entry, *device, inputs)) {
+      entry->reset(inputs, entry->geometry);
+      entry->capture_failed = true;
+      return false;
+    }
+    entry->graph->waitLastReplay();
+  }
+
+  entry->graph->replay();
+  drop(stack, num_inputs_);
+  for (const IValue& output : entry->static_outputs) {
+    stack.push_back(copyOutput(output));
+  }
+  entry->graph->recordReplayDone();
+  return true;
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <ATen/core/stack.h>
+#include <c10/core/Device.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/runtime/argument_spec.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+struct ExecutionPlan;
+
+// Opt-in mode of the graph executors for launch bound CUDA workloads. Once a
+// top-level call has seen the same ArgumentSpec, input shapes and non-tensor
+// inputs getCudaGraphWarmupRuns() times in a row with a stable plan, the plan
+// is captured into a CUDA graph over static copies of the tensor inputs, and
+// later calls with matching inputs copy their inputs in and replay the graph
+// instead of running the interpreter. Calls with other inputs, with inputs that
+// require grad, or to plans that can't be captured run eagerly as before.
+//
+// The captured plan must only depend on its inputs through the CUDA tensors,
+// which is the case for the plans without the side effecting ops rejected by
+// CudaGraphCache. Tensor attributes of module inputs are captured by address,
+// so they may be updated in place but must not be reassigned.
+TORCH_API std::atomic<bool>& getCudaGraphCaptureMode();
+
+// number of eager calls with the same inputs before their plan is captured
+TORCH_API std::atomic<size_t>& getCudaGraphWarmupRuns();
+
+// A CUDA graph of the work launched on one device between captureBegin and
+// captureEnd. It is implemented over at::cuda::CUDAGraph by
+// register_cuda_graph_capture.cpp in libtorch_cuda, since libtorch itself does
+// not depend on CUDA.
+struct TORCH_API CapturedCudaGraph {
+  virtual ~CapturedCudaGraph() = default;
+  // Switches to a side stream that waits for the current stream of the device
+  // and begins capturing it.
+  virtual void captureBegin() = 0;
+  // Ends capture and switches back to the stream of captureBegin. Throws if
+  // the capture failed, e.g. because an op synchronized with the device.
+  virtual void captureEnd() = 0;
+  // Makes the current stream wait for the work that read the outputs of the
+  // last replay, so that the static inputs and outputs may be overwritten.
+  virtual void waitLastReplay() = 0;
+  // Replays the graph on the current stream.
+  virtual void replay() = 0;
+  // Marks the end of the work on the current stream that reads the outputs
+  // of this replay.
+  virtual void recordReplayDone() = 0;
+};
+
+using CapturedCudaGraphFactory =
+    std::unique_ptr<CapturedCudaGraph> (*)(c10::DeviceIndex device);
+
+TORCH_API void registerCapturedCudaGraphFactory(
+    CapturedCudaGraphFactory factory);
+
+// The CUDA graphs captured for the plans of a graph executor, by ArgumentSpec.
+// An ArgumentSpec holds the graph of the last input shapes it was captured
+// for, and is recaptured once other shapes become stable.
+struct TORCH_API CudaGraphCache {
+  CudaGraphCache(Graph& graph, size_t num_inputs);
+  ~CudaGraphCache();
+
+  // Replaces the inputs at the end of stack with the outputs of plan, by
+  // replaying the graph captured for the inputs, capturing it first if the
+  // inputs are stable. Returns false, leaving stack alone, if the caller has
+  // to run plan itself.
+  bool run(const ExecutionPlan& plan, Stack& stack);
+
+ private:
+  struct Entry;
+
+  bool isCapturable(const ExecutionPlan& plan);
+  bool capture(
+      const ExecutionPlan& plan,
+      Entry& entry,
+      c10::DeviceIndex device,
+      at::ArrayRef<IValue> inputs);
+
+  ArgumentSpecCreator arg_spec_creator_;
+  const size_t num_inputs_;
+
+  // Held while capturing or replaying, the static inputs and outputs of an
+  // entry are used by one call at a time.
+  std::mutex mutex_;
+  std::unordered_map<const ExecutionPlan*, bool> plan_is_capturable_;
+  std::unordered_map<ArgumentSpec, std::unique_ptr<Entry>> entries_;
+};
+
+} // namespace jit
+} // namespace torch
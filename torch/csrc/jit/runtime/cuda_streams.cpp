@@ -0,0 +1,113 @@
+#include <torch/csrc/jit/runtime/cuda_streams.h>
+
+#include <c10/core/Event.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
+#include <torch/csrc/jit/runtime/custom_operator.h>
+#include <torch/csrc/jit/runtime/operator.h>
+
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+static std::atomic<size_t> num_cuda_streams{1};
+
+std::atomic<size_t>& getNumCudaStreams() {
+  return num_cuda_streams;
+}
+
+namespace {
+
+// The streams of the graphs running on several streams on this thread, by
+// the slots AssignCudaStreams numbers them with. Slot 0 is the stream that
+// was current when the graph started.
+thread_local std::vector<std::vector<c10::Stream>> running_streams;
+
+// The ops are device generic so that libtorch, which does not depend on
+// CUDA, can run them.
+const c10::impl::VirtualGuardImpl& cudaGuardImpl() {
+  static const c10::impl::VirtualGuardImpl impl(c10::DeviceType::CUDA);
+  return impl;
+}
+
+const c10::Stream& streamOf(int64_t slot) {
+  TORCH_INTERNAL_ASSERT(!running_streams.empty());
+  return running_streams.back().at(slot);
+}
+
+c10::AliasAnalysisKind aliasAnalysisConservative() {
+  return c10::AliasAnalysisKind::CONSERVATIVE;
+}
+
+RegisterOperators const reg({
+    Operator(
+        "cuda::_streams_begin(int num_streams) -> ()",
+        [](Stack* stack) {
+          const int64_t num_streams = pop(stack).toInt();
+          const auto& impl = cudaGuardImpl();
+          const c10::Device device = impl.getDevice();
+          std::vector<c10::Stream> streams{impl.getStream(device)};
+          for (int64_t i = 1; i < num_streams; i++) {
+            streams.push_back(impl.getStreamFromPool(device));
+          }
+          running_streams.push_back(std::move(streams));
+        },
+        aliasAnalysisConservative()),
+    Operator(
+        "cuda::_stream_use(int slot) -> ()",
+        [](Stack* stack) {
+          const int64_t slot = pop(stack).toInt();
+          cudaGuardImpl().exchangeStream(streamOf(slot));
+        },
+        aliasAnalysisConservative()),
+    Operator(
+        // Makes the consumer stream wait for the work launched so far on the
+        // producer stream
+        "cuda::_stream_wait(int producer, int consumer) -> ()",
+        [](Stack* stack) {
+          const int64_t consumer = pop(stack).toInt();
+          const int64_t producer = pop(stack).toInt();
+          c10::Event event(c10::DeviceType::CUDA);
+          event.record(streamOf(producer));
+          event.block(streamOf(consumer));
+        },
+        aliasAnalysisConservative()),
+    Operator(
+        // Keeps the caching allocator from reusing the memory of tensors
+        // allocated on another stream before the work of the consumer stream
+        // on them is done
+        "cuda::_stream_record(Tensor[] values, int consumer) -> ()",
+        [](Stack* stack) {
+          const int64_t consumer = pop(stack).toInt();
+          const auto values = pop(stack).toTensorList();
+          const auto& impl = cudaGuardImpl();
+          for (const at::Tensor& value : values) {
+            if (value.defined() && value.is_cuda() && value.has_storage()) {
+              impl.recordDataPtrOnStream(
+                  value.storage().data_ptr(), streamOf(consumer));
+            }
+          }
+        },
+        aliasAnalysisConservative()),
+    Operator(
+        "cuda::_streams_end() -> ()",
+        [](Stack* stack) {
+          cudaGuardImpl().exchangeStream(streamOf(0));
+          running_streams.pop_back();
+        },
+        aliasAnalysisConservative()),
+});
+
+} // namespace
+
+CudaStreamsGuard::CudaStreamsGuard() : depth_(running_streams.size()) {}
+
+CudaStreamsGuard::~CudaStreamsGuard() {
+  while (running_streams.size() > depth_) {
+    cudaGuardImpl().exchangeStream(running_streams.back().at(0));
+    running_streams.pop_back();
+  }
+}
+
+} // namespace jit
+} // namespace torch
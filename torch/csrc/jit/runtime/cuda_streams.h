@@ -0,0 +1,30 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <atomic>
+#include <cstddef>
+
+namespace torch {
+namespace jit {
+
+// Opt-in mode of the profiling executor for graphs of small independent CUDA
+// kernels. When more than one stream is allowed, AssignCudaStreams spreads
+// the branches of the optimized graphs without data dependencies between
+// each other over that many streams: the stream current at the start of the
+// graph and streams of the CUDA stream pool.
+TORCH_API std::atomic<size_t>& getNumCudaStreams();
+
+// Restores the streams of the graphs that were running on several streams
+// when an exception leaves them, which would otherwise leave a pool stream
+// current. Held by the top-level runs of the graph executors.
+struct TORCH_API CudaStreamsGuard {
+  CudaStreamsGuard();
+  ~CudaStreamsGuard();
+
+ private:
+  size_t depth_;
+};
+
+} // namespace jit
+} // namespace torch
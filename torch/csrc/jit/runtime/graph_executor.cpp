@@ -517,6 +517,23 @@ void GraphExecutorImplBase::run(Stack& stack) {
 
   const ExecutionPlan& plan =
       getPlanFor(stack, GraphExecutor::getDefaultNumBailOuts());
+  CudaStreamsGuard streams_guard;
+  if (getCudaGraphCaptureMode()) {
+    CudaGraphCache* cuda_graphs = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(compile_mutex);
+      if (isStablePlan(plan)) {
+        if (!cuda_graphs_) {
+          cuda_graphs_.reset(new CudaGraphCache(*graph, num_inputs));
+        }
+        cuda_graphs = cuda_graphs_.get();
+      }
+    }
+    if (cuda_graphs && cuda_graphs->run(plan, stack)) {
+      last_executed_optimized_graph = plan.graph;
+      return;
+    }
+  }
   InterpreterState(plan.code).run(stack);
   last_executed_optimized_graph = plan.graph;
 }
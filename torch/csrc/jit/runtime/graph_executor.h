@@ -107,6 +107,28 @@ TORCH_API std::atomic<bool>& getProfilingMode();
 TORCH_API std::atomic<bool>& getExecutorMode();
 TORCH_API std::atomic<size_t>& getNumProfiledRuns();
 TORCH_API std::atomic<size_t>& getBailoutDepth();
+
+// Number of optimized plans a profiling executor keeps per function, by the
+// shape class of its inputs: the dtypes, devices, ranks and contiguity of the
+// tensor inputs, and for every dim whether it is 0, 1 or divisible by 8 and
+// which earlier dim of the inputs it equals. The inputs of a new class are
+// profiled and optimized on their own, and the least recently used plan is
+// evicted once the cache is full. 0 disables the cache, so that a single plan
+// handles all inputs through its bailouts.
+TORCH_API std::atomic<size_t>& getProfilingPlanCacheSize();
+
+struct ProfilingPlanCacheStats {
+  // calls that found an optimized plan for their shape class
+  std::atomic<size_t> hits{0};
+  // calls with a new shape class, which start profiling it
+  std::atomic<size_t> misses{0};
+  std::atomic<size_t> evictions{0};
+  // bailouts of guarded plans to their unoptimized remainder, with or
+  // without the cache
+  std::atomic<size_t> bailouts{0};
+};
+
+TORCH_API ProfilingPlanCacheStats& getProfilingPlanCacheStats();
 TORCH_API bool IsNewExecutorEnabled();
 
 struct TORCH_API GraphOptimizerEnabledGuard {
@@ -9,6 +9,8 @@
 #include <torch/csrc/jit/resource_guard.h>
 #include <torch/csrc/jit/runtime/argument_spec.h>
 #include <torch/csrc/jit/runtime/autodiff.h>
+#include <torch/csrc/jit/runtime/cuda_graph_capture.h>
+#include <torch/csrc/jit/runtime/cuda_streams.h>
 #include <torch/csrc/jit/runtime/custom_operator.h>
 #include <torch/csrc/jit/runtime/interpreter.h>
 #include <torch/csrc/jit/runtime/profiling_record.h>
@@ -85,6 +87,13 @@ struct GraphExecutorImplBase {
  protected:
   friend struct GraphExecutor;
 
+  // Whether plan is final for the inputs it was returned for, so that it may
+  // be captured into a CUDA graph, see cuda_graph_capture.h. Called with
+  // compile_mutex held.
+  virtual bool isStablePlan(const ExecutionPlan& plan) {
+    return true;
+  }
+
   // The unoptimized starting graph. This field is effectively const, but we
   // can't make it so because Graph::copy() is not const (and making it const is
   // not that easy at this point).
@@ -99,6 +108,10 @@ struct GraphExecutorImplBase {
   // GraphExecutors can be accessed from multiple threads, so this thread needs
   // to be held every time we access the fallback or plan_cache.
   std::mutex compile_mutex;
+
+  // CUDA graphs of the plans, created by the first run in CUDA graph capture
+  // mode with compile_mutex held
+  std::unique_ptr<CudaGraphCache> cuda_graphs_;
 };
 
 } // namespace jit
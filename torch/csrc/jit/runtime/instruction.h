@@ -54,7 +54,12 @@ namespace jit {
   _(FORK, "CN") /* launch a thread to run code entry x with N inputs  */       \
   _(WARN, "I") /* emit a warning with line information */                      \
   _(ENTER, "EN") /* enter scope of a contextmanager */                         \
-  _(EXIT, "EX") /* exit the last entered contextmanager */
+  _(EXIT, "EX") /* exit the last entered contextmanager */                     \
+  _(TUPLE_INDEX, "") /* pop index and tuple, push tuple[index] */              \
+  _(IS, "") /* pop 2 values, push whether they are the same object */          \
+  _(IS_NOT, "") /* pop 2 values, push whether they are different objects */    \
+  _(LOAD_OP, "R") /* mobile only: LOAD X, then the OP that follows */          \
+  _(MOVE_RET, "R") /* mobile only: MOVE X, then the RET that follows */
 
 enum OpCode : uint8_t {
 #define DEFINE_OP(op, _) op,
@@ -489,15 +489,20 @@ struct CodeImpl {
   std::vector<BailoutBlock> bailout_blocks_;
   std::vector<std::unique_ptr<Function>> bailout_functions_;
   size_t remaining_bailout_depth_;
+  // whether the primitive ops with an instruction of their own are emitted
+  // as that instruction rather than as an OP, see emitPrimitiveOp
+  bool emit_primitive_instructions_;
 
   CodeImpl(
       const std::shared_ptr<Graph>& graph,
       std::string function_name,
-      size_t remaining_bailout_depth)
+      size_t remaining_bailout_depth,
+      bool emit_primitive_instructions)
       : function_name_(std::move(function_name)),
         preprocess_(*graph),
         current_node_(preprocess_.graph->return_node()),
-        remaining_bailout_depth_(remaining_bailout_depth) {
+        remaining_bailout_depth_(remaining_bailout_depth),
+        emit_primitive_instructions_(emit_primitive_instructions) {
     graph_ = preprocess_.graph;
     n_outputs = graph_->outputs().size();
     if (n_outputs == 1) {
@@ -644,6 +649,28 @@ struct CodeImpl {
     operator_table_.emplace_back(op.getOperation(node));
   }
 
+  // A few primitive ops, whose schema is known here, run in the
+  // interpreter loop instead of through a boxed Operation: no call through
+  // std::function, and no Operation in the operator table.
+  void emitPrimitiveOp(OpCode op, Node* node) {
+    if (!emit_primitive_instructions_) {
+      emitOperator(node);
+      return;
+    }
+    emitLoadInputs(node->inputs());
+    insertInstruction(op);
+  }
+
+  // The casts that do not change the value need no instruction: the input
+  // is left on the stack as the output.
+  void emitNoopCast(Node* node) {
+    if (!emit_primitive_instructions_) {
+      emitOperator(node);
+      return;
+    }
+    emitLoadInputs(node->inputs());
+  }
+
   void emitWait(Node* node) {
     emitLoadInputs(node->inputs());
     insertInstruction(WAIT);
@@ -994,6 +1021,19 @@ struct CodeImpl {
       case prim::Exit:
         emitExit(node);
         break;
+      case prim::TupleIndex:
+        emitPrimitiveOp(TUPLE_INDEX, node);
+        break;
+      case aten::__is__:
+        emitPrimitiveOp(IS, node);
+        break;
+      case aten::__isnot__:
+        emitPrimitiveOp(IS_NOT, node);
+        break;
+      case prim::unchecked_cast:
+      case prim::unchecked_unwrap_optional:
+        emitNoopCast(node);
+        break;
     }
   }
 
@@ -1451,6 +1491,8 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
           } break;
           case TAIL_CALL: {
             GRAPH_DEBUG("running TAIL_CALL for ", inst.X);
+            // only emitted for bailouts
+            getProfilingPlanCacheStats().bailouts++;
             frame.function->function_table_[inst.X]->ensure_defined();
             size_t remaining_bailout_depth =
                 frame.function->remaining_bailout_depth_ > 0
@@ -1485,6 +1527,27 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             tupleSlice(stack, inst.X, inst.X + inst.N);
             ++frame.pc;
           } break;
+          case TUPLE_INDEX: {
+            tupleIndex(stack);
+            ++frame.pc;
+          } break;
+          case IS: {
+            IValue self, obj;
+            pop(stack, self, obj);
+            push(stack, self.is(obj));
+            ++frame.pc;
+          } break;
+          case IS_NOT: {
+            IValue self, obj;
+            pop(stack, self, obj);
+            push(stack, !self.is(obj));
+            ++frame.pc;
+          } break;
+          case LOAD_OP:
+          case MOVE_RET:
+            TORCH_INTERNAL_ASSERT(
+                false, inst, " is only used by mobile modules");
+            break;
           case NAMED_TUPLE_CONSTRUCT: {
             auto type =
                 frame.function->type_table_[inst.X]->expect<TupleType>();
@@ -1705,11 +1768,13 @@ std::ostream& operator<<(std::ostream& out, const Code& code) {
 Code::Code(
     const std::shared_ptr<Graph>& graph,
     std::string function_name,
-    size_t remaining_bailout_depth)
+    size_t remaining_bailout_depth,
+    bool emit_primitive_instructions)
     : pImpl(new CodeImpl(
           graph,
           std::move(function_name),
-          remaining_bailout_depth)) {}
+          remaining_bailout_depth,
+          emit_primitive_instructions)) {}
 Code::~Code() = default;
 
 const std::vector<GraphExecutor*>& Code::grad_executors() {
@@ -42,11 +42,14 @@ struct TORCH_API Code {
   Code() : pImpl(nullptr) {}
   // remaining_bailout_depth is irrelevant in a `Code` object unless the `Code`
   // is directly created by `GraphExecutor` in which case it's likely to contain
-  // `prim::BailOut`s to control the maximum depth of bailout chains
+  // `prim::BailOut`s to control the maximum depth of bailout chains.
+  // With emit_primitive_instructions = false every op is emitted as an OP or
+  // OPN instruction, as the bytecode of mobile modules requires.
   explicit Code(
       const std::shared_ptr<Graph>& graph,
       std::string function_name,
-      size_t remaining_bailout_depth = 0);
+      size_t remaining_bailout_depth = 0,
+      bool emit_primitive_instructions = true);
   ~Code();
 
   const std::vector<GraphExecutor*>& grad_executors();
@@ -4,6 +4,7 @@
 #include <ATen/core/alias_info.h>
 #include <torch/csrc/jit/frontend/edit_distance.h>
 
+#include <algorithm>
 #include <queue>
 #include <utility>
 #include <vector>
@@ -12,6 +13,8 @@ namespace torch {
 namespace jit {
 
 namespace {
+void checkSchemalessOperator(const Operator& op);
+
 using OperatorMap =
     std::unordered_map<Symbol, std::vector<std::shared_ptr<Operator>>>;
 struct OperatorRegistry {
@@ -46,6 +49,11 @@ struct OperatorRegistry {
   // XXX - caller must be holding lock
   void registerPendingOperators() {
     for (const auto& op : to_register) {
+      if (op->isC10Op()) {
+        // deferred from registerOperator so that registering the c10
+        // wrapper doesn't parse the schema of the operator
+        checkSchemalessOperator(*op);
+      }
       Symbol sym = Symbol::fromQualString(op->schema().name());
       operators[sym].push_back(op);
       operators_by_sig[canonicalSchemaString(op->schema())] = op;
@@ -58,15 +66,35 @@ struct OperatorRegistry {
     std::lock_guard<std::mutex> guard(lock);
 #ifdef C10_MOBILE
     TORCH_INTERNAL_ASSERT(
-        0 == registered_operator_names.count(op.schema().operator_name()),
+        0 == registered_operator_names.count(op.operatorName()),
         "Tried to register operator \"",
-        op.schema(),
+        toString(op.operatorName()),
         "\" to JIT but the operator name was already registered before. Please add or change the overload name.");
-    registered_operator_names.insert(op.schema().operator_name());
+    registered_operator_names.insert(op.operatorName());
 #endif
     to_register.push_back(std::make_shared<Operator>(std::move(op)));
   }
 
+  // Returns false if the wrapper of the c10 operator was already moved out
+  // of the pending list, i.e. its schema has been parsed
+  bool deregisterPendingC10Operator(const c10::OperatorName& name) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto pending_it = std::find_if(
+        to_register.begin(),
+        to_register.end(),
+        [&](const std::shared_ptr<Operator>& op) {
+          return op->isC10Op() && op->operatorName() == name;
+        });
+    if (pending_it == to_register.end()) {
+      return false;
+    }
+#ifdef C10_MOBILE
+    registered_operator_names.erase(name);
+#endif
+    to_register.erase(pending_it);
+    return true;
+  }
+
   void deregisterOperator(const FunctionSchema& schema) {
     Symbol sym = Symbol::fromQualString(schema.name());
     auto sig = canonicalSchemaString(schema);
@@ -82,7 +110,10 @@ struct OperatorRegistry {
 #endif
     // Try removing from pending operators list first
     auto pending_it = to_register.begin();
-    while (pending_it != to_register.end() && (*pending_it)->schema() != schema)
+    // Compare the names first, which doesn't parse lazily defined schemas
+    while (pending_it != to_register.end() &&
+           ((*pending_it)->operatorName() != schema.operator_name() ||
+            (*pending_it)->schema() != schema))
       ++pending_it;
 
     if (pending_it != to_register.end()) {
@@ -337,7 +368,8 @@ bool aliasAnalysisHasSpecialCaseFor(Symbol symbol) {
   return handled.count(symbol) || purposefully_not_handled.count(symbol);
 }
 
-void registerOperator(Operator&& op) {
+namespace {
+void checkSchemalessOperator(const Operator& op) {
   if (op.schema().is_varret()) {
     Symbol s = Symbol::fromQualString(op.schema().name());
     if (!printerHasSpecialCaseFor(s)) {
@@ -363,6 +395,13 @@ void registerOperator(Operator&& op) {
           " is special cased and cannot use explicit alias analysis.");
     }
   }
+}
+} // namespace
+
+void registerOperator(Operator&& op) {
+  if (!op.isC10Op()) {
+    checkSchemalessOperator(op);
+  }
   getRegistry().registerOperator(std::move(op));
 }
 
@@ -370,6 +409,12 @@ void deregisterOperator(const FunctionSchema& schema) {
   getRegistry().deregisterOperator(schema);
 }
 
+void deregisterOperator(const c10::OperatorHandle& op) {
+  if (!getRegistry().deregisterPendingC10Operator(op.operator_name())) {
+    getRegistry().deregisterOperator(op.schema());
+  }
+}
+
 const std::vector<std::shared_ptr<Operator>> getAllOperators() {
   return getRegistry().getAllOperators();
 }
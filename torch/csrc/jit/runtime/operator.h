@@ -156,6 +156,14 @@ struct TORCH_API Operator {
     return op_.is_left();
   }
 
+  // Unlike schema().operator_name(), this doesn't parse the schema of c10
+  // operators that were defined lazily, see Note [Lazy schema registration]
+  c10::OperatorName operatorName() const {
+    return op_.fold<c10::OperatorName>(
+        [](const C10Operator& op) { return op.handle_.operator_name(); },
+        [this](const JitOnlyOperator&) { return schema().operator_name(); });
+  }
+
   c10::AliasAnalysisKind aliasAnalysisKind() const {
     const FunctionSchema& schemaRef = schema();
     c10::AliasAnalysisKind alias_analysis = schemaRef.aliasAnalysis();
@@ -208,6 +216,9 @@ TORCH_API std::vector<Symbol> findSimilarOperators(Symbol input_op);
 
 TORCH_API void registerOperator(Operator&& op);
 TORCH_API void deregisterOperator(const FunctionSchema& schema);
+// Removes the wrapper of a c10 operator, without parsing its schema if the
+// JIT never looked it up
+TORCH_API void deregisterOperator(const c10::OperatorHandle& op);
 
 // XXX: this function is meant to be used with string literals only!
 TORCH_API std::shared_ptr<Operator> getOperatorForLiteral(
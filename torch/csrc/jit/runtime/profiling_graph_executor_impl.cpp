@@ -1,7 +1,9 @@
 #include <torch/csrc/jit/runtime/profiling_graph_executor_impl.h>
 
+#include <ATen/core/grad_mode.h>
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/passes/bailout_graph.h>
+#include <torch/csrc/jit/passes/assign_cuda_streams.h>
 #include <torch/csrc/jit/passes/batch_mm.h>
 #include <torch/csrc/jit/passes/canonicalize_graph_fuser_ops.h>
 #include <torch/csrc/jit/passes/clear_profiling.h>
@@ -54,6 +56,10 @@ C10_DEFINE_int64(
     torch_jit_bailout_depth,
     kDefaultBailoutDepth,
     "Number of re-specializations");
+C10_DEFINE_int64(
+    torch_jit_profiling_plan_cache_size,
+    0,
+    "Number of optimized plans per function, by shape class of the inputs");
 
 namespace torch {
 namespace jit {
@@ -68,6 +74,7 @@ static std::atomic<bool> profiling_mode{true};
 
 static std::atomic<size_t> num_profiled_runs{kDefaultNumProfiledRuns};
 static std::atomic<size_t> bailout_depth{kDefaultBailoutDepth};
+static std::atomic<size_t> profiling_plan_cache_size{0};
 
 std::atomic<bool>& getProfilingMode() {
   return profiling_mode;
@@ -95,6 +102,65 @@ std::atomic<size_t>& getBailoutDepth() {
   return bailout_depth;
 }
 
+std::atomic<size_t>& getProfilingPlanCacheSize() {
+  // Initialize profiling_plan_cache_size from command-line flag.
+  static const size_t init = []() {
+    return profiling_plan_cache_size =
+               FLAGS_torch_jit_profiling_plan_cache_size;
+  }();
+  (void)init; // Silence clang-tidy.
+  return profiling_plan_cache_size;
+}
+
+ProfilingPlanCacheStats& getProfilingPlanCacheStats() {
+  static ProfilingPlanCacheStats stats;
+  return stats;
+}
+
+namespace {
+
+// The shape class of inputs, see getProfilingPlanCacheSize()
+std::vector<int64_t> shapeClassOf(at::ArrayRef<IValue> inputs) {
+  const bool grad_enabled = at::GradMode::is_enabled();
+  std::vector<int64_t> shape_class;
+  std::vector<int64_t> sizes;
+  for (const IValue& input : inputs) {
+    // the other inputs are profiled for being None only
+    shape_class.push_back(input.isTensor() ? 2 : input.isNone());
+    if (!input.isTensor()) {
+      continue;
+    }
+    const at::Tensor& t = input.toTensor();
+    if (!t.defined()) {
+      shape_class.push_back(-1);
+      continue;
+    }
+    shape_class.push_back(static_cast<int64_t>(t.scalar_type()));
+    shape_class.push_back(static_cast<int64_t>(t.device().type()));
+    shape_class.push_back(t.device().index());
+    shape_class.push_back(grad_enabled && t.requires_grad());
+    shape_class.push_back(t.is_contiguous());
+    shape_class.push_back(t.dim());
+    for (int64_t size : t.sizes()) {
+      if (size <= 1) {
+        shape_class.push_back(size);
+        continue;
+      }
+      // refers to the first dim of this size, which is this one for a new
+      // size
+      const auto first = std::find(sizes.begin(), sizes.end(), size);
+      shape_class.push_back(
+          2 + (size % 8 == 0) + 2 * (first - sizes.begin()));
+      if (first == sizes.end()) {
+        sizes.push_back(size);
+      }
+    }
+  }
+  return shape_class;
+}
+
+} // namespace
+
 static bool needsGradientInProfilingMode(Block* b) {
   for (auto n : b->nodes()) {
     if (n->kind() == prim::BailOut) {
@@ -582,18 +648,13 @@ const ExecutionPlan& ProfilingGraphExecutorImpl::getOptimizedPlanFor(
     return *optimized_plan_;
   }
 
+  if (getProfilingPlanCacheSize() > 0) {
+    return getCachedPlanFor(stack);
+  }
+
   // if a profiling graph hasn't been created yet
   if (!pr_) {
-    auto copy = graph->copy();
-    runProfilingInsensitiveOptimizations(copy);
-    pr_ = ProfilingRecord::instrumentGraph(copy);
-    // `InsertProfileNodesForSpecializeAutogradZero` profiles a definition vs a
-    // use and it doesn't expect any profile nodes between a graph input and its
-    // consumer, `aten::_grad_sum_to_size`. This means we need to run it first,
-    // before any other pass that could insert `prim::iprofile_value` node on
-    // `aten::_grad_sum_to_size` input.
-    InsertProfileNodesForSpecializeAutogradZero(pr_.get());
-    GRAPH_DUMP("Profiled Graph: ", pr_->graph());
+    pr_ = createProfilingRecord();
     profiling_plan_ = ExecutionPlan(pr_->graph(), function_name_);
     // fall-through
   }
@@ -603,16 +664,93 @@ const ExecutionPlan& ProfilingGraphExecutorImpl::getOptimizedPlanFor(
     return *profiling_plan_;
   }
 
-  auto copy = pr_->graph()->copy();
+  optimized_plan_ = ExecutionPlan(
+      optimizeProfiledGraph(*pr_), function_name_, *remaining_bailout_depth_);
+  return *optimized_plan_;
+}
+
+const ExecutionPlan& ProfilingGraphExecutorImpl::getCachedPlanFor(
+    Stack& stack) {
+  std::vector<int64_t> shape_class = shapeClassOf(last(stack, num_inputs));
+  auto it = std::find_if(
+      plan_cache_.begin(), plan_cache_.end(), [&](const CachedPlan& plan) {
+        return plan.shape_class == shape_class;
+      });
+
+  if (it == plan_cache_.end()) {
+    getProfilingPlanCacheStats().misses++;
+    GRAPH_DEBUG("Profiling a new shape class in ", this);
+    if (plan_cache_.size() >= getProfilingPlanCacheSize()) {
+      getProfilingPlanCacheStats().evictions++;
+      evicted_plan_.clear();
+      evicted_plan_.splice(
+          evicted_plan_.begin(), plan_cache_, std::prev(plan_cache_.end()));
+    }
+    plan_cache_.emplace_front();
+    CachedPlan& plan = plan_cache_.front();
+    plan.shape_class = std::move(shape_class);
+    plan.pr = createProfilingRecord();
+    plan.profiling_plan = ExecutionPlan(plan.pr->graph(), function_name_);
+    return *plan.profiling_plan;
+  }
+
+  plan_cache_.splice(plan_cache_.begin(), plan_cache_, it);
+  CachedPlan& plan = plan_cache_.front();
+  if (plan.optimized_plan) {
+    getProfilingPlanCacheStats().hits++;
+    return *plan.optimized_plan;
+  }
+  if (!plan.pr->ready()) {
+    return *plan.profiling_plan;
+  }
+  getProfilingPlanCacheStats().hits++;
+
+  // the fallback functions created for this plan are owned by it, so that
+  // they are released with it
+  const size_t num_fallback_functions = fallback_functions_.size();
+  plan.optimized_plan = ExecutionPlan(
+      optimizeProfiledGraph(*plan.pr),
+      function_name_,
+      *remaining_bailout_depth_);
+  plan.fallback_functions.insert(
+      plan.fallback_functions.end(),
+      std::make_move_iterator(
+          fallback_functions_.begin() + num_fallback_functions),
+      std::make_move_iterator(fallback_functions_.end()));
+  fallback_functions_.resize(num_fallback_functions);
+  plan.pr.reset();
+  plan.profiling_plan.reset();
+  return *plan.optimized_plan;
+}
+
+std::unique_ptr<ProfilingRecord> ProfilingGraphExecutorImpl::
+    createProfilingRecord() {
+  auto copy = graph->copy();
+  runProfilingInsensitiveOptimizations(copy);
+  auto pr = ProfilingRecord::instrumentGraph(copy);
+  // `InsertProfileNodesForSpecializeAutogradZero` profiles a definition vs a
+  // use and it doesn't expect any profile nodes between a graph input and its
+  // consumer, `aten::_grad_sum_to_size`. This means we need to run it first,
+  // before any other pass that could insert `prim::iprofile_value` node on
+  // `aten::_grad_sum_to_size` input.
+  InsertProfileNodesForSpecializeAutogradZero(pr.get());
+  GRAPH_DUMP("Profiled Graph: ", pr->graph());
+  return pr;
+}
+
+std::shared_ptr<Graph> ProfilingGraphExecutorImpl::optimizeProfiledGraph(
+    const ProfilingRecord& pr) {
+  auto copy = pr.graph()->copy();
   ProfilingRecord::removeProfileCounter(copy->block());
   runProfilingOptimizations(copy);
   // replaces a fallback graph inserted by
   // specialize_autogradzero if one exists
   replaceFallbackGraphWithFallbackFunction(copy->block());
+  if (getNumCudaStreams() > 1) {
+    AssignCudaStreams(copy, getNumCudaStreams());
+  }
   GRAPH_DUMP("Optimized Graph: ", copy);
-  optimized_plan_ =
-      ExecutionPlan(copy, function_name_, *remaining_bailout_depth_);
-  return *optimized_plan_;
+  return copy;
 }
 
 const ExecutionPlan& ProfilingGraphExecutorImpl::getPlanFor(
@@ -629,8 +767,28 @@ const ExecutionPlan& ProfilingGraphExecutorImpl::getPlanFor(
   return getOptimizedPlanFor(stack, remaining_bailout_depth);
 }
 
+bool ProfilingGraphExecutorImpl::isStablePlan(const ExecutionPlan& plan) {
+  // the profiling plan changes into the optimized one once profiling is done
+  for (const CachedPlan& cached : plan_cache_) {
+    if (cached.profiling_plan && &plan == &*cached.profiling_plan) {
+      return false;
+    }
+  }
+  return !profiling_plan_ || &plan != &*profiling_plan_;
+}
+
 GraphExecutorState ProfilingGraphExecutorImpl::getDebugState() {
   GraphExecutorState state;
+  if (!optimized_plan_) {
+    // the most recently used optimized plan of the cache
+    for (const CachedPlan& cached : plan_cache_) {
+      if (cached.optimized_plan) {
+        state.execution_plans.emplace(
+            ArgumentSpec{0, 0}, *cached.optimized_plan);
+        return state;
+      }
+    }
+  }
   TORCH_INTERNAL_ASSERT(optimized_plan_);
   auto opt_plan = *optimized_plan_;
   state.execution_plans.emplace(ArgumentSpec{0, 0}, opt_plan);
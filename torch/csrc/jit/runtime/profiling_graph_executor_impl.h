@@ -1,6 +1,8 @@
 #pragma once
 #include <torch/csrc/jit/runtime/graph_executor_impl.h>
 
+#include <list>
+
 namespace torch {
 namespace jit {
 
@@ -14,10 +16,26 @@ struct ProfilingGraphExecutorImpl : public GraphExecutorImplBase {
   GraphExecutorState getDebugState() override;
   ~ProfilingGraphExecutorImpl() override = default;
 
+ protected:
+  bool isStablePlan(const ExecutionPlan& plan) override;
+
  private:
+  // The profiling and optimized plans of one shape class of the inputs, see
+  // getProfilingPlanCacheSize()
+  struct CachedPlan {
+    std::vector<int64_t> shape_class;
+    std::unique_ptr<ProfilingRecord> pr;
+    c10::optional<ExecutionPlan> profiling_plan;
+    c10::optional<ExecutionPlan> optimized_plan;
+    std::vector<std::unique_ptr<Function>> fallback_functions;
+  };
+
   const ExecutionPlan& getOptimizedPlanFor(
       Stack& stack,
       size_t remaining_bailout_depth);
+  const ExecutionPlan& getCachedPlanFor(Stack& stack);
+  std::unique_ptr<ProfilingRecord> createProfilingRecord();
+  std::shared_ptr<Graph> optimizeProfiledGraph(const ProfilingRecord& pr);
   void runProfilingInsensitiveOptimizations(std::shared_ptr<Graph>& graph);
   void runProfilingOptimizations(std::shared_ptr<Graph>& graph);
   void replaceFallbackGraphWithFallbackFunction(Block* b);
@@ -37,6 +55,11 @@ struct ProfilingGraphExecutorImpl : public GraphExecutorImplBase {
   // of the GraphExecutor and only shared with InterpreterState
   std::vector<std::unique_ptr<Function>> fallback_functions_;
   c10::optional<size_t> remaining_bailout_depth_;
+  // most recently used first
+  std::list<CachedPlan> plan_cache_;
+  // The plans returned by getPlanFor are used after compile_mutex is
+  // released, so an evicted plan is only destroyed by the next eviction.
+  std::list<CachedPlan> evicted_plan_;
 };
 
 } // namespace jit
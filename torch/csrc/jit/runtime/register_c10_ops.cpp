@@ -161,7 +161,7 @@ Operator createOperatorFromC10_withTracingNotHandledHere(
 class RegistrationListener final : public c10::OpRegistrationListener {
  public:
   void onOperatorRegistered(const c10::OperatorHandle& op) override {
-    if (op.schema().name() == "aten::backward") {
+    if (op.operator_name().name == "aten::backward") {
       // aten::backward has a manual wrapper in register_prim_ops_fulljit.cpp.
       // We should not additionally export the c10 aten::backward op from
       // native_functions.yaml to JIT. This special handling is needed because
@@ -170,7 +170,7 @@ class RegistrationListener final : public c10::OpRegistrationListener {
       // TODO Find a better way to handle this.
       return;
     }
-    if (at::is_custom_op(op.schema().operator_name())) {
+    if (at::is_custom_op(op.operator_name())) {
       // custom ops don't do tracing/autograd in VariableType yet, we need to
       // handle tracing here.
       torch::jit::registerOperator(
@@ -184,11 +184,11 @@ class RegistrationListener final : public c10::OpRegistrationListener {
   }
 
   void onOperatorDeregistered(const c10::OperatorHandle& op) override {
-    if (op.schema().name() == "aten::backward") {
+    if (op.operator_name().name == "aten::backward") {
       // see comment in onOperatorRegistered for why aten::backward is excluded
       return;
     }
-    torch::jit::deregisterOperator(op.schema());
+    torch::jit::deregisterOperator(op);
   }
 };
 
@@ -0,0 +1,91 @@
+#include <torch/csrc/jit/runtime/cuda_graph_capture.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
+#include <ATen/cuda/CUDAGraph.h>
+#include <c10/cuda/CUDAGuard.h>
+
+/*
+ * Registers the CUDA graphs used by the CUDA graph capture mode of the graph
+ * executors, see cuda_graph_capture.h
+ */
+
+namespace torch {
+namespace jit {
+namespace {
+
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000 && \
+    !defined(__HIP_PLATFORM_HCC__)
+
+class CapturedCudaGraphImpl : public CapturedCudaGraph {
+ public:
+  explicit CapturedCudaGraphImpl(c10::DeviceIndex device)
+      : device_(device),
+        capture_stream_(at::cuda::getStreamFromPool(false, device)) {}
+
+  void captureBegin() override {
+    // The capture stream starts after the work that filled the static inputs.
+    at::cuda::CUDAEvent inputs_ready;
+    inputs_ready.record(at::cuda::getCurrentCUDAStream(device_));
+    inputs_ready.block(capture_stream_);
+    capture_guard_.emplace(capture_stream_);
+    try {
+      graph_.capture_begin();
+    } catch (...) {
+      capture_guard_.reset();
+      throw;
+    }
+  }
+
+  void captureEnd() override {
+    // Nothing ran on the capture stream, so the caller's stream doesn't
+    // need to wait for it.
+    try {
+      graph_.capture_end();
+    } catch (...) {
+      capture_guard_.reset();
+      throw;
+    }
+    capture_guard_.reset();
+  }
+
+  void waitLastReplay() override {
+    last_replay_done_.block(at::cuda::getCurrentCUDAStream(device_));
+  }
+
+  void replay() override {
+    c10::cuda::CUDAGuard device_guard(device_);
+    graph_.replay();
+  }
+
+  void recordReplayDone() override {
+    last_replay_done_.record(at::cuda::getCurrentCUDAStream(device_));
+  }
+
+ private:
+  c10::DeviceIndex device_;
+  at::cuda::CUDAStream capture_stream_;
+  c10::optional<c10::cuda::CUDAStreamGuard> capture_guard_;
+  at::cuda::CUDAGraph graph_;
+  at::cuda::CUDAEvent last_replay_done_;
+};
+
+std::unique_ptr<CapturedCudaGraph> createCapturedCudaGraph(
+    c10::DeviceIndex device) {
+  return std::unique_ptr<CapturedCudaGraph>(new CapturedCudaGraphImpl(device));
+}
+
+class RegisterCapturedCudaGraph {
+ public:
+  RegisterCapturedCudaGraph() {
+    registerCapturedCudaGraphFactory(&createCapturedCudaGraph);
+  }
+};
+
+static RegisterCapturedCudaGraph register_captured_cuda_graph_;
+
+#endif
+
+} // namespace
+} // namespace jit
+} // namespace torch
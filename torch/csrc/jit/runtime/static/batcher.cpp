@@ -0,0 +1,225 @@
+#include <torch/csrc/jit/runtime/static/batcher.h>
+
+#include <ATen/ATen.h>
+
+#include <numeric>
+#include <stdexcept>
+
+namespace torch {
+namespace jit {
+
+StaticRuntimeBatcher::StaticRuntimeBatcher(
+    std::shared_ptr<InferenceModule> m,
+    const StaticRuntimeOptions& opts,
+    const StaticRuntimeBatcherOptions& batcher_opts)
+    : runtime_(std::move(m), opts), batcher_opts_(batcher_opts) {
+  TORCH_CHECK(
+      batcher_opts_.max_batch_size > 0,
+      "max_batch_size must be positive, got ",
+      batcher_opts_.max_batch_size);
+  worker_ = std::thread([this] { worker_loop(); });
+}
+
+StaticRuntimeBatcher::~StaticRuntimeBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  worker_.join();
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> StaticRuntimeBatcher::submit(
+    std::vector<at::Tensor> inputs) {
+  TORCH_CHECK(!inputs.empty(), "StaticRuntimeBatcher requires inputs");
+  for (const auto& input : inputs) {
+    TORCH_CHECK(
+        input.defined() && input.dim() > 0,
+        "StaticRuntimeBatcher requires inputs with a batch dimension");
+  }
+  auto future = c10::make_intrusive<c10::ivalue::Future>(AnyType::get());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(
+        {std::move(inputs), future, std::chrono::steady_clock::now()});
+  }
+  cv_.notify_one();
+  return future;
+}
+
+bool StaticRuntimeBatcher::is_compatible(
+    const Request& first,
+    const Request& request) {
+  if (first.inputs.size() != request.inputs.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < first.inputs.size(); ++i) {
+    const auto& a = first.inputs[i];
+    const auto& b = request.inputs[i];
+    if (a.dim() != b.dim() || a.scalar_type() != b.scalar_type() ||
+        a.device() != b.device() || a.sizes().slice(1) != b.sizes().slice(1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<StaticRuntimeBatcher::Request> StaticRuntimeBatcher::take_batch(
+    std::unique_lock<std::mutex>& lock) {
+  cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+  if (queue_.empty()) {
+    return {};
+  }
+
+  const auto deadline = queue_.front().submit_time + batcher_opts_.max_latency;
+  size_t num_requests = 0;
+  while (true) {
+    // the longest compatible prefix of the queue that fits into a batch
+    int64_t rows = 0;
+    bool full = false;
+    num_requests = 0;
+    for (const auto& request : queue_) {
+      const int64_t request_rows = request.inputs[0].size(0);
+      if (num_requests > 0 &&
+          (!is_compatible(queue_.front(), request) ||
+           rows + request_rows > batcher_opts_.max_batch_size)) {
+        full = true;
+        break;
+      }
+      rows += request_rows;
+      ++num_requests;
+    }
+    full = full || rows >= batcher_opts_.max_batch_size;
+    if (full || stop_ ||
+        cv_.wait_until(lock, deadline) == std::cv_status::timeout) {
+      break;
+    }
+  }
+
+  std::vector<Request> batch;
+  batch.reserve(num_requests);
+  for (size_t i = 0; i < num_requests; ++i) {
+    batch.emplace_back(std::move(queue_.front()));
+    queue_.pop_front();
+  }
+  return batch;
+}
+
+void StaticRuntimeBatcher::run_batch(std::vector<Request>& batch) {
+  std::vector<IValue> results;
+  try {
+    std::vector<IValue> inputs;
+    std::vector<int64_t> rows;
+    rows.reserve(batch.size());
+    for (const auto& request : batch) {
+      rows.push_back(request.inputs[0].size(0));
+    }
+    if (batch.size() == 1) {
+      inputs.assign(batch[0].inputs.begin(), batch[0].inputs.end());
+    } else {
+      std::vector<at::Tensor> parts(batch.size());
+      for (size_t i = 0; i < batch[0].inputs.size(); ++i) {
+        for (size_t j = 0; j < batch.size(); ++j) {
+          parts[j] = batch[j].inputs[i];
+        }
+        inputs.emplace_back(at::cat(parts, 0));
+      }
+    }
+    const int64_t total_rows =
+        std::accumulate(rows.begin(), rows.end(), int64_t{0});
+
+    IValue output = runtime_.run(inputs, {});
+
+    // The outputs are cloned because Static Runtime writes the outputs of the
+    // next run into the same tensors.
+    auto split = [&](const IValue& ivalue) {
+      TORCH_CHECK(
+          ivalue.isTensor(),
+          "StaticRuntimeBatcher requires models with Tensor outputs");
+      const at::Tensor& tensor = ivalue.toTensor();
+      TORCH_CHECK(
+          tensor.dim() > 0 && tensor.size(0) == total_rows,
+          "StaticRuntimeBatcher requires outputs with the batch size of the "
+          "inputs (",
+          total_rows,
+          ") as dim 0");
+      std::vector<at::Tensor> slices;
+      slices.reserve(rows.size());
+      int64_t offset = 0;
+      for (int64_t n : rows) {
+        slices.emplace_back(tensor.narrow(0, offset, n).clone());
+        offset += n;
+      }
+      return slices;
+    };
+
+    if (output.isTuple() || output.isList()) {
+      const std::vector<IValue> elements = output.isTuple()
+          ? output.toTuple()->elements()
+          : output.toListRef().vec();
+      std::vector<std::vector<IValue>> outputs(batch.size());
+      for (const auto& element : elements) {
+        auto slices = split(element);
+        for (size_t j = 0; j < batch.size(); ++j) {
+          outputs[j].emplace_back(std::move(slices[j]));
+        }
+      }
+      for (auto& o : outputs) {
+        if (output.isTuple()) {
+          results.emplace_back(c10::ivalue::Tuple::create(std::move(o)));
+        } else {
+          c10::List<at::Tensor> list;
+          list.reserve(o.size());
+          for (auto& t : o) {
+            list.push_back(t.toTensor());
+          }
+          results.emplace_back(std::move(list));
+        }
+      }
+    } else {
+      for (auto& slice : split(output)) {
+        results.emplace_back(std::move(slice));
+      }
+    }
+  } catch (...) {
+    auto eptr = std::current_exception();
+    for (auto& request : batch) {
+      request.future->setError(eptr);
+    }
+    return;
+  }
+
+  for (size_t j = 0; j < batch.size(); ++j) {
+    batch[j].future->markCompleted(std::move(results[j]));
+  }
+}
+
+void StaticRuntimeBatcher::worker_loop() {
+  while (true) {
+    std::vector<Request> batch;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (stop_) {
+        break;
+      }
+      batch = take_batch(lock);
+    }
+    if (!batch.empty()) {
+      run_batch(batch);
+    }
+  }
+
+  std::deque<Request> pending;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending.swap(queue_);
+  }
+  auto eptr = std::make_exception_ptr(std::runtime_error(
+      "StaticRuntimeBatcher was destroyed before running the request"));
+  for (auto& request : pending) {
+    request.future->setError(eptr);
+  }
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace torch {
+namespace jit {
+
+struct TORCH_API StaticRuntimeBatcherOptions {
+  // max number of rows (the sum of the sizes of dim 0 of the inputs) of a
+  // batch. A single request that is larger than this runs on its own.
+  int64_t max_batch_size{64};
+  // max time the oldest request of a batch waits for other requests
+  std::chrono::microseconds max_latency{std::chrono::microseconds(500)};
+};
+
+/// StaticRuntimeBatcher batches concurrent requests to the same model
+/// dynamically, to give small models (e.g. embedding bags followed by MLPs)
+/// matrix-matrix sized work instead of matrix-vector sized work.
+///
+/// Requests are compatible if all their inputs are tensors with the same
+/// number of dimensions, dtype, device and sizes except for dim 0.
+/// Compatible requests are concatenated along dim 0, run through one
+/// StaticRuntime owned by the batcher, and the outputs are split back along
+/// dim 0. The model must map each row of its inputs to the same row of every
+/// output, and return a Tensor, or a Tuple or List of Tensors.
+///
+/// Requests are run in the order they are submitted. A batch is run as soon
+/// as it reaches max_batch_size rows, the next request isn't compatible, or
+/// its oldest request has waited for max_latency.
+/// @code
+///   auto mod = PrepareForStaticRuntime(m);
+///   StaticRuntimeBatcher batcher(mod);
+///   auto future = batcher.submit({input});
+///   future->wait();
+///   auto output = future->value();
+/// @endcode
+class TORCH_API StaticRuntimeBatcher {
+ public:
+  explicit StaticRuntimeBatcher(
+      std::shared_ptr<InferenceModule> m,
+      const StaticRuntimeOptions& opts = StaticRuntimeOptions(),
+      const StaticRuntimeBatcherOptions& batcher_opts =
+          StaticRuntimeBatcherOptions());
+
+  // Fails the requests that haven't run yet.
+  ~StaticRuntimeBatcher();
+
+  // The future completes with the output of the model for these inputs, or
+  // with the error raised by the batch they ran in.
+  c10::intrusive_ptr<c10::ivalue::Future> submit(
+      std::vector<at::Tensor> inputs);
+
+  const StaticRuntimeBatcherOptions& options() const {
+    return batcher_opts_;
+  }
+
+ private:
+  struct Request {
+    std::vector<at::Tensor> inputs;
+    c10::intrusive_ptr<c10::ivalue::Future> future;
+    std::chrono::steady_clock::time_point submit_time;
+  };
+
+  void worker_loop();
+  // Takes the next batch from the front of the queue. Requires mutex_.
+  std::vector<Request> take_batch(std::unique_lock<std::mutex>& lock);
+  void run_batch(std::vector<Request>& batch);
+
+  static bool is_compatible(const Request& first, const Request& request);
+
+  StaticRuntime runtime_;
+  const StaticRuntimeBatcherOptions batcher_opts_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request> queue_;
+  bool stop_{false};
+  std::thread worker_;
+};
+
+} // namespace jit
+} // namespace torch
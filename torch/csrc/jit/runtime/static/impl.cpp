@@ -1,13 +1,16 @@
 #include <torch/csrc/jit/runtime/static/impl.h>
 
+#include <ATen/Parallel.h>
 #include <ATen/core/LegacyTypeDispatch.h>
 #include <ATen/core/interned_strings.h>
 #include <c10/core/CPUAllocator.h>
+#include <c10/util/ThreadLocalDebugInfo.h>
 #include <caffe2/core/scope_guard.h>
 #include <caffe2/core/timer.h>
 #include <torch/csrc/jit/passes/canonicalize.h>
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
 #include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/fuse_add_layer_norm.h>
 #include <torch/csrc/jit/passes/remove_mutation.h>
 #include <torch/csrc/jit/passes/subgraph_rewrite.h>
 #include <torch/csrc/jit/runtime/static/ops.h>
@@ -31,6 +34,9 @@ namespace {
 void OptimizeGraph(std::shared_ptr<torch::jit::Graph>& graph) {
   PrepareGraphForStaticRuntime(graph);
   FuseInferenceOpsForSparseNN(graph);
+  FuseCatFlatten(graph);
+  FuseToContiguous(graph);
+  FuseAddLayerNorm(graph);
   ConstantPropagation(graph);
 }
 
@@ -321,6 +327,110 @@ void DeduceInternalValues(
     }
   }
 }
+bool isPrimOp(Node* node) {
+  return node->kind() == prim::ListConstruct ||
+      node->kind() == prim::TupleConstruct || node->kind() == prim::ListUnpack;
+}
+
+// Splits the nodes of graph into steps that run one after the other. A node
+// joins the region of the step that computes its inputs. A node with inputs
+// from several regions of the step starts the next step, and mutating nodes
+// and nodes with side effects are alone in their step. Cheap regions are
+// merged into one region run by the calling thread.
+std::vector<std::vector<ParallelRegion>> PartitionParallelRegions(
+    const std::shared_ptr<torch::jit::Graph>& graph,
+    size_t min_region_cost) {
+  std::vector<std::vector<ParallelRegion>> steps;
+  // regions of the current step and the number of their nodes other than
+  // prim ops
+  std::vector<ParallelRegion> regions;
+  std::vector<size_t> costs;
+  // region of the current step that computes a value
+  std::unordered_map<Value*, size_t> value_to_region;
+
+  auto finishStep = [&]() {
+    if (regions.empty()) {
+      return;
+    }
+    std::vector<ParallelRegion> step;
+    ParallelRegion inline_region;
+    inline_region.run_inline = true;
+    for (size_t i = 0; i < regions.size(); i++) {
+      if (costs[i] < min_region_cost || regions.size() == 1) {
+        inline_region.nodes.insert(
+            inline_region.nodes.end(),
+            regions[i].nodes.begin(),
+            regions[i].nodes.end());
+      } else {
+        step.emplace_back(std::move(regions[i]));
+      }
+    }
+    if (!inline_region.nodes.empty()) {
+      // keep the topological order of the nodes of the merged regions
+      std::sort(inline_region.nodes.begin(), inline_region.nodes.end());
+      step.insert(step.begin(), std::move(inline_region));
+    }
+    steps.emplace_back(std::move(step));
+    regions.clear();
+    costs.clear();
+    value_to_region.clear();
+  };
+
+  size_t node_idx = 0;
+  for (Node* node : graph->nodes()) {
+    if (node->kind() == prim::Constant) {
+      continue;
+    }
+    const FunctionSchema* schema = node->maybeSchema();
+    const bool alone =
+        node->hasSideEffects() || (schema && schema->is_mutable());
+    std::set<size_t> deps;
+    for (Value* input : node->inputs()) {
+      auto it = value_to_region.find(input);
+      if (it != value_to_region.end()) {
+        deps.insert(it->second);
+      }
+    }
+    if (alone || deps.size() > 1) {
+      finishStep();
+      deps.clear();
+    }
+    size_t region = 0;
+    if (deps.empty()) {
+      region = regions.size();
+      regions.emplace_back();
+      costs.push_back(0);
+    } else {
+      region = *deps.begin();
+    }
+    regions[region].nodes.push_back(node_idx++);
+    costs[region] += isPrimOp(node) ? 0 : 1;
+    for (Value* output : node->outputs()) {
+      value_to_region[output] = region;
+    }
+    if (alone) {
+      finishStep();
+    }
+  }
+  finishStep();
+  return steps;
+}
+
+// The regions of a step left to run by the tasks on the inter-op thread pool
+// and the calling thread. Each region is claimed by one of them, and the
+// calling thread only waits for regions that are already running, so a busy
+// pool can't deadlock a step.
+struct ParallelStepState {
+  explicit ParallelStepState(std::vector<const ParallelRegion*> r)
+      : regions(std::move(r)), remaining(regions.size()) {}
+
+  const std::vector<const ParallelRegion*> regions;
+  std::atomic<size_t> next{0};
+  std::mutex mutex;
+  std::condition_variable done;
+  size_t remaining;
+  std::exception_ptr error;
+};
 } // namespace
 
 void InferenceModule::init() {
@@ -335,6 +445,10 @@ void InferenceModule::init() {
       output_regs,
       opts.optimize_memory);
   DeduceInternalValues(graph, value_to_reg, internals);
+  if (opts.enable_inter_op_parallelism) {
+    parallel_steps =
+        PartitionParallelRegions(graph, opts.inter_op_min_region_cost);
+  }
 }
 
 InferenceModule::InferenceModule(
@@ -465,10 +579,6 @@ c10::IValue StaticRuntime::run(
   // functions, such as resize_ and resize_as_.
   at::AutoNonVariableTypeMode non_var_type_mode(true);
 
-  if (planner_) {
-    planner_->allocate();
-  }
-
   if (!kwargs.empty()) {
     // This is not ideal
     TORCH_CHECK(
@@ -486,11 +596,22 @@ c10::IValue StaticRuntime::run(
     }
   }
 
+  // the memory plan depends on the shapes of the inputs
+  if (planner_) {
+    planner_->allocate();
+  }
+
   // NB: before optimizing the order of execution, ensure that the
   // memory optimization pass (LivenessMap + AssignRegisters) is
   // aware of the new order!
-  for (auto& n : nodes_) {
-    n.run();
+  if (module_->parallel_steps.empty()) {
+    for (auto& n : nodes_) {
+      n.run();
+    }
+  } else {
+    for (const auto& step : module_->parallel_steps) {
+      run_parallel_step(step);
+    }
   }
 
   if (opts_.cleanup_activations) {
@@ -513,6 +634,97 @@ c10::IValue StaticRuntime::run(
   return Output(0);
 }
 
+void StaticRuntime::run_region(const ParallelRegion& region) {
+  for (size_t i : region.nodes) {
+    nodes_[i].run();
+  }
+}
+
+void StaticRuntime::run_parallel_step(const std::vector<ParallelRegion>& step) {
+  std::vector<const ParallelRegion*> parallel_regions;
+  const ParallelRegion* inline_region = nullptr;
+  for (const ParallelRegion& region : step) {
+    if (region.run_inline) {
+      inline_region = &region;
+    } else {
+      parallel_regions.push_back(&region);
+    }
+  }
+  if (parallel_regions.size() <= 1) {
+    for (const ParallelRegion& region : step) {
+      run_region(region);
+    }
+    return;
+  }
+
+  auto state = std::make_shared<ParallelStepState>(std::move(parallel_regions));
+  auto run_claimed_regions = [this, state]() {
+    size_t i = 0;
+    while ((i = state->next++) < state->regions.size()) {
+      std::exception_ptr error;
+      try {
+        run_region(*state->regions[i]);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (error && !state->error) {
+        state->error = error;
+      }
+      if (--state->remaining == 0) {
+        state->done.notify_all();
+      }
+    }
+  };
+  for (size_t i = 1; i < state->regions.size(); i++) {
+    at::launch(run_claimed_regions);
+  }
+
+  std::exception_ptr inline_error;
+  if (inline_region) {
+    try {
+      run_region(*inline_region);
+    } catch (...) {
+      inline_error = std::current_exception();
+    }
+  }
+  run_claimed_regions();
+  {
+    // the regions claimed by the pool use the nodes, so they have to finish
+    // before an error is rethrown
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&state] { return state->remaining == 0; });
+  }
+  if (inline_error) {
+    std::rethrow_exception(inline_error);
+  }
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+namespace {
+
+// Counts the CPU allocations made by the current thread
+struct AllocationCounter : public c10::MemoryReportingInfoBase {
+  void reportMemoryUsage(void* /* unused */, int64_t alloc_size, c10::Device device)
+      override {
+    if (alloc_size > 0 && device.is_cpu()) {
+      count++;
+      bytes += alloc_size;
+    }
+  }
+
+  bool memoryProfilingEnabled() const override {
+    return true;
+  }
+
+  size_t count = 0;
+  size_t bytes = 0;
+};
+
+} // namespace
+
 void StaticRuntime::benchmark(
     const std::vector<c10::IValue>& args,
     const std::unordered_map<std::string, c10::IValue>& kwargs,
@@ -546,16 +758,34 @@ void StaticRuntime::benchmark(
     const double ms = p.second;
     std::cout << std::setw(15) << ms << " ms. " << std::setw(10)
               << results.percent_per_node_type[kind] << "%. " << kind << " ("
-              << results.instances_per_node_type[kind] << " nodes)"
+              << results.instances_per_node_type[kind] << " nodes"
+              << (results.out_nodes.count(kind) ? ", out variant)" : ")")
               << std::endl;
   }
   std::cout << std::setw(15) << results.total_time << " ms. in Total"
             << std::endl;
+  const float out_nodes_percent = 100.0 * results.out_nodes_count /
+      static_cast<float>(results.total_nodes_count);
+  std::cout << "Total number of 'out' variant nodes/total number of nodes: "
+            << results.out_nodes_count << "/" << results.total_nodes_count
+            << " (" << out_nodes_percent << "%)" << std::endl;
+  std::cout << "Node types without out variant:";
+  for (const auto& p : results.instances_per_node_type) {
+    if (!results.out_nodes.count(p.first)) {
+      std::cout << " " << p.first;
+    }
+  }
+  std::cout << std::endl;
 
   if (planner_) {
     std::cout << "Total memory managed: " << planner_->total_managed()
               << " bytes" << std::endl;
+    std::cout << "Total memory reused: " << planner_->total_reused()
+              << " bytes" << std::endl;
   }
+  std::cout << "Allocations per iter: " << results.allocations_per_iter
+            << " (" << results.bytes_allocated_per_iter << " bytes)"
+            << std::endl;
   if (module_->opts.optimize_memory) {
     std::cout << "Total number of reused registers: " << module_->reused_regs
               << std::endl;
@@ -617,6 +847,9 @@ StaticRuntime::IndividualMetrics StaticRuntime::benchmark_individual_ops(
   }
 
   // main runs
+  auto allocations = std::make_shared<AllocationCounter>();
+  c10::DebugInfoGuard allocations_guard(
+      c10::DebugInfoKind::PROFILER_STATE, allocations);
   for (int i = 0; i < main_runs; i++) {
     if (planner_) {
       planner_->allocate();
@@ -643,18 +876,35 @@ StaticRuntime::IndividualMetrics StaticRuntime::benchmark_individual_ops(
     results.time_per_node[i] /= static_cast<float>(main_runs);
     results.time_per_node_type[kind] += results.time_per_node[i];
     results.instances_per_node_type[kind]++;
+    if (nodes_[i].has_out_variant()) {
+      results.out_nodes.insert(kind);
+      results.out_nodes_count++;
+    }
     results.total_time += results.time_per_node[i];
   }
+  results.total_nodes_count = nodes_.size();
   for (const auto& p : results.time_per_node_type) {
     const std::string& kind = p.first;
     results.percent_per_node_type[kind] = p.second / results.total_time * 100;
   }
+  if (planner_) {
+    results.managed_bytes = planner_->total_managed();
+    results.reused_bytes = planner_->total_reused();
+    results.reserved_bytes = planner_->total_reserved();
+    results.num_managed_tensors = planner_->num_managed();
+  }
+  results.allocations_per_iter =
+      allocations->count / static_cast<float>(main_runs);
+  results.bytes_allocated_per_iter =
+      allocations->bytes / static_cast<float>(main_runs);
   return results;
 }
 
 MemoryPlanner::MemoryPlanner(
     StaticRuntime* runtime,
-    std::unordered_map<Value*, std::vector<Value*>> should_share) {
+    std::unordered_map<Value*, std::vector<Value*>> should_share)
+    : runtime_(runtime),
+      signature_(compute_input_signature(runtime->inputs())) {
   // get input Value*
   at::ArrayRef<Value*> inputs =
       runtime->get_inference_module()->graph->inputs();
@@ -735,11 +985,9 @@ MemoryPlanner::MemoryPlanner(
         }
 
         if (shared.count(val)) {
-          managed_storage_[shared.at(val)].second.emplace_back(impl);
+          managed_storage_[shared.at(val)].emplace_back(impl);
         } else {
-          auto p =
-              std::make_pair<size_t, std::vector<c10::StorageImpl*>>(0, {impl});
-          managed_storage_.emplace_back(std::move(p));
+          managed_storage_.emplace_back(std::vector<c10::StorageImpl*>{impl});
           // first of a group, update the shared map with the index
           if (should_share.count(val)) {
             for (auto v : should_share.at(val)) {
@@ -764,21 +1012,55 @@ at::DataPtr MemoryPlanner::allocate_buffer(size_t size) {
   return allocator->allocate(size);
 }
 
+// Shapes, dtypes and int values of the inputs, which determine the sizes of
+// the managed tensors for most models.
+MemoryPlanner::InputSignature MemoryPlanner::compute_input_signature(
+    const std::vector<IValue>& inputs) {
+  InputSignature signature;
+  for (const auto& input : inputs) {
+    if (input.isTensor()) {
+      const auto& tensor = input.toTensor();
+      if (!tensor.defined()) {
+        signature.push_back(-1);
+        continue;
+      }
+      signature.push_back(static_cast<int64_t>(tensor.scalar_type()));
+      signature.push_back(tensor.dim());
+      signature.insert(
+          signature.end(), tensor.sizes().begin(), tensor.sizes().end());
+    } else if (input.isInt()) {
+      signature.push_back(-2);
+      signature.push_back(input.toInt());
+    } else {
+      signature.push_back(-3);
+    }
+  }
+  return signature;
+}
+
 void MemoryPlanner::allocate() {
-  if (managed_bytes_ == 0) {
+  signature_ = compute_input_signature(runtime_->inputs());
+  auto it = plans_.find(signature_);
+  const Plan* plan = it != plans_.end() ? &it->second : largest_plan_;
+  if (plan == nullptr || plan->total == 0) {
     return;
   }
-  buffer_ = allocate_buffer(managed_bytes_);
+  // the buffer is sized for the largest plan seen so far, so this only
+  // allocates when a plan outgrows all previous ones
+  if (buffer_size_ < plan->total) {
+    buffer_ = allocate_buffer(plan->total);
+    buffer_size_ = plan->total;
+  }
 
   size_t offset = 0;
   uint8_t* start = static_cast<uint8_t*>(buffer_.get());
-  for (const auto& ms : managed_storage_) {
-    auto tensor_size = ms.first;
+  for (size_t i = 0; i < managed_storage_.size(); ++i) {
+    auto tensor_size = plan->sizes[i];
     if (tensor_size == 0) {
       continue;
     }
-    const auto& impls = ms.second;
-    DCHECK_LE(offset + tensor_size, managed_bytes_);
+    const auto& impls = managed_storage_[i];
+    DCHECK_LE(offset + tensor_size, plan->total);
     void* src = static_cast<void*>(start + offset);
 
     for (auto& impl : impls) {
@@ -788,29 +1070,53 @@ void MemoryPlanner::allocate() {
 
     offset += tensor_size;
   }
-  DCHECK_EQ(offset, managed_bytes_);
+  DCHECK_EQ(offset, plan->total);
 }
 
 void MemoryPlanner::deallocate() {
-  managed_bytes_ = 0;
+  Plan current;
+  current.sizes.reserve(managed_storage_.size());
 
   // free memory used by outputs of ops in out variants
   // but keep the TensorImpl and StorageImpl around
-  for (auto& ms : managed_storage_) {
-    const auto& impls = ms.second;
+  size_t unshared_bytes = 0;
+  for (auto& impls : managed_storage_) {
     size_t max = 0;
     for (auto& impl : impls) {
       size_t current_size = compute_aligned_tensor_size(impl->nbytes());
       impl->reset();
       max = std::max(max, current_size);
+      unshared_bytes += current_size;
     }
-    ms.first = max;
-    managed_bytes_ += max;
+    current.sizes.push_back(max);
+    current.total += max;
   }
+  managed_bytes_ = current.total;
+  reused_bytes_ = unshared_bytes - current.total;
   for (auto& iv : unmanaged_values_) {
     *iv = IValue();
   }
-  buffer_ = {};
+
+  // Sizes of managed tensors can also depend on the values of the inputs, so
+  // the plan of a signature only ever grows. Once the cache is full, unseen
+  // signatures keep using the largest plan.
+  Plan* plan = nullptr;
+  auto it = plans_.find(signature_);
+  if (it != plans_.end()) {
+    plan = &it->second;
+    plan->total = 0;
+    for (size_t i = 0; i < current.sizes.size(); ++i) {
+      plan->sizes[i] = std::max(plan->sizes[i], current.sizes[i]);
+      plan->total += plan->sizes[i];
+    }
+  } else if (plans_.size() < kMaxCachedPlans) {
+    plan = &plans_.emplace(signature_, std::move(current)).first->second;
+  }
+  // pointers to elements of an unordered_map stay valid on rehashing
+  if (plan != nullptr &&
+      (largest_plan_ == nullptr || largest_plan_->total < plan->total)) {
+    largest_plan_ = plan;
+  }
 }
 
 ProcessedNode::ProcessedNode(
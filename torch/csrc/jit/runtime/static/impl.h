@@ -3,6 +3,7 @@
 #include <ATen/core/interned_strings.h>
 #include <ATen/core/ivalue.h>
 #include <c10/core/CPUAllocator.h>
+#include <c10/util/hash.h>
 #include <torch/csrc/jit/api/module.h>
 #include <torch/csrc/jit/ir/ir.h>
 #include <torch/csrc/jit/passes/constant_propagation.h>
@@ -13,6 +14,20 @@ namespace jit {
 
 struct TORCH_API InferenceModuleOptions {
   bool optimize_memory{true}; // TODO remove when logic moves to runtime
+  // partition the graph into regions of nodes that don't depend on each
+  // other, which StaticRuntime::run executes on the inter-op thread pool
+  bool enable_inter_op_parallelism{false};
+  // regions with fewer nodes, not counting prim ops, run on the calling thread
+  size_t inter_op_min_region_cost{10};
+};
+
+// Nodes run one after the other on one thread, as indices into the nodes of
+// the graph other than prim::Constant, i.e. into StaticRuntime::get_nodes().
+struct ParallelRegion {
+  std::vector<size_t> nodes;
+  // the regions of a step too cheap for the inter-op thread pool, which the
+  // calling thread runs
+  bool run_inline{false};
 };
 
 struct TORCH_API StaticRuntimeOptions {
@@ -58,6 +73,11 @@ struct TORCH_API StaticRuntimeOptions {
 ///   auto output = runtime->run(args, kwargs);
 ///   pool.push(runtime);
 /// @endcode
+/// In both modes, InferenceModuleOptions::enable_inter_op_parallelism also
+/// runs the independent regions of a graph, e.g. the towers of a ranking model
+/// joined by a cat, on the inter-op thread pool (at::launch). The managed
+/// tensors of concurrently running regions never share memory, since the
+/// MemoryPlanner gives each StorageImpl its own part of its buffer.
 ///
 
 // Group readonly data structures into InferenceModule
@@ -78,6 +98,10 @@ struct TORCH_API InferenceModule {
   std::vector<size_t> internals;
   size_t reused_regs = 0;
   InferenceModuleOptions opts;
+  // With opts.enable_inter_op_parallelism, all the nodes as steps that run one
+  // after the other. The regions of a step don't depend on each other and run
+  // concurrently. Empty otherwise.
+  std::vector<std::vector<ParallelRegion>> parallel_steps;
 
  private:
   void init();
@@ -139,6 +163,20 @@ class TORCH_API StaticRuntime {
     std::unordered_map<std::string, float> time_per_node_type;
     std::unordered_map<std::string, float> percent_per_node_type;
     std::unordered_map<std::string, int> instances_per_node_type;
+    // node types with an out variant, the others allocate their outputs
+    // outside of the MemoryPlanner
+    std::unordered_set<std::string> out_nodes;
+    int out_nodes_count{0};
+    int total_nodes_count{0};
+    // MemoryPlanner stats after the main runs, 0 without a MemoryPlanner
+    size_t managed_bytes{0};
+    size_t reused_bytes{0};
+    size_t reserved_bytes{0};
+    size_t num_managed_tensors{0};
+    // CPU allocations (and their bytes) made per iteration of the main runs,
+    // e.g. by ops without out variant
+    float allocations_per_iter{0};
+    float bytes_allocated_per_iter{0};
   };
 
   IndividualMetrics benchmark_individual_ops(
@@ -169,6 +207,14 @@ class TORCH_API StaticRuntime {
     return outputs_;
   }
 
+  const std::vector<IValue>& inputs() const {
+    return inputs_;
+  }
+
+  const MemoryPlanner* get_memory_planner() const {
+    return planner_.get();
+  }
+
  private:
   // Static runtime states
   std::shared_ptr<InferenceModule> module_;
@@ -192,6 +238,9 @@ class TORCH_API StaticRuntime {
     return inputs_[i];
   }
 
+  void run_region(const ParallelRegion& region);
+  void run_parallel_step(const std::vector<ParallelRegion>& step);
+
   // Output is readonly. The writing process happens inside ProcessedNodes
   const IValue& Output(size_t i) const {
     DCHECK(i < outputs_.size());
@@ -213,13 +262,17 @@ class TORCH_API StaticRuntime {
 /// tracking the unique StorageImpls of the output tensors of ops with _out
 /// variants. It tries to do this in several steps:
 ///   1. record the max memory usage for each StorageImpl at the end of each
-///      iteration
-///   2. in the next iteration, allocate the buffer for the max total usage and
+///      iteration, as the plan of the shapes of the inputs of that iteration
+///   2. in the next iteration, look up the plan of the input shapes and
 ///      compute the offset of each allocation with regard to the single memory
-///      buffer, optionally reusing memory.  In the first iteration, we rely on
-///      the default allocator for memory allocation.
-///   3. free the buffer at the end of each iteration
+///      buffer, optionally reusing memory. Input shapes that haven't been seen
+///      yet use the largest plan. In the first iteration, we rely on the
+///      default allocator for memory allocation.
+///   3. keep the buffer across iterations, and only grow it when a plan needs
+///      more memory than any plan before
 /// Steps 1 and 3 are handled by `deallocate()`, and step 2 by `allocate()`.
+/// Once every input shape of a workload has been seen, iterations make no
+/// allocator calls for managed tensors.
 /// Only models with simple output types are supported, i.e. None, Tensor or
 /// List/Tuple of Tensors. Complex output types such as List of Lists are not
 /// supported.
@@ -232,22 +285,56 @@ class MemoryPlanner {
 
   void allocate();
   void deallocate();
+  // bytes managed in the last iteration
   size_t total_managed() const {
     return managed_bytes_;
   }
+  // bytes saved in the last iteration by sharing storage between managed
+  // tensors whose lifetimes don't overlap
+  size_t total_reused() const {
+    return reused_bytes_;
+  }
+  // bytes of the buffer kept across iterations
+  size_t total_reserved() const {
+    return buffer_size_;
+  }
+  size_t num_managed() const {
+    return managed_storage_.size();
+  }
+  size_t num_cached_plans() const {
+    return plans_.size();
+  }
 
  private:
+  // the size (in bytes) of data to be allocated for each entry of
+  // managed_storage_, for one signature of input shapes
+  struct Plan {
+    std::vector<size_t> sizes;
+    size_t total{0};
+  };
+  using InputSignature = std::vector<int64_t>;
+  // enough for the distinct batch sizes of a typical inference workload
+  static constexpr size_t kMaxCachedPlans = 64;
+
+  const StaticRuntime* runtime_;
   std::vector<IValue*> unmanaged_values_;
-  // each pair contains the size (in bytes) of data to be allocated
-  // and a vector of StorageImpl's that should be backed by that same data
-  // Thus, if memonger is disabled, all vectors are of size 1.
-  std::vector<std::pair<size_t, std::vector<c10::StorageImpl*>>>
-      managed_storage_;
+  // each vector contains the StorageImpl's that should be backed by the same
+  // data. Thus, if memonger is disabled, all vectors are of size 1.
+  std::vector<std::vector<c10::StorageImpl*>> managed_storage_;
+  std::unordered_map<InputSignature, Plan, c10::hash<InputSignature>> plans_;
+  // plan with the largest total, used for unseen input shapes
+  const Plan* largest_plan_{nullptr};
+  // signature of the inputs of the current iteration
+  InputSignature signature_;
   size_t managed_bytes_{0};
-  at::DataPtr buffer_; // allocated each time we call Run()
+  size_t reused_bytes_{0};
+  at::DataPtr buffer_; // reused by all iterations
+  size_t buffer_size_{0};
 
   static size_t compute_aligned_tensor_size(size_t nbytes);
   static at::DataPtr allocate_buffer(size_t size);
+  static InputSignature compute_input_signature(
+      const std::vector<IValue>& inputs);
 };
 
 class ProcessedNode {
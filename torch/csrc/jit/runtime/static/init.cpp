@@ -24,7 +24,28 @@ void initStaticRuntimeBindings(PyObject* module) {
           &StaticRuntime::IndividualMetrics::percent_per_node_type)
       .def_readonly(
           "instances_per_node_type",
-          &StaticRuntime::IndividualMetrics::instances_per_node_type);
+          &StaticRuntime::IndividualMetrics::instances_per_node_type)
+      .def_readonly("out_nodes", &StaticRuntime::IndividualMetrics::out_nodes)
+      .def_readonly(
+          "out_nodes_count", &StaticRuntime::IndividualMetrics::out_nodes_count)
+      .def_readonly(
+          "total_nodes_count",
+          &StaticRuntime::IndividualMetrics::total_nodes_count)
+      .def_readonly(
+          "managed_bytes", &StaticRuntime::IndividualMetrics::managed_bytes)
+      .def_readonly(
+          "reused_bytes", &StaticRuntime::IndividualMetrics::reused_bytes)
+      .def_readonly(
+          "reserved_bytes", &StaticRuntime::IndividualMetrics::reserved_bytes)
+      .def_readonly(
+          "num_managed_tensors",
+          &StaticRuntime::IndividualMetrics::num_managed_tensors)
+      .def_readonly(
+          "allocations_per_iter",
+          &StaticRuntime::IndividualMetrics::allocations_per_iter)
+      .def_readonly(
+          "bytes_allocated_per_iter",
+          &StaticRuntime::IndividualMetrics::bytes_allocated_per_iter);
   static_runtime
       .def(
           "run",
@@ -6,6 +6,7 @@
 #include <ATen/TensorUtils.h>
 #include <ATen/native/quantized/cpu/qembeddingbag.h>
 #include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/runtime/custom_operator.h>
 #include <torch/csrc/jit/runtime/vararg_functions.h>
 
 namespace at {
@@ -105,10 +106,89 @@ C10_DEFINE_REGISTRY(SROperatorRegistry, SROperatorFunctor);
 // View ops with out variants are registered separately
 C10_DEFINE_REGISTRY(SRViewOperatorRegistry, SROperatorFunctor);
 
+namespace {
+// The overload of the op of n with the arguments of n followed by a kwarg-only
+// out Tensor, for ops that return a new Tensor. Covers the ATen ops with out=
+// overloads in native_functions.yaml that don't have a hand-written SROperator.
+std::shared_ptr<Operator> getGenericOutVariant(Node* n) {
+  const FunctionSchema* schema = n->maybeSchema();
+  if (!schema || schema->is_vararg() || schema->is_mutable() ||
+      schema->returns().size() != 1) {
+    return nullptr;
+  }
+  const Argument& ret = schema->returns()[0];
+  if (ret.alias_info() || ret.type()->kind() != TypeKind::TensorType) {
+    return nullptr;
+  }
+  const auto& args = schema->arguments();
+  for (const Argument& arg : args) {
+    if (arg.alias_info()) {
+      return nullptr;
+    }
+  }
+  for (const auto& op : getAllOperatorsFor(n->kind())) {
+    if (!op->isC10Op()) {
+      continue;
+    }
+    const FunctionSchema& out_schema = op->schema();
+    const auto& out_args = out_schema.arguments();
+    if (out_schema.is_vararg() || out_args.size() != args.size() + 1 ||
+        out_schema.returns().size() != 1) {
+      continue;
+    }
+    const Argument& out = out_args.back();
+    if (!out.kwarg_only() || !out.alias_info() ||
+        !out.alias_info()->isWrite() ||
+        out.type()->kind() != TypeKind::TensorType) {
+      continue;
+    }
+    bool same_args = true;
+    for (size_t i = 0; i < args.size() && same_args; i++) {
+      same_args = out_args[i].name() == args[i].name() &&
+          *out_args[i].type() == *args[i].type();
+    }
+    if (same_args) {
+      return op;
+    }
+  }
+  return nullptr;
+}
+
+bool hasGenericOutVariant(Node* n) {
+  return getGenericOutVariant(n) != nullptr;
+}
+
+// The first run calls the functional op, which gives the output its dtype and
+// device. Later runs resize that output to zero and pass it to the out variant,
+// so that it is backed by the memory of the MemoryPlanner.
+SROperator getGenericOutOperation(Node* n) {
+  Operation op = n->getOperator().getOperation(n);
+  Operation out_op = getGenericOutVariant(n)->getOperation();
+  return [op, out_op](ProcessedNode* p_node) {
+    std::vector<IValue> stack;
+    const size_t size = p_node->inputs().size();
+    stack.reserve(size + 1);
+    for (size_t i = 0; i < size; i++) {
+      stack.emplace_back(p_node->Input(i));
+    }
+    if (p_node->Output(0).isNone()) {
+      op(&stack);
+      DCHECK_EQ(stack.size(), 1);
+      p_node->Output(0) = std::move(stack[0]);
+      return;
+    }
+    auto& out_t = p_node->Output(0).toTensor();
+    fastResizeToZero(out_t);
+    stack.emplace_back(out_t);
+    out_op(&stack);
+  };
+}
+} // namespace
+
 bool canRunOutOfPlace(Node* n) {
   auto op_name = std::string(n->kind().toQualString());
   return SROperatorRegistry()->Has(op_name) ||
-      SRViewOperatorRegistry()->Has(op_name);
+      SRViewOperatorRegistry()->Has(op_name) || hasGenericOutVariant(n);
 }
 
 // The inputs/outputs of view ops do not participate in memory reuse
@@ -127,7 +207,7 @@ bool canReuseInputs(Node* n) {
   if (SROperatorRegistry()->Has(op_name)) {
     return SROperatorRegistry()->Create(op_name)->CanReuseInput();
   }
-  return false;
+  return !SRViewOperatorRegistry()->Has(op_name) && hasGenericOutVariant(n);
 }
 
 bool canReuseOutputs(Node* n) {
@@ -135,7 +215,7 @@ bool canReuseOutputs(Node* n) {
   if (SROperatorRegistry()->Has(op_name)) {
     return SROperatorRegistry()->Create(op_name)->CanReuseOutput();
   }
-  return false;
+  return !SRViewOperatorRegistry()->Has(op_name) && hasGenericOutVariant(n);
 }
 
 // TODO: expand to include all view producing ops, mostly in
@@ -264,6 +344,62 @@ REGISTER_OPERATOR_FUNCTOR(aten::cat, aten_cat, [](Node* n) -> SROperator {
     at::native::_cat_out_cpu(out_t, in0_tl, in1_i);
   };
 });
+namespace {
+// sizes of a tensor of the given sizes flattened from start_dim to end_dim
+std::vector<int64_t> flattenedSizes(
+    at::IntArrayRef sizes,
+    int64_t start_dim,
+    int64_t end_dim) {
+  start_dim = c10::maybe_wrap_dim(start_dim, sizes.size());
+  end_dim = c10::maybe_wrap_dim(end_dim, sizes.size());
+  TORCH_CHECK(
+      start_dim <= end_dim,
+      "flatten() has invalid args: start_dim cannot come after end_dim");
+  std::vector<int64_t> shape(sizes.begin(), sizes.begin() + start_dim);
+  shape.push_back(std::accumulate(
+      sizes.begin() + start_dim,
+      sizes.begin() + end_dim + 1,
+      static_cast<int64_t>(1),
+      std::multiplies<int64_t>()));
+  shape.insert(shape.end(), sizes.begin() + end_dim + 1, sizes.end());
+  return shape;
+}
+} // namespace
+
+// aten::flatten of the output of aten::cat, fused by FuseCatFlatten. The
+// output of cat is contiguous, so it is flattened in place instead of through
+// a view, which keeps it managed by the MemoryPlanner.
+RegisterOperators StaticRuntimeFusedOps({torch::jit::Operator(
+    "static_runtime::cat_flatten(Tensor[] tensors, int dim, int start_dim, int end_dim) -> Tensor",
+    [](Stack* stack) {
+      auto end_dim = pop(stack).toInt();
+      auto start_dim = pop(stack).toInt();
+      auto dim = pop(stack).toInt();
+      auto tensors = pop(stack).toTensorVector();
+      push(stack, at::cat(tensors, dim).flatten(start_dim, end_dim));
+    },
+    AliasAnalysisKind::FROM_SCHEMA)});
+
+REGISTER_OPERATOR_FUNCTOR(
+    static_runtime::cat_flatten,
+    static_runtime_cat_flatten,
+    [](Node* n) -> SROperator {
+      return [](ProcessedNode* p_node) {
+        auto in0_tl = p_node->Input(0).toTensorVector();
+        auto in1_i = p_node->Input(1).toInt();
+        auto in2_i = p_node->Input(2).toInt();
+        auto in3_i = p_node->Input(3).toInt();
+        if (p_node->Output(0).isNone()) {
+          p_node->Output(0) = create_empty_from(in0_tl[0]);
+        }
+        auto& out_t = p_node->Output(0).toTensor();
+        fastResizeToZero(out_t);
+        at::native::_cat_out_cpu(out_t, in0_tl, in1_i);
+        out_t.unsafeGetTensorImpl()->set_sizes_contiguous(
+            flattenedSizes(out_t.sizes(), in2_i, in3_i));
+      };
+    });
+
 REGISTER_OPERATOR_FUNCTOR(aten::tanh, aten_tanh, [](Node* n) -> SROperator {
   return [](ProcessedNode* p_node) {
     auto& in0_t = p_node->Input(0).toTensor();
@@ -504,6 +640,9 @@ std::function<void(ProcessedNode*)> getOutOfPlaceOperation(Node* n) {
   if (SRViewOperatorRegistry()->Has(op_name)) {
     return SRViewOperatorRegistry()->Create(op_name)->Generate(n);
   }
+  if (hasGenericOutVariant(n)) {
+    return getGenericOutOperation(n);
+  }
 
   return [](ProcessedNode*) { TORCH_CHECK(0); };
 }
@@ -1,5 +1,7 @@
 #include <torch/csrc/jit/runtime/static/passes.h>
 
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/ir/subgraph_matcher.h>
 #include <torch/csrc/jit/passes/subgraph_rewrite.h>
 
 namespace torch {
@@ -145,6 +147,49 @@ void ClipRangesGatherRangesSigridHash(
   fuse.runOnGraph(graph);
 }
 
+void FuseCatFlatten(std::shared_ptr<torch::jit::Graph>& graph) {
+  std::string pattern = R"IR(
+    graph(%a, %b, %c, %d):
+        %y0 : Tensor = aten::cat(%a, %b)
+        %res : Tensor = aten::flatten(%y0, %c, %d)
+        return (%res))IR";
+  std::string fused_pattern = R"IR(
+    graph(%a, %b, %c, %d):
+        %res : Tensor = static_runtime::cat_flatten(%a, %b, %c, %d)
+        return (%res))IR";
+  SubgraphRewriter fuse;
+  fuse.RegisterRewritePattern(pattern, fused_pattern);
+  fuse.runOnGraph(graph);
+}
+
+// aten::to followed by aten::contiguous copies at most once if the copy of
+// aten::to is contiguous, which gives the same result and leaves the input
+// alone if it already has the dtype and is contiguous.
+void FuseToContiguous(std::shared_ptr<torch::jit::Graph>& graph) {
+  std::string pattern = R"IR(
+    graph(%a, %b, %c, %d, %e, %f):
+        %y0 : Tensor = aten::to(%a, %b, %c, %d, %e)
+        %res : Tensor = aten::contiguous(%y0, %f)
+        return (%res))IR";
+  std::string fused_pattern = R"IR(
+    graph(%a, %b, %c, %d, %e, %f):
+        %res : Tensor = aten::to(%a, %b, %c, %d, %f)
+        return (%res))IR";
+  auto filter = [](const Match& match,
+                   const std::unordered_map<std::string, Value*>& vmap) {
+    // only the overload of aten::to with a dtype, since the other overloads
+    // with five arguments don't take a memory format
+    Value* dtype = match.values_map.at(vmap.at("b"));
+    auto format = toIValue(match.values_map.at(vmap.at("f")));
+    return dtype->type()->kind() == TypeKind::IntType && format &&
+        format->isInt() &&
+        format->toInt() == static_cast<int64_t>(c10::MemoryFormat::Contiguous);
+  };
+  SubgraphRewriter fuse;
+  fuse.RegisterRewritePattern(pattern, fused_pattern);
+  fuse.runOnGraph(graph, filter);
+}
+
 void FuseInferenceOpsForSparseNN(std::shared_ptr<torch::jit::Graph>& graph) {
 #ifdef FBCODE_CAFFE2
   ConcatAddMulReplaceNaNClip(graph);
@@ -4,6 +4,8 @@ namespace torch {
 namespace jit {
 
 void FuseInferenceOpsForSparseNN(std::shared_ptr<torch::jit::Graph>& graph);
+void FuseCatFlatten(std::shared_ptr<torch::jit::Graph>& graph);
+void FuseToContiguous(std::shared_ptr<torch::jit::Graph>& graph);
 
 } // namespace jit
 } // namespace torch
@@ -273,6 +273,19 @@ void tupleSlice(Stack& stack, size_t begin, size_t end) {
   push(stack, c10::ivalue::Tuple::create(std::move(output_elems)));
 }
 
+void tupleIndex(Stack& stack) {
+  int64_t index = pop(stack).toInt();
+  auto tuple = pop(stack).toTuple();
+  const auto size = static_cast<int64_t>(tuple->elements().size());
+  if (index < 0) {
+    index += size;
+  }
+  if (index < 0 || index >= size) {
+    throw std::out_of_range("Tuple list index out of range");
+  }
+  stack.emplace_back(tuple->elements()[index]);
+}
+
 void dequantize(Stack& stack) {
   auto iv = pop(stack);
   if (iv.isTuple()) {
@@ -39,6 +39,8 @@ void isinstance(Stack& stack, at::ArrayRef<at::TypePtr> types);
 
 void tupleSlice(Stack& stack, size_t begin, size_t end);
 
+void tupleIndex(Stack& stack);
+
 void dequantize(Stack& stack);
 
 } // namespace jit
@@ -19,6 +19,7 @@
 #include <onnx/proto_utils.h>
 
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 #include <c10/util/Optional.h>
 
 #include <fstream>
@@ -176,10 +177,18 @@ class EncoderBase {
       onnx_torch::OperatorExportTypes operator_export_type,
       bool strip_doc);
 
-  onnx::ModelProto get_model_proto() {
+  const onnx::ModelProto& get_model_proto() const {
     return model_proto_;
   }
 
+  // Moves the model out of the encoder, without copying the initializers it
+  // holds
+  std::shared_ptr<onnx::ModelProto> release_model_proto() {
+    auto model_proto = std::make_shared<onnx::ModelProto>();
+    model_proto->Swap(&model_proto_);
+    return model_proto;
+  }
+
   SymbolDimMap get_symbol_dim_param_map() {
     return symbol_dim_map_;
   }
@@ -584,6 +593,7 @@ void EncoderBase::AddInitializersIntoGraphProto(
     const std::string& onnx_file_path) {
   AT_ASSERT(block->inputs().size() >= initializers.size());
 
+  std::vector<std::pair<onnx::TensorProto*, const at::Tensor*>> encoded;
   for (auto input : block->inputs()) {
     auto name_tensor_pair = initializers.find(input->debugName());
     if (name_tensor_pair == initializers.end()) {
@@ -591,12 +601,26 @@ void EncoderBase::AddInitializersIntoGraphProto(
     }
     auto p = graph_proto->add_initializer();
     p->set_name(name_tensor_pair->first);
-    EncodeTensor(
-        p,
-        name_tensor_pair->second,
-        name_tensor_pair->first,
-        use_external_data_format,
-        onnx_file_path);
+    encoded.emplace_back(p, &name_tensor_pair->second);
+  }
+
+  auto encode = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      EncodeTensor(
+          encoded[i].first,
+          *encoded[i].second,
+          encoded[i].first->name(),
+          use_external_data_format,
+          onnx_file_path);
+    }
+  };
+  // With the external data format, each initializer is written to its own
+  // file and only touches its own TensorProto, so the large weights of a model
+  // are copied to the CPU and written in parallel.
+  if (use_external_data_format) {
+    at::parallel_for(0, encoded.size(), 1, encode);
+  } else {
+    encode(0, encoded.size());
   }
 }
 
@@ -939,8 +963,7 @@ export_onnx(
       "Please call torch.onnx.export with use_external_data_format=True.");
   GRAPH_DEBUG("onnx proto:", prettyPrint(graph_encoder.get_model_proto()));
   return std::make_tuple(
-      std::make_shared<::ONNX_NAMESPACE::ModelProto>(
-          graph_encoder.get_model_proto()),
+      graph_encoder.release_model_proto(),
       graph_encoder.get_raw_data_export_map(),
       graph_encoder.get_symbol_dim_param_map());
 }
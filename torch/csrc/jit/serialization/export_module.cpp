@@ -114,7 +114,11 @@ std::pair<IValue, c10::optional<IValue>> getFunctionTuple(
 
   Inline(*graph);
 
-  torch::jit::Code code(graph, func.name());
+  torch::jit::Code code(
+      graph,
+      func.name(),
+      /*remaining_bailout_depth=*/0,
+      /*emit_primitive_instructions=*/false);
   auto instructions_copy = code.instructions();
 
   // operator names
@@ -20,6 +20,7 @@
 #include <caffe2/serialize/istream_adapter.h>
 
 #include <ATen/ATen.h>
+#include <ATen/detail/CUDAHooksInterface.h>
 #include <fmt/format.h>
 
 #include <fstream>
@@ -83,6 +84,21 @@ IValue readArchiveAndTensors(
   };
 
   std::string archive_name_plus_slash = archive_name + "/";
+  if (getPrefetchTensorRecords()) {
+    std::vector<std::string> tensor_records;
+    for (const std::string& record : stream_reader.getAllRecords()) {
+      if (record.compare(
+              0, archive_name_plus_slash.size(), archive_name_plus_slash) ==
+          0) {
+        tensor_records.push_back(record);
+      }
+    }
+    c10::Allocator* allocator = nullptr;
+    if (device && device->is_cuda() && at::detail::getCUDAHooks().hasCUDA()) {
+      allocator = at::detail::getCUDAHooks().getPinnedMemoryAllocator();
+    }
+    stream_reader.prefetchRecords(tensor_records, allocator);
+  }
   auto read_record = [&](const std::string& name) {
     std::string ss = archive_name_plus_slash + name;
     return std::get<0>(stream_reader.getRecord(ss));
@@ -98,6 +114,17 @@ IValue readArchiveAndTensors(
   return unpickler.parse_ivalue();
 }
 
+static std::atomic<bool> lazy_method_compilation{false};
+static std::atomic<bool> prefetch_tensor_records{false};
+
+std::atomic<bool>& getLazyMethodCompilation() {
+  return lazy_method_compilation;
+}
+
+std::atomic<bool>& getPrefetchTensorRecords() {
+  return prefetch_tensor_records;
+}
+
 namespace {
 
 // This is a deserializer class which loads script modules from pt files.
@@ -112,14 +139,20 @@ class ScriptModuleDeserializer final {
       std::shared_ptr<PyTorchStreamReader> reader)
       : compilation_unit_(std::move(cu)),
         reader_(std::move(reader)),
+        constants_table_(std::make_shared<std::vector<at::IValue>>()),
         source_importer_(
             compilation_unit_,
-            &constants_table_,
-            [this](const std::string& qualifier) {
+            constants_table_.get(),
+            // Lazy methods may import types after the deserializer is gone,
+            // so the loader owns the archive and the constants they refer to.
+            [reader = reader_,
+             constants_table = constants_table_,
+             export_prefix = export_prefix_](const std::string& qualifier) {
               return findSourceInArchiveFromQualifier(
-                  *reader_, export_prefix_, qualifier);
+                  *reader, export_prefix, qualifier);
             },
-            reader_->version()) {}
+            reader_->version(),
+            getLazyMethodCompilation()) {}
 
   Module deserialize(
       c10::optional<at::Device> device,
@@ -131,9 +164,9 @@ class ScriptModuleDeserializer final {
   std::shared_ptr<CompilationUnit> compilation_unit_;
   std::shared_ptr<PyTorchStreamReader> reader_;
   c10::optional<at::Device> device_;
-  std::vector<at::IValue> constants_table_;
-  SourceImporter source_importer_;
   std::string export_prefix_ = "code/";
+  std::shared_ptr<std::vector<at::IValue>> constants_table_;
+  SourceImporter source_importer_;
 };
 
 IValue ScriptModuleDeserializer::readArchive(const std::string& archive_name) {
@@ -264,7 +297,7 @@ Module ScriptModuleDeserializer::deserialize(
   }
   auto tuple = readArchive("constants").toTuple();
   for (auto constant : tuple->elements()) {
-    constants_table_.push_back(constant.toIValue());
+    constants_table_->push_back(constant.toIValue());
   }
   auto m = Module(readArchive("data").toObject());
   rewriteQuantizedConvForBC(m);
@@ -5,6 +5,7 @@
 #include <torch/csrc/jit/ir/ir.h>
 #include <torch/csrc/jit/serialization/unpickler.h>
 
+#include <atomic>
 #include <istream>
 
 namespace caffe2 {
@@ -89,6 +90,23 @@ TORCH_API Module load(
     c10::optional<c10::Device> device,
     ExtraFilesMap& extra_files);
 
+/// If set, the methods of the modules and classes loaded by `load` and
+/// `import_ir_module` are compiled on their first call instead of during the
+/// load, which makes loading models with many methods faster when only some
+/// of them are run. Errors in the serialized code are then raised by the
+/// first call. `__init__` and forward hooks are still compiled at load, as
+/// is `__setstate__`, which the load runs. The archive stays open until the
+/// loaded module is destroyed. Off by default.
+TORCH_API std::atomic<bool>& getLazyMethodCompilation();
+
+/// Reads the tensor records of an archive at the start of its load, in the
+/// order of their offsets and with one read per run of adjacent records, see
+/// PyTorchStreamReader::prefetchRecords. Loads to a CUDA device prefetch into
+/// pinned memory, from which the tensors are copied asynchronously. The
+/// tensors of a run share their CPU memory, so it is only freed once all of
+/// them are. Off by default.
+TORCH_API std::atomic<bool>& getPrefetchTensorRecords();
+
 TORCH_API IValue readArchiveAndTensors(
     const std::string& archive_name,
     c10::optional<TypeResolver> type_resolver,
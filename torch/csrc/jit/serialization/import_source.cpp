@@ -96,8 +96,11 @@ struct SourceImporterImpl : public Resolver,
       std::shared_ptr<CompilationUnit> cu,
       const std::vector<at::IValue>* constant_table,
       SourceLoader source_loader,
-      size_t version)
-      : cu_(std::move(cu)), source_loader_(std::move(source_loader)) {
+      size_t version,
+      bool lazy_methods)
+      : cu_(std::move(cu)),
+        source_loader_(std::move(source_loader)),
+        lazy_methods_(lazy_methods) {
     env_ = {
         {"torch", std::make_shared<BuiltinModule>("aten", version)},
         {"ops", std::make_shared<OpsValue>(version)},
@@ -122,7 +125,7 @@ struct SourceImporterImpl : public Resolver,
       to_be_defined_.erase(it);
       importNamedType(name.prefix(), cd);
     }
-    return cu_->get_type(name);
+    return cu()->get_type(name);
   }
 
   Function* findFunction(const QualifiedName& name) {
@@ -133,7 +136,7 @@ struct SourceImporterImpl : public Resolver,
       to_be_defined_.erase(it);
       importFunction(name.prefix(), d);
     }
-    return cu_->find_function(name);
+    return cu()->find_function(name);
   }
 
   void parseSourceIfNeeded(const std::string& qualifier) {
@@ -196,7 +199,7 @@ struct SourceImporterImpl : public Resolver,
       definitions.emplace_back(def);
       resolvers.emplace_back(shared_from_this());
     }
-    cu_->define(
+    cu()->define(
         prefix,
         /*properties=*/{},
         /*propResolvers=*/{},
@@ -238,7 +241,7 @@ struct SourceImporterImpl : public Resolver,
   void importFunction(const std::string& qualifier, const Def& def) {
     std::vector<Def> definitions{def};
     std::vector<ResolverPtr> resolvers{shared_from_this()};
-    cu_->define(
+    cu()->define(
         qualifier,
         /*properties=*/{},
         /*propResolvers=*/{},
@@ -264,10 +267,10 @@ struct SourceImporterImpl : public Resolver,
       // ClassTypes)
       return importNamedTuple(qualified_name, class_def);
     } else if (superclass_name == "Interface") {
-      cu_->define_interface(
+      cu()->define_interface(
           qualified_name, class_def, shared_from_this(), /*is_module=*/false);
     } else if (superclass_name == "ModuleInterface") {
-      cu_->define_interface(
+      cu()->define_interface(
           qualified_name, class_def, shared_from_this(), /*is_module=*/true);
     } else if (superclass_name == "Enum") {
       importEnum(qualified_name, class_def);
@@ -364,7 +367,7 @@ struct SourceImporterImpl : public Resolver,
       }
     }
     auto class_type = ClassType::create(
-        c10::QualifiedName(qualified_classname), cu_, is_module);
+        c10::QualifiedName(qualified_classname), cu(), is_module);
 
     std::vector<Def> methods;
     std::vector<ResolverPtr> method_resolvers;
@@ -543,22 +546,26 @@ struct SourceImporterImpl : public Resolver,
           pre_hook_resolver_map.find(pre_hook_name)->second);
     }
 
-    cu_->register_type(class_type);
-    const auto self = SimpleSelf(class_type);
-    cu_->define(
+    cu()->register_type(class_type);
+    // Lazy methods refer to self until they are compiled.
+    selves_.push_back(torch::make_unique<SimpleSelf>(class_type));
+    const SimpleSelf* self = selves_.back().get();
+    cu()->define(
         qualified_classname,
         /*properties=*/{},
         /*propResolvers=*/{},
         methods,
         method_resolvers,
-        &self);
-    cu_->define_hooks(
+        self,
+        /*shouldMangle=*/false,
+        /*lazy=*/lazy_methods_);
+    cu()->define_hooks(
         qualified_classname,
         hooks,
         hook_resolvers,
         pre_hooks,
         pre_hook_resolvers,
-        &self);
+        self);
   }
 
   void importEnum(
@@ -620,8 +627,8 @@ struct SourceImporterImpl : public Resolver,
     }
 
     auto enum_type = EnumType::create(
-        qualified_name, std::move(value_type), std::move(names_values), cu_);
-    cu_->register_type(enum_type);
+        qualified_name, std::move(value_type), std::move(names_values), cu());
+    cu()->register_type(enum_type);
   }
 
   void importNamedTuple(
@@ -645,7 +652,7 @@ struct SourceImporterImpl : public Resolver,
     }
 
     auto tt = TupleType::createNamed(qualified_name, field_names, field_types);
-    cu_->register_type(tt);
+    cu()->register_type(tt);
   }
 
   void parsePossibleVersionNumber(Lexer& L) {
@@ -681,9 +688,20 @@ struct SourceImporterImpl : public Resolver,
     }
   }
 
-  std::shared_ptr<CompilationUnit> cu_;
+  std::shared_ptr<CompilationUnit> cu() const {
+    auto cu = cu_.lock();
+    TORCH_INTERNAL_ASSERT(cu, "importing into a destroyed CompilationUnit");
+    return cu;
+  }
+
+  // The CompilationUnit owns the lazy methods, which keep their resolver,
+  // this importer, alive until they are compiled, so it is held weakly.
+  std::weak_ptr<CompilationUnit> cu_;
   std::unordered_map<std::string, std::shared_ptr<SugaredValue>> env_;
   SourceLoader source_loader_;
+  // see SourceImporter
+  bool lazy_methods_;
+  std::vector<std::unique_ptr<SimpleSelf>> selves_;
   std::unordered_set<std::string> loaded_sources_;
   // named types and functions loaded from a file but not yet defined because
   // their type has not been requested yet.
@@ -720,12 +738,14 @@ SourceImporter::SourceImporter(
     std::shared_ptr<CompilationUnit> cu,
     const std::vector<IValue>* constant_table,
     SourceLoader loader,
-    size_t version)
+    size_t version,
+    bool lazy_methods)
     : pImpl(std::make_shared<SourceImporterImpl>(
           std::move(cu),
           constant_table,
           std::move(loader),
-          version)) {}
+          version,
+          lazy_methods)) {}
 
 TypePtr SourceImporter::loadType(const QualifiedName& name) const {
   ScriptTypeParser type_parser(pImpl);
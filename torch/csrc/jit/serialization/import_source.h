@@ -24,7 +24,11 @@ struct TORCH_API SourceImporter {
       std::shared_ptr<CompilationUnit> cu,
       const std::vector<at::IValue>* constant_table,
       SourceLoader loader,
-      size_t version);
+      size_t version,
+      // If true, the methods of the imported classes are compiled on first
+      // use rather than when the class is imported. The constant table and
+      // the loader then have to stay valid as long as the CompilationUnit.
+      bool lazy_methods = false);
 
   TypePtr loadType(const QualifiedName& name) const;
 
@@ -309,12 +309,17 @@ void Pickler::pushStorageOfTensor(const at::Tensor& tensor) {
 }
 
 void Pickler::pushBytes(const std::string& string) {
-  static const size_t kSmallStr = 32;
-  if (string.size() <= kSmallStr &&
-      bufferPos_ + string.size() <= buffer_.size()) {
-    // Small string that fits: buffer the data.
+  static const size_t kSmallStr = kBufferSize / 4;
+  if (bufferPos_ + string.size() <= buffer_.size()) {
+    // String that fits: buffer the data.
     memcpy(buffer_.data() + bufferPos_, string.data(), string.size());
     bufferPos_ += string.size();
+  } else if (string.size() <= kSmallStr) {
+    // Small string that doesn't fit (so the buffer isn't empty): flush, then
+    // buffer the data.
+    flushNonEmpty();
+    memcpy(buffer_.data(), string.data(), string.size());
+    bufferPos_ = string.size();
   } else {
     // Otherwise, first flush, then write directly.
     flush();
@@ -210,7 +210,7 @@ class TORCH_API Pickler {
   // the left of a '::', its type cannot be deduced by the compiler so one must
   // explicitly instantiate the template, i.e. push<int>(int) works, push(int)
   // does not)
-  static CONSTEXPR_EXCEPT_WIN_CUDA size_t kBufferSize = 256;
+  static CONSTEXPR_EXCEPT_WIN_CUDA size_t kBufferSize = 4096;
   template <typename T>
   void push(typename std::common_type<T>::type value) {
     const char* begin = reinterpret_cast<const char*>(&value);
@@ -226,7 +226,9 @@ class TORCH_API Pickler {
   // Code shouldn't call writer_ directly without first flush()ing.
   std::function<void(const char*, size_t)> writer_;
 
-  // Buffer to avoid calling a writer_ on a per-byte basis.
+  // Buffer to avoid calling a writer_ on a per-byte basis. Large enough that
+  // the opcodes of a big archive (e.g. the constants of a torch.jit.save()d
+  // model) take few calls, while strings larger than it are written directly.
   std::array<char, kBufferSize> buffer_;
   size_t bufferPos_{0};
 
@@ -435,7 +435,11 @@ PickleOpCode Unpickler::readInstruction() {
 
       if (device.type() == DeviceType::CUDA ||
           device.type() == DeviceType::XPU) {
-        tensor = tensor.to(device, tensor.scalar_type());
+        // records prefetched into pinned memory are copied asynchronously
+        tensor = tensor.to(
+            device,
+            tensor.scalar_type(),
+            /*non_blocking=*/device.is_cuda() && tensor.is_pinned());
       } else if (device.type() != DeviceType::CPU) {
         AT_ERROR(
             "supported devices include CPU and CUDA, however got ",
@@ -1,6 +1,7 @@
 #include <torch/csrc/jit/tensorexpr/kernel.h>
 
 #include <ATen/ExpandUtils.h>
+#include <ATen/Parallel.h>
 #include <ATen/TensorGeometry.h>
 #include <c10/util/string_utils.h>
 #include <torch/csrc/jit/jit_log.h>
@@ -10,6 +11,12 @@
 #include <torch/csrc/jit/tensorexpr/ir_simplifier.h>
 #include <torch/csrc/jit/tensorexpr/loopnest.h>
 
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+
 using namespace torch::jit;
 using namespace torch::jit::tensorexpr;
 
@@ -23,6 +30,14 @@ static int te_cuda_pointwise_block_size = -1;
 static bool fallback_allowed = false;
 static bool te_generate_block_code = false;
 static bool te_must_use_llvm_on_cpu = false;
+static bool te_tune_cpu_kernels = []() {
+  const char* enable_c_str = std::getenv("PYTORCH_TENSOREXPR_TUNE");
+  return enable_c_str && std::string(enable_c_str) == "1";
+}();
+static std::string te_tuning_database_path = []() -> std::string {
+  const char* path_c_str = std::getenv("PYTORCH_TENSOREXPR_TUNING_DB");
+  return path_c_str ? path_c_str : "";
+}();
 
 bool setFallbackAllowed(bool value) {
   bool old_value = fallback_allowed;
@@ -87,6 +102,119 @@ bool& getTEMustUseLLVMOnCPU() {
   return te_must_use_llvm_on_cpu;
 }
 
+bool& getTETuneCPUKernels() {
+  return te_tune_cpu_kernels;
+}
+
+std::string& getTETuningDatabasePath() {
+  return te_tuning_database_path;
+}
+
+std::string CPUSchedule::toString() const {
+  std::ostringstream oss;
+  oss << "inlining=" << inlining << " flatten=" << flatten
+      << " vector_width=" << vectorWidth;
+  return oss.str();
+}
+
+namespace {
+
+// Note [Tuning of CPU kernels]
+// The default CPU schedule, which inlines the intermediate buffers whose
+// computation is not duplicated and vectorizes inner loops by 8, is far from
+// the best for some kernels, e.g. reductions of broadcasts, or outputs with a
+// small innermost dim. When getTETuneCPUKernels() is set, compile() generates
+// the kernel with every candidate CPUSchedule, times each on inputs of the
+// profiled sizes, and keeps the fastest.
+//
+// The winners are kept in a tuning database keyed by a hash of the subgraph,
+// whose types hold the sizes, strides and dtypes of the inputs, so that a
+// subgraph is tuned once per process. When getTETuningDatabasePath() is set,
+// the database is also read from and appended to that file, so that later
+// processes on the same machine use the schedules tuned there, whether
+// tuning is enabled in them or not.
+class TuningDatabase {
+ public:
+  static TuningDatabase& get() {
+    static TuningDatabase db;
+    return db;
+  }
+
+  c10::optional<CPUSchedule> lookup(size_t key) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    load();
+    auto it = schedules_.find(key);
+    if (it == schedules_.end()) {
+      return c10::nullopt;
+    }
+    return it->second;
+  }
+
+  void insert(size_t key, const CPUSchedule& schedule) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    load();
+    schedules_[key] = schedule;
+    if (!path_.empty()) {
+      std::ofstream file(path_, std::ios::app);
+      file << key << " " << schedule.inlining << " " << schedule.flatten << " "
+           << schedule.vectorWidth << "\n";
+    }
+  }
+
+ private:
+  // Reads the file of the database, once per path.
+  void load() {
+    const std::string& path = getTETuningDatabasePath();
+    if (path == path_) {
+      return;
+    }
+    path_ = path;
+    schedules_.clear();
+    std::ifstream file(path_);
+    size_t key = 0;
+    int inlining = 0;
+    CPUSchedule schedule;
+    while (file >> key >> inlining >> schedule.flatten >>
+           schedule.vectorWidth) {
+      schedule.inlining = static_cast<CPUSchedule::Inlining>(inlining);
+      schedules_[key] = schedule;
+    }
+  }
+
+  std::mutex mutex_;
+  std::string path_;
+  std::unordered_map<size_t, CPUSchedule> schedules_;
+};
+
+std::vector<CPUSchedule> cpuScheduleCandidates(bool hasReduction) {
+  // The default schedule comes first, so that it wins ties.
+  std::vector<CPUSchedule> candidates;
+  for (auto inlining :
+       {CPUSchedule::kInlineWithoutDuplicatedWork,
+        CPUSchedule::kInlineAll,
+        CPUSchedule::kNoInlining}) {
+    if (hasReduction) {
+      CPUSchedule schedule;
+      schedule.inlining = inlining;
+      schedule.vectorWidth = 0;
+      candidates.push_back(schedule);
+      continue;
+    }
+    for (bool flatten : {false, true}) {
+      for (int vectorWidth : {8, 4, 16, 0}) {
+        CPUSchedule schedule;
+        schedule.inlining = inlining;
+        schedule.flatten = flatten;
+        schedule.vectorWidth = vectorWidth;
+        candidates.push_back(schedule);
+      }
+    }
+  }
+  return candidates;
+}
+
+} // namespace
+
 c10::optional<at::Device> pickDeviceType(
     const at::ArrayRef<torch::jit::Value*>& inputs) {
   c10::optional<at::Device> device = c10::nullopt;
@@ -102,6 +230,33 @@ c10::optional<at::Device> pickDeviceType(
   return device;
 }
 
+// Note [Fused matmuls]
+// A matmul in a fusion group saves the launch of the BLAS call and the
+// round trips of its operands and result through memory, since the ops around
+// it are computed in the same loops. The loops are much slower than the BLAS
+// kernels though, so only small matmuls are fused, and the others stay
+// external calls outside of the fusion groups.
+//
+// On CPU the matmul is a reduction, whose producers are inlined. On CUDA the
+// codegen can't synchronize a reduction with its consumers across blocks, so
+// the sum over k is unrolled into a pointwise expression instead, which is
+// inlined into the epilogue as any other pointwise op. Only matmuls with a
+// short reduction dimension are fused there, for which each thread computing
+// its outputs beats cuBLAS and the separate epilogue kernels.
+bool isFusibleMatmul(
+    const at::Device& device,
+    int64_t m,
+    int64_t n,
+    int64_t k) {
+  if (device.is_cuda()) {
+    constexpr int64_t kMaxUnrolledK = 16;
+    constexpr int64_t kMaxCudaOutputSize = 1 << 20;
+    return k <= kMaxUnrolledK && m * n <= kMaxCudaOutputSize;
+  }
+  constexpr int64_t kMaxCpuSize = 1 << 16;
+  return m * n * k <= kMaxCpuSize;
+}
+
 } // namespace tensorexpr
 } // namespace jit
 } // namespace torch
@@ -346,6 +501,12 @@ std::vector<ExprHandle> TensorExprKernel::inferSizesForValue(
       return shape;
     }
 
+    case aten::mm:
+    case aten::matmul: {
+      auto const& n = v->node();
+      return {sizesForValue(n->input(0))[0], sizesForValue(n->input(1))[1]};
+    }
+
     case aten::unsqueeze: {
       auto const& n = v->node();
       auto shape = sizesForValue(n->input(0));
@@ -1504,6 +1665,11 @@ Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
       return computeSum(v);
     }
 
+    case aten::mm:
+    case aten::matmul: {
+      return computeMatmul(v);
+    }
+
     case aten::softmax: {
       return computeSoftmax(v, false);
     }
@@ -1518,7 +1684,9 @@ Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
   }
 }
 
-Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
+Stmt* TensorExprKernel::generateStmt(
+    BackendType backendType,
+    const CPUSchedule& schedule) {
   torch::jit::tensorexpr::LoopNest l(tensorOutputs_);
   GRAPH_DEBUG("Original Stmt:\n", std::to_string(l.root_stmt()), "\n");
 
@@ -1539,7 +1707,50 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
   // difficult synchronization logic across blocks.
   bool allow_duplicated_work =
       (backendType == kCudaCodeGen || backendType == kBlockCodeGen);
-  l.inlineIntermediateBufs(allow_duplicated_work);
+  if (backendType != kLLVMCodeGen) {
+    l.inlineIntermediateBufs(allow_duplicated_work);
+  } else if (schedule.inlining != CPUSchedule::kNoInlining) {
+    l.inlineIntermediateBufs(schedule.inlining == CPUSchedule::kInlineAll);
+  }
+
+  if (backendType == kLLVMCodeGen && schedule.flatten && !hasReduction) {
+    for (auto tensor : tensorOutputs_) {
+      std::vector<For*> loops = l.getLoopStmtsFor(tensor);
+      if (!loops.empty()) {
+        For* flattened = nullptr;
+        LoopNest::flatten(loops, &flattened);
+      }
+    }
+  }
+
+  // Run the outer loop of the large outputs on the intra-op thread pool, as
+  // the ATen kernels do. Outputs without dims (full reductions) stay
+  // sequential, their single loop is over a reduction axis.
+  if (backendType == kLLVMCodeGen && at::get_num_threads() > 1) {
+    for (auto tensor : tensorOutputs_) {
+      std::vector<For*> loops = l.getLoopStmtsFor(tensor);
+      if (loops.empty() || tensor->buf()->ndim() == 0) {
+        continue;
+      }
+      int64_t numel = 1;
+      for (const Expr* dim : tensor->buf()->dims()) {
+        auto dim_imm = dynamic_cast<const IntImm*>(dim);
+        numel = dim_imm ? numel * dim_imm->value() : 0;
+      }
+      if (numel < at::internal::GRAIN_SIZE) {
+        continue;
+      }
+      For* parallel = loops[0];
+      if (loops.size() == 1) {
+        // Split the loop into chunks, the inner loop of which is vectorized
+        const int kParallelChunkSize = 4096;
+        For* inner = nullptr;
+        For* tail = nullptr;
+        l.splitWithTail(loops[0], kParallelChunkSize, &parallel, &inner, &tail);
+      }
+      l.parallelize(parallel);
+    }
+  }
 
   if (backendType == kCudaCodeGen) {
     for (auto tensor : tensorOutputs_) {
@@ -1612,8 +1823,9 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
 
   l.prepareForCodegen();
 
-  if (backendType == kLLVMCodeGen && !hasReduction) {
-    l.vectorizeInnerLoops();
+  if (backendType == kLLVMCodeGen && !hasReduction &&
+      schedule.vectorWidth > 0) {
+    l.vectorizeInnerLoops(schedule.vectorWidth);
   }
 
   Stmt* stmt = l.root_stmt();
@@ -1623,6 +1835,75 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
   return stmt;
 }
 
+std::vector<IValue> TensorExprKernel::makeTuningInputs() {
+  std::vector<IValue> inputs;
+  for (auto const& input : graph_->inputs()) {
+    const auto& type = input->type();
+    if (auto tt = type->cast<TensorType>()) {
+      // Ones, so that integer divisions by the inputs are defined.
+      inputs.emplace_back(at::empty_strided(
+                              *tt->sizes().concrete_sizes(),
+                              *tt->strides().concrete_sizes(),
+                              c10::TensorOptions(*tt->scalarType())
+                                  .device(device_))
+                              .fill_(1));
+    } else if (type->kind() == TypeKind::FloatType) {
+      inputs.emplace_back(1.0);
+    } else if (type->kind() == TypeKind::BoolType) {
+      inputs.emplace_back(true);
+    } else {
+      inputs.emplace_back(static_cast<int64_t>(1));
+    }
+  }
+  return inputs;
+}
+
+CPUSchedule TensorExprKernel::tuneCPUSchedule(
+    BackendType backendType,
+    const std::vector<CodeGen::BufferArg>& params) {
+  constexpr int kTuningRuns = 10;
+  bool hasReduction =
+      NodeFinder<ReduceOp>::find(LoopNest(tensorOutputs_).root_stmt()).size() !=
+      0;
+  std::vector<IValue> inputs = makeTuningInputs();
+
+  CPUSchedule best;
+  double best_time = std::numeric_limits<double>::infinity();
+  for (auto const& candidate : cpuScheduleCandidates(hasReduction)) {
+    double time = std::numeric_limits<double>::infinity();
+    try {
+      codegen_ = CreateCodeGen(
+          getCodeGenName(backendType),
+          generateStmt(backendType, candidate),
+          params,
+          device_,
+          SubgraphUtils::generateNameForGraph(graph_));
+      std::vector<at::Tensor> outputs;
+      std::vector<CodeGen::CallArg> runArgs = prepareRunArgs(inputs, outputs);
+      // The first call warms up the caches.
+      codegen_->call(runArgs);
+      for (int i = 0; i < kTuningRuns; i++) {
+        auto start = std::chrono::steady_clock::now();
+        codegen_->call(runArgs);
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        time = std::min(time, elapsed.count());
+      }
+    } catch (const std::exception& e) {
+      GRAPH_DEBUG(
+          "Schedule ", candidate.toString(), " is not supported: ", e.what());
+      continue;
+    }
+    GRAPH_DEBUG("Schedule ", candidate.toString(), " ran in ", time, "s");
+    if (time < best_time) {
+      best = candidate;
+      best_time = time;
+    }
+  }
+  codegen_ = nullptr;
+  return best;
+}
+
 std::string TensorExprKernel::getCodeGenName(BackendType backendType) {
   switch (backendType) {
     case kCudaCodeGen:
@@ -1794,6 +2075,49 @@ Tensor* TensorExprKernel::computeSum(const torch::jit::Value* v) {
       reduction_info.reductionDims);
 }
 
+Tensor* TensorExprKernel::computeMatmul(const torch::jit::Value* v) {
+  // The fuser only lets 2-D matmuls with static sizes in
+  auto const& n = v->node();
+  auto const& a = n->input(0);
+  auto const& b = n->input(1);
+  auto sizes_a = sizesForValue(a);
+  auto sizes_b = sizesForValue(b);
+  if (sizes_a.size() != 2 || sizes_b.size() != 2) {
+    throw malformed_input("aten::matmul only supports 2-D operands");
+  }
+  auto const& k = sizes_a[1];
+
+  if (!device_.is_cuda()) {
+    return Reduce(
+        "aten_matmul",
+        dimsFromSizes(sizesForValue(v)),
+        Sum(),
+        [&](ParameterList& indices) {
+          return tensorOrConstant(a, {indices[0], indices[2]}) *
+              tensorOrConstant(b, {indices[2], indices[1]});
+        },
+        {DimArg(k, "k")});
+  }
+
+  // See Note [Fused matmuls]
+  auto const* k_imm = k.AsNode<IntImm>();
+  if (!k_imm) {
+    throw malformed_input("aten::matmul needs a static reduction size on CUDA");
+  }
+  int64_t k_size = k_imm->value();
+  return Compute(
+      "aten_matmul",
+      dimsFromSizes(sizesForValue(v)),
+      [&](const VarHandle& i, const VarHandle& j) {
+        ExprHandle sum =
+            tensorOrConstant(a, {i, 0}) * tensorOrConstant(b, {0, j});
+        for (int64_t r = 1; r < k_size; ++r) {
+          sum = sum + tensorOrConstant(a, {i, r}) * tensorOrConstant(b, {r, j});
+        }
+        return sum;
+      });
+}
+
 Tensor* TensorExprKernel::computeSoftmax(
     const torch::jit::Value* v,
     bool log_softmax) {
@@ -2091,6 +2415,8 @@ void TensorExprKernel::compile() {
     inputTypes_.push_back(input->type());
   }
 
+  device_ = *pickDeviceType(graph_->inputs());
+
   // Bind nodes to tensor compute expressions.
   for (auto const& n : graph_->nodes()) {
     if (n->kind() == prim::Constant || n->kind() == prim::ListConstruct) {
@@ -2108,8 +2434,6 @@ void TensorExprKernel::compile() {
     }
   }
 
-  device_ = *pickDeviceType(graph_->inputs());
-
   // Move output operands from `tensors_` to `tensorOutputs_`
   for (const auto& output : graph_->outputs()) {
     if (!tensors_.count(output->unique())) {
@@ -2141,10 +2465,25 @@ void TensorExprKernel::compile() {
   }
 
   BackendType backendType = inferBackendTypeFromDevice(device_);
-  Stmt* stmt = generateStmt(backendType);
   // Set up formal params (inputs, then outputs) for kernel.
   std::vector<CodeGen::BufferArg> params = prepareBufferArgs();
 
+  // Pick the schedule of CPU kernels, see Note [Tuning of CPU kernels].
+  CPUSchedule schedule;
+  if (backendType == kLLVMCodeGen &&
+      (getTETuneCPUKernels() || !getTETuningDatabasePath().empty())) {
+    size_t key = std::hash<std::string>()(graph_->toString());
+    auto tuned = TuningDatabase::get().lookup(key);
+    if (tuned) {
+      schedule = *tuned;
+    } else if (getTETuneCPUKernels()) {
+      schedule = tuneCPUSchedule(backendType, params);
+      TuningDatabase::get().insert(key, schedule);
+    }
+    GRAPH_DEBUG("CPU schedule: ", schedule.toString());
+  }
+  Stmt* stmt = generateStmt(backendType, schedule);
+
   // Generate code.
   codegen_ = CreateCodeGen(
       getCodeGenName(backendType),
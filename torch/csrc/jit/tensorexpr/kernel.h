@@ -19,6 +19,27 @@ inline std::vector<int64_t> bufferSizes(const T& t) {
   return sizes;
 }
 
+// The decisions of the schedule of a kernel on CPU that are searched when
+// tuning it, see Note [Tuning of CPU kernels]. The default schedule is the one
+// used without tuning.
+struct CPUSchedule {
+  enum Inlining {
+    kNoInlining,
+    kInlineWithoutDuplicatedWork,
+    kInlineAll,
+  };
+
+  Inlining inlining = kInlineWithoutDuplicatedWork;
+  // Whether to flatten the loops of every output into one loop before
+  // vectorization, which matters when the innermost dims are small.
+  bool flatten = false;
+  // The vector width of the inner loops, 0 to not vectorize them. Kernels with
+  // reductions are never vectorized.
+  int vectorWidth = 8;
+
+  std::string toString() const;
+};
+
 class TORCH_API TensorExprKernel {
  public:
   explicit TensorExprKernel(const std::shared_ptr<Graph>& subgraph);
@@ -137,13 +158,24 @@ class TORCH_API TensorExprKernel {
 
   Tensor* computeSum(const torch::jit::Value* v);
 
+  Tensor* computeMatmul(const torch::jit::Value* v);
+
   Tensor* computeSoftmax(const torch::jit::Value* v, bool log_softmax);
 
   Tensor* computeValue(const torch::jit::Value* v);
 
-  Stmt* generateStmt(BackendType backendType);
+  Stmt* generateStmt(
+      BackendType backendType,
+      const CPUSchedule& schedule = CPUSchedule());
   std::vector<CodeGen::BufferArg> prepareBufferArgs();
 
+  // Returns the fastest of the candidate schedules of the kernel on inputs
+  // made by makeTuningInputs().
+  CPUSchedule tuneCPUSchedule(
+      BackendType backendType,
+      const std::vector<CodeGen::BufferArg>& params);
+  std::vector<IValue> makeTuningInputs();
+
   std::string getCodeGenName(BackendType backendType);
 
   std::vector<CodeGen::CallArg> prepareRunArgs(
@@ -245,12 +277,23 @@ TORCH_API int& getTECudaPointwiseBlockCount();
 TORCH_API int& getTECudaPointwiseBlockSize();
 TORCH_API bool& getTEGenerateBlockCode();
 TORCH_API bool& getTEMustUseLLVMOnCPU();
+TORCH_API bool& getTETuneCPUKernels();
+TORCH_API std::string& getTETuningDatabasePath();
 TORCH_API bool fallbackAllowed();
 TORCH_API bool setFallbackAllowed(bool value);
 
 TORCH_API c10::optional<at::Device> pickDeviceType(
     const at::ArrayRef<torch::jit::Value*>& inputs);
 
+// Whether the generated loops of a (m x k) by (k x n) matmul are expected to
+// beat the external BLAS call, once its prologue and epilogue are fused into
+// them (see Note [Fused matmuls])
+TORCH_API bool isFusibleMatmul(
+    const at::Device& device,
+    int64_t m,
+    int64_t n,
+    int64_t k);
+
 } // namespace tensorexpr
 } // namespace jit
 } // namespace torch
@@ -5,7 +5,11 @@
 #include <c10/util/Exception.h>
 #include <torch/csrc/jit/tensorexpr/llvm_jit.h>
 
+#include <cstdio>
+#include <fstream>
 #include <memory>
+#include <random>
+#include <sstream>
 
 #include <llvm/Analysis/TargetTransformInfo.h>
 #include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
@@ -14,6 +18,7 @@
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/MC/MCSubtargetInfo.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/Host.h>
 #include <llvm/Support/TargetSelect.h>
 
@@ -31,10 +36,12 @@
 #include <llvm/Support/TypeSize.h>
 #endif
 
+#include <torch/csrc/jit/tensorexpr/analysis.h>
 #include <torch/csrc/jit/tensorexpr/execution_counter.h>
 #include <torch/csrc/jit/tensorexpr/expr.h>
 #include <torch/csrc/jit/tensorexpr/external_functions_registry.h>
 #include <torch/csrc/jit/tensorexpr/half_support.h>
+#include <torch/csrc/jit/tensorexpr/hash_provider.h>
 #include <torch/csrc/jit/tensorexpr/ir.h>
 #include <torch/csrc/jit/tensorexpr/ir_printer.h>
 #include <torch/csrc/jit/tensorexpr/tensor.h>
@@ -51,10 +58,20 @@ C10_DEFINE_bool(
 
 DEFINE_TRIGGER(llvm_codegen_created);
 DEFINE_TRIGGER(llvm_codegen_executed);
+DEFINE_TRIGGER(llvm_codegen_cache_hit);
 
 namespace torch {
 namespace jit {
 namespace tensorexpr {
+
+std::string& getLLVMKernelCacheDir() {
+  static std::string cache_dir = []() -> std::string {
+    const char* dir = std::getenv("PYTORCH_TENSOREXPR_LLVM_CACHE_DIR");
+    return dir ? dir : "";
+  }();
+  return cache_dir;
+}
+
 namespace {
 
 llvm::CmpInst::Predicate llvm_comparison_predicate(
@@ -99,6 +116,98 @@ llvm::ElementCount ElementCount(int lanes) {
 }
 #endif
 
+// Note [LLVM kernel cache]
+// Compiling a kernel takes milliseconds, mostly spent in the optimization and
+// code generation passes, and every process running the same model compiles
+// the same kernels again. When getLLVMKernelCacheDir() is set, the object code
+// of every kernel compiled is written to a file of that directory, and the
+// LLVMCodeGen of the same kernel in any later process loads it instead of
+// compiling the kernel.
+//
+// The key of a kernel is its statement as printed before code generation, its
+// arguments and return type, and everything else the object code depends on:
+// the LLVM version, the target triple, CPU and features of the host, and
+// FLAGS_torch_jit_llvm_use_fast_intrinsics. The file name is made of the
+// structural hash of the statement combined with a hash of the key, and the
+// file starts with the key itself, which is compared on load so that a
+// collision of the hashes is a miss. Files are written to a temporary name and
+// renamed, so that a process never reads a file being written by another one.
+std::string kernelCacheKey(
+    Stmt* stmt,
+    const std::vector<CodeGen::BufferArg>& args,
+    Dtype dtype,
+    llvm::TargetMachine& TM) {
+  std::ostringstream key;
+  key << "llvm " << LLVM_VERSION_STRING << "\n";
+  key << "target " << TM.getTargetTriple().str() << " "
+      << TM.getTargetCPU().str() << " " << TM.getTargetFeatureString().str()
+      << "\n";
+  key << "fast_intrinsics " << FLAGS_torch_jit_llvm_use_fast_intrinsics
+      << "\n";
+  key << "dtype " << dtype << "\n";
+  // The arguments and the statement are printed by the same printer, so that
+  // the names of their vars agree.
+  IRPrinter printer(key);
+  for (auto const& arg : args) {
+    printer.os() << (arg.isVar() ? "var " : "buf ") << arg.dtype() << " "
+                 << *arg.var() << "\n";
+  }
+  printer.print(*stmt);
+  return key.str();
+}
+
+std::string kernelCachePath(
+    const std::string& dir,
+    Stmt* stmt,
+    const std::string& key) {
+  HashProvider hasher;
+  SimplifierHashType hash = hasher.hash_combine(hasher.hash(stmt), key);
+  std::ostringstream path;
+  path << dir << "/llvm_kernel_" << std::hex << hash._h << ".o";
+  return path.str();
+}
+
+std::unique_ptr<llvm::MemoryBuffer> loadCachedKernel(
+    const std::string& path,
+    const std::string& key) {
+  auto file = llvm::MemoryBuffer::getFile(path);
+  if (!file) {
+    return nullptr;
+  }
+  llvm::StringRef contents = (*file)->getBuffer();
+  if (contents.size() <= key.size() || !contents.startswith(key) ||
+      contents[key.size()] != '\0') {
+    return nullptr;
+  }
+  return llvm::MemoryBuffer::getMemBufferCopy(
+      contents.drop_front(key.size() + 1), path);
+}
+
+void storeCachedKernel(
+    const std::string& path,
+    const std::string& key,
+    llvm::StringRef object) {
+  const std::string tmp_path =
+      path + ".tmp" + std::to_string(std::random_device()());
+  {
+    std::ofstream file(tmp_path, std::ios::binary);
+    file.write(key.data(), key.size());
+    file.put('\0');
+    file.write(object.data(), object.size());
+    if (!file) {
+      GRAPH_DEBUG("Failed to write kernel cache file ", tmp_path);
+      file.close();
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  // Another process may have stored the same kernel meanwhile, either file is
+  // fine.
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  }
+}
+
 } // namespace
 
 class LLVMCodeGenImpl : public IRVisitor {
@@ -192,6 +301,7 @@ class LLVMCodeGenImpl : public IRVisitor {
   void visit(const ExternalCall* v) override;
 
   void emitIsNan(const Intrinsics* v);
+  void processParallelFor(const For* v);
 
   llvm::Value* emitUnmaskedLoad(llvm::Value* addr, llvm::Value* idx);
   llvm::Value* emitMaskedLoad(
@@ -317,6 +427,15 @@ LLVMCodeGenImpl::LLVMCodeGenImpl(
   HalfRewriter hsFix;
   stmt = stmt->accept_mutator(&hsFix);
 
+  std::string cacheKey;
+  std::string cachePath;
+  std::unique_ptr<llvm::MemoryBuffer> cachedObject;
+  if (!getLLVMKernelCacheDir().empty()) {
+    cacheKey = kernelCacheKey(stmt, args, dtype, jit_->getTargetMachine());
+    cachePath = kernelCachePath(getLLVMKernelCacheDir(), stmt, cacheKey);
+    cachedObject = loadCachedKernel(cachePath, cacheKey);
+  }
+
   // Emit prototype and bind argument Vars to parameter indices.
   llvm::Type* retTy = dtypeToLLVM(dtype);
   std::vector<llvm::Type*> params;
@@ -329,22 +448,57 @@ LLVMCodeGenImpl::LLVMCodeGenImpl(
     }
     varToArg_[arg.var()] = i;
   }
-  llvm::FunctionType* fntype = llvm::FunctionType::get(retTy, params, false);
-  fn_ = llvm::Function::Create(
-      fntype, llvm::Function::PrivateLinkage, "pytorch", module_.get());
-  fn_->addAttribute(
-      llvm::AttributeList::AttrIndex::FunctionIndex,
-      llvm::Attribute::AlwaysInline);
-  for (size_t i = 0; i < args.size(); i++) {
-    if (!args[i].isVar()) {
-      fn_->addParamAttr(i, llvm::Attribute::NoAlias);
+
+  if (cachedObject) {
+    GRAPH_DEBUG("Loaded the kernel from ", cachePath);
+    jit_->addObjectFile(std::move(cachedObject));
+    USE_TRIGGER(llvm_codegen_cache_hit);
+  } else {
+    llvm::FunctionType* fntype =
+        llvm::FunctionType::get(retTy, params, false);
+    fn_ = llvm::Function::Create(
+        fntype, llvm::Function::PrivateLinkage, "pytorch", module_.get());
+    fn_->addAttribute(
+        llvm::AttributeList::AttrIndex::FunctionIndex,
+        llvm::Attribute::AlwaysInline);
+    for (size_t i = 0; i < args.size(); i++) {
+      if (!args[i].isVar()) {
+        fn_->addParamAttr(i, llvm::Attribute::NoAlias);
+      }
     }
-  }
 
-  emitWrapper(params);
-  emitKernel(stmt, params);
+    emitWrapper(params);
+    emitKernel(stmt, params);
+
+    if (cachePath.empty()) {
+      jit_->addModule(std::move(module_), std::move(context_));
+    } else {
+      // Compile the module to object code here rather than in the JIT, to
+      // store the object code in the cache.
+      llvm::SmallVector<char, 0> objBuffer;
+      llvm::raw_svector_ostream objStream(objBuffer);
+      llvm::legacy::PassManager PM;
+      bool failed = jit_->getTargetMachine().addPassesToEmitFile(
+          PM,
+          objStream,
+          nullptr,
+#if LLVM_VERSION_MAJOR >= 10
+          llvm::CodeGenFileType::CGFT_ObjectFile);
+#else
+          llvm::TargetMachine::CodeGenFileType::CGFT_ObjectFile);
+#endif
+      if (failed) {
+        jit_->addModule(std::move(module_), std::move(context_));
+      } else {
+        PM.run(*module_);
+        llvm::StringRef object(objBuffer.data(), objBuffer.size());
+        storeCachedKernel(cachePath, cacheKey, object);
+        jit_->addObjectFile(
+            llvm::MemoryBuffer::getMemBufferCopy(object, cachePath));
+      }
+    }
+  }
 
-  jit_->addModule(std::move(module_), std::move(context_));
   auto sym = jit_->findSymbol("wrapper");
   kernelAddress_ = assertSuccess(sym.getAddress());
   argv_ = std::make_unique<void*[]>(params.size());
@@ -1040,6 +1194,11 @@ void LLVMCodeGenImpl::visit(const Load* v) {
 }
 
 void LLVMCodeGenImpl::visit(const For* v) {
+  if (v->is_parallel()) {
+    processParallelFor(v);
+    return;
+  }
+
   // Create "start" and "stop" values.
   v->start()->accept(this);
   auto start = this->value_;
@@ -1575,6 +1734,94 @@ void LLVMCodeGenImpl::visit(const FunctionCall* v) {
   throw unimplemented_lowering(v);
 }
 
+// A parallel loop is compiled to a function running one iteration, which
+// DispatchParallel calls from the threads of the intra-op pool. The values the
+// body uses from the kernel are packed in a struct, passed to every call.
+void LLVMCodeGenImpl::processParallelFor(const For* v) {
+  v->start()->accept(this);
+  auto start = irb_.CreateIntCast(this->value_, LongTy_, true);
+  v->stop()->accept(this);
+  auto stop = irb_.CreateIntCast(this->value_, LongTy_, true);
+
+  std::vector<const Var*> captured;
+  std::vector<llvm::Value*> captured_vals;
+  std::vector<llvm::Type*> captured_types;
+  for (const Var* var : VarFinder::find(v->body())) {
+    if (var == v->var() || (!varToArg_.count(var) && !varToVal_.count(var))) {
+      continue;
+    }
+    var->accept(this);
+    captured.push_back(var);
+    captured_vals.push_back(this->value_);
+    captured_types.push_back(this->value_->getType());
+  }
+  auto packed_ty = llvm::StructType::get(getContext(), captured_types);
+  // Allocate the struct in the entry block, the loop may be nested in others
+  llvm::IRBuilder<> entry_irb(
+      &fn_->getEntryBlock(), fn_->getEntryBlock().begin());
+  llvm::Value* packed = entry_irb.CreateAlloca(packed_ty);
+  for (size_t i = 0; i < captured_vals.size(); ++i) {
+    irb_.CreateStore(
+        captured_vals[i], irb_.CreateStructGEP(packed_ty, packed, i));
+  }
+
+  // Emit the body function.
+  auto body_fn_ty = llvm::FunctionType::get(
+      llvm::Type::getVoidTy(getContext()), {LongTy_, Int8PtrTy_}, false);
+  auto body_fn = llvm::Function::Create(
+      body_fn_ty,
+      llvm::Function::PrivateLinkage,
+      "parallel_body",
+      module_.get());
+  body_fn->addFnAttr(llvm::Attribute::NoUnwind);
+
+  auto caller_fn = fn_;
+  auto caller_block = irb_.GetInsertBlock();
+  auto caller_vals = std::move(varToVal_);
+  auto caller_args = std::move(varToArg_);
+  varToVal_.clear();
+  varToArg_.clear();
+
+  fn_ = body_fn;
+  irb_.SetInsertPoint(llvm::BasicBlock::Create(getContext(), "entry", fn_));
+  auto index = fn_->arg_begin();
+  auto body_packed =
+      irb_.CreatePointerCast(fn_->arg_begin() + 1, packed_ty->getPointerTo());
+  for (size_t i = 0; i < captured.size(); ++i) {
+    varToVal_.emplace(
+        captured[i],
+        irb_.CreateLoad(
+            captured_types[i],
+            irb_.CreateStructGEP(packed_ty, body_packed, i)));
+  }
+  varToVal_.emplace(
+      v->var(),
+      irb_.CreateIntCast(index, dtypeToLLVM(v->var()->dtype()), true));
+  v->body()->accept(this);
+  irb_.CreateRetVoid();
+
+  fn_ = caller_fn;
+  varToVal_ = std::move(caller_vals);
+  varToArg_ = std::move(caller_args);
+  irb_.SetInsertPoint(caller_block);
+
+  // Dispatch the iterations.
+  FunctionCallee callee = module_->getOrInsertFunction(
+      "DispatchParallel",
+      llvm::FunctionType::get(
+          llvm::Type::getVoidTy(getContext()),
+          {Int8PtrTy_, LongTy_, LongTy_, Int8PtrTy_},
+          false));
+  irb_.CreateCall(
+      callee.getFunctionType(),
+      callee.getCallee(),
+      {irb_.CreatePointerCast(body_fn, Int8PtrTy_),
+       start,
+       stop,
+       irb_.CreatePointerCast(packed, Int8PtrTy_)});
+  value_ = llvm::ConstantInt::get(IntTy_, 0);
+}
+
 void LLVMCodeGenImpl::visit(const ExternalCall* v) {
   constexpr int max_buffers = 10;
   constexpr int max_dimensions = 40;
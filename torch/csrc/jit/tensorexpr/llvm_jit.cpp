@@ -22,6 +22,7 @@
 
 #include <torch/csrc/jit/tensorexpr/external_functions_registry.h>
 
+#include <ATen/Parallel.h>
 #include <c10/util/Half.h>
 
 #include <algorithm>
@@ -65,6 +66,22 @@ static llvm::orc::JITTargetMachineBuilder makeTargetMachineBuilder() {
 #endif
 }
 
+// Runs the iterations of a parallel loop compiled by LLVMCodeGen, which are
+// calls of `func` on each index with the values packed by the kernel
+static void DispatchParallel(
+    void* func,
+    int64_t start,
+    int64_t stop,
+    void* packed_data) {
+  using ParallelBody = void (*)(int64_t, void*);
+  auto body = reinterpret_cast<ParallelBody>(func);
+  at::parallel_for(start, stop, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      body(i, packed_data);
+    }
+  });
+}
+
 static void registerIntrinsics(
     llvm::orc::JITDylib& JD,
     llvm::orc::MangleAndInterner& Mangle,
@@ -81,6 +98,7 @@ static void registerIntrinsics(
     symbols.insert(entry(sym.symbol, sym.address));
     intrinsics.insert(sym.symbol);
   }
+  symbols.insert(entry("DispatchParallel", DispatchParallel));
   assertSuccess(JD.define(absoluteSymbols(symbols)));
 
   for (const auto& kv : getNNCFunctionRegistry()) {
@@ -131,6 +149,12 @@ class TORCH_API PytorchLLVMJITImpl {
         "Failed to add module to compile layer");
   }
 
+  void addObjectFile(std::unique_ptr<MemoryBuffer> Obj) {
+    assertSuccess(
+        LLJ->addObjectFile(std::move(Obj)),
+        "Failed to add object file to object layer");
+  }
+
   JITSymbol findSymbol(const std::string Name) {
     return assertSuccess(LLJ->lookup(Name));
   }
@@ -208,6 +232,13 @@ class TORCH_API PytorchLLVMJITImpl {
         "Failed to add module to compile layer");
   }
 
+  void addObjectFile(std::unique_ptr<MemoryBuffer> Obj) {
+    auto K = ES.allocateVModule();
+    assertSuccess(
+        ObjectLayer.addObject(K, std::move(Obj)),
+        "Failed to add object file to object layer");
+  }
+
   JITSymbol findSymbol(const std::string Name) {
     std::string MangledName;
     raw_string_ostream MangledNameStream(MangledName);
@@ -247,6 +278,10 @@ void PytorchLLVMJIT::addModule(
   impl_->addModule(std::move(M), std::move(C));
 }
 
+void PytorchLLVMJIT::addObjectFile(std::unique_ptr<MemoryBuffer> Obj) {
+  impl_->addObjectFile(std::move(Obj));
+}
+
 JITSymbol PytorchLLVMJIT::findSymbol(const std::string Name) {
   return impl_->findSymbol(std::move(Name));
 }
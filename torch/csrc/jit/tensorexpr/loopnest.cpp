@@ -1027,7 +1027,7 @@ void LoopNest::prepareForCodegen() {
   root_stmt_ = insertAllocFree(root_stmt_);
 }
 
-void LoopNest::vectorizeInnerLoops() {
+void LoopNest::vectorizeInnerLoops(int vectorWidth) {
   std::vector<For*> innerLoops;
   std::vector<For*> worklist;
 
@@ -1077,16 +1077,15 @@ void LoopNest::vectorizeInnerLoops() {
     For* split1;
     For* tail1;
 
-    static const int kBodyVectorWidth = 8;
-    splitWithTail(loop, kBodyVectorWidth, &outer1, &split1, &tail1);
+    splitWithTail(loop, vectorWidth, &outer1, &split1, &tail1);
     vectorize(split1);
 
-    if (tail1) {
+    const int tailVectorWidth = vectorWidth / 2;
+    if (tail1 && tailVectorWidth > 1) {
       For* outer2;
       For* split2;
       For* tail2;
-      static const int kTailVectorWidth = 4;
-      splitWithTail(tail1, kTailVectorWidth, &outer2, &split2, &tail2);
+      splitWithTail(tail1, tailVectorWidth, &outer2, &split2, &tail2);
       vectorize(split2);
     }
   }
@@ -1617,6 +1616,18 @@ void LoopNest::setGPUThreadIndex(For* f, int thread_index) {
   f->set_gpu_thread_index(thread_index);
 }
 
+void LoopNest::parallelize(For* f) {
+  auto reductions = NodeFinder<ReduceOp>::find(f);
+  for (auto* r : reductions) {
+    if (std::find(r->reduce_args().begin(), r->reduce_args().end(), f->var()) !=
+        r->reduce_args().end()) {
+      throw std::logic_error(
+          "Cannot parallelize reduction axis - rfactor first");
+    }
+  }
+  f->set_parallel();
+}
+
 void LoopNest::setBufferMap(
     For* f,
     const std::unordered_map<std::string, const Buf*>& map) {
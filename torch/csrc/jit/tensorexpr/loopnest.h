@@ -83,6 +83,13 @@ class TORCH_API LoopNest {
   void setGPUBlockIndex(For* f, int idx);
   void setGPUThreadIndex(For* f, int idx);
 
+  // Run the iterations of `f` in parallel on the intra-op thread pool, with
+  // the LLVM backend. The other backends run them in order. A loop over a
+  // reduction axis accumulates into the same elements in every iteration and
+  // can't be parallelized: rfactor the reduction first, so that the partial
+  // results are computed by a loop over an axis of the new buffer.
+  static void parallelize(For* f);
+
   using AccessResult = std::pair<const Buf*, Stmt*>;
   // Insert a cache for the consumer's usages of the buffer produced in
   // consumer, and redirect reads and writes in the consumer to that cache.
@@ -110,9 +117,10 @@ class TORCH_API LoopNest {
   void eliminateDeadStores();
   void prepareForCodegen();
 
-  // Find the inner-most loops and vectorize them. Currently, this only works
-  // for the LLVM backend, when no reductions are involved.
-  void vectorizeInnerLoops();
+  // Find the inner-most loops and vectorize them by vectorWidth, and their
+  // tails by vectorWidth / 2. Currently, this only works for the LLVM backend,
+  // when no reductions are involved.
+  void vectorizeInnerLoops(int vectorWidth = 8);
 
   const std::unordered_set<const Buf*> getInputBufs() {
     return input_bufs_;
@@ -496,6 +496,9 @@ class TORCH_API LoopOptions {
     if (is_gpu_thread_index()) {
       throw std::runtime_error("Cannot set both gpu block and thread index");
     }
+    if (is_parallel()) {
+      throw std::runtime_error("Cannot bind a parallel loop to the GPU");
+    }
     if (is_gpu_block_index() && gpu_block_index() != index) {
       throw std::runtime_error("Cannot set a previously set block index");
     }
@@ -534,23 +537,42 @@ class TORCH_API LoopOptions {
     if (is_gpu_block_index()) {
       throw std::runtime_error("Cannot set both gpu thread and block index");
     }
+    if (is_parallel()) {
+      throw std::runtime_error("Cannot bind a parallel loop to the GPU");
+    }
     if (is_gpu_thread_index() && gpu_thread_index() != index) {
       throw std::runtime_error("Cannot set a previously set thread index");
     }
     gpu_thread_index_ = index;
   }
 
+  // Whether the iterations of the loop run in parallel on the intra-op thread
+  // pool, on CPU
+  bool is_parallel() const {
+    return is_parallel_;
+  }
+
+  void set_parallel() {
+    if (is_gpu_block_index() || is_gpu_thread_index()) {
+      throw std::runtime_error("Cannot parallelize a loop bound to the GPU");
+    }
+    is_parallel_ = true;
+  }
+
   std::string ToString() const {
     if (is_gpu_block_index()) {
       return gpu_block_index_str();
     } else if (is_gpu_thread_index()) {
       return gpu_thread_index_str();
+    } else if (is_parallel()) {
+      return "parallel";
     }
     return "";
   }
 
   bool isDefault() const {
-    return gpu_block_index_ == IDX_UNSET && gpu_thread_index_ == IDX_UNSET;
+    return gpu_block_index_ == IDX_UNSET && gpu_thread_index_ == IDX_UNSET &&
+        !is_parallel_;
   }
 
   void set_buffer_mapping(
@@ -565,6 +587,7 @@ class TORCH_API LoopOptions {
  private:
   int gpu_block_index_{IDX_UNSET};
   int gpu_thread_index_{IDX_UNSET};
+  bool is_parallel_{false};
   std::unordered_map<std::string, const Buf*> map_input_to_tensor_bufs_;
 };
 
@@ -663,6 +686,14 @@ class TORCH_API For : public StmtNode<For> {
     loop_options_.set_buffer_mapping(map);
   }
 
+  bool is_parallel() const {
+    return loop_options_.is_parallel();
+  }
+
+  void set_parallel() {
+    loop_options_.set_parallel();
+  }
+
   For* cloneWithNewBody(Stmt* body) const {
     return new For(var_, start_, stop_, body, loop_options_);
   }
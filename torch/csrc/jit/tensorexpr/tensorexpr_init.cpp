@@ -332,7 +332,10 @@ void initTensorExprBindings(PyObject* module) {
 
   py::class_<tensorexpr::LoopNest>(te, "LoopNest")
       .def(py::init<const std::vector<tensorexpr::Tensor*>&>())
-      .def("vectorize_inner_loops", &tensorexpr::LoopNest::vectorizeInnerLoops)
+      .def(
+          "vectorize_inner_loops",
+          &tensorexpr::LoopNest::vectorizeInnerLoops,
+          py::arg("vector_width") = 8)
       .def("prepare_for_codegen", &tensorexpr::LoopNest::prepareForCodegen)
       .def(
           "get_loop_body_for",
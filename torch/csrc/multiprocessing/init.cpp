@@ -1,4 +1,6 @@
 #include <torch/csrc/python_headers.h>
+#include <torch/csrc/DynamicTypes.h>
+#include <torch/csrc/multiprocessing/shm_pool.h>
 #include <torch/csrc/utils/object_ptr.h>
 #include <torch/csrc/utils/pybind.h>
 
@@ -34,6 +36,53 @@ PyObject* multiprocessing_init(PyObject* _unused, PyObject *noargs) {
 #endif
   });
 
+  // The storages are taken as Python objects, as the methods of the storage
+  // classes are generated for each dtype
+  module.def("_shm_pool_init_arena", [](py::handle arena, int64_t block_size) {
+    return shm_pool::init_arena(createStorage(arena.ptr()), block_size);
+  });
+  module.def("_shm_pool_block_size", [](py::handle arena) {
+    return shm_pool::block_size(createStorage(arena.ptr()));
+  });
+  module.def("_shm_pool_num_blocks", [](py::handle arena) {
+    return shm_pool::num_blocks(createStorage(arena.ptr()));
+  });
+  module.def("_shm_pool_num_free_blocks", [](py::handle arena) {
+    return shm_pool::num_free_blocks(createStorage(arena.ptr()));
+  });
+  module.def("_shm_pool_share", [](py::handle storage, py::handle arena) {
+    return shm_pool::share_into_arena(
+        createStorage(storage.ptr()).unsafeGetStorageImpl(),
+        createStorage(arena.ptr()));
+  });
+  // Returns (arena, block) for a pooled storage, and None otherwise
+  module.def("_shm_pool_block", [](py::handle storage) -> py::object {
+    at::Storage arena;
+    const int64_t block = shm_pool::pooled_block(
+        createStorage(storage.ptr()).unsafeGetStorageImpl(), &arena);
+    if (block < 0) {
+      return py::none();
+    }
+    auto arena_obj = py::reinterpret_steal<py::object>(
+        createPyObject(arena, caffe2::TypeMeta::Make<uint8_t>()));
+    return py::make_tuple(arena_obj, block);
+  });
+  module.def("_shm_pool_retain", [](py::handle arena, int64_t block) {
+    shm_pool::retain_block(createStorage(arena.ptr()), block);
+  });
+  module.def("_shm_pool_release", [](py::handle arena, int64_t block) {
+    shm_pool::release_block(createStorage(arena.ptr()), block);
+  });
+  module.def(
+      "_shm_pool_adopt",
+      [](py::handle storage, py::handle arena, int64_t block, int64_t nbytes) {
+        shm_pool::adopt_block(
+            createStorage(storage.ptr()).unsafeGetStorageImpl(),
+            createStorage(arena.ptr()),
+            block,
+            nbytes);
+      });
+
   Py_RETURN_TRUE;
 }
 
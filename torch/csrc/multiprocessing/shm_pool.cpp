@@ -0,0 +1,234 @@
+#include <torch/csrc/multiprocessing/shm_pool.h>
+
+#include <c10/core/StorageImpl.h>
+#include <c10/util/Exception.h>
+
+#include <atomic>
+#include <cstring>
+
+namespace torch {
+namespace multiprocessing {
+namespace shm_pool {
+
+namespace {
+
+// The arenas are mapped by several processes, their atomics can't be
+// implemented with a lock living in one of them
+static_assert(
+    ATOMIC_LLONG_LOCK_FREE == 2,
+    "the shared memory pool needs lock-free 64-bit atomics");
+
+constexpr uint64_t kArenaMagic = 0x6c6f6f706d687374; // "tshmpool"
+constexpr int64_t kBlockAlignment = 64;
+constexpr uint64_t kIndexMask = 0xffffffff;
+
+struct BlockHeader {
+  // the next free block plus one, or zero at the end of the free list
+  std::atomic<uint64_t> next;
+  // the references held by the storages and by the messages in flight
+  std::atomic<int64_t> refcount;
+};
+
+struct ArenaHeader {
+  uint64_t magic;
+  int64_t block_size;
+  int64_t num_blocks;
+  int64_t data_offset;
+  // The first free block plus one in the low 32 bits, and a tag bumped by each
+  // update in the high ones, which keeps a stale compare-exchange from
+  // succeeding after the head was popped and pushed back (the ABA problem)
+  std::atomic<uint64_t> free_head;
+  BlockHeader blocks[1];
+};
+
+int64_t align_up(int64_t n) {
+  return (n + kBlockAlignment - 1) / kBlockAlignment * kBlockAlignment;
+}
+
+int64_t header_size(int64_t num_blocks) {
+  return align_up(
+      static_cast<int64_t>(offsetof(ArenaHeader, blocks)) +
+      num_blocks * static_cast<int64_t>(sizeof(BlockHeader)));
+}
+
+ArenaHeader* header(const c10::Storage& arena) {
+  TORCH_CHECK(arena.device().is_cpu(), "shm_pool: expected a CPU arena");
+  auto* header = static_cast<ArenaHeader*>(arena.data_ptr().get());
+  TORCH_CHECK(
+      header && arena.nbytes() >= sizeof(ArenaHeader) && header->magic == kArenaMagic,
+      "shm_pool: the storage isn't an initialized arena");
+  return header;
+}
+
+BlockHeader& block_header(ArenaHeader* header, int64_t block) {
+  TORCH_CHECK(
+      block >= 0 && block < header->num_blocks,
+      "shm_pool: block ", block, " out of range for an arena of ", header->num_blocks, " blocks");
+  return header->blocks[block];
+}
+
+char* block_data(ArenaHeader* header, int64_t block) {
+  return reinterpret_cast<char*>(header) + header->data_offset + block * header->block_size;
+}
+
+uint64_t next_head(uint64_t head, uint64_t index) {
+  return (((head >> 32) + 1) << 32) | index;
+}
+
+void push_free(ArenaHeader* header, int64_t block) {
+  auto& node = header->blocks[block];
+  uint64_t head = header->free_head.load(std::memory_order_relaxed);
+  do {
+    node.next.store(head & kIndexMask, std::memory_order_relaxed);
+  } while (!header->free_head.compare_exchange_weak(
+      head, next_head(head, block + 1), std::memory_order_release, std::memory_order_relaxed));
+}
+
+int64_t pop_free(ArenaHeader* header) {
+  uint64_t head = header->free_head.load(std::memory_order_acquire);
+  while (true) {
+    const uint64_t index = head & kIndexMask;
+    if (index == 0) {
+      return -1;
+    }
+    // may read the link of a block popped meanwhile, in which case the tag
+    // has changed and the exchange fails
+    const uint64_t next = header->blocks[index - 1].next.load(std::memory_order_relaxed);
+    if (header->free_head.compare_exchange_weak(
+            head, next_head(head, next), std::memory_order_acquire, std::memory_order_acquire)) {
+      return static_cast<int64_t>(index) - 1;
+    }
+  }
+}
+
+void release(ArenaHeader* header, int64_t block) {
+  const auto previous = header->blocks[block].refcount.fetch_sub(1, std::memory_order_acq_rel);
+  TORCH_INTERNAL_ASSERT(previous > 0, "shm_pool: block ", block, " released too many times");
+  if (previous == 1) {
+    push_free(header, block);
+  }
+}
+
+// The context of the DataPtr of a pooled storage, which keeps the arena mapped
+// for as long as the storage lives
+struct PooledBlock {
+  c10::Storage arena;
+  int64_t block;
+};
+
+void delete_pooled_block(void* ctx) {
+  auto* pooled = static_cast<PooledBlock*>(ctx);
+  release(static_cast<ArenaHeader*>(pooled->arena.data_ptr().get()), pooled->block);
+  delete pooled;
+}
+
+void set_block(c10::StorageImpl* storage, const c10::Storage& arena, int64_t block, int64_t nbytes) {
+  auto* data = block_data(header(arena), block);
+  storage->set_data_ptr(c10::DataPtr(
+      data, new PooledBlock{arena, block}, &delete_pooled_block, arena.device()));
+  storage->set_nbytes(nbytes);
+  // the block can't grow, and is released by its own deleter
+  storage->set_resizable(false);
+  storage->set_allocator(nullptr);
+}
+
+} // namespace
+
+int64_t init_arena(const c10::Storage& arena, int64_t block_size) {
+  TORCH_CHECK(block_size > 0, "shm_pool: expected a positive block size, but got ", block_size);
+  TORCH_CHECK(arena.device().is_cpu(), "shm_pool: expected a CPU arena");
+  const int64_t arena_size = arena.nbytes();
+  block_size = align_up(block_size);
+  // the largest number of blocks fitting in the arena along with their headers
+  int64_t num_blocks = arena_size / (block_size + static_cast<int64_t>(sizeof(BlockHeader)));
+  while (num_blocks > 0 && header_size(num_blocks) + num_blocks * block_size > arena_size) {
+    --num_blocks;
+  }
+  TORCH_CHECK(
+      num_blocks > 0 && static_cast<uint64_t>(num_blocks) < kIndexMask,
+      "shm_pool: an arena of ", arena_size, " bytes can't hold blocks of ", block_size, " bytes");
+
+  auto* header = static_cast<ArenaHeader*>(arena.data_ptr().get());
+  header->magic = kArenaMagic;
+  header->block_size = block_size;
+  header->num_blocks = num_blocks;
+  header->data_offset = header_size(num_blocks);
+  for (int64_t i = 0; i < num_blocks; ++i) {
+    header->blocks[i].next.store(i + 1 < num_blocks ? i + 2 : 0, std::memory_order_relaxed);
+    header->blocks[i].refcount.store(0, std::memory_order_relaxed);
+  }
+  header->free_head.store(1, std::memory_order_release);
+  return num_blocks;
+}
+
+int64_t block_size(const c10::Storage& arena) {
+  return header(arena)->block_size;
+}
+
+int64_t num_blocks(const c10::Storage& arena) {
+  return header(arena)->num_blocks;
+}
+
+int64_t num_free_blocks(const c10::Storage& arena) {
+  auto* header = shm_pool::header(arena);
+  int64_t count = 0;
+  for (int64_t i = 0; i < header->num_blocks; ++i) {
+    if (header->blocks[i].refcount.load(std::memory_order_relaxed) == 0) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+int64_t share_into_arena(c10::StorageImpl* storage, const c10::Storage& arena) {
+  auto* header = shm_pool::header(arena);
+  const int64_t nbytes = storage->nbytes();
+  TORCH_CHECK(
+      nbytes <= header->block_size,
+      "shm_pool: a storage of ", nbytes, " bytes doesn't fit in blocks of ", header->block_size, " bytes");
+  const int64_t block = pop_free(header);
+  if (block < 0) {
+    return -1;
+  }
+  header->blocks[block].refcount.store(1, std::memory_order_relaxed);
+  if (nbytes > 0) {
+    std::memcpy(block_data(header, block), storage->data(), nbytes);
+  }
+  set_block(storage, arena, block, nbytes);
+  return block;
+}
+
+int64_t pooled_block(const c10::StorageImpl* storage, c10::Storage* arena) {
+  const auto& data_ptr = storage->data_ptr();
+  if (data_ptr.get_deleter() != &delete_pooled_block) {
+    return -1;
+  }
+  auto* pooled = static_cast<PooledBlock*>(data_ptr.get_context());
+  *arena = pooled->arena;
+  return pooled->block;
+}
+
+void retain_block(const c10::Storage& arena, int64_t block) {
+  block_header(header(arena), block).refcount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void adopt_block(c10::StorageImpl* storage, const c10::Storage& arena, int64_t block, int64_t nbytes) {
+  auto* header = shm_pool::header(arena);
+  TORCH_CHECK(
+      block_header(header, block).refcount.load(std::memory_order_acquire) > 0,
+      "shm_pool: block ", block, " was received after being released");
+  TORCH_CHECK(
+      nbytes >= 0 && nbytes <= header->block_size,
+      "shm_pool: ", nbytes, " bytes don't fit in blocks of ", header->block_size, " bytes");
+  set_block(storage, arena, block, nbytes);
+}
+
+void release_block(const c10::Storage& arena, int64_t block) {
+  auto* header = shm_pool::header(arena);
+  block_header(header, block);
+  release(header, block);
+}
+
+} // namespace shm_pool
+} // namespace multiprocessing
+} // namespace torch
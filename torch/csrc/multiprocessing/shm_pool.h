@@ -0,0 +1,59 @@
+#pragma once
+
+#include <c10/core/Storage.h>
+#include <c10/macros/Export.h>
+
+#include <cstdint>
+
+// Pools of fixed size blocks carved out of a shared memory arena, used by the
+// 'shm_pool' sharing strategy of torch.multiprocessing. A pooled storage is
+// sent as (arena, block, size) instead of getting a shared memory file of its
+// own, and its block goes back to the free list of the arena once the last
+// process using it releases it, whichever process that is.
+//
+// The arena starts with a header holding the free list and the reference count
+// of each block, both updated with lock-free atomics, so that all the processes
+// mapping the arena can take and release blocks without any other
+// synchronization.
+
+namespace torch {
+namespace multiprocessing {
+namespace shm_pool {
+
+// Lays out the free list of the arena, splitting it in blocks of block_size
+// bytes. Returns the number of blocks.
+TORCH_API int64_t init_arena(const c10::Storage& arena, int64_t block_size);
+
+TORCH_API int64_t block_size(const c10::Storage& arena);
+TORCH_API int64_t num_blocks(const c10::Storage& arena);
+TORCH_API int64_t num_free_blocks(const c10::Storage& arena);
+
+// Copies the data of the storage to a free block of the arena and points the
+// storage to it. Returns the block, or -1 if there is no free block.
+TORCH_API int64_t share_into_arena(
+    c10::StorageImpl* storage,
+    const c10::Storage& arena);
+
+// The block the storage points to, or -1 if it isn't a pooled storage, in
+// which case the arena is left undefined
+TORCH_API int64_t pooled_block(
+    const c10::StorageImpl* storage,
+    c10::Storage* arena);
+
+// Takes a reference to the block, held by a message in flight
+TORCH_API void retain_block(const c10::Storage& arena, int64_t block);
+
+// Points the storage to the first nbytes of the block, taking over the
+// reference of the message which carried it
+TORCH_API void adopt_block(
+    c10::StorageImpl* storage,
+    const c10::Storage& arena,
+    int64_t block,
+    int64_t nbytes);
+
+// Drops a reference taken by retain_block, for the messages never received
+TORCH_API void release_block(const c10::Storage& arena, int64_t block);
+
+} // namespace shm_pool
+} // namespace multiprocessing
+} // namespace torch
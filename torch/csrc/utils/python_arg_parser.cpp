@@ -3,11 +3,14 @@
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/Layout.h>
 #include <torch/csrc/MemoryFormat.h>
+#include <torch/csrc/Size.h>
 #include <torch/csrc/utils/invalid_arguments.h>
 #include <torch/csrc/utils/python_strings.h>
 
 #include <ATen/ATen.h>
 #include <ATen/TracerMode.h>
+#include <c10/util/OverheadProbe.h>
+#include <c10/util/SmallVector.h>
 
 #include <sstream>
 #include <stdexcept>
@@ -1006,7 +1009,167 @@ void PythonArgParser::check_deprecated(const FunctionSignature & signature) {
   }
 }
 
+// Note [PythonArgParser signature cache]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The overload of a call is the first signature that accepts its arguments,
+// so calls to functions with many signatures (add, index, to) type check
+// their arguments against every signature before the one they end up using.
+// Each parser caches the signature used by the last few kinds of calls.
+//
+// For the arguments of the types that FunctionParameter::check knows about,
+// whether a signature accepts an argument only depends on its type, except
+// for tensors (e.g. 0-dim tensors that don't require grad are also Scalars),
+// tuples and lists (their elements are checked) and Python types (only some
+// are dtypes). The cache key of a call holds the number of positional
+// arguments, the type of every argument, the dtype, dim == 0, numel == 1 and
+// requires_grad of the tensors, the types of the elements of tuples and
+// lists, the Python types themselves, and the keyword names. Calls with the
+// same key are accepted and rejected by the same signatures, so on a hit only
+// the cached signature is parsed.
+//
+// Calls with any other argument are never cached: a Python class can gain a
+// __torch_function__ or an __index__ at any time, and numpy arrays are ints
+// depending on their shape. The same goes for long sequences, which would
+// make the key as expensive as the parse. The types in the keys are not kept
+// alive: the types allowed are never freed, except for the tensor
+// subclasses, and one that reuses the address of a freed one is checked the
+// same way. The keyword names are, as their addresses are what the keys
+// compare.
+//
+// Everything here runs under the GIL.
+
+namespace {
+
+constexpr size_t kSignatureCacheSize = 8;
+constexpr Py_ssize_t kMaxCachedSequenceSize = 16;
+
+bool signature_cache_enabled = true;
+PythonArgParserCacheStats signature_cache_stats;
+
+using SignatureCacheKey = c10::SmallVector<uintptr_t, 16>;
+
+// Appends obj to the key, and returns false if a call with obj can't be cached
+bool append_to_cache_key(PyObject* obj, SignatureCacheKey& key, bool is_element) {
+  key.push_back(reinterpret_cast<uintptr_t>(Py_TYPE(obj)));
+  if (THPVariable_Check(obj)) {
+    const auto& var = reinterpret_cast<THPVariable*>(obj)->cdata;
+    if (!var.defined()) {
+      return false;
+    }
+    key.push_back(
+        static_cast<uintptr_t>(var.scalar_type()) |
+        static_cast<uintptr_t>(var.dim() == 0) << 8 |
+        static_cast<uintptr_t>(var.numel() == 1) << 9 |
+        static_cast<uintptr_t>(var.requires_grad()) << 10);
+    return true;
+  }
+  if (PyTuple_CheckExact(obj) || PyList_CheckExact(obj) || THPSize_Check(obj)) {
+    // the elements of nested sequences are never checked
+    if (is_element) {
+      return true;
+    }
+    const Py_ssize_t size = PySequence_Fast_GET_SIZE(obj);
+    if (size > kMaxCachedSequenceSize) {
+      return false;
+    }
+    key.push_back(size);
+    PyObject** items = PySequence_Fast_ITEMS(obj);
+    for (Py_ssize_t i = 0; i < size; ++i) {
+      if (!append_to_cache_key(items[i], key, /*is_element=*/true)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (PyType_CheckExact(obj)) {
+    if (PyType_HasFeature(reinterpret_cast<PyTypeObject*>(obj), Py_TPFLAGS_HEAPTYPE)) {
+      return false;
+    }
+    key.push_back(reinterpret_cast<uintptr_t>(obj));
+    return true;
+  }
+#ifdef USE_NUMPY
+  if (torch::utils::is_numpy_scalar(obj)) {
+    return true;
+  }
+#endif
+  return obj == Py_None || PyBool_Check(obj) || PyLong_CheckExact(obj) ||
+      PyFloat_CheckExact(obj) || PyComplex_CheckExact(obj) ||
+      PyUnicode_CheckExact(obj) || THPDtype_Check(obj) ||
+      THPLayout_Check(obj) || THPMemoryFormat_Check(obj) ||
+      THPQScheme_Check(obj) || THPDevice_Check(obj) ||
+      THPGenerator_Check(obj) || THPStream_Check(obj);
+}
+
+bool make_cache_key(PyObject* args, PyObject* kwargs, SignatureCacheKey& key) {
+  const Py_ssize_t nargs = args ? PyTuple_GET_SIZE(args) : 0;
+  key.push_back(nargs);
+  for (Py_ssize_t i = 0; i < nargs; ++i) {
+    if (!append_to_cache_key(PyTuple_GET_ITEM(args, i), key, /*is_element=*/false)) {
+      return false;
+    }
+  }
+  if (kwargs) {
+    PyObject *name = nullptr, *value = nullptr;
+    Py_ssize_t pos = 0;
+    while (PyDict_Next(kwargs, &pos, &name, &value)) {
+      key.push_back(reinterpret_cast<uintptr_t>(name));
+      if (!append_to_cache_key(value, key, /*is_element=*/false)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+PythonArgParserCacheStats get_python_arg_parser_cache_stats() {
+  return signature_cache_stats;
+}
+
+void reset_python_arg_parser_cache_stats() {
+  signature_cache_stats = PythonArgParserCacheStats();
+}
+
+void set_python_arg_parser_cache_enabled(bool enabled) {
+  signature_cache_enabled = enabled;
+}
+
+bool python_arg_parser_cache_enabled() {
+  return signature_cache_enabled;
+}
+
+void PythonArgParser::cache_signature(at::ArrayRef<uintptr_t> key, PyObject* kwargs, size_t signature) {
+  SignatureCacheEntry entry;
+  entry.key.assign(key.begin(), key.end());
+  if (kwargs) {
+    PyObject *name = nullptr, *value = nullptr;
+    Py_ssize_t pos = 0;
+    while (PyDict_Next(kwargs, &pos, &name, &value)) {
+      Py_INCREF(name);
+      entry.kwarg_names.push_back(name);
+    }
+  }
+  entry.signature = signature;
+
+  if (signature_cache_.size() < kSignatureCacheSize) {
+    signature_cache_.emplace_back(std::move(entry));
+    return;
+  }
+  // The references of evicted entries are released here, while the GIL is
+  // held. Those of the entries left when the parsers are destroyed at exit
+  // are leaked, as Python may be finalized by then.
+  auto& evicted = signature_cache_[next_cache_slot_];
+  for (PyObject* name : evicted.kwarg_names) {
+    Py_DECREF(name);
+  }
+  evicted = std::move(entry);
+  next_cache_slot_ = (next_cache_slot_ + 1) % kSignatureCacheSize;
+}
+
 PythonArgs PythonArgParser::raw_parse(PyObject* self, PyObject* args, PyObject* kwargs, PyObject* parsed_args[]) {  // NOLINT
+  C10_OVERHEAD_PROBE(PYTHON_ARG_PARSING);
   if (signatures_.size() == 1) {
     auto& signature = signatures_[0];
     signature.parse(self, args, kwargs, parsed_args, true);
@@ -1014,8 +1177,34 @@ PythonArgs PythonArgParser::raw_parse(PyObject* self, PyObject* args, PyObject*
     return PythonArgs(traceable, signature, parsed_args);
   }
 
-  for (auto& signature : signatures_) {
+  SignatureCacheKey key;
+  const bool cacheable = signature_cache_enabled && make_cache_key(args, kwargs, key);
+  SignatureCacheEntry* stale_entry = nullptr;
+  if (cacheable) {
+    for (auto& entry : signature_cache_) {
+      if (at::ArrayRef<uintptr_t>(entry.key).equals(key)) {
+        auto& signature = signatures_[entry.signature];
+        // only fails if a check depends on more than the key
+        if (signature.parse(self, args, kwargs, parsed_args, false)) {
+          ++signature_cache_stats.hits;
+          check_deprecated(signature);
+          return PythonArgs(traceable, signature, parsed_args);
+        }
+        stale_entry = &entry;
+        break;
+      }
+    }
+  }
+  ++signature_cache_stats.misses;
+
+  for (size_t i = 0; i < signatures_.size(); ++i) {
+    auto& signature = signatures_[i];
     if (signature.parse(self, args, kwargs, parsed_args, false)) {
+      if (stale_entry) {
+        stale_entry->signature = i;
+      } else if (cacheable) {
+        cache_signature(key, kwargs, i);
+      }
       check_deprecated(signature);
       return PythonArgs(traceable, signature, parsed_args);
     }
@@ -114,13 +114,39 @@ private:
   void print_error(PyObject* self, PyObject* args, PyObject* kwargs, PyObject* parsed_args[]);
   void check_deprecated(const FunctionSignature & signature);
   PythonArgs raw_parse(PyObject* self, PyObject* args, PyObject* kwargs, PyObject* parsed_args[]);
+  void cache_signature(at::ArrayRef<uintptr_t> key, PyObject* kwargs, size_t signature);
+
+  // See Note [PythonArgParser signature cache]
+  struct SignatureCacheEntry {
+    std::vector<uintptr_t> key;
+    // strong references to the keyword names in the key
+    std::vector<PyObject*> kwarg_names;
+    // position in signatures_
+    size_t signature;
+  };
 
   std::vector<FunctionSignature> signatures_;
   std::string function_name;
   ssize_t max_args;
   bool traceable;
+  std::vector<SignatureCacheEntry> signature_cache_;
+  size_t next_cache_slot_ = 0;
+};
+
+// Statistics of the signature cache of all the PythonArgParsers, see
+// Note [PythonArgParser signature cache]
+struct PythonArgParserCacheStats {
+  uint64_t hits = 0;
+  // calls with more than one signature that missed the cache or could not
+  // use it
+  uint64_t misses = 0;
 };
 
+PythonArgParserCacheStats get_python_arg_parser_cache_stats();
+void reset_python_arg_parser_cache_stats();
+void set_python_arg_parser_cache_enabled(bool enabled);
+bool python_arg_parser_cache_enabled();
+
 struct PYBIND11_EXPORT FunctionSignature {
   explicit FunctionSignature(const std::string& fmt, int index);
 
@@ -0,0 +1,152 @@
+#include <torch/csrc/python_headers.h>
+#include <torch/csrc/utils/tensor_buffer.h>
+
+#include <pybind11/pybind11.h>
+
+#include <c10/util/Optional.h>
+
+#include <memory>
+#include <vector>
+
+using at::ScalarType;
+
+namespace torch { namespace utils {
+
+namespace {
+
+bool is_little_endian() {
+  const uint16_t one = 1;
+  return *reinterpret_cast<const uint8_t*>(&one) == 1;
+}
+
+// The scalar type of the items described by a struct module format string,
+// such as "f", "<q" or "Zd", if there is one
+c10::optional<ScalarType> buffer_format_to_aten(const char* format, Py_ssize_t itemsize) {
+  if (!format) {
+    // unsigned bytes
+    return ScalarType::Byte;
+  }
+  switch (*format) {
+    case '@':
+    case '=':
+      ++format;
+      break;
+    case '<':
+      if (!is_little_endian()) return c10::nullopt;
+      ++format;
+      break;
+    case '>':
+    case '!':
+      if (is_little_endian()) return c10::nullopt;
+      ++format;
+      break;
+    default:
+      break;
+  }
+  if (format[0] == 'Z') {
+    // complex numbers, made of two floating point numbers
+    if (format[1] == 'f' && format[2] == '\0' && itemsize == 8) return ScalarType::ComplexFloat;
+    if (format[1] == 'd' && format[2] == '\0' && itemsize == 16) return ScalarType::ComplexDouble;
+    return c10::nullopt;
+  }
+  if (format[0] == '\0' || format[1] != '\0') {
+    // records and repeated items
+    return c10::nullopt;
+  }
+  switch (format[0]) {
+    // the integers are mapped by size, which differs between the native and
+    // the standard ones
+    case 'b': case 'h': case 'i': case 'l': case 'q': case 'n':
+      switch (itemsize) {
+        case 1: return ScalarType::Char;
+        case 2: return ScalarType::Short;
+        case 4: return ScalarType::Int;
+        case 8: return ScalarType::Long;
+        default: return c10::nullopt;
+      }
+    case 'B':
+      return itemsize == 1 ? c10::optional<ScalarType>(ScalarType::Byte) : c10::nullopt;
+    case '?':
+      return itemsize == 1 ? c10::optional<ScalarType>(ScalarType::Bool) : c10::nullopt;
+    case 'e':
+      return itemsize == 2 ? c10::optional<ScalarType>(ScalarType::Half) : c10::nullopt;
+    case 'f':
+      return itemsize == 4 ? c10::optional<ScalarType>(ScalarType::Float) : c10::nullopt;
+    case 'd':
+      return itemsize == 8 ? c10::optional<ScalarType>(ScalarType::Double) : c10::nullopt;
+    default:
+      // unsigned integers wider than a byte, characters, pointers...
+      return c10::nullopt;
+  }
+}
+
+struct BufferDeleter {
+  void operator()(Py_buffer* view) const {
+    PyBuffer_Release(view);
+    delete view;
+  }
+};
+
+} // namespace
+
+at::Tensor tensor_from_buffer(PyObject* obj, bool warn_if_not_writeable/*=true*/) {
+  if (!PyObject_CheckBuffer(obj)) {
+    return at::Tensor();
+  }
+  std::unique_ptr<Py_buffer, BufferDeleter> view(new Py_buffer());
+  if (PyObject_GetBuffer(obj, view.get(), PyBUF_RECORDS_RO) != 0) {
+    // the buffer can't be described by a shape and strides
+    delete view.release();
+    PyErr_Clear();
+    return at::Tensor();
+  }
+
+  const auto scalar_type = buffer_format_to_aten(view->format, view->itemsize);
+  if (!scalar_type || view->ndim < 0 || (view->ndim > 0 && !view->shape)) {
+    return at::Tensor();
+  }
+  const auto itemsize = view->itemsize;
+  std::vector<int64_t> sizes(view->shape, view->shape + view->ndim);
+  std::vector<int64_t> strides(view->ndim);
+  for (int i = 0; i < view->ndim; i++) {
+    const Py_ssize_t stride = view->strides ? view->strides[i] : 0;
+    // the tensors can't express negative strides nor strides which aren't a
+    // multiple of the item size, copied by the generic path
+    if (stride < 0 || stride % itemsize != 0) {
+      return at::Tensor();
+    }
+    strides[i] = stride / itemsize;
+  }
+  if (!view->strides) {
+    // C contiguous
+    int64_t stride = 1;
+    for (int i = view->ndim - 1; i >= 0; i--) {
+      strides[i] = stride;
+      stride *= sizes[i];
+    }
+  }
+
+  if (view->readonly && warn_if_not_writeable) {
+    TORCH_WARN_ONCE(
+      "The given buffer is not writable, and PyTorch does not support "
+      "non-writable tensors. This means you can write to the underlying "
+      "(supposedly non-writable) buffer using the tensor. You may want to copy "
+      "the buffer to protect its data or make it writable before converting it "
+      "to a tensor. This type of warning will be suppressed for the rest of "
+      "this program.");
+  }
+
+  void* data = view->buf;
+  Py_buffer* released_view = view.release();
+  return at::from_blob(
+      data,
+      sizes,
+      strides,
+      [released_view](void*) {
+        pybind11::gil_scoped_acquire gil;
+        BufferDeleter()(released_view);
+      },
+      at::device(at::kCPU).dtype(*scalar_type));
+}
+
+}} // namespace torch::utils
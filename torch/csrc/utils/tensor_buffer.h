@@ -0,0 +1,14 @@
+#pragma once
+
+#include <torch/csrc/python_headers.h>
+#include <ATen/ATen.h>
+
+namespace torch { namespace utils {
+
+// Wraps the memory of an object exporting the buffer protocol (bytes,
+// bytearray, array.array, memoryview...) in a CPU tensor, without copying it.
+// Returns an undefined tensor if the object doesn't export a buffer, or if its
+// format or strides can't be represented by a tensor.
+at::Tensor tensor_from_buffer(PyObject* obj, bool warn_if_not_writeable=true);
+
+}} // namespace torch::utils
@@ -12,10 +12,12 @@
 #include <torch/csrc/utils/python_numbers.h>
 #include <torch/csrc/utils/python_scalars.h>
 #include <torch/csrc/utils/python_strings.h>
+#include <torch/csrc/utils/tensor_buffer.h>
 #include <torch/csrc/utils/tensor_numpy.h>
 #include <torch/csrc/autograd/generated/variable_factories.h>
 
 #include <ATen/ATen.h>
+#include <ATen/DLConvertor.h>
 #include <ATen/InitialTensorOptions.h>
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/TracerMode.h>
@@ -147,7 +149,48 @@ std::vector<int64_t> compute_sizes(PyObject* seq) {
   return sizes;
 }
 
+at::ScalarType default_complex_scalar_type() {
+  switch (torch::tensors::get_default_scalar_type()) {
+    case ScalarType::Float: return ScalarType::ComplexFloat;
+    case ScalarType::Double: return ScalarType::ComplexDouble;
+    default: TORCH_CHECK(false, "invalid default scalar type for complex");
+  }
+}
+
+// The type of the Python floats, ints and bools, which make up nearly all the
+// leaves of the nested lists, checked before the other types
+c10::optional<ScalarType> infer_builtin_scalar_type(PyObject *obj) {
+  if (PyFloat_CheckExact(obj)) {
+    return torch::tensors::get_default_scalar_type();
+  }
+  if (PyLong_CheckExact(obj)) {
+    return ScalarType::Long;
+  }
+  if (PyBool_Check(obj)) {
+    return ScalarType::Bool;
+  }
+  return c10::nullopt;
+}
+
+// The type inferred from the items of a buffer, the same as for the Python
+// scalars they convert to
+ScalarType infer_buffer_scalar_type(ScalarType item_type) {
+  if (item_type == ScalarType::Bool) {
+    return ScalarType::Bool;
+  }
+  if (at::isIntegralType(item_type, /*includeBool=*/false)) {
+    return ScalarType::Long;
+  }
+  if (at::isComplexType(item_type)) {
+    return default_complex_scalar_type();
+  }
+  return torch::tensors::get_default_scalar_type();
+}
+
 ScalarType infer_scalar_type(PyObject *obj) {
+  if (auto builtin_type = infer_builtin_scalar_type(obj)) {
+    return *builtin_type;
+  }
 #ifdef USE_NUMPY
   if (PyArray_Check(obj)) {
     return numpy_dtype_to_aten(PyArray_TYPE((PyArrayObject*)obj));
@@ -169,11 +212,7 @@ ScalarType infer_scalar_type(PyObject *obj) {
     return ScalarType::Bool;
   }
   if (PyComplex_Check(obj)) {
-    switch (torch::tensors::get_default_scalar_type()) {
-      case ScalarType::Float: return ScalarType::ComplexFloat;
-      case ScalarType::Double: return ScalarType::ComplexDouble;
-      default: TORCH_CHECK(false, "invalid default scalar type for complex");
-    }
+    return default_complex_scalar_type();
   }
   if (THPVariable_Check(obj)) {
     auto var = reinterpret_cast<THPVariable*>(obj)->cdata;
@@ -182,6 +221,25 @@ ScalarType infer_scalar_type(PyObject *obj) {
   if (THPUtils_checkString(obj)) {
     throw TypeError("new(): invalid data type '%s'", Py_TYPE(obj)->tp_name);
   }
+  if (PyList_CheckExact(obj) || PyTuple_CheckExact(obj)) {
+    // the items are borrowed, without building a reference to each of them
+    auto length = PySequence_Fast_GET_SIZE(obj);
+    if (length == 0) return torch::tensors::get_default_scalar_type();
+    PyObject** items = PySequence_Fast_ITEMS(obj);
+    c10::optional<ScalarType> scalarType;
+    for (Py_ssize_t i = 0; i < length; ++i) {
+      auto cur_item = items[i];
+      if (cur_item == obj) throw TypeError("new(): self-referential lists are incompatible");
+      auto builtin_type = infer_builtin_scalar_type(cur_item);
+      ScalarType item_scalarType = builtin_type ? *builtin_type : infer_scalar_type(cur_item);
+      scalarType = (scalarType) ?
+          at::promoteTypes(*scalarType, item_scalarType) : item_scalarType;
+      if (scalarType == ScalarType::ComplexDouble) {
+        return *scalarType;
+      }
+    }
+    return *scalarType;
+  }
   if (PySequence_Check(obj)) {
     c10::optional<ScalarType> scalarType;
     auto length = PySequence_Length(obj);
@@ -206,6 +264,40 @@ ScalarType infer_scalar_type(PyObject *obj) {
   AT_ERROR("Could not infer dtype of ", Py_TYPE(obj)->tp_name);
 }
 
+// Stores the last dimension of a nested list, unpacking the Python floats and
+// ints inline rather than through the generic conversions
+void store_scalars(char* data, int64_t stride, ScalarType scalarType, PyObject** items, int64_t n) {
+  switch (scalarType) {
+    case at::kFloat:
+      for (int64_t i = 0; i < n; i++, data += stride) {
+        *(float*)data = PyFloat_CheckExact(items[i]) ?
+            (float)PyFloat_AS_DOUBLE(items[i]) : (float)THPUtils_unpackDouble(items[i]);
+      }
+      break;
+    case at::kDouble:
+      for (int64_t i = 0; i < n; i++, data += stride) {
+        *(double*)data = PyFloat_CheckExact(items[i]) ?
+            PyFloat_AS_DOUBLE(items[i]) : THPUtils_unpackDouble(items[i]);
+      }
+      break;
+    case at::kLong:
+      for (int64_t i = 0; i < n; i++, data += stride) {
+        int overflow = 1;
+        long long value = 0;
+        if (PyLong_CheckExact(items[i])) {
+          value = PyLong_AsLongLongAndOverflow(items[i], &overflow);
+        }
+        // out of range, or not an int: raises the usual errors
+        *(int64_t*)data = overflow == 0 ? value : THPUtils_unpackLong(items[i]);
+      }
+      break;
+    default:
+      for (int64_t i = 0; i < n; i++, data += stride) {
+        torch::utils::store_scalar(data, scalarType, items[i]);
+      }
+  }
+}
+
 void recursive_store(char* data, IntArrayRef sizes, IntArrayRef strides, int64_t dim,
                             ScalarType scalarType, int elementSize, PyObject* obj) {
   int64_t ndim = sizes.size();
@@ -224,6 +316,10 @@ void recursive_store(char* data, IntArrayRef sizes, IntArrayRef strides, int64_t
   }
 
   PyObject** items = PySequence_Fast_ITEMS(seq.get());
+  if (dim + 1 == ndim) {
+    store_scalars(data, strides[dim] * elementSize, scalarType, items, n);
+    return;
+  }
   for (int64_t i = 0; i < n; i++) {
     recursive_store(data, sizes, strides, dim + 1, scalarType, elementSize, items[i]);
     data += strides[dim] * elementSize;
@@ -281,6 +377,35 @@ Tensor internal_new_from_data(
   }
 #endif
 
+  if (PyCapsule_IsValid(data, "dltensor")) {
+    TORCH_CHECK(!pin_memory, "Can't pin tensor constructed from a DLPack capsule");
+    // the tensor takes over the capsule, which can't be used again
+    auto tensor = at::fromDLPack((DLManagedTensor*)PyCapsule_GetPointer(data, "dltensor"));
+    PyCapsule_SetName(data, "used_dltensor");
+    const auto& inferred_scalar_type = type_inference ? tensor.scalar_type() : scalar_type;
+    auto device = device_opt.has_value() ? *device_opt : tensor.device();
+    pybind11::gil_scoped_release no_gil;
+    maybe_initialize_cuda(tensor.device());
+    maybe_initialize_cuda(device);
+    return tensor.to(device, inferred_scalar_type, /*non_blocking=*/false, /*copy=*/copy_numpy);
+  }
+
+  // bytes, array.array, memoryview and the other buffers are converted as a
+  // whole, and aren't copied when they already have the requested dtype
+  auto buffer_tensor = tensor_from_buffer(data, /*warn_if_not_writeable=*/!copy_numpy);
+  if (buffer_tensor.defined()) {
+    const auto inferred_scalar_type =
+        type_inference ? infer_buffer_scalar_type(buffer_tensor.scalar_type()) : scalar_type;
+    auto device = device_opt.has_value() ? *device_opt : at::Device(computeDeviceType(dispatch_key));
+    pybind11::gil_scoped_release no_gil;
+    maybe_initialize_cuda(device);
+    if (pin_memory) {
+      return buffer_tensor.to(inferred_scalar_type).pin_memory().to(
+          device, inferred_scalar_type, /*non_blocking=*/false, /*copy=*/false);
+    }
+    return buffer_tensor.to(device, inferred_scalar_type, /*non_blocking=*/false, /*copy=*/copy_numpy);
+  }
+
   auto sizes = compute_sizes(data);
   ScalarType inferred_scalar_type = type_inference ? infer_scalar_type(data) : scalar_type;
   // This exists to prevent us from tracing the call to empty().  The actual
@@ -709,6 +834,83 @@ void _validate_sparse_coo_tensor_args(c10::DispatchKey dispatch_key, at::ScalarT
   at::native::_validate_sparse_coo_tensor_args(indices, values, r.intlist(2));
 }
 
+namespace {
+
+// The indices of a sparse CSR tensor keep the dtype of an index tensor, so
+// that int32 indices can be handed to the sparse BLAS libraries as they are;
+// Python sequences of ints are inferred as int64.
+Tensor internal_new_csr_indices_from_data(const Tensor& values, PyObject* data) {
+  return internal_new_from_data(legacyExtractDispatchKey(values.key_set()), kLong, values.device(), data,
+                                /*copy_variables=*/false, /*copy_numpy=*/true,
+                                /*type_inference=*/true);
+}
+
+} // namespace
+
+Tensor sparse_csr_tensor_ctor(c10::DispatchKey dispatch_key, at::ScalarType scalar_type, PyObject* args, PyObject* kwargs) {
+  static PythonArgParser parser({
+    "sparse_csr_tensor(PyObject* crow_indices, PyObject* col_indices, PyObject* values, *, ScalarType dtype=None, Device? device=None, bool requires_grad=False)",
+    "sparse_csr_tensor(PyObject* crow_indices, PyObject* col_indices, PyObject* values, IntArrayRef size, *, ScalarType dtype=None, Device? device=None, bool requires_grad=False)",
+  });
+
+  ParsedArgs<7> parsed_args;
+  auto r = parser.parse(args, kwargs, parsed_args);
+  if (r.idx == 0) {
+    bool type_inference = r.isNone(3);
+    const auto inferred_dispatch_key = denseTypeIdWithDefault(r, 4, dispatch_key);
+    const auto inferred_scalar_type = r.scalartypeWithDefault(3, scalar_type);
+    at::OptionalDeviceGuard device_guard(r.deviceOptional(4));
+    // if no dtype provided, infer type based on value type.
+    Tensor values = internal_new_from_data(inferred_dispatch_key, inferred_scalar_type, r.deviceOptional(4), r.pyobject(2),
+                                           /*copy_variables=*/false, /*copy_numpy=*/true,
+                                           /*type_inference=*/type_inference);
+    Tensor crow_indices = internal_new_csr_indices_from_data(values, r.pyobject(0));
+    Tensor col_indices = internal_new_csr_indices_from_data(values, r.pyobject(1));
+    return at::sparse_csr_tensor(crow_indices, col_indices, values, values.options().layout(at::kSparseCsr)).set_requires_grad(r.toBool(5));
+  } else if (r.idx == 1) {
+    bool type_inference = r.isNone(4);
+    const auto inferred_dispatch_key = denseTypeIdWithDefault(r, 5, dispatch_key);
+    const auto inferred_scalar_type = r.scalartypeWithDefault(4, scalar_type);
+    at::OptionalDeviceGuard device_guard(r.deviceOptional(5));
+    Tensor values = internal_new_from_data(inferred_dispatch_key, inferred_scalar_type, r.deviceOptional(5), r.pyobject(2),
+                                           /*copy_variables=*/false, /*copy_numpy=*/true,
+                                           /*type_inference=*/type_inference);
+    Tensor crow_indices = internal_new_csr_indices_from_data(values, r.pyobject(0));
+    Tensor col_indices = internal_new_csr_indices_from_data(values, r.pyobject(1));
+    return at::sparse_csr_tensor(crow_indices, col_indices, values, r.intlist(3), values.options().layout(at::kSparseCsr)).set_requires_grad(r.toBool(6));
+  }
+  throw std::runtime_error("sparse_csr_tensor(): invalid arguments");
+}
+
+Tensor _sparse_csr_tensor_unsafe_ctor(c10::DispatchKey dispatch_key, at::ScalarType scalar_type, PyObject* args, PyObject* kwargs) {
+  enum {
+    ARG_CROW_INDICES = 0,
+    ARG_COL_INDICES,
+    ARG_VALUES,
+    ARG_SIZE,
+    ARG_TYPE,
+    ARG_DEVICE,
+    ARG_REQUIRES_GRAD,
+    ARGS_COUNT
+  };
+  static PythonArgParser parser({
+    "_sparse_csr_tensor_unsafe(PyObject* crow_indices, PyObject* col_indices, PyObject* values, IntArrayRef size, *, ScalarType dtype=None, Device? device=None, bool requires_grad=False)",
+  });
+
+  ParsedArgs<ARGS_COUNT> parsed_args;
+  auto r = parser.parse(args, kwargs, parsed_args);
+  bool type_inference = r.isNone(ARG_TYPE);
+  const auto inferred_dispatch_key = denseTypeIdWithDefault(r, ARG_DEVICE, dispatch_key);
+  const auto inferred_scalar_type = r.scalartypeWithDefault(ARG_TYPE, scalar_type);
+  at::OptionalDeviceGuard device_guard(r.deviceOptional(ARG_DEVICE));
+  Tensor values = internal_new_from_data(inferred_dispatch_key, inferred_scalar_type, r.deviceOptional(ARG_DEVICE), r.pyobject(ARG_VALUES),
+                                         /*copy_variables=*/false, /*copy_numpy=*/true,
+                                         /*type_inference=*/type_inference);
+  Tensor crow_indices = internal_new_csr_indices_from_data(values, r.pyobject(ARG_CROW_INDICES));
+  Tensor col_indices = internal_new_csr_indices_from_data(values, r.pyobject(ARG_COL_INDICES));
+  return at::_sparse_csr_tensor_unsafe(crow_indices, col_indices, values, r.intlist(ARG_SIZE), values.options().layout(at::kSparseCsr)).set_requires_grad(r.toBool(ARG_REQUIRES_GRAD));
+}
+
 Tensor tensor_ctor(c10::DispatchKey dispatch_key, at::ScalarType scalar_type, PyObject* args, PyObject* kwargs) {
   static PythonArgParser parser({
     "tensor(PyObject* data, *, ScalarType dtype=None, Device? device=None, bool pin_memory=False, bool requires_grad=False, DimnameList? names=None)",
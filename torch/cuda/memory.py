@@ -123,21 +123,21 @@ def memory_stats(device: Union[Device, int] = None) -> Dict[str, Any]:
 
     Core statistics:
 
-    - ``"allocated.{all,large_pool,small_pool}.{current,peak,allocated,freed}"``:
+    - ``"allocated.{all,large_pool,small_pool,slab_pool}.{current,peak,allocated,freed}"``:
       number of allocation requests received by the memory allocator.
-    - ``"allocated_bytes.{all,large_pool,small_pool}.{current,peak,allocated,freed}"``:
+    - ``"allocated_bytes.{all,large_pool,small_pool,slab_pool}.{current,peak,allocated,freed}"``:
       amount of allocated memory.
-    - ``"segment.{all,large_pool,small_pool}.{current,peak,allocated,freed}"``:
+    - ``"segment.{all,large_pool,small_pool,slab_pool}.{current,peak,allocated,freed}"``:
       number of reserved segments from ``cudaMalloc()``.
-    - ``"reserved_bytes.{all,large_pool,small_pool}.{current,peak,allocated,freed}"``:
+    - ``"reserved_bytes.{all,large_pool,small_pool,slab_pool}.{current,peak,allocated,freed}"``:
       amount of reserved memory.
-    - ``"active.{all,large_pool,small_pool}.{current,peak,allocated,freed}"``:
+    - ``"active.{all,large_pool,small_pool,slab_pool}.{current,peak,allocated,freed}"``:
       number of active memory blocks.
-    - ``"active_bytes.{all,large_pool,small_pool}.{current,peak,allocated,freed}"``:
+    - ``"active_bytes.{all,large_pool,small_pool,slab_pool}.{current,peak,allocated,freed}"``:
       amount of active memory.
-    - ``"inactive_split.{all,large_pool,small_pool}.{current,peak,allocated,freed}"``:
+    - ``"inactive_split.{all,large_pool,small_pool,slab_pool}.{current,peak,allocated,freed}"``:
       number of inactive, non-releasable memory blocks.
-    - ``"inactive_split_bytes.{all,large_pool,small_pool}.{current,peak,allocated,freed}"``:
+    - ``"inactive_split_bytes.{all,large_pool,small_pool,slab_pool}.{current,peak,allocated,freed}"``:
       amount of inactive, non-releasable memory.
 
     For these core statistics, values are broken down as follows.
@@ -149,6 +149,9 @@ def memory_stats(device: Union[Device, int] = None) -> Dict[str, Any]:
       (as of October 2019, for size >= 1MB allocations).
     - ``small_pool``: statistics for the small allocation pool
       (as of October 2019, for size < 1MB allocations).
+    - ``slab_pool``: statistics for the slab allocation pool, used instead
+      of the small pool for size <= 128KB allocations when
+      ``PYTORCH_CUDA_SLAB_ALLOCATOR=1`` is set.
 
     Metric type:
 
@@ -397,6 +400,44 @@ def memory_snapshot():
     return torch._C._cuda_memorySnapshot()
 
 
+def host_memory_stats() -> Dict[str, Any]:
+    r"""Returns a dictionary of statistics of the caching allocator of pinned
+    host memory, used e.g. by :meth:`~torch.Tensor.pin_memory`.
+
+    The return value of this function is a dictionary of statistics, each of
+    which is a non-negative integer:
+
+    - ``"allocation.{current,peak,allocated,freed}"``:
+      number of allocation requests received by the allocator.
+    - ``"allocated_bytes.{current,peak,allocated,freed}"``:
+      amount of allocated memory, with the requests rounded up to the size
+      classes of the allocator.
+    - ``"segment.{current,peak,allocated,freed}"``:
+      number of blocks allocated with ``cudaHostAlloc()``.
+    - ``"reserved_bytes.{current,peak,allocated,freed}"``:
+      amount of reserved memory.
+
+    The meaning of ``current``, ``peak``, ``allocated`` and ``freed`` is the
+    same as in :func:`~torch.cuda.memory_stats`.
+    """
+    result = []
+    for name, stat in torch._C._cuda_hostMemoryStats().items():
+        for key, value in stat.items():
+            result.append((name + "." + key, value))
+    result.sort()
+    return collections.OrderedDict(result)
+
+
+def reset_accumulated_host_memory_stats() -> None:
+    r"""Resets the "allocated" and "freed" stats of :func:`~torch.cuda.host_memory_stats`."""
+    torch._C._cuda_resetAccumulatedHostMemoryStats()
+
+
+def reset_peak_host_memory_stats() -> None:
+    r"""Resets the "peak" stats of :func:`~torch.cuda.host_memory_stats`."""
+    torch._C._cuda_resetPeakHostMemoryStats()
+
+
 def memory_summary(device: Union[Device, int] = None, abbreviated: bool = False) -> str:
     r"""Returns a human-readable printout of the current memory allocator
     statistics for a given device.
@@ -465,6 +506,7 @@ def memory_summary(device: Union[Device, int] = None, abbreviated: bool = False)
         if not abbreviated:
             submetrics.append(("large_pool", "      from large pool"))
             submetrics.append(("small_pool", "      from small pool"))
+            submetrics.append(("slab_pool", "      from slab pool"))
 
         current_prefval, peak_prefval, allocated_prefval, freed_prefval = None, None, None, None
 
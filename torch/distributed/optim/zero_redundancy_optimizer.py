@@ -155,6 +155,11 @@ class ZeroRedundancyOptimizer(Optimizer):
 
         self.should_bucket_param: List[bool] = []
         self.work_handles: Deque[Any] = deque()
+
+        # Broadcasts of updated parameters not waited for yet, see
+        # `overlap_param_sync_with_forward`
+        self._overlap_with_forward = False
+        self._pending_param_works: Dict[torch.Tensor, Any] = {}
         self._setup_bucket_strategy()
         self.initialized = True
 
@@ -187,11 +192,53 @@ class ZeroRedundancyOptimizer(Optimizer):
             # Update the bucketing strategy accordingly
             self._setup_bucket_strategy()
 
+    def overlap_param_sync_with_forward(self, module: torch.nn.Module) -> None:
+        """Defers waiting for the broadcasts of the updated parameters to the
+        next forward pass of ``module``.
+
+        After this call, :meth:`step` returns as soon as the broadcasts of the
+        updated shards are issued, and every submodule of ``module`` waits for
+        the broadcasts of its own parameters right before its forward runs.
+        Communication then overlaps with the forward of the submodules that
+        come before. The broadcasts of parameters that the forward does not
+        use are waited for by the next :meth:`step`.
+
+        Arguments:
+            module (torch.nn.Module): the module whose parameters are
+                optimized, usually the model wrapped by
+                :class:`DistributedDataParallel`
+
+        .. warning: Between a step and the next forward of ``module``, the
+            parameters may not be up to date. Call :meth:`sync_params` before
+            reading them anywhere else, e.g. to checkpoint the model.
+        """
+
+        def wait_for_params(submodule: torch.nn.Module, inputs: Any) -> None:
+            for param in submodule.parameters(recurse=False):
+                work = self._pending_param_works.pop(param, None)
+                if work is not None:
+                    work.wait()
+
+        for submodule in module.modules():
+            submodule.register_forward_pre_hook(wait_for_params)
+        self._overlap_with_forward = True
+
+    def sync_params(self) -> None:
+        """Waits for the broadcasts of the parameters updated by the last
+        :meth:`step`, which is only needed after
+        :meth:`overlap_param_sync_with_forward`."""
+
+        for work in self._pending_param_works.values():
+            work.wait()
+        self._pending_param_works.clear()
+
     def consolidate_state_dict(self, recipient_rank: int = 0) -> None:
         """Update the consolidated state_dict list, one per rank.
 
         .. warning: This needs to be called on all replicas"""
 
+        self.sync_params()
+
         # Sync lr and other attributes in case its been updated
         self._update_param_groups()
 
@@ -311,6 +358,9 @@ class ZeroRedundancyOptimizer(Optimizer):
 
         .. note: Any extra parameter is passed to the base optimizer as-is"""
 
+        # The parameters of this shard must be up to date before updating them
+        self.sync_params()
+
         # Sync oss param_groups attributes in case they've been updated by a scheduler.
         self._update_param_groups()
 
@@ -455,19 +505,29 @@ class ZeroRedundancyOptimizer(Optimizer):
                 global_src_rank = _get_global_rank(self.group, src_rank)
 
                 # Direct broadcasts only
+                bucket_params = []
                 for param in params:
                     if not self.should_bucket_param[i_param]:
-                        self.work_handles.append(
-                            dist.broadcast(tensor=param.data, src=global_src_rank, group=self.group, async_op=True)
-                        )
+                        work = dist.broadcast(tensor=param.data, src=global_src_rank, group=self.group, async_op=True)
+                        self.work_handles.append(work)
+                        self._pending_param_works[param] = work
+                    else:
+                        bucket_params.append(param)
                     i_param += 1
 
                 # Bucket broadcasts
-                self.work_handles.append(
-                    dist.broadcast(tensor=bucket, src=global_src_rank, group=self.group, async_op=True)
-                )
+                work = dist.broadcast(tensor=bucket, src=global_src_rank, group=self.group, async_op=True)
+                self.work_handles.append(work)
+                for param in bucket_params:
+                    self._pending_param_works[param] = work
+
+        if self._overlap_with_forward:
+            # Waited for by the forward pre-hooks, or by `sync_params`
+            self.work_handles.clear()
+            return
 
         # Consume all async calls
+        self._pending_param_works.clear()
         while len(self.work_handles) > 0:
             work_handle = self.work_handles.popleft()
             work_handle.wait()
@@ -11,6 +11,8 @@ class ZeroRedundancyOptimizer(Optimizer):
     def per_device_params(self) -> Dict[torch.device, List[List[Parameter]]]: ...
     def param_to_rank(self) -> Dict[torch.Tensor, int]: ...
     def local_state_dict(self) -> Dict[Any, Any]: ...
+    def overlap_param_sync_with_forward(self, module: torch.nn.Module) -> None: ...
+    def sync_params(self) -> None: ...
     def consolidate_state_dict(self, recipient_rank: int = 0) -> None: ...
     def load_local_state_dict(self, state_dict: Dict[Any, Any]) -> None: ...
     def clip_grad_norm(self, max_norm: Union[float, int], norm_type: Union[float, int] = 2.0) -> torch.Tensor: ...
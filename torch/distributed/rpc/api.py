@@ -27,6 +27,7 @@ from torch._C._distributed_rpc import (
     _is_current_rpc_agent_set,
     _reset_current_rpc_agent,
     _set_and_start_rpc_agent,
+    _to_here_batch,
 )
 
 from .internal import (
@@ -882,3 +883,48 @@ def rpc_async(to, func, args=None, kwargs=None, timeout=UNSET_RPC_TIMEOUT):
     if hasattr(_thread_local_var, "future_list"):
         _thread_local_var.future_list.append(fut)
     return fut
+
+
+@_require_initialized
+def fetch_rrefs(rrefs, timeout=UNSET_RPC_TIMEOUT):
+    r"""
+    Blocking call that copies the values of ``rrefs`` from their owners to the
+    local node, like calling :meth:`~torch.distributed.rpc.RRef.to_here` on
+    each of them, but with a single RPC to each owner. The values of the
+    ``RRef`` s owned by the current node are returned without copying them.
+
+    Args:
+        rrefs (list): the ``RRef`` s whose values to fetch.
+        timeout (float, optional): timeout in seconds for the RPCs to the
+                                   owners. If they do not complete within this
+                                   timeframe, an exception indicating so will be
+                                   raised. If this argument is not provided, the
+                                   default RPC timeout (60s) will be used.
+
+    Returns:
+        A list of the values of ``rrefs``, in the same order.
+
+    Example::
+        Make sure that ``MASTER_ADDR`` and ``MASTER_PORT`` are set properly
+        on both workers. Refer to :meth:`~torch.distributed.init_process_group`
+        API for more details. For example,
+
+        >>> export MASTER_ADDR=localhost
+        >>> export MASTER_PORT=5678
+
+        Then run the following code in two different processes:
+
+        >>> # On worker 0:
+        >>> import torch
+        >>> import torch.distributed.rpc as rpc
+        >>> rpc.init_rpc("worker0", rank=0, world_size=2)
+        >>> rrefs = [rpc.remote("worker1", torch.add, args=(torch.ones(2), i)) for i in range(100)]
+        >>> values = rpc.fetch_rrefs(rrefs)
+        >>> rpc.shutdown()
+
+        >>> # On worker 1:
+        >>> import torch.distributed.rpc as rpc
+        >>> rpc.init_rpc("worker1", rank=1, world_size=2)
+        >>> rpc.shutdown()
+    """
+    return _to_here_batch(list(rrefs), timeout)
@@ -443,7 +443,9 @@ void ProcessGroupGloo::RecvWork::abort() {
 }
 
 ProcessGroupGloo::Options::Options()
-    : timeout(std::chrono::milliseconds(10 * 1000)), threads(2) {}
+    : timeout(std::chrono::milliseconds(10 * 1000)),
+      threads(2),
+      allreduceChunkBytes(4 * 1024 * 1024) {}
 
 namespace {
 
@@ -569,6 +571,7 @@ ProcessGroupGloo::ProcessGroupGloo(
     : ProcessGroup(rank, size),
       store_(new GlooStore(store)),
       stop_(false),
+      allreduceChunkBytes_(options.allreduceChunkBytes),
       collectiveCounter_(0) {
   auto& devices = options.devices;
   if (devices.empty()) {
@@ -824,8 +827,9 @@ class AsyncAllreduceWork : public ProcessGroupGloo::AsyncWork {
       const std::shared_ptr<gloo::Context>& context,
       std::vector<at::Tensor>& inputs,
       ReduceOp reduceOp,
-      uint32_t tag)
-      : ProcessGroupGloo::AsyncWork("gloo:all_reduce"),
+      uint32_t tag,
+      const char* profilingTitle = "gloo:all_reduce")
+      : ProcessGroupGloo::AsyncWork(profilingTitle),
       context(context), inputs(inputs), reduceOp(reduceOp), tag(tag) {}
 
   std::shared_ptr<gloo::Context> context;
@@ -873,6 +877,74 @@ class AsyncAllreduceWork : public ProcessGroupGloo::AsyncWork {
   std::vector<at::Tensor> outputs_;
 };
 
+// An allreduce split into chunks (see Options::allreduceChunkBytes). Every
+// chunk is a view of the input allreduced in place by an AsyncAllreduceChunkWork
+// with a tag of its own, so the chunks run on different worker threads and
+// the transfer of one chunk overlaps the reduction of another. This work is
+// completed by the last chunk to finish.
+class AsyncChunkedAllreduceWork : public ProcessGroup::Work {
+ public:
+  AsyncChunkedAllreduceWork(std::vector<at::Tensor>& inputs, size_t chunks)
+      : ProcessGroup::Work(-1, OpType::ALLREDUCE, "gloo:all_reduce"),
+        outputs_(inputs),
+        pending_(chunks) {}
+
+  void chunkFinished(const std::exception_ptr& eptr) {
+    std::lock_guard<std::mutex> lock(chunkMutex_);
+    if (eptr && !eptr_) {
+      eptr_ = eptr;
+    }
+    if (--pending_ == 0) {
+      finish(eptr_);
+    }
+  }
+
+  std::vector<at::Tensor> result() override {
+    TORCH_CHECK(
+        isCompleted(),
+        "Work needs to be completed before calling result(). "
+        "Should call wait() before result().");
+    return outputs_;
+  }
+
+ protected:
+  std::vector<at::Tensor> outputs_;
+  std::mutex chunkMutex_;
+  size_t pending_;
+  std::exception_ptr eptr_;
+};
+
+class AsyncAllreduceChunkWork : public AsyncAllreduceWork {
+ public:
+  AsyncAllreduceChunkWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& inputs,
+      ReduceOp reduceOp,
+      uint32_t tag,
+      c10::intrusive_ptr<AsyncChunkedAllreduceWork> parent)
+      : AsyncAllreduceWork(
+            context, inputs, reduceOp, tag, "gloo:all_reduce_chunk"),
+        parent(std::move(parent)) {}
+
+  c10::intrusive_ptr<AsyncChunkedAllreduceWork> parent;
+
+  void run() override {
+    std::exception_ptr eptr;
+    try {
+      AsyncAllreduceWork::run();
+    } catch (...) {
+      eptr = std::current_exception();
+    }
+    // Release the parent before rethrowing, the chunk itself is finished
+    // by AsyncWork::execute.
+    auto chunked = std::move(parent);
+    chunked->chunkFinished(eptr);
+    if (eptr) {
+      std::rethrow_exception(eptr);
+    }
+  }
+};
+
 class AsyncAllreduceCoalescedWork : public AsyncAllreduceWork {
  public:
   AsyncAllreduceCoalescedWork(
@@ -1301,6 +1373,21 @@ class AsyncSparseAllreduceCUDAWork : public AsyncSparseAllreduceWork {
 
 } // namespace
 
+size_t ProcessGroupGloo::allreduceChunks(
+    const std::vector<at::Tensor>& inputs) const {
+  if (allreduceChunkBytes_ == 0 || threads_.size() < 2 || inputs.size() != 1) {
+    return 1;
+  }
+  const auto& tensor = inputs[0];
+  if (!tensor.device().is_cpu() || tensor.layout() != c10::kStrided ||
+      !tensor.is_contiguous()) {
+    return 1;
+  }
+  const size_t nbytes = tensor.numel() * tensor.element_size();
+  return std::max<size_t>(
+      1, std::min(threads_.size(), nbytes / allreduceChunkBytes_));
+}
+
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
     std::vector<at::Tensor>& inputs,
     const AllreduceOptions& opts) {
@@ -1330,6 +1417,22 @@ c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
         "(allreduce of sparse tensors only works with ReduceOp.SUM)");
   }
 
+  const auto chunks = allreduceChunks(inputs);
+  if (chunks > 1) {
+    // Chunking consumes one tag per chunk, which is the same on all processes
+    // since the inputs and the options are.
+    auto flat = inputs[0].view({-1});
+    auto chunked =
+        c10::make_intrusive<AsyncChunkedAllreduceWork>(inputs, chunks);
+    for (const auto& chunk : flat.chunk(chunks)) {
+      auto tag = nextTag();
+      std::vector<at::Tensor> chunkInputs = {chunk};
+      enqueue(c10::make_intrusive<AsyncAllreduceChunkWork>(
+          getContext(tag), chunkInputs, opts.reduceOp, tag, chunked));
+    }
+    return chunked;
+  }
+
   c10::intrusive_ptr<AsyncWork> work;
   auto tag = nextTag();
   auto context = getContext(tag);
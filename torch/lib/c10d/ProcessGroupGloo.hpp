@@ -133,6 +133,12 @@ class ProcessGroupGloo : public ProcessGroup {
     std::vector<std::shared_ptr<::gloo::transport::Device>> devices;
     std::chrono::milliseconds timeout;
     int threads;
+
+    // A CPU allreduce of a single dense tensor of at least twice this many
+    // bytes is split into chunks that are allreduced in parallel by the
+    // worker threads, at most one chunk per thread. Like the number of
+    // threads, it must be the same on all processes. 0 disables chunking.
+    size_t allreduceChunkBytes;
   };
 
   const std::string getBackendName() const override {
@@ -246,6 +252,9 @@ class ProcessGroupGloo : public ProcessGroup {
   std::vector<std::thread> threads_;
   bool stop_;
 
+  // See Options::allreduceChunkBytes.
+  size_t allreduceChunkBytes_;
+
   // Incremented for every collective we kick off.
   // The value is used as tag for collective operations. Collectives are kicked
   // off in identical order across processes. Therefore the tag can be used
@@ -260,6 +269,10 @@ class ProcessGroupGloo : public ProcessGroup {
   // to contexts being used in a round-robin fashion.
   std::shared_ptr<::gloo::Context> getContext(uint32_t tag);
 
+  // Returns the number of chunks an allreduce of these inputs is split in,
+  // 1 if it is not split.
+  size_t allreduceChunks(const std::vector<at::Tensor>& inputs) const;
+
   // Entrypoint for worker threads.
   void runLoop(int workerIndex);
 
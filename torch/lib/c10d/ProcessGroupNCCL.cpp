@@ -405,7 +405,10 @@ ProcessGroupNCCL::ProcessGroupNCCL(
       ncclCommCounter_(0),
       terminateProcessGroup_(false),
       opTimeout_(options->opTimeout),
-      isHighPriorityStream_(options->isHighPriorityStream) {
+      isHighPriorityStream_(options->isHighPriorityStream),
+      localSize_(options->localSize),
+      alltoallBytesSent_(size, 0),
+      alltoallBytesReceived_(size, 0) {
   TORCH_CHECK(at::cuda::getNumGPUs() != 0,
     "ProcessGroupNCCL is only supported with GPUs, no GPUs found!");
   blockingWait_ = parseEnvVarFlag(NCCL_BLOCKING_WAIT);
@@ -432,7 +435,8 @@ ProcessGroupNCCL::ProcessGroupNCCL(
             << "\nNCCL_ASYNC_ERROR_HANDLING: " << asyncErrorHandling_
             << "\nNCCL_BLOCKING_WAIT: " << blockingWait_
             << "\nTIMEOUT(ms): " << opTimeout_.count()
-            << "\nUSE_HIGH_PRIORITY_STREAM: " << isHighPriorityStream_;
+            << "\nUSE_HIGH_PRIORITY_STREAM: " << isHighPriorityStream_
+            << "\nLOCAL_SIZE: " << localSize_;
 }
 
 ProcessGroupNCCL::~ProcessGroupNCCL() {
@@ -851,6 +855,65 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
   return devNCCLCommMap_[devicesKey];
 }
 
+std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::
+    getHierarchicalNCCLComms(
+        const std::string& devicesKey,
+        const at::Device& device) {
+  const auto key = "hierarchical:" + devicesKey;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (devNCCLCommMap_.find(key) != devNCCLCommMap_.end()) {
+      return devNCCLCommMap_[key];
+    }
+  }
+
+  const int localRank = rank_ % localSize_;
+  const int node = rank_ / localSize_;
+  const auto suffix = std::to_string(hierarchicalCommCounter_++);
+
+  // Like broadcastUniqueNCCLID, from the first rank of every communicator to
+  // the other ones.
+  auto exchangeUniqueNCCLID = [&](const std::string& storeKey, bool isRoot) {
+    ncclUniqueId ncclID;
+    if (isRoot) {
+      C10D_NCCL_CHECK(ncclGetUniqueId(&ncclID));
+      auto vec = std::vector<uint8_t>(
+          reinterpret_cast<uint8_t*>(&ncclID),
+          reinterpret_cast<uint8_t*>(&ncclID) + NCCL_UNIQUE_ID_BYTES);
+      store_->set(storeKey, vec);
+    } else {
+      auto vec = store_->get(storeKey);
+      TORCH_CHECK(vec.size() == NCCL_UNIQUE_ID_BYTES);
+      std::memcpy(&ncclID, vec.data(), vec.size());
+    }
+    return ncclID;
+  };
+  ncclUniqueId intraID = exchangeUniqueNCCLID(
+      "hierarchical_intra_" + std::to_string(node) + "_" + suffix,
+      localRank == 0);
+  ncclUniqueId interID = exchangeUniqueNCCLID(
+      "hierarchical_inter_" + std::to_string(localRank) + "_" + suffix,
+      node == 0);
+
+  // Every process creates the communicator of its node first, so creating
+  // them one after the other does not deadlock.
+  at::cuda::OptionalCUDAGuard gpuGuard(device);
+  std::vector<std::shared_ptr<NCCLComm>> ncclComms = {
+      NCCLComm::create(localSize_, localRank, intraID),
+      NCCLComm::create(size_ / localSize_, node, interID)};
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  ncclIdToCommMap_.emplace(
+      buildNcclUniqueIdStr(intraID),
+      std::vector<std::shared_ptr<NCCLComm>>{ncclComms[0]});
+  ncclIdToCommMap_.emplace(
+      buildNcclUniqueIdStr(interID),
+      std::vector<std::shared_ptr<NCCLComm>>{ncclComms[1]});
+  // Cached with the other communicators, so that the watchdog checks them.
+  devNCCLCommMap_.emplace(key, std::move(ncclComms));
+  return devNCCLCommMap_[key];
+}
+
 namespace {
 
 // Check validity of tensor
@@ -977,7 +1040,8 @@ void ProcessGroupNCCL::workEnqueue(
 }
 ProcessGroupNCCL::Options::Options()
     : opTimeout(kProcessGroupNCCLOpTimeoutMillis),
-      isHighPriorityStream(false) {}
+      isHighPriorityStream(false),
+      localSize(0) {}
 
 template <typename Fn, typename PreProcess, typename PostProcess>
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
@@ -1180,11 +1244,24 @@ c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupNCCL::pointToPoint(
       [](std::vector<at::cuda::CUDAStream>&) {});
 }
 
+bool ProcessGroupNCCL::useHierarchicalAllreduce(
+    const std::vector<at::Tensor>& tensors) const {
+  // Not within groupStart() and groupEnd(), whose NCCL calls may run in any
+  // order.
+  return localSize_ > 1 && size_ > localSize_ && size_ % localSize_ == 0 &&
+      tensors.size() == 1 && tensors[0].numel() >= localSize_ &&
+      ncclActiveGroupCounter_ == 0;
+}
+
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
     std::vector<at::Tensor>& tensors,
     const AllreduceOptions& opts) {
   check_gpu_tensors(tensors);
 
+  if (useHierarchicalAllreduce(tensors)) {
+    return hierarchicalAllreduce(tensors, opts);
+  }
+
   return collective(
       tensors,
       tensors,
@@ -1205,6 +1282,88 @@ c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
       "nccl:all_reduce");
 }
 
+// Note [Hierarchical allreduce]
+// A flat allreduce over several nodes runs one NCCL ring through all the GPUs,
+// which crosses the links between the nodes much more than needed when they
+// are slower than the links within a node. When Options::localSize is set,
+// allreduce of one tensor per process instead
+//   1. reduce-scatters the tensor within the node, every local rank getting
+//      the reduction over the node of one shard of it,
+//   2. allreduces every shard between the ranks of the same local rank on all
+//      nodes, so that only 1 / localSize of the tensor leaves the node per
+//      rank,
+//   3. allgathers the shards within the node.
+// The three steps run in place, one after the other on the NCCL stream of the
+// tensor, after the NCCL group of collective(). The last numel % localSize
+// elements are allreduced by the flat communicator within the group.
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupNCCL::hierarchicalAllreduce(
+    std::vector<at::Tensor>& tensors,
+    const AllreduceOptions& opts) {
+  auto& tensor = tensors[0];
+  const auto devices = getDeviceList(tensors);
+  auto& hierarchicalComms =
+      getHierarchicalNCCLComms(getKeyFromDevices(devices), devices[0]);
+  const int localRank = rank_ % localSize_;
+  const int64_t shardNumel = tensor.numel() / localSize_;
+  const int64_t tailOffset = shardNumel * localSize_;
+  const size_t elementSize = tensor.element_size();
+  const auto dataType = getNcclDataType(tensor.scalar_type());
+  const auto reduceOp = getNcclReduceOp(opts.reduceOp, tensor);
+
+  return collective(
+      tensors,
+      tensors,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        const int64_t tailNumel = input.numel() - tailOffset;
+        if (tailNumel == 0) {
+          return ncclSuccess;
+        }
+        return ncclAllReduce(
+            static_cast<char*>(input.data_ptr()) + tailOffset * elementSize,
+            static_cast<char*>(output.data_ptr()) + tailOffset * elementSize,
+            tailNumel,
+            dataType,
+            reduceOp,
+            comm,
+            stream.stream());
+      },
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {},
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {
+        at::cuda::CUDAStreamGuard guard(ncclStreams[0]);
+        auto stream = ncclStreams[0].stream();
+        auto data = static_cast<char*>(tensor.data_ptr());
+        auto shard = data + localRank * shardNumel * elementSize;
+        C10D_NCCL_CHECK(ncclReduceScatter(
+            data,
+            shard,
+            shardNumel,
+            dataType,
+            reduceOp,
+            hierarchicalComms[0]->getNcclComm(),
+            stream));
+        C10D_NCCL_CHECK(ncclAllReduce(
+            shard,
+            shard,
+            shardNumel,
+            dataType,
+            reduceOp,
+            hierarchicalComms[1]->getNcclComm(),
+            stream));
+        C10D_NCCL_CHECK(ncclAllGather(
+            shard,
+            data,
+            shardNumel,
+            dataType,
+            hierarchicalComms[0]->getNcclComm(),
+            stream));
+      },
+      OpType::ALLREDUCE,
+      "nccl:all_reduce");
+}
+
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce_coalesced(
     std::vector<at::Tensor>& tensors,
     const AllreduceCoalescedOptions& opts) {
@@ -1419,6 +1578,12 @@ c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall_base(
   check_gpu_single_tensor(outputTensor);
   check_gpu_single_tensor(inputTensor);
   if (outputSplitSizes.size() == 0 && inputSplitSizes.size() == 0) {
+    recordAlltoallBytes(
+        std::vector<size_t>(size_, inputTensor.nbytes() / size_),
+        std::vector<size_t>(size_, outputTensor.nbytes() / size_));
+    if (useHierarchicalAlltoall(inputTensor)) {
+      return hierarchicalAlltoall(outputTensor, inputTensor);
+    }
     std::vector<at::Tensor> inputTensors = {inputTensor};
     std::vector<at::Tensor> outputTensors = {outputTensor};
     return collective(
@@ -1444,6 +1609,20 @@ c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall_base(
   } else {
     c10d::checkSplitSizes(inputSplitSizes, inputTensor, size_);
     c10d::checkSplitSizes(outputSplitSizes, outputTensor, size_);
+    {
+      std::vector<size_t> sentBytes(size_);
+      std::vector<size_t> receivedBytes(size_);
+      std::vector<size_t> offsets(size_);
+      c10d::computeLengthsAndOffsets(
+          inputSplitSizes, inputTensor, &sentBytes, &offsets);
+      c10d::computeLengthsAndOffsets(
+          outputSplitSizes, outputTensor, &receivedBytes, &offsets);
+      for (int r = 0; r < size_; ++r) {
+        sentBytes[r] *= inputTensor.element_size();
+        receivedBytes[r] *= outputTensor.element_size();
+      }
+      recordAlltoallBytes(sentBytes, receivedBytes);
+    }
     std::vector<at::Tensor> inputTensors = {inputTensor};
     std::vector<at::Tensor> outputTensors = {outputTensor};
     return collective(
@@ -1482,6 +1661,77 @@ c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall_base(
   }
 }
 
+bool ProcessGroupNCCL::useHierarchicalAlltoall(const at::Tensor& input) const {
+  // Not within groupStart() and groupEnd(), see useHierarchicalAllreduce().
+  return localSize_ > 1 && size_ > localSize_ && size_ % localSize_ == 0 &&
+      input.numel() % size_ == 0 && ncclActiveGroupCounter_ == 0;
+}
+
+// Note [Hierarchical alltoall]
+// A flat alltoall sends size - 1 messages per rank, most of them over the
+// links between the nodes, and each of them small when the group is large.
+// When Options::localSize is set, an equal-split alltoall_base instead
+//   1. alltoalls within the node, every local rank getting from the ranks of
+//      its node the chunks they send to the ranks of its local rank on all
+//      nodes,
+//   2. alltoalls between the ranks of the same local rank on all nodes, every
+//      message aggregating the localSize chunks of the node for one remote
+//      rank.
+// Every rank thus sends numNodes - 1 messages between the nodes instead of
+// size - localSize, each localSize times larger. With the input viewed as
+// [numNodes][localSize][chunk], step 1 is an alltoall of its [localSize]
+// [numNodes][chunk] transpose, and step 2 one of the [numNodes][localSize]
+// [chunk] transpose of the result of step 1, into the output. The steps run
+// on the NCCL stream of the tensors after the (empty) NCCL group of
+// collective(). Uneven splits of alltoall_base need a round trip to exchange
+// the sizes of the aggregated messages, they stay flat.
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupNCCL::hierarchicalAlltoall(
+    at::Tensor& outputTensor,
+    at::Tensor& inputTensor) {
+  std::vector<at::Tensor> inputTensors = {inputTensor};
+  std::vector<at::Tensor> outputTensors = {outputTensor};
+  const auto devices = getDeviceList(inputTensors);
+  auto& hierarchicalComms =
+      getHierarchicalNCCLComms(getKeyFromDevices(devices), devices[0]);
+  const int64_t numNodes = size_ / localSize_;
+
+  return collective(
+      inputTensors,
+      outputTensors,
+      [&](at::Tensor& /* unused */,
+          at::Tensor& /* unused */,
+          ncclComm_t /* unused */,
+          at::cuda::CUDAStream& /* unused */) { return ncclSuccess; },
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {},
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {
+        at::cuda::CUDAStreamGuard guard(ncclStreams[0]);
+        // See [Sync Streams].
+        c10::cuda::CUDACachingAllocator::recordStream(
+            outputTensor.storage().data_ptr(), ncclStreams[0]);
+        // The intermediate tensors are allocated on the NCCL stream, which
+        // is the only one using them.
+        auto staged = inputTensor.view({numNodes, localSize_, -1})
+                          .transpose(0, 1)
+                          .contiguous();
+        auto gathered = at::empty_like(staged);
+        torch::cuda::nccl::all2all_single_equal_split(
+            staged,
+            gathered,
+            localSize_,
+            hierarchicalComms[0]->getNcclComm(),
+            ncclStreams[0]);
+        auto regrouped = gathered.transpose(0, 1).contiguous();
+        torch::cuda::nccl::all2all_single_equal_split(
+            regrouped,
+            outputTensor,
+            numNodes,
+            hierarchicalComms[1]->getNcclComm(),
+            ncclStreams[0]);
+      },
+      OpType::ALLTOALL_BASE,
+      "nccl:all_to_all");
+}
+
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall(
     std::vector<at::Tensor>& outputTensors,
     std::vector<at::Tensor>& inputTensors,
@@ -1493,6 +1743,15 @@ c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall(
     TORCH_CHECK(device == outputTensors[r].device() && device == inputTensors[r].device(),
       "Tensors must be on the same device")
   }
+  {
+    std::vector<size_t> sentBytes(size_);
+    std::vector<size_t> receivedBytes(size_);
+    for (int r = 0; r < size_; r++) {
+      sentBytes[r] = inputTensors[r].nbytes();
+      receivedBytes[r] = outputTensors[r].nbytes();
+    }
+    recordAlltoallBytes(sentBytes, receivedBytes);
+  }
   std::vector<at::Tensor> inputTensor0 = {inputTensors[0]};
   std::vector<at::Tensor> outputTensor0 = {outputTensors[0]};
   return collective(
@@ -1595,6 +1854,26 @@ void ProcessGroupNCCL::groupEnd() {
   --ncclActiveGroupCounter_;
 }
 
+void ProcessGroupNCCL::recordAlltoallBytes(
+    const std::vector<size_t>& sentBytes,
+    const std::vector<size_t>& receivedBytes) {
+  std::lock_guard<std::mutex> lock(alltoallBytesMutex_);
+  for (int r = 0; r < size_; ++r) {
+    alltoallBytesSent_[r] += sentBytes[r];
+    alltoallBytesReceived_[r] += receivedBytes[r];
+  }
+}
+
+std::vector<uint64_t> ProcessGroupNCCL::getAlltoallBytesSent() {
+  std::lock_guard<std::mutex> lock(alltoallBytesMutex_);
+  return alltoallBytesSent_;
+}
+
+std::vector<uint64_t> ProcessGroupNCCL::getAlltoallBytesReceived() {
+  std::lock_guard<std::mutex> lock(alltoallBytesMutex_);
+  return alltoallBytesReceived_;
+}
+
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupNCCL::gather(
     std::vector<std::vector<at::Tensor>>& /* unused */,
     std::vector<at::Tensor>& /* unused */,
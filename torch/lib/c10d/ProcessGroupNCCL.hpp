@@ -194,6 +194,12 @@ class ProcessGroupNCCL : public ProcessGroup {
 
     std::chrono::milliseconds opTimeout;
     bool isHighPriorityStream;
+    // The number of ranks on each node, the ranks of a node being
+    // consecutive. When it is greater than 1 and the group spans several
+    // nodes, allreduce and equal-split alltoall_base communicate within the
+    // nodes and between them separately, see Note [Hierarchical allreduce]
+    // and Note [Hierarchical alltoall]. 0 (the default) disables it.
+    int localSize;
   };
 
   // If you wish to create multiple process groups, each with a potentially
@@ -299,6 +305,12 @@ class ProcessGroupNCCL : public ProcessGroup {
 
   static void groupEnd();
 
+  // The bytes sent to, respectively received from, every rank by the
+  // alltoall* calls of this process group so far, indexed by rank.
+  std::vector<uint64_t> getAlltoallBytesSent();
+
+  std::vector<uint64_t> getAlltoallBytesReceived();
+
   // Unsupported Ops
   c10::intrusive_ptr<ProcessGroup::Work> gather(
       std::vector<std::vector<at::Tensor>>& outputTensors,
@@ -333,6 +345,13 @@ class ProcessGroupNCCL : public ProcessGroup {
       int p2pRank = 0,
       bool isSendRecvSelf = false);
 
+  // Helper that looks up or creates the communicators of the hierarchical
+  // collectives on `device': the one of the ranks of this node, then the one of
+  // the ranks with the same local rank on every node.
+  std::vector<std::shared_ptr<NCCLComm>>& getHierarchicalNCCLComms(
+      const std::string& devicesKey,
+      const at::Device& device);
+
   // Wrapper method which can be overridden for tests.
   virtual std::exception_ptr checkForNCCLErrors(
       const std::vector<std::shared_ptr<NCCLComm>>& ncclComms);
@@ -385,6 +404,25 @@ class ProcessGroupNCCL : public ProcessGroup {
       PreProcess pre,
       PostProcess post);
 
+  // Whether allreduce of `tensors' can be hierarchical.
+  bool useHierarchicalAllreduce(const std::vector<at::Tensor>& tensors) const;
+
+  c10::intrusive_ptr<ProcessGroup::Work> hierarchicalAllreduce(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceOptions& opts);
+
+  // Whether an equal-split alltoall_base of `input' can be hierarchical.
+  bool useHierarchicalAlltoall(const at::Tensor& input) const;
+
+  c10::intrusive_ptr<ProcessGroup::Work> hierarchicalAlltoall(
+      at::Tensor& outputTensor,
+      at::Tensor& inputTensor);
+
+  // Adds the bytes of an alltoall to the per-peer counters.
+  void recordAlltoallBytes(
+      const std::vector<size_t>& sentBytes,
+      const std::vector<size_t>& receivedBytes);
+
   // Checks for NCCL errors on each of the communicators and returns an
   // appropriate exception_ptr (nullptr if no errors).
   static std::exception_ptr checkForNCCLErrorsInternal(
@@ -538,6 +576,20 @@ class ProcessGroupNCCL : public ProcessGroup {
   // Schedule NCCL operations on high priority CUDA streams.
   bool isHighPriorityStream_ = false;
 
+  // The number of ranks on each node for the hierarchical allreduce, 0 if it
+  // is disabled.
+  int localSize_ = 0;
+
+  // The number of pairs of hierarchical communicators created, which scopes
+  // the keys of their ncclUniqueIds in the store.
+  uint64_t hierarchicalCommCounter_{0};
+
+  // The bytes sent to and received from every rank by the alltoall* calls
+  // of this process group, guarded by alltoallBytesMutex_.
+  std::mutex alltoallBytesMutex_;
+  std::vector<uint64_t> alltoallBytesSent_;
+  std::vector<uint64_t> alltoallBytesReceived_;
+
   // The number of active ncclGroupStart() calls. This counter will be increased
   // by 1 when ncclGroupStart() is called and decreased by 1 when ncclGroupEnd()
   // is called.
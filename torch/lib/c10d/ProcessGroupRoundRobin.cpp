@@ -1,18 +1,159 @@
 #include <c10d/ProcessGroupRoundRobin.hpp>
 
+#include <algorithm>
+#include <chrono>
+
 namespace c10d {
 
+namespace {
+
+// Returns the size of the tensors, or 0 if it may differ across processes.
+int64_t bytesOf(const std::vector<at::Tensor>& tensors) {
+  int64_t bytes = 0;
+  for (const auto& tensor : tensors) {
+    if (tensor.is_sparse()) {
+      return 0;
+    }
+    bytes += tensor.numel() * tensor.element_size();
+  }
+  return bytes;
+}
+
+int64_t bytesOf(const std::vector<std::vector<at::Tensor>>& tensorLists) {
+  int64_t bytes = 0;
+  for (const auto& tensors : tensorLists) {
+    const int64_t listBytes = bytesOf(tensors);
+    if (listBytes == 0) {
+      return 0;
+    }
+    bytes += listBytes;
+  }
+  return bytes;
+}
+
+// The work of a call split across process groups, which completes once the
+// work of all of its parts did.
+class SplitWork : public ProcessGroup::Work {
+ public:
+  SplitWork(
+      int rank,
+      OpType opType,
+      std::vector<c10::intrusive_ptr<ProcessGroup::Work>> works,
+      std::vector<at::Tensor> tensors)
+      : Work(rank, opType),
+        works_(std::move(works)),
+        tensors_(std::move(tensors)) {}
+
+  bool isCompleted() override {
+    return std::all_of(works_.begin(), works_.end(), [](const auto& work) {
+      return work->isCompleted();
+    });
+  }
+
+  bool isSuccess() const override {
+    return std::all_of(works_.begin(), works_.end(), [](const auto& work) {
+      return work->isSuccess();
+    });
+  }
+
+  std::exception_ptr exception() const override {
+    for (const auto& work : works_) {
+      if (auto exception = work->exception()) {
+        return exception;
+      }
+    }
+    return nullptr;
+  }
+
+  std::vector<at::Tensor> result() override {
+    return tensors_;
+  }
+
+  void synchronize() override {
+    for (const auto& work : works_) {
+      work->synchronize();
+    }
+  }
+
+  bool wait(std::chrono::milliseconds timeout) override {
+    if (timeout == kNoTimeout) {
+      bool success = true;
+      for (const auto& work : works_) {
+        success = work->wait(kNoTimeout) && success;
+      }
+      return success;
+    }
+    // The parts share the timeout. As kNoTimeout is 0, a part waited for past
+    // the deadline gets the shortest timeout instead.
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    bool success = true;
+    for (const auto& work : works_) {
+      const auto remaining =
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              deadline - std::chrono::steady_clock::now());
+      success = work->wait(std::max(remaining, std::chrono::milliseconds(1))) &&
+          success;
+    }
+    return success;
+  }
+
+  void abort() override {
+    for (const auto& work : works_) {
+      work->abort();
+    }
+  }
+
+  // Chains the futures of the parts through their own then(), so that the
+  // returned future has their type. For the CUDAFutures of NCCL, the callback
+  // of each step runs on streams that wait for its part, and waits for the
+  // previous step, so the value is recorded after all parts are complete on
+  // the CUDA streams too. An error of any part is the error of the result.
+  c10::intrusive_ptr<c10::ivalue::Future> getFuture() override {
+    auto type = c10::ListType::create(c10::TensorType::get());
+    const auto tensors = tensors_;
+    c10::intrusive_ptr<c10::ivalue::Future> result;
+    for (const auto& work : works_) {
+      auto part = work->getFuture();
+      // The previous step is complete before this one runs for the NCCL
+      // futures, which are completed when they're created. For the others,
+      // the callback blocks the thread that completed this part until the
+      // previous ones are complete.
+      result = part->then(
+          [part, previous = result, tensors]() {
+            part->waitAndThrow();
+            if (previous) {
+              previous->waitAndThrow();
+            }
+            return c10::IValue(tensors);
+          },
+          type);
+    }
+    return result;
+  }
+
+ private:
+  std::vector<c10::intrusive_ptr<ProcessGroup::Work>> works_;
+  std::vector<at::Tensor> tensors_;
+};
+
+} // namespace
+
+constexpr int64_t ProcessGroupRoundRobin::kDefaultSplitThresholdBytes;
+
 ProcessGroupRoundRobin::ProcessGroupRoundRobin(
     int rank,
     int size,
-    std::vector<c10::intrusive_ptr<ProcessGroup>> processGroups)
-    : ProcessGroup(rank, size), processGroups_(std::move(processGroups)) {
+    std::vector<c10::intrusive_ptr<ProcessGroup>> processGroups,
+    int64_t splitThresholdBytes)
+    : ProcessGroup(rank, size),
+      processGroups_(std::move(processGroups)),
+      splitThresholdBytes_(splitThresholdBytes) {
   TORCH_CHECK(processGroups_.size() >= 1);
   for (const auto& processGroup : processGroups_) {
     TORCH_CHECK(processGroup->getRank() == rank_);
     TORCH_CHECK(processGroup->getSize() == size_);
   }
-  iterator_ = processGroups_.begin();
+  load_.resize(processGroups_.size(), 0);
 }
 
 ProcessGroupRoundRobin::~ProcessGroupRoundRobin() {}
@@ -20,60 +161,77 @@ ProcessGroupRoundRobin::~ProcessGroupRoundRobin() {}
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::broadcast(
     std::vector<at::Tensor>& tensors,
     const BroadcastOptions& opts) {
-  return next()->broadcast(tensors, opts);
+  if (shouldSplit(tensors)) {
+    return split(
+        tensors,
+        OpType::BROADCAST,
+        [&opts](ProcessGroup& processGroup, std::vector<at::Tensor>& parts) {
+          return processGroup.broadcast(parts, opts);
+        });
+  }
+  return next(bytesOf(tensors))->broadcast(tensors, opts);
 }
 
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::allreduce(
     std::vector<at::Tensor>& tensors,
     const AllreduceOptions& opts) {
-  return next()->allreduce(tensors, opts);
+  if (shouldSplit(tensors)) {
+    return split(
+        tensors,
+        OpType::ALLREDUCE,
+        [&opts](ProcessGroup& processGroup, std::vector<at::Tensor>& parts) {
+          return processGroup.allreduce(parts, opts);
+        });
+  }
+  return next(bytesOf(tensors))->allreduce(tensors, opts);
 }
 
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::allreduce_coalesced(
     std::vector<at::Tensor>& tensors,
     const AllreduceCoalescedOptions& opts) {
-  return next()->allreduce_coalesced(tensors, opts);
+  return next(bytesOf(tensors))->allreduce_coalesced(tensors, opts);
 }
 
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::reduce(
     std::vector<at::Tensor>& tensors,
     const ReduceOptions& opts) {
-  return next()->reduce(tensors, opts);
+  return next(bytesOf(tensors))->reduce(tensors, opts);
 }
 
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::allgather(
     std::vector<std::vector<at::Tensor>>& outputs,
     std::vector<at::Tensor>& inputs,
     const AllgatherOptions& opts) {
-  return next()->allgather(outputs, inputs, opts);
+  return next(bytesOf(inputs) * size_)->allgather(outputs, inputs, opts);
 };
 
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::allgather_coalesced(
     std::vector<std::vector<at::Tensor>>& outputTensorLists,
     std::vector<at::Tensor>& inputTensors,
     const AllgatherOptions& opts) {
-  return next()->allgather(outputTensorLists, inputTensors, opts);
+  return next(bytesOf(inputTensors) * size_)
+      ->allgather(outputTensorLists, inputTensors, opts);
 }
 
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::gather(
     std::vector<std::vector<at::Tensor>>& outputs,
     std::vector<at::Tensor>& inputs,
     const GatherOptions& opts) {
-  return next()->gather(outputs, inputs, opts);
+  return next(bytesOf(inputs) * size_)->gather(outputs, inputs, opts);
 };
 
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::scatter(
     std::vector<at::Tensor>& outputs,
     std::vector<std::vector<at::Tensor>>& inputs,
     const ScatterOptions& opts) {
-  return next()->scatter(outputs, inputs, opts);
+  return next(bytesOf(outputs) * size_)->scatter(outputs, inputs, opts);
 };
 
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::reduce_scatter(
     std::vector<at::Tensor>& outputs,
     std::vector<std::vector<at::Tensor>>& inputs,
     const ReduceScatterOptions& opts) {
-  return next()->reduce_scatter(outputs, inputs, opts);
+  return next(bytesOf(inputs))->reduce_scatter(outputs, inputs, opts);
 };
 
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::alltoall_base(
@@ -82,6 +240,7 @@ c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::alltoall_base(
     std::vector<int64_t>& outputSplitSizes,
     std::vector<int64_t>& inputSplitSizes,
     const AllToAllOptions& opts) {
+  // the split sizes may differ across processes
   return next()->alltoall_base(
       outputTensor, inputTensor, outputSplitSizes, inputSplitSizes, opts);
 };
@@ -111,13 +270,70 @@ c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::barrier(
   throw std::runtime_error("ProcessGroupRoundRobin does not support barrier");
 };
 
-const c10::intrusive_ptr<ProcessGroup>& ProcessGroupRoundRobin::next() {
-  auto& processGroup = *iterator_;
-  iterator_++;
-  if (iterator_ == processGroups_.end()) {
-    iterator_ = processGroups_.begin();
+const c10::intrusive_ptr<ProcessGroup>& ProcessGroupRoundRobin::next(
+    int64_t bytes) {
+  size_t index = next_;
+  for (size_t i = 1; i < processGroups_.size(); i++) {
+    const size_t candidate = (next_ + i) % processGroups_.size();
+    if (load_[candidate] < load_[index]) {
+      index = candidate;
+    }
+  }
+  next_ = (index + 1) % processGroups_.size();
+  addLoad(index, bytes);
+  return processGroups_[index];
+}
+
+void ProcessGroupRoundRobin::addLoad(size_t index, int64_t bytes) {
+  load_[index] += bytes;
+  const int64_t minLoad = *std::min_element(load_.begin(), load_.end());
+  for (auto& load : load_) {
+    load -= minLoad;
+  }
+}
+
+bool ProcessGroupRoundRobin::shouldSplit(
+    const std::vector<at::Tensor>& tensors) const {
+  if (splitThresholdBytes_ <= 0 || processGroups_.size() < 2 ||
+      tensors.empty()) {
+    return false;
+  }
+  const auto& first = tensors.front();
+  if (first.numel() * first.element_size() < splitThresholdBytes_ ||
+      first.numel() < static_cast<int64_t>(processGroups_.size())) {
+    return false;
+  }
+  return std::all_of(
+      tensors.begin(), tensors.end(), [&first](const at::Tensor& tensor) {
+        return tensor.layout() == c10::kStrided && tensor.is_contiguous() &&
+            tensor.numel() == first.numel();
+      });
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::split(
+    std::vector<at::Tensor>& tensors,
+    OpType opType,
+    const std::function<c10::intrusive_ptr<ProcessGroup::Work>(
+        ProcessGroup&,
+        std::vector<at::Tensor>&)>& fn) {
+  const int64_t numGroups = processGroups_.size();
+  const int64_t numel = tensors.front().numel();
+  const int64_t partNumel = (numel + numGroups - 1) / numGroups;
+  std::vector<c10::intrusive_ptr<ProcessGroup::Work>> works;
+  works.reserve(numGroups);
+  for (int64_t i = 0; i < numGroups && i * partNumel < numel; i++) {
+    const int64_t begin = i * partNumel;
+    const int64_t length = std::min(partNumel, numel - begin);
+    std::vector<at::Tensor> parts;
+    parts.reserve(tensors.size());
+    for (const auto& tensor : tensors) {
+      parts.push_back(tensor.view({-1}).narrow(0, begin, length));
+    }
+    addLoad(i, bytesOf(parts));
+    works.push_back(fn(*processGroups_[i], parts));
   }
-  return processGroup;
+  return c10::make_intrusive<SplitWork>(
+      rank_, opType, std::move(works), tensors);
 }
 
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::allgather_base(
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <vector>
 
 #include <c10d/ProcessGroup.hpp>
@@ -11,8 +13,17 @@ constexpr const char* ROUND_ROBIN_BACKEND_NAME = "round_robin";
 // ProcessGroupRoundRobin implements simple load balancing.
 //
 // It is constructed with multiple processes groups. Each call is dispatched to
-// one of the specified process groups in a round robin fashion. Each process
-// group instance must have the same rank and size.
+// the process group that was given the fewest bytes so far, and calls whose
+// size is not the same on all processes (e.g. of sparse tensors or alltoall)
+// to the next process group in a round robin fashion. The dense, contiguous
+// tensors of allreduce and broadcast calls of at least splitThresholdBytes
+// are split in as many parts as there are process groups, which run in
+// parallel, and the returned work completes once all of them did. Each
+// process group instance must have the same rank and size.
+//
+// The load is the number of bytes given to each process group rather than
+// the number of bytes still in flight: when collectives complete differs
+// across processes, and all of them must pick the same process group.
 //
 // All functions of the class are expected to be called in the same order
 // across all processes in the process group. This is the only way that we
@@ -20,10 +31,14 @@ constexpr const char* ROUND_ROBIN_BACKEND_NAME = "round_robin";
 //
 class ProcessGroupRoundRobin final : public ProcessGroup {
  public:
+  // Splitting is disabled if the threshold is not positive.
+  static constexpr int64_t kDefaultSplitThresholdBytes = 16 * 1024 * 1024;
+
   explicit ProcessGroupRoundRobin(
       int rank,
       int size,
-      std::vector<c10::intrusive_ptr<ProcessGroup>> processGroups);
+      std::vector<c10::intrusive_ptr<ProcessGroup>> processGroups,
+      int64_t splitThresholdBytes = kDefaultSplitThresholdBytes);
 
   ~ProcessGroupRoundRobin() override;
 
@@ -104,10 +119,31 @@ class ProcessGroupRoundRobin final : public ProcessGroup {
 
  private:
   std::vector<c10::intrusive_ptr<ProcessGroup>> processGroups_;
-  std::vector<c10::intrusive_ptr<ProcessGroup>>::const_iterator iterator_;
-
-  // Returns the next ProcessGroup to use.
-  const c10::intrusive_ptr<ProcessGroup>& next();
+  const int64_t splitThresholdBytes_;
+  // The bytes given to each process group, minus the ones given to the least
+  // loaded one
+  std::vector<int64_t> load_;
+  // Where the search for the least loaded process group starts, so that ties
+  // are broken in a round robin fashion
+  size_t next_ = 0;
+
+  // Returns the next ProcessGroup to use for a call of the given size, which
+  // must be the same on all processes.
+  const c10::intrusive_ptr<ProcessGroup>& next(int64_t bytes = 0);
+
+  // Adds bytes to the load of the index-th process group.
+  void addLoad(size_t index, int64_t bytes);
+
+  // Whether tensors are split across all process groups.
+  bool shouldSplit(const std::vector<at::Tensor>& tensors) const;
+
+  // Runs fn on each process group with its part of the tensors.
+  c10::intrusive_ptr<ProcessGroup::Work> split(
+      std::vector<at::Tensor>& tensors,
+      OpType opType,
+      const std::function<c10::intrusive_ptr<ProcessGroup::Work>(
+          ProcessGroup&,
+          std::vector<at::Tensor>&)>& fn);
 };
 
 } // namespace c10d
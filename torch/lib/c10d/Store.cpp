@@ -13,4 +13,35 @@ void Store::setTimeout(const std::chrono::milliseconds& timeout) {
   timeout_ = timeout;
 }
 
+std::vector<uint8_t> Store::compareSet(
+    const std::string& /* unused */,
+    const std::vector<uint8_t>& /* unused */,
+    const std::vector<uint8_t>& /* unused */) {
+  throw std::runtime_error("compareSet is not supported by this store");
+}
+
+std::vector<std::vector<uint8_t>> Store::multiGet(
+    const std::vector<std::string>& keys) {
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(keys.size());
+  for (const auto& key : keys) {
+    values.emplace_back(get(key));
+  }
+  return values;
+}
+
+void Store::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument(
+        "multiSet expects as many values as keys, got " +
+        std::to_string(values.size()) + " values for " +
+        std::to_string(keys.size()) + " keys");
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    set(keys[i], values[i]);
+  }
+}
+
 } // namespace c10d
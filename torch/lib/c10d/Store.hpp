@@ -44,6 +44,24 @@ class Store : public torch::CustomClassHolder {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) = 0;
 
+  // Sets key to desiredValue if its value is expectedValue, or if key is not
+  // set and expectedValue is empty. Returns the value of key after the
+  // operation, or expectedValue if key is not set and expectedValue is not
+  // empty.
+  virtual std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue);
+
+  // Batched versions of get and set. Stores that can do it, like TCPStore,
+  // handle all the keys in one request, the others loop over the keys.
+  virtual std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys);
+
+  virtual void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
   void setTimeout(const std::chrono::milliseconds& timeout);
 
  protected:
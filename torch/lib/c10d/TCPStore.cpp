@@ -8,6 +8,10 @@
 #include <unistd.h>
 #endif
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
 #include <algorithm>
 #include <fcntl.h>
 #include <system_error>
@@ -16,7 +20,18 @@ namespace c10d {
 
 namespace {
 
-enum class QueryType : uint8_t { SET, GET, ADD, CHECK, WAIT, GETNUMKEYS, DELETE_KEY };
+enum class QueryType : uint8_t {
+  SET,
+  GET,
+  ADD,
+  CHECK,
+  WAIT,
+  GETNUMKEYS,
+  DELETE_KEY,
+  COMPARE_SET,
+  MULTI_GET,
+  MULTI_SET
+};
 
 enum class CheckResponseType : uint8_t { READY, NOT_READY };
 
@@ -75,27 +90,7 @@ void TCPStoreDaemon::queryFds(std::vector<struct pollfd>& fds) {
       tcputil::closeSocket(fds[fdIdx].fd);
 
       // Remove all the tracking state of the close FD
-      for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
-        for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
-          if (*vecIt == fds[fdIdx].fd) {
-            vecIt = it->second.erase(vecIt);
-          } else {
-            ++vecIt;
-          }
-        }
-        if (it->second.size() == 0) {
-          it = waitingSockets_.erase(it);
-        } else {
-          ++it;
-        }
-      }
-      for (auto it = keysAwaited_.begin(); it != keysAwaited_.end();) {
-        if (it->first == fds[fdIdx].fd) {
-          it = keysAwaited_.erase(it);
-        } else {
-          ++it;
-        }
-      }
+      clearWaitingState(fds[fdIdx].fd);
       fds.erase(fds.begin() + fdIdx);
       sockets_.erase(sockets_.begin() + fdIdx - CONNECT_SOCKET_OFFSET);
       --fdIdx;
@@ -104,11 +99,32 @@ void TCPStoreDaemon::queryFds(std::vector<struct pollfd>& fds) {
   }
 }
 
+void TCPStoreDaemon::clearWaitingState(int socket) {
+  for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
+    for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
+      if (*vecIt == socket) {
+        vecIt = it->second.erase(vecIt);
+      } else {
+        ++vecIt;
+      }
+    }
+    if (it->second.size() == 0) {
+      it = waitingSockets_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  keysAwaited_.erase(socket);
+}
+
 // query communicates with the worker. The format
 // of the query is as follows:
 // type of query | size of arg1 | arg1 | size of arg2 | arg2 | ...
-// or, in the case of wait
+// or, in the case of wait, check and multi get
 // type of query | number of args | size of arg1 | arg1 | ...
+// or, in the case of multi set
+// type of query | number of keys | size of key1 | key1 | size of value1 |
+// value1 | ...
 void TCPStoreDaemon::query(int socket) {
   QueryType qt;
   tcputil::recvBytes<QueryType>(socket, &qt, 1);
@@ -134,6 +150,15 @@ void TCPStoreDaemon::query(int socket) {
   } else if (qt == QueryType::DELETE_KEY) {
     deleteHandler(socket);
 
+  } else if (qt == QueryType::COMPARE_SET) {
+    compareSetHandler(socket);
+
+  } else if (qt == QueryType::MULTI_GET) {
+    multiGetHandler(socket);
+
+  } else if (qt == QueryType::MULTI_SET) {
+    multiSetHandler(socket);
+
   } else {
     throw std::runtime_error("Unexpected query type");
   }
@@ -192,6 +217,47 @@ void TCPStoreDaemon::deleteHandler(int socket) {
   tcputil::sendValue<int64_t>(socket, numDeleted);
 }
 
+void TCPStoreDaemon::compareSetHandler(int socket) {
+  std::string key = tcputil::recvString(socket);
+  std::vector<uint8_t> expectedValue = tcputil::recvVector<uint8_t>(socket);
+  std::vector<uint8_t> desiredValue = tcputil::recvVector<uint8_t>(socket);
+
+  auto pos = tcpStore_.find(key);
+  if (pos == tcpStore_.end() ? !expectedValue.empty()
+                             : pos->second != expectedValue) {
+    // The value is not the one expected, send back what it is
+    tcputil::sendVector<uint8_t>(
+        socket, pos == tcpStore_.end() ? expectedValue : pos->second);
+    return;
+  }
+  tcpStore_[key] = desiredValue;
+  tcputil::sendVector<uint8_t>(socket, desiredValue);
+  wakeupWaitingClients(key);
+}
+
+void TCPStoreDaemon::multiGetHandler(int socket) const {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  std::vector<std::string> keys(nargs);
+  for (size_t i = 0; i < nargs; i++) {
+    keys[i] = tcputil::recvString(socket);
+  }
+  for (size_t i = 0; i < nargs; i++) {
+    tcputil::sendVector<uint8_t>(
+        socket, tcpStore_.at(keys[i]), (i != (nargs - 1)));
+  }
+}
+
+void TCPStoreDaemon::multiSetHandler(int socket) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  for (size_t i = 0; i < nargs; i++) {
+    std::string key = tcputil::recvString(socket);
+    tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
+    wakeupWaitingClients(key);
+  }
+}
+
 void TCPStoreDaemon::checkHandler(int socket) const {
   SizeType nargs;
   tcputil::recvBytes<SizeType>(socket, &nargs, 1);
@@ -314,6 +380,71 @@ void TCPStoreDaemon::stop() {
   }
 }
 
+#ifdef __linux__
+// With thousands of workers, poll() spends most of its time scanning the
+// sockets that have no event, so the daemon uses epoll on Linux, whose cost
+// depends on the number of sockets with an event only.
+void TCPStoreDaemon::run() {
+  constexpr int kMaxEvents = 64;
+  int epollFd;
+  SYSCHECK_ERR_RETURN_NEG1(epollFd = ::epoll_create1(EPOLL_CLOEXEC));
+  ResourceGuard epollGuard([epollFd]() { ::close(epollFd); });
+  auto addFd = [epollFd](int fd) {
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    SYSCHECK_ERR_RETURN_NEG1(::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event));
+  };
+  addFd(storeListenSocket_);
+  // The read end of the pipe gets EPOLLHUP when the pipe is closed, to signal
+  // the stopping of the daemon run
+  addFd(controlPipeFd_[0]);
+
+  std::vector<struct epoll_event> events(kMaxEvents);
+  while (true) {
+    int numEvents;
+    SYSCHECK_ERR_RETURN_NEG1(
+        numEvents = ::epoll_wait(epollFd, events.data(), kMaxEvents, -1));
+    for (int i = 0; i < numEvents; i++) {
+      const int fd = events[i].data.fd;
+      if (fd == controlPipeFd_[0]) {
+        if (!(events[i].events & EPOLLHUP)) {
+          throw std::system_error(
+              ECONNABORTED,
+              std::system_category(),
+              "Unexpected epoll event on the control pipe's reading fd: " +
+                  std::to_string(events[i].events));
+        }
+        return;
+      }
+      // TCPStore's listening socket has an event and it should now be able
+      // to accept new connections.
+      if (fd == storeListenSocket_) {
+        if (events[i].events ^ EPOLLIN) {
+          throw std::system_error(
+              ECONNABORTED,
+              std::system_category(),
+              "Unexpected epoll event on the master's listening socket: " +
+                  std::to_string(events[i].events));
+        }
+        int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
+        sockets_.push_back(sockFd);
+        addFd(sockFd);
+        continue;
+      }
+      try {
+        query(fd);
+      } catch (...) {
+        // See queryFds() for why we close the connection whenever a query
+        // fails. Closing the socket removes it from the epoll set.
+        tcputil::closeSocket(fd);
+        clearWaitingState(fd);
+        sockets_.erase(std::find(sockets_.begin(), sockets_.end(), fd));
+      }
+    }
+  }
+}
+#else
 void TCPStoreDaemon::run() {
   std::vector<struct pollfd> fds;
   tcputil::addPollfd(fds, storeListenSocket_, POLLIN);
@@ -360,6 +491,7 @@ void TCPStoreDaemon::run() {
     queryFds(fds);
   }
 }
+#endif // __linux__
 #endif
 
 // TCPStore class methods
@@ -536,6 +668,58 @@ void TCPStore::waitHelper_(
   }
 }
 
+std::vector<uint8_t> TCPStore::compareSet(
+    const std::string& key,
+    const std::vector<uint8_t>& expectedValue,
+    const std::vector<uint8_t>& desiredValue) {
+  std::string regKey = regularPrefix_ + key;
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::COMPARE_SET);
+  tcputil::sendString(storeSocket_, regKey, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, expectedValue, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, desiredValue);
+  return tcputil::recvVector<uint8_t>(storeSocket_);
+}
+
+std::vector<std::vector<uint8_t>> TCPStore::multiGet(
+    const std::vector<std::string>& keys) {
+  std::vector<std::string> regKeys;
+  regKeys.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    regKeys[i] = regularPrefix_ + keys[i];
+  }
+  waitHelper_(regKeys, timeout_);
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_GET);
+  SizeType nkeys = regKeys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, regKeys[i], (i != (nkeys - 1)));
+  }
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(nkeys);
+  for (size_t i = 0; i < nkeys; i++) {
+    values.emplace_back(tcputil::recvVector<uint8_t>(storeSocket_));
+  }
+  return values;
+}
+
+void TCPStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument(
+        "multiSet expects as many values as keys, got " +
+        std::to_string(values.size()) + " values for " +
+        std::to_string(keys.size()) + " keys");
+  }
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_SET);
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, regularPrefix_ + keys[i], true);
+    tcputil::sendVector<uint8_t>(storeSocket_, values[i], (i != (nkeys - 1)));
+  }
+}
+
 PortType TCPStore::getPort() {
   return tcpStorePort_;
 }
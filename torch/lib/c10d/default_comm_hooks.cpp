@@ -19,23 +19,37 @@ c10::intrusive_ptr<c10::ivalue::Future> AllReduceCommHook::runHook(
   return fut->then(div_by_process_group_size, fut->elementType());
 }
 
-c10::intrusive_ptr<c10::ivalue::Future> FP16CompressCommHook::runHook(
+c10::intrusive_ptr<c10::ivalue::Future> CompressCommHook::runHook(
     GradBucket& bucket) {
-  auto& tensors = bucket.getTensorsRef();
-  for (auto& tensor : tensors) {
-    tensor.copy_(tensor.to(torch::kFloat16));
+  auto tensor = bucket.getTensorsRef()[0];
+  const auto size = state_->getSize();
+
+  // Divide before compressing, so that the sum can't overflow.
+  at::Tensor compressed;
+  if (error_feedback_) {
+    auto& residual = residuals_[bucket.getIndex()];
+    // Bucket indices are reassigned when buckets are rebuilt. Drop the
+    // residual in that case rather than adding it to other gradients.
+    if (!residual.defined() || residual.numel() != tensor.numel()) {
+      residual = at::zeros_like(tensor);
+    }
+    auto scaled = (tensor + residual).div_(size);
+    compressed = scaled.to(dtype_);
+    residual.copy_(scaled.sub_(compressed)).mul_(size);
+  } else {
+    compressed = tensor.div(size).to(dtype_);
   }
-  auto allreduce_work = state_->allreduce(tensors);
 
-  auto decompress_and_div_by_process_group_size = [allreduce_work, this]() {
-    auto tensor = allreduce_work->result()[0];
-    tensor.copy_(tensor.to(torch::kFloat) / state_->getSize());
+  std::vector<at::Tensor> compressed_tensors = {compressed};
+  auto allreduce_work = state_->allreduce(compressed_tensors);
+
+  auto decompress = [allreduce_work, tensor]() mutable {
+    tensor.copy_(allreduce_work->result()[0]);
     return c10::IValue(tensor);
   };
 
   auto fut = allreduce_work->getFuture();
-  return fut->then(
-      decompress_and_div_by_process_group_size, fut->elementType());
+  return fut->then(decompress, fut->elementType());
 }
 
 } // namespace c10d
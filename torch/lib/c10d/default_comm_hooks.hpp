@@ -3,11 +3,16 @@
 #include <c10d/comm.hpp>
 #include <c10d/ProcessGroup.hpp>
 
+#include <unordered_map>
+
 namespace c10d {
 
 enum class BuiltinCommHookType {
   ALLREDUCE = 1,
   FP16_COMPRESS = 2,
+  BF16_COMPRESS = 3,
+  FP16_COMPRESS_WITH_ERROR_FEEDBACK = 4,
+  BF16_COMPRESS_WITH_ERROR_FEEDBACK = 5,
 };
 
 class AllReduceCommHook : public CppCommHookInterface<ProcessGroup*> {
@@ -20,14 +25,40 @@ class AllReduceCommHook : public CppCommHookInterface<ProcessGroup*> {
   c10::intrusive_ptr<c10::ivalue::Future> runHook(GradBucket& bucket) override;
 };
 
-class FP16CompressCommHook : public CppCommHookInterface<ProcessGroup*> {
+// Compresses the bucket to the 16-bit floating point type `dtype` before
+// allreduce, and decompresses the result into the bucket, which halves the
+// bytes communicated for fp32 gradients.
+//
+// With `error_feedback`, the rounding error of each bucket is kept and added
+// to the same bucket in the next iteration, so that it isn't lost over the
+// course of training. This costs one residual tensor per bucket.
+class CompressCommHook : public CppCommHookInterface<ProcessGroup*> {
  public:
-  explicit FP16CompressCommHook(ProcessGroup* state)
-      : CppCommHookInterface<ProcessGroup*>(state) {}
+  CompressCommHook(
+      ProcessGroup* state,
+      at::ScalarType dtype,
+      bool error_feedback)
+      : CppCommHookInterface<ProcessGroup*>(state),
+        dtype_(dtype),
+        error_feedback_(error_feedback) {}
 
-  ~FP16CompressCommHook() override {}
+  ~CompressCommHook() override {}
 
   c10::intrusive_ptr<c10::ivalue::Future> runHook(GradBucket& bucket) override;
+
+ private:
+  const at::ScalarType dtype_;
+  const bool error_feedback_;
+  // Rounding errors by bucket index.
+  std::unordered_map<size_t, at::Tensor> residuals_;
+};
+
+class FP16CompressCommHook : public CompressCommHook {
+ public:
+  explicit FP16CompressCommHook(ProcessGroup* state)
+      : CompressCommHook(state, at::kHalf, /*error_feedback=*/false) {}
+
+  ~FP16CompressCommHook() override {}
 };
 
 } // namespace c10d
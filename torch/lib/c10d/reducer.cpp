@@ -1,6 +1,8 @@
 #include <c10d/reducer.hpp>
 
+#include <algorithm>
 #include <functional>
+#include <numeric>
 
 #include <c10/core/DeviceGuard.h>
 #include <c10/core/StreamGuard.h>
@@ -47,6 +49,9 @@ Reducer::Reducer(
       backward_stats_base_(0),
       has_rebuilt_bucket_(false),
       bucket_bytes_cap_(bucket_bytes_cap),
+      bucket_rebuild_period_(0),
+      iterations_since_rebuild_(0),
+      num_ready_variables_(0),
       divFactor_(kUnsetDivFactor),
       comm_hook_(nullptr),
       ddp_logging_data_(std::move(std::make_unique<c10::DDPLoggingData>())) {
@@ -428,6 +433,42 @@ void Reducer::mark_variable_ready_dense(VariableIndex index) {
   });
 }
 
+// Note [Accumulating into bucket views]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// With gradient_as_bucket_view, grads point to their bucket views once they
+// have been reduced. Grads computed without reduction (under `no_sync`)
+// before that would live in tensors of their own until the next reduced
+// backward copies them to the buckets, so that the memory of the gradients
+// is held twice during the whole accumulation. Instead, the first time such
+// a grad shows up it is moved to its bucket view, and later micro-batches
+// accumulate into the bucket directly. The final backward then finds every
+// accumulated grad already in place and only has to kick off the reductions
+// as the buckets become ready.
+void Reducer::move_grad_to_bucket_view(VariableIndex index) {
+  const auto& bucket_index = variable_locators_[index.variable_index];
+  auto& bucket = buckets_[bucket_index.bucket_index];
+  if (bucket.expect_sparse_gradient) {
+    return;
+  }
+  auto& replica = bucket.replicas[index.replica_index];
+  auto& variable = replica.variables[bucket_index.intra_bucket_index];
+  auto& bucket_view = replica.bucket_views_in[bucket_index.intra_bucket_index];
+
+  runGradCallbackForVariable(variable, [&](auto& grad) {
+    // Grads with another layout are left to check_grad_layout in the reduced
+    // backward.
+    if (!grad.defined() || grad.is_alias_of(bucket_view) ||
+        grad.sizes() != bucket_view.sizes() ||
+        grad.strides() != bucket_view.strides()) {
+      return false;
+    }
+    bucket_view.copy_(grad);
+    grad = bucket_view;
+    // The grad is modified and needs to be written back.
+    return true;
+  });
+}
+
 void Reducer::mark_variable_ready_sparse(VariableIndex index) {
   const auto replica_index = index.replica_index;
   const auto variable_index = index.variable_index;
@@ -510,6 +551,12 @@ void Reducer::push_rebuilt_params(const VariableIndex& index) {
   }
 }
 
+void Reducer::record_ready_order(const VariableIndex& index) {
+  if (bucket_rebuild_period_ > 0 && index.replica_index == 0) {
+    ready_order_sum_[index.variable_index] += num_ready_variables_++;
+  }
+}
+
 // The function `autograd_hook` is called after the gradient for a
 // model parameter has been accumulated into its gradient tensor.
 // This function is only to be called from the autograd thread.
@@ -529,6 +576,10 @@ void Reducer::autograd_hook(VariableIndex index) {
   // This may be the case if the user wants to accumulate gradients
   // for number of iterations before reducing them.
   if (!expect_autograd_hooks_) {
+    // See Note [Accumulating into bucket views]
+    if (gradient_as_bucket_view_) {
+      move_grad_to_bucket_view(index);
+    }
     return;
   }
 
@@ -542,6 +593,7 @@ void Reducer::autograd_hook(VariableIndex index) {
   // and initialized. Also we only need to dump tensors and parameter indices of
   // one replica.
   push_rebuilt_params(index);
+  record_ready_order(index);
 
   // If `find_unused_parameters_` is true there may be model parameters that
   // went unused when computing the model output, they won't be part of the
@@ -985,6 +1037,7 @@ void Reducer::prepare_for_backward(
   // Reset accounting.
   expect_autograd_hooks_ = true;
   next_bucket_ = 0;
+  num_ready_variables_ = 0;
   backward_stats_base_ = current_time_in_nanos();
   for (auto& bucket : buckets_) {
     for (auto& replica : bucket.replicas) {
@@ -1356,7 +1409,7 @@ bool Reducer::rebuild_buckets() {
   ensure_prior_reduction_finished();
   std::lock_guard<std::mutex> lock(mutex_);
   if (!should_rebuild_buckets() || rebuilt_params_.empty()) {
-    return false;
+    return rebuild_buckets_by_ready_order();
   }
 
   TORCH_INTERNAL_ASSERT(
@@ -1392,11 +1445,67 @@ bool Reducer::rebuild_buckets() {
   has_rebuilt_bucket_ = true;
   rebuilt_params_.clear();
   rebuilt_param_indices_.clear();
+  iterations_since_rebuild_ = 0;
+  std::fill(ready_order_sum_.begin(), ready_order_sum_.end(), 0);
 
   initialize_buckets(std::move(rebuilt_bucket_indices));
   return true;
 }
 
+void Reducer::set_bucket_rebuild_period(int64_t period) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TORCH_CHECK(period >= 0, "Bucket rebuild period must be non-negative.");
+  TORCH_CHECK(
+      period == 0 || !find_unused_parameters_,
+      "Rebuilding buckets periodically is not supported with "
+      "find_unused_parameters=True.");
+  bucket_rebuild_period_ = period;
+  iterations_since_rebuild_ = 0;
+  ready_order_sum_.assign(replicas_[0].size(), 0);
+}
+
+bool Reducer::rebuild_buckets_by_ready_order() {
+  // Every rank calls rebuild_buckets once per iteration, so all ranks agree on
+  // when to sync bucket indices, even if some of them already joined.
+  if (bucket_rebuild_period_ == 0 || !has_rebuilt_bucket_ ||
+      ++iterations_since_rebuild_ < bucket_rebuild_period_) {
+    return false;
+  }
+  iterations_since_rebuild_ = 0;
+
+  // Since every variable becomes ready once per iteration, the sums of the
+  // positions order the variables like their averages.
+  std::vector<int64_t> indices(replicas_[0].size());
+  std::iota(indices.begin(), indices.end(), 0);
+  std::stable_sort(
+      indices.begin(), indices.end(), [this](int64_t a, int64_t b) {
+        return ready_order_sum_[a] < ready_order_sum_[b];
+      });
+  std::fill(ready_order_sum_.begin(), ready_order_sum_.end(), 0);
+
+  std::vector<at::Tensor> params;
+  params.reserve(indices.size());
+  for (const auto index : indices) {
+    params.push_back(replicas_[0][index]);
+  }
+  std::vector<size_t> bucket_size_limits;
+  bucket_size_limits.push_back(kDefaultFirstBucketBytes);
+  bucket_size_limits.push_back(bucket_bytes_cap_);
+  auto bucket_indices = compute_bucket_assignment_by_size(
+      params, bucket_size_limits, expect_sparse_gradients_[0], indices);
+  sync_bucket_indices(bucket_indices);
+
+  bool changed = bucket_indices.size() != buckets_.size();
+  for (size_t i = 0; !changed && i < buckets_.size(); ++i) {
+    changed = bucket_indices[i] != buckets_[i].variable_indices;
+  }
+  if (!changed) {
+    return false;
+  }
+  initialize_buckets(std::move(bucket_indices));
+  return true;
+}
+
 // See Note [DDP Communication Hook]
 void Reducer::register_comm_hook(std::unique_ptr<CommHookInterface> iface) {
   TORCH_CHECK(
@@ -1437,6 +1546,23 @@ void Reducer::register_builtin_comm_hook(
           std::make_unique<c10d::FP16CompressCommHook>(process_group_.get());
       LOG(INFO) << "Built-in communication hook FP16_COMPRESS is registered.";
       break;
+    case c10d::BuiltinCommHookType::BF16_COMPRESS:
+      comm_hook_ = std::make_unique<c10d::CompressCommHook>(
+          process_group_.get(), at::kBFloat16, /*error_feedback=*/false);
+      LOG(INFO) << "Built-in communication hook BF16_COMPRESS is registered.";
+      break;
+    case c10d::BuiltinCommHookType::FP16_COMPRESS_WITH_ERROR_FEEDBACK:
+      comm_hook_ = std::make_unique<c10d::CompressCommHook>(
+          process_group_.get(), at::kHalf, /*error_feedback=*/true);
+      LOG(INFO) << "Built-in communication hook "
+                << "FP16_COMPRESS_WITH_ERROR_FEEDBACK is registered.";
+      break;
+    case c10d::BuiltinCommHookType::BF16_COMPRESS_WITH_ERROR_FEEDBACK:
+      comm_hook_ = std::make_unique<c10d::CompressCommHook>(
+          process_group_.get(), at::kBFloat16, /*error_feedback=*/true);
+      LOG(INFO) << "Built-in communication hook "
+                << "BF16_COMPRESS_WITH_ERROR_FEEDBACK is registered.";
+      break;
     default:
       TORCH_WARN_ONCE(
           "Unknown built-in DDP comm hook type is provided. No comm hook will be used.");
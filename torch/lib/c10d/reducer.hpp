@@ -94,6 +94,15 @@ class Reducer {
   // Pushes all parameters to be rebuilt.
   void push_rebuilt_params_for_all_indices();
 
+  // After buckets have been rebuilt once, rebuild them again every `period`
+  // calls of `rebuild_buckets`, from the average order in which gradients
+  // became ready since the last rebuild. This follows models whose gradient
+  // order changes during training, e.g. because of conditional branches.
+  // The bucket indices of rank 0 are used on all ranks, so all ranks must set
+  // the same period. A period of 0 (the default) disables periodic
+  // rebuilding, and it is not supported with find_unused_parameters.
+  void set_bucket_rebuild_period(int64_t period);
+
   // Creates and sets ForwardPassWorkHandle given a ProcessGroup::Work and the
   // corresponding tensor being reduced.
   void set_forward_pass_work_handle(
@@ -135,6 +144,15 @@ class Reducer {
 
   void push_rebuilt_params(const VariableIndex& index);
 
+  // Records the position at which a variable became ready in this iteration,
+  // if buckets are rebuilt periodically.
+  void record_ready_order(const VariableIndex& index);
+
+  // Rebuilds buckets if `bucket_rebuild_period_` calls of `rebuild_buckets`
+  // passed since the last rebuild. Returns true if the bucket assignment
+  // changed.
+  bool rebuild_buckets_by_ready_order();
+
   mutable std::mutex mutex_;
   std::vector<std::vector<torch::autograd::Variable>> replicas_;
   c10::intrusive_ptr<::c10d::ProcessGroup> process_group_;
@@ -179,6 +197,10 @@ class Reducer {
 
   void mark_variable_ready_dense(VariableIndex index);
 
+  // Lets the grad of the variable point to its bucket view when accumulating
+  // gradients without reduction. See Note [Accumulating into bucket views].
+  void move_grad_to_bucket_view(VariableIndex index);
+
   void mark_variable_ready_sparse(VariableIndex index);
 
   void mark_variable_ready(VariableIndex index);
@@ -340,6 +362,15 @@ class Reducer {
   std::vector<int64_t> rebuilt_param_indices_;
   const int64_t bucket_bytes_cap_;
 
+  // Following variables are to help rebuild buckets periodically
+  int64_t bucket_rebuild_period_;
+  int64_t iterations_since_rebuild_;
+  // Sum over the iterations since the last rebuild of the position at which
+  // each variable of replica 0 became ready.
+  std::vector<int64_t> ready_order_sum_;
+  // Number of variables of replica 0 that became ready in this iteration.
+  int64_t num_ready_variables_;
+
   struct RpcContext {
     using ContextPtr = torch::distributed::autograd::ContextPtr;
     // The shared_ptr is to hold the context instance.
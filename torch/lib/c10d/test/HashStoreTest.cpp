@@ -85,3 +85,15 @@ TEST(HashStoreTest, testStressStore) {
 TEST(HashStoreTest, testStressStoreWithPrefix) {
   stressTestStore("testPrefix");
 }
+
+TEST(HashStoreTest, testCompareSet) {
+  c10d::HashStore store;
+  std::vector<uint8_t> first = {'a'};
+  std::vector<uint8_t> second = {'b'};
+  EXPECT_EQ(store.compareSet("key", first, second), first);
+  EXPECT_FALSE(store.check({"key"}));
+  EXPECT_EQ(store.compareSet("key", {}, first), first);
+  EXPECT_EQ(store.compareSet("key", second, second), first);
+  EXPECT_EQ(store.compareSet("key", first, second), second);
+  c10d::test::check(store, "key", "b");
+}
@@ -136,3 +136,56 @@ TEST(TCPStoreTest, testHelper) {
 TEST(TCPStoreTest, testHelperPrefix) {
   testHelper("testPrefix");
 }
+
+TEST(TCPStoreTest, testBatchedOps) {
+  auto serverTCPStore = c10::make_intrusive<c10d::TCPStore>(
+      "127.0.0.1", 0, 2, true, std::chrono::seconds(30), /* wait */ false);
+  auto clientTCPStore = c10::make_intrusive<c10d::TCPStore>(
+      "127.0.0.1",
+      serverTCPStore->getPort(),
+      2,
+      false,
+      std::chrono::seconds(30),
+      /* wait */ false);
+  auto clientStore =
+      c10::make_intrusive<c10d::PrefixStore>("prefix", clientTCPStore);
+
+  auto toBytes = [](const std::string& s) {
+    return std::vector<uint8_t>(s.begin(), s.end());
+  };
+  clientStore->multiSet(
+      {"key0", "key1", "key2"},
+      {toBytes("value0"), toBytes(""), toBytes("value2")});
+  auto values = clientStore->multiGet({"key2", "key1", "key0"});
+  ASSERT_EQ(values.size(), 3);
+  EXPECT_EQ(values[0], toBytes("value2"));
+  EXPECT_EQ(values[1], toBytes(""));
+  EXPECT_EQ(values[2], toBytes("value0"));
+  c10d::test::check(*clientStore, "key0", "value0");
+  EXPECT_TRUE(clientStore->multiGet({}).empty());
+  EXPECT_THROW(
+      clientStore->multiSet({"key0"}, {}), std::invalid_argument);
+
+  // The key is not set: only an empty expected value sets it.
+  EXPECT_EQ(
+      clientStore->compareSet("cas", toBytes("old"), toBytes("new")),
+      toBytes("old"));
+  EXPECT_FALSE(clientStore->check({"cas"}));
+  EXPECT_EQ(
+      clientStore->compareSet("cas", {}, toBytes("first")), toBytes("first"));
+  // The key is set: only its value as expected value replaces it.
+  EXPECT_EQ(
+      clientStore->compareSet("cas", toBytes("old"), toBytes("new")),
+      toBytes("first"));
+  EXPECT_EQ(
+      clientStore->compareSet("cas", toBytes("first"), toBytes("second")),
+      toBytes("second"));
+  c10d::test::check(*clientStore, "cas", "second");
+
+  // A compareSet wakes up the clients waiting for the key.
+  auto waiter = std::thread([&serverTCPStore] {
+    c10d::test::check(*serverTCPStore, "prefix/waited", "value");
+  });
+  clientStore->compareSet("waited", {}, toBytes("value"));
+  waiter.join();
+}
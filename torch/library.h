@@ -482,6 +482,15 @@ public:
     return _def(std::move(s));
   }
 
+  /// Overload of def() for a schema string, which is the common case.  Only
+  /// the operator name is parsed here; the rest of the schema is parsed when
+  /// the operator is first looked up, so that registering thousands of
+  /// operators at load time stays cheap.  As a consequence, an error in the
+  /// schema (other than in its name) is only reported on that lookup.
+  Library& def(const char* raw_schema) & {
+    return _defUnparsed(raw_schema);
+  }
+
   /// Define an operator for a schema and then register an implementation for
   /// it.  This is typically what you would use if you aren't planning
   /// on making use of the dispatcher to structure your operator
@@ -661,6 +670,7 @@ private:
   // Non-user visible actual implementations of functions.  These aren't
   // public because we only implement & qualifier and not && qualifier
   Library& _def(c10::FunctionSchema&& schema, c10::OperatorName* out_name = nullptr) &;
+  Library& _defUnparsed(const char* raw_schema) &;
   Library& _def(c10::either<c10::OperatorName, c10::FunctionSchema>&&, CppFunction&& f) &;
   Library& _impl(const char* name, CppFunction&& f) &;
   Library& _fallback(CppFunction&& f) &;
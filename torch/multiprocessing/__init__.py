@@ -44,7 +44,7 @@ if sys.platform == 'darwin' or sys.platform == 'win32':
     _all_sharing_strategies = {'file_system'}
 else:
     _sharing_strategy = 'file_descriptor'
-    _all_sharing_strategies = {'file_descriptor', 'file_system'}
+    _all_sharing_strategies = {'file_descriptor', 'file_system', 'shm_pool'}
 
 
 def set_sharing_strategy(new_strategy):
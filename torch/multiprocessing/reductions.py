@@ -300,15 +300,58 @@ def rebuild_storage_filename(cls, manager, handle, size):
     return storage._shared_decref()
 
 
+def rebuild_storage_pooled(cls, manager, handle, arena_size, block, size):
+    arena_key = ('shm_pool', handle)
+    arena = storage_from_cache(torch.ByteStorage, arena_key)
+    if arena is None:
+        arena = torch.ByteStorage._new_shared_filename(manager, handle, arena_size)
+        shared_cache[arena_key] = StorageWeakRef(arena)
+    arena._shared_decref()
+    storage = storage_from_cache(cls, arena_key + (block,))
+    if storage is not None:
+        # the storage already holds a reference to the block, the one of the
+        # message is dropped
+        torch.multiprocessing._shm_pool_release(arena, block)
+        return storage
+    storage = cls()
+    torch.multiprocessing._shm_pool_adopt(storage, arena, block, size * storage.element_size())
+    shared_cache[arena_key + (block,)] = StorageWeakRef(storage)
+    return storage
+
+
 def rebuild_storage_empty(cls):
     return cls()
 
 
+def reduce_storage_pooled(storage):
+    from . import shm_pool
+    pooled = shm_pool.share(storage)
+    if pooled is None:
+        return None
+    arena, block = pooled
+    manager, handle, arena_size = arena._share_filename_()
+    # the references of the message, dropped by the receiver
+    arena._shared_incref()
+    torch.multiprocessing._shm_pool_retain(arena, block)
+    arena_key = ('shm_pool', handle)
+    shared_cache[arena_key] = StorageWeakRef(arena)
+    shared_cache[arena_key + (block,)] = StorageWeakRef(storage)
+    return (rebuild_storage_pooled, (type(storage), manager, handle, arena_size, block, storage.size()))
+
+
 def reduce_storage(storage):
     from . import get_sharing_strategy
+    sharing_strategy = get_sharing_strategy()
     if storage.is_cuda:
         raise RuntimeError("Cannot pickle CUDA storage; try pickling a CUDA tensor instead")
-    elif get_sharing_strategy() == 'file_system':
+    elif sharing_strategy == 'shm_pool' and storage.size() > 0:
+        reduced = reduce_storage_pooled(storage)
+        if reduced is not None:
+            return reduced
+        # too large for the blocks, or the pool is full
+        sharing_strategy = 'file_descriptor'
+
+    if sharing_strategy == 'file_system':
         metadata = storage._share_filename_()
         cache_key = metadata[1]
         rebuild = rebuild_storage_filename
@@ -0,0 +1,119 @@
+"""
+Pools of shared memory blocks backing the ``'shm_pool'`` sharing strategy.
+
+Each process sending storages keeps a few large shared memory arenas, one set
+per block size, and copies every storage it sends into a free block of one of
+them. The message only carries the name of the arena and the index of the
+block, so sending a storage neither creates a shared memory file nor passes a
+file descriptor. The receivers map each arena once, and a block goes back to
+the free list of its arena when the last storage pointing to it is freed, in
+whichever process that happens, without any message to its sender.
+"""
+import threading
+from multiprocessing.util import register_after_fork
+
+import torch
+
+# The blocks sizes are powers of 4 between these two, the larger storages are
+# sent with the file_descriptor strategy
+MIN_BLOCK_SIZE = 16 << 10
+MAX_BLOCK_SIZE = 16 << 20
+# Size of the arenas, which hold at least MIN_BLOCKS_PER_ARENA blocks
+ARENA_SIZE = 64 << 20
+MIN_BLOCKS_PER_ARENA = 4
+# Room left for the header of the arena
+_ARENA_HEADER_SIZE = 64 << 10
+
+
+def _block_size(nbytes):
+    block_size = MIN_BLOCK_SIZE
+    while block_size < nbytes:
+        block_size *= 4
+    return block_size if block_size <= MAX_BLOCK_SIZE else None
+
+
+class _Pool(object):
+    def __init__(self):
+        # Total size of the arenas of this process, past which the storages are
+        # sent with the file_descriptor strategy
+        self.max_size = 1 << 30
+        self._after_fork()
+        # The arenas of the parent process keep serving the storages it sent,
+        # while the child allocates its own
+        register_after_fork(self, _Pool._after_fork)
+
+    def _after_fork(self):
+        self.lock = threading.Lock()
+        # block size -> arenas
+        self.arenas = {}
+        self.size = 0
+
+    def _new_arena(self, block_size):
+        arena_size = max(ARENA_SIZE, MIN_BLOCKS_PER_ARENA * block_size) + _ARENA_HEADER_SIZE
+        if self.size + arena_size > self.max_size:
+            return None
+        arena = torch.ByteStorage._new_using_filename(arena_size)
+        torch.multiprocessing._shm_pool_init_arena(arena, block_size)
+        self.arenas.setdefault(block_size, []).append(arena)
+        self.size += arena_size
+        return arena
+
+    def share(self, storage):
+        r"""Moves the storage to a block of the pool and returns its arena and
+        block, or None if it doesn't fit in the pool."""
+        pooled = torch.multiprocessing._shm_pool_block(storage)
+        if pooled is not None:
+            return pooled
+        block_size = _block_size(storage.size() * storage.element_size())
+        if block_size is None:
+            return None
+        with self.lock:
+            for arena in self.arenas.get(block_size, []):
+                block = torch.multiprocessing._shm_pool_share(storage, arena)
+                if block >= 0:
+                    return arena, block
+            arena = self._new_arena(block_size)
+            if arena is None:
+                return None
+            return arena, torch.multiprocessing._shm_pool_share(storage, arena)
+
+    def num_free_blocks(self):
+        with self.lock:
+            return sum(torch.multiprocessing._shm_pool_num_free_blocks(arena)
+                       for arenas in self.arenas.values() for arena in arenas)
+
+    def clear(self):
+        with self.lock:
+            self.arenas = {}
+            self.size = 0
+
+
+_pool = _Pool()
+
+
+def share(storage):
+    return _pool.share(storage)
+
+
+def num_free_blocks():
+    r"""Returns the number of free blocks in the arenas of this process."""
+    return _pool.num_free_blocks()
+
+
+def get_max_size():
+    r"""Returns the total size of the arenas a process may allocate, in bytes."""
+    return _pool.max_size
+
+
+def set_max_size(max_size):
+    r"""Sets the total size of the arenas a process may allocate, in bytes.
+    The arenas already allocated are kept."""
+    if max_size < 0:
+        raise ValueError("shm_pool max_size must be non-negative, but got {}".format(max_size))
+    _pool.max_size = max_size
+
+
+def clear():
+    r"""Drops the arenas of this process. Each arena is only unmapped once the
+    storages still using its blocks, in any process, are freed."""
+    _pool.clear()
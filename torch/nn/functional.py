@@ -2690,6 +2690,10 @@ def cross_entropy(
         )
     if size_average is not None or reduce is not None:
         reduction = _Reduction.legacy_get_string(size_average, reduce)
+    # The fused op doesn't keep the log-probabilities for the backward. Traced
+    # graphs keep the separate ops, which the ONNX exporter knows.
+    if not torch.jit.is_scripting() and not torch._C._get_tracing_state() and input.dim() == 2:
+        return torch._C._nn.log_softmax_nll_loss(input, target, weight, _Reduction.get_enum(reduction), ignore_index)
     return nll_loss(log_softmax(input, 1), target, weight, None, ignore_index, None, reduction)
 
 
@@ -3688,6 +3692,36 @@ GRID_SAMPLE_PADDING_MODES = {
 }
 
 
+def _grid_sampler_modes(fn_name: str, mode: str, padding_mode: str) -> Tuple[int, int]:
+    # The interpolation_mode and padding_mode enums of torch.grid_sampler
+    if mode != "bilinear" and mode != "nearest" and mode != "bicubic":
+        raise ValueError(
+            "nn.functional.{}(): expected mode to be "
+            "'bilinear', 'nearest' or 'bicubic', but got: '{}'".format(fn_name, mode)
+        )
+    if padding_mode != "zeros" and padding_mode != "border" and padding_mode != "reflection":
+        raise ValueError(
+            "nn.functional.{}(): expected padding_mode "
+            "to be 'zeros', 'border', or 'reflection', "
+            "but got: '{}'".format(fn_name, padding_mode)
+        )
+
+    if mode == "bilinear":
+        mode_enum = 0
+    elif mode == "nearest":
+        mode_enum = 1
+    else:  # mode == 'bicubic'
+        mode_enum = 2
+
+    if padding_mode == "zeros":
+        padding_mode_enum = 0
+    elif padding_mode == "border":
+        padding_mode_enum = 1
+    else:  # padding_mode == 'reflection'
+        padding_mode_enum = 2
+    return mode_enum, padding_mode_enum
+
+
 def grid_sample(
     input: Tensor,
     grid: Tensor,
@@ -3798,31 +3832,7 @@ def grid_sample(
         return handle_torch_function(
             grid_sample, (input, grid), input, grid, mode=mode, padding_mode=padding_mode, align_corners=align_corners
         )
-    if mode != "bilinear" and mode != "nearest" and mode != "bicubic":
-        raise ValueError(
-            "nn.functional.grid_sample(): expected mode to be "
-            "'bilinear', 'nearest' or 'bicubic', but got: '{}'".format(mode)
-        )
-    if padding_mode != "zeros" and padding_mode != "border" and padding_mode != "reflection":
-        raise ValueError(
-            "nn.functional.grid_sample(): expected padding_mode "
-            "to be 'zeros', 'border', or 'reflection', "
-            "but got: '{}'".format(padding_mode)
-        )
-
-    if mode == "bilinear":
-        mode_enum = 0
-    elif mode == "nearest":
-        mode_enum = 1
-    else:  # mode == 'bicubic'
-        mode_enum = 2
-
-    if padding_mode == "zeros":
-        padding_mode_enum = 0
-    elif padding_mode == "border":
-        padding_mode_enum = 1
-    else:  # padding_mode == 'reflection'
-        padding_mode_enum = 2
+    mode_enum, padding_mode_enum = _grid_sampler_modes("grid_sample", mode, padding_mode)
 
     if align_corners is None:
         warnings.warn(
@@ -3933,6 +3943,55 @@ def affine_grid(theta: Tensor, size: List[int], align_corners: Optional[bool] =
     return torch.affine_grid_generator(theta, size, align_corners)
 
 
+def affine_grid_sample(
+    input: Tensor,
+    theta: Tensor,
+    size: List[int],
+    mode: str = "bilinear",
+    padding_mode: str = "zeros",
+    align_corners: Optional[bool] = None,
+) -> Tensor:
+    r"""Samples :attr:`input` at the locations of the flow field generated by
+    :func:`affine_grid` from :attr:`theta`, that is
+    ``grid_sample(input, affine_grid(theta, size, align_corners), mode, padding_mode, align_corners)``.
+
+    For CPU inputs in the ``torch.channels_last`` or ``torch.channels_last_3d``
+    memory format which don't require grad, the sampling locations are computed
+    as the output is, and the grid isn't materialized.
+
+    Args:
+        input (Tensor): input of shape :math:`(N, C, H_\text{in}, W_\text{in})` (4-D case)
+                        or :math:`(N, C, D_\text{in}, H_\text{in}, W_\text{in})` (5-D case)
+        theta (Tensor): input batch of affine matrices with shape
+            (:math:`N \times 2 \times 3`) for 2D or
+            (:math:`N \times 3 \times 4`) for 3D
+        size (torch.Size): the output size, as in :func:`affine_grid`
+        mode (str): interpolation mode, as in :func:`grid_sample`. Default: ``'bilinear'``
+        padding_mode (str): padding mode, as in :func:`grid_sample`. Default: ``'zeros'``
+        align_corners (bool, optional): as in :func:`grid_sample`. Default: ``False``
+
+    Returns:
+        output (Tensor): output Tensor of size :attr:`size`
+    """
+    if has_torch_function_variadic(input, theta):
+        return handle_torch_function(
+            affine_grid_sample, (input, theta), input, theta, size,
+            mode=mode, padding_mode=padding_mode, align_corners=align_corners
+        )
+    mode_enum, padding_mode_enum = _grid_sampler_modes("affine_grid_sample", mode, padding_mode)
+
+    if align_corners is None:
+        warnings.warn(
+            "Default grid_sample and affine_grid behavior has changed "
+            "to align_corners=False since 1.3.0. Please specify "
+            "align_corners=True if the old behavior is desired. "
+            "See the documentation of grid_sample for details."
+        )
+        align_corners = False
+
+    return torch.affine_grid_sampler(input, theta, size, mode_enum, padding_mode_enum, align_corners)
+
+
 def _pad(input: Tensor, pad: List[int], mode: str = "constant", value: float = 0) -> Tensor:
     r"""Pads tensor.
 
@@ -4787,6 +4846,39 @@ def multi_head_attention_forward(
         if key_padding_mask is not None:
             key_padding_mask = pad(key_padding_mask, (0, 1))
 
+    # Without the weights to return or dropout to apply to them, the fused
+    # kernel computes the output without materializing the weights.
+    if not need_weights and (dropout_p == 0.0 or not training) and not (
+        attn_mask is not None and attn_mask.requires_grad
+    ):
+        mask: Optional[Tensor] = None
+        if attn_mask is not None:
+            if attn_mask.dtype == torch.bool:
+                attn_bias = torch.zeros(attn_mask.size(), dtype=q.dtype, device=q.device)
+                attn_bias.masked_fill_(attn_mask, float("-inf"))
+            else:
+                attn_bias = attn_mask.to(q.dtype)
+            if attn_bias.size(0) == 1:
+                mask = attn_bias.view(1, 1, tgt_len, src_len)
+            else:
+                mask = attn_bias.view(bsz, num_heads, tgt_len, src_len)
+        if key_padding_mask is not None:
+            padding_bias = torch.zeros((bsz, 1, 1, src_len), dtype=q.dtype, device=q.device)
+            padding_bias.masked_fill_(key_padding_mask.view(bsz, 1, 1, src_len), float("-inf"))
+            mask = padding_bias if mask is None else mask + padding_bias
+        # q is already scaled
+        attn_output, _ = torch._scaled_dot_product_attention(
+            q.view(bsz, num_heads, tgt_len, head_dim),
+            k.view(bsz, num_heads, src_len, head_dim),
+            v.view(bsz, num_heads, src_len, head_dim),
+            mask,
+            False,
+            1.0,
+        )
+        attn_output = attn_output.permute(2, 0, 1, 3).reshape(tgt_len, bsz, embed_dim)
+        attn_output = linear(attn_output, out_proj_weight, out_proj_bias)
+        return attn_output, None
+
     attn_output_weights = torch.bmm(q, k.transpose(1, 2))
     assert list(attn_output_weights.size()) == [bsz * num_heads, tgt_len, src_len]
 
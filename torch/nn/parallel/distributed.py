@@ -688,7 +688,8 @@ class DistributedDataParallel(Module):
         # inside _rebuild_buckets. To save peak memory usage,
         # call _rebuild_buckets before the peak memory usage increases
         # during forward computation.
-        # This should be called only once during whole training period.
+        # This rebuilds buckets only once during whole training period, unless
+        # a bucket rebuild period is set.
         if self.reducer._rebuild_buckets():
             logging.info("Reducer buckets have been rebuilt in this iteration.")
 
@@ -994,7 +995,8 @@ class DistributedDataParallel(Module):
                         # Some DDP process still needs to be joined.
                         if is_last_joiner:
                             is_last_joiner = False
-                        # It will rebuild buckets only once during training period
+                        # Called in every iteration, so that all ranks agree on
+                        # when buckets are rebuilt.
                         self.reducer._rebuild_buckets()
                         # Schedule a corresponding broadcast if we are syncing module
                         # buffers in the forward pass.
@@ -1149,6 +1151,32 @@ class DistributedDataParallel(Module):
         """
         dist._register_builtin_comm_hook(self.reducer, comm_hook_type)
 
+    def _set_bucket_rebuild_period(self, period):
+        r"""
+        Rebuilds the gradient buckets every ``period`` iterations, from the
+        average order in which gradients became ready since the last rebuild.
+        By default, buckets are only rebuilt once after the first iteration,
+        which doesn't follow models whose gradient order changes later on,
+        e.g. because of conditional branches.
+
+        Args:
+            period (int): number of iterations between rebuilds, or 0 to only
+            rebuild buckets once.
+
+        .. warning ::
+            All processes must set the same period, and the bucket assignment
+            of rank 0 is used by all processes.
+
+        .. warning ::
+            Rebuilding buckets periodically is not supported with
+            ``find_unused_parameters=True``.
+
+        Example::
+            >>> ddp._set_bucket_rebuild_period(1000)
+
+        """
+        self.reducer._set_bucket_rebuild_period(period)
+
     def _distributed_broadcast_coalesced(
         self, tensors, buffer_size, authoritative_rank=0
     ):
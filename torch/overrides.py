@@ -85,6 +85,7 @@ def get_ignored_functions() -> Set[Callable]:
         torch.import_ir_module_from_buffer,
         torch.is_anomaly_enabled,
         torch.is_grad_enabled,
+        torch.is_inference_mode_enabled,
         torch.merge_type_from_type_comment,
         torch.parse_ir,
         torch.parse_schema,
@@ -114,6 +115,7 @@ def get_ignored_functions() -> Set[Callable]:
         torch.set_grad_enabled,
         torch.no_grad,
         torch.enable_grad,
+        torch.inference_mode,
         torch.layout,
         torch.align_tensors,
         torch.arange,
@@ -159,6 +161,7 @@ def get_ignored_functions() -> Set[Callable]:
         torch.result_type,
         torch.scalar_tensor,
         torch.sparse_coo_tensor,
+        torch.sparse_csr_tensor,
         torch.tril_indices,
         torch.triu_indices,
         torch.vander,
@@ -253,6 +256,8 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.acosh: lambda input, out=None: -1,
         torch.arccosh: lambda input, out=None: -1,
         torch.add: lambda input, other, out=None: -1,
+        torch.add_layer_norm: (lambda input, residual, normalized_shape, weight=None, bias=None, eps=1e-05, p=0.0,
+                               train=False: -1),
         torch.addbmm: lambda input, batch1, batch2, alpha=1, beta=1, out=None: -1,
         torch.addcdiv: lambda input, tensor1, tensor2, value=1, out=None: -1,
         torch.addcmul: lambda input, tensor1, tensor2, value=1, out=None: -1,
@@ -260,11 +265,14 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.addmv: lambda input, mat, vec, beta=1, alpha=1, out=None: -1,
         torch.addr: lambda input, vec1, vec2, beta=1, alpha=1, out=None: -1,
         torch.affine_grid_generator: lambda theta, size, align_corners: -1,
+        torch.affine_grid_sampler: (lambda input, theta, size, interpolation_mode, padding_mode,
+                                    align_corners: -1),
         torch.all: lambda input, dim=None: -1,
         torch.allclose: lambda input, other, trol=1e-05, atol=1e-08, equal_nan=False: -1,
         torch.alpha_dropout: lambda input, p, train, inplace=False: -1,
         torch.amax: lambda input, dim=None: -1,
         torch.amin: lambda input, dim=None: -1,
+        torch.aminmax_var_mean: lambda input, dim=None, unbiased=True, keepdim=False: -1,
         torch.angle: lambda input, out=None: -1,
         torch.any: lambda input, dim=None, keepdim=False, out=None: -1,
         torch.argmax: lambda input: -1,
@@ -285,6 +293,8 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.avg_pool1d: lambda input, kernel_size, stride=None, padding=0, ceil_mode=False, count_include_pad=True: -1,
         torch.baddbmm: lambda input, batch1, batch2, alpha=1, beta=1, out=None: -1,
         torch.batch_norm: lambda input, weight, bias, running_mean, running_var, training, momentum, eps, cudnn_enabled: -1,
+        torch.batch_norm_add_relu: (lambda input, other, weight, bias, running_mean, running_var, training, momentum,
+                                    eps: -1),
         torch.batch_norm_backward_elemt: lambda grad_out, input, mean, invstd, weight, mean_dy, mean_dy_xmu: -1,
         torch.batch_norm_backward_reduce: lambda grad_out, input, mean, invstd, weight, input_g, weight_g, bias_g: -1,
         torch.batch_norm_elemt: lambda input, weight, bias, mean, invstd, eps: -1,
@@ -336,6 +346,8 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.conv1d: lambda input, weight, bias=None, stride=1, padding=0, dilation=1, groups=1: -1,
         torch.conv2d: lambda input, weight, bias=None, stride=1, padding=0, dilation=1, groups=1: -1,
         torch.conv3d: lambda input, weight, bias=None, stride=1, padding=0, dilation=1, groups=1: -1,
+        torch.conv_batch_norm: (lambda input, conv_weight, conv_bias, stride, padding, dilation, groups, weight, bias,
+                                running_mean, running_var, training, momentum, eps: -1),
         torch.convolution: lambda input, weight, bias, stride, padding, dilation, transposed, output_adding, groups: -1,
         torch.conv_tbc: lambda input, weight, bias, pad=0: -1,
         torch.conv_transpose1d: lambda input, weight, bias=None, stride=1, padding=0, output_padding=0, groups=1, dilation=1: -1,
@@ -463,6 +475,7 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.index_copy: lambda input, dim, index, source: -1,
         torch.index_put: lambda input, indices, values, accumulate=False: -1,
         torch.index_select: lambda input, dim, index, out=None: -1,
+        torch.index_static: lambda input, indices, count: -1,
         torch.index_fill: lambda input, dim, index, value: -1,
         torch.isfinite: lambda tensor: -1,
         torch.isinf: lambda tensor: -1,
@@ -523,6 +536,7 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.masked_fill: lambda input, mask, value: -1,
         torch.masked_scatter: lambda input, mask, source: -1,
         torch.masked_select: lambda input, mask, out=None: -1,
+        torch.masked_select_static: lambda input, mask, max_size: -1,
         torch.matmul: lambda input, other, out=None: -1,
         torch.matrix_power: lambda input, n: -1,
         torch.matrix_rank: lambda input, tol=None, symmetric=False: -1,
@@ -571,6 +585,8 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.native_norm: lambda input, p=2: -1,
         torch.native_norm: lambda input, p=2: -1,
         torch.native_norm: lambda input, p=2, dim=None, keepdim=False, dtype=None: -1,
+        torch.nested_tensor: lambda tensors: -1,
+        torch.nested_tensor_from_padded: lambda padded, lengths: -1,
         torch.ne: lambda input, other, out=None: -1,
         torch.not_equal: lambda input, other, out=None: -1,
         torch.neg: lambda input, out=None: -1,
@@ -585,6 +601,8 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.nn.functional.adaptive_max_pool3d: lambda input, output_size, return_indices=False: -1,
         torch.nn.functional.adaptive_max_pool3d_with_indices: lambda input, output_size, return_indices=False: -1,
         torch.nn.functional.affine_grid: lambda theta, size, align_corners=None: -1,
+        torch.nn.functional.affine_grid_sample: (lambda input, theta, size, mode='bilinear', padding_mode='zeros',
+                                                  align_corners=None: -1),
         torch.nn.functional.alpha_dropout: lambda input, p=0.5, training=False, inplace=False: -1,
         torch.nn.functional.avg_pool2d: (lambda input, kernel_size, stride=None, padding=0, ceil_mode=False,
                                          count_include_pad=True, divisor_override=None: -1),
@@ -708,6 +726,7 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
                                                                 swap=False, reduction='mean': -1),
         torch.nn.functional.unfold: lambda input, kernel_size, dilation=1, padding=0, stride=1: -1,
         torch.nonzero: lambda input, as_tuple=False: -1,
+        torch.nonzero_static: lambda input, max_size: -1,
         torch.norm: lambda input, p='fro', dim=None, keepdim=False, out=None, dtype=None: -1,
         torch.norm_except_dim: lambda v, pow=2, dim=0: -1,
         torch.nuclear_norm: lambda input, p='fro', dim=None, keepdim=False, out=None, dtype=None: -1,
@@ -833,6 +852,7 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.threshold: lambda input, threshold, value, inplace=False: -1,
         torch.tile: lambda input, dims: -1,
         torch.topk: lambda input, k, dim=-1, descending=False, out=None: -1,
+        torch.to_padded_tensor: lambda input, padding, output_size=None: -1,
         torch.trace: lambda input: -1,
         torch.transpose: lambda input, dim0, dim1: -1,
         torch.trapz: lambda y, x=None, dim=-1: -1,
@@ -909,6 +929,7 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         Tensor.is_mkldnn.__get__: lambda self: -1,
         Tensor.is_quantized.__get__: lambda self: -1,
         Tensor.is_sparse.__get__: lambda self: -1,
+        Tensor.is_sparse_csr.__get__: lambda self: -1,
         Tensor.is_vulkan.__get__: lambda self: -1,
         Tensor.layout.__get__: lambda self: -1,
         Tensor.name.__get__: lambda self: -1,
@@ -963,6 +984,8 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         Tensor.get_device: lambda self: -1,
         Tensor.half: lambda self, memory_format=torch.preserve_format: -1,
         Tensor.has_names: lambda self: -1,
+        Tensor.col_indices: lambda self: -1,
+        Tensor.crow_indices: lambda self: -1,
         Tensor.indices: lambda self: -1,
         Tensor.int: lambda self, memory_format=torch.preserve_format: -1,
         Tensor.is_coalesced: lambda self: -1,
@@ -1014,7 +1037,9 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         Tensor.tile: lambda self, *reps: -1,
         Tensor.to: lambda self, dtype, non_blocking=False, copy=False, memory_format=torch.preserve_format: -1,
         Tensor.to_dense: lambda self: -1,
+        Tensor.to_padded_tensor: lambda self, padding, output_size=None: -1,
         Tensor.to_sparse: lambda self: -1,
+        Tensor.to_sparse_csr: lambda self: -1,
         Tensor.tolist: lambda self: -1,
         Tensor.to_mkldnn: lambda self: -1,
         Tensor.type_as: lambda self, other: -1,
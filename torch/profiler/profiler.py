@@ -93,7 +93,8 @@ class profile(object):
     - ``record_shapes`` - save information about operator's input shapes;
     - ``profile_memory`` - track tensor memory allocation/deallocation;
     - ``with_stack`` - record source information (file and line number) for the ops;
-    - ``with_flops`` - use formula to estimate the FLOPS of specific operators (matrix multiplication and 2D convolution);
+    - ``with_flops`` - use formula to estimate the FLOPS and the bytes read and written of specific operators
+      (matrix multiplication, convolution, common pointwise, reduction and embedding operators);
     - ``use_cuda`` - (deprecated, use ``activities``).
 
     .. note::
@@ -900,6 +900,18 @@ class HistogramObserver(_ObserverBase):
         if x_orig.numel() == 0:
             return x_orig
         x = x_orig.detach()
+        if x.device.type == 'cpu' and self.histogram.device.type == 'cpu':
+            # One native pass for the min/max update, the histogram of x and
+            # the rebinning of the recorded histogram
+            histogram, min_val, max_val = torch._histogram_observer_update(
+                x, self.histogram, self.min_val, self.max_val, self.upsample_rate)
+            self.histogram.resize_(histogram.shape)
+            self.histogram.copy_(histogram)
+            self.min_val.resize_(min_val.shape)
+            self.min_val.copy_(min_val)
+            self.max_val.resize_(max_val.shape)
+            self.max_val.copy_(max_val)
+            return x_orig
         min_val = self.min_val
         max_val = self.max_val
         same_values = min_val.item() == max_val.item()
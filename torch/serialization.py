@@ -1,3 +1,4 @@
+import concurrent.futures
 import difflib
 import os
 import io
@@ -331,7 +332,8 @@ def _check_dill_version(pickle_module) -> None:
             ))
 
 def save(obj, f: Union[str, os.PathLike, BinaryIO, IO[bytes]],
-         pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL, _use_new_zipfile_serialization=True) -> None:
+         pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL, _use_new_zipfile_serialization=True,
+         compression_level: Optional[int] = None) -> None:
     """Saves an object to a disk file.
 
     See also: `saving-loading-tensors`
@@ -342,6 +344,12 @@ def save(obj, f: Union[str, os.PathLike, BinaryIO, IO[bytes]],
            os.PathLike object containing a file name
         pickle_module: module used for pickling metadata and objects
         pickle_protocol: can be specified to override the default protocol
+        compression_level (int, optional): if given, the tensor data is
+           compressed with deflate at this level, from 1 (fastest) to 9
+           (smallest). The data is split into chunks that are compressed, and
+           decompressed by :func:`torch.load`, in parallel on the intra-op
+           thread pool. Uncompressed files are faster to load and can be
+           memory-mapped, which is why they are the default. Default: ``None``
 
     .. note::
         A common PyTorch convention is to save tensors using .pt file extension.
@@ -366,10 +374,13 @@ def save(obj, f: Union[str, os.PathLike, BinaryIO, IO[bytes]],
     """
     _check_dill_version(pickle_module)
 
+    if compression_level is not None and not _use_new_zipfile_serialization:
+        raise ValueError("compression_level requires the zipfile-based format")
+
     with _open_file_like(f, 'wb') as opened_file:
         if _use_new_zipfile_serialization:
             with _open_zipfile_writer(opened_file) as opened_zipfile:
-                _save(obj, opened_zipfile, pickle_module, pickle_protocol)
+                _save(obj, opened_zipfile, pickle_module, pickle_protocol, compression_level)
                 return
         _legacy_save(obj, opened_file, pickle_module, pickle_protocol)
 
@@ -447,7 +458,8 @@ def _legacy_save(obj, f, pickle_module, pickle_protocol) -> None:
         serialized_storages[key]._write_file(f, _should_read_directly(f), True)
 
 
-def _save(obj, zip_file, pickle_module, pickle_protocol):
+def _pickle_with_storages(obj, pickle_module, pickle_protocol):
+    # Returns the pickle data for `obj` and the storages it references, by key
     serialized_storages = {}
 
     def persistent_id(obj):
@@ -474,8 +486,13 @@ def _save(obj, zip_file, pickle_module, pickle_protocol):
     pickler = pickle_module.Pickler(data_buf, protocol=pickle_protocol)
     pickler.persistent_id = persistent_id
     pickler.dump(obj)
-    data_value = data_buf.getvalue()
+    return data_buf.getvalue(), serialized_storages
+
+
+def _write_records(zip_file, data_value, serialized_storages, compression_level=None):
     zip_file.write_record('data.pkl', data_value, len(data_value))
+    if compression_level is not None:
+        zip_file.set_compression_level(compression_level)
 
     # Write each tensor to a file named tensor/the_tensor_key in the zip archive
     for key in sorted(serialized_storages.keys()):
@@ -488,7 +505,100 @@ def _save(obj, zip_file, pickle_module, pickle_protocol):
             storage = storage.cpu()
         # Now that it is on the CPU we can directly copy it into the zip file
         num_bytes = storage.size() * storage.element_size()
-        zip_file.write_record(name, storage.data_ptr(), num_bytes)
+        zip_file.write_record(name, storage.data_ptr(), num_bytes,
+                              compress=compression_level is not None,
+                              element_size=storage.element_size())
+
+
+def _save(obj, zip_file, pickle_module, pickle_protocol, compression_level=None):
+    data_value, serialized_storages = _pickle_with_storages(obj, pickle_module, pickle_protocol)
+    _write_records(zip_file, data_value, serialized_storages, compression_level)
+
+
+def _snapshot_storages(serialized_storages, pin_memory):
+    # Copies the storages to CPU memory. The copies of CUDA storages run on a
+    # side stream of their device, and this returns once they are done.
+    snapshot = {}
+    streams: Dict[torch.device, Any] = {}
+    for key, storage in serialized_storages.items():
+        if storage.device.type == 'cuda':
+            stream = streams.get(storage.device)
+            if stream is None:
+                stream = torch.cuda.Stream(device=storage.device)
+                stream.wait_stream(torch.cuda.current_stream(storage.device))
+                streams[storage.device] = stream
+            with torch.cuda.stream(stream):
+                src = torch._utils._rebuild_tensor(storage, 0, (storage.size(),), (1,))
+                dst = torch.empty(src.size(), dtype=src.dtype, pin_memory=pin_memory)
+                dst.copy_(src, non_blocking=pin_memory)
+            snapshot[key] = dst.storage()
+        elif storage.device.type == 'cpu':
+            snapshot[key] = storage.clone()
+        else:
+            snapshot[key] = storage.cpu()
+    for stream in streams.values():
+        stream.synchronize()
+    return snapshot
+
+
+_async_save_executor: Optional[concurrent.futures.ThreadPoolExecutor] = None
+
+
+def async_save(obj, f: Union[str, os.PathLike, BinaryIO, IO[bytes]],
+               pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL,
+               pin_memory: bool = True,
+               compression_level: Optional[int] = None) -> concurrent.futures.Future:
+    """Saves an object to a disk file like :func:`torch.save`, but writes it
+    from a background thread.
+
+    The tensors of ``obj`` are first copied to CPU memory, which is the only
+    part of the save that blocks the caller: the copies of CUDA tensors run on
+    a side stream, and this function returns as soon as they are done. ``obj``
+    can then be modified without affecting the saved file, while the file is
+    written by a background thread. Saves are written one after the other, in
+    the order of the calls. The file is loaded with :func:`torch.load`.
+
+    In distributed training, each rank saves its own state to a file of its
+    own, e.g. ``'checkpoint.{}.pt'.format(rank)``, so that no rank waits for
+    the others.
+
+    Args:
+        obj: saved object
+        f: a file-like object (has to implement write and flush) or a string or
+           os.PathLike object containing a file name. A file-like object must
+           not be used until the save is complete.
+        pickle_module: module used for pickling metadata and objects
+        pickle_protocol: can be specified to override the default protocol
+        pin_memory (bool): whether to copy CUDA tensors to page-locked memory,
+           which the asynchronous copies require. Default: ``True``
+        compression_level (int, optional): compresses the tensor data, see
+           :func:`torch.save`. Default: ``None``
+
+    Returns:
+        A :class:`concurrent.futures.Future` completed once the file is
+        written, whose ``result()`` raises the error the write ran into, if
+        any.
+
+    Example:
+        >>> fut = torch.serialization.async_save(model.state_dict(), 'checkpoint.pt')
+        >>> # train on
+        >>> fut.result()
+    """
+    global _async_save_executor
+    _check_dill_version(pickle_module)
+
+    data_value, serialized_storages = _pickle_with_storages(obj, pickle_module, pickle_protocol)
+    snapshot = _snapshot_storages(serialized_storages, pin_memory and torch.cuda.is_available())
+
+    def write():
+        with _open_file_like(f, 'wb') as opened_file:
+            with _open_zipfile_writer(opened_file) as opened_zipfile:
+                _write_records(opened_zipfile, data_value, snapshot, compression_level)
+
+    if _async_save_executor is None:
+        _async_save_executor = concurrent.futures.ThreadPoolExecutor(
+            max_workers=1, thread_name_prefix='torch_async_save')
+    return _async_save_executor.submit(write)
 
 
 def load(f, map_location=None, pickle_module=pickle, **pickle_load_args):
@@ -844,6 +954,10 @@ def _load(zip_file, map_location, pickle_module, pickle_file='data.pkl', **pickl
         storage = loaded_storages[key]
         return storage
 
+    if torch._C._jit_get_prefetch_tensor_records():
+        # read all storages up front, in the order they are stored
+        zip_file.prefetch_records([name for name in zip_file.get_all_records() if name.startswith('data/')])
+
     # Load the data (which may in turn use `persistent_load` to load tensors)
     data_file = io.BytesIO(zip_file.get_record(pickle_file))
     unpickler = pickle_module.Unpickler(data_file, **pickle_load_args)
@@ -241,6 +241,10 @@ def my_rref_function(rref_a, rref_b):
     return rref_a.to_here() + rref_b.to_here()
 
 
+def my_rrefs_sum(rrefs):
+    return sum(rpc.fetch_rrefs(rrefs))
+
+
 def delayed_add(a, b, seconds=0.05):
     time.sleep(seconds)
     return a + b
@@ -2290,6 +2294,37 @@ class RpcTest(RpcAgentTestFixture):
         ret = ret_rref
         self.assertEqual(ret, torch.add(torch.ones(n, n), 1))
 
+    @dist_init
+    def test_fetch_rrefs(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        rrefs = [
+            rpc.remote(worker_name(dst_rank), torch.add, args=(torch.ones(n, n), i))
+            for i in range(20)
+        ]
+        # RRefs of Python objects, of another owner, and a local one
+        rrefs += [
+            rpc.remote(worker_name(dst_rank), my_function, args=(torch.ones(n, n), i, 1))
+            for i in range(20)
+        ]
+        rrefs.append(
+            rpc.remote(worker_name((self.rank + 2) % self.world_size), torch.add, args=(torch.ones(n, n), 1))
+        )
+        rrefs.append(RRef(torch.ones(n, n)))
+        values = rpc.fetch_rrefs(rrefs)
+        self.assertEqual(values, [rref.to_here() for rref in rrefs])
+        self.assertEqual(rpc.fetch_rrefs([]), [])
+
+        # Passing many RRefs to another worker sends many fork requests and
+        # child accepts at once.
+        ret = rpc.rpc_sync(
+            worker_name((self.rank + 3) % self.world_size), my_rrefs_sum, args=(rrefs,)
+        )
+        self.assertEqual(ret, sum(values))
+
+        with self.assertRaisesRegex(ValueError, expected_err):
+            rpc.fetch_rrefs(rrefs[:1] + [rpc.remote(worker_name(dst_rank), raise_func)])
+
     @dist_init
     def test_local_rref_no_fork(self):
         local_rref = RRef(35)
@@ -4601,6 +4636,27 @@ class TensorPipeAgentRpcTest(RpcAgentTestFixture):
                 rpc_timeout=timeout,
             )
 
+    @dist_init
+    def test_tensorpipe_transport_metrics(self):
+        dst = worker_name((self.rank + 1) % self.world_size)
+        t = torch.ones(1024)
+        rpc.rpc_sync(dst, torch.add, args=(t, 1))
+
+        info = rpc.api._get_current_rpc_agent().get_debug_info()
+        prefix = "agent.transport."
+        transports = [
+            key[len(prefix):-len(".bytes_sent")]
+            for key in info
+            if key.startswith(prefix) and key.endswith(".bytes_sent")
+        ]
+        # All the workers of the test are on the same host, hence the pipe
+        # connects over the transport with the highest priority.
+        self.assertEqual(len(transports), 1)
+        transport = transports[0]
+        self.assertGreaterEqual(int(info[prefix + transport + ".bytes_sent"]), t.numel() * t.element_size())
+        self.assertGreaterEqual(int(info[prefix + transport + ".bytes_received"]), t.numel() * t.element_size())
+        self.assertGreater(float(info[prefix + transport + ".average_rpc_latency_us"]), 0)
+
     def _test_device_maps(self, options, errMsg="Invalid device_map"):
         with self.assertRaisesRegex(ValueError, errMsg):
             rpc.init_rpc(